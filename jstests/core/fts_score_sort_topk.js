@@ -0,0 +1,66 @@
+// Tests that a text search sorted by text score with a limit only reads the text index until the
+// top documents are known, and returns the same results and scores as a full search.
+// @tags: [assumes_unsharded_collection]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.fts_score_sort_topk;
+    coll.drop();
+
+    // Give the documents distinct term frequencies, so that their scores differ.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; i++) {
+        const words = ["common"];
+        for (let j = 0; j < i % 50; j++) {
+            words.push("apple");
+        }
+        words.push(i % 7 === 0 ? "banana" : "cherry");
+        for (let j = 0; i % 50 === 0 && j <= i / 50; j++) {
+            words.push("rare");
+        }
+        words.push("filler" + i);
+        bulk.insert({_id: i, text: words.join(" ")});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({text: "text"}));
+
+    function runQuery(search, limit) {
+        let cursor = coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+                         .sort({score: {$meta: "textScore"}});
+        if (limit) {
+            cursor = cursor.limit(limit);
+        }
+        return cursor.toArray().map(doc => doc.score);
+    }
+
+    function getTextOrStage(search, limit) {
+        const explain = coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+                            .sort({score: {$meta: "textScore"}})
+                            .limit(limit)
+                            .explain("executionStats");
+        return getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    }
+
+    // The top k scores match the first k scores of the full result.
+    for (let search of ["apple", "apple banana", "common apple cherry", "rare common"]) {
+        const fullScores = runQuery(search, 0);
+        for (let limit of [1, 5, 20]) {
+            assert.eq(fullScores.slice(0, limit), runQuery(search, limit), {search, limit});
+        }
+    }
+
+    // A limited search for a rare term combined with a common term stops reading early.
+    let textOr = getTextOrStage("rare common", 5);
+    assert.neq(null, textOr);
+    assert.eq(5, textOr.topK, textOr);
+    assert(textOr.stoppedEarly, textOr);
+    assert.lt(textOr.docsExamined, coll.count(), textOr);
+
+    // Negations and phrases are checked after scoring, so those searches read every posting.
+    textOr = getTextOrStage("apple -banana", 5);
+    assert.eq(undefined, textOr.topK, textOr);
+    textOr = getTextOrStage("\"common apple\"", 5);
+    assert.eq(undefined, textOr.topK, textOr);
+})();
@@ -0,0 +1,72 @@
+// Tests that $near queries on a 2dsphere index return the nearest documents in order when they are
+// limited, and that documents far enough beyond the limit are not fetched.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.geo_s2near_limit;
+    coll.drop();
+
+    const nDocs = 1000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; ++i) {
+        bulk.insert({_id: i, geo: [(i % 40) / 10, Math.floor(i / 40) / 10], a: i % 3});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({geo: "2dsphere"}));
+
+    const origin = {type: "Point", coordinates: [2.01, 1.21]};
+
+    function nearIds(filter, limit) {
+        const query = Object.extend({geo: {$near: {$geometry: origin}}}, filter);
+        return coll.find(query).limit(limit).toArray().map(doc => doc._id);
+    }
+
+    function assertNearestFirst(filter, limit) {
+        // Compute the expected order from the distances reported by $geoNear.
+        const all = coll.aggregate([
+                            {
+                              $geoNear: {
+                                  near: origin,
+                                  distanceField: "dist",
+                                  spherical: true,
+                                  query: filter,
+                              }
+                            },
+                            {$sort: {dist: 1, _id: 1}}
+                        ])
+                        .toArray();
+        const limited = coll.find(Object.extend({geo: {$near: {$geometry: origin}}}, filter))
+                            .limit(limit)
+                            .toArray();
+        assert.eq(limit, limited.length);
+
+        // Distances may tie, so compare the distances of the returned documents.
+        const distById = {};
+        all.forEach(doc => distById[doc._id] = doc.dist);
+        for (let i = 0; i < limit; ++i) {
+            assert.eq(all[i].dist, distById[limited[i]._id], tojson(limited));
+        }
+    }
+
+    assertNearestFirst({}, 1);
+    assertNearestFirst({}, 10);
+    assertNearestFirst({}, 100);
+    assertNearestFirst({a: 1}, 10);
+    assert.eq(nearIds({}, nDocs).length, nDocs);
+    assert.eq(nearIds({a: 2}, nDocs).length, nDocs / 3);
+
+    // Documents beyond the limit are not fetched when the index is not multikey.
+    const explain =
+        coll.find({geo: {$near: {$geometry: origin}}}).limit(10).explain("executionStats");
+    const nearStage = getPlanStage(explain.executionStats.executionStages, "GEO_NEAR_2DSPHERE");
+    assert.neq(null, nearStage, tojson(explain));
+    assert.lt(nearStage.docsExamined, nDocs / 2, tojson(explain));
+
+    // Results remain ordered once the index is multikey and documents are fetched eagerly.
+    assert.writeOK(coll.insert(
+        {_id: nDocs, geo: {type: "MultiPoint", coordinates: [[2.01, 1.21], [3, 2]]}}));
+    assertNearestFirst({}, 10);
+    assert.eq(nDocs, nearIds({}, 10)[0]);
+})();
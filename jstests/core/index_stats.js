@@ -234,6 +234,31 @@
               getUsageCount("_id_", foreignCollection),
               "Expected each lookup to be tracked as an index use");
 
+    //
+    // Confirm index maintenance costs are recorded, and that indexes which are key prefixes of
+    // other indexes are reported.
+    //
+    col.drop();
+    assert.commandWorked(col.createIndex({a: 1}, {name: "a_1"}));
+    assert.commandWorked(col.createIndex({a: 1, b: -1}, {name: "a_1_b_-1"}));
+    assert.commandWorked(col.createIndex({a: -1, b: 1}, {name: "a_-1_b_1"}));
+    assert.writeOK(col.insert({_id: 0, a: 1, b: 1}));
+    assert.writeOK(col.update({_id: 0}, {$set: {b: 2}}));
+    assert.writeOK(col.remove({_id: 0}));
+
+    var statsByName = {};
+    col.aggregate([{$indexStats: {}}]).forEach(function(doc) {
+        statsByName[doc.name] = doc;
+    });
+    assert.eq(3, statsByName["a_1_b_-1"].writes.ops, tojson(statsByName));
+    assert.eq(2, statsByName["a_1_b_-1"].writes.keysInserted, tojson(statsByName));
+    assert.eq(2, statsByName["a_1_b_-1"].writes.keysDeleted, tojson(statsByName));
+    assert.gt(statsByName["a_1_b_-1"].writes.bytesInserted, 0, tojson(statsByName));
+    assert.eq(1, statsByName["a_1"].writes.keysInserted, tojson(statsByName));
+    assert.eq(["a_1_b_-1"], statsByName["a_1"].prefixOf, tojson(statsByName));
+    assert.eq([], statsByName["a_1_b_-1"].prefixOf, tojson(statsByName));
+    assert.eq([], statsByName["_id_"].prefixOf, tojson(statsByName));
+
     //
     // Confirm index use is recorded for $graphLookup.
     //
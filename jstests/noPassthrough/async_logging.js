@@ -0,0 +1,36 @@
+// Tests that the log file is written by a background thread when asyncLogging is enabled, and
+// that everything logged up to shutdown reaches the file.
+(function() {
+    "use strict";
+
+    const logPath = MongoRunner.dataPath + "async_logging.log";
+    removeFile(logPath);
+
+    const conn = MongoRunner.runMongod({logpath: logPath, setParameter: "asyncLogging=true"});
+    assert.neq(null, conn, "mongod failed to start with asyncLogging enabled");
+    const adminDB = conn.getDB("admin");
+
+    const stats = assert.commandWorked(adminDB.runCommand({serverStatus: 1})).asyncLogging;
+    assert.neq(undefined, stats, "expected an asyncLogging section in serverStatus");
+    assert.gt(stats.writtenLines, 0);
+    assert.eq(stats.droppedLines, 0);
+
+    // Log every operation as slow, so that the query below is logged with the marker.
+    const testDB = conn.getDB("test");
+    assert.commandWorked(testDB.setProfilingLevel(0, -1));
+    const marker = "async logging marker " + ObjectId().str;
+    assert.eq(0, testDB.coll.find({marker: marker}).itcount());
+
+    // Lines logged before a log rotation are written to the file they were logged to.
+    assert.commandWorked(adminDB.runCommand({logRotate: 1}));
+
+    MongoRunner.stopMongod(conn);
+
+    const rotatedLogs = listFiles(MongoRunner.dataPath)
+                            .filter(file => file.baseName.startsWith("async_logging.log."))
+                            .map(file => cat(file.name))
+                            .join("");
+    assert(rotatedLogs.includes(marker), "marker missing from the rotated log file");
+    assert(cat(logPath).includes("shutting down with code:0"),
+           "final shutdown line missing from the log file");
+})();
@@ -0,0 +1,47 @@
+// Tests that explain with executionStats verbosity reports the CPU time and storage engine
+// activity of every stage, and that queryPlanner verbosity does not.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.explain_detailed_stage_stats;
+
+    const docs = [];
+    for (let i = 0; i < 1000; i++) {
+        docs.push({_id: i, a: i % 10, b: "x".repeat(100)});
+    }
+    assert.commandWorked(coll.insert(docs));
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    function checkDetailedStats(stage) {
+        assert(stage.hasOwnProperty("cpuNanos"), tojson(stage));
+        assert.gte(stage.cpuNanos, 0, tojson(stage));
+        assert(stage.hasOwnProperty("storage"), tojson(stage));
+        assert.gte(stage.storage.bytesRead, 0, tojson(stage));
+        assert.gte(stage.storage.readMicros, 0, tojson(stage));
+        assert.gte(stage.storage.cacheWaitMicros, 0, tojson(stage));
+    }
+
+    let explain = coll.find({a: 3}).explain("executionStats");
+    const root = explain.executionStats.executionStages;
+    for (let stageName of ["FETCH", "IXSCAN"]) {
+        const stage = getPlanStage(root, stageName);
+        assert.neq(null, stage, tojson(explain));
+        checkDetailedStats(stage);
+    }
+    // Each stage's time includes the time of its children.
+    assert.gt(root.cpuNanos, 0, tojson(explain));
+    assert.gte(root.cpuNanos, getPlanStage(root, "IXSCAN").cpuNanos, tojson(explain));
+
+    explain = coll.explain("executionStats").aggregate([{$match: {b: {$exists: true}}}]);
+    checkDetailedStats(getAggPlanStage(explain, "COLLSCAN"));
+
+    explain = coll.find({a: 3}).explain("queryPlanner");
+    assert.eq(null, getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN").cpuNanos);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,96 @@
+/**
+ * Tests the getSamplingProfile command and the samplingProfilerFrequencyHz server parameter.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    const admin = conn.getDB("admin");
+    const testDB = conn.getDB("test");
+
+    function getProfile(options) {
+        return assert.commandWorked(
+            admin.runCommand(Object.assign({getSamplingProfile: 1}, options || {})));
+    }
+
+    function assertProfileShape(res, samplesPerSecond) {
+        assert.eq(samplesPerSecond, res.samplesPerSecond, tojson(res));
+        assert.gte(res.samples, 0, tojson(res));
+        assert.gte(res.droppedSamples, 0, tojson(res));
+        assert(Array.isArray(res.profile), tojson(res));
+        let previousCount = Infinity;
+        res.profile.forEach((entry) => {
+            assert.eq("string", typeof entry.command, tojson(entry));
+            assert.eq("string", typeof entry.ns, tojson(entry));
+            assert.eq("string", typeof entry.stack, tojson(entry));
+            assert.gt(entry.count, 0, tojson(entry));
+            assert.lte(entry.count, previousCount, "not sorted by count: " + tojson(res));
+            previousCount = entry.count;
+        });
+    }
+
+    // Sampling is off by default, and nothing is collected.
+    assertProfileShape(getProfile(), 0);
+    assert.eq(0, getProfile().profile.length);
+
+    // Invalid frequencies are rejected, at startup and at runtime.
+    assert.commandFailed(admin.runCommand({setParameter: 1, samplingProfilerFrequencyHz: -1}));
+    assert.commandFailed(admin.runCommand({setParameter: 1, samplingProfilerFrequencyHz: 1001}));
+    assert.eq(null,
+              MongoRunner.runMongod({setParameter: {samplingProfilerFrequencyHz: 1001}}),
+              "mongod started with an invalid sampling frequency");
+
+    // Invalid options are rejected.
+    assert.commandFailedWithCode(admin.runCommand({getSamplingProfile: 1, limit: -1}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailed(admin.runCommand({getSamplingProfile: 1, reset: "yes"}));
+
+    const res = admin.runCommand({setParameter: 1, samplingProfilerFrequencyHz: 1000});
+    if (!res.ok) {
+        // Sampling is only supported on Linux.
+        assert.commandFailedWithCode(res, ErrorCodes.InternalError);
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    // Burn CPU in a command so that it gets sampled.
+    assert.commandWorked(testDB.coll.insert({_id: 0}));
+    assert.soon(() => {
+        assert.eq(1,
+                  testDB.coll
+                      .find({
+                          $where: function() {
+                              const end = Date.now() + 100;
+                              while (Date.now() < end) {
+                              }
+                              return true;
+                          }
+                      })
+                      .itcount());
+        const profile = getProfile();
+        return profile.profile.some((entry) => entry.command === "find" &&
+                                        entry.ns === "test.coll");
+    });
+    assertProfileShape(getProfile(), 1000);
+
+    // The limit bounds the number of stacks reported, keeping the most frequent ones.
+    const full = getProfile({limit: 1000000});
+    assert.gt(full.profile.length, 1, tojson(full));
+    const limited = getProfile({limit: 1});
+    assert.eq(1, limited.profile.length, tojson(limited));
+    assert.eq(full.profile[0].count, limited.profile[0].count, tojson(limited));
+    assert.eq(0, getProfile({limit: 0}).profile.length);
+
+    // Stop sampling so that reset leaves the profile empty.
+    assert.commandWorked(admin.runCommand({setParameter: 1, samplingProfilerFrequencyHz: 0}));
+    const beforeReset = getProfile({reset: true});
+    assertProfileShape(beforeReset, 0);
+    assert.gt(beforeReset.samples, 0, tojson(beforeReset));
+
+    const afterReset = getProfile();
+    assertProfileShape(afterReset, 0);
+    assert.eq(0, afterReset.samples, tojson(afterReset));
+    assert.eq(0, afterReset.profile.length, tojson(afterReset));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,66 @@
+/**
+ * Tests that the work stealing service executor keeps serving a replica set when more operations
+ * block than it has worker threads, by starting extra threads once all of its workers are stuck.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/parallel_shell_helpers.js");
+
+    const kNumWorkers = 2;
+    const kNumBlockedFinds = 2 * kNumWorkers;
+    const kComment = "service_executor_work_stealing_blocked_workers.js";
+
+    const rst = new ReplSetTest({
+        nodes: 2,
+        nodeOptions: {
+            serviceExecutor: "workStealing",
+            setParameter: {workStealingServiceExecutorThreads: kNumWorkers},
+        },
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    assert.commandWorked(testDB.coll.insert({_id: 0}, {writeConcern: {w: 2}}));
+
+    assert.commandWorked(primary.adminCommand(
+        {configureFailPoint: "waitInFindBeforeMakingBatch", mode: "alwaysOn"}));
+
+    // Each of these finds occupies a thread of the executor until the failpoint is turned off.
+    const awaitFinds = [];
+    for (let i = 0; i < kNumBlockedFinds; i++) {
+        awaitFinds.push(startParallelShell(
+            funWithArgs(function(comment) {
+                const coll = db.getSiblingDB("test").coll;
+                assert.eq(1, coll.find({_id: 0}).comment(comment).itcount());
+            }, kComment),
+            primary.port));
+    }
+
+    // Finding the blocked operations, turning off the failpoint and replicating a write all need
+    // threads beyond the workers that the finds are holding.
+    assert.soon(() => {
+        const ops = primary.getDB("admin")
+                        .aggregate([
+                            {$currentOp: {}},
+                            {$match: {"command.comment": kComment}},
+                        ])
+                        .toArray();
+        return ops.length === kNumBlockedFinds;
+    });
+
+    assert.commandWorked(testDB.coll.insert({_id: 1}, {writeConcern: {w: 2}}));
+
+    const stats = assert.commandWorked(primary.adminCommand({serverStatus: 1}))
+                      .network.serviceExecutorTaskStats;
+    assert.eq("workStealing", stats.executor, tojson(stats));
+    assert.gte(stats.extraThreadsStarted, 1, tojson(stats));
+
+    assert.commandWorked(
+        primary.adminCommand({configureFailPoint: "waitInFindBeforeMakingBatch", mode: "off"}));
+    awaitFinds.forEach((awaitFind) => awaitFind());
+
+    rst.stopSet();
+})();
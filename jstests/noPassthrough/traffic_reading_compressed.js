@@ -0,0 +1,44 @@
+// Tests that compressed traffic recordings can be read back.
+(function() {
+    const recordingDir = MongoRunner.toRealDir("$dataDir/traffic_recording_compressed/");
+    const recordingFilePath = MongoRunner.toRealDir(recordingDir + "/recording.txt");
+
+    mkdir(recordingDir);
+
+    const m = MongoRunner.runMongod({setParameter: "trafficRecordingDirectory=" + recordingDir});
+    const adminDB = m.getDB("admin");
+    const coll = m.getDB("test").getCollection("foo");
+
+    assert.commandWorked(adminDB.runCommand(
+        {'startRecordingTraffic': 1, 'filename': 'recording.txt', 'compress': true}));
+
+    const trafficStats = assert.commandWorked(adminDB.runCommand({serverStatus: 1}))
+                             .trafficRecording;
+    assert.eq(trafficStats.running, true);
+    assert.eq(trafficStats.compressed, true);
+    assert.eq(trafficStats.droppedPackets, 0);
+
+    for (let i = 0; i < 10; i++) {
+        assert.commandWorked(coll.insert({"name": "foo biz bar", "i": i}));
+    }
+    assert.eq(10, coll.find().itcount());
+
+    assert.commandWorked(adminDB.runCommand({'stopRecordingTraffic': 1}));
+    MongoRunner.stopMongod(m);
+
+    let numRequest = 0;
+    let numResponse = 0;
+    let opTypes = {};
+    convertTrafficRecordingToBSON(recordingFilePath).forEach((obj) => {
+        if (obj["rawop"]["header"]["responseto"] == 0) {
+            numRequest++;
+        } else {
+            numResponse++;
+        }
+        opTypes[obj["opType"]] = (opTypes[obj["opType"]] || 0) + 1;
+    });
+
+    assert.eq(numResponse, numRequest);
+    assert.eq(opTypes['insert'], 10);
+    assert.eq(opTypes['find'], 1);
+})();
@@ -0,0 +1,115 @@
+// Tests that the TTL monitor deletes expired documents with several worker threads, cuts passes
+// over an index short after ttlIndexPassMaxMillis and starts the next pass without sleeping, and
+// reports each TTL index in the "ttl" serverStatus section.
+
+(function() {
+    'use strict';
+
+    load('jstests/noPassthrough/libs/server_parameter_helpers.js');
+
+    testNumericServerParameter('ttlMonitorWorkerThreads',
+                               true,   // is Startup Param
+                               false,  // is runtime param
+                               1,      // default value
+                               4,      // valid, non-default value
+                               true,   // has lower bound
+                               0,      // out of bound value (below lower bound)
+                               true,   // has upper bound
+                               65      // out of bounds value (above upper bound)
+                               );
+
+    testNumericServerParameter('ttlIndexPassMaxMillis',
+                               true,     // is Startup Param
+                               true,     // is runtime param
+                               0,        // default value
+                               100,      // valid, non-default value
+                               true,     // has lower bound
+                               -1,       // out of bound value (below lower bound)
+                               false,    // has upper bound
+                               'unused'  // out of bounds value (above upper bound)
+                               );
+
+    const kSleepSecs = 10;
+    const kNumSmallCollections = 3;
+    const kNumBigDocs = 20000;
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            ttlMonitorEnabled: false,
+            ttlMonitorSleepSecs: kSleepSecs,
+            ttlMonitorWorkerThreads: 4,
+            ttlIndexPassMaxMillis: 1,
+            // Check for the end of the time slice often.
+            internalQueryExecYieldIterations: 10,
+        }
+    });
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const db = conn.getDB('test');
+
+    function fill(coll, numExpired) {
+        assert.commandWorked(coll.createIndex({t: 1}, {expireAfterSeconds: 0}));
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < numExpired; i++) {
+            bulk.insert({t: new Date(0)});
+        }
+        bulk.insert({t: new Date(Date.now() + 24 * 60 * 60 * 1000), keep: true});
+        assert.writeOK(bulk.execute());
+    }
+
+    fill(db.big, kNumBigDocs);
+    for (let i = 0; i < kNumSmallCollections; i++) {
+        fill(db['small' + i], 10);
+    }
+
+    function getPasses() {
+        return db.serverStatus().metrics.ttl.passes;
+    }
+
+    function getTTLIndexes() {
+        const status = assert.commandWorked(db.adminCommand({serverStatus: 1, ttl: 1}));
+        return status.ttl.indexes;
+    }
+
+    // The section is only reported on request.
+    assert(!db.serverStatus().hasOwnProperty('ttl'), tojson(db.serverStatus()));
+    assert.eq(0, getTTLIndexes().length);
+
+    const passesBefore = getPasses();
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: true}));
+    assert.soon(() => getPasses() > passesBefore, 'TTL monitor did not run', 3 * kSleepSecs * 1000);
+    const firstPassStart = Date.now();
+    const passesAtFirstPass = getPasses();
+
+    // The big collection takes several passes, which follow each other without sleeping.
+    assert.soon(() => db.big.count() === 1, 'big collection was not emptied', kSleepSecs * 1000);
+    assert.lt(Date.now() - firstPassStart, kSleepSecs * 1000);
+    assert.gt(getPasses(), passesAtFirstPass, 'expected passes to follow without sleeping');
+    assert.eq(1, db.big.count({keep: true}));
+
+    for (let i = 0; i < kNumSmallCollections; i++) {
+        const coll = db['small' + i];
+        assert.soon(() => coll.count() === 1, coll.getFullName() + ' was not emptied');
+        assert.eq(1, coll.count({keep: true}));
+    }
+
+    // Every index is reported, with its lag once a pass over it was not cut short.
+    assert.soon(() => {
+        const indexes = getTTLIndexes();
+        return indexes.length === kNumSmallCollections + 1 &&
+            indexes.every((index) => index.hasOwnProperty('lagSecs'));
+    }, () => tojson(getTTLIndexes()));
+    getTTLIndexes().forEach((index) => {
+        assert.eq('t_1', index.name, tojson(index));
+        assert.gte(index.deletedLastPass, 0, tojson(index));
+        assert.gte(index.lagSecs, 0, tojson(index));
+        assert(index.ns === 'test.big' || index.ns.startsWith('test.small'), tojson(index));
+    });
+
+    // Indexes that no longer exist are dropped from the section after the next pass.
+    assert(db.small0.drop());
+    assert.soon(() => getTTLIndexes().every((index) => index.ns !== 'test.small0'),
+                () => tojson(getTTLIndexes()),
+                3 * kSleepSecs * 1000);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,61 @@
+/**
+ * Tests that with wiredTigerCappedBackgroundTrim enabled a capped collection stays bounded while
+ * documents are inserted into it, and that the background thread brings it back under its cap,
+ * also once the collection is renamed.
+ * @tags: [requires_capped]
+ */
+(function() {
+    'use strict';
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTestLog("Skipping test because storageEngine is not wiredTiger");
+        return;
+    }
+
+    const conn = MongoRunner.runMongod({setParameter: {wiredTigerCappedBackgroundTrim: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+
+    // The slack for a capped collection of this size is a tenth of it. Inserts only remove
+    // documents themselves once the collection is over its cap by more than twice the slack.
+    const cappedSize = 1024 * 1024;
+    const slack = cappedSize / 10;
+    const batchSize = 50;
+    const padding = "x".repeat(1024);
+
+    assert.commandWorked(testDB.createCollection("capped", {capped: true, size: cappedSize}));
+
+    function insertAndCheckBounded(coll, firstId) {
+        let nextId = firstId;
+        for (let batch = 0; batch < 200; ++batch) {
+            const bulk = coll.initializeUnorderedBulkOp();
+            for (let i = 0; i < batchSize; ++i) {
+                bulk.insert({_id: nextId++, padding: padding});
+            }
+            assert.commandWorked(bulk.execute());
+
+            const size = coll.stats().size;
+            assert.lte(size,
+                       cappedSize + 2 * slack + batchSize * Object.bsonsize({padding: padding}),
+                       "capped collection grew past its cap after inserting _id " + nextId);
+        }
+
+        // Batches are smaller than the slack, so only the background thread brings the
+        // collection back under its cap.
+        assert.soon(() => coll.stats().size <= cappedSize,
+                    () => "capped collection stayed over its cap: " + tojson(coll.stats()));
+        assert.lt(coll.find().itcount(), nextId - firstId);
+        assert.eq(1, coll.find({_id: nextId - 1}).itcount());
+        return nextId;
+    }
+
+    const nextId = insertAndCheckBounded(testDB.capped, 0);
+
+    // A trim requested under the old name finds no collection, and the inserts under the new name
+    // ask again once that request times out.
+    assert.commandWorked(testDB.capped.renameCollection("renamed"));
+    insertAndCheckBounded(testDB.renamed, nextId);
+
+    MongoRunner.stopMongod(conn);
+})();
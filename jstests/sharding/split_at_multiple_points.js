@@ -0,0 +1,45 @@
+/**
+ * Tests splitting chunks at many points at once through the 'middles' option of the split command.
+ */
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({mongos: 1, shards: 1});
+    var configDB = st.s0.getDB('config');
+
+    assert.commandWorked(configDB.adminCommand({enableSharding: 'test'}));
+    assert.commandWorked(configDB.adminCommand({shardCollection: 'test.user', key: {_id: 1}}));
+
+    // Cannot be combined with the other ways of specifying a split.
+    assert.commandFailed(
+        configDB.adminCommand({split: 'test.user', middle: {_id: 0}, middles: [{_id: 1}]}));
+    assert.commandFailed(
+        configDB.adminCommand({split: 'test.user', find: {_id: 0}, middles: [{_id: 1}]}));
+
+    // Attempt to split on a value that is not the shard key.
+    assert.commandFailed(configDB.adminCommand({split: 'test.user', middles: [{x: 100}]}));
+    assert.eq(1, configDB.chunks.find({ns: 'test.user'}).itcount());
+
+    // Split points are sorted and deduplicated, and may fall into different chunks.
+    assert.commandWorked(configDB.adminCommand({split: 'test.user', middles: [{_id: 0}]}));
+    assert.commandWorked(configDB.adminCommand(
+        {split: 'test.user', middles: [{_id: 10}, {_id: -10}, {_id: 10}, {_id: 20}]}));
+    assert.eq(5, configDB.chunks.find({ns: 'test.user'}).itcount());
+    [-10, 0, 10, 20].forEach(function(x) {
+        assert.neq(null, configDB.chunks.findOne({ns: 'test.user', min: {_id: x}}));
+    });
+
+    // Cannot split on an existing chunk boundary.
+    assert.commandFailed(
+        configDB.adminCommand({split: 'test.user', middles: [{_id: 5}, {_id: 10}]}));
+
+    // Pre-split into more chunks than a single splitChunk request can commit.
+    var middles = [];
+    for (var x = 100; x < 10100; x++) {
+        middles.push({_id: x});
+    }
+    assert.commandWorked(configDB.adminCommand({split: 'test.user', middles: middles}));
+    assert.eq(10000, configDB.chunks.find({ns: 'test.user', min: {$gte: {_id: 100}}}).itcount());
+
+    st.stop();
+})();
@@ -80,12 +80,12 @@ inline unsigned Status::refCount() const {
 inline Status::Status() : _error(NULL) {}
 
 inline void Status::ref(ErrorInfo* error) {
-    if (error)
+    if (error && !error->immortal)
         error->refs.fetchAndAdd(1);
 }
 
 inline void Status::unref(ErrorInfo* error) {
-    if (error && (error->refs.subtractAndFetch(1) == 0))
+    if (error && !error->immortal && (error->refs.subtractAndFetch(1) == 0))
         delete error;
 }
 
@@ -79,6 +79,13 @@ Status::Status(ErrorCodes::Error code,
     ref(_error);
 }
 
+Status Status::makeImmortal(ErrorCodes::Error code, StringData reason) {
+    Status status(code, reason);
+    if (status._error)
+        status._error->immortal = true;
+    return status;
+}
+
 Status::Status(ErrorCodes::Error code, const std::string& reason) : Status(code, reason, nullptr) {}
 Status::Status(ErrorCodes::Error code, const char* reason)
     : Status(code, StringData(reason), nullptr) {}
@@ -97,6 +97,19 @@ public:
         MONGO_STATIC_ASSERT(std::is_same<error_details::ErrorExtraInfoFor<T::code>, T>());
     }
 
+    /**
+     * Builds an error status whose ErrorInfo is never freed and is shared by all of its copies
+     * without reference counting, so copying and destroying those copies neither allocates nor
+     * writes to shared memory. Use it to initialize a static Status for errors raised on hot paths
+     * whose reason carries no per-occurrence detail:
+     *
+     *     static const Status kWriteConflict =
+     *         Status::makeImmortal(ErrorCodes::WriteConflict, "WriteConflict");
+     *
+     * Every call leaks a new ErrorInfo, so it should only be used to initialize statics.
+     */
+    static Status makeImmortal(ErrorCodes::Error code, StringData reason);
+
     inline Status(const Status& other);
     inline Status& operator=(const Status& other);
 
@@ -240,6 +253,7 @@ private:
         const ErrorCodes::Error code;  // error code
         const std::string reason;      // description of error cause
         const std::shared_ptr<const ErrorExtraInfo> extra;
+        bool immortal = false;  // if true, refs is not maintained and this is never freed
 
         static ErrorInfo* create(ErrorCodes::Error code,
                                  StringData reason,
@@ -0,0 +1,70 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+namespace {
+
+void BM_StatusConstruct(benchmark::State& state) {
+    for (auto keepRunning : state) {
+        Status status(ErrorCodes::WriteConflict, "WriteConflict");
+        benchmark::DoNotOptimize(status);
+    }
+}
+
+/**
+ * Copies a Status shared by all threads, which contend on its reference count.
+ */
+void BM_StatusCopyShared(benchmark::State& state) {
+    static const Status shared(ErrorCodes::WriteConflict, "WriteConflict");
+    for (auto keepRunning : state) {
+        Status copy = shared;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+void BM_StatusCopyImmortal(benchmark::State& state) {
+    static const Status immortal = Status::makeImmortal(ErrorCodes::WriteConflict, "WriteConflict");
+    for (auto keepRunning : state) {
+        Status copy = immortal;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+BENCHMARK(BM_StatusConstruct)->ThreadRange(1, 16);
+BENCHMARK(BM_StatusCopyShared)->ThreadRange(1, 16);
+BENCHMARK(BM_StatusCopyImmortal)->ThreadRange(1, 16);
+
+}  // namespace
+}  // namespace mongo
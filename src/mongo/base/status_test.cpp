@@ -101,6 +101,25 @@ TEST(Cloning, Copy) {
     ASSERT_EQUALS(orig.refCount(), 2U);
 }
 
+TEST(Cloning, CopyImmortal) {
+    static const Status orig = Status::makeImmortal(ErrorCodes::MaxError, "error");
+    ASSERT_EQUALS(orig.refCount(), 1U);
+
+    // Copies share the ErrorInfo without touching its reference count.
+    Status dest(orig);
+    ASSERT_EQUALS(dest.code(), ErrorCodes::MaxError);
+    ASSERT_EQUALS(dest.reason(), "error");
+    ASSERT_EQUALS(dest.refCount(), 1U);
+    ASSERT_EQUALS(orig.refCount(), 1U);
+
+    // Changing the reason creates an ordinary Status.
+    const auto copy = orig.withContext("context");
+    ASSERT_EQ(copy.code(), ErrorCodes::MaxError);
+    ASSERT_EQUALS(copy.refCount(), 1U);
+    Status copyOfCopy(copy);
+    ASSERT_EQUALS(copy.refCount(), 2U);
+}
+
 TEST(Cloning, MoveCopyOK) {
     Status orig = Status::OK();
     ASSERT_TRUE(orig.isOK());
@@ -27,6 +27,7 @@
  *    it in the license file.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <vector>
@@ -413,6 +414,158 @@ Status validateBSONIterative(Buffer* buffer) {
     return Status::OK();
 }
 
+/**
+ * Returns the number of bytes the value of an element of type 'type' takes, if it always takes the
+ * same number of bytes, or -1 otherwise.
+ */
+int fixedValueSize(signed char type) {
+    switch (type) {
+        case MinKey:
+        case MaxKey:
+        case jstNULL:
+        case Undefined:
+            return 0;
+        case Bool:
+            return 1;
+        case NumberInt:
+            return 4;
+        case NumberDouble:
+        case NumberLong:
+        case bsonTimestamp:
+        case Date:
+            return 8;
+        case jstOID:
+            return OID::kOIDSize;
+        case NumberDecimal:
+            return sizeof(Decimal128::Value);
+        default:
+            return -1;
+    }
+}
+
+/**
+ * Checks the structure of the BSON object at the start of 'buffer' without tracking what is needed
+ * to describe an error. Returns true only if validateBSONIterative() would accept the object, but
+ * may also return false for some valid objects, such as ones with code with scope or nested more
+ * deeply than the fast path keeps track of, in which case validateBSONIterative() decides.
+ *
+ * Rather than checking every read against the end of the buffer, it checks the declared size of
+ * each object against the end of its parent once, and then only reads within that object.
+ */
+bool validateBSONFast(const char* buffer, uint64_t maxLength) {
+    // The end of each object being validated, past its terminating EOO byte.
+    const size_t kMaxDepth = 32;
+    const char* ends[kMaxDepth];
+    const size_t maxDepth = std::min<size_t>(kMaxDepth, BSONDepth::getMaxAllowableDepth());
+
+    auto readInt = [](const char* ptr) { return ConstDataView(ptr).read<LittleEndian<int>>(); };
+
+    const int topLevelSize = readInt(buffer);
+    if (topLevelSize < 5 || static_cast<uint64_t>(topLevelSize) > maxLength ||
+        buffer[topLevelSize - 1] != EOO) {
+        return false;
+    }
+    size_t depth = 0;
+    ends[depth] = buffer + topLevelSize;
+    const char* pos = buffer + 4;
+
+    while (true) {
+        // Every object ends with an EOO byte, so 'last' is always safe to read and elements must
+        // end no later than it.
+        const char* const last = ends[depth] - 1;
+        const signed char type = *pos++;
+        if (type == EOO) {
+            if (pos != ends[depth]) {
+                return false;
+            }
+            if (depth == 0) {
+                return true;
+            }
+            --depth;
+            continue;
+        }
+
+        pos = static_cast<const char*>(memchr(pos, 0, last - pos));
+        if (!pos) {
+            return false;
+        }
+        ++pos;
+
+        const int fixedSize = fixedValueSize(type);
+        if (fixedSize >= 0) {
+            if (last - pos < fixedSize) {
+                return false;
+            }
+            if (type == Bool && static_cast<uint8_t>(*pos) > 1) {
+                return false;
+            }
+            pos += fixedSize;
+            continue;
+        }
+
+        switch (type) {
+            case String:
+            case Code:
+            case Symbol:
+            case DBRef: {
+                if (last - pos < 4) {
+                    return false;
+                }
+                const int size = readInt(pos);
+                pos += 4;
+                if (size <= 0 || last - pos < size || pos[size - 1] != '\0') {
+                    return false;
+                }
+                pos += size;
+                if (type == DBRef) {
+                    if (last - pos < OID::kOIDSize) {
+                        return false;
+                    }
+                    pos += OID::kOIDSize;
+                }
+                break;
+            }
+            case RegEx:
+                for (int i = 0; i < 2; ++i) {
+                    pos = static_cast<const char*>(memchr(pos, 0, last - pos));
+                    if (!pos) {
+                        return false;
+                    }
+                    ++pos;
+                }
+                break;
+            case BinData: {
+                if (last - pos < 4) {
+                    return false;
+                }
+                const int size = readInt(pos);
+                pos += 4;
+                if (size < 0 || last - pos < static_cast<std::ptrdiff_t>(size) + 1) {
+                    return false;
+                }
+                pos += size + 1;
+                break;
+            }
+            case Object:
+            case Array: {
+                if (last - pos < 5 || depth + 1 >= maxDepth) {
+                    return false;
+                }
+                const int size = readInt(pos);
+                if (size < 5 || last - pos < size || pos[size - 1] != EOO) {
+                    return false;
+                }
+                ends[++depth] = pos + size;
+                pos += 4;
+                break;
+            }
+            default:
+                // Code with scope and invalid types.
+                return false;
+        }
+    }
+}
+
 }  // namespace
 
 Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
@@ -420,6 +573,12 @@ Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion
         return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
     }
 
+    // Almost all objects are valid, so only go over them again to describe what is wrong with
+    // them if the fast path rejects them.
+    if (validateBSONFast(originalBuffer, maxLength)) {
+        return Status::OK();
+    }
+
     Buffer buf(originalBuffer, maxLength, version);
     return validateBSONIterative(&buf);
 }
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns a document shaped like a typical insert: an _id followed by strings, numbers, a date, a
+ * small subdocument and a short array, repeated 'repeat' times under different field names.
+ */
+BSONObj makeDocument(int repeat, int stringLength) {
+    BSONObjBuilder builder;
+    builder.append("_id", repeat);
+    const std::string value(stringLength, 'x');
+    for (int i = 0; i < repeat; ++i) {
+        const std::string suffix = std::to_string(i);
+        builder.append("name" + suffix, value);
+        builder.append("count" + suffix, i);
+        builder.append("total" + suffix, static_cast<long long>(i) * 1000);
+        builder.append("ratio" + suffix, i / 3.0);
+        builder.appendBool("active" + suffix, i % 2);
+        builder.appendDate("created" + suffix, Date_t::fromMillisSinceEpoch(i));
+        builder.append("address" + suffix,
+                       BSON("street" << value << "city" << value << "zip" << 12345));
+        builder.append("tags" + suffix, BSON_ARRAY(value << value << i));
+    }
+    return builder.obj();
+}
+
+void BM_validateBSON(benchmark::State& state, BSONObj obj) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+BENCHMARK_CAPTURE(BM_validateBSON, small, makeDocument(1, 8));
+BENCHMARK_CAPTURE(BM_validateBSON, wide, makeDocument(100, 8));
+BENCHMARK_CAPTURE(BM_validateBSON, longStrings, makeDocument(10, 1000));
+
+}  // namespace
+}  // namespace mongo
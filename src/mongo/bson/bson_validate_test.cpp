@@ -251,6 +251,30 @@ TEST(BSONValidateFast, NestedObject) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2, BSONVersion::kLatest));
 }
 
+TEST(BSONValidateFast, DeeplyNestedObjects) {
+    // Deeper than the fast path keeps track of, but within the maximum depth.
+    BSONObj x = BSON("innermost" << 1);
+    for (int i = 0; i < 100; i++) {
+        x = BSON("a" << x << "b" << BSON_ARRAY(i));
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+
+    // Give the innermost element an invalid type.
+    std::string data(x.objdata(), x.objsize());
+    const auto innermost = data.find("innermost");
+    ASSERT_NE(innermost, std::string::npos);
+    data[innermost - 1] = 0x42;
+    const Status status = validateBSON(data.data(), data.size(), BSONVersion::kLatest);
+    ASSERT_EQ(status, ErrorCodes::InvalidBSON);
+    ASSERT_STRING_CONTAINS(status.reason(), "invalid bson type");
+}
+
+TEST(BSONValidateFast, CodeWithScope) {
+    BSONObj x = BSON("a" << BSONCodeWScope("return b;", BSON("b" << 1)) << "c" << 2);
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+    ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() - 1, BSONVersion::kLatest));
+}
+
 TEST(BSONValidateFast, ErrorWithId) {
     BufBuilder bb;
     BSONObjBuilder ob(bb);
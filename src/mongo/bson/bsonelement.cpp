@@ -59,6 +59,56 @@ using std::string;
 const double BSONElement::kLongLongMaxPlusOneAsDouble =
     scalbn(1, std::numeric_limits<long long>::digits);
 
+namespace {
+
+/**
+ * Writes 'str' to 's' escaped the way escape() escapes it, but without building a copy of it:
+ * runs of characters which need no escaping are written as they are.
+ */
+void writeEscaped(std::stringstream& s, StringData str) {
+    static const char kHexDigits[] = "0123456789abcdef";
+
+    const char* run = str.rawData();
+    const char* const end = run + str.size();
+    for (const char* p = run; p < end; ++p) {
+        const char c = *p;
+        if (c != '"' && c != '\\' && !(c >= 0 && c <= 0x1f)) {
+            continue;
+        }
+
+        s.write(run, p - run);
+        run = p + 1;
+        switch (c) {
+            case '"':
+                s << "\\\"";
+                break;
+            case '\\':
+                s << "\\\\";
+                break;
+            case '\b':
+                s << "\\b";
+                break;
+            case '\f':
+                s << "\\f";
+                break;
+            case '\n':
+                s << "\\n";
+                break;
+            case '\r':
+                s << "\\r";
+                break;
+            case '\t':
+                s << "\\t";
+                break;
+            default:
+                s << "\\u00" << kHexDigits[c >> 4] << kHexDigits[c & 0xf];
+        }
+    }
+    s.write(run, end - run);
+}
+
+}  // namespace
+
 string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames, int pretty) const {
     std::stringstream s;
     BSONElement::jsonStringStream(format, includeFieldNames, pretty, s);
@@ -69,12 +119,17 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
                                    bool includeFieldNames,
                                    int pretty,
                                    std::stringstream& s) const {
-    if (includeFieldNames)
-        s << '"' << escape(fieldName()) << "\" : ";
+    if (includeFieldNames) {
+        s << '"';
+        writeEscaped(s, fieldNameStringData());
+        s << "\" : ";
+    }
     switch (type()) {
         case mongo::String:
         case Symbol:
-            s << '"' << escape(string(valuestr(), valuestrsize() - 1)) << '"';
+            s << '"';
+            writeEscaped(s, StringData(valuestr(), valuestrsize() - 1));
+            s << '"';
             break;
         case NumberLong:
             if (format == TenGen) {
@@ -75,6 +75,22 @@ public:
         _b.reserveBytes(1);
     }
 
+    /**
+     * Constructs a BSONObjBuilder whose buffer is allocated from 'arena', such as the arena of the
+     * OperationContext, rather than from the heap. The objects it builds reference the arena's
+     * memory: obj() returns an unowned BSONObj, which stays valid until the arena is destroyed.
+     */
+    explicit BSONObjBuilder(BufferArena* arena, int initsize = 512)
+        : _b(_buf), _buf(0), _offset(0), _s(this), _tracker(0), _doneCalled(false) {
+        _b.useArena(arena, initsize);
+
+        // Skip over space for the object length. The length is filled in by _done.
+        _b.skip(sizeof(int));
+
+        // Reserve space for the EOO byte. This means _done() can't fail.
+        _b.reserveBytes(1);
+    }
+
     /** @param baseBuilder construct a BSONObjBuilder using an existing BufBuilder
      *  This is for more efficient adding of subobjects/arrays. See docs for subobjStart for
      *  example.
@@ -665,12 +681,16 @@ public:
     /**
      * destructive
      * The returned BSONObj will free the buffer when it is finished.
-     * @return owned BSONObj
+     * @return owned BSONObj, or for a builder constructed on a BufferArena, an unowned BSONObj
+     * referencing the arena
     */
     template <typename BSONTraits = BSONObj::DefaultSizeTrait>
     BSONObj obj() {
         massert(10335, "builder does not own memory", owned());
         auto out = done<BSONTraits>();
+        if (_b.usesArena()) {
+            return out;
+        }
         out.shareOwnershipWith(_b.release());
         return out;
     }
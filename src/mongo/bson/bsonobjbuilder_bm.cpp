@@ -50,4 +50,36 @@ void BM_arrayBuilder(benchmark::State& state) {
 
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 
+// Builds many small objects, like the replies or index keys of an operation, either on the heap
+// or in an arena which lives as long as the operation.
+void BM_smallObjBuilder(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (auto j = 0; j < state.range(0); j++) {
+            BSONObjBuilder builder;
+            builder.append("_id", j);
+            builder.append("name", "value");
+            benchmark::DoNotOptimize(builder.obj());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_smallObjBuilderOnArena(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        BufferArena arena;
+        for (auto j = 0; j < state.range(0); j++) {
+            BSONObjBuilder builder(&arena);
+            builder.append("_id", j);
+            builder.append("name", "value");
+            benchmark::DoNotOptimize(builder.obj());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_smallObjBuilder)->Ranges({{{1}, {10'000}}});
+BENCHMARK(BM_smallObjBuilderOnArena)->Ranges({{{1}, {10'000}}});
+
 }  // namespace mongo
@@ -509,6 +509,41 @@ TEST(BSONObjBuilderTest, SizeChecks) {
     }
 }
 
+TEST(BSONObjBuilderTest, ObjBuiltOnArenaReferencesArena) {
+    BufferArena arena;
+    BSONObj obj;
+    {
+        BSONObjBuilder builder(&arena);
+        builder.append("a", 1);
+        builder.append("b", "two");
+        obj = builder.obj();
+    }
+
+    ASSERT_FALSE(obj.isOwned());
+    ASSERT_BSONOBJ_EQ(obj, BSON("a" << 1 << "b"
+                                    << "two"));
+}
+
+TEST(BSONObjBuilderTest, ObjBuiltOnArenaCanOutgrowInitialSize) {
+    BufferArena arena;
+    BSONObjBuilder builder(&arena, 16);
+    BSONObjBuilder expected;
+    for (int i = 0; i < 1000; ++i) {
+        builder.append(std::to_string(i), i);
+        expected.append(std::to_string(i), i);
+    }
+
+    // A sub-object built in the same arena-backed buffer.
+    {
+        BSONObjBuilder sub(builder.subobjStart("sub"));
+        sub.append("x", "y");
+    }
+    expected.append("sub", BSON("x"
+                                << "y"));
+
+    ASSERT_BSONOBJ_EQ(builder.obj(), expected.obj());
+}
+
 
 }  // namespace
 }  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/bson/json.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "mongo/base/parse_number.h"
@@ -1290,6 +1291,358 @@ bool JParse::isArray() {
     return peekToken(LBRACKET);
 }
 
+namespace {
+
+/**
+ * Parses objects in plain JSON, which is what tools and logs mostly produce, directly into BSON.
+ * Field names and strings without escapes are appended straight from the input and integers are
+ * converted without strtod, where JParse goes through std::string copies and token matching.
+ *
+ * Anything else, such as extended JSON types, unquoted field names, single quoted strings or
+ * unusual escapes, makes it give up so that the input is parsed by JParse instead. JParse then also
+ * reports any errors, so the fast path never changes what fromjson() accepts or produces.
+ */
+class FastJsonParser {
+public:
+    explicit FastJsonParser(StringData input)
+        : _begin(input.rawData()), _p(_begin), _end(_begin + input.size()) {}
+
+    /**
+     * Parses a top-level object into 'builder'. Returns false if the input has to be parsed by
+     * JParse instead, in which case 'builder' holds partial results.
+     */
+    bool parse(BSONObjBuilder& builder) {
+        skipWhitespace();
+        return consume('{') && objectBody(builder, 0);
+    }
+
+    int offset() const {
+        return _p - _begin;
+    }
+
+private:
+    // Deeper documents are left to JParse rather than growing the stack further.
+    static constexpr int kMaxDepth = 100;
+
+    void skipWhitespace() {
+        while (_p < _end && isspace(*reinterpret_cast<const unsigned char*>(_p))) {
+            ++_p;
+        }
+    }
+
+    bool consume(char c) {
+        if (_p < _end && *_p == c) {
+            ++_p;
+            return true;
+        }
+        return false;
+    }
+
+    bool literal(StringData token) {
+        if (StringData(_p, std::min<size_t>(_end - _p, token.size())) != token) {
+            return false;
+        }
+        _p += token.size();
+        return true;
+    }
+
+    /**
+     * Returns true if an object whose first field is 'fieldName' is an extended JSON type, such as
+     * {$oid: ...}, which JParse::object() converts.
+     */
+    static bool isReservedFieldName(StringData fieldName) {
+        static const StringData kReservedFieldNames[] = {"$oid"_sd,
+                                                         "$binary"_sd,
+                                                         "$date"_sd,
+                                                         "$timestamp"_sd,
+                                                         "$regex"_sd,
+                                                         "$ref"_sd,
+                                                         "$undefined"_sd,
+                                                         "$numberLong"_sd,
+                                                         "$numberDecimal"_sd,
+                                                         "$minKey"_sd,
+                                                         "$maxKey"_sd};
+        return fieldName.startsWith("$") &&
+            std::find(std::begin(kReservedFieldNames), std::end(kReservedFieldNames), fieldName) !=
+            std::end(kReservedFieldNames);
+    }
+
+    // Called after the opening brace.
+    bool objectBody(BSONObjBuilder& builder, int depth) {
+        skipWhitespace();
+        if (consume('}')) {
+            return true;
+        }
+
+        bool first = true;
+        do {
+            skipWhitespace();
+            StringData fieldName;
+            if (!string(&fieldName, false)) {
+                return false;
+            }
+            if (first && isReservedFieldName(fieldName)) {
+                return false;
+            }
+            first = false;
+
+            skipWhitespace();
+            if (!consume(':') || !value(fieldName, builder, depth)) {
+                return false;
+            }
+            skipWhitespace();
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // Called after the opening bracket.
+    bool arrayBody(BSONObjBuilder& builder, int depth) {
+        skipWhitespace();
+        if (consume(']')) {
+            return true;
+        }
+
+        uint32_t index = 0;
+        do {
+            if (!value(builder.numStr(index++), builder, depth)) {
+                return false;
+            }
+            skipWhitespace();
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool value(StringData fieldName, BSONObjBuilder& builder, int depth) {
+        skipWhitespace();
+        if (_p >= _end) {
+            return false;
+        }
+
+        switch (*_p) {
+            case '{': {
+                if (depth >= kMaxDepth) {
+                    return false;
+                }
+                ++_p;
+                BSONObjBuilder sub(builder.subobjStart(fieldName));
+                return objectBody(sub, depth + 1);
+            }
+            case '[': {
+                if (depth >= kMaxDepth) {
+                    return false;
+                }
+                ++_p;
+                BSONObjBuilder sub(builder.subarrayStart(fieldName));
+                return arrayBody(sub, depth + 1);
+            }
+            case '"': {
+                StringData str;
+                if (!string(&str, true)) {
+                    return false;
+                }
+                builder.append(fieldName, str);
+                return true;
+            }
+            case 't':
+                if (!literal("true")) {
+                    return false;
+                }
+                builder.append(fieldName, true);
+                return true;
+            case 'f':
+                if (!literal("false")) {
+                    return false;
+                }
+                builder.append(fieldName, false);
+                return true;
+            case 'n':
+                if (!literal("null")) {
+                    return false;
+                }
+                builder.appendNull(fieldName);
+                return true;
+            default:
+                return number(fieldName, builder);
+        }
+    }
+
+    /**
+     * Parses a double quoted string. Strings with escapes are only accepted if 'allowEscapes' is
+     * true, and are then unescaped into a buffer which is reused by the next such string.
+     */
+    bool string(StringData* out, bool allowEscapes) {
+        if (!consume('"')) {
+            return false;
+        }
+
+        const char* start = _p;
+        while (_p < _end && *_p != '"' && *_p != '\\') {
+            if (*reinterpret_cast<const unsigned char*>(_p) < 0x20) {
+                return false;
+            }
+            ++_p;
+        }
+        if (_p >= _end) {
+            return false;
+        }
+        if (*_p == '"') {
+            *out = StringData(start, _p++ - start);
+            return true;
+        }
+        if (!allowEscapes) {
+            return false;
+        }
+
+        _unescaped.assign(start, _p);
+        while (_p < _end && *_p != '"') {
+            if (*reinterpret_cast<const unsigned char*>(_p) < 0x20) {
+                return false;
+            }
+            if (*_p != '\\') {
+                _unescaped.push_back(*_p++);
+                continue;
+            }
+
+            if (_p + 1 >= _end) {
+                return false;
+            }
+            switch (_p[1]) {
+                case '"':
+                case '\'':
+                case '\\':
+                case '/':
+                    _unescaped.push_back(_p[1]);
+                    break;
+                case 'b':
+                    _unescaped.push_back('\b');
+                    break;
+                case 'f':
+                    _unescaped.push_back('\f');
+                    break;
+                case 'n':
+                    _unescaped.push_back('\n');
+                    break;
+                case 'r':
+                    _unescaped.push_back('\r');
+                    break;
+                case 't':
+                    _unescaped.push_back('\t');
+                    break;
+                case 'v':
+                    _unescaped.push_back('\v');
+                    break;
+                default:
+                    // Leave \u escapes and anything unusual to JParse.
+                    return false;
+            }
+            _p += 2;
+        }
+        if (_p >= _end) {
+            return false;
+        }
+        ++_p;
+        *out = _unescaped;
+        return true;
+    }
+
+    /**
+     * Parses a number in JSON syntax, typed the way JParse::number() types it: as an int if it is
+     * an integer which fits, else as a long long if it is an integer which fits, else as a double.
+     */
+    bool number(StringData fieldName, BSONObjBuilder& builder) {
+        const char* const start = _p;
+        const char* q = _p;
+        if (q < _end && *q == '-') {
+            ++q;
+        }
+        const char* const digits = q;
+        while (q < _end && isdigit(*reinterpret_cast<const unsigned char*>(q))) {
+            ++q;
+        }
+        if (q == digits) {
+            return false;
+        }
+        const size_t numDigits = q - digits;
+
+        bool isInteger = true;
+        if (q < _end && *q == '.') {
+            isInteger = false;
+            const char* const fraction = ++q;
+            while (q < _end && isdigit(*reinterpret_cast<const unsigned char*>(q))) {
+                ++q;
+            }
+            if (q == fraction) {
+                return false;
+            }
+        }
+        if (q < _end && (*q == 'e' || *q == 'E')) {
+            isInteger = false;
+            ++q;
+            if (q < _end && (*q == '+' || *q == '-')) {
+                ++q;
+            }
+            const char* const exponent = q;
+            while (q < _end && isdigit(*reinterpret_cast<const unsigned char*>(q))) {
+                ++q;
+            }
+            if (q == exponent) {
+                return false;
+            }
+        }
+
+        // The number has to end where strtod() would stop, and JParse rejects numbers at the end
+        // of the input.
+        if (q >= _end ||
+            !(isspace(*reinterpret_cast<const unsigned char*>(q)) || *q == ',' || *q == '}' ||
+              *q == ']')) {
+            return false;
+        }
+
+        if (isInteger && numDigits <= 18) {
+            long long n = 0;
+            for (const char* d = digits; d < q; ++d) {
+                n = n * 10 + (*d - '0');
+            }
+            if (start != digits) {
+                n = -n;
+            }
+            if (n == static_cast<int>(n)) {
+                builder.append(fieldName, static_cast<int>(n));
+            } else {
+                builder.append(fieldName, n);
+            }
+            _p = q;
+            return true;
+        }
+
+        char* endptrd;
+        char* endptrll;
+        errno = 0;
+        const double retd = strtod(start, &endptrd);
+        if (errno == ERANGE || endptrd != q) {
+            return false;
+        }
+        errno = 0;
+        const long long retll = strtoll(start, &endptrll, 10);
+        if (endptrll < endptrd || errno == ERANGE) {
+            builder.append(fieldName, retd);
+        } else if (retll == static_cast<int>(retll)) {
+            builder.append(fieldName, static_cast<int>(retll));
+        } else {
+            builder.append(fieldName, retll);
+        }
+        _p = q;
+        return true;
+    }
+
+    const char* const _begin;
+    const char* _p;
+    const char* const _end;
+    std::string _unescaped;
+};
+
+}  // namespace
+
 BSONObj fromjson(const char* jsonString, int* len) {
     MONGO_JSON_DEBUG("jsonString: " << jsonString);
     if (jsonString[0] == '\0') {
@@ -1297,7 +1650,21 @@ BSONObj fromjson(const char* jsonString, int* len) {
             *len = 0;
         return BSONObj();
     }
-    JParse jparse(jsonString);
+
+    const StringData input(jsonString);
+    try {
+        FastJsonParser fastParser(input);
+        BSONObjBuilder builder;
+        if (fastParser.parse(builder)) {
+            if (len)
+                *len = fastParser.offset();
+            return builder.obj();
+        }
+    } catch (const std::exception&) {
+        // Let JParse report the error.
+    }
+
+    JParse jparse(input);
     BSONObjBuilder builder;
     Status ret = Status::OK();
     try {
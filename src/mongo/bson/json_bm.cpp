@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+
+namespace mongo {
+namespace {
+
+// A document like those found in logs and exports, with 'numFields' fields of assorted types.
+BSONObj makeDocument(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; ++i) {
+        const auto fieldName = "field" + std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                builder.append(fieldName, i);
+                break;
+            case 1:
+                builder.append(fieldName, "a string value, with \"quotes\"");
+                break;
+            case 2:
+                builder.append(fieldName, i * 1.5);
+                break;
+            case 3:
+                builder.append(fieldName, BSON("nested" << i << "flag" << true));
+                break;
+        }
+    }
+    return builder.obj();
+}
+
+void BM_fromjson(benchmark::State& state) {
+    const std::string json = tojson(makeDocument(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fromjson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+void BM_fromjsonExtended(benchmark::State& state) {
+    BSONObjBuilder builder;
+    builder.append("_id", OID());
+    builder.append("date", Date_t::fromMillisSinceEpoch(1000));
+    builder.appendElements(makeDocument(state.range(0)));
+    const std::string json = tojson(builder.obj());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fromjson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+void BM_jsonString(benchmark::State& state) {
+    const BSONObj obj = makeDocument(state.range(0));
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        auto json = obj.jsonString();
+        totalBytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+BENCHMARK(BM_fromjson)->Arg(4)->Arg(64)->Arg(1024);
+BENCHMARK(BM_fromjsonExtended)->Arg(4)->Arg(64)->Arg(1024);
+BENCHMARK(BM_jsonString)->Arg(4)->Arg(64)->Arg(1024);
+
+}  // namespace
+}  // namespace mongo
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cfloat>
 #include <cinttypes>
 #include <cstdint>
@@ -50,6 +51,7 @@
 #include "mongo/stdx/type_traits.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/buffer_arena.h"
 #include "mongo/util/itoa.h"
 #include "mongo/util/shared_buffer.h"
 
@@ -84,30 +86,74 @@ public:
         invariant(!_buf.isShared());
     }
 
+    /**
+     * Allocates from 'arena' instead of the heap. The buffer then cannot be released, and stays
+     * valid after it is freed until the arena is destroyed.
+     */
+    explicit SharedBufferAllocator(BufferArena* arena) : _arena(arena) {}
+
     // Allow moving but not copying. It would be an error for two SharedBufferAllocators to use the
     // same underlying buffer.
     SharedBufferAllocator(SharedBufferAllocator&&) = default;
     SharedBufferAllocator& operator=(SharedBufferAllocator&&) = default;
 
     void malloc(size_t sz) {
-        _buf = SharedBuffer::allocate(sz);
+        if (_arena) {
+            _arenaBuf = _arena->allocate(sz);
+            _arenaCapacity = sz;
+            return;
+        }
+
+        _buf = sz < SharedBufferPool::kMinSizeClass ? SharedBuffer::allocate(sz)
+                                                     : SharedBuffer::allocatePooled(sz);
     }
-    void realloc(size_t sz) {
-        _buf.realloc(sz);
+    /**
+     * Grows the buffer to 'sz' bytes, preserving its first 'used' bytes.
+     */
+    void realloc(size_t sz, size_t used) {
+        if (_arena) {
+            _arenaBuf = _arena->reallocate(_arenaBuf, _arenaCapacity, sz);
+            _arenaCapacity = sz;
+            return;
+        }
+
+        if (sz < SharedBufferPool::kMinSizeClass) {
+            _buf.realloc(sz);
+            return;
+        }
+
+        // Move to a pooled buffer rather than growing in place, so that the old buffer can be
+        // reused by the next builder.
+        auto newBuf = SharedBuffer::allocatePooled(sz);
+        if (_buf) {
+            memcpy(newBuf.get(), _buf.get(), std::min(sz, used));
+        }
+        _buf = std::move(newBuf);
     }
     void free() {
         _buf = {};
+        _arenaBuf = nullptr;
+        _arenaCapacity = 0;
     }
     SharedBuffer release() {
+        invariant(!_arena);
         return std::move(_buf);
     }
 
     char* get() const {
-        return _buf.get();
+        return _arena ? _arenaBuf : _buf.get();
+    }
+
+    bool usesArena() const {
+        return _arena;
     }
 
 private:
     SharedBuffer _buf;
+
+    BufferArena* _arena = nullptr;
+    char* _arenaBuf = nullptr;
+    size_t _arenaCapacity = 0;
 };
 
 class StackAllocator {
@@ -124,7 +170,7 @@ public:
         if (sz > SZ)
             _ptr = mongoMalloc(sz);
     }
-    void realloc(size_t sz) {
+    void realloc(size_t sz, size_t used) {
         if (_ptr == _buf) {
             if (sz > SZ) {
                 _ptr = mongoMalloc(sz);
@@ -329,6 +375,26 @@ public:
         _buf = SharedBufferAllocator(std::move(buf));
     }
 
+    /**
+     * Makes this BufBuilder allocate its buffer of 'initsize' bytes, and any larger buffer it
+     * grows into, from 'arena'. The built data then stays valid until the arena is destroyed, even
+     * after this builder is, but cannot be released. Only legal to call when this builder is empty.
+     */
+    void useArena(BufferArena* arena, int initsize = 512) {
+        MONGO_STATIC_ASSERT(std::is_same<BufferAllocator, SharedBufferAllocator>());
+        invariant(l == 0);  // Can only do this while empty.
+        invariant(reservedBytes == 0);
+        _buf = SharedBufferAllocator(arena);
+        size = initsize;
+        if (size > 0) {
+            _buf.malloc(size);
+        }
+    }
+
+    bool usesArena() const {
+        return _buf.usesArena();
+    }
+
 private:
     template <typename T>
     void appendNumImpl(T t) {
@@ -350,7 +416,7 @@ private:
         while (a < minSize)
             a = a * 2;
 
-        _buf.realloc(a);
+        _buf.realloc(a, l);
         size = a;
     }
 
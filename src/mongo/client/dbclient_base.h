@@ -592,7 +592,8 @@ public:
         Exhaust mode sends back all data queries as fast as possible, with no back-and-forth for
         OP_GETMORE.  If you are certain you will exhaust the query, it could be useful.  If
         exhaust mode is not specified in 'queryOptions' or not available, this call transparently
-        falls back to using ordinary getMores.
+        falls back to using ordinary getMores. If it was specified but is not available, a
+        DBClientConnection sends each getMore ahead, while the previous batch is being processed.
 
         Use the DBClientCursorBatchIterator version, below, if you want to do items in large
         blocks, perhaps to avoid granular locking and such.
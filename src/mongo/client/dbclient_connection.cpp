@@ -524,16 +524,24 @@ unsigned long long DBClientConnection::query(stdx::function<void(DBClientCursorB
                                              const BSONObj* fieldsToReturn,
                                              int queryOptions,
                                              int batchSize) {
-    if (!(queryOptions & QueryOption_Exhaust) || !(availableOptions() & QueryOption_Exhaust)) {
+    if (!(queryOptions & QueryOption_Exhaust)) {
         return DBClientBase::query(f, nsOrUuid, query, fieldsToReturn, queryOptions, batchSize);
     }
 
     // mask options
     queryOptions &= (int)(QueryOption_NoCursorTimeout | QueryOption_SlaveOk | QueryOption_Exhaust);
 
+    // If the server cannot stream the batches, the caller still does not use the connection while
+    // iterating, so the cursor can request each batch while the previous one is being processed.
+    const bool readAhead = !(availableOptions() & QueryOption_Exhaust);
+    if (readAhead) {
+        queryOptions &= ~QueryOption_Exhaust;
+    }
+
     unique_ptr<DBClientCursor> c(
         this->query(nsOrUuid, query, 0, 0, fieldsToReturn, queryOptions, batchSize));
     uassert(13386, "socket error for mapping query", c.get());
+    c->setReadAhead(readAhead);
 
     unsigned long long n = 0;
 
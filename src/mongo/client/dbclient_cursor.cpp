@@ -192,6 +192,7 @@ bool DBClientCursor::init() {
         return false;
     }
     dataReceived(reply);
+    _sendReadAhead();
     return true;
 }
 
@@ -236,6 +237,10 @@ void DBClientCursor::requestMore() {
         return exhaustReceiveMore();
     }
 
+    if (_readAheadPending) {
+        return _receiveReadAhead();
+    }
+
     invariant(!_connectionHasPendingReplies);
     verify(cursorId && batch.pos == batch.objs.size());
 
@@ -250,8 +255,11 @@ void DBClientCursor::requestMore() {
         _client->call(toSend, response);
         dataReceived(response);
     };
-    if (_client)
-        return doRequestMore();
+    if (_client) {
+        doRequestMore();
+        _sendReadAhead();
+        return;
+    }
 
     invariant(_scopedHost.size());
     DBClientBase::withConnection_do_not_use(_scopedHost, [&](DBClientBase* conn) {
@@ -277,6 +285,38 @@ void DBClientCursor::exhaustReceiveMore() {
     dataReceived(response);
 }
 
+void DBClientCursor::setReadAhead(bool readAhead) {
+    _readAhead = readAhead;
+    _sendReadAhead();
+}
+
+void DBClientCursor::_sendReadAhead() {
+    if (!_readAhead || _connectionHasPendingReplies || !cursorId || !_client ||
+        !_scopedHost.empty() || haveLimit || tailable() || (opts & QueryOption_Exhaust) ||
+        !_client->lazySupported()) {
+        return;
+    }
+
+    Message toSend = _assembleGetMore();
+    _client->say(toSend);
+    _lastRequestId = toSend.header().getId();
+    _connectionHasPendingReplies = true;
+    _readAheadPending = true;
+}
+
+void DBClientCursor::_receiveReadAhead() {
+    invariant(_readAheadPending);
+    verify(batch.pos == batch.objs.size());
+    Message response;
+    _readAheadPending = false;
+    _connectionHasPendingReplies = false;
+    if (!_client->recv(response, _lastRequestId)) {
+        uasserted(51290, "recv failed while reading ahead on cursor");
+    }
+    dataReceived(response);
+    _sendReadAhead();
+}
+
 BSONObj DBClientCursor::commandDataReceived(const Message& reply) {
     int op = reply.operation();
     invariant(op == opReply || op == dbMsg);
@@ -570,6 +610,13 @@ DBClientCursor::~DBClientCursor() {
 
 void DBClientCursor::kill() {
     DESTRUCTOR_GUARD({
+        if (_readAheadPending) {
+            // Drain the reply to the 'getMore' sent ahead so that the connection can be reused.
+            Message response;
+            _readAheadPending = false;
+            _connectionHasPendingReplies = !_client->recv(response, _lastRequestId);
+        }
+
         if (cursorId && _ownCursor && !globalInShutdownDeprecated()) {
             auto killCursor = [&](auto&& conn) {
                 if (_useFindCommand) {
@@ -134,6 +134,16 @@ public:
         batchSize = newBatchSize;
     }
 
+    /**
+     * Enables reading ahead: once a batch has been received, the 'getMore' for the next batch is
+     * sent right away and its reply is only read when the current batch has been consumed, so that
+     * the round trip to the server overlaps with the processing of the current batch.
+     *
+     * Only cursors that own their connection and are neither tailable, exhaust nor limited read
+     * ahead. While a 'getMore' is in flight, the connection must not be used for anything else.
+     */
+    void setReadAhead(bool readAhead);
+
 
     /**
      * Fold this in with queryOptions to force the use of legacy query operations.
@@ -214,8 +224,8 @@ public:
      * If true, you should not try to use the connection for any other purpose or return it to a
      * pool.
      *
-     * This can happen if either initLazy() was called without initLazyFinish() or an exhaust query
-     * was started but not completed.
+     * This can happen if either initLazy() was called without initLazyFinish(), an exhaust query
+     * was started but not completed, or a 'getMore' was sent ahead by a read ahead cursor.
      */
     bool connectionHasPendingReplies() const {
         return _connectionHasPendingReplies;
@@ -273,6 +283,9 @@ private:
     bool _useFindCommand = true;
     bool _connectionHasPendingReplies = false;
     int _lastRequestId = 0;
+    bool _readAhead = false;
+    // Whether the pending reply on the connection is the reply to a 'getMore' sent ahead.
+    bool _readAheadPending = false;
 
     void dataReceived(const Message& reply) {
         bool retry;
@@ -289,6 +302,17 @@ private:
 
     void requestMore();
 
+    /**
+     * Sends the 'getMore' for the next batch without waiting for its reply, if read ahead is
+     * enabled and this cursor can read ahead.
+     */
+    void _sendReadAhead();
+
+    /**
+     * Receives the reply to the 'getMore' sent ahead by _sendReadAhead().
+     */
+    void _receiveReadAhead();
+
     // init pieces
     Message _assembleInit();
     Message _assembleGetMore();
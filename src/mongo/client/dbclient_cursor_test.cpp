@@ -69,6 +69,13 @@ public:
         return true;
     }
 
+    void say(Message& toSend, bool isRetry, std::string* actualServer) override {
+        // Intercept request.
+        toSend.header().setId(nextMessageId());
+        toSend.header().setResponseToMsgId(0);
+        _lastSent = toSend;
+    }
+
     bool recv(Message& m, int lastRequestId) override {
         m = _mockRecvResponse;
         return true;
@@ -439,5 +446,43 @@ TEST_F(DBClientCursorTest, DBClientCursorPassesReadOnceFlag) {
     ASSERT_TRUE(msg.body.getBoolField("readOnce")) << msg.body;
 }
 
+TEST_F(DBClientCursorTest, DBClientCursorReadsAheadWhenEnabled) {
+
+    // Set up the DBClientCursor and a mock client connection.
+    DBClientConnectionForTest conn;
+    const NamespaceString nss("test", "coll");
+    DBClientCursor cursor(
+        &conn, NamespaceStringOrUUID(nss), Query().obj, 0, 0, nullptr, /*QueryOption*/ 0, 0);
+    cursor.setBatchSize(1);
+
+    // Set up mock 'find' response.
+    const long long cursorId = 42;
+    conn.setCallResponse(mockFindResponse(nss, cursorId, {docObj(1)}));
+    ASSERT(cursor.init());
+    ASSERT_FALSE(cursor.connectionHasPendingReplies());
+
+    // Enabling read ahead sends the 'getMore' for the next batch before the first batch has been
+    // consumed.
+    conn.clearLastSentMessage();
+    cursor.setReadAhead(true);
+    auto m = conn.getLastSentMessage();
+    ASSERT(!m.empty());
+    auto msg = OpMsg::parse(m);
+    ASSERT_EQ(StringData(msg.body.firstElement().fieldName()), "getMore");
+    ASSERT_EQ(msg.body["getMore"].numberLong(), cursorId);
+    ASSERT(cursor.connectionHasPendingReplies());
+    ASSERT_BSONOBJ_EQ(docObj(1), cursor.next());
+
+    // The next batch is received without sending another request. Since the cursor is exhausted,
+    // nothing is sent ahead anymore.
+    conn.setRecvResponse(mockGetMoreResponse(nss, 0, {docObj(2)}));
+    conn.clearLastSentMessage();
+    ASSERT(cursor.more());
+    ASSERT(conn.getLastSentMessage().empty());
+    ASSERT_FALSE(cursor.connectionHasPendingReplies());
+    ASSERT_BSONOBJ_EQ(docObj(2), cursor.next());
+    ASSERT(cursor.isDead());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -95,6 +95,12 @@ public:
      */
     virtual void markHostUnreachable(const HostAndPort& host, const Status& status) = 0;
 
+    /**
+     * Reports to the targeter that an operation sent to 'host' took 'latency' to complete, so
+     * that it can prefer faster hosts on subsequent requests which may go to several hosts.
+     */
+    virtual void noteOperationLatency(const HostAndPort& host, Milliseconds latency) = 0;
+
 protected:
     RemoteCommandTargeter() = default;
 };
@@ -71,6 +71,8 @@ public:
      */
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    void noteOperationLatency(const HostAndPort& host, Milliseconds latency) override;
+
     /**
      * Sets the return value for the next call to connectionString.
      */
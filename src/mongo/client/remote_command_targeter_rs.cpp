@@ -94,4 +94,10 @@ void RemoteCommandTargeterRS::markHostUnreachable(const HostAndPort& host, const
     _rsMonitor->failedHost(host, status);
 }
 
+void RemoteCommandTargeterRS::noteOperationLatency(const HostAndPort& host, Milliseconds latency) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->noteOperationLatency(host, latency);
+}
+
 }  // namespace mongo
@@ -54,6 +54,8 @@ public:
 
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    void noteOperationLatency(const HostAndPort& host, Milliseconds latency) override;
+
 private:
     const HostAndPort _hostAndPort;
 };
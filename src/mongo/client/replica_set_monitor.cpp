@@ -39,6 +39,7 @@
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/client/connpool.h"
 #include "mongo/client/global_conn_pool.h"
+#include "mongo/client/global_conn_pool_gen.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/client/replica_set_monitor_internal.h"
 #include "mongo/db/operation_context.h"
@@ -115,6 +116,18 @@ bool compareLatencies(const Node* lhs, const Node* rhs) {
     return lhs->latencyMicros < rhs->latencyMicros;
 }
 
+bool compareOperationLatencies(const Node* lhs, const Node* rhs) {
+    // Nodes which weren't sent any operations yet compare better than all others, so they are
+    // tried out.
+    const auto lhsLatency = lhs->operationLatencyMicros == unknownLatency
+        ? 0
+        : lhs->operationLatencyMicros;
+    const auto rhsLatency = rhs->operationLatencyMicros == unknownLatency
+        ? 0
+        : rhs->operationLatencyMicros;
+    return lhsLatency < rhsLatency;
+}
+
 bool hostsEqual(const Node& lhs, const HostAndPort& rhs) {
     return lhs.host == rhs;
 }
@@ -319,11 +332,29 @@ HostAndPort ReplicaSetMonitor::getMasterOrUassert() {
 void ReplicaSetMonitor::failedHost(const HostAndPort& host, const Status& status) {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
-    if (node)
+    if (node) {
+        const bool wasMaster = node->isMaster;
         node->markFailed(status);
+
+        // The in-progress scan took its view of the set from the primary that just failed. Drop it
+        // rather than letting waiters for a new primary join it, since it may still be waiting for
+        // hosts that don't respond until it completes.
+        if (wasMaster && _state->currentScan && _state->currentScan->foundUpMaster) {
+            LOG(1) << "Abandoning the refresh of replica set " << getName()
+                   << " in progress because its primary " << host << " failed";
+            _state->currentScan.reset();
+        }
+    }
     DEV _state->checkInvariants();
 }
 
+void ReplicaSetMonitor::noteOperationLatency(const HostAndPort& host, Milliseconds latency) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (node)
+        node->updateOperationLatency(durationCount<Microseconds>(latency));
+}
+
 bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -937,7 +968,17 @@ void IsMasterReply::parse(const BSONObj& obj) {
     }
 }
 
-Node::Node(const HostAndPort& host) : host(host), latencyMicros(unknownLatency) {}
+Node::Node(const HostAndPort& host)
+    : host(host), latencyMicros(unknownLatency), operationLatencyMicros(unknownLatency) {}
+
+void Node::updateOperationLatency(int64_t micros) {
+    if (operationLatencyMicros == unknownLatency) {
+        operationLatencyMicros = micros;
+    } else {
+        // update latency with smoothed moving average (1/4th the delta)
+        operationLatencyMicros += (micros - operationLatencyMicros) / 4;
+    }
+}
 
 void Node::markFailed(const Status& status) {
     if (isUp) {
@@ -1003,6 +1044,12 @@ void Node::update(const IsMasterReply& reply) {
         }
     }
 
+    // Nodes which were slow are rarely selected, so their operation latency would otherwise stay
+    // high after they recover. Halve it on every scan so that they are tried again eventually.
+    if (operationLatencyMicros != unknownLatency) {
+        operationLatencyMicros /= 2;
+    }
+
     LOG(3) << "Updating " << host << " lastWriteDate to " << reply.lastWriteDate;
     lastWriteDate = reply.lastWriteDate;
 
@@ -1186,6 +1233,18 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                 if (ReplicaSetMonitor::useDeterministicHostSelection) {
                     // only in tests
                     return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
+                } else if (replicaSetMonitorSelectsByOperationLatency.load()) {
+                    // Pick two of the nodes at random and use the one whose operations were
+                    // faster recently. This steers reads away from a node which is slow to
+                    // answer, while still spreading them over the others.
+                    const auto first = rand.nextInt32(matchingNodes.size());
+                    auto second = rand.nextInt32(matchingNodes.size() - 1);
+                    if (second >= first) {
+                        second++;
+                    }
+                    return compareOperationLatencies(matchingNodes[second], matchingNodes[first])
+                        ? matchingNodes[second]->host
+                        : matchingNodes[first]->host;
                 } else {
                     // normal case
                     return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
@@ -112,9 +112,19 @@ public:
      * Call this when you get a connection error. If you get an error while trying to refresh our
      * view of a host, call Refresher::failedHost instead because it bypasses taking the monitor's
      * mutex.
+     *
+     * If 'host' was the primary, a scan in progress that already relied on it is abandoned, so that
+     * the next refresh starts a new scan instead of waiting for the stale one to complete.
      */
     void failedHost(const HostAndPort& host, const Status& status);
 
+    /**
+     * Notifies this Monitor that an operation sent to 'host' took 'latency' to complete, from
+     * sending the request until receiving the response. Reads prefer hosts whose operations
+     * completed faster recently, see SetState::getMatchingHost.
+     */
+    void noteOperationLatency(const HostAndPort& host, Milliseconds latency);
+
     /**
      * Returns true if this node is the master based ONLY on local data. Be careful, return may
      * be stale.
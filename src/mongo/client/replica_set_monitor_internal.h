@@ -124,10 +124,18 @@ public:
          */
         void update(const IsMasterReply& reply);
 
+        /**
+         * Updates the smoothed latency of the operations sent to this node.
+         */
+        void updateOperationLatency(int64_t micros);
+
         HostAndPort host;
         bool isUp{false};
         bool isMaster{false};
         int64_t latencyMicros{};
+        // Smoothed latency of the operations sent to this node, as opposed to 'latencyMicros',
+        // which only measures isMaster round trips.
+        int64_t operationLatencyMicros{};
         BSONObj tags;  // owned
         int minWireVersion{};
         int maxWireVersion{};
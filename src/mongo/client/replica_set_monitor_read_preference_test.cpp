@@ -299,6 +299,27 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, SecOnlyPrefersLowerOperationLatency) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    nodes[0].latencyMicros = 1 * 1000;
+    nodes[2].latencyMicros = 1 * 1000;
+
+    nodes[0].updateOperationLatency(50 * 1000);
+    nodes[2].updateOperationLatency(1 * 1000);
+
+    // Both secondaries are equally close, but operations on 'c' completed faster.
+    for (int i = 0; i < 10; i++) {
+        bool isPrimarySelected = false;
+        HostAndPort host =
+            selectNode(nodes, mongo::ReadPreference::SecondaryOnly, tags, 3, &isPrimarySelected);
+
+        ASSERT_EQUALS("c", host.host());
+        ASSERT(!isPrimarySelected);
+    }
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
@@ -973,6 +973,52 @@ TEST(ReplicaSetMonitor, OutOfBandFailedHost) {
     }
 }
 
+// Ensure that an out-of-band failure of the primary abandons a scan that already found it
+TEST(ReplicaSetMonitor, OutOfBandFailedPrimaryAbandonsScan) {
+    SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
+    ReplicaSetMonitorPtr rsm = std::make_shared<ReplicaSetMonitor>(state);
+    Refresher refresher(state);
+
+    for (size_t i = 0; i != basicSeeds.size(); ++i) {
+        NextStep ns = refresher.getNextStep();
+        ASSERT_EQUALS(ns.step, NextStep::CONTACT_HOST);
+    }
+
+    refresher.receivedIsMaster(HostAndPort("a"),
+                               -1,
+                               BSON("setName"
+                                    << "name"
+                                    << "ismaster"
+                                    << true
+                                    << "secondary"
+                                    << false
+                                    << "hosts"
+                                    << BSON_ARRAY("a"
+                                                  << "b"
+                                                  << "c")
+                                    << "ok"
+                                    << true));
+
+    // Failing a secondary keeps the scan going.
+    rsm->failedHost(HostAndPort("b"), {ErrorCodes::InternalError, "Test error"});
+    ASSERT(state->currentScan);
+    ASSERT_EQUALS(refresher.getNextStep().step, NextStep::WAIT);
+
+    // Failing the primary abandons the scan, and the next refresh contacts all hosts again.
+    rsm->failedHost(HostAndPort("a"), {ErrorCodes::InternalError, "Test error"});
+    ASSERT(!state->currentScan);
+    ASSERT_EQUALS(refresher.getNextStep().step, NextStep::DONE);
+
+    Refresher newRefresher(state);
+    std::set<HostAndPort> seen;
+    for (size_t i = 0; i != basicSeeds.size(); ++i) {
+        NextStep ns = newRefresher.getNextStep();
+        ASSERT_EQUALS(ns.step, NextStep::CONTACT_HOST);
+        seen.insert(ns.host);
+    }
+    ASSERT(basicSeedsSet == seen);
+}
+
 // Newly elected primary with electionId >= maximum electionId seen by the Refresher
 TEST(ReplicaSetMonitorTests, NewPrimaryWithMaxElectionId) {
     SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
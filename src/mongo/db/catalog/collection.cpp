@@ -60,6 +60,11 @@ void CappedInsertNotifier::waitUntil(uint64_t prevVersion, Date_t deadline) cons
     }
 }
 
+uint64_t CappedInsertNotifier::getVersion() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _version;
+}
+
 void CappedInsertNotifier::kill() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _dead = true;
@@ -1024,10 +1024,18 @@ void _genericRecordStoreValidate(OperationContext* opCtx,
     int interruptInterval = 4096;
     RecordId prevRecordId;
 
+    ProgressMeterHolder progress;
+    {
+        stdx::unique_lock<Client> lk(*opCtx->getClient());
+        progress.set(CurOp::get(opCtx)->setProgress_inlock("Validate: scanning documents",
+                                                           recordStore->numRecords(opCtx)));
+    }
+
     while (auto record = cursor->next()) {
         if (!(nrecords % interruptInterval)) {
             opCtx->checkForInterrupt();
         }
+        progress->hit();
         ++nrecords;
         auto dataSize = record->data.size();
         dataSizeTotal += dataSize;
@@ -1053,6 +1061,7 @@ void _genericRecordStoreValidate(OperationContext* opCtx,
 
         prevRecordId = record->id;
     }
+    progress->finished();
 
     if (results->valid) {
         recordStore->updateStatsAfterRepair(opCtx, nrecords, dataSizeTotal);
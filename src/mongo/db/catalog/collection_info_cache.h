@@ -104,6 +104,13 @@ public:
     virtual void notifyOfQuery(OperationContext* const opCtx,
                                const std::set<std::string>& indexesUsed) = 0;
 
+    /**
+     * Signal to the cache that a write to the collection has maintained index 'indexName' at cost
+     * 'cost'.
+     */
+    virtual void notifyOfIndexWrite(StringData indexName,
+                                    const CollectionIndexUsageTracker::IndexWriteCost& cost) = 0;
+
     virtual void setNs(NamespaceString ns) = 0;
 };
 }  // namespace mongo
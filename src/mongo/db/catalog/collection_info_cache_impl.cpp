@@ -172,6 +172,11 @@ void CollectionInfoCacheImpl::notifyOfQuery(OperationContext* opCtx,
     }
 }
 
+void CollectionInfoCacheImpl::notifyOfIndexWrite(
+    StringData indexName, const CollectionIndexUsageTracker::IndexWriteCost& cost) {
+    _indexUsageTracker.recordIndexWrite(indexName, cost);
+}
+
 void CollectionInfoCacheImpl::clearQueryCache() {
     LOG(1) << _collection->ns() << ": clearing plan cache - collection info cache reset";
     if (NULL != _planCache.get()) {
@@ -108,6 +108,9 @@ public:
      */
     void notifyOfQuery(OperationContext* opCtx, const std::set<std::string>& indexesUsed);
 
+    void notifyOfIndexWrite(StringData indexName,
+                            const CollectionIndexUsageTracker::IndexWriteCost& cost) override;
+
     void setNs(NamespaceString ns) override;
 
 private:
@@ -75,15 +75,33 @@ Database* DatabaseHolderImpl::getDb(OperationContext* opCtx, StringData ns) cons
     const StringData db = _todb(ns);
     invariant(opCtx->lockState()->isDbLockedForMode(db, MODE_IS));
 
-    stdx::lock_guard<SimpleMutex> lk(_m);
-    DBs::const_iterator it = _dbs.find(db);
-    if (it != _dbs.end()) {
+    const DBs& openDbs = _getOpenDbs();
+    DBs::const_iterator it = openDbs.find(db);
+    if (it != openDbs.end()) {
         return it->second;
     }
 
     return NULL;
 }
 
+const DatabaseHolderImpl::DBs& DatabaseHolderImpl::_getOpenDbs() const {
+    if (auto openDbs = _openDbs.get()) {
+        return *openDbs;
+    }
+
+    stdx::lock_guard<SimpleMutex> lk(_m);
+    if (!_openDbs.get()) {
+        auto openDbs = std::make_shared<DBs>();
+        for (const auto& nameAndPointer : _dbs) {
+            if (nameAndPointer.second) {
+                openDbs->insert(nameAndPointer);
+            }
+        }
+        _openDbs.publish(std::move(openDbs));
+    }
+    return *_openDbs.get();
+}
+
 std::set<std::string> DatabaseHolderImpl::_getNamesWithConflictingCasing_inlock(StringData name) {
     std::set<std::string> duplicates;
 
@@ -156,6 +174,7 @@ Database* DatabaseHolderImpl::openDb(OperationContext* opCtx, StringData ns, boo
     invariant(it != _dbs.end() && it->second == nullptr);
     it->second = newDb.release();
     invariant(_getNamesWithConflictingCasing_inlock(dbname.toString()).empty());
+    _openDbs.invalidate();
 
     return it->second;
 }
@@ -218,6 +237,7 @@ void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns) {
     db = nullptr;
 
     _dbs.erase(it);
+    _openDbs.invalidate();
 
     getGlobalServiceContext()
         ->getStorageEngine()
@@ -246,6 +266,7 @@ void DatabaseHolderImpl::closeAll(OperationContext* opCtx) {
         delete db;
 
         _dbs.erase(name);
+        _openDbs.invalidate();
 
         getGlobalServiceContext()
             ->getStorageEngine()
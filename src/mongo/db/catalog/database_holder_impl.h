@@ -31,6 +31,7 @@
 
 #include "mongo/db/catalog/database_holder.h"
 
+#include "mongo/util/concurrency/copy_on_write_snapshot.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
 
@@ -60,12 +61,24 @@ public:
                                                DatabaseCatalogEntry* const dbce) override;
 
 private:
+    typedef StringMap<Database*> DBs;
+
     std::set<std::string> _getNamesWithConflictingCasing_inlock(StringData name);
 
-    typedef StringMap<Database*> DBs;
+    /**
+     * Returns a copy of the open databases in '_dbs', building it first if a database was opened
+     * or closed since it was last built. The result is valid until the calling thread calls this
+     * again.
+     */
+    const DBs& _getOpenDbs() const;
+
     mutable SimpleMutex _m;
     DBs _dbs;
 
+    // Read by getDb() without taking '_m'. Invalidated under '_m' whenever a database is opened or
+    // closed. Unlike '_dbs', holds no entries for databases that are still being opened.
+    mutable CopyOnWriteSnapshot<DBs> _openDbs;
+
     // Databases objects and their constituent collections are destroyed and recreated when
     // databases are closed and opened. We use this counter to assign a new epoch to a database when
     // it is reopened. This permits callers to detect after yielding and reacquiring locks whether
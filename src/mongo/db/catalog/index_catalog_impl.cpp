@@ -70,6 +70,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/represent_as.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -1159,7 +1160,13 @@ const IndexDescriptor* IndexCatalogImpl::refreshEntry(OperationContext* opCtx,
 Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
                                                IndexCatalogEntry* index,
                                                const std::vector<BsonRecord>& bsonRecords,
-                                               int64_t* keysInsertedOut) {
+                                               int64_t* keysInsertedOut,
+                                               int64_t* bytesInsertedOut) {
+    if (bsonRecords.size() > 1 && !index->isHybridBuilding()) {
+        return _indexFilteredRecordsInKeyOrder(
+            opCtx, index, bsonRecords, keysInsertedOut, bytesInsertedOut);
+    }
+
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
@@ -1192,6 +1199,9 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
             if (keysInsertedOut) {
                 *keysInsertedOut += result.numInserted;
             }
+            if (bytesInsertedOut) {
+                *bytesInsertedOut += result.bytesInserted;
+            }
         }
 
         if (!status.isOK()) {
@@ -1201,13 +1211,148 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexCatalogImpl::_indexFilteredRecordsInKeyOrder(OperationContext* opCtx,
+                                                         IndexCatalogEntry* index,
+                                                         const std::vector<BsonRecord>& bsonRecords,
+                                                         int64_t* keysInsertedOut,
+                                                         int64_t* bytesInsertedOut) {
+    invariant(!index->isHybridBuilding());
+    invariant(!bsonRecords.empty());
+
+    InsertDeleteOptions options;
+    prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
+    IndexAccessMethod* accessMethod = index->accessMethod();
+    const BSONObjSet noKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+
+    struct KeyToInsert {
+        BSONObj key;
+        const BsonRecord* record;
+    };
+    std::vector<KeyToInsert> keysToInsert;
+    keysToInsert.reserve(bsonRecords.size());
+
+    // Generate the keys of every record up front, collecting the multikey information of the
+    // whole batch along the way.
+    BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths multikeyPaths;
+    bool isMultikey = false;
+    for (auto&& bsonRecord : bsonRecords) {
+        invariant(bsonRecord.id != RecordId());
+
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet recordMultikeyMetadataKeys =
+            SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths recordMultikeyPaths;
+        accessMethod->getKeys(*bsonRecord.docPtr,
+                              options.getKeysMode,
+                              &keys,
+                              &recordMultikeyMetadataKeys,
+                              &recordMultikeyPaths);
+
+        isMultikey = isMultikey ||
+            accessMethod->shouldMarkIndexAsMultikey(
+                keys, recordMultikeyMetadataKeys, recordMultikeyPaths);
+        if (multikeyPaths.size() < recordMultikeyPaths.size()) {
+            multikeyPaths.resize(recordMultikeyPaths.size());
+        }
+        for (size_t i = 0; i < recordMultikeyPaths.size(); ++i) {
+            multikeyPaths[i].insert(recordMultikeyPaths[i].begin(), recordMultikeyPaths[i].end());
+        }
+        multikeyMetadataKeys.insert(recordMultikeyMetadataKeys.begin(),
+                                    recordMultikeyMetadataKeys.end());
+
+        for (auto&& key : keys) {
+            keysToInsert.push_back({key, &bsonRecord});
+        }
+    }
+
+    // The index must be marked multikey no later than the first key which makes it so becomes
+    // visible, so do it first, at the timestamp of the earliest record in the batch.
+    const Timestamp& firstTimestamp = bsonRecords.front().ts;
+    Timestamp lastTimestampSet;
+    if (isMultikey || !multikeyMetadataKeys.empty()) {
+        if (!firstTimestamp.isNull()) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(firstTimestamp);
+            if (!status.isOK())
+                return status;
+            lastTimestampSet = firstTimestamp;
+        }
+
+        InsertResult result;
+        Status status = accessMethod->insertKeys(opCtx,
+                                                 noKeys,
+                                                 multikeyMetadataKeys,
+                                                 multikeyPaths,
+                                                 bsonRecords.front().id,
+                                                 options,
+                                                 &result);
+        if (!status.isOK())
+            return status;
+        if (keysInsertedOut) {
+            *keysInsertedOut += result.numInserted;
+        }
+        if (bytesInsertedOut) {
+            *bytesInsertedOut += result.bytesInserted;
+        }
+        if (isMultikey) {
+            accessMethod->setIndexIsMultikey(opCtx, multikeyPaths);
+        }
+    }
+
+    const Ordering ordering = Ordering::make(index->descriptor()->keyPattern());
+    std::sort(keysToInsert.begin(),
+              keysToInsert.end(),
+              [&](const KeyToInsert& lhs, const KeyToInsert& rhs) {
+                  const int cmp = lhs.key.woCompare(rhs.key, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.record->id < rhs.record->id);
+              });
+
+    // Each key is still written at the timestamp of the record it belongs to.
+    for (auto&& keyToInsert : keysToInsert) {
+        const BsonRecord& bsonRecord = *keyToInsert.record;
+        if (!bsonRecord.ts.isNull() && bsonRecord.ts != lastTimestampSet) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(bsonRecord.ts);
+            if (!status.isOK())
+                return status;
+            lastTimestampSet = bsonRecord.ts;
+        }
+
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        keys.insert(keyToInsert.key);
+        InsertResult result;
+        Status status = accessMethod->insertKeys(
+            opCtx, keys, noKeys, MultikeyPaths{}, bsonRecord.id, options, &result);
+        if (!status.isOK())
+            return status;
+        if (keysInsertedOut) {
+            *keysInsertedOut += result.numInserted;
+        }
+        if (bytesInsertedOut) {
+            *bytesInsertedOut += result.bytesInserted;
+        }
+    }
+
+    // Leave the timestamp of later writes in this unit of work where indexing the records one at a
+    // time would have left it.
+    const Timestamp& lastTimestamp = bsonRecords.back().ts;
+    if (!lastTimestamp.isNull() && lastTimestamp != lastTimestampSet) {
+        Status status = opCtx->recoveryUnit()->setTimestamp(lastTimestamp);
+        if (!status.isOK())
+            return status;
+    }
+
+    return Status::OK();
+}
+
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        IndexCatalogEntry* index,
                                        const std::vector<BsonRecord>& bsonRecords,
-                                       int64_t* keysInsertedOut) {
+                                       int64_t* keysInsertedOut,
+                                       int64_t* bytesInsertedOut) {
     const MatchExpression* filter = index->getFilterExpression();
     if (!filter)
-        return _indexFilteredRecords(opCtx, index, bsonRecords, keysInsertedOut);
+        return _indexFilteredRecords(
+            opCtx, index, bsonRecords, keysInsertedOut, bytesInsertedOut);
 
     std::vector<BsonRecord> filteredBsonRecords;
     for (auto bsonRecord : bsonRecords) {
@@ -1215,7 +1360,8 @@ Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
             filteredBsonRecords.push_back(bsonRecord);
     }
 
-    return _indexFilteredRecords(opCtx, index, filteredBsonRecords, keysInsertedOut);
+    return _indexFilteredRecords(
+        opCtx, index, filteredBsonRecords, keysInsertedOut, bytesInsertedOut);
 }
 
 Status IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
@@ -1276,13 +1422,21 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
     }
 
     for (auto&& it : _readyIndexes) {
-        Status s = _indexRecords(opCtx, it.get(), bsonRecords, keysInsertedOut);
+        Timer timer;
+        CollectionIndexUsageTracker::IndexWriteCost cost;
+        Status s =
+            _indexRecords(opCtx, it.get(), bsonRecords, &cost.keysInserted, &cost.bytesInserted);
         if (!s.isOK())
             return s;
+        cost.micros = timer.micros();
+        _recordIndexWrite(it.get(), cost);
+        if (keysInsertedOut) {
+            *keysInsertedOut += cost.keysInserted;
+        }
     }
 
     for (auto&& it : _buildingIndexes) {
-        Status s = _indexRecords(opCtx, it.get(), bsonRecords, keysInsertedOut);
+        Status s = _indexRecords(opCtx, it.get(), bsonRecords, keysInsertedOut, nullptr);
         if (!s.isOK())
             return s;
     }
@@ -1308,6 +1462,7 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
         IndexDescriptor* descriptor = entry->descriptor();
         IndexAccessMethod* iam = entry->accessMethod();
 
+        Timer timer;
         InsertDeleteOptions options;
         prepareInsertDeleteOptions(opCtx, descriptor, &options);
 
@@ -1318,14 +1473,18 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
         if (!status.isOK())
             return status;
 
-        int64_t keysInserted;
-        int64_t keysDeleted;
-        status = iam->update(opCtx, updateTicket, &keysInserted, &keysDeleted);
+        CollectionIndexUsageTracker::IndexWriteCost cost;
+        status = iam->update(opCtx, updateTicket, &cost.keysInserted, &cost.keysDeleted);
         if (!status.isOK())
             return status;
 
-        *keysInsertedOut += keysInserted;
-        *keysDeletedOut += keysDeleted;
+        // An update that leaves the keys of an index alone costs it no more than key generation.
+        cost.bytesInserted = updateTicket.getAddedKeysSize();
+        cost.micros = timer.micros();
+        _recordIndexWrite(entry, cost);
+
+        *keysInsertedOut += cost.keysInserted;
+        *keysDeletedOut += cost.keysDeleted;
     }
 
     // Building indexes go through the interceptor.
@@ -1338,7 +1497,7 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
         bool logIfError = false;
         invariant(_unindexRecord(opCtx, entry, oldDoc, recordId, logIfError, keysDeletedOut));
 
-        auto status = _indexRecords(opCtx, entry, {record}, keysInsertedOut);
+        auto status = _indexRecords(opCtx, entry, {record}, keysInsertedOut, nullptr);
         if (!status.isOK())
             return status;
     }
@@ -1359,8 +1518,15 @@ void IndexCatalogImpl::unindexRecord(OperationContext* opCtx,
          ++it) {
         IndexCatalogEntry* entry = it->get();
 
+        Timer timer;
+        CollectionIndexUsageTracker::IndexWriteCost cost;
         bool logIfError = !noWarn;
-        invariant(_unindexRecord(opCtx, entry, obj, loc, logIfError, keysDeletedOut));
+        invariant(_unindexRecord(opCtx, entry, obj, loc, logIfError, &cost.keysDeleted));
+        cost.micros = timer.micros();
+        _recordIndexWrite(entry, cost);
+        if (keysDeletedOut) {
+            *keysDeletedOut += cost.keysDeleted;
+        }
     }
 
     for (IndexCatalogEntryContainer::const_iterator it = _buildingIndexes.begin();
@@ -1374,6 +1540,11 @@ void IndexCatalogImpl::unindexRecord(OperationContext* opCtx,
     }
 }
 
+void IndexCatalogImpl::_recordIndexWrite(IndexCatalogEntry* index,
+                                         const CollectionIndexUsageTracker::IndexWriteCost& cost) {
+    _collection->infoCache()->notifyOfIndexWrite(index->descriptor()->indexName(), cost);
+}
+
 Status IndexCatalogImpl::compactIndexes(OperationContext* opCtx) {
     for (IndexCatalogEntryContainer::const_iterator it = _readyIndexes.begin();
          it != _readyIndexes.end();
@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/index_catalog.h"
 
 #include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/collection_index_usage_tracker.h"
 #include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
@@ -374,12 +375,29 @@ private:
     Status _indexFilteredRecords(OperationContext* opCtx,
                                  IndexCatalogEntry* index,
                                  const std::vector<BsonRecord>& bsonRecords,
-                                 int64_t* keysInsertedOut);
+                                 int64_t* keysInsertedOut,
+                                 int64_t* bytesInsertedOut);
 
+    /**
+     * Indexes a batch of records by generating the keys of all of them first and then inserting
+     * the keys in index order, so that consecutive inserts land on neighbouring index pages.
+     * Equivalent to indexing each record in turn. Must not be used on hybrid index builds.
+     */
+    Status _indexFilteredRecordsInKeyOrder(OperationContext* opCtx,
+                                           IndexCatalogEntry* index,
+                                           const std::vector<BsonRecord>& bsonRecords,
+                                           int64_t* keysInsertedOut,
+                                           int64_t* bytesInsertedOut);
+
+    /**
+     * Indexes 'bsonRecords' in 'index', adding the number of keys inserted to 'keysInsertedOut'
+     * and their total size to 'bytesInsertedOut', either of which may be null.
+     */
     Status _indexRecords(OperationContext* opCtx,
                          IndexCatalogEntry* index,
                          const std::vector<BsonRecord>& bsonRecords,
-                         int64_t* keysInsertedOut);
+                         int64_t* keysInsertedOut,
+                         int64_t* bytesInsertedOut);
 
     Status _unindexRecord(OperationContext* opCtx,
                           IndexCatalogEntry* index,
@@ -388,6 +406,13 @@ private:
                           bool logIfError,
                           int64_t* keysDeletedOut);
 
+    /**
+     * Reports the cost of maintaining the ready index 'index' for one write to the collection's
+     * index usage statistics.
+     */
+    void _recordIndexWrite(IndexCatalogEntry* index,
+                           const CollectionIndexUsageTracker::IndexWriteCost& cost);
+
     /**
      * this does no sanity checks
      */
@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -51,6 +53,12 @@ namespace {
 // The number of items we can scan before we must yield.
 static const int kScanLimit = 1000;
 
+// Bounds on the number of buckets used to count index keys and document keys. The number of
+// buckets grows with the expected number of keys so that unrelated mismatches rarely cancel out,
+// up to the maximum.
+const uint64_t kMinKeyCountBuckets = 1 << 16;
+const uint64_t kMaxKeyCountBuckets = 1 << 22;
+
 // TODO SERVER-36385: Completely remove the key size check in 4.4
 bool largeKeyDisallowed() {
     return (serverGlobalParams.featureCompatibility.getVersion() ==
@@ -104,6 +112,15 @@ IndexConsistency::IndexConsistency(OperationContext* opCtx,
 
         indexNumber++;
     }
+
+    // Estimate one key per index per document, ignoring multikey indexes.
+    const uint64_t expectedKeys =
+        std::max<int64_t>(_recordStore->numRecords(opCtx), 1) * std::max(indexNumber, 1);
+    uint64_t numBuckets = kMinKeyCountBuckets;
+    while (numBuckets < expectedKeys && numBuckets < kMaxKeyCountBuckets) {
+        numBuckets <<= 1;
+    }
+    _indexKeyCount.resize(numBuckets, 0);
 }
 
 void IndexConsistency::addDocKey(const KeyString& ks, int indexNumber) {
@@ -200,13 +217,9 @@ int64_t IndexConsistency::getNumRecords(int indexNumber) const {
 bool IndexConsistency::haveEntryMismatch() const {
 
     stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    for (auto iterator = _indexKeyCount.begin(); iterator != _indexKeyCount.end(); iterator++) {
-        if (iterator->second != 0) {
-            return true;
-        }
-    }
-
-    return false;
+    return std::any_of(_indexKeyCount.begin(), _indexKeyCount.end(), [](uint32_t count) {
+        return count != 0;
+    });
 }
 
 int64_t IndexConsistency::getNumExtraIndexKeys(int indexNumber) const {
@@ -252,8 +265,7 @@ void IndexConsistency::_addDocKey_inlock(const KeyString& ks, int indexNumber) {
         return;
     }
 
-    const uint32_t hash = _hashKeyString(ks, indexNumber);
-    _indexKeyCount[hash]++;
+    _bucket_inlock(ks, indexNumber)++;
     _indexesInfo.at(indexNumber).numRecords++;
 }
 
@@ -264,8 +276,7 @@ void IndexConsistency::_addIndexKey_inlock(const KeyString& ks, int indexNumber)
         return;
     }
 
-    const uint32_t hash = _hashKeyString(ks, indexNumber);
-    _indexKeyCount[hash]--;
+    _bucket_inlock(ks, indexNumber)--;
     _indexesInfo.at(indexNumber).numKeys++;
 }
 
@@ -275,6 +286,11 @@ uint32_t IndexConsistency::_hashKeyString(const KeyString& ks, int indexNumber)
     MurmurHash3_x86_32(
         ks.getTypeBits().getBuffer(), ks.getTypeBits().getSize(), indexNsHash, &indexNsHash);
     MurmurHash3_x86_32(ks.getBuffer(), ks.getSize(), indexNsHash, &indexNsHash);
-    return indexNsHash % (1U << 22);
+    return indexNsHash;
+}
+
+uint32_t& IndexConsistency::_bucket_inlock(const KeyString& ks, int indexNumber) {
+    // The number of buckets is a power of two.
+    return _indexKeyCount[_hashKeyString(ks, indexNumber) & (_indexKeyCount.size() - 1)];
 }
 }  // namespace mongo
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/storage/key_string.h"
@@ -181,7 +183,10 @@ private:
     //       are too few index entries.
     //     - If the count is < 0 in the bucket at the end of the validation pass, then there
     //       are too many index entries.
-    std::map<uint32_t, uint32_t> _indexKeyCount;
+    //
+    // The buckets are held in a flat array sized from the number of keys the collection is expected
+    // to have, so that counting a key is a single array access even for very large collections.
+    std::vector<uint32_t> _indexKeyCount;
 
     // Contains the corresponding index number for each index namespace
     std::map<std::string, int> _indexNumber;
@@ -220,5 +225,10 @@ private:
      * Returns a hashed value from the given KeyString and index namespace.
      */
     uint32_t _hashKeyString(const KeyString& ks, int indexNumbers) const;
+
+    /**
+     * Returns the `_indexKeyCount` bucket for the given KeyString and index namespace.
+     */
+    uint32_t& _bucket_inlock(const KeyString& ks, int indexNumber);
 };  // IndexConsistency
 }  // namespace mongo
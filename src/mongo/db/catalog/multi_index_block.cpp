@@ -71,6 +71,11 @@ const StringData kBuildingPhaseCompleteFieldName = "buildingPhaseComplete"_sd;
 const StringData kRunTwoPhaseIndexBuildFieldName = "runTwoPhaseIndexBuild"_sd;
 const StringData kCommitReadyMembersFieldName = "commitReadyMembers"_sd;
 
+// Limits on how many scanned documents are buffered before their keys are generated as one batch,
+// when index keys are generated on multiple threads.
+const size_t kKeyGenerationBatchDocs = 1024;
+const size_t kKeyGenerationBatchBytes = 16 * 1024 * 1024;
+
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(hangAfterStartingIndexBuild);
@@ -417,6 +422,16 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         _method != IndexBuildMethod::kBackground && useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    // Key generation dominates the cost of building multikey, wildcard and geo indexes. Builds that
+    // write to bulk builders can buffer scanned documents and generate their keys in parallel.
+    size_t keyGenerationThreads = 1;
+    if (_method != IndexBuildMethod::kBackground) {
+        keyGenerationThreads = static_cast<size_t>(maxIndexBuildKeyGenerationThreads.load());
+    }
+    std::vector<BSONObj> batchDocs;
+    std::vector<RecordId> batchLocs;
+    size_t batchBytes = 0;
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -447,7 +462,21 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
             failPointHangDuringBuild(&hangBeforeIndexBuildOf, "before", objToIndex.value());
 
             WriteUnitOfWork wunit(opCtx);
-            Status ret = insert(opCtx, objToIndex.value(), loc);
+            Status ret = Status::OK();
+            if (keyGenerationThreads > 1) {
+                batchDocs.push_back(objToIndex.value().getOwned());
+                batchLocs.push_back(loc);
+                batchBytes += batchDocs.back().objsize();
+                if (batchDocs.size() >= kKeyGenerationBatchDocs ||
+                    batchBytes >= kKeyGenerationBatchBytes) {
+                    ret = _insertBatch(opCtx, batchDocs, batchLocs, keyGenerationThreads);
+                    batchDocs.clear();
+                    batchLocs.clear();
+                    batchBytes = 0;
+                }
+            } else {
+                ret = insert(opCtx, objToIndex.value(), loc);
+            }
             if (_method == IndexBuildMethod::kBackground)
                 exec->saveState();
             if (!ret.isOK()) {
@@ -494,6 +523,15 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         return exec->getMemberObjectStatus(objToIndex.value());
     }
 
+    if (!batchDocs.empty()) {
+        WriteUnitOfWork wunit(opCtx);
+        Status ret = _insertBatch(opCtx, batchDocs, batchLocs, keyGenerationThreads);
+        if (!ret.isOK()) {
+            return ret;
+        }
+        wunit.commit();
+    }
+
     if (MONGO_FAIL_POINT(leaveIndexBuildUnfinishedForShutdown)) {
         log() << "Index build interrupted due to 'leaveIndexBuildUnfinishedForShutdown' failpoint. "
                  "Mimicing shutdown error code.";
@@ -534,6 +572,43 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status MultiIndexBlock::_insertBatch(OperationContext* opCtx,
+                                     const std::vector<BSONObj>& docs,
+                                     const std::vector<RecordId>& locs,
+                                     size_t numThreads) {
+    if (State::kAborted == _getState()) {
+        return {ErrorCodes::IndexBuildAborted,
+                str::stream() << "Index build aborted: " << _abortReason};
+    }
+
+    std::vector<BSONObj> filteredDocs;
+    std::vector<RecordId> filteredLocs;
+    for (size_t i = 0; i < _indexes.size(); i++) {
+        invariant(_indexes[i].bulk);
+
+        const std::vector<BSONObj>* indexDocs = &docs;
+        const std::vector<RecordId>* indexLocs = &locs;
+        if (_indexes[i].filterExpression) {
+            filteredDocs.clear();
+            filteredLocs.clear();
+            for (size_t j = 0; j < docs.size(); j++) {
+                if (_indexes[i].filterExpression->matchesBSON(docs[j])) {
+                    filteredDocs.push_back(docs[j]);
+                    filteredLocs.push_back(locs[j]);
+                }
+            }
+            indexDocs = &filteredDocs;
+            indexLocs = &filteredLocs;
+        }
+
+        Status idxStatus = _indexes[i].bulk->insertBatch(
+            opCtx, *indexDocs, *indexLocs, _indexes[i].options, numThreads);
+        if (!idxStatus.isOK())
+            return idxStatus;
+    }
+    return Status::OK();
+}
+
 Status MultiIndexBlock::insert(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc) {
     if (State::kAborted == _getState()) {
         return {ErrorCodes::IndexBuildAborted,
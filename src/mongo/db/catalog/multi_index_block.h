@@ -307,6 +307,15 @@ private:
     Status _dumpInsertsFromBulk(std::set<RecordId>* dupRecords,
                                 std::vector<BSONObj>* dupKeysInserted);
 
+    /**
+     * Like insert(), but for a batch of documents, generating each index's keys for the batch on
+     * up to 'numThreads' threads. Requires that every index is being built with a bulk builder.
+     */
+    Status _insertBatch(OperationContext* opCtx,
+                        const std::vector<BSONObj>& docs,
+                        const std::vector<RecordId>& locs,
+                        size_t numThreads);
+
     /**
      * Returns the current state.
      */
@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/index_consistency.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/wildcard_access_method.h"
@@ -158,16 +159,30 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     const auto& key = descriptor->keyPattern();
     const Ordering ord = Ordering::make(key);
     KeyString::Version version = KeyString::kLatestVersion;
-    std::unique_ptr<KeyString> prevIndexKeyString = nullptr;
+    // The two KeyStrings are swapped after each entry so that their buffers are reused.
+    std::unique_ptr<KeyString> indexKeyString = stdx::make_unique<KeyString>(version);
+    std::unique_ptr<KeyString> prevIndexKeyString = stdx::make_unique<KeyString>(version);
     bool isFirstEntry = true;
+    int interruptInterval = 4096;
+
+    ProgressMeterHolder progress;
+    {
+        stdx::unique_lock<Client> lk(*_opCtx->getClient());
+        progress.set(CurOp::get(_opCtx)->setProgress_inlock(
+            "Validate: scanning index " + descriptor->indexName(),
+            _indexConsistency->getNumRecords(indexNumber)));
+    }
 
     std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(_opCtx, true);
     // Seeking to BSONObj() is equivalent to seeking to the first entry of an index.
     for (auto indexEntry = cursor->seek(BSONObj(), true); indexEntry; indexEntry = cursor->next()) {
+        if (!(numKeys % interruptInterval)) {
+            _opCtx->checkForInterrupt();
+        }
+        progress->hit();
 
         // We want to use the latest version of KeyString here.
-        std::unique_ptr<KeyString> indexKeyString =
-            stdx::make_unique<KeyString>(version, indexEntry->key, ord, indexEntry->loc);
+        indexKeyString->resetToKey(indexEntry->key, ord, indexEntry->loc);
         // Ensure that the index entries are in increasing or decreasing order.
         if (!isFirstEntry && *indexKeyString < *prevIndexKeyString) {
             if (results->valid) {
@@ -195,6 +210,8 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
         prevIndexKeyString.swap(indexKeyString);
     }
 
+    progress->finished();
+
     if (_indexConsistency->getMultikeyMetadataPathCount(indexNumber) > 0) {
         results->errors.push_back(
             str::stream() << "Index '" << descriptor->indexName()
@@ -218,12 +235,20 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
     int interruptInterval = 4096;
     RecordId prevRecordId;
 
+    ProgressMeterHolder progress;
+    {
+        stdx::unique_lock<Client> lk(*_opCtx->getClient());
+        progress.set(CurOp::get(_opCtx)->setProgress_inlock(
+            "Validate: scanning documents", recordStore->numRecords(_opCtx)));
+    }
+
     while (auto record = cursor->next()) {
         ++nrecords;
 
         if (!(nrecords % interruptInterval)) {
             _opCtx->checkForInterrupt();
         }
+        progress->hit();
 
         auto dataSize = record->data.size();
         dataSizeTotal += dataSize;
@@ -249,6 +274,7 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
 
         prevRecordId = record->id;
     }
+    progress->finished();
 
     if (results->valid) {
         recordStore->updateStatsAfterRepair(_opCtx, nrecords, dataSizeTotal);
@@ -129,8 +129,9 @@ inline std::vector<stdx::unique_lock<stdx::mutex>> lockAllPartitions(T& mutexes)
  * A templated class used to partition an associative container like a set or a map to increase
  * scalability. `AssociativeContainer` is a type like a std::map or std::set that meets the
  * requirements of either the AssociativeContainer or UnorderedAssociativeContainer concept.
- * `nPartitions` determines how many partitions to make. `Partitioner` can be provided to customize
- * how the partition of each entry is computed.
+ * `nPartitions` determines how many partitions to make by default; the number of partitions may
+ * also be chosen at construction time. `Partitioner` can be provided to customize how the partition
+ * of each entry is computed.
  */
 template <typename AssociativeContainer,
           std::size_t nPartitions = 16,
@@ -216,7 +217,7 @@ public:
          * Returns the number of entries with the given key.
          */
         std::size_t count(const key_type& key) const {
-            auto partitionId = KeyPartitioner()(key, nPartitions);
+            auto partitionId = KeyPartitioner()(key, this->_partitionedContainer->numPartitions());
             return this->_partitionedContainer->_partitions[partitionId].count(key);
         }
 
@@ -233,8 +234,8 @@ public:
          * Inserts `value` into its designated partition.
          */
         void insert(value_type value) & {
-            const auto partitionId =
-                KeyPartitioner()(partitioned_detail::getKey(value), nPartitions);
+            const auto partitionId = KeyPartitioner()(partitioned_detail::getKey(value),
+                                                      this->_partitionedContainer->numPartitions());
             this->_partitionedContainer->_partitions[partitionId].insert(std::move(value));
         }
         void insert(value_type)&& = delete;
@@ -243,7 +244,8 @@ public:
          * Erases one entry from the partitioned structure, returns the number of entries removed.
          */
         std::size_t erase(const key_type& key) & {
-            const auto partitionId = KeyPartitioner()(key, nPartitions);
+            const auto partitionId =
+                KeyPartitioner()(key, this->_partitionedContainer->numPartitions());
             return this->_partitionedContainer->_partitions[partitionId].erase(key);
         }
         void erase(const key_type&) && = delete;
@@ -299,7 +301,15 @@ public:
     /**
      * Constructs a partitioned version of a AssociativeContainer, with `nPartitions` partitions.
      */
-    Partitioned() : _mutexes(nPartitions), _partitions(nPartitions) {}
+    Partitioned() : Partitioned(nPartitions) {}
+
+    /**
+     * Constructs a partitioned version of a AssociativeContainer, with `numPartitions` partitions.
+     */
+    explicit Partitioned(std::size_t numPartitions)
+        : _mutexes(numPartitions), _partitions(numPartitions) {
+        invariant(numPartitions > 0);
+    }
 
     Partitioned(const Partitioned&) = delete;
     Partitioned(Partitioned&&) = default;
@@ -307,6 +317,13 @@ public:
     Partitioned& operator=(Partitioned&&) = default;
     ~Partitioned() = default;
 
+    /**
+     * Returns the number of partitions, which does not change after construction.
+     */
+    std::size_t numPartitions() const {
+        return _partitions.size();
+    }
+
     /**
      * Returns true if each partition is empty. Locks the all partitions to perform this check, but
      * insertions can occur as soon as this method returns.
@@ -355,7 +372,7 @@ public:
      */
     void insert(const value_type value) & {
         auto partition = this->lockOnePartitionById(
-            KeyPartitioner()(partitioned_detail::getKey(value), nPartitions));
+            KeyPartitioner()(partitioned_detail::getKey(value), numPartitions()));
         partition->insert(std::move(value));
     }
     void insert(const value_type) && = delete;
@@ -375,7 +392,7 @@ public:
     }
 
     OnePartition lockOnePartition(const key_type key) & {
-        return OnePartition{*this, KeyPartitioner()(key, nPartitions)};
+        return OnePartition{*this, KeyPartitioner()(key, numPartitions())};
     }
 
     OnePartition lockOnePartitionById(PartitionId id) & {
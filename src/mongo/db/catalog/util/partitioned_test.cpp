@@ -100,6 +100,23 @@ TEST(Partitioned, ErasingEntryThatDoesNotExistShouldNotModifySize) {
     ASSERT_EQ(test.size(), 3UL);
 }
 
+TEST(Partitioned, PartitionCountCanBeChosenAtConstruction) {
+    PartitionedIntSet test(7);
+    ASSERT_EQ(test.numPartitions(), 7UL);
+    for (std::size_t i = 0; i < 14; ++i) {
+        test.insert(i);
+    }
+    ASSERT_EQ(test.size(), 14UL);
+    for (std::size_t i = 0; i < 7; ++i) {
+        auto partition = test.lockOnePartitionById(i);
+        ASSERT_EQ(partition->size(), 2UL);
+        ASSERT_EQ(partition->count(i), 1UL);
+        ASSERT_EQ(partition->count(i + 7), 1UL);
+    }
+    ASSERT_EQ(1UL, test.erase(13));
+    ASSERT_EQ(test.count(13), 0UL);
+}
+
 TEST(PartitionedAll, DefaultConstructedPartitionedShouldBeEmpty) {
     PartitionedIntSet test;
     auto all = test.lockAllPartitions();
@@ -229,13 +229,15 @@ void UUIDCatalog::setCollectionNamespace(OperationContext* opCtx,
     //
     // This means that Collection::ns() may be called while only '_catalogLock' (and no lock manager
     // locks) are held. The purpose of this function is ensure that we write to the Collection's
-    // namespace string under '_catalogLock'.
+    // namespace string under '_catalogLock'. Lookups that do not take '_catalogLock' read the
+    // namespace from a copy made when the lookup maps are rebuilt.
     invariant(coll);
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     coll->setNs(toCollection);
     invariant(_collections.erase(fromCollection) > 0);
     auto collEntry = std::make_pair(toCollection, coll);
     invariant(_collections.insert(collEntry).second == true);
+    _lookupMaps.invalidate();
 
     opCtx->recoveryUnit()->onRollback([this, coll, fromCollection, toCollection] {
         stdx::lock_guard<stdx::mutex> lock(_catalogLock);
@@ -243,6 +245,7 @@ void UUIDCatalog::setCollectionNamespace(OperationContext* opCtx,
         _collections.erase(toCollection);
         auto collEntry = std::make_pair(fromCollection, coll);
         _collections.insert(collEntry);
+        _lookupMaps.invalidate();
     });
 }
 
@@ -273,26 +276,27 @@ void UUIDCatalog::onOpenCatalog(OperationContext* opCtx) {
 }
 
 Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    return foundIt == _catalog.end() ? nullptr : foundIt->second;
+    const auto& byUUID = _getLookupMaps().byUUID;
+    auto foundIt = byUUID.find(uuid);
+    return foundIt == byUUID.end() ? nullptr : foundIt->second.first;
 }
 
 Collection* UUIDCatalog::lookupCollectionByNamespace(const NamespaceString& nss) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto it = _collections.find(nss);
-    return it == _collections.end() ? nullptr : it->second;
+    const auto& byNamespace = _getLookupMaps().byNamespace;
+    auto it = byNamespace.find(nss);
+    return it == byNamespace.end() ? nullptr : it->second;
 }
 
 NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt != _catalog.end())
-        return foundIt->second->ns();
+    const auto& byUUID = _getLookupMaps().byUUID;
+    auto foundIt = byUUID.find(uuid);
+    if (foundIt != byUUID.end())
+        return foundIt->second.second;
 
     // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
     // using the pre-close state. This ensures that any tasks reloading the catalog can see their
     // own updates.
+    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     if (_shadowCatalog) {
         auto shadowIt = _shadowCatalog->find(uuid);
         if (shadowIt != _shadowCatalog->end())
@@ -355,6 +359,23 @@ boost::optional<CollectionUUID> UUIDCatalog::next(StringData db, CollectionUUID
     return nextEntry->first.second;
 }
 
+const UUIDCatalog::LookupMaps& UUIDCatalog::_getLookupMaps() const {
+    if (auto maps = _lookupMaps.get()) {
+        return *maps;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
+    if (!_lookupMaps.get()) {
+        auto maps = std::make_shared<LookupMaps>();
+        for (auto&& entry : _catalog) {
+            maps->byUUID.emplace(entry.first, std::make_pair(entry.second, entry.second->ns()));
+        }
+        maps->byNamespace = _collections;
+        _lookupMaps.publish(std::move(maps));
+    }
+    return *_lookupMaps.get();
+}
+
 void UUIDCatalog::_registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collection* coll) {
     // Collection is invalid or this UUID is already taken.
     if (!coll || (_catalog.find(uuid) != _catalog.end())) {
@@ -372,6 +393,8 @@ void UUIDCatalog::_registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collecti
 
     std::pair<NamespaceString, Collection*> collNameEntry = std::make_pair(coll->ns(), coll);
     invariant(_collections.insert(collNameEntry).second == true);
+
+    _lookupMaps.invalidate();
 }
 Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
     auto foundIt = _catalog.find(uuid);
@@ -385,6 +408,7 @@ Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
     _catalog.erase(foundIt);
     _orderedCollections.erase(std::make_pair(dbName, uuid));
     _collections.erase(foundColl->ns());
+    _lookupMaps.invalidate();
 
     // Removal from an ordered map will invalidate iterators and potentially references to the
     // references to the erased element.
@@ -36,6 +36,7 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/copy_on_write_snapshot.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -309,6 +310,24 @@ public:
     iterator end() const;
 
 private:
+    /**
+     * Immutable copy of the lookup maps below, read by lookupCollectionByUUID,
+     * lookupCollectionByNamespace and lookupNSSByUUID without taking '_catalogLock'.
+     */
+    struct LookupMaps {
+        mongo::stdx::unordered_map<CollectionUUID,
+                                   std::pair<Collection*, NamespaceString>,
+                                   CollectionUUID::Hash>
+            byUUID;
+        mongo::stdx::unordered_map<NamespaceString, Collection*> byNamespace;
+    };
+
+    /**
+     * Returns the current LookupMaps, building them first if the catalog changed since they were
+     * last built. The result is valid until the calling thread reads the catalog again.
+     */
+    const LookupMaps& _getLookupMaps() const;
+
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<stdx::mutex>&);
     void _registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collection* coll);
@@ -334,6 +353,13 @@ private:
     mongo::stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash> _catalog;
 
     mongo::stdx::unordered_map<NamespaceString, Collection*> _collections;
+
+    /**
+     * Invalidated under '_catalogLock' whenever '_catalog' or '_collections' change, and rebuilt by
+     * the next lookup.
+     */
+    mutable CopyOnWriteSnapshot<LookupMaps> _lookupMaps;
+
     /**
      * Generation number to track changes to the catalog that could invalidate iterators.
      */
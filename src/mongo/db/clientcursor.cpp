@@ -46,6 +46,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/cursor_server_params.h"
 #include "mongo/db/jsobj.h"
@@ -96,7 +97,9 @@ ClientCursor::ClientCursor(ClientCursorParams params,
       _operationUsingCursor(operationUsingCursor),
       _lastUseDate(now),
       _createdDate(now),
-      _planSummary(Explain::getPlanSummary(_exec.get())) {
+      _planSummary(Explain::getPlanSummary(_exec.get())),
+      _queryStatsKey(CurOp::get(operationUsingCursor)->debug().queryStatsKey),
+      _queryShape(CurOp::get(operationUsingCursor)->debug().queryShape) {
     invariant(_exec);
     invariant(_operationUsingCursor);
 
@@ -257,6 +257,18 @@ public:
         return StringData(_planSummary);
     }
 
+    /**
+     * Returns the key and shape under which the operation that created this cursor recorded its
+     * query statistics. Each getMore on the cursor records its statistics under the same key.
+     */
+    const std::string& getQueryStatsKey() const {
+        return _queryStatsKey;
+    }
+
+    const BSONObj& getQueryShape() const {
+        return _queryShape;
+    }
+
     ClientCursorParams::LockPolicy lockPolicy() const {
         return _lockPolicy;
     }
@@ -420,6 +432,10 @@ private:
 
     // A string with the plan summary of the cursor's query.
     std::string _planSummary;
+
+    // The query statistics key and query shape of the operation that created this cursor.
+    const std::string _queryStatsKey;
+    const BSONObj _queryShape;
 };
 
 /**
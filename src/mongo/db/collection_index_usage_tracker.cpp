@@ -50,6 +50,22 @@ void CollectionIndexUsageTracker::recordIndexAccess(StringData indexName) {
     _indexUsageMap[indexName].accesses.fetchAndAdd(1);
 }
 
+void CollectionIndexUsageTracker::recordIndexWrite(StringData indexName,
+                                                   const IndexWriteCost& cost) {
+    invariant(!indexName.empty());
+    auto it = _indexUsageMap.find(indexName);
+    if (it == _indexUsageMap.end()) {
+        return;
+    }
+
+    auto& stats = it->second;
+    stats.writes.fetchAndAdd(1);
+    stats.keysInserted.fetchAndAdd(cost.keysInserted);
+    stats.keysDeleted.fetchAndAdd(cost.keysDeleted);
+    stats.bytesInserted.fetchAndAdd(cost.bytesInserted);
+    stats.writeMicros.fetchAndAdd(cost.micros);
+}
+
 void CollectionIndexUsageTracker::registerIndex(StringData indexName, const BSONObj& indexKey) {
     invariant(!indexName.empty());
     dassert(_indexUsageMap.find(indexName) == _indexUsageMap.end());
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
@@ -45,12 +47,26 @@ class ClockSource;
  * considered "used" when it appears as part of a winning plan for an operation that uses the
  * query system.
  *
+ * It also tracks what each index costs to maintain: the keys that writes to the collection insert
+ * into and delete from it, and the time they spend doing so.
+ *
  * Indexes must be registered and deregistered on creation/destruction.
  */
 class CollectionIndexUsageTracker {
     MONGO_DISALLOW_COPYING(CollectionIndexUsageTracker);
 
 public:
+    /**
+     * The cost of maintaining an index for a single write to the collection.
+     */
+    struct IndexWriteCost {
+        std::int64_t keysInserted = 0;
+        std::int64_t keysDeleted = 0;
+        // Total BSON size of the inserted keys.
+        std::int64_t bytesInserted = 0;
+        std::int64_t micros = 0;
+    };
+
     struct IndexUsageStats {
         IndexUsageStats() = default;
         explicit IndexUsageStats(Date_t now, const BSONObj& key)
@@ -58,11 +74,21 @@ public:
 
         IndexUsageStats(const IndexUsageStats& other)
             : accesses(other.accesses.load()),
+              writes(other.writes.load()),
+              keysInserted(other.keysInserted.load()),
+              keysDeleted(other.keysDeleted.load()),
+              bytesInserted(other.bytesInserted.load()),
+              writeMicros(other.writeMicros.load()),
               trackerStartTime(other.trackerStartTime),
               indexKey(other.indexKey) {}
 
         IndexUsageStats& operator=(const IndexUsageStats& other) {
             accesses.store(other.accesses.load());
+            writes.store(other.writes.load());
+            keysInserted.store(other.keysInserted.load());
+            keysDeleted.store(other.keysDeleted.load());
+            bytesInserted.store(other.bytesInserted.load());
+            writeMicros.store(other.writeMicros.load());
             trackerStartTime = other.trackerStartTime;
             indexKey = other.indexKey;
             return *this;
@@ -71,6 +97,14 @@ public:
         // Number of operations that have used this index.
         AtomicWord<long long> accesses;
 
+        // Number of document inserts, updates and deletes that have maintained this index, and what
+        // maintaining it cost them.
+        AtomicWord<long long> writes;
+        AtomicWord<long long> keysInserted;
+        AtomicWord<long long> keysDeleted;
+        AtomicWord<long long> bytesInserted;
+        AtomicWord<long long> writeMicros;
+
         // Date/Time that we started tracking index usage.
         Date_t trackerStartTime;
 
@@ -92,6 +126,13 @@ public:
      */
     void recordIndexAccess(StringData indexName);
 
+    /**
+     * Record that a write to the collection maintained index 'indexName' at cost 'cost'. Safe to
+     * be called by multiple threads concurrently. Writes to indexes that are not registered, such
+     * as indexes still being built, are ignored.
+     */
+    void recordIndexWrite(StringData indexName, const IndexWriteCost& cost);
+
     /**
      * Add map entry for 'indexName' stats collection. Must be called under exclusive collection
      * lock.
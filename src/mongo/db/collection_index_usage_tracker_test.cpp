@@ -84,6 +84,35 @@ TEST_F(CollectionIndexUsageTrackerTest, MultipleHit) {
     ASSERT_EQUALS(2, statsMap["foo"].accesses.loadRelaxed());
 }
 
+// Test that index maintenance costs are accumulated per index.
+TEST_F(CollectionIndexUsageTrackerTest, RecordIndexWrite) {
+    getTracker()->registerIndex("foo", BSON("foo" << 1));
+    getTracker()->registerIndex("bar", BSON("bar" << 1));
+
+    CollectionIndexUsageTracker::IndexWriteCost cost;
+    cost.keysInserted = 2;
+    cost.keysDeleted = 1;
+    cost.bytesInserted = 30;
+    cost.micros = 7;
+    getTracker()->recordIndexWrite("foo", cost);
+    getTracker()->recordIndexWrite("foo", cost);
+
+    CollectionIndexUsageMap statsMap = getTracker()->getUsageStats();
+    ASSERT_EQUALS(2, statsMap["foo"].writes.loadRelaxed());
+    ASSERT_EQUALS(4, statsMap["foo"].keysInserted.loadRelaxed());
+    ASSERT_EQUALS(2, statsMap["foo"].keysDeleted.loadRelaxed());
+    ASSERT_EQUALS(60, statsMap["foo"].bytesInserted.loadRelaxed());
+    ASSERT_EQUALS(14, statsMap["foo"].writeMicros.loadRelaxed());
+    ASSERT_EQUALS(0, statsMap["foo"].accesses.loadRelaxed());
+    ASSERT_EQUALS(0, statsMap["bar"].writes.loadRelaxed());
+}
+
+// Test that writes to indexes which are not registered are ignored.
+TEST_F(CollectionIndexUsageTrackerTest, RecordIndexWriteUnregistered) {
+    getTracker()->recordIndexWrite("foo", CollectionIndexUsageTracker::IndexWriteCost());
+    ASSERT(getTracker()->getUsageStats().empty());
+}
+
 TEST_F(CollectionIndexUsageTrackerTest, IndexKey) {
     getTracker()->registerIndex("foo", BSON("foo" << 1));
     CollectionIndexUsageMap statsMap = getTracker()->getUsageStats();
@@ -31,8 +31,10 @@
 
 #include "mongo/db/command_can_run_here.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -101,6 +103,12 @@ public:
                 "Are you explaining a write command on a secondary?",
                 commandCanRunHere(
                     opCtx, _dbName, _innerInvocation->definition(), inMultiDocumentTransaction));
+
+        // Executing explains also report the CPU time and storage engine activity of each stage.
+        const bool collectDetailedStats = _verbosity >= ExplainOptions::Verbosity::kExecStats;
+        PlanStage::setCollectDetailedStats(opCtx, collectDetailedStats);
+        ON_BLOCK_EXIT([&] { PlanStage::setCollectDetailedStats(opCtx, false); });
+
         _innerInvocation->explain(opCtx, _verbosity, result);
     }
 
@@ -468,6 +468,11 @@ public:
                 curOp->setGenericCursor_inlock(cursorPin->toGenericCursor());
             }
 
+            // Aggregate the statistics of this getMore with those of the query that created the
+            // cursor.
+            curOp->debug().queryStatsKey = cursorPin->getQueryStatsKey();
+            curOp->debug().queryShape = cursorPin->getQueryShape();
+
             CursorId respondWithId = 0;
 
             CursorResponseBuilder nextBatch(reply, CursorResponseBuilder::Options());
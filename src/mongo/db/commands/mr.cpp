@@ -233,6 +233,20 @@ void JSFunction::init(State* state) {
 void JSMapper::init(State* state) {
     _func.init(state);
     _params = state->config().mapParams;
+
+    BSONArrayBuilder paramsArray;
+    for (auto&& param : _params) {
+        paramsArray.append(param);
+    }
+    _paramsArray = paramsArray.arr();
+
+    _batchFunc = _func.scope()->createFunction(
+        "function(docs, params) {"
+        "  for (var i = 0; i < docs.length; i++) {"
+        "    _map.apply(docs[i], params);"
+        "  }"
+        "}");
+    uassert(ErrorCodes::JSInterpreterFailure, "couldn't compile batch map function", _batchFunc);
 }
 
 /**
@@ -245,6 +259,28 @@ void JSMapper::map(const BSONObj& o) {
         uasserted(9014, str::stream() << "map invoke failed: " << s->getError());
 }
 
+void JSMapper::mapBatch(const std::vector<BSONObj>& docs) {
+    if (docs.size() == 1) {
+        map(docs.front());
+        return;
+    }
+
+    BSONObjBuilder args;
+    {
+        BSONArrayBuilder docsArray(args.subarrayStart("docs"));
+        for (const auto& doc : docs) {
+            docsArray.append(doc);
+        }
+    }
+    args.append("params", BSONArray(_paramsArray));
+    const BSONObj argsObj = args.obj();
+
+    Scope* s = _func.scope();
+    verify(s);
+    if (s->invoke(_batchFunc, &argsObj, nullptr, 0, true))
+        uasserted(9014, str::stream() << "map invoke failed: " << s->getError());
+}
+
 /**
  * Applies the finalize function to a tuple obj (key, val)
  * Returns tuple obj {_id: key, value: newval}
@@ -1184,6 +1220,20 @@ void State::finalReduce(OperationContext* opCtx, CurOp* curOp) {
     verify(statusWithCQ.isOK());
     std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
 
+    // The values of keys whose values have all been read. They are reduced together once enough
+    // of them are pending, so that the lock on the inc collection is released and reacquired once
+    // per batch of keys rather than once per key.
+    const size_t kMaxPendingKeys = 100;
+    std::vector<BSONList> pendingKeys;
+    long pendingSize = 0;
+    auto finalReducePendingKeys = [&] {
+        for (auto& values : pendingKeys) {
+            finalReduce(values);
+        }
+        pendingKeys.clear();
+        pendingSize = 0;
+    };
+
     {
         auto exec = uassertStatusOK(getExecutor(_opCtx,
                                                 ctx->getCollection(),
@@ -1198,12 +1248,27 @@ void State::finalReduce(OperationContext* opCtx, CurOp* curOp) {
             o = o.getOwned();  // we will be accessing outside of the lock
             pm.hit();
 
+            if (pm->hits() % 100 == 0) {
+                _opCtx->checkForInterrupt();
+            }
+
             if (dps::compareObjectsAccordingToSort(o, prev, sortKey) == 0) {
                 // object is same as previous, add to array
                 all.push_back(o);
-                if (pm->hits() % 100 == 0) {
-                    _opCtx->checkForInterrupt();
-                }
+                pendingSize += o.objsize();
+                continue;
+            }
+
+            // 'o' starts a new key, so all values of the previous key have been read.
+            if (!all.empty()) {
+                pendingKeys.push_back(std::move(all));
+            }
+            all.clear();
+            prev = o;
+            all.push_back(o);
+            pendingSize += o.objsize();
+
+            if (pendingKeys.size() < kMaxPendingKeys && pendingSize < _config.maxInMemSize) {
                 continue;
             }
 
@@ -1211,13 +1276,15 @@ void State::finalReduce(OperationContext* opCtx, CurOp* curOp) {
 
             ctx.reset();
 
-            // reduce a finalize array
-            finalReduce(all);
+            // reduce and finalize the arrays of the pending keys
+            finalReducePendingKeys();
             ctx.emplace(_opCtx, _config.incLong);
 
-            all.clear();
-            prev = o;
-            all.push_back(o);
+            // The values read so far of the current key remain pending.
+            pendingSize = 0;
+            for (const auto& value : all) {
+                pendingSize += value.objsize();
+            }
 
             _opCtx->checkForInterrupt();
             exec->restoreState();
@@ -1230,7 +1297,8 @@ void State::finalReduce(OperationContext* opCtx, CurOp* curOp) {
     }
     ctx.reset();
 
-    // reduce and finalize last array
+    // reduce and finalize the pending and last arrays
+    finalReducePendingKeys();
     finalReduce(all);
     ctx.emplace(_opCtx, _config.incLong);
 
@@ -1510,6 +1578,26 @@ public:
 
                 Timer mt;
 
+                // Documents are mapped in batches, which are always flushed before the state is
+                // checked for spilling below.
+                const long long kMapBatchSize = 100;
+                std::vector<BSONObj> mapBatch;
+                mapBatch.reserve(kMapBatchSize);
+                auto mapPendingDocuments = [&] {
+                    if (mapBatch.empty()) {
+                        return;
+                    }
+
+                    if (config.verbose)
+                        mt.reset();
+
+                    config.mapper->mapBatch(mapBatch);
+                    mapBatch.clear();
+
+                    if (config.verbose)
+                        mapTime += mt.micros();
+                };
+
                 BSONObj o;
                 PlanExecutor::ExecState execState;
                 while (PlanExecutor::ADVANCED == (execState = exec->getNext(&o, NULL))) {
@@ -1524,18 +1612,14 @@ public:
                         }
                     }
 
-                    if (config.verbose)
-                        mt.reset();
-
-                    config.mapper->map(o);
-
-                    if (config.verbose)
-                        mapTime += mt.micros();
+                    mapBatch.push_back(std::move(o));
 
                     // Check if the state accumulated so far needs to be written to a collection.
                     // This may yield the DB lock temporarily and then acquire it again.
                     numInputs++;
-                    if (numInputs % 100 == 0) {
+                    if (numInputs % kMapBatchSize == 0) {
+                        mapPendingDocuments();
+
                         Timer t;
 
                         // TODO: As an optimization, we might want to do the save/restore state and
@@ -1561,6 +1645,8 @@ public:
                         break;
                 }
 
+                mapPendingDocuments();
+
                 if (PlanExecutor::FAILURE == execState) {
                     uasserted(ErrorCodes::OperationFailed,
                               str::stream() << "Executor error during mapReduce command: "
@@ -61,6 +61,16 @@ public:
 
     virtual void map(const BSONObj& o) = 0;
 
+    /**
+     * Applies the map function to each of 'docs' in order. Mappers that can map several documents
+     * more cheaply than one at a time override this.
+     */
+    virtual void mapBatch(const std::vector<BSONObj>& docs) {
+        for (const auto& doc : docs) {
+            map(doc);
+        }
+    }
+
 protected:
     Mapper() = default;
 };
@@ -134,11 +144,18 @@ class JSMapper : public Mapper {
 public:
     JSMapper(const BSONElement& code) : _func("_map", code) {}
     virtual void map(const BSONObj& o);
+    virtual void mapBatch(const std::vector<BSONObj>& docs);
     virtual void init(State* state);
 
 private:
     JSFunction _func;
     BSONObj _params;
+
+    // Calls the map function on each document of an array within a single invocation, so that
+    // the cost of entering the JavaScript engine is paid once per batch.
+    ScriptingFunction _batchFunc = 0;
+    // The values of '_params', as the array of arguments '_batchFunc' passes to the map function.
+    BSONObj _paramsArray;
 };
 
 class JSReducer : public Reducer {
@@ -45,9 +45,13 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_change_stream_fanout.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_facet.h"
+#include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
@@ -59,12 +63,15 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/speculative_majority_read_info.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/views/view.h"
@@ -90,12 +97,16 @@ namespace {
  * requests). Otherwise, returns false. The passed 'nsForCursor' is only used to determine the
  * namespace used in the returned cursor, which will be registered with the global cursor manager,
  * and thus will be different from that in 'request'.
+ *
+ * If 'batchOut' is not null, an owned copy of every result returned in the first batch is added to
+ * it.
  */
 bool handleCursorCommand(OperationContext* opCtx,
                          const NamespaceString& nsForCursor,
                          std::vector<ClientCursor*> cursors,
                          const AggregationRequest& request,
-                         rpc::ReplyBuilderInterface* result) {
+                         rpc::ReplyBuilderInterface* result,
+                         std::vector<BSONObj>* batchOut = nullptr) {
     invariant(!cursors.empty());
     long long batchSize = request.getBatchSize();
 
@@ -181,6 +192,9 @@ bool handleCursorCommand(OperationContext* opCtx,
         responseBuilder.setLatestOplogTimestamp(cursor->getExecutor()->getLatestOplogTimestamp());
         responseBuilder.setPostBatchResumeToken(cursor->getExecutor()->getPostBatchResumeToken());
         responseBuilder.append(next);
+        if (batchOut) {
+            batchOut->push_back(next.getOwned());
+        }
     }
 
     if (cursor) {
@@ -213,6 +227,119 @@ bool handleCursorCommand(OperationContext* opCtx,
     return static_cast<bool>(cursor);
 }
 
+/**
+ * Returns true if the results of 'request' may be served from and stored in the
+ * AggregationResultCache, judging by the request alone. The parsed pipeline is checked by
+ * isCacheablePipeline().
+ *
+ * Only local reads on a primary or standalone outside of a transaction are cached. Those read the
+ * latest data, which includes every write whose write version increment has happened; a read from
+ * an older snapshot could cache results which miss such a write.
+ */
+bool isCacheableRequest(OperationContext* opCtx,
+                        const AggregationRequest& request,
+                        const LiteParsedPipeline& liteParsedPipeline) {
+    if (!internalQueryEnableAggregationResultCache.load()) {
+        return false;
+    }
+
+    if (request.getNamespaceString().isCollectionlessAggregateNS() ||
+        liteParsedPipeline.hasChangeStream() ||
+        !liteParsedPipeline.getInvolvedNamespaces().empty()) {
+        return false;
+    }
+
+    if (request.getExplain() || request.isFromMongos() || request.needsMerge() ||
+        request.getExchangeSpec()) {
+        return false;
+    }
+
+    auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (txnParticipant && txnParticipant.inMultiDocumentTransaction()) {
+        return false;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    const auto level = readConcernArgs.getLevel();
+    if ((level != repl::ReadConcernLevel::kLocalReadConcern &&
+         level != repl::ReadConcernLevel::kAvailableReadConcern) ||
+        readConcernArgs.getArgsAtClusterTime()) {
+        return false;
+    }
+
+    return !ShardingState::get(opCtx)->enabled();
+}
+
+/**
+ * Returns true if every stage in 'sources' returns the same results each time it runs over the same
+ * collection data, and has no effects other than returning them.
+ */
+bool isCacheablePipeline(const Pipeline::SourceContainer& sources) {
+    for (auto&& source : sources) {
+        const auto constraints = source->constraints(Pipeline::SplitState::kUnsplit);
+        if (!constraints.requiresInputDocSource || constraints.writesPersistentData()) {
+            return false;
+        }
+
+        const StringData sourceName = source->getSourceName();
+        if (sourceName == DocumentSourceSample::kStageName ||
+            sourceName == "$sampleFromRandomCursor"_sd) {
+            return false;
+        }
+
+        if (auto facet = dynamic_cast<DocumentSourceFacet*>(source.get())) {
+            for (auto&& facetPipeline : facet->getFacetPipelines()) {
+                if (!isCacheablePipeline(facetPipeline.pipeline->getSources())) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Builds the key which the results of 'pipeline' over the collection 'nss' are cached under. The
+ * key changes whenever the collection is written to, dropped or recreated.
+ */
+std::string makeResultCacheKey(const NamespaceString& nss,
+                               const UUID& uuid,
+                               uint64_t writeVersion,
+                               const Pipeline& pipeline,
+                               const ExpressionContext& expCtx) {
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("ns", nss.ns());
+    uuid.appendToBuilder(&keyBuilder, "uuid");
+    keyBuilder.append("version", static_cast<long long>(writeVersion));
+    keyBuilder << "pipeline" << Value(pipeline.serialize());
+    keyBuilder.append("collation",
+                      expCtx.getCollator() ? expCtx.getCollator()->getSpec().toBSON()
+                                           : CollationSpec::kSimpleSpec);
+    const auto key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
+/**
+ * Replies to an aggregation with 'results' from the AggregationResultCache, as a first batch which
+ * exhausts the cursor.
+ */
+void appendCachedResults(OperationContext* opCtx,
+                         const NamespaceString& nsForCursor,
+                         const std::vector<BSONObj>& results,
+                         rpc::ReplyBuilderInterface* result) {
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder responseBuilder(result, options);
+    for (auto&& obj : results) {
+        responseBuilder.append(obj);
+    }
+    responseBuilder.done(0LL, nsForCursor.ns());
+
+    auto curOp = CurOp::get(opCtx);
+    curOp->debug().nreturned = results.size();
+    curOp->debug().cursorExhausted = true;
+}
+
 StatusWith<StringMap<ExpressionContext::ResolvedNamespace>> resolveInvolvedNamespaces(
     OperationContext* opCtx, const AggregationRequest& request) {
     const LiteParsedPipeline liteParsedPipeline(request);
@@ -385,6 +512,34 @@ void _adjustChangeStreamReadConcern(OperationContext* opCtx) {
     uassertStatusOK(waitForReadConcern(opCtx, readConcernArgs, true));
 }
 
+/**
+ * Records the shape of the pipeline of 'request' as the query shape of the current operation,
+ * unless the operation already has one, as when this aggregation runs the resolved pipeline of a
+ * view. The shape is recorded before the stages of the pipeline plan their queries, so that it is
+ * not replaced by the shapes of those queries.
+ */
+void setQueryShape(OperationContext* opCtx,
+                   const NamespaceString& nss,
+                   const AggregationRequest& request) {
+    auto& opDebug = CurOp::get(opCtx)->debug();
+    if (!opDebug.queryStatsKey.empty()) {
+        return;
+    }
+
+    BSONArrayBuilder pipelineBuilder;
+    for (auto&& stage : request.getPipeline()) {
+        pipelineBuilder.append(QueryStatsStore::redactLiterals(stage));
+    }
+    const BSONArray pipeline = pipelineBuilder.arr();
+
+    opDebug.queryShape = BSON("ns" << nss.ns() << "command"
+                                   << "aggregate"
+                                   << "pipeline"
+                                   << pipeline);
+    opDebug.queryStatsKey = std::string("aggregate") + '\0' + nss.ns() + '\0' +
+        std::string(pipeline.objdata(), pipeline.objsize());
+}
+
 }  // namespace
 
 Status runAggregate(OperationContext* opCtx,
@@ -406,6 +561,10 @@ Status runAggregate(OperationContext* opCtx,
     std::vector<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> execs;
     boost::intrusive_ptr<ExpressionContext> expCtx;
     auto curOp = CurOp::get(opCtx);
+
+    // If set, the results of the aggregation are cached under this key when they all fit in the
+    // first batch.
+    boost::optional<std::string> resultCacheKey;
     {
         const LiteParsedPipeline liteParsedPipeline(request);
 
@@ -426,6 +585,8 @@ Status runAggregate(OperationContext* opCtx,
 
         const auto& pipelineInvolvedNamespaces = liteParsedPipeline.getInvolvedNamespaces();
 
+        setQueryShape(opCtx, origNss, request);
+
         // If emplaced, AutoGetCollectionForReadCommand will throw if the sharding version for this
         // connection is out of date. If the namespace is a view, the lock will be released before
         // re-running the expanded aggregation.
@@ -435,6 +596,9 @@ Status runAggregate(OperationContext* opCtx,
         // AutoStatsTracker to record CurOp and Top entries.
         boost::optional<AutoStatsTracker> statsTracker;
 
+        // The AggregationResultCache write version of 'nss', if the results may be cached.
+        boost::optional<uint64_t> writeVersion;
+
         // If this is a change stream, perform special checks and change the execution namespace.
         if (liteParsedPipeline.hasChangeStream()) {
             // Replace the execution namespace with that of the oplog.
@@ -465,6 +629,13 @@ Status runAggregate(OperationContext* opCtx,
                                  0);
             collatorToUse.emplace(resolveCollator(opCtx, request, nullptr));
         } else {
+            // The write version must be read before the snapshot the aggregation reads from is
+            // opened, so that any write the snapshot misses increments it afterwards.
+            if (isCacheableRequest(opCtx, request, liteParsedPipeline)) {
+                writeVersion = AggregationResultCache::get(opCtx).getWriteVersion(nss);
+                opCtx->recoveryUnit()->abandonSnapshot();
+            }
+
             // This is a regular aggregation. Lock the collection or view.
             ctx.emplace(opCtx, nss, AutoGetCollection::ViewMode::kViewsPermitted);
             collatorToUse.emplace(resolveCollator(opCtx, request, ctx->getCollection()));
@@ -536,12 +707,32 @@ Status runAggregate(OperationContext* opCtx,
 
         pipeline->optimizePipeline();
 
+        // Answer the aggregation from the result cache if it ran before with the same pipeline
+        // over the same collection data. Cached results always fit in a single batch.
+        if (writeVersion && collection && uuid &&
+            expCtx->tailableMode == TailableModeEnum::kNormal &&
+            repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss) &&
+            isCacheablePipeline(pipeline->getSources())) {
+            resultCacheKey = makeResultCacheKey(nss, *uuid, *writeVersion, *pipeline, *expCtx);
+
+            std::vector<BSONObj> cachedResults;
+            if (AggregationResultCache::get(opCtx).lookup(*resultCacheKey, &cachedResults) &&
+                cachedResults.size() <= static_cast<size_t>(request.getBatchSize())) {
+                appendCachedResults(opCtx, origNss, cachedResults, result);
+                return Status::OK();
+            }
+        }
+
         // Prepare a PlanExecutor to provide input into the pipeline, if needed.
         if (liteParsedPipeline.hasChangeStream()) {
             // If we are using a change stream, the cursor stage should have a simple collation,
             // regardless of what the user's collation was.
             std::unique_ptr<CollatorInterface> collatorForCursor = nullptr;
             auto collatorStash = expCtx->temporarilyChangeCollator(std::move(collatorForCursor));
+
+            // If other streams over the same namespace can share the oplog scan, this replaces the
+            // stages which would read the oplog, and no cursor is attached.
+            DocumentSourceChangeStreamFanoutConsumer::substituteIfShareable(pipeline.get());
             PipelineD::prepareCursorSource(collection, nss, &request, pipeline.get());
         } else {
             PipelineD::prepareCursorSource(collection, nss, &request, pipeline.get());
@@ -646,10 +837,17 @@ Status runAggregate(OperationContext* opCtx,
             pins[0].getCursor()->getExecutor(), *(expCtx->explain), &bodyBuilder);
     } else {
         // Cursor must be specified, if explain is not.
-        const bool keepCursor =
-            handleCursorCommand(opCtx, origNss, std::move(cursors), request, result);
+        std::vector<BSONObj> firstBatch;
+        const bool keepCursor = handleCursorCommand(opCtx,
+                                                    origNss,
+                                                    std::move(cursors),
+                                                    request,
+                                                    result,
+                                                    resultCacheKey ? &firstBatch : nullptr);
         if (keepCursor) {
             cursorFreer.dismiss();
+        } else if (resultCacheKey) {
+            AggregationResultCache::get(opCtx).insert(*resultCacheKey, std::move(firstBatch));
         }
     }
 
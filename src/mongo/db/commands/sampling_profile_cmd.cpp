@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/util/sampling_profiler.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Reports the stacks collected by the sampling profiler, enabled with the
+ * samplingProfilerFrequencyHz server parameter:
+ *
+ *     { getSamplingProfile: 1, limit: <number of stacks, default 1000>, reset: <bool> }
+ *
+ * With 'reset', the collected stacks are discarded after being reported.
+ */
+class CmdGetSamplingProfile : public BasicCommand {
+public:
+    CmdGetSamplingProfile() : BasicCommand("getSamplingProfile") {}
+
+    std::string help() const override {
+        return "report the stacks sampled by the sampling profiler, most frequent first";
+    }
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+    bool adminOnly() const override {
+        return true;
+    }
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long limit;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(cmdObj, "limit", 1000, &limit));
+        uassert(ErrorCodes::BadValue, "'limit' must not be negative", limit >= 0);
+        bool reset;
+        uassertStatusOK(bsonExtractBooleanFieldWithDefault(cmdObj, "reset", false, &reset));
+
+        SamplingProfiler::appendProfile(limit, &result);
+        if (reset) {
+            SamplingProfiler::reset();
+        }
+        return true;
+    }
+} cmdGetSamplingProfile;
+
+}  // namespace
+}  // namespace mongo
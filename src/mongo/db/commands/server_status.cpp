@@ -173,6 +173,11 @@ public:
         return true;
     }
 
+    ServerStatusSection* findSection(StringData sectionName) const {
+        auto it = _sections.find(sectionName.toString());
+        return it == _sections.end() ? nullptr : it->second;
+    }
+
     void addSection(ServerStatusSection* section) {
         // Disallow adding a section named "timing" as it is reserved for the server status command.
         dassert(section->getSectionName() != kTimingSection);
@@ -210,6 +215,10 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+ServerStatusSection* ServerStatusSection::find(StringData sectionName) {
+    return CmdServerStatusInstantiator::getInstance().findSection(sectionName);
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
@@ -42,6 +42,12 @@ public:
     ServerStatusSection(const std::string& sectionName);
     virtual ~ServerStatusSection() = default;
 
+    /**
+     * Returns the section registered as 'sectionName', or nullptr if there is none. Sections are
+     * registered during static initialization and live for the rest of the process.
+     */
+    static ServerStatusSection* find(StringData sectionName);
+
     const std::string& getSectionName() const {
         return _sectionName;
     }
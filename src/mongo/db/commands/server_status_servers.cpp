@@ -33,11 +33,13 @@
 
 #include "mongo/config.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/logger/logger.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 
@@ -89,6 +91,10 @@ public:
             BSONObjBuilder section(b.subobjStart("serviceExecutorTaskStats"));
             executor->appendStats(&section);
         }
+        {
+            BSONObjBuilder section(b.subobjStart("sharedBufferPool"));
+            SharedBufferPool::appendStats(&section);
+        }
 
         return b.obj();
     }
@@ -132,6 +138,30 @@ public:
             getHostFQDNs(getHostNameCached(), HostnameCanonicalizationMode::kForwardAndReverse));
     }
 } advisoryHostFQDNs;
+
+class AsyncLogging final : public ServerStatusSection {
+public:
+    AsyncLogging() : ServerStatusSection("asyncLogging") {}
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    void appendSection(OperationContext* opCtx,
+                       const BSONElement& configElement,
+                       BSONObjBuilder* out) const override {
+        auto writer = logger::globalAsyncLogWriter();
+        if (!writer) {
+            return;
+        }
+
+        const auto stats = writer->getStats();
+        BSONObjBuilder section(out->subobjStart("asyncLogging"));
+        section.append("writtenLines", static_cast<long long>(stats.writtenLines));
+        section.append("droppedLines", static_cast<long long>(stats.droppedLines));
+        section.append("droppedBytes", static_cast<long long>(stats.droppedBytes));
+        section.append("bufferedBytes", static_cast<long long>(stats.bufferedBytes));
+    }
+} asyncLogging;
 }  // namespace
 
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include <string>
 #include <vector>
 
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
 #include "mongo/db/concurrency/global_lock_acquisition_tracker.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
@@ -169,6 +170,18 @@ Lock::GlobalLock::GlobalLock(GlobalLock&& otherLock)
 
 void Lock::GlobalLock::_enqueue(LockMode lockMode, Date_t deadline) {
     try {
+        // Replicated writes wait for flow control before taking any lock, so that throttled
+        // writers do not hold up the operations queued behind them.
+        if (lockMode == MODE_IX && _isOutermostLock && _opCtx->writesAreReplicated() &&
+            _opCtx->lockState()->shouldParticipateInFlowControl()) {
+            if (auto ticketholder = FlowControlTicketholder::get(_opCtx)) {
+                uassert(ErrorCodes::LockTimeout,
+                        str::stream() << "Unable to acquire a flow control ticket by deadline "
+                                      << deadline.toString(),
+                        ticketholder->getTicketUntil(_opCtx, deadline));
+            }
+        }
+
         if (_opCtx->lockState()->shouldConflictWithSecondaryBatchApplication()) {
             _pbwm.lock(MODE_IS);
         }
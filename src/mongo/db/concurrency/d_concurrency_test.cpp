@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
 #include "mongo/db/concurrency/global_lock_acquisition_tracker.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/concurrency/replication_state_transition_lock_guard.h"
@@ -493,6 +494,84 @@ TEST_F(DConcurrencyTestFixture, GlobalLockIXSetsGlobalWriteLockedOnOperationCont
     ASSERT_TRUE(GlobalLockAcquisitionTracker::get(opCtx).getGlobalWriteLocked());
 }
 
+TEST_F(DConcurrencyTestFixture, GlobalLockIXTakesFlowControlTicket) {
+    auto clients = makeKClientsWithLockers(1);
+    auto opCtx = clients[0].second.get();
+
+    FlowControlTicketholder::set(getServiceContext(),
+                                 stdx::make_unique<FlowControlTicketholder>(1));
+    ON_BLOCK_EXIT([&] { FlowControlTicketholder::set(getServiceContext(), nullptr); });
+    auto ticketholder = FlowControlTicketholder::get(getServiceContext());
+
+    {
+        Lock::GlobalLock globalWrite(
+            opCtx, MODE_IX, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(globalWrite.isLocked());
+
+        // Recursive acquisitions do not take another ticket.
+        Lock::GlobalLock recursiveWrite(
+            opCtx, MODE_IX, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(recursiveWrite.isLocked());
+    }
+    ASSERT_EQ(1, ticketholder->totalTicketsAcquired());
+
+    // Reads and writes that opt out of flow control do not wait for a ticket.
+    {
+        Lock::GlobalLock globalRead(
+            opCtx, MODE_IS, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(globalRead.isLocked());
+    }
+    opCtx->lockState()->setShouldParticipateInFlowControl(false);
+    {
+        Lock::GlobalLock globalWrite(
+            opCtx, MODE_IX, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(globalWrite.isLocked());
+    }
+    ASSERT_EQ(1, ticketholder->totalTicketsAcquired());
+}
+
+TEST_F(DConcurrencyTestFixture, GlobalLockIXWaitingForFlowControlTicketIsInterruptible) {
+    auto clients = makeKClientsWithLockers(1);
+    auto opCtx = clients[0].second.get();
+
+    FlowControlTicketholder::set(getServiceContext(),
+                                 stdx::make_unique<FlowControlTicketholder>(0));
+    ON_BLOCK_EXIT([&] { FlowControlTicketholder::set(getServiceContext(), nullptr); });
+
+    auto result = runTaskAndKill(opCtx, [&]() {
+        Lock::GlobalLock globalWrite(
+            opCtx, MODE_IX, Date_t::max(), Lock::InterruptBehavior::kThrow);
+    });
+
+    ASSERT_THROWS_CODE(result.get(), AssertionException, ErrorCodes::Interrupted);
+    ASSERT_FALSE(opCtx->lockState()->isLocked());
+}
+
+TEST_F(DConcurrencyTestFixture, GlobalLockIXWaitingForFlowControlTicketTimesOut) {
+    auto clients = makeKClientsWithLockers(1);
+    auto opCtx = clients[0].second.get();
+
+    FlowControlTicketholder::set(getServiceContext(),
+                                 stdx::make_unique<FlowControlTicketholder>(0));
+    ON_BLOCK_EXIT([&] { FlowControlTicketholder::set(getServiceContext(), nullptr); });
+
+    ASSERT_THROWS_CODE(Lock::GlobalLock(opCtx,
+                                        MODE_IX,
+                                        Date_t::now() + Milliseconds(10),
+                                        Lock::InterruptBehavior::kThrow),
+                       AssertionException,
+                       ErrorCodes::LockTimeout);
+    ASSERT_FALSE(opCtx->lockState()->isLocked());
+
+    {
+        Lock::GlobalLock globalWrite(
+            opCtx, MODE_IX, Date_t::now(), Lock::InterruptBehavior::kLeaveUnlocked);
+        ASSERT_FALSE(globalWrite.isLocked());
+    }
+    ASSERT_FALSE(opCtx->lockState()->isLocked());
+    ASSERT_EQ(0, FlowControlTicketholder::get(getServiceContext())->totalTicketsAcquired());
+}
+
 TEST_F(DConcurrencyTestFixture, GlobalLockSDoesNotSetGlobalWriteLockedOnOperationContext) {
     auto clients = makeKClientsWithLockers(1);
     auto opCtx = clients[0].second.get();
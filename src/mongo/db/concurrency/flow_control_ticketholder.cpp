@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+const auto getFlowControlTicketholder =
+    ServiceContext::declareDecoration<std::unique_ptr<FlowControlTicketholder>>();
+
+}  // namespace
+
+FlowControlTicketholder* FlowControlTicketholder::get(ServiceContext* service) {
+    return getFlowControlTicketholder(service).get();
+}
+
+FlowControlTicketholder* FlowControlTicketholder::get(ServiceContext& service) {
+    return getFlowControlTicketholder(service).get();
+}
+
+FlowControlTicketholder* FlowControlTicketholder::get(OperationContext* opCtx) {
+    return get(opCtx->getClient()->getServiceContext());
+}
+
+void FlowControlTicketholder::set(ServiceContext* service,
+                                  std::unique_ptr<FlowControlTicketholder> ticketholder) {
+    getFlowControlTicketholder(service) = std::move(ticketholder);
+}
+
+void FlowControlTicketholder::refreshTo(int numTickets) {
+    invariant(numTickets >= 0);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _tickets = numTickets;
+    _cv.notify_all();
+}
+
+void FlowControlTicketholder::getTicket(OperationContext* opCtx) {
+    invariant(getTicketUntil(opCtx, Date_t::max()));
+}
+
+bool FlowControlTicketholder::getTicketUntil(OperationContext* opCtx, Date_t deadline) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_inShutdown) {
+        return true;
+    }
+
+    if (_tickets == 0) {
+        Timer timer;
+        ++_numWaiters;
+        ON_BLOCK_EXIT([&] {
+            --_numWaiters;
+            _totalTimeAcquiringMicros += timer.micros();
+        });
+
+        if (!opCtx->waitForConditionOrInterruptUntil(
+                _cv, lk, deadline, [&] { return _tickets > 0 || _inShutdown; })) {
+            return false;
+        }
+        if (_inShutdown) {
+            return true;
+        }
+    }
+
+    --_tickets;
+    ++_totalTicketsAcquired;
+    return true;
+}
+
+long long FlowControlTicketholder::totalTicketsAcquired() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _totalTicketsAcquired;
+}
+
+void FlowControlTicketholder::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("ticketsAcquired", _totalTicketsAcquired);
+    builder->append("ticketsAvailable", _tickets);
+    builder->append("timeAcquiringMicros", _totalTimeAcquiringMicros);
+    builder->append("waiters", _numWaiters);
+}
+
+void FlowControlTicketholder::setInShutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _inShutdown = true;
+    _cv.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Admits writes on a primary at the rate that flow control has determined the majority of the
+ * replica set can keep up with. Flow control refreshes the number of available tickets once per
+ * second; writers that find no ticket left wait for the next refresh.
+ *
+ * Only mongod installs a FlowControlTicketholder, so get() returns nullptr everywhere else.
+ */
+class FlowControlTicketholder {
+    MONGO_DISALLOW_COPYING(FlowControlTicketholder);
+
+public:
+    explicit FlowControlTicketholder(int numTickets) : _tickets(numTickets) {}
+
+    static FlowControlTicketholder* get(ServiceContext* service);
+    static FlowControlTicketholder* get(ServiceContext& service);
+    static FlowControlTicketholder* get(OperationContext* opCtx);
+
+    static void set(ServiceContext* service, std::unique_ptr<FlowControlTicketholder> ticketholder);
+
+    /**
+     * Replaces the tickets left over from the previous period with 'numTickets' and wakes up the
+     * writers waiting for one.
+     */
+    void refreshTo(int numTickets);
+
+    /**
+     * Takes a ticket, waiting for the next refresh if none is available. Throws if 'opCtx' is
+     * interrupted while waiting.
+     */
+    void getTicket(OperationContext* opCtx);
+
+    /**
+     * Like getTicket(), but gives up waiting at 'deadline'. Returns false if no ticket became
+     * available by then.
+     */
+    bool getTicketUntil(OperationContext* opCtx, Date_t deadline);
+
+    /**
+     * Returns the number of tickets handed out since startup. Flow control uses it to measure the
+     * rate at which the primary accepts writes.
+     */
+    long long totalTicketsAcquired() const;
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Lets all current and future writers through without a ticket.
+     */
+    void setInShutdown();
+
+private:
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+
+    int _tickets;
+    bool _inShutdown = false;
+
+    long long _totalTicketsAcquired = 0;
+    long long _totalTimeAcquiringMicros = 0;
+    int _numWaiters = 0;
+};
+
+}  // namespace mongo
@@ -412,8 +412,10 @@ void LockHead::migratePartitionedLockHeads() {
 const unsigned LockManager::_numLockBuckets(128);
 
 // Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+// The exact value doesn't appear very important, but should be power of two. Lockers map to
+// partitions by their id, so have enough partitions that concurrently running operations rarely
+// share one even with many cores.
+const unsigned LockManager::_numPartitions = 128;
 
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
@@ -35,8 +35,10 @@
 
 #include <vector>
 
+#include "mongo/db/concurrency/lock_state_gen.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/wait_event.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
 #include "mongo/util/background.h"
@@ -331,13 +333,20 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = makeGuard([&] { _clientState.store(kInactive); });
 
+        auto priority = getAdmissionPriority();
+        if (priority == AdmissionPriority::kNormal &&
+            _numTicketAcquisitions >= lowPriorityTicketAcquisitionThreshold.load()) {
+            priority = AdmissionPriority::kLow;
+        }
+
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, priority);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, priority)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
+        _numTicketAcquisitions++;
     }
     _clientState.store(reader ? kActiveReader : kActiveWriter);
     return true;
@@ -353,12 +362,27 @@ LockResult LockerImpl::_lockGlobalBegin(OperationContext* opCtx, LockMode mode,
             auto beforeAcquire = Date_t::now();
             deadline = std::min(deadline,
                                 _maxLockTimeout ? beforeAcquire + *_maxLockTimeout : Date_t::max());
-            uassert(ErrorCodes::LockTimeout,
-                    str::stream() << "Unable to acquire ticket with mode '" << _modeForTicket
-                                  << "' within a max lock request timeout of '"
-                                  << Date_t::now() - beforeAcquire
-                                  << "' milliseconds.",
-                    _acquireTicket(opCtx, mode, deadline));
+
+            // Shed load by failing operations which wait too long for their first ticket, before
+            // they did any work.
+            const Milliseconds maxQueueWait{ticketQueueMaxWaitMillis.load()};
+            if (maxQueueWait > Milliseconds(0) && _numTicketAcquisitions == 0 &&
+                getAdmissionPriority() != AdmissionPriority::kHigh &&
+                beforeAcquire + maxQueueWait < deadline) {
+                uassert(ErrorCodes::ExceededTimeLimit,
+                        str::stream() << "Unable to acquire ticket with mode '" << mode
+                                      << "' within the ticketQueueMaxWaitMillis of '"
+                                      << maxQueueWait
+                                      << "', the server is overloaded.",
+                        _acquireTicket(opCtx, mode, beforeAcquire + maxQueueWait));
+            } else {
+                uassert(ErrorCodes::LockTimeout,
+                        str::stream() << "Unable to acquire ticket with mode '" << _modeForTicket
+                                      << "' within a max lock request timeout of '"
+                                      << Date_t::now() - beforeAcquire
+                                      << "' milliseconds.",
+                        _acquireTicket(opCtx, mode, deadline));
+            }
         }
         _modeForTicket = mode;
     }
@@ -851,6 +875,8 @@ void LockerImpl::lockComplete(OperationContext* opCtx,
         timeout = Milliseconds::max();
     }
 
+    WaitEventGuard waitEvent(opCtx, WaitEvent::kLock);
+
     // Don't go sleeping without bound in order to be able to report long waits.
     Milliseconds waitTime = std::min(timeout, MaxWaitTime);
     const uint64_t startOfTotalWaitTime = curTimeMicros64();
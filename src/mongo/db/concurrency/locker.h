@@ -36,6 +36,7 @@
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/admission_priority.h"
 
 namespace mongo {
 
@@ -463,6 +464,30 @@ public:
     bool shouldAcquireTicket() const {
         return _shouldAcquireTicket;
     }
+
+    /**
+     * If set to false, this opts out of flow control, which throttles the writes of a primary when
+     * its secondaries fall behind. Only writes the replica set needs in order to catch up, such as
+     * periodic no-ops, should opt out.
+     */
+    void setShouldParticipateInFlowControl(bool newValue) {
+        _shouldParticipateInFlowControl = newValue;
+    }
+    bool shouldParticipateInFlowControl() const {
+        return _shouldParticipateInFlowControl;
+    }
+
+    /**
+     * Sets the priority with which this locker waits for tickets. Operations which acquire tickets
+     * many times, because they yield often, wait with AdmissionPriority::kLow regardless.
+     */
+    void setAdmissionPriority(AdmissionPriority priority) {
+        _admissionPriority = priority;
+    }
+    AdmissionPriority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
     /**
      * This function is for unit testing only.
      */
@@ -497,6 +522,8 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    bool _shouldParticipateInFlowControl = true;
+    AdmissionPriority _admissionPriority = AdmissionPriority::kNormal;
     std::string _debugInfo;  // Extra info about this locker for debugging purpose
 };
 
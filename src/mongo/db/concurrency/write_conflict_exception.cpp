@@ -40,8 +40,16 @@ MONGO_FAIL_POINT_DEFINE(skipWriteConflictRetries);
 
 AtomicWord<bool> WriteConflictException::trace(false);
 
-WriteConflictException::WriteConflictException()
-    : DBException(Status(ErrorCodes::WriteConflict, "WriteConflict")) {
+namespace {
+// Write conflicts are thrown on every contended write, so they share one immortal Status rather
+// than allocating a new one each time.
+const Status& writeConflictStatus() {
+    static const Status status = Status::makeImmortal(ErrorCodes::WriteConflict, "WriteConflict");
+    return status;
+}
+}  // namespace
+
+WriteConflictException::WriteConflictException() : DBException(writeConflictStatus()) {
     if (trace.load()) {
         printStackTrace();
     }
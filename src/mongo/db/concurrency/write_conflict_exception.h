@@ -30,9 +30,11 @@
 #pragma once
 
 #include <exception>
+#include <type_traits>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/curop.h"
+#include "mongo/stdx/type_traits.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point_service.h"
 
@@ -67,6 +69,25 @@ private:
     void defineOnlyInFinalSubclassToPreventSlicing() final {}
 };
 
+namespace write_conflict_retry_detail {
+template <typename F>
+using ResultOf = decltype(std::declval<F&>()());
+
+/**
+ * Records a write conflict on the current operation, backs off and abandons the snapshot before
+ * the next attempt.
+ */
+inline void handleWriteConflict(OperationContext* opCtx,
+                                StringData opStr,
+                                StringData ns,
+                                int* attempts) {
+    CurOp::get(opCtx)->debug().additiveMetrics.incrementWriteConflicts(1);
+    WriteConflictException::logAndBackoff(*attempts, opStr, ns);
+    ++*attempts;
+    opCtx->recoveryUnit()->abandonSnapshot();
+}
+}  // namespace write_conflict_retry_detail
+
 /**
  * Runs the argument function f as many times as needed for f to complete or throw an exception
  * other than WriteConflictException.  For each time f throws a WriteConflictException, logs the
@@ -77,7 +98,9 @@ private:
  * WriteConflictException retry loop up the call stack. Hence, this retry loop is reduced to an
  * invocation of the argument function f without any exception handling and retry logic.
  */
-template <typename F>
+template <typename F,
+          stdx::enable_if_t<!std::is_same<write_conflict_retry_detail::ResultOf<F>, Status>::value,
+                            int> = 0>
 auto writeConflictRetry(OperationContext* opCtx, StringData opStr, StringData ns, F&& f) {
     invariant(opCtx);
     invariant(opCtx->lockState());
@@ -92,11 +115,45 @@ auto writeConflictRetry(OperationContext* opCtx, StringData opStr, StringData ns
         try {
             return f();
         } catch (WriteConflictException const&) {
-            CurOp::get(opCtx)->debug().additiveMetrics.incrementWriteConflicts(1);
-            WriteConflictException::logAndBackoff(attempts, opStr, ns);
-            ++attempts;
-            opCtx->recoveryUnit()->abandonSnapshot();
+            write_conflict_retry_detail::handleWriteConflict(opCtx, opStr, ns, &attempts);
+        }
+    }
+}
+
+/**
+ * Overload for functions returning a Status. Besides throwing WriteConflictException, f may
+ * report a write conflict by returning a WriteConflict Status, which is retried without the cost
+ * of throwing and catching an exception.
+ *
+ * As above, no retry happens within an enclosing WriteUnitOfWork. A WriteConflict Status is then
+ * thrown as a WriteConflictException so that the retry loop up the call stack sees it.
+ */
+template <typename F,
+          stdx::enable_if_t<std::is_same<write_conflict_retry_detail::ResultOf<F>, Status>::value,
+                            int> = 0>
+Status writeConflictRetry(OperationContext* opCtx, StringData opStr, StringData ns, F&& f) {
+    invariant(opCtx);
+    invariant(opCtx->lockState());
+    invariant(opCtx->recoveryUnit());
+
+    if (opCtx->lockState()->inAWriteUnitOfWork() || MONGO_FAIL_POINT(skipWriteConflictRetries)) {
+        Status status = f();
+        if (status == ErrorCodes::WriteConflict) {
+            throw WriteConflictException();
+        }
+        return status;
+    }
+
+    int attempts = 0;
+    while (true) {
+        try {
+            Status status = f();
+            if (status != ErrorCodes::WriteConflict) {
+                return status;
+            }
+        } catch (WriteConflictException const&) {
         }
+        write_conflict_retry_detail::handleWriteConflict(opCtx, opStr, ns, &attempts);
     }
 }
 
@@ -48,6 +48,8 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/query_stats_store.h"
+#include "mongo/db/wait_event.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
@@ -55,6 +57,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/stringutils.h"
+#include "mongo/util/tsc_tick_source.h"
 
 namespace mongo {
 
@@ -293,6 +296,11 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
         }
 
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
+
+        const auto& waitEventStats = WaitEventStats::get(clientOpCtx);
+        if (!waitEventStats.empty()) {
+            infoBuilder->append("waitEvents", waitEventStats.toBSON());
+        }
     }
 }
 
@@ -307,7 +315,8 @@ CurOp::CurOp(OperationContext* opCtx) : CurOp(opCtx, &_curopStack(opCtx)) {
         _lockStatsBase = opCtx->lockState()->getLockerInfo(boost::none)->stats;
 }
 
-CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack) : _stack(stack) {
+CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack)
+    : _stack(stack), _phases(TscTickSource::get()) {
     if (opCtx) {
         _stack->push(opCtx, this);
     } else {
@@ -398,8 +407,27 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
 
     // Obtain the total execution time of this operation.
     _end = curTimeMicros64();
+    _phases.finish();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
 
+    const auto& waitEventStats = WaitEventStats::get(opCtx);
+    if (!waitEventStats.empty()) {
+        _debug.waitEvents = waitEventStats.toBSON();
+    }
+
+    if (!_debug.queryStatsKey.empty()) {
+        QueryStatsStore::OperationStats stats;
+        stats.isGetMore = _debug.logicalOp == LogicalOp::opGetMore;
+        stats.failed = !_debug.errInfo.isOK();
+        stats.keysExamined = _debug.additiveMetrics.keysExamined.value_or(0);
+        stats.docsExamined = _debug.additiveMetrics.docsExamined.value_or(0);
+        stats.nreturned = std::max(_debug.nreturned, 0LL);
+        stats.bytesReturned = std::max(_debug.responseLength, 0);
+        stats.executionMicros = _debug.executionTimeMicros;
+        QueryStatsStore::get(opCtx->getServiceContext())
+            .record(_debug.queryStatsKey, _debug.queryShape, _planSummary, stats);
+    }
+
     const bool shouldSample =
         client->getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
 
@@ -557,6 +585,10 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
     }
 
     builder->append("numYields", _numYields);
+
+    if (!_phases.empty()) {
+        builder->append("phases", _phases.toBSON());
+    }
 }
 
 namespace {
@@ -653,6 +685,8 @@ string OpDebug::report(Client* client,
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysInserted", additiveMetrics.keysInserted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
+    OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflictWaitMicros",
+                                   additiveMetrics.prepareReadConflictWaitMicros);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("writeConflicts", additiveMetrics.writeConflicts);
 
     s << " numYields:" << curop.numYields();
@@ -687,6 +721,16 @@ string OpDebug::report(Client* client,
         s << " storage:" << storageStats->toBSON().toString();
     }
 
+    if (!waitEvents.isEmpty()) {
+        s << " waitEvents:" << waitEvents.toString();
+    }
+
+    const auto& phases = curop.getPhaseTimeline();
+    if (!phases.empty()) {
+        s << " phases:";
+        phases.toBSON().toString(s, true);
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -744,6 +788,8 @@ void OpDebug::append(const CurOp& curop,
     OPDEBUG_APPEND_OPTIONAL("keysInserted", additiveMetrics.keysInserted);
     OPDEBUG_APPEND_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_APPEND_OPTIONAL("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
+    OPDEBUG_APPEND_OPTIONAL("prepareReadConflictWaitMicros",
+                            additiveMetrics.prepareReadConflictWaitMicros);
     OPDEBUG_APPEND_OPTIONAL("writeConflicts", additiveMetrics.writeConflicts);
 
     b.appendNumber("numYield", curop.numYields());
@@ -764,6 +810,15 @@ void OpDebug::append(const CurOp& curop,
         b.append("storage", storageStats->toBSON());
     }
 
+    if (!waitEvents.isEmpty()) {
+        b.append("waitEvents", waitEvents);
+    }
+
+    const auto& phases = curop.getPhaseTimeline();
+    if (!phases.empty()) {
+        b.append("phases", phases.toBSON());
+    }
+
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
         if (!errInfo.reason().empty()) {
@@ -824,6 +879,8 @@ void OpDebug::AdditiveMetrics::add(const AdditiveMetrics& otherMetrics) {
     keysDeleted = addOptionalLongs(keysDeleted, otherMetrics.keysDeleted);
     prepareReadConflicts =
         addOptionalLongs(prepareReadConflicts, otherMetrics.prepareReadConflicts);
+    prepareReadConflictWaitMicros =
+        addOptionalLongs(prepareReadConflictWaitMicros, otherMetrics.prepareReadConflictWaitMicros);
     writeConflicts = addOptionalLongs(writeConflicts, otherMetrics.writeConflicts);
 }
 
@@ -833,6 +890,7 @@ bool OpDebug::AdditiveMetrics::equals(const AdditiveMetrics& otherMetrics) {
         ninserted == otherMetrics.ninserted && ndeleted == otherMetrics.ndeleted &&
         keysInserted == otherMetrics.keysInserted && keysDeleted == otherMetrics.keysDeleted &&
         prepareReadConflicts == otherMetrics.prepareReadConflicts &&
+        prepareReadConflictWaitMicros == otherMetrics.prepareReadConflictWaitMicros &&
         writeConflicts == otherMetrics.writeConflicts;
 }
 
@@ -871,6 +929,13 @@ void OpDebug::AdditiveMetrics::incrementPrepareReadConflicts(long long n) {
     *prepareReadConflicts += n;
 }
 
+void OpDebug::AdditiveMetrics::incrementPrepareReadConflictWaitMicros(long long n) {
+    if (!prepareReadConflictWaitMicros) {
+        prepareReadConflictWaitMicros = 0;
+    }
+    *prepareReadConflictWaitMicros += n;
+}
+
 string OpDebug::AdditiveMetrics::report() const {
     StringBuilder s;
 
@@ -883,6 +948,7 @@ string OpDebug::AdditiveMetrics::report() const {
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysInserted", keysInserted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysDeleted", keysDeleted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflicts", prepareReadConflicts);
+    OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflictWaitMicros", prepareReadConflictWaitMicros);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("writeConflicts", writeConflicts);
 
     return s.str();
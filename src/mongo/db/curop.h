@@ -35,6 +35,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/phase_timeline.h"
 #include "mongo/db/server_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/progress_meter.h"
@@ -93,6 +94,11 @@ public:
          */
         void incrementPrepareReadConflicts(long long n);
 
+        /**
+         * Increments prepareReadConflictWaitMicros by n.
+         */
+        void incrementPrepareReadConflictWaitMicros(long long n);
+
         /**
          * Generates a string showing all non-empty fields. For every non-empty field field1,
          * field2, ..., with corresponding values value1, value2, ..., we will output a string in
@@ -116,6 +122,8 @@ public:
         boost::optional<long long> keysDeleted;
         // Number of read conflicts caused by a prepared transaction.
         boost::optional<long long> prepareReadConflicts;
+        // Time spent waiting for prepared transactions to commit or abort after read conflicts.
+        boost::optional<long long> prepareReadConflictWaitMicros;
         boost::optional<long long> writeConflicts;
     };
 
@@ -181,6 +189,12 @@ public:
     // The hash of the query's "stable" key. This represents the query's shape.
     boost::optional<uint32_t> queryHash;
 
+    // The key under which the execution statistics of this operation are aggregated by query
+    // shape, and the shape of its query or pipeline with the literal values redacted. Empty if the
+    // operation runs no query.
+    std::string queryStatsKey;
+    BSONObj queryShape;
+
     // Details of any error (whether from an exception or a command returning failure).
     Status errInfo = Status::OK();
 
@@ -197,6 +211,9 @@ public:
 
     // Stores storage statistics.
     std::shared_ptr<StorageStats> storageStats;
+
+    // Counts and durations of the waits of this operation, by wait event.
+    BSONObj waitEvents;
 };
 
 /**
@@ -406,6 +423,7 @@ public:
     }
     void done() {
         _end = curTimeMicros64();
+        _phases.finish();
     }
     bool isDone() const {
         return _end > 0;
@@ -436,6 +454,19 @@ public:
         _lastPauseTime = 0;
     }
 
+    /**
+     * Marks the start of the named phase of this operation, ending the previous phase. The phases
+     * and their durations are reported in the slow query log, the profiler and $currentOp.
+     * 'phase' must have static storage duration, such as a string literal.
+     */
+    void recordPhase(const char* phase) {
+        _phases.record(phase);
+    }
+
+    const PhaseTimeline& getPhaseTimeline() const {
+        return _phases;
+    }
+
     /**
      * If this op has been marked as done(), returns the wall clock duration between being marked as
      * started with ensureStarted() and the call to done().
@@ -603,6 +634,9 @@ private:
     // The cumulative duration for which the timer has been paused.
     Microseconds _totalPausedDuration{0};
 
+    // Timestamped phases of this operation, read from the TSC where available.
+    PhaseTimeline _phases;
+
     // _networkOp represents the network-level op code: OP_QUERY, OP_GET_MORE, OP_MSG, etc.
     NetworkOp _networkOp{opInvalid};  // only set this through setNetworkOp_inlock() to keep synced
     // _logicalOp is the logical operation type, ie 'dbQuery' regardless of whether this is an
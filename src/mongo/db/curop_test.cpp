@@ -62,6 +62,8 @@ TEST(CurOpTest, AddingAdditiveMetricsObjectsTogetherShouldAddFieldsTogether) {
     additiveMetricsToAdd.keysDeleted = 2;
     currentAdditiveMetrics.prepareReadConflicts = 1;
     additiveMetricsToAdd.prepareReadConflicts = 5;
+    currentAdditiveMetrics.prepareReadConflictWaitMicros = 10;
+    additiveMetricsToAdd.prepareReadConflictWaitMicros = 20;
     currentAdditiveMetrics.writeConflicts = 7;
     additiveMetricsToAdd.writeConflicts = 0;
 
@@ -89,6 +91,9 @@ TEST(CurOpTest, AddingAdditiveMetricsObjectsTogetherShouldAddFieldsTogether) {
     ASSERT_EQ(*currentAdditiveMetrics.prepareReadConflicts,
               *additiveMetricsBeforeAdd.prepareReadConflicts +
                   *additiveMetricsToAdd.prepareReadConflicts);
+    ASSERT_EQ(*currentAdditiveMetrics.prepareReadConflictWaitMicros,
+              *additiveMetricsBeforeAdd.prepareReadConflictWaitMicros +
+                  *additiveMetricsToAdd.prepareReadConflictWaitMicros);
     ASSERT_EQ(*currentAdditiveMetrics.writeConflicts,
               *additiveMetricsBeforeAdd.writeConflicts + *additiveMetricsToAdd.writeConflicts);
 }
@@ -108,6 +113,8 @@ TEST(CurOpTest, AddingUninitializedAdditiveMetricsFieldsShouldBeTreatedAsZero) {
     additiveMetricsToAdd.keysDeleted = 2;
     currentAdditiveMetrics.prepareReadConflicts = 1;
     additiveMetricsToAdd.prepareReadConflicts = 5;
+    currentAdditiveMetrics.prepareReadConflictWaitMicros = 10;
+    additiveMetricsToAdd.prepareReadConflictWaitMicros = 20;
     currentAdditiveMetrics.writeConflicts = 7;
     additiveMetricsToAdd.writeConflicts = 0;
 
@@ -135,6 +142,9 @@ TEST(CurOpTest, AddingUninitializedAdditiveMetricsFieldsShouldBeTreatedAsZero) {
     ASSERT_EQ(*currentAdditiveMetrics.prepareReadConflicts,
               *additiveMetricsBeforeAdd.prepareReadConflicts +
                   *additiveMetricsToAdd.prepareReadConflicts);
+    ASSERT_EQ(*currentAdditiveMetrics.prepareReadConflictWaitMicros,
+              *additiveMetricsBeforeAdd.prepareReadConflictWaitMicros +
+                  *additiveMetricsToAdd.prepareReadConflictWaitMicros);
     ASSERT_EQ(*currentAdditiveMetrics.writeConflicts,
               *additiveMetricsBeforeAdd.writeConflicts + *additiveMetricsToAdd.writeConflicts);
 }
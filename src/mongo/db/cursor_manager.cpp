@@ -54,11 +54,13 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/startup_test.h"
 
 namespace mongo {
 
 constexpr int CursorManager::kNumPartitions;
+constexpr std::size_t CursorManager::kPartitionsPerCore;
 
 namespace {
 
@@ -101,7 +103,10 @@ std::pair<Status, int> CursorManager::killCursorsWithMatchingSessions(
 
 CursorManager::CursorManager()
     : _random(stdx::make_unique<PseudoRandom>(SecureRandom::create()->nextInt64())),
-      _cursorMap(stdx::make_unique<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>>>()) {}
+      _cursorMap(stdx::make_unique<
+                 Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>>(
+          std::max(static_cast<std::size_t>(kNumPartitions),
+                   static_cast<std::size_t>(ProcessInfo::getNumCores()) * kPartitionsPerCore))) {}
 
 CursorManager::~CursorManager() {
     auto allPartitions = _cursorMap->lockAllPartitions();
@@ -125,7 +130,7 @@ bool CursorManager::cursorShouldTimeout_inlock(const ClientCursor* cursor, Date_
 std::size_t CursorManager::timeoutCursors(OperationContext* opCtx, Date_t now) {
     std::vector<std::unique_ptr<ClientCursor, ClientCursor::Deleter>> toDisposeWithoutMutex;
 
-    for (size_t partitionId = 0; partitionId < kNumPartitions; ++partitionId) {
+    for (size_t partitionId = 0; partitionId < _cursorMap->numPartitions(); ++partitionId) {
         auto lockedPartition = _cursorMap->lockOnePartitionById(partitionId);
         for (auto it = lockedPartition->begin(); it != lockedPartition->end();) {
             auto* cursor = it->second;
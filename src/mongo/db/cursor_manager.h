@@ -173,7 +173,10 @@ public:
                                                            const SessionKiller::Matcher& matcher);
 
 private:
+    // The cursor map has at least kNumPartitions partitions, and kPartitionsPerCore partitions for
+    // each core on machines with more cores, so that getMores rarely contend on a partition lock.
     static constexpr int kNumPartitions = 16;
+    static constexpr std::size_t kPartitionsPerCore = 2;
     friend class ClientCursorPin;
 
     CursorId allocateCursorId_inlock();
@@ -208,6 +208,11 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     // with no record id.
     invariant(member->hasRecordId());
 
+    if (!mayBeHashed(member->recordId)) {
+        _ws->free(*out);
+        return PlanStage::NEED_TIME;
+    }
+
     DataMap::iterator it = _dataMap.find(member->recordId);
     if (_dataMap.end() == it) {
         // Child's output wasn't in every previous child.  Throw it out.
@@ -216,7 +221,7 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     } else {
         // Child's output was in every previous child.  Merge any key data in
         // the child's output and free the child's just-outputted WSM.
-        WorkingSetID hashID = it->second;
+        WorkingSetID hashID = it->second.id;
         _dataMap.erase(it);
 
         AndCommon::mergeFrom(_ws, hashID, *member);
@@ -251,7 +256,7 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         // with no record id.
         invariant(member->hasRecordId());
 
-        if (!_dataMap.insert(std::make_pair(member->recordId, id)).second) {
+        if (!_dataMap.insert(std::make_pair(member->recordId, HashedMember{id, 0})).second) {
             // Didn't insert because we already had this RecordId inside the map. This should only
             // happen if we're seeing a newer copy of the same doc in a more recent snapshot.
             // Throw out the newer copy of the doc.
@@ -277,6 +282,7 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         }
 
         _specificStats.mapAfterChild.push_back(_dataMap.size());
+        rebuildFilter();
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus) {
@@ -308,12 +314,17 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         // WSM with no record id.
         invariant(member->hasRecordId());
 
-        if (_dataMap.end() == _dataMap.find(member->recordId)) {
+        DataMap::iterator it = _dataMap.end();
+        if (mayBeHashed(member->recordId)) {
+            it = _dataMap.find(member->recordId);
+        }
+
+        if (_dataMap.end() == it) {
             // Ignore.  It's not in any previous child.
         } else {
             // We have a hit.  Copy data into the WSM we already have.
-            _seenMap.insert(member->recordId);
-            WorkingSetID olderMemberID = _dataMap[member->recordId];
+            it->second.lastChildSeen = _currentChild;
+            WorkingSetID olderMemberID = it->second.id;
             WorkingSetMember* olderMember = _ws->get(olderMemberID);
             size_t memUsageBefore = olderMember->getMemUsage();
 
@@ -325,30 +336,29 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         _ws->free(id);
         return PlanStage::NEED_TIME;
     } else if (PlanStage::IS_EOF == childStatus) {
-        // Finished with a child.
-        ++_currentChild;
-
-        // Keep elements of _dataMap that are in _seenMap.
+        // Keep elements of _dataMap that were seen by the child we just finished.
         DataMap::iterator it = _dataMap.begin();
         while (it != _dataMap.end()) {
-            if (_seenMap.end() == _seenMap.find(it->first)) {
+            if (it->second.lastChildSeen != _currentChild) {
                 DataMap::iterator toErase = it;
                 ++it;
 
                 // Update memory stats.
-                WorkingSetMember* member = _ws->get(toErase->second);
+                WorkingSetMember* member = _ws->get(toErase->second.id);
                 _memUsage -= member->getMemUsage();
 
-                _ws->free(toErase->second);
+                _ws->free(toErase->second.id);
                 _dataMap.erase(toErase);
             } else {
                 ++it;
             }
         }
 
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        // Finished with a child.
+        ++_currentChild;
 
-        _seenMap.clear();
+        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        rebuildFilter();
 
         // _dataMap is now the intersection of the first _currentChild nodes.
 
@@ -379,6 +389,27 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
     }
 }
 
+void AndHashStage::rebuildFilter() {
+    if (_filter) {
+        _memUsage -= _filter->getMemUsage();
+    }
+
+    _filter = make_unique<RecordIdBloomFilter>(_dataMap.size());
+    for (auto&& entry : _dataMap) {
+        _filter->insert(entry.first);
+    }
+    _memUsage += _filter->getMemUsage();
+}
+
+bool AndHashStage::mayBeHashed(const RecordId& recordId) {
+    invariant(_filter);
+    if (_filter->mayContain(recordId)) {
+        return true;
+    }
+    ++_specificStats.filterRejects;
+    return false;
+}
+
 unique_ptr<PlanStageStats> AndHashStage::getStats() {
     _commonStats.isEOF = isEOF();
 
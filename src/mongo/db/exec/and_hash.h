@@ -32,11 +32,11 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bloom_filter.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 #include "mongo/stdx/unordered_map.h"
-#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
@@ -83,6 +83,17 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    /**
+     * Rebuilds '_filter' from the RecordIds currently in '_dataMap'. Called each time a child
+     * has been fully hashed and '_dataMap' has shrunk to the intersection so far.
+     */
+    void rebuildFilter();
+
+    /**
+     * Returns false if 'recordId' is definitely not in '_dataMap', without probing the map.
+     */
+    bool mayBeHashed(const RecordId& recordId);
+
     // Not owned by us.
     WorkingSet* _ws;
 
@@ -93,13 +104,20 @@ private:
 
     // _dataMap is filled out by the first child and probed by subsequent children.  This is the
     // hash table that we create by intersecting _children and probe with the last child.
-    typedef stdx::unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
+    struct HashedMember {
+        WorkingSetID id;
+
+        // The last child, by index, which produced this RecordId. Entries which the current child
+        // did not produce are dropped once that child is EOF.
+        size_t lastChildSeen;
+    };
+    typedef stdx::unordered_map<RecordId, HashedMember, RecordId::Hasher> DataMap;
     DataMap _dataMap;
 
-    // Keeps track of what elements from _dataMap subsequent children have seen.
-    // Only used while _hashingChildren.
-    typedef stdx::unordered_set<RecordId, RecordId::Hasher> SeenMap;
-    SeenMap _seenMap;
+    // Summarizes the RecordIds in _dataMap once the first child has been hashed, so that probes
+    // by subsequent children for RecordIds which are not in the intersection rarely need to
+    // touch _dataMap.
+    std::unique_ptr<RecordIdBloomFilter> _filter;
 
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
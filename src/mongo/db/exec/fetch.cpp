@@ -31,11 +31,14 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/mongoutils/str.h"
@@ -46,6 +49,8 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+MONGO_FAIL_POINT_DEFINE(throwWriteConflictExceptionInFetchStage);
+
 // static
 const char* FetchStage::kStageType = "FETCH";
 
@@ -69,6 +74,10 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (!_pendingResults.empty() || NEED_TIME != _childEndState) {
+        return false;
+    }
+
     return child()->isEOF();
 }
 
@@ -80,12 +89,27 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (!_pendingResults.empty()) {
+        const PendingResult pending = _pendingResults.front();
+        _pendingResults.pop_front();
+        if (pending.ready) {
+            // Already fetched and filtered by the batch which was interrupted.
+            *out = pending.id;
+            return ADVANCED;
+        }
+        status = ADVANCED;
+        id = pending.id;
+    } else if (NEED_TIME != _childEndState) {
+        status = _childEndState;
+        id = _childEndId;
+        _childEndState = NEED_TIME;
+        _childEndId = WorkingSet::INVALID_ID;
+    } else {
+        status = child()->work(&id);
     }
 
     if (PlanStage::ADVANCED == status) {
@@ -103,6 +127,10 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
                 if (!_cursor)
                     _cursor = collection()->getCursor(getOpCtx());
 
+                if (MONGO_FAIL_POINT(throwWriteConflictExceptionInFetchStage)) {
+                    throw WriteConflictException();
+                }
+
                 if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
                     _ws->free(id);
                     return NEED_TIME;
@@ -131,6 +159,136 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatch(WorkingSet* ws,
+                                              size_t maxWorks,
+                                              std::vector<WorkingSetID>* out,
+                                              WorkingSetID* lastOut) {
+    if (_idRetrying != WorkingSet::INVALID_ID || !_pendingResults.empty() ||
+        NEED_TIME != _childEndState) {
+        // Drain whatever is left over from an interrupted batch one result at a time.
+        return PlanStage::doWorkBatch(ws, maxWorks, out, lastOut);
+    }
+
+    // Fetch and filter the results of a whole batch from our child, keeping those which survive
+    // at the front of the batch. Each unit of work our child does is one of ours.
+    const size_t firstResult = out->size();
+    const WorkCounters childBefore = childWorkCounters();
+    StageState childStatus = child()->workBatch(ws, maxWorks, out, lastOut);
+    creditChildBatchWork(childBefore);
+
+    // Results which already carry a document only need filtering. Each of the others needs its
+    // record read, which we do in RecordId order when allowed: consecutive seeks then land near
+    // each other in the record store rather than wherever the index order takes them. Results
+    // are dropped from the batch by overwriting them with INVALID_ID, so the surviving results
+    // keep the order in which our child produced them.
+    std::vector<size_t> toFetch;
+    for (size_t i = firstResult; i < out->size(); ++i) {
+        WorkingSetMember* member = _ws->get((*out)[i]);
+        if (member->hasObj()) {
+            ++_specificStats.alreadyHasObj;
+            filterBatchResult(out, i);
+        } else {
+            // We need a valid RecordId to fetch from and this is the only state that has one.
+            verify(WorkingSetMember::RID_AND_IDX == member->getState());
+            verify(member->hasRecordId());
+            toFetch.push_back(i);
+        }
+    }
+
+    if (toFetch.size() > 1 && internalQueryFetchBatchInRecordIdOrder.load()) {
+        std::sort(toFetch.begin(), toFetch.end(), [&](size_t lhs, size_t rhs) {
+            return _ws->get((*out)[lhs])->recordId < _ws->get((*out)[rhs])->recordId;
+        });
+    }
+
+    // The record data of the most recently fetched result lives in our cursor, and must be made
+    // owned before the cursor moves again.
+    WorkingSetID lastFetched = WorkingSet::INVALID_ID;
+    for (size_t next = 0; next < toFetch.size(); ++next) {
+        const size_t i = toFetch[next];
+        const WorkingSetID id = (*out)[i];
+        WorkingSetMember* member = _ws->get(id);
+
+        if (lastFetched != WorkingSet::INVALID_ID) {
+            _ws->get(lastFetched)->makeObjOwnedIfNeeded();
+            lastFetched = WorkingSet::INVALID_ID;
+        }
+
+        try {
+            if (!_cursor)
+                _cursor = collection()->getCursor(getOpCtx());
+
+            if (MONGO_FAIL_POINT(throwWriteConflictExceptionInFetchStage)) {
+                throw WriteConflictException();
+            }
+
+            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                _ws->free(id);
+                (*out)[i] = WorkingSet::INVALID_ID;
+                ++_commonStats.needTime;
+                continue;
+            }
+        } catch (const WriteConflictException&) {
+            // Return the results which precede every unfetched one. The rest, including this one,
+            // are consumed one at a time after the yield, followed by the state which ended our
+            // child's batch. Those already fetched and filtered are not examined again. None of
+            // them may hold unowned BSON across the yield.
+            member->makeObjOwnedIfNeeded();
+            std::vector<bool> unfetched(out->size(), false);
+            for (auto it = toFetch.begin() + next; it != toFetch.end(); ++it) {
+                unfetched[*it] = true;
+            }
+            const size_t firstUnfetched = *std::min_element(toFetch.begin() + next, toFetch.end());
+            for (size_t j = firstUnfetched; j < out->size(); ++j) {
+                if ((*out)[j] != WorkingSet::INVALID_ID) {
+                    _ws->get((*out)[j])->makeObjOwnedIfNeeded();
+                    _pendingResults.push_back({(*out)[j], !unfetched[j]});
+                }
+            }
+            if (PlanStage::ADVANCED != childStatus && PlanStage::NEED_TIME != childStatus) {
+                _childEndState = childStatus;
+                _childEndId = *lastOut;
+            }
+
+            out->resize(firstUnfetched);
+            compactBatch(out, firstResult);
+            ++_commonStats.needYield;
+            *lastOut = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        if (filterBatchResult(out, i)) {
+            lastFetched = id;
+        }
+    }
+
+    compactBatch(out, firstResult);
+    return childStatus;
+}
+
+bool FetchStage::filterBatchResult(std::vector<WorkingSetID>* batch, size_t pos) {
+    ++_specificStats.docsExamined;
+    if (Filter::passes(_ws->get((*batch)[pos]), _filter)) {
+        return true;
+    }
+
+    _ws->free((*batch)[pos]);
+    (*batch)[pos] = WorkingSet::INVALID_ID;
+    ++_commonStats.needTime;
+    return false;
+}
+
+void FetchStage::compactBatch(std::vector<WorkingSetID>* batch, size_t firstResult) {
+    size_t numKept = firstResult;
+    for (size_t i = firstResult; i < batch->size(); ++i) {
+        if ((*batch)[i] != WorkingSet::INVALID_ID) {
+            (*batch)[numKept++] = (*batch)[i];
+        }
+    }
+    batch->resize(numKept);
+    _commonStats.advanced += numKept - firstResult;
+}
+
 void FetchStage::doSaveStateRequiresCollection() {
     if (_cursor) {
         _cursor->saveUnpositioned();
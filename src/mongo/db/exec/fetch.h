@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/requires_collection_stage.h"
@@ -60,6 +61,10 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(WorkingSet* ws,
+                           size_t maxWorks,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* lastOut) final;
 
     void doDetachFromOperationContext() final;
     void doReattachToOperationContext() final;
@@ -86,6 +91,18 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Applies our filter to the fetched result at position 'pos' of 'batch'. If it does not pass,
+     * frees it and overwrites its position with INVALID_ID. Returns whether it passed.
+     */
+    bool filterBatchResult(std::vector<WorkingSetID>* batch, size_t pos);
+
+    /**
+     * Removes the INVALID_ID entries at or after 'firstResult' from 'batch', preserving the order
+     * of the rest, and counts the rest as advanced.
+     */
+    void compactBatch(std::vector<WorkingSetID>* batch, size_t firstResult);
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
@@ -98,6 +115,24 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // A result of a batch from our child which was not yet returned when a write conflict ended
+    // the batch. A 'ready' result was already fetched and passed our filter, and is returned as it
+    // is. The others are fetched and filtered as if our child had just produced them.
+    struct PendingResult {
+        WorkingSetID id;
+        bool ready;
+    };
+
+    // The pending results of an interrupted batch, in the order our child produced them. They are
+    // consumed after '_idRetrying' and before asking our child for more.
+    std::deque<PendingResult> _pendingResults;
+
+    // The state which ended our child's interrupted batch, if it was neither ADVANCED nor
+    // NEED_TIME, and the id that came with it. Returned once the pending results have been
+    // consumed. NEED_TIME if there is none.
+    StageState _childEndState = NEED_TIME;
+    WorkingSetID _childEndId = WorkingSet::INVALID_ID;
+
     // Stats
     FetchStats _specificStats;
 };
@@ -39,8 +39,11 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/geoparser.h"
@@ -776,7 +779,8 @@ GeoNear2DSphereStage::GeoNear2DSphereStage(const GeoNearParams& nearParams,
       _nearParams(nearParams),
       _fullBounds(geoNearDistanceBounds(*nearParams.nearQuery)),
       _currBounds(_fullBounds.center(), -1, _fullBounds.getInner()),
-      _boundsIncrement(0.0) {
+      _boundsIncrement(0.0),
+      _s2FieldPosition(getFieldPosition(s2Index, nearParams.nearQuery->field)) {
     _specificStats.keyPattern = s2Index->keyPattern();
     _specificStats.indexName = s2Index->indexName();
     _specificStats.indexVersion = static_cast<int>(s2Index->version());
@@ -787,12 +791,40 @@ GeoNear2DSphereStage::GeoNear2DSphereStage(const GeoNearParams& nearParams,
     // strings, and _nearParams.filter should have the collator.
     const CollatorInterface* collator = nullptr;
     ExpressionParams::initialize2dsphereParams(s2Index->infoObj(), collator, &_indexParams);
+
+    _canDeferFetch = SPHERE == nearParams.nearQuery->centroid->crs &&
+        _indexParams.indexVersion >= S2_INDEX_VERSION_3;
 }
 
 GeoNear2DSphereStage::~GeoNear2DSphereStage() {}
 
+void GeoNear2DSphereStage::doSaveStateRequiresIndex() {
+    _recordCursor.reset();
+}
+
+void GeoNear2DSphereStage::doDetachFromOperationContext() {
+    _recordCursor.reset();
+}
+
 namespace {
 
+// Returns the area, in square meters, of the spherical cap of the given radius in meters.
+double sphericalCapArea(double radius) {
+    radius = std::min(radius, kMaxEarthDistanceInMeters);
+    return 2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters *
+        (1 - std::cos(radius / kRadiusOfEarthInMeters));
+}
+
+// Returns the radius, in meters, of the spherical cap of the given area in square meters.
+double sphericalCapRadius(double area) {
+    double cosRadius =
+        1 - area / (2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters);
+    if (cosRadius <= -1) {
+        return kMaxEarthDistanceInMeters;
+    }
+    return std::acos(cosRadius) * kRadiusOfEarthInMeters;
+}
+
 S2Region* buildS2Region(const R2Annulus& sphereBounds) {
     // Internal bounds come in SPHERE CRS units
     // i.e. center is lon/lat, inner/outer are in meters
@@ -1024,13 +1056,7 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement = nextBoundsIncrement();
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -1052,10 +1078,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     scanParams.bounds = _nearParams.baseBounds;
 
     // Because the planner doesn't yet set up 2D index bounds, do it ourselves here
-    const string s2Field = _nearParams.nearQuery->field;
-    const int s2FieldPosition = getFieldPosition(indexDescriptor(), s2Field);
-    fassert(28678, s2FieldPosition >= 0);
-    scanParams.bounds.fields[s2FieldPosition].intervals.clear();
+    fassert(28678, _s2FieldPosition >= 0);
+    scanParams.bounds.fields[_s2FieldPosition].intervals.clear();
     std::unique_ptr<S2Region> region(buildS2Region(_currBounds));
 
     std::vector<S2CellId> cover = ExpressionMapping::get2dsphereCovering(*region);
@@ -1075,20 +1099,111 @@ StatusWith<NearStage::CoveredInterval*>  //
     // Add the cells in this covering to the _scannedCells union
     _scannedCells.Add(cover);
 
-    OrderedIntervalList* coveredIntervals = &scanParams.bounds.fields[s2FieldPosition];
+    OrderedIntervalList* coveredIntervals = &scanParams.bounds.fields[_s2FieldPosition];
     ExpressionMapping::S2CellIdsToIntervalsWithParents(cover, _indexParams, coveredIntervals);
 
     IndexScan* scan = new IndexScan(opCtx, scanParams, workingSet, nullptr);
 
-    // FetchStage owns index scan
-    _children.emplace_back(new FetchStage(opCtx, workingSet, scan, _nearParams.filter, collection));
+    if (_canDeferFetch && !indexDescriptor()->isMultikey(opCtx)) {
+        // Documents are fetched and filtered by fetchAndComputeDistance()
+        _children.emplace_back(scan);
+    } else {
+        // FetchStage owns index scan
+        _children.emplace_back(
+            new FetchStage(opCtx, workingSet, scan, _nearParams.filter, collection));
+    }
 
     return StatusWith<CoveredInterval*>(new CoveredInterval(
         _children.back().get(), nextBounds.getInner(), nextBounds.getOuter(), isLastInterval));
 }
 
+double GeoNear2DSphereStage::nextBoundsIncrement() const {
+    // Grow the annulus so that, at the density of results seen so far, the next interval is
+    // expected to return about as many results as all previous intervals together. This returns
+    // small numbers of results fast, then larger numbers later, while adapting to dense and
+    // sparse regions within a few intervals.
+    const long long kMinTargetResults = 30;
+    const long long kMaxTargetResults = 600;
+
+    long long numResultsReturned = 0;
+    for (const IntervalStats& intervalStats : _specificStats.intervalStats) {
+        numResultsReturned += intervalStats.numResultsReturned;
+    }
+
+    const double searchedArea = sphericalCapArea(_currBounds.getOuter()) -
+        sphericalCapArea(std::max(0.0, _fullBounds.getInner()));
+    if (numResultsReturned == 0 || searchedArea <= 0) {
+        return _boundsIncrement * 2;
+    }
+
+    const double density = numResultsReturned / searchedArea;
+    const long long targetResults =
+        std::max(kMinTargetResults, std::min(kMaxTargetResults, numResultsReturned));
+    const double nextOuter = sphericalCapRadius(sphericalCapArea(_currBounds.getOuter()) +
+                                                targetResults / density);
+
+    // Bound the change so that a single sparse or dense interval does not make the next one
+    // degenerate.
+    return std::max(_boundsIncrement / 4,
+                    std::min(_boundsIncrement * 4, nextOuter - _currBounds.getOuter()));
+}
+
 StatusWith<double> GeoNear2DSphereStage::computeDistance(WorkingSetMember* member) {
-    return computeGeoNearDistance(_nearParams, member);
+    if (member->hasObj()) {
+        return computeGeoNearDistance(_nearParams, member);
+    }
+
+    // The member was returned by an index scan without fetching the document. The document's
+    // geometry lies within the cell of its index key, so the distance to that cell's bounding
+    // cap is a lower bound on the document's distance.
+    invariant(_canDeferFetch && member->keyData.size() == 1u);
+    BSONObjIterator keyIt(member->keyData[0].keyData);
+    for (int i = 0; i < _s2FieldPosition; ++i) {
+        keyIt.next();
+    }
+    const BSONElement cellElt = keyIt.next();
+    if (cellElt.type() != NumberLong) {
+        return StatusWith<double>(0.0);
+    }
+
+    const S2Cap cap =
+        S2Cell(S2CellId(static_cast<uint64>(cellElt.numberLong()))).GetCapBound();
+    const double centerDistance =
+        S1Angle(_nearParams.nearQuery->centroid->point, cap.axis()).radians();
+
+    // Account for rounding errors in the distances computed from the document's geometry.
+    const double kEpsilon = 1e-12;
+    return StatusWith<double>(std::max(0.0, centerDistance - cap.angle().radians() - kEpsilon) *
+                              kRadiusOfEarthInMeters);
+}
+
+PlanStage::StageState GeoNear2DSphereStage::fetchAndComputeDistance(WorkingSet* workingSet,
+                                                                    WorkingSetID id,
+                                                                    double* distance) {
+    try {
+        if (!_recordCursor) {
+            _recordCursor = collection()->getCursor(getOpCtx());
+        }
+        if (!WorkingSetCommon::fetch(getOpCtx(), workingSet, id, _recordCursor)) {
+            *distance = -1;
+            return PlanStage::NEED_TIME;
+        }
+    } catch (const WriteConflictException&) {
+        // The member is left unfetched and is fetched again after yielding.
+        return PlanStage::NEED_YIELD;
+    }
+    ++_specificStats.docsExamined;
+
+    WorkingSetMember* member = workingSet->get(id);
+    if (!Filter::passes(member, _nearParams.filter)) {
+        *distance = -1;
+        return PlanStage::NEED_TIME;
+    }
+
+    // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
+    member->makeObjOwnedIfNeeded();
+    *distance = uassertStatusOK(computeGeoNearDistance(_nearParams, member));
+    return PlanStage::NEED_TIME;
 }
 
 }  // namespace mongo
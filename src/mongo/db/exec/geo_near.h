@@ -39,6 +39,7 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/index_bounds.h"
+#include "mongo/db/storage/record_store.h"
 #include "third_party/s2/s2cellunion.h"
 
 namespace mongo {
@@ -120,11 +121,25 @@ protected:
 
     StatusWith<double> computeDistance(WorkingSetMember* member) final;
 
+    StageState fetchAndComputeDistance(WorkingSet* workingSet,
+                                       WorkingSetID id,
+                                       double* distance) final;
+
     PlanStage::StageState initialize(OperationContext* opCtx,
                                      WorkingSet* workingSet,
                                      WorkingSetID* out) final;
 
+    void doSaveStateRequiresIndex() final;
+
+    void doDetachFromOperationContext() final;
+
 private:
+    /**
+     * Returns the amount to grow the search annulus by for the next interval, based on the
+     * density of results returned by the intervals searched so far.
+     */
+    double nextBoundsIncrement() const;
+
     const GeoNearParams _nearParams;
 
     S2IndexingParams _indexParams;
@@ -143,6 +158,19 @@ private:
 
     class DensityEstimator;
     std::unique_ptr<DensityEstimator> _densityEstimator;
+
+    // Position of the geo field in the index key pattern
+    const int _s2FieldPosition;
+
+    // Whether intervals may return index entries without fetching them, as long as the index is
+    // not multikey. Each entry of such a version 3 index holds the only cell covering the
+    // document's geometry, which bounds the document's distance from below. Documents are then
+    // only fetched once they may be the nearest result, which avoids fetching documents beyond a
+    // limit.
+    bool _canDeferFetch;
+
+    // Used to fetch the documents of index entries returned without fetching them
+    std::unique_ptr<SeekableRecordCursor> _recordCursor;
 };
 
 }  // namespace mongo
@@ -39,13 +39,16 @@
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -61,6 +64,42 @@ using stdx::make_unique;
 // static
 const char* MultiPlanStage::kStageType = "MULTI_PLAN";
 
+namespace {
+
+/**
+ * Walks the solution tree rooted at 'node' and returns its only index scan, or nullptr if the tree
+ * contains anything other than a single index scan beneath non-blocking, single-child stages.
+ */
+const IndexScanNode* getSoleIndexScan(const QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_IXSCAN:
+            return static_cast<const IndexScanNode*>(node);
+        case STAGE_FETCH:
+        case STAGE_LIMIT:
+        case STAGE_SKIP:
+        case STAGE_PROJECTION_DEFAULT:
+        case STAGE_PROJECTION_COVERED:
+        case STAGE_PROJECTION_SIMPLE:
+        case STAGE_SHARDING_FILTER:
+            if (node->children.size() != 1U) {
+                return nullptr;
+            }
+            return getSoleIndexScan(node->children[0]);
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * The estimated cost of a candidate is the number of keys it examines plus the number of
+ * documents it fetches.
+ */
+size_t estimatedCost(const MultiPlanStats::CandidateCostEstimate& estimate) {
+    return estimate.keysExamined + estimate.keysMatched;
+}
+
+}  // namespace
+
 MultiPlanStage::MultiPlanStage(OperationContext* opCtx,
                                const Collection* collection,
                                CanonicalQuery* cq,
@@ -200,6 +239,10 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
 
+    if (internalQueryPlanCostBasedSelectionEnabled.load() && pickBestPlanByCostEstimate()) {
+        return Status::OK();
+    }
+
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), collection());
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
@@ -331,6 +374,111 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     return Status::OK();
 }
 
+bool MultiPlanStage::pickBestPlanByCostEstimate() {
+    // Key counts say nothing about the cost of a blocking sort, so leave sorted queries to the
+    // trial period.
+    if (!_query->getQueryRequest().getSort().isEmpty()) {
+        return false;
+    }
+
+    std::vector<const IndexScanNode*> scans;
+    for (auto&& candidate : _candidates) {
+        if (candidate.solution->hasBlockingStage || !candidate.solution->root) {
+            return false;
+        }
+        const IndexScanNode* ixn = getSoleIndexScan(candidate.solution->root.get());
+        if (!ixn) {
+            return false;
+        }
+        scans.push_back(ixn);
+    }
+
+    const size_t maxKeys = static_cast<size_t>(internalQueryPlanCostBasedSelectionMaxKeys.load());
+    std::vector<MultiPlanStats::CandidateCostEstimate> estimates;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        const IndexScanNode* ixn = scans[ix];
+        auto descriptor = collection()->getIndexCatalog()->findIndexByName(
+            getOpCtx(), ixn->index.identifier.catalogName);
+        if (!descriptor) {
+            return false;
+        }
+
+        IndexScanParams params{descriptor,
+                               ixn->index.identifier.catalogName,
+                               ixn->index.keyPattern,
+                               ixn->index.multikeyPaths,
+                               ixn->index.multikey};
+        params.bounds = ixn->bounds;
+        params.direction = ixn->direction;
+        params.shouldDedup = ixn->shouldDedup;
+
+        WorkingSet ws;
+        IndexScan scan(getOpCtx(), std::move(params), &ws, ixn->filter.get());
+        const auto* scanStats = static_cast<const IndexScanStats*>(scan.getSpecificStats());
+
+        MultiPlanStats::CandidateCostEstimate estimate;
+        estimate.planSummary = Explain::getPlanSummary(_candidates[ix].root);
+        while (scanStats->keysExamined < maxKeys) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            const StageState state = scan.work(&id);
+            if (PlanStage::ADVANCED == state) {
+                ++estimate.keysMatched;
+                ws.free(id);
+            } else if (PlanStage::IS_EOF == state) {
+                estimate.exact = true;
+                break;
+            } else if (PlanStage::NEED_TIME != state) {
+                // Rather than yielding or surfacing an error here, defer to the trial period.
+                LOG(2) << "Abandoning cost-based plan selection after "
+                       << PlanStage::stateStr(state) << " from " << estimate.planSummary;
+                return false;
+            }
+        }
+        estimate.keysExamined = scanStats->keysExamined;
+        estimates.push_back(std::move(estimate));
+    }
+
+    // Only an exact count can win: a capped count is merely a lower bound on the cost.
+    int winnerIdx = kNoSuchPlan;
+    for (size_t ix = 0; ix < estimates.size(); ++ix) {
+        if (estimates[ix].exact &&
+            (winnerIdx == kNoSuchPlan ||
+             estimatedCost(estimates[ix]) < estimatedCost(estimates[winnerIdx]))) {
+            winnerIdx = static_cast<int>(ix);
+        }
+    }
+
+    bool clearWinner = (winnerIdx != kNoSuchPlan);
+    if (clearWinner) {
+        const double minRatio = internalQueryPlanCostBasedSelectionMinRatio.load();
+        const double winnerCost =
+            std::max(static_cast<double>(estimatedCost(estimates[winnerIdx])), 1.0);
+        for (size_t ix = 0; ix < estimates.size(); ++ix) {
+            if (static_cast<int>(ix) != winnerIdx &&
+                static_cast<double>(estimatedCost(estimates[ix])) < minRatio * winnerCost) {
+                clearWinner = false;
+                break;
+            }
+        }
+    }
+
+    _specificStats.costEstimates = std::move(estimates);
+    if (!clearWinner) {
+        LOG(5) << "Cost estimates too close to call, falling back to trial period";
+        return false;
+    }
+
+    // The plan cache entry is expected to carry trial period scores, so a plan chosen by cost
+    // estimate is not cached. The estimate is cheap enough to repeat.
+    _bestPlanIdx = winnerIdx;
+    _backupPlanIdx = kNoSuchPlan;
+    _specificStats.chosenByCostEstimate = true;
+
+    LOG(2) << "Winning plan chosen by cost estimate: "
+           << Explain::getPlanSummary(_candidates[_bestPlanIdx].root);
+    return true;
+}
+
 bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy) {
     bool doneWorking = false;
 
@@ -172,6 +172,18 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Estimates the cost of each candidate by counting the index keys it would scan, and picks
+     * the cheapest candidate as the best plan if its estimate is exact and every other candidate
+     * is estimated to be at least 'internalQueryPlanCostBasedSelectionMinRatio' times as
+     * expensive. Only applies when every candidate is a single index scan, optionally followed by
+     * non-blocking stages such as FETCH or LIMIT.
+     *
+     * Returns true if a best plan was chosen, in which case no trial period is needed. Returns
+     * false if the estimates were unavailable or too close to call.
+     */
+    bool pickBestPlanByCostEstimate();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -120,7 +120,8 @@ PlanStage::StageState NearStage::doWork(WorkingSetID* out) {
  * Holds a generic search result with a distance computed in some fashion.
  */
 struct NearStage::SearchResult {
-    SearchResult(WorkingSetID resultID, double distance) : resultID(resultID), distance(distance) {}
+    SearchResult(WorkingSetID resultID, double distance, bool exact)
+        : resultID(resultID), distance(distance), exact(exact) {}
 
     bool operator<(const SearchResult& other) const {
         // We want increasing distance, not decreasing, so we reverse the <
@@ -129,8 +130,18 @@ struct NearStage::SearchResult {
 
     WorkingSetID resultID;
     double distance;
+
+    // False if 'distance' is only a lower bound, because the member has not been fetched yet.
+    bool exact;
 };
 
+PlanStage::StageState NearStage::fetchAndComputeDistance(WorkingSet* workingSet,
+                                                         WorkingSetID id,
+                                                         double* distance) {
+    // Only subclasses whose covering stages return unfetched members need to implement this.
+    MONGO_UNREACHABLE;
+}
+
 // Set "toReturn" when NEED_YIELD.
 PlanStage::StageState NearStage::bufferNext(WorkingSetID* toReturn, Status* error) {
     //
@@ -208,7 +219,7 @@ PlanStage::StageState NearStage::bufferNext(WorkingSetID* toReturn, Status* erro
 
     // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
     nextMember->makeObjOwnedIfNeeded();
-    _resultBuffer.push(SearchResult(nextMemberID, memberDistance));
+    _resultBuffer.push(SearchResult(nextMemberID, memberDistance, nextMember->hasObj()));
 
     // Store the member's RecordId, if available, for deduping.
     if (nextMember->hasRecordId()) {
@@ -231,6 +242,26 @@ PlanStage::StageState NearStage::advanceNext(WorkingSetID* toReturn) {
         SearchResult result = _resultBuffer.top();
         memberDistance = result.distance;
 
+        bool inInterval = _nextInterval->inclusiveMax ? memberDistance <= _nextInterval->maxDistance
+                                                      : memberDistance < _nextInterval->maxDistance;
+
+        // A member buffered with a lower bound on its distance is fetched once it is the nearest
+        // buffered result and may belong to this interval, and is then buffered again with its
+        // exact distance.
+        if (!result.exact && inInterval) {
+            double distance;
+            PlanStage::StageState state =
+                fetchAndComputeDistance(_workingSet, result.resultID, &distance);
+            if (PlanStage::NEED_YIELD == state) {
+                *toReturn = WorkingSet::INVALID_ID;
+                return state;
+            }
+            invariant(PlanStage::NEED_TIME == state);
+            _resultBuffer.pop();
+            _resultBuffer.push(SearchResult(result.resultID, distance, true));
+            return PlanStage::NEED_TIME;
+        }
+
         // Throw out all documents with memberDistance < minDistance
         if (memberDistance < _nextInterval->minDistance) {
             WorkingSetMember* member = _workingSet->get(result.resultID);
@@ -242,8 +273,6 @@ PlanStage::StageState NearStage::advanceNext(WorkingSetID* toReturn) {
             return PlanStage::NEED_TIME;
         }
 
-        bool inInterval = _nextInterval->inclusiveMax ? memberDistance <= _nextInterval->maxDistance
-                                                      : memberDistance < _nextInterval->maxDistance;
         if (inInterval) {
             resultID = result.resultID;
         }
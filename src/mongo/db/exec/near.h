@@ -129,10 +129,24 @@ protected:
      * Computes the distance value for the given member data, or -1 if the member should not be
      * returned in the sorted results.
      *
+     * Covering stages may return members that have not been fetched yet. For those, a lower bound
+     * on the distance is returned instead, and the member is completed by
+     * fetchAndComputeDistance() once no buffered result can be nearer.
+     *
      * Returns !OK on invalid member data.
      */
     virtual StatusWith<double> computeDistance(WorkingSetMember* member) = 0;
 
+    /**
+     * Fetches a member that computeDistance() only returned a lower bound for, and sets 'distance'
+     * to its exact distance, or to -1 if the document no longer exists or does not match the
+     * filter. Returns NEED_YIELD if the fetch must be retried after yielding, and NEED_TIME
+     * otherwise.
+     */
+    virtual StageState fetchAndComputeDistance(WorkingSet* workingSet,
+                                               WorkingSetID id,
+                                               double* distance);
+
     /*
      * Initialize near stage before buffering the data.
      * Return IS_EOF if subclass finishes the initialization.
@@ -144,9 +158,9 @@ protected:
                                   WorkingSet* workingSet,
                                   WorkingSetID* out) = 0;
 
-    void doSaveStateRequiresIndex() final {}
+    void doSaveStateRequiresIndex() override {}
 
-    void doRestoreStateRequiresIndex() final {}
+    void doRestoreStateRequiresIndex() override {}
 
     // Filled in by subclasses.
     NearStats _specificStats;
@@ -0,0 +1,323 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_collection_scan.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* ParallelCollectionScan::kStageType = "PARALLEL_COLLSCAN";
+
+namespace {
+
+// The first batch reads this many records per thread, and each batch after it twice as many as
+// the one before, up to the maximum.
+const size_t kInitialRecordsPerThread = 16;
+const size_t kMaxRecordsPerThread = 1024;
+
+// Stop reading a batch once it holds this many bytes of documents.
+const size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+// Ranges smaller than this are not worth handing to another thread.
+const size_t kMinRecordsPerTask = 16;
+
+/**
+ * The threads on which every parallel collection scan in the process evaluates its filter.
+ */
+struct ParallelCollectionScanPool {
+    ParallelCollectionScanPool()
+        : threadPool([] {
+              ThreadPool::Options options;
+              options.poolName = "ParallelCollectionScan";
+              options.threadNamePrefix = "ParallelCollScan-";
+              options.minThreads = 0;
+              options.maxThreads = 64;
+              return options;
+          }()) {}
+
+    ThreadPool threadPool;
+};
+
+const auto parallelCollectionScanPool =
+    ServiceContext::declareDecoration<ParallelCollectionScanPool>();
+const ServiceContext::ConstructorActionRegisterer parallelCollectionScanPoolRegisterer{
+    "ParallelCollectionScanPool",
+    [](ServiceContext* service) { parallelCollectionScanPool(service).threadPool.startup(); },
+    [](ServiceContext* service) {
+        auto& pool = parallelCollectionScanPool(service).threadPool;
+        pool.shutdown();
+        pool.join();
+    }};
+
+/**
+ * Returns true if no node of 'expr' keeps mutable state while matching.
+ */
+bool canMatchConcurrently(const MatchExpression* expr) {
+    if (MatchExpression::WHERE == expr->matchType() ||
+        MatchExpression::EXPRESSION == expr->matchType()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canMatchConcurrently(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+ParallelCollectionScan::ParallelCollectionScan(OperationContext* opCtx,
+                                               const Collection* collection,
+                                               const CollectionScanParams& params,
+                                               size_t numThreads,
+                                               WorkingSet* workingSet,
+                                               const MatchExpression* filter)
+    : RequiresCollectionStage(kStageType, opCtx, collection),
+      _workingSet(workingSet),
+      _filter(filter),
+      _params(params),
+      _numThreads(numThreads),
+      _nextBatchSize(kInitialRecordsPerThread * numThreads) {
+    invariant(canScanInParallel(params, filter));
+    invariant(numThreads > 0);
+
+    // Explain reports the direction of the collection scan.
+    _specificStats.direction = params.direction;
+}
+
+// static
+bool ParallelCollectionScan::canScanInParallel(const CollectionScanParams& params,
+                                               const MatchExpression* filter) {
+    if (!params.start.isNull() || params.maxTs || params.tailable ||
+        params.shouldTrackLatestOplogTimestamp || params.stopApplyingFilterAfterFirstMatch ||
+        params.shouldWaitForOplogVisibility) {
+        return false;
+    }
+
+    return filter && canMatchConcurrently(filter);
+}
+
+PlanStage::StageState ParallelCollectionScan::doWork(WorkingSetID* out) {
+    // Hand out the next match from the current batch, if there is one.
+    while (_batchPos < _numFiltered) {
+        BufferedRecord& record = _batch[_batchPos++];
+        if (!record.matches) {
+            continue;
+        }
+
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = record.id;
+        member->obj = std::move(record.obj);
+        _workingSet->transitionToRecordIdAndObj(id);
+
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
+    if (isEOF()) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    try {
+        readBatch();
+    } catch (const WriteConflictException&) {
+        // The records read so far are owned, so keep them and pick up where we left off.
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
+void ParallelCollectionScan::readBatch() {
+    if (_numFiltered > 0) {
+        // The previous batch has been consumed.
+        invariant(_batchPos == _numFiltered);
+        _batch.clear();
+        _batchPos = 0;
+        _numFiltered = 0;
+        _batchBytes = 0;
+    }
+
+    if (!_cursor) {
+        _cursor = collection()->getCursor(getOpCtx(),
+                                          _params.direction == CollectionScanParams::FORWARD);
+    }
+
+    // Records only remain valid until the cursor moves, so each one is copied as it is read.
+    const SnapshotId snapshotId = getOpCtx()->recoveryUnit()->getSnapshotId();
+    while (_batch.size() < _nextBatchSize && _batchBytes < kMaxBatchBytes) {
+        boost::optional<Record> record = _cursor->next();
+        if (!record) {
+            _cursorExhausted = true;
+            break;
+        }
+
+        _batchBytes += record->data.size();
+        _batch.push_back(
+            BufferedRecord{record->id, {snapshotId, record->data.releaseToBson().getOwned()}});
+    }
+
+    _nextBatchSize = std::min(_nextBatchSize * 2, kMaxRecordsPerThread * _numThreads);
+
+    filterBatch();
+    _numFiltered = _batch.size();
+}
+
+void ParallelCollectionScan::filterBatch() {
+    const size_t numRecords = _batch.size();
+    _specificStats.docsTested += numRecords;
+
+    const auto matchRange = [this](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            _batch[i].matches = _filter->matchesBSON(_batch[i].obj.value());
+        }
+    };
+
+    const size_t numTasks =
+        std::max(size_t(1), std::min(_numThreads, numRecords / kMinRecordsPerTask));
+    if (numTasks == 1) {
+        matchRange(0, numRecords);
+        return;
+    }
+
+    // The first range is matched on this thread and the rest on the shared pool. Every range must
+    // finish before we return, since the tasks refer to our batch and to this frame.
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+    size_t numRemaining = numTasks;
+    std::exception_ptr error;
+
+    const auto runTask = [&](size_t first, size_t last) {
+        std::exception_ptr taskError;
+        try {
+            matchRange(first, last);
+        } catch (...) {
+            taskError = std::current_exception();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (taskError && !error) {
+            error = taskError;
+        }
+        if (--numRemaining == 0) {
+            allDone.notify_all();
+        }
+    };
+
+    const size_t rangeSize = (numRecords + numTasks - 1) / numTasks;
+    auto& pool = parallelCollectionScanPool(getOpCtx()->getServiceContext()).threadPool;
+    for (size_t task = 1; task < numTasks; ++task) {
+        const size_t first = task * rangeSize;
+        const size_t last = std::min(first + rangeSize, numRecords);
+        Status status = pool.schedule([&runTask, first, last] { runTask(first, last); });
+        if (!status.isOK()) {
+            // The pool is shutting down, so match the range ourselves.
+            runTask(first, last);
+        }
+    }
+    runTask(0, rangeSize);
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    allDone.wait(lk, [&] { return numRemaining == 0; });
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool ParallelCollectionScan::isEOF() {
+    return _cursorExhausted && _batchPos == _batch.size();
+}
+
+void ParallelCollectionScan::doSaveStateRequiresCollection() {
+    if (_cursor) {
+        _cursor->save();
+    }
+}
+
+void ParallelCollectionScan::doRestoreStateRequiresCollection() {
+    if (_cursor) {
+        const bool couldRestore = _cursor->restore();
+        uassert(ErrorCodes::CappedPositionLost,
+                "ParallelCollectionScan died due to position in capped collection being deleted.",
+                couldRestore);
+    }
+}
+
+void ParallelCollectionScan::doDetachFromOperationContext() {
+    if (_cursor)
+        _cursor->detachFromOperationContext();
+}
+
+void ParallelCollectionScan::doReattachToOperationContext() {
+    if (_cursor)
+        _cursor->reattachToOperationContext(getOpCtx());
+}
+
+unique_ptr<PlanStageStats> ParallelCollectionScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree.
+    BSONObjBuilder bob;
+    _filter->serialize(&bob);
+    _commonStats.filter = bob.obj();
+
+    unique_ptr<PlanStageStats> ret =
+        make_unique<PlanStageStats>(_commonStats, STAGE_PARALLEL_COLLSCAN);
+    ret->specific = make_unique<CollectionScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ParallelCollectionScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
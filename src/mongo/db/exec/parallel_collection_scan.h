@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/collection_scan_common.h"
+#include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/snapshot.h"
+
+namespace mongo {
+
+class MatchExpression;
+class SeekableRecordCursor;
+class WorkingSet;
+class OperationContext;
+
+/**
+ * Scans over a collection like CollectionScan, but evaluates the filter on several threads.
+ *
+ * Records are read in batches from a single cursor on the operation's own storage snapshot, so
+ * the set of documents seen is exactly that of a CollectionScan. Each batch is copied out of the
+ * storage engine and split into contiguous ranges which are matched against the filter
+ * concurrently, and the matching documents are then returned in record order.
+ *
+ * Only plain forward or backward scans with a filter that is safe to evaluate concurrently can
+ * be run this way; see canScanInParallel().
+ */
+class ParallelCollectionScan final : public RequiresCollectionStage {
+public:
+    static const char* kStageType;
+
+    ParallelCollectionScan(OperationContext* opCtx,
+                           const Collection* collection,
+                           const CollectionScanParams& params,
+                           size_t numThreads,
+                           WorkingSet* workingSet,
+                           const MatchExpression* filter);
+
+    /**
+     * Returns true if a scan with 'params' and 'filter' can be run by this stage. The scan must
+     * not need any of the oplog or tailable cursor handling of CollectionScan, and 'filter' must
+     * be present and contain no expressions, such as $where or $expr, which keep mutable state
+     * while matching.
+     */
+    static bool canScanInParallel(const CollectionScanParams& params,
+                                  const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
+    StageType stageType() const final {
+        return STAGE_PARALLEL_COLLSCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+protected:
+    void doSaveStateRequiresCollection() final;
+
+    void doRestoreStateRequiresCollection() final;
+
+private:
+    struct BufferedRecord {
+        RecordId id;
+        Snapshotted<BSONObj> obj;
+        bool matches = false;
+    };
+
+    /**
+     * Reads the next batch of records into '_batch', then filters it. Throws
+     * WriteConflictException if the read must be retried after a yield, in which case the records
+     * read so far are kept and reading resumes where it left off.
+     */
+    void readBatch();
+
+    /**
+     * Matches every record in '_batch' against '_filter', splitting the work between up to
+     * '_numThreads' threads.
+     */
+    void filterBatch();
+
+    // WorkingSet is not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    std::unique_ptr<SeekableRecordCursor> _cursor;
+
+    CollectionScanParams _params;
+
+    const size_t _numThreads;
+
+    // The records of the current batch, of which those before '_batchPos' have been consumed.
+    // Until the batch has been filtered '_numFiltered' is zero; a batch interrupted by a yield
+    // keeps the records read so far unfiltered and resumes reading after it. '_batchBytes' is
+    // the total size of the records read into the batch.
+    std::vector<BufferedRecord> _batch;
+    size_t _batchPos = 0;
+    size_t _numFiltered = 0;
+    size_t _batchBytes = 0;
+
+    // The number of records to read in the next batch. Starts small so that scans which stop
+    // early do not read far ahead, and grows with every batch.
+    size_t _nextBatchSize;
+
+    // True once the cursor has returned EOF.
+    bool _cursorExhausted = false;
+
+    // Stats
+    CollectionScanStats _specificStats;
+};
+
+}  // namespace mongo
@@ -33,15 +33,96 @@
 
 #include "mongo/db/exec/plan_stage.h"
 
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <time.h>
+#endif
+
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/recovery_unit.h"
 
 namespace mongo {
+namespace {
+
+const auto collectDetailedStatsDecoration = OperationContext::declareDecoration<bool>();
+
+/**
+ * Returns the CPU time used by the calling thread, in nanoseconds.
+ */
+long long threadCpuNanos() {
+#if defined(_WIN32)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    auto toHundredNanos = [](const FILETIME& t) {
+        return (static_cast<long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+    };
+    return (toHundredNanos(kernelTime) + toHundredNanos(userTime)) * 100;
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<long long>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+#endif
+}
+
+/**
+ * Adds the CPU time and storage engine activity of the executing thread during its lifetime to
+ * 'stats', if the operation gathers detailed statistics.
+ */
+class ScopedDetailedStats {
+    MONGO_DISALLOW_COPYING(ScopedDetailedStats);
+
+public:
+    ScopedDetailedStats(OperationContext* opCtx, CommonStats* stats)
+        : _opCtx(opCtx), _stats(collectDetailedStatsDecoration(opCtx) ? stats : nullptr) {
+        if (!_stats) {
+            return;
+        }
+        _startStorage = _opCtx->recoveryUnit()->getStorageCounters();
+        _startCpuNanos = threadCpuNanos();
+    }
+
+    ~ScopedDetailedStats() {
+        if (!_stats) {
+            return;
+        }
+        const long long cpuNanos = threadCpuNanos() - _startCpuNanos;
+        const auto storage = _opCtx->recoveryUnit()->getStorageCounters();
+
+        // The counters are per storage engine session, which can change while a stage works,
+        // making differences meaningless; those are dropped.
+        auto delta = [](long long end, long long start) { return std::max(end - start, 0LL); };
+        _stats->detailedStats = true;
+        _stats->cpuNanos += std::max(cpuNanos, 0LL);
+        _stats->storageBytesRead += delta(storage.bytesRead, _startStorage.bytesRead);
+        _stats->storageReadMicros += delta(storage.readMicros, _startStorage.readMicros);
+        _stats->storageCacheWaitMicros +=
+            delta(storage.cacheWaitMicros, _startStorage.cacheWaitMicros);
+    }
+
+private:
+    OperationContext* const _opCtx;
+    CommonStats* const _stats;
+    RecoveryUnit::StorageCounters _startStorage;
+    long long _startCpuNanos = 0;
+};
+
+}  // namespace
+
+void PlanStage::setCollectDetailedStats(OperationContext* opCtx, bool collect) {
+    collectDetailedStatsDecoration(opCtx) = collect;
+}
 
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedDetailedStats detailedStats(_opCtx, &_commonStats);
     ++_commonStats.works;
 
     StageState workResult = doWork(out);
@@ -57,6 +138,66 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(WorkingSet* ws,
+                                           size_t maxWorks,
+                                           std::vector<WorkingSetID>* out,
+                                           WorkingSetID* lastOut) {
+    invariant(_opCtx);
+    invariant(maxWorks > 0);
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedDetailedStats detailedStats(_opCtx, &_commonStats);
+
+    *lastOut = WorkingSet::INVALID_ID;
+    return doWorkBatch(ws, maxWorks, out, lastOut);
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(WorkingSet* ws,
+                                             size_t maxWorks,
+                                             std::vector<WorkingSetID>* out,
+                                             WorkingSetID* lastOut) {
+    StageState workResult = StageState::NEED_TIME;
+    for (size_t i = 0; i < maxWorks; ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        ++_commonStats.works;
+        workResult = doWork(&id);
+
+        if (StageState::ADVANCED == workResult) {
+            ++_commonStats.advanced;
+            out->push_back(id);
+
+            // A document which points into storage engine memory is only valid until the next
+            // unit of work. Rather than copy it, which costs more than batching saves, end the
+            // batch with it.
+            WorkingSetMember* member = ws->get(id);
+            if (member->hasObj() && !member->hasOwnedObj()) {
+                break;
+            }
+        } else if (StageState::NEED_TIME == workResult) {
+            ++_commonStats.needTime;
+        } else {
+            if (StageState::NEED_YIELD == workResult) {
+                ++_commonStats.needYield;
+            }
+            *lastOut = id;
+            break;
+        }
+    }
+
+    return workResult;
+}
+
+PlanStage::WorkCounters PlanStage::childWorkCounters() const {
+    const CommonStats* childStats = child()->getCommonStats();
+    return {childStats->works, childStats->needTime, childStats->needYield};
+}
+
+void PlanStage::creditChildBatchWork(const WorkCounters& before) {
+    const WorkCounters after = childWorkCounters();
+    _commonStats.works += after.works - before.works;
+    _commonStats.needTime += after.needTime - before.needTime;
+    _commonStats.needYield += after.needYield - before.needYield;
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
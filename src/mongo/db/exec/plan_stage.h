@@ -170,6 +170,14 @@ public:
         FAILURE,
     };
 
+    /**
+     * Sets whether the plan stages run by 'opCtx' gather the detailed statistics of CommonStats,
+     * the CPU time and storage engine activity of every stage. Gathering them costs a few system
+     * calls per call to work(), so it is only enabled by explain with executionStats verbosity or
+     * higher.
+     */
+    static void setCollectDetailedStats(OperationContext* opCtx, bool collect);
+
     static std::string stateStr(const StageState& state) {
         if (ADVANCED == state) {
             return "ADVANCED";
@@ -193,6 +201,29 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Performs up to 'maxWorks' units of work, appending the WorkingSetID of every result produced
+     * to 'out'. The outcome is the same as calling work() that many times, but stages which can
+     * process their input a batch at a time use this to avoid paying the per-call overhead of
+     * work() for every result.
+     *
+     * The batch ends early at the first unit of work which returns something other than ADVANCED
+     * or NEED_TIME. The state of the last unit of work is returned. If that unit set an id which
+     * is not a result, such as the status member of a FAILURE, it is stored in '*lastOut';
+     * otherwise '*lastOut' is set to WorkingSet::INVALID_ID. The results appended to 'out' are
+     * valid whatever state is returned, and the caller should consume them before acting on it.
+     *
+     * Storage engines only promise that record data remains valid until the next operation on the
+     * cursor which produced it, so only the last result appended to 'out' may hold a document
+     * which is not owned. The default implementation ends the batch at such a result rather than
+     * copying it, so plans whose results point into the storage engine are worked one result at a
+     * time, as work() would.
+     */
+    StageState workBatch(WorkingSet* ws,
+                         size_t maxWorks,
+                         std::vector<WorkingSetID>* out,
+                         WorkingSetID* lastOut);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -341,6 +372,40 @@ protected:
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work.  See comment at workBatch() above.
+     *
+     * The default implementation calls doWork() in a loop. Stages which override this are
+     * responsible for keeping their CommonStats counters identical to those work() would have
+     * produced.
+     */
+    virtual StageState doWorkBatch(WorkingSet* ws,
+                                   size_t maxWorks,
+                                   std::vector<WorkingSetID>* out,
+                                   WorkingSetID* lastOut);
+
+    /**
+     * The counters of a stage's CommonStats which record how many units of work it has done.
+     */
+    struct WorkCounters {
+        size_t works;
+        size_t needTime;
+        size_t needYield;
+    };
+
+    /**
+     * Returns the current work counters of this stage's only child.
+     */
+    WorkCounters childWorkCounters() const;
+
+    /**
+     * For stages whose doWorkBatch() passes a batch from their only child through. Credits this
+     * stage with one unit of work for each unit of work the child has done since 'before' was
+     * taken, along with the child's NEED_TIMEs and NEED_YIELDs. The caller is left to count the
+     * results it advances and any further NEED_TIMEs it produces by discarding results.
+     */
+    void creditChildBatchWork(const WorkCounters& before);
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -65,6 +65,11 @@ struct CommonStats {
           needTime(0),
           needYield(0),
           executionTimeMillis(0),
+          detailedStats(false),
+          cpuNanos(0),
+          storageBytesRead(0),
+          storageReadMicros(0),
+          storageCacheWaitMicros(0),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -86,6 +91,19 @@ struct CommonStats {
     // Time elapsed while working inside this stage.
     long long executionTimeMillis;
 
+    // Whether the detailed statistics below were gathered. This is only done while explaining an
+    // operation with executionStats verbosity or higher; see PlanStage::setCollectDetailedStats().
+    bool detailedStats;
+
+    // CPU time used by the executing thread while working inside this stage, in nanoseconds.
+    long long cpuNanos;
+
+    // Storage engine activity while working inside this stage. See
+    // RecoveryUnit::StorageCounters.
+    long long storageBytesRead;
+    long long storageReadMicros;
+    long long storageCacheWaitMicros;
+
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
 
@@ -152,6 +170,10 @@ struct AndHashStats : public SpecificStats {
     // mapAfterChild[mapAfterChild.size() - 1] WSMswere match tested.
     // commonstats.advanced is how many passed.
 
+    // How many RecordIds from children after the first were discarded by the Bloom filter
+    // without probing the hash table?
+    size_t filterRejects = 0u;
+
     // What's our current memory usage?
     size_t memUsage = 0u;
 
@@ -441,11 +463,34 @@ struct MockStats : public SpecificStats {
 };
 
 struct MultiPlanStats : public SpecificStats {
+    /**
+     * The result of counting the index keys that a single-index candidate plan would scan.
+     */
+    struct CandidateCostEstimate {
+        std::string planSummary;
+
+        // The number of index keys examined, and the number of those which passed the index
+        // filter and would therefore be fetched.
+        size_t keysExamined = 0u;
+        size_t keysMatched = 0u;
+
+        // False if counting stopped at 'internalQueryPlanCostBasedSelectionMaxKeys', in which case
+        // the counts are only a lower bound.
+        bool exact = false;
+    };
+
     MultiPlanStats() {}
 
     SpecificStats* clone() const final {
         return new MultiPlanStats(*this);
     }
+
+    // One entry per candidate plan, in candidate order, if cost-based plan selection was
+    // attempted. Empty otherwise.
+    std::vector<CandidateCostEstimate> costEstimates;
+
+    // Whether the winning plan was chosen from 'costEstimates' rather than by a trial period.
+    bool chosenByCostEstimate = false;
 };
 
 struct OrStats : public SpecificStats {
@@ -491,6 +536,12 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // The number of leading fields of 'sortPattern' by which the input was already ordered.
+    size_t sortedPrefixLength = 0u;
+
+    // How many groups of results sharing a sorted prefix were sorted separately.
+    size_t groupsSorted = 0u;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -556,6 +607,8 @@ struct NearStats : public SpecificStats {
     // btree index version, not geo index version
     int indexVersion;
     BSONObj keyPattern;
+    // Documents fetched after their index entries were buffered without fetching them
+    size_t docsExamined = 0u;
 };
 
 struct UpdateStats : public SpecificStats {
@@ -630,6 +683,14 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // The number of documents the stage was asked to return in score order, or zero if it
+    // returned every matching document.
+    size_t topK = 0;
+
+    // True if the stage stopped reading the text index because no unread posting could place
+    // another document among the top 'topK' results.
+    bool stoppedEarly = false;
 };
 
 struct TrialStats : public SpecificStats {
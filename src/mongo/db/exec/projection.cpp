@@ -181,6 +181,38 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(WorkingSet* ws,
+                                                   size_t maxWorks,
+                                                   std::vector<WorkingSetID>* out,
+                                                   WorkingSetID* lastOut) {
+    // Our units of work map one to one onto our child's, so pass its whole batch through and
+    // transform the results in place.
+    const size_t firstResult = out->size();
+    const WorkCounters childBefore = childWorkCounters();
+    StageState status = child()->workBatch(ws, maxWorks, out, lastOut);
+    creditChildBatchWork(childBefore);
+
+    for (size_t i = firstResult; i < out->size(); ++i) {
+        Status projStatus = transform(_ws.get((*out)[i]));
+        if (!projStatus.isOK()) {
+            warning() << "Couldn't execute projection, status = " << redact(projStatus);
+            for (size_t j = i; j < out->size(); ++j) {
+                _ws.free((*out)[j]);
+            }
+            if (PlanStage::FAILURE == status) {
+                _ws.free(*lastOut);
+            }
+            out->resize(i);
+            _commonStats.advanced += i - firstResult;
+            *lastOut = WorkingSetCommon::allocateStatusMember(&_ws, projStatus);
+            return PlanStage::FAILURE;
+        }
+    }
+
+    _commonStats.advanced += out->size() - firstResult;
+    return status;
+}
+
 std::unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     auto ret = std::make_unique<PlanStageStats>(_commonStats, stageType());
@@ -54,6 +54,10 @@ protected:
 public:
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(WorkingSet* ws,
+                           size_t maxWorks,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* lastOut) final;
 
     std::unique_ptr<PlanStageStats> getStats() final;
 
@@ -238,7 +238,7 @@ StatusWith<BSONObj> ProjectionExec::project(const BSONObj& in,
         return {addMeta(std::move(bob), geoDistance, geoNearPoint, sortKey, textScore, recordId)};
 }
 
-StatusWith<BSONObj> ProjectionExec::projectCovered(const std::vector<IndexKeyDatum>& keyData,
+StatusWith<BSONObj> ProjectionExec::projectCovered(const IndexKeyDatumVector& keyData,
                                                    const boost::optional<const double> geoDistance,
                                                    const BSONObj& geoNearPoint,
                                                    const BSONObj& sortKey,
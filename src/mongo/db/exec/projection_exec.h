@@ -145,7 +145,7 @@ public:
      * still covered by indices.
      */
     StatusWith<BSONObj> projectCovered(
-        const std::vector<IndexKeyDatum>& keyData,
+        const IndexKeyDatumVector& keyData,
         const boost::optional<const double> geoDistance = boost::none,
         const BSONObj& geoNearPoint = BSONObj(),
         const BSONObj& sortKey = BSONObj(),
@@ -124,4 +124,102 @@ TEST_F(QueuedDataStageTest, validateStats) {
     unique_ptr<PlanStageStats> allStats(mock->getStats());
     ASSERT_TRUE(stats->isEOF);
 }
+
+//
+// Test that workBatch() stops at the first state which isn't ADVANCED or NEED_TIME, and counts
+// each unit of work the same way work() does.
+//
+TEST_F(QueuedDataStageTest, workBatchStopsAtNeedYield) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    WorkingSetID first = ws.allocate();
+    WorkingSetID second = ws.allocate();
+    WorkingSetID third = ws.allocate();
+    mock->pushBack(PlanStage::NEED_TIME);
+    mock->pushBack(first);
+    mock->pushBack(second);
+    mock->pushBack(PlanStage::NEED_YIELD);
+    mock->pushBack(third);
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID lastId;
+    ASSERT_EQUALS(PlanStage::NEED_YIELD, mock->workBatch(&ws, 10, &batch, &lastId));
+    ASSERT_EQUALS(2U, batch.size());
+    ASSERT_EQUALS(first, batch[0]);
+    ASSERT_EQUALS(second, batch[1]);
+
+    const CommonStats* stats = mock->getCommonStats();
+    ASSERT_EQUALS(stats->works, 4U);
+    ASSERT_EQUALS(stats->needTime, 1U);
+    ASSERT_EQUALS(stats->advanced, 2U);
+    ASSERT_EQUALS(stats->needYield, 1U);
+
+    batch.clear();
+    ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(&ws, 10, &batch, &lastId));
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(third, batch[0]);
+    ASSERT_EQUALS(WorkingSet::INVALID_ID, lastId);
+    ASSERT_EQUALS(stats->works, 6U);
+}
+
+//
+// Test that workBatch() does no more than the requested number of units of work.
+//
+TEST_F(QueuedDataStageTest, workBatchHonorsMaxWorks) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    for (int i = 0; i < 5; ++i) {
+        mock->pushBack(ws.allocate());
+    }
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID lastId;
+    ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(&ws, 3, &batch, &lastId));
+    ASSERT_EQUALS(3U, batch.size());
+    ASSERT_EQUALS(mock->getCommonStats()->works, 3U);
+
+    ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(&ws, 3, &batch, &lastId));
+    ASSERT_EQUALS(5U, batch.size());
+    ASSERT_TRUE(mock->isEOF());
+}
+
+//
+// Test that workBatch() ends the batch at a result whose document is not owned, instead of copying
+// it, so that batching never costs more than working one result at a time.
+//
+TEST_F(QueuedDataStageTest, workBatchEndsAtUnownedResultWithoutCopyingIt) {
+    const BSONObj storage = BSON("a" << 1);
+
+    WorkingSet ws;
+    auto makeResult = [&](BSONObj obj) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->recordId = RecordId(1);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+        ws.transitionToRecordIdAndObj(id);
+        return id;
+    };
+    WorkingSetID owned = makeResult(storage);
+    WorkingSetID unowned = makeResult(BSONObj(storage.objdata()));
+    WorkingSetID last = makeResult(storage);
+
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    mock->pushBack(owned);
+    mock->pushBack(unowned);
+    mock->pushBack(last);
+
+    std::vector<WorkingSetID> batch;
+    WorkingSetID lastId;
+    ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(&ws, 10, &batch, &lastId));
+    ASSERT_EQUALS(2U, batch.size());
+    ASSERT_EQUALS(owned, batch[0]);
+    ASSERT_EQUALS(unowned, batch[1]);
+    ASSERT_FALSE(ws.get(unowned)->hasOwnedObj());
+    ASSERT_EQUALS(storage.objdata(), ws.get(unowned)->obj.value().objdata());
+    ASSERT_EQUALS(mock->getCommonStats()->works, 2U);
+
+    ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(&ws, 10, &batch, &lastId));
+    ASSERT_EQUALS(3U, batch.size());
+    ASSERT_EQUALS(last, batch[2]);
+}
 }
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bloom_filter.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+namespace {
+
+// Odd constants used to derive the eight per-word bit positions from one 32-bit hash, as in the
+// split block Bloom filter design.
+constexpr std::array<uint32_t, 8> kSalts = {0x47b6137bU,
+                                            0x44974d91U,
+                                            0x8824ad5bU,
+                                            0xa2b7289dU,
+                                            0x705495c7U,
+                                            0x2df1424bU,
+                                            0x9efc4947U,
+                                            0x5c6bfb31U};
+
+}  // namespace
+
+RecordIdBloomFilter::RecordIdBloomFilter(size_t expectedEntries, size_t bitsPerEntry) {
+    const size_t bitsPerBlock = kWordsPerBlock * 32;
+    const size_t minBlocks =
+        std::max<size_t>(1, (expectedEntries * bitsPerEntry + bitsPerBlock - 1) / bitsPerBlock);
+
+    size_t numBlocks = 1;
+    while (numBlocks < minBlocks) {
+        numBlocks <<= 1;
+    }
+
+    _blocks.assign(numBlocks, Block{});
+    _blockMask = numBlocks - 1;
+}
+
+// static
+uint64_t RecordIdBloomFilter::hash(const RecordId& id) {
+    // The 64-bit finalizer from MurmurHash3. RecordIds are frequently dense, so their raw
+    // representation must be mixed before its bits are used to pick blocks and bit positions.
+    uint64_t h = static_cast<uint64_t>(id.repr());
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// static
+RecordIdBloomFilter::Block RecordIdBloomFilter::makeMask(uint32_t hash) {
+    Block mask;
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+        mask[i] = 1U << ((hash * kSalts[i]) >> 27);
+    }
+    return mask;
+}
+
+void RecordIdBloomFilter::insert(const RecordId& id) {
+    const uint64_t h = hash(id);
+    Block& block = _blocks[(h >> 32) & _blockMask];
+    const Block mask = makeMask(static_cast<uint32_t>(h));
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+        block[i] |= mask[i];
+    }
+}
+
+bool RecordIdBloomFilter::mayContain(const RecordId& id) const {
+    const uint64_t h = hash(id);
+    const Block& block = _blocks[(h >> 32) & _blockMask];
+    const Block mask = makeMask(static_cast<uint32_t>(h));
+    for (size_t i = 0; i < kWordsPerBlock; ++i) {
+        if ((block[i] & mask[i]) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
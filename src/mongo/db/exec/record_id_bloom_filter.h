@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A blocked Bloom filter over RecordIds. Each RecordId maps to one 32-byte block and sets one bit
+ * in each of the block's eight words, so a membership test touches a single cache line.
+ *
+ * mayContain() never returns false for an inserted RecordId. With the default sizing of 16 bits
+ * per expected entry, it returns true for roughly 0.1% of RecordIds which were never inserted.
+ */
+class RecordIdBloomFilter {
+public:
+    static constexpr size_t kDefaultBitsPerEntry = 16;
+
+    /**
+     * Sizes the filter for 'expectedEntries' insertions. The number of blocks is rounded up to a
+     * power of two.
+     */
+    explicit RecordIdBloomFilter(size_t expectedEntries,
+                                 size_t bitsPerEntry = kDefaultBitsPerEntry);
+
+    void insert(const RecordId& id);
+
+    bool mayContain(const RecordId& id) const;
+
+    /**
+     * Returns the number of bytes used by the filter's bit array.
+     */
+    size_t getMemUsage() const {
+        return _blocks.size() * sizeof(Block);
+    }
+
+private:
+    static constexpr size_t kWordsPerBlock = 8;
+    using Block = std::array<uint32_t, kWordsPerBlock>;
+
+    static uint64_t hash(const RecordId& id);
+
+    /**
+     * Returns the bits to set or test in a block for the low-order half of a RecordId's hash.
+     */
+    static Block makeMask(uint32_t hash);
+
+    std::vector<Block> _blocks;
+
+    // _blocks.size() - 1.
+    uint64_t _blockMask;
+};
+
+}  // namespace mongo
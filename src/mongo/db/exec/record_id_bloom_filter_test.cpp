@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bloom_filter.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdBloomFilterTest, ContainsEveryInsertedRecordId) {
+    RecordIdBloomFilter filter(1000);
+    for (int64_t i = 1; i <= 1000; ++i) {
+        filter.insert(RecordId(i * 7));
+    }
+    for (int64_t i = 1; i <= 1000; ++i) {
+        ASSERT_TRUE(filter.mayContain(RecordId(i * 7)));
+    }
+}
+
+TEST(RecordIdBloomFilterTest, RejectsMostRecordIdsNeverInserted) {
+    const int64_t kNumEntries = 10000;
+    RecordIdBloomFilter filter(kNumEntries);
+    for (int64_t i = 0; i < kNumEntries; ++i) {
+        filter.insert(RecordId(2 * i + 1));
+    }
+
+    size_t falsePositives = 0;
+    for (int64_t i = 0; i < kNumEntries; ++i) {
+        if (filter.mayContain(RecordId(2 * i + 2))) {
+            ++falsePositives;
+        }
+    }
+
+    // The expected false positive rate is about 0.1%. Allow a generous margin.
+    ASSERT_LT(falsePositives, static_cast<size_t>(kNumEntries / 100));
+}
+
+TEST(RecordIdBloomFilterTest, EmptyFilterContainsNothing) {
+    RecordIdBloomFilter filter(0);
+    ASSERT_GT(filter.getMemUsage(), 0U);
+    ASSERT_FALSE(filter.mayContain(RecordId(1)));
+    ASSERT_FALSE(filter.mayContain(RecordId(RecordId::kMaxRepr)));
+}
+
+}  // namespace
+}  // namespace mongo
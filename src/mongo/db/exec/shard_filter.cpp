@@ -36,6 +36,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/s/chunk_writes_tracker.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -56,9 +57,14 @@ ShardFilterStage::ShardFilterStage(OperationContext* opCtx,
                                    PlanStage* child)
     : PlanStage(kStageType, opCtx), _ws(ws), _metadata(std::move(metadata)) {
     _children.emplace_back(child);
+    if (_metadata->isSharded()) {
+        _shardKeyPattern.emplace(_metadata->getKeyPattern());
+    }
 }
 
-ShardFilterStage::~ShardFilterStage() {}
+ShardFilterStage::~ShardFilterStage() {
+    _flushLastChunkReads();
+}
 
 bool ShardFilterStage::isEOF() {
     return child()->isEOF();
@@ -76,11 +82,10 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
         // If we're sharded make sure that we don't return data that is not owned by us,
         // including pending documents from in-progress migrations and orphaned documents from
         // aborted migrations
-        if (_metadata->isSharded()) {
-            ShardKeyPattern shardKeyPattern(_metadata->getKeyPattern());
+        if (_shardKeyPattern) {
             WorkingSetMember* member = _ws->get(*out);
             WorkingSetMatchableDocument matchable(member);
-            BSONObj shardKey = shardKeyPattern.extractShardKeyFromMatchable(matchable);
+            BSONObj shardKey = _shardKeyPattern->extractShardKeyFromMatchable(matchable);
 
             if (shardKey.isEmpty()) {
                 // We can't find a shard key for this document - this should never happen with
@@ -106,7 +111,7 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
                           << "document may have been inserted manually into shard";
             }
 
-            if (!_metadata->keyBelongsToMe(shardKey)) {
+            if (!_keyBelongsToMe(shardKey)) {
                 _ws->free(*out);
                 ++_specificStats.chunkSkips;
                 return PlanStage::NEED_TIME;
@@ -121,6 +126,36 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+bool ShardFilterStage::_keyBelongsToMe(const BSONObj& shardKey) {
+    if (shardKey.isEmpty()) {
+        return false;
+    }
+
+    if (!_lastChunk || !_lastChunk->containsKey(shardKey)) {
+        _flushLastChunkReads();
+        _lastChunk.emplace(
+            _metadata->getChunkManager()->findIntersectingChunkWithSimpleCollation(shardKey));
+    }
+
+    if (_lastChunk->getShardId() != _metadata->shardId()) {
+        return false;
+    }
+
+    ++_lastChunkReads;
+    return true;
+}
+
+void ShardFilterStage::_flushLastChunkReads() {
+    if (_lastChunkReads) {
+        _lastChunk->getWritesTracker()->addOperations(_lastChunkReads);
+        _lastChunkReads = 0;
+    }
+}
+
+void ShardFilterStage::doSaveState() {
+    _flushLastChunkReads();
+}
+
 unique_ptr<PlanStageStats> ShardFilterStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret =
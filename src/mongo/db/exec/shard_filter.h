@@ -29,8 +29,12 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/s/scoped_collection_metadata.h"
+#include "mongo/s/chunk.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
@@ -90,7 +94,23 @@ public:
 
     static const char* kStageType;
 
+protected:
+    void doSaveState() final;
+
 private:
+    /**
+     * Returns whether the document with the given shard key belongs to this shard, in the same
+     * way as CollectionMetadata::keyBelongsToMe(), but without searching the routing table when the
+     * key falls in the same chunk as the previous one.
+     */
+    bool _keyBelongsToMe(const BSONObj& shardKey);
+
+    /**
+     * Adds the documents counted against '_lastChunk' to the operations tracked for that chunk,
+     * which the balancer uses to find the chunks carrying most of the load of a shard.
+     */
+    void _flushLastChunkReads();
+
     WorkingSet* _ws;
 
     // Stats
@@ -99,6 +119,17 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     ScopedCollectionMetadata _metadata;
+
+    // The shard key pattern of the collection. Only set if the collection is sharded.
+    boost::optional<ShardKeyPattern> _shardKeyPattern;
+
+    // The chunk which contained the shard key of the last document checked. Results tend to come
+    // in shard key order, so the next document usually falls in the same chunk.
+    boost::optional<Chunk> _lastChunk;
+
+    // The number of documents owned by this shard returned from '_lastChunk', which have not
+    // been added to its writes tracker yet.
+    uint64_t _lastChunkReads = 0;
 };
 
 }  // namespace mongo
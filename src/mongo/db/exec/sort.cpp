@@ -55,10 +55,16 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
-SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
+SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p, bool useNormalizedKeys)
+    : pattern(p), useNormalizedKeys(useNormalizedKeys) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
+    if (useNormalizedKeys) {
+        // The RecordId is encoded at the end of the normalized key, so it breaks ties as well.
+        return lhs.normalizedKey.compare(rhs.normalizedKey) < 0;
+    }
+
     // False means ignore field names.
     int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
@@ -76,28 +82,38 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _sortedPrefixLength(params.sortedPrefixLength),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
-    _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
-
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+    invariant(_sortedPrefixLength == 0 ||
+              _sortedPrefixLength < static_cast<size_t>(sortComparator.nFields()));
+
+    // An Ordering describes at most kMaxCompoundIndexKeys fields. Longer patterns are compared
+    // field by field instead.
+    const bool useNormalizedKeys =
+        static_cast<size_t>(sortComparator.nFields()) <= Ordering::kMaxCompoundIndexKeys;
+    if (useNormalizedKeys) {
+        _ordering.emplace(Ordering::make(sortComparator));
     }
+    _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator, useNormalizedKeys);
 }
 
 SortStage::~SortStage() {}
 
 bool SortStage::isEOF() {
-    // We're done when our child has no more results, we've sorted the child's results, and
-    // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    // We're done when we've returned all sorted results of the last group, which is either the
+    // one holding the child's final results or the one reaching our limit.
+    if (!_sorted || _data.end() != _resultIterator) {
+        return false;
+    }
+    if (_limit > 0 && _numReturned + _data.size() >= _limit) {
+        return true;
+    }
+    return child()->isEOF() && !_nextGroupItem;
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
@@ -140,6 +156,23 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
+            if (_ordering) {
+                item.normalizedKey =
+                    KeyString(KeyString::kLatestVersion, item.sortKey, *_ordering, item.recordId)
+                        .getValueCopy();
+            }
+
+            if (_sortedPrefixLength > 0 && !_data.empty() && !inSameGroup(item, _data.front())) {
+                // The child has moved on to the next group, so every result of the current group
+                // has been buffered. Hold on to this item until the current group is returned.
+                member->makeObjOwnedIfNeeded();
+                _nextGroupItem = item;
+                sortBuffer();
+                _resultIterator = _data.begin();
+                _sorted = true;
+                return PlanStage::NEED_TIME;
+            }
+
             addToBuffer(item);
 
             return PlanStage::NEED_TIME;
@@ -163,9 +196,15 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
         return code;
     }
 
-    // Returning results.
-    verify(_resultIterator != _data.end());
     verify(_sorted);
+
+    // The current group has been returned, but not the last one.
+    if (_resultIterator == _data.end()) {
+        startNextGroup();
+        return PlanStage::NEED_TIME;
+    }
+
+    // Returning results.
     *out = _resultIterator->wsid;
     _resultIterator++;
 
@@ -176,9 +215,10 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
     _specificStats.memLimit = maxBytes;
-    _specificStats.memUsage = _memUsage;
+    _specificStats.memUsage = std::max(_specificStats.memUsage, _memUsage);
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
+    _specificStats.sortedPrefixLength = _sortedPrefixLength;
 
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_SORT);
     ret->specific = make_unique<SortStats>(_specificStats);
@@ -199,97 +239,99 @@ const SpecificStats* SortStage::getSpecificStats() const {
  * limit == 0:
  *     addToBuffer() - Adds item to vector.
  *     sortBuffer() - Sorts vector.
- * limit == 1:
- *     addToBuffer() - Replaces first item in vector with max of
- *                     current and new item.
- *                     Updates memory usage if item was replaced.
- *     sortBuffer() - Does nothing.
- * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
- *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ * limit > 0:
+ *     addToBuffer() - Adds item to a max-heap in the vector. Once the heap
+ *                     holds as many items as the group may return, a new
+ *                     item replaces the heap's root (the worst buffered item)
+ *                     if it sorts before it, and is discarded otherwise.
+ *                     Updates memory usage accordingly.
+ *     sortBuffer() - Sorts the heap in place.
+ *
+ * The limit of a group is the stage's limit less the results returned by earlier groups.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
-    // Holds ID of working set member to be freed at end of this function.
-    WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
+    const WorkingSetComparator& cmp = *_sortKeyComparator;
+    const size_t limit = (_limit == 0) ? 0 : _limit - _numReturned;
 
     WorkingSetMember* member = _ws->get(item.wsid);
-    if (_limit == 0) {
+    if (limit == 0 || _data.size() < limit) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
         _data.push_back(item);
-        _memUsage += member->getMemUsage();
-    } else if (_limit == 1) {
-        if (_data.empty()) {
-            member->makeObjOwnedIfNeeded();
-            _data.push_back(item);
-            _memUsage = member->getMemUsage();
-            return;
-        }
-        wsidToFree = item.wsid;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        // Compare new item with existing item in vector.
-        if (cmp(item, _data[0])) {
-            wsidToFree = _data[0].wsid;
-            member->makeObjOwnedIfNeeded();
-            _data[0] = item;
-            _memUsage = member->getMemUsage();
-        }
-    } else {
-        // Update data item set instead of vector
-        // Limit not reached - insert and return
-        vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
-            member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
-            return;
-        }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
-        wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += member->getMemUsage();
-            wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
-            member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+        _memUsage += getMemUsage(item);
+        if (limit > 0) {
+            std::push_heap(_data.begin(), _data.end(), cmp);
         }
+        return;
+    }
+
+    // Holds ID of working set member to be freed at end of this function.
+    WorkingSetID wsidToFree = item.wsid;
+    if (cmp(item, _data.front())) {
+        std::pop_heap(_data.begin(), _data.end(), cmp);
+        SortableDataItem& worstItem = _data.back();
+        _memUsage -= getMemUsage(worstItem);
+        wsidToFree = worstItem.wsid;
+        member->makeObjOwnedIfNeeded();
+        worstItem = item;
+        _memUsage += getMemUsage(item);
+        std::push_heap(_data.begin(), _data.end(), cmp);
     }
 
     // There was a buffered result which we can throw out because we are executing a sort with a
     // limit, and the result is now known not to be in the top k set. Free the working set member
     // associated with 'wsidToFree'.
-    if (wsidToFree != WorkingSet::INVALID_ID) {
-        _ws->free(wsidToFree);
-    }
+    _ws->free(wsidToFree);
 }
 
 void SortStage::sortBuffer() {
+    const WorkingSetComparator& cmp = *_sortKeyComparator;
     if (_limit == 0) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
         std::sort(_data.begin(), _data.end(), cmp);
-    } else if (_limit == 1) {
-        // Buffer contains either 0 or 1 item so it is already in a sorted state.
-        return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        std::sort_heap(_data.begin(), _data.end(), cmp);
+    }
+
+    if (_sortedPrefixLength > 0 && !_data.empty()) {
+        ++_specificStats.groupsSorted;
+    }
+}
+
+void SortStage::startNextGroup() {
+    invariant(_nextGroupItem);
+
+    // The results of the previous group now belong to our parent.
+    _numReturned += _data.size();
+    _data.clear();
+    _specificStats.memUsage = std::max(_specificStats.memUsage, _memUsage);
+    _memUsage = 0;
+    _sorted = false;
+
+    addToBuffer(*_nextGroupItem);
+    _nextGroupItem = boost::none;
+    _resultIterator = _data.end();
+}
+
+bool SortStage::inSameGroup(const SortableDataItem& lhs, const SortableDataItem& rhs) const {
+    // Sort keys hold one element per field of the sort pattern. Their collation has already been
+    // applied, so they are compared without a collator.
+    BSONObjIterator lhsIt(lhs.sortKey);
+    BSONObjIterator rhsIt(rhs.sortKey);
+    for (size_t i = 0; i < _sortedPrefixLength; ++i) {
+        invariant(lhsIt.more() && rhsIt.more());
+        if (lhsIt.next().woCompare(rhsIt.next(), false) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SortStage::getMemUsage(const SortableDataItem& item) const {
+    size_t memUsage = _ws->get(item.wsid)->getMemUsage();
+    if (_ordering) {
+        memUsage += item.normalizedKey.memUsageForSorter();
     }
+    return memUsage;
 }
 
 }  // namespace mongo
@@ -29,15 +29,17 @@
 
 #pragma once
 
-#include <set>
+#include <boost/optional.hpp>
 #include <vector>
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
@@ -54,15 +56,28 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit = 0;
+
+    // The number of leading fields of 'pattern' by which the child's results are already
+    // ordered. When nonzero, each group of results sharing those fields is sorted and returned
+    // before the next group is read.
+    size_t sortedPrefixLength = 0;
 };
 
 /**
  * Sorts the input received from the child according to the sort pattern provided.
  *
+ * With a limit of k, only the best k results seen so far are buffered, in a binary max-heap whose
+ * root is the worst of them. When the child's results arrive ordered by the first
+ * 'sortedPrefixLength' fields of the pattern, each run of results sharing those fields is sorted
+ * and returned on its own, so the stage streams results instead of blocking on its whole input
+ * and stops reading from the child once the limit has been returned.
+ *
  * Preconditions:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
  *   -- All WSMs produced by the child stage must have the sort key available as WSM computed data.
+ *   -- If 'sortedPrefixLength' is nonzero, results sharing the same values for the first
+ *   'sortedPrefixLength' sort key fields are returned by the child consecutively.
  */
 class SortStage final : public PlanStage {
 public:
@@ -99,6 +114,9 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // The number of leading sort key fields by which the child's results are already ordered.
+    size_t _sortedPrefixLength;
+
     //
     // Data storage
     //
@@ -115,54 +133,80 @@ private:
         // RecordId to break sortKey ties.
         // See sorta.js.
         RecordId recordId;
+        // The encoding of (sortKey, recordId) as a KeyString under the sort pattern's ordering,
+        // so that comparing two items is a byte comparison. Empty if the pattern has too many
+        // fields to build an Ordering, in which case items are compared field by field.
+        KeyString::Value normalizedKey;
     };
 
-    // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
-    // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // Comparison object for the data buffer. Items are compared on (sortKey, loc).
+    // This is also how the items are ordered in the indices. Keys are compared using their
+    // normalized KeyString encodings when available, and otherwise using BSONObj::woCompare()
+    // with RecordId as a tie-breaker.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
     struct WorkingSetComparator {
-        explicit WorkingSetComparator(BSONObj p);
+        WorkingSetComparator(BSONObj p, bool useNormalizedKeys);
 
         bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
         BSONObj pattern;
+        bool useNormalizedKeys;
     };
 
     /**
-     * Inserts one item into data buffer (vector or set).
-     * If limit is exceeded, remove item with lowest key.
+     * Inserts one item into the data buffer. If the buffer already holds as many items as the
+     * current group may return, the worst of them and the new item is discarded.
      */
     void addToBuffer(const SortableDataItem& item);
 
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
+    /**
+     * Clears the buffer of a group whose results have all been returned, and starts the next
+     * group with the item that ended the previous one.
+     */
+    void startNextGroup();
+
+    /**
+     * Returns true if 'lhs' and 'rhs' have the same values for the first '_sortedPrefixLength'
+     * fields of their sort keys.
+     */
+    bool inSameGroup(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
+
+    /**
+     * Returns the memory accounted to 'item' while it is buffered.
+     */
+    size_t getMemUsage(const SortableDataItem& item) const;
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // The ordering used to build normalized keys, if they are used.
+    boost::optional<Ordering> _ordering;
+
     // The data we buffer and sort.
-    // _data will contain sorted data when all data is gathered
-    // and sorted.
-    // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // _data will contain sorted data when all data for the current group is gathered and
+    // sorted. While gathering with a limit, _data is kept as a max-heap under the sort order so
+    // that the worst buffered item is always at the front.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
+    // The first item of the group following the one being returned, if it has been read.
+    boost::optional<SortableDataItem> _nextGroupItem;
+
+    // The number of results returned from earlier groups, which is less than '_limit' when
+    // there is a limit.
+    size_t _numReturned = 0;
+
     SortStats _specificStats;
 
     // The usage in bytes of all buffered data that we're sorting.
@@ -152,6 +152,64 @@ public:
         }
     }
 
+    /**
+     * Sorts the documents in 'inputStr', which are ordered by the first 'sortedPrefixLength'
+     * fields of 'patternStr', and checks that the results match 'expectedStr'. Also checks that
+     * the first result is returned before the whole input has been read and, if there is a limit,
+     * that the stage stops reading its input once the limit has been reached.
+     */
+    void testWorkWithSortedPrefix(const char* patternStr,
+                                  size_t sortedPrefixLength,
+                                  size_t limit,
+                                  const char* inputStr,
+                                  const char* expectedStr,
+                                  size_t expectedGroupsSorted) {
+        WorkingSet ws;
+
+        auto queuedDataStage = stdx::make_unique<QueuedDataStage>(getOpCtx(), &ws);
+        BSONObj inputObj = fromjson(inputStr);
+        for (auto&& elt : inputObj["input"].Obj()) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* wsm = ws.get(id);
+            wsm->obj = Snapshotted<BSONObj>(SnapshotId(), elt.Obj().getOwned());
+            wsm->transitionToOwnedObj();
+            queuedDataStage->pushBack(id);
+        }
+        QueuedDataStage* input = queuedDataStage.get();
+
+        SortStageParams params;
+        params.pattern = fromjson(patternStr);
+        params.limit = limit;
+        params.sortedPrefixLength = sortedPrefixLength;
+
+        auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+            getOpCtx(), queuedDataStage.release(), &ws, params.pattern, nullptr);
+        SortStage sort(getOpCtx(), params, &ws, sortKeyGen.release());
+
+        BSONArrayBuilder arr;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (state != PlanStage::IS_EOF) {
+            state = sort.work(&id);
+            ASSERT_NOT_EQUALS(state, PlanStage::FAILURE);
+            if (state == PlanStage::ADVANCED) {
+                if (arr.arrSize() == 0) {
+                    ASSERT_FALSE(input->isEOF());
+                }
+                arr.append(ws.get(id)->obj.value());
+            }
+        }
+        ASSERT_TRUE(sort.isEOF());
+        if (limit > 0) {
+            ASSERT_FALSE(input->isEOF());
+        }
+
+        ASSERT_BSONOBJ_EQ(BSON("output" << arr.arr()), fromjson(expectedStr));
+
+        auto stats = static_cast<const SortStats*>(sort.getSpecificStats());
+        ASSERT_EQ(stats->groupsSorted, expectedGroupsSorted);
+    }
+
 private:
     ServiceContext::UniqueOperationContext _opCtx;
 };
@@ -290,4 +348,39 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+//
+// Sorting input already ordered by a prefix of the sort pattern
+// Implementation should sort and return one group of results at a time.
+//
+
+TEST_F(SortStageTest, SortWithSortedPrefixReturnsEachGroupInOrder) {
+    testWorkWithSortedPrefix(
+        "{a: 1, b: -1}",
+        1,
+        0,
+        "{input: [{a: 1, b: 1}, {a: 1, b: 3}, {a: 2, b: 0}, {a: 2, b: 2}, {a: 3, b: 1}]}",
+        "{output: [{a: 1, b: 3}, {a: 1, b: 1}, {a: 2, b: 2}, {a: 2, b: 0}, {a: 3, b: 1}]}",
+        3);
+}
+
+TEST_F(SortStageTest, SortWithDescendingSortedPrefix) {
+    testWorkWithSortedPrefix("{a: -1, b: 1}",
+                             1,
+                             0,
+                             "{input: [{a: 3, b: 1}, {a: 2, b: 2}, {a: 2, b: 0}, {a: 1, b: 4}]}",
+                             "{output: [{a: 3, b: 1}, {a: 2, b: 0}, {a: 2, b: 2}, {a: 1, b: 4}]}",
+                             3);
+}
+
+TEST_F(SortStageTest, SortWithSortedPrefixAndLimitStopsReadingAfterLastGroup) {
+    testWorkWithSortedPrefix(
+        "{a: 1, b: 1}",
+        1,
+        3,
+        "{input: [{a: 1, b: 2}, {a: 1, b: 1}, {a: 2, b: 5}, {a: 2, b: 0}, {a: 2, b: 3},"
+        " {a: 3, b: 0}, {a: 4, b: 0}]}",
+        "{output: [{a: 1, b: 1}, {a: 1, b: 2}, {a: 2, b: 0}]}",
+        2);
+}
 }  // namespace
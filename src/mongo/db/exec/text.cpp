@@ -127,6 +127,15 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
 
         textScorer->addChildren(std::move(indexScanList));
 
+        // The TEXT_MATCH stage must accept every document that TEXT_OR chooses for the top k,
+        // which is only guaranteed when it has no negations, phrases or sensitivity checks.
+        const bool textMatchAcceptsAll = _params.query.getNegatedTerms().empty() &&
+            _params.query.getPositivePhr().empty() && _params.query.getNegatedPhr().empty() &&
+            !_params.query.getCaseSensitive() && !_params.query.getDiacriticSensitive();
+        if (_params.topK && textMatchAcceptsAll) {
+            textScorer->setTopK(_params.topK, _params.query.getTermsForBounds());
+        }
+
         textMatchStage = make_unique<TextMatchStage>(
             opCtx, std::move(textScorer), _params.query, _params.spec, ws);
     } else {
@@ -64,6 +64,10 @@ struct TextStageParams {
     // True if we need the text score in the output, because the projection includes the 'textScore'
     // metadata field.
     bool wantTextScore = true;
+
+    // If non-zero, only the 'topK' highest scoring documents are needed, because the results are
+    // sorted by text score and limited. The stage may then stop reading the index early.
+    size_t topK = 0;
 };
 
 /**
@@ -30,6 +30,7 @@
 #include "mongo/db/exec/text_or.h"
 
 #include <map>
+#include <numeric>
 #include <vector>
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -76,6 +77,17 @@ void TextOrStage::addChildren(Children childrenToAdd) {
                      std::make_move_iterator(childrenToAdd.end()));
 }
 
+void TextOrStage::setTopK(size_t k, std::set<std::string> terms) {
+    invariant(k > 0);
+    invariant(_internalState == State::kInit);
+    _topK = k;
+    _terms = std::move(terms);
+    // No posting has been read yet, so nothing bounds the score of the unseen documents.
+    _lastTermScores.assign(_children.size(), fts::MAX_WEIGHT);
+    _exhaustedChildren.assign(_children.size(), false);
+    _specificStats.topK = k;
+}
+
 bool TextOrStage::isEOF() {
     return _internalState == State::kDone;
 }
@@ -184,9 +196,20 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        StageState state = addTerm(id, out);
+        if (_topK && PlanStage::NEED_YIELD != state) {
+            advanceTopK();
+        }
+        return state;
     } else if (PlanStage::IS_EOF == childState) {
         // Done with this child.
+        if (_topK) {
+            _lastTermScores[_currentChild] = 0;
+            _exhaustedChildren[_currentChild] = true;
+            advanceTopK();
+            return PlanStage::NEED_TIME;
+        }
+
         ++_currentChild;
 
         if (_currentChild < _children.size()) {
@@ -219,6 +242,68 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+void TextOrStage::advanceTopK() {
+    // Read the children round-robin, so that the bound on the unseen documents falls evenly.
+    bool allExhausted = true;
+    for (size_t i = 1; i <= _children.size(); ++i) {
+        size_t next = (_currentChild + i) % _children.size();
+        if (!_exhaustedChildren[next]) {
+            _currentChild = next;
+            allExhausted = false;
+            break;
+        }
+    }
+
+    if (!allExhausted) {
+        if (_topScores.size() < _topK) {
+            return;
+        }
+
+        // A document that no child has returned yet scores at most the sum of the scores last
+        // read from each child, since every child returns its postings in descending score order.
+        const double unseenBound =
+            std::accumulate(_lastTermScores.begin(), _lastTermScores.end(), 0.0);
+        if (_topScores.top() < unseenBound) {
+            return;
+        }
+        _specificStats.stoppedEarly = true;
+    }
+
+    _scoreIterator = _scores.begin();
+    _internalState = State::kReturningResults;
+}
+
+void TextOrStage::scoreCandidate(TextRecordData* textRecordData) {
+    // The index holds one key per term with the score that FTSSpec::scoreDocument() computes for
+    // the document, so rescoring the document yields its full score across all query terms.
+    fts::TermFrequencyMap documentScores;
+    _ftsSpec.scoreDocument(_ws->get(textRecordData->wsid)->obj.value(), &documentScores);
+
+    double score = 0;
+    for (auto&& term : _terms) {
+        auto it = documentScores.find(term);
+        if (it != documentScores.end()) {
+            score += it->second;
+        }
+    }
+
+    if (_topScores.size() < _topK) {
+        _topScores.push(score);
+    } else if (score > _topScores.top()) {
+        _topScores.pop();
+        _topScores.push(score);
+    } else {
+        // This document can never be among the top k. Keep it marked as rejected so that the
+        // postings of its other terms are skipped.
+        _ws->free(textRecordData->wsid);
+        textRecordData->wsid = WorkingSet::INVALID_ID;
+        textRecordData->score = -1;
+        return;
+    }
+
+    textRecordData->score = score;
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -235,6 +320,12 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
+    // Drop the documents that were pushed out of the top k after they were scored.
+    if (_topK && _topScores.size() == _topK && textRecordData.score < _topScores.top()) {
+        _ws->free(textRecordData.wsid);
+        return PlanStage::NEED_TIME;
+    }
+
     WorkingSetMember* wsm = _ws->get(textRecordData.wsid);
 
     // Populate the working set member with the text score and return it.
@@ -250,6 +341,21 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
     TextRecordData* textRecordData = &_scores[wsm->recordId];
 
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(newKeyData.keyData);
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    BSONElement scoreElement = keyIt.next();
+    double documentTermScore = scoreElement.number();
+
+    if (_topK) {
+        _lastTermScores[_currentChild] = documentTermScore;
+    }
+
     if (textRecordData->score < 0) {
         // We have already rejected this document for not matching the filter.
         invariant(WorkingSet::INVALID_ID == textRecordData->wsid);
@@ -287,6 +393,15 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
 
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         wsm->makeObjOwnedIfNeeded();
+
+        if (_topK) {
+            scoreCandidate(textRecordData);
+            return NEED_TIME;
+        }
+    } else if (_topK) {
+        // The document was scored in full when it was first seen.
+        _ws->free(wsid);
+        return NEED_TIME;
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
@@ -297,17 +412,6 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
-    }
-
-    keyIt.next();  // Skip past 'term'.
-
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
-
     // Aggregate relevance score, term keys.
     textRecordData->score += documentTermScore;
     return NEED_TIME;
@@ -30,6 +30,10 @@
 #pragma once
 
 #include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/fts/fts_spec.h"
@@ -47,6 +51,12 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If a top k is set, the stage only returns the k highest scoring documents (and any ties with the
+ * k-th). Each child scans the postings of one term in descending score order, so the children are
+ * read round-robin and the scores last read bound the score of every document not seen yet. A
+ * document is scored in full from its contents when first seen, and reading stops as soon as k
+ * documents score at least that bound.
  */
 class TextOrStage final : public RequiresCollectionStage {
 public:
@@ -77,6 +87,12 @@ public:
 
     void addChildren(Children childrenToAdd);
 
+    /**
+     * Restricts the output to the 'k' highest scoring documents. 'terms' must be the terms whose
+     * postings the children scan. Must be called after all children are added.
+     */
+    void setTopK(size_t k, std::set<std::string> terms);
+
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
@@ -100,6 +116,8 @@ protected:
     void doRestoreStateRequiresCollection() final;
 
 private:
+    struct TextRecordData;
+
     /**
      * Worker for kInit. Initializes the _recordCursor member and handles the potential for
      * getCursor() to throw WriteConflictException.
@@ -123,6 +141,18 @@ private:
      */
     StageState returnResults(WorkingSetID* out);
 
+    /**
+     * Top k mode only. Scores the fetched document held by 'textRecordData' in full and keeps it
+     * only if it can still be among the top k documents.
+     */
+    void scoreCandidate(TextRecordData* textRecordData);
+
+    /**
+     * Top k mode only. Moves _currentChild to the next child that is not exhausted, or moves to
+     * kReturningResults once every child is exhausted or the top k documents are settled.
+     */
+    void advanceTopK();
+
     // The index spec used to determine where to find the score.
     FTSSpec _ftsSpec;
 
@@ -152,6 +182,14 @@ private:
 
     TextOrStats _specificStats;
 
+    // Top k mode only. The query terms, the score of the posting last read from each child (zero
+    // once the child is exhausted), and a min-heap of the best k document scores seen so far.
+    size_t _topK = 0;
+    std::set<std::string> _terms;
+    std::vector<double> _lastTermScores;
+    std::vector<bool> _exhaustedChildren;
+    std::priority_queue<double, std::vector<double>, std::greater<double>> _topScores;
+
     // Members needed only for using the TextMatchableDocument.
     const MatchExpression* _filter;
     WorkingSetID _idRetrying;
@@ -204,17 +204,6 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     // If asked to return new doc, default to the oldObj, in case nothing changes.
     BSONObj newObj = oldObj.value();
 
-    // Ask the driver to apply the mods. It may be that the driver can apply those "in
-    // place", that is, some values of the old document just get adjusted without any
-    // change to the binary layout on the bson layer. It may be that a whole new document
-    // is needed to accomodate the new bson layout of the resulting document. In any event,
-    // only enable in-place mutations if the underlying storage engine offers support for
-    // writing damage events.
-    _doc.reset(oldObj.value(),
-               (collection()->updateWithDamagesSupported()
-                    ? mutablebson::Document::kInPlaceEnabled
-                    : mutablebson::Document::kInPlaceDisabled));
-
     BSONObj logObj;
 
     bool docWasModified = false;
@@ -231,58 +220,80 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
         immutablePaths.keepShortest(&idFieldRef);
     }
-    if (!driver->needMatchDetails()) {
-        // If we don't need match details, avoid doing the rematch
-        status = driver->update(StringData(),
-                                &_doc,
-                                validateForStorage,
-                                immutablePaths,
-                                isInsert,
-                                &logObj,
-                                &docWasModified);
-    } else {
-        // If there was a matched field, obtain it.
-        MatchDetails matchDetails;
-        matchDetails.requestElemMatchKey();
-
-        dassert(cq);
-        verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
-
-        string matchedField;
-        if (matchDetails.hasElemMatchKey())
-            matchedField = matchDetails.elemMatchKey();
 
-        status = driver->update(matchedField,
-                                &_doc,
-                                validateForStorage,
-                                immutablePaths,
-                                isInsert,
-                                &logObj,
-                                &docWasModified);
-    }
+    // Updates that only $set or $inc top-level fields are applied directly to the BSON of the
+    // document. Documents whose _id is missing or not first are left to the driver below, which
+    // fixes up the _id field as part of the update.
+    boost::optional<BSONObj> updatedObj;
+    if (driver->canApplyToBSON() && oldObj.value().firstElementFieldName() == "_id"_sd) {
+        updatedObj = driver->applyToBSON(oldObj.value(), immutablePaths, &logObj, &docWasModified);
+    }
+
+    if (!updatedObj) {
+        // Ask the driver to apply the mods. It may be that the driver can apply those "in
+        // place", that is, some values of the old document just get adjusted without any
+        // change to the binary layout on the bson layer. It may be that a whole new document
+        // is needed to accomodate the new bson layout of the resulting document. In any event,
+        // only enable in-place mutations if the underlying storage engine offers support for
+        // writing damage events.
+        _doc.reset(oldObj.value(),
+                   (collection()->updateWithDamagesSupported()
+                        ? mutablebson::Document::kInPlaceEnabled
+                        : mutablebson::Document::kInPlaceDisabled));
+
+        if (!driver->needMatchDetails()) {
+            // If we don't need match details, avoid doing the rematch
+            status = driver->update(StringData(),
+                                    &_doc,
+                                    validateForStorage,
+                                    immutablePaths,
+                                    isInsert,
+                                    &logObj,
+                                    &docWasModified);
+        } else {
+            // If there was a matched field, obtain it.
+            MatchDetails matchDetails;
+            matchDetails.requestElemMatchKey();
+
+            dassert(cq);
+            verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
+
+            string matchedField;
+            if (matchDetails.hasElemMatchKey())
+                matchedField = matchDetails.elemMatchKey();
+
+            status = driver->update(matchedField,
+                                    &_doc,
+                                    validateForStorage,
+                                    immutablePaths,
+                                    isInsert,
+                                    &logObj,
+                                    &docWasModified);
+        }
 
-    if (!status.isOK()) {
-        uasserted(16837, status.reason());
-    }
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
+        }
 
-    // Skip adding _id field if the collection is capped (since capped collection documents can
-    // neither grow nor shrink).
-    const auto createIdField = !collection()->isCapped();
+        // Skip adding _id field if the collection is capped (since capped collection documents
+        // can neither grow nor shrink).
+        const auto createIdField = !collection()->isCapped();
 
-    // Ensure if _id exists it is first
-    status = ensureIdFieldIsFirst(&_doc);
-    if (status.code() == ErrorCodes::InvalidIdField) {
-        // Create ObjectId _id field if we are doing that
-        if (createIdField) {
-            addObjectIDIdField(&_doc);
+        // Ensure if _id exists it is first
+        status = ensureIdFieldIsFirst(&_doc);
+        if (status.code() == ErrorCodes::InvalidIdField) {
+            // Create ObjectId _id field if we are doing that
+            if (createIdField) {
+                addObjectIDIdField(&_doc);
+            }
+        } else {
+            uassertStatusOK(status);
         }
-    } else {
-        uassertStatusOK(status);
     }
 
     // See if the changes were applied in place
     const char* source = NULL;
-    const bool inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+    const bool inPlace = !updatedObj && _doc.getInPlaceUpdates(&_damages, &source);
 
     if (inPlace && _damages.empty()) {
         // An interesting edge case. A modifier didn't notice that it was really a no-op
@@ -344,7 +355,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         } else {
             // The updates were not in place. Apply them through the file manager.
 
-            newObj = _doc.getObject();
+            newObj = updatedObj ? *updatedObj : _doc.getObject();
             uassert(17419,
                     str::stream() << "Resulting document after update is larger than "
                                   << BSONObjMaxUserSize,
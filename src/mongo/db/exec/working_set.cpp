@@ -39,26 +39,41 @@ using std::string;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+// The sizes of the first block of members and of the largest.
+const size_t kMinMemberBlockSize = 4;
+const size_t kMaxMemberBlockSize = 1024;
+
+}  // namespace
+
 WorkingSet::MemberHolder::MemberHolder() : member(NULL) {}
 WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-}
+WorkingSet::~WorkingSet() = default;
 
 WorkingSetID WorkingSet::allocate() {
     if (_freeList == INVALID_ID) {
-        // The free list is empty so we need to make a single new WSM to return. This relies on
-        // vector::resize being amortized O(1) for efficient allocation. Note that the free list
-        // remains empty until something is returned by a call to free().
+        // The free list is empty so we need to hand out a new WSM, taking it from the last block
+        // or starting a new one. This relies on vector::resize being amortized O(1) for efficient
+        // allocation. Note that the free list remains empty until something is returned by a call
+        // to free().
+        if (_numUnusedInLastBlock == 0) {
+            if (_memberBlocks.empty()) {
+                _lastBlockSize = kMinMemberBlockSize;
+            } else {
+                _lastBlockSize = std::min(_lastBlockSize * 2, kMaxMemberBlockSize);
+            }
+            _memberBlocks.emplace_back(new WorkingSetMember[_lastBlockSize]);
+            _numUnusedInLastBlock = _lastBlockSize;
+        }
+
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = &_memberBlocks.back()[_lastBlockSize - _numUnusedInLastBlock--];
         return id;
     }
 
@@ -81,10 +96,10 @@ void WorkingSet::free(WorkingSetID i) {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
     _data.clear();
+    _memberBlocks.clear();
+    _lastBlockSize = 0;
+    _numUnusedInLastBlock = 0;
 
     // Since working set is now empty, the free list pointer should
     // point to nothing.
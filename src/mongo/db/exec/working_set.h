@@ -30,6 +30,8 @@
 #pragma once
 
 #include "boost/optional.hpp"
+#include <boost/container/small_vector.hpp>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -42,9 +44,16 @@ namespace mongo {
 
 class IndexAccessMethod;
 class WorkingSetMember;
+struct IndexKeyDatum;
 
 typedef size_t WorkingSetID;
 
+/**
+ * The index keys held by a WorkingSetMember. Almost every member holds the key of a single index,
+ * or of two when the plan intersects indexes, so that many are stored inline in the member.
+ */
+using IndexKeyDatumVector = boost::container::small_vector<IndexKeyDatum, 2>;
+
 /**
  * All data in use by a query.  Data is passed through the stage tree by referencing the ID of
  * an element of the working set.  Stages can add elements to the working set, delete elements
@@ -122,7 +131,7 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of '_memberBlocks'.
         WorkingSetMember* member;
     };
 
@@ -130,6 +139,14 @@ private:
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
 
+    // Members are allocated in blocks, each twice the size of the last up to a limit, rather than
+    // one at a time. Blocks are never moved or freed before clear(), so pointers to members remain
+    // valid. '_numUnusedInLastBlock' counts the members at the end of the last block which have
+    // not been handed out yet.
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _memberBlocks;
+    size_t _lastBlockSize = 0;
+    size_t _numUnusedInLastBlock = 0;
+
     // Index into _data, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
     // link. INVALID_ID is the list terminator since 0 is a valid index.
     // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
@@ -153,7 +170,7 @@ struct IndexKeyDatum {
      * object is populated if the element is in a provided index key.  Returns none otherwise.
      * Returning none indicates a query planning error.
      */
-    static boost::optional<BSONElement> getFieldDotted(const std::vector<IndexKeyDatum>& keyData,
+    static boost::optional<BSONElement> getFieldDotted(const IndexKeyDatumVector& keyData,
                                                        const std::string& field) {
         for (size_t i = 0; i < keyData.size(); ++i) {
             BSONObjIterator keyPatternIt(keyData[i].indexKeyPattern);
@@ -276,7 +293,7 @@ public:
 
     RecordId recordId;
     Snapshotted<BSONObj> obj;
-    std::vector<IndexKeyDatum> keyData;
+    IndexKeyDatumVector keyData;
 
     // True if this WSM has survived a yield in RID_AND_IDX state.
     // TODO consider replacing by tracking SnapshotIds for IndexKeyDatums.
@@ -155,4 +155,35 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+// Members are handed out from blocks; make sure they stay put as the working set grows and are
+// reused once freed.
+TEST_F(WorkingSetFixture, membersRemainValidAsWorkingSetGrows) {
+    member->recordId = RecordId(0);
+
+    std::vector<WorkingSetID> ids{id};
+    std::vector<WorkingSetMember*> members{member};
+    for (int i = 1; i < 5000; ++i) {
+        WorkingSetID newId = ws->allocate();
+        ws->get(newId)->recordId = RecordId(i);
+        ids.push_back(newId);
+        members.push_back(ws->get(newId));
+    }
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ASSERT_EQUALS(members[i], ws->get(ids[i]));
+        ASSERT_EQUALS(RecordId(i), members[i]->recordId);
+    }
+
+    ws->free(ids[100]);
+    WorkingSetID reusedId = ws->allocate();
+    ASSERT_EQUALS(ids[100], reusedId);
+    ASSERT_EQUALS(members[100], ws->get(reusedId));
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws->get(reusedId)->getState());
+
+    ws->clear();
+    WorkingSetID newId = ws->allocate();
+    ASSERT_EQUALS(0U, newId);
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws->get(newId)->getState());
+}
+
 }  // namespace
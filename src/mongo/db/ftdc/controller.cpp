@@ -35,6 +35,7 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/condition_variable.h"
@@ -69,6 +70,12 @@ void FTDCController::setPeriod(Milliseconds millis) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _condvar.notify_one();
+}
+
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _configTemp.maxDirectorySizeBytes = size;
@@ -128,6 +135,15 @@ void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 BSONObj FTDCController::getMostRecentPeriodicDocument() {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -195,13 +211,24 @@ void FTDCController::doLoop() {
         Client::initThread("ftdc");
         Client* client = &cc();
 
+        // Most recent output of the periodic collectors, and when to run them next. Between runs,
+        // samples taken for the high frequency collectors repeat it.
+        BSONObj periodicSample;
+        Date_t periodicSampleDate;
+        Date_t nextPeriodicTime;
+
         while (true) {
             // Compute the next interval to run regardless of how we were woken up
             // Skipping an interval due to a race condition with a config signal is harmless.
             auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
 
             // Get next time to run at
-            auto next_time = FTDCUtil::roundTime(now, _config.period);
+            auto period = _config.period;
+            if (_config.highFrequencyPeriod > Milliseconds(0) &&
+                _config.highFrequencyPeriod < period && !_highFrequencyCollectors.empty()) {
+                period = _config.highFrequencyPeriod;
+            }
+            auto next_time = FTDCUtil::roundTime(now, period);
 
             // Wait for the next run or signal to shutdown
             {
@@ -242,17 +269,33 @@ void FTDCController::doLoop() {
                     _mgr = uassertStatusOK(std::move(swMgr));
                 }
 
-                auto collectSample = _periodicCollectors.collect(client);
+                auto collectStart = getGlobalServiceContext()->getPreciseClockSource()->now();
+                if (collectStart >= nextPeriodicTime) {
+                    std::tie(periodicSample, periodicSampleDate) =
+                        _periodicCollectors.collect(client);
+                    nextPeriodicTime = FTDCUtil::roundTime(collectStart, _config.period);
+                }
+
+                BSONObj sample = periodicSample;
+                Date_t sampleDate = periodicSampleDate;
+                if (!_highFrequencyCollectors.empty()) {
+                    auto highFrequencySample = _highFrequencyCollectors.collect(client);
+
+                    BSONObjBuilder builder;
+                    builder.appendElements(periodicSample);
+                    builder.append(kFTDCHighFrequencyField, std::get<0>(highFrequencySample));
+                    sample = builder.obj();
+                    sampleDate = std::get<1>(highFrequencySample);
+                }
 
-                Status s = _mgr->writeSampleAndRotateIfNeeded(
-                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+                Status s = _mgr->writeSampleAndRotateIfNeeded(client, sample, sampleDate);
 
                 uassertStatusOK(s);
 
                 // Store a reference to the most recent document from the periodic collectors
                 {
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    _mostRecentPeriodicDocument = sample;
                 }
             }
         }
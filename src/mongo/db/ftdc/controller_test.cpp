@@ -280,4 +280,47 @@ TEST_F(FTDCControllerTest, TestStartAsDisabled) {
     ValidateDocumentList(alog, allDocs, FTDCValidationMode::kStrict);
 }
 
+// Test that high frequency collectors run more often than periodic collectors, and that every
+// sample contains the output of both.
+TEST_F(FTDCControllerTest, TestHighFrequency) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config;
+    config.enabled = true;
+    config.period = Milliseconds(1000);
+    config.highFrequencyPeriod = Milliseconds(1);
+    config.maxFileSizeBytes = FTDCConfig::kMaxFileSizeBytesDefault;
+    config.maxDirectorySizeBytes = FTDCConfig::kMaxDirectorySizeBytesDefault;
+
+    FTDCController c(dir, config);
+
+    auto c1 = stdx::make_unique<FTDCMetricsCollectorMock2>();
+    auto c2 = stdx::make_unique<FTDCMetricsCollectorMock2>();
+
+    auto c1Ptr = c1.get();
+    auto c2Ptr = c2.get();
+
+    c2Ptr->setSignalOnCount(50);
+
+    c.addPeriodicCollector(std::move(c1));
+
+    c.addHighFrequencyCollector(std::move(c2));
+
+    c.start();
+
+    // Wait for 50 high frequency samples to have occured
+    c2Ptr->wait();
+
+    auto mostRecent = c.getMostRecentPeriodicDocument();
+
+    c.stop();
+
+    ASSERT_LESS_THAN(c1Ptr->getDocs().size(), c2Ptr->getDocs().size());
+    ASSERT_TRUE(mostRecent.hasField("mock"));
+    ASSERT_TRUE(mostRecent[kFTDCHighFrequencyField].Obj().hasField("mock"));
+}
+
 }  // namespace mongo
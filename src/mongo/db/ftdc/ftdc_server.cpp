@@ -38,6 +38,7 @@
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
@@ -46,12 +47,16 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/stringutils.h"
 #include "mongo/util/synchronized_value.h"
 
 namespace mongo {
 
 namespace {
 
+// Shorter periods would make the FTDC thread compete with operations for CPU time.
+const std::int32_t kMinHighFrequencyPeriodMillis = 10;
+
 const auto getFTDCController = ServiceContext::declareDecoration<std::unique_ptr<FTDCController>>();
 
 FTDCController* getGlobalFTDCController() {
@@ -116,6 +121,24 @@ Status onUpdateFTDCPeriod(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t potentialNewValue) {
+    if (potentialNewValue != 0 && potentialNewValue < kMinHighFrequencyPeriodMillis) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream()
+                          << "diagnosticDataCollectionHighFrequencyPeriodMillis must be 0 or "
+                             "greater than or equal to '"
+                          << kMinHighFrequencyPeriodMillis
+                          << "'");
+    }
+
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+    }
+
+    return Status::OK();
+}
+
 Status onUpdateFTDCDirectorySize(const std::int32_t potentialNewValue) {
     if (potentialNewValue < ftdcStartupParams.maxFileSizeMB.load()) {
         return Status(
@@ -188,6 +211,27 @@ std::string FTDCSimpleInternalCommandCollector::name() const {
     return _name;
 }
 
+FTDCServerStatusSectionsCollector::FTDCServerStatusSectionsCollector(
+    StringData name, const std::vector<std::string>& sections)
+    : _name(name.toString()) {
+    for (const auto& sectionName : sections) {
+        if (auto section = ServerStatusSection::find(sectionName)) {
+            _sections.push_back(section);
+        }
+    }
+}
+
+void FTDCServerStatusSectionsCollector::collect(OperationContext* opCtx,
+                                                BSONObjBuilder& builder) {
+    for (auto section : _sections) {
+        section->appendSection(opCtx, BSONElement(), &builder);
+    }
+}
+
+std::string FTDCServerStatusSectionsCollector::name() const {
+    return _name;
+}
+
 // Register the FTDC system
 // Note: This must be run before the server parameters are parsed during startup
 // so that the FTDCController is initialized.
@@ -197,6 +241,8 @@ void startFTDC(boost::filesystem::path& path,
                RegisterCollectorsFunction registerCollectors) {
     FTDCConfig config;
     config.period = Milliseconds(ftdcStartupParams.periodMillis.load());
+    config.highFrequencyPeriod =
+        Milliseconds(ftdcStartupParams.highFrequencyPeriodMillis.load());
     // Only enable FTDC if our caller says to enable FTDC, MongoS may not have a valid path to write
     // files to so update the diagnosticDataCollectionEnabled set parameter to reflect that.
     ftdcStartupParams.enabled.store(startupMode == FTDCStartMode::kStart &&
@@ -234,6 +280,15 @@ void startFTDC(boost::filesystem::path& path,
 
     registerCollectors(controller.get());
 
+    // Install the high frequency collector, which reads the configured serverStatus sections
+    // directly on every high frequency period.
+    std::vector<std::string> highFrequencySections;
+    splitStringDelim(ftdcHighFrequencySections, &highFrequencySections, ',');
+    if (!highFrequencySections.empty()) {
+        controller->addHighFrequencyCollector(stdx::make_unique<FTDCServerStatusSectionsCollector>(
+            "serverStatus", highFrequencySections));
+    }
+
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
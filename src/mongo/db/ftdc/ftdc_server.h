@@ -30,6 +30,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
@@ -42,6 +43,8 @@
 
 namespace mongo {
 
+class ServerStatusSection;
+
 /**
  * Function that allows FTDC server components to register their own collectors as needed.
  */
@@ -98,6 +101,27 @@ private:
     const OpMsgRequest _request;
 };
 
+/**
+ * An FTDC Collector that appends serverStatus sections by calling them directly, without running
+ * the serverStatus command. Cheap enough to run as a high frequency collector for sections that
+ * only read counters.
+ */
+class FTDCServerStatusSectionsCollector : public FTDCCollectorInterface {
+public:
+    /**
+     * Collects the serverStatus sections named in 'sections'. Names that do not match a section
+     * are ignored.
+     */
+    FTDCServerStatusSectionsCollector(StringData name, const std::vector<std::string>& sections);
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override;
+    std::string name() const override;
+
+private:
+    std::string _name;
+    std::vector<ServerStatusSection*> _sections;
+};
+
 /**
  * FTDC startup parameters.
  *
@@ -106,6 +130,7 @@ private:
 struct FTDCStartupParams {
     AtomicWord<bool> enabled;
     AtomicWord<int> periodMillis;
+    AtomicWord<int> highFrequencyPeriodMillis;
 
     AtomicWord<int> maxDirectorySizeMB;
     AtomicWord<int> maxFileSizeMB;
@@ -115,6 +140,7 @@ struct FTDCStartupParams {
     FTDCStartupParams()
         : enabled(FTDCConfig::kEnabledDefault),
           periodMillis(FTDCConfig::kPeriodMillisDefault),
+          highFrequencyPeriodMillis(FTDCConfig::kHighFrequencyPeriodMillisDefault),
           // Scale the values down since are defaults are in bytes, but the user interface is MB
           maxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024)),
           maxFileSizeMB(FTDCConfig::kMaxFileSizeBytesDefault / (1024 * 1024)),
@@ -129,6 +155,7 @@ extern FTDCStartupParams ftdcStartupParams;
  */
 Status onUpdateFTDCEnabled(const bool value);
 Status onUpdateFTDCPeriod(const std::int32_t value);
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t value);
 Status onUpdateFTDCDirectorySize(const std::int32_t value);
 Status onUpdateFTDCFileSize(const std::int32_t value);
 Status onUpdateFTDCSamplesPerChunk(const std::int32_t value);
@@ -38,7 +38,6 @@
 #include "mongo/db/fts/tokenizer.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
-#include "mongo/util/stringutils.h"
 
 namespace mongo {
 namespace fts {
@@ -50,8 +49,7 @@ BasicFTSTokenizer::BasicFTSTokenizer(const FTSLanguage* language)
 
 void BasicFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
-    _document = document.toString();
-    _tokenizer = stdx::make_unique<Tokenizer>(_language, _document);
+    _tokenizer = stdx::make_unique<Tokenizer>(_language, document);
 }
 
 bool BasicFTSTokenizer::moveNext() {
@@ -69,19 +67,24 @@ bool BasicFTSTokenizer::moveNext() {
             continue;
         }
 
-        string word = tolowerString(token.data);
+        _word.assign(token.data.rawData(), token.data.size());
+        for (char& c : _word) {
+            c = static_cast<char>(tolower(static_cast<int>(c)));
+        }
 
         // Stop words are case-sensitive so we need them to be lower cased to check
         // against the stop word list
-        if ((_options & FTSTokenizer::kFilterStopWords) && _stopWords->isStopWord(word)) {
+        if ((_options & FTSTokenizer::kFilterStopWords) && _stopWords->isStopWord(_word)) {
             continue;
         }
 
         if (_options & FTSTokenizer::kGenerateCaseSensitiveTokens) {
-            word = token.data.toString();
+            _word.assign(token.data.rawData(), token.data.size());
         }
 
-        _stem = _stemmer.stem(word).toString();
+        // The stem stays valid until the next call to the stemmer, which is at least as long as
+        // get() promises.
+        _stem = _stemmer.stem(_word);
         return true;
     }
 }
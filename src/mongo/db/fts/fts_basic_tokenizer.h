@@ -74,11 +74,14 @@ private:
     const Stemmer _stemmer;
     const StopWords* const _stopWords;
 
-    std::string _document;
     std::unique_ptr<Tokenizer> _tokenizer;
     Options _options;
 
-    std::string _stem;
+    // The current token, lower cased unless case sensitive tokens were requested. Reused across
+    // tokens to avoid an allocation for each.
+    std::string _word;
+
+    StringData _stem;
 };
 
 }  // namespace fts
@@ -37,6 +37,7 @@
 #include "mongo/db/fts/fts_unicode_phrase_matcher.h"
 #include "mongo/db/fts/fts_unicode_tokenizer.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/string_map.h"
@@ -299,6 +300,15 @@ StatusWithFTSLanguage FTSLanguage::make(StringData langName, TextIndexVersion te
     }
 }
 
+FTSTokenizer* FTSLanguage::getThreadTokenizer() const {
+    thread_local stdx::unordered_map<const FTSLanguage*, std::unique_ptr<FTSTokenizer>> tokenizers;
+    auto& tokenizer = tokenizers[this];
+    if (!tokenizer) {
+        tokenizer = createTokenizer();
+    }
+    return tokenizer.get();
+}
+
 std::unique_ptr<FTSTokenizer> BasicFTSLanguage::createTokenizer() const {
     return stdx::make_unique<BasicFTSTokenizer>(this);
 }
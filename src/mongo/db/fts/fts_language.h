@@ -89,6 +89,13 @@ public:
      */
     virtual std::unique_ptr<FTSTokenizer> createTokenizer() const = 0;
 
+    /**
+     * Returns a tokenizer for this language that is owned by the calling thread and reused by
+     * every call on that thread, which saves creating a stemmer and keeps its stem cache warm.
+     * Callers must finish with the tokenizer before calling anything that may use it again.
+     */
+    FTSTokenizer* getThreadTokenizer() const;
+
     /**
      * Returns a reference to the phrase matcher instance that this language owns.
      */
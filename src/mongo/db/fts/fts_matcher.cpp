@@ -78,9 +78,9 @@ bool FTSMatcher::hasPositiveTerm(const BSONObj& obj) const {
     return false;
 }
 
-bool FTSMatcher::_hasPositiveTerm_string(const FTSLanguage* language, const string& raw) const {
-    std::unique_ptr<FTSTokenizer> tokenizer(language->createTokenizer());
-    tokenizer->reset(raw.c_str(), _getTokenizerOptions());
+bool FTSMatcher::_hasPositiveTerm_string(const FTSLanguage* language, StringData raw) const {
+    FTSTokenizer* tokenizer = language->getThreadTokenizer();
+    tokenizer->reset(raw, _getTokenizerOptions());
 
     while (tokenizer->moveNext()) {
         string word = tokenizer->get().toString();
@@ -108,9 +108,9 @@ bool FTSMatcher::hasNegativeTerm(const BSONObj& obj) const {
     return false;
 }
 
-bool FTSMatcher::_hasNegativeTerm_string(const FTSLanguage* language, const string& raw) const {
-    std::unique_ptr<FTSTokenizer> tokenizer(language->createTokenizer());
-    tokenizer->reset(raw.c_str(), _getTokenizerOptions());
+bool FTSMatcher::_hasNegativeTerm_string(const FTSLanguage* language, StringData raw) const {
+    FTSTokenizer* tokenizer = language->getThreadTokenizer();
+    tokenizer->reset(raw, _getTokenizerOptions());
 
     while (tokenizer->moveNext()) {
         string word = tokenizer->get().toString();
@@ -79,6 +79,8 @@ public:
     /**
      * Process a new document, and discards any previous results.
      * May be called multiple times on an instance of an iterator.
+     * The document is not copied, so it must remain valid until the tokenizer is reset or
+     * destroyed.
      */
     virtual void reset(StringData document, Options options) = 0;
 
@@ -31,6 +31,8 @@
 
 #include "mongo/db/fts/fts_unicode_tokenizer.h"
 
+#include <algorithm>
+
 #include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
@@ -55,9 +57,30 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
       _caseFoldMode(_language->str() == "turkish" ? unicode::CaseFoldMode::kTurkish
                                                   : unicode::CaseFoldMode::kNormal) {}
 
+namespace {
+
+bool isAscii(StringData str) {
+    return std::none_of(
+        str.begin(), str.end(), [](char c) { return static_cast<unsigned char>(c) > 0x7f; });
+}
+
+}  // namespace
+
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
+
+    // Turkish lower cases 'I' to a dotless i, which is not ASCII.
+    _isAscii = _caseFoldMode == unicode::CaseFoldMode::kNormal && isAscii(document);
+    if (_isAscii) {
+        _asciiDocument = document;
+        while (_pos < _asciiDocument.size() &&
+               unicode::codepointIsDelimiter(_asciiDocument[_pos], _delimListLanguage)) {
+            ++_pos;
+        }
+        return;
+    }
+
     _document.resetData(document);  // Validates that document is valid UTF8.
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
@@ -65,6 +88,10 @@ void UnicodeFTSTokenizer::reset(StringData document, Options options) {
 }
 
 bool UnicodeFTSTokenizer::moveNext() {
+    if (_isAscii) {
+        return _moveNextAscii();
+    }
+
     while (true) {
         if (_pos >= _document.size()) {
             _word = "";
@@ -107,6 +134,53 @@ bool UnicodeFTSTokenizer::moveNext() {
     }
 }
 
+bool UnicodeFTSTokenizer::_moveNextAscii() {
+    while (true) {
+        if (_pos >= _asciiDocument.size()) {
+            _word = "";
+            return false;
+        }
+
+        size_t start = _pos++;
+        while (_pos < _asciiDocument.size() &&
+               !unicode::codepointIsDelimiter(_asciiDocument[_pos], _delimListLanguage)) {
+            ++_pos;
+        }
+        const StringData token = _asciiDocument.substr(start, _pos - start);
+
+        while (_pos < _asciiDocument.size() &&
+               unicode::codepointIsDelimiter(_asciiDocument[_pos], _delimListLanguage)) {
+            ++_pos;
+        }
+
+        _wordBuf.reset();
+        char* lower = _wordBuf.skip(token.size());
+        for (size_t i = 0; i < token.size(); ++i) {
+            lower[i] = static_cast<char>(unicode::codepointToLower(token[i]));
+        }
+        _word = StringData(_wordBuf.buf(), token.size());
+
+        if ((_options & kFilterStopWords) && _stopWords->isStopWord(_word)) {
+            continue;
+        }
+
+        if (_options & kGenerateCaseSensitiveTokens) {
+            _word = token;
+        }
+
+        _word = _stemmer.stem(_word);
+
+        // ASCII has the pure diacritics '^' and '`', which caseFoldAndStripDiacritics() removes on
+        // its own ASCII fast path.
+        if (!(_options & kGenerateDiacriticSensitiveTokens)) {
+            _word = unicode::String::caseFoldAndStripDiacritics(
+                &_finalBuf, _word, unicode::String::kCaseSensitive, _caseFoldMode);
+        }
+
+        return true;
+    }
+}
+
 StringData UnicodeFTSTokenizer::get() const {
     return _word;
 }
@@ -54,6 +54,9 @@ class StopWords;
  *
  * For each word returns a stem version of a word optimized for full text indexing.
  * Optionally supports returning case sensitive search terms.
+ *
+ * Documents that are entirely ASCII are tokenized in place, without decoding them to UTF-32,
+ * unless Turkish case folding applies.
  */
 class UnicodeFTSTokenizer final : public FTSTokenizer {
     MONGO_DISALLOW_COPYING(UnicodeFTSTokenizer);
@@ -74,6 +77,12 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * moveNext() for documents that are entirely ASCII. Tokens are views of the document that
+     * are only copied to lower case them.
+     */
+    bool _moveNextAscii();
+
     const FTSLanguage* const _language;
     const Stemmer _stemmer;
     const StopWords* const _stopWords;
@@ -81,6 +90,8 @@ private:
     const unicode::CaseFoldMode _caseFoldMode;
 
     unicode::String _document;
+    StringData _asciiDocument;
+    bool _isAscii = false;
     size_t _pos;
     StringData _word;
     Options _options;
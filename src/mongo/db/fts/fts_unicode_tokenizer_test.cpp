@@ -242,5 +242,39 @@ TEST(FtsUnicodeTokenizer, FrenchStopWordsAndDiacriticSensitive) {
     ASSERT_EQUALS("excit", terms[4]);
 }
 
+// Ensure that ASCII documents, which skip decoding, produce the same tokens as documents that
+// contain other characters.
+TEST(FtsUnicodeTokenizer, AsciiMatchesUnicode) {
+    const char* ascii = "The QUICK brown Fox's ^jumps^ over `lazy` dogs, RUNNING";
+    const std::string unicode = std::string(ascii) + " \u00e9";
+
+    for (FTSTokenizer::Options options : {FTSTokenizer::kNone,
+                                          FTSTokenizer::kFilterStopWords,
+                                          FTSTokenizer::kGenerateCaseSensitiveTokens,
+                                          FTSTokenizer::kGenerateDiacriticSensitiveTokens}) {
+        std::vector<std::string> asciiTerms = tokenizeString(ascii, "english", options);
+        std::vector<std::string> unicodeTerms =
+            tokenizeString(unicode.c_str(), "english", options);
+
+        ASSERT_EQUALS(asciiTerms.size() + 1, unicodeTerms.size());
+        for (size_t i = 0; i < asciiTerms.size(); ++i) {
+            ASSERT_EQUALS(asciiTerms[i], unicodeTerms[i]);
+        }
+    }
+}
+
+// Ensure that Turkish case folding still applies to ASCII documents.
+TEST(FtsUnicodeTokenizer, TurkishAscii) {
+    std::vector<std::string> terms =
+        tokenizeString("SEN, VE SEN NEREDEN VARDIR?", "turkish", FTSTokenizer::kNone);
+
+    ASSERT_EQUALS(5U, terms.size());
+    ASSERT_EQUALS("sen", terms[0]);
+    ASSERT_EQUALS("ve", terms[1]);
+    ASSERT_EQUALS("sen", terms[2]);
+    ASSERT_EQUALS("nere", terms[3]);
+    ASSERT_EQUALS("var", terms[4]);
+}
+
 }  // namespace fts
 }  // namespace mongo
@@ -53,6 +53,14 @@ StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    const bool cacheable = word.size() <= kMaxCachedWordSize;
+    if (cacheable) {
+        auto it = _stemCache.find(word);
+        if (it != _stemCache.end()) {
+            return it->second;
+        }
+    }
+
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
@@ -61,7 +69,15 @@ StringData Stemmer::stem(StringData word) const {
         MONGO_UNREACHABLE;
     }
 
-    return StringData((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    StringData stemmed((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    if (!cacheable) {
+        return stemmed;
+    }
+
+    if (_stemCache.size() >= kMaxCachedStems) {
+        _stemCache.clear();
+    }
+    return _stemCache.emplace(word.toString(), stemmed.toString()).first->second;
 }
 }
 }
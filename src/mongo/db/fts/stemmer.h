@@ -30,8 +30,11 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -42,6 +45,8 @@ namespace fts {
  * maintains case
  * but works
  * running/Running -> run/Run
+ *
+ * Stems of short words are cached, since natural language text repeats a small vocabulary.
  */
 class Stemmer {
     MONGO_DISALLOW_COPYING(Stemmer);
@@ -60,7 +65,14 @@ public:
     StringData stem(StringData word) const;
 
 private:
+    // Longest word whose stem is cached, and the number of cached stems at which the cache is
+    // cleared.
+    static constexpr size_t kMaxCachedWordSize = 32;
+    static constexpr size_t kMaxCachedStems = 8192;
+
     struct sb_stemmer* _stemmer;
+
+    mutable StringMap<std::string> _stemCache;
 };
 }
 }
@@ -47,5 +47,19 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, CachedStems) {
+    Stemmer s(&languageEnglishV2);
+    const std::string longWord = "internationalizationsinternationalizations";
+
+    // Stem enough distinct words to clear the cache, checking that cached stems do not change.
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 10000; i++) {
+            ASSERT_EQUALS("run" + std::to_string(i), s.stem("run" + std::to_string(i)));
+            ASSERT_EQUALS("run", s.stem("running"));
+        }
+        ASSERT_EQUALS(s.stem(longWord).toString(), s.stem(longWord).toString());
+    }
+}
 }
 }
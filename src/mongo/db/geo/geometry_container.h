@@ -66,6 +66,12 @@ public:
      */
     bool isPoint() const;
 
+    /**
+     * Returns the point of this geometry. It is an error to call this function if isPoint() is
+     * false.
+     */
+    const PointWithCRS& getPoint() const;
+
     /**
      * Reports the CRS of the contained geometry.
      * TODO: Rework once we have collections of multiple CRSes
@@ -53,6 +53,38 @@ const BSONElement nullElt = nullObj.firstElement();
 const BSONObj undefinedObj = BSON("" << BSONUndefined);
 const BSONElement undefinedElt = undefinedObj.firstElement();
 
+/**
+ * Looks up the element of 'obj' named by the first component of each of 'fieldNames' in a single
+ * pass over 'obj', rather than scanning 'obj' once per indexed field. The scan stops as soon as
+ * every field has been found. Entries of 'objFields' are left EOO for fields which were already
+ * traversed to their end and for fields which 'obj' does not have.
+ */
+void getFirstComponentElements(const BSONObj& obj,
+                               const std::vector<const char*>& fieldNames,
+                               std::vector<BSONElement>* objFields) {
+    std::vector<StringData> firstComponents(fieldNames.size());
+    size_t numRemaining = 0;
+    for (size_t i = 0; i < fieldNames.size(); ++i) {
+        if (*fieldNames[i] != '\0') {
+            firstComponents[i] = StringData(fieldNames[i], strcspn(fieldNames[i], "."));
+            ++numRemaining;
+        }
+    }
+
+    objFields->assign(fieldNames.size(), BSONElement());
+    BSONObjIterator it(obj);
+    while (numRemaining > 0 && it.more()) {
+        BSONElement e = it.next();
+        const StringData name = e.fieldNameStringData();
+        for (size_t i = 0; i < fieldNames.size(); ++i) {
+            if (*fieldNames[i] != '\0' && (*objFields)[i].eoo() && firstComponents[i] == name) {
+                (*objFields)[i] = e;
+                --numRemaining;
+            }
+        }
+    }
+}
+
 }  // namespace
 
 BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
@@ -84,12 +116,11 @@ static void assertParallelArrays(const char* first, const char* second) {
     uasserted(ErrorCodes::CannotIndexParallelArrays, ss.str());
 }
 
-BSONElement BtreeKeyGenerator::_extractNextElement(const BSONObj& obj,
+BSONElement BtreeKeyGenerator::_extractNextElement(const BSONElement& objField,
                                                    const PositionalPathInfo& positionalInfo,
                                                    const char** field,
                                                    bool* arrayNestedArray) const {
-    std::string firstField = mongoutils::str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    bool haveObjField = !objField.eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -105,7 +136,15 @@ BSONElement BtreeKeyGenerator::_extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return dps::extractElementAtPathOrArrayAlongPath(obj, *field);
+        // Continue along the path from 'objField' rather than looking it up in 'obj' again.
+        const char* dot = strchr(*field, '.');
+        *field = dot ? dot + 1 : *field + strlen(*field);
+        if (objField.type() == Array || **field == '\0') {
+            return objField;
+        } else if (objField.type() == Object) {
+            return dps::extractElementAtPathOrArrayAlongPath(objField.embeddedObject(), *field);
+        }
+        return BSONElement();
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
@@ -219,6 +258,9 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
     // std::vector<boost::optional<size_t>>{{1U}, boost::none}.
     std::vector<boost::optional<size_t>> arrComponents(fieldNames.size());
 
+    std::vector<BSONElement> objFields;
+    getFirstComponentElements(obj, fieldNames, &objFields);
+
     bool mayExpandArrayUnembedded = true;
     for (size_t i = 0; i < fieldNames.size(); ++i) {
         if (*fieldNames[i] == '\0') {
@@ -228,7 +270,7 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
         bool arrayNestedArray;
         // Extract element matching fieldName[ i ] from object xor array.
         BSONElement e =
-            _extractNextElement(obj, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
+            _extractNextElement(objFields[i], positionalInfo[i], &fieldNames[i], &arrayNestedArray);
 
         if (e.eoo()) {
             // if field not present, set to null
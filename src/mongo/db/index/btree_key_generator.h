@@ -144,7 +144,8 @@ private:
     /**
      * A call to _getKeysWithArray() begins by calling this for each field in the key pattern. It
      * traverses the path '*field' in 'obj' until either reaching the end of the path or an array
-     * element.
+     * element. 'objField' is the element of 'obj' named by the first component of '*field', or EOO
+     * if 'obj' has no such element; the first components of all fields are looked up together.
      *
      * The 'positionalInfo' arg is used for handling a field path where 'obj' has an
      * array indexed by position. See the comments for PositionalPathInfo for more detail.
@@ -174,7 +175,7 @@ private:
      *   set '*field' to "". Similarly, it will return elemtn 99 and set '*field' to "" for
      *   the second array element.
      */
-    BSONElement _extractNextElement(const BSONObj& obj,
+    BSONElement _extractNextElement(const BSONElement& objField,
                                     const PositionalPathInfo& positionalInfo,
                                     const char** field,
                                     bool* arrayNestedArray) const;
@@ -340,6 +340,25 @@ TEST(BtreeKeyGeneratorTest, GetKeysFromCompoundMissing) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromCompoundFieldsInOtherOrder) {
+    BSONObj keyPattern = fromjson("{z: 1, 'x.b': 1, 'x.a': 1, w: 1}");
+    BSONObj genKeysFrom = fromjson("{w: 1, x: {a: 2, b: 3}, y: 4, z: 5}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 5, '': 3, '': 2, '': 1}"));
+    MultikeyPaths expectedMultikeyPaths{
+        std::set<size_t>{}, std::set<size_t>{}, std::set<size_t>{}, std::set<size_t>{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromCompoundDuplicateFieldUsesFirst) {
+    BSONObj keyPattern = fromjson("{x: 1, y: 1}");
+    BSONObj genKeysFrom = BSON("y" << 1 << "x" << 2 << "y" << 3);
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 2, '': 1}"));
+    MultikeyPaths expectedMultikeyPaths{std::set<size_t>{}, std::set<size_t>{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
 TEST(BtreeKeyGeneratorTest, GetKeysFromArraySubelementComplex) {
     BSONObj keyPattern = fromjson("{'a.b': 1}");
     BSONObj genKeysFrom = fromjson("{a:[{b:[2]}]}");
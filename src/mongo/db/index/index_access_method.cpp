@@ -33,6 +33,8 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
+#include <exception>
 #include <utility>
 #include <vector>
 
@@ -51,7 +53,9 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/timestamp_block.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
 
@@ -70,6 +74,18 @@ namespace {
 static const RecordId kMultikeyMetadataKeyId =
     RecordId{RecordId::ReservedId::kWildcardMultikeyMetadataId};
 
+// The KeyString version used to encode keys for the external sorter during bulk builds. This
+// encoding never leaves the sorter, so it does not depend on the index version.
+const KeyString::Version kSorterKeyStringVersion = KeyString::kLatestVersion;
+
+// Minimum number of documents each thread generates keys for in BulkBuilder::insertBatch(). Smaller
+// batches are not worth the cost of starting a thread.
+const size_t kMinDocsPerKeyGenThread = 64;
+
+// Number of decoded keys handed from the sorter thread to the inserting thread at a time during
+// commitBulk().
+const size_t kBulkLoadBatchSize = 1024;
+
 /**
  * Returns true if at least one prefix of any of the indexed fields causes the index to be
  * multikey, and returns false otherwise. This function returns false if the 'multikeyPaths'
@@ -110,24 +126,20 @@ bool failIndexKeyTooLongParam() {
     return failIndexKeyTooLong.load();
 }
 
+/**
+ * Compares index keys that were encoded as KeyStrings, using the index's ordering, with their
+ * RecordIds appended. This orders entries by key and then by RecordId, with a single memcmp.
+ */
 class BtreeExternalSortComparison {
 public:
-    BtreeExternalSortComparison(const BSONObj& ordering, IndexVersion version)
-        : _ordering(Ordering::make(ordering)), _version(version) {
-        invariant(IndexDescriptor::isIndexVersionSupported(version));
-    }
+    typedef std::pair<KeyString::Value, mongo::NullValue> Data;
 
-    typedef std::pair<BSONObj, RecordId> Data;
+    // KeyStrings compare as their bytes do, which lets the sorter radix sort them.
+    static constexpr bool kComparesKeyBytes = true;
 
     int operator()(const Data& l, const Data& r) const {
-        if (int x = l.first.woCompare(r.first, _ordering, /*considerfieldname*/ false))
-            return x;
-        return l.second.compare(r.second);
+        return l.first.compare(r.first);
     }
-
-private:
-    const Ordering _ordering;
-    const IndexVersion _version;
 };
 
 AbstractIndexAccessMethod::AbstractIndexAccessMethod(IndexCatalogEntry* btreeState,
@@ -235,6 +247,9 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
             if (isFatalError(opCtx, status, key)) {
                 return status;
             }
+            if (result) {
+                result->bytesInserted += key.objsize();
+            }
         }
     }
 
@@ -530,6 +545,12 @@ public:
                   const RecordId& loc,
                   const InsertDeleteOptions& options) final;
 
+    Status insertBatch(OperationContext* opCtx,
+                       const std::vector<BSONObj>& objs,
+                       const std::vector<RecordId>& locs,
+                       const InsertDeleteOptions& options,
+                       size_t numThreads) final;
+
     const MultikeyPaths& getMultikeyPaths() const final;
 
     bool isMultikey() const final;
@@ -543,8 +564,20 @@ public:
     int64_t getKeysInserted() const final;
 
 private:
+    /**
+     * Encodes 'key' and 'loc' into a single KeyString and adds it to the sorter.
+     */
+    void addToSorter(const BSONObj& key, const RecordId& loc);
+
+    /**
+     * Adds the keys generated for the document at 'loc' to the sorter and folds its multikey
+     * information into the index-wide state.
+     */
+    void addKeys(const BSONObjSet& keys, const MultikeyPaths& multikeyPaths, const RecordId& loc);
+
     std::unique_ptr<Sorter> _sorter;
     const IndexAccessMethod* _real;
+    const Ordering _ordering;
     int64_t _keysInserted = 0;
 
     // Set to true if any document added to the BulkBuilder causes the index to become multikey.
@@ -572,9 +605,22 @@ AbstractIndexAccessMethod::BulkBuilderImpl::BulkBuilderImpl(const IndexAccessMet
           SortOptions()
               .TempDir(storageGlobalParams.dbpath + "/_tmp")
               .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+              .MaxMemoryUsageBytes(maxMemoryUsageBytes)
+              .MaxSortThreads(static_cast<size_t>(maxIndexBuildSortThreads.load()))
+              .MemoryBroker(SorterMemoryBroker::get())
+              .MemoryConsumerName(str::stream() << "index build: " << descriptor->parentNS()
+                                                << " " << descriptor->indexName()),
+          BtreeExternalSortComparison(),
+          Sorter::Settings(KeyString::Value::SorterDeserializeSettings(kSorterKeyStringVersion),
+                           {}))),
+      _real(index),
+      _ordering(Ordering::make(descriptor->keyPattern())) {}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::addToSorter(const BSONObj& key,
+                                                             const RecordId& loc) {
+    KeyString keyString(kSorterKeyStringVersion, key, _ordering, loc);
+    _sorter->add(keyString.getValueCopy(), mongo::NullValue());
+}
 
 Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCtx,
                                                           const BSONObj& obj,
@@ -585,6 +631,77 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
 
     _real->getKeys(obj, options.getKeysMode, &keys, &_multikeyMetadataKeys, &multikeyPaths);
 
+    addKeys(keys, multikeyPaths, loc);
+    return Status::OK();
+}
+
+Status AbstractIndexAccessMethod::BulkBuilderImpl::insertBatch(OperationContext* opCtx,
+                                                               const std::vector<BSONObj>& objs,
+                                                               const std::vector<RecordId>& locs,
+                                                               const InsertDeleteOptions& options,
+                                                               size_t numThreads) {
+    invariant(objs.size() == locs.size());
+
+    struct GeneratedKeys {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+    };
+    std::vector<GeneratedKeys> generated(objs.size());
+
+    auto generateRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            _real->getKeys(objs[i],
+                           options.getKeysMode,
+                           &generated[i].keys,
+                           &generated[i].multikeyMetadataKeys,
+                           &generated[i].multikeyPaths);
+        }
+    };
+
+    // Each thread generates keys for a contiguous range of the batch, so that the keys can be
+    // added to the sorter in the same order insert() would have added them.
+    numThreads = std::max<size_t>(1, std::min(numThreads, objs.size() / kMinDocsPerKeyGenThread));
+    if (numThreads == 1) {
+        generateRange(0, objs.size());
+    } else {
+        const size_t perThread = (objs.size() + numThreads - 1) / numThreads;
+        std::vector<std::exception_ptr> errors(numThreads);
+        std::vector<stdx::thread> threads;
+        threads.reserve(numThreads - 1);
+        auto runRange = [&](size_t thread) {
+            try {
+                const size_t begin = thread * perThread;
+                generateRange(begin, std::min(begin + perThread, objs.size()));
+            } catch (...) {
+                errors[thread] = std::current_exception();
+            }
+        };
+        for (size_t thread = 1; thread < numThreads; ++thread) {
+            threads.emplace_back(runRange, thread);
+        }
+        runRange(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < objs.size(); ++i) {
+        _multikeyMetadataKeys.insert(generated[i].multikeyMetadataKeys.begin(),
+                                     generated[i].multikeyMetadataKeys.end());
+        addKeys(generated[i].keys, generated[i].multikeyPaths, locs[i]);
+    }
+    return Status::OK();
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::addKeys(const BSONObjSet& keys,
+                                                         const MultikeyPaths& multikeyPaths,
+                                                         const RecordId& loc) {
     if (!multikeyPaths.empty()) {
         if (_indexMultikeyPaths.empty()) {
             _indexMultikeyPaths = multikeyPaths;
@@ -597,14 +714,12 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
     }
 
     for (const auto& key : keys) {
-        _sorter->add(key, loc);
+        addToSorter(key, loc);
         ++_keysInserted;
     }
 
     _isMultiKey =
         _isMultiKey || _real->shouldMarkIndexAsMultikey(keys, _multikeyMetadataKeys, multikeyPaths);
-
-    return Status::OK();
 }
 
 const MultikeyPaths& AbstractIndexAccessMethod::BulkBuilderImpl::getMultikeyPaths() const {
@@ -618,7 +733,7 @@ bool AbstractIndexAccessMethod::BulkBuilderImpl::isMultikey() const {
 IndexAccessMethod::BulkBuilder::Sorter::Iterator*
 AbstractIndexAccessMethod::BulkBuilderImpl::done() {
     for (const auto& key : _multikeyMetadataKeys) {
-        _sorter->add(key, kMultikeyMetadataKeyId);
+        addToSorter(key, kMultikeyMetadataKeyId);
         ++_keysInserted;
     }
     return _sorter->done();
@@ -657,60 +772,121 @@ Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
     BSONObj previousKey;
     const Ordering ordering = Ordering::make(_descriptor->keyPattern());
 
-    while (it->more()) {
-        opCtx->checkForInterrupt();
+    // Merging the sorted runs and decoding each KeyString back into a key and RecordId does not
+    // touch the storage engine, so it runs on its own thread. It hands batches of decoded keys to
+    // this thread through a bounded queue, letting it overlap with the bulk inserts below.
+    using DecodedKeyBatch = std::vector<std::pair<BSONObj, RecordId>>;
+    using DecodedKeyQueue = SingleProducerSingleConsumerQueue<DecodedKeyBatch>;
+    DecodedKeyQueue::Options queueOptions;
+    queueOptions.maxQueueDepth = static_cast<size_t>(maxIndexBuildBulkLoadQueueDepth.load());
+    DecodedKeyQueue queue(queueOptions);
+
+    Status decodeStatus = Status::OK();
+    stdx::thread decoder([&] {
+        try {
+            DecodedKeyBatch batch;
+            while (it->more()) {
+                BulkBuilder::Sorter::Data data = it->next();
+                const KeyString::Value& keyString = data.first;
+                const size_t keySize =
+                    KeyString::sizeWithoutRecordIdAtEnd(keyString.getBuffer(), keyString.getSize());
+                batch.emplace_back(
+                    KeyString::toBson(
+                        keyString.getBuffer(), keySize, ordering, keyString.getTypeBits()),
+                    KeyString::decodeRecordIdAtEnd(keyString.getBuffer(), keyString.getSize()));
+
+                if (batch.size() == kBulkLoadBatchSize) {
+                    queue.push(std::move(batch));
+                    batch = DecodedKeyBatch();
+                }
+            }
+            if (!batch.empty()) {
+                queue.push(std::move(batch));
+            }
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+            // The inserting thread stopped early and is no longer consuming keys.
+        } catch (...) {
+            decodeStatus = exceptionToStatus();
+        }
+        queue.closeProducerEnd();
+    });
+
+    // Stops the decoder if we leave early because of an error or an interruption.
+    auto stopDecoder = makeGuard([&] {
+        queue.closeConsumerEnd();
+        decoder.join();
+    });
+
+    while (true) {
+        DecodedKeyBatch batch;
+        try {
+            batch = queue.pop(opCtx);
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+            break;
+        }
+
+        for (const auto& decoded : batch) {
+            opCtx->checkForInterrupt();
 
-        WriteUnitOfWork wunit(opCtx);
+            WriteUnitOfWork wunit(opCtx);
 
-        // Get the next datum and add it to the builder.
-        BulkBuilder::Sorter::Data data = it->next();
+            const BSONObj& key = decoded.first;
+            const RecordId& loc = decoded.second;
 
-        // Before attempting to insert, perform a duplicate key check.
-        bool isDup = false;
-        if (_descriptor->unique()) {
-            isDup = data.first.woCompare(previousKey, ordering) == 0;
-            if (isDup && !dupsAllowed) {
-                if (dupRecords) {
-                    dupRecords->insert(data.second);
-                    continue;
+            // Before attempting to insert, perform a duplicate key check.
+            bool isDup = false;
+            if (_descriptor->unique()) {
+                isDup = key.woCompare(previousKey, ordering) == 0;
+                if (isDup && !dupsAllowed) {
+                    if (dupRecords) {
+                        dupRecords->insert(loc);
+                        continue;
+                    }
+                    return buildDupKeyErrorStatus(key,
+                                                  _descriptor->parentNS(),
+                                                  _descriptor->indexName(),
+                                                  _descriptor->keyPattern());
                 }
-                return buildDupKeyErrorStatus(data.first,
-                                              _descriptor->parentNS(),
-                                              _descriptor->indexName(),
-                                              _descriptor->keyPattern());
             }
-        }
 
-        Status status = checkIndexKeySize ? checkKeySize(data.first) : Status::OK();
-        if (status.isOK()) {
-            StatusWith<SpecialFormatInserted> ret = builder->addKey(data.first, data.second);
-            status = ret.getStatus();
-            if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
-                _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
-        }
+            Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
+            if (status.isOK()) {
+                StatusWith<SpecialFormatInserted> ret = builder->addKey(key, loc);
+                status = ret.getStatus();
+                if (status.isOK() &&
+                    ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
+                    _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
+            }
 
-        if (!status.isOK()) {
-            // Duplicates are checked before inserting.
-            invariant(status.code() != ErrorCodes::DuplicateKey);
+            if (!status.isOK()) {
+                // Duplicates are checked before inserting.
+                invariant(status.code() != ErrorCodes::DuplicateKey);
 
-            // Overlong key that's OK to skip?
-            // TODO SERVER-36385: Remove this when there is no KeyTooLong error.
-            if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong()) {
-                continue;
+                // Overlong key that's OK to skip?
+                // TODO SERVER-36385: Remove this when there is no KeyTooLong error.
+                if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong()) {
+                    continue;
+                }
+
+                return status;
             }
 
-            return status;
-        }
+            previousKey = key;
 
-        previousKey = data.first.getOwned();
+            if (isDup && dupsAllowed && dupKeysInserted) {
+                dupKeysInserted->push_back(key);
+            }
 
-        if (isDup && dupsAllowed && dupKeysInserted) {
-            dupKeysInserted->push_back(data.first.getOwned());
+            // If we're here either it's a dup and we're cool with it or the addKey went just fine.
+            pm.hit();
+            wunit.commit();
         }
+    }
 
-        // If we're here either it's a dup and we're cool with it or the addKey went just fine.
-        pm.hit();
-        wunit.commit();
+    stopDecoder.dismiss();
+    decoder.join();
+    if (!decodeStatus.isOK()) {
+        return decodeStatus;
     }
 
     pm.finished();
@@ -821,4 +997,6 @@ std::string nextFileName() {
 }  // namespace mongo
 
 #include "mongo/db/sorter/sorter.cpp"
-MONGO_CREATE_SORTER(mongo::BSONObj, mongo::RecordId, mongo::BtreeExternalSortComparison);
+MONGO_CREATE_SORTER(mongo::KeyString::Value,
+                    mongo::NullValue,
+                    mongo::BtreeExternalSortComparison);
@@ -32,6 +32,7 @@
 #include <atomic>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -42,6 +43,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 
 namespace mongo {
@@ -225,7 +227,11 @@ public:
 
     class BulkBuilder {
     public:
-        using Sorter = mongo::Sorter<BSONObj, RecordId>;
+        /**
+         * Keys are sorted as KeyStrings that have the RecordId appended, so that the sorter only
+         * needs to compare bytes.
+         */
+        using Sorter = mongo::Sorter<KeyString::Value, mongo::NullValue>;
 
         virtual ~BulkBuilder() = default;
 
@@ -237,6 +243,17 @@ public:
                               const RecordId& loc,
                               const InsertDeleteOptions& options) = 0;
 
+        /**
+         * Equivalent to calling insert() on each of 'objs' in order, with the matching RecordId
+         * from 'locs'. Generating the keys is spread across up to 'numThreads' threads, while
+         * adding them to the sorter stays on the calling thread.
+         */
+        virtual Status insertBatch(OperationContext* opCtx,
+                                   const std::vector<BSONObj>& objs,
+                                   const std::vector<RecordId>& locs,
+                                   const InsertDeleteOptions& options,
+                                   size_t numThreads) = 0;
+
         virtual const MultikeyPaths& getMultikeyPaths() const = 0;
 
         virtual bool isMultikey() const = 0;
@@ -369,6 +386,8 @@ public:
 struct InsertResult {
 public:
     std::int64_t numInserted{0};
+    // Total BSON size of the inserted keys.
+    std::int64_t bytesInserted{0};
     std::vector<BSONObj> dupsInserted;
 };
 
@@ -383,6 +402,20 @@ public:
           newKeys(oldKeys),
           newMultikeyMetadataKeys(newKeys) {}
 
+    /**
+     * Returns the total BSON size of the keys the update inserts into the index.
+     */
+    std::int64_t getAddedKeysSize() const {
+        std::int64_t size = 0;
+        for (const auto& key : added) {
+            size += key.objsize();
+        }
+        for (const auto& key : newMultikeyMetadataKeys) {
+            size += key.objsize();
+        }
+        return size;
+    }
+
 private:
     friend class AbstractIndexAccessMethod;
 
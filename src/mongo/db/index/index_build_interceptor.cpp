@@ -33,13 +33,17 @@
 
 #include "mongo/db/index/index_build_interceptor.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/catalog/index_timestamp_helper.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_build_interceptor_gen.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
@@ -52,6 +56,10 @@ namespace mongo {
 
 MONGO_FAIL_POINT_DEFINE(hangDuringIndexBuildDrainYield);
 
+namespace {
+const StringData kDrainStatsFieldName = "drainStats"_sd;
+}  // namespace
+
 IndexBuildInterceptor::IndexBuildInterceptor(OperationContext* opCtx, IndexCatalogEntry* entry)
     : _indexCatalogEntry(entry),
       _sideWritesTable(
@@ -119,9 +127,10 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
         resetReadSourceGuard.dismiss();
     }
 
-    // These are used for logging only.
+    // These are used for logging and currentOp reporting only.
     int64_t totalDeleted = 0;
     int64_t totalInserted = 0;
+    int64_t numBatches = 0;
     Timer timer;
 
     const int64_t appliedAtStart = _numApplied;
@@ -137,14 +146,14 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
 
     // Force the progress meter to log at the end of every batch. By default, the progress meter
     // only logs after a large number of calls to hit(), but since we batch inserts by up to
-    // 1000 records, progress would rarely be displayed.
+    // 'maxIndexBuildDrainBatchSize' records, progress would rarely be displayed.
     progress->reset(_sideWritesCounter.load() - appliedAtStart /* total */,
                     3 /* secondsBetween */,
                     1 /* checkInterval */);
 
     // Buffer operations into batches to insert per WriteUnitOfWork. Impose an upper limit on the
     // number of documents and the total size of the batch.
-    const int32_t kBatchMaxSize = 1000;
+    const int32_t kBatchMaxSize = maxIndexBuildDrainBatchSize.load();
     const int64_t kBatchMaxBytes = BSONObjMaxInternalSize;
 
     int64_t batchSizeBytes = 0;
@@ -156,6 +165,8 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
     // into the next batch.
     boost::optional<SideWriteRecord> stashed;
 
+    const Ordering ordering = Ordering::make(_indexCatalogEntry->descriptor()->keyPattern());
+
     auto cursor = _sideWritesTable->rs()->getCursor(opCtx);
 
     bool atEof = false;
@@ -202,6 +213,16 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
 
         cursor->save();
 
+        // Apply the batch in index key order so that the writes walk the index once, instead of
+        // seeking to a random position for each one. The sort is stable, so writes to the same key
+        // are still applied in the order they were made. Writes to different keys are independent.
+        std::stable_sort(batch.begin(),
+                         batch.end(),
+                         [&](const SideWriteRecord& lhs, const SideWriteRecord& rhs) {
+                             return lhs.second["key"].Obj().woCompare(
+                                        rhs.second["key"].Obj(), ordering, false) < 0;
+                         });
+
         // If we are here, either we have reached the end of the table or the batch is full, so
         // insert everything in one WriteUnitOfWork, and delete each inserted document from the side
         // writes table.
@@ -243,6 +264,14 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
         _numApplied += batch.size();
         batch.clear();
         batchSizeBytes = 0;
+
+        ++numBatches;
+        _reportDrainStats(opCtx,
+                          _numApplied - appliedAtStart,
+                          totalInserted,
+                          totalDeleted,
+                          numBatches,
+                          timer.millis());
     }
 
     progress->finished();
@@ -310,6 +339,35 @@ Status IndexBuildInterceptor::_applyWrite(OperationContext* opCtx,
     return Status::OK();
 }
 
+void IndexBuildInterceptor::_reportDrainStats(OperationContext* opCtx,
+                                              int64_t applied,
+                                              int64_t keysInserted,
+                                              int64_t keysDeleted,
+                                              int64_t batches,
+                                              long long elapsedMillis) const {
+    stdx::unique_lock<Client> lk(*opCtx->getClient());
+    auto curOp = CurOp::get(opCtx);
+
+    BSONObjBuilder builder;
+    for (auto&& elem : curOp->opDescription()) {
+        if (elem.fieldNameStringData() != kDrainStatsFieldName) {
+            builder.append(elem);
+        }
+    }
+    {
+        BSONObjBuilder drainStats(builder.subobjStart(kDrainStatsFieldName));
+        drainStats.append("index", _indexCatalogEntry->descriptor()->indexName());
+        drainStats.append("applied", static_cast<long long>(applied));
+        drainStats.append("keysInserted", static_cast<long long>(keysInserted));
+        drainStats.append("keysDeleted", static_cast<long long>(keysDeleted));
+        drainStats.append("batches", static_cast<long long>(batches));
+        drainStats.append("elapsedMillis", elapsedMillis);
+        drainStats.append("appliedPerSecond",
+                          elapsedMillis > 0 ? (applied * 1000) / elapsedMillis : applied);
+    }
+    curOp->setOpDescription_inlock(builder.obj());
+}
+
 void IndexBuildInterceptor::_tryYield(OperationContext* opCtx) {
     // Never yield while holding locks that prevent writes to the collection: only yield while
     // holding intent locks. This check considers all locks in the hierarchy that would cover this
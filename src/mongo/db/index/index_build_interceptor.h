@@ -137,6 +137,17 @@ private:
                        int64_t* const keysInserted,
                        int64_t* const keysDeleted);
 
+    /**
+     * Publishes the progress of the current drain under the 'drainStats' field of this operation's
+     * currentOp entry, replacing the stats of any previous batch.
+     */
+    void _reportDrainStats(OperationContext* opCtx,
+                           int64_t applied,
+                           int64_t keysInserted,
+                           int64_t keysDeleted,
+                           int64_t batches,
+                           long long elapsedMillis) const;
+
     /**
      * Yield lock manager locks, but only when holding intent locks. Does nothing otherwise. If this
      * yields locks, it will also abandon the current storage engine snapshot.
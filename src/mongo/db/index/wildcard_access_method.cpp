@@ -27,13 +27,17 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/index/wildcard_access_method.h"
 
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method_gen.h"
 #include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
@@ -54,6 +58,22 @@ void WildcardAccessMethod::doGetKeys(const BSONObj& obj,
                                      BSONObjSet* multikeyMetadataKeys,
                                      MultikeyPaths* multikeyPaths) const {
     _keyGen.generateKeys(obj, keys, multikeyMetadataKeys);
+
+    // Documents with very many paths are still indexed in full, but are reported so that the
+    // index can be narrowed with a wildcardProjection. The warning is rate-limited so that a
+    // workload of such documents is not slowed down by logging.
+    const auto threshold = wildcardIndexKeyCountWarningThreshold.load();
+    if (threshold > 0 && keys->size() > static_cast<size_t>(threshold)) {
+        const auto now = Date_t::now().toMillisSinceEpoch();
+        auto lastWarning = _lastKeyCountWarningMillis.load();
+        if (now - lastWarning >= durationCount<Milliseconds>(Minutes(1)) &&
+            _lastKeyCountWarningMillis.compareAndSwap(lastWarning, now) == lastWarning) {
+            warning() << "Document generated " << keys->size() << " keys for wildcard index "
+                      << _descriptor->indexName() << " on " << _descriptor->parentNS()
+                      << ", more than wildcardIndexKeyCountWarningThreshold (" << threshold
+                      << "). Consider restricting the indexed paths with a wildcardProjection";
+        }
+    }
 }
 
 FieldRef WildcardAccessMethod::extractMultikeyPathFromIndexKey(const IndexKeyEntry& entry) {
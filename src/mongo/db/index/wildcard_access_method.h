@@ -33,6 +33,7 @@
 #include "mongo/db/index/wildcard_key_generator.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -102,5 +103,9 @@ private:
                                            MultikeyMetadataAccessStats* stats) const;
 
     const WildcardKeyGenerator _keyGen;
+
+    // When a document last exceeded 'wildcardIndexKeyCountWarningThreshold', in milliseconds
+    // since the epoch. Used to rate-limit the warning.
+    mutable AtomicWord<long long> _lastKeyCountWarningMillis{0};
 };
 }  // namespace mongo
@@ -43,20 +43,22 @@ static const BSONObj kDefaultProjection = BSON("_id"_sd << 0);
 
 // If the enclosing object is an array, then the current element's fieldname is the array index, so
 // we omit this when computing the full path. Otherwise, the full path is the pathPrefix plus the
-// element's fieldname.
-void pushPathComponent(BSONElement elem, bool enclosingObjIsArray, FieldRef* pathPrefix) {
+// element's fieldname. Returns the length of the path prior to appending the element's fieldname.
+size_t pushPathComponent(BSONElement elem, bool enclosingObjIsArray, std::string* pathPrefix) {
+    const auto prefixLength = pathPrefix->size();
     if (!enclosingObjIsArray) {
-        pathPrefix->appendPart(elem.fieldNameStringData());
+        if (prefixLength > 0) {
+            pathPrefix->push_back('.');
+        }
+        const auto fieldName = elem.fieldNameStringData();
+        pathPrefix->append(fieldName.rawData(), fieldName.size());
     }
+    return prefixLength;
 }
 
-// If the enclosing object is not an array, then the final path component should be its field name.
-// Verify that this is the case and then pop it off the FieldRef.
-void popPathComponent(BSONElement elem, bool enclosingObjIsArray, FieldRef* pathToElem) {
-    if (!enclosingObjIsArray) {
-        invariant(pathToElem->getPart(pathToElem->numParts() - 1) == elem.fieldNameStringData());
-        pathToElem->removeLastPart();
-    }
+// Truncates the path back to the length it had before the last call to pushPathComponent().
+void popPathComponent(size_t prefixLength, std::string* pathToElem) {
+    pathToElem->resize(prefixLength);
 }
 }  // namespace
 
@@ -101,13 +103,13 @@ WildcardKeyGenerator::WildcardKeyGenerator(BSONObj keyPattern,
 void WildcardKeyGenerator::generateKeys(BSONObj inputDoc,
                                         BSONObjSet* keys,
                                         BSONObjSet* multikeyPaths) const {
-    FieldRef rootPath;
+    std::string rootPath;
     _traverseWildcard(_projExec->applyProjection(inputDoc), false, &rootPath, keys, multikeyPaths);
 }
 
 void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
                                              bool objIsArray,
-                                             FieldRef* path,
+                                             std::string* path,
                                              BSONObjSet* keys,
                                              BSONObjSet* multikeyPaths) const {
     for (const auto elem : obj) {
@@ -116,7 +118,7 @@ void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
             continue;
 
         // Append the element's fieldname to the path, if the enclosing object is not an array.
-        pushPathComponent(elem, objIsArray, path);
+        const auto prefixLength = pushPathComponent(elem, objIsArray, path);
 
         switch (elem.type()) {
             case BSONType::Array:
@@ -140,12 +142,12 @@ void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
         }
 
         // Remove the element's fieldname from the path, if it was pushed onto it earlier.
-        popPathComponent(elem, objIsArray, path);
+        popPathComponent(prefixLength, path);
     }
 }
 
 bool WildcardKeyGenerator::_addKeyForNestedArray(BSONElement elem,
-                                                 const FieldRef& fullPath,
+                                                 StringData fullPath,
                                                  bool enclosingObjIsArray,
                                                  BSONObjSet* keys) const {
     // If this element is an array whose parent is also an array, index it as a value.
@@ -157,7 +159,7 @@ bool WildcardKeyGenerator::_addKeyForNestedArray(BSONElement elem,
 }
 
 bool WildcardKeyGenerator::_addKeyForEmptyLeaf(BSONElement elem,
-                                               const FieldRef& fullPath,
+                                               StringData fullPath,
                                                BSONObjSet* keys) const {
     invariant(elem.isABSONObj());
     if (elem.embeddedObject().isEmpty()) {
@@ -169,12 +171,10 @@ bool WildcardKeyGenerator::_addKeyForEmptyLeaf(BSONElement elem,
     return false;
 }
 
-void WildcardKeyGenerator::_addKey(BSONElement elem,
-                                   const FieldRef& fullPath,
-                                   BSONObjSet* keys) const {
+void WildcardKeyGenerator::_addKey(BSONElement elem, StringData fullPath, BSONObjSet* keys) const {
     // Wildcard keys are of the form { "": "path.to.field", "": <collation-aware value> }.
     BSONObjBuilder bob;
-    bob.append("", fullPath.dottedField());
+    bob.append("", fullPath);
     if (elem) {
         CollationIndexKey::collationAwareIndexKeyAppend(elem, _collator, &bob);
     } else {
@@ -183,12 +183,12 @@ void WildcardKeyGenerator::_addKey(BSONElement elem,
     keys->insert(bob.obj());
 }
 
-void WildcardKeyGenerator::_addMultiKey(const FieldRef& fullPath, BSONObjSet* multikeyPaths) const {
+void WildcardKeyGenerator::_addMultiKey(StringData fullPath, BSONObjSet* multikeyPaths) const {
     // Multikey paths are denoted by a key of the form { "": 1, "": "path.to.array" }. The argument
     // 'multikeyPaths' may be nullptr if the access method is being used in an operation which does
     // not require multikey path generation.
     if (multikeyPaths) {
-        multikeyPaths->insert(BSON("" << 1 << "" << fullPath.dottedField()));
+        multikeyPaths->insert(BSON("" << 1 << "" << fullPath));
     }
 }
 
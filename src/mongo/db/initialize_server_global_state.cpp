@@ -48,6 +48,8 @@
 #include "mongo/base/init.h"
 #include "mongo/config.h"
 #include "mongo/db/server_options.h"
+#include "mongo/logger/async_log_appender.h"
+#include "mongo/logger/async_log_writer.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -59,6 +61,7 @@
 #include "mongo/logger/syslog_appender.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/util/log.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/quick_exit.h"
@@ -295,15 +298,39 @@ MONGO_INITIALIZER_GENERAL(
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
-        manager->getNamedDomain("javascriptOutput")
-            ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        if (gAsyncLogging) {
+            using logger::AsyncLogAppender;
+            using logger::AsyncLogWriter;
+
+            auto asyncWriter = std::make_unique<AsyncLogWriter>(
+                writer.getValue(), static_cast<size_t>(gAsyncLoggingBufferSizeKB) * 1024);
+            asyncWriter->startup();
+            // Lines logged while shutting down, up to the final one, are written synchronously.
+            registerShutdownTask([writer = asyncWriter.get()] { writer->shutdown(); });
+
+            manager->getGlobalDomain()->attachAppender(
+                std::make_unique<AsyncLogAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), asyncWriter.get()));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(std::make_unique<AsyncLogAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), asyncWriter.get()));
+            logger::setGlobalAsyncLogWriter(std::move(asyncWriter));
+        } else {
+            manager->getGlobalDomain()->attachAppender(
+                std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        }
 
         if (serverGlobalParams.logAppend && exists) {
             log() << "***** SERVER RESTARTED *****";
+            if (auto asyncWriter = logger::globalAsyncLogWriter()) {
+                Status status = asyncWriter->flush();
+                if (!status.isOK())
+                    return status;
+            }
             Status status = logger::RotatableFileWriter::Use(writer.getValue()).status();
             if (!status.isOK())
                 return status;
@@ -40,6 +40,7 @@
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/log.h"
 #include "mongo/util/periodic_runner.h"
@@ -59,6 +60,8 @@ void clearShardingOperationFailedStatus(OperationContext* opCtx) {
 }  // namespace
 
 constexpr Milliseconds LogicalSessionCacheImpl::kLogicalSessionDefaultRefresh;
+constexpr size_t LogicalSessionCacheImpl::kNumPartitions;
+constexpr size_t LogicalSessionCacheImpl::kRefreshBatchSize;
 
 LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     std::unique_ptr<ServiceLiaison> service,
@@ -69,7 +72,8 @@ LogicalSessionCacheImpl::LogicalSessionCacheImpl(
       _sessionTimeout(options.sessionTimeout),
       _service(std::move(service)),
       _sessionsColl(std::move(collection)),
-      _transactionReaper(std::move(transactionReaper)) {
+      _transactionReaper(std::move(transactionReaper)),
+      _random(SecureRandom::create()->nextInt64()) {
     _stats.setLastSessionsCollectionJobTimestamp(now());
     _stats.setLastTransactionReaperJobTimestamp(now());
 
@@ -96,9 +100,10 @@ LogicalSessionCacheImpl::~LogicalSessionCacheImpl() {
 }
 
 Status LogicalSessionCacheImpl::promote(LogicalSessionId lsid) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    auto it = _activeSessions.find(lsid);
-    if (it == _activeSessions.end()) {
+    const auto& partition = _partitionFor(lsid);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.activeSessions.find(lsid);
+    if (it == partition.activeSessions.end()) {
         return {ErrorCodes::NoSuchSession, "no matching session record found in the cache"};
     }
 
@@ -171,8 +176,7 @@ Date_t LogicalSessionCacheImpl::now() {
 }
 
 size_t LogicalSessionCacheImpl::size() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheMutex);
-    return _activeSessions.size();
+    return static_cast<size_t>(_activeSessionsCount.load());
 }
 
 void LogicalSessionCacheImpl::_periodicRefresh(Client* client) {
@@ -308,33 +312,42 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
 
     LogicalSessionIdSet staleSessions;
     LogicalSessionIdSet explicitlyEndingSessions;
-    LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
+    std::array<SessionMap, kNumPartitions> activeSessions;
 
     {
         using std::swap;
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         swap(explicitlyEndingSessions, _endingSessions);
-        swap(activeSessions, _activeSessions);
+    }
+
+    // Swap out one partition at a time, so that operations only ever wait for a single swap.
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        using std::swap;
+        stdx::lock_guard<stdx::mutex> lk(_partitions[i].mutex);
+        swap(activeSessions[i], _partitions[i].activeSessions);
+        _activeSessionsCount.subtractAndFetch(static_cast<long long>(activeSessions[i].size()));
     }
 
     // Create guards that in the case of a exception replace the ending or active sessions that
     // swapped out of LogicalSessionCache, and merges in any records that had been added since we
     // swapped them out.
-    auto backSwap = [this](auto& member, auto& temp) {
+    auto activeSessionsBackSwapper = makeGuard([&] {
+        for (size_t i = 0; i < kNumPartitions; ++i) {
+            _mergeBackInto(_partitions[i], activeSessions[i]);
+        }
+    });
+    auto explicitlyEndingBackSwaper = makeGuard([&] {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         using std::swap;
-        swap(member, temp);
-        for (const auto& it : temp) {
-            member.emplace(it);
+        swap(_endingSessions, explicitlyEndingSessions);
+        for (const auto& it : explicitlyEndingSessions) {
+            _endingSessions.emplace(it);
         }
-    };
-    auto activeSessionsBackSwapper = makeGuard([&] { backSwap(_activeSessions, activeSessions); });
-    auto explicitlyEndingBackSwaper =
-        makeGuard([&] { backSwap(_endingSessions, explicitlyEndingSessions); });
+    });
 
     // remove all explicitlyEndingSessions from activeSessions
     for (const auto& lsid : explicitlyEndingSessions) {
-        activeSessions.erase(lsid);
+        activeSessions[LogicalSessionIdHash()(lsid) % kNumPartitions].erase(lsid);
     }
 
     // refresh all recently active sessions as well as for sessions attached to running ops
@@ -350,12 +363,14 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         }
         activeSessionRecords.insert(makeLogicalSessionRecord(it, now()));
     }
-    for (const auto& it : activeSessions) {
-        activeSessionRecords.insert(it.second);
+    for (const auto& partitionSessions : activeSessions) {
+        for (const auto& it : partitionSessions) {
+            activeSessionRecords.insert(it.second);
+        }
     }
 
     // Refresh the active sessions in the sessions collection.
-    uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
+    _refreshRecordsInBatches(opCtx, activeSessionRecords);
     activeSessionsBackSwapper.dismiss();
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
@@ -378,10 +393,10 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     auto openCursorSessions = _service->getOpenCursorSessions(opCtx);
     // Exclude sessions added to _activeSessions from the openCursorSession to avoid race between
     // killing cursors on the removed sessions and creating sessions.
-    {
-        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-        for (const auto& it : _activeSessions) {
+        for (const auto& it : partition.activeSessions) {
             auto newSessionIt = openCursorSessions.find(it.first);
             if (newSessionIt != openCursorSessions.end()) {
                 openCursorSessions.erase(newSessionIt);
@@ -421,37 +436,103 @@ void LogicalSessionCacheImpl::endSessions(const LogicalSessionIdSet& sessions) {
 
 LogicalSessionCacheStats LogicalSessionCacheImpl::getStats() {
     stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _stats.setActiveSessionsCount(_activeSessions.size());
+    _stats.setActiveSessionsCount(static_cast<int>(_activeSessionsCount.load()));
     return _stats;
 }
 
 Status LogicalSessionCacheImpl::_addToCache(LogicalSessionRecord record) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    if (_activeSessions.size() >= static_cast<size_t>(maxSessions)) {
+    auto& partition = _partitionFor(record.getId());
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    if (_activeSessionsCount.load() >= maxSessions) {
         return {ErrorCodes::TooManyLogicalSessions, "cannot add session into the cache"};
     }
-    _activeSessions.insert(std::make_pair(record.getId(), record));
+    if (partition.activeSessions.insert(std::make_pair(record.getId(), record)).second) {
+        _activeSessionsCount.addAndFetch(1);
+    }
     return Status::OK();
 }
 
+void LogicalSessionCacheImpl::_refreshRecordsInBatches(OperationContext* opCtx,
+                                                       const LogicalSessionRecordSet& records) {
+    if (records.size() <= kRefreshBatchSize) {
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, records));
+        return;
+    }
+
+    // Spread the batches over at most half of the refresh interval on average, leaving the other
+    // half as headroom for slow writes.
+    const size_t numBatches = (records.size() + kRefreshBatchSize - 1) / kRefreshBatchSize;
+    const long long maxPauseMillis =
+        std::min(static_cast<long long>(logicalSessionRefreshMaxBatchPauseMillis.load()),
+                 _refreshInterval.count() / static_cast<long long>(numBatches));
+
+    LogicalSessionRecordSet batch;
+    for (const auto& record : records) {
+        batch.insert(record);
+        if (batch.size() < kRefreshBatchSize) {
+            continue;
+        }
+
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, batch));
+        batch.clear();
+
+        long long pauseMillis;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+            pauseMillis = maxPauseMillis > 0 ? _random.nextInt64(maxPauseMillis) : 0;
+        }
+        opCtx->sleepFor(Milliseconds(pauseMillis));
+    }
+
+    if (!batch.empty()) {
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, batch));
+    }
+}
+
+LogicalSessionCacheImpl::Partition& LogicalSessionCacheImpl::_partitionFor(
+    const LogicalSessionId& lsid) {
+    return _partitions[LogicalSessionIdHash()(lsid) % kNumPartitions];
+}
+
+const LogicalSessionCacheImpl::Partition& LogicalSessionCacheImpl::_partitionFor(
+    const LogicalSessionId& lsid) const {
+    return _partitions[LogicalSessionIdHash()(lsid) % kNumPartitions];
+}
+
+void LogicalSessionCacheImpl::_mergeBackInto(Partition& partition, SessionMap& sessions) {
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    const auto numAddedSinceSwap = partition.activeSessions.size();
+    using std::swap;
+    swap(partition.activeSessions, sessions);
+    for (const auto& it : sessions) {
+        partition.activeSessions.emplace(it);
+    }
+    _activeSessionsCount.addAndFetch(
+        static_cast<long long>(partition.activeSessions.size() - numAddedSinceSwap));
+}
+
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds() const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    ret.reserve(_activeSessions.size());
-    for (const auto& id : _activeSessions) {
-        ret.push_back(id.first);
+    ret.reserve(_activeSessionsCount.load());
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& id : partition.activeSessions) {
+            ret.push_back(id.first);
+        }
     }
     return ret;
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
     const std::vector<SHA256Block>& userDigests) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    for (const auto& it : _activeSessions) {
-        if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
-            userDigests.cend()) {
-            ret.push_back(it.first);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& it : partition.activeSessions) {
+            if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
+                userDigests.cend()) {
+                ret.push_back(it.first);
+            }
         }
     }
     return ret;
@@ -459,9 +540,10 @@ std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
 
 boost::optional<LogicalSessionRecord> LogicalSessionCacheImpl::peekCached(
     const LogicalSessionId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    const auto it = _activeSessions.find(id);
-    if (it == _activeSessions.end()) {
+    const auto& partition = _partitionFor(id);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    const auto it = partition.activeSessions.find(id);
+    if (it == partition.activeSessions.end()) {
         return boost::none;
     }
     return it->second;
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/db/logical_session_cache.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/refresh_sessions_gen.h"
@@ -37,6 +39,8 @@
 #include "mongo/db/time_proof_service.h"
 #include "mongo/db/transaction_reaper.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/lru_cache.h"
 
@@ -58,6 +62,20 @@ class LogicalSessionCacheImpl final : public LogicalSessionCache {
 public:
     static constexpr Milliseconds kLogicalSessionDefaultRefresh = Milliseconds(5 * 60 * 1000);
 
+    /**
+     * The number of independently locked partitions the active sessions are spread over, so that
+     * operations on different sessions rarely contend with each other.
+     */
+    static constexpr size_t kNumPartitions = 16;
+
+    /**
+     * The number of session records a refresh writes to the sessions collection at once. Between
+     * batches, the refresh pauses for a random interval of up to
+     * logicalSessionRefreshMaxBatchPauseMillis, so that large refreshes do not contend with user
+     * writes all at once.
+     */
+    static constexpr size_t kRefreshBatchSize = 1000;
+
     /**
      * An Options type to support the LogicalSessionCacheImpl.
      */
@@ -145,10 +163,33 @@ private:
     bool _isDead(const LogicalSessionRecord& record, Date_t now) const;
 
     /**
-     * Takes the lock and inserts the given record into the cache.
+     * Takes the lock of the record's partition and inserts the given record into the cache.
      */
     Status _addToCache(LogicalSessionRecord record);
 
+    /**
+     * Writes 'records' to the sessions collection in batches of kRefreshBatchSize, pausing for a
+     * random interval between batches.
+     */
+    void _refreshRecordsInBatches(OperationContext* opCtx,
+                                  const LogicalSessionRecordSet& records);
+
+    using SessionMap = LogicalSessionIdMap<LogicalSessionRecord>;
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+        SessionMap activeSessions;
+    };
+
+    Partition& _partitionFor(const LogicalSessionId& lsid);
+    const Partition& _partitionFor(const LogicalSessionId& lsid) const;
+
+    /**
+     * Puts back the sessions that a failed refresh swapped out of 'partition', keeping any
+     * sessions that were added in the meantime.
+     */
+    void _mergeBackInto(Partition& partition, SessionMap& sessions);
+
     const Milliseconds _refreshInterval;
     const Minutes _sessionTimeout;
 
@@ -162,12 +203,19 @@ private:
     mutable stdx::mutex _reaperMutex;
     std::shared_ptr<TransactionReaper> _transactionReaper;
 
+    // Guards '_stats', '_endingSessions' and '_random'. The active sessions are guarded by the
+    // mutex of their partition instead.
     mutable stdx::mutex _cacheMutex;
 
-    LogicalSessionIdMap<LogicalSessionRecord> _activeSessions;
+    std::array<Partition, kNumPartitions> _partitions;
+
+    // The total number of active sessions over all partitions.
+    AtomicWord<long long> _activeSessionsCount{0};
 
     LogicalSessionIdSet _endingSessions;
 
+    PseudoRandom _random;
+
     Date_t lastRefreshTime;
 };
 
@@ -235,9 +235,11 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
         ASSERT_OK(cache()->startSession(opCtx(), record));
     }
 
-    // Check that all signedLsids refresh
-    sessions()->setRefreshHook([&count](const LogicalSessionRecordSet& sessions) {
-        ASSERT_EQ(sessions.size(), size_t(count));
+    // Check that all signedLsids refresh, in batches of at most kRefreshBatchSize records
+    size_t numRefreshed = 0;
+    sessions()->setRefreshHook([&numRefreshed](const LogicalSessionRecordSet& sessions) {
+        ASSERT_LTE(sessions.size(), LogicalSessionCacheImpl::kRefreshBatchSize);
+        numRefreshed += sessions.size();
         return Status::OK();
     });
 
@@ -245,6 +247,32 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     clearOpCtx();
     service()->fastForward(kForceRefresh);
     ASSERT(cache()->refreshNow(getClient()).isOK());
+    ASSERT_EQ(numRefreshed, size_t(count));
+}
+
+// Test that a failed refresh puts back the sessions it swapped out of every partition
+TEST_F(LogicalSessionCacheTest, FailedRefreshKeepsSessionsOfAllPartitions) {
+    const size_t count = 10 * LogicalSessionCacheImpl::kNumPartitions;
+    std::vector<LogicalSessionId> lsids;
+    for (size_t i = 0; i < count; i++) {
+        auto record = makeLogicalSessionRecordForTest();
+        lsids.push_back(record.getId());
+        ASSERT_OK(cache()->startSession(opCtx(), record));
+    }
+    ASSERT_EQ(count, cache()->size());
+
+    sessions()->setRefreshHook([](const LogicalSessionRecordSet& sessions) {
+        return Status(ErrorCodes::NotMaster, "not master");
+    });
+
+    clearOpCtx();
+    ASSERT_NOT_OK(cache()->refreshNow(getClient()));
+
+    ASSERT_EQ(count, cache()->size());
+    ASSERT_EQ(count, cache()->listIds().size());
+    for (const auto& lsid : lsids) {
+        ASSERT(cache()->peekCached(lsid));
+    }
 }
 
 //
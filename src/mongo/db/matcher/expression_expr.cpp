@@ -31,6 +31,8 @@
 
 #include "mongo/db/matcher/expression_expr.h"
 
+#include "mongo/db/query/query_knobs_gen.h"
+
 namespace mongo {
 ExprMatchExpression::ExprMatchExpression(boost::intrusive_ptr<Expression> expr,
                                          const boost::intrusive_ptr<ExpressionContext>& expCtx)
@@ -48,7 +50,7 @@ bool ExprMatchExpression::matches(const MatchableDocument* doc, MatchDetails* de
     }
 
     Document document(doc->toBSON());
-    auto value = _expression->evaluate(document);
+    auto value = _program ? _program->evaluate(document) : _expression->evaluate(document);
     return value.coerceToBool();
 }
 
@@ -90,6 +92,9 @@ std::unique_ptr<MatchExpression> ExprMatchExpression::shallowClone() const {
         Expression::parseOperand(_expCtx, bob.obj().firstElement(), _expCtx->variablesParseState);
 
     auto clone = stdx::make_unique<ExprMatchExpression>(std::move(clonedExpr), _expCtx);
+    if (_program) {
+        clone->_program = ExpressionProgram::compile(clone->_expression);
+    }
     if (_rewriteResult) {
         clone->_rewriteResult = _rewriteResult->clone();
     }
@@ -109,6 +114,9 @@ MatchExpression::ExpressionOptimizerFunc ExprMatchExpression::getOptimizer() con
         }
 
         exprMatchExpr._expression = exprMatchExpr._expression->optimize();
+        if (internalQueryEnableExpressionBytecode.load()) {
+            exprMatchExpr._program = ExpressionProgram::compile(exprMatchExpr._expression);
+        }
         exprMatchExpr._rewriteResult =
             RewriteExpr::rewrite(exprMatchExpr._expression, exprMatchExpr._expCtx->getCollator());
 
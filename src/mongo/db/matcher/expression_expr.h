@@ -36,6 +36,7 @@
 #include "mongo/db/matcher/rewrite_expr.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/expression_program.h"
 
 namespace mongo {
 
@@ -98,6 +99,9 @@ private:
 
     boost::intrusive_ptr<Expression> _expression;
 
+    // '_expression' compiled once it has been optimized, unless expression bytecode is disabled.
+    std::unique_ptr<ExpressionProgram> _program;
+
     boost::optional<RewriteExpr::RewriteResult> _rewriteResult;
 };
 
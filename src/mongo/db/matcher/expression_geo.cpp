@@ -37,6 +37,7 @@
 #include "mongo/platform/basic.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 namespace mongo {
 
@@ -141,6 +142,18 @@ Status GeoExpression::parseFrom(const BSONObj& obj) {
         geoContainer->projectInto(SPHERE);
     }
 
+    // Precompute a covering used to reject stored points without testing them against the
+    // geometry itself, which is expensive for complex polygons.
+    if (SPHERE == geoContainer->getNativeCRS() && geoContainer->hasS2Region()) {
+        const int kMaxCoveringCells = 16;
+        S2RegionCoverer coverer;
+        coverer.set_max_cells(kMaxCoveringCells);
+        std::vector<S2CellId> cover;
+        coverer.GetCovering(geoContainer->getS2Region(), &cover);
+        s2Covering = stdx::make_unique<S2CellUnion>();
+        s2Covering->InitSwap(&cover);
+    }
+
     return Status::OK();
 }
 
@@ -363,6 +376,11 @@ bool GeoMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails
 
     geometry.projectInto(_query->getGeometry().getNativeCRS());
 
+    const S2CellUnion* covering = _query->getS2Covering();
+    if (covering && geometry.isPoint() && !covering->Contains(geometry.getPoint().point)) {
+        return false;
+    }
+
     if (GeoExpression::WITHIN == _query->getPred()) {
         return _query->getGeometry().contains(geometry);
     } else {
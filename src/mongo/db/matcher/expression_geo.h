@@ -34,6 +34,7 @@
 #include "mongo/db/geo/geometry_container.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "third_party/s2/s2cellunion.h"
 
 namespace mongo {
 
@@ -63,6 +64,12 @@ public:
         return *geoContainer;
     }
 
+    // A coarse S2 covering of the geometry, or NULL if the geometry has no S2 region. Points
+    // outside of the covering can neither be within nor intersect the geometry.
+    const S2CellUnion* getS2Covering() const {
+        return s2Covering.get();
+    }
+
 private:
     // Parse geospatial query
     // e.g.
@@ -73,6 +80,7 @@ private:
     std::string field;
     std::unique_ptr<GeometryContainer> geoContainer;
     Predicate predicate;
+    std::unique_ptr<S2CellUnion> s2Covering;
 };
 
 class GeoMatchExpression : public LeafMatchExpression {
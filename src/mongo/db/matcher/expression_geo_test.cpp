@@ -79,6 +79,25 @@ std::unique_ptr<GeoMatchExpression> makeGeoMatchExpression(const BSONObj& locQue
     return ge;
 }
 
+TEST(ExpressionGeoTest, SphericalGeometryHasCovering) {
+    // A U-shaped polygon, whose notch lies within its bounding box.
+    BSONObj query = fromjson(
+        "{$geoWithin: {$geometry: {type: 'Polygon', coordinates: [[[0, 0], [6, 0], [6, 6], "
+        "[4, 6], [4, 2], [2, 2], [2, 6], [0, 6], [0, 0]]]}}}");
+    std::unique_ptr<GeoMatchExpression> ge(makeGeoMatchExpression(query));
+    ASSERT(ge->getGeoExpression().getS2Covering());
+
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [1, 5]}}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: [5, 1]}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'LineString', coordinates: [[1, 1], [5, 1]]}}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [3, 5]}}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: [3, 5]}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: [-50, 20]}")));
+
+    BSONObj flatQuery = fromjson("{$within: {$box: [{x: 4, y: 4}, [6, 6]]}}");
+    ASSERT(!makeGeoMatchExpression(flatQuery)->getGeoExpression().getS2Covering());
+}
+
 std::unique_ptr<GeoNearMatchExpression> makeGeoNearMatchExpression(const BSONObj& locQuery) {
     std::unique_ptr<GeoNearExpression> nq(new GeoNearExpression);
     ASSERT_OK(nq->parseFrom(locQuery));
@@ -375,8 +375,11 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     }
     next->_hasNull = _hasNull;
     next->_hasEmptyArray = _hasEmptyArray;
-    next->_equalitySet = _equalitySet;
+    // The sets of the clone must be built with its own comparator, which they keep a pointer to.
+    next->_equalitySet = next->_eltCmp.makeBSONEltFlatSetFromSortedUniqueRange(
+        _equalitySet.begin(), _equalitySet.end());
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_updateEqualityHashSet();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -389,7 +392,8 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails*
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (_equalityHashSet ? _equalityHashSet->count(e) > 0u
+                         : _equalitySet.find(e) != _equalitySet.end()) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -493,6 +497,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
         _originalEqualityVector.begin(),
         std::unique(
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeEqualTo()));
+    _updateEqualityHashSet();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -525,10 +530,24 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
         _originalEqualityVector.begin(),
         std::unique(
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeEqualTo()));
+    _updateEqualityHashSet();
 
     return Status::OK();
 }
 
+void InMatchExpression::_updateEqualityHashSet() {
+    if (_equalitySet.size() < kMinEqualitiesForHashSet) {
+        _equalityHashSet.reset();
+        return;
+    }
+
+    // Hashing respects the collation and numeric type equivalence of '_eltCmp', so the hash set
+    // has the same elements as '_equalitySet'.
+    _equalityHashSet = stdx::make_unique<BSONEltUnorderedSet>(_eltCmp.makeBSONEltUnorderedSet());
+    _equalityHashSet->reserve(_equalitySet.size());
+    _equalityHashSet->insert(_equalitySet.begin(), _equalitySet.end());
+}
+
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
     _regexes.push_back(std::move(expr));
     return Status::OK();
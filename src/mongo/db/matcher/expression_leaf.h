@@ -447,8 +447,17 @@ public:
     }
 
 private:
+    // Minimum number of distinct equalities for which membership is tested with a hash set rather
+    // than with a binary search of '_equalitySet'.
+    static constexpr size_t kMinEqualitiesForHashSet = 64u;
+
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Builds '_equalityHashSet' from '_equalitySet' if it has enough elements, or clears it.
+     */
+    void _updateEqualityHashSet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -475,6 +484,10 @@ private:
     // for this set.
     BSONEltFlatSet _equalitySet;
 
+    // The elements of '_equalitySet' hashed with '_eltCmp', for large $in lists. Null if
+    // '_equalitySet' has fewer than kMinEqualitiesForHashSet elements.
+    std::unique_ptr<BSONEltUnorderedSet> _equalityHashSet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
@@ -1370,6 +1370,37 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, MatchesLargeSetOfEqualities) {
+    BSONArrayBuilder operandBuilder;
+    for (int i = 0; i < 1000; i += 2) {
+        operandBuilder.append(i);
+        operandBuilder.append("key" + std::to_string(i));
+    }
+    BSONArray operand = operandBuilder.arr();
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    auto in = stdx::make_unique<InMatchExpression>("a");
+    in->setCollator(&collator);
+    ASSERT_OK(in->setEqualities(std::move(equalities)));
+    auto clone = in->shallowClone();
+    in.reset();
+
+    ASSERT(clone->matchesBSON(BSON("a" << 998)));
+    ASSERT(clone->matchesBSON(BSON("a" << 500LL)));
+    ASSERT(clone->matchesBSON(BSON("a" << 2.0)));
+    ASSERT(clone->matchesBSON(BSON("a" << Decimal128(4))));
+    ASSERT(clone->matchesBSON(BSON("a"
+                                   << "KEY998")));
+    ASSERT(clone->matchesBSON(BSON("a" << BSON_ARRAY(1 << 3 << 4))));
+    ASSERT(!clone->matchesBSON(BSON("a" << 999)));
+    ASSERT(!clone->matchesBSON(BSON("a" << 2.5)));
+    ASSERT(!clone->matchesBSON(BSON("a"
+                                    << "key999")));
+    ASSERT(!clone->matchesBSON(BSON("b" << 2)));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/matcher/expression.h"
 
 namespace mongo {
@@ -73,6 +75,33 @@ public:
         return _path;
     }
 
+    /**
+     * Returns the path of the object holding the last field of the path, or an empty string if
+     * the path is a top-level field. For example, returns "a.b" for the path "a.b.c".
+     */
+    StringData parentPath() const {
+        size_t lastDot = _path.rfind('.');
+        return lastDot == std::string::npos ? StringData() : _path.substr(0, lastDot);
+    }
+
+    /**
+     * Matches a document whose object at parentPath() is 'parent', and which has no arrays along
+     * parentPath(). 'parent' is empty if parentPath() does not lead to an object. Returns
+     * boost::none if the last field of the path is an array, in which case the document must be
+     * matched with matches().
+     */
+    boost::optional<bool> matchesInParent(const BSONObj& parent, MatchDetails* details) const {
+        size_t lastDot = _path.rfind('.');
+        BSONElement elem =
+            parent.getField(lastDot == std::string::npos ? _path : _path.substr(lastDot + 1));
+        if (elem.type() == BSONType::Array) {
+            return boost::none;
+        }
+
+        // Without arrays along the path, its element is the only one matches() would examine.
+        return matchesSingleElement(elem, details);
+    }
+
     void setPath(StringData path) {
         _path = path;
         _elementPath.init(_path);
@@ -194,9 +194,65 @@ bool ListOfMatchExpression::equivalent(const MatchExpression* other) const {
 
 // -----
 
+namespace {
+
+/**
+ * Sets 'out' to the object at 'path' in 'obj', or to an empty object if 'path' does not lead to an
+ * object. Returns false if there is an array along 'path', in which case paths under it must be
+ * traversed with an ElementIterator.
+ */
+bool getObjectAtPath(const BSONObj& obj, StringData path, BSONObj* out) {
+    BSONObj curr = obj;
+    while (!path.empty()) {
+        size_t dot = path.find('.');
+        BSONElement elem = curr.getField(path.substr(0, dot));
+        if (elem.type() == BSONType::Array) {
+            return false;
+        }
+        if (elem.type() != BSONType::Object) {
+            *out = BSONObj();
+            return true;
+        }
+        curr = elem.Obj();
+        path = dot == std::string::npos ? StringData() : path.substr(dot + 1);
+    }
+    *out = curr;
+    return true;
+}
+
+bool isPathMatchExpression(const MatchExpression* expr) {
+    return expr->getCategory() == MatchExpression::MatchCategory::kLeaf ||
+        expr->getCategory() == MatchExpression::MatchCategory::kArrayMatching;
+}
+
+}  // namespace
+
 bool AndMatchExpression::matches(const MatchableDocument* doc, MatchDetails* details) const {
+    // Children are sorted by path, so predicates on fields of the same object are usually
+    // adjacent. The object holding the field of the last path predicate is kept, so that its
+    // siblings are looked up directly instead of walking the document from the root again.
+    const BSONObj* obj = doc->getBSONObj();
+    bool haveParent = false;
+    bool parentHasArray = false;
+    StringData parentPath;
+    BSONObj parent;
+
     for (size_t i = 0; i < numChildren(); i++) {
-        if (!getChild(i)->matches(doc, details)) {
+        const MatchExpression* child = getChild(i);
+        boost::optional<bool> matched;
+        if (obj && isPathMatchExpression(child) && !child->path().empty()) {
+            const auto pathExpr = static_cast<const PathMatchExpression*>(child);
+            if (!haveParent || pathExpr->parentPath() != parentPath) {
+                parentPath = pathExpr->parentPath();
+                parentHasArray = !getObjectAtPath(*obj, parentPath, &parent);
+                haveParent = true;
+            }
+            if (!parentHasArray) {
+                matched = pathExpr->matchesInParent(parent, details);
+            }
+        }
+
+        if (!(matched ? *matched : child->matches(doc, details))) {
             if (details)
                 details->resetOutput();
             return false;
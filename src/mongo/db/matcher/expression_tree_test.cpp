@@ -156,6 +156,26 @@ TEST(AndOp, MatchesThreeClauses) {
     ASSERT(!andOp.matchesBSON(BSON("a" << 10 << "b" << 6), NULL));
 }
 
+TEST(AndOp, MatchesSiblingPaths) {
+    BSONObj operands = BSON("c" << 1 << "d" << 2 << "e" << BSONNULL);
+
+    AndMatchExpression andOp;
+    andOp.add(new EqualityMatchExpression("a.b.c", operands["c"]));
+    andOp.add(new GTMatchExpression("a.b.d", operands["d"]));
+    andOp.add(new EqualityMatchExpression("a.e", operands["e"]));
+
+    ASSERT(andOp.matchesBSON(fromjson("{a: {b: {c: 1, d: 3}}}"), NULL));
+    ASSERT(!andOp.matchesBSON(fromjson("{a: {b: {c: 1, d: 2}}}"), NULL));
+    ASSERT(!andOp.matchesBSON(fromjson("{a: {b: {c: 1, d: 3}, e: 1}}"), NULL));
+    ASSERT(!andOp.matchesBSON(fromjson("{a: {b: 1}}"), NULL));
+
+    // Arrays along the paths or at their ends are traversed.
+    ASSERT(andOp.matchesBSON(fromjson("{a: {b: {c: [2, 1], d: [1, 3]}}}"), NULL));
+    ASSERT(andOp.matchesBSON(fromjson("{a: {b: [{c: 1}, {d: 3}]}}"), NULL));
+    ASSERT(andOp.matchesBSON(fromjson("{a: [{b: {c: 1, d: 3}}, {e: 1}]}"), NULL));
+    ASSERT(!andOp.matchesBSON(fromjson("{a: [{b: {c: 1, d: 3}, e: 1}]}"), NULL));
+}
+
 TEST(AndOp, ElemMatchKey) {
     BSONObj baseOperand1 = BSON("a" << 1);
     BSONObj baseOperand2 = BSON("b" << 2);
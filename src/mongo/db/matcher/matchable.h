@@ -44,6 +44,15 @@ public:
 
     virtual BSONObj toBSON() const = 0;
 
+    /**
+     * Returns the BSON object which every path of this document is resolved in, or nullptr if
+     * paths are resolved in some other way. Lets matchers look paths up in the object directly
+     * rather than through an ElementIterator.
+     */
+    virtual const BSONObj* getBSONObj() const {
+        return nullptr;
+    }
+
     /**
      * The neewly returned ElementIterator is allowed to keep a pointer to path.
      * So the caller of this function should make sure path is in scope until
@@ -83,6 +92,10 @@ public:
         return _obj;
     }
 
+    const BSONObj* getBSONObj() const override {
+        return &_obj;
+    }
+
     virtual ElementIterator* allocateIterator(const ElementPath* path) const {
         if (_iteratorUsed)
             return new BSONElementIterator(path, _obj);
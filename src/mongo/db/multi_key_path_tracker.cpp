@@ -46,11 +46,11 @@ void MultikeyPathTracker::mergeMultikeyPaths(MultikeyPaths* toMergeInto,
     }
 }
 
-void MultikeyPathTracker::addMultikeyPathInfo(MultikeyPathInfo info) {
-    invariant(_trackMultikeyPathInfo);
+void MultikeyPathTracker::mergeMultikeyPathInfo(WorkerMultikeyPathInfo* toMergeInto,
+                                                MultikeyPathInfo info) {
     // Merge the `MultikeyPathInfo` input into the accumulated value being tracked for the
     // (collection, index) key.
-    for (auto& existingChanges : _multikeyPathInfo) {
+    for (auto& existingChanges : *toMergeInto) {
         if (existingChanges.nss != info.nss || existingChanges.indexName != info.indexName) {
             continue;
         }
@@ -60,7 +60,12 @@ void MultikeyPathTracker::addMultikeyPathInfo(MultikeyPathInfo info) {
     }
 
     // If an existing entry wasn't found for the (collection, index) input, create a new entry.
-    _multikeyPathInfo.emplace_back(info);
+    toMergeInto->emplace_back(std::move(info));
+}
+
+void MultikeyPathTracker::addMultikeyPathInfo(MultikeyPathInfo info) {
+    invariant(_trackMultikeyPathInfo);
+    mergeMultikeyPathInfo(&_multikeyPathInfo, std::move(info));
 }
 
 const WorkerMultikeyPathInfo& MultikeyPathTracker::getMultikeyPathInfo() const {
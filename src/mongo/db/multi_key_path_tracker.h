@@ -58,6 +58,12 @@ public:
 
     static void mergeMultikeyPaths(MultikeyPaths* toMergeInto, const MultikeyPaths& newPaths);
 
+    /**
+     * Merges 'info' into the entry of 'toMergeInto' for the same index, or appends it if there is
+     * none, so that each index is set as multikey at most once.
+     */
+    static void mergeMultikeyPathInfo(WorkerMultikeyPathInfo* toMergeInto, MultikeyPathInfo info);
+
     // Decoration requires a default constructor.
     MultikeyPathTracker() = default;
 
@@ -92,5 +92,22 @@ TEST(MultikeyPathTracker, TestMergeMultikeyPaths) {
         assertMultikeyPathsAreEqual(mutablePaths, {{0, 1}, {0, 1}, {0, 1, 2}});
     }
 }
+
+TEST(MultikeyPathTracker, TestMergeMultikeyPathInfo) {
+    const NamespaceString nss("test.coll");
+    WorkerMultikeyPathInfo infos;
+    MultikeyPathTracker::mergeMultikeyPathInfo(&infos, {nss, "a_1_b_1", {{0}, {}}});
+    MultikeyPathTracker::mergeMultikeyPathInfo(&infos, {nss, "c_1", {{0}}});
+    MultikeyPathTracker::mergeMultikeyPathInfo(&infos, {nss, "a_1_b_1", {{}, {0}}});
+    MultikeyPathTracker::mergeMultikeyPathInfo(&infos, {NamespaceString("test.other"), "c_1", {{}}});
+
+    // Changes to the same index of the same collection are merged into a single entry.
+    ASSERT_EQ(infos.size(), 3U);
+    ASSERT_EQ(infos[0].indexName, "a_1_b_1");
+    assertMultikeyPathsAreEqual(infos[0].multikeyPaths, {{0}, {0}});
+    ASSERT_EQ(infos[1].indexName, "c_1");
+    assertMultikeyPathsAreEqual(infos[1].multikeyPaths, {{0}});
+    ASSERT_EQ(infos[2].nss, NamespaceString("test.other"));
+}
 }  // namespace
 }  // namespace mongo
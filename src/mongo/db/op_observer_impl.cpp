@@ -507,8 +507,8 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
             return;
         }
         for (auto iter = first; iter != last; iter++) {
-            auto operation = OplogEntry::makeInsertOperation(nss, uuid, iter->doc);
-            txnParticipant.addTransactionOperation(opCtx, operation);
+            txnParticipant.addTransactionOperation(
+                opCtx, OplogEntry::makeInsertOperation(nss, uuid, iter->doc));
         }
     } else {
         lastWriteDate = getWallClockTimeForOpLog(opCtx);
@@ -581,7 +581,7 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
     if (inMultiDocumentTransaction) {
         auto operation = OplogEntry::makeUpdateOperation(
             args.nss, args.uuid, args.updateArgs.update, args.updateArgs.criteria);
-        txnParticipant.addTransactionOperation(opCtx, operation);
+        txnParticipant.addTransactionOperation(opCtx, std::move(operation));
     } else {
         opTime = replLogUpdate(opCtx, args);
         onWriteOpCompleted(opCtx,
@@ -642,7 +642,7 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
     if (inMultiDocumentTransaction) {
         auto operation =
             OplogEntry::makeDeleteOperation(nss, uuid, deletedDoc ? deletedDoc.get() : documentKey);
-        txnParticipant.addTransactionOperation(opCtx, operation);
+        txnParticipant.addTransactionOperation(opCtx, std::move(operation));
     } else {
         opTime = replLogDelete(opCtx, nss, uuid, stmtId, fromMigrate, deletedDoc);
         onWriteOpCompleted(opCtx,
@@ -1001,12 +1001,22 @@ void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
 namespace {
 
 OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
-                                       std::vector<repl::ReplOperation> stmts,
+                                       const std::vector<repl::ReplOperation>& stmts,
                                        const OplogSlot& prepareOplogSlot) {
-    BSONObjBuilder applyOpsBuilder;
+    // Size the buffer for all of the operations up front, so that building a large applyOps
+    // entry does not repeatedly grow and copy it.
+    std::size_t estimatedSize = 0;
+    for (const auto& stmt : stmts) {
+        estimatedSize += repl::OplogEntry::getReplOperationSize(stmt);
+    }
+    BSONObjBuilder applyOpsBuilder(
+        static_cast<int>(std::min(estimatedSize, static_cast<std::size_t>(BSONObjMaxUserSize))));
+
     BSONArrayBuilder opsArray(applyOpsBuilder.subarrayStart("applyOps"_sd));
-    for (auto& stmt : stmts) {
-        opsArray.append(stmt.toBSON());
+    for (const auto& stmt : stmts) {
+        // Serialize each operation straight into the array instead of through a temporary object.
+        BSONObjBuilder stmtBuilder(opsArray.subobjStart());
+        stmt.serialize(&stmtBuilder);
     }
     opsArray.done();
 
@@ -40,6 +40,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/transport/baton.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/buffer_arena.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -78,6 +79,10 @@ MONGO_FAIL_POINT_DEFINE(checkForInterruptFail);
 
 const auto kNoWaiterThread = stdx::thread::id();
 
+// Decorations are destroyed after the members of the OperationContext, so the arena outlives any
+// object of the operation which references it.
+const auto getBufferArena = OperationContext::declareDecoration<BufferArena>();
+
 }  // namespace
 
 OperationContext::OperationContext(Client* client, unsigned int opId)
@@ -386,6 +391,10 @@ std::unique_ptr<Locker> OperationContext::swapLockState(std::unique_ptr<Locker>
     return locker;
 }
 
+BufferArena* OperationContext::bufferArena() {
+    return &getBufferArena(this);
+}
+
 Date_t OperationContext::getExpirationDateForWaitForValue(Milliseconds waitFor) {
     return getServiceContext()->getPreciseClockSource()->now() + waitFor;
 }
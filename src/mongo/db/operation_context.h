@@ -52,6 +52,7 @@
 
 namespace mongo {
 
+class BufferArena;
 class Client;
 class CurOp;
 class ProgressMeter;
@@ -128,6 +129,12 @@ public:
      */
     std::unique_ptr<Locker> swapLockState(std::unique_ptr<Locker> locker);
 
+    /**
+     * Returns the arena for short-lived buffers of this operation, such as those of the
+     * BSONObjBuilders of its replies. Its memory is freed when this OperationContext is destroyed.
+     */
+    BufferArena* bufferArena();
+
     /**
      * Returns Status::OK() unless this operation is in a killed state.
      */
@@ -0,0 +1,388 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ops/update_combiner.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/safe_num.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const auto getUpdateCombiner = ServiceContext::declareDecoration<UpdateCombiner>();
+
+bool isCombinableModifier(StringData name) {
+    return name == "$inc" || name == "$max" || name == "$min" || name == "$addToSet";
+}
+
+bool isCombinableValue(StringData modifier, const BSONElement& value) {
+    if (modifier == "$inc") {
+        return value.isNumber();
+    }
+
+    if (modifier == "$addToSet" && value.type() == Object) {
+        const auto obj = value.embeddedObject();
+        const auto firstFieldName = obj.firstElement().fieldNameStringData();
+        if (firstFieldName.startsWith("$")) {
+            return obj.nFields() == 1 && firstFieldName == "$each" &&
+                obj.firstElement().type() == Array;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Calls 'fn' on each value a $addToSet modifier adds to the set.
+ */
+template <typename Fn>
+void forEachAddedValue(const BSONElement& value, Fn&& fn) {
+    if (value.type() == Object &&
+        value.embeddedObject().firstElement().fieldNameStringData() == "$each") {
+        for (auto&& elem : value.embeddedObject().firstElement().embeddedObject()) {
+            fn(elem);
+        }
+    } else {
+        fn(value);
+    }
+}
+
+/**
+ * Returns the element of the modifier 'modifier' on the field at position 'pos' of 'update'.
+ */
+BSONElement fieldAt(const BSONObj& update, StringData modifier, size_t pos) {
+    BSONObjIterator it(update[modifier].embeddedObject());
+    for (size_t i = 0; i < pos; ++i) {
+        it.next();
+    }
+    return it.next();
+}
+
+/**
+ * Appends to 'bob' the value of the modifier 'modifier' on the field at position 'pos' that has the
+ * effect of all of 'updates'. Returns false if there is no such value.
+ */
+bool mergeField(const std::vector<BSONObj>& updates,
+                StringData modifier,
+                size_t pos,
+                StringData fieldName,
+                BSONObjBuilder* bob) {
+    if (modifier == "$inc") {
+        SafeNum sum(fieldAt(updates.front(), modifier, pos));
+        for (size_t i = 1; i < updates.size(); ++i) {
+            sum = sum + SafeNum(fieldAt(updates[i], modifier, pos));
+        }
+        if (!sum.isValid()) {
+            return false;
+        }
+        sum.toBSON(fieldName, bob);
+        return true;
+    }
+
+    if (modifier == "$max" || modifier == "$min") {
+        auto extreme = fieldAt(updates.front(), modifier, pos);
+        for (size_t i = 1; i < updates.size(); ++i) {
+            const auto value = fieldAt(updates[i], modifier, pos);
+            const int cmp = value.woCompare(extreme, false);
+            if (modifier == "$max" ? cmp > 0 : cmp < 0) {
+                extreme = value;
+            }
+        }
+        bob->appendAs(extreme, fieldName);
+        return true;
+    }
+
+    invariant(modifier == "$addToSet");
+    std::vector<BSONElement> values;
+    for (auto&& update : updates) {
+        forEachAddedValue(fieldAt(update, modifier, pos), [&](const BSONElement& value) {
+            const bool seen = std::any_of(values.begin(), values.end(), [&](const BSONElement& e) {
+                return e.woCompare(value, false) == 0;
+            });
+            if (!seen) {
+                values.push_back(value);
+            }
+        });
+    }
+    BSONObjBuilder fieldBob(bob->subobjStart(fieldName));
+    BSONArrayBuilder each(fieldBob.subarrayStart("$each"));
+    for (auto&& value : values) {
+        each.append(value);
+    }
+    return true;
+}
+
+std::string makeQueueKey(const NamespaceString& nss, const write_ops::UpdateOpEntry& op) {
+    const auto id = op.getQ().firstElement();
+    std::string key = nss.ns();
+    key.push_back('\0');
+    key.push_back(static_cast<char>(id.type()));
+    key.append(id.value(), id.valuesize());
+    return key;
+}
+
+}  // namespace
+
+UpdateCombiner& UpdateCombiner::get(ServiceContext* service) {
+    return getUpdateCombiner(service);
+}
+
+bool UpdateCombiner::isCombinable(const write_ops::UpdateOpEntry& op,
+                                  const CollatorInterface* defaultCollator) {
+    if (op.getMulti() || op.getArrayFilters() || op.getCollation() || defaultCollator) {
+        return false;
+    }
+
+    const auto& query = op.getQ();
+    if (query.nFields() != 1 || query.firstElement().fieldNameStringData() != "_id") {
+        return false;
+    }
+    switch (query.firstElement().type()) {
+        case Object:
+        case Array:
+        case RegEx:
+        case Undefined:
+        case EOO:
+            return false;
+        default:
+            break;
+    }
+
+    const auto& update = op.getU();
+    if (update.isEmpty()) {
+        return false;
+    }
+    for (auto&& modifier : update) {
+        if (!isCombinableModifier(modifier.fieldNameStringData()) || modifier.type() != Object ||
+            modifier.embeddedObject().isEmpty()) {
+            return false;
+        }
+        for (auto&& field : modifier.embeddedObject()) {
+            const auto path = field.fieldNameStringData();
+            if (path.find('$') != std::string::npos || path == "_id" || path.startsWith("_id.") ||
+                !isCombinableValue(modifier.fieldNameStringData(), field)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::string UpdateCombiner::shapeOf(const write_ops::UpdateOpEntry& op) {
+    std::string shape = op.getUpsert() ? "upsert" : "update";
+    for (auto&& modifier : op.getU()) {
+        shape.push_back('\0');
+        shape.append(modifier.fieldName());
+        for (auto&& field : modifier.embeddedObject()) {
+            shape.push_back('\0');
+            shape.append(field.fieldName());
+        }
+    }
+    return shape;
+}
+
+boost::optional<BSONObj> UpdateCombiner::merge(const std::vector<BSONObj>& updates) {
+    invariant(!updates.empty());
+    BSONObjBuilder bob;
+    for (auto&& modifier : updates.front()) {
+        const auto modifierName = modifier.fieldNameStringData();
+        BSONObjBuilder modifierBob(bob.subobjStart(modifierName));
+        size_t pos = 0;
+        for (auto&& field : modifier.embeddedObject()) {
+            if (!mergeField(
+                    updates, modifierName, pos++, field.fieldNameStringData(), &modifierBob)) {
+                return boost::none;
+            }
+        }
+    }
+    return bob.obj();
+}
+
+SingleWriteResult UpdateCombiner::update(OperationContext* opCtx,
+                                         const NamespaceString& nss,
+                                         const write_ops::UpdateOpEntry& op,
+                                         const PerformUpdateFn& performUpdate) {
+    const auto key = makeQueueKey(nss, op);
+    Waiter self(&op);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto it = _queues.find(key);
+    if (it == _queues.end()) {
+        _queues.emplace(key, std::vector<Waiter*>());
+        self.isLeader = true;
+    } else {
+        it->second.push_back(&self);
+    }
+
+    while (!self.isLeader && !self.claimed) {
+        auto status = opCtx->waitForConditionOrInterruptNoAssert(self.cv, lk);
+        if (!status.isOK() && !self.isLeader && !self.claimed) {
+            auto& queue = _queues.find(key)->second;
+            queue.erase(std::find(queue.begin(), queue.end(), &self));
+            uassertStatusOK(status);
+        }
+    }
+
+    if (!self.isLeader) {
+        // Another thread took the update, and cannot be interrupted by this operation any longer.
+        self.cv.wait(lk, [&] { return self.done; });
+        lk.unlock();
+        return self.performAlone ? performUpdate(op) : self.result;
+    }
+
+    auto& queue = _queues.find(key)->second;
+    std::vector<Waiter*> batch{&self};
+    batch.insert(batch.end(), queue.begin(), queue.end());
+    queue.clear();
+    for (auto waiter : batch) {
+        waiter->claimed = true;
+    }
+    lk.unlock();
+
+    ON_BLOCK_EXIT([&] {
+        lk.lock();
+        for (auto waiter : batch) {
+            if (waiter != &self) {
+                waiter->done = true;
+                waiter->cv.notify_one();
+            }
+        }
+
+        auto queueIt = _queues.find(key);
+        if (queueIt->second.empty()) {
+            _queues.erase(queueIt);
+        } else {
+            auto next = queueIt->second.front();
+            queueIt->second.erase(queueIt->second.begin());
+            next->isLeader = true;
+            next->cv.notify_one();
+        }
+    });
+
+    return _performBatch(batch, &self, performUpdate);
+}
+
+SingleWriteResult UpdateCombiner::_performBatch(const std::vector<Waiter*>& batch,
+                                                Waiter* self,
+                                                const PerformUpdateFn& performUpdate) {
+    boost::optional<SingleWriteResult> selfResult;
+    std::exception_ptr selfError;
+    auto performOne = [&](Waiter* waiter) {
+        try {
+            if (waiter == self) {
+                selfResult = performUpdate(*waiter->op);
+            } else {
+                waiter->result = performUpdate(*waiter->op);
+            }
+        } catch (const DBException&) {
+            if (waiter == self) {
+                selfError = std::current_exception();
+            } else {
+                waiter->performAlone = true;
+            }
+        }
+    };
+
+    std::vector<std::string> shapes;
+    for (auto waiter : batch) {
+        shapes.push_back(shapeOf(*waiter->op));
+    }
+
+    for (size_t begin = 0, end = 0; begin < batch.size(); begin = end) {
+        end = begin + 1;
+        while (end < batch.size() && shapes[end] == shapes[begin]) {
+            ++end;
+        }
+        if (end - begin == 1) {
+            performOne(batch[begin]);
+            continue;
+        }
+
+        const std::vector<Waiter*> group(batch.begin() + begin, batch.begin() + end);
+        std::vector<BSONObj> updates;
+        for (auto waiter : group) {
+            updates.push_back(waiter->op->getU());
+        }
+        auto merged = merge(updates);
+
+        boost::optional<SingleWriteResult> groupResult;
+        if (merged) {
+            write_ops::UpdateOpEntry mergedOp;
+            mergedOp.setQ(group.front()->op->getQ());
+            mergedOp.setU(*merged);
+            mergedOp.setUpsert(group.front()->op->getUpsert());
+            try {
+                groupResult = performUpdate(mergedOp);
+            } catch (const DBException&) {
+                // Perform the updates one at a time below, so that each reports its own error.
+            }
+        }
+
+        if (!groupResult) {
+            for (auto waiter : group) {
+                if (waiter == self) {
+                    performOne(waiter);
+                } else {
+                    waiter->performAlone = true;
+                }
+            }
+            continue;
+        }
+
+        // Only the first update of the group inserted the document. The others modified it.
+        SingleWriteResult othersResult;
+        othersResult.setN(groupResult->getN());
+        othersResult.setNModified(groupResult->getUpsertedId().isEmpty()
+                                      ? groupResult->getNModified()
+                                      : groupResult->getN());
+        for (auto waiter : group) {
+            const auto& result = waiter == group.front() ? *groupResult : othersResult;
+            if (waiter == self) {
+                selfResult = result;
+            } else {
+                waiter->result = result;
+            }
+        }
+    }
+
+    if (selfError) {
+        std::rethrow_exception(selfError);
+    }
+    return *selfResult;
+}
+
+}  // namespace mongo
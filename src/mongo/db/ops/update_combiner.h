@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/ops/single_write_result_gen.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+class CollatorInterface;
+class NamespaceString;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Combines concurrent updates of the same document into a single storage update, so that clients
+ * incrementing a shared counter do not all conflict with each other in the storage engine.
+ *
+ * Only updates that select a single document by _id and apply commutative modifiers ($inc, $max,
+ * $min and $addToSet) can be combined. The first thread to update a document becomes its leader.
+ * Threads that update the same document while the leader works queue up behind it. When done, the
+ * leader hands off to the first queued thread, which merges all queued updates that modify the
+ * same fields into one update, performs it, and hands their results back to their threads.
+ */
+class UpdateCombiner {
+    MONGO_DISALLOW_COPYING(UpdateCombiner);
+
+public:
+    using PerformUpdateFn = stdx::function<SingleWriteResult(const write_ops::UpdateOpEntry&)>;
+
+    UpdateCombiner() = default;
+
+    static UpdateCombiner& get(ServiceContext* service);
+
+    /**
+     * Returns whether 'op' can be combined with other updates of the same document of a collection
+     * whose default collator is 'defaultCollator'. Merged updates compare values with the simple
+     * collation, so updates of collections with a default collation are never combined.
+     */
+    static bool isCombinable(const write_ops::UpdateOpEntry& op,
+                             const CollatorInterface* defaultCollator);
+
+    /**
+     * Returns a string that is the same for two combinable updates if and only if they apply the
+     * same modifiers to the same fields, and so can be merged.
+     */
+    static std::string shapeOf(const write_ops::UpdateOpEntry& op);
+
+    /**
+     * Returns the modifiers of an update equivalent to applying all of 'updates' in order, or
+     * boost::none if their values cannot be merged, such as when a sum overflows. The updates must
+     * all be combinable and have the same shape.
+     */
+    static boost::optional<BSONObj> merge(const std::vector<BSONObj>& updates);
+
+    /**
+     * Performs 'op', which must be combinable, and returns its result. 'performUpdate' performs an
+     * update on behalf of the calling thread. It is called either with 'op', with an update merged
+     * from 'op' and concurrent updates of the same document, or not at all, when 'op' was merged
+     * into an update performed by another thread. In the latter case, the result reports the
+     * document as modified if the merged update modified it.
+     */
+    SingleWriteResult update(OperationContext* opCtx,
+                             const NamespaceString& nss,
+                             const write_ops::UpdateOpEntry& op,
+                             const PerformUpdateFn& performUpdate);
+
+private:
+    struct Waiter {
+        explicit Waiter(const write_ops::UpdateOpEntry* op) : op(op) {}
+
+        const write_ops::UpdateOpEntry* const op;
+        stdx::condition_variable cv;
+
+        // Set when the thread should perform the queued updates of its document.
+        bool isLeader = false;
+
+        // Set when a leader took the update, and when it finished with it.
+        bool claimed = false;
+        bool done = false;
+
+        // Set when the leader failed to perform the update together with others, and the thread
+        // has to perform it alone to get its own error.
+        bool performAlone = false;
+        SingleWriteResult result;
+    };
+
+    /**
+     * Performs the updates of 'batch' through 'performUpdate', merging consecutive updates of the
+     * same shape. Sets the result or 'performAlone' of every waiter other than 'self'. Returns the
+     * result of the update of 'self', or throws its error.
+     */
+    SingleWriteResult _performBatch(const std::vector<Waiter*>& batch,
+                                    Waiter* self,
+                                    const PerformUpdateFn& performUpdate);
+
+    stdx::mutex _mutex;
+
+    // Updates waiting for the leader of their document, keyed by namespace and _id. A document has
+    // an entry while it has a leader.
+    stdx::unordered_map<std::string, std::vector<Waiter*>> _queues;
+};
+
+}  // namespace mongo
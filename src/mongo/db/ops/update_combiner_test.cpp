@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/db/ops/update_combiner.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+write_ops::UpdateOpEntry makeUpdate(const BSONObj& q, const BSONObj& u, bool upsert = false) {
+    write_ops::UpdateOpEntry entry;
+    entry.setQ(q);
+    entry.setU(u);
+    entry.setUpsert(upsert);
+    return entry;
+}
+
+bool isCombinable(const write_ops::UpdateOpEntry& op) {
+    return UpdateCombiner::isCombinable(op, nullptr);
+}
+
+TEST(UpdateCombinerTest, CombinableUpdates) {
+    ASSERT(isCombinable(makeUpdate(BSON("_id" << 1), BSON("$inc" << BSON("n" << 1)))));
+    ASSERT(isCombinable(
+        makeUpdate(BSON("_id"
+                        << "a"),
+                   BSON("$max" << BSON("x.y" << 3) << "$addToSet"
+                               << BSON("tags" << BSON("$each" << BSON_ARRAY(1 << 2)))),
+                   true)));
+}
+
+TEST(UpdateCombinerTest, UpdatesOfManyDocumentsAreNotCombinable) {
+    ASSERT_FALSE(
+        isCombinable(makeUpdate(BSON("_id" << BSON("$gt" << 1)), BSON("$inc" << BSON("n" << 1)))));
+    ASSERT_FALSE(
+        isCombinable(makeUpdate(BSON("_id" << 1 << "a" << 2), BSON("$inc" << BSON("n" << 1)))));
+    ASSERT_FALSE(isCombinable(makeUpdate(BSON("a" << 1), BSON("$inc" << BSON("n" << 1)))));
+
+    auto multi = makeUpdate(BSON("_id" << 1), BSON("$inc" << BSON("n" << 1)));
+    multi.setMulti(true);
+    ASSERT_FALSE(isCombinable(multi));
+}
+
+TEST(UpdateCombinerTest, NonCommutativeUpdatesAreNotCombinable) {
+    ASSERT_FALSE(isCombinable(makeUpdate(BSON("_id" << 1), BSON("$set" << BSON("n" << 1)))));
+    ASSERT_FALSE(isCombinable(makeUpdate(BSON("_id" << 1), BSON("n" << 1))));
+    ASSERT_FALSE(isCombinable(makeUpdate(BSON("_id" << 1),
+                                         BSON("$inc" << BSON("n"
+                                                             << "a")))));
+    ASSERT_FALSE(isCombinable(makeUpdate(BSON("_id" << 1), BSON("$inc" << BSON("a.$" << 1)))));
+    ASSERT_FALSE(isCombinable(makeUpdate(BSON("_id" << 1), BSON("$max" << BSON("_id" << 1)))));
+    ASSERT_FALSE(isCombinable(makeUpdate(
+        BSON("_id" << 1),
+        BSON("$addToSet" << BSON("a" << BSON("$each" << BSON_ARRAY(1) << "$slice" << 1))))));
+}
+
+TEST(UpdateCombinerTest, UpdatesOfCollectionsWithDefaultCollationAreNotCombinable) {
+    // With a case-insensitive collation, $max of "a" and "B" is "B" and $addToSet treats "a" and
+    // "A" as the same value, unlike the simple collation which merged updates compare with.
+    CollatorInterfaceMock caseInsensitive(CollatorInterfaceMock::MockType::kToLowerString);
+    const auto maxUpdate = makeUpdate(BSON("_id" << 1),
+                                      BSON("$max" << BSON("s"
+                                                          << "a")));
+    const auto addToSetUpdate = makeUpdate(BSON("_id" << 1),
+                                           BSON("$addToSet" << BSON("s"
+                                                                    << "A")));
+    ASSERT(isCombinable(maxUpdate));
+    ASSERT(isCombinable(addToSetUpdate));
+    ASSERT_FALSE(UpdateCombiner::isCombinable(maxUpdate, &caseInsensitive));
+    ASSERT_FALSE(UpdateCombiner::isCombinable(addToSetUpdate, &caseInsensitive));
+
+    auto incUpdate = makeUpdate(BSON("_id" << 1), BSON("$inc" << BSON("n" << 1)));
+    ASSERT_FALSE(UpdateCombiner::isCombinable(incUpdate, &caseInsensitive));
+}
+
+TEST(UpdateCombinerTest, ShapeDependsOnModifiersFieldsAndUpsert) {
+    auto shapeOf = [](const BSONObj& q, const BSONObj& u, bool upsert = false) {
+        return UpdateCombiner::shapeOf(makeUpdate(q, u, upsert));
+    };
+    const auto shape = shapeOf(BSON("_id" << 1), BSON("$inc" << BSON("n" << 1)));
+    ASSERT_EQ(shape, shapeOf(BSON("_id" << 2), BSON("$inc" << BSON("n" << 5))));
+    ASSERT_NE(shape, shapeOf(BSON("_id" << 1), BSON("$inc" << BSON("m" << 1))));
+    ASSERT_NE(shape, shapeOf(BSON("_id" << 1), BSON("$max" << BSON("n" << 1))));
+    ASSERT_NE(shape, shapeOf(BSON("_id" << 1), BSON("$inc" << BSON("n" << 1)), true));
+}
+
+TEST(UpdateCombinerTest, MergeSumsIncrements) {
+    auto merged = UpdateCombiner::merge({BSON("$inc" << BSON("a" << 1 << "b" << 2.5)),
+                                         BSON("$inc" << BSON("a" << 2 << "b" << 1)),
+                                         BSON("$inc" << BSON("a" << -1 << "b" << 0))});
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(*merged, BSON("$inc" << BSON("a" << 2 << "b" << 3.5)));
+}
+
+TEST(UpdateCombinerTest, MergeFailsWhenSumOverflows) {
+    const long long max = std::numeric_limits<long long>::max();
+    ASSERT_FALSE(UpdateCombiner::merge(
+        {BSON("$inc" << BSON("a" << max)), BSON("$inc" << BSON("a" << 1LL))}));
+}
+
+TEST(UpdateCombinerTest, MergeKeepsExtremes) {
+    auto merged =
+        UpdateCombiner::merge({BSON("$max" << BSON("a" << 3) << "$min" << BSON("b" << 3)),
+                               BSON("$max" << BSON("a" << 7) << "$min" << BSON("b" << 1)),
+                               BSON("$max" << BSON("a" << 5) << "$min" << BSON("b" << 2))});
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(*merged, BSON("$max" << BSON("a" << 7) << "$min" << BSON("b" << 1)));
+}
+
+TEST(UpdateCombinerTest, MergeUnitesAddedValues) {
+    auto merged = UpdateCombiner::merge(
+        {BSON("$addToSet" << BSON("a" << 1)),
+         BSON("$addToSet" << BSON("a" << BSON("$each" << BSON_ARRAY(2 << 1 << 3)))),
+         BSON("$addToSet" << BSON("a" << 2))});
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(*merged,
+                      BSON("$addToSet" << BSON("a" << BSON("$each" << BSON_ARRAY(1 << 2 << 3)))));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -54,6 +54,7 @@
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/ops/parsed_delete.h"
 #include "mongo/db/ops/parsed_update.h"
+#include "mongo/db/ops/update_combiner.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/ops/write_ops_gen.h"
@@ -350,6 +351,10 @@ void insertDocuments(OperationContext* opCtx,
     wuow.commit();
 }
 
+// Ranges of a batch with at most this many documents are inserted one-at-a-time after failing to
+// insert them together, rather than split further.
+const std::ptrdiff_t kMinInsertRangeSizeToSplit = 16;
+
 /**
  * Returns true if caller should try to insert more documents. Does nothing else if batch is empty.
  */
@@ -402,69 +407,121 @@ bool insertBatchAndHandleErrors(OperationContext* opCtx,
             &hangWithLockDuringBatchInsert, opCtx, "hangWithLockDuringBatchInsert");
     };
 
+    // Returns false if the caller should not try to insert more documents.
+    auto insertOneAtATime = [&](std::vector<InsertStatement>::iterator begin,
+                                std::vector<InsertStatement>::iterator end) {
+        for (auto it = begin; it != end; ++it) {
+            globalOpCounters.gotInsert();
+            ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInsert(
+                opCtx->getWriteConcern());
+            try {
+                writeConflictRetry(opCtx, "insert", wholeOp.getNamespace().ns(), [&] {
+                    try {
+                        if (!collection)
+                            acquireCollection();
+                        lastOpFixer->startingOp();
+                        insertDocuments(
+                            opCtx, collection->getCollection(), it, it + 1, fromMigrate);
+                        lastOpFixer->finishedOpSuccessfully();
+                        SingleWriteResult result;
+                        result.setN(1);
+                        out->results.emplace_back(std::move(result));
+                        curOp.debug().additiveMetrics.incrementNinserted(1);
+                    } catch (...) {
+                        // Release the lock following any error if we are not in multi-statement
+                        // transaction. Among other things, this ensures that we don't sleep in the
+                        // WCE retry loop with the lock held.
+                        // If we are in multi-statement transaction and under a WUOW, we will
+                        // not actually release the lock.
+                        collection.reset();
+                        throw;
+                    }
+                });
+            } catch (const DBException& ex) {
+                bool canContinue = handleError(
+                    opCtx, ex, wholeOp.getNamespace(), wholeOp.getWriteCommandBase(), out);
+
+                if (!canContinue) {
+                    // Failed in ordered batch, or in a transaction, or from some unrecoverable
+                    // error.
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    // Inserting a range of the batch together is only possible outside of multi-statement
+    // transactions and for non-capped collections. See Collection::_insertDocuments for why we do
+    // all capped inserts one-at-a-time.
+    bool canInsertTogether = false;
     try {
         acquireCollection();
         auto txnParticipant = TransactionParticipant::get(opCtx);
         auto inTxn = txnParticipant && txnParticipant.inActiveOrKilledMultiDocumentTransaction();
-        if (!collection->getCollection()->isCapped() && !inTxn && batch.size() > 1) {
-            // First try doing it all together. If all goes well, this is all we need to do.
-            // See Collection::_insertDocuments for why we do all capped inserts one-at-a-time.
+        canInsertTogether = !collection->getCollection()->isCapped() && !inTxn;
+    } catch (const DBException&) {
+        // The loop below will handle reporting any non-transient errors.
+        collection.reset();
+    }
+
+    // Returns whether all documents in [begin, end) were inserted in a single storage transaction.
+    // Does not report any errors.
+    auto insertTogether = [&](std::vector<InsertStatement>::iterator begin,
+                              std::vector<InsertStatement>::iterator end) {
+        const auto count = std::distance(begin, end);
+        try {
+            if (!collection)
+                acquireCollection();
             lastOpFixer->startingOp();
-            insertDocuments(
-                opCtx, collection->getCollection(), batch.begin(), batch.end(), fromMigrate);
+            insertDocuments(opCtx, collection->getCollection(), begin, end, fromMigrate);
             lastOpFixer->finishedOpSuccessfully();
-            globalOpCounters.gotInserts(batch.size());
+            globalOpCounters.gotInserts(count);
             ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInserts(
-                opCtx->getWriteConcern(), batch.size());
+                opCtx->getWriteConcern(), count);
             SingleWriteResult result;
             result.setN(1);
 
-            std::fill_n(std::back_inserter(out->results), batch.size(), std::move(result));
-            curOp.debug().additiveMetrics.incrementNinserted(batch.size());
+            std::fill_n(std::back_inserter(out->results), count, std::move(result));
+            curOp.debug().additiveMetrics.incrementNinserted(count);
             return true;
+        } catch (const DBException&) {
+            // Ignore this failure and behave as if we never tried to do the combined insert.
+            collection.reset();
+            return false;
         }
-    } catch (const DBException&) {
-        // Ignore this failure and behave as if we never tried to do the combined batch
-        // insert. The loop below will handle reporting any non-transient errors.
-        collection.reset();
-    }
-
-    // Try to insert the batch one-at-a-time. This path is executed for singular batches,
-    // multi-statement transactions, capped collections, and if we failed all-at-once inserting.
-    for (auto it = batch.begin(); it != batch.end(); ++it) {
-        globalOpCounters.gotInsert();
-        ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForInsert(
-            opCtx->getWriteConcern());
-        try {
-            writeConflictRetry(opCtx, "insert", wholeOp.getNamespace().ns(), [&] {
-                try {
-                    if (!collection)
-                        acquireCollection();
-                    lastOpFixer->startingOp();
-                    insertDocuments(opCtx, collection->getCollection(), it, it + 1, fromMigrate);
-                    lastOpFixer->finishedOpSuccessfully();
-                    SingleWriteResult result;
-                    result.setN(1);
-                    out->results.emplace_back(std::move(result));
-                    curOp.debug().additiveMetrics.incrementNinserted(1);
-                } catch (...) {
-                    // Release the lock following any error if we are not in multi-statement
-                    // transaction. Among other things, this ensures that we don't sleep in the WCE
-                    // retry loop with the lock held.
-                    // If we are in multi-statement transaction and under a WUOW, we will
-                    // not actually release the lock.
-                    collection.reset();
-                    throw;
-                }
-            });
-        } catch (const DBException& ex) {
-            bool canContinue =
-                handleError(opCtx, ex, wholeOp.getNamespace(), wholeOp.getWriteCommandBase(), out);
+    };
 
-            if (!canContinue) {
-                // Failed in ordered batch, or in a transaction, or from some unrecoverable error.
-                return false;
+    // Ranges of the batch that remain to be inserted, with the next one at the back. First try
+    // doing it all together. If all goes well, this is all we need to do. Otherwise, split the
+    // failed range in two and try each half together, so that a few bad documents in a large batch
+    // only cost inserting their neighbours one-at-a-time. Ranges are inserted in order, which
+    // keeps the semantics of ordered inserts.
+    std::vector<std::pair<std::vector<InsertStatement>::iterator,
+                          std::vector<InsertStatement>::iterator>>
+        ranges{{batch.begin(), batch.end()}};
+    while (!ranges.empty()) {
+        const auto range = ranges.back();
+        ranges.pop_back();
+
+        const auto rangeSize = std::distance(range.first, range.second);
+        if (canInsertTogether && rangeSize > 1) {
+            if (insertTogether(range.first, range.second)) {
+                continue;
             }
+            if (rangeSize > kMinInsertRangeSizeToSplit) {
+                const auto middle = range.first + rangeSize / 2;
+                ranges.emplace_back(middle, range.second);
+                ranges.emplace_back(range.first, middle);
+                continue;
+            }
+        }
+
+        // Try to insert the range one-at-a-time. This path is executed for singular batches,
+        // multi-statement transactions, capped collections, and for small ranges we failed to
+        // insert together.
+        if (!insertOneAtATime(range.first, range.second)) {
+            return false;
         }
     }
 
@@ -682,18 +739,6 @@ static SingleWriteResult performSingleUpdateOpWithDupKeyRetry(OperationContext*
                                                               const NamespaceString& ns,
                                                               StmtId stmtId,
                                                               const write_ops::UpdateOpEntry& op) {
-    globalOpCounters.gotUpdate();
-    ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForUpdate(opCtx->getWriteConcern());
-    auto& curOp = *CurOp::get(opCtx);
-    {
-        stdx::lock_guard<Client> lk(*opCtx->getClient());
-        curOp.setNS_inlock(ns.ns());
-        curOp.setNetworkOp_inlock(dbUpdate);
-        curOp.setLogicalOp_inlock(LogicalOp::opUpdate);
-        curOp.setOpDescription_inlock(op.toBSON());
-        curOp.ensureStarted();
-    }
-
     auto txnParticipant = TransactionParticipant::get(opCtx);
     uassert(ErrorCodes::InvalidOptions,
             "Cannot use (or request) retryable writes with multi=true",
@@ -746,6 +791,60 @@ static SingleWriteResult performSingleUpdateOpWithDupKeyRetry(OperationContext*
     MONGO_UNREACHABLE;
 }
 
+/**
+ * Returns whether 'op' may be combined with concurrent updates of the same document of 'ns'.
+ */
+static bool isCombinableUpdate(OperationContext* opCtx,
+                               const NamespaceString& ns,
+                               const write_ops::UpdateOpEntry& op) {
+    // Look at the update itself first, so that only updates which could be combined pay for
+    // looking up the default collation of the collection.
+    if (!UpdateCombiner::isCombinable(op, nullptr)) {
+        return false;
+    }
+
+    AutoGetCollection autoColl(opCtx, ns, MODE_IS);
+    const auto collection = autoColl.getCollection();
+    return UpdateCombiner::isCombinable(op,
+                                        collection ? collection->getDefaultCollator() : nullptr);
+}
+
+/**
+ * Performs a single update of the client, combining it with concurrent updates of the same
+ * document by other clients when it is eligible.
+ */
+static SingleWriteResult performSingleUpdateOpOrCombine(OperationContext* opCtx,
+                                                        const NamespaceString& ns,
+                                                        StmtId stmtId,
+                                                        const write_ops::UpdateOpEntry& op) {
+    globalOpCounters.gotUpdate();
+    ServerWriteConcernMetrics::get(opCtx)->recordWriteConcernForUpdate(opCtx->getWriteConcern());
+    auto& curOp = *CurOp::get(opCtx);
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        curOp.setNS_inlock(ns.ns());
+        curOp.setNetworkOp_inlock(dbUpdate);
+        curOp.setLogicalOp_inlock(LogicalOp::opUpdate);
+        curOp.setOpDescription_inlock(op.toBSON());
+        curOp.ensureStarted();
+    }
+
+    // The combined update runs with the settings of the operation that performs it, so only
+    // combine updates that use the defaults.
+    const bool shouldCombine = internalUpdateCombineConcurrentUpdates.load() &&
+        !opCtx->getTxnNumber() && !documentValidationDisabled(opCtx) &&
+        !OperationShardingState::get(opCtx).hasShardVersion() &&
+        isCombinableUpdate(opCtx, ns, op);
+    if (!shouldCombine) {
+        return performSingleUpdateOpWithDupKeyRetry(opCtx, ns, stmtId, op);
+    }
+
+    return UpdateCombiner::get(opCtx->getServiceContext())
+        .update(opCtx, ns, op, [&](const write_ops::UpdateOpEntry& combinedOp) {
+            return performSingleUpdateOpWithDupKeyRetry(opCtx, ns, stmtId, combinedOp);
+        });
+}
+
 WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& wholeOp) {
     // Update performs its own retries, so we should not be in a WriteUnitOfWork unless run in a
     // transaction.
@@ -790,7 +889,7 @@ WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& who
         ON_BLOCK_EXIT([&] { finishCurOp(opCtx, &curOp); });
         try {
             lastOpFixer.startingOp();
-            out.results.emplace_back(performSingleUpdateOpWithDupKeyRetry(
+            out.results.emplace_back(performSingleUpdateOpOrCombine(
                 opCtx, wholeOp.getNamespace(), stmtId, singleOp));
             lastOpFixer.finishedOpSuccessfully();
         } catch (const DBException& ex) {
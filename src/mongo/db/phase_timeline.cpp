@@ -0,0 +1,64 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/phase_timeline.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+BSONArray PhaseTimeline::toBSON() const {
+    const auto count = _count.load(std::memory_order_acquire);
+    auto endTick = _endTick.load(std::memory_order_acquire);
+    if (!endTick)
+        endTick = _tickSource->getTicks();
+
+    BSONArrayBuilder builder;
+    const auto first = count > kCapacity ? count - kCapacity : 0;
+    for (auto i = first; i < count; ++i) {
+        const auto& event = _events[i % kCapacity];
+        const auto nextTick =
+            i + 1 < count ? _events[(i + 1) % kCapacity].tick.load(std::memory_order_relaxed)
+                          : endTick;
+        const auto ticks = nextTick - event.tick.load(std::memory_order_relaxed);
+        BSONObjBuilder phaseBuilder(builder.subobjStart());
+        phaseBuilder.append("phase", event.phase.load(std::memory_order_relaxed));
+        phaseBuilder.append("micros",
+                            durationCount<Microseconds>(_tickSource->ticksTo<Microseconds>(
+                                std::max<TickSource::Tick>(ticks, 0))));
+    }
+    return builder.arr();
+}
+
+}  // namespace mongo
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+/**
+ * Fixed-size ring buffer of timestamped phase events for a single operation, used to break the
+ * latency of an operation down by phase.
+ *
+ * Each call to record() marks the start of a named phase, which lasts until the next phase is
+ * recorded or until finish() is called. Only the last kCapacity phases are kept.
+ *
+ * record() and finish() may only be called by the thread executing the operation and never
+ * block, so they are cheap enough for hot paths. toBSON() may be called concurrently from other
+ * threads, e.g. by $currentOp. A concurrent reader sees every phase recorded before it started,
+ * but if the buffer wraps while it reads, the oldest phases it reports may be mixed up with newer
+ * ones.
+ */
+class PhaseTimeline {
+    MONGO_DISALLOW_COPYING(PhaseTimeline);
+
+public:
+    static constexpr std::size_t kCapacity = 32;
+
+    explicit PhaseTimeline(TickSource* tickSource) : _tickSource(tickSource) {}
+
+    /**
+     * Starts the phase named 'phase', ending the previous one. 'phase' must have static storage
+     * duration, such as a string literal.
+     */
+    void record(const char* phase) {
+        const auto n = _count.load(std::memory_order_relaxed);
+        auto& event = _events[n % kCapacity];
+        event.tick.store(_tickSource->getTicks(), std::memory_order_relaxed);
+        event.phase.store(phase, std::memory_order_relaxed);
+        _endTick.store(0, std::memory_order_relaxed);
+        _count.store(n + 1, std::memory_order_release);
+    }
+
+    /**
+     * Ends the current phase. Recording another phase afterwards reopens the timeline.
+     */
+    void finish() {
+        if (!empty())
+            _endTick.store(_tickSource->getTicks(), std::memory_order_release);
+    }
+
+    bool empty() const {
+        return _count.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * Returns an array of {phase: <name>, micros: <duration>} objects for the retained phases,
+     * oldest first. The duration of the last phase runs until finish() or, if the timeline is
+     * not finished, until now.
+     */
+    BSONArray toBSON() const;
+
+private:
+    struct Event {
+        std::atomic<const char*> phase{nullptr};  // NOLINT
+        std::atomic<TickSource::Tick> tick{0};    // NOLINT
+    };
+
+    TickSource* const _tickSource;
+    std::array<Event, kCapacity> _events;
+    std::atomic<std::uint32_t> _count{0};      // NOLINT
+    std::atomic<TickSource::Tick> _endTick{0};  // NOLINT
+};
+
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/phase_timeline.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/tick_source_mock.h"
+
+namespace mongo {
+namespace {
+
+TEST(PhaseTimelineTest, EmptyTimelineHasNoPhases) {
+    TickSourceMock<Microseconds> tickSource;
+    PhaseTimeline timeline(&tickSource);
+    ASSERT_TRUE(timeline.empty());
+    timeline.finish();
+    ASSERT_TRUE(timeline.empty());
+    ASSERT_BSONOBJ_EQ(timeline.toBSON(), BSONArray());
+}
+
+TEST(PhaseTimelineTest, ReportsDurationOfEachPhase) {
+    TickSourceMock<Microseconds> tickSource;
+    PhaseTimeline timeline(&tickSource);
+    timeline.record("first");
+    tickSource.advance(Microseconds{10});
+    timeline.record("second");
+    tickSource.advance(Microseconds{25});
+
+    // The last phase runs until now while the timeline is not finished.
+    ASSERT_BSONOBJ_EQ(timeline.toBSON(),
+                      BSON_ARRAY(BSON("phase"
+                                      << "first"
+                                      << "micros"
+                                      << 10)
+                                 << BSON("phase"
+                                         << "second"
+                                         << "micros"
+                                         << 25)));
+
+    timeline.finish();
+    tickSource.advance(Microseconds{100});
+    ASSERT_BSONOBJ_EQ(timeline.toBSON()[1].Obj(),
+                      BSON("phase"
+                           << "second"
+                           << "micros"
+                           << 25));
+}
+
+TEST(PhaseTimelineTest, KeepsOnlyTheMostRecentPhases) {
+    TickSourceMock<Microseconds> tickSource;
+    PhaseTimeline timeline(&tickSource);
+    const char* const phases[] = {"even", "odd"};
+    for (std::size_t i = 0; i < PhaseTimeline::kCapacity + 3; ++i) {
+        timeline.record(phases[i % 2]);
+        tickSource.advance(Microseconds{1});
+    }
+    timeline.finish();
+
+    auto phasesObj = timeline.toBSON();
+    ASSERT_EQ(static_cast<std::size_t>(phasesObj.nFields()), PhaseTimeline::kCapacity);
+    ASSERT_EQ(phasesObj.firstElement().Obj()["phase"].str(), "odd");
+    for (auto&& phase : phasesObj) {
+        ASSERT_EQ(phase.Obj()["micros"].numberLong(), 1);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -77,6 +77,13 @@ public:
         processInternal(input, merging);
     }
 
+    /**
+     * Processes the 'n' values of 'inputs' in order, as if each had been passed to process().
+     */
+    void processBatch(const Value* inputs, size_t n, bool merging) {
+        processBatchInternal(inputs, n, merging);
+    }
+
     /** Marks the end of the evaluate() phase and return accumulated result.
      *  toBeMerged should be true when the outputs will be merged by process().
      */
@@ -110,6 +117,13 @@ protected:
     /// Update subclass's internal state based on input
     virtual void processInternal(const Value& input, bool merging) = 0;
 
+    /// Subclasses which can process a batch of inputs more cheaply than one at a time override this
+    virtual void processBatchInternal(const Value* inputs, size_t n, bool merging) {
+        for (size_t i = 0; i < n; ++i) {
+            processInternal(inputs[i], merging);
+        }
+    }
+
     const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
         return _expCtx;
     }
@@ -210,6 +224,9 @@ public:
         return true;
     }
 
+protected:
+    void processBatchInternal(const Value* inputs, size_t n, bool merging) final;
+
 private:
     BSONType totalType = NumberInt;
     DoubleDoubleSummation nonDecimalTotal;
@@ -239,6 +256,9 @@ public:
         return true;
     }
 
+protected:
+    void processBatchInternal(const Value* inputs, size_t n, bool merging) final;
+
 private:
     Value _val;
     const Sense _sense;
@@ -290,6 +310,9 @@ public:
     static boost::intrusive_ptr<Accumulator> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
+protected:
+    void processBatchInternal(const Value* inputs, size_t n, bool merging) final;
+
 private:
     /**
      * The total of all values is partitioned between those that are decimals, and those that are
@@ -351,4 +374,89 @@ public:
 private:
     MutableDocument _output;
 };
+
+/**
+ * Estimates the number of distinct values it is given with a HyperLogLog sketch, using a fixed
+ * amount of memory however many values there are. Values are compared using the collation of the
+ * ExpressionContext. Until it has seen a few hundred distinct values the sketch keeps their hashes
+ * exactly, so small counts are exact unless two values share a hash.
+ */
+class AccumulatorApproxCountDistinct final : public Accumulator {
+public:
+    explicit AccumulatorApproxCountDistinct(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    void addHash(uint64_t hash);
+    void addToRegisters(uint64_t hash);
+    void convertToRegisters();
+    void updateMemUsage();
+
+    // The distinct hashes seen, until there are too many to keep, after which they are counted by
+    // '_registers' instead.
+    std::vector<uint64_t> _hashes;
+    std::vector<uint8_t> _registers;
+};
+
+/**
+ * Estimates percentiles of the numeric values it is given with a KLL quantile sketch, whose size
+ * grows only logarithmically with the number of values. The argument is an object of the form
+ * {input: <expression>, p: [<percentile>, ...]}, where each percentile is a number between 0 and 1,
+ * and the result is an array holding the estimate for each percentile.
+ */
+class AccumulatorApproxPercentile final : public Accumulator {
+public:
+    explicit AccumulatorApproxPercentile(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    void setPercentiles(const Value& percentiles);
+    void addValue(double value);
+    size_t capacity(size_t level) const;
+    void compress();
+    void updateMemUsage();
+
+    // The percentiles to estimate, as given by the first input.
+    Value _percentiles;
+
+    // An item at level h stands for 2^h of the values seen. '_numValues' is their total weight.
+    std::vector<std::vector<double>> _levels;
+    long long _numValues = 0;
+    size_t _numItems = 0;
+    double _min = 0;
+    double _max = 0;
+
+    // Alternates which half of a level survives each compaction.
+    unsigned _numCompactions = 0;
+};
 }
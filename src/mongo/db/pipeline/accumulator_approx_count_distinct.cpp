@@ -0,0 +1,201 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+using std::vector;
+
+REGISTER_ACCUMULATOR(approxCountDistinct, AccumulatorApproxCountDistinct::create);
+
+const char* AccumulatorApproxCountDistinct::getOpName() const {
+    return "$approxCountDistinct";
+}
+
+namespace {
+const char hashesName[] = "hashes";
+const char registersName[] = "registers";
+
+// The sketch has 2^kPrecision registers, for a standard error of about 1.6%.
+const int kPrecision = 12;
+const size_t kNumRegisters = size_t(1) << kPrecision;
+
+// Exact hashes are kept for as long as they take up no more memory than the registers would.
+const size_t kMaxHashes = kNumRegisters / sizeof(uint64_t);
+
+/**
+ * ValueComparator hashes are not uniformly distributed over their bits, as HyperLogLog requires,
+ * so they are passed through the 64-bit finalizer of MurmurHash3.
+ */
+uint64_t mixHash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+}  // namespace
+
+void AccumulatorApproxCountDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        if (!input.missing()) {
+            addHash(mixHash(getExpressionContext()->getValueComparator().hash(input)));
+            updateMemUsage();
+        }
+        return;
+    }
+
+    // We're merging a partial state produced by getValue(true), which holds either the exact
+    // hashes or the registers of another sketch.
+    verify(input.getType() == Object);
+    const Value hashes = input[hashesName];
+    if (!hashes.missing()) {
+        for (auto&& hash : hashes.getArray()) {
+            addHash(static_cast<uint64_t>(hash.getLong()));
+        }
+    } else {
+        const BSONBinData registers = input[registersName].getBinData();
+        verify(registers.length == static_cast<int>(kNumRegisters));
+        if (_registers.empty()) {
+            convertToRegisters();
+        }
+        const auto otherRegisters = static_cast<const uint8_t*>(registers.data);
+        for (size_t i = 0; i < kNumRegisters; ++i) {
+            _registers[i] = std::max(_registers[i], otherRegisters[i]);
+        }
+    }
+    updateMemUsage();
+}
+
+void AccumulatorApproxCountDistinct::addHash(uint64_t hash) {
+    if (!_registers.empty()) {
+        addToRegisters(hash);
+        return;
+    }
+
+    auto it = std::lower_bound(_hashes.begin(), _hashes.end(), hash);
+    if (it != _hashes.end() && *it == hash) {
+        return;
+    }
+    _hashes.insert(it, hash);
+    if (_hashes.size() > kMaxHashes) {
+        convertToRegisters();
+    }
+}
+
+void AccumulatorApproxCountDistinct::addToRegisters(uint64_t hash) {
+    // The first bits of the hash choose the register, which keeps the highest position of the
+    // first set bit among the rest.
+    const size_t index = hash >> (64 - kPrecision);
+    const uint64_t rest = hash << kPrecision;
+    const uint8_t rank = rest == 0 ? (64 - kPrecision + 1) : countLeadingZeros64(rest) + 1;
+    _registers[index] = std::max(_registers[index], rank);
+}
+
+void AccumulatorApproxCountDistinct::convertToRegisters() {
+    _registers.assign(kNumRegisters, 0);
+    for (auto&& hash : _hashes) {
+        addToRegisters(hash);
+    }
+    _hashes = vector<uint64_t>();
+}
+
+void AccumulatorApproxCountDistinct::updateMemUsage() {
+    _memUsageBytes = sizeof(*this) + _hashes.capacity() * sizeof(uint64_t) + _registers.size();
+}
+
+Value AccumulatorApproxCountDistinct::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        if (!_registers.empty()) {
+            return Value(
+                DOC(registersName << BSONBinData(
+                        _registers.data(), _registers.size(), BinDataGeneral)));
+        }
+
+        vector<Value> hashes;
+        hashes.reserve(_hashes.size());
+        for (auto&& hash : _hashes) {
+            hashes.push_back(Value(static_cast<long long>(hash)));
+        }
+        return Value(DOC(hashesName << Value(std::move(hashes))));
+    }
+
+    if (_registers.empty()) {
+        return Value(static_cast<long long>(_hashes.size()));
+    }
+
+    double sum = 0;
+    size_t numZeros = 0;
+    for (auto&& rank : _registers) {
+        sum += std::ldexp(1.0, -rank);
+        numZeros += rank == 0;
+    }
+
+    const double m = kNumRegisters;
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && numZeros > 0) {
+        // Small cardinalities are estimated more accurately by counting the empty registers.
+        estimate = m * std::log(m / numZeros);
+    }
+    return Value(std::llround(estimate));
+}
+
+AccumulatorApproxCountDistinct::AccumulatorApproxCountDistinct(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    _memUsageBytes = sizeof(*this);
+}
+
+void AccumulatorApproxCountDistinct::reset() {
+    _hashes = vector<uint64_t>();
+    _registers = vector<uint8_t>();
+    _memUsageBytes = sizeof(*this);
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxCountDistinct::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxCountDistinct(expCtx);
+}
+
+}  // namespace mongo
@@ -0,0 +1,291 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "mongo/db/pipeline/accumulator.h"
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+using std::vector;
+
+REGISTER_ACCUMULATOR(approxPercentile, AccumulatorApproxPercentile::create);
+
+const char* AccumulatorApproxPercentile::getOpName() const {
+    return "$approxPercentile";
+}
+
+namespace {
+const char inputName[] = "input";
+const char percentilesName[] = "p";
+const char numValuesName[] = "n";
+const char minName[] = "min";
+const char maxName[] = "max";
+const char levelsName[] = "levels";
+
+// The top level of the sketch holds up to kMaxCapacity items, and each level below it
+// kCapacityRatio times as many as the one above, down to kMinCapacity. This bounds the error in
+// the rank of an estimate to about 1% of the number of values.
+const size_t kMaxCapacity = 200;
+const double kCapacityRatio = 2.0 / 3.0;
+const size_t kMinCapacity = 8;
+}  // namespace
+
+void AccumulatorApproxPercentile::processInternal(const Value& input, bool merging) {
+    uassert(51125,
+            str::stream() << "$approxPercentile requires an object with '" << inputName
+                          << "' and '"
+                          << percentilesName
+                          << "' fields, found type "
+                          << typeName(input.getType()),
+            input.getType() == Object);
+
+    if (!merging) {
+        setPercentiles(input[percentilesName]);
+        const Value value = input[inputName];
+        if (value.numeric()) {
+            const double number = value.coerceToDouble();
+            if (!std::isnan(number)) {
+                addValue(number);
+                updateMemUsage();
+            }
+        }
+        return;
+    }
+
+    // We're merging a partial state produced by getValue(true).
+    const Value percentiles = input[percentilesName];
+    if (!percentiles.missing()) {
+        setPercentiles(percentiles);
+    }
+
+    const long long numValues = input[numValuesName].getLong();
+    if (numValues == 0) {
+        return;
+    }
+
+    const double min = input[minName].getDouble();
+    const double max = input[maxName].getDouble();
+    _min = _numValues == 0 ? min : std::min(_min, min);
+    _max = _numValues == 0 ? max : std::max(_max, max);
+    _numValues += numValues;
+
+    const vector<Value>& levels = input[levelsName].getArray();
+    if (_levels.size() < levels.size()) {
+        _levels.resize(levels.size());
+    }
+    for (size_t level = 0; level < levels.size(); ++level) {
+        for (auto&& item : levels[level].getArray()) {
+            _levels[level].push_back(item.getDouble());
+        }
+        _numItems += levels[level].getArray().size();
+    }
+    compress();
+    updateMemUsage();
+}
+
+void AccumulatorApproxPercentile::setPercentiles(const Value& percentiles) {
+    if (!_percentiles.missing()) {
+        uassert(51126,
+                str::stream() << "$approxPercentile requires the same '" << percentilesName
+                              << "' for every input, found "
+                              << percentiles.toString()
+                              << " and "
+                              << _percentiles.toString(),
+                ValueComparator().evaluate(_percentiles == percentiles));
+        return;
+    }
+
+    const bool isValid = percentiles.isArray() && !percentiles.getArray().empty() &&
+        std::all_of(percentiles.getArray().begin(),
+                    percentiles.getArray().end(),
+                    [](const Value& percentile) {
+                        return percentile.numeric() && percentile.coerceToDouble() >= 0 &&
+                            percentile.coerceToDouble() <= 1;
+                    });
+    uassert(51127,
+            str::stream() << "$approxPercentile requires '" << percentilesName
+                          << "' to be a non-empty array of numbers between 0 and 1, found "
+                          << percentiles.toString(),
+            isValid);
+    _percentiles = percentiles;
+}
+
+void AccumulatorApproxPercentile::addValue(double value) {
+    _min = _numValues == 0 ? value : std::min(_min, value);
+    _max = _numValues == 0 ? value : std::max(_max, value);
+    ++_numValues;
+
+    if (_levels.empty()) {
+        _levels.resize(1);
+    }
+    _levels[0].push_back(value);
+    ++_numItems;
+    compress();
+}
+
+size_t AccumulatorApproxPercentile::capacity(size_t level) const {
+    const size_t depth = _levels.size() - 1 - level;
+    const size_t levelCapacity =
+        static_cast<size_t>(std::ceil(kMaxCapacity * std::pow(kCapacityRatio, depth)));
+    return std::max(kMinCapacity, levelCapacity);
+}
+
+void AccumulatorApproxPercentile::compress() {
+    while (true) {
+        size_t totalCapacity = 0;
+        for (size_t level = 0; level < _levels.size(); ++level) {
+            totalCapacity += capacity(level);
+        }
+        if (_numItems <= totalCapacity) {
+            return;
+        }
+
+        // Compact the lowest level which is over its capacity: sort it, and promote every other
+        // item to the level above, where it stands for twice as many values. An odd item out stays
+        // behind, so that the total weight is unchanged.
+        size_t level = 0;
+        while (_levels[level].size() <= capacity(level)) {
+            ++level;
+        }
+        if (level + 1 == _levels.size()) {
+            _levels.emplace_back();
+        }
+
+        auto& items = _levels[level];
+        auto& promoted = _levels[level + 1];
+        std::sort(items.begin(), items.end());
+        const size_t first = items.size() % 2;
+        for (size_t i = first + _numCompactions % 2; i < items.size(); i += 2) {
+            promoted.push_back(items[i]);
+        }
+        _numItems -= (items.size() - first) / 2;
+        items.resize(first);
+        ++_numCompactions;
+    }
+}
+
+void AccumulatorApproxPercentile::updateMemUsage() {
+    _memUsageBytes = sizeof(*this) + _percentiles.getApproximateSize() +
+        _levels.capacity() * sizeof(vector<double>);
+    for (auto&& items : _levels) {
+        _memUsageBytes += items.capacity() * sizeof(double);
+    }
+}
+
+Value AccumulatorApproxPercentile::getValue(bool toBeMerged) {
+    if (toBeMerged) {
+        vector<Value> levels;
+        for (auto&& items : _levels) {
+            levels.push_back(Value(vector<Value>(items.begin(), items.end())));
+        }
+        return Value(DOC(percentilesName << _percentiles << numValuesName << _numValues << minName
+                                         << _min
+                                         << maxName
+                                         << _max
+                                         << levelsName
+                                         << Value(std::move(levels))));
+    }
+
+    if (_percentiles.missing()) {
+        return Value(BSONNULL);
+    }
+
+    // Each item stands for 2^level values, so the values at or below an item make up the sum of
+    // the weights of the items up to it in sorted order.
+    vector<std::pair<double, long long>> items;
+    items.reserve(_numItems);
+    for (size_t level = 0; level < _levels.size(); ++level) {
+        for (auto&& item : _levels[level]) {
+            items.emplace_back(item, 1LL << level);
+        }
+    }
+    std::sort(items.begin(), items.end());
+
+    vector<Value> estimates;
+    for (auto&& percentile : _percentiles.getArray()) {
+        if (_numValues == 0) {
+            estimates.push_back(Value(BSONNULL));
+            continue;
+        }
+
+        const double p = percentile.coerceToDouble();
+        const double rank = p * _numValues;
+        double estimate = _max;
+        if (p == 0) {
+            estimate = _min;
+        } else if (p < 1) {
+            long long weight = 0;
+            for (auto&& item : items) {
+                weight += item.second;
+                if (weight >= rank) {
+                    estimate = item.first;
+                    break;
+                }
+            }
+        }
+        estimates.push_back(Value(estimate));
+    }
+    return Value(std::move(estimates));
+}
+
+AccumulatorApproxPercentile::AccumulatorApproxPercentile(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx)
+    : Accumulator(expCtx) {
+    _memUsageBytes = sizeof(*this);
+}
+
+void AccumulatorApproxPercentile::reset() {
+    _percentiles = Value();
+    _levels = vector<vector<double>>();
+    _numValues = 0;
+    _numItems = 0;
+    _min = 0;
+    _max = 0;
+    _numCompactions = 0;
+    _memUsageBytes = sizeof(*this);
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxPercentile::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    return new AccumulatorApproxPercentile(expCtx);
+}
+
+}  // namespace mongo
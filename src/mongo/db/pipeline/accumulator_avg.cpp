@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/platform/decimal128.h"
+#include "mongo/platform/overflow_arithmetic.h"
 
 namespace mongo {
 
@@ -93,6 +94,38 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     _count++;
 }
 
+void AccumulatorAvg::processBatchInternal(const Value* inputs, size_t n, bool merging) {
+    if (merging) {
+        for (size_t i = 0; i < n; ++i) {
+            processInternal(inputs[i], true);
+        }
+        return;
+    }
+
+    // Integers are added to a native total for as long as it does not overflow, which gives the
+    // same result as adding each of them to '_nonDecimalTotal', since it adds integers exactly.
+    long long longTotal = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Value& input = inputs[i];
+        if (input.getType() != NumberInt && input.getType() != NumberLong) {
+            processInternal(input, false);
+            continue;
+        }
+
+        const long long value = input.coerceToLong();
+        long long newTotal;
+        if (mongoSignedAddOverflow64(longTotal, value, &newTotal)) {
+            _nonDecimalTotal.addLong(longTotal);
+            newTotal = value;
+        }
+        longTotal = newTotal;
+        _count++;
+    }
+    if (longTotal != 0) {
+        _nonDecimalTotal.addLong(longTotal);
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorAvg::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorAvg(expCtx);
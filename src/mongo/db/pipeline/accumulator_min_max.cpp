@@ -29,6 +29,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+
 #include "mongo/db/pipeline/accumulator.h"
 
 #include "mongo/db/pipeline/accumulation_statement.h"
@@ -62,6 +64,38 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorMinMax::processBatchInternal(const Value* inputs, size_t n, bool merging) {
+    for (size_t i = 0; i < n; ++i) {
+        const Value& input = inputs[i];
+
+        // A number of the same type as the current value is compared natively, rather than through
+        // the ValueComparator. NaN is left to the ValueComparator, since it sorts before all other
+        // numbers. Replacing the current value does not change the memory used, as neither value
+        // holds anything outside of itself.
+        const BSONType type = input.getType();
+        if (type == _val.getType()) {
+            if (type == NumberInt || type == NumberLong) {
+                const long long value = input.coerceToLong();
+                const long long current = _val.coerceToLong();
+                if (_sense == MIN ? value < current : value > current) {
+                    _val = input;
+                }
+                continue;
+            }
+            if (type == NumberDouble && !std::isnan(input.getDouble()) &&
+                !std::isnan(_val.getDouble())) {
+                if (_sense == MIN ? input.getDouble() < _val.getDouble()
+                                  : input.getDouble() > _val.getDouble()) {
+                    _val = input;
+                }
+                continue;
+            }
+        }
+
+        processInternal(input, merging);
+    }
+}
+
 Value AccumulatorMinMax::getValue(bool toBeMerged) {
     if (_val.missing()) {
         return Value(BSONNULL);
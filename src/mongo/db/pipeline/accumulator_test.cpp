@@ -67,6 +67,15 @@ static void assertExpectedResults(
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
 
+            // Asserts that result equals expected result when all input is processed as a batch.
+            {
+                boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
+                accum->processBatch(op.first.data(), op.first.size(), false);
+                Value result = accum->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
+
             // Asserts that result equals expected result when all input is on one shard.
             {
                 boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
@@ -403,4 +412,143 @@ TEST(AccumulatorMergeObjects, MergingWithEmptyDocumentShouldIgnore) {
 
 }  // namespace AccumulatorMergeObjects
 
+/* ------------------------- AccumulatorApproxCountDistinct -------------------------- */
+
+namespace AccumulatorApproxCountDistinct {
+
+TEST(AccumulatorApproxCountDistinct, CountsSmallNumbersOfValuesExactly) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    assertExpectedResults(
+        "$approxCountDistinct",
+        expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(0LL)},
+            // Missing values are ignored.
+            {{Value()}, Value(0LL)},
+            // Duplicates are counted once, and numbers which compare equal are duplicates.
+            {{Value(1), Value(1LL), Value(1.0), Value("a"_sd), Value("a"_sd), Value(BSONNULL)},
+             Value(3LL)},
+        });
+}
+
+TEST(AccumulatorApproxCountDistinct, RespectsCollation) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx->setCollator(&collator);
+    assertExpectedResults(
+        "$approxCountDistinct", expCtx, {{{Value("a"_sd), Value("b"_sd)}, Value(1LL)}});
+}
+
+TEST(AccumulatorApproxCountDistinct, EstimatesLargeNumbersOfValuesWhenMerged) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxCountDistinct");
+
+    // Each shard sees more values than are kept exactly, and half of them overlap with the next.
+    const int kNumShards = 4;
+    const int kValuesPerShard = 20000;
+    auto merger = factory(expCtx);
+    for (int shard = 0; shard < kNumShards; ++shard) {
+        auto accum = factory(expCtx);
+        for (int i = 0; i < kValuesPerShard; ++i) {
+            accum->process(Value(shard * kValuesPerShard / 2 + i), false);
+        }
+        merger->process(accum->getValue(true), true);
+    }
+
+    const double expected = (kNumShards + 1) * kValuesPerShard / 2;
+    const Value result = merger->getValue(false);
+    ASSERT_EQUALS(NumberLong, result.getType());
+    ASSERT_APPROX_EQUAL(expected, result.getLong(), expected * 0.05);
+}
+
+}  // namespace AccumulatorApproxCountDistinct
+
+/* ------------------------- AccumulatorApproxPercentile -------------------------- */
+
+namespace AccumulatorApproxPercentile {
+
+Value percentileInput(Value input) {
+    return Value(DOC("input" << input << "p" << BSON_ARRAY(0 << 0.5 << 1)));
+}
+
+TEST(AccumulatorApproxPercentile, ComputesSmallNumbersOfValuesExactly) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    assertExpectedResults(
+        "$approxPercentile",
+        expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(BSONNULL)},
+            // Only non-numeric values.
+            {{percentileInput(Value("a"_sd)), percentileInput(Value())},
+             Value(BSON_ARRAY(BSONNULL << BSONNULL << BSONNULL))},
+            // One value is every percentile.
+            {{percentileInput(Value(7))}, Value(BSON_ARRAY(7.0 << 7.0 << 7.0))},
+            // Non-numeric values are ignored.
+            {{percentileInput(Value(5)),
+              percentileInput(Value(2LL)),
+              percentileInput(Value("a"_sd)),
+              percentileInput(Value(4.0)),
+              percentileInput(Value(1)),
+              percentileInput(Value(3))},
+             Value(BSON_ARRAY(1.0 << 3.0 << 5.0))},
+        });
+}
+
+TEST(AccumulatorApproxPercentile, EstimatesLargeNumbersOfValuesWhenMerged) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+
+    // The shards see interleaved values, so that every shard covers the whole range.
+    const int kNumShards = 4;
+    const int kNumValues = 100000;
+    std::vector<intrusive_ptr<Accumulator>> shards;
+    for (int shard = 0; shard < kNumShards; ++shard) {
+        shards.push_back(factory(expCtx));
+    }
+    for (int i = 0; i < kNumValues; ++i) {
+        const int value = (i * 7919) % kNumValues;
+        shards[i % kNumShards]->process(
+            Value(DOC("input" << value << "p" << BSON_ARRAY(0.01 << 0.5 << 0.99))), false);
+    }
+
+    auto merger = factory(expCtx);
+    for (auto&& shard : shards) {
+        ASSERT_LT(shard->memUsageForSorter(), 64 * 1024);
+        merger->process(shard->getValue(true), true);
+    }
+
+    const Value result = merger->getValue(false);
+    ASSERT_EQUALS(Array, result.getType());
+    ASSERT_EQUALS(3U, result.getArray().size());
+    ASSERT_APPROX_EQUAL(0.01 * kNumValues, result[0].getDouble(), 0.02 * kNumValues);
+    ASSERT_APPROX_EQUAL(0.5 * kNumValues, result[1].getDouble(), 0.02 * kNumValues);
+    ASSERT_APPROX_EQUAL(0.99 * kNumValues, result[2].getDouble(), 0.02 * kNumValues);
+}
+
+TEST(AccumulatorApproxPercentile, RejectsInvalidArguments) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$approxPercentile");
+
+    ASSERT_THROWS_CODE(factory(expCtx)->process(Value(1), false), AssertionException, 51125);
+    ASSERT_THROWS_CODE(
+        factory(expCtx)->process(Value(DOC("input" << 1 << "p" << BSON_ARRAY(1.5))), false),
+        AssertionException,
+        51127);
+    ASSERT_THROWS_CODE(
+        factory(expCtx)->process(Value(DOC("input" << 1 << "p" << BSONArray())), false),
+        AssertionException,
+        51127);
+
+    auto accum = factory(expCtx);
+    accum->process(Value(DOC("input" << 1 << "p" << BSON_ARRAY(0.5))), false);
+    ASSERT_THROWS_CODE(
+        accum->process(Value(DOC("input" << 1 << "p" << BSON_ARRAY(0.9))), false),
+        AssertionException,
+        51126);
+}
+
+}  // namespace AccumulatorApproxPercentile
+
 }  // namespace AccumulatorTests
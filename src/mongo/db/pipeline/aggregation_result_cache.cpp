@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+#include <iterator>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+const auto aggregationResultCache = ServiceContext::declareDecoration<AggregationResultCache>();
+
+}  // namespace
+
+AggregationResultCache& AggregationResultCache::get(ServiceContext* serviceContext) {
+    return aggregationResultCache(serviceContext);
+}
+
+AggregationResultCache& AggregationResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+uint64_t AggregationResultCache::getWriteVersion(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _isTrackingWrites.store(true);
+    return _writeVersions[nss.ns()];
+}
+
+void AggregationResultCache::notifyOfWrite(const NamespaceString& nss) {
+    if (!isTrackingWrites()) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _writeVersions.find(nss.ns());
+    if (it != _writeVersions.end()) {
+        ++it->second;
+    }
+}
+
+void AggregationResultCache::notifyOfWriteToDatabase(StringData dbName) {
+    if (!isTrackingWrites()) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& version : _writeVersions) {
+        if (nsToDatabaseSubstring(version.first) == dbName) {
+            ++version.second;
+        }
+    }
+}
+
+void AggregationResultCache::invalidateAll() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& version : _writeVersions) {
+        ++version.second;
+    }
+    _entries.clear();
+    _bytesUsed = 0;
+}
+
+bool AggregationResultCache::lookup(const std::string& key, std::vector<BSONObj>* results) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Entry* entry;
+    if (!_entries.get(key, &entry).isOK()) {
+        return false;
+    }
+    *results = entry->results;
+    return true;
+}
+
+void AggregationResultCache::insert(const std::string& key, std::vector<BSONObj> results) {
+    auto entry = std::make_unique<Entry>();
+    entry->bytes = key.size();
+    for (auto&& result : results) {
+        entry->bytes += result.objsize();
+    }
+
+    const size_t maxEntryBytes = internalQueryAggregationResultCacheMaxEntryBytes.load();
+    const size_t maxBytes = internalQueryAggregationResultCacheMaxMemoryBytes.load();
+    if (entry->bytes > maxEntryBytes || entry->bytes > maxBytes) {
+        return;
+    }
+    entry->results = std::move(results);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    // Another aggregation may have cached the same results while this one ran.
+    Entry* existing;
+    if (_entries.get(key, &existing).isOK()) {
+        return;
+    }
+
+    _bytesUsed += entry->bytes;
+    if (auto evicted = _entries.add(key, entry.release())) {
+        _bytesUsed -= evicted->bytes;
+    }
+    _evictIfNeeded(lk, maxBytes);
+}
+
+void AggregationResultCache::_evictIfNeeded(WithLock, size_t maxBytes) {
+    while (_bytesUsed > maxBytes && _entries.size() > 0) {
+        auto leastRecentlyUsed = std::prev(_entries.end());
+        _bytesUsed -= leastRecentlyUsed->second->bytes;
+        // Copy the key, since removing the entry destroys the list node which holds it.
+        const std::string key = leastRecentlyUsed->first;
+        _entries.remove(key).transitional_ignore();
+    }
+}
+
+size_t AggregationResultCache::numEntries() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+size_t AggregationResultCache::bytesUsed() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _bytesUsed;
+}
+
+}  // namespace mongo
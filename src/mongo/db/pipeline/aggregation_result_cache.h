@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A cache of the results of aggregations, for deployments which send the same aggregate command
+ * over and over against collections which change rarely.
+ *
+ * Every namespace which an aggregation has been cached against has a write version, which the
+ * AggregationResultCacheOpObserver increments whenever a write to the namespace commits. Callers
+ * read the write version of the collection before opening the storage snapshot they run the
+ * aggregation in, and build it into the key they cache the results under, so that any write which
+ * the snapshot may have missed makes the entry unreachable. Entries are evicted in least recently
+ * used order once the results held exceed internalQueryAggregationResultCacheMaxMemoryBytes.
+ *
+ * This class is thread-safe.
+ */
+class AggregationResultCache {
+    MONGO_DISALLOW_COPYING(AggregationResultCache);
+
+public:
+    static AggregationResultCache& get(ServiceContext* serviceContext);
+    static AggregationResultCache& get(OperationContext* opCtx);
+
+    AggregationResultCache() = default;
+
+    /**
+     * Returns the current write version of 'nss', and starts tracking writes to 'nss' if they were
+     * not tracked already.
+     */
+    uint64_t getWriteVersion(const NamespaceString& nss);
+
+    /**
+     * Returns true if writes to any namespace are being tracked. Until an aggregation has asked for
+     * a write version there is nothing to invalidate, and writes need not take the mutex.
+     */
+    bool isTrackingWrites() const {
+        return _isTrackingWrites.load();
+    }
+
+    /**
+     * Increments the write version of 'nss', making every entry cached against 'nss' unreachable.
+     */
+    void notifyOfWrite(const NamespaceString& nss);
+
+    /**
+     * Increments the write version of every namespace in database 'dbName'.
+     */
+    void notifyOfWriteToDatabase(StringData dbName);
+
+    /**
+     * Drops every entry and increments the write version of every namespace. Used when writes may
+     * have been undone, such as by a replication rollback.
+     */
+    void invalidateAll();
+
+    /**
+     * Looks up the results cached under 'key', copying them into 'results' and returning true if
+     * they were found.
+     */
+    bool lookup(const std::string& key, std::vector<BSONObj>* results);
+
+    /**
+     * Caches 'results' under 'key', evicting the least recently used entries if the cache has grown
+     * beyond its memory budget. The results are not cached if they are larger than
+     * internalQueryAggregationResultCacheMaxEntryBytes.
+     */
+    void insert(const std::string& key, std::vector<BSONObj> results);
+
+    /**
+     * Returns the number of entries in the cache, and the number of bytes their results use.
+     */
+    size_t numEntries() const;
+    size_t bytesUsed() const;
+
+private:
+    struct Entry {
+        std::vector<BSONObj> results;
+        size_t bytes = 0;
+    };
+
+    // The count limit for '_entries' is only a backstop; entries are evicted by size.
+    static constexpr size_t kMaxEntries = 100 * 1000;
+
+    void _evictIfNeeded(WithLock, size_t maxBytes);
+
+    AtomicWord<bool> _isTrackingWrites{false};
+
+    mutable stdx::mutex _mutex;
+
+    // The write version of every namespace which has been asked for, keyed by the full namespace.
+    StringMap<uint64_t> _writeVersions;
+
+    LRUKeyValue<std::string, Entry> _entries{kMaxEntries};
+    size_t _bytesUsed = 0;
+};
+
+}  // namespace mongo
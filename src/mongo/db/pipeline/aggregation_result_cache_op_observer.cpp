@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache_op_observer.h"
+
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Increments the write version of 'nss' once the current WriteUnitOfWork commits, or immediately
+ * if there is none. The version must not change before the write is visible, or an aggregation
+ * could read the new version and then cache results from a snapshot which misses the write.
+ */
+void notifyOfWriteOnCommit(OperationContext* opCtx, const NamespaceString& nss) {
+    auto serviceContext = opCtx->getServiceContext();
+    if (!opCtx->lockState()->inAWriteUnitOfWork()) {
+        AggregationResultCache::get(serviceContext).notifyOfWrite(nss);
+        return;
+    }
+
+    // The callback must be registered even when no writes are tracked yet. Otherwise an
+    // aggregation which starts tracking 'nss' before this write commits could cache results
+    // which miss it.
+    opCtx->recoveryUnit()->onCommit([serviceContext, nss](boost::optional<Timestamp>) {
+        AggregationResultCache::get(serviceContext).notifyOfWrite(nss);
+    });
+}
+
+void notifyOfWriteToDatabaseOnCommit(OperationContext* opCtx, const std::string& dbName) {
+    auto serviceContext = opCtx->getServiceContext();
+    if (!opCtx->lockState()->inAWriteUnitOfWork()) {
+        AggregationResultCache::get(serviceContext).notifyOfWriteToDatabase(dbName);
+        return;
+    }
+
+    opCtx->recoveryUnit()->onCommit([serviceContext, dbName](boost::optional<Timestamp>) {
+        AggregationResultCache::get(serviceContext).notifyOfWriteToDatabase(dbName);
+    });
+}
+
+}  // namespace
+
+AggregationResultCacheOpObserver::AggregationResultCacheOpObserver() = default;
+
+AggregationResultCacheOpObserver::~AggregationResultCacheOpObserver() = default;
+
+void AggregationResultCacheOpObserver::onInserts(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 OptionalCollectionUUID uuid,
+                                                 std::vector<InsertStatement>::const_iterator first,
+                                                 std::vector<InsertStatement>::const_iterator last,
+                                                 bool fromMigrate) {
+    notifyOfWriteOnCommit(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onUpdate(OperationContext* opCtx,
+                                                const OplogUpdateEntryArgs& args) {
+    notifyOfWriteOnCommit(opCtx, args.nss);
+}
+
+void AggregationResultCacheOpObserver::onDelete(OperationContext* opCtx,
+                                                const NamespaceString& nss,
+                                                OptionalCollectionUUID uuid,
+                                                StmtId stmtId,
+                                                bool fromMigrate,
+                                                const boost::optional<BSONObj>& deletedDoc) {
+    notifyOfWriteOnCommit(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onCreateCollection(OperationContext* opCtx,
+                                                          Collection* coll,
+                                                          const NamespaceString& collectionName,
+                                                          const CollectionOptions& options,
+                                                          const BSONObj& idIndex,
+                                                          const OplogSlot& createOpTime) {
+    notifyOfWriteOnCommit(opCtx, collectionName);
+}
+
+void AggregationResultCacheOpObserver::onCollMod(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 OptionalCollectionUUID uuid,
+                                                 const BSONObj& collModCmd,
+                                                 const CollectionOptions& oldCollOptions,
+                                                 boost::optional<TTLCollModInfo> ttlInfo) {
+    notifyOfWriteOnCommit(opCtx, nss);
+}
+
+void AggregationResultCacheOpObserver::onDropDatabase(OperationContext* opCtx,
+                                                      const std::string& dbName) {
+    notifyOfWriteToDatabaseOnCommit(opCtx, dbName);
+}
+
+repl::OpTime AggregationResultCacheOpObserver::onDropCollection(
+    OperationContext* opCtx,
+    const NamespaceString& collectionName,
+    OptionalCollectionUUID uuid,
+    std::uint64_t numRecords,
+    const CollectionDropType dropType) {
+    notifyOfWriteOnCommit(opCtx, collectionName);
+    return {};
+}
+
+void AggregationResultCacheOpObserver::postRenameCollection(OperationContext* const opCtx,
+                                                            const NamespaceString& fromCollection,
+                                                            const NamespaceString& toCollection,
+                                                            OptionalCollectionUUID uuid,
+                                                            OptionalCollectionUUID dropTargetUUID,
+                                                            bool stayTemp) {
+    notifyOfWriteOnCommit(opCtx, fromCollection);
+    notifyOfWriteOnCommit(opCtx, toCollection);
+}
+
+void AggregationResultCacheOpObserver::onRenameCollection(OperationContext* const opCtx,
+                                                          const NamespaceString& fromCollection,
+                                                          const NamespaceString& toCollection,
+                                                          OptionalCollectionUUID uuid,
+                                                          OptionalCollectionUUID dropTargetUUID,
+                                                          std::uint64_t numRecords,
+                                                          bool stayTemp) {
+    postRenameCollection(opCtx, fromCollection, toCollection, uuid, dropTargetUUID, stayTemp);
+}
+
+void AggregationResultCacheOpObserver::onApplyOps(OperationContext* opCtx,
+                                                  const std::string& dbName,
+                                                  const BSONObj& applyOpCmd) {
+    notifyOfWriteToDatabaseOnCommit(opCtx, dbName);
+}
+
+void AggregationResultCacheOpObserver::onEmptyCapped(OperationContext* opCtx,
+                                                     const NamespaceString& collectionName,
+                                                     OptionalCollectionUUID uuid) {
+    notifyOfWriteOnCommit(opCtx, collectionName);
+}
+
+void AggregationResultCacheOpObserver::onReplicationRollback(OperationContext* opCtx,
+                                                             const RollbackObserverInfo& rbInfo) {
+    AggregationResultCache::get(opCtx->getServiceContext()).invalidateAll();
+}
+
+}  // namespace mongo
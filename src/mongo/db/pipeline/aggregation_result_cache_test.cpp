@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/aggregation_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kTestNss("test.coll");
+
+std::vector<BSONObj> makeResults(int numResults, int padding = 0) {
+    std::vector<BSONObj> results;
+    for (int i = 0; i < numResults; ++i) {
+        results.push_back(BSON("_id" << i << "padding" << std::string(padding, 'x')));
+    }
+    return results;
+}
+
+TEST(AggregationResultCacheTest, LookupReturnsInsertedResults) {
+    AggregationResultCache cache;
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(cache.lookup("key", &results));
+
+    cache.insert("key", makeResults(3));
+    ASSERT_TRUE(cache.lookup("key", &results));
+    ASSERT_EQ(results.size(), 3U);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_BSONOBJ_EQ(results[i], makeResults(3)[i]);
+    }
+    ASSERT_EQ(cache.numEntries(), 1U);
+    ASSERT_FALSE(cache.lookup("otherKey", &results));
+}
+
+TEST(AggregationResultCacheTest, WritesOnlyIncrementTheVersionOfTrackedNamespaces) {
+    AggregationResultCache cache;
+    ASSERT_FALSE(cache.isTrackingWrites());
+    cache.notifyOfWrite(kTestNss);
+
+    ASSERT_EQ(cache.getWriteVersion(kTestNss), 0U);
+    ASSERT_TRUE(cache.isTrackingWrites());
+
+    cache.notifyOfWrite(kTestNss);
+    cache.notifyOfWrite(NamespaceString("test.other"));
+    ASSERT_EQ(cache.getWriteVersion(kTestNss), 1U);
+    ASSERT_EQ(cache.getWriteVersion(NamespaceString("test.other")), 0U);
+}
+
+TEST(AggregationResultCacheTest, WritesToDatabaseIncrementTheVersionOfItsNamespaces) {
+    AggregationResultCache cache;
+    const NamespaceString otherDbNss("testother.coll");
+    ASSERT_EQ(cache.getWriteVersion(kTestNss), 0U);
+    ASSERT_EQ(cache.getWriteVersion(otherDbNss), 0U);
+
+    cache.notifyOfWriteToDatabase("test");
+    ASSERT_EQ(cache.getWriteVersion(kTestNss), 1U);
+    ASSERT_EQ(cache.getWriteVersion(otherDbNss), 0U);
+}
+
+TEST(AggregationResultCacheTest, InvalidateAllDropsEntriesAndIncrementsVersions) {
+    AggregationResultCache cache;
+    ASSERT_EQ(cache.getWriteVersion(kTestNss), 0U);
+    cache.insert("key", makeResults(3));
+
+    cache.invalidateAll();
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(cache.lookup("key", &results));
+    ASSERT_EQ(cache.numEntries(), 0U);
+    ASSERT_EQ(cache.bytesUsed(), 0U);
+    ASSERT_EQ(cache.getWriteVersion(kTestNss), 1U);
+}
+
+TEST(AggregationResultCacheTest, EvictsLeastRecentlyUsedEntriesWhenOverMemoryBudget) {
+    const auto oldMaxBytes = internalQueryAggregationResultCacheMaxMemoryBytes.load();
+    internalQueryAggregationResultCacheMaxMemoryBytes.store(3 * 1024);
+    ON_BLOCK_EXIT([&] { internalQueryAggregationResultCacheMaxMemoryBytes.store(oldMaxBytes); });
+
+    // Each entry takes a little over 1KB, so the cache holds two of them.
+    AggregationResultCache cache;
+    cache.insert("a", makeResults(1, 1024));
+    cache.insert("b", makeResults(1, 1024));
+
+    std::vector<BSONObj> results;
+    ASSERT_TRUE(cache.lookup("a", &results));
+
+    cache.insert("c", makeResults(1, 1024));
+    ASSERT_EQ(cache.numEntries(), 2U);
+    ASSERT_LTE(cache.bytesUsed(), 3U * 1024);
+    ASSERT_TRUE(cache.lookup("a", &results));
+    ASSERT_FALSE(cache.lookup("b", &results));
+    ASSERT_TRUE(cache.lookup("c", &results));
+}
+
+TEST(AggregationResultCacheTest, DoesNotCacheResultsLargerThanMaxEntryBytes) {
+    const auto oldMaxEntryBytes = internalQueryAggregationResultCacheMaxEntryBytes.load();
+    internalQueryAggregationResultCacheMaxEntryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalQueryAggregationResultCacheMaxEntryBytes.store(oldMaxEntryBytes); });
+
+    AggregationResultCache cache;
+    cache.insert("large", makeResults(1, 1024));
+    cache.insert("small", makeResults(1));
+
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(cache.lookup("large", &results));
+    ASSERT_TRUE(cache.lookup("small", &results));
+    ASSERT_EQ(cache.numEntries(), 1U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -52,7 +52,7 @@ const std::vector<StringData> Document::allMetadataFieldNames = {Document::metaF
                                                                  Document::metaFieldGeoNearDistance,
                                                                  Document::metaFieldGeoNearPoint};
 
-Position DocumentStorage::findField(StringData requested) const {
+Position DocumentStorage::findFieldInBuffer(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -69,7 +69,7 @@ Position DocumentStorage::findField(StringData requested) const {
             pos = elem.nextCollision;
         }
     } else {  // linear scan
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = bufferIteratorAll(); !it.atEnd(); it.advance()) {
             if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                 return it.position();
             }
@@ -80,7 +80,7 @@ Position DocumentStorage::findField(StringData requested) const {
     return Position();
 }
 
-Value& DocumentStorage::appendField(StringData name) {
+Value& DocumentStorage::appendFieldToBuffer(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
 
@@ -189,7 +189,44 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
     _bufferEnd = _buffer + newSize;
 }
 
+void DocumentStorage::setBackingBson(BSONObj bson) {
+    invariant(!_buffer);
+    invariant(bson.isOwned());
+    _bson = std::move(bson);
+    _nextLazyField = _bson.isEmpty() ? nullptr : _bson.firstElement().rawdata();
+}
+
+Position DocumentStorage::loadNextLazyField() const {
+    auto self = const_cast<DocumentStorage*>(this);
+
+    const BSONElement elem(_nextLazyField);
+    const BSONElement nextElem(_nextLazyField + elem.size());
+    self->_nextLazyField = nextElem.eoo() ? nullptr : nextElem.rawdata();
+
+    const Position pos = getNextPosition();
+    self->appendFieldToBuffer(elem.fieldNameStringData()) = Value(elem);
+    return pos;
+}
+
+Position DocumentStorage::findLazyField(StringData name) const {
+    while (_nextLazyField) {
+        const Position pos = loadNextLazyField();
+        if (getField(pos).nameSD() == name) {
+            return pos;
+        }
+    }
+    return Position();
+}
+
+void DocumentStorage::loadAllLazyFields() const {
+    while (_nextLazyField) {
+        loadNextLazyField();
+    }
+}
+
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+    // The clone is made to be modified, so it is not given the backing BSON.
+    loadLazyFields();
     auto out = make_intrusive<DocumentStorage>();
 
     if (_buffer) {
@@ -233,7 +270,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 DocumentStorage::~DocumentStorage() {
     std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
 
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = bufferIteratorAll(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
 }
@@ -274,12 +311,25 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // An unmodified top-level document is already stored as BSON. Nested documents are still
+    // converted field by field, so that their depth is checked.
+    const BSONObj& backingBson = storage().unmodifiedBackingBson();
+    if (recursionLevel == 1 && !backingBson.isEmpty()) {
+        builder->appendElements(backingBson);
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
 }
 
 BSONObj Document::toBson() const {
+    const BSONObj& backingBson = storage().unmodifiedBackingBson();
+    if (!backingBson.isEmpty()) {
+        return backingBson;
+    }
+
     BSONObjBuilder bb;
     toBson(&bb);
     return bb.obj();
@@ -308,6 +358,17 @@ BSONObj Document::toBsonWithMetaData() const {
 }
 
 Document Document::fromBsonWithMetaData(const BSONObj& bson) {
+    // Metadata fields can only appear at the top level, and their names start with '$'. Without
+    // any such field, the fields are converted only as they are needed.
+    if (!bson.isEmpty() &&
+        std::none_of(bson.begin(), bson.end(), [](const BSONElement& elem) {
+            return elem.fieldNameStringData()[0] == '$';
+        })) {
+        auto storage = make_intrusive<DocumentStorage>();
+        storage->setBackingBson(bson.getOwned());
+        return Document(std::move(storage));
+    }
+
     MutableDocument md;
 
     BSONObjIterator it(bson);
@@ -419,6 +480,16 @@ size_t Document::getApproximateSize() const {
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
 
+    // The backing BSON is kept alongside the converted fields. Rather than converting any
+    // remaining fields to measure them, count them as part of it.
+    const BSONObj& backingBson = storage().unmodifiedBackingBson();
+    if (!backingBson.isEmpty()) {
+        size += backingBson.objsize();
+        if (storage().hasLazyFields()) {
+            return size;
+        }
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
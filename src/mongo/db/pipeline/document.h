@@ -140,6 +140,24 @@ public:
     const Value getNestedField(const FieldPath& path,
                                std::vector<Position>* positions = nullptr) const;
 
+    /**
+     * Converts any fields of this document which are still only held as BSON. Reading a document
+     * may otherwise modify it, so this must be called before the document is shared between
+     * threads.
+     */
+    void loadLazyFields() const {
+        storage().loadLazyFields();
+    }
+
+    /**
+     * Returns the BSON this document was created from by fromBsonWithMetaData() if none of its
+     * fields have been modified since, or an empty BSONObj otherwise. The BSON does not include
+     * any metadata of the document.
+     */
+    const BSONObj& getUnmodifiedBackingBson() const {
+        return storage().unmodifiedBackingBson();
+    }
+
     /// Number of fields in this document. O(n)
     size_t size() const {
         return storage().size();
@@ -224,7 +224,10 @@ public:
     }
 
     /// Returns the position of the named field (may be missing) or Position()
-    Position findField(StringData name) const;
+    Position findField(StringData name) const {
+        loadLazyFields();
+        return findFieldInBuffer(name);
+    }
 
     // Document uses these
     const ValueElement& getField(Position pos) const {
@@ -232,7 +235,9 @@ public:
         return *(_firstElement->plusBytes(pos.index));
     }
     Value getField(StringData name) const {
-        Position pos = findField(name);
+        Position pos = findFieldInBuffer(name);
+        if (!pos.found() && MONGO_unlikely(_nextLazyField != nullptr))
+            pos = findLazyField(name);
         if (!pos.found())
             return Value();
         return getField(pos).val;
@@ -240,18 +245,53 @@ public:
 
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
+        prepareForModification();
         verify(pos.found());
         return *(_firstElement->plusBytes(pos.index));
     }
     Value& getField(StringData name) {
-        Position pos = findField(name);
+        prepareForModification();
+        Position pos = findFieldInBuffer(name);
         if (!pos.found())
-            return appendField(name);  // TODO: find a way to avoid hashing name twice
+            return appendFieldToBuffer(name);  // TODO: find a way to avoid hashing name twice
         return getField(pos).val;
     }
 
     /// Adds a new field with missing Value at the end of the document
-    Value& appendField(StringData name);
+    Value& appendField(StringData name) {
+        prepareForModification();
+        return appendFieldToBuffer(name);
+    }
+
+    /**
+     * Backs this storage with 'bson', whose fields are then converted to Values lazily and in
+     * order, as far as is needed to find each field looked up by name. Anything that needs every
+     * field, such as iterating, addressing fields by Position or modifying them, converts the rest
+     * first. The storage must be empty, and 'bson' must be owned and free of metadata fields.
+     *
+     * Converting a field modifies the storage, so lazily converted storage must only be read by one
+     * thread at a time. To that end it is converted in full whenever its document is put in a
+     * Value, and only top-level documents are left partly converted.
+     */
+    void setBackingBson(BSONObj bson);
+
+    /// Converts any fields not yet converted from the backing BSON.
+    void loadLazyFields() const {
+        if (MONGO_unlikely(_nextLazyField != nullptr))
+            loadAllLazyFields();
+    }
+
+    bool hasLazyFields() const {
+        return _nextLazyField != nullptr;
+    }
+
+    /**
+     * Returns the BSON this storage was created from by setBackingBson() if none of the fields have
+     * been modified since, or an empty BSONObj otherwise.
+     */
+    const BSONObj& unmodifiedBackingBson() const {
+        return _bson;
+    }
 
     /** Preallocates space for fields. Use this to attempt to prevent buffer growth.
      *  This is only valid to call before anything is added to the document.
@@ -260,12 +300,14 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadLazyFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
-        return DocumentStorageIterator(_firstElement, end(), true);
+        loadLazyFields();
+        return bufferIteratorAll();
     }
 
     /// Shallow copy of this. Caller owns memory.
@@ -353,6 +395,35 @@ public:
     }
 
 private:
+    /// Like iteratorAll(), but only over the fields already converted to Values.
+    DocumentStorageIterator bufferIteratorAll() const {
+        return DocumentStorageIterator(_firstElement, end(), true);
+    }
+
+    /// Like findField(), but only among the fields already converted to Values.
+    Position findFieldInBuffer(StringData name) const;
+
+    /// Like appendField(), but leaves the backing BSON in place.
+    Value& appendFieldToBuffer(StringData name);
+
+    /**
+     * Converts the next field of the backing BSON and returns its position. Only the lazily
+     * converted fields are changed, so this is allowed on const storage.
+     */
+    Position loadNextLazyField() const;
+
+    /// Converts fields of the backing BSON until one named 'name' is found, or none are left.
+    Position findLazyField(StringData name) const;
+
+    void loadAllLazyFields() const;
+
+    /// Converts all fields and drops the backing BSON, which no longer matches once modified.
+    void prepareForModification() {
+        loadLazyFields();
+        if (MONGO_unlikely(!_bson.isEmpty()))
+            _bson = BSONObj();
+    }
+
     /// Same as lastElement->next() or firstElement() if empty.
     const ValueElement* end() const {
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
@@ -396,7 +467,7 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+        for (DocumentStorageIterator it = bufferIteratorAll(); !it.atEnd(); it.advance())
             addFieldToHashTable(it.position());
     }
 
@@ -438,6 +509,11 @@ private:
     Value _geoNearPoint;
     // When adding a field, make sure to update clone() method
 
+    // The BSON the fields are lazily converted from, and the next of its elements to convert, or
+    // nullptr once they all have been. See setBackingBson().
+    BSONObj _bson;
+    const char* _nextLazyField = nullptr;
+
     // Defined in document.cpp
     static const DocumentStorage kEmptyDoc;
 };
@@ -35,6 +35,7 @@
 #include "mongo/db/bson/bson_helper.h"
 #include "mongo/db/commands/feature_compatibility_version_documentation.h"
 #include "mongo/db/logical_clock.h"
+#include "mongo/db/matcher/expression_path.h"
 #include "mongo/db/pipeline/change_stream_constants.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source_change_stream_close_cursor.h"
@@ -103,8 +104,8 @@ static constexpr StringData kOplogMatchExplainName = "$_internalOplogMatch"_sd;
 }  // namespace
 
 intrusive_ptr<DocumentSourceOplogMatch> DocumentSourceOplogMatch::create(
-    BSONObj filter, const intrusive_ptr<ExpressionContext>& expCtx) {
-    return new DocumentSourceOplogMatch(std::move(filter), expCtx);
+    const intrusive_ptr<ExpressionContext>& expCtx, Timestamp startFrom, bool startFromInclusive) {
+    return new DocumentSourceOplogMatch(expCtx, startFrom, startFromInclusive);
 }
 
 const char* DocumentSourceOplogMatch::getSourceName() const {
@@ -137,9 +138,269 @@ Value DocumentSourceOplogMatch::serialize(optional<ExplainOptions::Verbosity> ex
     return Value();
 }
 
-DocumentSourceOplogMatch::DocumentSourceOplogMatch(BSONObj filter,
-                                                   const intrusive_ptr<ExpressionContext>& expCtx)
-    : DocumentSourceMatch(std::move(filter), expCtx) {}
+DocumentSourceOplogMatch::DocumentSourceOplogMatch(const intrusive_ptr<ExpressionContext>& expCtx,
+                                                   Timestamp startFrom,
+                                                   bool startFromInclusive)
+    : DocumentSourceMatch(
+          DocumentSourceChangeStream::buildMatchFilter(expCtx, startFrom, startFromInclusive),
+          expCtx),
+      _startFrom(startFrom),
+      _startFromInclusive(startFromInclusive) {}
+
+//
+// Helpers for pushing user filters on change events down into the oplog filter.
+//
+namespace {
+
+const StringData kDocumentKeyIdPath = "documentKey._id"_sd;
+
+/**
+ * Returns true if every path referenced by 'expr' is 'prefix' or a subpath of it, and each of them
+ * belongs to a PathMatchExpression whose path can be renamed. The children of an $elemMatch are
+ * relative to its path, so they are not examined.
+ */
+bool allPathsUnder(const MatchExpression* expr, StringData prefix) {
+    if (expr->getCategory() == MatchExpression::MatchCategory::kLogical) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            if (!allPathsUnder(expr->getChild(i), prefix)) {
+                return false;
+            }
+        }
+        return expr->numChildren() > 0;
+    }
+    if (!dynamic_cast<const PathMatchExpression*>(expr)) {
+        return false;
+    }
+    auto path = expr->path();
+    return path == prefix || (path.startsWith(prefix) && path[prefix.size()] == '.');
+}
+
+/**
+ * Serializes 'expr' with the 'from' prefix of each path replaced by 'to'. Must only be called on
+ * expressions for which allPathsUnder(expr, from) is true.
+ */
+BSONObj serializeWithRenamedPaths(const MatchExpression* expr, StringData from, StringData to) {
+    const StringMap<std::string> renames{{from.toString(), to.toString()}};
+    auto clone = expr->shallowClone();
+    std::vector<MatchExpression*> pending{clone.get()};
+    while (!pending.empty()) {
+        auto node = pending.back();
+        pending.pop_back();
+        if (node->getCategory() == MatchExpression::MatchCategory::kLogical) {
+            for (size_t i = 0; i < node->numChildren(); ++i) {
+                pending.push_back(node->getChild(i));
+            }
+        } else {
+            static_cast<PathMatchExpression*>(node)->applyRename(renames);
+        }
+    }
+    BSONObjBuilder bob;
+    clone->serialize(&bob);
+    return bob.obj();
+}
+
+BSONObj andOf(const std::vector<BSONObj>& clauses) {
+    invariant(!clauses.empty());
+    if (clauses.size() == 1) {
+        return clauses.front();
+    }
+    BSONArrayBuilder arr;
+    for (auto&& clause : clauses) {
+        arr.append(clause);
+    }
+    return BSON("$and" << arr.arr());
+}
+
+BSONObj orOf(const std::vector<BSONObj>& clauses) {
+    if (clauses.empty()) {
+        return BSON("$alwaysFalse" << 1);
+    }
+    if (clauses.size() == 1) {
+        return clauses.front();
+    }
+    BSONArrayBuilder arr;
+    for (auto&& clause : clauses) {
+        arr.append(clause);
+    }
+    return BSON("$or" << arr.arr());
+}
+
+// Predicates selecting the oplog entries which produce each type of CRUD change event. Updates and
+// replacements are both 'u' entries, told apart by whether the 'o' field holds a full document.
+BSONObj insertEntryFilter() {
+    return BSON("op"
+                << "i");
+}
+
+BSONObj deleteEntryFilter() {
+    return BSON("op"
+                << "d");
+}
+
+BSONObj updateEntryFilter() {
+    return BSON("op"
+                << "u"
+                << "o._id"
+                << BSON("$exists" << false));
+}
+
+BSONObj replaceEntryFilter() {
+    return BSON("op"
+                << "u"
+                << "o._id"
+                << BSON("$exists" << true));
+}
+
+/**
+ * Returns a predicate on raw oplog entries which holds for every insert, update, replace or delete
+ * entry that can produce a change event matching 'expr', or boost::none if no useful predicate
+ * can be derived. The result is only ever a superset of the entries of interest, so 'expr' must
+ * still be applied to the change events themselves.
+ *
+ * Predicates on 'fullDocument' and 'documentKey._id' compare user data, which must be done using
+ * the pipeline's collation; they are only rewritten when 'collatorIsSimple' is true, since the
+ * oplog scan always uses the simple collation. Predicates on 'operationType' are evaluated here
+ * against each event type, so they may be rewritten regardless of the collation.
+ */
+boost::optional<BSONObj> rewriteEventFilterForOplog(const MatchExpression* expr,
+                                                    bool collatorIsSimple,
+                                                    bool lookupPostImage) {
+    if (allPathsUnder(expr, DocumentSourceChangeStream::kOperationTypeField)) {
+        const std::vector<std::pair<StringData, BSONObj>> eventTypes{
+            {DocumentSourceChangeStream::kInsertOpType, insertEntryFilter()},
+            {DocumentSourceChangeStream::kUpdateOpType, updateEntryFilter()},
+            {DocumentSourceChangeStream::kReplaceOpType, replaceEntryFilter()},
+            {DocumentSourceChangeStream::kDeleteOpType, deleteEntryFilter()}};
+        std::vector<BSONObj> matchingTypes;
+        for (auto&& eventType : eventTypes) {
+            if (expr->matchesBSON(
+                    BSON(DocumentSourceChangeStream::kOperationTypeField << eventType.first))) {
+                matchingTypes.push_back(eventType.second);
+            }
+        }
+        if (matchingTypes.size() == eventTypes.size()) {
+            return boost::none;
+        }
+        return orOf(matchingTypes);
+    }
+
+    if (collatorIsSimple && allPathsUnder(expr, DocumentSourceChangeStream::kFullDocumentField)) {
+        // Inserts and replacements carry the full document in 'o'. Deletes have no 'fullDocument',
+        // and neither do updates unless the post-image is looked up, in which case it is unknown
+        // until then.
+        auto renamed = serializeWithRenamedPaths(expr,
+                                                 DocumentSourceChangeStream::kFullDocumentField,
+                                                 repl::OplogEntry::kObjectFieldName);
+        const bool matchesMissing = expr->matchesBSON(BSONObj());
+        std::vector<BSONObj> clauses{andOf({insertEntryFilter(), renamed}),
+                                     andOf({replaceEntryFilter(), renamed})};
+        if (lookupPostImage || matchesMissing) {
+            clauses.push_back(updateEntryFilter());
+        }
+        if (matchesMissing) {
+            clauses.push_back(deleteEntryFilter());
+        }
+        return orOf(clauses);
+    }
+
+    if (collatorIsSimple && allPathsUnder(expr, kDocumentKeyIdPath)) {
+        // Inserts and deletes carry the _id in 'o', while updates and replacements carry it in
+        // 'o2'.
+        return orOf({andOf({BSON("op" << BSON("$in" << BSON_ARRAY("i"
+                                                                   << "d"))),
+                            serializeWithRenamedPaths(expr, kDocumentKeyIdPath, "o._id")}),
+                     andOf({BSON("op"
+                                 << "u"),
+                            serializeWithRenamedPaths(expr, kDocumentKeyIdPath, "o2._id")})});
+    }
+
+    switch (expr->matchType()) {
+        case MatchExpression::AND: {
+            // Any event matching the $and matches each of its children, so the rewritable
+            // children can be kept and the rest dropped.
+            std::vector<BSONObj> clauses;
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (auto clause = rewriteEventFilterForOplog(
+                        expr->getChild(i), collatorIsSimple, lookupPostImage)) {
+                    clauses.push_back(std::move(*clause));
+                }
+            }
+            if (clauses.empty()) {
+                return boost::none;
+            }
+            return andOf(clauses);
+        }
+        case MatchExpression::OR: {
+            // An event matching the $or may match any one of its children, so every child must be
+            // rewritable.
+            std::vector<BSONObj> clauses;
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                auto clause = rewriteEventFilterForOplog(
+                    expr->getChild(i), collatorIsSimple, lookupPostImage);
+                if (!clause) {
+                    return boost::none;
+                }
+                clauses.push_back(std::move(*clause));
+            }
+            return orOf(clauses);
+        }
+        default:
+            return boost::none;
+    }
+}
+}  // namespace
+
+Pipeline::SourceContainer::iterator DocumentSourceOplogMatch::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    if (_pushedDownEventFilters) {
+        return std::next(itr);
+    }
+    _pushedDownEventFilters = true;
+
+    // Skip over the rest of the stages generated by $changeStream, noting whether the post-image
+    // of updates will be looked up.
+    bool lookupPostImage = false;
+    auto stageItr = std::next(itr);
+    while (stageItr != container->end() && (*stageItr)->constraints().isChangeStreamStage()) {
+        lookupPostImage = lookupPostImage ||
+            dynamic_cast<DocumentSourceLookupChangePostImage*>(stageItr->get());
+        ++stageItr;
+    }
+
+    std::vector<BSONObj> eventFilters;
+    for (; stageItr != container->end(); ++stageItr) {
+        auto userMatch = dynamic_cast<DocumentSourceMatch*>(stageItr->get());
+        if (!userMatch) {
+            break;
+        }
+        // Optimizing the filter rewrites any $expr into an equivalent match expression where
+        // possible, which gives us more predicates to work with.
+        auto optimized =
+            MatchExpression::optimize(userMatch->getMatchExpression()->shallowClone());
+        if (auto eventFilter = rewriteEventFilterForOplog(
+                optimized.get(), !pExpCtx->getCollator(), lookupPostImage)) {
+            eventFilters.push_back(std::move(*eventFilter));
+        }
+    }
+
+    if (!eventFilters.empty()) {
+        // Only CRUD entries are restricted. Commands must always be seen so that invalidations are
+        // still reported, and the entry we are resuming from must be seen so that the resume
+        // token can be verified.
+        BSONArrayBuilder clauses;
+        clauses.append(BSON("op" << BSON("$nin" << BSON_ARRAY("i"
+                                                              << "u"
+                                                              << "d"))));
+        if (_startFromInclusive) {
+            clauses.append(BSON("ts" << _startFrom));
+        }
+        clauses.append(andOf(eventFilters));
+        joinMatchWith(DocumentSourceMatch::create(BSON("$or" << clauses.arr()), pExpCtx));
+    }
+    return std::next(itr);
+}
 
 void DocumentSourceChangeStream::checkValueType(const Value v,
                                                 const StringData filedName,
@@ -350,9 +611,7 @@ list<intrusive_ptr<DocumentSource>> buildPipeline(const intrusive_ptr<Expression
 
     if (startFrom) {
         const bool startFromInclusive = (resumeStage != nullptr);
-        stages.push_back(DocumentSourceOplogMatch::create(
-            DocumentSourceChangeStream::buildMatchFilter(expCtx, *startFrom, startFromInclusive),
-            expCtx));
+        stages.push_back(DocumentSourceOplogMatch::create(expCtx, *startFrom, startFromInclusive));
 
         // If we haven't already populated the initial PBRT, then we are starting from a specific
         // timestamp rather than a resume token. Initialize the PBRT to a high water mark token.
@@ -213,8 +213,14 @@ private:
  */
 class DocumentSourceOplogMatch final : public DocumentSourceMatch {
 public:
+    /**
+     * Creates a $match on the oplog entries which may produce events for the change stream on
+     * 'expCtx', at or after 'startFrom' if 'startFromInclusive' is true and after it otherwise.
+     */
     static boost::intrusive_ptr<DocumentSourceOplogMatch> create(
-        BSONObj filter, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        Timestamp startFrom,
+        bool startFromInclusive);
 
     const char* getSourceName() const final;
 
@@ -230,8 +236,35 @@ public:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
 
+    /**
+     * Derives predicates on the raw oplog entries from any user $match stages which directly
+     * follow the change stream stages, and adds them to this filter so that oplog entries which
+     * cannot produce a matching event are discarded before being transformed. The user's $match
+     * stages are left in place, since the derived predicates only narrow the set of CRUD entries
+     * and never exclude entries that would have produced a matching event.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+    Timestamp getStartFrom() const {
+        return _startFrom;
+    }
+
+    bool isStartFromInclusive() const {
+        return _startFromInclusive;
+    }
+
 private:
-    DocumentSourceOplogMatch(BSONObj filter, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+    DocumentSourceOplogMatch(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                             Timestamp startFrom,
+                             bool startFromInclusive);
+
+    const Timestamp _startFrom;
+    const bool _startFromInclusive;
+
+    // Set once the user's filters have been pushed into this stage, so that optimizing the pipeline
+    // again does not add the same predicates twice.
+    bool _pushedDownEventFilters = false;
 };
 
 }  // namespace mongo
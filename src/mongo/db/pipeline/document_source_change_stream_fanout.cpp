@@ -0,0 +1,532 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_change_stream_fanout.h"
+
+#include "mongo/db/db_raii.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_change_stream_gen.h"
+#include "mongo/db/pipeline/document_source_change_stream_transform.h"
+#include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+const auto changeStreamFanoutRegistry =
+    ServiceContext::declareDecoration<ChangeStreamFanoutRegistry>();
+
+/**
+ * Returns true if an event at 'clusterTime' comes after 'startFrom', or is at 'startFrom' and
+ * 'startFromInclusive' is true.
+ */
+bool isAtOrAfterStart(Timestamp clusterTime, Timestamp startFrom, bool startFromInclusive) {
+    return clusterTime > startFrom || (startFromInclusive && clusterTime == startFrom);
+}
+
+Timestamp getClusterTime(const Document& event) {
+    return event[DocumentSourceChangeStream::kClusterTimeField].getTimestamp();
+}
+
+}  // namespace
+
+ChangeStreamFanout::ChangeStreamFanout(std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+                                       Timestamp startFrom,
+                                       bool startFromInclusive)
+    : _pipeline(std::move(pipeline)),
+      _coveredFrom(startFrom),
+      _coveredFromInclusive(startFromInclusive) {}
+
+bool ChangeStreamFanout::_covers(WithLock, Timestamp startFrom, bool startFromInclusive) const {
+    if (startFrom != _coveredFrom) {
+        return startFrom > _coveredFrom;
+    }
+    return _coveredFromInclusive || !startFromInclusive;
+}
+
+boost::optional<ChangeStreamFanout::SubscriberId> ChangeStreamFanout::subscribe(
+    Timestamp startFrom, bool startFromInclusive) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_closed || _failed || !_covers(lk, startFrom, startFromInclusive)) {
+        return boost::none;
+    }
+
+    const auto id = _nextSubscriberId++;
+    Subscriber subscriber;
+    subscriber.position = _basePosition;
+    subscriber.startFrom = startFrom;
+    subscriber.startFromInclusive = startFromInclusive;
+    _subscribers.emplace(id, subscriber);
+    return id;
+}
+
+bool ChangeStreamFanout::unsubscribe(SubscriberId id) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_subscribers.erase(id) == 1);
+    if (!_subscribers.empty()) {
+        return false;
+    }
+
+    _closed = true;
+    _events.clear();
+    return true;
+}
+
+boost::optional<Document> ChangeStreamFanout::_nextBufferedEvent(WithLock,
+                                                                 Subscriber* subscriber,
+                                                                 Timestamp* latestOplogTimestamp) {
+    while (subscriber->position < _basePosition + _events.size()) {
+        const auto& event = _events[subscriber->position++ - _basePosition];
+        if (!subscriber->reachedStartFrom) {
+            if (!isAtOrAfterStart(
+                    event.clusterTime, subscriber->startFrom, subscriber->startFromInclusive)) {
+                continue;
+            }
+            subscriber->reachedStartFrom = true;
+        }
+        *latestOplogTimestamp = event.latestOplogTimestamp;
+        return event.document;
+    }
+    return boost::none;
+}
+
+boost::optional<DocumentSource::GetNextResult> ChangeStreamFanout::getNext(
+    OperationContext* opCtx, SubscriberId id, Timestamp* latestOplogTimestamp) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto& subscriber = _subscribers.at(id);
+    while (true) {
+        if (_failed || subscriber.position < _basePosition) {
+            return boost::none;
+        }
+
+        if (auto event = _nextBufferedEvent(lk, &subscriber, latestOplogTimestamp)) {
+            return DocumentSource::GetNextResult(std::move(*event));
+        }
+
+        // This subscriber has consumed every buffered event, so it must run the shared pipeline
+        // itself unless another subscriber is already doing so. Either way, by the time it holds
+        // '_driveMutex' there may be new events in the buffer.
+        lk.unlock();
+        stdx::lock_guard<stdx::mutex> driveLk(_driveMutex);
+        lk.lock();
+        if (_failed || subscriber.position < _basePosition + _events.size()) {
+            continue;
+        }
+
+        _trimBuffer(lk);
+        lk.unlock();
+        const bool reachedEOF = _drive(opCtx);
+        lk.lock();
+
+        if (auto event = _nextBufferedEvent(lk, &subscriber, latestOplogTimestamp)) {
+            return DocumentSource::GetNextResult(std::move(*event));
+        }
+
+        if (reachedEOF) {
+            // Every event up to the latest oplog time the pipeline has scanned has been returned
+            // to this subscriber, or was before its starting point.
+            *latestOplogTimestamp = _latestOplogTimestamp;
+            return DocumentSource::GetNextResult::makeEOF();
+        }
+    }
+}
+
+bool ChangeStreamFanout::_drive(OperationContext* opCtx) {
+    const size_t maxBufferedEvents = internalQueryChangeStreamFanoutMaxBufferedEvents.load();
+
+    _pipeline->reattachToOperationContext(opCtx);
+    ON_BLOCK_EXIT([&] { _pipeline->detachFromOperationContext(); });
+    try {
+        while (auto next = _pipeline->getNext()) {
+            // Reading the event's fields may convert them from BSON, so finish doing so before the
+            // event is shared with other threads.
+            next->loadLazyFields();
+
+            Event event;
+            event.clusterTime = getClusterTime(*next);
+            event.latestOplogTimestamp = PipelineD::getLatestOplogTimestamp(_pipeline.get());
+            event.document = std::move(*next);
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _latestOplogTimestamp = event.latestOplogTimestamp;
+            _events.push_back(std::move(event));
+            if (_events.size() >= maxBufferedEvents) {
+                return false;
+            }
+        }
+
+        const auto latestOplogTimestamp = PipelineD::getLatestOplogTimestamp(_pipeline.get());
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _latestOplogTimestamp = std::max(_latestOplogTimestamp, latestOplogTimestamp);
+        return true;
+    } catch (const DBException& ex) {
+        // The pipeline may have been left part way through an event, so it cannot be used again.
+        // The other subscribers continue on pipelines of their own.
+        LOG(1) << "Shared change stream pipeline failed: " << redact(ex.toStatus());
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _failed = true;
+        throw;
+    }
+}
+
+void ChangeStreamFanout::_trimBuffer(WithLock lk) {
+    uint64_t minPosition = _basePosition + _events.size();
+    for (auto&& subscriber : _subscribers) {
+        minPosition = std::min(minPosition, subscriber.second.position);
+    }
+    while (_basePosition < minPosition) {
+        _popFront(lk);
+    }
+
+    // Make room for at least one new event. Subscribers which had yet to consume the events
+    // discarded here will find that they can no longer be served.
+    const size_t maxBufferedEvents = internalQueryChangeStreamFanoutMaxBufferedEvents.load();
+    while (!_events.empty() && _events.size() >= maxBufferedEvents) {
+        _popFront(lk);
+    }
+}
+
+void ChangeStreamFanout::_popFront(WithLock) {
+    // Other events may share the discarded event's clusterTime, so the fanout can still serve
+    // subscribers starting after that time, but no longer those starting at it.
+    _coveredFrom = _events.front().clusterTime;
+    _coveredFromInclusive = false;
+    _events.pop_front();
+    ++_basePosition;
+}
+
+void ChangeStreamFanout::dispose(OperationContext* opCtx) {
+    stdx::lock_guard<stdx::mutex> driveLk(_driveMutex);
+    invariant(_closed);
+    if (_pipeline) {
+        _pipeline->dispose(opCtx);
+        _pipeline.get_deleter().dismissDisposal();
+        _pipeline.reset();
+    }
+}
+
+size_t ChangeStreamFanout::numSubscribers() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _subscribers.size();
+}
+
+size_t ChangeStreamFanout::numBufferedEvents() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _events.size();
+}
+
+ChangeStreamFanoutRegistry& ChangeStreamFanoutRegistry::get(ServiceContext* serviceContext) {
+    return changeStreamFanoutRegistry(serviceContext);
+}
+
+std::pair<std::shared_ptr<ChangeStreamFanout>, ChangeStreamFanout::SubscriberId>
+ChangeStreamFanoutRegistry::subscribe(const std::string& key,
+                                      Timestamp startFrom,
+                                      bool startFromInclusive,
+                                      const PipelineFactory& makePipeline) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto range = _fanouts.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (auto id = it->second->subscribe(startFrom, startFromInclusive)) {
+                return {it->second, *id};
+            }
+        }
+    }
+
+    // Building the pipeline opens a cursor on the oplog, so do so without holding '_mutex'. If
+    // another stream does the same meanwhile, there will briefly be two fanouts for 'key'.
+    auto fanout = std::make_shared<ChangeStreamFanout>(
+        makePipeline(), startFrom, startFromInclusive);
+    auto id = fanout->subscribe(startFrom, startFromInclusive);
+    invariant(id);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fanouts.emplace(key, fanout);
+    return {std::move(fanout), *id};
+}
+
+void ChangeStreamFanoutRegistry::unsubscribe(OperationContext* opCtx,
+                                             const std::string& key,
+                                             const std::shared_ptr<ChangeStreamFanout>& fanout,
+                                             ChangeStreamFanout::SubscriberId id) {
+    if (!fanout->unsubscribe(id)) {
+        return;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto range = _fanouts.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == fanout) {
+                _fanouts.erase(it);
+                break;
+            }
+        }
+    }
+    fanout->dispose(opCtx);
+}
+
+size_t ChangeStreamFanoutRegistry::numFanouts() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _fanouts.size();
+}
+
+bool DocumentSourceChangeStreamFanoutConsumer::substituteIfShareable(Pipeline* pipeline) {
+    if (!internalQueryEnableChangeStreamFanout.load()) {
+        return false;
+    }
+
+    // Streams which are merged by mongos, or which run on a shard, must also report events such
+    // as the detection of a new shard, so only streams on a plain replica set are shared.
+    const auto& expCtx = pipeline->getContext();
+    if (expCtx->inMongos || expCtx->needsMerge || expCtx->fromMongos || expCtx->explain ||
+        serverGlobalParams.clusterRole != ClusterRole::None) {
+        return false;
+    }
+
+    const auto& sources = pipeline->getSources();
+    if (sources.size() < 2) {
+        return false;
+    }
+    auto oplogMatch = dynamic_cast<DocumentSourceOplogMatch*>(sources.front().get());
+    auto transform =
+        dynamic_cast<DocumentSourceChangeStreamTransform*>(std::next(sources.begin())->get());
+    if (!oplogMatch || !transform) {
+        return false;
+    }
+
+    // A resume token whose document key includes a shard key primes the transformation with the
+    // fields of that key, so the transformation would differ from that of other streams.
+    const auto& changeStreamSpec = transform->getChangeStreamSpec();
+    auto spec = DocumentSourceChangeStreamSpec::parse(IDLParserErrorContext("$changeStream"),
+                                                      changeStreamSpec);
+    if (auto resumeToken = spec.getResumeAfter() ? spec.getResumeAfter() : spec.getStartAfter()) {
+        auto documentKey = resumeToken->getData().documentKey;
+        if (documentKey.getType() == BSONType::Object && documentKey.getDocument().size() > 1) {
+            return false;
+        }
+    }
+
+    // Streams share a fanout if they differ only in their starting point, and in whether they look
+    // up the full document, which happens after the transformation.
+    BSONObjBuilder transformSpecBuilder;
+    for (auto&& elem : changeStreamSpec) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName != DocumentSourceChangeStreamSpec::kResumeAfterFieldName &&
+            fieldName != DocumentSourceChangeStreamSpec::kStartAfterFieldName &&
+            fieldName != DocumentSourceChangeStreamSpec::kStartAtOperationTimeFieldName &&
+            fieldName != DocumentSourceChangeStreamSpec::kFullDocumentFieldName) {
+            transformSpecBuilder.append(elem);
+        }
+    }
+    BSONObj transformSpec = transformSpecBuilder.obj();
+    const auto fcv = transform->getFeatureCompatibilityVersion();
+    std::string key = str::stream() << expCtx->ns.ns() << '|' << static_cast<int>(fcv) << '|'
+                                    << transformSpec.toString();
+
+    boost::intrusive_ptr<DocumentSourceChangeStreamFanoutConsumer> consumer(
+        new DocumentSourceChangeStreamFanoutConsumer(expCtx,
+                                                     fcv,
+                                                     changeStreamSpec,
+                                                     std::move(transformSpec),
+                                                     std::move(key),
+                                                     oplogMatch->getStartFrom(),
+                                                     oplogMatch->isStartFromInclusive()));
+    pipeline->popFront();
+    pipeline->popFront();
+    pipeline->addInitialSource(std::move(consumer));
+    return true;
+}
+
+DocumentSourceChangeStreamFanoutConsumer::DocumentSourceChangeStreamFanoutConsumer(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    ServerGlobalParams::FeatureCompatibility::Version fcv,
+    BSONObj changeStreamSpec,
+    BSONObj transformSpec,
+    std::string key,
+    Timestamp startFrom,
+    bool startFromInclusive)
+    : DocumentSource(expCtx),
+      _fcv(fcv),
+      _changeStreamSpec(changeStreamSpec.getOwned()),
+      _transformSpec(transformSpec.getOwned()),
+      _key(std::move(key)),
+      _startFrom(startFrom),
+      _startFromInclusive(startFromInclusive) {}
+
+const char* DocumentSourceChangeStreamFanoutConsumer::getSourceName() const {
+    return DocumentSourceChangeStream::kStageName.rawData();
+}
+
+StageConstraints DocumentSourceChangeStreamFanoutConsumer::constraints(
+    Pipeline::SplitState pipeState) const {
+    StageConstraints constraints(StreamType::kStreaming,
+                                 PositionRequirement::kFirst,
+                                 HostTypeRequirement::kAnyShard,
+                                 DiskUseRequirement::kNoDiskUse,
+                                 FacetRequirement::kNotAllowed,
+                                 TransactionRequirement::kNotAllowed,
+                                 ChangeStreamRequirement::kChangeStreamStage);
+    constraints.isIndependentOfAnyCollection = pExpCtx->ns.isCollectionlessAggregateNS();
+    constraints.requiresInputDocSource = false;
+    return constraints;
+}
+
+Value DocumentSourceChangeStreamFanoutConsumer::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(Document{{getSourceName(), Document(_changeStreamSpec)}});
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceChangeStreamFanoutConsumer::_makePipeline(
+    Timestamp startFrom, bool startFromInclusive) const {
+    // The oplog must be matched with the simple collation. A shared pipeline also outlives this
+    // stream, so it gets an ExpressionContext of its own either way.
+    auto expCtx = pExpCtx->copyWith(
+        pExpCtx->ns, boost::none, std::unique_ptr<CollatorInterface>(nullptr));
+    expCtx->tailableMode = TailableModeEnum::kTailableAndAwaitData;
+
+    Pipeline::SourceContainer stages{
+        DocumentSourceOplogMatch::create(expCtx, startFrom, startFromInclusive),
+        DocumentSourceChangeStreamTransform::create(expCtx, _fcv, _transformSpec)};
+    auto pipeline = uassertStatusOK(Pipeline::create(std::move(stages), expCtx));
+    {
+        AutoGetCollectionForRead autoColl(expCtx->opCtx, NamespaceString::kRsOplogNamespace);
+        PipelineD::prepareCursorSource(
+            autoColl.getCollection(), NamespaceString::kRsOplogNamespace, nullptr, pipeline.get());
+    }
+    pipeline->optimizePipeline();
+    return pipeline;
+}
+
+DocumentSource::GetNextResult DocumentSourceChangeStreamFanoutConsumer::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_ownPipeline) {
+        return _getNextFromOwnPipeline();
+    }
+
+    if (!_fanout) {
+        std::tie(_fanout, _subscriberId) =
+            ChangeStreamFanoutRegistry::get(pExpCtx->opCtx->getServiceContext())
+                .subscribe(_key, _startFrom, _startFromInclusive, [&] {
+                    auto pipeline = _makePipeline(_startFrom, _startFromInclusive);
+                    pipeline->detachFromOperationContext();
+                    return pipeline;
+                });
+    }
+
+    if (auto next = _fanout->getNext(pExpCtx->opCtx, _subscriberId, &_latestOplogTimestamp)) {
+        if (next->isAdvanced()) {
+            _recordReturned(next->getDocument());
+        }
+        return std::move(*next);
+    }
+
+    // The fanout can no longer serve this stream. Carry on from the last event returned, which
+    // the oplog still holds unless the stream has fallen behind by more than the oplog's length.
+    _unsubscribe();
+    if (_lastClusterTime) {
+        _ownPipeline = _makePipeline(*_lastClusterTime, true);
+        _numToSkip = _numReturnedAtLastClusterTime;
+    } else {
+        _ownPipeline = _makePipeline(_startFrom, _startFromInclusive);
+    }
+    LOG(1) << "Change stream on " << pExpCtx->ns << " fell behind its shared pipeline, continuing "
+           << "from " << (_lastClusterTime ? *_lastClusterTime : _startFrom);
+    return _getNextFromOwnPipeline();
+}
+
+DocumentSource::GetNextResult DocumentSourceChangeStreamFanoutConsumer::_getNextFromOwnPipeline() {
+    while (auto next = _ownPipeline->getNext()) {
+        _latestOplogTimestamp = PipelineD::getLatestOplogTimestamp(_ownPipeline.get());
+        if (_numToSkip > 0) {
+            // This event was returned from the fanout before the stream fell behind.
+            --_numToSkip;
+            continue;
+        }
+        _recordReturned(*next);
+        return std::move(*next);
+    }
+    _latestOplogTimestamp =
+        std::max(_latestOplogTimestamp, PipelineD::getLatestOplogTimestamp(_ownPipeline.get()));
+    return GetNextResult::makeEOF();
+}
+
+void DocumentSourceChangeStreamFanoutConsumer::_recordReturned(const Document& event) {
+    const auto clusterTime = getClusterTime(event);
+    if (_lastClusterTime && *_lastClusterTime == clusterTime) {
+        ++_numReturnedAtLastClusterTime;
+        return;
+    }
+    _lastClusterTime = clusterTime;
+    _numReturnedAtLastClusterTime = 1;
+}
+
+void DocumentSourceChangeStreamFanoutConsumer::_unsubscribe() {
+    if (!_fanout) {
+        return;
+    }
+    ChangeStreamFanoutRegistry::get(pExpCtx->opCtx->getServiceContext())
+        .unsubscribe(pExpCtx->opCtx, _key, _fanout, _subscriberId);
+    _fanout.reset();
+}
+
+void DocumentSourceChangeStreamFanoutConsumer::detachFromOperationContext() {
+    if (_ownPipeline) {
+        _ownPipeline->detachFromOperationContext();
+    }
+}
+
+void DocumentSourceChangeStreamFanoutConsumer::reattachToOperationContext(OperationContext* opCtx) {
+    if (_ownPipeline) {
+        _ownPipeline->reattachToOperationContext(opCtx);
+    }
+}
+
+void DocumentSourceChangeStreamFanoutConsumer::doDispose() {
+    _unsubscribe();
+    if (_ownPipeline) {
+        _ownPipeline->dispose(pExpCtx->opCtx);
+        _ownPipeline.get_deleter().dismissDisposal();
+        _ownPipeline.reset();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,324 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A ChangeStreamFanout tails the oplog and applies the change stream transformation once on behalf
+ * of every change stream watching the same namespace with the same options, and buffers the
+ * resulting events until each of its subscribers has consumed them.
+ *
+ * Whichever subscriber first runs out of buffered events drives the shared pipeline on its own
+ * OperationContext while the others wait, so the pipeline only ever runs on one thread at a time.
+ * The buffer is bounded by internalQueryChangeStreamFanoutMaxBufferedEvents; a subscriber which
+ * falls so far behind that events it has not yet consumed must be discarded can no longer be
+ * served, and is expected to continue on a pipeline of its own.
+ *
+ * This class is thread-safe.
+ */
+class ChangeStreamFanout {
+    MONGO_DISALLOW_COPYING(ChangeStreamFanout);
+
+public:
+    using SubscriberId = uint64_t;
+
+    /**
+     * Constructs a fanout reading from 'pipeline', which must yield every change event with a
+     * clusterTime after 'startFrom', or at 'startFrom' if 'startFromInclusive' is true. The
+     * pipeline must be detached from its OperationContext.
+     */
+    ChangeStreamFanout(std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+                       Timestamp startFrom,
+                       bool startFromInclusive);
+
+    /**
+     * Adds a subscriber for the events after 'startFrom', or at 'startFrom' if
+     * 'startFromInclusive' is true. Returns boost::none if some of those events have already been
+     * discarded from the buffer, or if the fanout has been closed.
+     */
+    boost::optional<SubscriberId> subscribe(Timestamp startFrom, bool startFromInclusive);
+
+    /**
+     * Removes 'id'. Returns true if this left the fanout without subscribers, in which case the
+     * fanout is closed to new subscribers and the caller must dispose() it.
+     */
+    bool unsubscribe(SubscriberId id);
+
+    /**
+     * Returns the next event for 'id', driving the shared pipeline on 'opCtx' if 'id' has
+     * consumed every buffered event, or EOF if the oplog holds no further events yet. Sets
+     * 'latestOplogTimestamp' to the latest oplog time which the events returned so far account
+     * for.
+     *
+     * Returns boost::none if the fanout can no longer serve 'id', either because events which 'id'
+     * had not yet consumed were discarded, or because the shared pipeline failed while another
+     * subscriber was driving it. The caller must then unsubscribe 'id'. If the shared pipeline
+     * fails while 'id' is driving it, the error is thrown to the caller.
+     */
+    boost::optional<DocumentSource::GetNextResult> getNext(OperationContext* opCtx,
+                                                           SubscriberId id,
+                                                           Timestamp* latestOplogTimestamp);
+
+    /**
+     * Disposes of the shared pipeline. Must be called once unsubscribe() has returned true.
+     */
+    void dispose(OperationContext* opCtx);
+
+    size_t numSubscribers() const;
+    size_t numBufferedEvents() const;
+
+private:
+    struct Event {
+        Document document;
+        Timestamp clusterTime;
+
+        // The latest oplog time scanned by the shared pipeline when it produced this event.
+        Timestamp latestOplogTimestamp;
+    };
+
+    struct Subscriber {
+        // The position in the stream of events of the next event to return.
+        uint64_t position;
+
+        Timestamp startFrom;
+        bool startFromInclusive;
+
+        // Set once the subscriber has been returned an event, after which no more of the events
+        // need to be checked against 'startFrom'.
+        bool reachedStartFrom = false;
+    };
+
+    /**
+     * Returns true if the buffer and the events which the pipeline has yet to produce include
+     * every event after 'startFrom', or at 'startFrom' if 'startFromInclusive' is true.
+     */
+    bool _covers(WithLock, Timestamp startFrom, bool startFromInclusive) const;
+
+    /**
+     * Returns the next buffered event for 'subscriber', or boost::none if it has consumed every
+     * buffered event.
+     */
+    boost::optional<Document> _nextBufferedEvent(WithLock,
+                                                 Subscriber* subscriber,
+                                                 Timestamp* latestOplogTimestamp);
+
+    /**
+     * Runs the shared pipeline on 'opCtx', appending the events it produces to the buffer until
+     * it returns EOF or the buffer is full. Returns true if it returned EOF. Must be called with
+     * '_driveMutex' held.
+     */
+    bool _drive(OperationContext* opCtx);
+
+    /**
+     * Discards buffered events which every subscriber has consumed, and then the oldest events if
+     * the buffer is still over its limit.
+     */
+    void _trimBuffer(WithLock);
+    void _popFront(WithLock);
+
+    // Only held while the shared pipeline runs, so that subscribers may read the buffer meanwhile.
+    // Acquired before '_mutex' whenever both are held.
+    stdx::mutex _driveMutex;
+    std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
+
+    mutable stdx::mutex _mutex;
+
+    // The buffered events, the first of which is at position '_basePosition' in the stream.
+    std::deque<Event> _events;
+    uint64_t _basePosition = 0;
+
+    // The earliest clusterTime whose events the fanout can still return.
+    Timestamp _coveredFrom;
+    bool _coveredFromInclusive;
+
+    // The latest oplog time scanned by the shared pipeline.
+    Timestamp _latestOplogTimestamp;
+
+    std::map<SubscriberId, Subscriber> _subscribers;
+    SubscriberId _nextSubscriberId = 0;
+
+    // Set once the last subscriber has left.
+    bool _closed = false;
+
+    // Set if the shared pipeline threw, after which the fanout serves no subscriber.
+    bool _failed = false;
+};
+
+/**
+ * The set of ChangeStreamFanouts open on a server, keyed by the namespace and options of the change
+ * streams which they serve.
+ */
+class ChangeStreamFanoutRegistry {
+    MONGO_DISALLOW_COPYING(ChangeStreamFanoutRegistry);
+
+public:
+    using PipelineFactory = std::function<std::unique_ptr<Pipeline, PipelineDeleter>()>;
+
+    static ChangeStreamFanoutRegistry& get(ServiceContext* serviceContext);
+
+    ChangeStreamFanoutRegistry() = default;
+
+    /**
+     * Subscribes to a fanout for 'key' which can serve the events after 'startFrom', or at
+     * 'startFrom' if 'startFromInclusive' is true. If there is none, opens a new one reading from
+     * the pipeline which 'makePipeline' returns, detached from its OperationContext.
+     */
+    std::pair<std::shared_ptr<ChangeStreamFanout>, ChangeStreamFanout::SubscriberId> subscribe(
+        const std::string& key,
+        Timestamp startFrom,
+        bool startFromInclusive,
+        const PipelineFactory& makePipeline);
+
+    /**
+     * Unsubscribes 'id' from 'fanout', disposing of the fanout on 'opCtx' if it was the last
+     * subscriber.
+     */
+    void unsubscribe(OperationContext* opCtx,
+                     const std::string& key,
+                     const std::shared_ptr<ChangeStreamFanout>& fanout,
+                     ChangeStreamFanout::SubscriberId id);
+
+    size_t numFanouts() const;
+
+private:
+    mutable stdx::mutex _mutex;
+    std::multimap<std::string, std::shared_ptr<ChangeStreamFanout>> _fanouts;
+};
+
+/**
+ * Stands in for the oplog cursor, $match and transformation stages of a $changeStream on a replica
+ * set member, reading the stream's events from a ChangeStreamFanout shared with every other stream
+ * over the same namespace with the same options. If the stream falls too far behind the others,
+ * continues on a pipeline of its own from the last event it returned.
+ */
+class DocumentSourceChangeStreamFanoutConsumer final : public DocumentSource {
+public:
+    /**
+     * If 'pipeline' begins with the oplog $match and transformation stages of a change stream
+     * which a ChangeStreamFanout can serve, replaces them with a consumer and returns true.
+     * Returns false, leaving 'pipeline' unchanged, if change stream fanout is disabled or cannot
+     * serve this stream. Must be called before a cursor source is attached to 'pipeline'.
+     */
+    static bool substituteIfShareable(Pipeline* pipeline);
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final;
+
+    DepsTracker::State getDependencies(DepsTracker* deps) const final {
+        return DepsTracker::State::EXHAUSTIVE_ALL;
+    }
+
+    boost::optional<MergingLogic> mergingLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
+
+    void detachFromOperationContext() final;
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+    /**
+     * Returns the latest oplog time which the events returned so far account for.
+     */
+    Timestamp getLatestOplogTimestamp() const {
+        return _latestOplogTimestamp;
+    }
+
+private:
+    DocumentSourceChangeStreamFanoutConsumer(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                             ServerGlobalParams::FeatureCompatibility::Version fcv,
+                                             BSONObj changeStreamSpec,
+                                             BSONObj transformSpec,
+                                             std::string key,
+                                             Timestamp startFrom,
+                                             bool startFromInclusive);
+
+    void doDispose() final;
+
+    /**
+     * Builds the oplog cursor, $match and transformation stages which this stage stands in for,
+     * reading from 'startFrom'.
+     */
+    std::unique_ptr<Pipeline, PipelineDeleter> _makePipeline(Timestamp startFrom,
+                                                             bool startFromInclusive) const;
+
+    GetNextResult _getNextFromOwnPipeline();
+
+    /**
+     * Records 'event' as returned, so that a pipeline of this stream's own can carry on after it.
+     */
+    void _recordReturned(const Document& event);
+
+    void _unsubscribe();
+
+    const ServerGlobalParams::FeatureCompatibility::Version _fcv;
+    const BSONObj _changeStreamSpec;
+
+    // The specification without its starting point, which the transformation stage is built from.
+    const BSONObj _transformSpec;
+    const std::string _key;
+    const Timestamp _startFrom;
+    const bool _startFromInclusive;
+
+    std::shared_ptr<ChangeStreamFanout> _fanout;
+    ChangeStreamFanout::SubscriberId _subscriberId = 0;
+
+    // Set if this stream fell behind the fanout, after which it reads from a pipeline of its own.
+    std::unique_ptr<Pipeline, PipelineDeleter> _ownPipeline;
+
+    // The clusterTime of the last event returned, and the number of events returned at that time.
+    // The stream's own pipeline starts from this time, and skips the events already returned.
+    boost::optional<Timestamp> _lastClusterTime;
+    size_t _numReturnedAtLastClusterTime = 0;
+    size_t _numToSkip = 0;
+
+    Timestamp _latestOplogTimestamp;
+};
+
+}  // namespace mongo
@@ -50,6 +50,7 @@
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/stdx/memory.h"
@@ -1332,6 +1333,156 @@ TEST_F(ChangeStreamStageTest, UsesOldSortKeyFormatIfMergeByPBRTIsFalse) {
     ASSERT_BSONOBJ_EQ(next.releaseDocument().getSortKeyMetaField(), expectedSortKey);
 }
 
+//
+// Tests for pushing user filters on change events down into the oplog filter.
+//
+class ChangeStreamOplogFilterTest : public ChangeStreamStageTest {
+public:
+    /**
+     * Builds and optimizes a pipeline consisting of the change stream described by 'spec' followed
+     * by a $match on 'userFilter', and returns an executable copy of the resulting oplog filter.
+     */
+    intrusive_ptr<DocumentSourceMatch> makeOplogFilter(const BSONObj& userFilter,
+                                                       const BSONObj& spec = kDefaultSpec) {
+        auto stages = DSChangeStream::createFromBson(spec.firstElement(), getExpCtx());
+        stages.push_back(DocumentSourceMatch::create(userFilter, getExpCtx()));
+        auto pipeline = uassertStatusOK(Pipeline::create(stages, getExpCtx()));
+        pipeline->optimizePipeline();
+
+        auto oplogMatch =
+            dynamic_cast<DocumentSourceOplogMatch*>(pipeline->getSources().front().get());
+        ASSERT(oplogMatch);
+        return DocumentSourceMatch::create(oplogMatch->getQuery(), getExpCtx());
+    }
+
+    bool passes(const intrusive_ptr<DocumentSourceMatch>& filter, const OplogEntry& entry) {
+        return filter->getMatchExpression()->matchesBSON(entry.toBSON());
+    }
+};
+
+TEST_F(ChangeStreamOplogFilterTest, OperationTypeFilterIsPushedDown) {
+    auto filter = makeOplogFilter(fromjson("{operationType: 'insert'}"));
+
+    ASSERT_TRUE(passes(filter, makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1))));
+    ASSERT_FALSE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1))));
+    ASSERT_FALSE(passes(filter,
+                        makeOplogEntry(OpTypeEnum::kUpdate,
+                                       nss,
+                                       BSON("$set" << BSON("x" << 1)),
+                                       testUuid(),
+                                       boost::none,
+                                       BSON("_id" << 1))));
+
+    // Commands must still be seen so that invalidating events are reported.
+    ASSERT_TRUE(passes(filter, createCommand(BSON("drop" << nss.coll()), testUuid())));
+}
+
+TEST_F(ChangeStreamOplogFilterTest, OperationTypeFilterDistinguishesUpdatesFromReplacements) {
+    auto filter = makeOplogFilter(fromjson("{operationType: {$in: ['replace', 'delete']}}"));
+    auto update = makeOplogEntry(OpTypeEnum::kUpdate,
+                                 nss,
+                                 BSON("$set" << BSON("x" << 1)),
+                                 testUuid(),
+                                 boost::none,
+                                 BSON("_id" << 1));
+    auto replace = makeOplogEntry(OpTypeEnum::kUpdate,
+                                  nss,
+                                  BSON("_id" << 1 << "x" << 1),
+                                  testUuid(),
+                                  boost::none,
+                                  BSON("_id" << 1));
+
+    ASSERT_FALSE(passes(filter, update));
+    ASSERT_TRUE(passes(filter, replace));
+    ASSERT_TRUE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1))));
+}
+
+TEST_F(ChangeStreamOplogFilterTest, DocumentKeyIdFilterIsPushedDown) {
+    auto filter = makeOplogFilter(fromjson("{'documentKey._id': 1}"));
+
+    ASSERT_TRUE(passes(filter, makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1))));
+    ASSERT_FALSE(passes(filter, makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 2))));
+    ASSERT_TRUE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1))));
+    ASSERT_FALSE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 2))));
+    ASSERT_TRUE(passes(filter,
+                       makeOplogEntry(OpTypeEnum::kUpdate,
+                                      nss,
+                                      BSON("$set" << BSON("x" << 1)),
+                                      testUuid(),
+                                      boost::none,
+                                      BSON("_id" << 1))));
+    ASSERT_FALSE(passes(filter,
+                        makeOplogEntry(OpTypeEnum::kUpdate,
+                                       nss,
+                                       BSON("$set" << BSON("x" << 1)),
+                                       testUuid(),
+                                       boost::none,
+                                       BSON("_id" << 2))));
+}
+
+TEST_F(ChangeStreamOplogFilterTest, FullDocumentFilterIsPushedDown) {
+    auto filter = makeOplogFilter(fromjson("{'fullDocument.x': 1}"));
+    auto update = makeOplogEntry(OpTypeEnum::kUpdate,
+                                 nss,
+                                 BSON("$set" << BSON("x" << 1)),
+                                 testUuid(),
+                                 boost::none,
+                                 BSON("_id" << 1));
+
+    ASSERT_TRUE(
+        passes(filter, makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 1))));
+    ASSERT_FALSE(
+        passes(filter, makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 2))));
+    ASSERT_FALSE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1))));
+
+    // Without a post-image lookup, update events have no 'fullDocument' to match.
+    ASSERT_FALSE(passes(filter, update));
+
+    // With a post-image lookup, the document is not known until after the transformation.
+    auto lookupFilter =
+        makeOplogFilter(fromjson("{'fullDocument.x': 1}"),
+                        fromjson("{$changeStream: {fullDocument: 'updateLookup'}}"));
+    ASSERT_TRUE(passes(lookupFilter, update));
+}
+
+TEST_F(ChangeStreamOplogFilterTest, FullDocumentFilterIsNotPushedDownWithNonSimpleCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    getExpCtx()->setCollator(&collator);
+    auto filter = makeOplogFilter(fromjson("{'fullDocument.x': 'a'}"));
+
+    ASSERT_TRUE(passes(
+        filter, makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << "b"))));
+}
+
+TEST_F(ChangeStreamOplogFilterTest, OrIsOnlyPushedDownIfEveryBranchIsRewritable) {
+    auto filter = makeOplogFilter(
+        fromjson("{$or: [{operationType: 'insert'}, {'updateDescription.updatedFields.x': 1}]}"));
+    ASSERT_TRUE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1))));
+
+    filter = makeOplogFilter(
+        fromjson("{$or: [{operationType: 'insert'}, {'documentKey._id': 2}]}"));
+    ASSERT_TRUE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 2))));
+    ASSERT_FALSE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1))));
+}
+
+TEST_F(ChangeStreamOplogFilterTest, EntryAtStartingPointIsNeverFilteredOut) {
+    auto filter =
+        makeOplogFilter(fromjson("{operationType: 'insert'}"),
+                        BSON(DSChangeStream::kStageName << BSON("startAtOperationTime"
+                                                                << kDefaultTs)));
+    ASSERT_TRUE(passes(filter, makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1))));
+
+    const repl::OpTime laterOpTime(Timestamp(kDefaultTs.getSecs() + 1, 1), 1);
+    ASSERT_FALSE(passes(filter,
+                        makeOplogEntry(OpTypeEnum::kDelete,
+                                       nss,
+                                       BSON("_id" << 1),
+                                       testUuid(),
+                                       boost::none,
+                                       boost::none,
+                                       laterOpTime)));
+}
+
 //
 // Test class for change stream of a single database.
 //
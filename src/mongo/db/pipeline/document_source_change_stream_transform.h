@@ -63,6 +63,14 @@ public:
         return DocumentSourceChangeStream::kStageName.rawData();
     }
 
+    const BSONObj& getChangeStreamSpec() const {
+        return _changeStreamSpec;
+    }
+
+    ServerGlobalParams::FeatureCompatibility::Version getFeatureCompatibilityVersion() const {
+        return _fcv;
+    }
+
 private:
     // This constructor is private, callers should use the 'create()' method above.
     DocumentSourceChangeStreamTransform(const boost::intrusive_ptr<ExpressionContext>&,
@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -92,7 +93,20 @@ const char* DocumentSourceExchange::getSourceName() const {
 }
 
 Value DocumentSourceExchange::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
-    return Value(DOC(getSourceName() << _exchange->getSpec().toBSON()));
+    if (!explain) {
+        return Value(DOC(getSourceName() << _exchange->getSpec().toBSON()));
+    }
+
+    auto stats = _exchange->getConsumerStats(_consumerId);
+    MutableDocument spec(Document(_exchange->getSpec().toBSON()));
+    spec["consumerStats"] = Value(DOC("consumerId" << static_cast<long long>(_consumerId)
+                                                   << "waitTimeMicros"
+                                                   << durationCount<Microseconds>(stats.waitTime)
+                                                   << "loadingStalls"
+                                                   << stats.loadingStalls
+                                                   << "documentsStolen"
+                                                   << stats.documentsStolen));
+    return Value(DOC(getSourceName() << spec.freeze()));
 }
 
 DocumentSourceExchange::DocumentSourceExchange(
@@ -132,6 +146,7 @@ Exchange::Exchange(ExchangeSpec spec, std::unique_ptr<Pipeline, PipelineDeleter>
     for (int idx = 0; idx < _spec.getConsumers(); ++idx) {
         _consumers.emplace_back(std::make_unique<ExchangeBuffer>());
     }
+    _consumerStats.resize(_consumers.size());
 
     if (_policy == ExchangePolicyEnum::kKeyRange) {
         uassert(50900,
@@ -295,9 +310,26 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
                       "Exchange failed due to an error on different thread.");
         }
 
+        auto& buffer = *_consumers[consumerId];
+
+        // Under the work stealing policy a consumer with no documents of its own takes one from
+        // another consumer rather than wait for loading to be unblocked, and every document must
+        // be handed out before a consumer can see the end of the stream.
+        if (_policy == ExchangePolicyEnum::kWorkStealing && !buffer.hasDocument() &&
+            (!buffer.isEmpty() || _loadingThreadId != kInvalidThreadId)) {
+            size_t victimId = getStealVictim(consumerId);
+            if (victimId != kInvalidThreadId) {
+                auto doc = takeDocument(victimId);
+                ++_consumerStats[consumerId].documentsStolen;
+                unblockLoading(victimId);
+
+                return doc;
+            }
+        }
+
         // Check if we have a document.
-        if (!_consumers[consumerId]->isEmpty()) {
-            auto doc = _consumers[consumerId]->getNext();
+        if (!buffer.isEmpty()) {
+            auto doc = takeDocument(consumerId);
             unblockLoading(consumerId);
 
             return doc;
@@ -329,6 +361,9 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
                 // The loading cannot continue until the consumer with the full buffer consumes some
                 // documents.
                 _loadingThreadId = fullConsumerId;
+                if (fullConsumerId != kInvalidThreadId) {
+                    ++_consumerStats[fullConsumerId].loadingStalls;
+                }
 
                 // Wake up everybody and try to make some progress.
                 _haveBufferSpace.notify_all();
@@ -344,9 +379,11 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
         } else {
             // Some other consumer is already loading the buffers. There is nothing else we can do
             // but wait.
+            Timer waitTimer;
             MutexAndResourceLock mutexAndResourceLock(opCtx, std::move(lk), resourceYielder);
             _haveBufferSpace.wait(mutexAndResourceLock);
             lk = mutexAndResourceLock.releaseLockOwnership();
+            _consumerStats[consumerId].waitTime += Microseconds(waitTimer.micros());
         }
     }
 }
@@ -360,23 +397,30 @@ size_t Exchange::loadNextBatch() {
             case ExchangePolicyEnum::kBroadcast: {
                 bool full = false;
                 // The document is sent to all consumers.
-                for (auto& c : _consumers) {
-                    full = c->appendDocument(input, _maxBufferSize);
+                for (size_t idx = 0; idx < _consumers.size(); ++idx) {
+                    full = appendDocument(idx, input) || full;
                 }
 
-                if (full)
-                    return 0;
+                // Wait for the consumer which has fallen furthest behind.
+                if (full) {
+                    auto fullest = std::max_element(
+                        _consumers.begin(), _consumers.end(), [](auto& lhs, auto& rhs) {
+                            return lhs->getBytesInBuffer() < rhs->getBytesInBuffer();
+                        });
+                    return std::distance(_consumers.begin(), fullest);
+                }
             } break;
-            case ExchangePolicyEnum::kRoundRobin: {
+            case ExchangePolicyEnum::kRoundRobin:
+            case ExchangePolicyEnum::kWorkStealing: {
                 size_t target = _roundRobinCounter;
                 _roundRobinCounter = (_roundRobinCounter + 1) % _consumers.size();
 
-                if (_consumers[target]->appendDocument(std::move(input), _maxBufferSize))
+                if (appendDocument(target, std::move(input)))
                     return target;
             } break;
             case ExchangePolicyEnum::kKeyRange: {
                 size_t target = getTargetConsumer(input.getDocument());
-                bool full = _consumers[target]->appendDocument(std::move(input), _maxBufferSize);
+                bool full = appendDocument(target, std::move(input));
                 if (full && _orderPreserving) {
                     // TODO send the high watermark here.
                 }
@@ -391,13 +435,50 @@ size_t Exchange::loadNextBatch() {
     invariant(input.isEOF());
 
     // We have reached the end so send EOS to all consumers.
-    for (auto& c : _consumers) {
-        c->appendDocument(input, _maxBufferSize);
+    for (size_t idx = 0; idx < _consumers.size(); ++idx) {
+        appendDocument(idx, input);
     }
 
     return kInvalidThreadId;
 }
 
+bool Exchange::appendDocument(size_t consumerId, DocumentSource::GetNextResult input) {
+    auto& buffer = *_consumers[consumerId];
+
+    // A disposed buffer discards the document, and its consumer will never make room.
+    if (buffer.isDisposed()) {
+        return false;
+    }
+
+    const size_t bytesBefore = buffer.getBytesInBuffer();
+    buffer.appendDocument(std::move(input));
+    _bytesInBuffers += buffer.getBytesInBuffer() - bytesBefore;
+
+    return _bytesInBuffers >= _maxBufferSize * _consumers.size();
+}
+
+DocumentSource::GetNextResult Exchange::takeDocument(size_t consumerId) {
+    auto& buffer = *_consumers[consumerId];
+
+    const size_t bytesBefore = buffer.getBytesInBuffer();
+    auto result = buffer.getNext();
+    _bytesInBuffers -= bytesBefore - buffer.getBytesInBuffer();
+
+    return result;
+}
+
+size_t Exchange::getStealVictim(size_t consumerId) const {
+    size_t victimId = kInvalidThreadId;
+    for (size_t idx = 0; idx < _consumers.size(); ++idx) {
+        if (idx != consumerId && _consumers[idx]->hasDocument() &&
+            (victimId == kInvalidThreadId ||
+             _consumers[idx]->getBytesInBuffer() > _consumers[victimId]->getBytesInBuffer())) {
+            victimId = idx;
+        }
+    }
+    return victimId;
+}
+
 size_t Exchange::getTargetConsumer(const Document& input) {
     // Build the key.
     BSONObjBuilder kb;
@@ -452,10 +533,16 @@ void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
         _pipeline->dispose(opCtx);
     }
 
+    _bytesInBuffers -= _consumers[consumerId]->getBytesInBuffer();
     _consumers[consumerId]->dispose();
     unblockLoading(consumerId);
 }
 
+Exchange::ConsumerStats Exchange::getConsumerStats(size_t consumerId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _consumerStats[consumerId];
+}
+
 DocumentSource::GetNextResult Exchange::ExchangeBuffer::getNext() {
     invariant(!_buffer.empty());
 
@@ -469,19 +556,16 @@ DocumentSource::GetNextResult Exchange::ExchangeBuffer::getNext() {
     return result;
 }
 
-bool Exchange::ExchangeBuffer::appendDocument(DocumentSource::GetNextResult input, size_t limit) {
+void Exchange::ExchangeBuffer::appendDocument(DocumentSource::GetNextResult input) {
     // If the buffer is disposed then we simply ignore any appends.
     if (_disposed) {
-        return false;
+        return;
     }
 
     if (input.isAdvanced()) {
         _bytesInBuffer += input.getDocument().getApproximateSize();
     }
     _buffer.push_back(std::move(input));
-
-    // The buffer is full.
-    return _bytesInBuffer >= limit;
 }
 
 }  // namespace mongo
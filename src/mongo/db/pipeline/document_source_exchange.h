@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -71,6 +72,20 @@ class Exchange : public RefCountable {
     static std::vector<FieldPath> extractKeyPaths(const BSONObj& keyPattern);
 
 public:
+    /**
+     * Counters describing how much a consumer has waited on the exchange and held it up.
+     */
+    struct ConsumerStats {
+        // The time spent waiting for another consumer to load documents or make buffer space.
+        Microseconds waitTime{0};
+
+        // The number of times loading stopped because this consumer's buffer was full.
+        long long loadingStalls = 0;
+
+        // The number of documents this consumer took from the buffers of other consumers.
+        long long documentsStolen = 0;
+    };
+
     /**
      * Create an exchange. 'pipeline' represents the input to the exchange operator and must not be
      * nullptr.
@@ -95,6 +110,8 @@ public:
 
     void dispose(OperationContext* opCtx, size_t consumerId);
 
+    ConsumerStats getConsumerStats(size_t consumerId);
+
     /**
      * Unblocks the loading thread (a producer) if the loading is blocked by a consumer identified
      * by consumerId. Note that there is no such thing as being blocked by multiple consumers. It is
@@ -109,13 +126,43 @@ private:
 
     size_t getTargetConsumer(const Document& input);
 
+    /**
+     * Appends 'input' to the buffer of consumer 'consumerId'. Returns true if the buffers have
+     * used up their shared budget and loading must wait for this consumer to consume.
+     */
+    bool appendDocument(size_t consumerId, DocumentSource::GetNextResult input);
+
+    /**
+     * Removes and returns the next result from the buffer of consumer 'consumerId'.
+     */
+    DocumentSource::GetNextResult takeDocument(size_t consumerId);
+
+    /**
+     * Returns the consumer with the most bytes buffered from which 'consumerId' may take a
+     * document under the 'workStealing' policy, or kInvalidThreadId if there is none.
+     */
+    size_t getStealVictim(size_t consumerId) const;
+
     class ExchangeBuffer {
     public:
-        bool appendDocument(DocumentSource::GetNextResult input, size_t limit);
+        void appendDocument(DocumentSource::GetNextResult input);
         DocumentSource::GetNextResult getNext();
         bool isEmpty() const {
             return _buffer.empty();
         }
+        bool isDisposed() const {
+            return _disposed;
+        }
+        size_t getBytesInBuffer() const {
+            return _bytesInBuffer;
+        }
+        /**
+         * Returns true if the next result in the buffer is a document, rather than the end of the
+         * stream.
+         */
+        bool hasDocument() const {
+            return !_buffer.empty() && _buffer.front().isAdvanced();
+        }
         /**
          * Mark the buffer associated with a consumer as disposed. After calling this method,
          * subsequent results that are appended to this buffer are instead discarded to prevent this
@@ -163,9 +210,14 @@ private:
     // to prevent deadlocks.
     const bool _orderPreserving;
 
-    // A maximum size of buffer per consumer.
+    // The share of the buffer budget per consumer. Loading continues while the buffers together
+    // hold less than '_maxBufferSize' bytes for every consumer, however they are divided up, so
+    // that a consumer which falls behind can use the space the others leave free.
     const size_t _maxBufferSize;
 
+    // The total number of bytes held in the buffers of all consumers.
+    size_t _bytesInBuffers{0};
+
     // An input to the exchange operator
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
 
@@ -187,6 +239,8 @@ private:
     size_t _disposeRunDown{0};
 
     std::vector<std::unique_ptr<ExchangeBuffer>> _consumers;
+
+    std::vector<ConsumerStats> _consumerStats;
 };
 
 class DocumentSourceExchange final : public DocumentSource {
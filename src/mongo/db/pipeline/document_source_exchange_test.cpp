@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/executor/thread_pool_task_executor.h"
@@ -237,6 +238,44 @@ TEST_F(DocumentSourceExchangeTest, ExchangeNConsumerEarlyout) {
         _executor->wait(h);
 }
 
+TEST_F(DocumentSourceExchangeTest, WorkStealingExchangeDoesNotWaitForIdleConsumer) {
+    const size_t nDocs = 500;
+    auto source = getMockSource(nDocs);
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kWorkStealing);
+    spec.setConsumers(2);
+    spec.setBufferSize(1024);
+
+    boost::intrusive_ptr<Exchange> ex =
+        new Exchange(spec, unittest::assertGet(Pipeline::create({source}, getExpCtx())));
+
+    boost::intrusive_ptr<DocumentSourceExchange> consumer0 =
+        new DocumentSourceExchange(getExpCtx(), ex, 0, nullptr);
+    boost::intrusive_ptr<DocumentSourceExchange> consumer1 =
+        new DocumentSourceExchange(getExpCtx(), ex, 1, nullptr);
+
+    // Consumer 1 never asks for a document, yet consumer 0 can read the whole input by taking the
+    // documents buffered for it.
+    size_t docs = 0;
+    for (auto input = consumer0->getNext(); input.isAdvanced(); input = consumer0->getNext()) {
+        ++docs;
+    }
+    ASSERT_EQ(docs, nDocs);
+    ASSERT_TRUE(consumer1->getNext().isEOF());
+
+    auto stats = ex->getConsumerStats(0);
+    ASSERT_GT(stats.documentsStolen, 0);
+    ASSERT_EQ(ex->getConsumerStats(1).documentsStolen, 0);
+    ASSERT_GT(ex->getConsumerStats(1).loadingStalls, 0);
+
+    auto explained = consumer0->serialize(ExplainOptions::Verbosity::kExecStats).getDocument();
+    auto consumerStats = explained["$_internalExchange"]["consumerStats"];
+    ASSERT_VALUE_EQ(consumerStats["consumerId"], Value(0LL));
+    ASSERT_VALUE_EQ(consumerStats["documentsStolen"], Value(stats.documentsStolen));
+    ASSERT_VALUE_EQ(consumerStats["loadingStalls"], Value(stats.loadingStalls));
+}
+
 TEST_F(DocumentSourceExchangeTest, BroadcastExchangeNConsumer) {
     const size_t nDocs = 500;
     auto source = getMockSource(nDocs);
@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <exception>
 #include <memory>
 #include <vector>
 
@@ -38,6 +39,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/client.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -45,9 +47,15 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -56,18 +64,76 @@ using std::pair;
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * The threads on which the facets of every parallel $facet stage in the process are run.
+ */
+struct FacetWorkerPool {
+    FacetWorkerPool()
+        : threadPool([] {
+              ThreadPool::Options options;
+              options.poolName = "FacetWorkers";
+              options.threadNamePrefix = "FacetWorker-";
+              options.minThreads = 0;
+              options.maxThreads = 64;
+              options.onCreateThread = [](const std::string& threadName) {
+                  Client::initThread(threadName.c_str());
+              };
+              return options;
+          }()) {}
+
+    ThreadPool threadPool;
+};
+
+const auto facetWorkerPool = ServiceContext::declareDecoration<FacetWorkerPool>();
+const ServiceContext::ConstructorActionRegisterer facetWorkerPoolRegisterer{
+    "FacetWorkerPool",
+    [](ServiceContext* service) { facetWorkerPool(service).threadPool.startup(); },
+    [](ServiceContext* service) {
+        auto& pool = facetWorkerPool(service).threadPool;
+        pool.shutdown();
+        pool.join();
+    }};
+
+}  // namespace
+
 DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelines,
                                          const intrusive_ptr<ExpressionContext>& expCtx)
     : DocumentSource(expCtx),
       _teeBuffer(TeeBuffer::create(facetPipelines.size())),
       _facets(std::move(facetPipelines)) {
+    _runInParallel = canRunFacetsInParallel();
+    if (_runInParallel) {
+        _teeBuffer->setLoadedByOwner();
+    }
+
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
         facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer));
+            DocumentSourceTeeConsumer::create(facet.pipeline->getContext(), facetId, _teeBuffer));
     }
 }
 
+bool DocumentSourceFacet::canRunFacetsInParallel() const {
+    if (!internalQueryEnableParallelFacets.load() || _facets.size() < 2) {
+        return false;
+    }
+
+    // Stages keep the state they need while running in their ExpressionContext, so no two facets
+    // may share one.
+    stdx::unordered_set<const ExpressionContext*> contexts{pExpCtx.get()};
+    for (auto&& facet : _facets) {
+        if (!contexts.insert(facet.pipeline->getContext().get()).second) {
+            return false;
+        }
+    }
+
+    stdx::unordered_set<NamespaceString> involvedCollections;
+    addInvolvedCollections(&involvedCollections);
+    return involvedCollections.empty();
+}
+
 namespace {
 /**
  * Extracts the names of the facets and the vectors of raw BSONObjs representing the stages within
@@ -177,7 +243,20 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     }
 
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
+    if (_runInParallel) {
+        // Each batch is loaded here and then consumed by all the facets at once. Once the input
+        // is exhausted the facets are run one last time, to see EOF and produce their output.
+        vector<char> eof(_facets.size(), false);
+        bool moreInput = true;
+        while (moreInput) {
+            pExpCtx->checkForInterrupt();
+            moreInput = _teeBuffer->loadNextBatchForConsumers();
+            runFacetsOnBatch(&results, &eof);
+        }
+        invariant(std::all_of(eof.begin(), eof.end(), [](char isEOF) { return isEOF; }));
+    }
+
+    bool allPipelinesEOF = _runInParallel;
     while (!allPipelinesEOF) {
         allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
         for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
@@ -199,6 +278,111 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     return resultDoc.freeze();
 }
 
+void DocumentSourceFacet::runFacetsOnBatch(vector<vector<Value>>* results, vector<char>* eof) {
+    OperationContext* opCtx = pExpCtx->opCtx;
+
+    // Each facet only touches its own results, its own ExpressionContext and its own position in
+    // the shared batch. Every task must finish before we return, since they refer to this frame.
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+    size_t numRemaining = 0;
+    std::exception_ptr error;
+    Status killStatus = Status::OK();
+    stdx::unordered_set<OperationContext*> workerOpCtxs;
+
+    const auto killWorker = [&killStatus](OperationContext* workerOpCtx) {
+        stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+        workerOpCtx->getServiceContext()->killOperation(
+            clientLock, workerOpCtx, killStatus.code());
+    };
+
+    const auto drain = [&](size_t facetId) {
+        const auto& pipeline = _facets[facetId].pipeline;
+        auto next = pipeline->getSources().back()->getNext();
+        for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+            (*results)[facetId].emplace_back(next.releaseDocument());
+        }
+        (*eof)[facetId] = next.isEOF();
+    };
+
+    const auto runTask = [&](size_t facetId, bool onWorkerThread) {
+        std::exception_ptr taskError;
+        try {
+            if (!onWorkerThread) {
+                drain(facetId);
+            } else {
+                // A worker runs the facet on an operation of its own, which is killed along with
+                // this operation.
+                auto workerOpCtx = cc().makeOperationContext();
+                {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    workerOpCtxs.insert(workerOpCtx.get());
+                    if (!killStatus.isOK()) {
+                        killWorker(workerOpCtx.get());
+                    }
+                }
+
+                const auto& facetExpCtx = _facets[facetId].pipeline->getContext();
+                facetExpCtx->opCtx = workerOpCtx.get();
+                ON_BLOCK_EXIT([&] {
+                    facetExpCtx->opCtx = opCtx;
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    workerOpCtxs.erase(workerOpCtx.get());
+                });
+                drain(facetId);
+            }
+        } catch (...) {
+            taskError = std::current_exception();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (taskError && !error) {
+            error = taskError;
+        }
+        if (--numRemaining == 0) {
+            allDone.notify_all();
+        }
+    };
+
+    vector<size_t> facetsToRun;
+    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+        if (!(*eof)[facetId]) {
+            facetsToRun.push_back(facetId);
+        }
+    }
+    if (facetsToRun.empty()) {
+        return;
+    }
+    numRemaining = facetsToRun.size();
+
+    // The first facet is run on this thread and the rest on the shared pool.
+    auto& pool = facetWorkerPool(opCtx->getServiceContext()).threadPool;
+    for (size_t i = 1; i < facetsToRun.size(); ++i) {
+        const size_t facetId = facetsToRun[i];
+        Status status = pool.schedule([&runTask, facetId] { runTask(facetId, true); });
+        if (!status.isOK()) {
+            // The pool is shutting down, so run the facet ourselves.
+            runTask(facetId, false);
+        }
+    }
+    runTask(facetsToRun.front(), false);
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    Status waitStatus =
+        opCtx->waitForConditionOrInterruptNoAssert(allDone, lk, [&] { return numRemaining == 0; });
+    if (!waitStatus.isOK()) {
+        killStatus = waitStatus;
+        for (auto&& workerOpCtx : workerOpCtxs) {
+            killWorker(workerOpCtx);
+        }
+        allDone.wait(lk, [&] { return numRemaining == 0; });
+        uassertStatusOK(waitStatus);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
@@ -319,11 +503,26 @@ intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     boost::optional<std::string> needsMongoS;
     boost::optional<std::string> needsShard;
 
+    const auto rawFacets = extractRawPipelines(elem);
+
+    // Facets which may be run in parallel are each given an ExpressionContext of their own. This is
+    // only done at the top level of a pipeline with no variables in scope, since the facets would
+    // otherwise need to share the variables of the enclosing pipeline.
+    const bool mayRunInParallel = internalQueryEnableParallelFacets.load() &&
+        rawFacets.size() > 1 && expCtx->subPipelineDepth == 0 &&
+        !expCtx->variablesParseState.hasDefinedVariables();
+
     std::vector<FacetPipeline> facetPipelines;
-    for (auto&& rawFacet : extractRawPipelines(elem)) {
+    for (auto&& rawFacet : rawFacets) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, expCtx));
+        auto facetExpCtx = expCtx;
+        if (mayRunInParallel) {
+            facetExpCtx = expCtx->copyWith(expCtx->ns, expCtx->uuid);
+            facetExpCtx->variables = expCtx->variables;
+        }
+        auto pipeline =
+            uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, facetExpCtx));
 
         // Validate that none of the facet pipelines have any conflicting HostTypeRequirements. This
         // verifies both that all stages within each pipeline are consistent, and that the pipelines
@@ -150,9 +150,25 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if the facets can each be run on their own thread. Every facet must have been
+     * parsed with an ExpressionContext of its own, and none may read from another collection.
+     */
+    bool canRunFacetsInParallel() const;
+
+    /**
+     * Runs every facet which has not yet reached EOF over the current batch of '_teeBuffer', each
+     * on its own thread, appending what they return to 'results' and recording which reached EOF
+     * in 'eof'.
+     */
+    void runFacetsOnBatch(std::vector<std::vector<Value>>* results, std::vector<char>* eof);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
+    // True if the facets are run concurrently, with '_teeBuffer' loaded by this stage.
+    bool _runInParallel = false;
+
     bool _done = false;
 };
 }  // namespace mongo
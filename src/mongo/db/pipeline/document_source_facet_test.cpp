@@ -44,8 +44,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -407,6 +409,51 @@ TEST_F(DocumentSourceFacetTest, ShouldBeAbleToEvaluateMultipleStagesWithinOneSub
     ASSERT_DOCUMENT_EQ(output.getDocument(), Document(fromjson("{subPipe: [{_id: 0}, {_id: 1}]}")));
 }
 
+TEST_F(DocumentSourceFacetTest, ShouldProduceTheSameResultsWhenFacetsRunInParallel) {
+    const bool oldParallelFacets = internalQueryEnableParallelFacets.load();
+    internalQueryEnableParallelFacets.store(true);
+    ON_BLOCK_EXIT([&] { internalQueryEnableParallelFacets.store(oldParallelFacets); });
+
+    // Small enough that the input is split over several batches.
+    const int oldBufferSize = internalQueryFacetBufferSizeBytes.load();
+    internalQueryFacetBufferSizeBytes.store(1024);
+    ON_BLOCK_EXIT([&] { internalQueryFacetBufferSizeBytes.store(oldBufferSize); });
+
+    auto ctx = getExpCtx();
+    auto spec = fromjson(
+        "{$facet: {all: [{$project: {_id: 0, x: 1}}],"
+        "          first: [{$limit: 2}, {$project: {_id: 1}}],"
+        "          grouped: [{$group: {_id: null, total: {$sum: '$x'}}}],"
+        "          sorted: [{$sort: {x: -1}}, {$skip: 3}, {$project: {x: 1, _id: 0}}]}}");
+    auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    vector<Value> expectedAll;
+    vector<Value> expectedSorted;
+    const int nDocs = 250;
+    for (int i = 0; i < nDocs; ++i) {
+        inputs.emplace_back(Document{{"_id", i}, {"x", i}});
+        expectedAll.emplace_back(Document{{"x", i}});
+    }
+    for (int i = nDocs - 4; i >= 0; --i) {
+        expectedSorted.emplace_back(Document{{"x", i}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    facetStage->setSource(mock.get());
+
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT_VALUE_EQ(output.getDocument()["all"], Value(expectedAll));
+    ASSERT_VALUE_EQ(output.getDocument()["first"],
+                    Value(vector<Value>{Value(Document{{"_id", 0}}), Value(Document{{"_id", 1}})}));
+    ASSERT_VALUE_EQ(output.getDocument()["grouped"],
+                    Value(vector<Value>{Value(Document{{"_id", BSONNULL},
+                                                       {"total", nDocs * (nDocs - 1) / 2}})}));
+    ASSERT_VALUE_EQ(output.getDocument()["sorted"], Value(expectedSorted));
+
+    ASSERT(facetStage->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldPropagateDisposeThroughToSource) {
     auto ctx = getExpCtx();
 
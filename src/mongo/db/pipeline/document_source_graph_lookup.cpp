@@ -31,6 +31,9 @@
 
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 
+#include <algorithm>
+#include <boost/filesystem/operations.hpp>
+
 #include "mongo/base/init.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
@@ -40,8 +43,11 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/destructor_guard.h"
 
 namespace mongo {
 
@@ -49,6 +55,25 @@ using boost::intrusive_ptr;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number.
+ *
+ * Each user of the Sorter must implement this function to ensure that all temporary files that the
+ * Sorter instances produce are uniquely identified using a unique file name extension with separate
+ * atomic variable. This is necessary because the sorter.cpp code is separately included in multiple
+ * places, rather than compiled in one place and linked, and so cannot provide a globally unique ID.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> documentSourceGraphLookupFileCounter;
+    return "extsort-doc-graph-lookup." +
+        std::to_string(documentSourceGraphLookupFileCounter.fetchAndAdd(1));
+}
+
+}  // namespace
+
 std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceGraphLookUp::liteParse(
     const AggregationRequest& request, const BSONElement& spec) {
     uassert(ErrorCodes::FailedToParse,
@@ -105,18 +130,13 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
-        // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+    while (auto result = getNextResult()) {
+        results.push_back(Value(std::move(*result)));
     }
 
     MutableDocument output(*_input);
     output.setNestedField(_as, Value(std::move(results)));
 
-    _visitedUsageBytes = 0;
-
     invariant(_visited.empty());
 
     return output.freeze();
@@ -128,7 +148,8 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        auto result = getNextResult();
+        if (!result) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -139,12 +160,12 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
 
             _input = input.releaseDocument();
             performSearch();
-            _visitedUsageBytes = 0;
             _outputIndex = 0;
+            result = getNextResult();
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!result) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -158,13 +179,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(std::move(*result)));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
@@ -174,7 +193,151 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
+    clearResults();
+}
+
+boost::optional<Document> DocumentSourceGraphLookUp::getNextResult() {
+    while (_pendingResults.empty()) {
+        if (!loadNextResults()) {
+            return boost::none;
+        }
+    }
+
+    auto result = std::move(_pendingResults.front());
+    _pendingResults.pop_front();
+    return result;
+}
+
+bool DocumentSourceGraphLookUp::loadNextResults() {
+    // Results are moved out one at a time to avoid consuming more memory, unless their full
+    // documents must be fetched, which is done for a batch at a time.
+    const size_t batchSize =
+        _fetchFullDocuments ? internalDocumentSourceGraphLookupMaxQueryValues.load() : 1;
+    while (_pendingResults.size() < batchSize) {
+        if (!_visited.empty()) {
+            auto it = _visited.begin();
+            _pendingResults.push_back(std::move(it->second));
+            _visited.erase(it);
+        } else if (!_spilledRuns.empty()) {
+            auto& run = _spilledRuns.back();
+            if (run->more()) {
+                _pendingResults.push_back(run->next().second);
+            } else {
+                _spilledRuns.pop_back();
+            }
+        } else {
+            break;
+        }
+    }
+
+    if (_pendingResults.empty()) {
+        return false;
+    }
+
+    if (_fetchFullDocuments) {
+        fetchFullDocuments();
+    }
+    return true;
+}
+
+void DocumentSourceGraphLookUp::fetchFullDocuments() {
+    BSONObjBuilder match;
+    {
+        BSONObjBuilder query(match.subobjStart("$match"));
+        BSONObjBuilder idObj(query.subobjStart("_id"));
+        BSONArrayBuilder in(idObj.subarrayStart("$in"));
+        for (auto&& result : _pendingResults) {
+            in << result["_id"];
+        }
+    }
+
+    auto fullDocuments = ValueComparator::kInstance.makeUnorderedValueMap<Document>();
+    auto pipeline = makeFromPipeline(match.obj(), false);
+    while (auto next = pipeline->getNext()) {
+        auto id = (*next)["_id"];
+        fullDocuments[id] = std::move(*next);
+    }
+
+    std::deque<Document> results;
+    for (auto&& result : _pendingResults) {
+        auto it = fullDocuments.find(result["_id"]);
+        if (it == fullDocuments.end()) {
+            // The document was removed after the search found it.
+            continue;
+        }
+
+        if (_depthField) {
+            MutableDocument fullDocument(std::move(it->second));
+            fullDocument.setNestedField(*_depthField, result.getNestedField(*_depthField));
+            results.push_back(fullDocument.freeze());
+        } else {
+            results.push_back(std::move(it->second));
+        }
+    }
+    _pendingResults = std::move(results);
+}
+
+void DocumentSourceGraphLookUp::clearResults() {
     _visited.clear();
+    _visitedUsageBytes = 0;
+    _pendingResults.clear();
+
+    _spilledRuns.clear();
+    _spilledIds.clear();
+    _spilledIdsUsageBytes = 0;
+    if (_nextSpillFileOffset > 0) {
+        // The runs of the last search are no longer needed, so the file can be reused.
+        boost::filesystem::remove(_spillFileName);
+        _nextSpillFileOffset = 0;
+    }
+}
+
+void DocumentSourceGraphLookUp::spillVisited() {
+    _usedDisk = true;
+
+    // The documents are written in no particular order, since a run is only ever read back in
+    // full.
+    SortedFileWriter<Value, Document> writer(
+        SortOptions().TempDir(pExpCtx->tempDir), _spillFileName, _nextSpillFileOffset);
+    for (auto&& entry : _visited) {
+        writer.addAlreadySorted(entry.first, entry.second);
+        _spilledIdsUsageBytes += entry.first.getApproximateSize();
+        _spilledIds.insert(entry.first);
+    }
+    _spilledRuns.emplace_back(writer.done());
+    _nextSpillFileOffset = writer.getFileEndOffset();
+
+    _visited.clear();
+    _visitedUsageBytes = _spilledIdsUsageBytes;
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceGraphLookUp::makeFromPipeline(
+    BSONObj matchStage, bool onlySearchFields) {
+    // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+    _fromPipeline.back() = std::move(matchStage);
+    if (!onlySearchFields) {
+        return pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx);
+    }
+
+    // Project out everything but the fields the search needs. A path is left out of the projection
+    // if it is within another one, since the projection would otherwise have a path collision.
+    std::vector<std::string> paths{
+        "_id", _connectFromField.fullPath(), _connectToField.fullPath()};
+    std::sort(paths.begin(), paths.end());
+    BSONObjBuilder projection;
+    StringData lastPath;
+    for (auto&& path : paths) {
+        if (!lastPath.empty() &&
+            (path == lastPath || str::startsWith(path, lastPath.toString() + '.'))) {
+            continue;
+        }
+        projection.append(path, 1);
+        lastPath = path;
+    }
+
+    auto fromPipeline = _fromPipeline;
+    fromPipeline.push_back(BSON("$project" << projection.obj()));
+    return pExpCtx->mongoProcessInterface->makePipeline(fromPipeline, _fromExpCtx);
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -185,7 +348,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
         // Check whether each key in the frontier exists in the cache or needs to be queried.
         auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
-        auto matchStage = makeMatchStageFromFrontier(&cached);
+        auto matchStages = makeMatchStagesFromFrontier(&cached);
 
         ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
         _frontier.swap(queried);
@@ -200,14 +363,10 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             checkMemoryUsage();
         }
 
-        if (matchStage) {
-            // Query for all keys that were in the frontier and not in the cache, populating
-            // '_frontier' for the next iteration of search.
-
-            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
-            auto pipeline =
-                pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx);
+        // Query for all keys that were in the frontier and not in the cache, populating
+        // '_frontier' for the next iteration of search.
+        for (auto&& matchStage : matchStages) {
+            auto pipeline = makeFromPipeline(std::move(matchStage), _fetchFullDocuments);
             while (auto next = pipeline->getNext()) {
                 uassert(40271,
                         str::stream()
@@ -234,7 +393,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() || _spilledIds.find(id) != _spilledIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -281,7 +440,7 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
         });
 }
 
-boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
+std::vector<BSONObj> DocumentSourceGraphLookUp::makeMatchStagesFromFrontier(
     DocumentUnorderedSet* cached) {
     // Add any cached values to 'cached' and remove them from '_frontier'.
     for (auto it = _frontier.begin(); it != _frontier.end();) {
@@ -299,40 +458,49 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
-    // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
+    // Create queries of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]},
+    // splitting the frontier between as many as it takes to keep each $in bounded.
     //
-    // We wrap the query in a $match so that it can be parsed into a DocumentSourceMatch when
+    // We wrap each query in a $match so that it can be parsed into a DocumentSourceMatch when
     // constructing a pipeline to execute.
-    BSONObjBuilder match;
-    {
-        BSONObjBuilder query(match.subobjStart("$match"));
+    const size_t maxValuesPerQuery = internalDocumentSourceGraphLookupMaxQueryValues.load();
+    std::vector<BSONObj> matchStages;
+    for (auto it = _frontier.begin(); it != _frontier.end();) {
+        BSONObjBuilder match;
         {
-            BSONArrayBuilder andObj(query.subarrayStart("$and"));
-            if (_additionalFilter) {
-                andObj << *_additionalFilter;
-            }
-
+            BSONObjBuilder query(match.subobjStart("$match"));
             {
-                BSONObjBuilder connectToObj(andObj.subobjStart());
+                BSONArrayBuilder andObj(query.subarrayStart("$and"));
+                if (_additionalFilter) {
+                    andObj << *_additionalFilter;
+                }
+
                 {
-                    BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
+                    BSONObjBuilder connectToObj(andObj.subobjStart());
                     {
-                        BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
-                            in << value;
+                        BSONObjBuilder subObj(
+                            connectToObj.subobjStart(_connectToField.fullPath()));
+                        {
+                            BSONArrayBuilder in(subObj.subarrayStart("$in"));
+                            for (size_t n = 0; n < maxValuesPerQuery && it != _frontier.end();
+                                 ++n, ++it) {
+                                in << *it;
+                            }
                         }
                     }
                 }
             }
         }
+        matchStages.push_back(match.obj());
     }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return matchStages;
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
     // Make sure _input is set before calling performSearch().
     invariant(_input);
+    clearResults();
 
     Value startingValue = _startWith->evaluate(*_input);
 
@@ -377,7 +545,11 @@ Pipeline::SourceContainer::iterator DocumentSourceGraphLookUp::doOptimizeAt(
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if (_allowDiskUse && !_visited.empty() &&
+        (_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes) {
+        spillVisited();
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
@@ -453,10 +625,18 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
+      _fetchFullDocuments(internalDocumentSourceGraphLookupFetchDocumentsAfterSearch.load()),
+      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc) {
+    if (_allowDiskUse) {
+        _spillFileName = pExpCtx->tempDir + "/" + nextFileName();
+    }
+
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
     _fromExpCtx = pExpCtx->copyWith(resolvedNamespace.ns);
     _fromPipeline = resolvedNamespace.pipeline;
@@ -467,6 +647,13 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
     _fromPipeline.push_back(BSON("$match" << BSONObj()));
 }
 
+DocumentSourceGraphLookUp::~DocumentSourceGraphLookUp() {
+    _spilledRuns.clear();
+    if (!_spillFileName.empty()) {
+        DESTRUCTOR_GUARD(boost::filesystem::remove(_spillFileName));
+    }
+}
+
 intrusive_ptr<DocumentSourceGraphLookUp> DocumentSourceGraphLookUp::create(
     const intrusive_ptr<ExpressionContext>& expCtx,
     NamespaceString fromNs,
@@ -600,3 +787,6 @@ void DocumentSourceGraphLookUp::addInvolvedCollections(
     }
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -29,11 +29,16 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
+#include <vector>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -42,6 +47,8 @@ public:
     static std::unique_ptr<LiteParsedDocumentSourceForeignCollections> liteParse(
         const AggregationRequest& request, const BSONElement& spec);
 
+    ~DocumentSourceGraphLookUp();
+
     GetNextResult getNext() final;
 
     const char* getSourceName() const final;
@@ -66,7 +73,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      hostRequirement,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed);
 
@@ -90,6 +97,10 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx) final;
 
+    bool usedDisk() final {
+        return _usedDisk;
+    }
+
     static boost::intrusive_ptr<DocumentSourceGraphLookUp> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         NamespaceString fromNs,
@@ -133,15 +144,22 @@ private:
     }
 
     /**
-     * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
+     * Prepares the queries to execute on the 'from' collection wrapped in a $match by using the
+     * contents of '_frontier'. Each query searches for at most
+     * 'internalDocumentSourceGraphLookupMaxQueryValues' values.
      *
      * Fills 'cached' with any values that were retrieved from the cache.
      *
-     * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
-     * Otherwise, returns a query object.
+     * Returns no queries if all values were retrieved from the cache.
+     */
+    std::vector<BSONObj> makeMatchStagesFromFrontier(DocumentUnorderedSet* cached);
+
+    /**
+     * Makes a pipeline over the 'from' collection which runs 'matchStage'. If 'onlySearchFields' is
+     * true, the pipeline only returns the fields of each document needed by the search.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    std::unique_ptr<Pipeline, PipelineDeleter> makeFromPipeline(BSONObj matchStage,
+                                                                bool onlySearchFields);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -161,6 +179,34 @@ private:
      */
     void performSearch();
 
+    /**
+     * Returns the next document found by the last search, or boost::none if there are no more.
+     */
+    boost::optional<Document> getNextResult();
+
+    /**
+     * Moves the next results of the last search from '_visited' or '_spilledRuns' into
+     * '_pendingResults', fetching their full documents if the search did not retrieve them.
+     * Returns false if there were no more results.
+     */
+    bool loadNextResults();
+
+    /**
+     * Replaces each of '_pendingResults' by the full document with the same _id, dropping any
+     * which no longer exist.
+     */
+    void fetchFullDocuments();
+
+    /**
+     * Discards what is left of the results of the last search, including any spilled to disk.
+     */
+    void clearResults();
+
+    /**
+     * Writes the documents in '_visited' to disk, keeping only their _ids in memory.
+     */
+    void spillVisited();
+
     /**
      * Updates '_cache' with 'result' appropriately, given that 'result' was retrieved when querying
      * for 'queried'.
@@ -168,8 +214,9 @@ private:
     void addToCache(const Document& result, const ValueUnorderedSet& queried);
 
     /**
-     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * Assert that '_visited' and '_frontier' have not exceeded the maximum memory usage, spilling
+     * '_visited' to disk first if allowed to, and then evict from '_cache' until this source is
+     * using less than '_maxMemoryUsageBytes'.
      */
     void checkMemoryUsage();
 
@@ -198,7 +245,17 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    const size_t _maxMemoryUsageBytes;
+
+    // If true, the search only retrieves the fields it needs and the full documents it found are
+    // fetched as they are returned.
+    const bool _fetchFullDocuments;
+
+    // If true, '_visited' is spilled to '_spillFileName' when it would exceed the memory limit.
+    const bool _allowDiskUse;
+    bool _usedDisk = false;
+    std::string _spillFileName;
+    unsigned int _nextSpillFileOffset = 0;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -212,6 +269,16 @@ private:
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // The documents of the current search which were spilled to disk, and their '_id' values. The
+    // '_id' values stay in memory, and count towards '_visitedUsageBytes', so that the search can
+    // still tell which nodes it has already visited.
+    std::vector<std::shared_ptr<Sorter<Value, Document>::Iterator>> _spilledRuns;
+    ValueUnorderedSet _spilledIds;
+    size_t _spilledIdsUsageBytes = 0;
+
+    // Results of the last search which are ready to be returned.
+    std::deque<Document> _pendingResults;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
@@ -38,9 +38,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -615,5 +618,154 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Returns the documents of a chain 0 -> 1 -> ... -> 'length' - 1, each of which has a 'payload'.
+ */
+std::vector<Document> makeChain(int length, const std::string& payload) {
+    std::vector<Document> chain;
+    for (int i = 0; i < length; ++i) {
+        chain.push_back(Document{{"_id", i}, {"next", i + 1}, {"payload", payload}});
+    }
+    return chain;
+}
+
+boost::intrusive_ptr<DocumentSourceGraphLookUp> makeChainLookup(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const std::vector<Document>& chain,
+    boost::optional<FieldPath> depthField = boost::none) {
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (auto&& doc : chain) {
+        fromContents.emplace_back(Document(doc));
+    }
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    return DocumentSourceGraphLookUp::create(expCtx,
+                                             fromNs,
+                                             "results",
+                                             "next",
+                                             "_id",
+                                             ExpressionFieldPath::create(expCtx, "startVal"),
+                                             boost::none,
+                                             depthField,
+                                             boost::none,
+                                             boost::none);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSplitLargeFrontiersIntoSeveralQueries) {
+    const int oldMaxQueryValues = internalDocumentSourceGraphLookupMaxQueryValues.load();
+    internalDocumentSourceGraphLookupMaxQueryValues.store(2);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxQueryValues.store(oldMaxQueryValues); });
+
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"startVal", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    // The root links to five leaves, which are all on the frontier at once.
+    Document root{{"_id", 0}, {"next", Value(std::vector<Value>{Value(1), Value(2), Value(3),
+                                                                 Value(4), Value(5)})}};
+    std::vector<Document> graph{root};
+    for (int i = 1; i <= 5; ++i) {
+        graph.push_back(Document{{"_id", i}});
+    }
+    auto graphLookupStage = makeChainLookup(expCtx, graph);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(graph.size(), resultsArray.size());
+    for (auto&& doc : graph) {
+        ASSERT(arrayContains(expCtx, resultsArray, Value(doc)));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldReturnFullDocumentsWhenFetchingThemAfterSearch) {
+    const bool oldFetchAfterSearch =
+        internalDocumentSourceGraphLookupFetchDocumentsAfterSearch.load();
+    internalDocumentSourceGraphLookupFetchDocumentsAfterSearch.store(true);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceGraphLookupFetchDocumentsAfterSearch.store(oldFetchAfterSearch);
+    });
+
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"startVal", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    const int chainLength = 10;
+    auto chain = makeChain(chainLength, "payload");
+    auto graphLookupStage = makeChainLookup(expCtx, chain, FieldPath("depth"));
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(size_t(chainLength), resultsArray.size());
+    for (int i = 0; i < chainLength; ++i) {
+        MutableDocument expected(chain[i]);
+        expected.setField("depth", Value(static_cast<long long>(i)));
+        ASSERT(arrayContains(expCtx, resultsArray, expected.freezeToValue()));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsWhenAllowedToUseDisk) {
+    const long long oldMaxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(oldMaxMemoryBytes); });
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"startVal", 0}},
+                                                     Document{{"_id", 1}, {"startVal", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    const int chainLength = 50;
+    auto chain = makeChain(chainLength, std::string(500, 'x'));
+    auto graphLookupStage = makeChainLookup(expCtx, chain);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(size_t(chainLength), resultsArray.size());
+    for (auto&& doc : chain) {
+        ASSERT(arrayContains(expCtx, resultsArray, Value(doc)));
+    }
+    ASSERT_TRUE(graphLookupStage->usedDisk());
+
+    // The second search starts over rather than seeing the nodes spilled by the first.
+    next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(size_t(chainLength), next.getDocument().getField("results").getArray().size());
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorOnExceedingMemoryLimitWithoutAllowDiskUse) {
+    const long long oldMaxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(oldMaxMemoryBytes); });
+
+    auto expCtx = getExpCtx();
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"startVal", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    auto graphLookupStage = makeChainLookup(expCtx, makeChain(50, std::string(500, 'x')));
+    graphLookupStage->setSource(inputMock.get());
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
 }  // namespace
 }  // namespace mongo
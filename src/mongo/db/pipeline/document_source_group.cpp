@@ -32,6 +32,7 @@
 #include <boost/filesystem/operations.hpp>
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
@@ -41,7 +42,11 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/destructor_guard.h"
 
 namespace mongo {
@@ -62,6 +67,75 @@ std::string nextFileName() {
     return "extsort-doc-group." + std::to_string(documentSourceGroupFileCounter.fetchAndAdd(1));
 }
 
+/**
+ * A partition which still exceeds the memory limit after this many rounds of repartitioning is
+ * re-aggregated in memory regardless. Its keys no longer split, so it holds few groups whose
+ * partial aggregates are each large.
+ */
+const int kMaxPartitionDepth = 3;
+
+/**
+ * Picks the partition for a group key from the hash of the key. The hash is remixed with the depth
+ * of the partitioning, so that the keys of a partition that has to be split again are spread over
+ * all of the finer partitions rather than landing in the same one.
+ */
+size_t partitionForKey(size_t keyHash, int depth, size_t numPartitions) {
+    uint64_t h = keyHash + static_cast<uint64_t>(depth + 1) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h % numPartitions;
+}
+
+// When aggregating on several threads, input documents are aggregated in batches of up to this
+// many documents or bytes.
+const size_t kMaxPendingInputs = 4096;
+const size_t kMaxPendingInputsBytes = 16 * 1024 * 1024;
+
+// Ranges smaller than this are not worth handing to another thread.
+const size_t kMinInputsPerTask = 256;
+
+/**
+ * The threads on which every $group stage in the process aggregates its input.
+ */
+struct DocumentSourceGroupPool {
+    DocumentSourceGroupPool()
+        : threadPool([] {
+              ThreadPool::Options options;
+              options.poolName = "DocumentSourceGroup";
+              options.threadNamePrefix = "DocumentSourceGroup-";
+              options.minThreads = 0;
+              options.maxThreads = 64;
+              return options;
+          }()) {}
+
+    ThreadPool threadPool;
+};
+
+const auto documentSourceGroupPool = ServiceContext::declareDecoration<DocumentSourceGroupPool>();
+const ServiceContext::ConstructorActionRegisterer documentSourceGroupPoolRegisterer{
+    "DocumentSourceGroupPool",
+    [](ServiceContext* service) { documentSourceGroupPool(service).threadPool.startup(); },
+    [](ServiceContext* service) {
+        auto& pool = documentSourceGroupPool(service).threadPool;
+        pool.shutdown();
+        pool.join();
+    }};
+
+/**
+ * Returns true if evaluating 'expr' neither reads nor writes the variables of its expression
+ * context.
+ */
+bool canEvaluateConcurrently(const boost::intrusive_ptr<Expression>& expr) {
+    if (dynamic_cast<ExpressionConstant*>(expr.get())) {
+        return true;
+    }
+    auto fieldPathExpr = dynamic_cast<ExpressionFieldPath*>(expr.get());
+    return fieldPathExpr && fieldPathExpr->isRootFieldPath();
+}
+
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -147,7 +221,9 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
         accum->reset();  // Prep accumulators for a new group.
     }
 
-    if (_spilled) {
+    if (_partitioned) {
+        return getNextPartitioned();
+    } else if (_spilled) {
         return getNextSpilled();
     } else {
         return getNextStandard();
@@ -160,22 +236,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
         return GetNextResult::makeEOF();
 
     _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
     while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
         // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
         // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
-                }
-            }
-        }
+        mergeSerializedAccumulators(_firstPartOfNextGroup.second, &_currentAccumulators);
 
         if (!_sorterIterator->more()) {
             dispose();
@@ -188,6 +252,21 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
     return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
 }
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextPartitioned() {
+    // We aren't streaming, and we have spilled to disk by partition. Re-aggregate partitions until
+    // one of them produces groups to return.
+    while (groupsIterator == _groups->end()) {
+        if (_pendingPartitions.empty()) {
+            return GetNextResult::makeEOF();
+        }
+        loadNextPartition();
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    ++groupsIterator;
+    return std::move(out);
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     // Not spilled, and not streaming.
     if (_groups->empty())
@@ -203,8 +282,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
-    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _groups = pExpCtx->getValueComparator().makeFlatUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _partitions.clear();
+    _pendingPartitions.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -259,7 +340,26 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+void DocumentSourceGroup::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (_unwindSrc) {
+        _unwindSrc->serializeToArray(array, explain);
+    }
+    DocumentSource::serializeToArray(array, explain);
+}
+
+void DocumentSourceGroup::setUnwindSource(intrusive_ptr<DocumentSourceUnwind> unwind) {
+    invariant(canAbsorbUnwind());
+    _unwinder = unwind->createUnwinder();
+    _unwindSrc = std::move(unwind);
+}
+
 DepsTracker::State DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
+    // An absorbed $unwind reads the array it unwinds from the input.
+    if (_unwindSrc) {
+        _unwindSrc->getDependencies(deps);
+    }
+
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
         _idExpressions[i]->addDependencies(deps);
@@ -275,7 +375,19 @@ DepsTracker::State DocumentSourceGroup::getDependencies(DepsTracker* deps) const
 
 DocumentSource::GetModPathsReturn DocumentSourceGroup::getModifiedPaths() const {
     // We preserve none of the fields, but any fields referenced as part of the group key are
-    // logically just renamed.
+    // logically just renamed, unless an absorbed $unwind has changed them.
+    std::set<std::string> unwindPaths;
+    if (_unwindSrc) {
+        unwindPaths = _unwindSrc->getModifiedPaths().paths;
+    }
+    const auto isModifiedByUnwind = [&unwindPaths](const std::string& path) {
+        return std::any_of(
+            unwindPaths.begin(), unwindPaths.end(), [&path](const std::string& unwindPath) {
+                return path == unwindPath || expression::isPathPrefixOf(path, unwindPath) ||
+                    expression::isPathPrefixOf(unwindPath, path);
+            });
+    };
+
     StringMap<std::string> renames;
     for (std::size_t i = 0; i < _idExpressions.size(); ++i) {
         auto idExp = _idExpressions[i];
@@ -283,7 +395,9 @@ DocumentSource::GetModPathsReturn DocumentSourceGroup::getModifiedPaths() const
             _idFieldNames.empty() ? "_id" : "_id." + _idFieldNames[i];
         auto computedPaths = idExp->getComputedPaths(pathToPutResultOfExpression);
         for (auto&& rename : computedPaths.renames) {
-            renames[rename.first] = rename.second;
+            if (!isModifiedByUnwind(rename.second)) {
+                renames[rename.first] = rename.second;
+            }
         }
     }
 
@@ -316,7 +430,7 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _maxMemoryUsageBytes(maxMemoryUsageBytes ? *maxMemoryUsageBytes
                                                : internalDocumentSourceGroupMaxMemoryBytes.load()),
       _initialized(false),
-      _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
+      _groups(pExpCtx->getValueComparator().makeFlatUnorderedValueMap<Accumulators>()),
       _spilled(false),
       _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
     if (!pExpCtx->inMongos && (pExpCtx->allowDiskUse || kDebugBuild)) {
@@ -450,67 +564,41 @@ private:
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
-    const size_t numAccumulators = _accumulatedFields.size();
+    const size_t numThreads =
+        canAggregateConcurrently() ? internalDocumentSourceGroupThreads.load() : 1;
 
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
     for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
+        if (numThreads > 1) {
+            _pendingInputsBytes += input.getDocument().getApproximateSize();
+            _pendingInputs.push_back(input.releaseDocument());
+            if (_pendingInputs.size() >= kMaxPendingInputs ||
+                _pendingInputsBytes >= kMaxPendingInputsBytes) {
+                aggregatePendingInputs(numThreads);
+            }
+            continue;
         }
 
         // We release the result document here so that it does not outlive the end of this loop
         // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
-            }
+        if (!_unwinder) {
+            processDocument(input.releaseDocument());
+            continue;
         }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
-
-            _memoryUsageBytes += group[i]->memUsageForSorter();
+        // Likewise, each unwound document is released before the next one is unwound, so that the
+        // unwinder can set the next array element in place rather than copy the document.
+        _unwinder->resetDocument(input.releaseDocument());
+        for (auto unwound = _unwinder->getNext(); unwound.isAdvanced();
+             unwound = _unwinder->getNext()) {
+            pExpCtx->checkForInterrupt();
+            processDocument(unwound.releaseDocument());
         }
+    }
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
-
-                _sortedFiles.push_back(spill());
-            }
-        }
+    if (!_pendingInputs.empty()) {
+        aggregatePendingInputs(numThreads);
     }
 
     switch (input.getStatus()) {
@@ -522,24 +610,39 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (_partitioned) {
+                _spilled = true;
+                if (!_groups->empty()) {
+                    spillToPartitions(&_partitions);
+                }
+
+                for (auto&& partition : _partitions) {
+                    if (!partition.runs.empty()) {
+                        _pendingPartitions.push_back(std::move(partition));
+                    }
+                }
+                _partitions.clear();
+
+                // The first partition is loaded by getNextPartitioned().
+                groupsIterator = _groups->end();
+            } else if (!_sortedFiles.empty()) {
                 _spilled = true;
                 if (!_groups->empty()) {
                     _sortedFiles.push_back(spill());
                 }
 
                 // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _groups = pExpCtx->getValueComparator().makeFlatUnorderedValueMap<Accumulators>();
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles,
                     _fileName,
-                    SortOptions(),
+                    SortOptions().MaxMemoryUsageBytes(_maxMemoryUsageBytes),
                     SorterComparator(pExpCtx->getValueComparator())));
                 _ownsFileDeletion = false;
 
                 // prepare current to accumulate data
-                _currentAccumulators.reserve(numAccumulators);
+                _currentAccumulators.reserve(_accumulatedFields.size());
                 for (auto&& accumulatedField : _accumulatedFields) {
                     _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
                 }
@@ -560,6 +663,234 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     MONGO_UNREACHABLE;
 }
 
+void DocumentSourceGroup::spillIfMemoryLimitExceeded() {
+    if (_memoryUsageBytes <= _maxMemoryUsageBytes) {
+        return;
+    }
+
+    uassert(16945,
+            "Exceeded memory limit for $group, but didn't allow external sort."
+            " Pass allowDiskUse:true to opt in.",
+            _allowDiskUse);
+
+    // The spill strategy is chosen at the first spill and kept for the rest of the input.
+    if (_sortedFiles.empty() && !_partitioned) {
+        const int numPartitions = internalDocumentSourceGroupSpillPartitions.load();
+        if (numPartitions >= 2) {
+            _partitioned = true;
+            _numSpillPartitions = numPartitions;
+            _partitions.resize(_numSpillPartitions);
+        }
+    }
+
+    if (_partitioned) {
+        spillToPartitions(&_partitions);
+    } else {
+        _sortedFiles.push_back(spill());
+    }
+    _memoryUsageBytes = 0;
+}
+
+DocumentSourceGroup::Accumulators& DocumentSourceGroup::getGroupForUpdate(const Value& id,
+                                                                          bool* inserted) {
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    Accumulators& group = (*_groups)[id];
+    *inserted = _groups->size() != oldSize;
+
+    if (*inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(_accumulatedFields.size());
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= groupObj->memUsageForSorter();
+        }
+    }
+    return group;
+}
+
+bool DocumentSourceGroup::canAggregateConcurrently() const {
+    return std::all_of(_idExpressions.begin(), _idExpressions.end(), canEvaluateConcurrently) &&
+        std::all_of(_accumulatedFields.begin(),
+                    _accumulatedFields.end(),
+                    [](const AccumulationStatement& accumulatedField) {
+                        return canEvaluateConcurrently(accumulatedField.expression);
+                    });
+}
+
+void DocumentSourceGroup::processDocument(const Document& rootDocument) {
+    const size_t numAccumulators = _accumulatedFields.size();
+
+    spillIfMemoryLimitExceeded();
+
+    Value id = computeId(rootDocument);
+
+    bool inserted;
+    Accumulators& group = getGroupForUpdate(id, &inserted);
+
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument), _doingMerge);
+
+        _memoryUsageBytes += group[i]->memUsageForSorter();
+    }
+
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&                 // is a dup
+            !pExpCtx->inMongos &&        // can't spill to disk in mongos
+            !_allowDiskUse &&            // don't change behavior when testing external sort
+            _sortedFiles.size() < 20) {  // don't open too many FDs
+
+            _sortedFiles.push_back(spill());
+        }
+    }
+}
+
+void DocumentSourceGroup::aggregatePendingInputs(size_t numThreads) {
+    const size_t numInputs = _pendingInputs.size();
+    const size_t numTasks =
+        std::max(size_t(1), std::min(numThreads, numInputs / kMinInputsPerTask));
+
+    vector<GroupsMap> partialGroups;
+    partialGroups.reserve(numTasks);
+    for (size_t task = 0; task < numTasks; ++task) {
+        partialGroups.push_back(
+            pExpCtx->getValueComparator().makeFlatUnorderedValueMap<Accumulators>());
+    }
+
+    // Only the partial groups of its own range are modified by each task. Consecutive inputs with
+    // the same group key are batched, so that their group is only looked up once and each of its
+    // accumulators processes all their values at once. With an absorbed $unwind, each task unwinds
+    // the inputs of its range itself.
+    const size_t rangeSize = (numInputs + numTasks - 1) / numTasks;
+    const auto aggregateRange = [&](size_t task) {
+        GroupsMap& groups = partialGroups[task];
+        vector<vector<Value>> batches(_accumulatedFields.size());
+        Accumulators* group = nullptr;
+        Value groupId;
+        auto unwinder = _unwindSrc ? _unwindSrc->createUnwinder() : nullptr;
+
+        const auto processBatches = [&] {
+            for (size_t j = 0; j < batches.size(); ++j) {
+                (*group)[j]->processBatch(batches[j].data(), batches[j].size(), _doingMerge);
+                batches[j].clear();
+            }
+        };
+
+        const auto aggregateDocument = [&](const Document& rootDocument) {
+            Value id = computeId(rootDocument);
+            if (!group || !pExpCtx->getValueComparator().evaluate(id == groupId)) {
+                if (group) {
+                    processBatches();
+                }
+
+                const size_t oldSize = groups.size();
+                group = &groups[id];
+                if (groups.size() != oldSize) {
+                    group->reserve(_accumulatedFields.size());
+                    for (auto&& accumulatedField : _accumulatedFields) {
+                        group->push_back(accumulatedField.makeAccumulator(pExpCtx));
+                    }
+                }
+                groupId = std::move(id);
+            }
+
+            for (size_t j = 0; j < batches.size(); ++j) {
+                batches[j].push_back(_accumulatedFields[j].expression->evaluate(rootDocument));
+            }
+        };
+
+        const size_t last = std::min((task + 1) * rangeSize, numInputs);
+        for (size_t i = task * rangeSize; i < last; ++i) {
+            if (!unwinder) {
+                aggregateDocument(_pendingInputs[i]);
+                continue;
+            }
+
+            unwinder->resetDocument(_pendingInputs[i]);
+            for (auto unwound = unwinder->getNext(); unwound.isAdvanced();
+                 unwound = unwinder->getNext()) {
+                aggregateDocument(unwound.releaseDocument());
+            }
+        }
+
+        if (group) {
+            processBatches();
+        }
+    };
+
+    if (numTasks == 1) {
+        aggregateRange(0);
+    } else {
+        // The first range is aggregated on this thread and the rest on the shared pool. Every
+        // range must finish before we go on, since the tasks refer to this frame.
+        stdx::mutex mutex;
+        stdx::condition_variable allDone;
+        size_t numRemaining = numTasks;
+        std::exception_ptr error;
+
+        const auto runTask = [&](size_t task) {
+            std::exception_ptr taskError;
+            try {
+                aggregateRange(task);
+            } catch (...) {
+                taskError = std::current_exception();
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (taskError && !error) {
+                error = taskError;
+            }
+            if (--numRemaining == 0) {
+                allDone.notify_all();
+            }
+        };
+
+        auto& pool = documentSourceGroupPool(pExpCtx->opCtx->getServiceContext()).threadPool;
+        for (size_t task = 1; task < numTasks; ++task) {
+            Status status = pool.schedule([&runTask, task] { runTask(task); });
+            if (!status.isOK()) {
+                // The pool is shutting down, so aggregate the range ourselves.
+                runTask(task);
+            }
+        }
+        runTask(0);
+
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        allDone.wait(lk, [&] { return numRemaining == 0; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    _pendingInputs.clear();
+    _pendingInputsBytes = 0;
+
+    for (auto&& groups : partialGroups) {
+        for (auto&& partialGroup : groups) {
+            spillIfMemoryLimitExceeded();
+
+            bool inserted;
+            Accumulators& group = getGroupForUpdate(partialGroup.first, &inserted);
+            for (size_t i = 0; i < group.size(); ++i) {
+                group[i]->process(partialGroup.second[i]->getValue(/*toBeMerged=*/true), true);
+                _memoryUsageBytes += group[i]->memUsageForSorter();
+            }
+        }
+    }
+}
+
 bool DocumentSourceGroup::usedDisk() {
     return _usedDisk;
 }
@@ -576,39 +907,144 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 
     SortedFileWriter<Value, Value> writer(
         SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        writer.addAlreadySorted(ptrs[i]->first, serializeAccumulators(ptrs[i]->second));
+    }
+
+    _groups->clear();
+
+    Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
+    _nextSortedFileWriterOffset = writer.getFileEndOffset();
+    return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
+}
+
+void DocumentSourceGroup::spillToPartitions(std::vector<SpilledPartition>* partitions) {
+    _usedDisk = true;
+    const size_t numPartitions = partitions->size();
+    const int depth = partitions->front().depth;
+
+    vector<vector<const GroupsMap::value_type*>> ptrsByPartition(numPartitions);
+    for (auto&& group : *_groups) {
+        const size_t keyHash = pExpCtx->getValueComparator().hash(group.first);
+        ptrsByPartition[partitionForKey(keyHash, depth, numPartitions)].push_back(&group);
+    }
+
+    // Each partition's groups are written as one run. The runs are not sorted, since a partition
+    // is re-aggregated by hashing rather than by merging.
+    for (size_t i = 0; i < numPartitions; i++) {
+        if (ptrsByPartition[i].empty()) {
+            continue;
+        }
+
+        SortedFileWriter<Value, Value> writer(
+            SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+        for (auto&& ptr : ptrsByPartition[i]) {
+            writer.addAlreadySorted(ptr->first, serializeAccumulators(ptr->second));
+        }
+        (*partitions)[i].runs.emplace_back(writer.done());
+        _nextSortedFileWriterOffset = writer.getFileEndOffset();
+    }
+
+    _groups->clear();
+}
+
+void DocumentSourceGroup::loadNextPartition() {
+    SpilledPartition partition = std::move(_pendingPartitions.front());
+    _pendingPartitions.pop_front();
+
+    // The runs are read one at a time. The two read-ahead buffers of the open run count toward the
+    // memory limit, and take up at most a quarter of it.
+    const size_t readAheadBytes =
+        std::min(SortOptions().readAheadBytes, std::max<size_t>(_maxMemoryUsageBytes / 8, 1));
+
+    _groups->clear();
+    _memoryUsageBytes = 2 * readAheadBytes;
+
+    // Only populated if the partition turns out not to fit in memory.
+    std::vector<SpilledPartition> subPartitions;
+
+    for (auto&& run : partition.runs) {
+        run->setReadAheadBytes(readAheadBytes);
+        run->openSource();
+        while (run->more()) {
+            if (_memoryUsageBytes > _maxMemoryUsageBytes && partition.depth < kMaxPartitionDepth) {
+                if (subPartitions.empty()) {
+                    subPartitions.resize(_numSpillPartitions);
+                    for (auto&& subPartition : subPartitions) {
+                        subPartition.depth = partition.depth + 1;
+                    }
+                }
+                spillToPartitions(&subPartitions);
+                _memoryUsageBytes = 2 * readAheadBytes;
             }
-            break;
 
-        case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+            auto next = run->next();
+            bool inserted;
+            Accumulators& group = getGroupForUpdate(next.first, &inserted);
+            mergeSerializedAccumulators(next.second, &group);
+            for (auto&& accum : group) {
+                _memoryUsageBytes += accum->memUsageForSorter();
             }
-            break;
+        }
+        run->closeSource();
+    }
 
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
-                }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+    if (!subPartitions.empty()) {
+        if (!_groups->empty()) {
+            spillToPartitions(&subPartitions);
+        }
+
+        // Finish the groups of this partition before moving on, so that the number of pending
+        // partitions stays bounded by the partition count times the depth.
+        for (auto it = subPartitions.rbegin(); it != subPartitions.rend(); ++it) {
+            if (!it->runs.empty()) {
+                _pendingPartitions.push_front(std::move(*it));
             }
-            break;
+        }
     }
 
-    _groups->clear();
+    groupsIterator = _groups->begin();
+}
 
-    Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
-    _nextSortedFileWriterOffset = writer.getFileEndOffset();
-    return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
+Value DocumentSourceGroup::serializeAccumulators(const Accumulators& accums) const {
+    switch (accums.size()) {
+        case 0:  // no values, essentially a distinct
+            return Value();
+
+        case 1:  // just one value, use optimized serialization as single Value
+            return accums[0]->getValue(/*toBeMerged=*/true);
+
+        default: {  // multiple values, serialize as array-typed Value
+            vector<Value> states;
+            states.reserve(accums.size());
+            for (auto&& accum : accums) {
+                states.push_back(accum->getValue(/*toBeMerged=*/true));
+            }
+            return Value(std::move(states));
+        }
+    }
 }
 
-Value DocumentSourceGroup::computeId(const Document& root) {
+void DocumentSourceGroup::mergeSerializedAccumulators(const Value& serialized,
+                                                      Accumulators* accums) const {
+    switch (accums->size()) {  // mirrors switch in serializeAccumulators()
+        case 0:
+            break;
+
+        case 1:
+            (*accums)[0]->process(serialized, true);
+            break;
+
+        default: {
+            const vector<Value>& states = serialized.getArray();
+            for (size_t i = 0; i < accums->size(); i++) {
+                (*accums)[i]->process(states[i], true);
+            }
+        }
+    }
+}
+
+Value DocumentSourceGroup::computeId(const Document& root) const {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
         Value retValue = _idExpressions[0]->evaluate(root);
@@ -707,6 +1143,11 @@ bool DocumentSourceGroup::canRunInParallelBeforeOut(
         return true;  // This is fine.
     }
 
+    if (_unwindSrc &&
+        !_unwindSrc->canRunInParallelBeforeOut(nameOfShardKeyFieldsUponEntryToStage)) {
+        return false;
+    }
+
     // Certain $group stages are allowed to execute on each exchange consumer. In order to
     // guarantee each consumer will only group together data from its own shard, the $group must
     // group on a superset of the shard key.
@@ -727,6 +1168,11 @@ bool DocumentSourceGroup::canRunInParallelBeforeOut(
 
 std::unique_ptr<GroupFromFirstDocumentTransformation>
 DocumentSourceGroup::rewriteGroupAsTransformOnFirstDocument() const {
+    if (_unwindSrc) {
+        // The first document of each group is an unwound document, not one that can be scanned.
+        return nullptr;
+    }
+
     if (!_idFieldNames.empty()) {
         // This transformation is only intended for $group stages that group on a single field.
         return nullptr;
@@ -29,12 +29,14 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <utility>
 
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/transformer_interface.h"
 #include "mongo/db/sorter/sorter.h"
 
@@ -89,13 +91,20 @@ private:
 class DocumentSourceGroup final : public DocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
-    using GroupsMap = ValueUnorderedMap<Accumulators>;
+    using GroupsMap = ValueFlatUnorderedMap<Accumulators>;
 
     static constexpr StringData kStageName = "$group"_sd;
 
     boost::intrusive_ptr<DocumentSource> optimize() final;
     DepsTracker::State getDependencies(DepsTracker* deps) const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * Serializes an absorbed $unwind as the stage it was absorbed from, followed by this stage.
+     */
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
     GetNextResult getNext() final;
     const char* getSourceName() const final;
     GetModPathsReturn getModifiedPaths() const final;
@@ -151,6 +160,20 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Returns true if an immediately preceding $unwind can be handed to setUnwindSource().
+     */
+    bool canAbsorbUnwind() const {
+        return !_doingMerge && !_unwindSrc;
+    }
+
+    /**
+     * Absorbs the $unwind stage which precedes this one. Each input document is then unwound as it
+     * is aggregated, so that the unwound documents are neither passed between stages nor held in
+     * '_pendingInputs'.
+     */
+    void setUnwindSource(boost::intrusive_ptr<DocumentSourceUnwind> unwind);
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -187,6 +210,7 @@ private:
      * initialize() to have been called already.
      */
     GetNextResult getNextSpilled();
+    GetNextResult getNextPartitioned();
     GetNextResult getNextStandard();
 
     /**
@@ -208,12 +232,76 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * A partition of the groups spilled to disk by hash of the group key. 'runs' holds one
+     * unsorted run for each spill that wrote groups to this partition, and 'depth' is the number of
+     * times the groups in the partition have been repartitioned.
+     */
+    struct SpilledPartition {
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> runs;
+        int depth = 0;
+    };
+
+    /**
+     * Writes each group in the groups map to the entry of 'partitions' chosen by the hash of its
+     * key and clears the map. A partition may hold many partial aggregates for the same key, one
+     * per spill, which are merged when the partition is read back by loadNextPartition().
+     */
+    void spillToPartitions(std::vector<SpilledPartition>* partitions);
+
+    /**
+     * Re-aggregates the next pending partition into the groups map. If the partition does not fit
+     * within the memory limit, its groups are instead split into finer partitions which are queued
+     * ahead of the remaining ones, and the groups map is left empty.
+     */
+    void loadNextPartition();
+
+    /**
+     * Serializes the partial aggregates in 'accums' for spilling, and merges serialized partial
+     * aggregates back into 'accums'.
+     */
+    Value serializeAccumulators(const Accumulators& accums) const;
+    void mergeSerializedAccumulators(const Value& serialized, Accumulators* accums) const;
+
+    /**
+     * Spills the groups map if it uses more than the memory limit, or throws if spilling is not
+     * allowed.
+     */
+    void spillIfMemoryLimitExceeded();
+
+    /**
+     * Returns the accumulators of the group for 'id' in the groups map, creating the group if it
+     * does not exist yet, and sets '*inserted' accordingly. The memory used by the accumulators is
+     * taken off '_memoryUsageBytes'; the caller adds it back once they have processed their input.
+     */
+    Accumulators& getGroupForUpdate(const Value& id, bool* inserted);
+
+    /**
+     * Adds the values of 'rootDocument' to the accumulators of its group in the groups map.
+     */
+    void processDocument(const Document& rootDocument);
+
+    /**
+     * Returns true if the group keys and accumulated expressions can be evaluated on several
+     * threads at once. That is the case when each of them is a constant or a path in the current
+     * document, neither of which reads or writes variables while being evaluated.
+     */
+    bool canAggregateConcurrently() const;
+
+    /**
+     * Aggregates '_pendingInputs' into the groups map on up to 'numThreads' threads. Each thread
+     * builds partial groups for a contiguous range of the inputs, and the partial groups are then
+     * merged in range order, so order-sensitive accumulators such as $first and $push see their
+     * inputs in the order they were read.
+     */
+    void aggregatePendingInputs(size_t numThreads);
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
      * Computes the internal representation of the group key.
      */
-    Value computeId(const Document& root);
+    Value computeId(const Document& root) const;
 
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
@@ -241,6 +329,15 @@ private:
 
     bool _initialized;
 
+    // An absorbed $unwind, and the Unwinder which unwinds each input document when aggregating on
+    // this thread.
+    boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
+    std::unique_ptr<DocumentSourceUnwind::Unwinder> _unwinder;
+
+    // Input documents read but not yet aggregated, when aggregating on several threads.
+    std::vector<Document> _pendingInputs;
+    size_t _pendingInputsBytes = 0;
+
     Value _currentId;
     Accumulators _currentAccumulators;
 
@@ -255,8 +352,16 @@ private:
     // Only used when '_spilled' is false.
     GroupsMap::iterator groupsIterator;
 
-    // Only used when '_spilled' is true.
+    // Only used when '_spilled' is true and '_partitioned' is false.
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
+
+    // Set when the groups were spilled by hash partition rather than as sorted runs. The partitions
+    // are written to '_partitions' while the input is consumed, and then re-aggregated one at a
+    // time from '_pendingPartitions'.
+    bool _partitioned = false;
+    size_t _numSpillPartitions = 0;
+    std::vector<SpilledPartition> _partitions;
+    std::deque<SpilledPartition> _pendingPartitions;
     const bool _allowDiskUse;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
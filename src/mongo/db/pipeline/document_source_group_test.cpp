@@ -30,7 +30,9 @@
 #include "mongo/platform/basic.h"
 
 #include <boost/intrusive_ptr.hpp>
+#include <cmath>
 #include <deque>
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -44,6 +46,7 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
@@ -54,6 +57,7 @@
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -140,6 +144,246 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldMergePartialAggregatesWhenSpillingSortedOrByPartition) {
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    const auto oldSpillPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupSpillPartitions.store(oldSpillPartitions); });
+
+    // With two partitions, each partition holds more than the memory limit and has to be split
+    // again before it can be re-aggregated.
+    for (int spillPartitions : {0, 2, 16}) {
+        internalDocumentSourceGroupSpillPartitions.store(spillPartitions);
+
+        VariablesParseState vps = expCtx->variablesParseState;
+        AccumulationStatement pushStatement{"spaceHog",
+                                            ExpressionFieldPath::parse(expCtx, "$largeStr", vps),
+                                            AccumulationStatement::getFactory("$push")};
+        AccumulationStatement sumStatement{"count",
+                                           ExpressionConstant::create(expCtx, Value(1)),
+                                           AccumulationStatement::getFactory("$sum")};
+        auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$key", vps);
+        auto group = DocumentSourceGroup::create(
+            expCtx, groupByExpression, {pushStatement, sumStatement}, maxMemoryUsageBytes);
+
+        const int numGroups = 5;
+        const int docsPerGroup = 4;
+        string largeStr(maxMemoryUsageBytes / 3, 'x');
+        deque<DocumentSource::GetNextResult> inputs;
+        for (int i = 0; i < numGroups * docsPerGroup; ++i) {
+            inputs.push_back(Document{{"key", i % numGroups}, {"largeStr", largeStr}});
+        }
+        auto mock = DocumentSourceMock::create(inputs);
+        group->setSource(mock.get());
+
+        stdx::unordered_set<int> keySet;
+        for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+            auto doc = result.releaseDocument();
+            keySet.insert(doc["_id"].coerceToInt());
+            ASSERT_VALUE_EQ(doc["count"], Value(docsPerGroup));
+            ASSERT_EQ(doc["spaceHog"].getArrayLength(), size_t(docsPerGroup));
+        }
+        ASSERT_TRUE(group->getNext().isEOF());
+        ASSERT_TRUE(group->usedDisk());
+        ASSERT_EQ(keySet.size(), size_t(numGroups));
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldPreserveInputOrderWhenAggregatingOnSeveralThreads) {
+    auto expCtx = getExpCtx();
+    const auto oldThreads = internalDocumentSourceGroupThreads.load();
+    internalDocumentSourceGroupThreads.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupThreads.store(oldThreads); });
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto makeStatement = [&](StringData fieldName, StringData accumulator) {
+        return AccumulationStatement{fieldName.toString(),
+                                     ExpressionFieldPath::parse(expCtx, "$i", vps),
+                                     AccumulationStatement::getFactory(accumulator)};
+    };
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$key", vps);
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             groupByExpression,
+                                             {makeStatement("first", "$first"),
+                                              makeStatement("last", "$last"),
+                                              makeStatement("all", "$push"),
+                                              makeStatement("total", "$sum")});
+
+    // Enough documents for every thread to be handed a range of its own.
+    const int numGroups = 7;
+    const int numDocs = 5000;
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.push_back(Document{{"key", i % numGroups}, {"i", i}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> keySet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        const int key = doc["_id"].coerceToInt();
+        keySet.insert(key);
+
+        vector<Value> expectedAll;
+        long long expectedTotal = 0;
+        for (int i = key; i < numDocs; i += numGroups) {
+            expectedAll.push_back(Value(i));
+            expectedTotal += i;
+        }
+        ASSERT_VALUE_EQ(doc["first"], expectedAll.front());
+        ASSERT_VALUE_EQ(doc["last"], expectedAll.back());
+        ASSERT_VALUE_EQ(doc["all"], Value(expectedAll));
+        ASSERT_VALUE_EQ(doc["total"], Value(expectedTotal));
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_EQ(keySet.size(), size_t(numGroups));
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldAggregateRunsOfEqualKeysAsBatches) {
+    auto expCtx = getExpCtx();
+    const auto oldThreads = internalDocumentSourceGroupThreads.load();
+    internalDocumentSourceGroupThreads.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupThreads.store(oldThreads); });
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto makeStatement = [&](StringData fieldName, StringData accumulator) {
+        return AccumulationStatement{fieldName.toString(),
+                                     ExpressionFieldPath::parse(expCtx, "$v", vps),
+                                     AccumulationStatement::getFactory(accumulator)};
+    };
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$key", vps);
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             groupByExpression,
+                                             {makeStatement("total", "$sum"),
+                                              makeStatement("avg", "$avg"),
+                                              makeStatement("min", "$min"),
+                                              makeStatement("max", "$max")});
+
+    // Each key covers a run of consecutive documents, whose values mix every numeric type and
+    // overflow a NumberLong when summed.
+    const int numKeys = 5;
+    const int runLength = 1000;
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int key = 0; key < numKeys; ++key) {
+        for (int i = 0; i < runLength; ++i) {
+            Value v = i % 3 == 0 ? Value(i) : i % 3 == 1 ? Value(static_cast<long long>(i))
+                                                          : Value(static_cast<double>(i));
+            if (i == 500 || i == 501) {
+                v = Value(std::numeric_limits<long long>::max());
+            }
+            inputs.push_back(Document{{"key", key}, {"v", v}});
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    // The exact total is 2 * (2^63 - 1) plus the sum of the other values.
+    long long smallTotal = 0;
+    for (int i = 0; i < runLength; ++i) {
+        smallTotal += (i == 500 || i == 501) ? 0 : i;
+    }
+    const double expectedTotal = std::ldexp(1.0, 64) + static_cast<double>(smallTotal - 2);
+
+    size_t numResults = 0;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ++numResults;
+        ASSERT_EQ(doc["total"].getType(), NumberDouble);
+        // A run may be split between threads, whose partial totals are each rounded to a double.
+        ASSERT_APPROX_EQUAL(doc["total"].getDouble(), expectedTotal, 1e5);
+        ASSERT_APPROX_EQUAL(doc["avg"].getDouble(), expectedTotal / runLength, 1e3);
+        ASSERT_VALUE_EQ(doc["min"], Value(0));
+        ASSERT_VALUE_EQ(doc["max"], Value(std::numeric_limits<long long>::max()));
+    }
+    ASSERT_EQ(numResults, size_t(numKeys));
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldAbsorbPrecedingUnwindAndSerializeItSeparately) {
+    auto expCtx = getExpCtx();
+    auto unwind = DocumentSourceUnwind::create(expCtx, "items", false, std::string("index"));
+    auto group = DocumentSourceGroup::createFromBson(
+        fromjson("{$group: {_id: '$items', n: {$sum: 1}}}").firstElement(), expCtx);
+    auto groupStage = dynamic_cast<DocumentSourceGroup*>(group.get());
+
+    Pipeline::SourceContainer container{unwind, group};
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQ(1U, container.size());
+    ASSERT_EQ(group.get(), container.front().get());
+    ASSERT_FALSE(groupStage->canAbsorbUnwind());
+
+    vector<Value> serialization;
+    group->serializeToArray(serialization);
+    ASSERT_EQ(2U, serialization.size());
+    ASSERT_VALUE_EQ(unwind->serialize(), serialization[0]);
+    ASSERT_VALUE_EQ(groupStage->serialize(), serialization[1]);
+
+    DepsTracker deps;
+    ASSERT_EQ(DepsTracker::State::EXHAUSTIVE_ALL, group->getDependencies(&deps));
+    ASSERT_EQ(1U, deps.fields.size());
+    ASSERT_EQ(1U, deps.fields.count("items"));
+
+    // The group key is an unwound value, rather than a renamed field of the input.
+    ASSERT_TRUE(group->getModifiedPaths().renames.empty());
+    ASSERT_FALSE(groupStage->rewriteGroupAsTransformOnFirstDocument());
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldUnwindInputOfAbsorbedUnwind) {
+    auto expCtx = getExpCtx();
+    const auto oldThreads = internalDocumentSourceGroupThreads.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupThreads.store(oldThreads); });
+
+    // Every tenth document has an empty array, which is not unwound.
+    const int numDocs = 2000;
+    deque<DocumentSource::GetNextResult> inputs;
+    deque<DocumentSource::GetNextResult> bsonInputs;
+    vector<Value> expectedAll;
+    long long expectedTotal = 0;
+    for (int i = 0; i < numDocs; ++i) {
+        const BSONObj doc = i % 10 == 0
+            ? BSON("i" << i << "items" << BSONArray())
+            : BSON("i" << i << "items"
+                       << BSON_ARRAY(BSON("k" << 0 << "v" << i) << BSON("k" << 1 << "v" << 2 * i)));
+        inputs.push_back(Document(doc));
+        bsonInputs.push_back(Document::fromBsonWithMetaData(doc));
+        if (i % 10 != 0) {
+            expectedAll.push_back(Value(i));
+            expectedTotal += i;
+        }
+    }
+
+    for (auto numThreads : {1, 4}) {
+        internalDocumentSourceGroupThreads.store(numThreads);
+        for (auto&& input : {inputs, bsonInputs}) {
+            auto unwind = DocumentSourceUnwind::create(expCtx, "items", false, boost::none);
+            auto group = DocumentSourceGroup::createFromBson(
+                fromjson("{$group: {_id: '$items.k', total: {$sum: '$items.v'}, all: {$push: "
+                         "'$i'}}}")
+                    .firstElement(),
+                expCtx);
+            dynamic_cast<DocumentSourceGroup*>(group.get())->setUnwindSource(unwind);
+
+            auto mock = DocumentSourceMock::create(input);
+            group->setSource(mock.get());
+
+            size_t numResults = 0;
+            for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+                auto doc = result.releaseDocument();
+                const int key = doc["_id"].coerceToInt();
+                ++numResults;
+                ASSERT_VALUE_EQ(doc["total"], Value(expectedTotal * (key + 1)));
+                ASSERT_VALUE_EQ(doc["all"], Value(expectedAll));
+            }
+            ASSERT_TRUE(group->getNext().isEOF());
+            ASSERT_EQ(2U, numResults);
+        }
+    }
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
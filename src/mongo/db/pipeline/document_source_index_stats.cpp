@@ -31,6 +31,9 @@
 
 #include "mongo/db/pipeline/document_source_index_stats.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/server_options.h"
 #include "mongo/util/net/socket_utils.h"
@@ -47,24 +50,110 @@ const char* DocumentSourceIndexStats::getSourceName() const {
     return "$indexStats";
 }
 
-DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
-    pExpCtx->checkForInterrupt();
+namespace {
 
-    if (_indexStatsMap.empty()) {
-        _indexStatsMap = pExpCtx->mongoProcessInterface->getIndexStats(pExpCtx->opCtx, pExpCtx->ns);
-        _indexStatsIter = _indexStatsMap.begin();
+/**
+ * Returns true if every field of 'keyPattern' is ascending or descending, as opposed to naming a
+ * special index type such as "text" or "hashed".
+ */
+bool isOrderedKeyPattern(const BSONObj& keyPattern) {
+    for (auto&& elem : keyPattern) {
+        if (!elem.isNumber()) {
+            return false;
+        }
     }
+    return true;
+}
+
+/**
+ * Returns true if 'prefix' consists of the leading fields of 'keyPattern', in the same order and
+ * with the same directions, and 'keyPattern' has more fields. Queries served by an index on
+ * 'prefix' can then generally be served by an index on 'keyPattern' as well.
+ */
+bool isKeyPatternPrefix(const BSONObj& prefix, const BSONObj& keyPattern) {
+    if (prefix.nFields() >= keyPattern.nFields() || !isOrderedKeyPattern(prefix) ||
+        !isOrderedKeyPattern(keyPattern)) {
+        return false;
+    }
+
+    BSONObjIterator keyIt(keyPattern);
+    for (auto&& prefixElem : prefix) {
+        auto keyElem = keyIt.next();
+        if (prefixElem.fieldNameStringData() != keyElem.fieldNameStringData() ||
+            (prefixElem.number() < 0) != (keyElem.number() < 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void DocumentSourceIndexStats::_populate() {
+    const auto indexStatsMap =
+        pExpCtx->mongoProcessInterface->getIndexStats(pExpCtx->opCtx, pExpCtx->ns);
+
+    std::vector<std::pair<double, Document>> ranked;
+    for (auto&& entry : indexStatsMap) {
+        const auto& stats = entry.second;
+        const long long accesses = stats.accesses.loadRelaxed();
+        const long long writeMicros = stats.writeMicros.loadRelaxed();
+        const double microsPerAccess =
+            static_cast<double>(writeMicros) / std::max(accesses, 1LL);
 
-    if (_indexStatsIter != _indexStatsMap.end()) {
-        const auto& stats = _indexStatsIter->second;
         MutableDocument doc;
-        doc["name"] = Value(_indexStatsIter->first);
+        doc["name"] = Value(entry.first);
         doc["key"] = Value(stats.indexKey);
         doc["host"] = Value(_processName);
-        doc["accesses"]["ops"] = Value(stats.accesses.loadRelaxed());
+        doc["accesses"]["ops"] = Value(accesses);
         doc["accesses"]["since"] = Value(stats.trackerStartTime);
-        ++_indexStatsIter;
-        return doc.freeze();
+        doc["writes"]["ops"] = Value(stats.writes.loadRelaxed());
+        doc["writes"]["keysInserted"] = Value(stats.keysInserted.loadRelaxed());
+        doc["writes"]["keysDeleted"] = Value(stats.keysDeleted.loadRelaxed());
+        doc["writes"]["bytesInserted"] = Value(stats.bytesInserted.loadRelaxed());
+        doc["writes"]["micros"] = Value(writeMicros);
+        doc["writes"]["microsPerAccess"] = Value(microsPerAccess);
+
+        // The _id index can never be dropped, so it is not reported as redundant.
+        std::vector<Value> prefixOf;
+        if (entry.first != "_id_") {
+            for (auto&& other : indexStatsMap) {
+                if (isKeyPatternPrefix(stats.indexKey, other.second.indexKey)) {
+                    prefixOf.push_back(Value(other.first));
+                }
+            }
+        }
+        std::sort(prefixOf.begin(), prefixOf.end(), [](const Value& lhs, const Value& rhs) {
+            return lhs.getStringData() < rhs.getStringData();
+        });
+        doc["prefixOf"] = Value(std::move(prefixOf));
+
+        ranked.emplace_back(microsPerAccess, doc.freeze());
+    }
+
+    std::sort(ranked.begin(), ranked.end(), [](const auto& lhs, const auto& rhs) {
+        if (lhs.first != rhs.first) {
+            return lhs.first > rhs.first;
+        }
+        return lhs.second["name"].getStringData() < rhs.second["name"].getStringData();
+    });
+
+    for (auto&& entry : ranked) {
+        _indexStatsDocs.push_back(std::move(entry.second));
+    }
+    _indexStatsIter = _indexStatsDocs.begin();
+    _populated = true;
+}
+
+DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_populated) {
+        _populate();
+    }
+
+    if (_indexStatsIter != _indexStatsDocs.end()) {
+        return Document(*_indexStatsIter++);
     }
 
     return GetNextResult::makeEOF();
@@ -37,6 +37,10 @@ namespace mongo {
 /**
  * Provides a document source interface to retrieve index statistics for a given namespace.
  * Each document returned represents a single index and mongod instance.
+ *
+ * Besides how often each index was used, the documents report what each index costs to maintain
+ * and the indexes it is a key prefix of. Indexes are returned in decreasing order of maintenance
+ * time per use, so that the indexes costing writes the most for the least benefit come first.
  */
 class DocumentSourceIndexStats final : public DocumentSource {
 public:
@@ -92,8 +96,14 @@ public:
 private:
     DocumentSourceIndexStats(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
-    CollectionIndexUsageMap _indexStatsMap;
-    CollectionIndexUsageMap::const_iterator _indexStatsIter;
+    /**
+     * Builds the result documents, in the order they are returned, from the current statistics.
+     */
+    void _populate();
+
+    bool _populated = false;
+    std::vector<Document> _indexStatsDocs;
+    std::vector<Document>::const_iterator _indexStatsIter;
     std::string _processName;
 };
 
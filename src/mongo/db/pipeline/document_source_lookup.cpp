@@ -232,7 +232,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
+    boost::optional<std::vector<Document>> matches;
+    auto nextInput = getNextInput(&matches);
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
@@ -243,20 +244,11 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
-    }
-
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
     const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto addResult = [&](Document result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline's $lookup stage exceeds "
@@ -264,11 +256,29 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
                               << " bytes",
 
                 objsize <= maxBytes);
-        results.emplace_back(std::move(*result));
-    }
-    for (auto&& source : pipeline->getSources()) {
-        if (source->usedDisk())
-            _usedDisk = true;
+        results.emplace_back(std::move(result));
+    };
+
+    if (matches) {
+        for (auto&& match : *matches) {
+            addResult(std::move(match));
+        }
+    } else {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+            _resolvedPipeline.back() = matchStage;
+        }
+
+        auto pipeline = buildPipeline(inputDoc);
+        while (auto result = pipeline->getNext()) {
+            addResult(std::move(*result));
+        }
+        for (auto&& source : pipeline->getSources()) {
+            if (source->usedDisk())
+                _usedDisk = true;
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -322,6 +332,176 @@ std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     return pipeline;
 }
 
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextInput(
+    boost::optional<std::vector<Document>>* matchesOut) {
+    *matchesOut = boost::none;
+    if (wasConstructedWithPipelineSyntax()) {
+        return pSource->getNext();
+    }
+
+    if (_batch.empty() && !_batchEndResult) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput;
+        }
+
+        if (!_hashTable && !_hashJoinAbandoned &&
+            _numInputsQueried >= internalDocumentSourceLookupHashJoinMinInputDocuments.load()) {
+            buildHashTable();
+        }
+
+        if (_hashTable) {
+            // Input documents whose local field values cannot all be probed, such as those
+            // missing the local field, still query the foreign collection.
+            if (auto probeValues = getProbeValues(nextInput.getDocument())) {
+                *matchesOut = _hashTable->probe(*probeValues);
+                return nextInput;
+            }
+        }
+
+        if (_hashTable || internalDocumentSourceLookupBatchSize.load() == 1) {
+            ++_numInputsQueried;
+            return nextInput;
+        }
+
+        fillBatch(nextInput.releaseDocument());
+    }
+
+    if (!_batch.empty()) {
+        auto batched = std::move(_batch.front());
+        _batch.pop_front();
+        *matchesOut = std::move(batched.matches);
+        return std::move(batched.input);
+    }
+
+    invariant(_batchEndResult);
+    auto batchEndResult = std::move(*_batchEndResult);
+    _batchEndResult = boost::none;
+    return batchEndResult;
+}
+
+boost::optional<std::vector<Value>> DocumentSourceLookUp::getProbeValues(
+    const Document& inputDoc) const {
+    std::vector<Value> probeValues;
+    bool canProbe = true;
+    document_path_support::visitAllValuesAtPath(inputDoc, *_localField, [&](const Value& value) {
+        canProbe = canProbe && LookupHashTable::canProbe(value);
+        probeValues.push_back(value);
+    });
+    if (probeValues.empty() || !canProbe) {
+        return boost::none;
+    }
+    return probeValues;
+}
+
+void DocumentSourceLookUp::fillBatch(Document firstInput) {
+    invariant(!wasConstructedWithPipelineSyntax());
+    invariant(_batch.empty() && !_batchEndResult);
+
+    const auto batchSize = static_cast<size_t>(internalDocumentSourceLookupBatchSize.load());
+    const bool canProbe = LookupHashTable::canIndexPath(*_foreignField);
+
+    // The distinct local field values of the batch, in the order they were first seen.
+    auto batchValues = _fromExpCtx->getValueComparator().makeUnorderedValueSet();
+    BSONArrayBuilder batchValuesBuilder;
+
+    boost::optional<Document> nextInput = std::move(firstInput);
+    while (nextInput) {
+        BatchedInput batched;
+        batched.input = std::move(*nextInput);
+        ++_numInputsQueried;
+        if (auto probeValues = canProbe ? getProbeValues(batched.input) : boost::none) {
+            for (auto&& value : *probeValues) {
+                if (batchValues.insert(value).second) {
+                    batchValuesBuilder << value;
+                }
+            }
+            batched.probeValues = std::move(*probeValues);
+        }
+        _batch.push_back(std::move(batched));
+
+        // End the batch at its size, or before its query could approach the maximum BSON size.
+        if (_batch.size() == batchSize ||
+            static_cast<size_t>(batchValuesBuilder.len()) > BSONObjMaxUserSize / 2) {
+            break;
+        }
+
+        auto next = pSource->getNext();
+        if (next.isAdvanced()) {
+            nextInput = next.releaseDocument();
+        } else {
+            _batchEndResult = std::move(next);
+            nextInput = boost::none;
+        }
+    }
+
+    if (batchValues.empty()) {
+        return;
+    }
+
+    // Query once for the foreign documents matching any input document in the batch, and find
+    // the matches of each one among them. We've already allocated space for the trailing $match
+    // stage in '_resolvedPipeline'.
+    const auto joiningQuery =
+        BSON(_foreignField->fullPath() << BSON("$in" << batchValuesBuilder.arr()));
+    const auto additionalFilter = _additionalFilter.value_or(BSONObj());
+    _resolvedPipeline.back() =
+        BSON("$match" << BSON("$and" << BSON_ARRAY(joiningQuery << additionalFilter)));
+    auto pipeline = buildPipeline(Document());
+
+    LookupHashTable batchMatches(
+        *_foreignField,
+        _fromExpCtx->getValueComparator(),
+        static_cast<size_t>(internalLookupStageIntermediateDocumentMaxSizeBytes.load()));
+    bool fits = true;
+    while (auto result = pipeline->getNext()) {
+        if (!batchMatches.insert(std::move(*result))) {
+            fits = false;
+            break;
+        }
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+
+    // If the matches of the whole batch are too large to hold at once, each input document
+    // queries for its own instead.
+    if (fits) {
+        for (auto&& batched : _batch) {
+            if (!batched.probeValues.empty()) {
+                batched.matches = batchMatches.probe(batched.probeValues);
+            }
+        }
+    }
+}
+
+void DocumentSourceLookUp::buildHashTable() {
+    invariant(!wasConstructedWithPipelineSyntax());
+    invariant(!_hashTable);
+
+    const auto maxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    if (maxMemoryBytes == 0 || !LookupHashTable::canIndexPath(*_foreignField)) {
+        _hashJoinAbandoned = true;
+        return;
+    }
+
+    // Read every foreign document that any input document could match. We've already allocated
+    // space for the trailing $match stage in '_resolvedPipeline'.
+    _resolvedPipeline.back() = BSON("$match" << _additionalFilter.value_or(BSONObj()));
+    auto pipeline = buildPipeline(Document());
+
+    _hashTable.emplace(*_foreignField,
+                       _fromExpCtx->getValueComparator(),
+                       static_cast<size_t>(maxMemoryBytes));
+    while (auto result = pipeline->getNext()) {
+        if (!_hashTable->insert(std::move(*result))) {
+            _hashTable.reset();
+            break;
+        }
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+
+    _hashJoinAbandoned = !_hashTable;
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceLookUp::getModifiedPaths() const {
     std::set<std::string> modifiedPaths{_as.fullPath()};
     if (_unwindSrc) {
@@ -459,6 +639,9 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _matches = boost::none;
+    _hashTable = boost::none;
+    _batch.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -551,36 +734,41 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+    while (!_input || !_nextValue) {
+        auto nextInput = getNextInput(&_matches);
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
 
         _input = nextInput.releaseDocument();
-
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
+        _matchIndex = 0;
 
         if (_pipeline) {
             _usedDisk = _usedDisk || _pipeline->usedDisk();
             _pipeline->dispose(pExpCtx->opCtx);
+            _pipeline.reset();
         }
 
-        _pipeline = buildPipeline(*_input);
+        if (!_matches) {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in
+                // '_resolvedPipeline'.
+                _resolvedPipeline.back() = matchStage;
+            }
+
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = getNextUnwindMatch();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -598,7 +786,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = getNextUnwindMatch();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -612,6 +800,16 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::getNextUnwindMatch() {
+    if (!_matches) {
+        return _pipeline->getNext();
+    }
+    if (_matchIndex == _matches->size()) {
+        return boost::none;
+    }
+    return std::move((*_matches)[_matchIndex++]);
+}
+
 void DocumentSourceLookUp::copyVariablesToExpCtx(const Variables& vars,
                                                  const VariablesParseState& vps,
                                                  ExpressionContext* expCtx) {
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -37,6 +38,7 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
 
@@ -270,6 +272,39 @@ private:
      */
     std::unique_ptr<Pipeline, PipelineDeleter> buildPipeline(const Document& inputDoc);
 
+    /**
+     * Returns the next input document. For a $lookup with localField/foreignField syntax, also sets
+     * 'matchesOut' to the document's foreign matches if they have already been found, by probing
+     * '_hashTable' or by the query made for a batch of input documents. Otherwise the caller must
+     * query the foreign collection for them.
+     */
+    GetNextResult getNextInput(boost::optional<std::vector<Document>>* matchesOut);
+
+    /**
+     * Returns the values at the local field of 'inputDoc' if its foreign matches are exactly the
+     * documents having any of them at the foreign field, or boost::none otherwise.
+     */
+    boost::optional<std::vector<Value>> getProbeValues(const Document& inputDoc) const;
+
+    /**
+     * Reads the whole foreign collection, after any view pipeline and absorbed $match, into
+     * '_hashTable'. Sets '_hashJoinAbandoned' instead if the table cannot be used.
+     */
+    void buildHashTable();
+
+    /**
+     * Starts '_batch' with 'firstInput' and reads up to internalDocumentSourceLookupBatchSize
+     * input documents into it in all, then finds the foreign matches of all those that can be
+     * probed with a single $in query.
+     */
+    void fillBatch(Document firstInput);
+
+    /**
+     * Returns the next foreign document matching '_input' while unwinding, from either '_matches'
+     * or '_pipeline'.
+     */
+    boost::optional<Document> getNextUnwindMatch();
+
     /**
      * Reinitialize the cache with a new max size. May only be called if this DSLookup was created
      * with pipeline syntax, the cache has not been frozen or abandoned, and no data has been added
@@ -303,6 +338,29 @@ private:
     // from a cursor source.
     boost::optional<SequentialDocumentCache> _cache;
 
+    // For use when $lookup is specified with localField/foreignField syntax. Once the foreign
+    // collection has been queried for enough input documents, it is read once into this table, and
+    // the matches for each subsequent input document are found by probing it. If the table would
+    // exceed its memory limit, '_hashJoinAbandoned' is set and the stage goes on querying.
+    boost::optional<LookupHashTable> _hashTable;
+    bool _hashJoinAbandoned = false;
+
+    // The number of input documents whose foreign matches were found by querying.
+    long long _numInputsQueried = 0;
+
+    // For use when $lookup is specified with localField/foreignField syntax and '_hashTable' is not
+    // in use. Input documents are read ahead in batches, and a single query finds the foreign
+    // matches of every document in a batch whose local field values can be probed.
+    struct BatchedInput {
+        Document input;
+        std::vector<Value> probeValues;
+        boost::optional<std::vector<Document>> matches;
+    };
+    std::deque<BatchedInput> _batch;
+
+    // The pause or EOF that ended the current batch, to be returned after the batch.
+    boost::optional<GetNextResult> _batchEndResult;
+
     // The ExpressionContext used when performing aggregation pipelines against the '_resolvedNs'
     // namespace.
     boost::intrusive_ptr<ExpressionContext> _fromExpCtx;
@@ -326,6 +384,8 @@ private:
     // not null.
     long long _cursorIndex = 0;
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
+    boost::optional<std::vector<Document>> _matches;
+    size_t _matchIndex = 0;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
 };
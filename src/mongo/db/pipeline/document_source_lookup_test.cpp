@@ -48,6 +48,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -523,12 +524,21 @@ public:
         }
 
         pipeline->addInitialSource(DocumentSourceMock::create(_mockResults));
+        ++_numCursorsAttached;
         return pipeline;
     }
 
+    /**
+     * Returns how many times the foreign collection has been read.
+     */
+    size_t numCursorsAttached() const {
+        return _numCursorsAttached;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    size_t _numCursorsAttached = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -635,6 +645,214 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, ShouldProbeHashTableOnceEnoughInputDocumentsAreLookedUp) {
+    const auto oldMinInputDocuments = internalDocumentSourceLookupHashJoinMinInputDocuments.load();
+    const auto oldBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupHashJoinMinInputDocuments.store(1);
+    internalDocumentSourceLookupBatchSize.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupHashJoinMinInputDocuments.store(oldMinInputDocuments);
+        internalDocumentSourceLookupBatchSize.store(oldBatchSize);
+    });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "x"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"foreignId", 2}},
+                                                       Document{{"foreignId", 1}},
+                                                       Document{{"foreignId", DOC_ARRAY(2 << 3)}},
+                                                       Document{{"_id", 0}},
+                                                       Document{{"foreignId", 4}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"x", 1}};
+    const Document foreign1{{"_id", 1}, {"x", 2}};
+    const Document foreign2{{"_id", 2}, {"x", DOC_ARRAY(1 << 3)}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document(foreign0), Document(foreign1), Document(foreign2)};
+    auto mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoProcessInterface;
+
+    // The first input document queries the foreign collection.
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 2}, {"foreignDocs", DOC_ARRAY(foreign1)}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 1U);
+
+    // The second reads the whole foreign collection into the hash table, then probes it, as does
+    // the third.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", DOC_ARRAY(foreign0 << foreign2)}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", DOC_ARRAY(2 << 3)},
+                                 {"foreignDocs", DOC_ARRAY(foreign1 << foreign2)}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 2U);
+
+    // A missing local field matches foreign documents missing the foreign field, so it queries
+    // the foreign collection.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", 0}, {"foreignDocs", std::vector<Value>{}}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 3U);
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 4}, {"foreignDocs", std::vector<Value>{}}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 3U);
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldQueryForEachInputDocumentIfHashTableExceedsMemoryLimit) {
+    const auto oldMinInputDocuments = internalDocumentSourceLookupHashJoinMinInputDocuments.load();
+    const auto oldMaxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    const auto oldBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupHashJoinMinInputDocuments.store(0);
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(1);
+    internalDocumentSourceLookupBatchSize.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupHashJoinMinInputDocuments.store(oldMinInputDocuments);
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(oldMaxMemoryBytes);
+        internalDocumentSourceLookupBatchSize.store(oldBatchSize);
+    });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDoc"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const bool preserveNullAndEmptyArrays = false;
+    const boost::optional<std::string> includeArrayIndex = boost::none;
+    lookup->setUnwindStage(DocumentSourceUnwind::create(
+        expCtx, "foreignDoc", preserveNullAndEmptyArrays, includeArrayIndex));
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 0}}, Document{{"foreignId", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    auto mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoProcessInterface;
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 0}, {"foreignDoc", Document{{"_id", 0}}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 1}, {"foreignDoc", Document{{"_id", 1}}}}));
+
+    // The attempt to build the hash table, then one query per input document.
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 3U);
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldQueryOnceForEachBatchOfInputDocuments) {
+    const auto oldBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupBatchSize.store(3);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchSize.store(oldBatchSize); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The first batch holds three input documents, one of which must query on its own as it is
+    // missing the local field. The second batch ends at the pause.
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 1}},
+                                    Document{{"x", 0}},
+                                    Document{{"foreignId", 1}},
+                                    Document{{"foreignId", 0}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"foreignId", 2}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    auto mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoProcessInterface;
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 1}, {"foreignDocs", DOC_ARRAY(DOC("_id" << 1))}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 1U);
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", 0}, {"foreignDocs", std::vector<Value>{}}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 2U);
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 1}, {"foreignDocs", DOC_ARRAY(DOC("_id" << 1))}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 2U);
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 0}, {"foreignDocs", DOC_ARRAY(DOC("_id" << 0))}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 3U);
+
+    ASSERT_TRUE(lookup->getNext().isPaused());
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 2}, {"foreignDocs", std::vector<Value>{}}}));
+    ASSERT_EQ(mongoProcessInterface->numCursorsAttached(), 4U);
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
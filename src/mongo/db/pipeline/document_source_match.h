@@ -66,7 +66,7 @@ public:
      * $and.
      */
     Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
-                                                     Pipeline::SourceContainer* container) final;
+                                                     Pipeline::SourceContainer* container) override;
 
     DepsTracker::State getDependencies(DepsTracker* deps) const final;
 
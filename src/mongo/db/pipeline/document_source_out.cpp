@@ -31,6 +31,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <deque>
+#include <exception>
+
+#include "mongo/db/client.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/pipeline/document_path_support.h"
@@ -38,8 +42,17 @@
 #include "mongo/db/pipeline/document_source_out_gen.h"
 #include "mongo/db/pipeline/document_source_out_in_place.h"
 #include "mongo/db/pipeline/document_source_out_replace_coll.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -48,6 +61,225 @@ MONGO_FAIL_POINT_DEFINE(hangWhileBuildingDocumentSourceOutBatch);
 using boost::intrusive_ptr;
 using std::vector;
 
+namespace {
+
+/**
+ * The threads on which the batches of every $out stage with more than one writer are written.
+ */
+struct OutWriterPool {
+    OutWriterPool()
+        : threadPool([] {
+              ThreadPool::Options options;
+              options.poolName = "OutWriters";
+              options.threadNamePrefix = "OutWriter-";
+              options.minThreads = 0;
+              options.maxThreads = 256;
+              options.onCreateThread = [](const std::string& threadName) {
+                  Client::initThread(threadName.c_str());
+              };
+              return options;
+          }()) {}
+
+    ThreadPool threadPool;
+};
+
+const auto outWriterPool = ServiceContext::declareDecoration<OutWriterPool>();
+const ServiceContext::ConstructorActionRegisterer outWriterPoolRegisterer{
+    "OutWriterPool",
+    [](ServiceContext* service) { outWriterPool(service).threadPool.startup(); },
+    [](ServiceContext* service) {
+        auto& pool = outWriterPool(service).threadPool;
+        pool.shutdown();
+        pool.join();
+    }};
+
+}  // namespace
+
+/**
+ * Writes the batches of a $out stage on several threads of the OutWriterPool at once. Each writer
+ * has a bounded queue of batches, which it writes in order on an operation of its own. Writers are
+ * killed along with the operation running the pipeline.
+ */
+class DocumentSourceOut::ParallelWriters {
+    MONGO_DISALLOW_COPYING(ParallelWriters);
+
+public:
+    ParallelWriters(DocumentSourceOut* stage, size_t numWriters)
+        : _stage(stage),
+          _opCtx(stage->pExpCtx->opCtx),
+          _maxQueuedBatches(internalDocumentSourceOutMaxQueuedBatches.load()),
+          _queues(numWriters) {}
+
+    /**
+     * Abandons any batches which have not been written yet, and waits for every writer to exit.
+     */
+    ~ParallelWriters() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        for (auto&& queue : _queues) {
+            queue.clear();
+        }
+        _closed = true;
+        _cond.notify_all();
+        if (_numRunning > 0) {
+            _killWriters(lk, {ErrorCodes::Interrupted, "$out stage was abandoned"});
+            _cond.wait(lk, [&] { return _numRunning == 0; });
+        }
+    }
+
+    /**
+     * Schedules the writers on the OutWriterPool. Throws if the pool is shutting down.
+     */
+    void start() {
+        auto& pool = outWriterPool(_opCtx->getServiceContext()).threadPool;
+        for (size_t writerId = 0; writerId < _queues.size(); ++writerId) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                ++_numRunning;
+            }
+            Status status = pool.schedule([this, writerId] { _runWriter(writerId); });
+            if (!status.isOK()) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                --_numRunning;
+                uassertStatusOK(status);
+            }
+        }
+    }
+
+    /**
+     * Queues 'batch' to be written by writer 'writerId', waiting while its queue is full. Throws
+     * the error of any writer which has failed.
+     */
+    void push(size_t writerId, BatchedObjects&& batch) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _wait(lk, [&] { return _error || _queues[writerId].size() < _maxQueuedBatches; });
+        _rethrowIfFailed(lk);
+        _queues[writerId].push_back(std::move(batch));
+        _cond.notify_all();
+    }
+
+    /**
+     * Waits for every queued batch to be written, and makes the writes of the writers wait for the
+     * write concern of this operation. Throws the error of any writer which has failed.
+     */
+    void finish() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _closed = true;
+        _cond.notify_all();
+        _wait(lk, [&] { return _numRunning == 0; });
+        _rethrowIfFailed(lk);
+
+        auto& replClientInfo = repl::ReplClientInfo::forClient(_opCtx->getClient());
+        if (_lastOp > replClientInfo.getLastOp()) {
+            replClientInfo.setLastOp(_lastOp);
+        }
+    }
+
+private:
+    void _runWriter(size_t writerId) {
+        std::exception_ptr error;
+        try {
+            auto writerOpCtx = cc().makeOperationContext();
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _writerOpCtxs.insert(writerOpCtx.get());
+                if (!_killStatus.isOK()) {
+                    _killWriter(writerOpCtx.get());
+                }
+            }
+            ON_BLOCK_EXIT([&] {
+                auto lastOp = repl::ReplClientInfo::forClient(cc()).getLastOp();
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _writerOpCtxs.erase(writerOpCtx.get());
+                if (lastOp > _lastOp) {
+                    _lastOp = lastOp;
+                }
+            });
+
+            const auto& stageExpCtx = _stage->pExpCtx;
+            auto expCtx = stageExpCtx->copyWith(stageExpCtx->ns, stageExpCtx->uuid);
+            expCtx->opCtx = writerOpCtx.get();
+
+            while (true) {
+                BatchedObjects batch;
+                {
+                    stdx::unique_lock<stdx::mutex> lk(_mutex);
+                    auto& queue = _queues[writerId];
+                    writerOpCtx->waitForConditionOrInterrupt(
+                        _cond, lk, [&] { return _error || _closed || !queue.empty(); });
+                    if (_error || queue.empty()) {
+                        break;
+                    }
+                    batch = std::move(queue.front());
+                    queue.pop_front();
+                    _cond.notify_all();
+                }
+                _stage->spill(expCtx, std::move(batch));
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (error && !_error) {
+            _error = error;
+        }
+        --_numRunning;
+        _cond.notify_all();
+    }
+
+    /**
+     * Waits for 'pred' to hold. If this operation is interrupted first, kills the writers, waits
+     * for them to exit and throws.
+     */
+    template <typename Pred>
+    void _wait(stdx::unique_lock<stdx::mutex>& lk, Pred pred) {
+        Status waitStatus = _opCtx->waitForConditionOrInterruptNoAssert(_cond, lk, pred);
+        if (!waitStatus.isOK()) {
+            _killWriters(lk, waitStatus);
+            _cond.wait(lk, [&] { return _numRunning == 0; });
+            uassertStatusOK(waitStatus);
+        }
+    }
+
+    void _rethrowIfFailed(WithLock) {
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+    }
+
+    void _killWriters(WithLock, Status killStatus) {
+        if (_killStatus.isOK()) {
+            _killStatus = std::move(killStatus);
+        }
+        for (auto&& writerOpCtx : _writerOpCtxs) {
+            _killWriter(writerOpCtx);
+        }
+    }
+
+    void _killWriter(OperationContext* writerOpCtx) {
+        stdx::lock_guard<Client> clientLock(*writerOpCtx->getClient());
+        writerOpCtx->getServiceContext()->killOperation(
+            clientLock, writerOpCtx, _killStatus.code());
+    }
+
+    DocumentSourceOut* const _stage;
+    OperationContext* const _opCtx;
+    const size_t _maxQueuedBatches;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cond;
+
+    std::vector<std::deque<BatchedObjects>> _queues;
+    size_t _numRunning = 0;
+    bool _closed = false;
+    std::exception_ptr _error;
+    Status _killStatus = Status::OK();
+    stdx::unordered_set<OperationContext*> _writerOpCtxs;
+
+    // The latest write of any writer, which this operation waits for the write concern of.
+    repl::OpTime _lastOp;
+};
+
 std::unique_ptr<DocumentSourceOut::LiteParsed> DocumentSourceOut::LiteParsed::parse(
     const AggregationRequest& request, const BSONElement& spec) {
 
@@ -91,6 +323,7 @@ std::unique_ptr<DocumentSourceOut::LiteParsed> DocumentSourceOut::LiteParsed::pa
             actions.addAction(ActionType::remove);
             break;
         case WriteModeEnum::kModeReplaceDocuments:
+        case WriteModeEnum::kModeFoldDocuments:
             actions.addAction(ActionType::update);
             break;
         case WriteModeEnum::kModeInsertDocuments:
@@ -210,8 +443,34 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
         _initialized = true;
     }
 
-    BatchedObjects batch;
-    int bufferedBytes = 0;
+    // With more than one writer, batches are handed to writer threads. When documents with the
+    // same unique key update the same target document, each writer is given the batches of its own
+    // part of the unique key space so that those updates happen in order. Otherwise full batches
+    // go to each writer in turn.
+    std::unique_ptr<ParallelWriters> writers;
+    const size_t numWriters = _getNumWriters();
+    if (numWriters > 1) {
+        writers = std::make_unique<ParallelWriters>(this, numWriters);
+        writers->start();
+    }
+    const bool partitionByUniqueKey = writers &&
+        (_mode == WriteModeEnum::kModeReplaceDocuments ||
+         _mode == WriteModeEnum::kModeFoldDocuments);
+    size_t nextWriter = 0;
+
+    const auto writeBatch = [&](size_t partition, BatchedObjects&& batch) {
+        if (!writers) {
+            spill(pExpCtx, std::move(batch));
+        } else if (partitionByUniqueKey) {
+            writers->push(partition, std::move(batch));
+        } else {
+            writers->push(nextWriter++ % numWriters, std::move(batch));
+        }
+    };
+
+    const size_t numPartitions = partitionByUniqueKey ? numWriters : 1;
+    std::vector<BatchedObjects> batches(numPartitions);
+    std::vector<int> bufferedBytes(numPartitions, 0);
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
@@ -239,18 +498,30 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
         auto uniqueKey = extractUniqueKeyFromDoc(doc, _uniqueKeyFields);
         auto insertObj = doc.toBson();
 
-        bufferedBytes += insertObj.objsize();
+        const size_t partition = numPartitions == 1
+            ? 0
+            : pExpCtx->getValueComparator().hash(Value(uniqueKey)) % numPartitions;
+        auto& batch = batches[partition];
+        bufferedBytes[partition] += insertObj.objsize();
         if (!batch.empty() &&
-            (bufferedBytes > BSONObjMaxUserSize || batch.size() >= write_ops::kMaxWriteBatchSize)) {
-            spill(std::move(batch));
+            (bufferedBytes[partition] > BSONObjMaxUserSize ||
+             batch.size() >= write_ops::kMaxWriteBatchSize)) {
+            writeBatch(partition, std::move(batch));
             batch.clear();
-            bufferedBytes = insertObj.objsize();
+            bufferedBytes[partition] = insertObj.objsize();
         }
         batch.emplace(std::move(insertObj), std::move(uniqueKey));
     }
-    if (!batch.empty()) {
-        spill(std::move(batch));
-        batch.clear();
+    for (size_t partition = 0; partition < numPartitions; ++partition) {
+        if (!batches[partition].empty()) {
+            writeBatch(partition, std::move(batches[partition]));
+            batches[partition].clear();
+        }
+    }
+
+    // Every batch must be written before the pause or EOF is returned.
+    if (writers) {
+        writers->finish();
     }
 
     switch (nextInput.getStatus()) {
@@ -272,12 +543,22 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
     MONGO_UNREACHABLE;
 }
 
+size_t DocumentSourceOut::_getNumWriters() const {
+    // Writer threads have no OperationContext to run on in mongos, where writes are only ever
+    // dispatched to the shards.
+    if (pExpCtx->inMongos) {
+        return 1;
+    }
+    return internalDocumentSourceOutNumWriters.load();
+}
+
 intrusive_ptr<DocumentSourceOut> DocumentSourceOut::create(
     NamespaceString outputNs,
     const intrusive_ptr<ExpressionContext>& expCtx,
     WriteModeEnum mode,
     std::set<FieldPath> uniqueKey,
-    boost::optional<ChunkVersion> targetCollectionVersion) {
+    boost::optional<ChunkVersion> targetCollectionVersion,
+    BSONObj foldSpec) {
 
     // TODO (SERVER-36832): Allow this combination.
     uassert(
@@ -313,6 +594,29 @@ intrusive_ptr<DocumentSourceOut> DocumentSourceOut::create(
     }
     uassert(17385, "Can't $out to special collection: " + outputNs.coll(), !outputNs.isSpecial());
 
+    if (mode == WriteModeEnum::kModeFoldDocuments) {
+        uassert(51121,
+                "$out with mode foldDocuments requires a non-empty 'fold' specification",
+                !foldSpec.isEmpty());
+        for (auto&& path : uniqueKey) {
+            uassert(51122,
+                    str::stream() << "$out with mode foldDocuments requires a uniqueKey of "
+                                     "top-level fields, but found '"
+                                  << path.fullPath()
+                                  << "'",
+                    path.getPathLength() == 1);
+            uassert(51123,
+                    str::stream() << "$out cannot fold the uniqueKey field '" << path.fullPath()
+                                  << "'",
+                    !foldSpec.hasField(path.fullPath()));
+        }
+    } else {
+        uassert(51124,
+                str::stream() << "$out with mode " << WriteMode_serializer(mode)
+                              << " does not accept a 'fold' specification",
+                foldSpec.isEmpty());
+    }
+
     switch (mode) {
         case WriteModeEnum::kModeReplaceCollection:
             return new DocumentSourceOutReplaceColl(
@@ -323,6 +627,13 @@ intrusive_ptr<DocumentSourceOut> DocumentSourceOut::create(
         case WriteModeEnum::kModeReplaceDocuments:
             return new DocumentSourceOutInPlaceReplace(
                 std::move(outputNs), expCtx, mode, std::move(uniqueKey), targetCollectionVersion);
+        case WriteModeEnum::kModeFoldDocuments:
+            return new DocumentSourceOutInPlaceFold(std::move(outputNs),
+                                                    expCtx,
+                                                    mode,
+                                                    std::move(uniqueKey),
+                                                    targetCollectionVersion,
+                                                    std::move(foldSpec));
         default:
             MONGO_UNREACHABLE;
     }
@@ -332,11 +643,13 @@ DocumentSourceOut::DocumentSourceOut(NamespaceString outputNs,
                                      const intrusive_ptr<ExpressionContext>& expCtx,
                                      WriteModeEnum mode,
                                      std::set<FieldPath> uniqueKey,
-                                     boost::optional<ChunkVersion> targetCollectionVersion)
+                                     boost::optional<ChunkVersion> targetCollectionVersion,
+                                     BSONObj foldSpec)
     : DocumentSource(expCtx),
       _writeConcern(expCtx->opCtx->getWriteConcern()),
       _outputNs(std::move(outputNs)),
       _targetCollectionVersion(targetCollectionVersion),
+      _foldSpec(foldSpec.getOwned()),
       _done(false),
       _mode(mode),
       _uniqueKeyFields(std::move(uniqueKey)),
@@ -349,6 +662,7 @@ intrusive_ptr<DocumentSource> DocumentSourceOut::createFromBson(
     std::set<FieldPath> uniqueKey;
     NamespaceString outputNs;
     boost::optional<ChunkVersion> targetCollectionVersion;
+    BSONObj foldSpec;
     if (elem.type() == BSONType::String) {
         outputNs = NamespaceString(expCtx->ns.db().toString() + '.' + elem.str());
         uniqueKey.emplace("_id");
@@ -356,6 +670,9 @@ intrusive_ptr<DocumentSource> DocumentSourceOut::createFromBson(
         auto spec =
             DocumentSourceOutSpec::parse(IDLParserErrorContext("$out"), elem.embeddedObject());
         mode = spec.getMode();
+        if (auto fold = spec.getFold()) {
+            foldSpec = *fold;
+        }
 
         // Retrieve the target database from the user command, otherwise use the namespace from the
         // expression context.
@@ -371,7 +688,12 @@ intrusive_ptr<DocumentSource> DocumentSourceOut::createFromBson(
                                 << typeName(elem.type()));
     }
 
-    return create(std::move(outputNs), expCtx, mode, std::move(uniqueKey), targetCollectionVersion);
+    return create(std::move(outputNs),
+                  expCtx,
+                  mode,
+                  std::move(uniqueKey),
+                  targetCollectionVersion,
+                  std::move(foldSpec));
 }
 
 std::pair<std::set<FieldPath>, boost::optional<ChunkVersion>>
@@ -460,6 +782,9 @@ Value DocumentSourceOut::serialize(boost::optional<ExplainOptions::Verbosity> ex
         }
         return uniqueKeyBob.obj();
     }());
+    if (!_foldSpec.isEmpty()) {
+        spec.setFold(_foldSpec);
+    }
     spec.setTargetCollectionVersion(_targetCollectionVersion);
     return Value(Document{{getSourceName(), spec.toBSON()}});
 }
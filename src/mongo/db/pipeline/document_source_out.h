@@ -104,7 +104,8 @@ public:
                       const boost::intrusive_ptr<ExpressionContext>& expCtx,
                       WriteModeEnum mode,
                       std::set<FieldPath> uniqueKey,
-                      boost::optional<ChunkVersion> targetCollectionVersion);
+                      boost::optional<ChunkVersion> targetCollectionVersion,
+                      BSONObj foldSpec = BSONObj());
 
     virtual ~DocumentSourceOut() = default;
 
@@ -184,8 +185,8 @@ public:
 
     /**
      * Storage for a batch of BSON Objects to be inserted/updated to the write namespace. The
-     * extracted unique key values are also stored in a batch, used by $out with mode
-     * "replaceDocuments" as the query portion of the update.
+     * extracted unique key values are also stored in a batch, used by $out with modes
+     * "replaceDocuments" and "foldDocuments" as the query portion of the update.
      *
      */
     struct BatchedObjects {
@@ -214,13 +215,17 @@ public:
     };
 
     /**
-     * Writes the documents in 'batch' to the write namespace.
+     * Writes the documents in 'batch' to the write namespace, on the operation of 'expCtx'. This is
+     * either the stage's own ExpressionContext or, when batches are written by several writer
+     * threads at once, a copy of it attached to the current writer's operation. Implementations
+     * must therefore not modify the stage.
      */
-    virtual void spill(BatchedObjects&& batch) {
-        LocalReadConcernBlock readLocal(pExpCtx->opCtx);
+    virtual void spill(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       BatchedObjects&& batch) {
+        LocalReadConcernBlock readLocal(expCtx->opCtx);
 
-        pExpCtx->mongoProcessInterface->insert(
-            pExpCtx, getWriteNs(), std::move(batch.objects), _writeConcern, _targetEpoch());
+        expCtx->mongoProcessInterface->insert(
+            expCtx, getWriteNs(), std::move(batch.objects), _writeConcern, _targetEpoch());
     };
 
     /**
@@ -229,14 +234,16 @@ public:
     virtual void finalize() = 0;
 
     /**
-     * Creates a new $out stage from the given arguments.
+     * Creates a new $out stage from the given arguments. 'foldSpec' must be given for, and only
+     * for, mode "foldDocuments".
      */
     static boost::intrusive_ptr<DocumentSourceOut> create(
         NamespaceString outputNs,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         WriteModeEnum,
         std::set<FieldPath> uniqueKey = std::set<FieldPath>{"_id"},
-        boost::optional<ChunkVersion> targetCollectionVersion = boost::none);
+        boost::optional<ChunkVersion> targetCollectionVersion = boost::none,
+        BSONObj foldSpec = BSONObj());
 
     /**
      * Parses a $out stage from the user-supplied BSON.
@@ -255,12 +262,23 @@ protected:
     const NamespaceString _outputNs;
     boost::optional<ChunkVersion> _targetCollectionVersion;
 
-    boost::optional<OID> _targetEpoch() {
+    // For mode "foldDocuments", how each folded field is combined with the target document.
+    const BSONObj _foldSpec;
+
+    boost::optional<OID> _targetEpoch() const {
         return _targetCollectionVersion ? boost::optional<OID>(_targetCollectionVersion->epoch())
                                         : boost::none;
     }
 
 private:
+    class ParallelWriters;
+
+    /**
+     * Returns the number of writer threads batches should be spread over, or 1 if they should all
+     * be written on this thread.
+     */
+    size_t _getNumWriters() const;
+
     /**
      * If 'spec' does not specify a uniqueKey, uses the sharding catalog to pick a default key of
      * the shard key + _id. Returns a pair of the uniqueKey (either from the spec or generated), and
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_out_in_place.h"
+
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+DocumentSourceOutInPlaceFold::DocumentSourceOutInPlaceFold(
+    NamespaceString outputNs,
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    WriteModeEnum mode,
+    std::set<FieldPath> uniqueKey,
+    boost::optional<ChunkVersion> targetCollectionVersion,
+    BSONObj foldSpec)
+    : DocumentSourceOutInPlace(std::move(outputNs),
+                               expCtx,
+                               mode,
+                               std::move(uniqueKey),
+                               targetCollectionVersion,
+                               std::move(foldSpec)) {
+    for (auto&& elem : _foldSpec) {
+        const auto fieldName = elem.fieldNameStringData();
+        uassert(51119,
+                str::stream() << "$out fold field '" << fieldName
+                              << "' must be a top-level field name",
+                !fieldName.empty() && fieldName[0] != '$' &&
+                    fieldName.find('.') == std::string::npos);
+
+        const auto op = elem.type() == BSONType::String ? elem.valueStringData() : StringData();
+        if (op == "$sum"_sd) {
+            _foldOperators[fieldName] = "$inc"_sd;
+        } else if (op == "$min"_sd || op == "$max"_sd) {
+            _foldOperators[fieldName] = elem.valueStringData();
+        } else {
+            uasserted(51120,
+                      str::stream() << "$out fold field '" << fieldName
+                                    << "' must be one of \"$sum\", \"$min\" or \"$max\", but found "
+                                    << elem);
+        }
+    }
+}
+
+BSONObj DocumentSourceOutInPlaceFold::makeFoldUpdate(const BSONObj& obj,
+                                                     const BSONObj& uniqueKey) const {
+    BSONObjBuilder setFields;
+    BSONObjBuilder incFields;
+    BSONObjBuilder minFields;
+    BSONObjBuilder maxFields;
+    for (auto&& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+
+        // The unique key is matched by the query, and inserted from it on an upsert.
+        if (uniqueKey.hasField(fieldName)) {
+            continue;
+        }
+
+        auto it = _foldOperators.find(fieldName);
+        if (it == _foldOperators.end()) {
+            setFields.append(elem);
+        } else if (it->second == "$inc"_sd) {
+            incFields.append(elem);
+        } else if (it->second == "$min"_sd) {
+            minFields.append(elem);
+        } else {
+            maxFields.append(elem);
+        }
+    }
+
+    BSONObjBuilder update;
+    for (auto&& op : {std::make_pair("$set"_sd, &setFields),
+                      std::make_pair("$inc"_sd, &incFields),
+                      std::make_pair("$min"_sd, &minFields),
+                      std::make_pair("$max"_sd, &maxFields)}) {
+        BSONObj fields = op.second->obj();
+        if (!fields.isEmpty()) {
+            update.append(op.first, fields);
+        }
+    }
+
+    // An update must modify something, so a document holding only its unique key is inserted
+    // as it is and otherwise leaves the target unchanged.
+    if (update.asTempObj().isEmpty()) {
+        update.append("$setOnInsert", uniqueKey);
+    }
+    return update.obj();
+}
+
+void DocumentSourceOutInPlaceFold::spill(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                         BatchedObjects&& batch) {
+    std::vector<BSONObj> updates;
+    updates.reserve(batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        updates.push_back(makeFoldUpdate(batch.objects[i], batch.uniqueKeys[i]));
+    }
+
+    // Set upsert to true and multi to false as there should be at most one document to update
+    // or insert.
+    constexpr auto upsert = true;
+    constexpr auto multi = false;
+    try {
+        LocalReadConcernBlock readLocal(expCtx->opCtx);
+
+        expCtx->mongoProcessInterface->update(expCtx,
+                                              getWriteNs(),
+                                              std::move(batch.uniqueKeys),
+                                              std::move(updates),
+                                              _writeConcern,
+                                              upsert,
+                                              multi,
+                                              _targetEpoch());
+    } catch (const ExceptionFor<ErrorCodes::ImmutableField>& ex) {
+        uassertStatusOKWithContext(ex.toStatus(),
+                                   "$out failed to fold into the matching document, did you "
+                                   "attempt to modify the _id or the shard key?");
+    } catch (const ExceptionFor<ErrorCodes::TypeMismatch>& ex) {
+        uassertStatusOKWithContext(ex.toStatus(),
+                                   "$out failed to fold into the matching document, are the "
+                                   "values of a \"$sum\" field numeric?");
+    }
+}
+
+}  // namespace mongo
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/pipeline/document_source_out.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -62,22 +63,23 @@ class DocumentSourceOutInPlaceReplace final : public DocumentSourceOutInPlace {
 public:
     using DocumentSourceOutInPlace::DocumentSourceOutInPlace;
 
-    void spill(BatchedObjects&& batch) final {
+    void spill(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+               BatchedObjects&& batch) final {
         // Set upsert to true and multi to false as there should be at most one document to update
         // or insert.
         constexpr auto upsert = true;
         constexpr auto multi = false;
         try {
-            LocalReadConcernBlock readLocal(pExpCtx->opCtx);
-
-            pExpCtx->mongoProcessInterface->update(pExpCtx,
-                                                   getWriteNs(),
-                                                   std::move(batch.uniqueKeys),
-                                                   std::move(batch.objects),
-                                                   _writeConcern,
-                                                   upsert,
-                                                   multi,
-                                                   _targetEpoch());
+            LocalReadConcernBlock readLocal(expCtx->opCtx);
+
+            expCtx->mongoProcessInterface->update(expCtx,
+                                                  getWriteNs(),
+                                                  std::move(batch.uniqueKeys),
+                                                  std::move(batch.objects),
+                                                  _writeConcern,
+                                                  upsert,
+                                                  multi,
+                                                  _targetEpoch());
         } catch (const ExceptionFor<ErrorCodes::ImmutableField>& ex) {
             uassertStatusOKWithContext(ex.toStatus(),
                                        "$out failed to update the matching document, did you "
@@ -86,4 +88,32 @@ public:
     }
 };
 
+/**
+ * Version of $out which folds each document into the document in the output collection that
+ * matches the unique key, or inserts the document if there is no match. Fields named in the fold
+ * spec are combined with the target's value by $inc, $min or $max, so that results aggregated
+ * from new input can be added to a summary of earlier input. All other fields are set.
+ */
+class DocumentSourceOutInPlaceFold final : public DocumentSourceOutInPlace {
+public:
+    DocumentSourceOutInPlaceFold(NamespaceString outputNs,
+                                 const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 WriteModeEnum mode,
+                                 std::set<FieldPath> uniqueKey,
+                                 boost::optional<ChunkVersion> targetCollectionVersion,
+                                 BSONObj foldSpec);
+
+    void spill(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+               BatchedObjects&& batch) final;
+
+private:
+    /**
+     * Returns the update which folds 'obj', whose unique key is 'uniqueKey', into its target.
+     */
+    BSONObj makeFoldUpdate(const BSONObj& obj, const BSONObj& uniqueKey) const;
+
+    // The update operator applying to each folded field.
+    StringMap<StringData> _foldOperators;
+};
+
 }  // namespace mongo
@@ -33,8 +33,12 @@
 
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -46,6 +50,7 @@ StringData kUniqueKeyFieldName = DocumentSourceOutSpec::kUniqueKeyFieldName;
 StringData kDefaultMode = WriteMode_serializer(WriteModeEnum::kModeReplaceCollection);
 StringData kInsertDocumentsMode = WriteMode_serializer(WriteModeEnum::kModeInsertDocuments);
 StringData kReplaceDocumentsMode = WriteMode_serializer(WriteModeEnum::kModeReplaceDocuments);
+StringData kFoldDocumentsMode = WriteMode_serializer(WriteModeEnum::kModeFoldDocuments);
 
 /**
  * For the purpsoses of this test, assume every collection is unsharded. Stages may ask this during
@@ -74,6 +79,38 @@ public:
     }
 };
 
+/**
+ * Records every document written to it, from whichever thread writes it.
+ */
+class WriteRecordingMongoProcessInterface final : public MongoProcessInterfaceForTest {
+public:
+    void insert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                const NamespaceString& ns,
+                std::vector<BSONObj>&& objs,
+                const WriteConcernOptions& wc,
+                boost::optional<OID>) override {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        written.insert(written.end(), objs.begin(), objs.end());
+    }
+
+    void update(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                const NamespaceString& ns,
+                std::vector<BSONObj>&& queries,
+                std::vector<BSONObj>&& updates,
+                const WriteConcernOptions& wc,
+                bool upsert,
+                bool multi,
+                boost::optional<OID>) override {
+        uassert(ErrorCodes::DuplicateKey, "injected update failure", !failUpdates);
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        written.insert(written.end(), updates.begin(), updates.end());
+    }
+
+    stdx::mutex mutex;
+    std::vector<BSONObj> written;
+    bool failUpdates = false;
+};
+
 class DocumentSourceOutTest : public AggregationContextFixture {
 public:
     DocumentSourceOutTest() : AggregationContextFixture() {
@@ -418,5 +455,175 @@ TEST_F(DocumentSourceOutTest, CorrectlyUsesForeignTargetDb) {
 
     ASSERT_THROWS_CODE(createOutStage(spec), AssertionException, 50939);
 }
+TEST_F(DocumentSourceOutTest, SerializeFoldSpec) {
+    BSONObj spec = BSON("$out" << BSON("to"
+                                       << "target"
+                                       << "mode"
+                                       << kFoldDocumentsMode
+                                       << "fold"
+                                       << BSON("count"
+                                               << "$sum"
+                                               << "last"
+                                               << "$max")));
+    auto outStage = createOutStage(spec);
+    ASSERT(outStage->getMode() == WriteModeEnum::kModeFoldDocuments);
+    auto serialized = outStage->serialize().getDocument();
+    ASSERT_EQ(serialized["$out"][kModeFieldName].getStringData(), kFoldDocumentsMode);
+    ASSERT_DOCUMENT_EQ(serialized["$out"]["fold"].getDocument(),
+                       (Document{{"count", "$sum"_sd}, {"last", "$max"_sd}}));
+
+    // Make sure we can reparse the serialized BSON.
+    auto reSerialized = createOutStage(serialized.toBson())->serialize().getDocument();
+    ASSERT_VALUE_EQ(reSerialized["$out"]["fold"], serialized["$out"]["fold"]);
+}
+
+TEST_F(DocumentSourceOutTest, FailsToParseIfFoldSpecDoesNotMatchMode) {
+    BSONObj spec = BSON("$out" << BSON("to"
+                                       << "target"
+                                       << "mode"
+                                       << kFoldDocumentsMode));
+    ASSERT_THROWS_CODE(createOutStage(spec), AssertionException, 51121);
+
+    spec = BSON("$out" << BSON("to"
+                               << "target"
+                               << "mode"
+                               << kReplaceDocumentsMode
+                               << "fold"
+                               << BSON("count"
+                                       << "$sum")));
+    ASSERT_THROWS_CODE(createOutStage(spec), AssertionException, 51124);
+}
+
+TEST_F(DocumentSourceOutTest, FailsToParseIfFoldSpecIsInvalid) {
+    auto makeSpec = [](BSONObj fold) {
+        return BSON("$out" << BSON("to"
+                                   << "target"
+                                   << "mode"
+                                   << kFoldDocumentsMode
+                                   << "fold"
+                                   << fold));
+    };
+
+    ASSERT_THROWS_CODE(createOutStage(makeSpec(BSON("count"
+                                                    << "$avg"))),
+                       AssertionException,
+                       51120);
+    ASSERT_THROWS_CODE(createOutStage(makeSpec(BSON("count" << 1))), AssertionException, 51120);
+    ASSERT_THROWS_CODE(createOutStage(makeSpec(BSON("a.count"
+                                                    << "$sum"))),
+                       AssertionException,
+                       51119);
+    ASSERT_THROWS_CODE(createOutStage(makeSpec(BSON("_id"
+                                                    << "$max"))),
+                       AssertionException,
+                       51123);
+}
+
+class DocumentSourceOutParallelWritersTest : public DocumentSourceOutTest {
+public:
+    DocumentSourceOutParallelWritersTest()
+        : _oldNumWriters(internalDocumentSourceOutNumWriters.load()),
+          _processInterface(std::make_shared<WriteRecordingMongoProcessInterface>()) {
+        internalDocumentSourceOutNumWriters.store(4);
+        getExpCtx()->mongoProcessInterface = _processInterface;
+    }
+
+    ~DocumentSourceOutParallelWritersTest() {
+        internalDocumentSourceOutNumWriters.store(_oldNumWriters);
+    }
+
+    /**
+     * Runs a $out stage with the given mode over 'inputs', and returns the stage's result.
+     */
+    DocumentSource::GetNextResult runOut(StringData mode,
+                                         const std::deque<DocumentSource::GetNextResult>& inputs) {
+        auto outStage = createOutStage(BSON("$out" << BSON("to"
+                                                           << "target"
+                                                           << "mode"
+                                                           << mode)));
+        auto mock = DocumentSourceMock::create(inputs);
+        outStage->setSource(mock.get());
+        return outStage->getNext();
+    }
+
+    WriteRecordingMongoProcessInterface& processInterface() {
+        return *_processInterface;
+    }
+
+private:
+    const int _oldNumWriters;
+    std::shared_ptr<WriteRecordingMongoProcessInterface> _processInterface;
+};
+
+TEST_F(DocumentSourceOutParallelWritersTest, WritesEveryDocument) {
+    std::deque<DocumentSource::GetNextResult> inputs;
+    const int nDocs = 500;
+    for (int i = 0; i < nDocs; ++i) {
+        inputs.emplace_back(Document{{"_id", i}});
+    }
+    ASSERT_TRUE(runOut(kInsertDocumentsMode, inputs).isEOF());
+
+    auto& written = processInterface().written;
+    ASSERT_EQ(written.size(), static_cast<size_t>(nDocs));
+    std::set<int> ids;
+    for (auto&& obj : written) {
+        ids.insert(obj["_id"].numberInt());
+    }
+    ASSERT_EQ(ids.size(), static_cast<size_t>(nDocs));
+}
+
+TEST_F(DocumentSourceOutParallelWritersTest, WritesDocumentsWithTheSameUniqueKeyInOrder) {
+    std::deque<DocumentSource::GetNextResult> inputs;
+    const int nDocs = 500;
+    const int nKeys = 20;
+    for (int i = 0; i < nDocs; ++i) {
+        inputs.emplace_back(Document{{"_id", i % nKeys}, {"seq", i}});
+    }
+    ASSERT_TRUE(runOut(kReplaceDocumentsMode, inputs).isEOF());
+
+    auto& written = processInterface().written;
+    ASSERT_EQ(written.size(), static_cast<size_t>(nDocs));
+    std::map<int, int> lastSeqForKey;
+    for (auto&& obj : written) {
+        const int key = obj["_id"].numberInt();
+        const int seq = obj["seq"].numberInt();
+        auto it = lastSeqForKey.find(key);
+        if (it != lastSeqForKey.end()) {
+            ASSERT_LT(it->second, seq);
+        }
+        lastSeqForKey[key] = seq;
+    }
+    ASSERT_EQ(lastSeqForKey.size(), static_cast<size_t>(nKeys));
+}
+
+TEST_F(DocumentSourceOutParallelWritersTest, WritesEveryBatchBeforePropagatingAPause) {
+    std::deque<DocumentSource::GetNextResult> inputs{
+        Document{{"_id", 0}},
+        Document{{"_id", 1}},
+        DocumentSource::GetNextResult::makePauseExecution(),
+        Document{{"_id", 2}}};
+    auto outStage = createOutStage(BSON("$out" << BSON("to"
+                                                       << "target"
+                                                       << "mode"
+                                                       << kReplaceDocumentsMode)));
+    auto mock = DocumentSourceMock::create(inputs);
+    outStage->setSource(mock.get());
+
+    ASSERT_TRUE(outStage->getNext().isPaused());
+    ASSERT_EQ(processInterface().written.size(), 2U);
+    ASSERT_TRUE(outStage->getNext().isEOF());
+    ASSERT_EQ(processInterface().written.size(), 3U);
+}
+
+TEST_F(DocumentSourceOutParallelWritersTest, ThrowsTheErrorOfAFailedWriter) {
+    processInterface().failUpdates = true;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.emplace_back(Document{{"_id", i}});
+    }
+    ASSERT_THROWS_CODE(
+        runOut(kReplaceDocumentsMode, inputs), AssertionException, ErrorCodes::DuplicateKey);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -31,16 +31,32 @@
 
 #include "mongo/db/pipeline/document_source_sample.h"
 
+#include <algorithm>
+
 #include "mongo/db/client.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 using boost::intrusive_ptr;
 
+namespace {
+/**
+ * Orders reservoir entries by descending random value. A heap built with it keeps the entry with
+ * the smallest random value at the front, and sorting with it puts the largest value first.
+ */
+struct RandValGreater {
+    bool operator()(const std::pair<double, Document>& lhs,
+                    const std::pair<double, Document>& rhs) const {
+        return lhs.first > rhs.first;
+    }
+};
+}  // namespace
+
 constexpr StringData DocumentSourceSample::kStageName;
 
 DocumentSourceSample::DocumentSourceSample(const intrusive_ptr<ExpressionContext>& pExpCtx)
@@ -56,14 +72,20 @@ DocumentSource::GetNextResult DocumentSourceSample::getNext() {
 
     pExpCtx->checkForInterrupt();
 
-    if (!_sortStage->isPopulated()) {
-        // Exhaust source stage, add random metadata, and push all into sorter.
+    if (!_populated) {
+        // Exhaust source stage, giving each document a random value and keeping those with the
+        // largest values.
         PseudoRandom& prng = pExpCtx->opCtx->getClient()->getPrng();
         auto nextInput = pSource->getNext();
         for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-            MutableDocument doc(nextInput.releaseDocument());
-            doc.setRandMetaField(prng.nextCanonicalDouble());
-            _sortStage->loadDocument(doc.freeze());
+            const double randVal = prng.nextCanonicalDouble();
+            if (_usingSortStage) {
+                MutableDocument doc(nextInput.releaseDocument());
+                doc.setRandMetaField(randVal);
+                _sortStage->loadDocument(doc.freeze());
+            } else {
+                addToReservoir(randVal, nextInput.releaseDocument());
+            }
         }
         switch (nextInput.getStatus()) {
             case GetNextResult::ReturnStatus::kAdvanced: {
@@ -73,13 +95,72 @@ DocumentSource::GetNextResult DocumentSourceSample::getNext() {
                 return nextInput;  // Propagate the pause.
             }
             case GetNextResult::ReturnStatus::kEOF: {
-                _sortStage->loadingDone();
+                _populated = true;
+                if (_usingSortStage) {
+                    _sortStage->loadingDone();
+                } else {
+                    // Turn the heap into the order in which the sample is returned.
+                    std::sort_heap(_reservoir.begin(), _reservoir.end(), RandValGreater());
+                }
             }
         }
     }
 
-    invariant(_sortStage->isPopulated());
-    return _sortStage->getNext();
+    if (_usingSortStage) {
+        invariant(_sortStage->isPopulated());
+        return _sortStage->getNext();
+    }
+    return getNextFromReservoir();
+}
+
+void DocumentSourceSample::addToReservoir(double randVal, Document&& doc) {
+    if (_reservoir.size() == static_cast<size_t>(_size)) {
+        // The reservoir is full, so 'doc' only belongs in the sample if it beats the smallest
+        // random value in it.
+        if (randVal <= _reservoir.front().first) {
+            return;
+        }
+        std::pop_heap(_reservoir.begin(), _reservoir.end(), RandValGreater());
+        _reservoirBytes -= _reservoir.back().second.getApproximateSize();
+        _reservoir.pop_back();
+    }
+
+    _reservoirBytes += doc.getApproximateSize();
+    _reservoir.emplace_back(randVal, std::move(doc));
+    std::push_heap(_reservoir.begin(), _reservoir.end(), RandValGreater());
+
+    const auto maxMemoryUsageBytes = internalDocumentSourceSortMaxBlockingSortBytes.load();
+    if (_reservoirBytes > static_cast<size_t>(maxMemoryUsageBytes)) {
+        spillReservoirToSortStage();
+    }
+}
+
+void DocumentSourceSample::spillReservoirToSortStage() {
+    for (auto&& entry : _reservoir) {
+        MutableDocument doc(std::move(entry.second));
+        doc.setRandMetaField(entry.first);
+        _sortStage->loadDocument(doc.freeze());
+    }
+    _reservoir.clear();
+    _reservoir.shrink_to_fit();
+    _reservoirBytes = 0;
+    _usingSortStage = true;
+}
+
+DocumentSource::GetNextResult DocumentSourceSample::getNextFromReservoir() {
+    if (_reservoirPos == _reservoir.size()) {
+        return GetNextResult::makeEOF();
+    }
+
+    auto& entry = _reservoir[_reservoirPos++];
+    MutableDocument doc(std::move(entry.second));
+    doc.setRandMetaField(entry.first);
+    if (pExpCtx->needsMerge) {
+        // The merging half of the pipeline merges the samples from each shard by random value,
+        // which it expects to find in the sort key metadata.
+        doc.setSortKeyMetaField(BSON("" << entry.first));
+    }
+    return doc.freeze();
 }
 
 Value DocumentSourceSample::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
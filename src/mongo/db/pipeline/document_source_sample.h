@@ -29,11 +29,24 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 
 namespace mongo {
 
+/**
+ * Draws a uniform random sample of 'size' documents from its input.
+ *
+ * Every input document is given a random value, and the stage keeps only the 'size' documents with
+ * the largest values seen so far in a reservoir, so at most 'size' documents are held in memory and
+ * the input is never sorted. The sample is returned in descending order of random value, which is
+ * the order in which the merging half of a sharded $sample expects it. Should the reservoir grow
+ * past the memory limit of a blocking sort, the stage falls back to a top-k $sort by random value,
+ * which may spill to disk.
+ */
 class DocumentSourceSample final : public DocumentSource {
 public:
     static constexpr StringData kStageName = "$sample"_sd;
@@ -69,9 +82,39 @@ public:
 private:
     explicit DocumentSourceSample(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    /**
+     * Offers 'doc' with random value 'randVal' to the reservoir, evicting the document with the
+     * smallest random value if the reservoir is full. Moves the reservoir into '_sortStage' if it
+     * no longer fits in memory.
+     */
+    void addToReservoir(double randVal, Document&& doc);
+
+    /**
+     * Loads the contents of the reservoir into '_sortStage', and sends all further input there.
+     */
+    void spillReservoirToSortStage();
+
+    /**
+     * Returns the next document of the sample, once the input has been exhausted.
+     */
+    GetNextResult getNextFromReservoir();
+
     long long _size;
 
-    // Uses a $sort stage to randomly sort the documents.
+    // The documents with the largest random values seen so far. Kept as a min-heap on the random
+    // value while the input is being consumed, then sorted in descending order of random value.
+    std::vector<std::pair<double, Document>> _reservoir;
+    size_t _reservoirBytes = 0;
+    size_t _reservoirPos = 0;
+
+    // True once the input has been exhausted.
+    bool _populated = false;
+
+    // True if the reservoir outgrew the memory limit and the sample is being taken by
+    // '_sortStage' instead.
+    bool _usingSortStage = false;
+
+    // Randomly sorts the documents if they do not fit in the reservoir.
     boost::intrusive_ptr<DocumentSourceSort> _sortStage;
 };
 
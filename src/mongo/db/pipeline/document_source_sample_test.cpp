@@ -31,6 +31,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/bson/bsonelement.h"
 #include "mongo/bson/bsonobj.h"
@@ -41,10 +42,12 @@
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/tick_source_mock.h"
 
 namespace mongo {
@@ -189,6 +192,69 @@ TEST_F(SampleBasics, ShouldPropagatePauses) {
     assertEOF();
 }
 
+/**
+ * Every input document should be equally likely to be part of the sample.
+ */
+TEST_F(SampleBasics, ShouldSampleEachDocumentWithEqualProbability) {
+    // Sample 2 out of 4 documents, so that each document is chosen with probability 0.5. With 4000
+    // trials each count has a standard deviation of about 32, so a tolerance of 200 makes spurious
+    // failures vanishingly rare.
+    const int nTrials = 4000;
+    std::vector<int> timesSampled(4, 0);
+    for (int i = 0; i < nTrials; i++) {
+        loadDocuments(4);
+        createSample(2);
+        for (int j = 0; j < 2; j++) {
+            auto next = sample()->getNext();
+            ASSERT_TRUE(next.isAdvanced());
+            ++timesSampled[next.getDocument()["_id"].getInt()];
+        }
+        assertEOF();
+    }
+    for (int count : timesSampled) {
+        ASSERT_GTE(count, nTrials / 2 - 200);
+        ASSERT_LTE(count, nTrials / 2 + 200);
+    }
+}
+
+TEST_F(SampleBasics, ShouldSetSortKeyForMergingWhenNeedsMerge) {
+    getExpCtx()->needsMerge = true;
+    loadDocuments(5);
+    createSample(3);
+    for (int i = 0; i < 3; i++) {
+        auto next = sample()->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto doc = next.releaseDocument();
+        ASSERT_TRUE(doc.hasSortKeyMetaField());
+        ASSERT_BSONOBJ_EQ(BSON("" << doc.getRandMetaField()), doc.getSortKeyMetaField());
+    }
+    assertEOF();
+}
+
+TEST_F(SampleBasics, ShouldFallBackToSortWhenSampleDoesNotFitInMemory) {
+    loadDocuments(20);
+    createSample(10);
+
+    // The reservoir outgrows this limit after a document or two, but the $sort stage the sample
+    // falls back to was created with the default limit and can still hold the whole sample.
+    const auto oldMaxBytes = internalDocumentSourceSortMaxBlockingSortBytes.load();
+    internalDocumentSourceSortMaxBlockingSortBytes.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceSortMaxBlockingSortBytes.store(oldMaxBytes); });
+
+    boost::optional<Document> prevDoc;
+    for (int i = 0; i < 10; i++) {
+        auto next = sample()->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto doc = next.releaseDocument();
+        ASSERT_TRUE(doc.hasRandMetaField());
+        if (prevDoc) {
+            ASSERT_LTE(doc.getRandMetaField(), prevDoc->getRandMetaField());
+        }
+        prevDoc = std::move(doc);
+    }
+    assertEOF();
+}
+
 /**
  * Fixture to test error cases of the $sample stage.
  */
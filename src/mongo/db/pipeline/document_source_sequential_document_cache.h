@@ -69,6 +69,14 @@ public:
 
     GetNextResult getNext() final;
 
+    /**
+     * The cache holds exactly the documents produced by the preceding stages, so it adds no
+     * dependencies of its own and the fields needed are determined by the stages after it.
+     */
+    DepsTracker::State getDependencies(DepsTracker* deps) const final {
+        return DepsTracker::State::SEE_NEXT;
+    }
+
     static boost::intrusive_ptr<DocumentSourceSequentialDocumentCache> create(
         const boost::intrusive_ptr<ExpressionContext>& pExpCtx, SequentialDocumentCache* cache) {
         return new DocumentSourceSequentialDocumentCache(pExpCtx, cache);
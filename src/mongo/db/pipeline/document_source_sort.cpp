@@ -42,6 +42,7 @@
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -126,6 +127,10 @@ REGISTER_DOCUMENT_SOURCE(sort,
 DocumentSource::GetNextResult DocumentSourceSort::getNext() {
     pExpCtx->checkForInterrupt();
 
+    if (_sortedPrefixLength > 0) {
+        return getNextFromSortedRuns();
+    }
+
     if (!_populated) {
         const auto populationResult = populate();
         if (populationResult.isPaused()) {
@@ -145,10 +150,14 @@ DocumentSource::GetNextResult DocumentSourceSort::getNext() {
 void DocumentSourceSort::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     if (explain) {  // always one Value for combined $sort + $limit
-        array.push_back(
-            Value(DOC(kStageName << DOC(
-                          "sortKey" << sortKeyPattern(SortKeySerialization::kForExplain) << "limit"
-                                    << (_limitSrc ? Value(_limitSrc->getLimit()) : Value())))));
+        array.push_back(Value(DOC(
+            kStageName << DOC(
+                "sortKey" << sortKeyPattern(SortKeySerialization::kForExplain) << "limit"
+                          << (_limitSrc ? Value(_limitSrc->getLimit()) : Value())
+                          << "sortedPrefixLength"
+                          << (_sortedPrefixLength > 0
+                                  ? Value(static_cast<long long>(_sortedPrefixLength))
+                                  : Value())))));
     } else {  // one Value for $sort and maybe a Value for $limit
         MutableDocument inner(sortKeyPattern(SortKeySerialization::kForPipelineSerialization));
         array.push_back(Value(DOC(kStageName << inner.freeze())));
@@ -161,6 +170,8 @@ void DocumentSourceSort::serializeToArray(
 
 void DocumentSourceSort::doDispose() {
     _output.reset();
+    _sorter.reset();
+    _nextRunItem = boost::none;
 }
 
 long long DocumentSourceSort::getLimit() const {
@@ -341,6 +352,14 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
         opts.tempDir = pExpCtx->tempDir;
     }
 
+    opts.memoryBroker = SorterMemoryBroker::get();
+    str::stream consumerName;
+    consumerName << "$sort: " << pExpCtx->ns.ns();
+    if (pExpCtx->opCtx) {
+        consumerName << " opid " << pExpCtx->opCtx->getOpID();
+    }
+    opts.memoryConsumerName = consumerName;
+
     return opts;
 }
 
@@ -380,6 +399,91 @@ void DocumentSourceSort::loadingDone() {
     _populated = true;
 }
 
+void DocumentSourceSort::setSortedPrefixLength(size_t prefixLength) {
+    invariant(prefixLength < _sortPattern.size());
+    for (size_t i = 0; i < prefixLength; ++i) {
+        invariant(_sortPattern[i].fieldPath);
+    }
+    _sortedPrefixLength = prefixLength;
+}
+
+DocumentSource::GetNextResult DocumentSourceSort::getNextFromSortedRuns() {
+    for (;;) {
+        if (_output && _output->more()) {
+            ++_numReturned;
+            return _output->next().second;
+        }
+        _output.reset();
+
+        const bool reachedLimit = _limitSrc && _numReturned >= _limitSrc->getLimit();
+        if (reachedLimit || (_inputExhausted && !_nextRunItem)) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+
+        const auto loadResult = loadNextRun();
+        if (loadResult.isPaused()) {
+            return loadResult;
+        }
+        invariant(loadResult.isEOF());
+    }
+}
+
+DocumentSource::GetNextResult DocumentSourceSort::loadNextRun() {
+    if (!_sorter) {
+        // Earlier runs have used up part of the limit.
+        auto opts = makeSortOptions();
+        if (_limitSrc) {
+            opts.limit = _limitSrc->getLimit() - _numReturned;
+        }
+        _sorter.reset(MySorter::make(opts, Comparator(*this)));
+
+        if (_nextRunItem) {
+            _runKey = _nextRunItem->first;
+            _sorter->add(_nextRunItem->first, _nextRunItem->second);
+            _nextRunItem = boost::none;
+        }
+    }
+
+    auto nextInput = _inputExhausted ? GetNextResult::makeEOF() : pSource->getNext();
+    for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
+        auto item = extractSortKey(nextInput.releaseDocument());
+        if (!_runKey) {
+            _runKey = item.first;
+        } else if (!inSameRun(*_runKey, item.first)) {
+            // This document begins the next run, so the current one is complete.
+            _nextRunItem = std::move(item);
+            break;
+        }
+        _sorter->add(item.first, item.second);
+    }
+
+    if (nextInput.isPaused()) {
+        return nextInput;
+    }
+    if (nextInput.isEOF()) {
+        _inputExhausted = true;
+    }
+
+    _output.reset(_sorter->done());
+    _usedDisk = _sorter->usedDisk() || _usedDisk;
+    _sorter.reset();
+    _runKey = boost::none;
+    return GetNextResult::makeEOF();
+}
+
+bool DocumentSourceSort::inSameRun(const Value& lhs, const Value& rhs) const {
+    // A sorted prefix is shorter than the pattern, so the keys are arrays with one element per
+    // part. The query system orders missing fields together with nulls.
+    ValueComparator comparator;
+    for (size_t i = 0; i < _sortedPrefixLength; ++i) {
+        if (comparator.compare(missingToNull(lhs[i]), missingToNull(rhs[i])) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool DocumentSourceSort::usedDisk() {
     return _usedDisk;
 }
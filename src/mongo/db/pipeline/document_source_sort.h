@@ -140,6 +140,18 @@ public:
         return _limitSrc;
     }
 
+    /**
+     * Tells the stage that its input is already ordered by the first 'prefixLength' parts of the
+     * sort pattern, which must be field paths. Each run of input documents sharing those parts is
+     * then sorted and returned before the next run is read, so that results stream and only one
+     * run is buffered at a time. A length of zero restores the fully blocking sort.
+     */
+    void setSortedPrefixLength(size_t prefixLength);
+
+    size_t getSortedPrefixLength() const {
+        return _sortedPrefixLength;
+    }
+
 protected:
     /**
      * Attempts to absorb a subsequent $limit stage so that it an perform a top-k sort.
@@ -190,6 +202,25 @@ private:
      */
     GetNextResult populate();
 
+    /**
+     * Returns the next result when the input is ordered by a prefix of the sort pattern, loading
+     * and sorting the next run of input documents once the current one has been returned.
+     */
+    GetNextResult getNextFromSortedRuns();
+
+    /**
+     * Reads input documents into '_sorter' until one arrives which does not share the sorted
+     * prefix of those before it, or the input is exhausted, and then prepares '_output' to return
+     * the run. Like populate(), returns kPauseExecution if the input paused before the run was
+     * complete, in which case the next call resumes loading it, and kEOF otherwise.
+     */
+    GetNextResult loadNextRun();
+
+    /**
+     * Returns true if the sort keys 'lhs' and 'rhs' agree on the sorted prefix of the pattern.
+     */
+    bool inSameRun(const Value& lhs, const Value& rhs) const;
+
     SortOptions makeSortOptions() const;
 
     /**
@@ -258,6 +289,22 @@ private:
     std::unique_ptr<MySorter> _sorter;
     std::unique_ptr<MySorter::Iterator> _output;
     bool _usedDisk = false;
+
+    // The number of leading parts of '_sortPattern' by which the input is already ordered. When
+    // nonzero, the input is sorted one run of documents sharing that prefix at a time.
+    size_t _sortedPrefixLength = 0;
+
+    // The sort key of the first document of the run being loaded into '_sorter', if any.
+    boost::optional<Value> _runKey;
+
+    // The first document of the next run, read while loading the current one.
+    boost::optional<std::pair<Value, Document>> _nextRunItem;
+
+    // Set once the input has returned EOF to a sorted run.
+    bool _inputExhausted = false;
+
+    // The number of results returned by sorted runs, which are limited together.
+    long long _numReturned = 0;
 };
 
 }  // namespace mongo
@@ -429,6 +429,68 @@ TEST_F(DocumentSourceSortExecutionTest, ShouldBeAbleToPauseLoadingWhileSpilled)
     ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
 }
 
+TEST_F(DocumentSourceSortExecutionTest, ShouldSortEachRunOfInputSharingTheSortedPrefix) {
+    auto sort = DocumentSourceSort::create(getExpCtx(), BSON("a" << 1 << "b" << -1));
+    sort->setSortedPrefixLength(1);
+
+    // Missing values of 'a' arrive in the same run as nulls, but still sort before them.
+    auto mock = DocumentSourceMock::create({Document{{"a", BSONNULL}, {"b", 1}},
+                                            Document{{"b", 3}},
+                                            Document{{"a", BSONNULL}, {"b", 2}},
+                                            Document{{"a", 1}, {"b", 1}},
+                                            Document{{"a", 1}, {"b", 2}},
+                                            Document{{"a", 2}, {"b", 5}}});
+    sort->setSource(mock.get());
+
+    // The first run is returned once the first document of the next one has been read.
+    auto next = sort->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"b", 3}}));
+    ASSERT_EQ(mock->queue.size(), 2UL);
+
+    for (auto&& expected : {Document{{"a", BSONNULL}, {"b", 2}},
+                            Document{{"a", BSONNULL}, {"b", 1}},
+                            Document{{"a", 1}, {"b", 2}},
+                            Document{{"a", 1}, {"b", 1}},
+                            Document{{"a", 2}, {"b", 5}}}) {
+        next = sort->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expected);
+    }
+    ASSERT_TRUE(sort->getNext().isEOF());
+    ASSERT_TRUE(sort->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceSortExecutionTest, ShouldStopReadingSortedRunsOnceLimitIsReturned) {
+    auto sort = DocumentSourceSort::create(getExpCtx(), BSON("a" << 1 << "b" << 1), 3);
+    sort->setSortedPrefixLength(1);
+
+    auto mock = DocumentSourceMock::create({Document{{"a", 1}, {"b", 2}},
+                                            Document{{"a", 1}, {"b", 1}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 2}, {"b", 4}},
+                                            Document{{"a", 2}, {"b", 3}},
+                                            Document{{"a", 2}, {"b", 0}},
+                                            Document{{"a", 3}, {"b", 0}},
+                                            Document{{"a", 4}, {"b", 0}}});
+    sort->setSource(mock.get());
+
+    // A pause in the middle of a run is propagated.
+    ASSERT_TRUE(sort->getNext().isPaused());
+
+    for (auto&& expected : {Document{{"a", 1}, {"b", 1}},
+                            Document{{"a", 1}, {"b", 2}},
+                            Document{{"a", 2}, {"b", 0}}}) {
+        auto next = sort->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expected);
+    }
+    ASSERT_TRUE(sort->getNext().isEOF());
+
+    // The run holding the last result was read, but nothing after it.
+    ASSERT_EQ(mock->queue.size(), 1UL);
+}
+
 TEST_F(DocumentSourceSortExecutionTest,
        ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
@@ -33,9 +33,11 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
@@ -43,49 +45,33 @@ using boost::intrusive_ptr;
 using std::string;
 using std::vector;
 
-/** Helper class to unwind array from a single document. */
-class DocumentSourceUnwind::Unwinder {
-public:
-    Unwinder(const FieldPath& unwindPath,
-             bool preserveNullAndEmptyArrays,
-             const boost::optional<FieldPath>& indexPath);
-    /** Reset the unwinder to unwind a new document. */
-    void resetDocument(const Document& document);
+namespace {
 
-    /**
-     * @return the next document unwound from the document provided to resetDocument(), using
-     * the current value in the array located at the provided unwindPath.
-     *
-     * Returns boost::none if the array is exhausted.
-     */
-    DocumentSource::GetNextResult getNext();
-
-private:
-    // Tracks whether or not we can possibly return any more documents. Note we may return
-    // boost::none even if this is true.
-    bool _haveNext = false;
-
-    // Path to the array to unwind.
-    const FieldPath _unwindPath;
-
-    // Documents that have a nullish value, or an empty array for the field '_unwindPath', will pass
-    // through the $unwind stage unmodified if '_preserveNullAndEmptyArrays' is true.
-    const bool _preserveNullAndEmptyArrays;
-
-    // If set, the $unwind stage will include the array index in the specified path, overwriting any
-    // existing value, setting to null when the value was a non-array or empty array.
-    const boost::optional<FieldPath> _indexPath;
-
-    Value _inputArray;
-
-    MutableDocument _output;
-
-    // Document indexes of the field path components.
-    vector<Position> _unwindPathFieldIndexes;
+/**
+ * Converts 'bson' to a Document, except for the field at 'path' below component 'level', which is
+ * set to null so that it can be overwritten. Each component of 'path' but the last must name an
+ * embedded document in 'bson'.
+ */
+Document convertAllButPath(const BSONObj& bson, const FieldPath& path, size_t level) {
+    MutableDocument output(bson.nFields());
+    bool found = false;
+    for (auto&& elem : bson) {
+        const StringData fieldName = elem.fieldNameStringData();
+        if (found || fieldName != path.getFieldName(level)) {
+            output.addField(fieldName, Value(elem));
+        } else if (level == path.getPathLength() - 1) {
+            output.addField(fieldName, Value(BSONNULL));
+            found = true;
+        } else {
+            output.addField(fieldName,
+                            Value(convertAllButPath(elem.embeddedObject(), path, level + 1)));
+            found = true;
+        }
+    }
+    return output.freeze();
+}
 
-    // Index into the _inputArray to return next.
-    size_t _index;
-};
+}  // namespace
 
 DocumentSourceUnwind::Unwinder::Unwinder(const FieldPath& unwindPath,
                                          bool preserveNullAndEmptyArrays,
@@ -96,11 +82,53 @@ DocumentSourceUnwind::Unwinder::Unwinder(const FieldPath& unwindPath,
 
 void DocumentSourceUnwind::Unwinder::resetDocument(const Document& document) {
     // Reset document specific attributes.
-    _output.reset(document);
     _unwindPathFieldIndexes.clear();
     _index = 0;
-    _inputArray = document.getNestedField(_unwindPath, &_unwindPathFieldIndexes);
+    _inputArray = Value();
+    _backingBson = BSONObj();
+    _bsonArrayIt = boost::none;
     _haveNext = true;
+
+    if (resetFromBackingBson(document)) {
+        return;
+    }
+
+    _output.reset(document);
+    _inputArray = document.getNestedField(_unwindPath, &_unwindPathFieldIndexes);
+}
+
+bool DocumentSourceUnwind::Unwinder::resetFromBackingBson(const Document& document) {
+    // Only the metadata copied by copyMetaDataFrom() can be carried over to the output.
+    const BSONObj& bson = document.getUnmodifiedBackingBson();
+    if (bson.isEmpty() || document.hasSortKeyMetaField() || document.hasGeoNearDistance() ||
+        document.hasGeoNearPoint()) {
+        return false;
+    }
+
+    BSONObj parent = bson;
+    BSONElement array;
+    for (size_t level = 0; level < _unwindPath.getPathLength(); ++level) {
+        array = parent[_unwindPath.getFieldName(level)];
+        if (level < _unwindPath.getPathLength() - 1) {
+            if (array.type() != Object) {
+                return false;
+            }
+            parent = array.embeddedObject();
+        }
+    }
+    if (array.type() != Array || array.embeddedObject().isEmpty()) {
+        return false;
+    }
+
+    // Every field but the array is converted once, and each output document shares them.
+    Document base = convertAllButPath(bson, _unwindPath, 0);
+    base.getNestedField(_unwindPath, &_unwindPathFieldIndexes);
+    _output.reset(std::move(base));
+    _output.copyMetaDataFrom(document);
+
+    _backingBson = bson;
+    _bsonArrayIt.emplace(array.embeddedObject());
+    return true;
 }
 
 DocumentSource::GetNextResult DocumentSourceUnwind::Unwinder::getNext() {
@@ -114,7 +142,13 @@ DocumentSource::GetNextResult DocumentSourceUnwind::Unwinder::getNext() {
     // this index in the output document, or null if the value didn't come from an array.
     boost::optional<long long> indexForOutput;
 
-    if (_inputArray.getType() == Array) {
+    if (_bsonArrayIt) {
+        // The array is known to be non-empty. Only the element being unwound is converted.
+        _output.setNestedField(_unwindPathFieldIndexes, Value(_bsonArrayIt->next()));
+        indexForOutput = _index;
+        _index++;
+        _haveNext = _bsonArrayIt->more();
+    } else if (_inputArray.getType() == Array) {
         const size_t length = _inputArray.getArrayLength();
         invariant(_index == 0 || _index < length);
 
@@ -164,7 +198,11 @@ DocumentSourceUnwind::DocumentSourceUnwind(const intrusive_ptr<ExpressionContext
       _unwindPath(fieldPath),
       _preserveNullAndEmptyArrays(preserveNullAndEmptyArrays),
       _indexPath(indexPath),
-      _unwinder(new Unwinder(fieldPath, preserveNullAndEmptyArrays, indexPath)) {}
+      _unwinder(createUnwinder()) {}
+
+std::unique_ptr<DocumentSourceUnwind::Unwinder> DocumentSourceUnwind::createUnwinder() const {
+    return stdx::make_unique<Unwinder>(_unwindPath, _preserveNullAndEmptyArrays, _indexPath);
+}
 
 REGISTER_DOCUMENT_SOURCE(unwind,
                          LiteParsedDocumentSourceDefault::parse,
@@ -207,6 +245,22 @@ DocumentSource::GetNextResult DocumentSourceUnwind::getNext() {
     return nextOut;
 }
 
+Pipeline::SourceContainer::iterator DocumentSourceUnwind::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextGroup = dynamic_cast<DocumentSourceGroup*>((*std::next(itr)).get());
+    if (!nextGroup || !nextGroup->canAbsorbUnwind()) {
+        return std::next(itr);
+    }
+
+    nextGroup->setUnwindSource(this);
+    auto groupItr = container->erase(itr);
+
+    // The stage before the $group may be able to optimize further, if there is such a stage.
+    return groupItr == container->begin() ? groupItr : std::prev(groupItr);
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceUnwind::getModifiedPaths() const {
     std::set<std::string> modifiedFields{_unwindPath.fullPath()};
     if (_indexPath) {
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/field_path.h"
 
@@ -90,6 +91,81 @@ public:
         return _indexPath;
     }
 
+    /**
+     * Unwinds the array at the unwind path of one document at a time. A $group which has absorbed
+     * this stage makes its own Unwinder for each thread it aggregates its input on.
+     */
+    class Unwinder {
+    public:
+        Unwinder(const FieldPath& unwindPath,
+                 bool preserveNullAndEmptyArrays,
+                 const boost::optional<FieldPath>& indexPath);
+
+        /** Reset the unwinder to unwind a new document. */
+        void resetDocument(const Document& document);
+
+        /**
+         * @return the next document unwound from the document provided to resetDocument(), using
+         * the current value in the array located at the provided unwindPath.
+         *
+         * Returns EOF if the array is exhausted.
+         */
+        DocumentSource::GetNextResult getNext();
+
+    private:
+        /**
+         * Prepares to unwind the array of 'document' straight from its backing BSON, so that the
+         * elements of the array are only converted as they are unwound. Returns false, doing
+         * nothing, if 'document' is not backed by BSON or the unwind path does not lead to a
+         * non-empty array in it.
+         */
+        bool resetFromBackingBson(const Document& document);
+
+        // Tracks whether or not we can possibly return any more documents. Note we may return
+        // boost::none even if this is true.
+        bool _haveNext = false;
+
+        // Path to the array to unwind.
+        const FieldPath _unwindPath;
+
+        // Documents that have a nullish value, or an empty array for the field '_unwindPath', will
+        // pass through the $unwind stage unmodified if '_preserveNullAndEmptyArrays' is true.
+        const bool _preserveNullAndEmptyArrays;
+
+        // If set, the $unwind stage will include the array index in the specified path,
+        // overwriting any existing value, setting to null when the value was a non-array or empty
+        // array.
+        const boost::optional<FieldPath> _indexPath;
+
+        Value _inputArray;
+
+        // When the array is read from the backing BSON of the input document, the remaining
+        // elements of the array, and the BSON which holds them.
+        BSONObj _backingBson;
+        boost::optional<BSONObjIterator> _bsonArrayIt;
+
+        MutableDocument _output;
+
+        // Document indexes of the field path components.
+        std::vector<Position> _unwindPathFieldIndexes;
+
+        // Index into the _inputArray to return next.
+        size_t _index;
+    };
+
+    /**
+     * Returns a new Unwinder with the options of this stage.
+     */
+    std::unique_ptr<Unwinder> createUnwinder() const;
+
+protected:
+    /**
+     * Hands this stage to an immediately following $group, which can then unwind its input itself
+     * rather than receive every unwound document from this stage.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceUnwind(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                          const FieldPath& fieldPath,
@@ -106,7 +182,6 @@ private:
     const boost::optional<FieldPath> _indexPath;
 
     // Iteration state.
-    class Unwinder;
     std::unique_ptr<Unwinder> _unwinder;
 };
 
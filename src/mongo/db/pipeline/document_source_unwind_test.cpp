@@ -179,7 +179,24 @@ private:
      * '_unwind' must be initialized before calling this method.
      */
     void assertResultsMatch(BSONObj expectedResults) {
-        auto source = DocumentSourceMock::create(inputData());
+        assertResultsMatch(inputData(), expectedResults);
+
+        // Once more with each input document backed by BSON, as when it is read from a
+        // collection, in which case the array is unwound without first converting it.
+        deque<DocumentSource::GetNextResult> bsonInputData;
+        for (auto&& input : inputData()) {
+            if (input.isAdvanced()) {
+                bsonInputData.push_back(
+                    Document::fromBsonWithMetaData(input.getDocument().toBson()));
+            } else {
+                bsonInputData.push_back(std::move(input));
+            }
+        }
+        assertResultsMatch(std::move(bsonInputData), expectedResults);
+    }
+
+    void assertResultsMatch(deque<DocumentSource::GetNextResult> input, BSONObj expectedResults) {
+        auto source = DocumentSourceMock::create(std::move(input));
         _unwind->setSource(source.get());
         // Load the results from the DocumentSourceUnwind.
         vector<Document> resultSet;
@@ -733,6 +750,29 @@ TEST_F(UnwindStageTest, UnwindIncludesIndexPathWhenIncludingIndex) {
     ASSERT_EQUALS(1U, modifiedPaths.paths.count("arrIndex"));
 }
 
+TEST_F(UnwindStageTest, ShouldKeepMetadataWhenUnwindingArrayOfBackingBson) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "a.b", false, std::string("index"));
+    const BSONObj bson = fromjson("{_id: 0, a: {b: [1, 2], c: 3}}");
+    MutableDocument input(Document::fromBsonWithMetaData(bson));
+    input.setTextScore(2.5);
+    auto source = DocumentSourceMock::create(input.freeze());
+    unwind->setSource(source.get());
+
+    auto next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, a: {b: 1, c: 3}, index: 0}")),
+                       next.getDocument());
+    ASSERT_EQUALS(2.5, next.getDocument().getTextScore());
+
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, a: {b: 2, c: 3}, index: 1}")),
+                       next.getDocument());
+    ASSERT_EQUALS(2.5, next.getDocument().getTextScore());
+
+    ASSERT_TRUE(unwind->getNext().isEOF());
+}
+
 //
 // Error cases.
 //
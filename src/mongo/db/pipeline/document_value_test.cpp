@@ -154,6 +154,40 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+TEST(DocumentConstruction, FromBsonWithoutMetaDataConvertsFieldsAsTheyAreNeeded) {
+    BSONObj obj = BSON("a" << 1 << "b" << BSON("c" << 2) << "d"
+                           << "q");
+    Document document = Document::fromBsonWithMetaData(obj);
+    ASSERT_VALUE_EQ(Value(BSON("c" << 2)), document["b"]);
+    ASSERT_TRUE(document["e"].missing());
+    ASSERT_EQUALS(3U, document.size());
+    ASSERT_DOCUMENT_EQ(Document(obj), document);
+
+    // The document has not been modified, so it serializes to the BSON it was created from.
+    ASSERT_EQUALS(static_cast<const void*>(obj.objdata()),
+                  static_cast<const void*>(document.toBson().objdata()));
+}
+
+TEST(DocumentConstruction, ModifyingLazilyConvertedDocumentSerializesModifiedFields) {
+    BSONObj obj = BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4 << "e" << 5);
+
+    // A shared document is copied before it is modified.
+    Document shared = Document::fromBsonWithMetaData(obj);
+    ASSERT_VALUE_EQ(Value(1), shared["a"]);
+    MutableDocument copied(shared);
+    copied["c"] = Value(30);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 2 << "c" << 30 << "d" << 4 << "e" << 5),
+                      copied.freeze().toBson());
+    ASSERT_BSONOBJ_EQ(obj, shared.toBson());
+
+    // An unshared document is modified in place.
+    MutableDocument inPlace(Document::fromBsonWithMetaData(obj));
+    inPlace["b"] = Value();
+    inPlace.addField("f", Value(6));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "c" << 3 << "d" << 4 << "e" << 5 << "f" << 6),
+                      inPlace.freeze().toBson());
+}
+
 /** Add Document fields. */
 class AddField {
 public:
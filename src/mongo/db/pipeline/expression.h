@@ -715,6 +715,12 @@ public:
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 
+    /**
+     * Returns the sum of the 'numOperands' values starting at 'operands', just as evaluate() does
+     * for operands which evaluate to those values.
+     */
+    static Value apply(const Value* operands, size_t numOperands);
+
     bool isAssociative() const final {
         return true;
     }
@@ -823,6 +829,10 @@ public:
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const boost::intrusive_ptr<Expression>& pExpression);
 
+    const boost::intrusive_ptr<Expression>& getExpression() const {
+        return pExpression;
+    }
+
 protected:
     void _doAddDependencies(DepsTracker* deps) const final;
 
@@ -860,6 +870,12 @@ public:
         return cmpOp;
     }
 
+    /**
+     * Compares 'lhs' with 'rhs' under this expression's operator, just as evaluate() does for
+     * operands which evaluate to them.
+     */
+    Value apply(const Value& lhs, const Value& rhs) const;
+
     static boost::intrusive_ptr<Expression> parse(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         BSONElement bsonExpr,
@@ -1106,6 +1122,11 @@ public:
 
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
+
+    /**
+     * Returns 'lhs' divided by 'rhs', just as evaluate() does for operands which evaluate to them.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
 };
 
 
@@ -1483,6 +1504,12 @@ public:
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
 
+    /**
+     * Returns the product of the 'numOperands' values starting at 'operands', just as evaluate()
+     * does for operands which evaluate to those values.
+     */
+    static Value apply(const Value* operands, size_t numOperands);
+
     bool isAssociative() const final {
         return true;
     }
@@ -1841,6 +1868,11 @@ public:
 
     Value evaluate(const Document& root) const final;
     const char* getOpName() const final;
+
+    /**
+     * Returns 'lhs' minus 'rhs', just as evaluate() does for operands which evaluate to them.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
 };
 
 
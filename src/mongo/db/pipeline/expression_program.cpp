@@ -0,0 +1,358 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_program.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+bool isIntOrLong(const Value& val) {
+    return val.getType() == NumberInt || val.getType() == NumberLong;
+}
+}  // namespace
+
+std::unique_ptr<ExpressionProgram> ExpressionProgram::compile(
+    boost::intrusive_ptr<Expression> expression) {
+    std::unique_ptr<ExpressionProgram> program(new ExpressionProgram(std::move(expression)));
+    program->compileInto(program->_expression.get(), program->allocateRegisters(1));
+    return program;
+}
+
+ExpressionProgram::ExpressionProgram(boost::intrusive_ptr<Expression> expression)
+    : _expression(std::move(expression)) {}
+
+size_t ExpressionProgram::getNumSubtreeInstructions() const {
+    return std::count_if(_instructions.begin(), _instructions.end(), [](const auto& instruction) {
+        return instruction.op == OpCode::kEvaluate;
+    });
+}
+
+uint32_t ExpressionProgram::allocateRegisters(size_t n) {
+    const uint32_t first = _registers.size();
+    _registers.resize(_registers.size() + n);
+    return first;
+}
+
+size_t ExpressionProgram::emit(
+    OpCode op, uint32_t dst, uint32_t arg0, uint32_t arg1, const Expression* expr) {
+    _instructions.push_back({op, dst, arg0, arg1, expr});
+    return _instructions.size() - 1;
+}
+
+void ExpressionProgram::compileInto(const Expression* expr, uint32_t dst) {
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+        _constants.push_back(constant->getValue());
+        emit(OpCode::kConstant, dst, _constants.size() - 1, 0, expr);
+    } else if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+        if (fieldPath->isRootFieldPath() && fieldPath->getFieldPath().getPathLength() > 1) {
+            _fieldPaths.push_back(fieldPath->getFieldPath());
+            emit(OpCode::kFieldPath, dst, _fieldPaths.size() - 1, 0, expr);
+        } else {
+            emit(OpCode::kEvaluate, dst, 0, 0, expr);
+        }
+    } else if (dynamic_cast<const ExpressionAdd*>(expr) ||
+               dynamic_cast<const ExpressionMultiply*>(expr)) {
+        const auto& operands = static_cast<const ExpressionNary*>(expr)->getOperandList();
+        const uint32_t first = allocateRegisters(operands.size());
+        for (size_t i = 0; i < operands.size(); ++i) {
+            compileInto(operands[i].get(), first + i);
+        }
+        emit(dynamic_cast<const ExpressionAdd*>(expr) ? OpCode::kAdd : OpCode::kMultiply,
+             dst,
+             first,
+             operands.size(),
+             expr);
+    } else if (dynamic_cast<const ExpressionSubtract*>(expr) ||
+               dynamic_cast<const ExpressionDivide*>(expr) ||
+               dynamic_cast<const ExpressionCompare*>(expr)) {
+        const auto& operands = static_cast<const ExpressionNary*>(expr)->getOperandList();
+        const uint32_t lhs = allocateRegisters(2);
+        const uint32_t rhs = lhs + 1;
+        compileInto(operands[0].get(), lhs);
+        compileInto(operands[1].get(), rhs);
+        const OpCode op = dynamic_cast<const ExpressionSubtract*>(expr)
+            ? OpCode::kSubtract
+            : dynamic_cast<const ExpressionDivide*>(expr) ? OpCode::kDivide : OpCode::kCompare;
+        emit(op, dst, lhs, rhs, expr);
+    } else if (auto andExpr = dynamic_cast<const ExpressionAnd*>(expr)) {
+        compileLogical(andExpr->getOperandList(), true, dst);
+    } else if (auto orExpr = dynamic_cast<const ExpressionOr*>(expr)) {
+        compileLogical(orExpr->getOperandList(), false, dst);
+    } else if (auto notExpr = dynamic_cast<const ExpressionNot*>(expr)) {
+        compileInto(notExpr->getOperandList()[0].get(), dst);
+        emit(OpCode::kNot, dst, 0, 0, expr);
+    } else if (auto coerceToBool = dynamic_cast<const ExpressionCoerceToBool*>(expr)) {
+        compileInto(coerceToBool->getExpression().get(), dst);
+        emit(OpCode::kCoerceToBool, dst, 0, 0, expr);
+    } else if (auto cond = dynamic_cast<const ExpressionCond*>(expr)) {
+        // 'dst' = if ? then : else, where only the chosen branch is evaluated.
+        const auto& operands = cond->getOperandList();
+        compileInto(operands[0].get(), dst);
+        const size_t jumpToElse = emit(OpCode::kJumpIfFalse, dst, 0, 0, expr);
+        compileInto(operands[1].get(), dst);
+        const size_t jumpToEnd = emit(OpCode::kJump, dst, 0, 0, expr);
+        _instructions[jumpToElse].arg0 = _instructions.size();
+        compileInto(operands[2].get(), dst);
+        _instructions[jumpToEnd].arg0 = _instructions.size();
+    } else {
+        emit(OpCode::kEvaluate, dst, 0, 0, expr);
+    }
+}
+
+void ExpressionProgram::compileLogical(
+    const std::vector<boost::intrusive_ptr<Expression>>& operands, bool isAnd, uint32_t dst) {
+    if (operands.empty()) {
+        _constants.push_back(Value(isAnd));
+        emit(OpCode::kConstant, dst, _constants.size() - 1, 0, nullptr);
+        return;
+    }
+
+    // Each operand is coerced to a bool in 'dst', and the first one which decides the result jumps
+    // past the rest with that bool still in 'dst'.
+    std::vector<size_t> jumpsToEnd;
+    for (size_t i = 0; i < operands.size(); ++i) {
+        compileInto(operands[i].get(), dst);
+        emit(OpCode::kCoerceToBool, dst, 0, 0, nullptr);
+        if (i + 1 < operands.size()) {
+            jumpsToEnd.push_back(
+                emit(isAnd ? OpCode::kJumpIfFalse : OpCode::kJumpIfTrue, dst, 0, 0, nullptr));
+        }
+    }
+    for (auto jump : jumpsToEnd) {
+        _instructions[jump].arg0 = _instructions.size();
+    }
+}
+
+Value ExpressionProgram::evaluate(const Document& root) const {
+    const size_t numInstructions = _instructions.size();
+    size_t pc = 0;
+    while (pc < numInstructions) {
+        const Instruction& instruction = _instructions[pc++];
+        Value& dst = _registers[instruction.dst];
+        switch (instruction.op) {
+            case OpCode::kConstant:
+                dst = _constants[instruction.arg0];
+                break;
+            case OpCode::kFieldPath:
+                dst = evaluateFieldPath(instruction, root);
+                break;
+            case OpCode::kEvaluate:
+                dst = instruction.expr->evaluate(root);
+                break;
+            case OpCode::kAdd:
+                dst = evaluateAdd(instruction);
+                break;
+            case OpCode::kMultiply:
+                dst = evaluateMultiply(instruction);
+                break;
+            case OpCode::kSubtract:
+                dst = evaluateSubtract(instruction);
+                break;
+            case OpCode::kDivide:
+                dst = evaluateDivide(instruction);
+                break;
+            case OpCode::kCompare:
+                dst = evaluateCompare(instruction);
+                break;
+            case OpCode::kCoerceToBool:
+                if (dst.getType() != Bool) {
+                    dst = Value(dst.coerceToBool());
+                }
+                break;
+            case OpCode::kNot:
+                dst = Value(!dst.coerceToBool());
+                break;
+            case OpCode::kJump:
+                pc = instruction.arg0;
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!dst.coerceToBool()) {
+                    pc = instruction.arg0;
+                }
+                break;
+            case OpCode::kJumpIfTrue:
+                if (dst.coerceToBool()) {
+                    pc = instruction.arg0;
+                }
+                break;
+        }
+    }
+
+    // Hand back the result, and drop the references the other registers hold into this document.
+    Value result = std::move(_registers[0]);
+    for (auto& reg : _registers) {
+        reg = Value();
+    }
+    return result;
+}
+
+Value ExpressionProgram::evaluateFieldPath(const Instruction& instruction,
+                                           const Document& root) const {
+    // The first component of the path names the variable, which is the root document.
+    const FieldPath& path = _fieldPaths[instruction.arg0];
+    const size_t pathLength = path.getPathLength();
+    Value val = root[path.getFieldName(1)];
+    for (size_t i = 2; i < pathLength; ++i) {
+        switch (val.getType()) {
+            case Object:
+                val = val.getDocument()[path.getFieldName(i)];
+                break;
+            case Array:
+                // Traversing arrays collects the matches of every element, which the expression
+                // knows how to do.
+                return instruction.expr->evaluate(root);
+            default:
+                return Value();
+        }
+    }
+    return val;
+}
+
+Value ExpressionProgram::evaluateAdd(const Instruction& instruction) const {
+    const Value* operands = &_registers[instruction.arg0];
+    const size_t numOperands = instruction.arg1;
+
+    if (numOperands == 2 && operands[0].getType() == NumberDouble &&
+        operands[1].getType() == NumberDouble) {
+        // A compensated sum of two doubles is their rounded sum, except for the signed zeros and
+        // special values the summation handles itself.
+        const double sum = operands[0].getDouble() + operands[1].getDouble();
+        if (std::isfinite(sum) && sum != 0.0) {
+            return Value(sum);
+        }
+        return ExpressionAdd::apply(operands, numOperands);
+    }
+
+    long long sum = 0;
+    bool haveLong = false;
+    for (size_t i = 0; i < numOperands; ++i) {
+        if (!isIntOrLong(operands[i]) ||
+            mongoSignedAddOverflow64(sum, operands[i].coerceToLong(), &sum)) {
+            return ExpressionAdd::apply(operands, numOperands);
+        }
+        haveLong = haveLong || operands[i].getType() == NumberLong;
+    }
+    return haveLong ? Value(sum) : Value::createIntOrLong(sum);
+}
+
+Value ExpressionProgram::evaluateMultiply(const Instruction& instruction) const {
+    const Value* operands = &_registers[instruction.arg0];
+    const size_t numOperands = instruction.arg1;
+
+    if (numOperands == 2 && operands[0].getType() == NumberDouble &&
+        operands[1].getType() == NumberDouble) {
+        return Value(operands[0].getDouble() * operands[1].getDouble());
+    }
+
+    long long product = 1;
+    bool haveLong = false;
+    for (size_t i = 0; i < numOperands; ++i) {
+        if (!isIntOrLong(operands[i]) ||
+            mongoSignedMultiplyOverflow64(product, operands[i].coerceToLong(), &product)) {
+            return ExpressionMultiply::apply(operands, numOperands);
+        }
+        haveLong = haveLong || operands[i].getType() == NumberLong;
+    }
+    return haveLong ? Value(product) : Value::createIntOrLong(product);
+}
+
+Value ExpressionProgram::evaluateSubtract(const Instruction& instruction) const {
+    const Value& lhs = _registers[instruction.arg0];
+    const Value& rhs = _registers[instruction.arg1];
+
+    if (lhs.getType() == NumberInt && rhs.getType() == NumberInt) {
+        return Value::createIntOrLong(static_cast<long long>(lhs.getInt()) - rhs.getInt());
+    }
+    if (lhs.getType() == NumberDouble && rhs.getType() == NumberDouble) {
+        return Value(lhs.getDouble() - rhs.getDouble());
+    }
+    return ExpressionSubtract::apply(lhs, rhs);
+}
+
+Value ExpressionProgram::evaluateDivide(const Instruction& instruction) const {
+    const Value& lhs = _registers[instruction.arg0];
+    const Value& rhs = _registers[instruction.arg1];
+
+    if (lhs.numeric() && rhs.numeric() && lhs.getType() != NumberDecimal &&
+        rhs.getType() != NumberDecimal) {
+        const double denom = rhs.coerceToDouble();
+        if (denom != 0.0) {
+            return Value(lhs.coerceToDouble() / denom);
+        }
+    }
+    return ExpressionDivide::apply(lhs, rhs);
+}
+
+Value ExpressionProgram::evaluateCompare(const Instruction& instruction) const {
+    const auto* compare = static_cast<const ExpressionCompare*>(instruction.expr);
+    const Value& lhs = _registers[instruction.arg0];
+    const Value& rhs = _registers[instruction.arg1];
+
+    int cmp;
+    if (isIntOrLong(lhs) && isIntOrLong(rhs)) {
+        const long long left = lhs.coerceToLong();
+        const long long right = rhs.coerceToLong();
+        cmp = left < right ? -1 : left > right ? 1 : 0;
+    } else if (lhs.getType() == NumberDouble && rhs.getType() == NumberDouble &&
+               !std::isnan(lhs.getDouble()) && !std::isnan(rhs.getDouble())) {
+        const double left = lhs.getDouble();
+        const double right = rhs.getDouble();
+        cmp = left < right ? -1 : left > right ? 1 : 0;
+    } else {
+        return compare->apply(lhs, rhs);
+    }
+
+    switch (compare->getOp()) {
+        case ExpressionCompare::EQ:
+            return Value(cmp == 0);
+        case ExpressionCompare::NE:
+            return Value(cmp != 0);
+        case ExpressionCompare::GT:
+            return Value(cmp > 0);
+        case ExpressionCompare::GTE:
+            return Value(cmp >= 0);
+        case ExpressionCompare::LT:
+            return Value(cmp < 0);
+        case ExpressionCompare::LTE:
+            return Value(cmp <= 0);
+        case ExpressionCompare::CMP:
+            return Value(cmp);
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * A flattened form of an optimized Expression tree, which evaluates the tree by running a loop over
+ * an array of instructions rather than by making virtual calls down the tree.
+ *
+ * Every instruction writes its result to a register, reading its operands from registers written by
+ * the instructions before it. Field paths on the root document are split into their components
+ * once, at compile time. $add, $subtract, $multiply, $divide and the comparison operators take
+ * typed fast paths when their operands are ints, longs or doubles, and hand any other operands to
+ * the same code the Expression tree uses, so that the result of evaluating a program is always
+ * that of evaluating its expression. Any other operator is compiled to a single instruction which
+ * evaluates its subtree through Expression::evaluate().
+ *
+ * Evaluation reuses the registers of the program, so a program must not be evaluated by more than
+ * one thread at a time.
+ */
+class ExpressionProgram {
+public:
+    /**
+     * Compiles 'expression', which the program keeps a reference to.
+     */
+    static std::unique_ptr<ExpressionProgram> compile(boost::intrusive_ptr<Expression> expression);
+
+    /**
+     * Returns the value of the compiled expression for the document 'root'.
+     */
+    Value evaluate(const Document& root) const;
+
+    size_t getNumInstructions() const {
+        return _instructions.size();
+    }
+
+    /**
+     * Returns the number of instructions which evaluate a subtree through Expression::evaluate().
+     */
+    size_t getNumSubtreeInstructions() const;
+
+private:
+    enum class OpCode : uint8_t {
+        kConstant,      // dst = constants[arg0]
+        kFieldPath,     // dst = value of fieldPaths[arg0] in the root document
+        kEvaluate,      // dst = expr->evaluate(root)
+        kAdd,           // dst = sum of the arg1 registers starting at arg0
+        kMultiply,      // dst = product of the arg1 registers starting at arg0
+        kSubtract,      // dst = arg0 - arg1
+        kDivide,        // dst = arg0 / arg1
+        kCompare,       // dst = arg0 <op> arg1, where <op> is that of the ExpressionCompare expr
+        kCoerceToBool,  // dst = coerceToBool(dst)
+        kNot,           // dst = !coerceToBool(dst)
+        kJump,          // jump to arg0
+        kJumpIfFalse,   // jump to arg0 if dst is false
+        kJumpIfTrue,    // jump to arg0 if dst is true
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t dst;
+        uint32_t arg0;
+        uint32_t arg1;
+
+        // The expression this instruction was compiled from, for instructions which need it.
+        const Expression* expr;
+    };
+
+    explicit ExpressionProgram(boost::intrusive_ptr<Expression> expression);
+
+    /**
+     * Appends the instructions which write the value of 'expr' to the register 'dst'.
+     */
+    void compileInto(const Expression* expr, uint32_t dst);
+
+    /**
+     * Appends the instructions for $and (if 'isAnd') or $or of 'operands' into register 'dst'.
+     */
+    void compileLogical(const std::vector<boost::intrusive_ptr<Expression>>& operands,
+                        bool isAnd,
+                        uint32_t dst);
+
+    /**
+     * Reserves 'n' consecutive registers and returns the first of them.
+     */
+    uint32_t allocateRegisters(size_t n);
+
+    size_t emit(OpCode op, uint32_t dst, uint32_t arg0, uint32_t arg1, const Expression* expr);
+
+    Value evaluateFieldPath(const Instruction& instruction, const Document& root) const;
+    Value evaluateAdd(const Instruction& instruction) const;
+    Value evaluateMultiply(const Instruction& instruction) const;
+    Value evaluateSubtract(const Instruction& instruction) const;
+    Value evaluateDivide(const Instruction& instruction) const;
+    Value evaluateCompare(const Instruction& instruction) const;
+
+    // Keeps every expression an instruction refers to alive.
+    const boost::intrusive_ptr<Expression> _expression;
+
+    std::vector<Instruction> _instructions;
+    std::vector<Value> _constants;
+    std::vector<FieldPath> _fieldPaths;
+
+    mutable std::vector<Value> _registers;
+};
+
+}  // namespace mongo
@@ -0,0 +1,218 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_program.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using ExpressionProgramTest = AggregationContextFixture;
+
+/**
+ * Parses and optimizes the expression given as the field 'expr' of 'spec'.
+ */
+boost::intrusive_ptr<Expression> parseAndOptimize(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& spec) {
+    auto expr = Expression::parseOperand(expCtx, spec["expr"], expCtx->variablesParseState);
+    return expr->optimize();
+}
+
+/**
+ * Returns the value of 'evaluate', or the error it throws as a Status.
+ */
+template <typename Evaluate>
+StatusWith<Value> evaluateToStatus(const Evaluate& evaluate) {
+    try {
+        return evaluate();
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+/**
+ * Asserts that the program compiled from the expression in 'spec' gives the same value, of the same
+ * type, or the same error as the expression itself for each of 'documents'.
+ */
+void assertProgramMatchesExpression(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    const BSONObj& spec,
+                                    const std::vector<Document>& documents) {
+    auto expr = parseAndOptimize(expCtx, spec);
+    auto program = ExpressionProgram::compile(expr);
+    for (auto&& doc : documents) {
+        auto expected = evaluateToStatus([&] { return expr->evaluate(doc); });
+        auto actual = evaluateToStatus([&] { return program->evaluate(doc); });
+        if (!expected.isOK()) {
+            ASSERT_EQ(expected.getStatus().code(), actual.getStatus().code())
+                << spec << " on " << doc.toString();
+            continue;
+        }
+        ASSERT_OK(actual.getStatus()) << spec << " on " << doc.toString();
+        ASSERT_VALUE_EQ(expected.getValue(), actual.getValue());
+        ASSERT_EQ(expected.getValue().getType(), actual.getValue().getType())
+            << spec << " on " << doc.toString();
+    }
+}
+
+/**
+ * Returns documents {a: <x>, b: <y>} for every pair of values in a mix of numeric and other types,
+ * omitting a field whose value is missing.
+ */
+std::vector<Document> makeOperandPairs() {
+    const std::vector<Value> values = {
+        Value(),
+        Value(BSONNULL),
+        Value(0),
+        Value(2),
+        Value(-3),
+        Value(std::numeric_limits<int>::max()),
+        Value(5LL),
+        Value(std::numeric_limits<long long>::max()),
+        Value(std::numeric_limits<long long>::lowest()),
+        Value(2.5),
+        Value(0.0),
+        Value(-0.0),
+        Value(1e308),
+        Value(std::numeric_limits<double>::quiet_NaN()),
+        Value(std::numeric_limits<double>::infinity()),
+        Value(Decimal128("1.5")),
+        Value(Date_t::fromMillisSinceEpoch(1000)),
+        Value("str"_sd),
+    };
+
+    std::vector<Document> documents;
+    for (auto&& a : values) {
+        for (auto&& b : values) {
+            MutableDocument doc;
+            if (!a.missing()) {
+                doc.addField("a", a);
+            }
+            if (!b.missing()) {
+                doc.addField("b", b);
+            }
+            documents.push_back(doc.freeze());
+        }
+    }
+    return documents;
+}
+
+TEST_F(ExpressionProgramTest, ArithmeticMatchesExpressionEvaluation) {
+    const auto documents = makeOperandPairs();
+    for (auto&& spec : {fromjson("{expr: {$add: ['$a', '$b']}}"),
+                        fromjson("{expr: {$add: ['$a', '$b', '$a']}}"),
+                        fromjson("{expr: {$subtract: ['$a', '$b']}}"),
+                        fromjson("{expr: {$multiply: ['$a', '$b']}}"),
+                        fromjson("{expr: {$multiply: ['$a', '$b', '$b']}}"),
+                        fromjson("{expr: {$divide: ['$a', '$b']}}")}) {
+        assertProgramMatchesExpression(getExpCtx(), spec, documents);
+    }
+}
+
+TEST_F(ExpressionProgramTest, ComparisonsMatchExpressionEvaluation) {
+    const auto documents = makeOperandPairs();
+    for (auto&& spec : {fromjson("{expr: {$eq: ['$a', '$b']}}"),
+                        fromjson("{expr: {$ne: ['$a', '$b']}}"),
+                        fromjson("{expr: {$gt: ['$a', '$b']}}"),
+                        fromjson("{expr: {$gte: ['$a', '$b']}}"),
+                        fromjson("{expr: {$lt: ['$a', '$b']}}"),
+                        fromjson("{expr: {$lte: ['$a', '$b']}}"),
+                        fromjson("{expr: {$cmp: ['$a', '$b']}}")}) {
+        assertProgramMatchesExpression(getExpCtx(), spec, documents);
+    }
+}
+
+TEST_F(ExpressionProgramTest, LogicalOperatorsMatchExpressionEvaluation) {
+    const auto documents = makeOperandPairs();
+    for (auto&& spec : {fromjson("{expr: {$and: ['$a', '$b']}}"),
+                        fromjson("{expr: {$and: [{$gt: ['$a', 0]}, {$lt: ['$b', 3]}, '$a']}}"),
+                        fromjson("{expr: {$or: ['$a', '$b']}}"),
+                        fromjson("{expr: {$or: [{$gt: ['$a', 0]}, {$lt: ['$b', 3]}, '$b']}}"),
+                        fromjson("{expr: {$not: ['$a']}}"),
+                        fromjson("{expr: {$and: [{$add: ['$a', '$b']}]}}"),
+                        fromjson("{expr: {$cond: [{$gte: ['$a', 2]}, '$a', '$b']}}")}) {
+        assertProgramMatchesExpression(getExpCtx(), spec, documents);
+    }
+}
+
+TEST_F(ExpressionProgramTest, FieldPathsMatchExpressionEvaluation) {
+    const std::vector<Document> documents = {
+        Document(fromjson("{}")),
+        Document(fromjson("{a: 1}")),
+        Document(fromjson("{a: {b: 1}}")),
+        Document(fromjson("{a: {b: {c: 1}}}")),
+        Document(fromjson("{a: {b: [{c: 1}, {c: 2}, {d: 3}, 4]}}")),
+        Document(fromjson("{a: [{b: {c: 1}}, {b: {c: 2}}]}")),
+        Document(fromjson("{a: {b: null}}")),
+    };
+    for (auto&& spec : {fromjson("{expr: '$a'}"),
+                        fromjson("{expr: '$a.b'}"),
+                        fromjson("{expr: '$a.b.c'}"),
+                        fromjson("{expr: '$$ROOT'}"),
+                        fromjson("{expr: '$$CURRENT.a.b'}"),
+                        fromjson("{expr: {$add: ['$a.b.c', 1]}}")}) {
+        assertProgramMatchesExpression(getExpCtx(), spec, documents);
+    }
+}
+
+TEST_F(ExpressionProgramTest, ShouldOnlyEvaluateTheOperandsWhichDecideTheResult) {
+    auto program = ExpressionProgram::compile(parseAndOptimize(
+        getExpCtx(), fromjson("{expr: {$or: [{$eq: ['$a', 1]}, {$divide: ['$a', 0]}]}}")));
+    ASSERT_VALUE_EQ(Value(true), program->evaluate(Document{{"a", 1}}));
+    ASSERT_THROWS_CODE(program->evaluate(Document{{"a", 2}}), AssertionException, 16608);
+
+    program = ExpressionProgram::compile(parseAndOptimize(
+        getExpCtx(), fromjson("{expr: {$cond: [{$eq: ['$a', 0]}, 0, {$divide: [1, '$a']}]}}")));
+    ASSERT_VALUE_EQ(Value(0), program->evaluate(Document{{"a", 0}}));
+    ASSERT_VALUE_EQ(Value(0.5), program->evaluate(Document{{"a", 2}}));
+}
+
+TEST_F(ExpressionProgramTest, ShouldCompileSupportedOperatorsToInstructions) {
+    auto program = ExpressionProgram::compile(parseAndOptimize(
+        getExpCtx(),
+        fromjson("{expr: {$and: [{$gt: [{$add: ['$a', '$b']}, 10]}, {$lt: ['$c.d', 5]}]}}")));
+    ASSERT_EQ(0U, program->getNumSubtreeInstructions());
+
+    // Operators without instructions of their own are evaluated as a subtree.
+    program = ExpressionProgram::compile(
+        parseAndOptimize(getExpCtx(), fromjson("{expr: {$eq: [{$concat: ['$a', '$b']}, 'ab']}}")));
+    ASSERT_EQ(1U, program->getNumSubtreeInstructions());
+    ASSERT_VALUE_EQ(Value(true), program->evaluate(Document{{"a", "a"_sd}, {"b", "b"_sd}}));
+}
+
+}  // namespace
+}  // namespace mongo
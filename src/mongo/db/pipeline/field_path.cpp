@@ -31,46 +31,124 @@
 
 #include "mongo/db/pipeline/field_path.h"
 
+#include <limits>
+
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bson_depth.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
 using std::string;
 using std::vector;
 
-string FieldPath::getFullyQualifiedPath(StringData prefix, StringData suffix) {
-    if (prefix.empty()) {
-        return suffix.toString();
-    }
+namespace {
 
-    return str::stream() << prefix << "." << suffix;
+// The table of interned paths is split into shards, selected by the high bits of the path hash,
+// so that threads parsing different paths rarely contend on the same mutex.
+constexpr int kInternShardBits = 4;
+constexpr size_t kInternShards = size_t(1) << kInternShardBits;
+
+// Interned paths are never freed and paths come from user input, so the table is bounded.
+constexpr size_t kMaxInternedPathsPerShard = 4096;
+constexpr size_t kMaxInternedPathLength = 1024;
+
+struct InternShard {
+    stdx::mutex mutex;
+    StringMap<std::unique_ptr<const FieldPath::Rep>> paths;
+};
+
+InternShard& internShard(size_t hash) {
+    // Leaked so that paths held by static objects stay valid during shutdown.
+    static InternShard* const shards = new InternShard[kInternShards];
+    return shards[hash >> (std::numeric_limits<size_t>::digits - kInternShardBits)];
 }
 
-FieldPath::FieldPath(std::string inputPath)
-    : _fieldPath(std::move(inputPath)), _fieldPathDotPosition{string::npos} {
-    uassert(40352, "FieldPath cannot be constructed with empty string", !_fieldPath.empty());
-    uassert(40353, "FieldPath must not end with a '.'.", _fieldPath[_fieldPath.size() - 1] != '.');
+/**
+ * Splits and validates 'path'. Throws a AssertionException if the path is invalid.
+ */
+std::unique_ptr<FieldPath::Rep> parsePath(StringData path, size_t hash) {
+    uassert(40352, "FieldPath cannot be constructed with empty string", !path.empty());
+    uassert(40353, "FieldPath must not end with a '.'.", path[path.size() - 1] != '.');
+
+    auto rep = std::make_unique<FieldPath::Rep>();
+    rep->path = path.toString();
+    rep->hash = hash;
+    rep->dotPositions.push_back(string::npos);
 
     // Store index delimiter position for use in field lookup.
     size_t dotPos;
     size_t startPos = 0;
-    while (string::npos != (dotPos = _fieldPath.find('.', startPos))) {
-        _fieldPathDotPosition.push_back(dotPos);
+    while (string::npos != (dotPos = path.find('.', startPos))) {
+        rep->dotPositions.push_back(dotPos);
         startPos = dotPos + 1;
     }
 
-    _fieldPathDotPosition.push_back(_fieldPath.size());
+    rep->dotPositions.push_back(path.size());
 
     // Validate the path length and the fields.
-    const auto pathLength = getPathLength();
+    const auto pathLength = rep->dotPositions.size() - 1;
     uassert(ErrorCodes::Overflow,
             "FieldPath is too long",
             pathLength <= BSONDepth::getMaxAllowableDepth());
     for (size_t i = 0; i < pathLength; ++i) {
-        uassertValidFieldName(getFieldName(i));
+        const auto begin = rep->dotPositions[i] + 1;
+        FieldPath::uassertValidFieldName(path.substr(begin, rep->dotPositions[i + 1] - begin));
+    }
+    return rep;
+}
+
+}  // namespace
+
+string FieldPath::getFullyQualifiedPath(StringData prefix, StringData suffix) {
+    if (prefix.empty()) {
+        return suffix.toString();
+    }
+
+    return str::stream() << prefix << "." << suffix;
+}
+
+FieldPath::FieldPath(StringData inputPath) {
+    const auto hash = StringMapHasher{}(inputPath);
+    auto& shard = internShard(hash);
+    {
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        auto it = shard.paths.find(StringMapHashedKey(inputPath, hash));
+        if (it != shard.paths.end()) {
+            _rep = it->second.get();
+            return;
+        }
+    }
+
+    // Parse outside of the lock, so that only valid paths are interned.
+    auto rep = parsePath(inputPath, hash);
+    if (inputPath.size() <= kMaxInternedPathLength) {
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        if (shard.paths.size() < kMaxInternedPathsPerShard) {
+            // Another thread may have interned the same path in the meantime.
+            auto& interned = shard.paths[inputPath.toString()];
+            if (!interned) {
+                interned = std::move(rep);
+            }
+            _rep = interned.get();
+            return;
+        }
+    }
+
+    _owned = std::move(rep);
+    _rep = _owned.get();
+}
+
+size_t FieldPath::getInternedPathCount_forTest() {
+    size_t count = 0;
+    for (size_t i = 0; i < kInternShards; ++i) {
+        auto& shard = internShard(i << (std::numeric_limits<size_t>::digits - kInternShardBits));
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        count += shard.paths.size();
     }
+    return count;
 }
 
 void FieldPath::uassertValidFieldName(StringData fieldName) {
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,12 @@ namespace mongo {
 
 /**
  * Utility class which represents a field path with nested paths separated by dots.
+ *
+ * Parsed paths are interned in a process-wide table: constructing a FieldPath from a path that was
+ * parsed before skips splitting and validation and shares the immutable parsed representation,
+ * so copying a FieldPath copies a pointer and comparing two interned paths for equality compares
+ * pointers. Once the table is full, new paths are parsed into a representation owned by the
+ * FieldPath and its copies.
  */
 class FieldPath {
 public:
@@ -66,15 +73,20 @@ public:
      *
      * Field names are validated using uassertValidFieldName().
      */
-    /* implicit */ FieldPath(std::string inputPath);
-    /* implicit */ FieldPath(StringData inputPath) : FieldPath(inputPath.toString()) {}
-    /* implicit */ FieldPath(const char* inputPath) : FieldPath(std::string(inputPath)) {}
+    /* implicit */ FieldPath(StringData inputPath);
+    /* implicit */ FieldPath(const std::string& inputPath) : FieldPath(StringData(inputPath)) {}
+    /* implicit */ FieldPath(const char* inputPath) : FieldPath(StringData(inputPath)) {}
+
+    /**
+     * Returns the number of interned paths, for testing.
+     */
+    static size_t getInternedPathCount_forTest();
 
     /**
      * Returns the number of path elements in the field path.
      */
     size_t getPathLength() const {
-        return _fieldPathDotPosition.size() - 1;
+        return _rep->dotPositions.size() - 1;
     }
 
     /**
@@ -82,23 +94,38 @@ public:
      */
     StringData getFieldName(size_t i) const {
         dassert(i < getPathLength());
-        const auto begin = _fieldPathDotPosition[i] + 1;
-        const auto end = _fieldPathDotPosition[i + 1];
-        return StringData(&_fieldPath[begin], end - begin);
+        const auto begin = _rep->dotPositions[i] + 1;
+        const auto end = _rep->dotPositions[i + 1];
+        return StringData(&_rep->path[begin], end - begin);
     }
 
     /**
      * Returns the full path, not including the prefix 'FieldPath::prefix'.
      */
     const std::string& fullPath() const {
-        return _fieldPath;
+        return _rep->path;
+    }
+
+    /**
+     * Returns a hash of the full path, computed once when the path was parsed.
+     */
+    size_t hash() const {
+        return _rep->hash;
+    }
+
+    /**
+     * Returns true if this path is interned. Two interned paths are equal exactly when they share
+     * the same representation.
+     */
+    bool isInterned() const {
+        return !_owned;
     }
 
     /**
      * Returns the full path, including the prefix 'FieldPath::prefix'.
      */
     std::string fullPathWithPrefix() const {
-        return prefix + _fieldPath;
+        return prefix + _rep->path;
     }
     /**
      * A FieldPath like this but missing the first element (useful for recursion).
@@ -106,19 +133,33 @@ public:
      */
     FieldPath tail() const {
         massert(16409, "FieldPath::tail() called on single element path", getPathLength() > 1);
-        return {_fieldPath.substr(_fieldPathDotPosition[1] + 1)};
+        return {StringData(_rep->path).substr(_rep->dotPositions[1] + 1)};
     }
 
+    /**
+     * The immutable parsed form of a path, shared by all FieldPaths for that path.
+     */
+    struct Rep {
+        // Contains the full field path, with each field delimited by a '.' character.
+        std::string path;
+
+        // Contains the position of field delimiter dots in 'path'. The first element contains
+        // string::npos (which evaluates to -1) and the last contains path.size() to facilitate
+        // lookup.
+        std::vector<size_t> dotPositions;
+
+        size_t hash;
+    };
+
 private:
     static const char prefix = '$';
 
-    // Contains the full field path, with each field delimited by a '.' character.
-    std::string _fieldPath;
+    // Points either to an interned Rep, which lives for the rest of the process, or to '_owned'.
+    const Rep* _rep;
 
-    // Contains the position of field delimiter dots in '_fieldPath'. The first element contains
-    // string::npos (which evaluates to -1) and the last contains _fieldPath.size() to facilitate
-    // lookup.
-    std::vector<size_t> _fieldPathDotPosition;
+    // Owns '_rep' when the path could not be interned. Null for interned paths, so copying an
+    // interned path does not touch a reference count.
+    std::shared_ptr<const Rep> _owned;
 };
 
 inline bool operator<(const FieldPath& lhs, const FieldPath& rhs) {
@@ -126,6 +167,9 @@ inline bool operator<(const FieldPath& lhs, const FieldPath& rhs) {
 }
 
 inline bool operator==(const FieldPath& lhs, const FieldPath& rhs) {
-    return lhs.fullPath() == rhs.fullPath();
+    if (lhs.isInterned() && rhs.isInterned()) {
+        return &lhs.fullPath() == &rhs.fullPath();
+    }
+    return lhs.hash() == rhs.hash() && lhs.fullPath() == rhs.fullPath();
 }
 }
@@ -135,6 +135,42 @@ TEST(FieldPathTest, TailThreeFields) {
     ASSERT_EQUALS("bar.baz", path.fullPath());
 }
 
+/** Parsing the same path twice shares one interned representation. */
+TEST(FieldPathTest, SamePathIsInterned) {
+    FieldPath path("internFoo.bar");
+    FieldPath samePath(std::string("internFoo.bar"));
+    ASSERT_TRUE(path.isInterned());
+    ASSERT_EQUALS(&path.fullPath(), &samePath.fullPath());
+    ASSERT_EQUALS(path.hash(), samePath.hash());
+    ASSERT_TRUE(path == samePath);
+    ASSERT_FALSE(path == FieldPath("internFoo.baz"));
+
+    FieldPath copy = path;
+    ASSERT_EQUALS(&path.fullPath(), &copy.fullPath());
+    ASSERT_EQUALS(2U, copy.getPathLength());
+    ASSERT_EQUALS("bar", copy.getFieldName(1));
+}
+
+/** Invalid paths are not interned and fail validation every time they are parsed. */
+TEST(FieldPathTest, InvalidPathIsNotInterned) {
+    const auto internedPaths = FieldPath::getInternedPathCount_forTest();
+    ASSERT_THROWS(FieldPath("internFoo..bar"), AssertionException);
+    ASSERT_THROWS(FieldPath("internFoo..bar"), AssertionException);
+    ASSERT_EQUALS(internedPaths, FieldPath::getInternedPathCount_forTest());
+}
+
+/** Very long paths are owned by the FieldPath rather than interned. */
+TEST(FieldPathTest, LongPathIsNotInterned) {
+    const std::string longPath(2048, 'a');
+    FieldPath path(longPath);
+    FieldPath samePath(longPath);
+    ASSERT_FALSE(path.isInterned());
+    ASSERT_NOT_EQUALS(&path.fullPath(), &samePath.fullPath());
+    ASSERT_TRUE(path == samePath);
+    ASSERT_TRUE(path == FieldPath(path));
+    ASSERT_EQUALS(longPath, path.fullPath());
+}
+
 /**
  * Creates a FieldPath that represents a document nested 'depth' levels deep.
  */
@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+
+#include "mongo/db/pipeline/document_path_support.h"
+#include "mongo/util/stringutils.h"
+
+namespace mongo {
+
+LookupHashTable::LookupHashTable(FieldPath foreignField,
+                                 const ValueComparator& comparator,
+                                 size_t maxMemoryUsageBytes)
+    : _foreignField(std::move(foreignField)),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _positionsByValue(comparator.makeFlatUnorderedValueMap<std::vector<size_t>>()) {}
+
+bool LookupHashTable::canProbe(const Value& value) {
+    switch (value.getType()) {
+        case BSONType::EOO:
+        case BSONType::jstNULL:
+        case BSONType::Undefined:
+        case BSONType::RegEx:
+        case BSONType::Array:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool LookupHashTable::canIndexPath(const FieldPath& foreignField) {
+    for (size_t i = 0; i < foreignField.getPathLength(); ++i) {
+        if (parseUnsignedBase10Integer(foreignField.getFieldName(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LookupHashTable::insert(Document doc) {
+    const size_t position = _documents.size();
+    size_t memoryUsageBytes = _memoryUsageBytes + doc.getApproximateSize();
+    document_path_support::visitAllValuesAtPath(doc, _foreignField, [&](const Value& value) {
+        auto& positions = _positionsByValue[value];
+        if (positions.empty()) {
+            memoryUsageBytes += value.getApproximateSize();
+        }
+        // A document may have the same value more than once along the path.
+        if (positions.empty() || positions.back() != position) {
+            positions.push_back(position);
+            memoryUsageBytes += sizeof(size_t);
+        }
+    });
+
+    _memoryUsageBytes = memoryUsageBytes;
+    if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        return false;
+    }
+
+    _documents.push_back(std::move(doc));
+    return true;
+}
+
+std::vector<Document> LookupHashTable::probe(const std::vector<Value>& values) const {
+    std::vector<size_t> positions;
+    for (auto&& value : values) {
+        invariant(canProbe(value));
+        auto it = _positionsByValue.find(value);
+        if (it != _positionsByValue.end()) {
+            positions.insert(positions.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // A document may be found under more than one of 'values'.
+    if (values.size() > 1) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    std::vector<Document> matches;
+    matches.reserve(positions.size());
+    for (auto position : positions) {
+        matches.push_back(_documents[position]);
+    }
+    return matches;
+}
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * An in-memory hash table over the documents of a $lookup's foreign collection, keyed on each value
+ * found at the foreign field path. It lets a $lookup specified with localField/foreignField syntax
+ * find the matches for an input document without querying the foreign collection again.
+ *
+ * Values at the foreign field path are found the way the equality queries issued by $lookup find
+ * them: arrays along the path and at its end are traversed, but arrays nested directly within
+ * arrays are not. Keys are compared with the ValueComparator the table is built with, so that
+ * matching honors the collation. Probes are limited to the values for which hashing gives the same
+ * matches as an equality query, see canProbe().
+ */
+class LookupHashTable {
+    MONGO_DISALLOW_COPYING(LookupHashTable);
+
+public:
+    /**
+     * The 'comparator' must outlive the table.
+     */
+    LookupHashTable(FieldPath foreignField,
+                    const ValueComparator& comparator,
+                    size_t maxMemoryUsageBytes);
+
+    /**
+     * Returns true if the matches for 'value' can be found by probing the table. Null, undefined
+     * and missing values also match documents where the foreign field is missing, regular
+     * expressions are matched against strings when several values are looked up at once, and
+     * arrays also match other arrays as a whole, so none of them can be probed.
+     */
+    static bool canProbe(const Value& value);
+
+    /**
+     * Returns true if every value at 'foreignField' in a document is found by the table. This is
+     * not the case if the path has a numeric component, which an equality query also treats as a
+     * position in an array.
+     */
+    static bool canIndexPath(const FieldPath& foreignField);
+
+    /**
+     * Adds 'doc' under each value at the foreign field path. Returns false if this would take the
+     * table over its memory limit, in which case the table must no longer be used.
+     */
+    bool insert(Document doc);
+
+    /**
+     * Returns the documents having any of 'values' at the foreign field path, each once and in the
+     * order they were inserted. Every one of 'values' must satisfy canProbe().
+     */
+    std::vector<Document> probe(const std::vector<Value>& values) const;
+
+    size_t count() const {
+        return _documents.size();
+    }
+
+    size_t getMemoryUsageBytes() const {
+        return _memoryUsageBytes;
+    }
+
+private:
+    const FieldPath _foreignField;
+    const size_t _maxMemoryUsageBytes;
+    size_t _memoryUsageBytes = 0;
+
+    // The documents in the table, in the order in which they were inserted.
+    std::vector<Document> _documents;
+
+    // For each value at the foreign field path, the positions in '_documents' of the documents
+    // having that value, in increasing order and without duplicates.
+    ValueFlatUnorderedMap<std::vector<size_t>> _positionsByValue;
+};
+
+}  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ValueComparator kSimpleComparator{nullptr};
+const size_t kMaxMemoryUsageBytes = 1024 * 1024;
+
+std::vector<Value> getIds(const std::vector<Document>& docs) {
+    std::vector<Value> ids;
+    for (auto&& doc : docs) {
+        ids.push_back(doc["_id"]);
+    }
+    return ids;
+}
+
+TEST(LookupHashTableTest, ProbeFindsDocumentsByEachValueAtPath) {
+    LookupHashTable table(FieldPath("a.b"), kSimpleComparator, kMaxMemoryUsageBytes);
+    ASSERT_TRUE(table.insert(Document{{"_id", 0}, {"a", Document{{"b", 1}}}}));
+    ASSERT_TRUE(
+        table.insert(Document{{"_id", 1}, {"a", DOC_ARRAY(DOC("b" << 2) << DOC("b" << 1))}}));
+    ASSERT_TRUE(table.insert(Document{{"_id", 2}, {"a", Document{{"b", DOC_ARRAY(3 << 2)}}}}));
+    ASSERT_TRUE(table.insert(Document{{"_id", 3}, {"a", 1}}));
+    ASSERT_EQ(table.count(), 4U);
+
+    ASSERT_VALUE_EQ(Value(getIds(table.probe({Value(1)}))), Value(DOC_ARRAY(0 << 1)));
+    ASSERT_VALUE_EQ(Value(getIds(table.probe({Value(2)}))), Value(DOC_ARRAY(1 << 2)));
+    ASSERT_VALUE_EQ(Value(getIds(table.probe({Value(4)}))), Value(std::vector<Value>{}));
+}
+
+TEST(LookupHashTableTest, ProbeDoesNotTraverseArraysNestedInArrays) {
+    LookupHashTable table(FieldPath("a"), kSimpleComparator, kMaxMemoryUsageBytes);
+    ASSERT_TRUE(table.insert(Document{{"_id", 0}, {"a", DOC_ARRAY(DOC_ARRAY(1))}}));
+
+    ASSERT_TRUE(table.probe({Value(1)}).empty());
+}
+
+TEST(LookupHashTableTest, ProbeMatchesEqualNumbersOfDifferentTypes) {
+    LookupHashTable table(FieldPath("a"), kSimpleComparator, kMaxMemoryUsageBytes);
+    ASSERT_TRUE(table.insert(Document{{"_id", 0}, {"a", 1LL}}));
+
+    ASSERT_VALUE_EQ(Value(getIds(table.probe({Value(1.0)}))), Value(DOC_ARRAY(0)));
+}
+
+TEST(LookupHashTableTest, ProbeReturnsEachDocumentOnceInInsertionOrder) {
+    LookupHashTable table(FieldPath("a"), kSimpleComparator, kMaxMemoryUsageBytes);
+    ASSERT_TRUE(table.insert(Document{{"_id", 0}, {"a", DOC_ARRAY(2 << 1 << 1)}}));
+    ASSERT_TRUE(table.insert(Document{{"_id", 1}, {"a", 1}}));
+
+    ASSERT_VALUE_EQ(Value(getIds(table.probe({Value(1), Value(2)}))), Value(DOC_ARRAY(0 << 1)));
+    ASSERT_VALUE_EQ(Value(getIds(table.probe({Value(2), Value(1)}))), Value(DOC_ARRAY(0 << 1)));
+}
+
+TEST(LookupHashTableTest, ProbeRespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    ValueComparator comparator(&collator);
+    LookupHashTable table(FieldPath("a"), comparator, kMaxMemoryUsageBytes);
+    ASSERT_TRUE(table.insert(Document{{"_id", 0}, {"a", "foo"_sd}}));
+    ASSERT_TRUE(table.insert(Document{{"_id", 1}, {"a", "FOO"_sd}}));
+
+    ASSERT_VALUE_EQ(Value(getIds(table.probe({Value("Foo"_sd)}))), Value(DOC_ARRAY(0 << 1)));
+}
+
+TEST(LookupHashTableTest, InsertFailsWhenMemoryLimitIsExceeded) {
+    const Document doc{{"_id", 0}, {"a", 1}};
+    LookupHashTable table(FieldPath("a"), kSimpleComparator, doc.getApproximateSize() * 3);
+    ASSERT_TRUE(table.insert(doc));
+    ASSERT_TRUE(table.insert(doc));
+    ASSERT_FALSE(table.insert(doc));
+    ASSERT_GT(table.getMemoryUsageBytes(), doc.getApproximateSize() * 3);
+}
+
+TEST(LookupHashTableTest, OnlyValuesMatchedByEqualityAloneCanBeProbed) {
+    ASSERT_TRUE(LookupHashTable::canProbe(Value(1)));
+    ASSERT_TRUE(LookupHashTable::canProbe(Value("a"_sd)));
+    ASSERT_TRUE(LookupHashTable::canProbe(Value(Document{{"a", 1}})));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value()));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value(BSONNULL)));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value(BSONUndefined)));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value(BSONRegEx("^a"))));
+    ASSERT_FALSE(LookupHashTable::canProbe(Value(DOC_ARRAY(1))));
+}
+
+TEST(LookupHashTableTest, PathsWithNumericComponentsCannotBeIndexed) {
+    ASSERT_TRUE(LookupHashTable::canIndexPath(FieldPath("a.b")));
+    ASSERT_FALSE(LookupHashTable::canIndexPath(FieldPath("a.0")));
+    ASSERT_FALSE(LookupHashTable::canIndexPath(FieldPath("a.1.b")));
+}
+
+}  // namespace
+}  // namespace mongo
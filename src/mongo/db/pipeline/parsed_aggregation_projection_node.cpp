@@ -31,6 +31,8 @@
 
 #include "mongo/db/pipeline/parsed_aggregation_projection_node.h"
 
+#include "mongo/db/query/query_knobs_gen.h"
+
 namespace mongo {
 namespace parsed_aggregation_projection {
 
@@ -58,6 +60,7 @@ void ProjectionNode::addExpressionForPath(const FieldPath& path,
     if (path.getPathLength() == 1) {
         auto fieldName = path.fullPath();
         _expressions[fieldName] = expr;
+        _programs.erase(fieldName);
         _orderToProcessAdditionsAndChildren.push_back(fieldName);
         return;
     }
@@ -157,6 +160,11 @@ void ProjectionNode::applyExpressions(const Document& root, MutableDocument* out
             outputDoc->setField(
                 field, childIt->second->applyExpressionsToValue(root, outputDoc->peek()[field]));
         } else {
+            auto programIt = _programs.find(field);
+            if (programIt != _programs.end()) {
+                outputDoc->setField(field, programIt->second->evaluate(root));
+                continue;
+            }
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
             outputDoc->setField(field, expressionIt->second->evaluate(root));
@@ -225,8 +233,14 @@ void ProjectionNode::reportComputedPaths(std::set<std::string>* computedPaths,
 }
 
 void ProjectionNode::optimize() {
+    _programs.clear();
+    const bool compileExpressions = internalQueryEnableExpressionBytecode.load();
     for (auto&& expressionIt : _expressions) {
         _expressions[expressionIt.first] = expressionIt.second->optimize();
+        if (compileExpressions) {
+            _programs[expressionIt.first] =
+                ExpressionProgram::compile(_expressions[expressionIt.first]);
+        }
     }
     for (auto&& childPair : _children) {
         childPair.second->optimize();
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/db/pipeline/expression_program.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
 
 namespace mongo {
@@ -148,6 +149,10 @@ protected:
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
     stdx::unordered_set<std::string> _projectedFields;
 
+    // The entries of '_expressions' compiled when the projection is optimized, unless expression
+    // bytecode is disabled.
+    StringMap<std::unique_ptr<ExpressionProgram>> _programs;
+
     ProjectionPolicies _policies;
 
     std::string _pathToNode;
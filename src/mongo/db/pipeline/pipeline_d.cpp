@@ -55,6 +55,7 @@
 #include "mongo/db/ops/write_ops_gen.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_change_stream_fanout.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
@@ -68,6 +69,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -107,8 +109,8 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
     // function because double-locking forces any PlanExecutor we create to adopt a NO_YIELD policy.
     invariant(opCtx->lockState()->isCollectionLockedForMode(coll->ns(), MODE_IS));
 
-    static const double kMaxSampleRatioForRandCursor = 0.05;
-    if (sampleSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100) {
+    const double maxSampleRatioForRandCursor = internalQueryMaxSampleRatioForRandomCursor.load();
+    if (sampleSize > numRecords * maxSampleRatioForRandCursor || numRecords <= 100) {
         return {nullptr};
     }
 
@@ -139,11 +141,12 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
         // The ratio of owned to orphaned documents must be at least equal to the ratio between the
         // requested sampleSize and the maximum permitted sampleSize for the original constraints to
         // be satisfied. For instance, if there are 200 documents and the sampleSize is 5, then at
-        // least (5 / (200*0.05)) = (5/10) = 50% of those documents must be owned. If less than 5%
-        // of the documents in the collection are owned, we default to the backup plan.
+        // least (5 / (200*0.05)) = (5/10) = 50% of those documents must be owned with the default
+        // ratio of 0.05. If less than that ratio of the documents in the collection are owned, we
+        // default to the backup plan.
         static const size_t kMaxPresampleSize = 100;
         const auto minWorkAdvancedRatio = std::max(
-            sampleSize / (numRecords * kMaxSampleRatioForRandCursor), kMaxSampleRatioForRandCursor);
+            sampleSize / (numRecords * maxSampleRatioForRandCursor), maxSampleRatioForRandCursor);
         // The trial plan is SHARDING_FILTER-MULTI_ITERATOR.
         auto randomCursorPlan =
             std::make_unique<ShardFilterStage>(opCtx, *shardMetadata, ws.get(), root.release());
@@ -715,12 +718,60 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
                     << swExecutorSort.getStatus().toString()};
         }
         // The query system can't provide a non-blocking sort.
+        const BSONObj fullSortObj = *sortObj;
         *sortObj = BSONObj();
+
+        // It may still be able to return its results ordered by a prefix of the sort pattern, in
+        // which case the $sort only has to sort each run of results sharing that prefix. Only
+        // leading parts which are field paths can be provided, and a prefix must be shorter than
+        // the pattern.
+        std::vector<BSONElement> sortParts;
+        for (auto&& part : fullSortObj) {
+            if (part.type() == BSONType::Object) {
+                break;
+            }
+            sortParts.push_back(part);
+        }
+        size_t prefixLength = std::min(sortParts.size(), size_t(fullSortObj.nFields() - 1));
+        if (!internalQueryAllowSortOnIndexedPrefix.load()) {
+            prefixLength = 0;
+        }
+
+        for (; prefixLength > 0; --prefixLength) {
+            BSONObjBuilder prefixBuilder;
+            for (size_t i = 0; i < prefixLength; ++i) {
+                prefixBuilder.append(sortParts[i]);
+            }
+            BSONObj prefixSortObj = prefixBuilder.obj();
+
+            auto swExecutorPrefixSort = attemptToGetExecutor(opCtx,
+                                                             collection,
+                                                             nss,
+                                                             expCtx,
+                                                             oplogReplay,
+                                                             queryObj,
+                                                             emptyProjection,
+                                                             prefixSortObj,
+                                                             boost::none, /* groupIdForDistinct */
+                                                             aggRequest,
+                                                             plannerOpts,
+                                                             matcherFeatures);
+            if (swExecutorPrefixSort.isOK()) {
+                sortStage->setSortedPrefixLength(prefixLength);
+                *sortObj = prefixSortObj;
+                break;
+            } else if (swExecutorPrefixSort == ErrorCodes::QueryPlanKilled) {
+                return {ErrorCodes::OperationFailed,
+                        str::stream() << "Failed to determine whether query system can provide a "
+                                         "non-blocking sort on a prefix of the sort pattern: "
+                                      << swExecutorPrefixSort.getStatus().toString()};
+            }
+        }
     }
 
-    // Either there was no $sort stage, or the query system could not provide a non-blocking
-    // sort.
-    dassert(sortObj->isEmpty());
+    // Either there was no $sort stage, or the query system could provide at most a prefix of it,
+    // which the $sort stage will build on.
+    dassert(sortObj->isEmpty() || (sortStage && sortStage->getSortedPrefixLength() > 0));
     *projectionObj = removeSortKeyMetaProjection(*projectionObj);
     const auto metadataRequired = deps.getAllRequiredMetadataTypes();
     if (metadataRequired.size() == 1 &&
@@ -807,6 +858,10 @@ Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getLatestOplogTimestamp();
     }
+    if (auto fanoutConsumer = dynamic_cast<DocumentSourceChangeStreamFanoutConsumer*>(
+            pipeline->_sources.front().get())) {
+        return fanoutConsumer->getLatestOplogTimestamp();
+    }
     return Timestamp();
 }
 
@@ -48,6 +48,7 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/document_source_project.h"
+#include "mongo/db/pipeline/document_source_sequential_document_cache.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_source_test_optimizations.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
@@ -2815,6 +2816,24 @@ TEST_F(PipelineDependenciesTest, ShouldNotAddAnyRequiredFieldsAfterFirstStageWit
     ASSERT_EQ(depsTracker.fields.count("b"), 1UL);
 }
 
+TEST_F(PipelineDependenciesTest, ShouldSeePastStagesWhichPassDocumentsThrough) {
+    auto ctx = getExpCtx();
+    SequentialDocumentCache cache(1024);
+    auto pipeline = unittest::assertGet(
+        Pipeline::create({DocumentSourceNeedsASeeNext::create(),
+                          DocumentSourceSequentialDocumentCache::create(ctx, &cache),
+                          DocumentSourceInternalSplitPipeline::create(
+                              ctx, StageConstraints::HostTypeRequirement::kNone),
+                          DocumentSourceNeedsOnlyB::create()},
+                         ctx));
+
+    auto depsTracker = pipeline->getDependencies(DepsTracker::MetadataAvailable::kNoMetadata);
+    ASSERT_FALSE(depsTracker.needWholeDocument);
+    ASSERT_EQ(depsTracker.fields.size(), 2UL);
+    ASSERT_EQ(depsTracker.fields.count("a"), 1UL);
+    ASSERT_EQ(depsTracker.fields.count("b"), 1UL);
+}
+
 TEST_F(PipelineDependenciesTest, ShouldNotRequireTextScoreIfThereIsNoScoreAvailable) {
     auto ctx = getExpCtx();
     auto pipeline = unittest::assertGet(Pipeline::create({}, ctx));
@@ -266,6 +266,10 @@ DispatchShardPipelineResults dispatchShardPipeline(
 
         exchangeSpec = cluster_aggregation_planner::checkIfEligibleForExchange(
             opCtx, splitPipeline->mergePipeline.get());
+        if (!exchangeSpec && !mustRunOnAll) {
+            exchangeSpec = cluster_aggregation_planner::checkIfEligibleForGroupExchange(
+                splitPipeline->mergePipeline.get(), shardIds);
+        }
     }
 
     // Generate the command object for the targeted shards.
@@ -73,7 +73,7 @@ public:
                 const WriteConcernOptions& wc,
                 bool upsert,
                 bool multi,
-                boost::optional<OID>) final {
+                boost::optional<OID>) override {
         MONGO_UNREACHABLE;
     }
 
@@ -50,6 +50,16 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
+    if (_loadedByOwner) {
+        // Only this consumer's own position may be looked at, since the others may be running.
+        auto& consumer = _consumers[consumerId];
+        if (consumer.nLeftToReturn == 0) {
+            return _buffer.empty() ? DocumentSource::GetNextResult::makeEOF()
+                                   : DocumentSource::GetNextResult::makePauseExecution();
+        }
+        return _buffer[_buffer.size() - consumer.nLeftToReturn--];
+    }
+
     size_t nConsumersStillProcessingThisBatch =
         std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
             return info.nLeftToReturn > 0;
@@ -76,6 +86,23 @@ DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
     return _buffer[bufferIndex];
 }
 
+bool TeeBuffer::loadNextBatchForConsumers() {
+    invariant(_loadedByOwner);
+    if (!anyConsumerInUse()) {
+        disposeSource();
+        return false;
+    }
+
+    loadNextBatch();
+
+    // The consumers read the documents of the batch concurrently, so none may be left to convert
+    // itself from BSON as it is read.
+    for (auto&& input : _buffer) {
+        input.getDocument().loadLazyFields();
+    }
+    return !_buffer.empty();
+}
+
 void TeeBuffer::loadNextBatch() {
     _buffer.clear();
     size_t bytesInBuffer = 0;
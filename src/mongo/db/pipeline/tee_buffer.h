@@ -66,13 +66,8 @@ public:
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
-        if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-                return info.stillInUse;
-            })) {
-            _buffer.clear();
-            if (_source) {
-                _source->dispose();
-            }
+        if (!_loadedByOwner && !anyConsumerInUse()) {
+            disposeSource();
         }
     }
 
@@ -83,6 +78,22 @@ public:
      */
     DocumentSource::GetNextResult getNext(size_t consumerId);
 
+    /**
+     * Lets each consumer run on its own thread. A consumer then never loads the next batch
+     * itself: once it has consumed the whole buffer it pauses until the owner of the buffer calls
+     * loadNextBatchForConsumers(), and returns EOF once that finds no more input. No consumer may
+     * be running while a batch is loaded.
+     */
+    void setLoadedByOwner() {
+        _loadedByOwner = true;
+    }
+
+    /**
+     * Loads the next batch for consumers run by setLoadedByOwner(), or disposes of the source if no
+     * consumer is still in use. Returns false if there was no more input to load.
+     */
+    bool loadNextBatchForConsumers();
+
 private:
     TeeBuffer(size_t nConsumers, size_t bufferSizeBytes);
 
@@ -93,6 +104,19 @@ private:
      */
     void loadNextBatch();
 
+    bool anyConsumerInUse() const {
+        return std::any_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        });
+    }
+
+    void disposeSource() {
+        _buffer.clear();
+        if (_source) {
+            _source->dispose();
+        }
+    }
+
     DocumentSource* _source = nullptr;
 
     const size_t _bufferSizeBytes;
@@ -103,5 +127,8 @@ private:
         int nLeftToReturn = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    // True if batches are loaded by the owner of the buffer rather than by the consumers.
+    bool _loadedByOwner = false;
 };
 }  // namespace mongo
@@ -167,5 +167,45 @@ TEST(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDisp
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
 }
+
+TEST(TeeBufferTest, ShouldOnlyLoadBatchesWhenAskedToByOwner) {
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}, Document{{"a", 2}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    const size_t nConsumers = 2;
+    const size_t bufferBytes = 1;  // Both docs won't fit in a single batch.
+    auto teeBuffer = TeeBuffer::create(nConsumers, bufferBytes);
+    teeBuffer->setSource(mock.get());
+    teeBuffer->setLoadedByOwner();
+
+    ASSERT_TRUE(teeBuffer->loadNextBatchForConsumers());
+    auto next0 = teeBuffer->getNext(0);
+    ASSERT_TRUE(next0.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next0.getDocument(), inputs.front().getDocument());
+
+    // Consumer #0 pauses even once consumer #1 is done with the batch, until the owner loads more.
+    ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+    auto next1 = teeBuffer->getNext(1);
+    ASSERT_TRUE(next1.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next1.getDocument(), inputs.front().getDocument());
+    ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+    ASSERT_TRUE(teeBuffer->getNext(1).isPaused());
+
+    // Disposing a consumer leaves the source alone while the other is still in use.
+    teeBuffer->dispose(1);
+    ASSERT_FALSE(mock->isDisposed);
+
+    ASSERT_TRUE(teeBuffer->loadNextBatchForConsumers());
+    next0 = teeBuffer->getNext(0);
+    ASSERT_TRUE(next0.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next0.getDocument(), inputs.back().getDocument());
+
+    ASSERT_FALSE(teeBuffer->loadNextBatchForConsumers());
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+
+    teeBuffer->dispose(0);
+    ASSERT_FALSE(teeBuffer->loadNextBatchForConsumers());
+    ASSERT_TRUE(mock->isDisposed);
+}
 }  // namespace
 }  // namespace mongo
@@ -121,6 +121,8 @@ void ValueStorage::putString(StringData s) {
 }
 
 void ValueStorage::putDocument(const Document& d) {
+    // Nested documents may be shared between threads, so they must be fully converted.
+    d.storage().loadLazyFields();
     putRefCountable(d._storage);
 }
 
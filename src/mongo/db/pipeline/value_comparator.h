@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <absl/container/flat_hash_map.h>
 #include <map>
 #include <set>
 
@@ -183,6 +184,18 @@ public:
         return stdx::unordered_map<Value, T, Hasher, EqualTo>(0, Hasher(this), EqualTo(this));
     }
 
+    /**
+     * Like makeUnorderedValueMap(), but the entries are stored inline in the table rather than in
+     * separately allocated nodes. Lookups are cheaper, but inserting into the returned map
+     * invalidates references to its entries. This comparator must outlive the returned map.
+     */
+    template <typename T>
+    absl::flat_hash_map<Value, T, EnsureTrustedHasher<Hasher, Value>, EqualTo>
+    makeFlatUnorderedValueMap() const {
+        return absl::flat_hash_map<Value, T, EnsureTrustedHasher<Hasher, Value>, EqualTo>(
+            0, Hasher(this), EqualTo(this));
+    }
+
 private:
     const StringData::ComparatorInterface* _stringComparator = nullptr;
 };
@@ -203,4 +216,11 @@ template <typename T>
 using ValueUnorderedMap =
     stdx::unordered_map<Value, T, ValueComparator::Hasher, ValueComparator::EqualTo>;
 
+template <typename T>
+using ValueFlatUnorderedMap =
+    absl::flat_hash_map<Value,
+                        T,
+                        EnsureTrustedHasher<ValueComparator::Hasher, Value>,
+                        ValueComparator::EqualTo>;
+
 }  // namespace mongo
@@ -250,15 +250,23 @@ StatusWith<CursorResponse> CursorResponse::parseFromBSON(const BSONObj& cmdRespo
                               << writeConcernError.type()};
     }
 
-    return {{NamespaceString(fullns),
-             cursorId,
-             std::move(batch),
-             boost::none,
-             latestOplogTimestampElem ? latestOplogTimestampElem.timestamp()
-                                      : boost::optional<Timestamp>{},
-             postBatchResumeTokenElem ? postBatchResumeTokenElem.Obj().getOwned()
-                                      : boost::optional<BSONObj>{},
-             writeConcernError ? writeConcernError.Obj().getOwned() : boost::optional<BSONObj>{}}};
+    const bool hasDocs = !batch.empty();
+    CursorResponse response(
+        NamespaceString(fullns),
+        cursorId,
+        std::move(batch),
+        boost::none,
+        latestOplogTimestampElem ? latestOplogTimestampElem.timestamp()
+                                 : boost::optional<Timestamp>{},
+        postBatchResumeTokenElem ? postBatchResumeTokenElem.Obj().getOwned()
+                                 : boost::optional<BSONObj>{},
+        writeConcernError ? writeConcernError.Obj().getOwned() : boost::optional<BSONObj>{});
+
+    if (hasDocs) {
+        batchObj.shareOwnershipWith(cmdResponse);
+        response.setRawBatch(std::move(batchObj));
+    }
+    return {std::move(response)};
 }
 
 void CursorResponse::addToBSON(CursorResponse::ResponseType responseType,
@@ -270,11 +278,15 @@ void CursorResponse::addToBSON(CursorResponse::ResponseType responseType,
 
     const char* batchFieldName =
         (responseType == ResponseType::InitialResponse) ? kBatchFieldInitial : kBatchField;
-    BSONArrayBuilder batchBuilder(cursorBuilder.subarrayStart(batchFieldName));
-    for (const BSONObj& obj : _batch) {
-        batchBuilder.append(obj);
+    if (!_rawBatch.isEmpty()) {
+        cursorBuilder.appendArray(batchFieldName, _rawBatch);
+    } else {
+        BSONArrayBuilder batchBuilder(cursorBuilder.subarrayStart(batchFieldName));
+        for (const BSONObj& obj : _batch) {
+            batchBuilder.append(obj);
+        }
+        batchBuilder.doneFast();
     }
-    batchBuilder.doneFast();
 
     if (_postBatchResumeToken && !_postBatchResumeToken->isEmpty()) {
         cursorBuilder.append(kPostBatchResumeTokenField, *_postBatchResumeToken);
@@ -234,9 +234,27 @@ public:
     }
 
     std::vector<BSONObj> releaseBatch() {
+        _rawBatch = BSONObj();
         return std::move(_batch);
     }
 
+    /**
+     * Returns the batch array exactly as it appeared in the parsed command response, sharing
+     * ownership with it. Empty if this response was not parsed from BSON.
+     */
+    const BSONObj& getRawBatch() const {
+        return _rawBatch;
+    }
+
+    /**
+     * Sets an already serialized BSON array of documents to be written out as the batch in place of
+     * the documents returned by getBatch(). Lets a response received from a remote be forwarded
+     * without appending its documents one at a time.
+     */
+    void setRawBatch(BSONObj rawBatch) {
+        _rawBatch = std::move(rawBatch);
+    }
+
     boost::optional<long long> getNumReturnedSoFar() const {
         return _numReturnedSoFar;
     }
@@ -266,6 +284,7 @@ private:
     NamespaceString _nss;
     CursorId _cursorId;
     std::vector<BSONObj> _batch;
+    BSONObj _rawBatch;
     boost::optional<long long> _numReturnedSoFar;
     boost::optional<Timestamp> _latestOplogTimestamp;
     boost::optional<BSONObj> _postBatchResumeToken;
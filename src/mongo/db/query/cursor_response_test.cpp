@@ -310,6 +310,39 @@ TEST(CursorResponseTest, addToBSONSubsequentResponse) {
     ASSERT_BSONOBJ_EQ(responseObj, expectedResponse);
 }
 
+TEST(CursorResponseTest, addToBSONRawBatch) {
+    CursorResponse response(NamespaceString("testdb.testcoll"), CursorId(123), {});
+    response.setRawBatch(BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2)));
+
+    BSONObjBuilder builder;
+    response.addToBSON(CursorResponse::ResponseType::SubsequentResponse, &builder);
+    BSONObj responseObj = builder.obj();
+
+    BSONObj expectedResponse =
+        BSON("cursor" << BSON("id" << CursorId(123) << "ns"
+                                   << "testdb.testcoll"
+                                   << "nextBatch"
+                                   << BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2)))
+                      << "ok"
+                      << 1.0);
+    ASSERT_BSONOBJ_EQ(responseObj, expectedResponse);
+}
+
+TEST(CursorResponseTest, parseFromBSONKeepsRawBatch) {
+    BSONObj batch = BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2));
+    CursorResponse response = CursorResponse::parseFromBSONThrowing(
+        BSON("cursor" << BSON("id" << CursorId(123) << "ns"
+                                   << "db.coll"
+                                   << "nextBatch"
+                                   << batch)
+                      << "ok"
+                      << 1));
+    ASSERT_BSONOBJ_EQ(response.getRawBatch(), batch);
+
+    response.releaseBatch();
+    ASSERT_TRUE(response.getRawBatch().isEmpty());
+}
+
 TEST(CursorResponseTest, serializeLatestOplogEntry) {
     std::vector<BSONObj> batch = {BSON("_id" << 1), BSON("_id" << 2)};
     CursorResponse response(
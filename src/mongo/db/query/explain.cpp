@@ -172,7 +172,7 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
  * (in which case this gets called from Explain::getSummaryStats()).
  */
 size_t getDocsExamined(StageType type, const SpecificStats* specific) {
-    if (STAGE_COLLSCAN == type) {
+    if (STAGE_COLLSCAN == type || STAGE_PARALLEL_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
     } else if (STAGE_FETCH == type) {
@@ -184,6 +184,9 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_TEXT_OR == type) {
         const TextOrStats* spec = static_cast<const TextOrStats*>(specific);
         return spec->fetches;
+    } else if (STAGE_GEO_NEAR_2DSPHERE == type) {
+        const NearStats* spec = static_cast<const NearStats*>(specific);
+        return spec->docsExamined;
     }
 
     return 0;
@@ -325,6 +328,13 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
         bob->appendNumber("nReturned", stats.common.advanced);
         bob->appendNumber("executionTimeMillisEstimate", stats.common.executionTimeMillis);
+        if (stats.common.detailedStats) {
+            bob->appendNumber("cpuNanos", stats.common.cpuNanos);
+            BSONObjBuilder storageBob(bob->subobjStart("storage"));
+            storageBob.appendNumber("bytesRead", stats.common.storageBytesRead);
+            storageBob.appendNumber("readMicros", stats.common.storageReadMicros);
+            storageBob.appendNumber("cacheWaitMicros", stats.common.storageCacheWaitMicros);
+        }
         bob->appendNumber("works", stats.common.works);
         bob->appendNumber("advanced", stats.common.advanced);
         bob->appendNumber("needTime", stats.common.needTime);
@@ -341,6 +351,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendNumber("filterRejects", spec->filterRejects);
 
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i),
@@ -355,7 +366,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
                 bob->appendNumber(string(stream() << "failedAnd_" << i), spec->failedAnd[i]);
             }
         }
-    } else if (STAGE_COLLSCAN == stats.stageType) {
+    } else if (STAGE_COLLSCAN == stats.stageType || STAGE_PARALLEL_COLLSCAN == stats.stageType) {
         CollectionScanStats* spec = static_cast<CollectionScanStats*>(stats.specific.get());
         bob->append("direction", spec->direction > 0 ? "forward" : "backward");
         if (spec->maxTs) {
@@ -451,6 +462,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         bob->append("indexVersion", spec->indexVersion);
 
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            if (STAGE_GEO_NEAR_2DSPHERE == stats.stageType) {
+                bob->appendNumber("docsExamined", spec->docsExamined);
+            }
             BSONArrayBuilder intervalsBob(bob->subarrayStart("searchIntervals"));
             for (vector<IntervalStats>::const_iterator it = spec->intervalStats.begin();
                  it != spec->intervalStats.end();
@@ -543,6 +557,13 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (spec->limit > 0) {
             bob->appendNumber("limitAmount", spec->limit);
         }
+
+        if (spec->sortedPrefixLength > 0) {
+            bob->appendNumber("sortedPrefixLength", spec->sortedPrefixLength);
+            if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+                bob->appendNumber("groupsSorted", spec->groupsSorted);
+            }
+        }
     } else if (STAGE_SORT_MERGE == stats.stageType) {
         MergeSortStats* spec = static_cast<MergeSortStats*>(stats.specific.get());
         bob->append("sortPattern", spec->sortPattern);
@@ -567,8 +588,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_TEXT_OR == stats.stageType) {
         TextOrStats* spec = static_cast<TextOrStats*>(stats.specific.get());
 
+        if (spec->topK) {
+            bob->appendNumber("topK", spec->topK);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->fetches);
+            if (spec->topK) {
+                bob->appendBool("stoppedEarly", spec->stoppedEarly);
+            }
         }
     } else if (STAGE_UPDATE == stats.stageType) {
         UpdateStats* spec = static_cast<UpdateStats*>(stats.specific.get());
@@ -687,6 +715,24 @@ void Explain::generatePlannerInfo(PlanExecutor* exec,
         plannerBob.append("planCacheKey", unsignedIntToFixedLengthHex(*planCacheKeyHash));
     }
 
+    if (MultiPlanStage* mps = getMultiPlanStage(exec->getRootStage())) {
+        auto mpsStats = static_cast<const MultiPlanStats*>(mps->getSpecificStats());
+        if (!mpsStats->costEstimates.empty()) {
+            BSONObjBuilder costBob(plannerBob.subobjStart("costBasedPlanning"));
+            costBob.append("chosenByCostEstimate", mpsStats->chosenByCostEstimate);
+            BSONArrayBuilder estimatesBob(costBob.subarrayStart("candidates"));
+            for (auto&& estimate : mpsStats->costEstimates) {
+                BSONObjBuilder estimateBob(estimatesBob.subobjStart());
+                estimateBob.append("planSummary", estimate.planSummary);
+                estimateBob.appendNumber("keysExamined", estimate.keysExamined);
+                estimateBob.appendNumber("keysMatched", estimate.keysMatched);
+                estimateBob.append("exact", estimate.exact);
+            }
+            estimatesBob.doneFast();
+            costBob.doneFast();
+        }
+    }
+
     BSONObjBuilder winningPlanBob(plannerBob.subobjStart("winningPlan"));
     const auto winnerStats = getWinningPlanStatsTree(exec);
     statsToBSON(*winnerStats.get(), &winningPlanBob, ExplainOptions::Verbosity::kQueryPlanner);
@@ -1018,6 +1064,9 @@ void Explain::planCacheEntryToBSON(const PlanCacheEntry& entry, BSONObjBuilder*
     // Append whether or not the entry is active.
     out->append("isActive", entry.isActive);
     out->append("works", static_cast<long long>(entry.works));
+    out->append("numHits", static_cast<long long>(entry.numHits));
+    out->append("numMisses", static_cast<long long>(entry.numMisses));
+    out->append("numReplans", static_cast<long long>(entry.numReplans));
 
     BSONObjBuilder cachedPlanBob(out->subobjStart("cachedPlan"));
     Explain::statsToBSON(
@@ -30,13 +30,17 @@
 #include "mongo/db/query/expression_index.h"
 
 #include <iostream>
+#include <limits>
 #include <unordered_set>
 
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/r2_region_coverer.h"
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
+#include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/expression_index_knobs_gen.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -108,10 +112,12 @@ void ExpressionMapping::cover2d(const R2Region& region,
     GeoHashsToIntervalsWithParents(unorderedCovering, oilOut);
 }
 
-std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
-    auto minLevel = gInternalQueryS2GeoCoarsestLevel.load();
-    auto maxLevel = gInternalQueryS2GeoFinestLevel.load();
+namespace {
 
+std::vector<S2CellId> computeS2Covering(const S2Region& region,
+                                        int minLevel,
+                                        int maxLevel,
+                                        int maxCells) {
     uassert(28739, "Geo coarsest level must be in range [0,30]", 0 <= minLevel && minLevel <= 30);
     uassert(28740, "Geo finest level must be in range [0,30]", 0 <= maxLevel && maxLevel <= 30);
     uassert(28741, "Geo coarsest level must be less than or equal to finest", minLevel <= maxLevel);
@@ -119,13 +125,73 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     S2RegionCoverer coverer;
     coverer.set_min_level(minLevel);
     coverer.set_max_level(maxLevel);
-    coverer.set_max_cells(gInternalQueryS2GeoMaxCells.load());
+    coverer.set_max_cells(maxCells);
 
     std::vector<S2CellId> cover;
     coverer.GetCovering(region, &cover);
     return cover;
 }
 
+/**
+ * Caches the 2dsphere coverings of query geometries, keyed by the serialized geometry and the
+ * covering parameters. Entries are evicted in least recently used order to keep the cache within
+ * internalQueryS2GeoCoveringCacheMaxBytes.
+ */
+class S2CoveringCache {
+public:
+    boost::optional<std::vector<S2CellId>> find(const std::string& key) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _cache.promote(key);
+        if (it == _cache.end()) {
+            return boost::none;
+        }
+        return it->second.cover;
+    }
+
+    void insert(const std::string& key, const std::vector<S2CellId>& cover, size_t maxBytes) {
+        const size_t bytes = key.size() + cover.size() * sizeof(S2CellId);
+        if (bytes > maxBytes) {
+            return;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_cache.hasKey(key)) {
+            return;
+        }
+        while (!_cache.empty() && _cachedBytes + bytes > maxBytes) {
+            auto lru = std::prev(_cache.end());
+            _cachedBytes -= lru->second.bytes;
+            _cache.erase(lru);
+        }
+        _cache.add(key, Entry{cover, bytes});
+        _cachedBytes += bytes;
+    }
+
+private:
+    struct Entry {
+        std::vector<S2CellId> cover;
+        size_t bytes;
+    };
+
+    stdx::mutex _mutex;
+
+    // Entries are only bounded by their total size.
+    LRUCache<std::string, Entry> _cache{std::numeric_limits<std::size_t>::max()};
+
+    size_t _cachedBytes = 0;
+};
+
+S2CoveringCache s2CoveringCache;
+
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+    return computeS2Covering(region,
+                             gInternalQueryS2GeoCoarsestLevel.load(),
+                             gInternalQueryS2GeoFinestLevel.load(),
+                             gInternalQueryS2GeoMaxCells.load());
+}
+
 void ExpressionMapping::cover2dsphere(const S2Region& region,
                                       const S2IndexingParams& indexingParams,
                                       OrderedIntervalList* oilOut) {
@@ -133,6 +199,37 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+void ExpressionMapping::cover2dsphere(const GeoMatchExpression& expr,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    const S2Region& region = expr.getGeoExpression().getGeometry().getS2Region();
+    const long long maxBytes = gInternalQueryS2GeoCoveringCacheMaxBytes.load();
+    const int minLevel = gInternalQueryS2GeoCoarsestLevel.load();
+    const int maxLevel = gInternalQueryS2GeoFinestLevel.load();
+    const int maxCells = gInternalQueryS2GeoMaxCells.load();
+    if (maxBytes <= 0) {
+        cover2dsphere(region, indexingParams, oilOut);
+        return;
+    }
+
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("minLevel", minLevel);
+    keyBuilder.append("maxLevel", maxLevel);
+    keyBuilder.append("maxCells", maxCells);
+    keyBuilder.append("geo", expr.getSerializedRightHandSide());
+    const BSONObj keyObj = keyBuilder.done();
+    const std::string key(keyObj.objdata(), keyObj.objsize());
+
+    std::vector<S2CellId> cover;
+    if (auto cached = s2CoveringCache.find(key)) {
+        cover = std::move(*cached);
+    } else {
+        cover = computeS2Covering(region, minLevel, maxLevel, maxCells);
+        s2CoveringCache.insert(key, cover, static_cast<size_t>(maxBytes));
+    }
+    S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
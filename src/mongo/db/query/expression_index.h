@@ -42,6 +42,8 @@ class S2Region;
 
 namespace mongo {
 
+class GeoMatchExpression;
+
 /**
  * Functions that compute expression index mappings.
  *
@@ -78,6 +80,15 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    /**
+     * Like cover2dsphere() above, for the geometry of 'expr'. Coverings are cached by the
+     * serialized geometry, so that repeated queries on the same complex geometries do not
+     * recompute them.
+     */
+    static void cover2dsphere(const GeoMatchExpression& expr,
+                              const S2IndexingParams& indexParams,
+                              OrderedIntervalList* oilOut);
 };
 
 }  // namespace mongo
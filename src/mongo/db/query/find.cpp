@@ -445,6 +445,9 @@ Message getMore(OperationContext* opCtx,
         curOp.setGenericCursor_inlock(cursorPin->toGenericCursor());
     }
 
+    curOp.debug().queryStatsKey = cursorPin->getQueryStatsKey();
+    curOp.debug().queryShape = cursorPin->getQueryShape();
+
     PlanExecutor::ExecState state;
 
     // We report keysExamined and docsExamined to OpDebug for a given getMore operation. To obtain
@@ -81,6 +81,7 @@
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/scripting/engine.h"
@@ -312,6 +313,40 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+/**
+ * Records the shape of 'cq' as the query shape of the current operation, unless the operation
+ * already has one. An aggregation records the shape of its pipeline before planning the queries of
+ * its stages.
+ */
+void setQueryShape(OperationContext* opCtx, const CanonicalQuery& cq) {
+    auto curOp = CurOp::get(opCtx);
+    auto& opDebug = curOp->debug();
+    if (!opDebug.queryStatsKey.empty()) {
+        return;
+    }
+
+    const StringData commandName = curOp->getCommand()
+        ? StringData(curOp->getCommand()->getName())
+        : StringData(logicalOpToString(opDebug.logicalOp));
+    const auto& qr = cq.getQueryRequest();
+
+    BSONObjBuilder shapeBuilder;
+    shapeBuilder.append("ns", cq.ns());
+    shapeBuilder.append("command", commandName);
+    shapeBuilder.append("filter", QueryStatsStore::redactLiterals(qr.getFilter()));
+    if (!qr.getSort().isEmpty()) {
+        shapeBuilder.append("sort", qr.getSort());
+    }
+    if (!qr.getProj().isEmpty()) {
+        shapeBuilder.append("projection", QueryStatsStore::redactLiterals(qr.getProj()));
+    }
+    opDebug.queryShape = shapeBuilder.obj();
+
+    // The encoded key of the canonical query is the shape under which the plan cache stores its
+    // plans, which omits the literal values of the query.
+    opDebug.queryStatsKey = commandName.toString() + '\0' + cq.ns() + '\0' + cq.encodeKey();
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -332,6 +367,8 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
     invariant(canonicalQuery);
     unique_ptr<PlanStage> root;
 
+    setQueryShape(opCtx, *canonicalQuery);
+
     // This can happen as we're called by internal clients as well.
     if (NULL == collection) {
         const string& ns = canonicalQuery->ns();
@@ -672,7 +672,8 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
 
         *tightnessOut = IndexBoundsBuilder::EXACT;
 
-        // Create our various intervals.
+        // Create our various intervals. Most equalities produce a single point interval.
+        oilOut->intervals.reserve(oilOut->intervals.size() + ime->getEqualities().size());
 
         IndexBoundsBuilder::BoundsTightness tightness;
         bool arrayOrNullPresent = false;
@@ -719,10 +720,9 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
 
         if (mongoutils::str::equals("2dsphere", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasS2Region());
-            const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            ExpressionMapping::cover2dsphere(*gme, indexParams, oilOut);
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
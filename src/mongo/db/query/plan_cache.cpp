@@ -157,8 +157,7 @@ bool PlanCache::shouldCacheQuery(const CanonicalQuery& query) {
 //
 
 CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& entry)
-    : plannerData(entry.plannerData.size()),
-      key(key),
+    : key(key),
       query(entry.query.getOwned()),
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
@@ -166,10 +165,12 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       decisionWorks(entry.works) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
-    for (size_t i = 0; i < entry.plannerData.size(); ++i) {
-        verify(entry.plannerData[i]);
-        plannerData[i] = entry.plannerData[i]->clone();
-    }
+    //
+    // Planning from the cache only ever uses the winning plan, so the losing candidates' index
+    // tag trees are not copied on every lookup.
+    invariant(!entry.plannerData.empty());
+    verify(entry.plannerData[0]);
+    plannerData.push_back(entry.plannerData[0]->clone());
 }
 
 CachedSolution::~CachedSolution() {
@@ -236,6 +237,9 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
 
     // Copy performance stats.
     entry->feedback = feedback;
+    entry->numHits = numHits;
+    entry->numMisses = numMisses;
+    entry->numReplans = numReplans;
 
     return entry;
 }
@@ -337,6 +341,10 @@ std::string SolutionCacheData::toString() const {
             return str::stream() << "(whole index scan solution: "
                                  << "dir=" << this->wholeIXSolnDir << "; "
                                  << "tree=" << this->tree->toString() << ")";
+        case SKIP_IXSCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip index scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
         case USE_INDEX_TAGS_SOLN:
@@ -353,12 +361,27 @@ std::string SolutionCacheData::toString() const {
 
 PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size) : PlanCache(size, 1) {}
+
+PlanCache::PlanCache(size_t size, size_t numShards) {
+    invariant(numShards > 0);
+    const size_t shardSize = (size + numShards - 1) / numShards;
+    for (size_t i = 0; i < numShards; ++i) {
+        _shards.push_back(stdx::make_unique<Shard>(shardSize));
+    }
+}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns)
+    : PlanCache(internalQueryCacheSize.load(), internalQueryCacheNumShards.load()) {
+    _ns = ns;
+}
 
 PlanCache::~PlanCache() {}
 
+PlanCache::Shard& PlanCache::getShard(const PlanCacheKey& key) const {
+    return *_shards[PlanCacheKeyHasher{}(key) % _shards.size()];
+}
+
 std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCacheKey& key) const {
 
     PlanCache::GetResult res = get(key);
@@ -476,7 +499,11 @@ Status PlanCache::set(const CanonicalQuery& query,
 
     const auto key = computeKey(query);
     const size_t newWorks = why->stats[0]->common.works;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
+    PlanCacheEntry* oldEntry = nullptr;
+    Status cacheStatus = shard.cache.get(key, &oldEntry);
+    invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
     bool isNewEntryActive = false;
     uint32_t queryHash;
     uint32_t planCacheKey;
@@ -486,9 +513,6 @@ Status PlanCache::set(const CanonicalQuery& query,
         planCacheKey = canonical_query_encoder::computeHash(key.stringData());
         queryHash = canonical_query_encoder::computeHash(key.getStableKeyStringData());
     } else {
-        PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
-        invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         if (oldEntry) {
             queryHash = oldEntry->queryHash;
             planCacheKey = oldEntry->planCacheKey;
@@ -521,6 +545,11 @@ Status PlanCache::set(const CanonicalQuery& query,
         newEntry->collation = query.getCollator()->getSpec().toBSON();
     }
     newEntry->timeOfCreation = now;
+    if (oldEntry) {
+        newEntry->numHits = oldEntry->numHits;
+        newEntry->numMisses = oldEntry->numMisses;
+        newEntry->numReplans = oldEntry->numReplans;
+    }
 
     // Strip projections on $-prefixed fields, as these are added by internal callers of the query
     // system and are not considered part of the user projection.
@@ -533,7 +562,7 @@ Status PlanCache::set(const CanonicalQuery& query,
     }
     newEntry->projection = projBuilder.obj();
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    std::unique_ptr<PlanCacheEntry> evictedEntry = shard.cache.add(key, newEntry.release());
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
@@ -550,15 +579,17 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return;
     }
     invariant(entry);
     entry->isActive = false;
+    ++entry->numReplans;
 }
 
 PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
@@ -567,26 +598,34 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 }
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return {CacheEntryState::kNotPresent, nullptr};
     }
     invariant(entry);
 
-    auto state =
-        entry->isActive ? CacheEntryState::kPresentActive : CacheEntryState::kPresentInactive;
+    CacheEntryState state;
+    if (entry->isActive) {
+        state = CacheEntryState::kPresentActive;
+        ++entry->numHits;
+    } else {
+        state = CacheEntryState::kPresentInactive;
+        ++entry->numMisses;
+    }
     return {state, stdx::make_unique<CachedSolution>(key, *entry)};
 }
 
 Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = getShard(ck);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = shard.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -601,13 +640,17 @@ Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheKey key = computeKey(canonicalQuery);
+    Shard& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
+    return shard.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        shard->cache.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -621,9 +664,10 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Shard& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -633,20 +677,26 @@ StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQ
 }
 
 std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<std::unique_ptr<PlanCacheEntry>> entries;
 
-    for (auto&& cacheEntry : _cache) {
-        auto entry = cacheEntry.second;
-        entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        for (auto&& cacheEntry : shard->cache) {
+            auto entry = cacheEntry.second;
+            entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t total = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        total += shard->cache.size();
+    }
+    return total;
 }
 
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
@@ -657,13 +707,15 @@ std::vector<BSONObj> PlanCache::getMatchingStats(
     const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
     const std::function<bool(const BSONObj&)>& filterFunc) const {
     std::vector<BSONObj> results;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
 
-    for (auto&& cacheEntry : _cache) {
-        const auto entry = cacheEntry.second;
-        auto serializedEntry = serializationFunc(*entry);
-        if (filterFunc(serializedEntry)) {
-            results.push_back(serializedEntry);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        for (auto&& cacheEntry : shard->cache) {
+            const auto entry = cacheEntry.second;
+            auto serializedEntry = serializationFunc(*entry);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
         }
     }
 
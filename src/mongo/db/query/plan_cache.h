@@ -217,6 +217,10 @@ struct SolutionCacheData {
         // scan (e.g. using index to provide sort).
         WHOLE_IXSCAN_SOLN,
 
+        // The cached plan skip-scans the index stored in
+        // 'tree' over its unconstrained leading fields.
+        SKIP_IXSCAN_SOLN,
+
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
@@ -247,7 +251,8 @@ public:
     CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& entry);
     ~CachedSolution();
 
-    // Owned here.
+    // Owned here. Holds only the data for the winning plan, which is all that is needed to
+    // rebuild a QuerySolution from the cache.
     std::vector<SolutionCacheData*> plannerData;
 
     // Key used to provide feedback on the entry.
@@ -345,6 +350,14 @@ public:
     // trigger a replan. Running a query of the same shape while this cache entry is inactive may
     // cause this value to be increased.
     size_t works = 0;
+
+    // Usage counters reported by $planCacheStats. A hit is a lookup which found this entry
+    // active, a miss is one which found it inactive, and a replan is a deactivation of this entry
+    // after its plan performed poorly. The counters carry over when a new plan replaces this
+    // entry for the same query shape.
+    size_t numHits = 0;
+    size_t numMisses = 0;
+    size_t numReplans = 0;
 };
 
 /**
@@ -398,6 +411,12 @@ public:
 
     PlanCache(size_t size);
 
+    /**
+     * Creates a cache holding roughly 'size' entries, split across 'numShards' independently
+     * locked shards.
+     */
+    PlanCache(size_t size, size_t numShards);
+
     PlanCache(const std::string& ns);
 
     ~PlanCache();
@@ -531,6 +550,20 @@ public:
     }
 
 private:
+    /**
+     * A lock stripe of the cache. Entries are assigned to shards by the hash of their
+     * PlanCacheKey, so that lookups of different query shapes rarely contend on the same mutex.
+     * Each shard evicts its own least recently used entries.
+     */
+    struct Shard {
+        explicit Shard(size_t size) : cache(size) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> cache;
+
+        // Protects 'cache'.
+        stdx::mutex mutex;
+    };
+
     struct NewEntryState {
         bool shouldBeCreated = false;
         bool shouldBeActive = false;
@@ -543,10 +576,12 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    /**
+     * Returns the shard responsible for 'key'.
+     */
+    Shard& getShard(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    std::vector<std::unique_ptr<Shard>> _shards;
 
     // Full namespace of collection.
     std::string _ns;
@@ -629,6 +629,68 @@ TEST(PlanCacheTest, AddActiveCacheEntry) {
     ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kNotPresent);
 }
 
+TEST(PlanCacheTest, EntriesCountHitsMissesAndReplans) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 20), Date_t{}));
+
+    // Lookups of an inactive entry are misses.
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+
+    // Promoting the entry to active keeps its counters, and lookups are now hits.
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 10), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+    planCache.deactivate(*cq);
+
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->numMisses, 2U);
+    ASSERT_EQ(entry->numHits, 1U);
+    ASSERT_EQ(entry->numReplans, 1U);
+}
+
+TEST(PlanCacheTest, CachedSolutionCopiesOnlyWinningPlan) {
+    unique_ptr<QuerySolution> winner{GenerateQuerySolution{}()};
+    winner->cacheData->solnType = SolutionCacheData::WHOLE_IXSCAN_SOLN;
+    unique_ptr<QuerySolution> loser{GenerateQuerySolution{}()};
+    std::vector<QuerySolution*> solns = {winner.get(), loser.get()};
+
+    PlanCacheEntry entry(solns, createDecision(2U).release(), 0U, 0U);
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    CachedSolution cachedSoln(PlanCache().computeKey(*cq), entry);
+    ASSERT_EQ(cachedSoln.plannerData.size(), 1U);
+    ASSERT_EQ(cachedSoln.plannerData[0]->solnType, SolutionCacheData::WHOLE_IXSCAN_SOLN);
+}
+
+TEST(PlanCacheTest, ShardedCacheHoldsEntriesForManyShapes) {
+    const size_t kCacheSize = 64;
+    PlanCache planCache(kCacheSize, 8);
+    QueryTestServiceContext serviceContext;
+
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (const char* field : {"a", "b", "c", "d", "e", "f"}) {
+        queries.push_back(canonicalize(BSON(field << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+    ASSERT_EQ(planCache.size(), queries.size());
+    ASSERT_EQ(planCache.getAllEntries().size(), queries.size());
+
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    ASSERT_OK(planCache.remove(*queries.front()));
+    ASSERT_EQ(planCache.get(*queries.front()).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.size(), queries.size() - 1);
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
+}
+
 TEST(PlanCacheTest, WorksValueIncreases) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -52,6 +52,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -123,6 +124,23 @@ PlanStage* getStageByType(PlanStage* root, StageType type) {
 
     return NULL;
 }
+
+/**
+ * Returns true if 'root'' or any of its descendants writes to the database.
+ */
+bool containsWriteStage(const PlanStage* root) {
+    if (STAGE_UPDATE == root->stageType() || STAGE_DELETE == root->stageType()) {
+        return true;
+    }
+
+    for (auto&& child : root->getChildren()) {
+        if (containsWriteStage(child.get())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }  // namespace
 
 // static
@@ -327,6 +345,12 @@ void PlanExecutorImpl::saveState() {
     // boundaries.
     WorkingSetCommon::prepareForSnapshotChange(_workingSet.get());
 
+    // Buffered results from the root stage's current batch must not hold unowned BSON across the
+    // snapshot change either.
+    for (size_t i = _batchPos; i < _batch.size(); ++i) {
+        _workingSet->get(_batch[i])->makeObjOwnedIfNeeded();
+    }
+
     if (!isMarkedAsKilled()) {
         _root->saveState();
     }
@@ -446,15 +470,23 @@ PlanExecutor::ExecState PlanExecutorImpl::_waitForInserts(CappedInsertNotifierDa
     // of the notifier at the time of the previous EOF, we require two EOFs in a row with no
     // notifier version change in order to wait.  This is sufficient to ensure we never wait
     // when data is available.
+    //
+    // If the locks were released for the wait, the snapshot was abandoned before it, so the plan
+    // will see the data of every insert that the notifier had signalled by the time the wait
+    // returned. In that case the version read after the wait is recorded instead, and the next EOF
+    // waits right away rather than scanning once more. With many awaitData cursors on the same
+    // collection, this halves the work done by each of them for every notification.
     auto curOp = CurOp::get(_opCtx);
     curOp->pauseTimer();
     ON_BLOCK_EXIT([curOp] { curOp->resumeTimer(); });
     auto opCtx = _opCtx;
     uint64_t currentNotifierVersion = notifierData->notifier->getVersion();
-    auto yieldResult = _yieldPolicy->yieldOrInterrupt([opCtx, notifierData] {
-        const auto deadline = awaitDataState(opCtx).waitForInsertsDeadline;
-        notifierData->notifier->waitUntil(notifierData->lastEOFVersion, deadline);
-    });
+    auto yieldResult =
+        _yieldPolicy->yieldOrInterrupt([opCtx, notifierData, &currentNotifierVersion] {
+            const auto deadline = awaitDataState(opCtx).waitForInsertsDeadline;
+            notifierData->notifier->waitUntil(notifierData->lastEOFVersion, deadline);
+            currentNotifierVersion = notifierData->notifier->getVersion();
+        });
     notifierData->lastEOFVersion = currentNotifierVersion;
 
     if (yieldResult.isOK()) {
@@ -525,7 +557,7 @@ PlanExecutor::ExecState PlanExecutorImpl::_getNextImpl(Snapshotted<BSONObj>* obj
         }
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = _workRoot(&id);
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -613,9 +645,55 @@ PlanExecutor::ExecState PlanExecutorImpl::_getNextImpl(Snapshotted<BSONObj>* obj
     }
 }
 
+PlanStage::StageState PlanExecutorImpl::_workRoot(WorkingSetID* out) {
+    if (_batchPos < _batch.size()) {
+        *out = _batch[_batchPos++];
+        return PlanStage::ADVANCED;
+    }
+
+    if (PlanStage::NEED_TIME != _batchEndState) {
+        const PlanStage::StageState endState = _batchEndState;
+        *out = _batchEndId;
+        _batchEndState = PlanStage::NEED_TIME;
+        _batchEndId = WorkingSet::INVALID_ID;
+        return endState;
+    }
+
+    const int batchSize = internalQueryExecWorkBatchSize.load();
+    if (batchSize > 1 && !_planContainsWrites) {
+        _planContainsWrites = containsWriteStage(_root.get());
+    }
+
+    // Plans which write are always worked one unit at a time, so that we never apply writes on
+    // behalf of results the caller has not asked for yet.
+    if (batchSize <= 1 || *_planContainsWrites) {
+        return _root->work(out);
+    }
+
+    _batch.clear();
+    _batchPos = 0;
+    WorkingSetID lastId = WorkingSet::INVALID_ID;
+    const PlanStage::StageState code =
+        _root->workBatch(_workingSet.get(), batchSize, &_batch, &lastId);
+
+    if (_batch.empty()) {
+        *out = lastId;
+        return code;
+    }
+
+    if (PlanStage::ADVANCED != code && PlanStage::NEED_TIME != code) {
+        _batchEndState = code;
+        _batchEndId = lastId;
+    }
+    *out = _batch[_batchPos++];
+    return PlanStage::ADVANCED;
+}
+
 bool PlanExecutorImpl::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() ||
+        (_stash.empty() && _batchPos == _batch.size() && PlanStage::FAILURE != _batchEndState &&
+         _root->isEOF());
 }
 
 void PlanExecutorImpl::markAsKilled(Status killStatus) {
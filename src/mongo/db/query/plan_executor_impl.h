@@ -31,8 +31,10 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/query/plan_executor.h"
 
 namespace mongo {
@@ -147,6 +149,13 @@ private:
      */
     ExecState _getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
+    /**
+     * Asks the root stage for its next unit of output, with the same contract as
+     * PlanStage::work(). When batched execution is enabled, the root stage is worked a batch at a
+     * time and the buffered results are handed out one per call.
+     */
+    PlanStage::StageState _workRoot(WorkingSetID* out);
+
     // The OperationContext that we're executing within. This can be updated if necessary by using
     // detachFromOperationContext() and reattachToOperationContext().
     OperationContext* _opCtx;
@@ -173,6 +182,18 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // The results of the root stage's current batch, of which those before '_batchPos' have
+    // already been handed out. If the batch ended in something other than ADVANCED or NEED_TIME,
+    // that state and the id that accompanied it are returned once the results run out.
+    std::vector<WorkingSetID> _batch;
+    size_t _batchPos = 0;
+    PlanStage::StageState _batchEndState = PlanStage::NEED_TIME;
+    WorkingSetID _batchEndId = WorkingSet::INVALID_ID;
+
+    // Whether the plan contains any stage which writes, and so must not be worked in batches.
+    // Computed the first time batched execution is considered.
+    boost::optional<bool> _planContainsWrites;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     bool _everDetachedFromOperationContext = false;
@@ -43,9 +43,11 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/planner_wildcard_helpers.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
@@ -1292,6 +1294,91 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+// static
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeSkipScan(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    // Only plain, non-multikey compound indexes whose keys are ordered like the query's values
+    // are skip-scanned. Sparse and partial indexes may not contain every matching document.
+    if (index.type != INDEX_BTREE || index.keyPattern.nFields() < 2 || index.multikey ||
+        index.sparse || index.filterExpr ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    // Rate the index against a copy of the predicate, so that the tags left behind do not
+    // interfere with the planning of 'query' itself.
+    unique_ptr<MatchExpression> root = query.root()->shallowClone();
+    root->resetTag();
+    const std::vector<IndexEntry> indices{index};
+    QueryPlannerIXSelect::rateIndices(root.get(), "", indices, query.getCollator());
+    QueryPlannerIXSelect::stripInvalidAssignments(root.get(), indices);
+
+    std::vector<MatchExpression*> preds;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            preds.push_back(root->getChild(i));
+        }
+    } else {
+        preds.push_back(root.get());
+    }
+
+    auto isn = stdx::make_unique<IndexScanNode>(index);
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+    isn->addKeyMetadata = query.getQueryRequest().returnKey();
+    isn->queryCollator = query.getCollator();
+
+    bool hasBounds = false;
+    for (auto pred : preds) {
+        auto rt = static_cast<RelevantTag*>(pred->getTag());
+        if (!rt) {
+            continue;
+        }
+        if (!rt->first.empty()) {
+            // The leading field is constrained, so the regular index plans apply.
+            return nullptr;
+        }
+        if (rt->notFirst.empty()) {
+            continue;
+        }
+
+        size_t pos = 0;
+        for (auto&& keyElt : index.keyPattern) {
+            if (keyElt.fieldNameStringData() == rt->path) {
+                OrderedIntervalList* oil = &isn->bounds.fields[pos];
+                IndexBoundsBuilder::BoundsTightness tightness;
+                if (oil->name.empty()) {
+                    IndexBoundsBuilder::translate(pred, keyElt, index, oil, &tightness);
+                } else {
+                    IndexBoundsBuilder::translateAndIntersect(pred, keyElt, index, oil, &tightness);
+                }
+                hasBounds = true;
+                break;
+            }
+            ++pos;
+        }
+    }
+
+    if (!hasBounds) {
+        return nullptr;
+    }
+
+    size_t pos = 0;
+    for (auto&& keyElt : index.keyPattern) {
+        if (isn->bounds.fields[pos].name.empty()) {
+            IndexBoundsBuilder::allValuesForField(keyElt, &isn->bounds.fields[pos]);
+        }
+        ++pos;
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds are not necessarily exact, so the fetch re-applies the whole predicate.
+    auto fetch = stdx::make_unique<FetchNode>();
+    root->resetTag();
+    fetch->filter = std::move(root);
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
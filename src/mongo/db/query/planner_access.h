@@ -110,6 +110,16 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that skip-scans the provided index for a query whose predicates only
+     * constrain non-leading fields of the index. The leading fields get "all values" bounds, so
+     * the index scan seeks past each distinct leading value to the keys that can match the
+     * constrained fields. Returns nullptr if the index cannot be skip-scanned for 'query'.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeSkipScan(const IndexEntry& index,
+                                                           const CanonicalQuery& query,
+                                                           const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -40,6 +40,7 @@
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
@@ -396,6 +397,36 @@ std::unique_ptr<ProjectionNode> analyzeProjection(const CanonicalQuery& query,
         std::move(solnRoot), *query.root(), qr.getProj(), *query.getProj());
 }
 
+/**
+ * Returns the length of the longest proper prefix of 'sortObj' that is among 'providedSorts', or
+ * 0 if there is none. A node providing that order returns its results sharing the values of the
+ * prefix consecutively, so a blocking sort above it need only sort within each run of them. Sets
+ * 'reverseOut' if only the reverse of the prefix is provided, in which case the scans beneath the
+ * node must be reversed.
+ */
+size_t getSortedPrefixLength(const BSONObj& sortObj,
+                             const BSONObjSet& providedSorts,
+                             bool* reverseOut) {
+    *reverseOut = false;
+    for (int length = sortObj.nFields() - 1; length > 0; --length) {
+        BSONObjBuilder prefixBob;
+        BSONObjIterator it(sortObj);
+        for (int i = 0; i < length; ++i) {
+            prefixBob.append(it.next());
+        }
+        const BSONObj prefix = prefixBob.obj();
+
+        if (providedSorts.count(prefix)) {
+            return static_cast<size_t>(length);
+        }
+        if (providedSorts.count(QueryPlannerCommon::reverseSortObj(prefix))) {
+            *reverseOut = true;
+            return static_cast<size_t>(length);
+        }
+    }
+    return 0;
+}
+
 }  // namespace
 
 // static
@@ -649,6 +680,15 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
 
     SortNode* sort = new SortNode();
     sort->pattern = sortObj;
+    // The key generator and fetch preserve the order of the results beneath them.
+    if (internalQueryAllowSortOnIndexedPrefix.load()) {
+        bool reversePrefix = false;
+        sort->sortedPrefixLength =
+            getSortedPrefixLength(sortObj, solnRoot->getSort(), &reversePrefix);
+        if (reversePrefix) {
+            QueryPlannerCommon::reverseScans(solnRoot);
+        }
+    }
     sort->children.push_back(solnRoot);
     solnRoot = sort;
     // When setting the limit on the sort, we need to consider both
@@ -716,6 +756,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A TEXT node directly beneath a limited sort on the text score only has to produce the top
+    // 'limit' documents, which allows it to stop reading the text index early.
+    QuerySolutionNode* sortInput = keyGenNode->children[0];
+    if (sort->limit && STAGE_TEXT == sortInput->getType() && sortObj.nFields() == 1 &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(sortInput)->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -3828,6 +3828,38 @@ TEST_F(QueryPlannerTest, IntersectDisableAndHash) {
     internalQueryPlannerEnableHashIntersection.store(oldEnableHashIntersection);
 }
 
+TEST_F(QueryPlannerTest, SkipScanOverUnconstrainedLeadingField) {
+    bool oldEnableSkipScan = internalQueryPlannerEnableIndexSkipScan.load();
+    internalQueryPlannerEnableIndexSkipScan.store(true);
+
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("x" << 1 << "y" << 1), false /* multikey */, true /* sparse */);
+
+    runQuery(fromjson("{b: {$gte: 3, $lt: 5}, y: 1}"));
+
+    // The skip scan is ranked against the collection scan. The sparse index is not used.
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gte: 3, $lt: 5}, y: 1}, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey', 'MaxKey', true, true]], b: [[3, 5, true, false]]}}}}}");
+
+    // A constrained leading field is planned as usual.
+    runQuery(fromjson("{a: 1, b: 3}"));
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [[1, 1, true, true]], b: [[3, 3, true, true]]}}}}}");
+
+    internalQueryPlannerEnableIndexSkipScan.store(false);
+    runQuery(fromjson("{b: {$gte: 3, $lt: 5}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+
+    internalQueryPlannerEnableIndexSkipScan.store(oldEnableSkipScan);
+}
+
 //
 // Index intersection cases for SERVER-12825: make sure that
 // we don't generate an ixisect plan if a compound index is
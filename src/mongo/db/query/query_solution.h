@@ -274,6 +274,10 @@ struct TextNode : public QuerySolutionNode {
     IndexEntry index;
     std::unique_ptr<fts::FTSQuery> ftsQuery;
 
+    // If non-zero, the TEXT node feeds a sort on the text score with this limit, so it only has
+    // to produce the 'topK' highest scoring documents.
+    size_t topK = 0u;
+
     // The number of fields in the prefix of the text index. For example, if the key pattern is
     //
     //   { a: 1, b: 1, _fts: "text", _ftsx: 1, c: 1 }
@@ -729,6 +733,10 @@ struct SortNode : public QuerySolutionNode {
 
     // Sum of both limit and skip count in the parsed query.
     size_t limit;
+
+    // The number of leading fields of 'pattern' by which the child's results are already
+    // ordered, if any.
+    size_t sortedPrefixLength = 0;
 };
 
 struct LimitNode : public QuerySolutionNode {
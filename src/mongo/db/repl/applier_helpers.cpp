@@ -39,6 +39,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
@@ -51,9 +52,6 @@ namespace {
 // Must not create too large an object.
 const auto kInsertGroupMaxBatchSize = write_ops::insertVectorMaxBytes;
 
-// Limit number of ops in a single group.
-constexpr auto kInsertGroupMaxBatchCount = 64;
-
 }  // namespace
 
 // static
@@ -101,6 +99,8 @@ StatusWith<InsertGroup::ConstIterator> InsertGroup::groupAndApplyInserts(ConstIt
     size_t batchSize = entry.getObject().objsize();
     auto batchCount = OperationPtrs::size_type(1);
     auto batchNamespace = entry.getNss();
+    // Limit number of ops in a single group.
+    const auto maxBatchCount = OperationPtrs::size_type(replInsertGroupMaxOperations.load());
 
     /**
      * Search for the op that delimits this insert batch, and save its position
@@ -126,8 +126,7 @@ StatusWith<InsertGroup::ConstIterator> InsertGroup::groupAndApplyInserts(ConstIt
             return nextEntry->getOpType() != OpTypeEnum::kInsert  // Must be an insert.
                 || opNamespace != batchNamespace                  // Must be in the same namespace.
                 || batchSize > kInsertGroupMaxBatchSize  // Must not create too large an object.
-                ||
-                batchCount > kInsertGroupMaxBatchCount;  // Limit number of ops in a single group.
+                || batchCount > maxBatchCount;           // Limit number of ops in a single group.
         });
 
     // See if we were able to create a group that contains more than a single op.
@@ -406,18 +406,8 @@ void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryRes
         }
     }
 
-    // Start first collection cloner.
-    _currentCollectionClonerIter = _collectionCloners.begin();
-
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
-
-    Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-    if (!startStatus.isOK()) {
-        LOG(1) << "    failed to start collection cloning on "
-               << _currentCollectionClonerIter->getSourceNamespace() << ": " << redact(startStatus);
-        _finishCallback_inlock(lk, startStatus);
-        return;
-    }
+    _nextCollectionClonerIter = _collectionCloners.begin();
+    _startCollectionCloners_inlock(lk);
 }
 
 void DatabaseCloner::_collectionClonerCallback(const Status& status, const NamespaceString& nss) {
@@ -435,30 +425,59 @@ void DatabaseCloner::_collectionClonerCallback(const Status& status, const Names
     _collectionWork(collStatus, nss);
     lk.lock();
 
+    invariant(_activeCollectionCloners > 0);
+    --_activeCollectionCloners;
+
     // Failure to clone a collection will stop the database cloner from
     // cloning the rest of the collections in the listCollections result.
     if (!collStatus.isOK()) {
-        Status failStatus = {ErrorCodes::InitialSyncFailure, collStatus.toString()};
-        _finishCallback_inlock(lk, failStatus);
-        return;
+        _failCollectionCloners_inlock({ErrorCodes::InitialSyncFailure, collStatus.toString()});
+    } else {
+        ++_stats.clonedCollections;
     }
 
-    ++_stats.clonedCollections;
-    _currentCollectionClonerIter++;
+    _startCollectionCloners_inlock(lk);
+}
+
+void DatabaseCloner::_startCollectionCloners_inlock(UniqueLock& lk) {
+    const auto maxActiveCollectionCloners =
+        static_cast<std::size_t>(initialSyncMaxConcurrentCollectionCloners.load());
+
+    while (_collectionClonersStatus.isOK() &&
+           _activeCollectionCloners < maxActiveCollectionCloners &&
+           _nextCollectionClonerIter != _collectionCloners.end()) {
+        auto& collectionCloner = *_nextCollectionClonerIter++;
+
+        LOG(1) << "    cloning collection " << collectionCloner.getSourceNamespace();
 
-    if (_currentCollectionClonerIter != _collectionCloners.end()) {
-        Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
+        Status startStatus = _startCollectionCloner(collectionCloner);
         if (!startStatus.isOK()) {
             LOG(1) << "    failed to start collection cloning on "
-                   << _currentCollectionClonerIter->getSourceNamespace() << ": "
-                   << redact(startStatus);
-            _finishCallback_inlock(lk, startStatus);
-            return;
+                   << collectionCloner.getSourceNamespace() << ": " << redact(startStatus);
+            _failCollectionCloners_inlock(startStatus);
+            break;
         }
+        ++_activeCollectionCloners;
+    }
+
+    // Cloners that are still running report back through _collectionClonerCallback(), which
+    // calls this function again.
+    if (_activeCollectionCloners > 0) {
+        return;
+    }
+
+    _finishCallback_inlock(lk, _collectionClonersStatus);
+}
+
+void DatabaseCloner::_failCollectionCloners_inlock(const Status& status) {
+    if (!_collectionClonersStatus.isOK()) {
         return;
     }
+    _collectionClonersStatus = status;
 
-    _finishCallback_inlock(lk, Status::OK());
+    for (auto it = _collectionCloners.begin(); it != _nextCollectionClonerIter; ++it) {
+        it->shutdown();
+    }
 }
 
 void DatabaseCloner::_finishCallback(const Status& status) {
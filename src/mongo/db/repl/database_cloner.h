@@ -188,10 +188,23 @@ private:
 
     /**
      * Forwards collection cloner result to client.
-     * Starts a new cloner on a different collection.
+     * Starts new cloners on the collections that have not been cloned yet.
      */
     void _collectionClonerCallback(const Status& status, const NamespaceString& nss);
 
+    /**
+     * Starts collection cloners until 'initialSyncMaxConcurrentCollectionCloners' are active or
+     * every collection has been started. Reports completion once no cloner is active anymore.
+     * 'lk' may be unlocked on return.
+     */
+    void _startCollectionCloners_inlock(stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Records 'status' as the result of this database cloner and shuts down the collection cloners
+     * that were already started, so that no further collections are cloned.
+     */
+    void _failCollectionCloners_inlock(const Status& status);
+
     /**
      * Reports completion status.
      * Sets cloner to inactive.
@@ -234,8 +247,12 @@ private:
     // Holds all collection infos from listCollections.
     std::vector<BSONObj> _collectionInfos;                               // (M)
     std::vector<NamespaceString> _collectionNamespaces;                  // (M)
-    std::list<CollectionCloner> _collectionCloners;                      // (M)
-    std::list<CollectionCloner>::iterator _currentCollectionClonerIter;  // (M)
+    std::list<CollectionCloner> _collectionCloners;                   // (M)
+    std::list<CollectionCloner>::iterator _nextCollectionClonerIter;  // (M)
+    // Number of collection cloners that have been started and have not completed yet.
+    std::size_t _activeCollectionCloners = 0;  // (M)
+    // First error reported by a collection cloner. Returned once all active cloners complete.
+    Status _collectionClonersStatus = Status::OK();  // (M)
     ScheduleDbWorkFn
         _scheduleDbWorkFn;  // (RT) Function for scheduling database work using the executor.
     StartCollectionClonerFn _startCollectionCloner;  // (RT)
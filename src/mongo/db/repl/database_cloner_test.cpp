@@ -38,11 +38,13 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/base_cloner_test_fixture.h"
 #include "mongo/db/repl/database_cloner.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace {
@@ -789,6 +791,70 @@ TEST_F(DatabaseClonerTest, ShutdownCancelsCollectionCloning) {
     ASSERT_EQUALS(ErrorCodes::InitialSyncFailure, getStatus());
 }
 
+TEST_F(DatabaseClonerTest, StartsConcurrentCollectionClonersUpToLimit) {
+    const auto oldMaxCloners = initialSyncMaxConcurrentCollectionCloners.load();
+    initialSyncMaxConcurrentCollectionCloners.store(2);
+    ON_BLOCK_EXIT(
+        [oldMaxCloners] { initialSyncMaxConcurrentCollectionCloners.store(oldMaxCloners); });
+
+    ASSERT_OK(_databaseCloner->startup());
+    ASSERT_EQUALS(DatabaseCloner::State::kRunning, _databaseCloner->getState_forTest());
+
+    const std::vector<BSONObj> sourceInfos = {BSON("name"
+                                                   << "a"
+                                                   << "options"
+                                                   << _options1.toBSON()),
+                                              BSON("name"
+                                                   << "b"
+                                                   << "options"
+                                                   << _options2.toBSON()),
+                                              BSON("name"
+                                                   << "c"
+                                                   << "options"
+                                                   << _options3.toBSON())};
+    auto net = getNet();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(net);
+
+        assertRemoteCommandNameEquals(
+            "listCollections",
+            net->scheduleSuccessfulResponse(createListCollectionsResponse(
+                0, BSON_ARRAY(sourceInfos[0] << sourceInfos[1] << sourceInfos[2]))));
+        net->runReadyNetworkOperations();
+
+        // The first two collection cloners are started together and each sends a count request.
+        // Blackhole both requests to leave the collection cloners active.
+        for (const auto& uuid : {*_options1.uuid, *_options2.uuid}) {
+            ASSERT_TRUE(net->hasReadyRequests());
+            auto noi = net->getNextReadyRequest();
+            assertRemoteCommandNameEquals("count", noi->getRequest());
+            ASSERT_EQUALS(uuid, UUID::parse(noi->getRequest().cmdObj.firstElement()));
+            net->blackHole(noi);
+        }
+
+        // The third collection cloner waits for one of the others to complete.
+        ASSERT_FALSE(net->hasReadyRequests());
+    }
+
+    _databaseCloner->shutdown();
+
+    // Deliver cancellation event to cloners.
+    executor::NetworkInterfaceMock::InNetworkGuard(net)->runReadyNetworkOperations();
+
+    _databaseCloner->join();
+    ASSERT_FALSE(_databaseCloner->isActive());
+    ASSERT_EQUALS(DatabaseCloner::State::kComplete, _databaseCloner->getState_forTest());
+    ASSERT_EQUALS(ErrorCodes::InitialSyncFailure, getStatus());
+
+    // Both active collection cloners reported their result. The third one was never started.
+    ASSERT_NOT_EQUALS(ErrorCodes::NotYetInitialized,
+                      _collections[NamespaceString{"db.a"}].status.code());
+    ASSERT_NOT_EQUALS(ErrorCodes::NotYetInitialized,
+                      _collections[NamespaceString{"db.b"}].status.code());
+    ASSERT_EQUALS(ErrorCodes::NotYetInitialized,
+                  _collections[NamespaceString{"db.c"}].status.code());
+}
+
 TEST_F(DatabaseClonerTest, FirstCollectionListIndexesFailed) {
     ASSERT_EQUALS(DatabaseCloner::State::kPreStart, _databaseCloner->getState_forTest());
 
@@ -140,6 +140,10 @@ void NoopWriter::stopWritingPeriodicNoops() {
 }
 
 void NoopWriter::_writeNoop(OperationContext* opCtx) {
+    // Noop writes advance the optimes secondaries report, which flow control relies on to lift
+    // its throttling, so they must never wait for flow control themselves.
+    opCtx->lockState()->setShouldParticipateInFlowControl(false);
+
     // Use GlobalLock instead of DBLock to allow return when the lock is not available. It may
     // happen when the primary steps down and a shared global lock is acquired.
     Lock::GlobalLock lock(
@@ -193,6 +193,21 @@ public:
         size.increment(std::size_t(value.objsize()));
     }
 
+    /**
+     * Accounts for all operations in [begin, end) with a single update of each counter.
+     */
+    template <typename Iterator>
+    void incrementAll(Iterator begin, Iterator end) {
+        std::size_t totalSize = 0;
+        std::size_t totalCount = 0;
+        for (auto i = begin; i != end; ++i) {
+            totalSize += std::size_t(i->objsize());
+            ++totalCount;
+        }
+        count.increment(totalCount);
+        size.increment(totalSize);
+    }
+
     void decrement(const Value& value) {
         count.decrement(1);
         size.decrement(std::size_t(value.objsize()));
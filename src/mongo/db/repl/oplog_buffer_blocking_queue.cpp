@@ -80,9 +80,7 @@ void OplogBufferBlockingQueue::pushAllNonBlocking(OperationContext*,
                                                   Batch::const_iterator end) {
     _queue.pushAllNonBlocking(begin, end);
     if (_counters) {
-        for (auto i = begin; i != end; ++i) {
-            _counters->increment(*i);
-        }
+        _counters->incrementAll(begin, end);
     }
 }
 
@@ -110,6 +110,12 @@ public:
     // This member is not parsed from the BSON and is instead populated by fillWriterVectors.
     bool isForCappedCollection = false;
 
+    // This member is not parsed from the BSON and is instead populated by the ReplBatcher when the
+    // entry is added to a batch, which happens while the previous batch is still being applied.
+    // It caches the hash of the namespace so that fillWriterVectors does not have to compute it
+    // while holding the PBWM lock.
+    boost::optional<std::size_t> nsHash;
+
     /**
      * Returns if the oplog entry is for a command operation.
      */
@@ -76,6 +76,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_transactions_metrics.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/db/wait_event.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/executor/connection_pool_stats.h"
@@ -173,6 +174,18 @@ BSONObj incrementConfigVersionByRandom(BSONObj config) {
     return builder.obj();
 }
 
+/**
+ * Returns whether two waiters wait for the same write concern, not counting the timeout. Waiters
+ * without a write concern only wait for their opTime.
+ */
+bool isSameWriteConcernForWaiting(const WriteConcernOptions* lhs, const WriteConcernOptions* rhs) {
+    if (!lhs || !rhs) {
+        return lhs == rhs;
+    }
+    return lhs->syncMode == rhs->syncMode && lhs->wNumNodes == rhs->wNumNodes &&
+        lhs->wMode == rhs->wMode;
+}
+
 }  // namespace
 
 ReplicationCoordinatorImpl::Waiter::Waiter(OpTime _opTime, const WriteConcernOptions* _writeConcern)
@@ -243,56 +256,74 @@ private:
 };
 
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    // Writers usually wait for the latest opTime, so this almost always appends to the list.
+    auto it = std::upper_bound(
+        _list.begin(), _list.end(), waiter, [](WaiterType lhs, WaiterType rhs) {
+            return lhs->opTime < rhs->opTime;
+        });
+    _list.insert(it, waiter);
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalIf_inlock(
     stdx::function<bool(WaiterType)> func) {
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
-            // This element doesn't match, so we advance the iterator to the next one.
-            ++it;
+    // Write concerns for which a waiter did not satisfy the condition. Since the list is ordered by
+    // opTime, the remaining waiters with any of these write concerns cannot satisfy it either.
+    std::vector<const WriteConcernOptions*> unsatisfiedWriteConcerns;
+    auto isKnownUnsatisfied = [&](WaiterType waiter) {
+        return std::any_of(unsatisfiedWriteConcerns.begin(),
+                           unsatisfiedWriteConcerns.end(),
+                           [&](const WriteConcernOptions* writeConcern) {
+                               return isSameWriteConcernForWaiting(writeConcern,
+                                                                   waiter->writeConcern);
+                           });
+    };
+
+    for (std::size_t i = 0; i < _list.size();) {
+        WaiterType waiter = _list[i];
+        if (isKnownUnsatisfied(waiter)) {
+            ++i;
             continue;
         }
 
-        if (!(*it)->runs_once()) {
-            (*it)->notify_inlock();
-            // Keep the waiter on the list and let the guard remove it instead. Advance the
-            // iterator since we are skipping the removal.
-            ++it;
+        if (!func(waiter)) {
+            // This element doesn't match, so we advance to the next one.
+            unsatisfiedWriteConcerns.push_back(waiter->writeConcern);
+            ++i;
             continue;
         }
 
-        // Remove the waiter from the list if it was only meant to be notified once.
-        WaiterType waiter = std::move(*it);
-
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
-        } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+        if (!waiter->runs_once()) {
+            waiter->notify_inlock();
+            // Keep the waiter on the list and let the guard remove it instead. Advance to the next
+            // waiter since we are skipping the removal.
+            ++i;
+            continue;
         }
+
+        // Remove the waiter from the list if it was only meant to be notified once. The next
+        // waiter takes its position.
+        _list.erase(_list.begin() + i);
+
         // It's important to call notify() after the waiter has been removed from the list
         // since notify() might remove the waiter itself.
         waiter->notify_inlock();
     }
 }
 
-
 void ReplicationCoordinatorImpl::WaiterList::signalAll_inlock() {
     this->signalIf_inlock([](Waiter* waiter) { return true; });
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+    auto range = std::equal_range(
+        _list.begin(), _list.end(), waiter, [](WaiterType lhs, WaiterType rhs) {
+            return lhs->opTime < rhs->opTime;
+        });
+    auto it = std::find(range.first, range.second, waiter);
+    if (it == range.second) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
+    _list.erase(it);
     return true;
 }
 
@@ -1682,6 +1713,8 @@ Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
             Milliseconds{writeConcern.wTimeout};
     }();
 
+    WaitEventGuard waitEvent(opCtx, WaitEvent::kWriteConcern);
+
     // Must hold _mutex before constructing waitInfo as it will modify _replicationWaiterList
     stdx::condition_variable condVar;
     ThreadWaiter waiter(opTime, &writeConcern, &condVar);
@@ -577,12 +577,16 @@ private:
         void add_inlock(WaiterType waiter);
         // Returns whether waiter is found and removed.
         bool remove_inlock(WaiterType waiter);
-        // Signals all waiters that satisfy the condition.
+        // Signals all waiters that satisfy the condition. The condition must be monotonic in the
+        // waiter's opTime: if it does not hold for a waiter, it must not hold for any waiter with
+        // an equivalent write concern and a later opTime either. Such waiters are skipped without
+        // evaluating the condition.
         void signalIf_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals all waiters from the list.
         void signalAll_inlock();
 
     private:
+        // Ordered by opTime.
         std::vector<WaiterType> _list;
     };
 
@@ -281,6 +281,11 @@ public:
 
     void setMaster(bool isMaster);
 
+    /**
+     * Sets the return value for calls to getLastCommittedOpTime.
+     */
+    void setLastCommittedOpTime(const OpTime& opTime);
+
     virtual ServiceContext* getServiceContext() override {
         return _service;
     }
@@ -303,6 +308,7 @@ private:
     MemberState _memberState;
     OpTime _myLastDurableOpTime;
     OpTime _myLastAppliedOpTime;
+    OpTime _lastCommittedOpTime;
     ReplSetConfig _getConfigReturnValue;
     AwaitReplicationReturnValueFunction _awaitReplicationReturnValueFunction = [](const OpTime&) {
         return StatusAndDuration(Status::OK(), Milliseconds(0));
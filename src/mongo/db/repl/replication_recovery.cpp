@@ -59,11 +59,20 @@ namespace {
 const auto kRecoveryBatchLogLevel = logger::LogSeverity::Debug(2);
 const auto kRecoveryOperationLogLevel = logger::LogSeverity::Debug(3);
 
+// How often to report the progress of replaying the oplog during recovery.
+const Seconds kRecoveryProgressLogInterval(10);
+
 /**
- * Tracks and logs operations applied during recovery.
+ * Tracks and logs operations applied during recovery. Periodically logs how far replay has
+ * progressed through the oplog and an estimate of the time remaining, so that long recoveries,
+ * such as rollbacks after a long network partition, can be monitored.
  */
 class RecoveryOplogApplierStats : public OplogApplier::Observer {
 public:
+    RecoveryOplogApplierStats(const Timestamp& oplogApplicationStartPoint,
+                              const Timestamp& topOfOplog)
+        : _oplogApplicationStartPoint(oplogApplicationStartPoint), _topOfOplog(topOfOplog) {}
+
     void onBatchBegin(const OplogApplier::Operations& batch) final {
         _numBatches++;
         LOG_FOR_RECOVERY(kRecoveryBatchLogLevel)
@@ -85,7 +94,38 @@ public:
         }
     }
 
-    void onBatchEnd(const StatusWith<OpTime>&, const OplogApplier::Operations&) final {}
+    void onBatchEnd(const StatusWith<OpTime>& lastOpTimeApplied,
+                    const OplogApplier::Operations&) final {
+        if (!lastOpTimeApplied.isOK()) {
+            return;
+        }
+
+        const auto elapsed = Milliseconds(_timer.millis());
+        if (elapsed - _lastProgressLogged < kRecoveryProgressLogInterval) {
+            return;
+        }
+        _lastProgressLogged = elapsed;
+
+        // Estimate progress from the wall clock seconds of the oplog entries applied so far,
+        // relative to the range of the oplog being replayed.
+        const auto appliedThrough = lastOpTimeApplied.getValue().getTimestamp();
+        const double totalSecs = _topOfOplog.getSecs() - _oplogApplicationStartPoint.getSecs();
+        const double appliedSecs = appliedThrough.getSecs() - _oplogApplicationStartPoint.getSecs();
+        const double fractionApplied = totalSecs > 0 ? appliedSecs / totalSecs : 1.0;
+
+        StringBuilder estimate;
+        if (fractionApplied > 0 && fractionApplied < 1) {
+            const auto remaining = Milliseconds(
+                static_cast<long long>(elapsed.count() * (1 - fractionApplied) / fractionApplied));
+            estimate << ", estimated " << duration_cast<Seconds>(remaining) << " remaining";
+        }
+
+        log() << "Replication recovery applied " << _numOpsApplied << " operations in "
+              << _numBatches << " batches through " << appliedThrough.toBSON() << " in "
+              << duration_cast<Seconds>(elapsed) << ". Replaying up to " << _topOfOplog.toBSON()
+              << ", " << static_cast<int>(fractionApplied * 100) << "% done" << estimate.str();
+    }
+
     void onMissingDocumentsFetchedAndInserted(const std::vector<FetchInfo>&) final {}
 
     void complete(const OpTime& applyThroughOpTime) const {
@@ -95,8 +135,12 @@ public:
     }
 
 private:
+    const Timestamp _oplogApplicationStartPoint;
+    const Timestamp _topOfOplog;
     std::size_t _numBatches = 0;
     std::size_t _numOpsApplied = 0;
+    Timer _timer;
+    Milliseconds _lastProgressLogged{0};
 };
 
 /**
@@ -410,7 +454,7 @@ void ReplicationRecoveryImpl::_applyToEndOfOplog(OperationContext* opCtx,
     OplogBufferLocalOplog oplogBuffer(oplogApplicationStartPoint);
     oplogBuffer.startup(opCtx);
 
-    RecoveryOplogApplierStats stats;
+    RecoveryOplogApplierStats stats(oplogApplicationStartPoint, topOfOplog);
 
     auto writerPool = OplogApplier::makeWriterPool();
     OplogApplier::Options options;
@@ -34,6 +34,7 @@
 #include "mongo/db/repl/sync_tail.h"
 
 #include "third_party/murmurhash3/MurmurHash3.h"
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 #include <memory>
 
@@ -96,6 +97,12 @@ Counter64 oplogApplicationBatchSize;
 ServerStatusMetricField<Counter64> displayOplogApplicationBatchSize("repl.apply.batchSize",
                                                                     &oplogApplicationBatchSize);
 
+// Tracks the number of operations given to the busiest writer thread, summed over all batches.
+// Compared to 'repl.apply.batchSize', this shows how evenly batches are spread over the writers.
+Counter64 oplogApplicationMaxWriterOps;
+ServerStatusMetricField<Counter64> displayOplogApplicationMaxWriterOps(
+    "repl.apply.maxWriterOps", &oplogApplicationMaxWriterOps);
+
 // Number of times we tried to go live as a secondary.
 Counter64 attemptsToBecomeSecondary;
 ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
@@ -298,12 +305,8 @@ Status SyncTail::syncApply(OperationContext* opCtx,
         // wants to. We should ignore these errors intelligently while in RECOVERING and STARTUP
         // mode (similar to initial sync) instead so we do not accidentally ignore real errors.
         bool shouldAlwaysUpsert = (oplogApplicationMode != OplogApplication::Mode::kInitialSync);
-        Status status = applyOperation_inlock(
+        return applyOperation_inlock(
             opCtx, db, op, shouldAlwaysUpsert, oplogApplicationMode, incrementOpsAppliedStats);
-        if (!status.isOK() && status.code() == ErrorCodes::WriteConflict) {
-            throw WriteConflictException();
-        }
-        return status;
     };
 
     auto clockSource = opCtx->getServiceContext()->getFastClockSource();
@@ -328,8 +331,14 @@ Status SyncTail::syncApply(OperationContext* opCtx,
         }
         Lock::DBLock dbLock(opCtx, nss.db(), MODE_X);
         OldClientContext ctx(opCtx, nss.ns());
-        return finishApply(applyOp(ctx.db()));
+        Status status = applyOp(ctx.db());
+        if (status == ErrorCodes::WriteConflict) {
+            throw WriteConflictException();
+        }
+        return finishApply(status);
     } else if (OplogEntry::isCrudOpType(opType)) {
+        // A WriteConflict status returned by applyOp is retried by writeConflictRetry without
+        // throwing.
         return finishApply(writeConflictRetry(opCtx, "syncApply_CRUD", nss.ns(), [&] {
             // Need to throw instead of returning a status for it to be properly ignored.
             try {
@@ -1168,7 +1177,8 @@ Status multiSyncApply(OperationContext* opCtx,
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
- * writerVectors - Set of operations for each worker thread to apply.
+ * writerVectors - Buckets of operations, which are later assigned to worker threads. Operations
+ *      that must be applied in order are always placed in the same bucket.
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
@@ -1193,7 +1203,11 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
             continue;
         }
 
-        auto hashedNs = StringMapHasher().hashed_key(op.getNss().ns());
+        // Entries coming from the batcher already carry their namespace hash. Derived operations,
+        // such as those extracted from applyOps, are hashed here.
+        const auto& ns = op.getNss().ns();
+        auto hashedNs = op.nsHash ? StringMapHashedKey(ns, *op.nsHash)
+                                  : StringMapHasher().hashed_key(ns);
         // Reduce the hash from 64bit down to 32bit, just to allow combinations with murmur3 later
         // on. Bit depth not important, we end up just doing integer modulo with this in the end.
         // The hash function should provide entropy in the lower bits as it's used in hash tables.
@@ -1271,6 +1285,45 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
     }
 }
 
+namespace {
+
+// Operations are first hashed into this many buckets per writer thread, and the buckets are then
+// assigned to writers. Operations that must be applied in order always hash to the same bucket, so
+// any assignment of whole buckets to writers preserves the required ordering.
+const size_t kWriterBucketsPerThread = 16;
+
+/**
+ * Distributes 'buckets' over 'numWriters' writer vectors by handing the largest remaining bucket
+ * to the writer with the fewest operations so far. Unlike a plain 'hash % numWriters', this keeps
+ * busy buckets that happen to collide from piling up on one writer while the others sit idle.
+ */
+std::vector<MultiApplier::OperationPtrs> balanceWriterBuckets(
+    std::vector<MultiApplier::OperationPtrs>* buckets, size_t numWriters) {
+    std::sort(buckets->begin(), buckets->end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.size() > rhs.size();
+    });
+
+    std::vector<MultiApplier::OperationPtrs> writerVectors(numWriters);
+    for (auto&& bucket : *buckets) {
+        if (bucket.empty()) {
+            break;  // Buckets are sorted by size, so the rest are empty as well.
+        }
+
+        auto writer = std::min_element(
+            writerVectors.begin(), writerVectors.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.size() < rhs.size();
+            });
+        if (writer->empty()) {
+            writer->swap(bucket);
+        } else {
+            writer->insert(writer->end(), bucket.begin(), bucket.end());
+        }
+    }
+    return writerVectors;
+}
+
+}  // namespace
+
 void SyncTail::_applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
                          std::vector<Status>* statusVector,
                          std::vector<WorkerMultikeyPathInfo>* workerMultikeyPathInfo) {
@@ -1334,8 +1387,17 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         //   and create a pseudo oplog.
         std::vector<MultiApplier::Operations> derivedOps;
 
-        std::vector<MultiApplier::OperationPtrs> writerVectors(_writerPool->getStats().numThreads);
-        _fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        const size_t numWriters = _writerPool->getStats().numThreads;
+        std::vector<MultiApplier::OperationPtrs> writerBuckets(numWriters *
+                                                               kWriterBucketsPerThread);
+        _fillWriterVectors(opCtx, &ops, &writerBuckets, &derivedOps);
+        auto writerVectors = balanceWriterBuckets(&writerBuckets, numWriters);
+
+        size_t maxWriterOps = 0;
+        for (const auto& writer : writerVectors) {
+            maxWriterOps = std::max(maxWriterOps, writer.size());
+        }
+        oplogApplicationMaxWriterOps.increment(maxWriterOps);
 
         // Wait for writes to finish before applying ops.
         _writerPool->waitForIdle();
@@ -1387,19 +1449,26 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         }
     }
 
+    // Writers that made the same index multikey each tracked it separately. Merge their paths so
+    // that every index is only set as multikey once per batch.
+    WorkerMultikeyPathInfo batchMultikeyPathInfo;
+    for (auto&& infoVector : multikeyVector) {
+        for (auto&& info : infoVector) {
+            MultikeyPathTracker::mergeMultikeyPathInfo(&batchMultikeyPathInfo, std::move(info));
+        }
+    }
+
     Timestamp firstTimeInBatch = ops.front().getTimestamp();
     // Set any indexes to multikey that this batch ignored. This must be done while holding the
     // parallel batch writer mutex.
-    for (WorkerMultikeyPathInfo infoVector : multikeyVector) {
-        for (MultikeyPathInfo info : infoVector) {
-            // We timestamp every multikey write with the first timestamp in the batch. It is always
-            // safe to set an index as multikey too early, just not too late. We conservatively pick
-            // the first timestamp in the batch since we do not have enough information to find out
-            // the timestamp of the first write that set the given multikey path.
-            fassert(50686,
-                    _storageInterface->setIndexIsMultikey(
-                        opCtx, info.nss, info.indexName, info.multikeyPaths, firstTimeInBatch));
-        }
+    for (const MultikeyPathInfo& info : batchMultikeyPathInfo) {
+        // We timestamp every multikey write with the first timestamp in the batch. It is always
+        // safe to set an index as multikey too early, just not too late. We conservatively pick
+        // the first timestamp in the batch since we do not have enough information to find out
+        // the timestamp of the first write that set the given multikey path.
+        fassert(50686,
+                _storageInterface->setIndexIsMultikey(
+                    opCtx, info.nss, info.indexName, info.multikeyPaths, firstTimeInBatch));
     }
 
     // We have now written all database writes and updated the oplog to match.
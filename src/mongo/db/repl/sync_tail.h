@@ -45,6 +45,7 @@
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -158,6 +159,9 @@ public:
             invariant(!_mustShutdown);
             _bytes += obj.objsize();
             _batch.emplace_back(std::move(obj));
+
+            auto& entry = _batch.back();
+            entry.nsHash = StringMapHasher()(entry.getNss().ns());
         }
         void pop_back() {
             _bytes -= back().getRawObjSizeBytes();
@@ -57,6 +57,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_interface_local.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/replication_process.h"
@@ -750,6 +751,38 @@ TEST_F(SyncTailTest, MultiSyncApplyLimitsBatchCountWhenGroupingInsertOperation)
     ASSERT_BSONOBJ_EQ(insertOps.back().getObject(), singleInsertDocumentGroup[0]);
 }
 
+TEST_F(SyncTailTest, MultiSyncApplyLimitsBatchCountToInsertGroupMaxOperationsParameter) {
+    const auto originalMaxOperations = replInsertGroupMaxOperations.load();
+    ON_BLOCK_EXIT([&] { replInsertGroupMaxOperations.store(originalMaxOperations); });
+    replInsertGroupMaxOperations.store(3);
+
+    int seconds = 1;
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto createOp = makeCreateCollectionOplogEntry({Timestamp(Seconds(seconds++), 0), 1LL}, nss);
+
+    MultiApplier::Operations operationsToApply;
+    operationsToApply.push_back(createOp);
+    for (int i = 0; i < 7; ++i) {
+        operationsToApply.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(seconds), 0), 1LL}, nss, BSON("_id" << seconds++)));
+    }
+
+    // Each element in 'docsInserted' is a grouped insert operation.
+    std::vector<std::vector<BSONObj>> docsInserted;
+    _opObserver->onInsertsFn =
+        [&](OperationContext*, const NamespaceString& nss, const std::vector<BSONObj>& docs) {
+            docsInserted.push_back(docs);
+        };
+
+    ASSERT_OK(runOpsSteadyState(operationsToApply));
+
+    // The seven inserts should be applied as groups of 3, 3 and 1.
+    ASSERT_EQUALS(3U, docsInserted.size());
+    ASSERT_EQUALS(3U, docsInserted[0].size());
+    ASSERT_EQUALS(3U, docsInserted[1].size());
+    ASSERT_EQUALS(1U, docsInserted[2].size());
+}
+
 // Create an 'insert' oplog operation of an approximate size in bytes. The '_id' of the oplog entry
 // and its optime in seconds are given by the 'id' argument.
 OplogEntry makeSizedInsertOp(const NamespaceString& nss, int size, int id) {
@@ -38,6 +38,7 @@
 #include "mongo/db/repl/topology_coordinator.h"
 #include "mongo/db/repl/topology_coordinator_gen.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -2367,6 +2368,7 @@ bool TopologyCoordinator::updateLastCommittedOpTime() {
     const bool useDurableOpTime = _rsConfig.getWriteConcernMajorityShouldJournal();
 
     std::vector<OpTime> votingNodesOpTimes;
+    votingNodesOpTimes.reserve(_memberData.size());
     for (const auto& memberData : _memberData) {
         int memberIndex = memberData.getConfigIndex();
         invariant(memberIndex >= 0);
@@ -2382,12 +2384,13 @@ bool TopologyCoordinator::updateLastCommittedOpTime() {
     if (votingNodesOpTimes.size() < static_cast<unsigned long>(_rsConfig.getWriteMajority())) {
         return false;
     }
-    std::sort(votingNodesOpTimes.begin(), votingNodesOpTimes.end());
 
-    // need the majority to have this OpTime
-    OpTime committedOpTime =
-        votingNodesOpTimes[votingNodesOpTimes.size() - _rsConfig.getWriteMajority()];
-    return advanceLastCommittedOpTime(committedOpTime);
+    // need the majority to have this OpTime. Only the OpTime at that position matters, so select
+    // it in linear time rather than sorting every voting member's OpTime.
+    const auto committedOpTimeIt =
+        votingNodesOpTimes.begin() + (votingNodesOpTimes.size() - _rsConfig.getWriteMajority());
+    std::nth_element(votingNodesOpTimes.begin(), committedOpTimeIt, votingNodesOpTimes.end());
+    return advanceLastCommittedOpTime(*committedOpTimeIt);
 }
 
 bool TopologyCoordinator::advanceLastCommittedOpTime(const OpTime& committedOpTime) {
@@ -38,6 +38,8 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/s/balancer/balancer_policy_gen.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_tags.h"
@@ -256,6 +258,7 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
 
     MigrateInfoVector candidateChunks;
     std::set<ShardId> usedShards;
+    int loadMigrationsLeft = balancerMaxLoadMigrationsPerRound.load();
 
     std::shuffle(collections.begin(), collections.end(), _random);
 
@@ -271,8 +274,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
             continue;
         }
 
-        auto candidatesStatus =
-            _getMigrateCandidatesForCollection(opCtx, nss, shardStats, &usedShards);
+        auto candidatesStatus = _getMigrateCandidatesForCollection(
+            opCtx, nss, shardStats, &usedShards, &loadMigrationsLeft);
         if (candidatesStatus == ErrorCodes::NamespaceNotFound) {
             // Namespace got dropped before we managed to get to it, so just skip it
             continue;
@@ -414,7 +417,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
     OperationContext* opCtx,
     const NamespaceString& nss,
     const ShardStatisticsVector& shardStats,
-    std::set<ShardId>* usedShards) {
+    std::set<ShardId>* usedShards,
+    int* loadMigrationsLeft) {
     auto routingInfoStatus =
         Grid::get(opCtx)->catalogCache()->getShardedCollectionRoutingInfoWithRefresh(opCtx, nss);
     if (!routingInfoStatus.isOK()) {
@@ -425,12 +429,12 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
 
     const auto& shardKeyPattern = cm->getShardKeyPattern().getKeyPattern();
 
-    const auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
+    auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
     if (!collInfoStatus.isOK()) {
         return collInfoStatus.getStatus();
     }
 
-    const DistributionStatus& distribution = collInfoStatus.getValue();
+    DistributionStatus& distribution = collInfoStatus.getValue();
 
     for (const auto& tagRangeEntry : distribution.tagRanges()) {
         const auto& tagRange = tagRangeEntry.second;
@@ -471,7 +475,40 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
-    return BalancerPolicy::balance(shardStats, distribution, usedShards);
+    auto migrations =
+        BalancerPolicy::balance(shardStats, distribution, usedShards, loadMigrationsLeft);
+
+    // Select the migrations which will follow the ones above on the same shards, as if those had
+    // completed. The migration manager starts each of them as soon as its shards are done with the
+    // preceding migrations, rather than waiting for the next round.
+    const int maxMigrationsPerShard = balancerMaxMigrationsPerShardPerRound.load();
+    SimpleBSONObjSet movedChunks;
+    size_t previousStageBegin = 0;
+
+    for (int stage = 1; stage < maxMigrationsPerShard; stage++) {
+        const size_t stageBegin = migrations.size();
+        for (size_t i = previousStageBegin; i < stageBegin; i++) {
+            distribution.applyMigration(migrations[i]);
+            movedChunks.insert(migrations[i].minKey);
+        }
+
+        std::set<ShardId> stageUsedShards;
+        auto stageMigrations = BalancerPolicy::balance(shardStats, distribution, &stageUsedShards);
+        for (auto& migration : stageMigrations) {
+            // Each chunk is moved at most once per round
+            if (movedChunks.count(migration.minKey))
+                continue;
+
+            migrations.push_back(std::move(migration));
+        }
+
+        if (migrations.size() == stageBegin)
+            break;
+
+        previousStageBegin = stageBegin;
+    }
+
+    return migrations;
 }
 
 }  // namespace mongo
@@ -33,6 +33,9 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include <algorithm>
+
+#include "mongo/db/s/balancer/balancer_policy_gen.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -52,6 +55,18 @@ namespace {
 // optimal average across all shards for a zone for a rebalancing migration to be initiated.
 const size_t kDefaultImbalanceThreshold = 1;
 
+const ClusterStatistics::ShardStatistics::CollectionLoad kIdleCollectionLoad;
+
+/**
+ * Returns the load the specified shard reported for the collection, which is idle if the shard did
+ * not report any.
+ */
+const ClusterStatistics::ShardStatistics::CollectionLoad& getCollectionLoad(
+    const ClusterStatistics::ShardStatistics& stat, const NamespaceString& nss) {
+    auto it = stat.collectionLoads.find(nss.ns());
+    return it == stat.collectionLoads.end() ? kIdleCollectionLoad : it->second;
+}
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -106,6 +121,21 @@ const vector<ChunkType>& DistributionStatus::getChunks(const ShardId& shardId) c
     return i->second;
 }
 
+void DistributionStatus::applyMigration(const MigrateInfo& migrateInfo) {
+    auto& fromChunks = _shardChunks[migrateInfo.from];
+
+    auto it = std::find_if(fromChunks.begin(), fromChunks.end(), [&](const ChunkType& chunk) {
+        return !chunk.getMin().woCompare(migrateInfo.minKey);
+    });
+    invariant(it != fromChunks.end());
+
+    ChunkType chunk = std::move(*it);
+    fromChunks.erase(it);
+
+    chunk.setShard(migrateInfo.to);
+    _shardChunks[migrateInfo.to].push_back(std::move(chunk));
+}
+
 Status DistributionStatus::addRangeToZone(const ZoneRange& range) {
     const auto minIntersect = _zoneRanges.upper_bound(range.min);
     const auto maxIntersect = _zoneRanges.upper_bound(range.max);
@@ -290,7 +320,8 @@ ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& sha
 
 vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
-                                            std::set<ShardId>* usedShards) {
+                                            std::set<ShardId>* usedShards,
+                                            int* loadMigrationsLeft) {
     vector<MigrateInfo> migrations;
 
     // 1) Check for shards, which are in draining mode
@@ -428,6 +459,12 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             ;
     }
 
+    // 4) If the chunks are balanced, even out the load of the shards
+    if (migrations.empty() && loadMigrationsLeft && *loadMigrationsLeft > 0 &&
+        _loadBalance(shardStats, distribution, &migrations, usedShards)) {
+        --*loadMigrationsLeft;
+    }
+
     return migrations;
 }
 
@@ -491,6 +528,15 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
 
     const vector<ChunkType>& chunks = distribution.getChunks(from);
 
+    // The hottest chunk of the donor is only moved if there is no other chunk to move, so that a
+    // chunk moved to even out the load is not moved right back
+    const auto fromStat =
+        std::find_if(shardStats.begin(), shardStats.end(), [&](const auto& stat) {
+            return stat.shardId == from;
+        });
+    const auto& fromLoad = getCollectionLoad(*fromStat, distribution.nss());
+    const ChunkType* hotChunk = nullptr;
+
     unsigned numJumboChunks = 0;
 
     for (const auto& chunk : chunks) {
@@ -502,12 +548,24 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
             continue;
         }
 
+        if (fromLoad.hotChunkOperations && !chunk.getMin().woCompare(fromLoad.hotChunkMin)) {
+            hotChunk = &chunk;
+            continue;
+        }
+
         migrations->emplace_back(to, chunk);
         invariant(usedShards->insert(chunk.getShard()).second);
         invariant(usedShards->insert(to).second);
         return true;
     }
 
+    if (hotChunk) {
+        migrations->emplace_back(to, *hotChunk);
+        invariant(usedShards->insert(from).second);
+        invariant(usedShards->insert(to).second);
+        return true;
+    }
+
     if (numJumboChunks) {
         warning() << "Shard: " << from << ", collection: " << distribution.nss().ns()
                   << " has only jumbo chunks for zone \'" << tag
@@ -517,6 +575,89 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_loadBalance(const ShardStatisticsVector& shardStats,
+                                  const DistributionStatus& distribution,
+                                  vector<MigrateInfo>* migrations,
+                                  set<ShardId>* usedShards) {
+    const int imbalancePercent = balancerLoadImbalancePercent.load();
+    if (imbalancePercent <= 0)
+        return false;
+
+    const auto& nss = distribution.nss();
+
+    const ClusterStatistics::ShardStatistics* donor = nullptr;
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        const uint64_t operations = getCollectionLoad(stat, nss).operations;
+        if (!donor || operations > getCollectionLoad(*donor, nss).operations) {
+            donor = &stat;
+        }
+    }
+
+    if (!donor)
+        return false;
+
+    const auto& donorLoad = getCollectionLoad(*donor, nss);
+    if (!donorLoad.hotChunkOperations ||
+        donorLoad.operations < static_cast<uint64_t>(balancerLoadMinOperations.load()))
+        return false;
+
+    // The hottest chunk may not be found if the shard reported it based on a different version of
+    // the routing table
+    const vector<ChunkType>& chunks = distribution.getChunks(donor->shardId);
+    const auto hotChunk = std::find_if(chunks.begin(), chunks.end(), [&](const auto& chunk) {
+        return !chunk.getMin().woCompare(donorLoad.hotChunkMin);
+    });
+    if (hotChunk == chunks.end() || hotChunk->getJumbo())
+        return false;
+
+    const string tag = distribution.getTagForChunk(*hotChunk);
+
+    const ClusterStatistics::ShardStatistics* receiver = nullptr;
+    for (const auto& stat : shardStats) {
+        if (stat.shardId == donor->shardId || usedShards->count(stat.shardId))
+            continue;
+
+        if (!isShardSuitableReceiver(stat, tag).isOK())
+            continue;
+
+        const uint64_t operations = getCollectionLoad(stat, nss).operations;
+        if (!receiver || operations < getCollectionLoad(*receiver, nss).operations) {
+            receiver = &stat;
+        }
+    }
+
+    if (!receiver)
+        return false;
+
+    const uint64_t receiverOperations = getCollectionLoad(*receiver, nss).operations;
+
+    LOG(1) << "collection : " << nss.ns();
+    LOG(1) << "donor      : " << donor->shardId << " operations " << donorLoad.operations;
+    LOG(1) << "receiver   : " << receiver->shardId << " operations " << receiverOperations;
+    LOG(1) << "hot chunk  : " << redact(hotChunk->toString()) << " operations "
+           << donorLoad.hotChunkOperations;
+
+    // Check whether it is necessary to balance the load
+    if (donorLoad.operations * 100 <= receiverOperations * (100 + imbalancePercent))
+        return false;
+
+    // Moving a chunk which carries most of the load would only make the receiver the most loaded
+    // shard. Such a chunk needs to be split first.
+    if (receiverOperations + donorLoad.hotChunkOperations >= donorLoad.operations) {
+        LOG(1) << "Chunk " << redact(hotChunk->toString())
+               << " carries too much of the load of shard " << donor->shardId << " to be moved";
+        return false;
+    }
+
+    migrations->emplace_back(receiver->shardId, *hotChunk);
+    invariant(usedShards->insert(donor->shardId).second);
+    invariant(usedShards->insert(receiver->shardId).second);
+    return true;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
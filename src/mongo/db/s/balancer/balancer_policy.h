@@ -121,6 +121,12 @@ public:
      */
     const std::vector<ChunkType>& getChunks(const ShardId& shardId) const;
 
+    /**
+     * Moves the chunk of the specified migration to its recipient shard, as if the migration had
+     * completed. The chunk is placed last among the chunks of the recipient.
+     */
+    void applyMigration(const MigrateInfo& migrateInfo);
+
     /**
      * Returns all tag ranges defined for the collection.
      */
@@ -185,10 +191,17 @@ public:
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
      * shard.
+     *
+     * If the chunks of the collection are balanced and balancing by load is enabled, suggests
+     * moving the hottest chunk of the most loaded shard to the least loaded one, as reported in
+     * the shards' collection loads. The loadMigrationsLeft parameter is in/out and bounds the
+     * number of such migrations across all the collections of a round. If it is null, the
+     * collection is not balanced by load.
      */
     static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
-                                            std::set<ShardId>* usedShards);
+                                            std::set<ShardId>* usedShards,
+                                            int* loadMigrationsLeft = nullptr);
 
     /**
      * Using the specified distribution information, returns a suggested better location for the
@@ -235,6 +248,18 @@ private:
                                    size_t idealNumberOfChunksPerShardForTag,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Selects the hottest chunk of the shard with the most load on the collection to be moved to
+     * the shard with the least load, if the difference between their loads exceeds the
+     * 'balancerLoadImbalancePercent' server parameter and moving the chunk makes it smaller.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _loadBalance(const ShardStatisticsVector& shardStats,
+                             const DistributionStatus& distribution,
+                             std::vector<MigrateInfo>* migrations,
+                             std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
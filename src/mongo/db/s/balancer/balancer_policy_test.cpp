@@ -33,10 +33,12 @@
 
 #include "mongo/db/keypattern.h"
 #include "mongo/db/s/balancer/balancer_policy.h"
+#include "mongo/db/s/balancer/balancer_policy_gen.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -609,6 +611,125 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+/**
+ * Sets the load the specified shard reports for the test collection.
+ */
+void setCollectionLoad(ShardStatistics* stat,
+                       uint64_t operations,
+                       const BSONObj& hotChunkMin,
+                       uint64_t hotChunkOperations) {
+    auto& load = stat->collectionLoads[kNamespace.ns()];
+    load.operations = operations;
+    load.hotChunkMin = hotChunkMin;
+    load.hotChunkOperations = hotChunkOperations;
+}
+
+TEST(BalancerPolicy, BalancedClusterMovesHotChunkToLeastLoadedShard) {
+    const auto origImbalancePercent = balancerLoadImbalancePercent.load();
+    balancerLoadImbalancePercent.store(50);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalancePercent.store(origImbalancePercent); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId2, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+    setCollectionLoad(&cluster.first[0], 20000, cluster.second[kShardId0][1].getMin(), 8000);
+    setCollectionLoad(&cluster.first[1], 1000, cluster.second[kShardId1][0].getMin(), 1000);
+    setCollectionLoad(&cluster.first[2], 5000, cluster.second[kShardId2][0].getMin(), 5000);
+
+    std::set<ShardId> usedShards;
+    int loadMigrationsLeft = 1;
+    const auto migrations(BalancerPolicy::balance(cluster.first,
+                                                  DistributionStatus(kNamespace, cluster.second),
+                                                  &usedShards,
+                                                  &loadMigrationsLeft));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migrations[0].minKey);
+    ASSERT_EQ(0, loadMigrationsLeft);
+
+    // The budget of load migrations is spent, so the next collection is not balanced by load
+    usedShards.clear();
+    ASSERT(BalancerPolicy::balance(cluster.first,
+                                   DistributionStatus(kNamespace, cluster.second),
+                                   &usedShards,
+                                   &loadMigrationsLeft)
+               .empty());
+}
+
+TEST(BalancerPolicy, BalancingByLoadIsDisabledByDefault) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+    setCollectionLoad(&cluster.first[0], 20000, cluster.second[kShardId0][1].getMin(), 8000);
+
+    std::set<ShardId> usedShards;
+    int loadMigrationsLeft = 1;
+    ASSERT(BalancerPolicy::balance(cluster.first,
+                                   DistributionStatus(kNamespace, cluster.second),
+                                   &usedShards,
+                                   &loadMigrationsLeft)
+               .empty());
+}
+
+TEST(BalancerPolicy, HotChunkCarryingMostOfTheLoadIsNotMoved) {
+    const auto origImbalancePercent = balancerLoadImbalancePercent.load();
+    balancerLoadImbalancePercent.store(50);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalancePercent.store(origImbalancePercent); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+    setCollectionLoad(&cluster.first[0], 20000, cluster.second[kShardId0][1].getMin(), 15000);
+    setCollectionLoad(&cluster.first[1], 6000, cluster.second[kShardId1][0].getMin(), 6000);
+
+    std::set<ShardId> usedShards;
+    int loadMigrationsLeft = 1;
+    ASSERT(BalancerPolicy::balance(cluster.first,
+                                   DistributionStatus(kNamespace, cluster.second),
+                                   &usedShards,
+                                   &loadMigrationsLeft)
+               .empty());
+    ASSERT_EQ(1, loadMigrationsLeft);
+}
+
+TEST(BalancerPolicy, BalancingByChunkCountPrefersNotToMoveHotChunk) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+    setCollectionLoad(&cluster.first[0], 20000, cluster.second[kShardId0][0].getMin(), 8000);
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migrations[0].minKey);
+}
+
+TEST(DistributionStatus, ApplyMigrationMovesChunkLastOnRecipient) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId1, kNoMaxSize, 1, false, emptyTagSet, emptyShardVersion), 1}});
+    const ChunkType movedChunk = cluster.second[kShardId0][0];
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    distribution.applyMigration(MigrateInfo(kShardId1, movedChunk));
+
+    ASSERT_EQ(4U, distribution.numberOfChunksInShard(kShardId0));
+    ASSERT_EQ(2U, distribution.numberOfChunksInShard(kShardId1));
+    ASSERT_BSONOBJ_EQ(movedChunk.getMin(), distribution.getChunks(kShardId1)[1].getMin());
+    ASSERT_EQ(kShardId1, distribution.getChunks(kShardId1)[1].getShard());
+
+    // The donor still has more chunks than the recipient, so the policy selects its next chunk
+    const auto migrations(balanceChunks(cluster.first, distribution, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migrations[0].minKey);
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -29,17 +29,18 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/s/client/shard.h"
 
 namespace mongo {
 
-class BSONObj;
 class OperationContext;
 template <typename T>
 class StatusWith;
@@ -58,6 +59,18 @@ public:
      */
     struct ShardStatistics {
     public:
+        /**
+         * The load a shard reported for one of its sharded collections, counted in documents read
+         * or written since the previous report.
+         */
+        struct CollectionLoad {
+            uint64_t operations{0};
+
+            // The minimum key of the chunk, which saw the most operations, and their number
+            BSONObj hotChunkMin;
+            uint64_t hotChunkOperations{0};
+        };
+
         ShardStatistics(ShardId shardId,
                         uint64_t maxSizeMB,
                         uint64_t currSizeMB,
@@ -93,6 +106,9 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Load of the sharded collections, which had any reads or writes, keyed by namespace
+        std::map<std::string, CollectionLoad> collectionLoads;
     };
 
     virtual ~ClusterStatistics();
@@ -46,19 +46,23 @@
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
+
+using ShardStatistics = ClusterStatistics::ShardStatistics;
+
 namespace {
 
 const char kVersionField[] = "version";
+const char kShardingStatisticsField[] = "shardingStatistics";
+const char kCollectionLoadField[] = "collectionLoad";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard, asking it to also report the
+ * load of its sharded collections.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -66,12 +70,13 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
     }
     auto shard = shardStatus.getValue();
 
-    auto commandResponse =
-        shard->runCommandWithFixedRetryAttempts(opCtx,
-                                                ReadPreferenceSetting{ReadPreference::PrimaryOnly},
-                                                "admin",
-                                                BSON("serverStatus" << 1),
-                                                Shard::RetryPolicy::kIdempotent);
+    auto commandResponse = shard->runCommandWithFixedRetryAttempts(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        "admin",
+        BSON("serverStatus" << 1 << kShardingStatisticsField
+                            << BSON(kCollectionLoadField << true)),
+        Shard::RetryPolicy::kIdempotent);
     if (!commandResponse.isOK()) {
         return commandResponse.getStatus();
     }
@@ -79,21 +84,43 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
+/**
+ * Extracts the load of each sharded collection from a shard's serverStatus response.
+ */
+std::map<std::string, ShardStatistics::CollectionLoad> parseCollectionLoads(
+    const BSONObj& serverStatus) {
+    std::map<std::string, ShardStatistics::CollectionLoad> collectionLoads;
+
+    const auto collectionLoadElem =
+        serverStatus[kShardingStatisticsField][kCollectionLoadField];
+    if (collectionLoadElem.type() != Object) {
+        return collectionLoads;
     }
 
-    return version;
+    for (const auto& collElem : collectionLoadElem.Obj()) {
+        if (collElem.type() != Object)
+            continue;
+
+        const BSONObj coll = collElem.Obj();
+        if (coll["hotChunkMin"].type() != Object)
+            continue;
+
+        ShardStatistics::CollectionLoad load;
+        load.operations = coll["operations"].safeNumberLong();
+        load.hotChunkMin = coll["hotChunkMin"].Obj().getOwned();
+        load.hotChunkOperations = coll["hotChunkOperations"].safeNumberLong();
+
+        collectionLoads.emplace(collElem.fieldName(), std::move(load));
+    }
+
+    return collectionLoads;
 }
 
 }  // namespace
 
-using ShardStatistics = ClusterStatistics::ShardStatistics;
-
 ClusterStatisticsImpl::ClusterStatisticsImpl(BalancerRandomSource& random) : _random(random) {}
 
 ClusterStatisticsImpl::~ClusterStatisticsImpl() = default;
@@ -134,15 +161,27 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        std::map<std::string, ShardStatistics::CollectionLoad> collectionLoads;
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
-        } else {
+        auto serverStatusStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        auto mongoDVersionStatus = [&]() -> Status {
+            if (!serverStatusStatus.isOK()) {
+                return serverStatusStatus.getStatus();
+            }
+            return bsonExtractStringField(
+                serverStatusStatus.getValue(), kVersionField, &mongoDVersion);
+        }();
+        if (!mongoDVersionStatus.isOK()) {
             // Since the mongod version is only used for reporting, there is no need to fail the
             // entire round if it cannot be retrieved, so just leave it empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(mongoDVersionStatus);
+        }
+
+        // Likewise, the load is only used to even out the load of shards which are otherwise
+        // balanced, so a shard which cannot be asked for it is treated as idle
+        if (serverStatusStatus.isOK()) {
+            collectionLoads = parseCollectionLoads(serverStatusStatus.getValue());
         }
 
         std::set<std::string> shardTags;
@@ -157,6 +196,7 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().collectionLoads = std::move(collectionLoads);
     }
 
     return stats;
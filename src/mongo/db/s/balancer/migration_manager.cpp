@@ -33,7 +33,10 @@
 
 #include "mongo/db/s/balancer/migration_manager.h"
 
+#include <algorithm>
+#include <list>
 #include <memory>
+#include <set>
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
@@ -123,38 +126,79 @@ MigrationStatuses MigrationManager::executeMigrationsForAutoBalance(
 
     {
         std::map<MigrationIdentifier, ScopedMigrationRequest> scopedMigrationRequests;
-        vector<std::pair<shared_ptr<Notification<RemoteCommandResponse>>, MigrateInfo>> responses;
-
-        for (const auto& migrateInfo : migrateInfos) {
-            // Write a document to the config.migrations collection, in case this migration must be
-            // recovered by the Balancer. Fail if the chunk is already moving.
-            auto statusWithScopedMigrationRequest =
-                ScopedMigrationRequest::writeMigration(opCtx, migrateInfo, waitForDelete);
-            if (!statusWithScopedMigrationRequest.isOK()) {
-                migrationStatuses.emplace(migrateInfo.getName(),
-                                          std::move(statusWithScopedMigrationRequest.getStatus()));
+        std::list<std::pair<shared_ptr<Notification<RemoteCommandResponse>>, MigrateInfo>>
+            responses;
+
+        // Migrations, which have not been started yet because one of their shards takes part in
+        // another migration, in the order in which they were requested
+        std::list<MigrateInfo> pendingMigrations(migrateInfos.begin(), migrateInfos.end());
+        std::set<ShardId> busyShards;
+
+        while (!pendingMigrations.empty() || !responses.empty()) {
+            for (auto it = pendingMigrations.begin(); it != pendingMigrations.end();) {
+                if (busyShards.count(it->from) || busyShards.count(it->to)) {
+                    ++it;
+                    continue;
+                }
+
+                const MigrateInfo migrateInfo = std::move(*it);
+                it = pendingMigrations.erase(it);
+
+                // Write a document to the config.migrations collection, in case this migration must
+                // be recovered by the Balancer. Fail if the chunk is already moving.
+                auto statusWithScopedMigrationRequest =
+                    ScopedMigrationRequest::writeMigration(opCtx, migrateInfo, waitForDelete);
+                if (!statusWithScopedMigrationRequest.isOK()) {
+                    migrationStatuses.emplace(
+                        migrateInfo.getName(),
+                        std::move(statusWithScopedMigrationRequest.getStatus()));
+                    continue;
+                }
+                scopedMigrationRequests.emplace(
+                    migrateInfo.getName(), std::move(statusWithScopedMigrationRequest.getValue()));
+
+                busyShards.insert(migrateInfo.from);
+                busyShards.insert(migrateInfo.to);
+
+                responses.emplace_back(
+                    _schedule(
+                        opCtx, migrateInfo, maxChunkSizeBytes, secondaryThrottle, waitForDelete),
+                    migrateInfo);
+            }
+
+            if (responses.empty())
                 continue;
+
+            // Wait for any of the scheduled migrations to complete, so that the migrations which
+            // are waiting for its shards can be started right away
+            const auto isComplete = [](const auto& response) { return !!*response.first; };
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                _condVar.wait(lock, [&] {
+                    return std::any_of(responses.begin(), responses.end(), isComplete);
+                });
             }
-            scopedMigrationRequests.emplace(migrateInfo.getName(),
-                                            std::move(statusWithScopedMigrationRequest.getValue()));
 
-            responses.emplace_back(
-                _schedule(opCtx, migrateInfo, maxChunkSizeBytes, secondaryThrottle, waitForDelete),
-                migrateInfo);
-        }
+            for (auto it = responses.begin(); it != responses.end();) {
+                if (!isComplete(*it)) {
+                    ++it;
+                    continue;
+                }
 
-        // Wait for all the scheduled migrations to complete.
-        for (auto& response : responses) {
-            auto notification = std::move(response.first);
-            auto migrateInfo = std::move(response.second);
+                const auto& remoteCommandResponse = it->first->get();
+                const auto& migrateInfo = it->second;
 
-            const auto& remoteCommandResponse = notification->get();
+                auto itRequest = scopedMigrationRequests.find(migrateInfo.getName());
+                invariant(itRequest != scopedMigrationRequests.end());
+                Status commandStatus =
+                    _processRemoteCommandResponse(remoteCommandResponse, &itRequest->second);
+                migrationStatuses.emplace(migrateInfo.getName(), std::move(commandStatus));
 
-            auto it = scopedMigrationRequests.find(migrateInfo.getName());
-            invariant(it != scopedMigrationRequests.end());
-            Status commandStatus =
-                _processRemoteCommandResponse(remoteCommandResponse, &it->second);
-            migrationStatuses.emplace(migrateInfo.getName(), std::move(commandStatus));
+                busyShards.erase(migrateInfo.from);
+                busyShards.erase(migrateInfo.to);
+
+                it = responses.erase(it);
+            }
         }
     }
 
@@ -561,6 +605,10 @@ void MigrationManager::_complete(WithLock lock,
     }
 
     notificationToSignal->set(remoteCommandResponse);
+
+    // Wakes up executeMigrationsForAutoBalance, which starts the migrations waiting for the shards
+    // of this one
+    _condVar.notify_all();
 }
 
 void MigrationManager::_checkDrained(WithLock) {
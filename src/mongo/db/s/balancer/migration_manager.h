@@ -75,6 +75,10 @@ public:
      * "candidateMigrations" and wait for them to complete. Takes the distributed lock for each
      * collection with a chunk being migrated.
      *
+     * A shard takes part in only one of the migrations at a time. Migrations involving a shard,
+     * which is busy with another migration, are started as soon as it completes, in the order in
+     * which they were specified.
+     *
      * If any of the migrations, which were scheduled in parallel fails with a LockBusy error
      * reported from the shard, retries it serially without the distributed lock.
      *
@@ -266,7 +270,7 @@ private:
     State _state{State::kStopped};
 
     // Condition variable, which is waited on when the migration manager's state is changing and
-    // signaled when the state change is complete.
+    // signaled when the state change is complete. Also signaled whenever a migration completes.
     stdx::condition_variable _condVar;
 
     // Maps collection namespaces to that collection's active migrations.
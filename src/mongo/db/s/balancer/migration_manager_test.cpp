@@ -334,6 +334,55 @@ TEST_F(MigrationManagerTest, OneCollectionTwoMigrations) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(MigrationManagerTest, MigrationsSharingADonorAreStartedOneAfterAnother) {
+    // Set up two shards in the metadata.
+    ASSERT_OK(catalogClient()->insertConfigDocument(
+        operationContext(), ShardType::ConfigNS, kShard0, kMajorityWriteConcern));
+    ASSERT_OK(catalogClient()->insertConfigDocument(
+        operationContext(), ShardType::ConfigNS, kShard2, kMajorityWriteConcern));
+
+    // Set up the database and collection as sharded in the metadata.
+    const std::string dbName = "foo";
+    const NamespaceString collName(dbName, "bar");
+    ChunkVersion version(2, 0, OID::gen());
+
+    setUpDatabase(dbName, kShardId0);
+    setUpCollection(collName, version);
+
+    // Set up two chunks on the same shard in the metadata.
+    ChunkType chunk1 =
+        setUpChunk(collName, kKeyPattern.globalMin(), BSON(kPattern << 49), kShardId0, version);
+    version.incMinor();
+    ChunkType chunk2 =
+        setUpChunk(collName, BSON(kPattern << 49), kKeyPattern.globalMax(), kShardId0, version);
+
+    // Going to request that these two chunks get migrated to different shards.
+    const std::vector<MigrateInfo> migrationRequests{{kShardId1, chunk1}, {kShardId3, chunk2}};
+
+    auto future = launchAsync([this, migrationRequests] {
+        ThreadClient tc("Test", getGlobalServiceContext());
+        auto opCtx = cc().makeOperationContext();
+
+        // Scheduling the moveChunk commands requires finding a host to which to send the command.
+        // Set up a dummy host for the source shard.
+        shardTargeterMock(opCtx.get(), kShardId0)->setFindHostReturnValue(kShardHost0);
+
+        MigrationStatuses migrationStatuses = _migrationManager->executeMigrationsForAutoBalance(
+            opCtx.get(), migrationRequests, 0, kDefaultSecondaryThrottle, false);
+
+        for (const auto& migrateInfo : migrationRequests) {
+            ASSERT_OK(migrationStatuses.at(migrateInfo.getName()));
+        }
+    });
+
+    // Expect the second moveChunk command to only be sent once the first one has completed.
+    expectMoveChunkCommand(chunk1, kShardId1, Status::OK());
+    expectMoveChunkCommand(chunk2, kShardId3, Status::OK());
+
+    // Run the MigrationManager code.
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(MigrationManagerTest, TwoCollectionsTwoMigrationsEach) {
     // Set up two shards in the metadata.
     ASSERT_OK(catalogClient()->insertConfigDocument(
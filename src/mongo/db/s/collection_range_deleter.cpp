@@ -51,6 +51,7 @@
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
@@ -87,6 +88,21 @@ boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& dele
     return boost::none;
 }
 
+/**
+ * Returns how far the majority commit point trails the last optime applied by this node, which
+ * approximates how far behind the slowest majority secondary is with the deletions already done.
+ */
+Seconds getReplicationLag(OperationContext* opCtx) {
+    auto* const replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+        return Seconds(0);
+    }
+
+    const auto lastApplied = replCoord->getMyLastAppliedOpTime().getTimestamp().getSecs();
+    const auto lastCommitted = replCoord->getLastCommittedOpTime().getTimestamp().getSecs();
+    return Seconds(lastApplied > lastCommitted ? lastApplied - lastCommitted : 0);
+}
+
 }  // namespace
 
 CollectionRangeDeleter::CollectionRangeDeleter() = default;
@@ -103,6 +119,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     int maxToDelete,
     CollectionRangeDeleter* forTestOnly) {
 
+    const bool adaptiveBatchSize = maxToDelete <= 0;
     if (maxToDelete <= 0) {
         maxToDelete = rangeDeleterBatchSize.load();
         if (maxToDelete <= 0) {
@@ -110,6 +127,11 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
         }
     }
 
+    const auto replicationLag =
+        adaptiveBatchSize && rangeDeleterMaxReplicationLagSecs.load() > 0
+        ? getReplicationLag(opCtx)
+        : Seconds(0);
+
     StatusWith<int> wrote = 0;
 
     auto range = boost::optional<ChunkRange>(boost::none);
@@ -160,6 +182,10 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
             const auto& frontRange = orphans.front().range;
             range.emplace(frontRange.getMin().getOwned(), frontRange.getMax().getOwned());
             notification = orphans.front().notification;
+
+            if (adaptiveBatchSize) {
+                maxToDelete = self->_nextBatchSize(maxToDelete, replicationLag);
+            }
         }
 
         invariant(range);
@@ -287,6 +313,28 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     return Date_t::now() + Milliseconds(rangeDeleterBatchDelayMS.load());
 }
 
+int CollectionRangeDeleter::_nextBatchSize(int maxBatchSize, Seconds replicationLag) {
+    const auto maxLagSecs = rangeDeleterMaxReplicationLagSecs.load();
+    if (maxLagSecs <= 0) {
+        _batchSize = maxBatchSize;
+        return _batchSize;
+    }
+
+    if (_batchSize <= 0) {
+        _batchSize = maxBatchSize;
+    }
+
+    if (replicationLag > Seconds(maxLagSecs)) {
+        _batchSize = std::max(std::min(_batchSize, maxBatchSize) / 2, 1);
+        LOG(1) << "Reducing range deletion batch size to " << _batchSize
+               << " because replication lag is " << replicationLag;
+    } else {
+        _batchSize = std::min(_batchSize + std::max(maxBatchSize / 8, 1), maxBatchSize);
+    }
+
+    return _batchSize;
+}
+
 bool CollectionRangeDeleter::_checkCollectionMetadataStillValid(
     OperationContext* opCtx,
     const NamespaceString& nss,
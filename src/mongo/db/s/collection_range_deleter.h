@@ -215,12 +215,23 @@ private:
      */
     void _pop(Status status);
 
+    /**
+     * Returns the number of documents to delete in the next batch when no explicit size was
+     * requested, given the configured 'maxBatchSize' and the current replication lag of the node.
+     * The size is halved whenever the lag exceeds rangeDeleterMaxReplicationLagSecs and grows back
+     * linearly towards 'maxBatchSize' otherwise.
+     */
+    int _nextBatchSize(int maxBatchSize, Seconds replicationLag);
+
     /**
      * Ranges scheduled for deletion.  The front of the list will be in active process of deletion.
      * As each range is completed, its notification is signaled before it is popped.
      */
     std::list<Deletion> _orphans;
     std::list<Deletion> _delayedOrphans;
+
+    // Size of the last batch chosen by _nextBatchSize, or 0 if none was chosen yet
+    int _batchSize{0};
 };
 
 }  // namespace mongo
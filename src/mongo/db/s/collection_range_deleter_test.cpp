@@ -40,12 +40,14 @@
 #include "mongo/db/keypattern.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -385,5 +387,45 @@ TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     ASSERT_FALSE(next(rangeDeleter, 1));
 }
 
+// Tests that batches are halved while replication lags and grow back once it has caught up.
+TEST_F(CollectionRangeDeleterTest, BatchSizeAdaptsToReplicationLag) {
+    const auto origBatchSize = rangeDeleterBatchSize.load();
+    const auto origMaxLagSecs = rangeDeleterMaxReplicationLagSecs.load();
+    rangeDeleterBatchSize.store(8);
+    rangeDeleterMaxReplicationLagSecs.store(10);
+    ON_BLOCK_EXIT([&] {
+        rangeDeleterBatchSize.store(origBatchSize);
+        rangeDeleterMaxReplicationLagSecs.store(origMaxLagSecs);
+    });
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    for (int i = 0; i < 20; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(
+        Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 20)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    // The majority commit point of the mock stays at the null optime, so this is 100s of lag
+    replicationCoordinator()->setMyLastAppliedOpTime(repl::OpTime(Timestamp(100, 0), 1));
+
+    ASSERT_TRUE(next(rangeDeleter, 0));
+    ASSERT_EQUALS(16ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 20)));
+    ASSERT_TRUE(next(rangeDeleter, 0));
+    ASSERT_EQUALS(14ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 20)));
+
+    // With the lag below the threshold the batch grows by one eighth of the maximum per pass
+    rangeDeleterMaxReplicationLagSecs.store(1000);
+    ASSERT_TRUE(next(rangeDeleter, 0));
+    ASSERT_EQUALS(11ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 20)));
+
+    // An explicit batch size is used as is
+    ASSERT_TRUE(next(rangeDeleter, 1));
+    ASSERT_EQUALS(10ULL, dbclient.count(kNss.toString(), BSON(kShardKey << LT << 20)));
+}
+
 }  // namespace
 }  // namespace mongo
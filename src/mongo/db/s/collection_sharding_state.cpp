@@ -36,6 +36,7 @@
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/sharded_connection_info.h"
+#include "mongo/s/chunk_writes_tracker.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/util/log.h"
 #include "mongo/util/string_map.h"
@@ -83,6 +84,49 @@ public:
         versionB.done();
     }
 
+    void reportCollectionLoad(BSONObjBuilder* builder) {
+        BSONObjBuilder loadB(builder->subobjStart("collectionLoad"));
+
+        {
+            stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+            for (auto& coll : _collections) {
+                const auto optMetadata = coll.second->getCurrentMetadataIfKnown();
+                if (!optMetadata || !(*optMetadata)->isSharded())
+                    continue;
+
+                const auto& metadata = *optMetadata;
+
+                uint64_t totalOperations = 0;
+                uint64_t hotChunkOperations = 0;
+                BSONObj hotChunkMin;
+
+                for (const auto& chunk : metadata->getChunkManager()->chunks()) {
+                    if (chunk.getShardId() != metadata->shardId())
+                        continue;
+
+                    const uint64_t operations = chunk.getWritesTracker()->clearOperations();
+                    totalOperations += operations;
+                    if (operations > hotChunkOperations) {
+                        hotChunkOperations = operations;
+                        hotChunkMin = chunk.getMin();
+                    }
+                }
+
+                if (!totalOperations)
+                    continue;
+
+                BSONObjBuilder collB(loadB.subobjStart(coll.first));
+                collB.append("operations", static_cast<long long>(totalOperations));
+                collB.append("hotChunkMin", hotChunkMin);
+                collB.append("hotChunkOperations", static_cast<long long>(hotChunkOperations));
+                collB.done();
+            }
+        }
+
+        loadB.done();
+    }
+
 private:
     using CollectionsMap = StringMap<std::shared_ptr<CollectionShardingState>>;
 
@@ -152,6 +196,12 @@ void CollectionShardingState::report(OperationContext* opCtx, BSONObjBuilder* bu
     collectionsMap->report(opCtx, builder);
 }
 
+void CollectionShardingState::reportCollectionLoad(OperationContext* opCtx,
+                                                   BSONObjBuilder* builder) {
+    auto& collectionsMap = CollectionShardingStateMap::get(opCtx->getServiceContext());
+    collectionsMap->reportCollectionLoad(builder);
+}
+
 ScopedCollectionMetadata CollectionShardingState::getOrphansFilter(OperationContext* opCtx) {
     const auto receivedShardVersion = getOperationReceivedVersion(opCtx, _nss);
     if (!receivedShardVersion)
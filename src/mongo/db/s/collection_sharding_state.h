@@ -74,6 +74,14 @@ public:
      */
     static void report(OperationContext* opCtx, BSONObjBuilder* builder);
 
+    /**
+     * Reports, for each sharded collection, the number of documents read from or written to the
+     * chunks owned by this shard along with the chunk which saw most of them, and resets these
+     * counts. Since every request resets the counts, the figures reported by all the shards polled
+     * in one balancer round cover the same interval.
+     */
+    static void reportCollectionLoad(OperationContext* opCtx, BSONObjBuilder* builder);
+
     /**
      * Returns the orphan chunk filtering metadata that the current operation should be using for
      * the collection.
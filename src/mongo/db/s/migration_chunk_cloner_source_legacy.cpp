@@ -33,6 +33,8 @@
 
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 
+#include <algorithm>
+
 #include "mongo/base/status.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -430,15 +432,19 @@ void MigrationChunkClonerSourceLegacy::_consumeOperationTrackRequestAndAddToTran
     switch (op) {
         case 'd': {
             stdx::lock_guard<stdx::mutex> sl(_mutex);
-            _deleted.push_back(idObj);
-            _memoryUsed += idObj.firstElement().size() + 5;
+            if (_deletedIds.insert(idObj).second) {
+                _deleted.push_back(idObj);
+                _memoryUsed += idObj.firstElement().size() + 5;
+            }
         } break;
 
         case 'i':
         case 'u': {
             stdx::lock_guard<stdx::mutex> sl(_mutex);
-            _reload.push_back(idObj);
-            _memoryUsed += idObj.firstElement().size() + 5;
+            if (_reloadIds.insert(idObj).second) {
+                _reload.push_back(idObj);
+                _memoryUsed += idObj.firstElement().size() + 5;
+            }
         } break;
 
         default:
@@ -508,7 +514,7 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-    std::set<RecordId>::iterator it;
+    std::vector<RecordId>::iterator it;
 
     for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
         // We must always make progress in this method by at least one document because empty return
@@ -548,8 +554,8 @@ Status MigrationChunkClonerSourceLegacy::nextModsBatch(OperationContext* opCtx,
 
     long long docSizeAccumulator = 0;
 
-    _xfer(opCtx, db, &_deleted, builder, "deleted", &docSizeAccumulator, false);
-    _xfer(opCtx, db, &_reload, builder, "reload", &docSizeAccumulator, true);
+    _xfer(opCtx, db, &_deleted, &_deletedIds, builder, "deleted", &docSizeAccumulator, false);
+    _xfer(opCtx, db, &_reload, &_reloadIds, builder, "reload", &docSizeAccumulator, true);
 
     builder->append("size", docSizeAccumulator);
 
@@ -563,7 +569,9 @@ void MigrationChunkClonerSourceLegacy::_cleanup(OperationContext* opCtx) {
     _drainAllOutstandingOperationTrackRequests(lk);
 
     _reload.clear();
+    _reloadIds.clear();
     _deleted.clear();
+    _deletedIds.clear();
 }
 
 StatusWith<BSONObj> MigrationChunkClonerSourceLegacy::_callRecipient(const BSONObj& cmdObj) {
@@ -655,6 +663,10 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     bool isLargeChunk = false;
     unsigned long long recCount = 0;
 
+    // Collected without holding '_mutex' and sorted once the scan completes, which is much cheaper
+    // than keeping a balanced tree of every record id in the chunk.
+    std::vector<RecordId> cloneLocs;
+
     BSONObj obj;
     RecordId recordId;
     PlanExecutor::ExecState state;
@@ -665,8 +677,7 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
         }
 
         if (!isLargeChunk) {
-            stdx::lock_guard<stdx::mutex> lk(_mutex);
-            _cloneLocs.insert(recordId);
+            cloneLocs.push_back(recordId);
         }
 
         if (++recCount > maxRecsWhenFull) {
@@ -703,7 +714,12 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
                           << _args.getMaxKey()};
     }
 
+    // A yielding index scan may return the same record more than once.
+    std::sort(cloneLocs.begin(), cloneLocs.end());
+    cloneLocs.erase(std::unique(cloneLocs.begin(), cloneLocs.end()), cloneLocs.end());
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cloneLocs = std::move(cloneLocs);
     _averageObjectSizeForCloneLocs = collectionAverageObjectSize + 12;
 
     return Status::OK();
@@ -712,11 +728,13 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
 void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* opCtx,
                                              Database* db,
                                              std::list<BSONObj>* docIdList,
+                                             SimpleBSONObjUnorderedSet* docIdSet,
                                              BSONObjBuilder* builder,
                                              const char* fieldName,
                                              long long* sizeAccumulator,
                                              bool explode) {
-    const long long maxSize = 1024 * 1024;
+    // Leaves room for the array indices, which are not accounted for in 'sizeAccumulator'.
+    const long long maxSize = BSONObjMaxUserSize / 2;
 
     if (docIdList->size() == 0 || *sizeAccumulator > maxSize) {
         return;
@@ -732,6 +750,11 @@ void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* opCtx,
         if (explode) {
             BSONObj fullDoc;
             if (Helpers::findById(opCtx, db, ns.c_str(), idDoc, fullDoc)) {
+                // Leave a document which does not fit for the next batch, unless nothing has been
+                // added to this one yet.
+                if (*sizeAccumulator && *sizeAccumulator + fullDoc.objsize() > maxSize) {
+                    break;
+                }
                 arr.append(fullDoc);
                 *sizeAccumulator += fullDoc.objsize();
             }
@@ -740,6 +763,8 @@ void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* opCtx,
             *sizeAccumulator += idDoc.objsize();
         }
 
+        _memoryUsed -= idDoc.firstElement().size() + 5;
+        docIdSet->erase(idDoc);
         docIdIter = docIdList->erase(docIdIter);
     }
 
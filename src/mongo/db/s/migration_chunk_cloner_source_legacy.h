@@ -30,9 +30,10 @@
 #pragma once
 
 #include <list>
-#include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/optime.h"
@@ -194,13 +195,14 @@ private:
      * Insert items from docIdList to a new array with the given fieldName in the given builder. If
      * explode is true, the inserted object will be the full version of the document. Note that
      * whenever an item from the docList is inserted to the array, it will also be removed from
-     * docList.
+     * docList and docIdSet.
      *
      * Should be holding the collection lock for ns if explode is true.
      */
     void _xfer(OperationContext* opCtx,
                Database* db,
                std::list<BSONObj>* docIdList,
+               SimpleBSONObjUnorderedSet* docIdSet,
                BSONObjBuilder* builder,
                const char* fieldName,
                long long* sizeAccumulator,
@@ -278,8 +280,8 @@ private:
     // The current state of the cloner
     State _state{kNew};
 
-    // List of record ids that needs to be transferred (initial clone)
-    std::set<RecordId> _cloneLocs;
+    // List of record ids that needs to be transferred (initial clone), in ascending order
+    std::vector<RecordId> _cloneLocs;
 
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
@@ -295,12 +297,15 @@ private:
     // Indicates whether new requests to track an operation are accepted.
     bool _acceptingNewOperationTrackRequests{true};
 
-    // List of _id of documents that were modified that must be re-cloned (xfer mods)
+    // List of _id of documents that were modified that must be re-cloned (xfer mods). The latest
+    // version of the document is read when it is transferred, so each _id is queued at most once.
     std::list<BSONObj> _reload;
+    SimpleBSONObjUnorderedSet _reloadIds;
 
     // List of _id of documents that were deleted during clone that should be deleted later (xfer
-    // mods)
+    // mods). Each _id is queued at most once.
     std::list<BSONObj> _deleted;
+    SimpleBSONObjUnorderedSet _deletedIds;
 
     // Total bytes in _reload + _deleted (xfer mods)
     uint64_t _memoryUsed{0};
@@ -381,49 +381,68 @@ void MigrationDestinationManager::cloneDocumentsFromDonor(
     stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
     stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
 
-    SingleProducerSingleConsumerQueue<BSONObj>::Options options;
-    options.maxQueueDepth = 1;
+    // Batches are independent of each other, so they can be inserted by several threads at once.
+    const int numInserterThreads = migrateCloneInsertionThreads.load();
 
-    SingleProducerSingleConsumerQueue<BSONObj> batches(options);
+    SingleProducerMultiConsumerQueue<BSONObj>::Options options;
+    options.maxQueueDepth = numInserterThreads;
 
-    stdx::thread inserterThread{[&] {
-        ThreadClient tc("chunkInserter", opCtx->getServiceContext());
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = makeGuard([&] { batches.closeConsumerEnd(); });
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
-                }
-                insertBatchFn(inserterOpCtx.get(), arr);
-            }
-        } catch (...) {
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Error(51008));
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+    SingleProducerMultiConsumerQueue<BSONObj> batches(options);
+
+    std::vector<stdx::thread> inserterThreads;
+    auto joinInserterThreads = [&] {
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
         }
-    }};
+    };
     auto inserterThreadJoinGuard = makeGuard([&] {
         batches.closeProducerEnd();
-        inserterThread.join();
+        joinInserterThreads();
     });
 
+    for (int i = 0; i < numInserterThreads; ++i) {
+        inserterThreads.emplace_back([&] {
+            ThreadClient tc("chunkInserter", opCtx->getServiceContext());
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    auto arr = nextBatch["objects"].Obj();
+                    if (arr.isEmpty()) {
+                        return;
+                    }
+                    insertBatchFn(inserterOpCtx.get(), arr);
+                }
+            } catch (...) {
+                {
+                    stdx::lock_guard<Client> lk(*opCtx->getClient());
+                    opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Error(51008));
+                }
+                log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+                batches.closeConsumerEnd();
+            }
+        });
+    }
+
     while (true) {
         opCtx->checkForInterrupt();
 
         auto res = fetchBatchFn(opCtx);
 
         opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
         auto arr = res["objects"].Obj();
         if (arr.isEmpty()) {
+            // Every inserter thread stops once it receives an empty batch.
+            res = res.getOwned();
+            for (int i = 0; i < numInserterThreads; ++i) {
+                batches.push(BSONObj(res), opCtx);
+            }
             inserterThreadJoinGuard.dismiss();
-            inserterThread.join();
+            joinInserterThreads();
             opCtx->checkForInterrupt();
             break;
         }
+        batches.push(res.getOwned(), opCtx);
     }
 }
 
@@ -30,8 +30,11 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/s/migration_destination_manager.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -105,6 +108,44 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that every fetched batch is inserted when several threads insert them.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithSeveralInserterThreads) {
+    const auto originalInsertionThreads = migrateCloneInsertionThreads.load();
+    migrateCloneInsertionThreads.store(4);
+    ON_BLOCK_EXIT([&] { migrateCloneInsertionThreads.store(originalInsertionThreads); });
+
+    const int numBatches = 10;
+    int batchesFetched = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        if (batchesFetched == numBatches) {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        } else {
+            ++batchesFetched;
+            fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
+        }
+
+        return fetchBatchResultBuilder.obj();
+    };
+
+    stdx::mutex resultDocsMutex;
+    std::vector<BSONObj> resultDocs;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<stdx::mutex> lk(resultDocsMutex);
+        for (auto&& docToClone : docs) {
+            resultDocs.push_back(docToClone.Obj().getOwned());
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn);
+
+    ASSERT_EQ(numBatches * createDocumentsToClone().size(), resultDocs.size());
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
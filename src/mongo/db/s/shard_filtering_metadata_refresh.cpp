@@ -37,12 +37,16 @@
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/database_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
+#include "mongo/db/s/shard_metadata_util.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/s/catalog_cache.h"
+#include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/grid.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -277,4 +281,59 @@ void forceDatabaseRefresh(OperationContext* opCtx, const StringData dbName) {
     dss.setDbVersion(opCtx, std::move(refreshedDbVersion), dssLock);
 }
 
+void scheduleShardFilteringMetadataWarmUp(ServiceContext* serviceContext) {
+    if (!shardRoutingTableWarmUpOnStepUp.load()) {
+        return;
+    }
+
+    const auto executor = Grid::get(serviceContext)->getExecutorPool()->getFixedExecutor();
+    auto swHandle = executor->scheduleWork(
+        [serviceContext](const executor::TaskExecutor::CallbackArgs& cbArgs) {
+            if (!cbArgs.status.isOK()) {
+                return;
+            }
+
+            ThreadClient tc("ShardFilteringMetadataWarmUp", serviceContext);
+            auto uniqueOpCtx = tc->makeOperationContext();
+            auto opCtx = uniqueOpCtx.get();
+
+            const auto swNamespaces = shardmetadatautil::readAllShardCollectionsNamespaces(opCtx);
+            if (!swNamespaces.isOK()) {
+                warning() << "Failed to warm up the routing table cache after step up"
+                          << causedBy(redact(swNamespaces.getStatus()));
+                return;
+            }
+
+            const auto& namespaces = swNamespaces.getValue();
+            log() << "Warming up the filtering metadata of " << namespaces.size()
+                  << " collections after step up";
+
+            auto* const replCoord = repl::ReplicationCoordinator::get(opCtx);
+            for (const auto& nss : namespaces) {
+                // Stop as soon as this node is no longer primary, the new primary will do the work
+                if (!replCoord->getMemberState().primary()) {
+                    log() << "Stopping the warm up of the filtering metadata after step down";
+                    return;
+                }
+
+                try {
+                    forceShardFilteringMetadataRefresh(opCtx, nss);
+                } catch (const DBException& ex) {
+                    if (ErrorCodes::isShutdownError(ex.code()) ||
+                        ErrorCodes::isNotMasterError(ex.code())) {
+                        return;
+                    }
+
+                    log() << "Failed to warm up the filtering metadata for " << nss.ns()
+                          << causedBy(redact(ex));
+                }
+            }
+        });
+
+    if (!swHandle.isOK()) {
+        warning() << "Failed to schedule the warm up of the routing table cache after step up"
+                  << causedBy(redact(swHandle.getStatus()));
+    }
+}
+
 }  // namespace mongo
@@ -36,6 +36,7 @@
 namespace mongo {
 
 class OperationContext;
+class ServiceContext;
 
 /**
  * Must be invoked whenever code, which is executing on a shard encounters a StaleConfig exception
@@ -84,4 +85,12 @@ Status onDbVersionMismatchNoExcept(
 
 void forceDatabaseRefresh(OperationContext* opCtx, const StringData dbName);
 
+/**
+ * If enabled through the 'shardRoutingTableWarmUpOnStepUp' parameter, schedules a background task
+ * which refreshes the filtering metadata of every collection whose routing table is persisted on
+ * this shard. Must be called on a shard primary after it steps up. Failures are only logged, since
+ * the collections will be refreshed on demand anyways.
+ */
+void scheduleShardFilteringMetadataWarmUp(ServiceContext* serviceContext);
+
 }  // namespace mongo
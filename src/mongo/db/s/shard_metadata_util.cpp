@@ -169,6 +169,33 @@ StatusWith<ShardCollectionType> readShardCollectionsEntry(OperationContext* opCt
     }
 }
 
+StatusWith<std::vector<NamespaceString>> readAllShardCollectionsNamespaces(
+    OperationContext* opCtx) {
+    try {
+        DBDirectClient client(opCtx);
+        const auto projection = BSON(ShardCollectionType::ns() << 1);
+        std::unique_ptr<DBClientCursor> cursor = client.query(
+            NamespaceString::kShardConfigCollectionsNamespace, Query(), 0, 0, &projection);
+        if (!cursor) {
+            return Status(ErrorCodes::OperationFailed,
+                          str::stream() << "Failed to establish a cursor for reading "
+                                        << NamespaceString::kShardConfigCollectionsNamespace.ns()
+                                        << " from local storage");
+        }
+
+        std::vector<NamespaceString> namespaces;
+        while (cursor->more()) {
+            BSONObj document = cursor->nextSafe();
+            namespaces.emplace_back(document[ShardCollectionType::ns.name()].String());
+        }
+
+        return namespaces;
+    } catch (const DBException& ex) {
+        return ex.toStatus(
+            "Failed to read the collections entries locally from config.cache.collections");
+    }
+}
+
 StatusWith<ShardDatabaseType> readShardDatabasesEntry(OperationContext* opCtx, StringData dbName) {
     Query fullQuery(BSON(ShardDatabaseType::name() << dbName.toString()));
 
@@ -126,6 +126,13 @@ StatusWith<RefreshState> getPersistedRefreshFlags(OperationContext* opCtx,
 StatusWith<ShardCollectionType> readShardCollectionsEntry(OperationContext* opCtx,
                                                           const NamespaceString& nss);
 
+/**
+ * Reads the namespaces of all the entries in the shard server's collections collection, that is all
+ * the collections whose routing table is persisted on this shard.
+ */
+StatusWith<std::vector<NamespaceString>> readAllShardCollectionsNamespaces(
+    OperationContext* opCtx);
+
 /**
  * Reads the shard server's databases collection entry identified by 'dbName'.
  */
@@ -192,6 +192,15 @@ TEST_F(ShardMetadataUtilTest, UpdateAndReadCollectionsEntry) {
     ASSERT(!readShardCollectionType.hasLastRefreshedCollectionVersion());
 }
 
+TEST_F(ShardMetadataUtilTest, ReadAllCollectionsNamespaces) {
+    ASSERT(assertGet(readAllShardCollectionsNamespaces(operationContext())).empty());
+
+    setUpCollection();
+    auto namespaces = assertGet(readAllShardCollectionsNamespaces(operationContext()));
+    ASSERT_EQUALS(1U, namespaces.size());
+    ASSERT_EQUALS(kNss, namespaces.front());
+}
+
 TEST_F(ShardMetadataUtilTest, PersistedRefreshSignalStartAndFinish) {
     setUpCollection();
 
@@ -176,6 +176,8 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
     // Don't trigger chunk splits from inserts happening due to migration since
     // we don't necessarily own that chunk yet
     if (!fromMigrate) {
+        chunkWritesTracker->addOperations(1);
+
         const auto balancerConfig = Grid::get(opCtx)->getBalancerConfiguration();
 
         if (balancerConfig->getShouldAutoSplit() &&
@@ -32,6 +32,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/s/active_migrations_registry.h"
+#include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/s/balancer_configuration.h"
@@ -111,6 +112,13 @@ public:
         BSONObjBuilder result;
         ShardingStatistics::get(opCtx).report(&result);
         catalogCache->report(&result);
+
+        // The balancer requests the load of each collection explicitly, because reporting it
+        // resets the counts it is based on
+        if (configElement.type() == Object && configElement.Obj()["collectionLoad"].trueValue()) {
+            CollectionShardingState::reportCollectionLoad(opCtx, &result);
+        }
+
         return result.obj();
     }
 
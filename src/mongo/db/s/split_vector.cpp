@@ -44,6 +44,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -51,6 +54,9 @@ namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// The number of documents sampleSplitVector draws for each one it requires to fall into the chunk
+const int kMaxSampleDrawsPerSampleInChunk{100};
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
@@ -306,4 +312,119 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
     return splitKeys;
 }
 
+StatusWith<std::vector<BSONObj>> sampleSplitVector(OperationContext* opCtx,
+                                                   const NamespaceString& nss,
+                                                   const BSONObj& keyPattern,
+                                                   const BSONObj& min,
+                                                   const BSONObj& max,
+                                                   long long maxChunkSizeBytes) {
+    const auto fallBackToSplitVector = [&] {
+        return splitVector(opCtx,
+                           nss,
+                           keyPattern,
+                           min,
+                           max,
+                           false,
+                           boost::none,
+                           boost::none,
+                           boost::none,
+                           maxChunkSizeBytes);
+    };
+
+    const long long sampleSize = autoSplitSampleSize.load();
+    if (sampleSize <= 0 || maxChunkSizeBytes <= 0) {
+        return fallBackToSplitVector();
+    }
+
+    std::vector<BSONObj> sampleKeys;
+    long long numDraws = 0;
+    long long keyCount = 0;
+    long long estimatedNumDocsInChunk = 0;
+
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+
+        Collection* const collection = autoColl.getCollection();
+        if (!collection) {
+            return {ErrorCodes::NamespaceNotFound, "ns not found"};
+        }
+
+        const long long recCount = collection->numRecords(opCtx);
+        const long long dataSize = collection->dataSize(opCtx);
+
+        // If there's not enough data for more than one chunk, no point continuing.
+        if (dataSize < maxChunkSizeBytes || recCount == 0) {
+            return std::vector<BSONObj>();
+        }
+
+        auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+        if (!cursor) {
+            return fallBackToSplitVector();
+        }
+
+        const ShardKeyPattern shardKeyPattern(keyPattern);
+
+        while (static_cast<long long>(sampleKeys.size()) < sampleSize &&
+               numDraws < sampleSize * kMaxSampleDrawsPerSampleInChunk) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            numDraws++;
+
+            BSONObj key = shardKeyPattern.extractShardKeyFromDoc(record->data.toBson());
+            if (key.isEmpty() || key.woCompare(min) < 0 || key.woCompare(max) >= 0) {
+                continue;
+            }
+
+            sampleKeys.push_back(key.getOwned());
+        }
+
+        // We'll use the average object size and number of object to find approximately how many
+        // keys each chunk should have, in the same way as splitVector.
+        const long long avgRecSize = dataSize / recCount;
+        keyCount = std::min<long long>(maxChunkSizeBytes / (2 * avgRecSize), kMaxObjectPerChunk);
+
+        if (numDraws > 0) {
+            estimatedNumDocsInChunk =
+                recCount * static_cast<long long>(sampleKeys.size()) / numDraws;
+        }
+    }
+
+    // Only a small fraction of the sampled documents falls into a chunk holding only a small part
+    // of the collection, which is not enough to estimate the split points reliably.
+    if (static_cast<long long>(sampleKeys.size()) < sampleSize || keyCount <= 0) {
+        return fallBackToSplitVector();
+    }
+
+    std::vector<BSONObj> splitKeys;
+    if (estimatedNumDocsInChunk <= keyCount) {
+        return splitKeys;
+    }
+
+    std::sort(
+        sampleKeys.begin(), sampleKeys.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    // Use every sample key which is 'keyCount' documents after the previous split point, as
+    // estimated from the fraction of the samples in between. All the instances of a given key
+    // value must live in the same chunk, so repeated keys and the chunk's minimum are skipped.
+    const double samplesPerSplit = static_cast<double>(sampleKeys.size()) * keyCount /
+        static_cast<double>(estimatedNumDocsInChunk);
+
+    for (double pos = samplesPerSplit; pos < sampleKeys.size(); pos += samplesPerSplit) {
+        const BSONObj& key = sampleKeys[static_cast<size_t>(pos)];
+        if (!key.woCompare(min) || (!splitKeys.empty() && !key.woCompare(splitKeys.back()))) {
+            continue;
+        }
+
+        splitKeys.push_back(key);
+    }
+
+    LOG(1) << "estimated " << splitKeys.size() << " split points for chunk " << nss.toString()
+           << " " << redact(min) << " -->> " << redact(max) << " from " << sampleKeys.size()
+           << " of " << numDraws << " sampled documents";
+
+    return splitKeys;
+}
+
 }  // namespace mongo
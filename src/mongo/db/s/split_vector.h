@@ -67,4 +67,21 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              boost::optional<long long> maxChunkSize,
                                              boost::optional<long long> maxChunkSizeBytes);
 
+/**
+ * Approximate version of splitVector used by the auto-splitter, which estimates the split points
+ * for the chunk [min, max) from a sample of random documents of the collection instead of scanning
+ * its keys in the shard key index. The number of documents of the chunk is estimated from the
+ * fraction of the sampled documents falling into it. Draws samples until it has
+ * 'autoSplitSampleSize' of them in the chunk, or a hundred times that many in total.
+ *
+ * Falls back to splitVector if sampling is disabled, the storage engine does not support random
+ * cursors or too few of the sampled documents fall into the chunk.
+ */
+StatusWith<std::vector<BSONObj>> sampleSplitVector(OperationContext* opCtx,
+                                                   const NamespaceString& nss,
+                                                   const BSONObj& keyPattern,
+                                                   const BSONObj& min,
+                                                   const BSONObj& max,
+                                                   long long maxChunkSizeBytes);
+
 }  // namespace mongo
@@ -301,6 +301,31 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST_F(SplitVectorTest, SampleSplitVectorFallsBackToScanWithoutRandomCursor) {
+    // The storage engine of the test fixture does not support random cursors, so the split points
+    // are found by scanning the index, exactly as splitVector does
+    std::vector<BSONObj> splitKeys =
+        unittest::assertGet(sampleSplitVector(operationContext(),
+                                              kNss,
+                                              BSON(kPattern << 1),
+                                              BSON(kPattern << 0),
+                                              BSON(kPattern << 100),
+                                              getDocSizeBytes() * 100LL));
+    ASSERT_EQ(1UL, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 50), splitKeys[0]);
+}
+
+TEST_F(SplitVectorTest, SampleSplitVectorNotEnoughData) {
+    std::vector<BSONObj> splitKeys =
+        unittest::assertGet(sampleSplitVector(operationContext(),
+                                              kNss,
+                                              BSON(kPattern << 1),
+                                              BSON(kPattern << 0),
+                                              BSON(kPattern << 100),
+                                              getDocSizeBytes() * 1000LL));
+    ASSERT_EQ(0UL, splitKeys.size());
+}
+
 const NamespaceString kJumboNss = NamespaceString("foo", "bar2");
 const std::string kJumboPattern = "a";
 
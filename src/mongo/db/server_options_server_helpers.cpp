@@ -296,7 +296,7 @@ Status storeServerOptions(const moe::Environment& params) {
 
     if (params.count("net.serviceExecutor")) {
         auto value = params["net.serviceExecutor"].as<std::string>();
-        const auto valid = {"synchronous"_sd, "adaptive"_sd};
+        const auto valid = {"synchronous"_sd, "adaptive"_sd, "workStealing"_sd};
         if (std::find(valid.begin(), valid.end(), value) == valid.end()) {
             return {ErrorCodes::BadValue, "Unsupported value for serviceExecutor"};
         }
@@ -444,6 +444,14 @@ Status storeServerOptions(const moe::Environment& params) {
         }
     }
 
+    if (params.count("net.compression.zstdDictionaryPath")) {
+        const auto ret = storeMessageCompressionDictionaryOptions(
+            params["net.compression.zstdDictionaryPath"].as<string>());
+        if (!ret.isOK()) {
+            return ret;
+        }
+    }
+
     return Status::OK();
 }
 
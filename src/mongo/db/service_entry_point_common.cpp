@@ -93,6 +93,7 @@
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -465,6 +466,7 @@ bool runCommandImpl(OperationContext* opCtx,
 #endif
     replyBuilder->reserveBytes(bytesToReserve);
 
+    CurOp::get(opCtx)->recordPhase("run");
     auto txnParticipant = TransactionParticipant::get(opCtx);
     if (!invocation->supportsWriteConcern()) {
         behaviors.uassertCommandDoesNotSpecifyWriteConcern(request.body);
@@ -507,6 +509,7 @@ bool runCommandImpl(OperationContext* opCtx,
                 return;  // Don't do normal waiting.
             }
 
+            CurOp::get(opCtx)->recordPhase("waitForWriteConcern");
             behaviors.waitForWriteConcern(opCtx, invocation, lastOpBeforeRun, bb);
         };
 
@@ -534,6 +537,7 @@ bool runCommandImpl(OperationContext* opCtx,
                                                             wcResult.toBSON()));
     }
 
+    CurOp::get(opCtx)->recordPhase("finishCommand");
     behaviors.waitForLinearizableReadConcern(opCtx);
 
     // Wait for data to satisfy the read concern level, if necessary.
@@ -615,6 +619,14 @@ void execCommandDatabase(OperationContext* opCtx,
 
         validateSessionOptions(sessionOptions, command->getName(), dbname);
 
+        // Members of the cluster replicate and exchange heartbeats through the local and admin
+        // databases. Let these operations ahead of user operations when tickets are scarce.
+        if (opCtx->getClient()->session() &&
+            (opCtx->getClient()->session()->getTags() & transport::Session::kInternalClient) &&
+            (dbname == NamespaceString::kLocalDb || dbname == NamespaceString::kAdminDb)) {
+            opCtx->lockState()->setAdmissionPriority(AdmissionPriority::kHigh);
+        }
+
         // This constructor will check out the session and start a transaction, if necessary. It
         // handles the appropriate state management for both multi-statement transactions and
         // retryable writes. Currently, only requests with a transaction number will check out the
@@ -808,6 +820,9 @@ void execCommandDatabase(OperationContext* opCtx,
             rpc::TrackingMetadata::get(opCtx).setIsLogged(true);
         }
 
+        SamplingProfiler::ScopedTag profilerTag(command->getName(), invocation->ns().ns());
+
+        CurOp::get(opCtx)->recordPhase("waitForReadConcern");
         behaviors.waitForReadConcern(opCtx, invocation.get(), request);
 
         try {
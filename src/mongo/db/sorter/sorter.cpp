@@ -48,10 +48,15 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
+#include <array>
 #include <boost/filesystem/operations.hpp>
+#include <exception>
 #include <snappy.h>
 #include <vector>
+#include <zstd.h>
 
+#include "mongo/base/data_cursor.h"
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
@@ -61,8 +66,13 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/future.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/type_traits.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
+#include "mongo/util/checksum.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/unowned_ptr.h"
@@ -105,6 +115,86 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+/**
+ * Runs func(0) ... func(numTasks - 1), each on its own thread, with the last task running on the
+ * calling thread. Waits for all of the tasks to finish and then rethrows the first exception that
+ * any of them threw, if any.
+ */
+template <typename Func>
+void runTasksInParallel(size_t numTasks, const Func& func) {
+    std::vector<std::exception_ptr> errors(numTasks);
+    auto runTask = [&](size_t i) {
+        try {
+            func(i);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<stdx::thread> threads;
+    threads.reserve(numTasks);
+    for (size_t i = 0; i + 1 < numTasks; i++) {
+        threads.emplace_back(runTask, i);
+    }
+    if (numTasks > 0) {
+        runTask(numTasks - 1);
+    }
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (auto&& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+/**
+ * Stable-sorts the range [begin, end) using up to 'maxThreads' threads. The range is split into
+ * contiguous partitions which are sorted concurrently and then merged back together pairwise, with
+ * independent merges also running concurrently. Ranges that are too small to benefit from extra
+ * threads are sorted on the calling thread.
+ */
+template <typename RandomIt, typename Less>
+void parallelStableSort(RandomIt begin, RandomIt end, const Less& less, size_t maxThreads) {
+    // Below this many elements per partition, the cost of spawning threads outweighs the benefit.
+    const size_t kMinElementsPerThread = 1024;
+
+    const size_t size = std::distance(begin, end);
+    const size_t numParts = std::min(maxThreads, size / kMinElementsPerThread);
+    if (numParts <= 1) {
+        std::stable_sort(begin, end, less);
+        return;
+    }
+
+    std::vector<RandomIt> bounds;
+    bounds.reserve(numParts + 1);
+    for (size_t i = 0; i < numParts; i++) {
+        bounds.push_back(begin + (size * i) / numParts);
+    }
+    bounds.push_back(end);
+
+    runTasksInParallel(numParts,
+                       [&](size_t i) { std::stable_sort(bounds[i], bounds[i + 1], less); });
+
+    // Merging adjacent runs left-to-right with std::inplace_merge preserves stability.
+    for (size_t width = 1; width < numParts; width *= 2) {
+        std::vector<size_t> firstRuns;
+        for (size_t i = 0; i + width < numParts; i += 2 * width) {
+            firstRuns.push_back(i);
+        }
+
+        runTasksInParallel(firstRuns.size(), [&](size_t j) {
+            const size_t i = firstRuns[j];
+            std::inplace_merge(bounds[i],
+                               bounds[i + width],
+                               bounds[std::min(i + 2 * width, numParts)],
+                               less);
+        });
+    }
+}
+
 /**
  * Returns results from sorted in-memory storage.
  */
@@ -139,10 +229,70 @@ private:
     std::deque<Data> _data;
 };
 
+/**
+ * Identifies how the payload of a spill file block is compressed. Stored on disk in the block
+ * header, so existing values must not be changed.
+ */
+enum class BlockCompression : uint8_t { kNone = 0, kSnappy = 1, kZstd = 2 };
+
+/**
+ * Header that precedes every block of a spill file. It is followed on disk by 'storedSize' bytes
+ * of payload, which may be compressed and then protected by the encryption hooks. The checksum
+ * covers exactly those payload bytes as they are stored on disk.
+ *
+ * On disk the fields are stored one after another in this order, without padding, with integers
+ * in little-endian byte order.
+ */
+struct SpillBlockHeader {
+    static const size_t kSerializedSize = 2 * sizeof(int32_t) + 1 + 2 * sizeof(uint64_t);
+
+    void serialize(char* out) const {
+        DataCursor cursor(out);
+        cursor.writeAndAdvance<LittleEndian<int32_t>>(storedSize);
+        cursor.writeAndAdvance<LittleEndian<int32_t>>(uncompressedSize);
+        cursor.writeAndAdvance<uint8_t>(static_cast<uint8_t>(compression));
+        cursor.writeAndAdvance<LittleEndian<uint64_t>>(checksum.words[0]);
+        cursor.writeAndAdvance<LittleEndian<uint64_t>>(checksum.words[1]);
+    }
+
+    static SpillBlockHeader deserialize(const char* in) {
+        SpillBlockHeader header;
+        ConstDataCursor cursor(in);
+        header.storedSize = cursor.readAndAdvance<LittleEndian<int32_t>>();
+        header.uncompressedSize = cursor.readAndAdvance<LittleEndian<int32_t>>();
+        header.compression = static_cast<BlockCompression>(cursor.readAndAdvance<uint8_t>());
+        header.checksum.words[0] = cursor.readAndAdvance<LittleEndian<uint64_t>>();
+        header.checksum.words[1] = cursor.readAndAdvance<LittleEndian<uint64_t>>();
+        return header;
+    }
+
+    int32_t storedSize;
+    int32_t uncompressedSize;
+    BlockCompression compression;
+    Checksum checksum;
+};
+
+/**
+ * Returns how many bytes each of 'numRanges' spilled ranges that are read at the same time may
+ * read ahead. Each range holds two read-ahead buffers, and all of them share the memory limit, down
+ * to a small minimum per range.
+ */
+inline size_t readAheadBytesPerRange(const SortOptions& opts, size_t numRanges) {
+    const size_t kMinReadAheadBytes = 4 * 1024;
+    const size_t share = opts.maxMemoryUsageBytes / (2 * std::max<size_t>(numRanges, 1));
+    return std::min(opts.readAheadBytes, std::max(kMinReadAheadBytes, share));
+}
+
 /**
  * Returns results from a sorted range within a file. Each instance is given a file name and start
  * and end offsets.
  *
+ * While open, the iterator reads ahead up to 'readAheadBytes' of the range at a time so that many
+ * small blocks are fetched from disk with a single large read. Each read is made in the background
+ * into a second buffer while the data of the previous one is consumed, so that reading overlaps
+ * with merging. Whoever opens the iterator accounts for both buffers, 2 * 'readAheadBytes' in all,
+ * and may resize them with setReadAheadBytes() while the iterator is closed.
+ *
  * This class is NOT responsible for file clean up / deletion. There are openSource() and
  * closeSource() functions to ensure the FileIterator is not holding the file open when the file is
  * deleted. Since it is one among many FileIterators, it cannot close a file that may still be in
@@ -159,12 +309,14 @@ public:
     FileIterator(const std::string& fileName,
                  std::streampos fileStartOffset,
                  std::streampos fileEndOffset,
+                 size_t readAheadBytes,
                  const Settings& settings)
         : _settings(settings),
           _done(false),
           _fileName(fileName),
           _fileStartOffset(fileStartOffset),
-          _fileEndOffset(fileEndOffset) {
+          _fileEndOffset(fileEndOffset),
+          _readAheadBytes(std::max(readAheadBytes, SpillBlockHeader::kSerializedSize)) {
         uassert(16815,
                 str::stream() << "unexpected empty file: " << _fileName,
                 boost::filesystem::file_size(_fileName) != 0);
@@ -184,14 +336,32 @@ public:
                               << "\": "
                               << myErrnoWithDescription(),
                 _file.good());
+        _fileOffset = _fileStartOffset;
+        _readAheadBuffer.reset(new char[_readAheadBytes]);
+        _prefetchBuffer.reset(new char[_readAheadBytes]);
+        _readAheadPos = 0;
+        _readAheadLen = 0;
+        startPrefetch();
     }
 
     void closeSource() {
+        // The background read may still be using the file and the buffer it reads into.
+        if (_prefetch.valid()) {
+            _prefetch.wait();
+            _prefetch = stdx::future<size_t>();
+        }
         _file.close();
         uassert(50969,
                 str::stream() << "error closing file \"" << _fileName << "\": "
                               << myErrnoWithDescription(),
                 !_file.fail());
+        _readAheadBuffer.reset();
+        _prefetchBuffer.reset();
+    }
+
+    void setReadAheadBytes(size_t readAheadBytes) {
+        invariant(!_readAheadBuffer);
+        _readAheadBytes = std::max(readAheadBytes, SpillBlockHeader::kSerializedSize);
     }
 
     bool more() {
@@ -229,19 +399,29 @@ private:
      * read, then _done is set to true and the function returns immediately.
      */
     void fillBufferFromDisk() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
+        char serializedHeader[SpillBlockHeader::kSerializedSize];
+        read(serializedHeader, sizeof(serializedHeader));
         if (_done)
             return;
 
-        // negative size means compressed
-        const bool compressed = rawSize < 0;
-        int32_t blockSize = std::abs(rawSize);
+        const SpillBlockHeader header = SpillBlockHeader::deserialize(serializedHeader);
+
+        int32_t blockSize = header.storedSize;
+        uassert(51114,
+                str::stream() << "invalid block size " << blockSize << " in file \"" << _fileName
+                              << "\"",
+                blockSize > 0 && header.uncompressedSize > 0);
 
         _buffer.reset(new char[blockSize]);
         read(_buffer.get(), blockSize);
         uassert(16816, "file too short?", !_done);
 
+        Checksum checksum;
+        checksum.gen(_buffer.get(), blockSize);
+        uassert(51115,
+                str::stream() << "checksum mismatch in block of file \"" << _fileName << "\"",
+                checksum == header.checksum);
+
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
@@ -259,54 +439,125 @@ private:
             _buffer.swap(out);
         }
 
-        if (!compressed) {
-            _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+        const size_t uncompressedSize = header.uncompressedSize;
+        switch (header.compression) {
+            case BlockCompression::kNone: {
+                _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
+                return;
+            }
+            case BlockCompression::kSnappy: {
+                dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+
+                size_t snappyUncompressedSize;
+                uassert(17061,
+                        "couldn't get uncompressed length",
+                        snappy::GetUncompressedLength(
+                            _buffer.get(), blockSize, &snappyUncompressedSize) &&
+                            snappyUncompressedSize == uncompressedSize);
+
+                std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+                uassert(17062,
+                        "decompression failed",
+                        snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
+
+                // hold on to decompressed data and throw out compressed data at block exit
+                _buffer.swap(decompressionBuffer);
+                break;
+            }
+            case BlockCompression::kZstd: {
+                std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+                const size_t ret = ZSTD_decompress(
+                    decompressionBuffer.get(), uncompressedSize, _buffer.get(), blockSize);
+                uassert(51116,
+                        str::stream() << "decompression failed: " << ZSTD_getErrorName(ret),
+                        !ZSTD_isError(ret) && ret == uncompressedSize);
+
+                // hold on to decompressed data and throw out compressed data at block exit
+                _buffer.swap(decompressionBuffer);
+                break;
+            }
+            default:
+                uasserted(51117,
+                          str::stream() << "unknown compression type "
+                                        << static_cast<int>(header.compression)
+                                        << " in file \""
+                                        << _fileName
+                                        << "\"");
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
-
-        size_t uncompressedSize;
-        uassert(17061,
-                "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
-
-        std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
-        uassert(17062,
-                "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
-
-        // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
         _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
     }
 
     /**
-     * Attempts to read data from disk. Sets _done to true when file offset reaches _fileEndOffset.
+     * Attempts to read data from the range, refilling the read-ahead buffer from disk as needed.
+     * Sets _done to true when the logical file offset reaches _fileEndOffset.
      *
      * Masserts on any file errors
      */
     void read(void* out, size_t size) {
-        invariant(_file.is_open());
+        char* dest = static_cast<char*>(out);
+        while (size > 0) {
+            if (_readAheadPos == _readAheadLen && !fillReadAheadBuffer()) {
+                _done = true;
+                return;
+            }
 
-        const std::streampos offset = _file.tellg();
-        uassert(51049,
-                str::stream() << "error reading file \"" << _fileName << "\": "
-                              << myErrnoWithDescription(),
-                offset >= 0);
+            const size_t toCopy = std::min(size, _readAheadLen - _readAheadPos);
+            memcpy(dest, _readAheadBuffer.get() + _readAheadPos, toCopy);
+            _readAheadPos += toCopy;
+            dest += toCopy;
+            size -= toCopy;
+        }
+    }
+
+    /**
+     * Makes the chunk of the range read in the background the contents of the read-ahead buffer,
+     * waiting for the read to finish if needed, and starts reading the chunk after it. Returns
+     * false if the whole range has already been read.
+     */
+    bool fillReadAheadBuffer() {
+        invariant(_readAheadBuffer);
 
-        if (offset >= _fileEndOffset) {
-            invariant(offset == _fileEndOffset);
-            _done = true;
+        if (!_prefetch.valid()) {
+            invariant(_fileOffset == _fileEndOffset);
+            return false;
+        }
+
+        // Rethrows any error of the background read.
+        const size_t bytesRead = _prefetch.get();
+        _readAheadBuffer.swap(_prefetchBuffer);
+        _readAheadPos = 0;
+        _readAheadLen = bytesRead;
+
+        startPrefetch();
+        return true;
+    }
+
+    /**
+     * Starts reading the next chunk of the range into the prefetch buffer on another thread,
+     * unless the whole range has already been read. Only that thread uses the file and the
+     * prefetch buffer until '_prefetch' is ready.
+     */
+    void startPrefetch() {
+        if (_fileOffset >= _fileEndOffset) {
+            invariant(_fileOffset == _fileEndOffset);
             return;
         }
 
-        _file.read(reinterpret_cast<char*>(out), size);
-        uassert(16817,
-                str::stream() << "error reading file \"" << _fileName << "\": "
-                              << myErrnoWithDescription(),
-                _file.good());
-        verify(_file.gcount() == static_cast<std::streamsize>(size));
+        const std::streamoff remaining = _fileEndOffset - _fileOffset;
+        const size_t toRead = std::min(_readAheadBytes, static_cast<size_t>(remaining));
+        _fileOffset += toRead;
+
+        char* const buffer = _prefetchBuffer.get();
+        _prefetch = stdx::async(stdx::launch::async, [this, buffer, toRead] {
+            _file.read(buffer, toRead);
+            uassert(16817,
+                    str::stream() << "error reading file \"" << _fileName << "\": "
+                                  << myErrnoWithDescription(),
+                    _file.good());
+            verify(_file.gcount() == static_cast<std::streamsize>(toRead));
+            return toRead;
+        });
     }
 
     const Settings _settings;
@@ -316,13 +567,30 @@ private:
     std::string _fileName;            // File containing the sorted data range.
     std::streampos _fileStartOffset;  // File offset at which the sorted data range starts.
     std::streampos _fileEndOffset;    // File offset at which the sorted data range ends.
+    std::streampos _fileOffset;       // File offset up to which reads have been started.
     std::ifstream _file;
+
+    size_t _readAheadBytes;                    // Capacity of the read-ahead buffer.
+    std::unique_ptr<char[]> _readAheadBuffer;  // Allocated only while the source is open.
+    size_t _readAheadPos = 0;                  // Offset of the next unconsumed buffered byte.
+    size_t _readAheadLen = 0;                  // Number of valid bytes in the buffer.
+    std::unique_ptr<char[]> _prefetchBuffer;   // Filled by the background read, if one is running.
+
+    // The background read of the next chunk of the range, which yields the number of bytes read.
+    // Declared last so that it is waited for before the file and buffers it uses are destroyed.
+    stdx::future<size_t> _prefetch;
 };
 
 /**
  * Merge-sorts results from 0 or more FileIterators, all of which should be iterating over sorted
  * ranges within the same file. This class is given the data source file name upon construction and
  * is responsible for deleting the data source file upon destruction.
+ *
+ * The merge is driven by a tournament tree of losers: each internal node of the tree remembers the
+ * input that lost the match played at that node, and the overall winner is kept at the root. After
+ * the winning input advances, only the matches on the path from its leaf to the root are replayed,
+ * which costs about log2(k) comparisons for k inputs. Ties are broken by input position so that
+ * the merge is stable.
  */
 template <typename Key, typename Value, typename Comparator>
 class MergeIterator : public SortIteratorInterface<Key, Value> {
@@ -330,48 +598,54 @@ public:
     typedef SortIteratorInterface<Key, Value> Input;
     typedef std::pair<Key, Value> Data;
 
+    /**
+     * Deletes the files named in 'itersSourceFileNames', which hold the ranges of 'iters', once
+     * destroyed.
+     */
     MergeIterator(const std::vector<std::shared_ptr<Input>>& iters,
-                  const std::string& itersSourceFileName,
+                  std::vector<std::string> itersSourceFileNames,
                   const SortOptions& opts,
                   const Comparator& comp)
         : _opts(opts),
           _remaining(opts.limit ? opts.limit : std::numeric_limits<unsigned long long>::max()),
           _first(true),
-          _greater(comp),
-          _itersSourceFileName(itersSourceFileName) {
+          _comp(comp),
+          _itersSourceFileNames(std::move(itersSourceFileNames)) {
+        // The ranges are all open at once, so their read-ahead buffers share the memory limit.
+        const size_t readAheadBytes = readAheadBytesPerRange(opts, iters.size());
         for (size_t i = 0; i < iters.size(); i++) {
+            iters[i]->setReadAheadBytes(readAheadBytes);
             iters[i]->openSource();
             if (iters[i]->more()) {
-                _heap.push_back(std::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+                _streams.push_back(stdx::make_unique<Stream>(iters[i]->next(), iters[i]));
             } else {
                 iters[i]->closeSource();
             }
         }
 
-        if (_heap.empty()) {
+        if (_streams.empty()) {
             _remaining = 0;
             return;
         }
 
-        std::make_heap(_heap.begin(), _heap.end(), _greater);
-        std::pop_heap(_heap.begin(), _heap.end(), _greater);
-        _current = _heap.back();
-        _heap.pop_back();
+        _numActive = _streams.size();
+        buildTree();
     }
 
     ~MergeIterator() {
         // Clear the remaining Stream objects first, to close the file handles before deleting the
         // file. Some systems will error closing the file if any file handles are still open.
-        _current.reset();
-        _heap.clear();
-        DESTRUCTOR_GUARD(boost::filesystem::remove(_itersSourceFileName));
+        _streams.clear();
+        for (auto&& fileName : _itersSourceFileNames) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(fileName));
+        }
     }
 
     void openSource() {}
     void closeSource() {}
 
     bool more() {
-        if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+        if (_remaining > 0 && (_first || _numActive > 1 || _streams[_tree[0]]->more()))
             return true;
 
         _remaining = 0;
@@ -385,21 +659,19 @@ public:
 
         if (_first) {
             _first = false;
-            return _current->current();
+            return _streams[_tree[0]]->current();
         }
 
-        if (!_current->advance()) {
-            verify(!_heap.empty());
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            _current = _heap.back();
-            _heap.pop_back();
-        } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-            std::pop_heap(_heap.begin(), _heap.end(), _greater);
-            std::swap(_current, _heap.back());
-            std::push_heap(_heap.begin(), _heap.end(), _greater);
+        auto& winner = _streams[_tree[0]];
+        if (!winner->advance()) {
+            // Destroying the Stream closes its source. An exhausted input loses every match.
+            winner.reset();
+            _numActive--;
+            verify(_numActive > 0);
         }
+        replayFromWinner();
 
-        return _current->current();
+        return _streams[_tree[0]]->current();
     }
 
 
@@ -413,8 +685,7 @@ private:
      */
     class Stream {
     public:
-        Stream(size_t fileNum, const Data& first, std::shared_ptr<Input> rest)
-            : fileNum(fileNum), _current(first), _rest(rest) {}
+        Stream(const Data& first, std::shared_ptr<Input> rest) : _current(first), _rest(rest) {}
 
         ~Stream() {
             _rest->closeSource();
@@ -434,38 +705,383 @@ private:
             return true;
         }
 
-        const size_t fileNum;
-
     private:
         Data _current;
         std::shared_ptr<Input> _rest;
     };
 
-    class STLComparator {  // uses greater rather than less-than to maintain a MinHeap
-    public:
-        explicit STLComparator(const Comparator& comp) : _comp(comp) {}
-        bool operator()(unowned_ptr<const Stream> lhs, unowned_ptr<const Stream> rhs) const {
-            // first compare data
-            dassertCompIsSane(_comp, lhs->current(), rhs->current());
-            int ret = _comp(lhs->current(), rhs->current());
-            if (ret)
-                return ret > 0;
-
-            // then compare fileNums to ensure stability
-            return lhs->fileNum > rhs->fileNum;
+    /**
+     * Returns true if the input at index 'lhs' should be returned before the input at index 'rhs'.
+     * Exhausted inputs lose to all others.
+     */
+    bool beats(size_t lhs, size_t rhs) const {
+        if (!_streams[lhs])
+            return false;
+        if (!_streams[rhs])
+            return true;
+
+        // first compare data
+        dassertCompIsSane(_comp, _streams[lhs]->current(), _streams[rhs]->current());
+        int ret = _comp(_streams[lhs]->current(), _streams[rhs]->current());
+        if (ret)
+            return ret < 0;
+
+        // then compare input positions to ensure stability
+        return lhs < rhs;
+    }
+
+    /**
+     * Plays the initial tournament. The k inputs are the leaves k ... 2k - 1 of an implicit binary
+     * tree whose internal nodes are 1 ... k - 1, so that node n has children 2n and 2n + 1. Slot 0
+     * of '_tree' holds the overall winner.
+     */
+    void buildTree() {
+        const size_t numLeaves = _streams.size();
+        std::vector<size_t> winners(2 * numLeaves);
+        for (size_t i = 0; i < numLeaves; i++) {
+            winners[numLeaves + i] = i;
         }
 
-    private:
-        const Comparator _comp;
-    };
+        _tree.assign(numLeaves, 0);
+        for (size_t node = numLeaves - 1; node >= 1; node--) {
+            const size_t left = winners[2 * node];
+            const size_t right = winners[2 * node + 1];
+            if (beats(left, right)) {
+                winners[node] = left;
+                _tree[node] = right;
+            } else {
+                winners[node] = right;
+                _tree[node] = left;
+            }
+        }
+        _tree[0] = numLeaves > 1 ? winners[1] : 0;
+    }
+
+    /**
+     * Replays the matches on the path from the previous winner's leaf to the root, after that
+     * winner has advanced to its next value or become exhausted.
+     */
+    void replayFromWinner() {
+        size_t winner = _tree[0];
+        for (size_t node = (_streams.size() + winner) / 2; node >= 1; node /= 2) {
+            if (beats(_tree[node], winner)) {
+                std::swap(_tree[node], winner);
+            }
+        }
+        _tree[0] = winner;
+    }
 
     SortOptions _opts;
     unsigned long long _remaining;
     bool _first;
-    std::shared_ptr<Stream> _current;
-    std::vector<std::shared_ptr<Stream>> _heap;  // MinHeap
-    STLComparator _greater;                      // named so calls make sense
-    std::string _itersSourceFileName;
+    const Comparator _comp;
+    std::vector<std::unique_ptr<Stream>> _streams;  // Null once the input is exhausted.
+    std::vector<size_t> _tree;                      // Losers at each internal node, winner at 0.
+    size_t _numActive = 0;                          // Number of inputs that are not exhausted.
+    std::vector<std::string> _itersSourceFileNames;
+};
+
+/**
+ * Comparators opt in to radix sorting by declaring 'static constexpr bool kComparesKeyBytes = true'.
+ * This promises that they order data exactly as memcmp orders the bytes of the keys, with a key
+ * that is a prefix of another sorting first, and that the keys expose those bytes through
+ * getBuffer() and getSize().
+ */
+template <typename Comparator, typename = void>
+struct ComparesKeyBytes : std::false_type {};
+
+template <typename Comparator>
+struct ComparesKeyBytes<Comparator, stdx::void_t<decltype(Comparator::kComparesKeyBytes)>>
+    : std::integral_constant<bool, Comparator::kComparesKeyBytes> {};
+
+/**
+ * Stable MSD radix sort of the 'size' elements starting at 'data', all of whose keys share their
+ * first 'depth' bytes. 'scratch' must have room for 'size' elements. Small buckets, and buckets
+ * whose keys share very long prefixes, fall back to std::stable_sort with 'less'. After the first
+ * byte has been distributed, the resulting buckets are sorted on up to 'maxThreads' threads.
+ */
+template <typename RandomIt, typename ScratchIt, typename Less>
+void msdRadixSort(RandomIt data,
+                  ScratchIt scratch,
+                  size_t size,
+                  size_t depth,
+                  const Less& less,
+                  size_t maxThreads) {
+    // Below this many elements a comparison sort is faster than another counting pass.
+    const size_t kMinRadixSortSize = 64;
+    // Beyond this depth the comparison sort wins, since each level costs a full pass over the data.
+    const size_t kMaxRadixSortDepth = 32;
+    // Bucket 0 holds keys that end at 'depth', which sort before every key that continues. Bucket
+    // b + 1 holds keys whose byte at 'depth' is b.
+    const size_t kNumBuckets = 257;
+
+    auto bucketOf = [](const auto& elem, size_t depth) -> size_t {
+        const auto& key = elem.first;
+        return depth < key.getSize() ? 1 + static_cast<unsigned char>(key.getBuffer()[depth]) : 0;
+    };
+
+    while (true) {
+        if (size < kMinRadixSortSize || depth >= kMaxRadixSortDepth) {
+            std::stable_sort(data, data + size, less);
+            return;
+        }
+
+        std::array<size_t, kNumBuckets + 1> bounds{};
+        for (size_t i = 0; i < size; i++) {
+            bounds[bucketOf(data[i], depth) + 1]++;
+        }
+
+        // Skip the copy when every key shares this byte, which is common for leading type bytes.
+        const size_t firstBucket = bucketOf(data[0], depth);
+        if (bounds[firstBucket + 1] == size) {
+            if (firstBucket == 0) {
+                return;  // All keys are equal.
+            }
+            depth++;
+            continue;
+        }
+
+        for (size_t b = 1; b <= kNumBuckets; b++) {
+            bounds[b] += bounds[b - 1];
+        }
+
+        // Distributing elements in their original order keeps the sort stable.
+        std::array<size_t, kNumBuckets> next;
+        std::copy(bounds.begin(), bounds.begin() + kNumBuckets, next.begin());
+        for (size_t i = 0; i < size; i++) {
+            scratch[next[bucketOf(data[i], depth)]++] = std::move(data[i]);
+        }
+        std::move(scratch, scratch + size, data);
+
+        // Keys in bucket 0 are all equal, so only the other buckets need more sorting.
+        auto sortBucket = [&](size_t b) {
+            msdRadixSort(data + bounds[b],
+                         scratch + bounds[b],
+                         bounds[b + 1] - bounds[b],
+                         depth + 1,
+                         less,
+                         1);
+        };
+        if (maxThreads <= 1) {
+            for (size_t b = 1; b < kNumBuckets; b++) {
+                sortBucket(b);
+            }
+        } else {
+            const size_t numThreads = std::min(maxThreads, kNumBuckets - 1);
+            runTasksInParallel(numThreads, [&](size_t t) {
+                for (size_t b = 1 + t; b < kNumBuckets; b += numThreads) {
+                    sortBucket(b);
+                }
+            });
+        }
+        return;
+    }
+}
+
+/**
+ * Stably sorts 'data' with 'less' on up to 'maxThreads' threads, using a radix sort on the key
+ * bytes when the comparator orders keys by their bytes.
+ */
+template <typename Container, typename Less>
+void sortInMemory(Container* data, const Less& less, size_t maxThreads, std::false_type) {
+    parallelStableSort(data->begin(), data->end(), less, maxThreads);
+}
+
+template <typename Container, typename Less>
+void sortInMemory(Container* data, const Less& less, size_t maxThreads, std::true_type) {
+    std::vector<typename Container::value_type> scratch(data->size());
+    msdRadixSort(data->begin(), scratch.begin(), data->size(), 0, less, maxThreads);
+}
+
+/**
+ * Registers a sorter configured with 'opts' with its memory broker, if it has one.
+ */
+inline std::unique_ptr<SorterMemoryBroker::Registration> registerWithMemoryBroker(
+    const SortOptions& opts) {
+    if (!opts.memoryBroker) {
+        return nullptr;
+    }
+    return opts.memoryBroker->registerSorter(opts.memoryConsumerName, opts.extSortAllowed);
+}
+
+/**
+ * Returns true if a sorter holding 'memUsed' bytes of in-memory data must spill, either because it
+ * exceeded its own limit or because its memory broker revoked its quota.
+ */
+inline bool shouldSpill(const SortOptions& opts,
+                        SorterMemoryBroker::Registration* memoryRegistration,
+                        size_t memUsed) {
+    if (memUsed > opts.maxMemoryUsageBytes) {
+        return true;
+    }
+    return memoryRegistration && memoryRegistration->reportUsage(memUsed);
+}
+
+/**
+ * Returns the number of spilled ranges that a sorter merges into one at a time. This bounds both
+ * the number of file handles that are open at once and the memory held by their read-ahead
+ * buffers during any merge.
+ */
+inline size_t maxSpillsToMerge(const SortOptions& opts) {
+    const size_t kMinSpillsToMerge = 16;
+    const size_t kMaxSpillsToMerge = 512;
+    const size_t budget =
+        opts.maxMemoryUsageBytes / std::max<size_t>(2 * opts.readAheadBytes, 1);
+    return std::max(kMinSpillsToMerge, std::min(kMaxSpillsToMerge, budget));
+}
+
+/**
+ * The sorted ranges that a sorter has spilled, merged level by level so that the cost of merging
+ * grows with the logarithm of the number of spills rather than with its square.
+ *
+ * Ranges spilled from memory are at level 0. Once there are maxSpillsToMerge() ranges at a level,
+ * they are merged into a single range at the next level. Each level has a file of its own, so once
+ * the ranges of a level are merged, its file holds nothing that is still needed. The file is then
+ * deleted, and its space reused for the next ranges at that level.
+ *
+ * This class deletes the files it created, unless done() has handed them to the returned
+ * iterator.
+ */
+template <typename Key, typename Value, typename Comparator>
+class SpilledRanges {
+    MONGO_DISALLOW_COPYING(SpilledRanges);
+
+public:
+    typedef SortIteratorInterface<Key, Value> Iterator;
+    typedef typename SortedFileWriter<Key, Value>::Settings Settings;
+
+    /**
+     * Level 0 uses 'fileName', and each further level 'fileName' with the level as suffix.
+     */
+    SpilledRanges(std::string fileName,
+                  const SortOptions& opts,
+                  const Comparator& comp,
+                  const Settings& settings)
+        : _opts(opts), _comp(comp), _settings(settings), _fanIn(maxSpillsToMerge(opts)) {
+        _levels.push_back({std::move(fileName), 0});
+    }
+
+    ~SpilledRanges() {
+        if (_done) {
+            return;
+        }
+        for (auto&& level : _levels) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(level.fileName));
+        }
+    }
+
+    bool empty() const {
+        return _ranges.empty();
+    }
+
+    /**
+     * The file and offset at which the next range spilled from memory is to be written.
+     */
+    const std::string& spillFileName() const {
+        return _levels[0].fileName;
+    }
+    std::streampos spillFileOffset() const {
+        return _levels[0].nextOffset;
+    }
+
+    /**
+     * Takes ownership of 'range', which was written from memory at spillFileOffset() and ends at
+     * 'fileEndOffset', and merges ranges as needed.
+     */
+    void add(Iterator* range, std::streampos fileEndOffset) {
+        _ranges.emplace_back(range);
+        _rangeLevels.push_back(0);
+        _levels[0].nextOffset = fileEndOffset;
+
+        for (size_t level = 0; _numTrailingAtLevel(level) >= _fanIn; ++level) {
+            _mergeTrailing(_fanIn);
+        }
+    }
+
+    /**
+     * Returns an iterator over all of the ranges, which deletes the spill files once destroyed.
+     * Merges the smallest ranges first if there are more than maxSpillsToMerge() of them.
+     */
+    Iterator* done() {
+        while (_ranges.size() > _fanIn) {
+            _mergeTrailing(std::min(_fanIn, _ranges.size() - _fanIn + 1));
+        }
+
+        std::vector<std::string> fileNames;
+        for (auto&& level : _levels) {
+            if (level.nextOffset != 0) {
+                fileNames.push_back(level.fileName);
+            }
+        }
+        _done = true;
+        return new MergeIterator<Key, Value, Comparator>(
+            _ranges, std::move(fileNames), _opts, _comp);
+    }
+
+private:
+    struct Level {
+        std::string fileName;
+        std::streampos nextOffset;  // Zero when the file does not exist.
+    };
+
+    size_t _numTrailingAtLevel(size_t level) const {
+        size_t count = 0;
+        for (auto it = _rangeLevels.rbegin(); it != _rangeLevels.rend() && *it == level; ++it) {
+            count++;
+        }
+        return count;
+    }
+
+    /**
+     * Merges the last 'count' ranges, which are the most recent and the smallest, into one range
+     * at the level above the highest of them. Then deletes the files that no range uses anymore.
+     */
+    void _mergeTrailing(size_t count) {
+        const size_t first = _ranges.size() - count;
+        const size_t outputLevel = _rangeLevels[first] + 1;
+        if (outputLevel == _levels.size()) {
+            _levels.push_back({_levels[0].fileName + "." + std::to_string(outputLevel), 0});
+        }
+
+        std::vector<std::shared_ptr<Iterator>> inputs(_ranges.begin() + first, _ranges.end());
+        _ranges.resize(first);
+        _rangeLevels.resize(first);
+
+        {
+            MergeIterator<Key, Value, Comparator> merged(inputs, {}, _opts, _comp);
+            Level& output = _levels[outputLevel];
+            SortedFileWriter<Key, Value> writer(
+                _opts, output.fileName, output.nextOffset, _settings);
+            while (merged.more()) {
+                auto next = merged.next();
+                writer.addAlreadySorted(next.first, next.second);
+            }
+            _ranges.emplace_back(writer.done());
+            _rangeLevels.push_back(outputLevel);
+            output.nextOffset = writer.getFileEndOffset();
+        }
+        inputs.clear();
+
+        for (size_t level = 0; level < _levels.size(); ++level) {
+            if (_levels[level].nextOffset != 0 &&
+                std::find(_rangeLevels.begin(), _rangeLevels.end(), level) == _rangeLevels.end()) {
+                boost::filesystem::remove(_levels[level].fileName);
+                _levels[level].nextOffset = 0;
+            }
+        }
+    }
+
+    const SortOptions _opts;
+    const Comparator _comp;
+    const Settings _settings;
+    const size_t _fanIn;
+    std::vector<Level> _levels;
+    bool _done = false;
+
+    // In the order in which they were spilled, so that the merges are stable. The level of each
+    // range is in '_rangeLevels', and never increases along the vector.
+    std::vector<std::shared_ptr<Iterator>> _ranges;
+    std::vector<size_t> _rangeLevels;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -480,19 +1096,16 @@ public:
     NoLimitSorter(const SortOptions& opts,
                   const Comparator& comp,
                   const Settings& settings = Settings())
-        : _comp(comp), _settings(settings), _opts(opts), _memUsed(0) {
+        : _comp(comp),
+          _settings(settings),
+          _opts(opts),
+          _memUsed(0),
+          _memoryRegistration(registerWithMemoryBroker(_opts)),
+          _spills(_opts.extSortAllowed ? _opts.tempDir + "/" + nextFileName() : "",
+                  _opts,
+                  _comp,
+                  _settings) {
         verify(_opts.limit == 0);
-        if (_opts.extSortAllowed) {
-            _fileName = _opts.tempDir + "/" + nextFileName();
-        }
-    }
-
-    ~NoLimitSorter() {
-        if (!_done) {
-            // If done() was never called to return a MergeIterator, then this Sorter still owns
-            // file deletion.
-            DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName));
-        }
     }
 
     void add(const Key& key, const Value& val) {
@@ -502,21 +1115,22 @@ public:
 
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
+        _memUsed += kSortScratchBytesPerElement;
 
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        if (shouldSpill(_opts, _memoryRegistration.get(), _memUsed))
             spill();
     }
 
     Iterator* done() {
         invariant(!_done);
 
-        if (_iters.empty()) {
+        if (_spills.empty()) {
             sort();
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
-        Iterator* mergeIt = Iterator::merge(_iters, _fileName, _opts, _comp);
+        Iterator* mergeIt = _spills.done();
         _done = true;
         return mergeIt;
     }
@@ -534,9 +1148,14 @@ private:
         const Comparator& _comp;
     };
 
+    // The radix sort moves the data through a scratch vector of the same length, which counts
+    // toward the memory limit along with the data itself.
+    static constexpr size_t kSortScratchBytesPerElement =
+        ComparesKeyBytes<Comparator>::value ? sizeof(Data) : 0;
+
     void sort() {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        sortInMemory(&_data, less, _opts.maxSortThreads, ComparesKeyBytes<Comparator>());
 
         // Does 2x more compares than stable_sort
         // TODO test on windows
@@ -566,27 +1185,26 @@ private:
         sort();
 
         SortedFileWriter<Key, Value> writer(
-            _opts, _fileName, _nextSortedFileWriterOffset, _settings);
+            _opts, _spills.spillFileName(), _spills.spillFileOffset(), _settings);
         for (; !_data.empty(); _data.pop_front()) {
             writer.addAlreadySorted(_data.front().first, _data.front().second);
         }
         Iterator* iteratorPtr = writer.done();
-        _nextSortedFileWriterOffset = writer.getFileEndOffset();
-
-        _iters.push_back(std::shared_ptr<Iterator>(iteratorPtr));
+        _spills.add(iteratorPtr, writer.getFileEndOffset());
 
         _memUsed = 0;
+        if (_memoryRegistration)
+            _memoryRegistration->reportUsage(0);
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
-    std::string _fileName;
-    std::streampos _nextSortedFileWriterOffset = 0;
     bool _done = false;
     size_t _memUsed;
+    std::unique_ptr<SorterMemoryBroker::Registration> _memoryRegistration;
     std::deque<Data> _data;                         // the "current" data
-    std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    SpilledRanges<Key, Value, Comparator> _spills;  // data that has already been spilled
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -646,16 +1264,17 @@ public:
           _settings(settings),
           _opts(opts),
           _memUsed(0),
+          _memoryRegistration(registerWithMemoryBroker(_opts)),
+          _spills(_opts.extSortAllowed ? _opts.tempDir + "/" + nextFileName() : "",
+                  _opts,
+                  _comp,
+                  _settings),
           _haveCutoff(false),
           _worstCount(0),
           _medianCount(0) {
         // This also *works* with limit==1 but LimitOneSorter should be used instead
         verify(_opts.limit > 1);
 
-        if (_opts.extSortAllowed) {
-            _fileName = _opts.tempDir + "/" + nextFileName();
-        }
-
         // Preallocate a fixed sized vector of the required size if we don't expect it to have a
         // major impact on our memory budget. This is the common case with small limits. If the
         // limit is really large, we need to take care when doing the check below. Both 'opts.limit'
@@ -679,14 +1298,6 @@ public:
         }
     }
 
-    ~TopKSorter() {
-        if (!_done) {
-            // If done() was never called to return a MergeIterator, then this Sorter still owns
-            // file deletion.
-            DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName));
-        }
-    }
-
     void add(const Key& key, const Value& val) {
         invariant(!_done);
 
@@ -705,7 +1316,7 @@ public:
             if (_data.size() == _opts.limit)
                 std::make_heap(_data.begin(), _data.end(), less);
 
-            if (_memUsed > _opts.maxMemoryUsageBytes)
+            if (shouldSpill(_opts, _memoryRegistration.get(), _memUsed))
                 spill();
 
             return;
@@ -728,18 +1339,18 @@ public:
         _data.back() = contender;
         std::push_heap(_data.begin(), _data.end(), less);
 
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        if (shouldSpill(_opts, _memoryRegistration.get(), _memUsed))
             spill();
     }
 
     Iterator* done() {
-        if (_iters.empty()) {
+        if (_spills.empty()) {
             sort();
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
-        Iterator* iterator = Iterator::merge(_iters, _fileName, _opts, _comp);
+        Iterator* iterator = _spills.done();
         _done = true;
         return iterator;
     }
@@ -872,7 +1483,7 @@ private:
         updateCutoff();
 
         SortedFileWriter<Key, Value> writer(
-            _opts, _fileName, _nextSortedFileWriterOffset, _settings);
+            _opts, _spills.spillFileName(), _spills.spillFileOffset(), _settings);
         for (size_t i = 0; i < _data.size(); i++) {
             writer.addAlreadySorted(_data[i].first, _data[i].second);
         }
@@ -881,21 +1492,21 @@ private:
         std::vector<Data>().swap(_data);
 
         Iterator* iteratorPtr = writer.done();
-        _nextSortedFileWriterOffset = writer.getFileEndOffset();
-        _iters.push_back(std::shared_ptr<Iterator>(iteratorPtr));
+        _spills.add(iteratorPtr, writer.getFileEndOffset());
 
         _memUsed = 0;
+        if (_memoryRegistration)
+            _memoryRegistration->reportUsage(0);
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
-    std::string _fileName;
-    std::streampos _nextSortedFileWriterOffset = 0;
     bool _done = false;
     size_t _memUsed;
+    std::unique_ptr<SorterMemoryBroker::Registration> _memoryRegistration;
     std::vector<Data> _data;  // the "current" data. Organized as max-heap if size == limit.
-    std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    SpilledRanges<Key, Value, Comparator> _spills;  // data that has already been spilled
 
     // See updateCutoff() for a full description of how these members are used.
     bool _haveCutoff;
@@ -917,7 +1528,9 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
                                                const std::string& fileName,
                                                const std::streampos fileStartOffset,
                                                const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings),
+      _compressor(opts.spillCompressor),
+      _readAheadBytes(opts.readAheadBytes) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -968,14 +1581,41 @@ void SortedFileWriter<Key, Value>::spill() {
     if (size == 0)
         return;
 
+    sorter::SpillBlockHeader header{};
+    header.uncompressedSize = size;
+
     std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
+    sorter::BlockCompression compression;
+    switch (_compressor) {
+        case SortOptions::Compressor::kSnappy:
+            snappy::Compress(outBuffer, size, &compressed);
+            compression = sorter::BlockCompression::kSnappy;
+            break;
+        case SortOptions::Compressor::kZstd: {
+            // Favor speed over compression ratio, since the data will only be read back once.
+            const int kZstdSpillCompressionLevel = 1;
+            compressed.resize(ZSTD_compressBound(size));
+            const size_t ret = ZSTD_compress(
+                &compressed[0], compressed.size(), outBuffer, size, kZstdSpillCompressionLevel);
+            uassert(51118,
+                    str::stream() << "Failed to compress data: " << ZSTD_getErrorName(ret),
+                    !ZSTD_isError(ret));
+            compressed.resize(ret);
+            compression = sorter::BlockCompression::kZstd;
+            break;
+        }
+        default:
+            MONGO_UNREACHABLE;
+    }
     verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
     const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
     if (shouldCompress) {
         size = compressed.size();
         outBuffer = const_cast<char*>(compressed.data());
+        header.compression = compression;
+    } else {
+        header.compression = sorter::BlockCompression::kNone;
     }
 
     std::unique_ptr<char[]> out;
@@ -996,11 +1636,13 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
-    // negative size means compressed
-    size = shouldCompress ? -size : size;
+    header.storedSize = size;
+    header.checksum.gen(outBuffer, size);
+    char serializedHeader[sorter::SpillBlockHeader::kSerializedSize];
+    header.serialize(serializedHeader);
     try {
-        _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        _file.write(outBuffer, std::abs(size));
+        _file.write(serializedHeader, sizeof(serializedHeader));
+        _file.write(outBuffer, size);
     } catch (const std::exception&) {
         msgasserted(16821,
                     str::stream() << "error writing to file \"" << _fileName << "\": "
@@ -1026,7 +1668,7 @@ SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     _file.close();
 
     return new sorter::FileIterator<Key, Value>(
-        _fileName, _fileStartOffset, _fileEndOffset, _settings);
+        _fileName, _fileStartOffset, _fileEndOffset, _readAheadBytes, _settings);
 }
 
 //
@@ -1040,7 +1682,8 @@ SortIteratorInterface<Key, Value>* SortIteratorInterface<Key, Value>::merge(
     const std::string& fileName,
     const SortOptions& opts,
     const Comparator& comp) {
-    return new sorter::MergeIterator<Key, Value, Comparator>(iters, fileName, opts, comp);
+    return new sorter::MergeIterator<Key, Value, Comparator>(
+        iters, std::vector<std::string>{fileName}, opts, comp);
 }
 
 template <typename Key, typename Value>
@@ -38,6 +38,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/sorter/sorter_memory_broker.h"
 
 /**
  * This is the public API for the Sorter (both in-memory and external)
@@ -86,10 +87,35 @@
 
 namespace mongo {
 
+class BufReader;
+
+/**
+ * A Value type for Sorters whose keys already carry everything that needs to be sorted, such as
+ * KeyString::Value keys with a RecordId appended.
+ */
+class NullValue {
+public:
+    struct SorterDeserializeSettings {};  // unused
+
+    void serializeForSorter(BufBuilder& buf) const {}
+    static NullValue deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        return {};
+    }
+    int memUsageForSorter() const {
+        return sizeof(NullValue);
+    }
+    NullValue getOwned() const {
+        return {};
+    }
+};
+
 /**
  * Runtime options that control the Sorter's behavior
  */
 struct SortOptions {
+    // Compression algorithms that may be applied to the blocks of data written to spill files.
+    enum class Compressor { kSnappy, kZstd };
+
     // The number of KV pairs to be returned. 0 indicates no limit.
     unsigned long long limit;
 
@@ -104,7 +130,37 @@ struct SortOptions {
     // extSortAllowed is true.
     std::string tempDir;
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    // The maximum number of threads used to sort each batch of in-memory data before it is
+    // returned or spilled to disk. Values greater than 1 require the comparator to be safe to call
+    // concurrently from multiple threads. Only used when there is no limit.
+    size_t maxSortThreads;
+
+    // The compression algorithm applied to each block of data written to a spill file. A block is
+    // stored uncompressed if compressing it does not save at least 10% of its size.
+    Compressor spillCompressor;
+
+    // The most bytes that each iterator over a spilled range reads from disk at a time. Each open
+    // iterator buffers twice this much file data, as it reads the next chunk in the background
+    // while the previous one is consumed, so iterators that are merged together read less at a time
+    // to stay within maxMemoryUsageBytes between them.
+    size_t readAheadBytes;
+
+    // If set, the sorter registers the memory it holds with this broker, which may ask the sorter
+    // to spill before reaching maxMemoryUsageBytes when many sorters are running at once. Not
+    // owned, and must outlive the sorter.
+    SorterMemoryBroker* memoryBroker;
+
+    // Identifies the sorter, and the operation that owns it, to the memory broker.
+    std::string memoryConsumerName;
+
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          maxSortThreads(1),
+          spillCompressor(Compressor::kSnappy),
+          readAheadBytes(256 * 1024),
+          memoryBroker(nullptr) {}
 
     // Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -127,6 +183,31 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& MaxSortThreads(size_t newMaxSortThreads) {
+        maxSortThreads = newMaxSortThreads;
+        return *this;
+    }
+
+    SortOptions& SpillCompressor(Compressor newSpillCompressor) {
+        spillCompressor = newSpillCompressor;
+        return *this;
+    }
+
+    SortOptions& ReadAheadBytes(size_t newReadAheadBytes) {
+        readAheadBytes = newReadAheadBytes;
+        return *this;
+    }
+
+    SortOptions& MemoryBroker(SorterMemoryBroker* newMemoryBroker) {
+        memoryBroker = newMemoryBroker;
+        return *this;
+    }
+
+    SortOptions& MemoryConsumerName(const std::string& newMemoryConsumerName) {
+        memoryConsumerName = newMemoryConsumerName;
+        return *this;
+    }
 };
 
 /**
@@ -158,6 +239,10 @@ public:
     virtual void openSource() = 0;
     virtual void closeSource() = 0;
 
+    // Sets how much of its source the iterator buffers at a time while open, if it reads from
+    // disk. May only be called while the source is closed.
+    virtual void setReadAheadBytes(size_t readAheadBytes) {}
+
 protected:
     SortIteratorInterface() {}  // can only be constructed as a base
 };
@@ -254,6 +339,8 @@ private:
     void spill();
 
     const Settings _settings;
+    const SortOptions::Compressor _compressor;
+    const size_t _readAheadBytes;
     std::string _fileName;
     std::ofstream _file;
     BufBuilder _buffer;
@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_memory_broker.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/sorter/sorter_memory_broker_gen.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr size_t SorterMemoryBroker::kReportingGranularityBytes;
+
+SorterMemoryBroker::Registration::Registration(SorterMemoryBroker* broker,
+                                               std::string name,
+                                               bool canSpill)
+    : _broker(broker), _name(std::move(name)), _canSpill(canSpill) {}
+
+SorterMemoryBroker::Registration::~Registration() {
+    _broker->_unregister(this);
+}
+
+bool SorterMemoryBroker::Registration::reportUsage(size_t bytes) {
+    // Only this registration's owner writes '_usageBytes', so it can be read without the lock.
+    const size_t reported = _usageBytes;
+    const size_t delta = bytes > reported ? bytes - reported : reported - bytes;
+    if (delta >= kReportingGranularityBytes || (bytes == 0 && reported != 0)) {
+        _broker->_updateUsage(this, bytes);
+    }
+    return bytes > 0 && _spillRequested.load();
+}
+
+SorterMemoryBroker::SorterMemoryBroker(std::function<size_t()> getBudgetBytes)
+    : _getBudgetBytes(std::move(getBudgetBytes)) {}
+
+SorterMemoryBroker* SorterMemoryBroker::get() {
+    static SorterMemoryBroker* const broker = new SorterMemoryBroker([] {
+        return static_cast<size_t>(maxSorterMemoryUsageMegabytes.load()) * 1024 * 1024;
+    });
+    return broker;
+}
+
+std::unique_ptr<SorterMemoryBroker::Registration> SorterMemoryBroker::registerSorter(
+    std::string name, bool canSpill) {
+    std::unique_ptr<Registration> registration(new Registration(this, std::move(name), canSpill));
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    registration->_position = _registrations.insert(_registrations.end(), registration.get());
+    return registration;
+}
+
+size_t SorterMemoryBroker::getTotalUsageBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _totalUsageBytes;
+}
+
+void SorterMemoryBroker::appendStats(BSONObjBuilder* builder, bool includeSorters) const {
+    const size_t budgetBytes = _getBudgetBytes();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("budgetBytes", static_cast<long long>(budgetBytes));
+    builder->append("totalUsageBytes", static_cast<long long>(_totalUsageBytes));
+    builder->append("peakUsageBytes", static_cast<long long>(_peakUsageBytes));
+    builder->append("activeSorters", static_cast<long long>(_registrations.size()));
+    builder->append("spillsRequested", _spillsRequested);
+
+    if (!includeSorters) {
+        return;
+    }
+
+    BSONArrayBuilder sorters(builder->subarrayStart("sorters"));
+    for (const auto* registration : _registrations) {
+        BSONObjBuilder sorter(sorters.subobjStart());
+        sorter.append("name", registration->_name);
+        sorter.append("usageBytes", static_cast<long long>(registration->_usageBytes));
+        sorter.append("canSpill", registration->_canSpill);
+        sorter.append("spillRequested", registration->_spillRequested.load());
+    }
+}
+
+void SorterMemoryBroker::_updateUsage(Registration* registration, size_t bytes) {
+    const size_t budgetBytes = _getBudgetBytes();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_totalUsageBytes >= registration->_usageBytes);
+    _totalUsageBytes = _totalUsageBytes - registration->_usageBytes + bytes;
+    _peakUsageBytes = std::max(_peakUsageBytes, _totalUsageBytes);
+
+    if (bytes < registration->_usageBytes) {
+        // The sorter released memory, typically by spilling, so any revocation has been honored.
+        registration->_spillRequested.store(false);
+    }
+    registration->_usageBytes = bytes;
+
+    if (budgetBytes == 0 || _totalUsageBytes <= budgetBytes) {
+        return;
+    }
+
+    // Memory that sorters have already been asked to release does not need to be asked for again.
+    size_t projectedUsageBytes = _totalUsageBytes;
+    std::vector<Registration*> candidates;
+    for (auto* other : _registrations) {
+        if (other->_spillRequested.load()) {
+            projectedUsageBytes -= other->_usageBytes;
+        } else if (other->_canSpill && other->_usageBytes > 0) {
+            candidates.push_back(other);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](Registration* lhs, Registration* rhs) {
+        return lhs->_usageBytes > rhs->_usageBytes;
+    });
+    for (auto* candidate : candidates) {
+        if (projectedUsageBytes <= budgetBytes) {
+            break;
+        }
+        candidate->_spillRequested.store(true);
+        projectedUsageBytes -= candidate->_usageBytes;
+        ++_spillsRequested;
+    }
+}
+
+void SorterMemoryBroker::_unregister(Registration* registration) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_totalUsageBytes >= registration->_usageBytes);
+    _totalUsageBytes -= registration->_usageBytes;
+    _registrations.erase(registration->_position);
+}
+
+}  // namespace mongo
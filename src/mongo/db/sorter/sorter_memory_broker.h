@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Tracks the memory held by every sorter that registers with it, and keeps the total within a
+ * shared budget on top of each sorter's own maxMemoryUsageBytes limit.
+ *
+ * Whenever the total exceeds the budget, the broker revokes the quota of the largest sorters that
+ * are allowed to spill, largest first, until those spills would bring the total back under the
+ * budget. A sorter learns that its quota was revoked the next time it reports its usage, and is
+ * expected to spill before accepting more data.
+ *
+ * All methods are thread-safe.
+ */
+class SorterMemoryBroker {
+    MONGO_DISALLOW_COPYING(SorterMemoryBroker);
+
+public:
+    /**
+     * A sorter's registration with the broker. Unregisters the sorter when destroyed, returning
+     * its memory to the shared budget.
+     */
+    class Registration {
+        MONGO_DISALLOW_COPYING(Registration);
+
+    public:
+        ~Registration();
+
+        /**
+         * Records that the sorter now holds 'bytes' bytes of in-memory data. Returns true if the
+         * sorter should spill now to relieve memory pressure. Changes smaller than
+         * kReportingGranularityBytes are only pushed to the broker once they accumulate, so this is
+         * cheap enough to call on every insertion.
+         */
+        bool reportUsage(size_t bytes);
+
+    private:
+        friend class SorterMemoryBroker;
+
+        Registration(SorterMemoryBroker* broker, std::string name, bool canSpill);
+
+        SorterMemoryBroker* const _broker;
+        const std::string _name;
+        const bool _canSpill;
+
+        // The usage most recently pushed to the broker. Guarded by the broker's mutex.
+        size_t _usageBytes = 0;
+
+        // Set by the broker when it revokes this sorter's quota, and cleared once the sorter
+        // reports that it has released its memory.
+        AtomicWord<bool> _spillRequested{false};
+
+        std::list<Registration*>::iterator _position;
+    };
+
+    // Usage changes smaller than this are not pushed to the broker immediately.
+    static constexpr size_t kReportingGranularityBytes = 1024 * 1024;
+
+    /**
+     * 'getBudgetBytes' is consulted each time usage is reported, so the budget may change at
+     * runtime. A budget of 0 means that usage is tracked but never limited.
+     */
+    explicit SorterMemoryBroker(std::function<size_t()> getBudgetBytes);
+
+    /**
+     * Returns the process-wide broker, whose budget is the maxSorterMemoryUsageMegabytes server
+     * parameter.
+     */
+    static SorterMemoryBroker* get();
+
+    /**
+     * Registers a sorter under 'name', which identifies the operation that owns it in
+     * serverStatus. Only sorters that 'canSpill' ever have their quota revoked, but the memory of
+     * every registered sorter counts towards the budget.
+     */
+    std::unique_ptr<Registration> registerSorter(std::string name, bool canSpill);
+
+    /**
+     * Returns the total memory held by all registered sorters, in bytes.
+     */
+    size_t getTotalUsageBytes() const;
+
+    /**
+     * Appends the budget and the aggregate usage, followed by the usage of each registered sorter
+     * if 'includeSorters' is true.
+     */
+    void appendStats(BSONObjBuilder* builder, bool includeSorters) const;
+
+private:
+    void _updateUsage(Registration* registration, size_t bytes);
+    void _unregister(Registration* registration);
+
+    const std::function<size_t()> _getBudgetBytes;
+
+    mutable stdx::mutex _mutex;
+    std::list<Registration*> _registrations;
+    size_t _totalUsageBytes = 0;
+    size_t _peakUsageBytes = 0;
+    long long _spillsRequested = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_memory_broker.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kMB = 1024 * 1024;
+
+TEST(SorterMemoryBrokerTest, UnlimitedBudgetOnlyTracksUsage) {
+    SorterMemoryBroker broker([] { return size_t(0); });
+    auto first = broker.registerSorter("first", true);
+    auto second = broker.registerSorter("second", true);
+
+    ASSERT_FALSE(first->reportUsage(100 * kMB));
+    ASSERT_FALSE(second->reportUsage(200 * kMB));
+    ASSERT_EQ(broker.getTotalUsageBytes(), 300 * kMB);
+}
+
+TEST(SorterMemoryBrokerTest, SmallChangesAreBatched) {
+    SorterMemoryBroker broker([] { return size_t(0); });
+    auto sorter = broker.registerSorter("sorter", true);
+
+    sorter->reportUsage(SorterMemoryBroker::kReportingGranularityBytes / 2);
+    ASSERT_EQ(broker.getTotalUsageBytes(), 0U);
+
+    sorter->reportUsage(SorterMemoryBroker::kReportingGranularityBytes);
+    ASSERT_EQ(broker.getTotalUsageBytes(), SorterMemoryBroker::kReportingGranularityBytes);
+
+    // Dropping to zero is always reported, so that spills release their quota immediately.
+    sorter->reportUsage(0);
+    ASSERT_EQ(broker.getTotalUsageBytes(), 0U);
+}
+
+TEST(SorterMemoryBrokerTest, LargestSorterSpillsFirst) {
+    SorterMemoryBroker broker([] { return 100 * kMB; });
+    auto small = broker.registerSorter("small", true);
+    auto large = broker.registerSorter("large", true);
+
+    ASSERT_FALSE(small->reportUsage(30 * kMB));
+    ASSERT_FALSE(large->reportUsage(60 * kMB));
+
+    // Going over budget revokes the quota of the largest sorter only, no matter who reported.
+    ASSERT_FALSE(small->reportUsage(50 * kMB));
+    ASSERT_TRUE(large->reportUsage(60 * kMB));
+    ASSERT_FALSE(small->reportUsage(50 * kMB));
+
+    // Once the large sorter spills, it may grow again.
+    ASSERT_FALSE(large->reportUsage(0));
+    ASSERT_FALSE(large->reportUsage(10 * kMB));
+    ASSERT_EQ(broker.getTotalUsageBytes(), 60 * kMB);
+}
+
+TEST(SorterMemoryBrokerTest, SortersThatCannotSpillAreNotAskedTo) {
+    SorterMemoryBroker broker([] { return 100 * kMB; });
+    auto inMemoryOnly = broker.registerSorter("inMemoryOnly", false);
+    auto spillable = broker.registerSorter("spillable", true);
+
+    ASSERT_FALSE(inMemoryOnly->reportUsage(90 * kMB));
+    ASSERT_FALSE(spillable->reportUsage(5 * kMB));
+    ASSERT_TRUE(spillable->reportUsage(20 * kMB));
+    ASSERT_FALSE(inMemoryOnly->reportUsage(90 * kMB));
+}
+
+TEST(SorterMemoryBrokerTest, UnregisteringReleasesMemory) {
+    SorterMemoryBroker broker([] { return 100 * kMB; });
+    auto kept = broker.registerSorter("kept", true);
+    ASSERT_FALSE(kept->reportUsage(40 * kMB));
+    {
+        auto transient = broker.registerSorter("transient", true);
+        ASSERT_FALSE(transient->reportUsage(50 * kMB));
+        ASSERT_EQ(broker.getTotalUsageBytes(), 90 * kMB);
+    }
+    ASSERT_EQ(broker.getTotalUsageBytes(), 40 * kMB);
+    ASSERT_FALSE(kept->reportUsage(90 * kMB));
+}
+
+TEST(SorterMemoryBrokerTest, AppendStats) {
+    SorterMemoryBroker broker([] { return 100 * kMB; });
+    auto sorter = broker.registerSorter("sorter", true);
+    sorter->reportUsage(10 * kMB);
+
+    BSONObjBuilder summary;
+    broker.appendStats(&summary, false);
+    BSONObj summaryObj = summary.obj();
+    ASSERT_EQ(summaryObj["budgetBytes"].numberLong(), static_cast<long long>(100 * kMB));
+    ASSERT_EQ(summaryObj["totalUsageBytes"].numberLong(), static_cast<long long>(10 * kMB));
+    ASSERT_EQ(summaryObj["activeSorters"].numberLong(), 1);
+    ASSERT_FALSE(summaryObj.hasField("sorters"));
+
+    BSONObjBuilder detailed;
+    broker.appendStats(&detailed, true);
+    BSONObj detailedObj = detailed.obj();
+    ASSERT_EQ(detailedObj["sorters"].Array().size(), 1U);
+    ASSERT_EQ(detailedObj["sorters"].Array()[0]["name"].String(), "sorter");
+}
+
+}  // namespace
+}  // namespace mongo
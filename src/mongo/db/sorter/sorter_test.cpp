@@ -123,6 +123,54 @@ private:
     Direction _dir;
 };
 
+// A key that orders by its bytes, so that sorters radix sort it.
+class BytesWrapper {
+public:
+    BytesWrapper(std::string bytes = "") : _bytes(std::move(bytes)) {}
+
+    const char* getBuffer() const {
+        return _bytes.data();
+    }
+    size_t getSize() const {
+        return _bytes.size();
+    }
+    const std::string& str() const {
+        return _bytes;
+    }
+
+    /// members for Sorter
+    struct SorterDeserializeSettings {};  // unused
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(static_cast<int>(_bytes.size()));
+        buf.appendBuf(_bytes.data(), _bytes.size());
+    }
+    static BytesWrapper deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        const int size = buf.read<LittleEndian<int>>();
+        return std::string(static_cast<const char*>(buf.skip(size)), size);
+    }
+    int memUsageForSorter() const {
+        return sizeof(BytesWrapper) + _bytes.size();
+    }
+    BytesWrapper getOwned() const {
+        return *this;
+    }
+
+private:
+    std::string _bytes;
+};
+
+typedef pair<BytesWrapper, IntWrapper> BWPair;
+typedef Sorter<BytesWrapper, IntWrapper> BWSorter;
+
+class BWComparator {
+public:
+    static constexpr bool kComparesKeyBytes = true;
+
+    int operator()(const BWPair& lhs, const BWPair& rhs) const {
+        return lhs.first.str().compare(rhs.first.str());
+    }
+};
+
 class IntIterator : public IWIterator {
 public:
     IntIterator(int start = 0, int stop = INT_MAX, int increment = 1)
@@ -304,6 +352,89 @@ public:
 
             ASSERT_TRUE(boost::filesystem::remove(fileName));
         }
+        {  // big, zstd compressed and read back with a read-ahead smaller than a block
+            std::string fileName = opts.tempDir + "/" + nextFileName();
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(
+                SortOptions(opts).SpillCompressor(SortOptions::Compressor::kZstd).ReadAheadBytes(
+                    1000),
+                fileName,
+                0);
+            for (int i = 0; i < 1000 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+
+            ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                        make_shared<IntIterator>(0, 1000 * 1000));
+
+            ASSERT_TRUE(boost::filesystem::remove(fileName));
+        }
+        {  // closed part way through while the next chunk is read in the background
+            std::string fileName = opts.tempDir + "/" + nextFileName();
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(
+                SortOptions(opts).ReadAheadBytes(4096), fileName, 0);
+            for (int i = 0; i < 100 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+            std::shared_ptr<IWIterator> iter(sorter.done());
+
+            iter->openSource();
+            for (int i = 0; i < 10; i++) {
+                ASSERT(iter->more());
+                ASSERT_EQ(i, static_cast<int>(iter->next().first));
+            }
+            iter->closeSource();
+
+            ASSERT_TRUE(boost::filesystem::remove(fileName));
+        }
+        {  // corrupted block
+            std::string fileName = opts.tempDir + "/" + nextFileName();
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(opts, fileName, 0);
+            for (int i = 0; i < 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+            std::shared_ptr<IWIterator> iter(sorter.done());
+
+            {
+                // Flip the bits of the first payload byte, just past the block header.
+                std::fstream file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+                file.seekg(SpillBlockHeader::kSerializedSize);
+                const char original = file.get();
+                file.seekp(SpillBlockHeader::kSerializedSize);
+                file.put(~original);
+            }
+
+            iter->openSource();
+            ASSERT_THROWS_CODE(iter->more(), AssertionException, 51115);
+            iter->closeSource();
+
+            ASSERT_TRUE(boost::filesystem::remove(fileName));
+        }
+        {  // block header layout is independent of the platform
+            SpillBlockHeader header{};
+            header.storedSize = 0x01020304;
+            header.uncompressedSize = 0x05060708;
+            header.compression = BlockCompression::kZstd;
+            header.checksum.gen("spill", 5);
+
+            char serialized[SpillBlockHeader::kSerializedSize];
+            header.serialize(serialized);
+            ASSERT_EQ(25U, sizeof(serialized));
+            ASSERT_EQ(0x04, serialized[0]);
+            ASSERT_EQ(0x01, serialized[3]);
+            ASSERT_EQ(0x08, serialized[4]);
+            ASSERT_EQ(0x05, serialized[7]);
+            ASSERT_EQ(2, serialized[8]);
+
+            const SpillBlockHeader parsed = SpillBlockHeader::deserialize(serialized);
+            ASSERT_EQ(header.storedSize, parsed.storedSize);
+            ASSERT_EQ(header.uncompressedSize, parsed.uncompressedSize);
+            ASSERT(header.compression == parsed.compression);
+            ASSERT(header.checksum == parsed.checksum);
+        }
+        {  // merged ranges share the memory limit for their read-ahead buffers
+            const SortOptions mergeOpts =
+                SortOptions(opts).MaxMemoryUsageBytes(1024 * 1024).ReadAheadBytes(256 * 1024);
+            ASSERT_EQ(256U * 1024, readAheadBytesPerRange(mergeOpts, 1));
+            ASSERT_EQ(32U * 1024, readAheadBytesPerRange(mergeOpts, 16));
+            ASSERT_EQ(4U * 1024, readAheadBytesPerRange(mergeOpts, 1000));
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
@@ -352,6 +483,15 @@ public:
             ASSERT_ITERATORS_EQUIVALENT(mergeIterators(iterators, DESC),
                                         make_shared<IntIterator>(30, 0, -1));
         }
+        {  // test many sources, with a count that is not a power of two
+            std::shared_ptr<IWIterator> iterators[37];
+            for (int i = 0; i < 37; i++) {
+                iterators[i] = make_shared<IntIterator>(i, 37 * 100, 37);  // i, i + 37, ...
+            }
+
+            ASSERT_ITERATORS_EQUIVALENT(mergeIterators(iterators, ASC),
+                                        make_shared<IntIterator>(0, 37 * 100, 1));
+        }
         {  // test Limit
             std::shared_ptr<IWIterator> iterators[] = {
                 make_shared<IntIterator>(1, 20, 2)  // 1, 3, ... 19
@@ -545,6 +685,176 @@ public:
     PseudoRandom _random;
 };
 
+template <bool Random = true>
+class LotsOfDataParallelSort : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) {
+        // Make sure each spilled batch is large enough to be split across all of the threads.
+        MONGO_STATIC_ASSERT(MEM_LIMIT / sizeof(IWPair) > 4 * 1024);
+
+        return opts.MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed().MaxSortThreads(4);
+    }
+    enum { MEM_LIMIT = 256 * 1024 };
+};
+
+template <bool Random = true>
+class LotsOfDataZstdCompressed : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return Parent::adjustSortOptions(opts).SpillCompressor(SortOptions::Compressor::kZstd);
+    }
+};
+
+template <bool Random = true>
+class LotsOfDataSharedMemoryBudget : public LotsOfDataLittleMemory<Random> {
+    typedef LotsOfDataLittleMemory<Random> Parent;
+
+public:
+    void run() {
+        Parent::run();
+
+        // Each sorter was allowed to keep all of its data in memory, so only the broker can have
+        // made them spill.
+        BSONObjBuilder stats;
+        _broker.appendStats(&stats, false);
+        ASSERT_GT(stats.obj()["spillsRequested"].numberLong(), 0);
+        ASSERT_EQ(_broker.getTotalUsageBytes(), 0U);
+    }
+
+    SortOptions adjustSortOptions(SortOptions opts) {
+        MONGO_STATIC_ASSERT(Parent::NUM_ITEMS * sizeof(IWPair) > 2 * BUDGET);
+
+        return opts.MaxMemoryUsageBytes(1024 * 1024 * 1024).ExtSortAllowed().MemoryBroker(&_broker);
+    }
+
+    enum { BUDGET = 1024 * 1024 };
+    SorterMemoryBroker _broker{[] { return size_t(BUDGET); }};
+};
+
+class RadixSortByKeyBytes : public ScopedGlobalServiceContextForTest {
+public:
+    void run() {
+        unittest::TempDir tempDir("sorterTests");
+        PseudoRandom random(int64_t(time(0)));
+
+        // Short keys over a small alphabet produce many duplicates and keys that are prefixes of
+        // other keys. The values record the insertion order, to check that the sort is stable.
+        std::vector<BWPair> input;
+        for (int i = 0; i < 20 * 1000; i++) {
+            std::string key(random.nextInt32(12), '\0');
+            for (auto& c : key) {
+                c = static_cast<char>(random.nextInt32(4) * 85);
+            }
+            input.emplace_back(BytesWrapper(std::move(key)), IntWrapper(i));
+        }
+
+        std::vector<BWPair> expected = input;
+        std::stable_sort(expected.begin(), expected.end(), [](const BWPair& l, const BWPair& r) {
+            return BWComparator()(l, r) < 0;
+        });
+
+        const SortOptions inMemory = SortOptions().TempDir(tempDir.path());
+        const SortOptions spilling =
+            SortOptions(inMemory).ExtSortAllowed().MaxMemoryUsageBytes(64 * 1024);
+        for (const auto& opts : {inMemory, SortOptions(inMemory).MaxSortThreads(4), spilling}) {
+            std::unique_ptr<BWSorter> sorter(BWSorter::make(opts, BWComparator()));
+            for (const auto& pair : input) {
+                sorter->add(pair.first, pair.second);
+            }
+
+            std::unique_ptr<BWSorter::Iterator> iter(sorter->done());
+            iter->openSource();
+            for (const auto& pair : expected) {
+                ASSERT(iter->more());
+                BWPair next = iter->next();
+                ASSERT_EQ(next.first.str(), pair.first.str());
+                ASSERT_EQ(static_cast<int>(next.second), static_cast<int>(pair.second));
+            }
+            ASSERT_FALSE(iter->more());
+            iter->closeSource();
+        }
+
+        // The scratch space of the radix sort counts toward the memory limit, so data that only
+        // fits without it exceeds the limit.
+        const BWPair pair(BytesWrapper(std::string(16, 'x')), IntWrapper(0));
+        const size_t numPairs = 1000;
+        const size_t dataBytes =
+            numPairs * (pair.first.memUsageForSorter() + pair.second.memUsageForSorter());
+        std::unique_ptr<BWSorter> sorter(BWSorter::make(
+            SortOptions(inMemory).MaxMemoryUsageBytes(dataBytes + numPairs * sizeof(BWPair) / 2),
+            BWComparator()));
+        ASSERT_THROWS_CODE(
+            [&] {
+                for (size_t i = 0; i < numPairs; i++) {
+                    sorter->add(pair.first, pair.second);
+                }
+            }(),
+            AssertionException,
+            16819);
+    }
+};
+
+class SpillFilesStayBounded : public ScopedGlobalServiceContextForTest {
+public:
+    void run() {
+        unittest::TempDir tempDir("sorterTests");
+        PseudoRandom random(int64_t(time(0)));
+
+        // Random keys do not compress, so the spill files hold about 'dataBytes' per level.
+        const size_t numPairs = 100 * 1000;
+        const size_t keySize = 32;
+        const size_t dataBytes = numPairs * (sizeof(int) + keySize + sizeof(int));
+
+        // Hundreds of spills, merged sixteen at a time, so that ranges reach the third level.
+        const SortOptions opts =
+            SortOptions().TempDir(tempDir.path()).ExtSortAllowed().MaxMemoryUsageBytes(32 * 1024);
+        ASSERT_EQ(16U, maxSpillsToMerge(opts));
+
+        std::unique_ptr<BWSorter> sorter(BWSorter::make(opts, BWComparator()));
+        size_t maxSpillBytes = 0;
+        for (size_t i = 0; i < numPairs; i++) {
+            std::string key(keySize, '\0');
+            for (auto& c : key) {
+                c = static_cast<char>(random.nextInt32(256));
+            }
+            sorter->add(BytesWrapper(std::move(key)), IntWrapper(static_cast<int>(i)));
+
+            if (i % 1000 == 0) {
+                maxSpillBytes = std::max(maxSpillBytes, spillBytes(tempDir.path()));
+            }
+        }
+
+        // Merging every range spilled so far into one on each merge would have written several
+        // times the data by the end. Merging by level keeps each document in one file at a time,
+        // but for the merge in progress.
+        ASSERT_LTE(maxSpillBytes, dataBytes * 5 / 2);
+
+        std::unique_ptr<BWSorter::Iterator> iter(sorter->done());
+        iter->openSource();
+        size_t count = 0;
+        std::string last;
+        while (iter->more()) {
+            auto next = iter->next();
+            ASSERT_LTE(last, next.first.str());
+            last = next.first.str();
+            count++;
+        }
+        iter->closeSource();
+        ASSERT_EQ(numPairs, count);
+
+        iter.reset();
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+
+private:
+    static size_t spillBytes(const std::string& dir) {
+        size_t bytes = 0;
+        for (boost::filesystem::directory_iterator it(dir), end; it != end; ++it) {
+            bytes += boost::filesystem::file_size(it->path());
+        }
+        return bytes;
+    }
+};
 
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
@@ -584,6 +894,14 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataParallelSort</*random=*/false>>();
+        add<SorterTests::LotsOfDataParallelSort</*random=*/true>>();
+        add<SorterTests::LotsOfDataZstdCompressed</*random=*/false>>();
+        add<SorterTests::LotsOfDataZstdCompressed</*random=*/true>>();
+        add<SorterTests::LotsOfDataSharedMemoryBudget</*random=*/false>>();
+        add<SorterTests::LotsOfDataSharedMemoryBudget</*random=*/true>>();
+        add<SorterTests::RadixSortByKeyBytes>();
+        add<SorterTests::SpillFilesStayBounded>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -32,6 +32,8 @@
 #include "mongo/db/stats/operation_latency_histogram.h"
 
 #include <algorithm>
+#include <cmath>
+#include <memory>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/namespace_string.h"
@@ -92,6 +94,70 @@ const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
                                                549755813888,
                                                1099511627776};
 
+OperationLatencyHistogram::OperationLatencyHistogram(const OperationLatencyHistogram& other) {
+    *this = other;
+}
+
+OperationLatencyHistogram& OperationLatencyHistogram::operator=(
+    const OperationLatencyHistogram& other) {
+    _reads = other._reads;
+    _writes = other._writes;
+    _commands = other._commands;
+    _transactions = other._transactions;
+    return *this;
+}
+
+OperationLatencyHistogram::HistogramData& OperationLatencyHistogram::HistogramData::operator=(
+    const HistogramData& other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (const Buckets* otherBuckets = other.buckets.load()) {
+        auto& ownBuckets = getBuckets();
+        for (int i = 0; i < kMaxFineBuckets; i++) {
+            ownBuckets[i].store((*otherBuckets)[i].loadRelaxed());
+        }
+    } else {
+        delete buckets.swap(nullptr);
+    }
+    entryCount.store(other.entryCount.loadRelaxed());
+    sum.store(other.sum.loadRelaxed());
+    return *this;
+}
+
+OperationLatencyHistogram::HistogramData::Buckets&
+OperationLatencyHistogram::HistogramData::getBuckets() {
+    if (Buckets* existing = buckets.load()) {
+        return *existing;
+    }
+    auto allocated = std::make_unique<Buckets>();
+    if (Buckets* existing = buckets.compareAndSwap(nullptr, allocated.get())) {
+        // Another thread allocated the buckets first.
+        return *existing;
+    }
+    return *allocated.release();
+}
+
+void OperationLatencyHistogram::HistogramData::merge(const HistogramData& other) {
+    if (const Buckets* otherBuckets = other.buckets.load()) {
+        auto& ownBuckets = getBuckets();
+        for (int i = 0; i < kMaxFineBuckets; i++) {
+            if (auto count = (*otherBuckets)[i].loadRelaxed()) {
+                ownBuckets[i].fetchAndAddRelaxed(count);
+            }
+        }
+    }
+    entryCount.fetchAndAddRelaxed(other.entryCount.loadRelaxed());
+    sum.fetchAndAddRelaxed(other.sum.loadRelaxed());
+}
+
+void OperationLatencyHistogram::merge(const OperationLatencyHistogram& other) {
+    _reads.merge(other._reads);
+    _writes.merge(other._writes);
+    _commands.merge(other._commands);
+    _transactions.merge(other._transactions);
+}
+
 void OperationLatencyHistogram::_append(const HistogramData& data,
                                         const char* key,
                                         bool includeHistograms,
@@ -99,19 +165,53 @@ void OperationLatencyHistogram::_append(const HistogramData& data,
 
     BSONObjBuilder histogramBuilder(builder->subobjStart(key));
     if (includeHistograms) {
+        const HistogramData::Buckets* dataBuckets = data.buckets.load();
+        std::array<uint64_t, kMaxFineBuckets> fineBuckets{};
+        std::array<uint64_t, kMaxBuckets> buckets{};
+        uint64_t count = 0;
+        for (int i = 0; dataBuckets && i < kMaxFineBuckets; i++) {
+            fineBuckets[i] = (*dataBuckets)[i].loadRelaxed();
+            buckets[_getBucket(_getFineBucketLowerBound(i))] += fineBuckets[i];
+            count += fineBuckets[i];
+        }
+
         BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
         for (int i = 0; i < kMaxBuckets; i++) {
-            if (data.buckets[i] == 0)
+            if (buckets[i] == 0)
                 continue;
             BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
             entryBuilder.append("micros", static_cast<long long>(kLowerBounds[i]));
-            entryBuilder.append("count", static_cast<long long>(data.buckets[i]));
+            entryBuilder.append("count", static_cast<long long>(buckets[i]));
             entryBuilder.doneFast();
         }
         arrayBuilder.doneFast();
+
+        if (count > 0) {
+            // Each percentile is interpolated linearly within the bucket holding its rank.
+            static const std::array<std::pair<const char*, double>, 4> kPercentiles = {
+                {{"p50", 0.5}, {"p95", 0.95}, {"p99", 0.99}, {"p999", 0.999}}};
+            BSONObjBuilder percentilesBuilder(histogramBuilder.subobjStart("percentiles"));
+            int bucket = 0;
+            uint64_t below = 0;
+            for (const auto& percentile : kPercentiles) {
+                const double rank = std::max(1.0, std::ceil(percentile.second * count));
+                while (below + fineBuckets[bucket] < rank) {
+                    below += fineBuckets[bucket++];
+                }
+                const uint64_t lower = _getFineBucketLowerBound(bucket);
+                // The last bucket is unbounded, so its percentiles are reported at its lower bound.
+                const uint64_t width = bucket + 1 < kMaxFineBuckets
+                    ? _getFineBucketLowerBound(bucket + 1) - lower - 1
+                    : 0;
+                const double fraction = (rank - below) / fineBuckets[bucket];
+                percentilesBuilder.append(percentile.first,
+                                          static_cast<long long>(lower + width * fraction));
+            }
+            percentilesBuilder.doneFast();
+        }
     }
-    histogramBuilder.append("latency", static_cast<long long>(data.sum));
-    histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+    histogramBuilder.append("latency", static_cast<long long>(data.sum.loadRelaxed()));
+    histogramBuilder.append("ops", static_cast<long long>(data.entryCount.loadRelaxed()));
     histogramBuilder.doneFast();
 }
 
@@ -149,14 +249,39 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
     }
 }
 
+// Values below kSubBuckets have a bucket each. Above, each power of two is split into kSubBuckets
+// buckets selected by the kSubBucketBits bits that follow the most significant bit.
+int OperationLatencyHistogram::_getFineBucket(uint64_t value) {
+    if (value < kSubBuckets) {
+        return value;
+    }
+
+    int log2 = 63 - countLeadingZeros64(value);
+    if (log2 > kMaxLog2) {
+        return kMaxFineBuckets - 1;
+    }
+    int subBucket = (value >> (log2 - kSubBucketBits)) & (kSubBuckets - 1);
+    return (log2 - kSubBucketBits + 1) * kSubBuckets + subBucket;
+}
+
+uint64_t OperationLatencyHistogram::_getFineBucketLowerBound(int fineBucket) {
+    if (fineBucket < kSubBuckets) {
+        return fineBucket;
+    }
+
+    int shift = fineBucket / kSubBuckets - 1;
+    uint64_t mantissa = kSubBuckets + fineBucket % kSubBuckets;
+    return mantissa << shift;
+}
+
 void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, HistogramData* data) {
-    data->buckets[bucket]++;
-    data->entryCount++;
-    data->sum += latency;
+    data->getBuckets()[bucket].fetchAndAddRelaxed(1);
+    data->entryCount.fetchAndAddRelaxed(1);
+    data->sum.fetchAndAddRelaxed(latency);
 }
 
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
-    int bucket = _getBucket(latency);
+    int bucket = _getFineBucket(latency);
     switch (type) {
         case Command::ReadWriteType::kRead:
             _incrementData(latency, bucket, &_reads);
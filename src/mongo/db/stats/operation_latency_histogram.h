@@ -31,6 +31,7 @@
 #include <array>
 
 #include "mongo/db/commands.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -40,7 +41,12 @@ class BSONObjBuilder;
  * Stores statistics for latencies of read, write, command, and multi-document transaction
  * operations.
  *
- * Note: This class is not thread-safe.
+ * Latencies are counted in buckets that split every power of two into kSubBuckets equal parts, so
+ * a percentile computed from the buckets is within 1/kSubBuckets of the actual value. The coarser
+ * reported histogram, whose bucket bounds are given by kLowerBounds, is derived from them.
+ *
+ * Increments may run concurrently with each other and with append(). Appending while operations
+ * complete may observe a count and a latency total from slightly different points in time.
  */
 class OperationLatencyHistogram {
 public:
@@ -49,25 +55,68 @@ public:
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
 
+    // Number of equal parts each power of two is split into for counting.
+    static const int kSubBucketBits = 3;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+
+    // Latencies at or above 2^(kMaxLog2 + 1) are counted in the last bucket.
+    static const int kMaxLog2 = 40;
+    static const int kMaxFineBuckets = (kMaxLog2 - kSubBucketBits + 2) * kSubBuckets;
+
+    OperationLatencyHistogram() = default;
+    OperationLatencyHistogram(const OperationLatencyHistogram& other);
+    OperationLatencyHistogram& operator=(const OperationLatencyHistogram& other);
+
     /**
      * Increments the bucket of the histogram based on the operation type.
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
     /**
-     * Appends the four histograms with latency totals and operation counts.
+     * Adds the counts of 'other' to this histogram.
+     */
+    void merge(const OperationLatencyHistogram& other);
+
+    /**
+     * Appends the four histograms with latency totals and operation counts. With
+     * 'includeHistograms', also appends the bucket counts and the 50th, 95th, 99th and 99.9th
+     * percentile latencies of each histogram.
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
 private:
     struct HistogramData {
-        std::array<uint64_t, kMaxBuckets> buckets{};
-        uint64_t entryCount = 0;
-        uint64_t sum = 0;
+        using Buckets = std::array<AtomicWord<unsigned long long>, kMaxFineBuckets>;
+
+        HistogramData() = default;
+        HistogramData(const HistogramData& other) {
+            *this = other;
+        }
+        HistogramData& operator=(const HistogramData& other);
+        ~HistogramData() {
+            delete buckets.load();
+        }
+
+        /**
+         * Returns the bucket counts, allocating them if this is the first latency recorded.
+         */
+        Buckets& getBuckets();
+
+        void merge(const HistogramData& other);
+
+        // Null until the first latency is recorded. Every namespace has a histogram for each
+        // operation type, but most namespaces only see some of the types.
+        AtomicWord<Buckets*> buckets{nullptr};
+        AtomicWord<unsigned long long> entryCount{0};
+        AtomicWord<unsigned long long> sum{0};
     };
 
     static int _getBucket(uint64_t latency);
 
+    static int _getFineBucket(uint64_t latency);
+
+    static uint64_t _getFineBucketLowerBound(int fineBucket);
+
     static uint64_t _getBucketMicros(int bucket);
 
     void _append(const HistogramData& data,
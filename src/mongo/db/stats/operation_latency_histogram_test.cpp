@@ -34,6 +34,8 @@
 #include <array>
 #include <iostream>
 #include <numeric>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/db/commands.h"
@@ -92,4 +94,65 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, PercentilesAreWithinSubBucketPrecision) {
+    OperationLatencyHistogram hist;
+    for (uint64_t latency = 1; latency <= 100000; latency++) {
+        hist.increment(latency, Command::ReadWriteType::kWrite);
+    }
+    BSONObjBuilder outBuilder;
+    hist.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+
+    // Latencies are spread evenly, so the pN latency is about N thousand micros.
+    const double precision = 1.0 / OperationLatencyHistogram::kSubBuckets;
+    BSONObj percentiles = out["writes"]["percentiles"].Obj();
+    const std::vector<std::pair<std::string, double>> expectedPercentiles = {
+        {"p50", 50000}, {"p95", 95000}, {"p99", 99000}, {"p999", 99900}};
+    for (const auto& expected : expectedPercentiles) {
+        ASSERT_APPROX_EQUAL(percentiles[expected.first].Long(),
+                            expected.second,
+                            expected.second * precision);
+    }
+
+    // Histograms without latencies have no percentiles.
+    ASSERT_FALSE(out["reads"].Obj().hasField("percentiles"));
+}
+
+TEST(OperationLatencyHistogram, PercentilesOfSingleLatency) {
+    OperationLatencyHistogram hist;
+    hist.increment(3, Command::ReadWriteType::kCommand);
+    BSONObjBuilder outBuilder;
+    hist.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_BSONOBJ_EQ(out["commands"]["percentiles"].Obj(),
+                      BSON("p50" << 3LL << "p95" << 3LL << "p99" << 3LL << "p999" << 3LL));
+}
+
+TEST(OperationLatencyHistogram, MergeAddsCounts) {
+    OperationLatencyHistogram first;
+    OperationLatencyHistogram second;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        first.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        second.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        second.increment(kLowerBounds[i], Command::ReadWriteType::kTransaction);
+    }
+    OperationLatencyHistogram merged(first);
+    merged.merge(second);
+
+    BSONObjBuilder outBuilder;
+    merged.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 2 * kMaxBuckets);
+    ASSERT_EQUALS(out["transactions"]["ops"].Long(), kMaxBuckets);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 0);
+    for (auto&& bucket : out["reads"]["histogram"].Array()) {
+        ASSERT_EQUALS(bucket["count"].Long(), 2);
+    }
+
+    // Merging does not change the histogram merged from.
+    BSONObjBuilder firstBuilder;
+    first.append(false, &firstBuilder);
+    ASSERT_EQUALS(firstBuilder.done()["reads"]["ops"].Long(), kMaxBuckets);
+}
 }  // namespace mongo
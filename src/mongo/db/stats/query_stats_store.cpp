@@ -0,0 +1,250 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_stats_store_gen.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+constexpr StringData kRedactedValue = "?"_sd;
+
+size_t getLatencyBucket(long long micros) {
+    if (micros <= 0) {
+        return 0;
+    }
+    const size_t bucket = 64 - countLeadingZeros64(static_cast<unsigned long long>(micros));
+    return std::min(bucket, QueryStatsStore::kNumLatencyBuckets - 1);
+}
+
+long long getLatencyBucketLowerBound(size_t bucket) {
+    return bucket == 0 ? 0 : 1LL << (bucket - 1);
+}
+
+bool isArrayOfObjects(const BSONObj& array) {
+    for (auto&& elem : array) {
+        if (elem.type() != BSONType::Object) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void appendRedacted(const BSONObj& obj, BSONObjBuilder* builder);
+
+void appendRedactedElement(const BSONElement& elem, BSONObjBuilder* builder) {
+    const auto fieldName = elem.fieldNameStringData();
+    switch (elem.type()) {
+        case BSONType::Object: {
+            BSONObjBuilder subBuilder(builder->subobjStart(fieldName));
+            appendRedacted(elem.embeddedObject(), &subBuilder);
+            break;
+        }
+        case BSONType::Array:
+            if (isArrayOfObjects(elem.embeddedObject())) {
+                BSONArrayBuilder arrayBuilder(builder->subarrayStart(fieldName));
+                for (auto&& subElem : elem.embeddedObject()) {
+                    BSONObjBuilder subBuilder(arrayBuilder.subobjStart());
+                    appendRedacted(subElem.embeddedObject(), &subBuilder);
+                }
+            } else {
+                builder->append(fieldName, kRedactedValue);
+            }
+            break;
+        case BSONType::String:
+            if (elem.valueStringData().startsWith("$")) {
+                builder->append(elem);
+            } else {
+                builder->append(fieldName, kRedactedValue);
+            }
+            break;
+        default:
+            builder->append(fieldName, kRedactedValue);
+    }
+}
+
+void appendRedacted(const BSONObj& obj, BSONObjBuilder* builder) {
+    for (auto&& elem : obj) {
+        appendRedactedElement(elem, builder);
+    }
+}
+
+}  // namespace
+
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+BSONObj QueryStatsStore::redactLiterals(const BSONObj& obj) {
+    BSONObjBuilder builder;
+    appendRedacted(obj, &builder);
+    return builder.obj();
+}
+
+void QueryStatsStore::Metric::add(long long value) {
+    sum += value;
+    max = std::max(max, value);
+}
+
+void QueryStatsStore::Metric::append(StringData name, BSONObjBuilder* builder) const {
+    BSONObjBuilder metricBuilder(builder->subobjStart(name));
+    metricBuilder.append("sum", sum);
+    metricBuilder.append("max", max);
+}
+
+BSONObj QueryStatsStore::Entry::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("shape", shape);
+    builder.append("planSummary", planSummary);
+    builder.append("firstSeen", firstSeen);
+    builder.append("lastSeen", lastSeen);
+    builder.append("execCount", execCount);
+    builder.append("getMoreCount", getMoreCount);
+    builder.append("errorCount", errorCount);
+    keysExamined.append("keysExamined", &builder);
+    docsExamined.append("docsExamined", &builder);
+    nreturned.append("nreturned", &builder);
+    bytesReturned.append("bytesReturned", &builder);
+
+    BSONObjBuilder latencyBuilder(builder.subobjStart("latencyMicros"));
+    latencyBuilder.append("sum", latencyMicros.sum);
+    latencyBuilder.append("min", minLatencyMicros);
+    latencyBuilder.append("max", latencyMicros.max);
+    BSONArrayBuilder histogramBuilder(latencyBuilder.subarrayStart("histogram"));
+    for (size_t bucket = 0; bucket < kNumLatencyBuckets; ++bucket) {
+        if (latencyBuckets[bucket] == 0) {
+            continue;
+        }
+        BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+        entryBuilder.append("micros", getLatencyBucketLowerBound(bucket));
+        entryBuilder.append("count", latencyBuckets[bucket]);
+    }
+    histogramBuilder.doneFast();
+    latencyBuilder.doneFast();
+
+    return builder.obj();
+}
+
+void QueryStatsStore::record(StringData key,
+                             const BSONObj& shape,
+                             StringData planSummary,
+                             const OperationStats& stats) {
+    const auto maxEntries = queryStatsMaxEntries.load();
+    if (maxEntries <= 0) {
+        return;
+    }
+    const size_t maxEntriesPerPartition =
+        std::max<size_t>(1, static_cast<size_t>(maxEntries) / kNumPartitions);
+
+    std::string keyString = key.toString();
+    auto& partition = _partitions[std::hash<std::string>()(keyString) % kNumPartitions];
+    const auto now = Date_t::now();
+
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.index.find(keyString);
+    if (it != partition.index.end()) {
+        partition.entries.splice(partition.entries.begin(), partition.entries, it->second);
+    } else {
+        while (partition.entries.size() >= maxEntriesPerPartition) {
+            partition.index.erase(partition.entries.back().key);
+            partition.entries.pop_back();
+        }
+        partition.entries.emplace_front();
+        partition.entries.front().key = keyString;
+        partition.entries.front().firstSeen = now;
+        partition.entries.front().minLatencyMicros = stats.executionMicros;
+        partition.index.emplace(std::move(keyString), partition.entries.begin());
+    }
+
+    auto& entry = partition.entries.front();
+    if (!shape.isEmpty()) {
+        entry.shape = shape.getOwned();
+    }
+    if (!planSummary.empty()) {
+        entry.planSummary = planSummary.toString();
+    }
+    entry.lastSeen = now;
+    if (stats.isGetMore) {
+        ++entry.getMoreCount;
+    } else {
+        ++entry.execCount;
+    }
+    if (stats.failed) {
+        ++entry.errorCount;
+    }
+    entry.keysExamined.add(stats.keysExamined);
+    entry.docsExamined.add(stats.docsExamined);
+    entry.nreturned.add(stats.nreturned);
+    entry.bytesReturned.add(stats.bytesReturned);
+    entry.latencyMicros.add(stats.executionMicros);
+    entry.minLatencyMicros = std::min(entry.minLatencyMicros, stats.executionMicros);
+    ++entry.latencyBuckets[getLatencyBucket(stats.executionMicros)];
+}
+
+std::vector<BSONObj> QueryStatsStore::toBSON() const {
+    std::vector<BSONObj> results;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (auto&& entry : partition.entries) {
+            results.push_back(entry.toBSON());
+        }
+    }
+    return results;
+}
+
+void QueryStatsStore::clear() {
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.index.clear();
+        partition.entries.clear();
+    }
+}
+
+size_t QueryStatsStore::size() const {
+    size_t size = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        size += partition.entries.size();
+    }
+    return size;
+}
+
+}  // namespace mongo
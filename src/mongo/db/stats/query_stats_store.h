@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Aggregates the execution statistics of queries by query shape.
+ *
+ * An operation that runs a query or an aggregation records its statistics under the shape of that
+ * query when it completes. A shape is identified by a key chosen by the operation, which omits the
+ * literal values of the query, and is described by a document with the literal values redacted.
+ *
+ * The store is bounded by the 'queryStatsMaxEntries' server parameter. It is split into partitions
+ * by the hash of the key, so that concurrent operations rarely contend on the same mutex, and each
+ * partition discards its least recently executed shapes when it is full.
+ */
+class QueryStatsStore {
+    MONGO_DISALLOW_COPYING(QueryStatsStore);
+
+public:
+    static constexpr size_t kNumPartitions = 16;
+
+    // Latencies are counted in buckets whose upper bounds are successive powers of two.
+    static constexpr size_t kNumLatencyBuckets = 32;
+
+    /**
+     * The statistics of a single operation.
+     */
+    struct OperationStats {
+        bool isGetMore = false;
+        bool failed = false;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+        long long executionMicros = 0;
+    };
+
+    static QueryStatsStore& get(ServiceContext* service);
+
+    /**
+     * Returns 'obj' with every literal value replaced by "?". Objects are redacted recursively, as
+     * are arrays holding only objects, such as the clauses of an $or or the stages of a pipeline.
+     * Strings starting with '$', which name field paths and variables, are kept.
+     */
+    static BSONObj redactLiterals(const BSONObj& obj);
+
+    QueryStatsStore() = default;
+
+    /**
+     * Adds the statistics of an operation to those of the shape with the given key. 'shape' and
+     * 'planSummary' replace the ones recorded for the shape.
+     */
+    void record(StringData key,
+                const BSONObj& shape,
+                StringData planSummary,
+                const OperationStats& stats);
+
+    /**
+     * Returns one document for each query shape in the store.
+     */
+    std::vector<BSONObj> toBSON() const;
+
+    /**
+     * Discards the statistics of every query shape.
+     */
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct Metric {
+        void add(long long value);
+        void append(StringData name, BSONObjBuilder* builder) const;
+
+        long long sum = 0;
+        long long max = 0;
+    };
+
+    struct Entry {
+        std::string key;
+        BSONObj shape;
+        std::string planSummary;
+        Date_t firstSeen;
+        Date_t lastSeen;
+        long long execCount = 0;
+        long long getMoreCount = 0;
+        long long errorCount = 0;
+        Metric keysExamined;
+        Metric docsExamined;
+        Metric nreturned;
+        Metric bytesReturned;
+        Metric latencyMicros;
+        long long minLatencyMicros = 0;
+        std::array<long long, kNumLatencyBuckets> latencyBuckets{};
+
+        BSONObj toBSON() const;
+    };
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+
+        // Most recently executed shapes first.
+        std::list<Entry> entries;
+        stdx::unordered_map<std::string, std::list<Entry>::iterator> index;
+    };
+
+    std::array<Partition, kNumPartitions> _partitions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/stats/query_stats_store_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+QueryStatsStore::OperationStats makeStats(long long docsExamined, long long executionMicros) {
+    QueryStatsStore::OperationStats stats;
+    stats.docsExamined = docsExamined;
+    stats.nreturned = 1;
+    stats.executionMicros = executionMicros;
+    return stats;
+}
+
+/**
+ * Sets 'queryStatsMaxEntries' for the lifetime of the object.
+ */
+class MaxEntriesGuard {
+public:
+    explicit MaxEntriesGuard(int maxEntries) : _original(queryStatsMaxEntries.load()) {
+        queryStatsMaxEntries.store(maxEntries);
+    }
+
+    ~MaxEntriesGuard() {
+        queryStatsMaxEntries.store(_original);
+    }
+
+private:
+    const int _original;
+};
+
+TEST(QueryStatsStoreTest, RedactLiteralsReplacesValuesAndKeepsStructure) {
+    auto redacted = QueryStatsStore::redactLiterals(
+        BSON("a" << 1 << "b" << BSON("$gt" << 5) << "$or"
+                 << BSON_ARRAY(BSON("c"
+                                    << "x")
+                               << BSON("d" << BSON("$in" << BSON_ARRAY(1 << 2))))
+                 << "e"
+                 << "$f"));
+    ASSERT_BSONOBJ_EQ(redacted,
+                      BSON("a"
+                           << "?"
+                           << "b"
+                           << BSON("$gt"
+                                   << "?")
+                           << "$or"
+                           << BSON_ARRAY(BSON("c"
+                                              << "?")
+                                         << BSON("d" << BSON("$in"
+                                                             << "?")))
+                           << "e"
+                           << "$f"));
+}
+
+TEST(QueryStatsStoreTest, StatisticsAreAggregatedByKey) {
+    QueryStatsStore store;
+    const auto shape = BSON("filter" << BSON("a"
+                                             << "?"));
+
+    store.record("a", shape, "IXSCAN { a: 1 }", makeStats(1, 10));
+    store.record("a", shape, "IXSCAN { a: 1 }", makeStats(3, 1000));
+    auto getMore = makeStats(5, 100);
+    getMore.isGetMore = true;
+    store.record("a", BSONObj(), "", getMore);
+    store.record("b", shape, "COLLSCAN", makeStats(7, 10));
+
+    ASSERT_EQ(2U, store.size());
+    auto results = store.toBSON();
+    ASSERT_EQ(2U, results.size());
+    const auto& entry =
+        results[0]["planSummary"].String() == "COLLSCAN" ? results[1] : results[0];
+
+    ASSERT_BSONOBJ_EQ(shape, entry["shape"].Obj());
+    ASSERT_EQ("IXSCAN { a: 1 }", entry["planSummary"].String());
+    ASSERT_EQ(2, entry["execCount"].numberLong());
+    ASSERT_EQ(1, entry["getMoreCount"].numberLong());
+    ASSERT_EQ(0, entry["errorCount"].numberLong());
+    ASSERT_BSONOBJ_EQ(BSON("sum" << 9LL << "max" << 5LL), entry["docsExamined"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("sum" << 3LL << "max" << 1LL), entry["nreturned"].Obj());
+
+    const auto latency = entry["latencyMicros"].Obj();
+    ASSERT_EQ(1110, latency["sum"].numberLong());
+    ASSERT_EQ(10, latency["min"].numberLong());
+    ASSERT_EQ(1000, latency["max"].numberLong());
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(BSON("micros" << 8LL << "count" << 1LL)
+                                 << BSON("micros" << 64LL << "count" << 1LL)
+                                 << BSON("micros" << 512LL << "count" << 1LL)),
+                      latency["histogram"].Obj());
+}
+
+TEST(QueryStatsStoreTest, LeastRecentlyExecutedShapesAreEvicted) {
+    MaxEntriesGuard guard(QueryStatsStore::kNumPartitions);
+    QueryStatsStore store;
+
+    for (int i = 0; i < 1000; ++i) {
+        store.record(std::to_string(i), BSON("i" << i), "", makeStats(1, 1));
+    }
+    ASSERT_LTE(store.size(), QueryStatsStore::kNumPartitions);
+    ASSERT_GT(store.size(), 0U);
+
+    // The shape recorded last is never the least recently executed one of its partition.
+    bool foundLast = false;
+    for (auto&& entry : store.toBSON()) {
+        foundLast = foundLast || entry["shape"]["i"].numberInt() == 999;
+    }
+    ASSERT_TRUE(foundLast);
+}
+
+TEST(QueryStatsStoreTest, ZeroMaxEntriesDisablesRecording) {
+    MaxEntriesGuard guard(0);
+    QueryStatsStore store;
+
+    store.record("a", BSONObj(), "", makeStats(1, 1));
+    ASSERT_EQ(0U, store.size());
+}
+
+TEST(QueryStatsStoreTest, ClearDiscardsAllShapes) {
+    QueryStatsStore store;
+    store.record("a", BSONObj(), "", makeStats(1, 1));
+    store.record("b", BSONObj(), "", makeStats(1, 1));
+    ASSERT_EQ(2U, store.size());
+
+    store.clear();
+    ASSERT_EQ(0U, store.size());
+    ASSERT_TRUE(store.toBSON().empty());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -208,21 +209,27 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
 
+OperationLatencyHistogram& Top::_globalHistogramStripe() {
+    auto threadHash = std::hash<stdx::thread::id>()(stdx::this_thread::get_id());
+    return _globalHistogramStats[threadHash % kGlobalHistogramStripes];
+}
+
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    _incrementHistogram(opCtx, latency, &_globalHistogramStripe(), readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram globalHistogramStats;
+    for (const auto& stripe : _globalHistogramStats) {
+        globalHistogramStats.merge(stripe);
+    }
+    globalHistogramStats.append(includeHistograms, builder);
 }
 
 void Top::incrementGlobalTransactionLatencyStats(uint64_t latency) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
+    _globalHistogramStripe().increment(latency, Command::ReadWriteType::kTransaction);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
@@ -33,6 +33,7 @@
  * DB usage monitor.
  */
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/db/commands.h"
@@ -149,8 +150,18 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
+    /**
+     * Returns the stripe of the global histogram that the current thread records into.
+     */
+    OperationLatencyHistogram& _globalHistogramStripe();
+
+    // Every operation records its latency in the global histogram, so it is striped by thread to
+    // spread concurrent increments over separate counters, and does not need '_lock'. The stripes
+    // are added together when the histogram is read.
+    static constexpr size_t kGlobalHistogramStripes = 16;
+    std::array<OperationLatencyHistogram, kGlobalHistogramStripes> _globalHistogramStats;
+
     mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
     UsageMap _usage;
     std::set<std::string> _collDropNs;
 };
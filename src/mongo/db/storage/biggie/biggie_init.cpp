@@ -29,9 +29,12 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem/path.hpp>
+
 #include "mongo/base/init.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/biggie/biggie_parameters_gen.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/storage_engine_init.h"
 #include "mongo/db/storage/storage_options.h"
@@ -47,6 +50,12 @@ public:
         KVStorageEngineOptions options;
         options.directoryPerDB = params.directoryperdb;
         options.forRepair = params.repair;
+        if (gBiggieSnapshotIntervalSecs > 0) {
+            auto snapshotPath = boost::filesystem::path(params.dbpath) / "biggie.snapshot";
+            return new KVStorageEngine(
+                new KVEngine(snapshotPath.string(), Seconds(gBiggieSnapshotIntervalSecs)),
+                options);
+        }
         return new KVStorageEngine(new KVEngine(), options);
     }
 
@@ -31,7 +31,14 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/base/checked_cast.h"
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/client.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/snapshot_window_options.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
@@ -39,11 +46,233 @@
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/db/storage/storage_file_util.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace biggie {
 
+namespace {
+// Snapshots start with this magic string, followed by the idents and then the master's entries.
+// Every string is written as its little-endian 64-bit size followed by its bytes.
+const auto kSnapshotMagic = "biggie-snapshot-v1"_sd;
+
+void writeString(std::ostream& out, StringData str) {
+    char size[sizeof(uint64_t)];
+    DataView(size).write<LittleEndian<uint64_t>>(str.size());
+    out.write(size, sizeof(size));
+    out.write(str.rawData(), str.size());
+}
+
+void writeCount(std::ostream& out, uint64_t count) {
+    char buf[sizeof(uint64_t)];
+    DataView(buf).write<LittleEndian<uint64_t>>(count);
+    out.write(buf, sizeof(buf));
+}
+
+bool readCount(std::istream& in, uint64_t* count) {
+    char buf[sizeof(uint64_t)];
+    if (!in.read(buf, sizeof(buf)))
+        return false;
+    *count = ConstDataView(buf).read<LittleEndian<uint64_t>>();
+    return true;
+}
+
+bool readString(std::istream& in, std::string* str) {
+    uint64_t size;
+    if (!readCount(in, &size))
+        return false;
+    str->resize(size);
+    return static_cast<bool>(in.read(&(*str)[0], size));
+}
+}  // namespace
+
+KVEngine::KVEngine(std::string snapshotPath, Seconds snapshotInterval)
+    : mongo::KVEngine(),
+      _snapshotPath(std::move(snapshotPath)),
+      _snapshotInterval(snapshotInterval) {
+    invariant(_snapshotInterval > Seconds(0));
+
+    Timer timer;
+    Status status = loadSnapshot(_snapshotPath);
+    if (status.isOK()) {
+        log() << "Restored biggie snapshot " << _snapshotPath << " with "
+              << getMasterInfo().second.size() << " entries in " << timer.millis() << "ms";
+    } else if (status != ErrorCodes::NoSuchKey) {
+        uassertStatusOKWithContext(status, "Failed to restore biggie snapshot");
+    }
+
+    _snapshotThreadHandle = stdx::thread([this] { _snapshotThread(); });
+}
+
+KVEngine::~KVEngine() {
+    if (_snapshotThreadHandle.joinable()) {
+        {
+            stdx::lock_guard<stdx::mutex> lock(_snapshotThreadMutex);
+            _snapshotThreadShutdown = true;
+        }
+        _snapshotThreadCond.notify_one();
+        _snapshotThreadHandle.join();
+    }
+}
+
+void KVEngine::cleanShutdown() {
+    if (!_snapshotThreadHandle.joinable())
+        return;
+
+    {
+        stdx::lock_guard<stdx::mutex> lock(_snapshotThreadMutex);
+        _snapshotThreadShutdown = true;
+    }
+    _snapshotThreadCond.notify_one();
+    _snapshotThreadHandle.join();
+
+    Status status = saveSnapshot(_snapshotPath);
+    if (!status.isOK()) {
+        error() << "Failed to save biggie snapshot at shutdown: " << status;
+    }
+}
+
+void KVEngine::_snapshotThread() {
+    Client::initThread("BiggieSnapshot");
+
+    stdx::unique_lock<stdx::mutex> lock(_snapshotThreadMutex);
+    while (true) {
+        MONGO_IDLE_THREAD_BLOCK;
+        if (_snapshotThreadCond.wait_for(lock, _snapshotInterval.toSystemDuration(), [&] {
+                return _snapshotThreadShutdown;
+            })) {
+            return;
+        }
+
+        lock.unlock();
+        Timer timer;
+        Status status = saveSnapshot(_snapshotPath);
+        if (status.isOK()) {
+            LOG(1) << "Saved biggie snapshot in " << timer.millis() << "ms";
+        } else {
+            warning() << "Failed to save biggie snapshot: " << status;
+        }
+        lock.lock();
+    }
+}
+
+Status KVEngine::saveSnapshot(const std::string& path) {
+    // Copying the master is cheap, since the copy shares all nodes with it, and commits made
+    // while the copy is written out never modify those nodes. The idents are copied under the
+    // same lock so that the snapshot never has data for an ident it does not know about.
+    StringStore master;
+    std::map<std::string, bool> idents;
+    {
+        stdx::lock_guard<stdx::mutex> masterLock(_masterLock);
+        stdx::lock_guard<stdx::mutex> identsLock(_identsLock);
+        master = _master;
+        idents = _idents;
+    }
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return {ErrorCodes::FileOpenFailed,
+                    str::stream() << "Could not open " << tmpPath << " for writing"};
+        }
+
+        out.write(kSnapshotMagic.rawData(), kSnapshotMagic.size());
+        writeCount(out, idents.size());
+        for (auto&& ident : idents) {
+            writeString(out, ident.first);
+            out.put(ident.second ? 1 : 0);
+        }
+        writeCount(out, master.size());
+        for (auto&& entry : master) {
+            writeString(out, entry.first);
+            writeString(out, entry.second);
+        }
+
+        out.close();
+        if (!out) {
+            return {ErrorCodes::FileStreamFailed,
+                    str::stream() << "Could not write biggie snapshot to " << tmpPath};
+        }
+    }
+
+    // The snapshot must be on disk before it replaces the previous one, and the rename must be on
+    // disk before the snapshot is relied upon.
+    Status status = fsyncFile(tmpPath);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        return {ErrorCodes::FileRenameFailed,
+                str::stream() << "Could not rename " << tmpPath << " to " << path << ": "
+                              << ec.message()};
+    }
+    return fsyncParentDirectory(boost::filesystem::absolute(path));
+}
+
+Status KVEngine::loadSnapshot(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return {ErrorCodes::NoSuchKey, str::stream() << "No biggie snapshot at " << path};
+    }
+
+    auto corrupt = [&] {
+        return Status(ErrorCodes::InvalidBSON,
+                      str::stream() << "The biggie snapshot at " << path << " is corrupt");
+    };
+
+    std::string magic(kSnapshotMagic.size(), '\0');
+    if (!in.read(&magic[0], magic.size()) || magic != kSnapshotMagic)
+        return corrupt();
+
+    uint64_t numIdents;
+    if (!readCount(in, &numIdents))
+        return corrupt();
+    std::map<std::string, bool> idents;
+    for (uint64_t i = 0; i < numIdents; ++i) {
+        std::string ident;
+        char isRecordStore;
+        if (!readString(in, &ident) || !in.get(isRecordStore))
+            return corrupt();
+        idents[ident] = isRecordStore != 0;
+    }
+
+    uint64_t numEntries;
+    if (!readCount(in, &numEntries))
+        return corrupt();
+    StringStore store;
+    for (uint64_t i = 0; i < numEntries; ++i) {
+        std::string key;
+        std::string value;
+        if (!readString(in, &key) || !readString(in, &value))
+            return corrupt();
+        store.insert(StringStore::value_type(std::move(key), std::move(value)));
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> masterLock(_masterLock);
+        stdx::lock_guard<stdx::mutex> identsLock(_identsLock);
+        _master = std::move(store);
+        _masterVersion++;
+        _idents = std::move(idents);
+    }
+    _restoredFromSnapshot = true;
+    return Status::OK();
+}
+
+void KVEngine::_setIdent(StringData ident, bool isRecordStore) {
+    stdx::lock_guard<stdx::mutex> lock(_identsLock);
+    _idents[ident.toString()] = isRecordStore;
+}
+
 mongo::RecoveryUnit* KVEngine::newRecoveryUnit() {
     return new RecoveryUnit(this, nullptr);
 }
@@ -56,7 +285,7 @@ Status KVEngine::createRecordStore(OperationContext* opCtx,
                                    StringData ns,
                                    StringData ident,
                                    const CollectionOptions& options) {
-    _idents[ident.toString()] = true;
+    _setIdent(ident, true);
     return Status::OK();
 }
 
@@ -64,7 +293,7 @@ std::unique_ptr<mongo::RecordStore> KVEngine::makeTemporaryRecordStore(Operation
                                                                        StringData ident) {
     std::unique_ptr<mongo::RecordStore> recordStore =
         std::make_unique<RecordStore>("", ident, false);
-    _idents[ident.toString()] = true;
+    _setIdent(ident, true);
     return recordStore;
 };
 
@@ -88,7 +317,10 @@ std::unique_ptr<mongo::RecordStore> KVEngine::getRecordStore(OperationContext* o
     } else {
         recordStore = std::make_unique<RecordStore>(ns, ident, options.capped);
     }
-    _idents[ident.toString()] = true;
+    if (_restoredFromSnapshot) {
+        checked_cast<RecordStore*>(recordStore.get())->initStatsFromStore(getMasterInfo().second);
+    }
+    _setIdent(ident, true);
     return recordStore;
 }
 
@@ -102,27 +334,42 @@ bool KVEngine::trySwapMaster(StringStore& newMaster, uint64_t version) {
     return true;
 }
 
+void KVEngine::mergeAndSwapMaster(StringStore& newMaster, const StringStore& base) {
+    stdx::lock_guard<stdx::mutex> lock(_masterLock);
+    newMaster.merge3(base, _master);
+    invariant(!newMaster.hasBranch() && !_master.hasBranch());
+    _master = newMaster;
+    _masterVersion++;
+}
+
 
 Status KVEngine::createSortedDataInterface(OperationContext* opCtx,
                                            StringData ident,
                                            const IndexDescriptor* desc) {
-    _idents[ident.toString()] = false;
+    _setIdent(ident, false);
     return Status::OK();  // I don't think we actually need to do anything here
 }
 
 mongo::SortedDataInterface* KVEngine::getSortedDataInterface(OperationContext* opCtx,
                                                              StringData ident,
                                                              const IndexDescriptor* desc) {
-    _idents[ident.toString()] = false;
+    _setIdent(ident, false);
     return new SortedDataInterface(opCtx, ident, desc);
 }
 
 Status KVEngine::dropIdent(OperationContext* opCtx, StringData ident) {
     Status dropStatus = Status::OK();
-    if (_idents.count(ident.toString()) > 0) {
+    boost::optional<bool> isRecordStore;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_identsLock);
+        auto it = _idents.find(ident.toString());
+        if (it != _idents.end())
+            isRecordStore = it->second;
+    }
+    if (isRecordStore) {
         // Check if the ident is a RecordStore or a SortedDataInterface then call the corresponding
         // truncate. A true value in the map means it is a RecordStore, false a SortedDataInterface.
-        if (_idents[ident.toString()] == true) {  // ident is RecordStore.
+        if (*isRecordStore) {  // ident is RecordStore.
             CollectionOptions s;
             auto rs = getRecordStore(opCtx, ""_sd, ident, s);
             dropStatus = checked_cast<RecordStore*>(rs.get())
@@ -133,6 +380,7 @@ Status KVEngine::dropIdent(OperationContext* opCtx, StringData ident) {
                 std::make_unique<SortedDataInterface>(Ordering::make(BSONObj()), true, ident);
             dropStatus = sdi->truncate(opCtx);
         }
+        stdx::lock_guard<stdx::mutex> lock(_identsLock);
         _idents.erase(ident.toString());
     }
     return dropStatus;
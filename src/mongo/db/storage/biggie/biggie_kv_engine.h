@@ -37,6 +37,10 @@
 #include "mongo/db/storage/biggie/biggie_sorted_impl.h"
 #include "mongo/db/storage/biggie/store.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace biggie {
@@ -49,7 +53,13 @@ class KVEngine : public mongo::KVEngine {
 public:
     KVEngine() : mongo::KVEngine() {}
 
-    virtual ~KVEngine() {}
+    /**
+     * Constructs an engine that restores the snapshot at 'snapshotPath', if there is one, and
+     * saves a new snapshot there every 'snapshotInterval' and on clean shutdown.
+     */
+    KVEngine(std::string snapshotPath, Seconds snapshotInterval);
+
+    virtual ~KVEngine();
 
     virtual mongo::RecoveryUnit* newRecoveryUnit();
 
@@ -125,6 +135,7 @@ public:
     }
 
     std::vector<std::string> getAllIdents(OperationContext* opCtx) const {
+        stdx::lock_guard<stdx::mutex> lock(_identsLock);
         std::vector<std::string> idents;
         for (const auto& i : _idents) {
             idents.push_back(i.first);
@@ -132,7 +143,7 @@ public:
         return idents;
     }
 
-    virtual void cleanShutdown(){};
+    virtual void cleanShutdown();
 
     void setJournalListener(mongo::JournalListener* jl) final {}
 
@@ -161,12 +172,50 @@ public:
      */
     bool trySwapMaster(StringStore& newMaster, uint64_t version);
 
+    /**
+     * Merges the changes made to the master since 'base' into 'newMaster' and swaps _master to the
+     * result, all while holding the master lock so that no other commit can intervene. Throws
+     * merge_conflict_exception, leaving _master unchanged, if the changes conflict.
+     */
+    void mergeAndSwapMaster(StringStore& newMaster, const StringStore& base);
+
+    /**
+     * Writes the committed contents of the engine to 'path'. Any previous snapshot at 'path' is
+     * only replaced once the new one is complete.
+     */
+    Status saveSnapshot(const std::string& path);
+
+    /**
+     * Replaces the contents of the engine with the snapshot at 'path'. Returns NoSuchKey if there
+     * is no snapshot at 'path'.
+     */
+    Status loadSnapshot(const std::string& path);
+
 private:
+    void _setIdent(StringData ident, bool isRecordStore);
+
+    void _snapshotThread();
+
     std::shared_ptr<void> _catalogInfo;
     int _cachePressureForTest = 0;
+
+    mutable stdx::mutex _identsLock;      // Guards _idents. Taken after _masterLock if both are.
     std::map<std::string, bool> _idents;  // TODO : replace with a query to _master.
     std::unique_ptr<VisibilityManager> _visibilityManager;
 
+    // Where snapshots are saved, or empty if the engine keeps no data across restarts.
+    std::string _snapshotPath;
+    Seconds _snapshotInterval{0};
+
+    // Set once a snapshot has been restored. Record stores opened afterwards count the records
+    // already in the master.
+    bool _restoredFromSnapshot = false;
+
+    stdx::mutex _snapshotThreadMutex;  // Guards _snapshotThreadShutdown.
+    stdx::condition_variable _snapshotThreadCond;
+    bool _snapshotThreadShutdown = false;
+    stdx::thread _snapshotThreadHandle;
+
     mutable stdx::mutex _masterLock;
     StringStore _master;
     uint64_t _masterVersion = 0;
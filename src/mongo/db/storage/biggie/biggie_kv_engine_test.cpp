@@ -31,11 +31,18 @@
 
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 
+#include <boost/filesystem.hpp>
+#include <fstream>
+
 #include "mongo/base/init.h"
+#include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -69,5 +76,138 @@ MONGO_INITIALIZER(RegisterKVHarnessFactory)(InitializerContext*) {
     return Status::OK();
 }
 
+namespace {
+
+class BiggieSnapshotTest : public ServiceContextTest {
+protected:
+    BiggieSnapshotTest()
+        : _tempDir("biggie_snapshot_test"), _snapshotPath(_tempDir.path() + "/biggie.snapshot") {}
+
+    ServiceContext::UniqueOperationContext makeOpCtx(KVEngine* engine) {
+        auto opCtx = makeOperationContext();
+        opCtx->setRecoveryUnit(std::unique_ptr<mongo::RecoveryUnit>(engine->newRecoveryUnit()),
+                               WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+        return opCtx;
+    }
+
+    std::unique_ptr<mongo::RecordStore> getRecordStore(KVEngine* engine, OperationContext* opCtx) {
+        ASSERT_OK(engine->createRecordStore(opCtx, "a.b", "collection-ident", CollectionOptions()));
+        return engine->getRecordStore(opCtx, "a.b", "collection-ident", CollectionOptions());
+    }
+
+    RecordId insert(OperationContext* opCtx, mongo::RecordStore* rs, const std::string& data) {
+        WriteUnitOfWork wuow(opCtx);
+        auto id = rs->insertRecord(opCtx, data.c_str(), data.size() + 1, Timestamp());
+        ASSERT_OK(id);
+        wuow.commit();
+        return id.getValue();
+    }
+
+    /**
+     * Saves a snapshot of an engine with a collection of three records and an index, and returns
+     * the highest RecordId inserted.
+     */
+    RecordId saveSnapshot() {
+        KVEngine engine;
+        auto opCtx = makeOpCtx(&engine);
+        auto rs = getRecordStore(&engine, opCtx.get());
+        insert(opCtx.get(), rs.get(), "a");
+        insert(opCtx.get(), rs.get(), "bb");
+        auto lastId = insert(opCtx.get(), rs.get(), "ccc");
+        ASSERT_OK(engine.createSortedDataInterface(opCtx.get(), "index-ident", nullptr));
+        ASSERT_OK(engine.saveSnapshot(_snapshotPath));
+        return lastId;
+    }
+
+    std::string readSnapshotFile() {
+        std::ifstream in(_snapshotPath, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeSnapshotFile(const std::string& contents) {
+        std::ofstream out(_snapshotPath, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size());
+    }
+
+    unittest::TempDir _tempDir;
+    const std::string _snapshotPath;
+};
+
+TEST_F(BiggieSnapshotTest, LoadRestoresSavedContents) {
+    saveSnapshot();
+
+    KVEngine engine;
+    ASSERT_OK(engine.loadSnapshot(_snapshotPath));
+    auto opCtx = makeOpCtx(&engine);
+
+    auto idents = engine.getAllIdents(opCtx.get());
+    std::sort(idents.begin(), idents.end());
+    ASSERT_EQ(2U, idents.size());
+    ASSERT_EQ("collection-ident", idents[0]);
+    ASSERT_EQ("index-ident", idents[1]);
+
+    auto rs = engine.getRecordStore(opCtx.get(), "a.b", "collection-ident", CollectionOptions());
+    std::vector<std::string> records;
+    auto cursor = rs->getCursor(opCtx.get());
+    while (auto record = cursor->next()) {
+        records.push_back(record->data.data());
+    }
+    ASSERT_EQ(3U, records.size());
+    ASSERT_EQ("a", records[0]);
+    ASSERT_EQ("bb", records[1]);
+    ASSERT_EQ("ccc", records[2]);
+}
+
+TEST_F(BiggieSnapshotTest, SaveReplacesPreviousSnapshot) {
+    writeSnapshotFile("not a snapshot");
+    saveSnapshot();
+
+    KVEngine engine;
+    ASSERT_OK(engine.loadSnapshot(_snapshotPath));
+    ASSERT_FALSE(boost::filesystem::exists(_snapshotPath + ".tmp"));
+}
+
+TEST_F(BiggieSnapshotTest, RestoredRecordStoreRebuildsItsCounts) {
+    const auto lastId = saveSnapshot();
+
+    KVEngine engine(_snapshotPath, Seconds(3600));
+    auto opCtx = makeOpCtx(&engine);
+    auto rs = engine.getRecordStore(opCtx.get(), "a.b", "collection-ident", CollectionOptions());
+    ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(2 + 3 + 4, rs->dataSize(opCtx.get()));
+
+    // New records are not given the RecordIds of the restored ones.
+    ASSERT_GT(insert(opCtx.get(), rs.get(), "dddd"), lastId);
+    ASSERT_EQ(4, rs->numRecords(opCtx.get()));
+}
+
+TEST_F(BiggieSnapshotTest, LoadFailsWithoutSnapshot) {
+    KVEngine engine;
+    ASSERT_EQ(ErrorCodes::NoSuchKey, engine.loadSnapshot(_snapshotPath));
+}
+
+TEST_F(BiggieSnapshotTest, LoadRejectsCorruptSnapshot) {
+    writeSnapshotFile("not a snapshot");
+
+    KVEngine engine;
+    ASSERT_EQ(ErrorCodes::InvalidBSON, engine.loadSnapshot(_snapshotPath));
+    ASSERT_THROWS_CODE(
+        KVEngine(_snapshotPath, Seconds(3600)), AssertionException, ErrorCodes::InvalidBSON);
+}
+
+TEST_F(BiggieSnapshotTest, LoadRejectsTruncatedSnapshot) {
+    saveSnapshot();
+    const auto contents = readSnapshotFile();
+
+    // Cutting the snapshot anywhere leaves a count or a string incomplete.
+    for (size_t size : {contents.size() - 1, contents.size() / 2, size_t(10)}) {
+        writeSnapshotFile(contents.substr(0, size));
+        KVEngine engine;
+        ASSERT_EQ(ErrorCodes::InvalidBSON, engine.loadSnapshot(_snapshotPath));
+    }
+}
+
+}  // namespace
+
 }  // namespace biggie
 }  // namespace mongo
@@ -358,6 +358,21 @@ void RecordStore::updateStatsAfterRepair(OperationContext* opCtx,
     _dataSize.store(dataSize);
 }
 
+void RecordStore::initStatsFromStore(const StringStore& store) {
+    long long numRecords = 0;
+    long long dataSize = 0;
+    int64_t highestRecordId = 0;
+    auto end = store.upper_bound(_postfix);
+    for (auto it = store.lower_bound(_prefix); it != end; ++it) {
+        numRecords++;
+        dataSize += it->second.size();
+        highestRecordId = std::max(highestRecordId, extractRecordId(it->first).repr());
+    }
+    _numRecords.store(numRecords);
+    _dataSize.store(dataSize);
+    _highestRecordId.store(highestRecordId + 1);
+}
+
 void RecordStore::waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const {
     _visibilityManager->waitForAllEarlierOplogWritesToBeVisible(opCtx);
 }
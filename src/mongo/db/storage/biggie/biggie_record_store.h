@@ -117,6 +117,12 @@ public:
                                         long long numRecords,
                                         long long dataSize);
 
+    /**
+     * Sets the record count, data size and next record id from the records of this ident already
+     * in 'store'. Used when the engine restored its contents from a snapshot.
+     */
+    void initStatsFromStore(const StringStore& store);
+
 private:
     friend class VisibilityManagerChange;
 
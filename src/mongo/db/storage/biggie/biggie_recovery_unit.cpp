@@ -57,21 +57,21 @@ void RecoveryUnit::commitUnitOfWork() {
     invariant(_inUnitOfWork);
     if (_dirty) {
         invariant(_forked);
-        while (true) {
+        try {
+            // Merge optimistically without holding the master lock. Commits touching other
+            // collections and indexes rarely conflict, but any commit in between fails the swap.
             std::pair<uint64_t, StringStore> masterInfo = _KVEngine->getMasterInfo();
-            try {
-                _workingCopy.merge3(_mergeBase, masterInfo.second);
-            } catch (const merge_conflict_exception&) {
-                throw WriteConflictException();
-            }
+            _workingCopy.merge3(_mergeBase, masterInfo.second);
 
-            if (_KVEngine->trySwapMaster(_workingCopy, masterInfo.first)) {
-                // Merged successfully
-                break;
-            } else {
-                // Retry the merge, but update the mergeBase since some progress was made merging.
+            if (!_KVEngine->trySwapMaster(_workingCopy, masterInfo.first)) {
+                // Rather than retrying optimistically, which can repeatedly lose to other commits
+                // under concurrent writes, merge only what was committed since the first merge
+                // while holding the master lock.
                 _mergeBase = masterInfo.second;
+                _KVEngine->mergeAndSwapMaster(_workingCopy, _mergeBase);
             }
+        } catch (const merge_conflict_exception&) {
+            throw WriteConflictException();
         }
         _forked = false;
         _dirty = false;
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <boost/optional.hpp>
 #include <cstring>
@@ -191,25 +192,18 @@ public:
 
                 // Check the children right of the node that the iterator was at already. This way,
                 // there will be no backtracking in the traversal.
-                for (auto iter = oldKey + 1 + node->_children.begin();
-                     iter != node->_children.end();
-                     ++iter) {
-
-                    // If the node has a child, then the sub-tree must have a node with data that
-                    // has not yet been visited.
-                    if (*iter != nullptr) {
-
-                        // If the current node has data, return it and exit. If not, continue
-                        // following the nodes to find the next one with data. It is necessary to go
-                        // to the left-most node in this sub-tree.
-                        if ((*iter)->_data) {
-                            _current = iter->get();
-                            return;
-                        }
-                        _current = iter->get();
+                // If the node has such a child, then the sub-tree must have a node with data that
+                // has not yet been visited.
+                if (Node* child = node->_children.firstFrom(oldKey + 1)) {
+
+                    // If the current node has data, return it and exit. If not, continue following
+                    // the nodes to find the next one with data. It is necessary to go to the
+                    // left-most node in this sub-tree.
+                    _current = child;
+                    if (!child->_data) {
                         _traverseLeftSubtree();
-                        return;
                     }
+                    return;
                 }
             }
             return;
@@ -220,12 +214,7 @@ public:
             // '_current' is root. However, it cannot return the root, and hence at least 1
             // iteration of the while loop is required.
             do {
-                for (auto child : _current->_children) {
-                    if (child != nullptr) {
-                        _current = child.get();
-                        break;
-                    }
-                }
+                _current = _current->_children.firstFrom(0);
             } while (!_current->_data);
         }
 
@@ -399,14 +388,12 @@ public:
 
                 // After moving up in the tree, continue searching for neighboring nodes to see if
                 // they have data, moving from right to left.
-                for (int i = oldKey - 1; i >= 0; i--) {
-                    if (node->_children[i] != nullptr) {
-                        // If there is a sub-tree found, it must have data, therefore it's necessary
-                        // to traverse to the right most node.
-                        _current = node->_children[i].get();
-                        _traverseRightSubtree();
-                        return;
-                    }
+                if (Node* child = node->_children.lastBefore(oldKey)) {
+                    // If there is a sub-tree found, it must have data, therefore it's necessary
+                    // to traverse to the right most node.
+                    _current = child;
+                    _traverseRightSubtree();
+                    return;
                 }
 
                 // If there were no sub-trees that contained data, and the 'current' node has data,
@@ -421,15 +408,9 @@ public:
         void _traverseRightSubtree() {
             // This function traverses the given tree to the right most leaf of the subtree where
             // 'current' is the root.
-            do {
-                for (auto iter = _current->_children.rbegin(); iter != _current->_children.rend();
-                     ++iter) {
-                    if (*iter != nullptr) {
-                        _current = iter->get();
-                        break;
-                    }
-                }
-            } while (!_current->isLeaf());
+            while (!_current->isLeaf()) {
+                _current = _current->_children.lastBefore(256);
+            }
         }
 
         void updateTreeView(bool stopIfMultipleCursors = false) {
@@ -610,7 +591,7 @@ public:
 
             uint8_t childFirstChar = child->_trieKey.front();
             if (!isUniquelyOwned) {
-                parent->_children[childFirstChar] = std::make_shared<Node>(*child);
+                parent->_children.set(childFirstChar, std::make_shared<Node>(*child));
                 child = parent->_children[childFirstChar].get();
             }
 
@@ -618,7 +599,7 @@ public:
         }
 
         // Handle the deleted node, as it is a leaf.
-        parent->_children[deleted->_trieKey.front()] = nullptr;
+        parent->_children.set(deleted->_trieKey.front(), nullptr);
 
         // 'parent' may only have one child, in which case we need to evaluate whether or not
         // this node is redundant.
@@ -734,18 +715,14 @@ public:
             std::tie(node, idx) = context.back();
             context.pop_back();
 
-            for (auto iter = idx + node->_children.begin(); iter != node->_children.end(); ++iter) {
-                if (!(*iter))
-                    continue;
-
+            if (Node* child = node->_children.firstFrom(idx)) {
                 // There exists a node with a key larger than the one given.
-                node = iter->get();
+                node = child;
                 if (node->_data)
                     return const_iterator(_root, node);
 
                 // Need to search this node's children for the next largest node.
                 context.push_back(std::make_pair(node, 0));
-                break;
             }
 
             if (node->_trieKey.empty() && context.empty()) {
@@ -782,7 +759,214 @@ public:
         return _walkTree(_root.get(), 0);
     }
 
+    /**
+     * Returns the approximate number of bytes used by the nodes of this tree, not counting nodes
+     * shared with other trees more than once.
+     */
+    size_t memoryUsageForTest() const {
+        return _memoryUsage(_root.get()) + sizeof(Head) - sizeof(Node);
+    }
+
 private:
+    /**
+     * The children of a Node, indexed by the first byte of their trie keys. Like the adaptive
+     * nodes of an ART, a node with few children keeps them in sorted vectors that grow with the
+     * number of children, and only a node with many children uses a full 256-slot array. Most
+     * nodes have a handful of children at most, and every copy-on-write copies the children of
+     * each node along the modified path, so this keeps both the tree and its copies small.
+     */
+    class Children {
+    public:
+        Children() = default;
+
+        Children(const Children& other)
+            : _keys(other._keys), _nodes(other._nodes), _denseCount(other._denseCount) {
+            if (other._dense)
+                _dense = std::make_unique<DenseArray>(*other._dense);
+        }
+
+        Children(Children&& other) = default;
+
+        Children& operator=(const Children& other) {
+            Children copy(other);
+            *this = std::move(copy);
+            return *this;
+        }
+
+        Children& operator=(Children&& other) = default;
+
+        /**
+         * Returns the child whose trie key starts with 'key', or a null pointer if there is none.
+         * The reference is invalidated by the next call to set().
+         */
+        const std::shared_ptr<Node>& operator[](uint8_t key) const {
+            if (_dense)
+                return (*_dense)[key];
+
+            auto it = std::lower_bound(_keys.begin(), _keys.end(), key);
+            if (it == _keys.end() || *it != key)
+                return _nullChild();
+            return _nodes[it - _keys.begin()];
+        }
+
+        /**
+         * Replaces the child whose trie key starts with 'key'. A null 'node' removes the child.
+         */
+        void set(uint8_t key, std::shared_ptr<Node> node) {
+            if (_dense) {
+                auto& slot = (*_dense)[key];
+                if (slot && !node) {
+                    _denseCount--;
+                } else if (!slot && node) {
+                    _denseCount++;
+                }
+                slot = std::move(node);
+                if (_denseCount < kMinDenseChildren)
+                    _makeSparse();
+                return;
+            }
+
+            auto it = std::lower_bound(_keys.begin(), _keys.end(), key);
+            size_t pos = it - _keys.begin();
+            if (it != _keys.end() && *it == key) {
+                if (node) {
+                    _nodes[pos] = std::move(node);
+                } else {
+                    _keys.erase(it);
+                    _nodes.erase(_nodes.begin() + pos);
+                }
+                return;
+            }
+
+            if (!node)
+                return;
+
+            if (_keys.size() == kMaxSparseChildren) {
+                _makeDense();
+                set(key, std::move(node));
+                return;
+            }
+            _keys.insert(it, key);
+            _nodes.insert(_nodes.begin() + pos, std::move(node));
+        }
+
+        size_t size() const {
+            return _dense ? _denseCount : _keys.size();
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /**
+         * Returns the child with the smallest key at or after 'key', or nullptr if there is none.
+         */
+        Node* firstFrom(unsigned key) const {
+            if (_dense) {
+                for (unsigned i = key; i < 256; ++i) {
+                    if ((*_dense)[i])
+                        return (*_dense)[i].get();
+                }
+                return nullptr;
+            }
+
+            auto it = std::find_if(
+                _keys.begin(), _keys.end(), [&](uint8_t existing) { return existing >= key; });
+            return it == _keys.end() ? nullptr : _nodes[it - _keys.begin()].get();
+        }
+
+        /**
+         * Returns the child with the largest key before 'key', or nullptr if there is none.
+         */
+        Node* lastBefore(unsigned key) const {
+            if (_dense) {
+                for (unsigned i = std::min(key, 256U); i > 0; --i) {
+                    if ((*_dense)[i - 1])
+                        return (*_dense)[i - 1].get();
+                }
+                return nullptr;
+            }
+
+            for (size_t i = _keys.size(); i > 0; --i) {
+                if (_keys[i - 1] < key)
+                    return _nodes[i - 1].get();
+            }
+            return nullptr;
+        }
+
+        /**
+         * Calls 'f' with each child, in the order of their keys.
+         */
+        template <typename F>
+        void forEach(F&& f) const {
+            if (_dense) {
+                for (auto&& child : *_dense) {
+                    if (child)
+                        f(child);
+                }
+                return;
+            }
+
+            for (auto&& child : _nodes) {
+                f(child);
+            }
+        }
+
+        /**
+         * Returns the number of bytes allocated for the children, not counting the children.
+         */
+        size_t memoryUsage() const {
+            return _keys.capacity() * sizeof(uint8_t) +
+                _nodes.capacity() * sizeof(std::shared_ptr<Node>) +
+                (_dense ? sizeof(DenseArray) : 0);
+        }
+
+    private:
+        using DenseArray = std::array<std::shared_ptr<Node>, 256>;
+
+        // A node switches to the 256-slot array when it gains a child past kMaxSparseChildren,
+        // and back to sorted vectors when it falls below kMinDenseChildren. The gap avoids
+        // switching back and forth when children are repeatedly added and removed.
+        static constexpr size_t kMaxSparseChildren = 48;
+        static constexpr size_t kMinDenseChildren = 32;
+
+        static const std::shared_ptr<Node>& _nullChild() {
+            static const std::shared_ptr<Node> nullChild;
+            return nullChild;
+        }
+
+        void _makeDense() {
+            _dense = std::make_unique<DenseArray>();
+            for (size_t i = 0; i < _keys.size(); ++i) {
+                (*_dense)[_keys[i]] = std::move(_nodes[i]);
+            }
+            _denseCount = _keys.size();
+            _keys = std::vector<uint8_t>();
+            _nodes = std::vector<std::shared_ptr<Node>>();
+        }
+
+        void _makeSparse() {
+            _keys.reserve(_denseCount);
+            _nodes.reserve(_denseCount);
+            for (size_t i = 0; i < _dense->size(); ++i) {
+                if ((*_dense)[i]) {
+                    _keys.push_back(static_cast<uint8_t>(i));
+                    _nodes.push_back(std::move((*_dense)[i]));
+                }
+            }
+            _dense.reset();
+            _denseCount = 0;
+        }
+
+        // Sorted keys and the corresponding children, when not using the 256-slot array.
+        std::vector<uint8_t> _keys;
+        std::vector<std::shared_ptr<Node>> _nodes;
+
+        // The 256-slot array indexed by key and its number of non-null children, if in use.
+        std::unique_ptr<DenseArray> _dense;
+        size_t _denseCount = 0;
+    };
+
     class Node {
         friend class RadixStore;
 
@@ -822,18 +1006,14 @@ private:
         }
 
         bool isLeaf() const {
-            for (auto child : _children) {
-                if (child != nullptr)
-                    return false;
-            }
-            return true;
+            return _children.empty();
         }
 
     protected:
         unsigned int _depth = 0;
         std::vector<uint8_t> _trieKey;
         boost::optional<value_type> _data;
-        std::array<std::shared_ptr<Node>, 256> _children;
+        Children _children;
     };
 
     /**
@@ -910,14 +1090,22 @@ private:
         }
         ret.push_back('\n');
 
-        for (auto child : node->_children) {
-            if (child != nullptr) {
-                ret.append(_walkTree(child.get(), depth + 1));
-            }
-        }
+        node->_children.forEach([&](const std::shared_ptr<Node>& child) {
+            ret.append(_walkTree(child.get(), depth + 1));
+        });
         return ret;
     }
 
+    size_t _memoryUsage(const Node* node) const {
+        size_t bytes = sizeof(Node) + node->_trieKey.capacity() + node->_children.memoryUsage();
+        if (node->_data)
+            bytes += node->_data->first.capacity() + node->_data->second.capacity();
+
+        node->_children.forEach(
+            [&](const std::shared_ptr<Node>& child) { bytes += _memoryUsage(child.get()); });
+        return bytes;
+    }
+
     Node* _findNode(const Key& key) const {
         const char* charKey = key.data();
 
@@ -1012,7 +1200,7 @@ private:
             if (node.use_count() - 1 > 1) {
                 // Copy node on a modifying operation when it isn't owned uniquely.
                 node = std::make_shared<Node>(*node);
-                prev->_children[childFirstChar] = node;
+                prev->_children.set(childFirstChar, node);
             }
 
             // 'node' is uniquely owned at this point, so we are free to modify it.
@@ -1045,7 +1233,7 @@ private:
 
                 // Change the current node's trieKey and make a child of the new node.
                 newKey = _makeKey(node->_trieKey, mismatchIdx, node->_trieKey.size() - mismatchIdx);
-                newNode->_children[newKey.front()] = node;
+                newNode->_children.set(newKey.front(), node);
 
                 node->_trieKey = newKey;
                 node->_depth = newNode->_depth + newNode->_trieKey.size();
@@ -1125,7 +1313,7 @@ private:
         if (value) {
             newNode->_data.emplace(value->first, value->second);
         }
-        node->_children[key.front()] = newNode;
+        node->_children.set(key.front(), newNode);
         return newNode.get();
     }
 
@@ -1181,16 +1369,11 @@ private:
         }
 
         // Determine if this node has only one child.
-        std::shared_ptr<Node> onlyChild = nullptr;
-
-        for (size_t i = 0; i < node->_children.size(); ++i) {
-            if (node->_children[i] != nullptr) {
-                if (onlyChild != nullptr) {
-                    return;
-                }
-                onlyChild = node->_children[i];
-            }
+        if (node->_children.size() != 1) {
+            return;
         }
+        std::shared_ptr<Node> onlyChild =
+            node->_children[node->_children.firstFrom(0)->_trieKey.front()];
 
         // Append the child's key onto the parent.
         for (char item : onlyChild->_trieKey) {
@@ -1240,7 +1423,7 @@ private:
 
             if (prev->_children[node->_trieKey.front()].use_count() > 1) {
                 std::shared_ptr<Node> nodeCopy = std::make_shared<Node>(*node);
-                prev->_children[nodeCopy->_trieKey.front()] = nodeCopy;
+                prev->_children.set(nodeCopy->_trieKey.front(), nodeCopy);
                 context[idx] = nodeCopy.get();
                 prev = nodeCopy.get();
             } else {
@@ -1379,7 +1562,7 @@ private:
                     // modifications that go on in _makeBranchUnique.
                     _rebuildContext(context, trieKeyIndex);
 
-                    current->_children[key] = other->_children[key];
+                    current->_children.set(key, other->_children[key]);
                 } else if (!otherNode || (baseNode && baseNode != otherNode)) {
                     // Either the master tree and working tree remove the same branch, or the master
                     // tree updated the branch while the working tree removed the branch, resulting
@@ -1392,12 +1575,12 @@ private:
 
                     current = _makeBranchUnique(context);
                     _rebuildContext(context, trieKeyIndex);
-                    current->_children[key] = nullptr;
+                    current->_children.set(key, nullptr);
                 } else if (baseNode && otherNode && baseNode == node) {
                     // If base and current point to the same node, then master changed.
                     current = _makeBranchUnique(context);
                     _rebuildContext(context, trieKeyIndex);
-                    current->_children[key] = other->_children[key];
+                    current->_children.set(key, other->_children[key]);
                 }
             } else if (baseNode && otherNode && baseNode != otherNode) {
                 // If all three are unique and leaf nodes, then it is a merge conflict.
@@ -1440,12 +1623,7 @@ private:
             if (node->_children.empty())
                 return nullptr;
 
-            for (auto child : node->_children) {
-                if (child != nullptr) {
-                    node = child.get();
-                    break;
-                }
-            }
+            node = node->_children.firstFrom(0);
         }
         return node;
     }
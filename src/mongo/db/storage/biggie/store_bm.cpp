@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/storage/biggie/store.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+// Keys resembling those of a record store: a shared ident prefix followed by a record id.
+std::string makeKey(int64_t i) {
+    return "collection-0-1234567890" + std::to_string(i * 7919);
+}
+
+void BM_RadixStoreInsert(benchmark::State& state) {
+    size_t memoryUsage = 0;
+    for (auto _ : state) {
+        StringStore store;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            store.insert(StringStore::value_type(makeKey(i), "value"));
+        }
+        memoryUsage = store.memoryUsageForTest();
+        benchmark::DoNotOptimize(store);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytesPerKey"] = memoryUsage / state.range(0);
+}
+
+// Measures copy-on-write: each update through a copy of the tree duplicates the modified path.
+void BM_RadixStoreCopyOnWriteUpdate(benchmark::State& state) {
+    StringStore store;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        store.insert(StringStore::value_type(makeKey(i), "value"));
+    }
+
+    int64_t i = 0;
+    for (auto _ : state) {
+        StringStore copy = store;
+        copy.update(StringStore::value_type(makeKey(i++ % state.range(0)), "updated"));
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_RadixStoreScan(benchmark::State& state) {
+    StringStore store;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        store.insert(StringStore::value_type(makeKey(i), "value"));
+    }
+
+    for (auto _ : state) {
+        size_t bytes = 0;
+        for (auto&& entry : store) {
+            bytes += entry.second.size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_RadixStoreInsert)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_RadixStoreCopyOnWriteUpdate)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_RadixStoreScan)->Arg(1000)->Arg(100000);
+
+}  // namespace
+}  // namespace biggie
+}  // namespace mongo
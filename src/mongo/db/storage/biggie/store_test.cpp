@@ -2492,5 +2492,45 @@ TEST_F(RadixStoreTest, LowerBoundEndpoint) {
     ASSERT_TRUE(it == thisStore.end());
 }
 
+TEST_F(RadixStoreTest, NodeWithManyChildrenGrowsAndShrinks) {
+    // The children of a single node outgrow the sorted vectors and then shrink back into them.
+    for (int c = 1; c < 255; ++c) {
+        thisStore.insert(value_type(std::string("k") + static_cast<char>(c), "v"));
+    }
+    otherStore = thisStore;
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(254));
+
+    int expectedChar = 1;
+    for (auto& item : thisStore) {
+        ASSERT_EQ(item.first, std::string("k") + static_cast<char>(expectedChar++));
+    }
+    ASSERT_EQ(expectedChar, 255);
+
+    for (auto it = thisStore.rbegin(); it != thisStore.rend(); ++it) {
+        ASSERT_EQ(it->first, std::string("k") + static_cast<char>(--expectedChar));
+    }
+    ASSERT_EQ(expectedChar, 1);
+
+    auto it = thisStore.lower_bound(std::string("k") + static_cast<char>(100));
+    ASSERT_EQ(it->first, std::string("k") + static_cast<char>(100));
+
+    const size_t denseUsage = thisStore.memoryUsageForTest();
+    for (int c = 10; c < 255; ++c) {
+        ASSERT_TRUE(thisStore.erase(std::string("k") + static_cast<char>(c)));
+    }
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(9));
+    ASSERT_LT(thisStore.memoryUsageForTest(), denseUsage);
+
+    expectedChar = 1;
+    for (auto& item : thisStore) {
+        ASSERT_EQ(item.first, std::string("k") + static_cast<char>(expectedChar++));
+    }
+    ASSERT_EQ(expectedChar, 10);
+
+    // The copy taken before the erasures still has all of the children.
+    ASSERT_EQ(otherStore.size(), StringStore::size_type(254));
+    ASSERT_TRUE(otherStore.find(std::string("k") + static_cast<char>(200)) != otherStore.end());
+}
+
 }  // biggie namespace
 }  // mongo namespace
@@ -0,0 +1,211 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/flow_control.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/flow_control_parameters_gen.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+namespace {
+
+const auto getFlowControl = ServiceContext::declareDecoration<std::unique_ptr<FlowControl>>();
+
+// Bounds the samples kept while the commit point does not move at all.
+const std::size_t kMaxSamples = 24 * 60 * 60;
+
+FlowControlTicketholder* installTicketholder(ServiceContext* service) {
+    FlowControlTicketholder::set(
+        service, stdx::make_unique<FlowControlTicketholder>(FlowControl::kMaxTickets));
+    return FlowControlTicketholder::get(service);
+}
+
+class FlowControlSSS : public ServerStatusSection {
+public:
+    FlowControlSSS() : ServerStatusSection("flowControl") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        if (auto flowControl = FlowControl::get(opCtx)) {
+            flowControl->appendStats(&builder);
+        }
+        return builder.obj();
+    }
+
+} flowControlSSS;
+
+}  // namespace
+
+FlowControl::FlowControl(ServiceContext* service, repl::ReplicationCoordinator* replCoord)
+    : _replCoord(replCoord), _ticketholder(installTicketholder(service)) {
+    auto periodicRunner = service->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "FlowControlRefresher",
+        [this](Client* client) { _ticketholder->refreshTo(getNumTickets()); },
+        Seconds(1));
+    periodicRunner->scheduleJob(std::move(job));
+}
+
+FlowControl* FlowControl::get(ServiceContext* service) {
+    return getFlowControl(service).get();
+}
+
+FlowControl* FlowControl::get(ServiceContext& service) {
+    return getFlowControl(service).get();
+}
+
+FlowControl* FlowControl::get(OperationContext* opCtx) {
+    return get(opCtx->getClient()->getServiceContext());
+}
+
+void FlowControl::set(ServiceContext* service, std::unique_ptr<FlowControl> flowControl) {
+    getFlowControl(service) = std::move(flowControl);
+}
+
+int FlowControl::getNumTickets() {
+    const long long ticketsAcquired = _ticketholder->totalTicketsAcquired();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!gEnableFlowControl.load() ||
+        _replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet ||
+        !_replCoord->getMemberState().primary()) {
+        _reset_inlock();
+        return _targetTickets;
+    }
+
+    const Timestamp lastApplied = _replCoord->getMyLastAppliedOpTime().getTimestamp();
+    const Timestamp lastCommitted = _replCoord->getLastCommittedOpTime().getTimestamp();
+
+    if (_samples.empty() || _samples.back().first < lastApplied) {
+        _samples.emplace_back(lastApplied, ticketsAcquired);
+        if (_samples.size() > kMaxSamples) {
+            _samples.pop_front();
+        }
+    }
+
+    // The writes that became majority committed since the previous refresh are the rate at which
+    // the replica set currently keeps up with the primary.
+    const long long committedTickets = _ticketsAcquiredAt_inlock(lastCommitted);
+    if (committedTickets >= 0) {
+        _sustainedRate = _lastCommittedTickets >= 0
+            ? std::max(0LL, committedTickets - _lastCommittedTickets)
+            : 0;
+        _lastCommittedTickets = committedTickets;
+    } else {
+        _sustainedRate = 0;
+    }
+
+    while (_samples.size() > 1 && _samples[1].first <= lastCommitted) {
+        _samples.pop_front();
+    }
+
+    _lagSeconds = lastCommitted.isNull() || lastApplied <= lastCommitted
+        ? 0
+        : static_cast<long long>(lastApplied.getSecs()) - lastCommitted.getSecs();
+
+    const int targetLagSeconds = gFlowControlTargetLagSeconds.load();
+    if (_lagSeconds < targetLagSeconds) {
+        _isLagged = false;
+        _targetTickets = kMaxTickets;
+        return _targetTickets;
+    }
+
+    if (!_isLagged) {
+        _isLagged = true;
+        ++_timesLagged;
+        LOG(1) << "Flow control is throttling writes; the majority commit point lags by "
+               << _lagSeconds << " seconds";
+    }
+
+    // Scale the sustained rate down in proportion to how far the lag exceeds the target, but by no
+    // more than half, so that the primary slows down gradually.
+    const double factor = std::max(0.5, static_cast<double>(targetLagSeconds) / _lagSeconds);
+    const long long tickets = static_cast<long long>(_sustainedRate * factor);
+    const long long minTickets = gFlowControlMinTicketsPerSecond.load();
+    _targetTickets =
+        static_cast<int>(std::min<long long>(kMaxTickets, std::max(minTickets, tickets)));
+    return _targetTickets;
+}
+
+long long FlowControl::_ticketsAcquiredAt_inlock(Timestamp ts) const {
+    auto it = std::upper_bound(
+        _samples.begin(), _samples.end(), ts, [](const Timestamp& lhs, const auto& sample) {
+            return lhs < sample.first;
+        });
+    if (it == _samples.begin()) {
+        return -1;
+    }
+    return std::prev(it)->second;
+}
+
+void FlowControl::_reset_inlock() {
+    _samples.clear();
+    _lastCommittedTickets = -1;
+    _isLagged = false;
+    _lagSeconds = 0;
+    _sustainedRate = 0;
+    _targetTickets = kMaxTickets;
+}
+
+void FlowControl::appendStats(BSONObjBuilder* builder) const {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->append("enabled", gEnableFlowControl.load());
+        builder->append("targetRateLimit", _targetTickets);
+        builder->append("isLagged", _isLagged);
+        builder->append("isLaggedCount", _timesLagged);
+        builder->append("lagSeconds", _lagSeconds);
+        builder->append("sustainedRate", _sustainedRate);
+    }
+    _ticketholder->appendStats(builder);
+}
+
+}  // namespace mongo
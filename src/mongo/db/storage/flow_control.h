@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class FlowControlTicketholder;
+class OperationContext;
+class ServiceContext;
+
+namespace repl {
+class ReplicationCoordinator;
+}  // namespace repl
+
+/**
+ * Throttles the writes of a primary when the majority commit point falls behind its last applied
+ * optime by more than flowControlTargetLagSeconds, so that secondaries can catch up before the
+ * primary's write rate runs the replica set out of majority-committed history.
+ *
+ * Once a second, flow control samples how many writes the primary has admitted by the time it
+ * applied its latest optime. Comparing these samples to the commit point gives the rate at which
+ * the majority of the set applies the primary's writes. While lagged, the primary admits writes
+ * at that rate, scaled down by how far the lag exceeds the target.
+ */
+class FlowControl {
+    MONGO_DISALLOW_COPYING(FlowControl);
+
+public:
+    static constexpr int kMaxTickets = 1000 * 1000 * 1000;
+
+    /**
+     * Installs a FlowControlTicketholder on 'service' and schedules the job that refreshes it once
+     * a second on the service's PeriodicRunner.
+     */
+    FlowControl(ServiceContext* service, repl::ReplicationCoordinator* replCoord);
+
+    static FlowControl* get(ServiceContext* service);
+    static FlowControl* get(ServiceContext& service);
+    static FlowControl* get(OperationContext* opCtx);
+
+    static void set(ServiceContext* service, std::unique_ptr<FlowControl> flowControl);
+
+    /**
+     * Returns the number of writes to admit during the next second.
+     */
+    int getNumTickets();
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    /**
+     * Returns the number of writes admitted by the time 'ts' was applied, or -1 if the samples
+     * do not go back far enough.
+     */
+    long long _ticketsAcquiredAt_inlock(Timestamp ts) const;
+
+    void _reset_inlock();
+
+    repl::ReplicationCoordinator* const _replCoord;
+    FlowControlTicketholder* const _ticketholder;
+
+    mutable stdx::mutex _mutex;
+
+    // Pairs of an applied timestamp and the number of writes admitted by the time it was applied,
+    // in timestamp order. Only the newest sample at or before the commit point is kept.
+    std::deque<std::pair<Timestamp, long long>> _samples;
+
+    // Number of writes that were majority committed as of the previous refresh, or -1.
+    long long _lastCommittedTickets = -1;
+
+    bool _isLagged = false;
+    long long _lagSeconds = 0;
+    long long _sustainedRate = 0;
+    int _targetTickets = kMaxTickets;
+    long long _timesLagged = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/flow_control.h"
+
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/storage/flow_control_parameters_gen.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mock_periodic_runner_impl.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class FlowControlTest : public ServiceContextTest {
+protected:
+    void setUp() override {
+        getServiceContext()->setPeriodicRunner(stdx::make_unique<MockPeriodicRunnerImpl>());
+        _replCoord = stdx::make_unique<repl::ReplicationCoordinatorMock>(getServiceContext());
+        ASSERT_OK(_replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        _flowControl = stdx::make_unique<FlowControl>(getServiceContext(), _replCoord.get());
+        _opCtx = makeOperationContext();
+    }
+
+    void tearDown() override {
+        _opCtx.reset();
+        _flowControl.reset();
+        FlowControlTicketholder::set(getServiceContext(), nullptr);
+    }
+
+    /**
+     * Admits 'numWrites' writes, then moves the last applied optime and the majority commit point
+     * to the given seconds and computes the tickets for the next period.
+     */
+    int refresh(int numWrites, unsigned lastAppliedSecs, unsigned lastCommittedSecs) {
+        auto ticketholder = FlowControlTicketholder::get(getServiceContext());
+        for (int i = 0; i < numWrites; ++i) {
+            ticketholder->getTicket(_opCtx.get());
+        }
+        _replCoord->setMyLastAppliedOpTime(repl::OpTime(Timestamp(lastAppliedSecs, 1), 1));
+        _replCoord->setLastCommittedOpTime(repl::OpTime(Timestamp(lastCommittedSecs, 1), 1));
+        return _flowControl->getNumTickets();
+    }
+
+    std::unique_ptr<repl::ReplicationCoordinatorMock> _replCoord;
+    std::unique_ptr<FlowControl> _flowControl;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+TEST_F(FlowControlTest, DoesNotThrottleWithinTargetLag) {
+    ASSERT_EQ(10, gFlowControlTargetLagSeconds.load());
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 100, 100));
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(1000, 109, 100));
+}
+
+TEST_F(FlowControlTest, DoesNotThrottleSecondaries) {
+    ASSERT_OK(_replCoord->setFollowerMode(repl::MemberState::RS_SECONDARY));
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 100, 100));
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(1000, 200, 100));
+}
+
+TEST_F(FlowControlTest, AdmitsTheMinimumWhenNoRateIsKnown) {
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 100, 100));
+
+    // The commit point has not moved since the first sample, so the replica set has no measured
+    // rate yet and only the floor is admitted.
+    ASSERT_EQ(gFlowControlMinTicketsPerSecond.load(), refresh(1000, 120, 100));
+}
+
+TEST_F(FlowControlTest, ScalesSustainedRateByLag) {
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 100, 100));
+    ASSERT_EQ(gFlowControlMinTicketsPerSecond.load(), refresh(1000, 120, 100));
+
+    // The 1000 writes admitted by 120 became majority committed. A lag of 20 seconds is twice the
+    // target, which halves the rate.
+    ASSERT_EQ(500, refresh(600, 140, 120));
+
+    // The 600 writes admitted by 140 became majority committed. A lag of 15 seconds scales the
+    // rate by 10/15.
+    ASSERT_EQ(400, refresh(400, 155, 140));
+
+    // Once the lag is back under the target, writes are no longer throttled.
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 160, 155));
+}
+
+TEST_F(FlowControlTest, NeverScalesByLessThanHalf) {
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 100, 100));
+    ASSERT_EQ(gFlowControlMinTicketsPerSecond.load(), refresh(1000, 200, 100));
+    ASSERT_EQ(500, refresh(0, 300, 200));
+}
+
+TEST_F(FlowControlTest, RespectsTheMinimumTickets) {
+    const int minTickets = gFlowControlMinTicketsPerSecond.load();
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 100, 100));
+    ASSERT_EQ(minTickets, refresh(10, 120, 100));
+    ASSERT_EQ(minTickets, refresh(0, 140, 120));
+
+    gFlowControlMinTicketsPerSecond.store(1);
+    ON_BLOCK_EXIT([&] { gFlowControlMinTicketsPerSecond.store(minTickets); });
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 200, 200));
+    ASSERT_EQ(1, refresh(10, 220, 200));
+}
+
+TEST_F(FlowControlTest, TrimsSamplesBehindTheCommitPoint) {
+    ASSERT_EQ(FlowControl::kMaxTickets, refresh(0, 100, 100));
+    ASSERT_EQ(gFlowControlMinTicketsPerSecond.load(), refresh(1000, 120, 100));
+    ASSERT_EQ(500, refresh(600, 140, 120));
+
+    // The sample taken at 100 was discarded once the commit point reached 120, so a commit point
+    // that is older than every remaining sample yields no rate and leaves the committed count
+    // where it was.
+    ASSERT_EQ(gFlowControlMinTicketsPerSecond.load(), refresh(0, 160, 110));
+    ASSERT_EQ(300, refresh(0, 180, 140));
+}
+
+}  // namespace
+}  // namespace mongo
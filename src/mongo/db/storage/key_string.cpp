@@ -34,8 +34,13 @@
 #include "mongo/db/storage/key_string.h"
 
 #include <cmath>
+#include <cstring>
 #include <type_traits>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/data_cursor.h"
 #include "mongo/base/data_view.h"
 #include "mongo/platform/bits.h"
@@ -229,15 +234,70 @@ const uint8_t kGreater = 254;
 
 // some utility functions
 namespace {
+/**
+ * Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. 'dst' and 'src' may be the same
+ * buffer, in which case the bits are flipped in place, but must not otherwise overlap.
+ *
+ * Descending keys run every string, OID and number through here, so the bulk of the work is done
+ * 16 bytes at a time with SSE2 where available and 8 bytes at a time elsewhere.
+ */
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+
+#if defined(_M_AMD64) || defined(__amd64__)
+    const __m128i allOnes = _mm_set1_epi8(-1);
+    while (end - input >= static_cast<std::ptrdiff_t>(sizeof(__m128i))) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_xor_si128(chunk, allOnes));
+        input += sizeof(__m128i);
+        output += sizeof(__m128i);
+    }
+#endif
+
+    while (end - input >= static_cast<std::ptrdiff_t>(sizeof(uint64_t))) {
+        uint64_t word;
+        std::memcpy(&word, input, sizeof(word));
+        word = ~word;
+        std::memcpy(output, &word, sizeof(word));
+        input += sizeof(uint64_t);
+        output += sizeof(uint64_t);
+    }
+
     while (input != end) {
         *output++ = ~(*input++);
     }
 }
 
+// The most bytes that the encoding of an integer takes: a ctype byte and up to 8 bytes of value.
+const size_t kMaxIntegerEncodingBytes = 9;
+
+/**
+ * Writes the encoding that KeyString::_appendPreshiftedIntegerPortion() appends for 'value' to
+ * 'out', without inverting it. Always writes kMaxIntegerEncodingBytes bytes, and returns how many
+ * of them make up the encoding.
+ */
+size_t encodePreshiftedIntegerPortion(uint64_t value, bool isNegative, char* out) {
+    dassert(value != 0ULL);
+    dassert(value != 1ULL);
+
+    const size_t bytesNeeded = (64 - countLeadingZeros64(value) + 7) / 8;
+
+    // Move the used bytes of value to the top of the word, so that in big endian order they come
+    // first and the whole word can be stored at once.
+    uint64_t bytes = endian::nativeToBig(value << (64 - 8 * bytesNeeded));
+
+    if (isNegative) {
+        out[0] = CType::kNumericNegative1ByteInt - (bytesNeeded - 1);
+        bytes = ~bytes;
+    } else {
+        out[0] = CType::kNumericPositive1ByteInt + (bytesNeeded - 1);
+    }
+    std::memcpy(out + 1, &bytes, sizeof(bytes));
+    return 1 + bytesNeeded;
+}
+
 template <typename T>
 T readType(BufReader* reader, bool inverted) {
     MONGO_STATIC_ASSERT(std::is_integral<T>::value);
@@ -284,10 +344,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     uassert(50817, "Failed to find '0xFF' in inverted string.", end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -314,9 +372,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
+    memcpy_flipBits(&out[0], out.data(), out.size());
 
     return out;
 }
@@ -515,9 +571,16 @@ void KeyString::_appendDBRef(const BSONDBRef& val, bool invert) {
 
 void KeyString::_appendArray(const BSONArray& val, bool invert) {
     _append(CType::kArray, invert);
-    BSONForEach(elem, val) {
+    BSONObjIterator it(val);
+    while (it.more()) {
+        // Arrays of numbers are common in index keys, so runs of integer-valued ones are encoded
+        // in bulk.
+        if (_appendIntegerValuedNumbers(&it, invert) > 0) {
+            continue;
+        }
+
         // No generic ctype byte needed here since no name is encoded.
-        _appendBsonValue(elem, invert, NULL);
+        _appendBsonValue(it.next(), invert, NULL);
     }
     _append(int8_t(0), invert);
 }
@@ -1041,22 +1104,79 @@ void KeyString::_appendInteger(const long long num, bool invert) {
 }
 
 void KeyString::_appendPreshiftedIntegerPortion(uint64_t value, bool isNegative, bool invert) {
-    dassert(value != 0ULL);
-    dassert(value != 1ULL);
-
-    const size_t bytesNeeded = (64 - countLeadingZeros64(value) + 7) / 8;
+    char encoded[kMaxIntegerEncodingBytes];
+    _appendBytes(encoded, encodePreshiftedIntegerPortion(value, isNegative, encoded), invert);
+}
+
+size_t KeyString::_appendIntegerValuedNumbers(BSONObjIterator* it, bool invert) {
+    // The numbers are encoded into a local buffer and appended a chunk at a time, which takes one
+    // append, and one pass to invert the bits of a descending key, for the whole chunk rather than
+    // two of each for every number.
+    const size_t kNumbersPerChunk = 32;
+    char chunk[kNumbersPerChunk * kMaxIntegerEncodingBytes];
+    size_t chunkBytes = 0;
+    size_t numInChunk = 0;
+    size_t numAppended = 0;
+
+    while (it->more()) {
+        // Only numbers which are encoded exactly as the integer they equal, and are not the most
+        // negative int64, which is encoded as a large double, belong to the run.
+        const BSONElement elem = **it;
+        uint64_t magnitude;
+        bool isNegative;
+        if (elem.type() == NumberInt || elem.type() == NumberLong) {
+            const long long num =
+                elem.type() == NumberInt ? elem._numberInt() : elem._numberLong();
+            if (num == std::numeric_limits<long long>::min()) {
+                break;
+            }
+            isNegative = num < 0;
+            magnitude = isNegative ? -num : num;
+            if (elem.type() == NumberInt) {
+                _typeBits.appendNumberInt();
+            } else {
+                _typeBits.appendNumberLong();
+            }
+        } else if (elem.type() == NumberDouble) {
+            const double num = elem._numberDouble();
+            isNegative = num < 0.0;
+            const double absolute = isNegative ? -num : num;
+            if (num == 0.0) {
+                magnitude = 0;
+            } else if (absolute >= 1.0 && absolute < kMinLargeDouble &&
+                       static_cast<double>(static_cast<uint64_t>(absolute)) == absolute) {
+                magnitude = static_cast<uint64_t>(absolute);
+            } else {
+                // Fractions, NaNs and doubles too large for an int64 have encodings of their own.
+                break;
+            }
+            if (num == 0.0 && std::signbit(num)) {
+                _typeBits.appendZero(TypeBits::kNegativeDoubleZero);
+            } else {
+                _typeBits.appendNumberDouble();
+            }
+        } else {
+            break;
+        }
 
-    // Append the low bytes of value in big endian order.
-    value = endian::nativeToBig(value);
-    const void* firstUsedByte = reinterpret_cast<const char*>((&value) + 1) - bytesNeeded;
+        if (magnitude == 0) {
+            chunk[chunkBytes++] = CType::kNumericZero;
+        } else {
+            chunkBytes +=
+                encodePreshiftedIntegerPortion(magnitude << 1, isNegative, chunk + chunkBytes);
+        }
+        if (++numInChunk == kNumbersPerChunk) {
+            _appendBytes(chunk, chunkBytes, invert);
+            chunkBytes = 0;
+            numInChunk = 0;
+        }
 
-    if (isNegative) {
-        _append(uint8_t(CType::kNumericNegative1ByteInt - (bytesNeeded - 1)), invert);
-        _appendBytes(firstUsedByte, bytesNeeded, !invert);
-    } else {
-        _append(uint8_t(CType::kNumericPositive1ByteInt + (bytesNeeded - 1)), invert);
-        _appendBytes(firstUsedByte, bytesNeeded, invert);
+        it->next();
+        ++numAppended;
     }
+
+    _appendBytes(chunk, chunkBytes, invert);
+    return numAppended;
 }
 
 template <typename T>
@@ -2135,6 +2255,71 @@ int KeyString::compare(const KeyString& other) const {
     return a < b ? -1 : 1;
 }
 
+KeyString::Value::Value(Version version,
+                        const char* buffer,
+                        size_t size,
+                        const TypeBits& typeBits)
+    : _prefix(_computePrefix(buffer, size)),
+      _version(version),
+      _ksSize(size),
+      _typeBitsSize(typeBits.getSize()),
+      _buffer(SharedBuffer::allocate(_ksSize + _typeBitsSize)) {
+    memcpy(_buffer.get(), buffer, _ksSize);
+    memcpy(_buffer.get() + _ksSize, typeBits.getBuffer(), _typeBitsSize);
+}
+
+KeyString::TypeBits KeyString::Value::getTypeBits() const {
+    BufReader reader(_buffer.get() + _ksSize, _typeBitsSize);
+    return TypeBits::fromBuffer(_version, &reader);
+}
+
+void KeyString::Value::serializeForSorter(BufBuilder& buf) const {
+    buf.appendNum(static_cast<int32_t>(_ksSize));
+    buf.appendNum(static_cast<int32_t>(_typeBitsSize));
+    buf.appendBuf(_buffer.get(), _ksSize + _typeBitsSize);
+}
+
+KeyString::Value KeyString::Value::deserializeForSorter(BufReader& buf,
+                                                        const SorterDeserializeSettings& settings) {
+    const int32_t ksSize = buf.read<LittleEndian<int32_t>>();
+    const int32_t typeBitsSize = buf.read<LittleEndian<int32_t>>();
+
+    Value out;
+    out._version = settings.version;
+    out._ksSize = ksSize;
+    out._typeBitsSize = typeBitsSize;
+    out._buffer = SharedBuffer::allocate(ksSize + typeBitsSize);
+    memcpy(out._buffer.get(), buf.skip(ksSize + typeBitsSize), ksSize + typeBitsSize);
+    out._prefix = _computePrefix(out._buffer.get(), ksSize);
+    return out;
+}
+
+uint64_t KeyString::Value::_computePrefix(const char* buffer, size_t size) {
+    uint64_t prefix = 0;
+    memcpy(&prefix, buffer, std::min(size, sizeof(prefix)));
+    return endian::bigToNative(prefix);
+}
+
+int KeyString::Value::_compareAfterPrefix(const Value& other) const {
+    // The prefixes are equal, so the first min(size, 8) bytes of both encodings are too.
+    const size_t min = std::min(_ksSize, other._ksSize);
+    const size_t skip = std::min(min, sizeof(_prefix));
+
+    int cmp = memcmp(getBuffer() + skip, other.getBuffer() + skip, min - skip);
+    if (cmp) {
+        if (cmp < 0)
+            return -1;
+        return 1;
+    }
+
+    // keys match
+
+    if (_ksSize == other._ksSize)
+        return 0;
+
+    return _ksSize < other._ksSize ? -1 : 1;
+}
+
 uint32_t KeyString::TypeBits::readSizeFromBuffer(BufReader* reader) {
     const uint8_t firstByte = reader->peek<uint8_t>();
 
@@ -40,6 +40,8 @@
 #include "mongo/db/record_id.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/bufreader.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -288,6 +290,82 @@ public:
         StackBufBuilder _buf;
     };
 
+    /**
+     * An owned, immutable copy of the encoded bytes and TypeBits of a KeyString. Copies are cheap
+     * since they share a single reference-counted buffer. The first 8 bytes of the encoding are
+     * also kept inline so that most comparisons are decided without touching the shared buffer.
+     * Values compare with the same semantics as the KeyStrings they were copied from.
+     *
+     * This class provides the members required of Sorter keys, see sorter.h.
+     */
+    class Value {
+    public:
+        /**
+         * The KeyString version is not serialized for the Sorter, so it must be known when the
+         * Value is read back.
+         */
+        struct SorterDeserializeSettings {
+            explicit SorterDeserializeSettings(Version version = kLatestVersion)
+                : version(version) {}
+            Version version;
+        };
+
+        Value() : _version(kLatestVersion) {}
+
+        Value(Version version, const char* buffer, size_t size, const TypeBits& typeBits);
+
+        int compare(const Value& other) const {
+            if (_prefix != other._prefix) {
+                return _prefix < other._prefix ? -1 : 1;
+            }
+            return _compareAfterPrefix(other);
+        }
+
+        const char* getBuffer() const {
+            return _buffer.get();
+        }
+        size_t getSize() const {
+            return _ksSize;
+        }
+        Version getVersion() const {
+            return _version;
+        }
+
+        /**
+         * Returns an 8-byte integer whose big-endian representation is the first 8 bytes of the
+         * encoding, padded with zeros. Comparing prefixes as integers is consistent with comparing
+         * the full encodings.
+         */
+        uint64_t getPrefix() const {
+            return _prefix;
+        }
+
+        /**
+         * Returns a copy of the TypeBits, which are needed to decode this key back into BSON.
+         */
+        TypeBits getTypeBits() const;
+
+        void serializeForSorter(BufBuilder& buf) const;
+        static Value deserializeForSorter(BufReader& buf, const SorterDeserializeSettings& settings);
+        int memUsageForSorter() const {
+            return sizeof(Value) + _buffer.capacity();
+        }
+        Value getOwned() const {
+            return *this;
+        }
+
+    private:
+        static uint64_t _computePrefix(const char* buffer, size_t size);
+
+        int _compareAfterPrefix(const Value& other) const;
+
+        uint64_t _prefix = 0;
+        Version _version;
+        uint32_t _ksSize = 0;      // Size of the KeyString encoding at the start of '_buffer'.
+        uint32_t _typeBitsSize = 0;  // Size of the encoded TypeBits that follow it.
+        SharedBuffer _buffer;
+    };
+
     enum Discriminator {
         kInclusive,  // Anything to be stored in an index must use this.
         kExclusiveBefore,
@@ -391,6 +469,13 @@ public:
 
     int compare(const KeyString& other) const;
 
+    /**
+     * Returns an owned copy of the encoded bytes and TypeBits of this KeyString.
+     */
+    Value getValueCopy() const {
+        return Value(version, getBuffer(), getSize(), _typeBits);
+    }
+
     /**
      * @return a hex encoding of this key
      */
@@ -439,6 +524,12 @@ private:
     void _appendInteger(const long long num, bool invert);
     void _appendPreshiftedIntegerPortion(uint64_t value, bool isNegative, bool invert);
 
+    /**
+     * Appends the run of integer-valued numbers which 'it' is positioned at, if any, and moves 'it'
+     * past them. Returns how many numbers were appended.
+     */
+    size_t _appendIntegerValuedNumbers(BSONObjIterator* it, bool invert);
+
     void _appendDoubleWithoutTypeBits(const double num, DecimalContinuationMarker dcm, bool invert);
     void _appendHugeDecimalWithoutTypeBits(const Decimal128 dec, bool invert);
     void _appendTinyDecimalWithoutTypeBits(const Decimal128 dec, const double bin, bool invert);
@@ -337,6 +337,69 @@ TEST_F(KeyStringTest, Array1) {
     }
 }
 
+TEST_F(KeyStringTest, ArraysOfIntegerValuedNumbers) {
+    // Runs of integer-valued numbers in arrays are encoded in bulk, so check that every kind of
+    // number, and every length of run up to past a whole chunk, is encoded as it is on its own.
+    BSONArrayBuilder numbers;
+    numbers.append(0);
+    numbers.append(0LL);
+    numbers.append(0.0);
+    numbers.append(-0.0);
+    numbers.append(1);
+    numbers.append(-1LL);
+    numbers.append(-255.0);
+    numbers.append(256);
+    numbers.append(std::numeric_limits<int>::max());
+    numbers.append(std::numeric_limits<int>::min());
+    numbers.append(std::numeric_limits<long long>::max());
+    numbers.append(std::numeric_limits<long long>::min() + 1);
+    numbers.append(std::numeric_limits<long long>::min());
+    numbers.append(std::ldexp(1.0, 53) + 2);
+    numbers.append(-std::ldexp(1.0, 62));
+    numbers.append(std::ldexp(1.0, 63));
+    numbers.append(0.5);
+    numbers.append(-1.5);
+    numbers.append(std::numeric_limits<double>::quiet_NaN());
+    numbers.append(std::numeric_limits<double>::infinity());
+    numbers.append("a string");
+    for (int i = 0; i < 100; i++) {
+        if (i % 3 == 0) {
+            numbers.append(i * 1000);
+        } else if (i % 3 == 1) {
+            numbers.append(-i * 1000000000LL);
+        } else {
+            numbers.append(i * 12345.0);
+        }
+    }
+    const BSONArray all = numbers.arr();
+
+    for (auto ord : {ALL_ASCENDING, ONE_DESCENDING}) {
+        // An empty array is the array ctype byte followed by its terminator and then kEnd.
+        const KeyString empty(version, BSON("" << BSONArray()), ord);
+        ASSERT_EQUALS(3U, empty.getSize());
+
+        std::vector<BSONElement> prefix;
+        std::string expected(empty.getBuffer(), 1);
+        BSONForEach(elem, all) {
+            prefix.push_back(elem);
+            const KeyString single(version, elem.wrap(""), ord);
+            expected.append(single.getBuffer(), single.getSize() - 1);
+
+            BSONArrayBuilder array;
+            for (auto&& prefixElem : prefix) {
+                array.append(prefixElem);
+            }
+            const BSONObj key = BSON("" << array.arr());
+            ROUNDTRIP_ORDER(version, key, ord);
+
+            const KeyString ks(version, key, ord);
+            const std::string expectedKey = expected + std::string(empty.getBuffer() + 1, 2);
+            ASSERT_EQUALS(toHex(expectedKey.data(), expectedKey.size()),
+                          toHex(ks.getBuffer(), ks.getSize()));
+        }
+    }
+}
+
 TEST_F(KeyStringTest, SubDoc1) {
     ROUNDTRIP(version, BSON("" << BSON("foo" << 2)));
     ROUNDTRIP(version,
@@ -359,6 +422,26 @@ TEST_F(KeyStringTest, SubDoc2) {
     COMPARES_SAME(version, b, c);
 }
 
+TEST_F(KeyStringTest, InvertedStringsOfEveryLength) {
+    // Descending strings are bit-flipped in word and vector sized chunks, so cover lengths on
+    // both sides of each chunk boundary, with and without embedded NUL bytes.
+    for (size_t len = 0; len <= 40; len++) {
+        std::string str;
+        for (size_t i = 0; i < len; i++) {
+            str += static_cast<char>('a' + (i % 26));
+        }
+        ROUNDTRIP(version, BSON("" << str));
+        ROUNDTRIP(version, BSON("" << BSONCode(str)));
+
+        if (len > 0) {
+            str[len / 2] = '\0';
+            str[len - 1] = '\0';
+            ROUNDTRIP(version, BSON("" << str));
+            ROUNDTRIP(version, BSON("" << BSONSymbol(str)));
+        }
+    }
+}
+
 
 TEST_F(KeyStringTest, Compound1) {
     ROUNDTRIP(version, BSON("" << BSON("a" << 5) << "" << 1));
@@ -1020,6 +1103,70 @@ TEST_F(KeyStringTest, AllPermCompare) {
     testPermutation(version, elements, orderings, false);
 }
 
+TEST_F(KeyStringTest, ValueCompareMatchesKeyStringCompare) {
+    std::vector<BSONObj> elements = getInterestingElements(version);
+    for (const auto& ordering : {ONE_ASCENDING, ONE_DESCENDING}) {
+        for (size_t i = 0; i < elements.size(); i++) {
+            const KeyString ksI(version, elements[i], ordering);
+            const KeyString::Value valueI = ksI.getValueCopy();
+            ASSERT_EQ(valueI.getSize(), ksI.getSize());
+            ASSERT_EQ(memcmp(valueI.getBuffer(), ksI.getBuffer(), ksI.getSize()), 0);
+
+            for (size_t j = 0; j < elements.size(); j++) {
+                const KeyString ksJ(version, elements[j], ordering);
+                const KeyString::Value valueJ = ksJ.getValueCopy();
+                ASSERT_EQ(valueI.compare(valueJ), ksI.compare(ksJ))
+                    << elements[i] << " vs " << elements[j];
+                if (valueI.getPrefix() != valueJ.getPrefix()) {
+                    ASSERT_EQ(valueI.getPrefix() < valueJ.getPrefix(), ksI < ksJ);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(KeyStringTest, ValueComparesKeysSharingAPrefix) {
+    // These keys differ only after their first eight bytes, or only in length.
+    const KeyString a(version, BSON("" << "aaaaaaaaaa"), ALL_ASCENDING);
+    const KeyString b(version, BSON("" << "aaaaaaaaab"), ALL_ASCENDING);
+    const KeyString c(version, BSON("" << "aaaaaaaaaa"
+                                       << ""
+                                       << 1),
+                      ALL_ASCENDING);
+    ASSERT_EQ(a.getValueCopy().getPrefix(), b.getValueCopy().getPrefix());
+    ASSERT_LT(a.getValueCopy().compare(b.getValueCopy()), 0);
+    ASSERT_GT(b.getValueCopy().compare(a.getValueCopy()), 0);
+    ASSERT_LT(a.getValueCopy().compare(c.getValueCopy()), 0);
+    ASSERT_EQ(a.getValueCopy().compare(a.getValueCopy()), 0);
+}
+
+TEST_F(KeyStringTest, ValueSorterRoundtrip) {
+    std::vector<BSONObj> elements = getInterestingElements(version);
+    for (size_t i = 0; i < elements.size(); i++) {
+        const KeyString ks(version, elements[i], ONE_ASCENDING, RecordId(i + 1));
+        const KeyString::Value value = ks.getValueCopy();
+
+        BufBuilder buf;
+        value.serializeForSorter(buf);
+        BufReader reader(buf.buf(), buf.len());
+        const KeyString::Value read = KeyString::Value::deserializeForSorter(
+            reader, KeyString::Value::SorterDeserializeSettings(version));
+        ASSERT(reader.atEof());
+
+        ASSERT_EQ(read.compare(value), 0);
+        ASSERT_EQ(read.getPrefix(), value.getPrefix());
+        ASSERT(read.getVersion() == version);
+        ASSERT_EQ(KeyString::decodeRecordIdAtEnd(read.getBuffer(), read.getSize()),
+                  RecordId(i + 1));
+
+        const size_t keySize = KeyString::sizeWithoutRecordIdAtEnd(read.getBuffer(), read.getSize());
+        const BSONObj decoded =
+            KeyString::toBson(read.getBuffer(), keySize, ONE_ASCENDING, read.getTypeBits());
+        ASSERT_BSONOBJ_EQ(decoded, elements[i]);
+        ASSERT_EQ(decoded.firstElement().type(), elements[i].firstElement().type());
+    }
+}
+
 TEST_F(KeyStringTest, AllPerm2Compare) {
     std::vector<BSONObj> baseElements = getInterestingElements(version);
     auto seed = newSeed();
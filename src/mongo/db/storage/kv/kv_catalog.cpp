@@ -458,6 +458,20 @@ std::string KVCatalog::getIndexIdent(OperationContext* opCtx,
     return idxIdent[idxName].String();
 }
 
+std::map<std::string, std::string> KVCatalog::getIndexIdents(OperationContext* opCtx,
+                                                             StringData ns) const {
+    std::map<std::string, std::string> idents;
+    BSONObj obj = _findEntry(opCtx, ns);
+    BSONElement idxIdent = obj["idxIdent"];
+    if (!idxIdent.isABSONObj())
+        return idents;
+
+    for (auto&& elem : idxIdent.Obj()) {
+        idents[elem.fieldName()] = elem.String();
+    }
+    return idents;
+}
+
 BSONObj KVCatalog::_findEntry(OperationContext* opCtx, StringData ns, RecordId* out) const {
     RecordId dl;
     {
@@ -74,6 +74,12 @@ public:
 
     std::string getIndexIdent(OperationContext* opCtx, StringData ns, StringData idName) const;
 
+    /**
+     * Returns the idents of all indexes of collection 'ns', keyed by index name. Reads the catalog
+     * entry once, as opposed to calling getIndexIdent() for every index.
+     */
+    std::map<std::string, std::string> getIndexIdents(OperationContext* opCtx, StringData ns) const;
+
     BSONCollectionCatalogEntry::MetaData getMetaData(OperationContext* opCtx, StringData ns) const;
     void putMetaData(OperationContext* opCtx,
                      StringData ns,
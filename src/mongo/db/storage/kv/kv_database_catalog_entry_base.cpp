@@ -184,6 +184,17 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
 void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
                                                 const std::string& ns,
                                                 bool forRepair) {
+    if (forRepair) {
+        initCollection(opCtx, ns, BSONCollectionCatalogEntry::MetaData(), forRepair);
+        return;
+    }
+    initCollection(opCtx, ns, _engine->getCatalog()->getMetaData(opCtx, ns), forRepair);
+}
+
+void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
+                                                const std::string& ns,
+                                                const BSONCollectionCatalogEntry::MetaData& md,
+                                                bool forRepair) {
     invariant(!_collections.count(ns));
 
     const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
@@ -194,7 +205,6 @@ void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
         // repaired. This also ensures that if we try to use it, it will blow up.
         rs = nullptr;
     } else {
-        BSONCollectionCatalogEntry::MetaData md = _engine->getCatalog()->getMetaData(opCtx, ns);
         rs = _engine->getEngine()->getGroupedRecordStore(opCtx, ns, ident, md.options, md.prefix);
         invariant(rs);
     }
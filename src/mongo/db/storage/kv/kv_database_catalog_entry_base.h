@@ -36,6 +36,7 @@
 #include "mongo/db/catalog/database_catalog_entry.h"
 
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/storage/bson_collection_catalog_entry.h"
 
 namespace mongo {
 
@@ -85,6 +86,15 @@ public:
 
     void initCollection(OperationContext* opCtx, const std::string& ns, bool forRepair);
 
+    /**
+     * Same as above, but uses the already fetched catalog metadata 'md' for 'ns' rather than
+     * reading it again from the KVCatalog.
+     */
+    void initCollection(OperationContext* opCtx,
+                        const std::string& ns,
+                        const BSONCollectionCatalogEntry::MetaData& md,
+                        bool forRepair);
+
     void reinitCollectionAfterRepair(OperationContext* opCtx, const std::string& ns);
 
 protected:
@@ -383,6 +383,10 @@ TEST(KVCatalogTest, Idx1) {
         MyOperationContext opCtx(engine);
         ASSERT_EQUALS(idxIndent, catalog->getIndexIdent(&opCtx, "a.b", "foo"));
         ASSERT_TRUE(catalog->isUserDataIdent(catalog->getIndexIdent(&opCtx, "a.b", "foo")));
+
+        auto indexIdents = catalog->getIndexIdents(&opCtx, "a.b");
+        ASSERT_EQUALS(1U, indexIdents.size());
+        ASSERT_EQUALS(idxIndent, indexIdents["foo"]);
     }
 
     {
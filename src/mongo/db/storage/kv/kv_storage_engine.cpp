@@ -35,9 +35,12 @@
 
 #include <algorithm>
 
+#include "mongo/base/counter.h"
 #include "mongo/db/catalog/catalog_control.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
@@ -45,6 +48,7 @@
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/temporary_kv_record_store.h"
 #include "mongo/db/storage/storage_repair_observer.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/db/unclean_shutdown.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
@@ -59,6 +63,16 @@ using std::vector;
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
 const auto kCatalogLogLevel = logger::LogSeverity::Debug(2);
+
+// The maximum number of empty temporary record stores kept for reuse.
+const size_t kMaxPooledTemporaryRecordStores = 16;
+
+Counter64 temporaryRecordStorePoolHits;
+Counter64 temporaryRecordStorePoolMisses;
+ServerStatusMetricField<Counter64> displayTemporaryRecordStorePoolHits(
+    "storage.temporaryRecordStores.poolHits", &temporaryRecordStorePoolHits);
+ServerStatusMetricField<Counter64> displayTemporaryRecordStorePoolMisses(
+    "storage.temporaryRecordStores.poolMisses", &temporaryRecordStorePoolMisses);
 }
 
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
@@ -165,13 +179,14 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
         // a repair context, if we can't find an ident in the catalog, we generate a catalog entry
         // 'local.orphan.xxxxx' for it. However, in a nonrepair context, the orphaned idents
         // will be dropped in reconcileCatalogAndIdents().
+        std::set<std::string> collectionIdentsKnownToCatalog;
+        for (const auto& coll : collectionsKnownToCatalog) {
+            collectionIdentsKnownToCatalog.insert(_catalog->getCollectionIdent(coll));
+        }
+
         for (const auto& ident : identsKnownToStorageEngine) {
             if (_catalog->isCollectionIdent(ident)) {
-                bool isOrphan = !std::any_of(collectionsKnownToCatalog.begin(),
-                                             collectionsKnownToCatalog.end(),
-                                             [this, &ident](const auto& coll) {
-                                                 return _catalog->getCollectionIdent(coll) == ident;
-                                             });
+                bool isOrphan = !collectionIdentsKnownToCatalog.count(ident);
                 if (isOrphan) {
                     // If the catalog does not have information about this
                     // collection, we create an new entry for it.
@@ -246,9 +261,11 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
             db = _databaseCatalogEntryFactory(dbName, this).release();
         }
 
-        db->initCollection(opCtx, coll, _options.forRepair);
-        auto maxPrefixForCollection = _catalog->getMetaData(opCtx, coll).getMaxPrefix();
-        maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
+        // Read the catalog entry once and share it between opening the collection and tracking
+        // the largest prefix, since each read fetches and parses the whole _mdb_catalog document.
+        const auto md = _catalog->getMetaData(opCtx, coll);
+        db->initCollection(opCtx, coll, md, _options.forRepair);
+        maxSeenPrefix = std::max(maxSeenPrefix, md.getMaxPrefix());
 
         if (nss.isOrphanCollection()) {
             log() << "Orphaned collection found: " << nss;
@@ -416,12 +433,15 @@ KVStorageEngine::reconcileCatalogAndIdents(OperationContext* opCtx) {
     std::vector<CollectionIndexNamePair> ret;
     for (const auto& coll : collections) {
         BSONCollectionCatalogEntry::MetaData metaData = _catalog->getMetaData(opCtx, coll);
+        const auto indexIdents = _catalog->getIndexIdents(opCtx, coll);
 
         // Batch up the indexes to remove them from `metaData` outside of the iterator.
         std::vector<std::string> indexesToDrop;
         for (const auto& indexMetaData : metaData.indexes) {
             const std::string& indexName = indexMetaData.name();
-            std::string indexIdent = _catalog->getIndexIdent(opCtx, coll, indexName);
+            auto identIt = indexIdents.find(indexName);
+            invariant(identIt != indexIdents.end());
+            const std::string& indexIdent = identIt->second;
 
             const bool foundIdent = engineIdents.find(indexIdent) != engineIdents.end();
             // An index drop will immediately remove the ident, but the `indexMetaData` catalog
@@ -527,6 +547,11 @@ void KVStorageEngine::cleanShutdown() {
     _catalog.reset();
     _catalogRecordStore.reset();
 
+    {
+        stdx::lock_guard<stdx::mutex> lock(_temporaryRecordStorePoolMutex);
+        _temporaryRecordStorePool.clear();
+    }
+
     _timestampMonitor.reset();
 
     _engine->cleanShutdown();
@@ -706,10 +731,58 @@ Status KVStorageEngine::repairRecordStore(OperationContext* opCtx, const std::st
 
 std::unique_ptr<TemporaryRecordStore> KVStorageEngine::makeTemporaryRecordStore(
     OperationContext* opCtx) {
-    std::unique_ptr<RecordStore> rs =
-        _engine->makeTemporaryRecordStore(opCtx, _catalog->newInternalIdent());
-    LOG(1) << "created temporary record store: " << rs->getIdent();
-    return std::make_unique<TemporaryKVRecordStore>(getEngine(), std::move(rs));
+    std::unique_ptr<RecordStore> rs;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_temporaryRecordStorePoolMutex);
+        if (!_temporaryRecordStorePool.empty()) {
+            rs = std::move(_temporaryRecordStorePool.back());
+            _temporaryRecordStorePool.pop_back();
+        }
+    }
+
+    if (rs) {
+        temporaryRecordStorePoolHits.increment();
+        LOG(1) << "reusing temporary record store: " << rs->getIdent();
+    } else {
+        temporaryRecordStorePoolMisses.increment();
+        rs = _engine->makeTemporaryRecordStore(opCtx, _catalog->newInternalIdent());
+        LOG(1) << "created temporary record store: " << rs->getIdent();
+    }
+    return std::make_unique<TemporaryKVRecordStore>(this, std::move(rs));
+}
+
+void KVStorageEngine::releaseTemporaryRecordStore(OperationContext* opCtx,
+                                                  std::unique_ptr<RecordStore> rs) {
+    // The record store can only be emptied in a transaction of its own. Callers that release it
+    // from within a WriteUnitOfWork, such as while rolling one back, drop it instead. The ident may
+    // also have been dropped already, for instance when reconciling the catalog at startup.
+    if (opCtx->lockState()->isWriteLocked() && !opCtx->lockState()->inAWriteUnitOfWork() &&
+        _engine->hasIdent(opCtx, rs->getIdent())) {
+        bool truncated = false;
+        try {
+            WriteUnitOfWork wuow(opCtx);
+            truncated = rs->truncate(opCtx).isOK();
+            if (truncated) {
+                wuow.commit();
+            }
+        } catch (const WriteConflictException&) {
+            truncated = false;
+        }
+
+        if (truncated) {
+            stdx::lock_guard<stdx::mutex> lock(_temporaryRecordStorePoolMutex);
+            if (_temporaryRecordStorePool.size() < kMaxPooledTemporaryRecordStores) {
+                LOG(1) << "pooling temporary record store: " << rs->getIdent();
+                _temporaryRecordStorePool.push_back(std::move(rs));
+                return;
+            }
+        }
+    }
+
+    const std::string ident = rs->getIdent();
+    auto status = _engine->dropIdent(opCtx, ident);
+    fassert(51032,
+            status.withContext(str::stream() << "failed to drop temporary ident: " << ident));
 }
 
 void KVStorageEngine::setJournalListener(JournalListener* jl) {
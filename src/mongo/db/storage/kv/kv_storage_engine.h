@@ -31,6 +31,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
@@ -144,6 +145,13 @@ public:
     virtual std::unique_ptr<TemporaryRecordStore> makeTemporaryRecordStore(
         OperationContext* opCtx) override;
 
+    /**
+     * Takes back a temporary record store that its owner no longer needs. When possible, the
+     * record store is truncated and kept for reuse by makeTemporaryRecordStore(), which saves
+     * creating and dropping a table. Otherwise its ident is dropped.
+     */
+    void releaseTemporaryRecordStore(OperationContext* opCtx, std::unique_ptr<RecordStore> rs);
+
     virtual void cleanShutdown();
 
     virtual void setStableTimestamp(Timestamp stableTimestamp,
@@ -435,5 +443,10 @@ private:
     mutable stdx::mutex _dbsLock;
     using DBMap = std::map<std::string, KVDatabaseCatalogEntryBase*>;
     DBMap _dbs;
+
+    // Empty temporary record stores kept for reuse. Their idents are not in the catalog, so any
+    // left over at shutdown are dropped on the next startup like other unknown internal idents.
+    stdx::mutex _temporaryRecordStorePoolMutex;
+    std::vector<std::unique_ptr<RecordStore>> _temporaryRecordStorePool;
 };
 }  // namespace mongo
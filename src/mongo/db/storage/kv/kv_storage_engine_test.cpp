@@ -299,6 +299,31 @@ TEST_F(KVStorageEngineTest, TemporaryDropsItself) {
     ASSERT(!identExists(opCtx.get(), ident));
 }
 
+TEST_F(KVStorageEngineTest, TemporaryIsReusedAfterRelease) {
+    auto opCtx = cc().makeOperationContext();
+    Lock::GlobalWrite writeLock(opCtx.get(), Date_t::max(), Lock::InterruptBehavior::kThrow);
+
+    std::string ident;
+    {
+        auto rs = makeTemporary(opCtx.get());
+        ident = rs->rs()->getIdent();
+        {
+            WriteUnitOfWork wuow(opCtx.get());
+            ASSERT_OK(rs->rs()->insertRecord(opCtx.get(), "data", 5, Timestamp()).getStatus());
+            wuow.commit();
+        }
+        rs->deleteTemporaryTable(opCtx.get());
+    }
+
+    // Releasing the temporary record store outside of a WriteUnitOfWork keeps it for reuse.
+    ASSERT(identExists(opCtx.get(), ident));
+
+    auto rs = makeTemporary(opCtx.get());
+    ASSERT_EQUALS(ident, rs->rs()->getIdent());
+    ASSERT_EQUALS(0, rs->rs()->numRecords(opCtx.get()));
+    rs->deleteTemporaryTable(opCtx.get());
+}
+
 TEST_F(KVStorageEngineTest, ReconcileDoesNotDropIndexBuildTempTables) {
     auto opCtx = cc().makeOperationContext();
 
@@ -33,9 +33,8 @@
 
 #include "mongo/db/storage/kv/temporary_kv_record_store.h"
 
-#include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/util/assert_util.h"
-#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -44,10 +43,7 @@ TemporaryKVRecordStore::~TemporaryKVRecordStore() {
 }
 
 void TemporaryKVRecordStore::deleteTemporaryTable(OperationContext* opCtx) {
-    auto status = _kvEngine->dropIdent(opCtx, _rs->getIdent());
-    fassert(
-        51032,
-        status.withContext(str::stream() << "failed to drop temporary ident: " << _rs->getIdent()));
+    _storageEngine->releaseTemporaryRecordStore(opCtx, std::move(_rs));
     _recordStoreHasBeenDeleted = true;
 }
 
@@ -34,7 +34,7 @@
 
 namespace mongo {
 
-class KVEngine;
+class KVStorageEngine;
 class OperationContext;
 
 /**
@@ -44,8 +44,8 @@ class OperationContext;
  */
 class TemporaryKVRecordStore : public TemporaryRecordStore {
 public:
-    TemporaryKVRecordStore(KVEngine* kvEngine, std::unique_ptr<RecordStore> rs)
-        : TemporaryRecordStore(std::move(rs)), _kvEngine(kvEngine){};
+    TemporaryKVRecordStore(KVStorageEngine* storageEngine, std::unique_ptr<RecordStore> rs)
+        : TemporaryRecordStore(std::move(rs)), _storageEngine(storageEngine){};
 
     // Not copyable.
     TemporaryKVRecordStore(const TemporaryKVRecordStore&) = delete;
@@ -54,17 +54,18 @@ public:
     // Move constructor.
     TemporaryKVRecordStore(TemporaryKVRecordStore&& other) noexcept
         : TemporaryRecordStore(std::move(other._rs)),
-          _kvEngine(other._kvEngine) {}
+          _storageEngine(other._storageEngine) {}
 
     ~TemporaryKVRecordStore();
 
     /**
-     * Drops the persisted record store from the storage engine.
+     * Returns the record store to the storage engine, which either drops it or keeps it for reuse
+     * by a later temporary record store. The record store may not be used afterwards.
      */
     void deleteTemporaryTable(OperationContext* opCtx);
 
 private:
-    KVEngine* _kvEngine;
+    KVStorageEngine* _storageEngine;
     bool _recordStoreHasBeenDeleted = false;
 };
 
@@ -39,6 +39,7 @@
 #include "mongo/db/storage/mobile/mobile_recovery_unit.h"
 #include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
 #include "mongo/db/storage/mobile/mobile_util.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -103,14 +104,14 @@ StatusWith<SpecialFormatInserted> MobileIndex::doInsert(OperationContext* opCtx,
     }
 
     std::string insertQuery = "INSERT INTO \"" + _ident + "\" (key, value) VALUES (?, ?);";
-    SqliteStatement insertStmt(*session, insertQuery);
+    SqliteStatement& insertStmt = *session->getCachedStatement(insertQuery);
+    ON_BLOCK_EXIT([&insertStmt] { insertStmt.resetForReuse(); });
 
     insertStmt.bindBlob(0, key.getBuffer(), key.getSize());
     insertStmt.bindBlob(1, value.getBuffer(), value.getSize());
 
     int status = insertStmt.step();
     if (status == SQLITE_CONSTRAINT) {
-        insertStmt.setExceptionStatus(status);
         if (isUnique()) {
             // Return error if duplicate key inserted in a unique index.
             BSONObj bson =
@@ -151,7 +152,8 @@ void MobileIndex::_doDelete(OperationContext* opCtx, const KeyString& key, KeySt
         deleteQuery << " AND value = ?";
     }
     deleteQuery << ";";
-    SqliteStatement deleteStmt(*session, deleteQuery);
+    SqliteStatement& deleteStmt = *session->getCachedStatement(deleteQuery);
+    ON_BLOCK_EXIT([&deleteStmt] { deleteStmt.resetForReuse(); });
 
     deleteStmt.bindBlob(0, key.getBuffer(), key.getSize());
     if (value) {
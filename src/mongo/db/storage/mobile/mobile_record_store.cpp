@@ -50,6 +50,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -263,7 +264,8 @@ bool MobileRecordStore::findRecord(OperationContext* opCtx,
                                    RecordData* rd) const {
     MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx);
     std::string sqlQuery = "SELECT data FROM \"" + _ident + "\" WHERE rec_id = ?;";
-    SqliteStatement stmt(*session, sqlQuery);
+    SqliteStatement& stmt = *session->getCachedStatement(sqlQuery);
+    ON_BLOCK_EXIT([&stmt] { stmt.resetForReuse(); });
 
     stmt.bindInt(0, recId.repr());
 
@@ -283,7 +285,8 @@ void MobileRecordStore::deleteRecord(OperationContext* opCtx, const RecordId& re
     MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
     std::string dataSizeQuery =
         "SELECT IFNULL(LENGTH(data), 0) FROM \"" + _ident + "\" WHERE rec_id = ?;";
-    SqliteStatement dataSizeStmt(*session, dataSizeQuery);
+    SqliteStatement& dataSizeStmt = *session->getCachedStatement(dataSizeQuery);
+    ON_BLOCK_EXIT([&dataSizeStmt] { dataSizeStmt.resetForReuse(); });
     dataSizeStmt.bindInt(0, recId.repr());
     dataSizeStmt.step(SQLITE_ROW);
 
@@ -292,7 +295,8 @@ void MobileRecordStore::deleteRecord(OperationContext* opCtx, const RecordId& re
     _changeDataSize(opCtx, -dataSizeBefore);
 
     std::string deleteQuery = "DELETE FROM \"" + _ident + "\" WHERE rec_id = ?;";
-    SqliteStatement deleteStmt(*session, deleteQuery);
+    SqliteStatement& deleteStmt = *session->getCachedStatement(deleteQuery);
+    ON_BLOCK_EXIT([&deleteStmt] { deleteStmt.resetForReuse(); });
     deleteStmt.bindInt(0, recId.repr());
     deleteStmt.step(SQLITE_DONE);
 }
@@ -303,6 +307,11 @@ Status MobileRecordStore::insertRecords(OperationContext* opCtx,
     // Inserts record into SQLite table (or replaces if duplicate record id).
     MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
 
+    // The statement is prepared once and reused for every record inserted by this transaction.
+    std::string insertQuery =
+        "INSERT OR REPLACE INTO \"" + _ident + "\"(rec_id, data) VALUES(?, ?);";
+    SqliteStatement& insertStmt = *session->getCachedStatement(insertQuery);
+
     for (auto& record : *inOutRecords) {
         const auto data = record.data.data();
         const auto len = record.data.size();
@@ -310,9 +319,7 @@ Status MobileRecordStore::insertRecords(OperationContext* opCtx,
         _changeNumRecs(opCtx, 1);
         _changeDataSize(opCtx, len);
 
-        std::string insertQuery =
-            "INSERT OR REPLACE INTO \"" + _ident + "\"(rec_id, data) VALUES(?, ?);";
-        SqliteStatement insertStmt(*session, insertQuery);
+        ON_BLOCK_EXIT([&insertStmt] { insertStmt.resetForReuse(); });
         RecordId recId = _nextId();
         insertStmt.bindInt(0, recId.repr());
         insertStmt.bindBlob(1, data, len);
@@ -355,7 +362,8 @@ Status MobileRecordStore::updateRecord(OperationContext* opCtx,
     MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
     std::string dataSizeQuery =
         "SELECT IFNULL(LENGTH(data), 0) FROM \"" + _ident + "\" WHERE rec_id = ?;";
-    SqliteStatement dataSizeStmt(*session, dataSizeQuery);
+    SqliteStatement& dataSizeStmt = *session->getCachedStatement(dataSizeQuery);
+    ON_BLOCK_EXIT([&dataSizeStmt] { dataSizeStmt.resetForReuse(); });
     dataSizeStmt.bindInt(0, recId.repr());
     dataSizeStmt.step(SQLITE_ROW);
 
@@ -363,7 +371,8 @@ Status MobileRecordStore::updateRecord(OperationContext* opCtx,
     _changeDataSize(opCtx, -dataSizeBefore + len);
 
     std::string updateQuery = "UPDATE \"" + _ident + "\" SET data = ? " + "WHERE rec_id = ?;";
-    SqliteStatement updateStmt(*session, updateQuery);
+    SqliteStatement& updateStmt = *session->getCachedStatement(updateQuery);
+    ON_BLOCK_EXIT([&updateStmt] { updateStmt.resetForReuse(); });
     updateStmt.bindBlob(0, data, len);
     updateStmt.bindInt(1, recId.repr());
     updateStmt.step(SQLITE_DONE);
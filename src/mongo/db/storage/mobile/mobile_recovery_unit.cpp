@@ -215,6 +215,10 @@ void MobileRecoveryUnit::_txnClose(bool commit) {
         SqliteStatement::execQuery(_session.get(), "ROLLBACK");
     }
 
+    // Statements cached during the transaction are only reused within it, so that they never
+    // outlive a table dropped by a later transaction.
+    _session->clearStatementCache();
+
     _active = false;
     _isReadOnly = true;  // I don't suppose we need this, but no harm in doing so
 }
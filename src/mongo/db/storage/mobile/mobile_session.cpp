@@ -33,6 +33,7 @@
 
 #include "mongo/db/storage/mobile/mobile_session.h"
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
 
 namespace mongo {
 
@@ -40,6 +41,9 @@ MobileSession::MobileSession(sqlite3* session, MobileSessionPool* sessionPool)
     : _session(session), _sessionPool(sessionPool) {}
 
 MobileSession::~MobileSession() {
+    // Cached statements must be finalized before the connection can be reused or closed.
+    clearStatementCache();
+
     // Releases this session back to the session pool.
     _sessionPool->releaseSession(this);
 }
@@ -47,4 +51,16 @@ MobileSession::~MobileSession() {
 sqlite3* MobileSession::getSession() const {
     return _session;
 }
+
+SqliteStatement* MobileSession::getCachedStatement(const std::string& sqlQuery) {
+    auto& stmt = _statementCache[sqlQuery];
+    if (!stmt) {
+        stmt = std::make_unique<SqliteStatement>(*this, sqlQuery);
+    }
+    return stmt.get();
+}
+
+void MobileSession::clearStatementCache() {
+    _statementCache.clear();
+}
 }  // namespace mongo
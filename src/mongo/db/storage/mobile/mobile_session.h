@@ -29,14 +29,17 @@
 
 #pragma once
 
+#include <memory>
 #include <sqlite3.h>
 #include <string>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 class MobileSessionPool;
+class SqliteStatement;
 
 /**
  * This class manages a SQLite database connection object.
@@ -54,8 +57,22 @@ public:
      */
     sqlite3* getSession() const;
 
+    /**
+     * Returns a prepared statement for 'sqlQuery' owned by this session. The statement stays
+     * prepared until clearStatementCache() is called, so writes repeated within a transaction
+     * only prepare it once. Callers must call SqliteStatement::resetForReuse() once done with it.
+     */
+    SqliteStatement* getCachedStatement(const std::string& sqlQuery);
+
+    /**
+     * Finalizes all statements returned by getCachedStatement().
+     */
+    void clearStatementCache();
+
 private:
     sqlite3* _session;
     MobileSessionPool* _sessionPool;
+
+    StringMap<std::unique_ptr<SqliteStatement>> _statementCache;
 };
 }  // namespace mongo
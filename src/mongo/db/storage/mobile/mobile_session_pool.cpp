@@ -39,6 +39,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/mobile/mobile_parameters_gen.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
 #include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
@@ -120,6 +121,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         sqlite3* session;
         int status = sqlite3_open(_path.c_str(), &session);
         checkStatus(status, SQLITE_OK, "sqlite3_open");
+        _configureSession(session);
         _curPoolSize++;
         return stdx::make_unique<MobileSession>(session, this);
     }
@@ -178,6 +180,18 @@ void MobileSessionPool::shutDown() {
     }
 }
 
+void MobileSessionPool::_configureSession(sqlite3* session) {
+    // The auto-checkpoint threshold and the memory-mapped size are properties of each connection
+    // rather than the database.
+    std::string configureQuery =
+        "PRAGMA wal_autocheckpoint = " + std::to_string(gMobileWalAutoCheckpointPages) + ";" +
+        "PRAGMA mmap_size = " + std::to_string(gMobileMmapSizeBytes) + ";";
+    char* errMsg = NULL;
+    int status = sqlite3_exec(session, configureQuery.c_str(), NULL, NULL, &errMsg);
+    checkStatus(status, SQLITE_OK, "sqlite3_exec", errMsg);
+    sqlite3_free(errMsg);
+}
+
 // This method should only be called when _sessions is locked.
 sqlite3* MobileSessionPool::_popSession_inlock() {
     sqlite3* session = _sessions.back();
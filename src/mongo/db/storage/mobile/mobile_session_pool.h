@@ -92,6 +92,12 @@ public:
     MobileDelayedOpQueue failedDropsQueue;
 
 private:
+    /**
+     * Applies the per-connection settings, such as the WAL checkpoint threshold, to a newly opened
+     * session.
+     */
+    void _configureSession(sqlite3* session);
+
     /**
      * Gets the front element from _sessions and then pops it off the queue.
      */
@@ -167,4 +167,11 @@ void SqliteStatement::reset() {
     checkStatus(status, SQLITE_OK, "sqlite3_reset");
 }
 
+void SqliteStatement::resetForReuse() {
+    // sqlite3_reset returns the error of the last step, if any, which the caller has already seen.
+    sqlite3_reset(_stmt);
+    _exceptionStatus = SQLITE_OK;
+    clearBindings();
+}
+
 }  // namespace mongo
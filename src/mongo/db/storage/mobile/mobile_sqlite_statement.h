@@ -102,6 +102,12 @@ public:
      */
     void reset();
 
+    /**
+     * Resets the statement and clears its bindings so that it can be stepped again, regardless of
+     * whether the last step failed. Used for statements cached by MobileSession.
+     */
+    void resetForReuse();
+
     /**
      * Sets the last status on the prepared statement.
      */
@@ -472,6 +472,40 @@ public:
      */
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) = 0;
 
+    /**
+     * Deletes every record whose RecordId is in the range ['first', 'last'], and returns the
+     * number of records deleted. Indexes are not updated, so callers must either remove the
+     * matching index entries themselves or only use this on collections without indexes. Not
+     * supported on capped collections.
+     *
+     * Storage engines that can drop a contiguous range of records without visiting each of them
+     * should override the default implementation, which deletes the records one by one.
+     */
+    virtual StatusWith<int64_t> deleteRange(OperationContext* opCtx,
+                                            const RecordId& first,
+                                            const RecordId& last) {
+        if (isCapped()) {
+            return {ErrorCodes::IllegalOperation,
+                    "Cannot delete a range of records from a capped collection"};
+        }
+
+        std::vector<RecordId> toDelete;
+        {
+            auto cursor = getCursor(opCtx, true);
+            while (auto record = cursor->next()) {
+                if (record->id > last)
+                    break;
+                if (record->id >= first)
+                    toDelete.push_back(record->id);
+            }
+        }
+
+        for (auto&& id : toDelete) {
+            deleteRecord(opCtx, id);
+        }
+        return static_cast<int64_t>(toDelete.size());
+    }
+
     /**
      * does this RecordStore support the compact operation?
      *
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/record_store_test_harness.h"
+
+#include "mongo/db/storage/record_store.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using std::string;
+using std::unique_ptr;
+
+// Insert multiple records, and verify that deleteRange() removes exactly the records whose ids
+// fall within the range and updates the record count and data size.
+TEST(RecordStoreTestHarness, DeleteRange) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 10;
+    const string data = "record";
+    std::vector<RecordId> ids;
+    for (int i = 0; i < nToInsert; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        ids.push_back(res.getValue());
+        uow.commit();
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<int64_t> res = rs->deleteRange(opCtx.get(), ids[3], ids[6]);
+        ASSERT_OK(res.getStatus());
+        ASSERT_EQUALS(4, res.getValue());
+        uow.commit();
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(nToInsert - 4, rs->numRecords(opCtx.get()));
+        ASSERT_EQUALS((nToInsert - 4) * static_cast<long long>(data.size() + 1),
+                      rs->dataSize(opCtx.get()));
+
+        for (int i = 0; i < nToInsert; i++) {
+            RecordData rd;
+            ASSERT_EQUALS(i < 3 || i > 6, rs->findRecord(opCtx.get(), ids[i], &rd));
+        }
+    }
+
+    // A range with no records in it deletes nothing.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<int64_t> res = rs->deleteRange(opCtx.get(), ids[4], ids[5]);
+        ASSERT_OK(res.getStatus());
+        ASSERT_EQUALS(0, res.getValue());
+        uow.commit();
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -29,6 +29,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/record_data.h"
 #include "mongo/db/storage/record_store.h"
@@ -93,6 +95,51 @@ TEST(RecordStoreTestHarness, UpdateRecord) {
     }
 }
 
+// Insert a large record and make small changes to it, which storage engines may write as deltas.
+TEST(RecordStoreTestHarness, UpdateLargeRecordWithSmallChanges) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    string data;
+    for (unsigned i = 0; i < 64 * 1024; i++) {
+        data.push_back(static_cast<char>((i * 2654435761U) >> 24));
+    }
+
+    RecordId loc;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp());
+        ASSERT_OK(res.getStatus());
+        loc = res.getValue();
+        uow.commit();
+    }
+
+    // Overwrite a few bytes, then grow and shrink the record in the middle.
+    std::vector<string> updates;
+    updates.push_back(data);
+    updates.back()[1000] ^= 1;
+    updates.back()[40000] ^= 1;
+    updates.push_back(updates.back());
+    updates.back().insert(30000, "inserted");
+    updates.push_back(updates.back());
+    updates.back().erase(50000, 16);
+
+    for (const auto& update : updates) {
+        {
+            ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->updateRecord(opCtx.get(), loc, update.c_str(), update.size()));
+            uow.commit();
+        }
+
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        RecordData record = rs->dataFor(opCtx.get(), loc);
+        ASSERT_EQUALS(update, string(record.data(), record.size()));
+    }
+}
+
 // Insert multiple records and try to update them.
 TEST(RecordStoreTestHarness, UpdateMultipleRecords) {
     const auto harnessHelper(newRecordStoreHarnessHelper());
@@ -291,6 +291,28 @@ public:
         return (nullptr);
     }
 
+    /**
+     * Cumulative counters of the storage engine work done on behalf of this recovery unit.
+     */
+    struct StorageCounters {
+        // Bytes read from disk into the storage engine cache.
+        long long bytesRead = 0;
+        // Time spent reading them from disk.
+        long long readMicros = 0;
+        // Time spent waiting for space in the storage engine cache.
+        long long cacheWaitMicros = 0;
+    };
+
+    /**
+     * Returns the current values of the storage counters, so that the storage engine work done by
+     * a part of an operation can be measured as a difference. Unlike getOperationStatistics(),
+     * this does not reset the statistics. Returns all zeros if the storage engine does not track
+     * them.
+     */
+    virtual StorageCounters getStorageCounters() const {
+        return {};
+    }
+
     /**
      * The ReadSource indicates which external or provided timestamp to read from for future
      * transactions.
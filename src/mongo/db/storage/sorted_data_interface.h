@@ -121,6 +121,36 @@ public:
      */
     virtual Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key) = 0;
 
+    /**
+     * Remove every entry from the index whose key is in the range ['lo', 'hi'], regardless of its
+     * RecordId. Like unindex(), 'lo' and 'hi' must not have field names.
+     *
+     * Storage engines that can drop a contiguous range of keys without visiting each of them
+     * should override the default implementation, which unindexes the entries one by one.
+     *
+     * @param opCtx the transaction under which the remove takes place
+     * @param dupsAllowed true if duplicate keys are allowed, and false
+     *        otherwise
+     */
+    virtual Status removeRange(OperationContext* opCtx,
+                               const BSONObj& lo,
+                               const BSONObj& hi,
+                               bool dupsAllowed) {
+        std::vector<IndexKeyEntry> toRemove;
+        {
+            auto cursor = newCursor(opCtx);
+            cursor->setEndPosition(hi, true);
+            for (auto entry = cursor->seek(lo, true); entry; entry = cursor->next()) {
+                toRemove.push_back(*entry);
+            }
+        }
+
+        for (auto&& entry : toRemove) {
+            unindex(opCtx, entry.key, entry.loc, dupsAllowed);
+        }
+        return Status::OK();
+    }
+
     /**
      * Attempt to reduce the storage space used by this index via compaction. Only called if the
      * indexed record store supports compaction-in-place.
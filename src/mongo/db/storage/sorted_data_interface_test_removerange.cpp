@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/storage/sorted_data_interface_test_harness.h"
+
+#include <memory>
+
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Insert keys on both sides of a range and verify that removeRange() removes exactly the entries
+// whose keys are within the range, including duplicates of the bounds.
+void removeRange(bool unique) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(
+        unique,
+        /*partial=*/false,
+        {{key1, loc1}, {key2, loc2}, {key3, loc3}, {key4, loc4}, {key5, loc5}}));
+    if (!unique) {
+        insertToIndex(harnessHelper.get(), sorted.get(), {{key2, loc6}, {key4, loc7}});
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->removeRange(opCtx.get(), key2, key4, !unique));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(2, sorted->numEntries(opCtx.get()));
+
+        const auto cursor(sorted->newCursor(opCtx.get()));
+        ASSERT_EQ(cursor->seek(kMinBSONKey, true), IndexKeyEntry(key1, loc1));
+        ASSERT_EQ(cursor->next(), IndexKeyEntry(key5, loc5));
+        ASSERT_EQ(cursor->next(), boost::none);
+    }
+}
+
+TEST(SortedDataInterface, RemoveRange) {
+    removeRange(/*unique=*/false);
+}
+
+TEST(SortedDataInterface, RemoveRangeUnique) {
+    removeRange(/*unique=*/true);
+}
+
+// Verify that removing a range that contains no keys leaves the index unchanged.
+TEST(SortedDataInterface, RemoveRangeEmpty) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(
+        /*unique=*/false, /*partial=*/false, {{key1, loc1}, {key5, loc5}}));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->removeRange(opCtx.get(), key2, key4, true));
+            ASSERT_OK(sorted->removeRange(opCtx.get(), key4, key2, true));
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(2, sorted->numEntries(opCtx.get()));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -37,11 +37,13 @@ namespace mongo {
 WiredTigerCursor::WiredTigerCursor(const std::string& uri,
                                    uint64_t tableID,
                                    bool allowOverwrite,
-                                   OperationContext* opCtx) {
+                                   OperationContext* opCtx,
+                                   bool forceReadOnce) {
     _tableID = tableID;
     _ru = WiredTigerRecoveryUnit::get(opCtx);
     _session = _ru->getSession();
-    _readOnce = _ru->getReadOnce();
+    _forcedReadOnce = forceReadOnce && !_ru->getReadOnce();
+    _readOnce = forceReadOnce || _ru->getReadOnce();
 
     if (_readOnce) {
         _cursor = _session->getReadOnceCursor(uri, allowOverwrite);
@@ -51,7 +53,7 @@ WiredTigerCursor::WiredTigerCursor(const std::string& uri,
 }
 
 WiredTigerCursor::~WiredTigerCursor() {
-    dassert(_ru->getReadOnce() == _readOnce);
+    dassert(_ru->getReadOnce() == (_readOnce && !_forcedReadOnce));
 
     // Read-once cursors will never take cursors from the cursor cache, and should never release
     // cursors into the cursor cache.
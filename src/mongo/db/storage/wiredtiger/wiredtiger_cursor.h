@@ -40,13 +40,17 @@ namespace mongo {
 /**
  * This is an object wrapper for WT_CURSOR. It obtains a cursor from the WiredTigerSession and is
  * responsible for returning or closing the cursor when destructed.
+ *
+ * The cursor is opened read-once if the recovery unit is in read-once mode or if 'forceReadOnce'
+ * is set.
  */
 class WiredTigerCursor {
 public:
     WiredTigerCursor(const std::string& uri,
                      uint64_t tableID,
                      bool allowOverwrite,
-                     OperationContext* opCtx);
+                     OperationContext* opCtx,
+                     bool forceReadOnce = false);
 
     ~WiredTigerCursor();
 
@@ -74,6 +78,7 @@ protected:
     WiredTigerRecoveryUnit* _ru;
     WiredTigerSession* _session;
     bool _readOnce;
+    bool _forcedReadOnce;
 
     WT_CURSOR* _cursor = nullptr;  // Owned
 };
@@ -47,6 +47,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -141,6 +142,12 @@ StatusWith<std::string> WiredTigerIndex::parseIndexOptions(const BSONObj& option
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == "cachePriority") {
+            auto priority = WiredTigerUtil::parseCachePriority(elem);
+            if (!priority.isOK()) {
+                return priority.getStatus();
+            }
+            ss << WiredTigerUtil::cachePriorityConfig(priority.getValue());
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -424,6 +431,43 @@ Status WiredTigerIndex::dupKeyCheck(OperationContext* opCtx, const BSONObj& key)
     return Status::OK();
 }
 
+Status WiredTigerIndex::removeRange(OperationContext* opCtx,
+                                    const BSONObj& lo,
+                                    const BSONObj& hi,
+                                    bool dupsAllowed) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    dassert(!hasFieldNames(lo));
+    dassert(!hasFieldNames(hi));
+
+    // These bounds sort before and after every entry for 'lo' and 'hi' respectively, whatever
+    // follows the key in the entry. WiredTiger truncates from the first entry at or after 'start'
+    // to the last entry at or before 'stop', so the bounds need not exist in the index.
+    const KeyString start(keyStringVersion(), lo, _ordering, KeyString::kExclusiveBefore);
+    const KeyString stop(keyStringVersion(), hi, _ordering, KeyString::kExclusiveAfter);
+    if (start.compare(stop) >= 0) {
+        return Status::OK();
+    }
+
+    WiredTigerCursor startWrap(_uri, _tableId, false, opCtx);
+    startWrap.assertInActiveTxn();
+    WiredTigerCursor stopWrap(_uri, _tableId, false, opCtx);
+    WT_CURSOR* startCursor = startWrap.get();
+    WT_CURSOR* stopCursor = stopWrap.get();
+
+    WiredTigerItem startItem(start.getBuffer(), start.getSize());
+    setKey(startCursor, startItem.Get());
+    WiredTigerItem stopItem(stop.getBuffer(), stop.getSize());
+    setKey(stopCursor, stopItem.Get());
+
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    int ret = WT_OP_CHECK(session->truncate(session, nullptr, startCursor, stopCursor, nullptr));
+    if (ret == WT_NOTFOUND) {
+        // There are no entries in the range.
+        return Status::OK();
+    }
+    return wtRCToStatus(ret);
+}
+
 bool WiredTigerIndex::isEmpty(OperationContext* opCtx) {
     if (_prefix != KVPrefix::kNotPrefixed) {
         const bool forward = true;
@@ -817,6 +861,9 @@ public:
         if (!_lastMoveSkippedKey)
             advanceWTCursor();
         updatePosition(true);
+        if (!_eof && _readAheadTracker.advanced()) {
+            scheduleReadAhead();
+        }
         return curr(parts);
     }
 
@@ -849,6 +896,7 @@ public:
         _query.resetToKey(finalKey, _idx.ordering(), discriminator);
         seekWTCursor(_query);
         updatePosition();
+        _readAheadTracker.reset();
         return curr(parts);
     }
 
@@ -864,6 +912,7 @@ public:
         _query.resetToKey(key, _idx.ordering(), discriminator);
         seekWTCursor(_query);
         updatePosition();
+        _readAheadTracker.reset();
         return curr(parts);
     }
 
@@ -1050,6 +1099,30 @@ protected:
         return false;
     }
 
+    /**
+     * Asks the engine's read-ahead threads to walk the keys past the current position.
+     */
+    void scheduleReadAhead() {
+        auto engine = WiredTigerRecoveryUnit::get(_opCtx)->getSessionCache()->getKVEngine();
+        if (!engine) {
+            // Some unit tests run without a storage engine.
+            return;
+        }
+
+        // The request may run after this cursor and its index are gone, so it gets copies.
+        std::string key(_key.getBuffer(), _key.getSize());
+        const KVPrefix prefix = _prefix;
+        engine->getReadAhead()->schedule(
+            &_readAheadTracker, _idx.uri(), _forward, [key, prefix](WT_CURSOR* cursor) {
+                const WiredTigerItem item(key.data(), key.size());
+                if (prefix == KVPrefix::kNotPrefixed) {
+                    cursor->set_key(cursor, item.Get());
+                } else {
+                    cursor->set_key(cursor, prefix.repr(), item.Get());
+                }
+            });
+    }
+
     /**
      * This must be called after moving the cursor to update our cached position. It should not
      * be called after a restore that did not restore to original state since that does not
@@ -1129,6 +1202,8 @@ protected:
     KVPrefix _prefix;
 
     std::unique_ptr<KeyString> _endPosition;
+
+    WiredTigerReadAhead::Tracker _readAheadTracker;
 };
 
 // The Standard Cursor doesn't need anything more than the base has.
@@ -109,6 +109,11 @@ public:
                                    double scale) const;
     virtual Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key);
 
+    virtual Status removeRange(OperationContext* opCtx,
+                               const BSONObj& lo,
+                               const BSONObj& hi,
+                               bool dupsAllowed);
+
     virtual bool isEmpty(OperationContext* opCtx);
 
     virtual Status touch(OperationContext* opCtx) const;
@@ -75,6 +75,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -83,6 +84,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/ticket_limit_controller.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
@@ -277,13 +279,7 @@ public:
         LOG(1) << "starting " << name() << " thread";
 
         while (!_shuttingDown.load()) {
-            {
-                stdx::unique_lock<stdx::mutex> lock(_mutex);
-                MONGO_IDLE_THREAD_BLOCK;
-                _condvar.wait_for(lock,
-                                  stdx::chrono::seconds(static_cast<std::int64_t>(
-                                      wiredTigerGlobalOptions.checkpointDelaySecs)));
-            }
+            _waitForNextCheckpoint();
 
             const Timestamp stableTimestamp = _wiredTigerKVEngine->getStableTimestamp();
             const Timestamp initialDataTimestamp = _wiredTigerKVEngine->getInitialDataTimestamp();
@@ -323,7 +319,7 @@ public:
                 if (initialDataTimestamp.asULL() <= 1) {
                     UniqueWiredTigerSession session = _sessionCache->getSession();
                     WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=false"));
+                    _checkpoint(s, "use_timestamp=false");
                 } else if (stableTimestamp < initialDataTimestamp) {
                     LOG_FOR_RECOVERY(2)
                         << "Stable timestamp is behind the initial data timestamp, skipping "
@@ -339,7 +335,7 @@ public:
 
                     UniqueWiredTigerSession session = _sessionCache->getSession();
                     WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=true"));
+                    _checkpoint(s, "use_timestamp=true");
 
                     // Now that the checkpoint is durable, publish the oplog needed to recover
                     // from it.
@@ -354,10 +350,25 @@ public:
             } catch (const AssertionException& exc) {
                 invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
             }
+
+            // Let eviction relax again until the next checkpoint approaches.
+            _setEvictionDirtyTarget(kDefaultEvictionDirtyTarget);
         }
         LOG(1) << "stopping " << name() << " thread";
     }
 
+    void appendStats(BSONObjBuilder* builder) const {
+        const long long startedAt = _checkpointStartedAtMillis.load();
+        builder->append("checkpoints completed", _checkpointsCompleted.load());
+        builder->append("in progress", startedAt != 0);
+        builder->append("current checkpoint running millis",
+                        startedAt != 0 ? static_cast<long long>(curTimeMillis64()) - startedAt : 0);
+        builder->append("last checkpoint millis", _lastCheckpointMillis.load());
+        builder->append("max checkpoint millis", _maxCheckpointMillis.load());
+        builder->append("total checkpoint millis", _totalCheckpointMillis.load());
+        builder->append("eviction dirty target", _evictionDirtyTarget.load());
+    }
+
     /**
      * Returns true if we have already triggered taking the first checkpoint.
      */
@@ -413,6 +424,80 @@ public:
     }
 
 private:
+    // WiredTiger's default 'eviction_dirty_target', as a percentage of the cache.
+    static constexpr int kDefaultEvictionDirtyTarget = 5;
+
+    /**
+     * Sleeps until the next checkpoint is due, or until woken early.
+     *
+     * With 'wiredTigerCheckpointPacingDirtyTarget' set, also lowers WiredTiger's eviction dirty
+     * target in steps from its default to that value as the checkpoint approaches. Eviction then
+     * writes out dirty pages throughout the interval, rather than leaving all of them for the
+     * checkpoint to write at once while it holds up application writes.
+     */
+    void _waitForNextCheckpoint() {
+        const auto interval = Seconds(static_cast<std::int64_t>(
+            wiredTigerGlobalOptions.checkpointDelaySecs));
+        const Date_t deadline = Date_t::now() + interval;
+
+        while (true) {
+            const int pacedTarget = gWiredTigerCheckpointPacingDirtyTarget.load();
+            const Date_t now = Date_t::now();
+            if (pacedTarget > 0 && interval > Seconds(1)) {
+                const double elapsed = durationCount<Milliseconds>(interval - (deadline - now)) /
+                    static_cast<double>(durationCount<Milliseconds>(interval));
+                const int target = kDefaultEvictionDirtyTarget -
+                    static_cast<int>((kDefaultEvictionDirtyTarget - pacedTarget) *
+                                     std::min(std::max(elapsed, 0.0), 1.0));
+                _setEvictionDirtyTarget(target);
+            }
+
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            if (pacedTarget <= 0 || deadline - now <= Seconds(1)) {
+                _condvar.wait_for(lock, (deadline - now).toSystemDuration());
+                return;
+            }
+            // A notification means a checkpoint was requested early.
+            if (_condvar.wait_for(lock, Seconds(1).toSystemDuration()) ==
+                stdx::cv_status::no_timeout) {
+                return;
+            }
+        }
+    }
+
+    void _setEvictionDirtyTarget(int target) {
+        if (_evictionDirtyTarget.load() == target) {
+            return;
+        }
+        const std::string config = str::stream() << "eviction_dirty_target=" << target;
+        int ret = _wiredTigerKVEngine->reconfigure(config.c_str());
+        if (ret != 0) {
+            warning() << "Failed to set " << config << ": " << wtRCToStatus(ret);
+            return;
+        }
+        _evictionDirtyTarget.store(target);
+    }
+
+    /**
+     * Takes a checkpoint and records how long it took.
+     */
+    void _checkpoint(WT_SESSION* session, const char* config) {
+        const long long startedAt = curTimeMillis64();
+        _checkpointStartedAtMillis.store(startedAt);
+        ON_BLOCK_EXIT([&] { _checkpointStartedAtMillis.store(0); });
+
+        invariantWTOK(session->checkpoint(session, config));
+
+        const long long millis = curTimeMillis64() - startedAt;
+        _checkpointsCompleted.addAndFetch(1);
+        _lastCheckpointMillis.store(millis);
+        _totalCheckpointMillis.addAndFetch(millis);
+        if (millis > _maxCheckpointMillis.load()) {
+            _maxCheckpointMillis.store(millis);
+        }
+    }
+
     WiredTigerKVEngine* _wiredTigerKVEngine;
     WiredTigerSessionCache* _sessionCache;
 
@@ -427,6 +512,14 @@ private:
 
     stdx::mutex _oplogNeededForCrashRecoveryMutex;
     AtomicWord<std::uint64_t> _oplogNeededForCrashRecovery;
+
+    // Only written by the checkpoint thread; read by serverStatus.
+    AtomicWord<int> _evictionDirtyTarget{kDefaultEvictionDirtyTarget};
+    AtomicWord<long long> _checkpointStartedAtMillis{0};
+    AtomicWord<long long> _checkpointsCompleted{0};
+    AtomicWord<long long> _lastCheckpointMillis{0};
+    AtomicWord<long long> _maxCheckpointMillis{0};
+    AtomicWord<long long> _totalCheckpointMillis{0};
 };
 
 namespace {
@@ -434,6 +527,125 @@ TicketHolder openWriteTransaction(128);
 TicketHolder openReadTransaction(128);
 }  // namespace
 
+/**
+ * Sizes the read and write ticket pools from the throughput and latency observed on each of them,
+ * see TicketLimitController. Replaces static values of wiredTigerConcurrentReadTransactions and
+ * wiredTigerConcurrentWriteTransactions while running.
+ */
+class WiredTigerKVEngine::WiredTigerConcurrencyAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerConcurrencyAdjuster(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+
+    virtual string name() const {
+        return "WTConcurrencyAdjuster";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOG(1) << "starting " << name() << " thread";
+
+        Pool pools[] = {Pool(&openReadTransaction), Pool(&openWriteTransaction)};
+        int samples = 0;
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, kSampleInterval.toSystemDuration());
+            }
+
+            for (auto& pool : pools) {
+                pool.ticketsInUse += pool.holder->used();
+            }
+            if (++samples < kSamplesPerAdjustment) {
+                continue;
+            }
+
+            const bool cacheUnderPressure = _isCacheUnderPressure();
+            const int minTickets = gWiredTigerAdaptiveConcurrencyMinTickets.load();
+            const int maxTickets =
+                std::max(minTickets, gWiredTigerAdaptiveConcurrencyMaxTickets.load());
+            const double intervalSecs =
+                durationCount<Milliseconds>(kSampleInterval) * samples / 1000.0;
+            for (auto& pool : pools) {
+                const long long released = pool.holder->numReleased();
+
+                TicketLimitController::Sample sample;
+                sample.throughput = (released - pool.lastReleased) / intervalSecs;
+                sample.ticketsInUse = static_cast<double>(pool.ticketsInUse) / samples;
+                sample.queued = pool.holder->queued();
+                sample.cacheUnderPressure = cacheUnderPressure;
+
+                const int limit = pool.controller.update(sample, minTickets, maxTickets);
+                if (limit != pool.holder->outof()) {
+                    LOG(2) << "Resizing WiredTiger tickets from " << pool.holder->outof() << " to "
+                           << limit;
+                    pool.holder->resize(limit).ignore();
+                }
+
+                pool.lastReleased = released;
+                pool.ticketsInUse = 0;
+            }
+            samples = 0;
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    static constexpr Milliseconds kSampleInterval{100};
+    static constexpr int kSamplesPerAdjustment = 10;
+
+    struct Pool {
+        explicit Pool(TicketHolder* holder)
+            : holder(holder), controller(holder->outof()), lastReleased(holder->numReleased()) {}
+
+        TicketHolder* holder;
+        TicketLimitController controller;
+        long long lastReleased;
+
+        // Sum of the tickets in use over the samples taken since the last adjustment.
+        long long ticketsInUse = 0;
+    };
+
+    /**
+     * Returns whether the cache is close to full or holds more dirty data than eviction keeps up
+     * with, in which case more concurrency only makes application threads evict.
+     */
+    bool _isCacheUnderPressure() {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        auto stat = [&](int key) {
+            return WiredTigerUtil::getStatisticsValueAs<int64_t>(
+                session->getSession(), "statistics:", "", key);
+        };
+        auto max = stat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        auto inUse = stat(WT_STAT_CONN_CACHE_BYTES_INUSE);
+        auto dirty = stat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        if (!max.isOK() || !inUse.isOK() || !dirty.isOK() || max.getValue() <= 0) {
+            return false;
+        }
+        const double cacheSize = max.getValue();
+        return inUse.getValue() / cacheSize > 0.95 || dirty.getValue() / cacheSize > 0.2;
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+    AtomicWord<bool> _shuttingDown{false};
+
+    stdx::mutex _mutex;  // protects _condvar
+    stdx::condition_variable _condvar;
+};
+
+constexpr Milliseconds WiredTigerKVEngine::WiredTigerConcurrencyAdjuster::kSampleInterval;
+constexpr int WiredTigerKVEngine::WiredTigerConcurrencyAdjuster::kSamplesPerAdjustment;
+
 OpenWriteTransactionParam::OpenWriteTransactionParam(StringData name, ServerParameterType spt)
     : ServerParameter(name, spt), _data(&openWriteTransaction) {}
 
@@ -482,6 +694,8 @@ stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](String
     fassertFailed(40358);
 };
 
+stdx::function<bool(StringData)> requestCappedTrimCallback = [](StringData) { return false; };
+
 StatusWith<std::vector<std::string>> getDataFilesFromBackupCursor(WT_CURSOR* cursor,
                                                                   std::string dbPath,
                                                                   const char* statusPrefix) {
@@ -634,6 +848,14 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = stdx::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    if (gWiredTigerAdaptiveConcurrency && !_readOnly) {
+        _concurrencyAdjuster =
+            stdx::make_unique<WiredTigerConcurrencyAdjuster>(_sessionCache.get());
+        _concurrencyAdjuster->go();
+    }
+
+    _readAhead = stdx::make_unique<WiredTigerReadAhead>(_sessionCache.get());
+
     if (_durable && !_ephemeral) {
         _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
         _journalFlusher->go();
@@ -675,6 +897,12 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
     _sessionCache.reset(NULL);
 }
 
+void WiredTigerKVEngine::appendCheckpointStats(BSONObjBuilder* builder) const {
+    if (_checkpointThread) {
+        _checkpointThread->appendStats(builder);
+    }
+}
+
 void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
@@ -682,6 +910,11 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        bbb.append("queued", openWriteTransaction.queued());
+        {
+            BSONObjBuilder queueTime(bbb.subobjStart("queueTimeMillis"));
+            openWriteTransaction.appendQueueTimeHistogram(&queueTime);
+        }
         bbb.done();
     }
     {
@@ -689,6 +922,11 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        bbb.append("queued", openReadTransaction.queued());
+        {
+            BSONObjBuilder queueTime(bbb.subobjStart("queueTimeMillis"));
+            openReadTransaction.appendQueueTimeHistogram(&queueTime);
+        }
         bbb.done();
     }
     bb.done();
@@ -765,6 +1003,16 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_readAhead) {
+        log() << "Shutting down read-ahead threads";
+        _readAhead->shutdown();
+        log() << "Finished shutting down read-ahead threads";
+    }
+    if (_concurrencyAdjuster) {
+        log() << "Shutting down concurrency adjuster thread";
+        _concurrencyAdjuster->shutdown();
+        log() << "Finished shutting down concurrency adjuster thread";
+    }
     if (_sessionSweeper) {
         log() << "Shutting down session sweeper thread";
         _sessionSweeper->shutdown();
@@ -1168,6 +1416,8 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.cappedCallback = nullptr;
     params.sizeStorer = _sizeStorer.get();
     params.isReadOnly = _readOnly;
+    params.cachePriority =
+        WiredTigerUtil::getCachePriority(options.storageEngine.getObjectField(_canonicalName));
 
     params.cappedMaxSize = -1;
     if (options.capped) {
@@ -1218,6 +1468,14 @@ Status WiredTigerKVEngine::createGroupedSortedDataInterface(OperationContext* op
                 dps::extractElementAtPath(storageEngineOptions, _canonicalName + ".configString")
                     .valuestrsafe();
         }
+
+        // Indexes of a collection in the "high" cache priority class share its priority, unless
+        // the index specification names a priority of its own.
+        const auto collPriority = WiredTigerUtil::getCachePriority(
+            collOptions.storageEngine.getObjectField(_canonicalName));
+        if (collPriority == WiredTigerUtil::CachePriority::kHigh) {
+            collIndexOptions += "," + WiredTigerUtil::cachePriorityConfig(collPriority);
+        }
     }
 
     StatusWith<std::string> result = WiredTigerIndex::generateCreateString(
@@ -1335,24 +1593,26 @@ Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, StringData ident)
     return Status::OK();
 }
 
-std::list<WiredTigerCachedCursor> WiredTigerKVEngine::filterCursorsWithQueuedDrops(
-    std::list<WiredTigerCachedCursor>* cache) {
-    std::list<WiredTigerCachedCursor> toDrop;
+WiredTigerSession::CursorCache WiredTigerKVEngine::filterCursorsWithQueuedDrops(
+    WiredTigerSession::CursorCache* cache) {
+    WiredTigerSession::CursorCache toDrop;
 
     stdx::lock_guard<stdx::mutex> lk(_identToDropMutex);
     if (_identToDrop.empty())
         return toDrop;
 
-    for (auto i = cache->begin(); i != cache->end();) {
+    // Compact the cursors which are kept towards the front of the cache, preserving their order.
+    auto kept = cache->begin();
+    for (auto i = cache->begin(); i != cache->end(); ++i) {
         if (!i->_cursor ||
             std::find(_identToDrop.begin(), _identToDrop.end(), std::string(i->_cursor->uri)) ==
                 _identToDrop.end()) {
-            ++i;
+            *kept++ = *i;
             continue;
         }
         toDrop.push_back(*i);
-        i = cache->erase(i);
     }
+    cache->erase(kept, cache->end());
 
     return toDrop;
 }
@@ -1522,6 +1782,14 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
     return initRsOplogBackgroundThreadCallback(ns);
 }
 
+void WiredTigerKVEngine::setRequestCappedTrimCallback(stdx::function<bool(StringData)> cb) {
+    requestCappedTrimCallback = std::move(cb);
+}
+
+bool WiredTigerKVEngine::requestCappedTrim(StringData ns) {
+    return requestCappedTrimCallback(ns);
+}
+
 namespace {
 
 MONGO_FAIL_POINT_DEFINE(WTPreserveSnapshotHistoryIndefinitely);
@@ -50,6 +50,7 @@ namespace mongo {
 
 class ClockSource;
 class JournalListener;
+class WiredTigerReadAhead;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
@@ -255,8 +256,8 @@ public:
         return _conn;
     }
     void dropSomeQueuedIdents();
-    std::list<WiredTigerCachedCursor> filterCursorsWithQueuedDrops(
-        std::list<WiredTigerCachedCursor>* cache);
+    WiredTigerSession::CursorCache filterCursorsWithQueuedDrops(
+        WiredTigerSession::CursorCache* cache);
     bool haveDropsQueued() const;
 
     void syncSizeInfo(bool sync) const;
@@ -289,6 +290,10 @@ public:
         return _oplogManager.get();
     }
 
+    WiredTigerReadAhead* getReadAhead() const {
+        return _readAhead.get();
+    }
+
     /**
      * Sets the implementation for `initRsOplogBackgroundThread` (allowing tests to skip the
      * background job, for example). Intended to be called from a MONGO_INITIALIZER and therefore in
@@ -304,8 +309,25 @@ public:
      */
     static bool initRsOplogBackgroundThread(StringData ns);
 
+    /**
+     * Sets the implementation for `requestCappedTrim`. Intended to be called from a
+     * MONGO_INITIALIZER and therefore in a single threaded context.
+     */
+    static void setRequestCappedTrimCallback(stdx::function<bool(StringData)> cb);
+
+    /**
+     * Asks a background job to remove excess documents from the capped collection 'ns'.
+     * Returns false if there is no such job, in which case the caller has to remove them itself.
+     */
+    static bool requestCappedTrim(StringData ns);
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends the checkpoint thread's progress and timing, if the thread is running.
+     */
+    void appendCheckpointStats(BSONObjBuilder* builder) const;
+
     Timestamp getStableTimestamp() const override;
     Timestamp getOldestTimestamp() const override;
     Timestamp getCheckpointTimestamp() const override;
@@ -352,6 +374,7 @@ public:
 
 private:
     class WiredTigerSessionSweeper;
+    class WiredTigerConcurrencyAdjuster;
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
 
@@ -437,8 +460,10 @@ private:
     const bool _keepDataHistory = true;
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
+    std::unique_ptr<WiredTigerConcurrencyAdjuster> _concurrencyAdjuster;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerReadAhead> _readAhead;  // Depends on _sessionCache
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -33,13 +33,16 @@
 
 #include <cstring>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/db/wait_event.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -119,12 +122,32 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
     // Close transaction before we wait.
     opCtx->recoveryUnit()->abandonSnapshot();
 
+    // The oplog read timestamp is published atomically, so a write which a journal flush already
+    // made visible can be detected without taking the mutex.
+    const auto latestVisibleTimestamp = getOplogReadTimestamp();
+    if (latestVisibleTimestamp < currentLatestVisibleTimestamp ||
+        RecordId(latestVisibleTimestamp) >= waitingFor) {
+        _visibleWithoutWaiting.fetchAndAdd(1);
+        return;
+    }
+
+    WaitEventGuard waitEvent(opCtx, WaitEvent::kOplogVisibility);
+    const auto waitStartMicros = curTimeMicros64();
     stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
 
     // Prevent any scheduled journal flushes from being delayed and blocking this wait excessively.
     _opsWaitingForVisibility++;
     invariant(_opsWaitingForVisibility > 0);
-    auto exitGuard = makeGuard([&] { _opsWaitingForVisibility--; });
+    auto exitGuard = makeGuard([&] {
+        _opsWaitingForVisibility--;
+        _waitLatency.record(curTimeMicros64() - waitStartMicros);
+    });
+
+    // If the journal thread is delaying a flush, wake it so that it notices this waiter right
+    // away instead of on its next poll.
+    if (_opsWaitingForJournal) {
+        _opsWaitingForJournalCV.notify_one();
+    }
 
     opCtx->waitForConditionOrInterrupt(_opsBecameVisibleCV, lk, [&] {
         auto newLatestVisibleTimestamp = getOplogReadTimestamp();
@@ -150,6 +173,7 @@ void WiredTigerOplogManager::triggerJournalFlush() {
     stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
     if (!_opsWaitingForJournal) {
         _opsWaitingForJournal = true;
+        _journalFlushRequestedAtMicros = curTimeMicros64();
         _opsWaitingForJournalCV.notify_one();
     }
 }
@@ -208,6 +232,8 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         }
         invariant(_opsWaitingForJournal);
         _opsWaitingForJournal = false;
+        // Every write which requests a flush from now on belongs to the next batch.
+        const auto batchRequestedAtMicros = _journalFlushRequestedAtMicros;
         lk.unlock();
 
         const uint64_t newTimestamp = fetchAllCommittedValue(sessionCache->conn());
@@ -227,11 +253,17 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         lk.lock();
         // Publish the new timestamp value.  Avoid going backward.
         auto oldTimestamp = getOplogReadTimestamp();
-        if (newTimestamp > oldTimestamp) {
+        const bool published = newTimestamp > oldTimestamp;
+        if (published) {
             _setOplogReadTimestamp(lk, newTimestamp);
         }
         lk.unlock();
 
+        if (published) {
+            _opsBecameVisibleCV.notify_all();
+            _publishLatency.record(curTimeMicros64() - batchRequestedAtMicros);
+        }
+
         // Wake up any await_data cursors and tell them more data might be visible now.
         oplogRecordStore->notifyCappedWaitersIfNeeded();
     }
@@ -242,16 +274,57 @@ std::uint64_t WiredTigerOplogManager::getOplogReadTimestamp() const {
 }
 
 void WiredTigerOplogManager::setOplogReadTimestamp(Timestamp ts) {
-    stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
-    _setOplogReadTimestamp(lk, ts.asULL());
+    {
+        stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+        _setOplogReadTimestamp(lk, ts.asULL());
+    }
+    _opsBecameVisibleCV.notify_all();
 }
 
 void WiredTigerOplogManager::_setOplogReadTimestamp(WithLock, uint64_t newTimestamp) {
+    // The store happens under the mutex so that a waiter cannot miss it between checking the
+    // timestamp and blocking on '_opsBecameVisibleCV'.
     _oplogReadTimestamp.store(newTimestamp);
-    _opsBecameVisibleCV.notify_all();
     LOG(2) << "Setting new oplogReadTimestamp: " << Timestamp(newTimestamp);
 }
 
+void WiredTigerOplogManager::appendVisibilityStats(BSONObjBuilder* builder) const {
+    builder->append("visible without waiting", _visibleWithoutWaiting.load());
+    _waitLatency.append("wait for visibility", builder);
+    _publishLatency.append("journal flush requested to visible", builder);
+}
+
+void WiredTigerOplogManager::LatencyHistogram::record(uint64_t micros) {
+    const uint64_t latency = micros;
+    int bucket = 0;
+    while (micros > 0 && bucket < kNumBuckets - 1) {
+        micros >>= 1;
+        ++bucket;
+    }
+    _buckets[bucket].fetchAndAdd(1);
+    _count.fetchAndAdd(1);
+    _totalMicros.fetchAndAdd(static_cast<long long>(latency));
+}
+
+void WiredTigerOplogManager::LatencyHistogram::append(StringData name,
+                                                      BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart(name));
+    BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+    for (int i = 0; i < kNumBuckets; i++) {
+        const auto count = _buckets[i].load();
+        if (count == 0)
+            continue;
+        BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+        entryBuilder.append("micros", i == 0 ? 0LL : 1LL << (i - 1));
+        entryBuilder.append("count", count);
+        entryBuilder.doneFast();
+    }
+    arrayBuilder.doneFast();
+    histogramBuilder.append("latency", _totalMicros.load());
+    histogramBuilder.append("ops", _count.load());
+    histogramBuilder.doneFast();
+}
+
 uint64_t WiredTigerOplogManager::fetchAllCommittedValue(WT_CONNECTION* conn) {
     // Fetch the latest all_committed value from the storage engine.  This value will be a
     // timestamp that has no holes (uncommitted transactions with lower timestamps) behind it.
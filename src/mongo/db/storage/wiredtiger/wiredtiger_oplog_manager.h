@@ -29,8 +29,12 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
@@ -38,6 +42,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 
@@ -74,18 +79,41 @@ public:
     void triggerJournalFlush();
 
     // Waits until all committed writes at this point to become visible (that is, no holes exist in
-    // the oplog.)
+    // the oplog.) Returns without taking any lock if they already are.
     void waitForAllEarlierOplogWritesToBeVisible(const WiredTigerRecordStore* oplogRecordStore,
                                                  OperationContext* opCtx);
 
+    // Appends counters and latency histograms describing how long writes take to become visible
+    // in the oplog, for serverStatus.
+    void appendVisibilityStats(BSONObjBuilder* builder) const;
+
     // Returns the all committed timestamp. All transactions with timestamps earlier than the
     // all committed timestamp are committed.
     uint64_t fetchAllCommittedValue(WT_CONNECTION* conn);
 
 private:
+    // A histogram of latencies in microseconds, with power-of-two bucket boundaries. Safe to update
+    // and read concurrently.
+    class LatencyHistogram {
+    public:
+        void record(uint64_t micros);
+        void append(StringData name, BSONObjBuilder* builder) const;
+
+    private:
+        // Bucket 0 counts latencies of 0, and bucket i > 0 counts latencies in [2^(i-1), 2^i). The
+        // last bucket also counts everything longer, from about 16 seconds.
+        static constexpr int kNumBuckets = 26;
+
+        std::array<AtomicWord<long long>, kNumBuckets> _buckets;
+        AtomicWord<long long> _count;
+        AtomicWord<long long> _totalMicros;
+    };
+
     void _oplogJournalThreadLoop(WiredTigerSessionCache* sessionCache,
                                  WiredTigerRecordStore* oplogRecordStore);
 
+    // Stores a new oplog read timestamp. Callers must notify '_opsBecameVisibleCV' once they have
+    // released the mutex, so that woken waiters do not immediately block on it.
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
     stdx::thread _oplogJournalThread;
@@ -103,6 +131,20 @@ private:
     // journal flushing should not be delayed.
     std::int64_t _opsWaitingForVisibility = 0;  // Guarded by oplogVisibilityStateMutex.
 
+    // When the first write of the batch which the next journal flush will make visible asked for
+    // that flush, in microseconds.
+    unsigned long long _journalFlushRequestedAtMicros = 0;  // Guarded by oplogVisibilityStateMutex.
+
     AtomicWord<unsigned long long> _oplogReadTimestamp;
+
+    // Number of waitForAllEarlierOplogWritesToBeVisible() calls which found the writes visible
+    // without waiting.
+    AtomicWord<long long> _visibleWithoutWaiting;
+
+    // Time spent by waitForAllEarlierOplogWritesToBeVisible() calls which had to wait.
+    LatencyHistogram _waitLatency;
+
+    // Time from a batch of oplog writes requesting a journal flush until they became visible.
+    LatencyHistogram _publishLatency;
 };
 }  // namespace mongo
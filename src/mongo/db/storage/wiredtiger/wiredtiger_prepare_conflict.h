@@ -33,7 +33,10 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/wait_event.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -66,6 +69,11 @@ int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
     CurOp::get(opCtx)->debug().additiveMetrics.incrementPrepareReadConflicts(1);
     wiredTigerPrepareConflictLog(attempts);
 
+    // Only prepared units of work at or before the read timestamp can conflict with this read, so
+    // only their ends need to wake it.
+    const Timestamp readTimestamp =
+        recoveryUnit->getPointInTimeReadTimestamp().value_or(Timestamp());
+
     while (true) {
         attempts++;
         auto lastCount = recoveryUnit->getSessionCache()->getPrepareCommitOrAbortCount();
@@ -79,8 +87,14 @@ int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
         CurOp::get(opCtx)->debug().additiveMetrics.incrementPrepareReadConflicts(1);
         wiredTigerPrepareConflictLog(attempts);
         // Wait on the session cache to signal that a unit of work has been committed or aborted.
-        recoveryUnit->getSessionCache()->waitUntilPreparedUnitOfWorkCommitsOrAborts(opCtx,
-                                                                                    lastCount);
+        WaitEventGuard waitEvent(opCtx, WaitEvent::kPrepareConflict);
+        Timer waitTimer;
+        ON_BLOCK_EXIT([&] {
+            CurOp::get(opCtx)->debug().additiveMetrics.incrementPrepareReadConflictWaitMicros(
+                waitTimer.micros());
+        });
+        recoveryUnit->getSessionCache()->waitUntilPreparedUnitOfWorkCommitsOrAborts(
+            opCtx, lastCount, readTimestamp);
     }
 }
 }  // namespace mongo
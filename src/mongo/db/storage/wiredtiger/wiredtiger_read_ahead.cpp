@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// Read-ahead is I/O bound, so a few threads are enough to keep the disk busy for many scans.
+const size_t kReadAheadThreads = 4;
+
+// Past this many outstanding requests the pool cannot keep up, and the scans are better served
+// by reading for themselves than by waiting behind a queue.
+const int kMaxQueuedReadAheads = 64;
+
+ThreadPool::Options makeReadAheadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "WiredTigerReadAhead";
+    options.threadNamePrefix = "WTReadAhead-";
+    options.minThreads = 0;
+    options.maxThreads = kReadAheadThreads;
+    return options;
+}
+
+}  // namespace
+
+bool WiredTigerReadAhead::Tracker::advanced() {
+    const int window = gWiredTigerReadAheadKeys.load();
+    if (window <= 0) {
+        return false;
+    }
+
+    // Schedule again once the scan is halfway through the previous window, so that the read-ahead
+    // stays in front of it.
+    if (++_sequentialKeys < std::max(1, window / 2)) {
+        return false;
+    }
+    _sequentialKeys = 0;
+    return !_inFlight || !_inFlight->load();
+}
+
+WiredTigerReadAhead::WiredTigerReadAhead(WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache), _pool(makeReadAheadPoolOptions()) {
+    _pool.startup();
+}
+
+WiredTigerReadAhead::~WiredTigerReadAhead() {
+    shutdown();
+}
+
+void WiredTigerReadAhead::schedule(Tracker* tracker,
+                                   const std::string& uri,
+                                   bool forward,
+                                   Positioner positioner) {
+    if (!tracker->_inFlight) {
+        tracker->_inFlight = std::make_shared<AtomicWord<bool>>(false);
+    }
+    if (tracker->_inFlight->load()) {
+        return;
+    }
+
+    if (_shuttingDown.load()) {
+        return;
+    }
+    if (_queued.addAndFetch(1) > kMaxQueuedReadAheads) {
+        _queued.subtractAndFetch(1);
+        _dropped.addAndFetch(1);
+        return;
+    }
+
+    auto inFlight = tracker->_inFlight;
+    inFlight->store(true);
+    const int keys = gWiredTigerReadAheadKeys.load();
+    Status status = _pool.schedule([this, uri, forward, positioner, keys, inFlight] {
+        ON_BLOCK_EXIT([&] {
+            _queued.subtractAndFetch(1);
+            inFlight->store(false);
+        });
+        if (!_shuttingDown.load()) {
+            _readAhead(uri, forward, positioner, keys);
+        }
+    });
+
+    if (!status.isOK()) {
+        _queued.subtractAndFetch(1);
+        inFlight->store(false);
+        _dropped.addAndFetch(1);
+        return;
+    }
+    _scheduled.addAndFetch(1);
+}
+
+void WiredTigerReadAhead::shutdown() {
+    if (_shuttingDown.swap(true)) {
+        return;
+    }
+    _pool.shutdown();
+    _pool.join();
+}
+
+void WiredTigerReadAhead::appendStats(BSONObjBuilder* builder) const {
+    builder->append("scheduled", _scheduled.load());
+    builder->append("dropped", _dropped.load());
+    builder->append("keys read", _keysRead.load());
+}
+
+void WiredTigerReadAhead::_readAhead(const std::string& uri,
+                                     bool forward,
+                                     const Positioner& positioner,
+                                     int keys) {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    WT_SESSION* wtSession = session->getSession();
+
+    // The table may have been dropped since the request was made; there is nothing to read then.
+    WT_CURSOR* cursor;
+    int ret = wtSession->open_cursor(wtSession, uri.c_str(), nullptr, nullptr, &cursor);
+    if (ret != 0) {
+        LOG(2) << "Skipping read-ahead on " << uri << ": " << wtRCToStatus(ret);
+        return;
+    }
+    ON_BLOCK_EXIT([&] { invariantWTOK(cursor->close(cursor)); });
+
+    // Each operation below runs in its own implicit transaction. Any error, including a prepare
+    // conflict, just ends the read-ahead early: the scan will read the rest itself.
+    positioner(cursor);
+    int cmp;
+    ret = cursor->search_near(cursor, &cmp);
+
+    int keysRead = 0;
+    while (ret == 0 && keysRead < keys && !_shuttingDown.load()) {
+        ret = forward ? cursor->next(cursor) : cursor->prev(cursor);
+        if (ret == 0) {
+            ++keysRead;
+        }
+    }
+    _keysRead.addAndFetch(keysRead);
+}
+
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <wiredtiger.h>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class WiredTigerSessionCache;
+
+/**
+ * Warms the WiredTiger cache ahead of sequential scans. Once a cursor has been advancing in the
+ * same direction for a while, it asks this class to walk a separate cursor over the next
+ * 'wiredTigerReadAheadKeys' keys from its current position on a small pool of background threads.
+ * The pages of those keys are then already in cache, or on their way in, when the scan reaches
+ * them, instead of every leaf page costing the scan a synchronous read.
+ *
+ * The read-ahead cursors read outside of any transaction and never block the scan they serve:
+ * requests are dropped rather than queued once the pool falls behind.
+ */
+class WiredTigerReadAhead {
+    MONGO_DISALLOW_COPYING(WiredTigerReadAhead);
+
+public:
+    /**
+     * Sets the key of a freshly opened cursor to the position a read-ahead should start from.
+     * Must not refer to the scanning cursor or its table objects, which may be gone by the time a
+     * request runs.
+     */
+    using Positioner = stdx::function<void(WT_CURSOR*)>;
+
+    /**
+     * Kept by each scanning cursor to decide when a read-ahead is due.
+     */
+    class Tracker {
+    public:
+        /**
+         * Records that the cursor returned the next key of its scan. Returns true if the cursor
+         * should schedule a read-ahead from its current position.
+         */
+        bool advanced();
+
+        /**
+         * Records that the cursor was repositioned, which ends the current sequential run.
+         */
+        void reset() {
+            _sequentialKeys = 0;
+        }
+
+    private:
+        friend class WiredTigerReadAhead;
+
+        int _sequentialKeys = 0;
+
+        // Set while a read-ahead scheduled by this cursor is queued or running, so a cursor never
+        // has more than one outstanding. Shared with the request, which may outlive the cursor.
+        std::shared_ptr<AtomicWord<bool>> _inFlight;
+    };
+
+    explicit WiredTigerReadAhead(WiredTigerSessionCache* sessionCache);
+
+    ~WiredTigerReadAhead();
+
+    /**
+     * Schedules a walk over the keys following (or, if not 'forward', preceding) the position set
+     * by 'positioner' in the table 'uri'. Does nothing if 'tracker' already has a read-ahead
+     * outstanding or if the pool is saturated.
+     */
+    void schedule(Tracker* tracker, const std::string& uri, bool forward, Positioner positioner);
+
+    /**
+     * Waits for running read-aheads to finish and drops queued ones. Must be called before the
+     * session cache shuts down.
+     */
+    void shutdown();
+
+    /**
+     * Waits until no read-ahead is queued or running. For testing.
+     */
+    void waitForIdle() {
+        _pool.waitForIdle();
+    }
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    void _readAhead(const std::string& uri, bool forward, const Positioner& positioner, int keys);
+
+    WiredTigerSessionCache* const _sessionCache;  // not owned
+    ThreadPool _pool;
+
+    AtomicWord<bool> _shuttingDown{false};
+    AtomicWord<int> _queued{0};
+
+    AtomicWord<long long> _scheduled{0};
+    AtomicWord<long long> _dropped{0};
+    AtomicWord<long long> _keysRead{0};
+};
+
+}  // namespace mongo
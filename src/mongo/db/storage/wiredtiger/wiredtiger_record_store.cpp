@@ -51,6 +51,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -79,12 +80,29 @@ static const int kMaximumRecordStoreVersion = 1;
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion >= kMinimumRecordStoreVersion);
 MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion);
 
+// How long inserts wait on a background trim they asked for before asking again, in case the job
+// could not act on the request, e.g. because the collection was renamed in the meantime.
+const Milliseconds kCappedTrimRequestTimeout = Seconds(10);
+
 void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
     StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
     fassert(39999, appMetadata);
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// Table settings for "archive" collections: append-only history that is rarely read, and then
+// usually scanned in full. Larger leaf pages compress better, zstd trades CPU for a better ratio
+// than the default snappy, and pages are filled completely since updates are not expected.
+constexpr auto kArchiveTableConfig = "block_compressor=zstd,leaf_page_max=128KB,split_pct=100,"_sd;
+
+struct CachePriorityStats {
+    AtomicWord<long long> collections;
+    AtomicWord<long long> readOnceCursors;
+};
+
+// Indexed by WiredTigerUtil::CachePriority.
+CachePriorityStats cachePriorityStats[WiredTigerUtil::kNumCachePriorities];
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
@@ -104,6 +122,10 @@ const std::string kWiredTigerEngineName = "wiredTiger";
 // cursors will be available in the needed session caches.
 static int kCappedDocumentRemoveLimit = 3;
 
+// The most oplog stones removed by a single truncate. Bounds the size of the truncating
+// transaction when the oplog is far over its maximum size.
+const size_t kMaxStonesPerTruncate = 10;
+
 class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
 public:
     InsertChange(OplogStones* oplogStones,
@@ -145,6 +167,7 @@ public:
 
         stdx::lock_guard<stdx::mutex> lk(_oplogStones->_mutex);
         _oplogStones->_stones.clear();
+        _oplogStones->_persistStones_inlock();
     }
 
     void rollback() final {}
@@ -169,7 +192,10 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
 
-    _calculateStones(opCtx, numStonesToKeep);
+    if (!_loadStones(opCtx)) {
+        _calculateStones(opCtx, numStonesToKeep);
+        _persistStones_inlock();
+    }
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
@@ -224,9 +250,37 @@ WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
     return _stones.front();
 }
 
+std::vector<WiredTigerRecordStore::OplogStones::Stone>
+WiredTigerRecordStore::OplogStones::peekOldestStonesIfNeeded(Timestamp mayTruncateUpTo,
+                                                             size_t maxStones) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    int64_t totalBytes = 0;
+    for (auto&& stone : _stones) {
+        totalBytes += stone.bytes;
+    }
+
+    std::vector<Stone> stones;
+    for (auto&& stone : _stones) {
+        if (stones.size() >= maxStones || totalBytes <= _rs->cappedMaxSize() ||
+            static_cast<std::uint64_t>(stone.lastRecord.repr()) >= mayTruncateUpTo.asULL()) {
+            break;
+        }
+        stones.push_back(stone);
+        totalBytes -= stone.bytes;
+    }
+    return stones;
+}
+
 void WiredTigerRecordStore::OplogStones::popOldestStone() {
+    popOldestStones(1);
+}
+
+void WiredTigerRecordStore::OplogStones::popOldestStones(size_t numStones) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    _stones.pop_front();
+    invariant(numStones <= _stones.size());
+    _stones.erase(_stones.begin(), _stones.begin() + numStones);
+    _persistStones_inlock();
 }
 
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
@@ -252,6 +306,7 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRec
     LOG(2) << "create new oplogStone, current stones:" << _stones.size();
     OplogStones::Stone stone = {_currentRecords.swap(0), _currentBytes.swap(0), lastRecord};
     _stones.push_back(stone);
+    _persistStones_inlock();
 
     _pokeReclaimThreadIfNeeded();
 }
@@ -291,6 +346,7 @@ void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
     // Remove the stones corresponding to the records that were deleted.
     int64_t offset = _stones.size() - numStonesToRemove;
     _stones.erase(_stones.begin() + offset, _stones.end());
+    _persistStones_inlock();
 
     // Account for any remaining records from a partially truncated stone in the stone currently
     // being filled.
@@ -306,6 +362,101 @@ void WiredTigerRecordStore::OplogStones::setMinBytesPerStone(int64_t size) {
     // Only allow changing the minimum bytes per stone if no data has been inserted.
     invariant(_stones.size() == 0 && _currentRecords.load() == 0);
     _minBytesPerStone = size;
+    _persistStones_inlock();
+}
+
+bool WiredTigerRecordStore::OplogStones::_loadStones(OperationContext* opCtx) {
+    if (!_rs->_sizeStorer) {
+        return false;
+    }
+
+    BSONObj persisted = _rs->_sizeStorer->loadOplogStones(_rs->getURI());
+    if (persisted.isEmpty() || persisted["stones"].type() != Array) {
+        return false;
+    }
+
+    // Stones placed for a different oplog size would make truncation too coarse or too fine.
+    if (persisted["minBytesPerStone"].safeNumberLong() != _minBytesPerStone) {
+        log() << "Ignoring the persisted oplog markers, which were placed for a different oplog "
+                 "size";
+        return false;
+    }
+
+    RecordId earliest;
+    RecordId latest;
+    {
+        auto cursor = _rs->getCursor(opCtx, /*forward=*/true);
+        auto record = cursor->next();
+        if (!record) {
+            return false;
+        }
+        earliest = record->id;
+    }
+    {
+        auto cursor = _rs->getCursor(opCtx, /*forward=*/false);
+        auto record = cursor->next();
+        if (!record) {
+            return false;
+        }
+        latest = record->id;
+    }
+
+    // The persisted stones may be out of date after an unclean shutdown or a rollback. Skip the
+    // stones that were truncated away but not yet popped when they were persisted, and drop those
+    // that end past the newest record, leaving their records to the stone being filled.
+    long long recordsInStones = 0;
+    long long bytesInStones = 0;
+    for (auto&& elem : persisted["stones"].Obj()) {
+        if (elem.type() != Object) {
+            _stones.clear();
+            return false;
+        }
+        BSONObj stoneObj = elem.Obj();
+        OplogStones::Stone stone = {stoneObj["records"].safeNumberLong(),
+                                    stoneObj["bytes"].safeNumberLong(),
+                                    RecordId(stoneObj["lastRecord"].safeNumberLong())};
+        if (!stone.lastRecord.isValid() ||
+            (!_stones.empty() && stone.lastRecord <= _stones.back().lastRecord)) {
+            _stones.clear();
+            return false;
+        }
+        if (stone.lastRecord < earliest) {
+            continue;
+        }
+        if (stone.lastRecord > latest) {
+            break;
+        }
+        _stones.push_back(stone);
+        recordsInStones += stone.records;
+        bytesInStones += stone.bytes;
+    }
+
+    _currentRecords.store(std::max(_rs->numRecords(opCtx) - recordsInStones, 0LL));
+    _currentBytes.store(std::max(_rs->dataSize(opCtx) - bytesInStones, 0LL));
+
+    log() << "Loaded " << _stones.size() << " persisted markers for truncating the oplog between "
+          << Timestamp(earliest.repr()).toStringPretty() << " and "
+          << Timestamp(latest.repr()).toStringPretty();
+    return true;
+}
+
+void WiredTigerRecordStore::OplogStones::_persistStones_inlock() {
+    if (!_rs->_sizeStorer) {
+        return;
+    }
+
+    BSONObjBuilder builder;
+    builder.append("minBytesPerStone", static_cast<long long>(_minBytesPerStone));
+    {
+        BSONArrayBuilder stonesBuilder(builder.subarrayStart("stones"));
+        for (auto&& stone : _stones) {
+            BSONObjBuilder stoneBuilder(stonesBuilder.subobjStart());
+            stoneBuilder.append("records", static_cast<long long>(stone.records));
+            stoneBuilder.append("bytes", static_cast<long long>(stone.bytes));
+            stoneBuilder.append("lastRecord", static_cast<long long>(stone.lastRecord.repr()));
+        }
+    }
+    _rs->_sizeStorer->storeOplogStones(_rs->getURI(), builder.obj());
 }
 
 void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCtx,
@@ -461,11 +612,14 @@ void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
+    _persistStones_inlock();
     _pokeReclaimThreadIfNeeded();
 }
 
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
     StringBuilder ss;
+    // The archive settings are placed first so that anything in 'configString' overrides them.
+    StringData archiveConfig;
     BSONForEach(elem, options) {
         if (elem.fieldNameStringData() == "configString") {
             Status status = WiredTigerUtil::checkTableCreationOptions(elem);
@@ -473,6 +627,17 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == "cachePriority") {
+            auto priority = WiredTigerUtil::parseCachePriority(elem);
+            if (!priority.isOK()) {
+                return priority.getStatus();
+            }
+            ss << WiredTigerUtil::cachePriorityConfig(priority.getValue());
+        } else if (elem.fieldNameStringData() == "archive") {
+            if (!elem.isBoolean()) {
+                return {ErrorCodes::TypeMismatch, "'archive' must be a boolean."};
+            }
+            archiveConfig = elem.boolean() ? kArchiveTableConfig : ""_sd;
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -481,7 +646,37 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
                                                          << " is not a supported option.");
         }
     }
-    return StatusWith<std::string>(ss.str());
+    return StatusWith<std::string>(archiveConfig + ss.str());
+}
+
+// static
+void WiredTigerRecordStore::appendCachePriorityStats(BSONObjBuilder* builder) {
+    for (int i = 0; i < WiredTigerUtil::kNumCachePriorities; ++i) {
+        const auto priority = static_cast<WiredTigerUtil::CachePriority>(i);
+        BSONObjBuilder classBuilder(
+            builder->subobjStart(WiredTigerUtil::cachePriorityName(priority)));
+        classBuilder.append("collections", cachePriorityStats[i].collections.load());
+        classBuilder.append("read-once cursors opened",
+                            cachePriorityStats[i].readOnceCursors.load());
+    }
+}
+
+bool WiredTigerRecordStore::_useReadOnceCursor(OperationContext* opCtx, bool forward) const {
+    // Tailing readers expect the newest oplog pages to stay in cache.
+    if (_isOplog) {
+        return false;
+    }
+
+    bool readOnce = _cachePriority == WiredTigerUtil::CachePriority::kLow;
+    if (!readOnce && forward) {
+        const long long threshold = gWiredTigerReadOnceScanThresholdBytes.load();
+        readOnce = threshold > 0 && dataSize(opCtx) >= threshold;
+    }
+
+    if (readOnce) {
+        cachePriorityStats[static_cast<int>(_cachePriority)].readOnceCursors.addAndFetch(1);
+    }
+    return readOnce;
 }
 
 class WiredTigerRecordStore::RandomCursor final : public RecordCursor {
@@ -642,6 +837,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _isCapped(params.isCapped),
       _isEphemeral(params.isEphemeral),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _cachePriority(params.cachePriority),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -689,6 +885,8 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
         sizeRecoveryState(getGlobalServiceContext())
             .markCollectionAsAlwaysNeedsSizeAdjustment(_ident);
     }
+
+    cachePriorityStats[static_cast<int>(_cachePriority)].collections.addAndFetch(1);
 }
 
 WiredTigerRecordStore::~WiredTigerRecordStore() {
@@ -711,6 +909,8 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
         // Delete oplog visibility manager on KV engine.
         _kvEngine->haltOplogManager();
     }
+
+    cachePriorityStats[static_cast<int>(_cachePriority)].collections.subtractAndFetch(1);
 }
 
 void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
@@ -782,11 +982,11 @@ bool WiredTigerRecordStore::inShutdown() const {
 }
 
 long long WiredTigerRecordStore::dataSize(OperationContext* opCtx) const {
-    return _sizeInfo->dataSize.load();
+    return std::max(_sizeInfo->dataSize.load(), 0LL);
 }
 
 long long WiredTigerRecordStore::numRecords(OperationContext* opCtx) const {
-    return _sizeInfo->numRecords.load();
+    return std::max(_sizeInfo->numRecords.load(), 0LL);
 }
 
 bool WiredTigerRecordStore::isCapped() const {
@@ -881,6 +1081,77 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
     _increaseDataSize(opCtx, -old_length);
 }
 
+StatusWith<int64_t> WiredTigerRecordStore::deleteRange(OperationContext* opCtx,
+                                                       const RecordId& first,
+                                                       const RecordId& last) {
+    dassert(opCtx->lockState()->isWriteLocked());
+
+    if (isCapped()) {
+        return {ErrorCodes::IllegalOperation,
+                "Cannot delete a range of records from a capped collection"};
+    }
+    if (first > last) {
+        return 0;
+    }
+
+    // The records in the range are still scanned to keep the record count and data size accurate,
+    // but are removed with a single WT_SESSION::truncate() instead of one remove each.
+    WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
+    startWrap.assertInActiveTxn();
+    WT_CURSOR* start = startWrap.get();
+    setKey(start, first);
+    int cmp;
+    int ret =
+        wiredTigerPrepareConflictRetry(opCtx, [&] { return start->search_near(start, &cmp); });
+    if (ret == 0 && cmp < 0) {
+        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+    }
+    if (ret == WT_NOTFOUND) {
+        return 0;
+    }
+    invariantWTOK(ret);
+
+    const RecordId firstRemovedId = getKey(start);
+    if (firstRemovedId > last) {
+        return 0;
+    }
+
+    WiredTigerCursor stopWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* stop = stopWrap.get();
+    setKey(stop, firstRemovedId);
+    invariantWTOK(wiredTigerPrepareConflictRetry(opCtx, [&] { return stop->search(stop); }));
+
+    int64_t recordsRemoved = 0;
+    int64_t bytesRemoved = 0;
+    RecordId lastRemovedId;
+    do {
+        const RecordId id = getKey(stop);
+        if (id > last) {
+            break;
+        }
+
+        WT_ITEM value;
+        invariantWTOK(stop->get_value(stop, &value));
+        recordsRemoved++;
+        bytesRemoved += value.size;
+        lastRemovedId = id;
+
+        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return stop->next(stop); });
+    } while (ret == 0);
+    if (ret != WT_NOTFOUND) {
+        invariantWTOK(ret);
+    }
+
+    setKey(start, firstRemovedId);
+    setKey(stop, lastRemovedId);
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    invariantWTOK(WT_OP_CHECK(session->truncate(session, nullptr, start, stop, nullptr)));
+
+    _changeNumRecords(opCtx, -recordsRemoved);
+    _increaseDataSize(opCtx, -bytesRemoved);
+    return recordsRemoved;
+}
+
 bool WiredTigerRecordStore::cappedAndNeedDelete() const {
     if (!_isCapped)
         return false;
@@ -925,6 +1196,24 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
     if (!cappedAndNeedDelete())
         return 0;
 
+    // Leave the deletes to a background job, unless it has fallen far behind, so that inserts do
+    // not contend on the deleter mutex. Max docs has to be exact, so those are always done here.
+    if (_cappedMaxDocs == -1 && gWiredTigerCappedBackgroundTrim.load() &&
+        (_sizeInfo->dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack)) {
+        const long long now = Date_t::now().toMillisSinceEpoch();
+        const long long requestedAt = _cappedTrimRequestedAt.load();
+        if (requestedAt != 0 && now - requestedAt < kCappedTrimRequestTimeout.count()) {
+            return 0;
+        }
+        if (_cappedTrimRequestedAt.compareAndSwap(requestedAt, now) != requestedAt) {
+            return 0;
+        }
+        if (WiredTigerKVEngine::requestCappedTrim(ns())) {
+            return 0;
+        }
+        _cappedTrimRequestedAt.store(0);
+    }
+
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
     stdx::unique_lock<stdx::timed_mutex> lock(_cappedDeleterMutex, stdx::defer_lock);
 
@@ -957,6 +1246,31 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
     return _cappedDeleteAsNeeded_inlock(opCtx, justInserted);
 }
 
+int64_t WiredTigerRecordStore::trimCappedAsNeeded(OperationContext* opCtx) {
+    // Inserts from now on ask again if the collection is still over its cap after this pass.
+    _cappedTrimRequestedAt.store(0);
+
+    if (!sizeRecoveryState(getGlobalServiceContext()).collectionNeedsSizeAdjustment(_ident) ||
+        !cappedAndNeedDelete()) {
+        return 0;
+    }
+
+    // Stop short of the newest document, as an insert that removes documents itself would.
+    RecordId newest;
+    {
+        auto cursor = getCursor(opCtx, false);
+        auto record = cursor->next();
+        if (!record) {
+            return 0;
+        }
+        newest = record->id;
+    }
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    stdx::lock_guard<stdx::timed_mutex> lock(_cappedDeleterMutex);
+    return _cappedDeleteAsNeeded_inlock(opCtx, newest);
+}
+
 Timestamp WiredTigerRecordStore::getPinnedOplog() const {
     return _kvEngine->getPinnedOplog();
 }
@@ -1175,17 +1489,30 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
 
 void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayTruncateUpTo) {
     Timer timer;
-    while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
+    while (true) {
+        // When the oplog is far over its maximum size, remove several stones with a single
+        // truncate rather than one truncate per stone. Stones needed for replication recovery
+        // are never returned.
+        auto stones =
+            _oplogStones->peekOldestStonesIfNeeded(mayTruncateUpTo, kMaxStonesPerTruncate);
+        if (stones.empty()) {
+            break;
+        }
+
+        auto stone = &stones.back();
         invariant(stone->lastRecord.isValid());
 
-        if (static_cast<std::uint64_t>(stone->lastRecord.repr()) >= mayTruncateUpTo.asULL()) {
-            // Do not truncate oplogs needed for replication recovery.
-            return;
+        int64_t records = 0;
+        int64_t bytes = 0;
+        for (auto&& truncated : stones) {
+            records += truncated.records;
+            bytes += truncated.bytes;
         }
 
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
-               << stone->lastRecord << " to remove approximately " << stone->records
-               << " records totaling to " << stone->bytes << " bytes";
+               << stone->lastRecord << " to remove " << stones.size()
+               << " stones of approximately " << records << " records totaling to " << bytes
+               << " bytes";
 
         WiredTigerRecoveryUnit* ru = WiredTigerRecoveryUnit::get(opCtx);
         WT_SESSION* session = ru->getSession()->getSession();
@@ -1207,13 +1534,13 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
 
             setKey(cursor, stone->lastRecord);
             invariantWTOK(session->truncate(session, nullptr, nullptr, cursor, nullptr));
-            _changeNumRecords(opCtx, -stone->records);
-            _increaseDataSize(opCtx, -stone->bytes);
+            _changeNumRecords(opCtx, -records);
+            _increaseDataSize(opCtx, -bytes);
 
             wuow.commit();
 
-            // Remove the stone after a successful truncation.
-            _oplogStones->popOldestStone();
+            // Remove the stones after a successful truncation.
+            _oplogStones->popOldestStones(stones.size());
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
@@ -1257,6 +1584,10 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
 
     RecordId highestId = RecordId();
     dassert(nRecords != 0);
+
+    // Outside of the oplog, the whole batch takes a block of consecutive RecordIds reserved at
+    // once, so that its records are appended to the table in key order.
+    const RecordId firstId = _isOplog ? RecordId() : _reserveIds(nRecords);
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         if (_isOplog) {
@@ -1265,15 +1596,14 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
-        } else if (_isCapped) {
-            record.id = _nextId();
         } else {
-            record.id = _nextId();
+            record.id = RecordId(firstId.repr() + static_cast<int64_t>(i));
         }
         dassert(record.id > highestId);
         highestId = record.id;
     }
 
+    Timestamp lastTimestampSet;
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         Timestamp ts;
@@ -1289,9 +1619,11 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         } else {
             ts = timestamps[i];
         }
-        if (!ts.isNull()) {
+        // Records of a batch which share a timestamp only need it set once.
+        if (!ts.isNull() && ts != lastTimestampSet) {
             LOG(4) << "inserting record with timestamp " << ts;
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
+            lastTimestampSet = ts;
         }
         setKey(c, record.id);
         WiredTigerItem value(record.data.data(), record.data.size());
@@ -1401,9 +1733,34 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     }
 
     WiredTigerItem value(data, len);
-    c->set_value(c, value.Get());
-    ret = WT_OP_CHECK(c->insert(c));
-    invariantWTOK(ret);
+
+    // For large records, only write the bytes that changed, so that updating a small part of the
+    // record does not make WiredTiger rewrite and cache the whole record again. Give up when more
+    // than a tenth of the record changed, as it is then cheaper to write the whole record than to
+    // have later reads reconstruct it from the modifications.
+    bool modified = false;
+    const int modifyThreshold = gWiredTigerModifyUpdateThresholdBytes.load();
+    if (modifyThreshold > 0 && len >= modifyThreshold && old_length >= modifyThreshold) {
+        const int kMaxModifyEntries = 16;
+        WT_MODIFY entries[kMaxModifyEntries];
+        int nentries = kMaxModifyEntries;
+        const size_t maxDiff = std::max<int64_t>(len, old_length) / 10;
+        ret = wiredtiger_calc_modify(
+            c->session, &old_value, value.Get(), maxDiff, entries, &nentries);
+        if (ret == 0) {
+            invariantWTOK(WT_OP_CHECK(c->modify(c, entries, nentries)));
+            modified = true;
+        } else {
+            // No small enough set of modifications was found.
+            invariant(ret == WT_NOTFOUND, str::stream() << "wiredtiger_calc_modify: " << ret);
+        }
+    }
+
+    if (!modified) {
+        c->set_value(c, value.Get());
+        ret = WT_OP_CHECK(c->insert(c));
+        invariantWTOK(ret);
+    }
 
     _increaseDataSize(opCtx, len - old_length);
     if (!_oplogStones) {
@@ -1649,6 +2006,15 @@ RecordId WiredTigerRecordStore::_nextId() {
     return out;
 }
 
+RecordId WiredTigerRecordStore::_reserveIds(size_t count) {
+    invariant(!_isOplog);
+    invariant(count > 0);
+    RecordId first = RecordId(_nextIdNum.fetchAndAdd(static_cast<long long>(count)));
+    invariant(first.isNormal());
+    invariant(RecordId(first.repr() + static_cast<int64_t>(count) - 1).isNormal());
+    return first;
+}
+
 WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext* opCtx) {
     return checked_cast<WiredTigerRecoveryUnit*>(opCtx->recoveryUnit());
 }
@@ -1659,7 +2025,7 @@ public:
     virtual void commit(boost::optional<Timestamp>) {}
     virtual void rollback() {
         LOG(3) << "WiredTigerRecordStore: rolling back NumRecordsChange" << -_diff;
-        _rs->_sizeInfo->numRecords.fetchAndAdd(-_diff);
+        _rs->_sizeInfo->numRecords.add(-_diff);
     }
 
 private:
@@ -1673,8 +2039,7 @@ void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t d
     }
 
     opCtx->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
-    if (_sizeInfo->numRecords.fetchAndAdd(diff) < 0)
-        _sizeInfo->numRecords.store(std::max(diff, int64_t(0)));
+    _sizeInfo->numRecords.add(diff);
 }
 
 class WiredTigerRecordStore::DataSizeChange : public RecoveryUnit::Change {
@@ -1698,8 +2063,7 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t a
     if (opCtx)
         opCtx->recoveryUnit()->registerChange(new DataSizeChange(this, amount));
 
-    if (_sizeInfo->dataSize.fetchAndAdd(amount) < 0)
-        _sizeInfo->dataSize.store(std::max(amount, int64_t(0)));
+    _sizeInfo->dataSize.add(amount);
 
     if (_sizeStorer)
         _sizeStorer->store(_uri, _sizeInfo);
@@ -1827,11 +2191,14 @@ Status WiredTigerRecordStore::oplogDiskLocRegister(OperationContext* opCtx,
 WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContext* opCtx,
                                                                  const WiredTigerRecordStore& rs,
                                                                  bool forward)
-    : _rs(rs), _opCtx(opCtx), _forward(forward) {
+    : _rs(rs),
+      _opCtx(opCtx),
+      _forward(forward),
+      _readOnce(rs._useReadOnceCursor(opCtx, forward)) {
     if (_rs._isOplog) {
         _oplogVisibleTs = WiredTigerRecoveryUnit::get(opCtx)->getOplogVisibilityTs();
     }
-    _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx);
+    _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx, _readOnce);
 }
 
 boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
@@ -1880,10 +2247,34 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
 
+    // Tailing oplog readers stay at the end of the oplog, where there is nothing to read ahead.
+    if (!_rs._isOplog && _readAheadTracker.advanced()) {
+        scheduleReadAhead(id);
+    }
+
     _lastReturnedId = id;
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::scheduleReadAhead(const RecordId& id) {
+    auto engine = WiredTigerRecoveryUnit::get(_opCtx)->getSessionCache()->getKVEngine();
+    if (!engine) {
+        // Some unit tests run without a storage engine.
+        return;
+    }
+
+    // The request may run after this cursor and its record store are gone, so it gets copies.
+    const KVPrefix prefix = _rs.getPrefix();
+    engine->getReadAhead()->schedule(
+        &_readAheadTracker, _rs.getURI(), _forward, [id, prefix](WT_CURSOR* cursor) {
+            if (prefix == KVPrefix::kNotPrefixed) {
+                cursor->set_key(cursor, id.repr());
+            } else {
+                cursor->set_key(cursor, prefix.repr(), id.repr());
+            }
+        });
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     if (_oplogVisibleTs && id.repr() > *_oplogVisibleTs) {
         _eof = true;
@@ -1891,6 +2282,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     }
 
     _skipNextAdvance = false;
+    _readAheadTracker.reset();
     WT_CURSOR* c = _cursor->get();
     setKey(c, id);
     // Nothing after the next line can throw WCEs.
@@ -1935,7 +2327,7 @@ bool WiredTigerRecordStoreCursorBase::restore() {
     }
 
     if (!_cursor)
-        _cursor.emplace(_rs.getURI(), _rs.tableId(), true, _opCtx);
+        _cursor.emplace(_rs.getURI(), _rs.tableId(), true, _opCtx, _readOnce);
 
     // This will ensure an active session exists, so any restored cursors will bind to it
     invariant(WiredTigerRecoveryUnit::get(_opCtx)->getSession() == _cursor->getSession());
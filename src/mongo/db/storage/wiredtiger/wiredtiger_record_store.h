@@ -40,8 +40,10 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -80,9 +82,18 @@ public:
      * Parses collections options for wired tiger configuration string for table creation.
      * The document 'options' is typically obtained from the 'wiredTiger' field of
      * CollectionOptions::storageEngine.
+     *
+     * Besides 'configString' and 'cachePriority', the options may set 'archive: true' to lay the
+     * collection out for rarely read, append-only data: heavier compression and larger pages.
      */
     static StatusWith<std::string> parseOptionsField(const BSONObj options);
 
+    /**
+     * Appends, for each cache priority class, the number of open collections in the class and the
+     * number of read-once cursors opened over them.
+     */
+    static void appendCachePriorityStats(BSONObjBuilder* builder);
+
     /**
      * Creates a configuration string suitable for 'config' parameter in WT_SESSION::create().
      * It is possible for 'ns' to be an empty string, in the case of internal-only temporary tables.
@@ -112,6 +123,7 @@ public:
         CappedCallback* cappedCallback;
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
+        WiredTigerUtil::CachePriority cachePriority = WiredTigerUtil::CachePriority::kNormal;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -139,6 +151,10 @@ public:
 
     virtual void deleteRecord(OperationContext* opCtx, const RecordId& id);
 
+    virtual StatusWith<int64_t> deleteRange(OperationContext* opCtx,
+                                            const RecordId& first,
+                                            const RecordId& last);
+
     virtual Status insertRecords(OperationContext* opCtx,
                                  std::vector<Record>* records,
                                  const std::vector<Timestamp>& timestamps);
@@ -181,6 +197,18 @@ public:
 
     virtual Timestamp getPinnedOplog() const final;
 
+    /**
+     * Removes excess documents from a capped collection that is over its maximum size or number
+     * of documents, on behalf of the inserts that left it to a background job. Never removes the
+     * newest document. Returns the number of documents removed.
+     */
+    int64_t trimCappedAsNeeded(OperationContext* opCtx);
+
+    /**
+     * Returns true if this is a capped collection over its maximum size or number of documents.
+     */
+    bool cappedAndNeedDelete() const;
+
     virtual Status compact(OperationContext* opCtx) final;
 
     virtual bool isInRecordIdOrder() const override {
@@ -236,6 +264,10 @@ public:
         return _tableId;
     }
 
+    virtual KVPrefix getPrefix() const {
+        return KVPrefix::kNotPrefixed;
+    }
+
     void setSizeStorer(WiredTigerSizeStorer* ss) {
         _sizeStorer = ss;
     }
@@ -280,14 +312,27 @@ private:
 
     static WiredTigerRecoveryUnit* _getRecoveryUnit(OperationContext* opCtx);
 
+    /**
+     * Returns true if a cursor in the given direction should bypass the cursor cache and avoid
+     * keeping the pages it reads in the WiredTiger cache. This is the case when the collection is
+     * in the "low" cache priority class, or when the cursor is a forward scan over a collection
+     * larger than 'wiredTigerReadOnceScanThresholdBytes'. Counts the cursor if so.
+     */
+    bool _useReadOnceCursor(OperationContext* opCtx, bool forward) const;
+
     Status _insertRecords(OperationContext* opCtx,
                           Record* records,
                           const Timestamp* timestamps,
                           size_t nRecords);
 
     RecordId _nextId();
+
+    /**
+     * Reserves 'count' consecutive RecordIds and returns the first of them.
+     */
+    RecordId _reserveIds(size_t count);
+
     void _setId(RecordId id);
-    bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
 
     /**
@@ -341,6 +386,7 @@ private:
     const bool _isEphemeral;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    const WiredTigerUtil::CachePriority _cachePriority;
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
@@ -354,6 +400,9 @@ private:
     // See comment in ::cappedDeleteAsNeeded
     int _cappedDeleteCheckCount;
     mutable stdx::timed_mutex _cappedDeleterMutex;
+    // When a background job was asked to remove excess documents, in milliseconds since the epoch,
+    // so that each insert does not ask again. Zero once the job has started its pass.
+    AtomicWord<long long> _cappedTrimRequestedAt{0};
 
     AtomicWord<long long> _nextIdNum;
 
@@ -397,7 +446,7 @@ public:
     virtual std::unique_ptr<RecordCursor> getRandomCursorWithOptions(
         OperationContext* opCtx, StringData extraConfig) const override;
 
-    virtual KVPrefix getPrefix() const {
+    KVPrefix getPrefix() const override {
         return _prefix;
     }
 
@@ -452,6 +501,7 @@ protected:
     const WiredTigerRecordStore& _rs;
     OperationContext* _opCtx;
     const bool _forward;
+    const bool _readOnce;
     bool _skipNextAdvance = false;
     boost::optional<WiredTigerCursor> _cursor;
     bool _eof = false;
@@ -460,6 +510,13 @@ protected:
 private:
     bool isVisible(const RecordId& id);
 
+    /**
+     * Asks the engine's read-ahead threads to walk the records past 'id'.
+     */
+    void scheduleReadAhead(const RecordId& id);
+
+    WiredTigerReadAhead::Tracker _readAheadTracker;
+
     /**
      * This value is used for visibility calculations on what oplog entries can be returned to a
      * client. This value *must* be initialized/updated *before* a WiredTiger snapshot is
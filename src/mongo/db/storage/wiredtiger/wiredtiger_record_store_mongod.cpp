@@ -46,6 +46,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -171,5 +172,103 @@ MONGO_INITIALIZER(SetInitRsOplogBackgroundThreadCallback)(InitializerContext* co
     return Status::OK();
 }
 
+/**
+ * Removes excess documents from capped collections whose inserts asked for it, so that the inserts
+ * do not have to remove them one small range at a time while holding the capped deleter mutex.
+ */
+class CappedTrimmerThread : public BackgroundJob {
+public:
+    CappedTrimmerThread() : BackgroundJob(false /* deleteSelf */) {}
+
+    virtual std::string name() const {
+        return "WT-CappedTrimmerThread";
+    }
+
+    void requestTrim(const NamespaceString& nss) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _pending.insert(nss);
+        _condvar.notify_one();
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+
+        while (!globalInShutdownDeprecated()) {
+            NamespaceString nss;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                if (_pending.empty()) {
+                    _condvar.wait_for(lk, stdx::chrono::seconds(1));
+                    continue;
+                }
+                nss = *_pending.begin();
+                _pending.erase(_pending.begin());
+            }
+
+            if (_trim(nss)) {
+                // Come back to the collection once the others that asked in the meantime are done.
+                requestTrim(nss);
+            }
+        }
+    }
+
+private:
+    /**
+     * Returns true if the collection may still be over its cap.
+     */
+    bool _trim(const NamespaceString& nss) {
+        const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+
+        try {
+            ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
+                opCtx.get()->lockState());
+            AutoGetCollection autoColl(opCtx.get(), nss, MODE_IX);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                // The inserts that asked, if the collection was renamed, ask again once their
+                // request times out.
+                LOG(2) << "no collection " << nss;
+                return false;
+            }
+
+            // Clears the request first thing, so that the inserts ask again if this pass fails.
+            auto rs = checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+            return rs->trimCappedAsNeeded(opCtx.get()) > 0 && rs->cappedAndNeedDelete();
+        } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+            return false;
+        } catch (const DBException& ex) {
+            // The inserts into the collection ask again once their request is cleared or times
+            // out, and remove the documents themselves once the collection is too far over its
+            // cap.
+            warning() << "error trimming capped collection " << nss << ": " << redact(ex);
+            return false;
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    std::set<NamespaceString> _pending;
+};
+
+bool requestCappedTrim(StringData ns) {
+    if (storageGlobalParams.repair || storageGlobalParams.readOnly) {
+        return false;
+    }
+
+    static CappedTrimmerThread* trimmer = [] {
+        log() << "Starting WT-CappedTrimmerThread";
+        auto thread = new CappedTrimmerThread();
+        thread->go();
+        return thread;
+    }();
+    trimmer->requestTrim(NamespaceString(ns));
+    return true;
+}
+
+MONGO_INITIALIZER(SetRequestCappedTrimCallback)(InitializerContext* context) {
+    WiredTigerKVEngine::setRequestCappedTrimCallback(requestCappedTrim);
+    return Status::OK();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/platform/atomic_word.h"
@@ -71,8 +72,16 @@ public:
 
     boost::optional<OplogStones::Stone> peekOldestStoneIfNeeded() const;
 
+    // Returns the oldest stones that can be truncated together: each one is needed to bring the
+    // oplog back under its maximum size and ends before 'mayTruncateUpTo'. Returns at most
+    // 'maxStones' stones, and none if the oplog is not over its maximum size.
+    std::vector<OplogStones::Stone> peekOldestStonesIfNeeded(Timestamp mayTruncateUpTo,
+                                                             size_t maxStones) const;
+
     void popOldestStone();
 
+    void popOldestStones(size_t numStones);
+
     void createNewStoneIfNeeded(RecordId lastRecord);
 
     void updateCurrentStoneAfterInsertOnCommit(OperationContext* opCtx,
@@ -117,6 +126,14 @@ private:
     class InsertChange;
     class TruncateChange;
 
+    // Restores the stones persisted in the size storer, dropping any that no longer match the
+    // bounds of the oplog. Returns false if there are no usable persisted stones.
+    bool _loadStones(OperationContext* opCtx);
+
+    // Hands the current stones to the size storer, so that the next startup does not need to
+    // scan or sample the oplog to place them.
+    void _persistStones_inlock();
+
     void _calculateStones(OperationContext* opCtx, size_t size);
     void _calculateStonesByScanning(OperationContext* opCtx);
     void _calculateStonesBySampling(OperationContext* opCtx,
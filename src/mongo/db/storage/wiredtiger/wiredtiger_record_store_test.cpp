@@ -102,6 +102,35 @@ TEST(WiredTigerRecordStoreTest, GenerateCreateStringValidConfigStringOption) {
               std::string("prefix_compression=true,"));
 }
 
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringHighCachePriority) {
+    BSONObj spec = fromjson("{cachePriority: 'high'}");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(spec), std::string("cache_resident=true,"));
+}
+
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringLowCachePriority) {
+    BSONObj spec = fromjson("{cachePriority: 'low'}");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(spec),
+              std::string("cache_resident=false,"));
+}
+
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringInvalidCachePriority) {
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{cachePriority: 'urgent'}")),
+              ErrorCodes::BadValue);
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{cachePriority: 1}")),
+              ErrorCodes::TypeMismatch);
+}
+
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringArchive) {
+    BSONObj spec = fromjson("{configString: 'leaf_page_max=64KB', archive: true}");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(spec),
+              std::string("block_compressor=zstd,leaf_page_max=128KB,split_pct=100,"
+                          "leaf_page_max=64KB,"));
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{archive: false}")),
+              std::string(""));
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(fromjson("{archive: 1}")),
+              ErrorCodes::TypeMismatch);
+}
+
 TEST(WiredTigerRecordStoreTest, Isolation1) {
     const auto harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
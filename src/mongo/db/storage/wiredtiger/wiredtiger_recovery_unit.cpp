@@ -212,7 +212,7 @@ void WiredTigerRecoveryUnit::_commit() {
         }
 
         if (notifyDone) {
-            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted();
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted(_prepareTimestamp);
         }
 
         for (Changes::const_iterator it = _changes.begin(), end = _changes.end(); it != end; ++it) {
@@ -239,7 +239,7 @@ void WiredTigerRecoveryUnit::_abort() {
         }
 
         if (notifyDone) {
-            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted();
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted(_prepareTimestamp);
         }
 
         for (Changes::const_reverse_iterator it = _changes.rbegin(), end = _changes.rend();
@@ -798,6 +798,33 @@ std::shared_ptr<StorageStats> WiredTigerRecoveryUnit::getOperationStatistics() c
     return statsPtr;
 }
 
+RecoveryUnit::StorageCounters WiredTigerRecoveryUnit::getStorageCounters() const {
+    StorageCounters counters;
+    if (!_session)
+        return counters;
+
+    WT_SESSION* s = _session->getSession();
+    invariant(s);
+
+    WT_CURSOR* c = nullptr;
+    if (s->open_cursor(s, "statistics:session", nullptr, "statistics=(fast)", &c) != 0)
+        return counters;
+    ON_BLOCK_EXIT([&] { c->close(c); });
+
+    auto readStat = [&](int key) {
+        const char* desc;
+        uint64_t value;
+        c->set_key(c, key);
+        if (c->search(c) != 0 || c->get_value(c, &desc, nullptr, &value) != 0)
+            return 0LL;
+        return WiredTigerUtil::castStatisticsValue<long long>(value);
+    };
+    counters.bytesRead = readStat(WT_STAT_SESSION_BYTES_READ);
+    counters.readMicros = readStat(WT_STAT_SESSION_READ_TIME);
+    counters.cacheWaitMicros = readStat(WT_STAT_SESSION_CACHE_TIME);
+    return counters;
+}
+
 void WiredTigerRecoveryUnit::_setState(State newState) {
     _state = newState;
 }
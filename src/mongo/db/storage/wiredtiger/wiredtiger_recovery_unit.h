@@ -158,6 +158,8 @@ public:
 
     std::shared_ptr<StorageStats> getOperationStatistics() const override;
 
+    StorageCounters getStorageCounters() const override;
+
     // ---- WT STUFF
 
     WiredTigerSession* getSession();
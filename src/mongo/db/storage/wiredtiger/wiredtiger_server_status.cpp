@@ -35,6 +35,8 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -76,6 +78,26 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder visibilityBuilder(bob.subobjStart("oplog visibility"));
+        _engine->getOplogManager()->appendVisibilityStats(&visibilityBuilder);
+    }
+
+    {
+        BSONObjBuilder priorityBuilder(bob.subobjStart("cache priority"));
+        WiredTigerRecordStore::appendCachePriorityStats(&priorityBuilder);
+    }
+
+    {
+        BSONObjBuilder readAheadBuilder(bob.subobjStart("read ahead"));
+        _engine->getReadAhead()->appendStats(&readAheadBuilder);
+    }
+
+    {
+        BSONObjBuilder checkpointBuilder(bob.subobjStart("checkpoint thread"));
+        _engine->appendCheckpointStats(&checkpointBuilder);
+    }
+
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
     return bob.obj();
@@ -33,7 +33,9 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/base/error_codes.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -44,9 +46,31 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
+namespace {
+
+// Writers waiting for the journal to be flushed, and the flushes done for them. Their ratio is the
+// average number of writers that share a flush.
+Counter64 journalFlushWaits;
+Counter64 journalFlushes;
+Counter64 journalFlushWaitMicros;
+Counter64 journalFlushDelayMicros;
+
+ServerStatusMetricField<Counter64> displayJournalFlushWaits("storage.journal.flushWaits",
+                                                            &journalFlushWaits);
+ServerStatusMetricField<Counter64> displayJournalFlushes("storage.journal.flushes",
+                                                         &journalFlushes);
+ServerStatusMetricField<Counter64> displayJournalFlushWaitMicros("storage.journal.waitMicros",
+                                                                 &journalFlushWaitMicros);
+ServerStatusMetricField<Counter64> displayJournalFlushDelayMicros("storage.journal.delayMicros",
+                                                                  &journalFlushDelayMicros);
+
+}  // namespace
 
 const std::string kWTRepairMsg =
     "Please read the documentation for starting MongoDB with --repair here: "
@@ -106,10 +130,10 @@ void _openCursor(WT_SESSION* session,
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool allowOverwrite) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
+    for (auto i = _cursors.rbegin(); i != _cursors.rend(); ++i) {
         if (i->_id == id) {
             WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
+            _cursors.erase(std::next(i).base());
             _cursorsOut++;
             return c;
         }
@@ -137,17 +161,18 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     invariantWTOK(cursor->reset(cursor));
 
-    // Cursors are pushed to the front of the list and removed from the back
-    _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    // Cursors are appended to the back of the cache and removed from the front
+    _cursors.emplace_back(id, _cursorGen++, cursor);
 
     // A negative value for wiredTigercursorCacheSize means to use hybrid caching.
     std::uint32_t cacheSize = abs(gWiredTigerCursorCacheSize.load());
 
-    while (!_cursors.empty() && _cursorGen - _cursors.back()._gen > cacheSize) {
-        cursor = _cursors.back()._cursor;
-        _cursors.pop_back();
-        invariantWTOK(cursor->close(cursor));
+    auto firstKept = _cursors.begin();
+    while (firstKept != _cursors.end() && _cursorGen - firstKept->_gen > cacheSize) {
+        invariantWTOK(firstKept->_cursor->close(firstKept->_cursor));
+        ++firstKept;
     }
+    _cursors.erase(_cursors.begin(), firstKept);
 }
 
 void WiredTigerSession::closeCursor(WT_CURSOR* cursor) {
@@ -162,14 +187,15 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
     invariant(_session);
 
     bool all = (uri == "");
-    for (auto i = _cursors.begin(); i != _cursors.end();) {
+    auto kept = _cursors.begin();
+    for (auto i = _cursors.begin(); i != _cursors.end(); ++i) {
         WT_CURSOR* cursor = i->_cursor;
         if (cursor && (all || uri == cursor->uri)) {
             invariantWTOK(cursor->close(cursor));
-            i = _cursors.erase(i);
         } else
-            ++i;
+            *kept++ = *i;
     }
+    _cursors.erase(kept, _cursors.end());
 }
 
 void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
@@ -188,6 +214,21 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
 namespace {
 AtomicWord<unsigned long long> nextTableId(1);
+
+/**
+ * One shard of idle sessions per core, so that threads running on different cores rarely share a
+ * shard.
+ */
+size_t idleSessionShardCount() {
+    const size_t kMaxIdleSessionShards = 128;
+    return std::max<size_t>(
+        1, std::min<size_t>(ProcessInfo::getNumAvailableCores(), kMaxIdleSessionShards));
+}
+
+// Hands out a distinct slot to each thread which uses a session cache, which determines the idle
+// session shard the thread uses first.
+AtomicWord<unsigned long long> nextIdleSessionSlot(0);
+thread_local const unsigned long long threadIdleSessionSlot = nextIdleSessionSlot.fetchAndAdd(1);
 }
 // static
 uint64_t WiredTigerSession::genTableId() {
@@ -201,6 +242,7 @@ WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
+      _idleSessionShards(idleSessionShardCount()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
@@ -208,6 +250,7 @@ WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource*
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
+      _idleSessionShards(idleSessionShardCount()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
@@ -273,6 +316,11 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    Timer waitTimer;
+    journalFlushWaits.increment();
+    _durabilityWaits.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] { journalFlushWaitMicros.increment(waitTimer.micros()); });
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -282,8 +330,27 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         // Someone else synced already since we read lastSyncTime, so we're done!
         return;
     }
+
+    // When other writers shared the last flush, more are likely to arrive shortly. Writers that
+    // arrive while we wait read the same lastSyncTime as we did and queue on the mutex, so the
+    // flush below covers them as well. A lone writer never waits.
+    const long long maxDelayMicros = gWiredTigerJournalGroupCommitMaxDelayMicros.load();
+    if (maxDelayMicros > 0 && _lastFlushBatchSize > 1) {
+        const long long delayMicros = std::min(maxDelayMicros, _avgFlushMicros / 2);
+        if (delayMicros > 0) {
+            sleepmicros(delayMicros);
+            journalFlushDelayMicros.increment(delayMicros);
+        }
+    }
+
     _lastSyncTime.store(current + 1);
 
+    const long long waits = _durabilityWaits.load();
+    _lastFlushBatchSize = waits - _durabilityWaitsAtLastFlush;
+    _durabilityWaitsAtLastFlush = waits;
+    journalFlushes.increment();
+    Timer flushTimer;
+
     // Nobody has synched yet, so we have to sync ourselves.
 
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
@@ -306,30 +373,49 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         LOG(4) << "created checkpoint";
     }
     _journalListener->onDurable(token);
+
+    _avgFlushMicros = (_avgFlushMicros * 7 + flushTimer.micros()) / 8;
 }
 
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
-                                                                        std::uint64_t lastCount) {
+                                                                        std::uint64_t lastCount,
+                                                                        Timestamp readTimestamp) {
     invariant(opCtx);
     stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
-    if (lastCount == _prepareCommitOrAbortCounter.loadRelaxed()) {
-        opCtx->waitForConditionOrInterrupt(_prepareCommittedOrAbortedCond, lk, [&] {
-            return _prepareCommitOrAbortCounter.loadRelaxed() > lastCount;
-        });
+    if (lastCount != _prepareCommitOrAbortCounter.loadRelaxed()) {
+        // A prepared unit of work ended since the caller last retried.
+        return;
     }
+
+    PrepareConflictWaiter waiter(readTimestamp);
+    auto it = _prepareConflictWaiters.insert(_prepareConflictWaiters.end(), &waiter);
+    // Runs with the mutex held, including when the wait is interrupted.
+    ON_BLOCK_EXIT([&] { _prepareConflictWaiters.erase(it); });
+    opCtx->waitForConditionOrInterrupt(waiter.cond, lk, [&] { return waiter.woken; });
 }
 
-void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
-    stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
+void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted(
+    Timestamp prepareTimestamp) {
+    stdx::lock_guard<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
     _prepareCommitOrAbortCounter.fetchAndAdd(1);
-    _prepareCommittedOrAbortedCond.notify_all();
+    for (auto&& waiter : _prepareConflictWaiters) {
+        // A reader only conflicts with units of work prepared at or before its read timestamp.
+        // Readers without a read timestamp may conflict with any of them.
+        if (prepareTimestamp.isNull() || waiter->readTimestamp.isNull() ||
+            prepareTimestamp <= waiter->readTimestamp) {
+            waiter->woken = true;
+            waiter->cond.notify_one();
+        }
+    }
 }
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& shard : _idleSessionShards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        for (SessionCache::iterator i = shard.sessions.begin(); i != shard.sessions.end(); i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -337,15 +423,21 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& shard : _idleSessionShards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        for (SessionCache::iterator i = shard.sessions.begin(); i != shard.sessions.end(); i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto&& shard : _idleSessionShards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        count += shard.sessions.size();
+    }
+    return count;
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -355,30 +447,39 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    SessionCache expired;
+    for (auto&& shard : _idleSessionShards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
-                delete (session);
+                it = shard.sessions.erase(it);
+                expired.push_back(session);
             } else {
                 ++it;
             }
         }
     }
+
+    // Close the expired sessions outside of the shard locks.
+    for (auto session : expired) {
+        delete (session);
+    }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. This happens before
+    // any shard is emptied, so a session released into a shard after it has been emptied is
+    // recognized as stale and closed by releaseSession() instead.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    SessionCache swap;
+    for (auto&& shard : _idleSessionShards) {
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        swap.insert(swap.end(), shard.sessions.begin(), shard.sessions.end());
+        shard.sessions.clear();
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -395,13 +496,18 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    // Start with this thread's own shard, and only take a session from another shard if that one
+    // is empty. When every shard is empty this visits all of them, but then a new session has to
+    // be opened anyway, which costs far more.
+    const size_t home = getHomeIdleSessionShard();
+    for (size_t i = 0; i < _idleSessionShards.size(); ++i) {
+        auto& shard = _idleSessionShards[(home + i) % _idleSessionShards.size()];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
+        if (!shard.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = shard.sessions.back();
+            shard.sessions.pop_back();
             // Reset the idle time
             cachedSession->setIdleExpireTime(Date_t::min());
             return UniqueWiredTigerSession(cachedSession);
@@ -463,10 +569,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        auto& shard = _idleSessionShards[getHomeIdleSessionShard()];
+        stdx::lock_guard<stdx::mutex> lock(shard.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            shard.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -478,6 +585,9 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         _engine->dropSomeQueuedIdents();
 }
 
+size_t WiredTigerSessionCache::getHomeIdleSessionShard() const {
+    return threadIdleSessionSlot % _idleSessionShards.size();
+}
 
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
@@ -29,16 +29,21 @@
 
 #pragma once
 
+#include <boost/align/aligned_allocator.hpp>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
+#include "mongo/bson/timestamp.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -62,6 +67,11 @@ public:
  */
 class WiredTigerSession {
 public:
+    // The cursor cache is a flat array of cached cursors, ordered from the least to the most
+    // recently released. Its storage is reused once it has grown, so caching and reusing cursors
+    // does not allocate.
+    typedef std::vector<WiredTigerCachedCursor> CursorCache;
+
     /**
      * Creates a new WT session on the specified connection.
      *
@@ -164,9 +174,6 @@ public:
 private:
     friend class WiredTigerSessionCache;
 
-    // The cursor cache is a list of pairs that contain an ID and cursor
-    typedef std::list<WiredTigerCachedCursor> CursorCache;
-
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
@@ -268,17 +275,22 @@ public:
      * signaled that it has ended.
      * Accepts an OperationContext that will throw an AssertionException when interrupted.
      *
+     * The caller is only woken by prepared units of work it may have conflicted with: those
+     * prepared at or before 'readTimestamp'. A null 'readTimestamp' waits for any of them.
+     *
      * This method is provided in WiredTigerSessionCache and not RecoveryUnit because all recovery
      * units share the same session cache, and we want a recovery unit on one thread to signal all
      * recovery units waiting for prepare conflicts across all other threads.
      */
-    void waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx, uint64_t lastCount);
+    void waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
+                                                    uint64_t lastCount,
+                                                    Timestamp readTimestamp = Timestamp());
 
     /**
-     * Notifies waiters that the caller's perpared unit of work has ended (either committed or
-     * aborted).
+     * Notifies waiters that the caller's perpared unit of work, prepared at 'prepareTimestamp',
+     * has ended (either committed or aborted). A null 'prepareTimestamp' notifies all waiters.
      */
-    void notifyPreparedUnitOfWorkHasCommittedOrAborted();
+    void notifyPreparedUnitOfWorkHasCommittedOrAborted(Timestamp prepareTimestamp = Timestamp());
 
     WT_CONNECTION* conn() const {
         return _conn;
@@ -317,9 +329,20 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    // Idle sessions are spread over a number of shards, each with its own lock, and each thread
+    // releases sessions into and takes them from its own shard. Other shards are only visited when
+    // a thread's own shard is empty, so that checking out a session does not contend with other
+    // threads in the common case.
+    struct IdleSessionShard {
+        stdx::mutex lock;
+        SessionCache sessions;
+    };
+    using AlignedIdleSessionShard = CacheAligned<IdleSessionShard>;
+    std::vector<AlignedIdleSessionShard,
+                boost::alignment::aligned_allocator<AlignedIdleSessionShard>>
+        _idleSessionShards;
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -331,9 +354,30 @@ private:
     AtomicWord<unsigned> _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
-    // Mutex and cond var for waiting on prepare commit or abort.
+    // Number of calls to waitUntilDurable that need a journal flush, and the value it had when the
+    // last flush started. Their difference tells how many writers the next flush may cover.
+    AtomicWord<long long> _durabilityWaits{0};
+    long long _durabilityWaitsAtLastFlush = 0;  // Guarded by _lastSyncMutex.
+
+    // Moving average of the time a journal flush takes, in microseconds. Guarded by _lastSyncMutex.
+    long long _avgFlushMicros = 0;
+
+    // Number of writers that waited for the last journal flush. Guarded by _lastSyncMutex.
+    long long _lastFlushBatchSize = 0;
+
+    // A reader waiting on prepare commit or abort. Each waiter has its own cond var so that the
+    // end of a prepared unit of work only wakes the readers it may have conflicted with.
+    struct PrepareConflictWaiter {
+        explicit PrepareConflictWaiter(Timestamp ts) : readTimestamp(ts) {}
+
+        const Timestamp readTimestamp;  // Null if the reader has no read timestamp.
+        bool woken = false;
+        stdx::condition_variable cond;
+    };
+
+    // Mutex and waiters for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
-    stdx::condition_variable _prepareCommittedOrAbortedCond;
+    std::list<PrepareConflictWaiter*> _prepareConflictWaiters;
     AtomicWord<std::uint64_t> _prepareCommitOrAbortCounter{0};
 
     // Protects _journalListener.
@@ -349,6 +393,12 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the index of the shard in '_idleSessionShards' which the calling thread releases
+     * sessions into and takes them from first.
+     */
+    size_t getHomeIdleSessionShard() const;
 };
 
 /**
@@ -33,10 +33,15 @@
 #include <string>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/system_clock_source.h"
 
 namespace mongo {
@@ -113,4 +118,76 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, IdleSessionsReleasedByOtherThreadsAreReused) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Release a session from another thread, which places it in that thread's idle shard.
+    WiredTigerSession* releasedSession = nullptr;
+    stdx::thread([&] {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        releasedSession = session.get();
+    }).join();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // The idle session is taken from the other shard rather than a new one being opened.
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        ASSERT_EQUALS(session.get(), releasedSession);
+        ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // Closing all sessions empties every shard.
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+TEST(WiredTigerSessionCacheTest, ReadAheadWalksKeysPastScanPosition) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    const std::string uri = "table:readAhead";
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        WT_SESSION* wtSession = session->getSession();
+        ASSERT_OK(wtRCToStatus(
+            wtSession->create(wtSession, uri.c_str(), "key_format=q,value_format=u")));
+        WT_CURSOR* cursor;
+        ASSERT_OK(wtRCToStatus(
+            wtSession->open_cursor(wtSession, uri.c_str(), nullptr, nullptr, &cursor)));
+        for (int64_t i = 0; i < 100; ++i) {
+            const WiredTigerItem value("x", 1);
+            cursor->set_key(cursor, i);
+            cursor->set_value(cursor, value.Get());
+            ASSERT_OK(wtRCToStatus(cursor->insert(cursor)));
+        }
+        ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+    }
+
+    const int originalReadAheadKeys = gWiredTigerReadAheadKeys.load();
+    gWiredTigerReadAheadKeys.store(20);
+    ON_BLOCK_EXIT([&] { gWiredTigerReadAheadKeys.store(originalReadAheadKeys); });
+
+    WiredTigerReadAhead readAhead(sessionCache);
+    WiredTigerReadAhead::Tracker tracker;
+
+    // A read-ahead is only due once the scan has been sequential for half the window.
+    for (int i = 0; i < 9; ++i) {
+        ASSERT_FALSE(tracker.advanced());
+    }
+    ASSERT_TRUE(tracker.advanced());
+
+    readAhead.schedule(
+        &tracker, uri, true, [](WT_CURSOR* cursor) { cursor->set_key(cursor, int64_t(90)); });
+    readAhead.waitForIdle();
+
+    BSONObjBuilder builder;
+    readAhead.appendStats(&builder);
+    const BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["scheduled"].numberLong(), 1);
+    ASSERT_EQ(stats["dropped"].numberLong(), 0);
+    // The window is larger than what is left of the table past key 90.
+    ASSERT_EQ(stats["keys read"].numberLong(), 9);
+}
+
 }  // namespace mongo
@@ -47,6 +47,16 @@
 
 namespace mongo {
 
+namespace {
+// Oplog stones are kept in the same table as the sizes, under the oplog's URI with this suffix.
+// No collection URI contains it, so these keys never collide with size entries.
+const auto kOplogStonesKeySuffix = "#oplogStones"_sd;
+
+std::string oplogStonesKey(StringData uri) {
+    return uri.toString() + kOplogStonesKeySuffix;
+}
+}  // namespace
+
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn,
                                            const std::string& storageUri,
                                            bool readOnly)
@@ -68,7 +78,14 @@ WiredTigerSizeStorer::~WiredTigerSizeStorer() {
     _cursor->close(_cursor);
 }
 
-void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeInfo) {
+size_t WiredTigerSizeStorer::Counter::_slotForThisThread() {
+    // Threads are spread over the slots in the order they first update any size.
+    static AtomicWord<unsigned> nextSlot{0};
+    thread_local const size_t slot = nextSlot.fetchAndAdd(1) % kSlots;
+    return slot;
+}
+
+void WiredTigerSizeStorer::store(StringData uri, const std::shared_ptr<SizeInfo>& sizeInfo) {
     // If the SizeInfo is still dirty, we're done.
     if (sizeInfo->_dirty.load() || _readOnly)
         return;
@@ -122,26 +139,71 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
     return result;
 }
 
+void WiredTigerSizeStorer::storeOplogStones(StringData uri, const BSONObj& stones) {
+    if (_readOnly)
+        return;
+
+    stdx::lock_guard<stdx::mutex> lk(_bufferMutex);
+    _stonesBuffer[uri] = stones.getOwned();
+}
+
+BSONObj WiredTigerSizeStorer::loadOplogStones(StringData uri) const {
+    {
+        // Check if we can satisfy the read from the buffer.
+        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
+        StonesBuffer::const_iterator it = _stonesBuffer.find(uri);
+        if (it != _stonesBuffer.end())
+            return it->second;
+    }
+
+    stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
+    // Intentionally ignoring return value.
+    ON_BLOCK_EXIT([&] { _cursor->reset(_cursor); });
+
+    _cursor->reset(_cursor);
+
+    const std::string key = oplogStonesKey(uri);
+    {
+        WT_ITEM item = {key.c_str(), key.size()};
+        _cursor->set_key(_cursor, &item);
+        int ret = _cursor->search(_cursor);
+        if (ret == WT_NOTFOUND)
+            return BSONObj();
+        invariantWTOK(ret);
+    }
+
+    WT_ITEM value;
+    invariantWTOK(_cursor->get_value(_cursor, &value));
+    BSONObj data = BSONObj(reinterpret_cast<const char*>(value.data)).getOwned();
+
+    LOG(2) << "WiredTigerSizeStorer::loadOplogStones " << uri << " -> " << redact(data);
+    return data;
+}
+
 void WiredTigerSizeStorer::flush(bool syncToDisk) {
     Buffer buffer;
+    StonesBuffer stonesBuffer;
     {
         stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
         _buffer.swap(buffer);
+        _stonesBuffer.swap(stonesBuffer);
     }
 
-    if (buffer.empty())
+    if (buffer.empty() && stonesBuffer.empty())
         return;  // Nothing to do.
 
     Timer t;
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     {
         // On failure, place entries back into the map, unless a newer value already exists.
-        ON_BLOCK_EXIT([this, &buffer]() {
+        ON_BLOCK_EXIT([this, &buffer, &stonesBuffer]() {
             this->_cursor->reset(this->_cursor);
-            if (!buffer.empty()) {
+            if (!buffer.empty() || !stonesBuffer.empty()) {
                 stdx::lock_guard<stdx::mutex> bufferLock(this->_bufferMutex);
                 for (auto& it : buffer)
                     this->_buffer.try_emplace(it.first, it.second);
+                for (auto& it : stonesBuffer)
+                    this->_stonesBuffer.try_emplace(it.first, it.second);
             }
         });
 
@@ -155,8 +217,18 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
             // still be written back. So, the required order is to clear the dirty flag first.
             SizeInfo& sizeInfo = *it->second;
             sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
+            const long long numRecords = sizeInfo.numRecords.load();
+            const long long dataSize = sizeInfo.dataSize.load();
+
+            // Rebase counts that drifted below zero by adding the difference rather than storing
+            // zero, so that concurrent updates are kept.
+            if (numRecords < 0)
+                sizeInfo.numRecords.add(-numRecords);
+            if (dataSize < 0)
+                sizeInfo.dataSize.add(-dataSize);
+
+            BSONObj data = BSON("numRecords" << std::max(numRecords, 0LL) << "dataSize"
+                                             << std::max(dataSize, 0LL));
 
             auto& uri = it->first;
             LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
@@ -166,9 +238,21 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
             _cursor->set_value(_cursor, value.Get());
             invariantWTOK(_cursor->insert(_cursor));
         }
+
+        for (auto&& it : stonesBuffer) {
+            const BSONObj& data = it.second;
+            const std::string key = oplogStonesKey(it.first);
+            LOG(2) << "WiredTigerSizeStorer::flush " << key << " -> " << redact(data);
+            WiredTigerItem keyItem(key.c_str(), key.size());
+            WiredTigerItem value(data.objdata(), data.objsize());
+            _cursor->set_key(_cursor, keyItem.Get());
+            _cursor->set_value(_cursor, value.Get());
+            invariantWTOK(_cursor->insert(_cursor));
+        }
         txnOpen.done();
         invariantWTOK(session->commit_transaction(session, nullptr));
         buffer.clear();
+        stonesBuffer.clear();
     }
 
     auto micros = t.micros();
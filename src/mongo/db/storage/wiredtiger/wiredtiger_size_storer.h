@@ -29,11 +29,13 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 
 #include <wiredtiger.h>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
@@ -54,19 +56,64 @@ namespace mongo {
  */
 class WiredTigerSizeStorer {
 public:
+    /**
+     * A count that many threads can add to at once without contending on a single cache line.
+     * Each thread adds to one of several slots, each on a cache line of its own, and loads sum
+     * the slots. A load racing with additions sees some subset of them, and a store racing with
+     * additions may lose them, which is acceptable for the approximate sizes kept here.
+     */
+    class Counter {
+    public:
+        long long load() const {
+            long long sum = 0;
+            for (const auto& slot : _slots) {
+                sum += slot.value.loadRelaxed();
+            }
+            return sum;
+        }
+
+        void store(long long value) {
+            for (size_t i = 1; i < kSlots; ++i) {
+                _slots[i].value.store(0);
+            }
+            _slots[0].value.store(value);
+        }
+
+        void add(long long delta) {
+            _slots[_slotForThisThread()].value.fetchAndAddRelaxed(delta);
+        }
+
+    private:
+        static constexpr size_t kSlots = 16;
+
+        // Padding rather than alignment keeps the slots of neighbouring counters on separate
+        // cache lines without needing an over-aligned allocation for every SizeInfo.
+        struct Slot {
+            AtomicWord<long long> value;
+            char padding[64 - sizeof(AtomicWord<long long>)];
+        };
+
+        static size_t _slotForThisThread();
+
+        std::array<Slot, kSlots> _slots;
+    };
+
     /**
      * SizeInfo is a thread-safe buffer for keeping track of the number of documents in a collection
      * and their data size. Storing a SizeInfo in the WiredTigerSizeStorer results in shared
      * ownership. The SizeInfo may still be updated after it is stored in the SizeStorer.
      * The 'dirty' field is used by the size storer to cheaply merge duplicate stores of the same
      * SizeInfo.
+     *
+     * The counts may drift below zero, for example after an unclean shutdown lost some updates.
+     * Readers should clamp them, and flush() moves them back to zero.
      */
     struct SizeInfo {
         ~SizeInfo() {
             invariant(!_dirty.load());
         }
-        AtomicWord<long long> numRecords;
-        AtomicWord<long long> dataSize;
+        Counter numRecords;
+        Counter dataSize;
 
     private:
         friend WiredTigerSizeStorer;
@@ -82,10 +129,23 @@ public:
      * Ensure that the shared SizeInfo will be stored by the next call to flush.
      * Values stored are no older than the values at time of this call, but may be newer.
      */
-    void store(StringData uri, std::shared_ptr<SizeInfo> sizeInfo);
+    void store(StringData uri, const std::shared_ptr<SizeInfo>& sizeInfo);
 
     std::shared_ptr<SizeInfo> load(StringData uri) const;
 
+    /**
+     * Buffers the boundaries of the oplog stones of the oplog at 'uri' to be written by the next
+     * flush, replacing any previously stored boundaries. Like sizes, the boundaries lost in a
+     * crash are only an approximation that readers must validate against the oplog itself.
+     */
+    void storeOplogStones(StringData uri, const BSONObj& stones);
+
+    /**
+     * Returns the boundaries last stored for the oplog at 'uri', or an empty object if there are
+     * none.
+     */
+    BSONObj loadOplogStones(StringData uri) const;
+
     /**
      * Writes all changes to the underlying table.
      */
@@ -99,8 +159,10 @@ private:
     WT_CURSOR* _cursor;  // pointer is const after constructor
 
     using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
+    using StonesBuffer = StringMap<BSONObj>;
 
-    mutable stdx::mutex _bufferMutex;  // Guards _buffer
+    mutable stdx::mutex _bufferMutex;  // Guards _buffer and _stonesBuffer
     Buffer _buffer;
+    StonesBuffer _stonesBuffer;
 };
 }
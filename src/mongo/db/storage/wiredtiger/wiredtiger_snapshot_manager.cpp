@@ -33,29 +33,51 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 
+#include <cstdio>
+
 #include "mongo/db/server_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/errno_util.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 
+WiredTigerSnapshotManager::ReadSnapshot::ReadSnapshot(Timestamp ts) : timestamp(ts) {
+    char readTSConfigString[15 /* read_timestamp= */ + 16 /* 16 hexadecimal digits */ +
+                            1 /* trailing null */];
+    auto size = std::snprintf(
+        readTSConfigString, sizeof(readTSConfigString), "read_timestamp=%llx", ts.asULL());
+    if (size < 0) {
+        int e = errno;
+        error() << "error snprintf " << errnoWithDescription(e);
+        fassertFailedNoTrace(51038);
+    }
+    invariant(static_cast<std::size_t>(size) < sizeof(readTSConfigString));
+
+    config = readTSConfigString;
+    ignorePrepareConfig = std::string("ignore_prepare=true,") + readTSConfigString;
+}
+
 void WiredTigerSnapshotManager::setCommittedSnapshot(const Timestamp& timestamp) {
     stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
 
-    invariant(!_committedSnapshot || *_committedSnapshot <= timestamp);
-    _committedSnapshot = timestamp;
+    invariant(!_committedSnapshot || _committedSnapshot->timestamp <= timestamp);
+    _committedSnapshot.emplace(timestamp);
 }
 
 void WiredTigerSnapshotManager::setLocalSnapshot(const Timestamp& timestamp) {
     stdx::lock_guard<stdx::mutex> lock(_localSnapshotMutex);
-    _localSnapshot = timestamp;
+    _localSnapshot.emplace(timestamp);
 }
 
 boost::optional<Timestamp> WiredTigerSnapshotManager::getLocalSnapshot() {
     stdx::lock_guard<stdx::mutex> lock(_localSnapshotMutex);
-    return _localSnapshot;
+    if (!_localSnapshot) {
+        return boost::none;
+    }
+    return _localSnapshot->timestamp;
 }
 
 void WiredTigerSnapshotManager::dropAllSnapshots() {
@@ -69,37 +91,38 @@ boost::optional<Timestamp> WiredTigerSnapshotManager::getMinSnapshotForNextCommi
     }
 
     stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
-    return _committedSnapshot;
+    if (!_committedSnapshot) {
+        return boost::none;
+    }
+    return _committedSnapshot->timestamp;
 }
 
 Timestamp WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     WT_SESSION* session, WiredTigerBeginTxnBlock::IgnorePrepared ignorePrepared) const {
-    WiredTigerBeginTxnBlock txnOpen(session, ignorePrepared);
-
     stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
     uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
             "Committed view disappeared while running operation",
             _committedSnapshot);
 
-    auto status = txnOpen.setTimestamp(_committedSnapshot.get());
+    // The read timestamp is part of the begin_transaction configuration, so there is no window
+    // between opening the transaction and setting its timestamp that would need a rollback.
+    auto status = wtRCToStatus(
+        session->begin_transaction(session, _committedSnapshot->getConfig(ignorePrepared)));
     fassert(30635, status);
 
-    txnOpen.done();
-    return *_committedSnapshot;
+    return _committedSnapshot->timestamp;
 }
 
 Timestamp WiredTigerSnapshotManager::beginTransactionOnLocalSnapshot(
     WT_SESSION* session, WiredTigerBeginTxnBlock::IgnorePrepared ignorePrepared) const {
-    WiredTigerBeginTxnBlock txnOpen(session, ignorePrepared);
-
     stdx::lock_guard<stdx::mutex> lock(_localSnapshotMutex);
     invariant(_localSnapshot);
-    LOG(3) << "begin_transaction on local snapshot " << _localSnapshot.get().toString();
-    auto status = txnOpen.setTimestamp(_localSnapshot.get());
+    LOG(3) << "begin_transaction on local snapshot " << _localSnapshot->timestamp.toString();
+    auto status = wtRCToStatus(
+        session->begin_transaction(session, _localSnapshot->getConfig(ignorePrepared)));
     fassert(50775, status);
 
-    txnOpen.done();
-    return *_localSnapshot;
+    return _localSnapshot->timestamp;
 }
 
 }  // namespace mongo
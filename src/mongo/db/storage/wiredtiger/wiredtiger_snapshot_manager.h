@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <string>
 #include <wiredtiger.h>
 
 #include "mongo/base/disallow_copying.h"
@@ -84,12 +85,32 @@ public:
     boost::optional<Timestamp> getMinSnapshotForNextCommittedRead() const;
 
 private:
+    /**
+     * A read timestamp along with the begin_transaction configurations that read at it. These are
+     * built once when the snapshot is set and shared by every transaction opened on the snapshot,
+     * so that each one is started by a single begin_transaction call without formatting a
+     * configuration string of its own.
+     */
+    struct ReadSnapshot {
+        explicit ReadSnapshot(Timestamp ts);
+
+        const char* getConfig(WiredTigerBeginTxnBlock::IgnorePrepared ignorePrepared) const {
+            return ignorePrepared == WiredTigerBeginTxnBlock::IgnorePrepared::kIgnore
+                ? ignorePrepareConfig.c_str()
+                : config.c_str();
+        }
+
+        Timestamp timestamp;
+        std::string config;
+        std::string ignorePrepareConfig;
+    };
+
     // Snapshot to use for reads at a commit timestamp.
     mutable stdx::mutex _committedSnapshotMutex;  // Guards _committedSnapshot.
-    boost::optional<Timestamp> _committedSnapshot;
+    boost::optional<ReadSnapshot> _committedSnapshot;
 
     // Snapshot to use for reads at a local stable timestamp.
     mutable stdx::mutex _localSnapshotMutex;  // Guards _localSnapshot.
-    boost::optional<Timestamp> _localSnapshot;
+    boost::optional<ReadSnapshot> _localSnapshot;
 };
 }
@@ -55,6 +55,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -344,5 +345,72 @@ TEST_F(SizeStorerUpdateTest, Basic) {
     ASSERT_EQUALS(getDataSize(), val);
 }
 
+// Sizes updated from many threads at once are summed across all of them.
+TEST_F(SizeStorerUpdateTest, ConcurrentUpdates) {
+    const int kThreads = 32;
+    const int kUpdatesPerThread = 1000;
+
+    auto sizeInfo = std::make_shared<WiredTigerSizeStorer::SizeInfo>();
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < kUpdatesPerThread; ++j) {
+                sizeInfo->numRecords.add(1);
+                sizeInfo->dataSize.add(10);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQUALS(sizeInfo->numRecords.load(), kThreads * kUpdatesPerThread);
+    ASSERT_EQUALS(sizeInfo->dataSize.load(), 10 * kThreads * kUpdatesPerThread);
+}
+
+// Sizes that drifted below zero are stored as zero and count up from there afterwards.
+TEST_F(SizeStorerUpdateTest, FlushRebasesNegativeSizes) {
+    auto sizeInfo = std::make_shared<WiredTigerSizeStorer::SizeInfo>();
+    sizeInfo->numRecords.add(-3);
+    sizeInfo->dataSize.add(-30);
+    sizeStorer->store(uri, sizeInfo);
+    sizeStorer->flush(false);
+
+    ASSERT_EQUALS(sizeInfo->numRecords.load(), 0);
+    ASSERT_EQUALS(sizeInfo->dataSize.load(), 0);
+
+    sizeInfo->numRecords.add(1);
+    sizeInfo->dataSize.add(10);
+    sizeStorer->store(uri, sizeInfo);
+    ASSERT_EQUALS(getNumRecords(), 1);
+    ASSERT_EQUALS(getDataSize(), 10);
+    sizeStorer->flush(false);
+}
+
+// Oplog stones are kept apart from the sizes stored under the same URI and survive a flush.
+TEST_F(SizeStorerUpdateTest, OplogStonesRoundTrip) {
+    ASSERT_BSONOBJ_EQ(sizeStorer->loadOplogStones(uri), BSONObj());
+
+    BSONObj stones = BSON("minBytesPerStone" << 100LL << "stones"
+                                             << BSON_ARRAY(BSON("records" << 1LL << "bytes" << 100LL
+                                                                          << "lastRecord"
+                                                                          << 5LL)));
+    sizeStorer->storeOplogStones(uri, stones);
+    ASSERT_BSONOBJ_EQ(sizeStorer->loadOplogStones(uri), stones);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs->updateStatsAfterRepair(opCtx.get(), 7, 70);
+    }
+    sizeStorer->flush(false);
+
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer reopened(
+        harnessHelper->conn(), WiredTigerKVEngine::kTableUriPrefix + "sizeStorer", enableWtLogging);
+    ASSERT_BSONOBJ_EQ(reopened.loadOplogStones(uri), stones);
+    ASSERT_EQUALS(reopened.load(uri)->numRecords.load(), 7);
+    ASSERT_EQUALS(reopened.load(uri)->dataSize.load(), 70);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -308,6 +308,57 @@ Status WiredTigerUtil::checkTableCreationOptions(const BSONElement& configElem)
     return Status::OK();
 }
 
+// static
+StatusWith<WiredTigerUtil::CachePriority> WiredTigerUtil::parseCachePriority(
+    const BSONElement& priorityElem) {
+    invariant(priorityElem.fieldNameStringData() == "cachePriority");
+
+    if (priorityElem.type() != String) {
+        return {ErrorCodes::TypeMismatch, "'cachePriority' must be a string."};
+    }
+
+    StringData priority = priorityElem.valueStringData();
+    for (auto candidate : {CachePriority::kLow, CachePriority::kNormal, CachePriority::kHigh}) {
+        if (priority == cachePriorityName(candidate)) {
+            return candidate;
+        }
+    }
+    return {ErrorCodes::BadValue,
+            str::stream() << "'cachePriority' must be one of \"low\", \"normal\" or \"high\", "
+                          << "not \""
+                          << priority
+                          << "\"."};
+}
+
+// static
+WiredTigerUtil::CachePriority WiredTigerUtil::getCachePriority(const BSONObj& engineOptions) {
+    BSONElement priorityElem = engineOptions["cachePriority"];
+    if (priorityElem.eoo()) {
+        return engineOptions["archive"].trueValue() ? CachePriority::kLow : CachePriority::kNormal;
+    }
+    return uassertStatusOK(parseCachePriority(priorityElem));
+}
+
+// static
+StringData WiredTigerUtil::cachePriorityName(CachePriority priority) {
+    switch (priority) {
+        case CachePriority::kLow:
+            return "low"_sd;
+        case CachePriority::kNormal:
+            return "normal"_sd;
+        case CachePriority::kHigh:
+            return "high"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+// static
+std::string WiredTigerUtil::cachePriorityConfig(CachePriority priority) {
+    // Read-once cursors are the mechanism for the "low" class, so it needs no table configuration
+    // beyond undoing a "high" priority inherited from the collection.
+    return priority == CachePriority::kHigh ? "cache_resident=true," : "cache_resident=false,";
+}
+
 // static
 StatusWith<uint64_t> WiredTigerUtil::getStatisticsValue(WT_SESSION* session,
                                                         const std::string& uri,
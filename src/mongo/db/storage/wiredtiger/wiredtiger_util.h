@@ -199,6 +199,37 @@ public:
      */
     static Status checkTableCreationOptions(const BSONElement& configElem);
 
+    /**
+     * Cache priority classes that a collection or index can be assigned through the
+     * 'cachePriority' field of its WiredTiger storage engine options. Tables in the "high" class
+     * are created cache resident so that scans of other tables cannot evict them. Cursors over
+     * collections in the "low" class are opened read-once, so the pages they bring into the cache
+     * are the first to be evicted.
+     */
+    enum class CachePriority { kLow, kNormal, kHigh };
+
+    static constexpr int kNumCachePriorities = 3;
+
+    /**
+     * Validates the 'cachePriority' specified as a collection or index creation option.
+     */
+    static StatusWith<CachePriority> parseCachePriority(const BSONElement& priorityElem);
+
+    /**
+     * Returns the cache priority named in already validated storage engine options. Without one,
+     * returns kLow for collections marked 'archive' and kNormal otherwise.
+     */
+    static CachePriority getCachePriority(const BSONObj& engineOptions);
+
+    static StringData cachePriorityName(CachePriority priority);
+
+    /**
+     * Returns the table creation configuration that implements 'priority'. The configuration is
+     * never empty, so a priority given to an individual index overrides the one it would
+     * otherwise inherit from its collection.
+     */
+    static std::string cachePriorityConfig(CachePriority priority);
+
     /**
      * Reads individual statistics using URI.
      * List of statistics keys WT_STAT_* can be found in wiredtiger.h.
@@ -29,6 +29,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cstring>
 #include <fcntl.h>
 #include <iostream>
 #include <string>
@@ -41,6 +42,8 @@
 #include <unistd.h>
 #endif
 
+#include <snappy.h>
+
 #include "mongo/base/data_cursor.h"
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_endian.h"
@@ -48,6 +51,7 @@
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/traffic_reader.h"
+#include "mongo/db/traffic_recording_format.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/op_msg.h"
@@ -71,16 +75,6 @@ namespace mongo {
 
 namespace {
 
-// Packet struct
-struct TrafficReaderPacket {
-    uint64_t id;
-    StringData local;
-    StringData remote;
-    Date_t date;
-    uint64_t order;
-    MsgData::ConstView message;
-};
-
 bool readBytes(size_t toRead, char* buf, int fd) {
     while (toRead) {
 #ifdef _WIN32
@@ -109,31 +103,6 @@ bool readBytes(size_t toRead, char* buf, int fd) {
     return true;
 }
 
-boost::optional<TrafficReaderPacket> readPacket(char* buf, int fd) {
-    if (!readBytes(4, buf, fd)) {
-        return boost::none;
-    }
-    auto len = ConstDataView(buf).read<LittleEndian<uint32_t>>();
-
-    uassert(ErrorCodes::FailedToParse, "packet too large", len < MaxMessageSizeBytes);
-    uassert(
-        ErrorCodes::FailedToParse, "could not read full packet", readBytes(len - 4, buf + 4, fd));
-
-    ConstDataRangeCursor cdr(buf, buf + len);
-
-    // Read the packet
-    uassertStatusOK(cdr.skip<LittleEndian<uint32_t>>());
-    uint64_t id = uassertStatusOK(cdr.readAndAdvance<LittleEndian<uint64_t>>());
-    StringData local = uassertStatusOK(cdr.readAndAdvance<Terminated<'\0', StringData>>());
-    StringData remote = uassertStatusOK(cdr.readAndAdvance<Terminated<'\0', StringData>>());
-    uint64_t date = uassertStatusOK(cdr.readAndAdvance<LittleEndian<uint64_t>>());
-    uint64_t order = uassertStatusOK(cdr.readAndAdvance<LittleEndian<uint64_t>>());
-    MsgData::ConstView message(cdr.data());
-
-    return TrafficReaderPacket{
-        id, local, remote, Date_t::fromMillisSinceEpoch(date), order, message};
-}
-
 void getBSONObjFromPacket(TrafficReaderPacket& packet, BSONObjBuilder* builder) {
     {
         // RawOp Field
@@ -202,6 +171,100 @@ void addOpType(TrafficReaderPacket& packet, BSONObjBuilder* builder) {
 
 }  // namespace
 
+TrafficRecordingReader::TrafficRecordingReader(int fd)
+    : _fd(fd), _buf(SharedBuffer::allocate(MaxMessageSizeBytes)) {}
+
+bool TrafficRecordingReader::_readBytes(size_t toRead, char* buf) {
+    if (!_compressed) {
+        return readBytes(toRead, buf, _fd);
+    }
+
+    while (toRead) {
+        if (_blockPos == _block.size() && !_readBlock()) {
+            return false;
+        }
+
+        const auto n = std::min(toRead, _block.size() - _blockPos);
+        std::memcpy(buf, _block.data() + _blockPos, n);
+        _blockPos += n;
+        buf += n;
+        toRead -= n;
+    }
+
+    return true;
+}
+
+bool TrafficRecordingReader::_readBlock() {
+    char header[2 * sizeof(uint32_t)];
+    if (!readBytes(sizeof(header), header, _fd)) {
+        return false;
+    }
+    ConstDataView headerView(header);
+    const auto compressedSize = headerView.read<LittleEndian<uint32_t>>();
+    const auto uncompressedSize = headerView.read<LittleEndian<uint32_t>>(sizeof(uint32_t));
+
+    _compressedBlock.resize(compressedSize);
+    uassert(ErrorCodes::FailedToParse,
+            "could not read full compressed block",
+            readBytes(compressedSize, &_compressedBlock[0], _fd));
+
+    size_t expectedSize;
+    uassert(ErrorCodes::FailedToParse,
+            "invalid compressed block",
+            snappy::GetUncompressedLength(
+                _compressedBlock.data(), _compressedBlock.size(), &expectedSize) &&
+                expectedSize == uncompressedSize);
+
+    _block.resize(uncompressedSize);
+    uassert(ErrorCodes::FailedToParse,
+            "invalid compressed block",
+            snappy::RawUncompress(_compressedBlock.data(), _compressedBlock.size(), &_block[0]));
+    _blockPos = 0;
+    return true;
+}
+
+boost::optional<TrafficReaderPacket> TrafficRecordingReader::next() {
+    char* buf = _buf.get();
+    if (!_readBytes(4, buf)) {
+        return boost::none;
+    }
+
+    // A compressed recording starts with a magic that no packet size matches.
+    if (!_startRead) {
+        _startRead = true;
+        const auto& magic = kTrafficRecordingCompressedMagic;
+        if (StringData(buf, 4) == magic.substr(0, 4)) {
+            uassert(ErrorCodes::FailedToParse,
+                    "invalid traffic recording header",
+                    readBytes(magic.size() - 4, buf + 4, _fd) &&
+                        StringData(buf, magic.size()) == magic);
+            _compressed = true;
+            if (!_readBytes(4, buf)) {
+                return boost::none;
+            }
+        }
+    }
+
+    auto len = ConstDataView(buf).read<LittleEndian<uint32_t>>();
+
+    uassert(ErrorCodes::FailedToParse, "packet too large", len < MaxMessageSizeBytes);
+    uassert(ErrorCodes::FailedToParse, "could not read full packet", _readBytes(len - 4, buf + 4));
+
+    ConstDataRangeCursor cdr(buf, buf + len);
+
+    // Read the packet
+    uassertStatusOK(cdr.skip<LittleEndian<uint32_t>>());
+    uint64_t id = uassertStatusOK(cdr.readAndAdvance<LittleEndian<uint64_t>>());
+    StringData local = uassertStatusOK(cdr.readAndAdvance<Terminated<'\0', StringData>>());
+    StringData remote = uassertStatusOK(cdr.readAndAdvance<Terminated<'\0', StringData>>());
+    uint64_t date = uassertStatusOK(cdr.readAndAdvance<LittleEndian<uint64_t>>());
+    uint64_t order = uassertStatusOK(cdr.readAndAdvance<LittleEndian<uint64_t>>());
+    MsgData::ConstView message(cdr.data());
+
+    return TrafficReaderPacket{
+        id, local, remote, Date_t::fromMillisSinceEpoch(date), order, message};
+}
+
 BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile) {
     BSONArrayBuilder builder{};
 
@@ -218,8 +281,8 @@ BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile) {
 
     const auto guard = makeGuard([&] { ::close(inputFd); });
 
-    auto buf = SharedBuffer::allocate(MaxMessageSizeBytes);
-    while (auto packet = readPacket(buf.get(), inputFd)) {
+    TrafficRecordingReader reader(inputFd);
+    while (auto packet = reader.next()) {
         BSONObjBuilder bob(builder.subobjStart());
         getBSONObjFromPacket(*packet, &bob);
         addOpType(*packet, &bob);
@@ -237,9 +300,9 @@ void trafficRecordingFileToMongoReplayFile(int inputFd, std::ostream& outputStre
     outputStream.write(optsObj.objdata(), optsObj.objsize());
 
     BSONObjBuilder bob;
-    auto buf = SharedBuffer::allocate(MaxMessageSizeBytes);
+    TrafficRecordingReader reader(inputFd);
 
-    while (auto packet = readPacket(buf.get(), inputFd)) {
+    while (auto packet = reader.next()) {
         getBSONObjFromPacket(*packet, &bob);
 
         auto obj = bob.asTempObj();
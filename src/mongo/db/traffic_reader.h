@@ -27,12 +27,67 @@
  *    it in the license file.
  */
 
-#include "mongo/rpc/op_msg.h"
-
 #pragma once
 
+#include <boost/optional.hpp>
+#include <iosfwd>
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/rpc/message.h"
+#include "mongo/util/shared_buffer.h"
+#include "mongo/util/time_support.h"
+
 namespace mongo {
 
+/**
+ * A packet of a traffic recording. Its fields point into the buffer of the reader which returned
+ * it, and are valid until the reader reads the next packet.
+ */
+struct TrafficReaderPacket {
+    uint64_t id;
+    StringData local;
+    StringData remote;
+    Date_t date;
+    uint64_t order;
+    MsgData::ConstView message;
+};
+
+/**
+ * Reads the packets of a traffic recording, compressed or not, from a file descriptor.
+ */
+class TrafficRecordingReader {
+public:
+    explicit TrafficRecordingReader(int fd);
+
+    /**
+     * Returns the next packet of the recording, or boost::none at the end of the recording.
+     * Throws if the recording is malformed.
+     */
+    boost::optional<TrafficReaderPacket> next();
+
+private:
+    bool _readBytes(size_t toRead, char* buf);
+
+    /**
+     * Reads and decompresses the next block of a compressed recording. Returns false at the end
+     * of the recording.
+     */
+    bool _readBlock();
+
+    const int _fd;
+    SharedBuffer _buf;
+
+    bool _startRead = false;
+    bool _compressed = false;
+
+    // The decompressed block being read, and the position of the next byte to read in it.
+    std::string _block;
+    size_t _blockPos = 0;
+    std::string _compressedBlock;
+};
+
 // Method for testing, takes the recorded traffic and returns a BSONArray
 BSONArray trafficRecordingFileToBSONArr(const std::string& inputFile);
 
@@ -39,7 +39,9 @@
 #endif
 
 #include "mongo/base/initializer.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/traffic_reader.h"
+#include "mongo/db/traffic_replayer.h"
 #include "mongo/util/signal_handlers.h"
 #include "mongo/util/text.h"
 
@@ -67,15 +69,24 @@ int main(int argc, char* argv[], char** envp) {
     int inputFd = 0;
     std::ofstream outputStream;
 
+    // Set when the recording is replayed against a server instead of converted
+    boost::optional<TrafficReplayOptions> replayOptions;
+
     try {
         // Define the program options
         auto inputStr = "Path to file input file (defaults to stdin)";
         auto outputStr =
             "Path to file that mongotrafficreader will place its output (defaults to stdout)";
+        auto replayStr =
+            "Connection string of a server to replay the recorded requests against, with the "
+            "timing and concurrency of the recorded sessions, instead of converting the recording";
+        auto speedStr = "Speed of the replay relative to the recording (defaults to 1.0)";
         boost::program_options::options_description desc{"Options"};
         desc.add_options()("help,h", "help")(
             "input,i", boost::program_options::value<std::string>(), inputStr)(
-            "output,o", boost::program_options::value<std::string>(), outputStr);
+            "output,o", boost::program_options::value<std::string>(), outputStr)(
+            "replay,r", boost::program_options::value<std::string>(), replayStr)(
+            "speed", boost::program_options::value<double>(), speedStr);
 
         // Parse the program options
         store(parse_command_line(argc, argv, desc), vm);
@@ -84,7 +95,8 @@ int main(int argc, char* argv[], char** envp) {
         // Handle the help option
         if (vm.count("help")) {
             std::cout << "Mongo Traffic Reader Help: \n\n\t./mongotrafficreader "
-                         "-i trafficinput.txt -o mongotrafficreader_dump.bson \n\n"
+                         "-i trafficinput.txt -o mongotrafficreader_dump.bson \n"
+                         "\t./mongotrafficreader -i trafficinput.txt -r mongodb://host:port \n\n"
                       << desc << std::endl;
             return EXIT_SUCCESS;
         }
@@ -106,6 +118,14 @@ int main(int argc, char* argv[], char** envp) {
 #endif
         }
 
+        if (vm.count("replay")) {
+            replayOptions.emplace();
+            replayOptions->uri = vm["replay"].as<std::string>();
+            if (vm.count("speed")) {
+                replayOptions->speed = vm["speed"].as<double>();
+            }
+        }
+
         // User must specify a --output param and it does not need to point to a valid file
         if (vm.count("output")) {
             auto outputFile = vm["output"].as<std::string>();
@@ -127,6 +147,18 @@ int main(int argc, char* argv[], char** envp) {
         return EXIT_FAILURE;
     }
 
+    if (replayOptions) {
+        setGlobalServiceContext(ServiceContext::make());
+        try {
+            auto stats = mongo::replayTrafficRecording(inputFd, *replayOptions);
+            outputStream << stats.jsonString() << std::endl;
+        } catch (const DBException& ex) {
+            std::cerr << "Error replaying traffic recording: " << ex.toStatus() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return 0;
+    }
+
     mongo::trafficRecordingFileToMongoReplayFile(inputFd, outputStream);
 
     return 0;
@@ -32,19 +32,24 @@
 #include "mongo/db/traffic_recorder.h"
 #include "mongo/db/traffic_recorder_gen.h"
 
+#include <array>
 #include <boost/filesystem/operations.hpp>
 #include <fstream>
+#include <snappy.h>
 
-#include "mongo/base/data_builder.h"
-#include "mongo/base/data_type_terminated.h"
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
 #include "mongo/base/init.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/traffic_recording_format.h"
 #include "mongo/rpc/factory.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/mongoutils/str.h"
-#include "mongo/util/producer_consumer_queue.h"
 
 namespace mongo {
 
@@ -52,6 +57,9 @@ namespace {
 
 bool shouldAlwaysRecordTraffic = false;
 
+// How often a recording writes out its buffers when they are not filling up.
+const Milliseconds kFlushInterval{100};
+
 MONGO_INITIALIZER(ShouldAlwaysRecordTraffic)(InitializerContext*) {
     if (!gAlwaysRecordTraffic.size()) {
         return Status::OK();
@@ -78,112 +86,133 @@ MONGO_INITIALIZER(ShouldAlwaysRecordTraffic)(InitializerContext*) {
  * The Recording class represents a single recording that the recorder is exposing.  It's made up of
  * a background thread which flushes records to disk, and helper methods to push to that thread,
  * expose stats, and stop the recording.
+ *
+ * Packets are serialized by the threads observing them into one of kNumStripes buffers, chosen by
+ * session, so that concurrent sessions rarely contend on the same mutex and the packets of a
+ * session stay in order. The background thread swaps each buffer for an empty one and writes it
+ * out. The buffers share the configured buffer size; a packet which does not fit in its buffer is
+ * dropped and counted, so that a recording never slows down the operations it observes.
  */
 class TrafficRecorder::Recording {
 public:
-    Recording(const StartRecordingTraffic& options)
-        : _path(_getPath(options.getFilename().toString())), _maxLogSize(options.getMaxFileSize()) {
-
-        MultiProducerSingleConsumerQueue<TrafficRecordingPacket, CostFunction>::Options
-            queueOptions;
-        queueOptions.maxQueueDepth = options.getBufferSize();
-        if (!shouldAlwaysRecordTraffic) {
-            queueOptions.maxProducerQueueDepth = 0;
-        }
-        _pcqPipe = MultiProducerSingleConsumerQueue<TrafficRecordingPacket, CostFunction>::Pipe(
-            queueOptions);
+    static constexpr size_t kNumStripes = 16;
 
+    Recording(const StartRecordingTraffic& options)
+        : _path(_getPath(options.getFilename().toString())),
+          _maxLogSize(options.getMaxFileSize()),
+          _compress(options.getCompress()),
+          _stripeCapacity(std::max<size_t>(options.getBufferSize() / kNumStripes, 1)) {
         _trafficStats.setRunning(true);
         _trafficStats.setBufferSize(options.getBufferSize());
         _trafficStats.setRecordingFile(_path);
         _trafficStats.setMaxFileSize(_maxLogSize);
+        _trafficStats.setCompressed(_compress);
     }
 
     void run() {
-        _thread = stdx::thread([ consumer = std::move(_pcqPipe.consumer), this ] {
+        _thread = stdx::thread([this] {
             try {
-                DataBuilder db;
                 std::fstream out(_path,
                                  std::ios_base::binary | std::ios_base::trunc | std::ios_base::out);
+                if (_compress) {
+                    _write(&out,
+                           kTrafficRecordingCompressedMagic.rawData(),
+                           kTrafficRecordingCompressedMagic.size());
+                }
 
-                while (true) {
-                    std::deque<TrafficRecordingPacket> storage;
-                    size_t bytes;
-
-                    std::tie(storage, bytes) = consumer.popManyUpTo(MaxMessageSizeBytes);
-
-                    // if this fired... somehow we got a message bigger than a message
-                    invariant(bytes);
-
-                    for (const auto& packet : storage) {
-                        db.clear();
-                        Message toWrite = packet.message;
-
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint32_t>>(0));
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(packet.id));
-                        uassertStatusOK(db.writeAndAdvance<Terminated<'\0', StringData>>(
-                            StringData(packet.local)));
-                        uassertStatusOK(db.writeAndAdvance<Terminated<'\0', StringData>>(
-                            StringData(packet.remote)));
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(
-                            packet.now.toMillisSinceEpoch()));
-                        uassertStatusOK(db.writeAndAdvance<LittleEndian<uint64_t>>(packet.order));
-
-                        auto size = db.size() + toWrite.size();
-                        uassertStatusOK(db.getCursor().write<LittleEndian<uint32_t>>(size));
+                auto flushed = stdx::make_unique<BufBuilder>();
+                std::string compressed;
+                bool done = false;
+                while (!done) {
+                    {
+                        stdx::unique_lock<stdx::mutex> lk(_mutex);
+                        _flushCondition.wait_for(lk, kFlushInterval.toSystemDuration(), [&] {
+                            return _inShutdown || _flushRequested.load();
+                        });
+                        done = _inShutdown;
+                    }
+                    _flushRequested.store(false);
 
+                    for (auto& stripe : _stripes) {
                         {
-                            stdx::lock_guard<stdx::mutex> lk(_mutex);
-                            _written += size;
+                            stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+                            if (!stripe.buffer->len()) {
+                                continue;
+                            }
+                            std::swap(stripe.buffer, flushed);
                         }
+                        stripe.drained.notify_all();
 
-                        uassert(ErrorCodes::LogWriteFailed,
-                                "hit maximum log size",
-                                _written < _maxLogSize);
-
-                        out.write(db.getCursor().data(), db.size());
-                        out.write(toWrite.buf(), toWrite.size());
+                        _writeBlock(&out, *flushed, &compressed);
+                        flushed->reset();
                     }
                 }
-            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
-                // Close naturally
             } catch (...) {
                 auto status = exceptionToStatus();
 
                 stdx::lock_guard<stdx::mutex> lk(_mutex);
                 _result = status;
             }
+
+            // Nothing is written anymore, so release any producer waiting for buffer space.
+            _stopped.store(true);
+            for (auto& stripe : _stripes) {
+                stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+                stripe.drained.notify_all();
+            }
         });
     }
 
     /**
-     * pushRecord returns false if the queue was full.  This is ultimately fatal to the recording
+     * pushRecord returns false if the recording stopped.  A packet which is dropped because its
+     * buffer is full does not stop the recording.
      */
-    bool pushRecord(const transport::SessionHandle& ts,
-                    Date_t now,
-                    const uint64_t order,
-                    const Message& message) {
-        try {
-            _pcqPipe.producer.push(
-                {ts->id(), ts->local().toString(), ts->remote().toString(), now, order, message});
-            return true;
-        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueProducerQueueDepthExceeded>&) {
-            invariant(!shouldAlwaysRecordTraffic);
-
-            // If we couldn't push our packet begin the process of failing the recording
-            _pcqPipe.producer.close();
-
-            stdx::lock_guard<stdx::mutex> lk(_mutex);
+    bool pushRecord(const transport::SessionHandle& ts, Date_t now, const Message& message) {
+        if (_stopped.load()) {
+            return false;
+        }
 
-            // If the result was otherwise okay, mark it as failed due to the queue blocking.  If
-            // it failed for another reason, don't overwrite that.
-            if (_result.isOK()) {
-                _result = Status(ErrorCodes::Error(51061), "queue was blocked in traffic recorder");
+        const auto local = ts->local().toString();
+        const auto remote = ts->remote().toString();
+        const size_t size = sizeof(uint32_t) + sizeof(uint64_t) + local.size() + 1 +
+            remote.size() + 1 + sizeof(uint64_t) + sizeof(uint64_t) + message.size();
+
+        auto& stripe = _stripes[ts->id() % kNumStripes];
+        stdx::unique_lock<stdx::mutex> lk(stripe.mutex);
+
+        // A packet larger than a buffer is still recorded when its buffer is empty.
+        const auto fits = [&] {
+            return !stripe.buffer->len() ||
+                static_cast<size_t>(stripe.buffer->len()) + size <= _stripeCapacity;
+        };
+        if (shouldAlwaysRecordTraffic) {
+            // Every packet must be recorded, so wait for the buffer to be written out instead.
+            stripe.drained.wait(lk, [&] { return fits() || _stopped.load(); });
+            if (_stopped.load()) {
+                return false;
             }
-        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+        } else if (!fits()) {
+            _droppedPackets.fetchAndAdd(1);
+            _droppedBytes.fetchAndAdd(size);
+            return true;
         }
 
-        return false;
+        // The order is taken under the mutex of the buffer, so that the packets of a buffer are
+        // in order.
+        auto& buffer = *stripe.buffer;
+        buffer.appendNum(static_cast<uint32_t>(size));
+        buffer.appendNum(static_cast<unsigned long long>(ts->id()));
+        buffer.appendStr(local);
+        buffer.appendStr(remote);
+        buffer.appendNum(static_cast<unsigned long long>(now.toMillisSinceEpoch()));
+        buffer.appendNum(static_cast<unsigned long long>(_order.addAndFetch(1)));
+        buffer.appendBuf(message.buf(), message.size());
+
+        if (static_cast<size_t>(buffer.len()) >= _stripeCapacity / 2 && !_flushRequested.load()) {
+            _flushRequested.store(true);
+            _flushCondition.notify_one();
+        }
+        return true;
     }
 
     Status shutdown() {
@@ -191,9 +220,9 @@ public:
 
         if (!_inShutdown) {
             _inShutdown = true;
+            _flushCondition.notify_one();
             lk.unlock();
 
-            _pcqPipe.producer.close();
             _thread.join();
 
             lk.lock();
@@ -203,28 +232,28 @@ public:
     }
 
     BSONObj getStats() {
+        long long bufferedBytes = 0;
+        for (auto& stripe : _stripes) {
+            stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+            bufferedBytes += stripe.buffer->len();
+        }
+
         stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _trafficStats.setBufferedBytes(_pcqPipe.controller.getStats().queueDepth);
+        _trafficStats.setBufferedBytes(bufferedBytes);
         _trafficStats.setCurrentFileSize(_written);
+        _trafficStats.setDroppedPackets(_droppedPackets.load());
+        _trafficStats.setDroppedBytes(_droppedBytes.load());
         return _trafficStats.toBSON();
     }
 
-    AtomicWord<uint64_t> order{0};
-
 private:
-    struct TrafficRecordingPacket {
-        const uint64_t id;
-        const std::string local;
-        const std::string remote;
-        const Date_t now;
-        const uint64_t order;
-        const Message message;
-    };
+    struct Stripe {
+        stdx::mutex mutex;
 
-    struct CostFunction {
-        size_t operator()(const TrafficRecordingPacket& packet) const {
-            return packet.message.size();
-        }
+        // Signaled when 'buffer' is written out.
+        stdx::condition_variable drained;
+
+        std::unique_ptr<BufBuilder> buffer = stdx::make_unique<BufBuilder>();
     };
 
     static std::string _getPath(const std::string& filename) {
@@ -245,13 +274,61 @@ private:
         return path.string();
     }
 
+    /**
+     * Writes the packets in 'packets' to 'out', as a compressed block if the recording is
+     * compressed. 'compressed' is scratch space for the compressed block.
+     */
+    void _writeBlock(std::fstream* out, const BufBuilder& packets, std::string* compressed) {
+        if (!_compress) {
+            _write(out, packets.buf(), packets.len());
+            return;
+        }
+
+        compressed->resize(2 * sizeof(uint32_t) + snappy::MaxCompressedLength(packets.len()));
+        size_t compressedSize;
+        snappy::RawCompress(
+            packets.buf(), packets.len(), &(*compressed)[2 * sizeof(uint32_t)], &compressedSize);
+
+        DataView(&(*compressed)[0])
+            .write(tagLittleEndian(static_cast<uint32_t>(compressedSize)))
+            .write(tagLittleEndian(static_cast<uint32_t>(packets.len())), sizeof(uint32_t));
+        _write(out, compressed->data(), 2 * sizeof(uint32_t) + compressedSize);
+    }
+
+    void _write(std::fstream* out, const char* data, size_t size) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _written += size;
+        }
+
+        uassert(ErrorCodes::LogWriteFailed, "hit maximum log size", _written < _maxLogSize);
+
+        out->write(data, size);
+        uassert(ErrorCodes::LogWriteFailed,
+                str::stream() << "failed to write to traffic recording " << _path,
+                out->good());
+    }
+
     const std::string _path;
     const size_t _maxLogSize;
+    const bool _compress;
+    const size_t _stripeCapacity;
+
+    std::array<Stripe, kNumStripes> _stripes;
+    AtomicWord<uint64_t> _order{0};
+    AtomicWord<long long> _droppedPackets{0};
+    AtomicWord<long long> _droppedBytes{0};
+
+    // Set once the background thread stops writing, because of an error or a shutdown.
+    AtomicWord<bool> _stopped{false};
+
+    // Set by producers to have buffers written out before the next flush interval.
+    AtomicWord<bool> _flushRequested{false};
 
-    MultiProducerSingleConsumerQueue<TrafficRecordingPacket, CostFunction>::Pipe _pcqPipe;
     stdx::thread _thread;
 
     stdx::mutex _mutex;
+    stdx::condition_variable _flushCondition;
     bool _inShutdown = false;
     TrafficRecorderStats _trafficStats;
     size_t _written = 0;
@@ -326,7 +403,7 @@ void TrafficRecorder::observe(const transport::SessionHandle& ts,
             }
         }
 
-        invariant(_recording->pushRecord(ts, now, _recording->order.addAndFetch(1), message));
+        invariant(_recording->pushRecord(ts, now, message));
         return;
     }
 
@@ -342,11 +419,11 @@ void TrafficRecorder::observe(const transport::SessionHandle& ts,
     }
 
     // Try to record the message
-    if (recording->pushRecord(ts, now, recording->order.addAndFetch(1), message)) {
+    if (recording->pushRecord(ts, now, message)) {
         return;
     }
 
-    // We couldn't queue
+    // The recording failed
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     // If the recording isn't the one we have in hand bail (its been ended, or a new one has
@@ -355,7 +432,7 @@ void TrafficRecorder::observe(const transport::SessionHandle& ts,
         return;
     }
 
-    // We couldn't queue and it's still our recording.  No one else should try to queue
+    // The recording failed and it's still our recording.  No one else should try to record
     _shouldRecord.store(false);
 }
 
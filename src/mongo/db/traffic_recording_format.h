@@ -0,0 +1,61 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * The format of traffic recording files, shared by the TrafficRecorder which writes them and the
+ * traffic reader which reads them.
+ *
+ * A recording is a sequence of packets. Each packet is laid out as:
+ *     uint32 size       - size of the packet, including this field
+ *     uint64 id         - id of the session the message was received or sent on
+ *     cstring local     - local address of the session
+ *     cstring remote    - remote address of the session
+ *     uint64 date       - milliseconds since the epoch at which the message was observed
+ *     uint64 order      - position of the packet in the recording
+ *     bytes message     - the wire protocol message
+ * with every integer little endian. Packets of a session are in order. Packets of different
+ * sessions may be interleaved out of order, and are ordered by their 'order' field.
+ *
+ * A compressed recording starts with kTrafficRecordingCompressedMagic, followed by a sequence of
+ * blocks. Each block is laid out as:
+ *     uint32 compressedSize
+ *     uint32 uncompressedSize
+ *     bytes data        - snappy compressed packets
+ * The magic is distinguishable from the size of a packet, which is less than the maximum message
+ * size, so that readers can tell both kinds of recordings apart.
+ */
+constexpr StringData kTrafficRecordingCompressedMagic = "MTRSNPY1"_sd;
+
+}  // namespace mongo
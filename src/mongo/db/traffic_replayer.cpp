@@ -0,0 +1,261 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_replayer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/dbclient_base.h"
+#include "mongo/client/mongo_uri.h"
+#include "mongo/db/traffic_reader.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+using ReplayClock = stdx::chrono::steady_clock;
+
+// Requests are handed to their session at most this long before they are due, which bounds the
+// memory held by a replay.
+const Milliseconds kReadAhead{1000};
+
+// Commands which cannot be replayed, because they authenticate with the nonces of the recorded
+// connection or control the recording itself.
+const StringData kSkippedCommands[] = {"authenticate"_sd,
+                                       "getnonce"_sd,
+                                       "logout"_sd,
+                                       "saslContinue"_sd,
+                                       "saslStart"_sd,
+                                       "startRecordingTraffic"_sd,
+                                       "stopRecordingTraffic"_sd};
+
+bool isSkippedCommand(StringData commandName) {
+    return std::find(std::begin(kSkippedCommands), std::end(kSkippedCommands), commandName) !=
+        std::end(kSkippedCommands);
+}
+
+struct ReplayStats {
+    AtomicWord<long long> requests{0};
+    AtomicWord<long long> errors{0};
+    AtomicWord<long long> skipped{0};
+    AtomicWord<long long> maxLagMicros{0};
+
+    void recordLag(long long lagMicros) {
+        auto current = maxLagMicros.load();
+        while (current < lagMicros) {
+            const auto previous = maxLagMicros.compareAndSwap(current, lagMicros);
+            if (previous == current) {
+                break;
+            }
+            current = previous;
+        }
+    }
+};
+
+/**
+ * Replays the requests of one recorded session, in order, on a connection of its own.
+ */
+class ReplaySession {
+public:
+    ReplaySession(const MongoURI& uri, ReplayStats* stats)
+        : _uri(uri), _stats(stats), _thread([this] { _run(); }) {}
+
+    ~ReplaySession() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _closed = true;
+        }
+        _condition.notify_one();
+        _thread.join();
+    }
+
+    void push(Message message, ReplayClock::time_point sendAt) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _requests.push_back({std::move(message), sendAt});
+        }
+        _condition.notify_one();
+    }
+
+private:
+    struct Request {
+        Message message;
+        ReplayClock::time_point sendAt;
+    };
+
+    void _run() {
+        std::unique_ptr<DBClientBase> conn;
+        while (true) {
+            Request request;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _condition.wait(lk, [&] { return _closed || !_requests.empty(); });
+                if (_requests.empty()) {
+                    return;
+                }
+                request = std::move(_requests.front());
+                _requests.pop_front();
+            }
+
+            stdx::this_thread::sleep_until(request.sendAt);
+            _stats->recordLag(durationCount<Microseconds>(ReplayClock::now() - request.sendAt));
+
+            try {
+                if (!conn || conn->isFailed()) {
+                    std::string errmsg;
+                    conn.reset(_uri.connect("mongotrafficreader", errmsg));
+                    uassert(ErrorCodes::HostUnreachable,
+                            str::stream() << "failed to connect to replay target: " << errmsg,
+                            conn);
+                }
+                _send(conn.get(), request.message);
+            } catch (const DBException& ex) {
+                _stats->errors.addAndFetch(1);
+                LOG(1) << "Replayed request failed: " << redact(ex);
+            }
+        }
+    }
+
+    void _send(DBClientBase* conn, Message& message) {
+        if (message.operation() != dbMsg) {
+            _stats->requests.addAndFetch(1);
+            if (message.operation() == dbQuery || message.operation() == dbGetMore) {
+                Message response;
+                uassert(ErrorCodes::HostUnreachable,
+                        "failed to receive a response",
+                        conn->call(message, response, false));
+            } else {
+                conn->say(message);
+            }
+            return;
+        }
+
+        const bool moreToCome = OpMsg::isFlagSet(message, OpMsg::kMoreToCome);
+        auto request = OpMsgRequest::parse(message);
+        if (isSkippedCommand(request.getCommandName())) {
+            _stats->skipped.addAndFetch(1);
+            return;
+        }
+
+        // The target cannot validate the signature of the recorded cluster time.
+        request.body = request.body.removeField("$clusterTime");
+
+        _stats->requests.addAndFetch(1);
+        if (moreToCome) {
+            auto toSend = request.serialize();
+            OpMsg::setFlag(&toSend, OpMsg::kMoreToCome);
+            conn->say(toSend);
+            return;
+        }
+
+        auto reply = conn->runCommand(std::move(request));
+        uassertStatusOK(getStatusFromCommandResult(reply->getCommandReply()));
+    }
+
+    const MongoURI _uri;
+    ReplayStats* const _stats;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condition;
+    std::deque<Request> _requests;
+    bool _closed = false;
+
+    stdx::thread _thread;
+};
+
+}  // namespace
+
+BSONObj replayTrafficRecording(int inputFd, const TrafficReplayOptions& options) {
+    uassert(ErrorCodes::BadValue, "The replay speed must be positive", options.speed > 0);
+    const auto uri = uassertStatusOK(MongoURI::parse(options.uri));
+
+    ReplayStats stats;
+    stdx::unordered_map<uint64_t, std::unique_ptr<ReplaySession>> sessions;
+
+    TrafficRecordingReader reader(inputFd);
+    boost::optional<Date_t> recordingStart;
+    const auto replayStart = ReplayClock::now();
+    while (auto packet = reader.next()) {
+        // Only the requests are replayed; the responses are sent by the target.
+        if (packet->message.getResponseToMsgId() != 0) {
+            continue;
+        }
+
+        if (!recordingStart) {
+            recordingStart = packet->date;
+        }
+        const auto recordedOffset = durationCount<Microseconds>(packet->date - *recordingStart);
+        const auto sendAt = replayStart +
+            stdx::chrono::microseconds(static_cast<long long>(recordedOffset / options.speed));
+        stdx::this_thread::sleep_until(sendAt - kReadAhead.toSystemDuration());
+
+        const auto length = packet->message.getLen();
+        auto buf = SharedBuffer::allocate(length);
+        std::memcpy(buf.get(), packet->message.view2ptr(), length);
+
+        auto& session = sessions[packet->id];
+        if (!session) {
+            session = stdx::make_unique<ReplaySession>(uri, &stats);
+        }
+        session->push(Message(std::move(buf)), sendAt);
+    }
+
+    // Wait for every session to send its remaining requests.
+    const auto numSessions = static_cast<long long>(sessions.size());
+    sessions.clear();
+
+    BSONObjBuilder builder;
+    builder.append("sessions", numSessions);
+    builder.append("requests", stats.requests.load());
+    builder.append("errors", stats.errors.load());
+    builder.append("skipped", stats.skipped.load());
+    builder.append("maxLagMicros", stats.maxLagMicros.load());
+    return builder.obj();
+}
+
+}  // namespace mongo
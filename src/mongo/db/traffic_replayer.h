@@ -0,0 +1,63 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+struct TrafficReplayOptions {
+    // Connection string of the server the recording is replayed against.
+    std::string uri;
+
+    // Rate at which recorded time passes during the replay. 2.0 replays twice as fast as the
+    // traffic was recorded.
+    double speed = 1.0;
+};
+
+/**
+ * Replays the requests of the traffic recording read from 'inputFd' against the server described
+ * by 'options'.
+ *
+ * Each recorded session is replayed on its own connection by its own thread, so the replay has
+ * the concurrency of the recording. Every request is sent at the offset from the start of the
+ * replay at which it was received from the start of the recording, scaled by the speed, or as soon
+ * as the previous request of its session completes if that is later. Responses are read and
+ * discarded. Authentication commands are skipped; the connections authenticate with the
+ * credentials of the connection string instead.
+ *
+ * Returns statistics about the replay: the number of sessions, of requests sent, of requests which
+ * failed and of requests skipped, and by how much requests were sent late at most.
+ */
+BSONObj replayTrafficRecording(int inputFd, const TrafficReplayOptions& options);
+
+}  // namespace mongo
@@ -1022,15 +1022,15 @@ Timestamp TransactionParticipant::Participant::prepareTransaction(
 }
 
 void TransactionParticipant::Participant::addTransactionOperation(
-    OperationContext* opCtx, const repl::ReplOperation& operation) {
+    OperationContext* opCtx, repl::ReplOperation operation) {
 
     // Ensure that we only ever add operations to an in progress transaction.
     invariant(o().txnState.isInProgress(), str::stream() << "Current state: " << o().txnState);
 
     invariant(p().autoCommit && !*p().autoCommit && o().activeTxnNumber != kUninitializedTxnNumber);
     invariant(opCtx->lockState()->inAWriteUnitOfWork());
-    p().transactionOperations.push_back(operation);
     p().transactionOperationBytes += repl::OplogEntry::getReplOperationSize(operation);
+    p().transactionOperations.push_back(std::move(operation));
     // _transactionOperationBytes is based on the in-memory size of the operation.  With overhead,
     // we expect the BSON size of the operation to be larger, so it's possible to make a transaction
     // just a bit too large and have it fail only in the commit.  It's still useful to fail early
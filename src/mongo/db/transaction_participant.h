@@ -470,9 +470,10 @@ public:
         /**
          * Adds a stored operation to the list of stored operations for the current multi-document
          * (non-autocommit) transaction.  It is illegal to add operations when no multi-document
-         * transaction is in progress.
+         * transaction is in progress. The operation is moved into the list, so callers that no
+         * longer need it should pass an rvalue.
          */
-        void addTransactionOperation(OperationContext* opCtx, const repl::ReplOperation& operation);
+        void addTransactionOperation(OperationContext* opCtx, repl::ReplOperation operation);
 
         /**
          * Returns a reference to the stored operations for a completed multi-document
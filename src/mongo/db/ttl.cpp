@@ -33,6 +33,8 @@
 
 #include "mongo/db/ttl.h"
 
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -43,6 +45,7 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -56,6 +59,7 @@
 #include "mongo/db/ttl_gen.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
@@ -68,6 +72,89 @@ ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
 
+namespace {
+
+/**
+ * Tracks how far behind the expiry of its documents the TTL monitor is on each TTL index.
+ */
+class TTLIndexStats {
+public:
+    /**
+     * Records a pass over the index 'name' of 'nss' that deleted 'numDeleted' documents, and, if
+     * it was not cut short, every document that had expired as of 'caughtUpAsOf'.
+     */
+    void recordPass(const NamespaceString& nss,
+                    const std::string& name,
+                    long long numDeleted,
+                    boost::optional<Date_t> caughtUpAsOf) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto& stats = _indexes[{nss.ns(), name}];
+        stats.deletedLastPass = numDeleted;
+        stats.lastPass = Date_t::now();
+        if (caughtUpAsOf) {
+            stats.caughtUpAsOf = *caughtUpAsOf;
+        }
+    }
+
+    /**
+     * Forgets the indexes that have not been visited since 'passStart'.
+     */
+    void removeIndexesNotVisitedSince(Date_t passStart) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto it = _indexes.begin(); it != _indexes.end();) {
+            it = it->second.lastPass < passStart ? _indexes.erase(it) : std::next(it);
+        }
+    }
+
+    /**
+     * Appends, for every index, the number of documents its last pass deleted and, once a pass
+     * was not cut short, the number of seconds since the last time it had no expired documents.
+     */
+    void append(BSONObjBuilder* builder) const {
+        const auto now = Date_t::now();
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        BSONArrayBuilder indexes(builder->subarrayStart("indexes"));
+        for (auto&& entry : _indexes) {
+            BSONObjBuilder index(indexes.subobjStart());
+            index.append("ns", entry.first.first);
+            index.append("name", entry.first.second);
+            index.append("deletedLastPass", entry.second.deletedLastPass);
+            if (entry.second.caughtUpAsOf) {
+                index.append("lagSecs",
+                             durationCount<Seconds>(now - *entry.second.caughtUpAsOf));
+            }
+        }
+    }
+
+private:
+    struct Stats {
+        long long deletedLastPass = 0;
+        Date_t lastPass;
+        boost::optional<Date_t> caughtUpAsOf;
+    };
+
+    mutable stdx::mutex _mutex;
+    std::map<std::pair<std::string, std::string>, Stats> _indexes;
+} ttlIndexStats;
+
+class TTLServerStatusSection final : public ServerStatusSection {
+public:
+    TTLServerStatusSection() : ServerStatusSection("ttl") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        ttlIndexStats.append(&builder);
+        return builder.obj();
+    }
+} ttlServerStatusSection;
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -83,11 +170,26 @@ public:
         ThreadClient tc(name(), getGlobalServiceContext());
         AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
 
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitorWorkers";
+        options.threadNamePrefix = "TTLMonitorWorker-";
+        options.minThreads = 0;
+        options.maxThreads = static_cast<size_t>(ttlMonitorWorkerThreads);
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName);
+            AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+        };
+        _workers = stdx::make_unique<ThreadPool>(options);
+        _workers->startup();
+
+        // Set when the last pass left expired documents behind, so the next one starts right away.
+        bool behind = false;
         while (!globalInShutdownDeprecated()) {
-            {
+            if (!behind) {
                 MONGO_IDLE_THREAD_BLOCK;
                 sleepsecs(ttlMonitorSleepSecs.load());
             }
+            behind = false;
 
             LOG(3) << "thread awake";
 
@@ -104,7 +206,7 @@ public:
             }
 
             try {
-                doTTLPass();
+                behind = doTTLPass();
             } catch (const WriteConflictException&) {
                 LOG(1) << "got WriteConflictException";
             }
@@ -112,7 +214,11 @@ public:
     }
 
 private:
-    void doTTLPass() {
+    /**
+     * Deletes the expired documents of every TTL index, spreading the indexes over the worker
+     * threads. Returns true if the deletion was cut short on any index.
+     */
+    bool doTTLPass() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -120,13 +226,14 @@ private:
         if (repl::ReplicationCoordinator::get(&opCtx)->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::ReplicationCoordinator::get(&opCtx)->getMemberState().readable())
-            return;
+            return false;
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
         std::vector<BSONObj> ttlIndexes;
 
         ttlPasses.increment();
+        const Date_t passStart = Date_t::now();
 
         // Get all TTL indexes from every collection.
         for (const std::string& collectionNS : ttlCollections) {
@@ -150,37 +257,48 @@ private:
             }
         }
 
+        AtomicWord<bool> cutShort{false};
         for (const BSONObj& idx : ttlIndexes) {
-            try {
-                doTTLForIndex(&opCtx, idx);
-            } catch (const DBException& dbex) {
-                error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                // Continue on to the next index.
-                continue;
-            }
+            // The pool is only shut down once this thread exits, so it always accepts work.
+            invariant(_workers->schedule([this, idx, &cutShort] {
+                const ServiceContext::UniqueOperationContext workerOpCtx =
+                    cc().makeOperationContext();
+                try {
+                    if (!doTTLForIndex(workerOpCtx.get(), idx)) {
+                        cutShort.store(true);
+                    }
+                } catch (const DBException& dbex) {
+                    error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
+                }
+            }));
         }
+        _workers->waitForIdle();
+
+        ttlIndexStats.removeIndexesNotVisitedSince(passStart);
+        return cutShort.load();
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
-     * of time has passed according to its expiry specification.
+     * of time has passed according to its expiry specification. Returns false if the deletion ran
+     * out of time before it removed every expired document.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    bool doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (collectionNSS.isDropPendingNamespace()) {
-            return;
+            return true;
         }
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             error() << "namespace '" << collectionNSS
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return;
+            return true;
         }
 
         const BSONObj key = idx["key"].Obj();
         const StringData name = idx["name"].valueStringData();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return;
+            return true;
         }
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
@@ -189,18 +307,18 @@ private:
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return true;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return true;
         }
 
         const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return;
+            return true;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
@@ -209,7 +327,7 @@ private:
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return true;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -217,12 +335,13 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return true;
         }
 
         const Date_t kDawnOfTime =
             Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
+        const Date_t now = Date_t::now();
+        const Date_t expirationTime = now - Seconds(secondsExpireElt.numberLong());
         const BSONObj startKey = BSON("" << kDawnOfTime);
         const BSONObj endKey = BSON("" << expirationTime);
         // The canonical check as to whether a key pattern element is "ascending" or
@@ -257,17 +376,32 @@ private:
                                                  PlanExecutor::YIELD_AUTO,
                                                  direction);
 
+        // Only limit the time spent deleting, not the time spent waiting for the collection lock.
+        const int maxMillis = ttlIndexPassMaxMillis.load();
+        if (maxMillis > 0) {
+            opCtx->setDeadlineAfterNowBy(Milliseconds(maxMillis), ErrorCodes::ExceededTimeLimit);
+        }
+
         Status result = exec->executePlan();
+        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
+        ttlDeletedDocuments.increment(numDeleted);
+        if (result == ErrorCodes::ExceededTimeLimit) {
+            LOG(1) << "deleted: " << numDeleted << " before running out of time";
+            ttlIndexStats.recordPass(collectionNSS, desc->indexName(), numDeleted, boost::none);
+            return false;
+        }
         if (!result.isOK()) {
             error() << "ttl query execution for index " << idx
                     << " failed with status: " << redact(result);
-            return;
+            return true;
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
         LOG(1) << "deleted: " << numDeleted;
+        ttlIndexStats.recordPass(collectionNSS, desc->indexName(), numDeleted, now);
+        return true;
     }
+
+    std::unique_ptr<ThreadPool> _workers;
 };
 
 namespace {
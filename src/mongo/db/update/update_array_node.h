@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <absl/container/flat_hash_map.h>
 #include <map>
 #include <string>
 #include <utility>
@@ -97,8 +98,8 @@ private:
 
     // When calling apply() causes us to merge elements of '_children', we store the result of the
     // merge in case we need it for another array element or document.
-    mutable stdx::unordered_map<UpdateNode*,
-                                stdx::unordered_map<UpdateNode*, clonable_ptr<UpdateNode>>>
+    mutable absl::flat_hash_map<UpdateNode*,
+                                absl::flat_hash_map<UpdateNode*, clonable_ptr<UpdateNode>>>
         _mergedChildrenCache;
 };
 
@@ -46,6 +46,7 @@
 #include "mongo/db/update/storage_validation.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/safe_num.h"
 #include "mongo/util/stringutils.h"
 
 namespace mongo {
@@ -187,6 +188,181 @@ void UpdateDriver::parse(
     auto root = stdx::make_unique<UpdateObjectNode>();
     _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
     _root = std::move(root);
+
+    if (arrayFilters.empty() && !_positional) {
+        compileTopLevelMods(updateExpr);
+    }
+}
+
+void UpdateDriver::compileTopLevelMods(const BSONObj& updateExpr) {
+    BSONObj ownedExpr = updateExpr.getOwned();
+    std::vector<TopLevelMod> mods;
+    for (auto&& mod : ownedExpr) {
+        if (mod.fieldNameStringData() == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+
+        auto modType = modifiertable::getType(mod.fieldName());
+        if (modType != modifiertable::MOD_SET && modType != modifiertable::MOD_INC) {
+            return;
+        }
+
+        // Since 'updateExpr' parsed, the field names are distinct and every $inc is numeric.
+        for (auto&& field : mod.Obj()) {
+            auto fieldName = field.fieldNameStringData();
+            if (fieldName.empty() || fieldName[0] == '$' ||
+                fieldName.find('.') != std::string::npos || fieldName == "_id"_sd) {
+                return;
+            }
+            if (modType == modifiertable::MOD_SET &&
+                (field.type() == BSONType::Object || field.type() == BSONType::Array)) {
+                return;
+            }
+            mods.push_back({modType, fieldName, field});
+        }
+    }
+
+    // The UpdateNode tree applies the modifiers in field name order.
+    std::sort(mods.begin(), mods.end(), [](const TopLevelMod& lhs, const TopLevelMod& rhs) {
+        return lhs.fieldName < rhs.fieldName;
+    });
+    _topLevelModsExpr = std::move(ownedExpr);
+    _topLevelMods = std::move(mods);
+}
+
+boost::optional<BSONObj> UpdateDriver::applyToBSON(const BSONObj& original,
+                                                   const FieldRefSet& immutablePaths,
+                                                   BSONObj* logOpRec,
+                                                   bool* docWasModified) {
+    invariant(canApplyToBSON());
+
+    for (auto&& mod : _topLevelMods) {
+        FieldRef path(mod.fieldName);
+        if (immutablePaths.findConflicts(&path, nullptr)) {
+            return boost::none;
+        }
+    }
+
+    const auto findMod = [this](StringData fieldName) -> int {
+        auto it = std::lower_bound(
+            _topLevelMods.begin(),
+            _topLevelMods.end(),
+            fieldName,
+            [](const TopLevelMod& mod, StringData name) { return mod.fieldName < name; });
+        return (it != _topLevelMods.end() && it->fieldName == fieldName)
+            ? it - _topLevelMods.begin()
+            : -1;
+    };
+
+    // Like the UpdateNode tree, only the first of several fields with the same name is updated.
+    std::vector<BSONElement> existing(_topLevelMods.size());
+    for (auto&& elem : original) {
+        auto i = findMod(elem.fieldNameStringData());
+        if (i >= 0 && existing[i].eoo()) {
+            existing[i] = elem;
+        }
+    }
+
+    // Compute the new value of each modified field. The results of $inc are collected in
+    // 'incResults' and are bound to 'newValues' once it is built.
+    std::vector<BSONElement> newValues(_topLevelMods.size());
+    std::vector<size_t> incremented;
+    BSONObjBuilder incResults;
+    for (size_t i = 0; i < _topLevelMods.size(); ++i) {
+        const auto& mod = _topLevelMods[i];
+        if (mod.type == modifiertable::MOD_SET) {
+            if (!existing[i].eoo() && existing[i].binaryEqualValues(mod.value)) {
+                continue;
+            }
+            newValues[i] = mod.value;
+            continue;
+        }
+
+        SafeNum valueToSet = mod.value;
+        if (!existing[i].eoo()) {
+            auto idElem = original["_id"];
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "Cannot apply $inc to a value of non-numeric type. {"
+                                  << (idElem ? idElem.toString() : "no id")
+                                  << "} has the field '"
+                                  << mod.fieldName
+                                  << "' of non-numeric type "
+                                  << typeName(existing[i].type()),
+                    existing[i].isNumber());
+
+            SafeNum originalValue = existing[i];
+            valueToSet += originalValue;
+            if (valueToSet.isIdentical(originalValue)) {
+                continue;
+            }
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Failed to apply $inc operations to current value ("
+                                  << originalValue.debugString()
+                                  << ") for document {"
+                                  << (idElem ? idElem.toString() : "no id")
+                                  << "}",
+                    valueToSet.isValid());
+        }
+        valueToSet.toBSON(mod.fieldName, &incResults);
+        incremented.push_back(i);
+    }
+    const BSONObj incResultsObj = incResults.done();
+    auto incResult = incResultsObj.begin();
+    for (auto i : incremented) {
+        newValues[i] = *incResult;
+        ++incResult;
+    }
+
+    _affectIndices = false;
+    bool modified = false;
+    for (size_t i = 0; i < _topLevelMods.size(); ++i) {
+        if (newValues[i].eoo()) {
+            continue;
+        }
+        modified = true;
+        if (_indexedFields &&
+            _indexedFields->mightBeIndexed(FieldRef(_topLevelMods[i].fieldName))) {
+            _affectIndices = true;
+        }
+    }
+
+    if (docWasModified) {
+        *docWasModified = modified;
+    }
+
+    if (_logOp && logOpRec) {
+        _logDoc.reset();
+        LogBuilder logBuilder(_logDoc.root());
+        for (size_t i = 0; i < _topLevelMods.size(); ++i) {
+            if (!newValues[i].eoo()) {
+                uassertStatusOK(
+                    logBuilder.addToSetsWithNewFieldName(_topLevelMods[i].fieldName, newValues[i]));
+            }
+        }
+        invariant(logBuilder.setUpdateSemantics(UpdateSemantics::kUpdateNode));
+        *logOpRec = _logDoc.getObject();
+    }
+
+    if (!modified) {
+        return original;
+    }
+
+    // Existing fields are replaced where they are, new fields are appended in field name order.
+    BSONObjBuilder bob(original.objsize() + incResultsObj.objsize());
+    for (auto&& elem : original) {
+        auto i = findMod(elem.fieldNameStringData());
+        if (i >= 0 && !newValues[i].eoo() && existing[i].rawdata() == elem.rawdata()) {
+            bob.appendAs(newValues[i], elem.fieldNameStringData());
+        } else {
+            bob.append(elem);
+        }
+    }
+    for (size_t i = 0; i < _topLevelMods.size(); ++i) {
+        if (existing[i].eoo() && !newValues[i].eoo()) {
+            bob.appendAs(newValues[i], _topLevelMods[i].fieldName);
+        }
+    }
+    return bob.obj();
 }
 
 Status UpdateDriver::populateDocumentWithQueryFields(OperationContext* opCtx,
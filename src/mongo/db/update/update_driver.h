@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <string>
 #include <vector>
 
@@ -115,6 +116,28 @@ public:
                   bool* docWasModified = nullptr,
                   FieldRefSetWithStorage* modifiedPaths = nullptr);
 
+    /**
+     * Returns true if the update only consists of $set and $inc modifiers over distinct top-level
+     * fields other than _id, and none of the $set values is an object or an array. Such updates can
+     * be applied by applyToBSON() without going through a mutablebson::Document.
+     */
+    bool canApplyToBSON() const {
+        return !_topLevelMods.empty();
+    }
+
+    /**
+     * Applies an update for which canApplyToBSON() is true to 'original' and returns the resulting
+     * document. Modified fields keep their position and new fields are appended in field name
+     * order, as update() would produce them. Returns boost::none, without applying anything, if a
+     * modified field is in 'immutablePaths'; such updates must be applied by update() instead.
+     *
+     * 'logOpRec' and 'docWasModified' are filled in as by update().
+     */
+    boost::optional<BSONObj> applyToBSON(const BSONObj& original,
+                                         const FieldRefSet& immutablePaths,
+                                         BSONObj* logOpRec = nullptr,
+                                         bool* docWasModified = nullptr);
+
     //
     // Accessors
     //
@@ -160,9 +183,22 @@ public:
     void setCollator(const CollatorInterface* collator);
 
 private:
+    // A $set or $inc of a top-level field. See canApplyToBSON().
+    struct TopLevelMod {
+        modifiertable::ModifierType type;
+        StringData fieldName;
+        BSONElement value;
+    };
+
     /** Create the modifier and add it to the back of the modifiers vector */
     inline Status addAndParse(const modifiertable::ModifierType type, const BSONElement& elem);
 
+    /**
+     * Fills in '_topLevelMods' if the successfully parsed 'updateExpr' qualifies for
+     * applyToBSON(), and leaves it empty otherwise.
+     */
+    void compileTopLevelMods(const BSONObj& updateExpr);
+
     //
     // immutable properties after parsing
     //
@@ -174,6 +210,11 @@ private:
     // The root of the UpdateNode tree.
     std::unique_ptr<UpdateNode> _root;
 
+    // The modifiers of an update that applyToBSON() can apply, sorted by field name. Their field
+    // names and values point into '_topLevelModsExpr', an owned copy of the update expression.
+    std::vector<TopLevelMod> _topLevelMods;
+    BSONObj _topLevelModsExpr;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
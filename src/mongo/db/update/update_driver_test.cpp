@@ -165,6 +165,91 @@ TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     ASSERT_TRUE(modified);
 }
 
+// Applies 'updateExpr' to 'doc' with both update() and applyToBSON(), and checks that they agree.
+void assertApplyToBSONMatchesUpdate(const char* updateExpr, const char* doc) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    driver.setLogOp(true);
+    driver.parse(fromjson(updateExpr), arrayFilters);
+    ASSERT_TRUE(driver.canApplyToBSON());
+
+    const bool validateForStorage = true;
+    const FieldRefSet emptyImmutablePaths;
+    const bool isInsert = false;
+    mutablebson::Document mutableDoc(fromjson(doc));
+    BSONObj logObj;
+    bool modified = false;
+    ASSERT_OK(driver.update(StringData(),
+                            &mutableDoc,
+                            validateForStorage,
+                            emptyImmutablePaths,
+                            isInsert,
+                            &logObj,
+                            &modified));
+
+    BSONObj directLogObj;
+    bool directModified = false;
+    auto directObj =
+        driver.applyToBSON(fromjson(doc), emptyImmutablePaths, &directLogObj, &directModified);
+    ASSERT_TRUE(directObj);
+    ASSERT_TRUE(mutableDoc.getObject().binaryEqual(*directObj));
+    ASSERT_TRUE(logObj.binaryEqual(directLogObj));
+    ASSERT_EQ(modified, directModified);
+}
+
+TEST(ApplyToBSON, MatchesUpdate) {
+    assertApplyToBSONMatchesUpdate("{$set: {a: 5}}", "{_id: 1, a: 1, b: 2}");
+    assertApplyToBSONMatchesUpdate("{$set: {a: 'abc'}}", "{_id: 1, a: 1, b: 2}");
+    assertApplyToBSONMatchesUpdate("{$set: {c: 'x', a: 1}, $inc: {d: 1, b: 2}}",
+                                   "{_id: 1, a: 1, b: 2}");
+    assertApplyToBSONMatchesUpdate("{$inc: {a: 2147483647}}", "{_id: 1, a: 1}");
+    assertApplyToBSONMatchesUpdate("{$inc: {a: 1.5}}", "{_id: 1, a: NumberLong(1)}");
+    assertApplyToBSONMatchesUpdate("{$inc: {a: 0}}", "{_id: 1, a: 1}");
+    assertApplyToBSONMatchesUpdate("{$set: {a: 1}}", "{_id: 1, a: 1}");
+    assertApplyToBSONMatchesUpdate("{$set: {a: 1}}", "{_id: 1, a: 2, a: 3}");
+}
+
+TEST(ApplyToBSON, OnlyTopLevelSetAndInc) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    for (auto&& updateExpr : {"{$set: {'a.b': 1}}",
+                              "{$set: {a: {b: 1}}}",
+                              "{$set: {a: [1]}}",
+                              "{$set: {_id: 1}}",
+                              "{$push: {a: 1}}",
+                              "{$inc: {a: 1}, $unset: {b: 1}}",
+                              "{a: 1}"}) {
+        UpdateDriver driver(expCtx);
+        driver.parse(fromjson(updateExpr), arrayFilters);
+        ASSERT_FALSE(driver.canApplyToBSON()) << updateExpr;
+    }
+}
+
+TEST(ApplyToBSON, DefersImmutableFieldsToUpdate) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    driver.parse(fromjson("{$set: {a: 1, b: 1}}"), arrayFilters);
+
+    FieldRefSet immutablePaths;
+    FieldRef immutablePath("a.c");
+    immutablePaths.insert(&immutablePath);
+    ASSERT_FALSE(driver.applyToBSON(fromjson("{_id: 1}"), immutablePaths));
+}
+
+TEST(ApplyToBSON, IncOfNonNumericFieldFails) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    UpdateDriver driver(expCtx);
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    driver.parse(fromjson("{$inc: {a: 1}}"), arrayFilters);
+
+    const FieldRefSet emptyImmutablePaths;
+    ASSERT_THROWS_CODE(driver.applyToBSON(fromjson("{_id: 1, a: 'abc'}"), emptyImmutablePaths),
+                       AssertionException,
+                       ErrorCodes::TypeMismatch);
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
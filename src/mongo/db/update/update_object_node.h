@@ -40,7 +40,7 @@
 #include "mongo/db/update/modifier_table.h"
 #include "mongo/db/update/update_internal_node.h"
 #include "mongo/stdx/memory.h"
-#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -127,7 +127,7 @@ private:
 
     // When calling apply() causes us to merge an element of '_children' with '_positionalChild', we
     // store the result of the merge in case we need it in a future call to apply().
-    mutable stdx::unordered_map<std::string, clonable_ptr<UpdateNode>> _mergedChildrenCache;
+    mutable StringMap<clonable_ptr<UpdateNode>> _mergedChildrenCache;
 };
 
 }  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/wait_event.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/tsc_tick_source.h"
+
+namespace mongo {
+namespace {
+
+const auto getWaitEventStats = OperationContext::declareDecoration<WaitEventStats>();
+
+}  // namespace
+
+StringData toString(WaitEvent event) {
+    switch (event) {
+        case WaitEvent::kLock:
+            return "lock"_sd;
+        case WaitEvent::kTicket:
+            return "ticket"_sd;
+        case WaitEvent::kPrepareConflict:
+            return "prepareConflict"_sd;
+        case WaitEvent::kOplogVisibility:
+            return "oplogVisibility"_sd;
+        case WaitEvent::kWriteConcern:
+            return "writeConcern"_sd;
+        case WaitEvent::kNumWaitEvents:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+WaitEventStats& WaitEventStats::get(OperationContext* opCtx) {
+    return getWaitEventStats(opCtx);
+}
+
+WaitEventStats& WaitEventStats::global() {
+    static WaitEventStats globalStats;
+    return globalStats;
+}
+
+void WaitEventStats::record(WaitEvent event, Microseconds waitTime) {
+    auto& counters = _counters[static_cast<std::size_t>(event)];
+    counters.count.fetchAndAddRelaxed(1);
+    counters.micros.fetchAndAddRelaxed(durationCount<Microseconds>(waitTime));
+}
+
+bool WaitEventStats::empty() const {
+    return std::all_of(_counters.begin(), _counters.end(), [](const Counters& counters) {
+        return counters.count.loadRelaxed() == 0;
+    });
+}
+
+BSONObj WaitEventStats::toBSON() const {
+    BSONObjBuilder builder;
+    for (std::size_t i = 0; i < _counters.size(); ++i) {
+        const auto count = _counters[i].count.loadRelaxed();
+        if (count == 0)
+            continue;
+        BSONObjBuilder eventBuilder(builder.subobjStart(toString(static_cast<WaitEvent>(i))));
+        eventBuilder.append("count", count);
+        eventBuilder.append("micros", _counters[i].micros.loadRelaxed());
+    }
+    return builder.obj();
+}
+
+WaitEventGuard::WaitEventGuard(OperationContext* opCtx, WaitEvent event)
+    : _opCtx(opCtx),
+      _event(event),
+      _tickSource(TscTickSource::get()),
+      _start(_tickSource->getTicks()) {}
+
+WaitEventGuard::~WaitEventGuard() {
+    const auto waitTime = _tickSource->ticksTo<Microseconds>(
+        std::max<TickSource::Tick>(_tickSource->getTicks() - _start, 0));
+    WaitEventStats::global().record(_event, waitTime);
+    if (_opCtx)
+        WaitEventStats::get(_opCtx).record(_event, waitTime);
+}
+
+}  // namespace mongo
@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * The places where an operation can block, reported as wait events.
+ */
+enum class WaitEvent {
+    kLock,             // Acquiring a lock from the lock manager.
+    kTicket,           // Acquiring a storage engine read or write ticket.
+    kPrepareConflict,  // Reading a document written by a prepared transaction.
+    kOplogVisibility,  // Waiting for earlier oplog writes to become visible.
+    kWriteConcern,     // Waiting for writes to replicate to satisfy a write concern.
+    kNumWaitEvents
+};
+
+StringData toString(WaitEvent event);
+
+/**
+ * Counts of waits and the time spent waiting, by wait event. Each operation has its own
+ * WaitEventStats, and all waits are also added to a global WaitEventStats.
+ *
+ * Waits are recorded by the thread running the operation, but the stats may be read
+ * concurrently, e.g. by $currentOp.
+ */
+class WaitEventStats {
+    MONGO_DISALLOW_COPYING(WaitEventStats);
+
+public:
+    WaitEventStats() = default;
+
+    static WaitEventStats& get(OperationContext* opCtx);
+    static WaitEventStats& global();
+
+    void record(WaitEvent event, Microseconds waitTime);
+
+    bool empty() const;
+
+    /**
+     * Returns an object with a {count: <waits>, micros: <time waiting>} field for each wait event
+     * that occurred, or an empty object if none did.
+     */
+    BSONObj toBSON() const;
+
+private:
+    struct Counters {
+        AtomicWord<long long> count{0};
+        AtomicWord<long long> micros{0};
+    };
+
+    std::array<Counters, static_cast<std::size_t>(WaitEvent::kNumWaitEvents)> _counters;
+};
+
+/**
+ * Records a wait event for the time between its construction and destruction, to the
+ * operation's and the global stats. Place one in front of each blocking call, past any fast path
+ * that does not block. 'opCtx' may be null, in which case only the global stats are updated.
+ */
+class WaitEventGuard {
+    MONGO_DISALLOW_COPYING(WaitEventGuard);
+
+public:
+    WaitEventGuard(OperationContext* opCtx, WaitEvent event);
+    ~WaitEventGuard();
+
+private:
+    OperationContext* const _opCtx;
+    const WaitEvent _event;
+    TickSource* const _tickSource;
+    const TickSource::Tick _start;
+};
+
+}  // namespace mongo
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/wait_event.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using WaitEventTest = ServiceContextTest;
+
+TEST(WaitEventStatsTest, ReportsOnlyEventsThatOccurred) {
+    WaitEventStats stats;
+    ASSERT_TRUE(stats.empty());
+    ASSERT_BSONOBJ_EQ(stats.toBSON(), BSONObj());
+
+    stats.record(WaitEvent::kTicket, Microseconds{10});
+    stats.record(WaitEvent::kTicket, Microseconds{5});
+    stats.record(WaitEvent::kWriteConcern, Microseconds{100});
+    ASSERT_FALSE(stats.empty());
+    ASSERT_BSONOBJ_EQ(stats.toBSON(),
+                      BSON("ticket" << BSON("count" << 2LL << "micros" << 15LL) << "writeConcern"
+                                    << BSON("count" << 1LL << "micros" << 100LL)));
+}
+
+TEST_F(WaitEventTest, GuardRecordsToOperationAndGlobalStats) {
+    auto opCtx = makeOperationContext();
+    auto globalLockWaits = [] {
+        return WaitEventStats::global().toBSON().getObjectField("lock")["count"].safeNumberLong();
+    };
+    const auto initialGlobalLockWaits = globalLockWaits();
+
+    {
+        WaitEventGuard guard(opCtx.get(), WaitEvent::kLock);
+    }
+    {
+        // Waits outside of an operation only count globally.
+        WaitEventGuard guard(nullptr, WaitEvent::kLock);
+    }
+
+    const auto opStats = WaitEventStats::get(opCtx.get()).toBSON();
+    ASSERT_EQ(opStats.nFields(), 1);
+    ASSERT_EQ(opStats.getObjectField("lock")["count"].numberLong(), 1);
+    ASSERT_EQ(globalLockWaits(), initialGlobalLockWaits + 2);
+}
+
+}  // namespace
+}  // namespace mongo
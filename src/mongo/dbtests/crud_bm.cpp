@@ -0,0 +1,416 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * End-to-end benchmarks of the core read and write paths of mongod. They run in process against a
+ * real storage engine, going through DBDirectClient and the mongod service entry point the way
+ * commands from clients do, and through SyncTail for oplog application.
+ *
+ * The storage engine is wiredTiger unless the MONGO_BENCHMARK_STORAGE_ENGINE environment variable
+ * names another one, e.g. "biggie". Each benchmark runs with 1 to 16 threads; select a thread count
+ * with --benchmark_filter, e.g. --benchmark_filter=BM_FindById/threads:8. Besides the time per
+ * operation, every benchmark reports operations per second ("items_per_second") and the median
+ * and 99th percentile latencies in microseconds, averaged over the threads.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <vector>
+
+#include "mongo/db/catalog/database_holder_impl.h"
+#include "mongo/db/catalog/uuid_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/index_builds_coordinator_mongod.h"
+#include "mongo/db/logical_clock.h"
+#include "mongo/db/op_observer_impl.h"
+#include "mongo/db/op_observer_registry.h"
+#include "mongo/db/repl/drop_pending_collection_reaper.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/replication_consistency_markers_mock.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/repl/sync_tail.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_entry_point_mongod.h"
+#include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/periodic_runner_factory.h"
+
+namespace mongo {
+namespace {
+
+const StringData kDefaultStorageEngine = "wiredTiger"_sd;
+const auto kDbName = "crud_bm"_sd;
+
+// Number of documents the read benchmarks run against.
+constexpr int kNumDocuments = 10000;
+
+// Number of distinct group keys for the $group benchmark.
+constexpr int kNumGroups = 100;
+
+// Number of documents each range scan returns.
+constexpr int kRangeScanLength = 100;
+
+// Number of inserts in each batch of oplog entries applied.
+constexpr int kOplogBatchSize = 100;
+
+constexpr int kMaxThreads = 16;
+
+/**
+ * A mongod ServiceContext with a storage engine in a temporary directory, set up as the primary of
+ * a single node replica set, so that writes are logged to the oplog.
+ */
+class BenchmarkEnvironment {
+    MONGO_DISALLOW_COPYING(BenchmarkEnvironment);
+
+public:
+    static BenchmarkEnvironment& get() {
+        static BenchmarkEnvironment environment;
+        return environment;
+    }
+
+    ~BenchmarkEnvironment() {
+        {
+            ThreadClient tc("crud_bm_shutdown", _service);
+            auto opCtx = cc().makeOperationContext();
+            Lock::GlobalLock lk(opCtx.get(), MODE_X);
+            DatabaseHolder::get(opCtx.get())->closeAll(opCtx.get());
+        }
+        IndexBuildsCoordinator::get(_service)->shutdown();
+        shutdownGlobalStorageEngineCleanly(_service);
+        _service->getPeriodicRunner()->shutdown();
+        boost::filesystem::remove_all(_dbpath);
+    }
+
+    ServiceContext* getServiceContext() const {
+        return _service;
+    }
+
+    repl::StorageInterface* getStorageInterface() const {
+        return _storageInterface.get();
+    }
+
+    repl::ReplicationConsistencyMarkers* getConsistencyMarkers() const {
+        return _consistencyMarkers.get();
+    }
+
+private:
+    BenchmarkEnvironment()
+        : _service(getGlobalServiceContext()),
+          _dbpath(boost::filesystem::temp_directory_path() /
+                  boost::filesystem::unique_path("crud_bm-%%%%-%%%%-%%%%")),
+          _storageInterface(std::make_unique<repl::StorageInterfaceImpl>()),
+          _consistencyMarkers(std::make_unique<repl::ReplicationConsistencyMarkersMock>()) {
+        serverGlobalParams.featureCompatibility.setVersion(
+            ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42);
+
+        _service->setServiceEntryPoint(std::make_unique<ServiceEntryPointMongod>(_service));
+        LogicalClock::set(_service, std::make_unique<LogicalClock>(_service));
+        repl::ReplicationCoordinator::set(
+            _service,
+            std::make_unique<repl::ReplicationCoordinatorMock>(_service, _storageInterface.get()));
+        uassertStatusOK(repl::ReplicationCoordinator::get(_service)->setFollowerMode(
+            repl::MemberState::RS_PRIMARY));
+
+        auto runner = makePeriodicRunner(_service);
+        runner->startup();
+        _service->setPeriodicRunner(std::move(runner));
+
+        const char* engine = std::getenv("MONGO_BENCHMARK_STORAGE_ENGINE");
+        storageGlobalParams.engine = engine ? engine : kDefaultStorageEngine.toString();
+        storageGlobalParams.engineSetByUser = true;
+        boost::filesystem::create_directories(_dbpath);
+        storageGlobalParams.dbpath = _dbpath.string();
+        initializeStorageEngine(_service, StorageEngineInitFlags::kNone);
+
+        DatabaseHolder::set(_service, std::make_unique<DatabaseHolderImpl>());
+        IndexBuildsCoordinator::set(_service, std::make_unique<IndexBuildsCoordinatorMongod>());
+        repl::DropPendingCollectionReaper::set(
+            _service, std::make_unique<repl::DropPendingCollectionReaper>(_storageInterface.get()));
+
+        auto registry = std::make_unique<OpObserverRegistry>();
+        registry->addObserver(std::make_unique<OpObserverImpl>());
+        registry->addObserver(std::make_unique<UUIDCatalogObserver>());
+        _service->setOpObserver(std::move(registry));
+
+        ThreadClient tc("crud_bm_setup", _service);
+        auto opCtx = cc().makeOperationContext();
+        repl::setOplogCollectionName(_service);
+        repl::createOplog(opCtx.get());
+    }
+
+    ServiceContext* const _service;
+    const boost::filesystem::path _dbpath;
+    const std::unique_ptr<repl::StorageInterface> _storageInterface;
+    const std::unique_ptr<repl::ReplicationConsistencyMarkers> _consistencyMarkers;
+};
+
+/**
+ * Records the latency of each benchmark iteration on one thread and reports the median and 99th
+ * percentile, averaged over the threads.
+ */
+class LatencyRecorder {
+public:
+    void start() {
+        _start = stdx::chrono::steady_clock::now();
+    }
+
+    void stop() {
+        _latencies.push_back(stdx::chrono::steady_clock::now() - _start);
+    }
+
+    /**
+     * Reports the recorded latencies, and the iterations as the items processed.
+     */
+    void report(benchmark::State& state) {
+        state.SetItemsProcessed(state.iterations());
+        if (_latencies.empty())
+            return;
+        std::sort(_latencies.begin(), _latencies.end());
+        auto percentileMicros = [&](double p) {
+            const auto latency = _latencies[static_cast<size_t>(p * (_latencies.size() - 1))];
+            return stdx::chrono::duration<double, std::micro>(latency).count();
+        };
+        state.counters["p50_us"] =
+            benchmark::Counter(percentileMicros(0.50), benchmark::Counter::kAvgThreads);
+        state.counters["p99_us"] =
+            benchmark::Counter(percentileMicros(0.99), benchmark::Counter::kAvgThreads);
+    }
+
+private:
+    stdx::chrono::steady_clock::time_point _start;
+    std::vector<stdx::chrono::steady_clock::duration> _latencies;
+};
+
+std::string collectionName(StringData coll) {
+    return str::stream() << kDbName << "." << coll;
+}
+
+/**
+ * Recreates the collection 'ns' with 'numDocuments' documents {_id: i, x: i, g: i % kNumGroups},
+ * indexed on 'x'.
+ */
+void resetCollection(DBDirectClient& client, const std::string& ns, int numDocuments) {
+    client.dropCollection(ns);
+    client.createCollection(ns);
+    client.createIndex(ns, BSON("x" << 1));
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < numDocuments; ++i) {
+        docs.push_back(BSON("_id" << i << "x" << i << "g" << i % kNumGroups));
+        if (docs.size() == 1000 || i + 1 == numDocuments) {
+            client.insert(ns, docs);
+            docs.clear();
+        }
+    }
+}
+
+/**
+ * Runs 'op' once per iteration with a DBDirectClient on each thread, after the first thread has
+ * set up the collection for the benchmark with 'numDocuments' documents.
+ */
+template <typename Op>
+void runClientBenchmark(benchmark::State& state, StringData coll, int numDocuments, Op op) {
+    auto& environment = BenchmarkEnvironment::get();
+    ThreadClient tc("crud_bm", environment.getServiceContext());
+    auto opCtx = cc().makeOperationContext();
+    DBDirectClient client(opCtx.get());
+    const auto ns = collectionName(coll);
+    if (state.thread_index == 0) {
+        resetCollection(client, ns, numDocuments);
+    }
+
+    PseudoRandom random(state.thread_index);
+    LatencyRecorder latencies;
+    long long iteration = 0;
+    for (auto _ : state) {
+        latencies.start();
+        op(client, ns, random, iteration++);
+        latencies.stop();
+    }
+    latencies.report(state);
+}
+
+void BM_Insert(benchmark::State& state) {
+    // Each thread inserts its own range of _id values.
+    const long long firstId = static_cast<long long>(state.thread_index) << 40;
+    runClientBenchmark(
+        state,
+        "insert",
+        0,
+        [&](DBDirectClient& client, const std::string& ns, PseudoRandom&, long long i) {
+            client.insert(ns, BSON("_id" << firstId + i << "x" << i << "g" << i % kNumGroups));
+        });
+}
+
+void BM_FindById(benchmark::State& state) {
+    runClientBenchmark(
+        state,
+        "findById",
+        kNumDocuments,
+        [](DBDirectClient& client, const std::string& ns, PseudoRandom& random, long long) {
+            const auto doc = client.findOne(ns, QUERY("_id" << random.nextInt32(kNumDocuments)));
+            invariant(!doc.isEmpty());
+        });
+}
+
+void BM_IndexRangeScan(benchmark::State& state) {
+    runClientBenchmark(
+        state,
+        "indexRangeScan",
+        kNumDocuments,
+        [](DBDirectClient& client, const std::string& ns, PseudoRandom& random, long long) {
+            const int low = random.nextInt32(kNumDocuments - kRangeScanLength);
+            auto cursor = client.query(
+                NamespaceString(ns),
+                BSON("x" << BSON("$gte" << low << "$lt" << low + kRangeScanLength)));
+            int count = 0;
+            while (cursor->more()) {
+                cursor->next();
+                ++count;
+            }
+            invariant(count == kRangeScanLength);
+        });
+}
+
+void BM_Update(benchmark::State& state) {
+    runClientBenchmark(
+        state,
+        "update",
+        kNumDocuments,
+        [](DBDirectClient& client, const std::string& ns, PseudoRandom& random, long long) {
+            client.update(ns,
+                          QUERY("_id" << random.nextInt32(kNumDocuments)),
+                          BSON("$inc" << BSON("x" << 1)));
+        });
+}
+
+void BM_AggregateGroup(benchmark::State& state) {
+    runClientBenchmark(
+        state,
+        "aggregateGroup",
+        kNumDocuments,
+        [](DBDirectClient& client, const std::string& ns, PseudoRandom&, long long) {
+            BSONObj result;
+            const auto pipeline =
+                BSON_ARRAY(BSON("$group" << BSON("_id"
+                                                 << "$g"
+                                                 << "total"
+                                                 << BSON("$sum"
+                                                         << "$x"))));
+            invariant(client.runCommand(kDbName.toString(),
+                                        BSON("aggregate" << NamespaceString(ns).coll() << "pipeline"
+                                                         << pipeline
+                                                         << "cursor"
+                                                         << BSONObj()),
+                                        result));
+        });
+}
+
+/**
+ * Applies batches of kOplogBatchSize inserts through SyncTail, which spreads them over its writer
+ * threads the way secondaries do. The thread count is the number of writer threads.
+ */
+void BM_ApplyOplogBatch(benchmark::State& state) {
+    auto& environment = BenchmarkEnvironment::get();
+    ThreadClient tc("crud_bm", environment.getServiceContext());
+    auto opCtx = cc().makeOperationContext();
+    const NamespaceString nss(collectionName("applyOplogBatch"));
+    {
+        DBDirectClient client(opCtx.get());
+        resetCollection(client, nss.ns(), 0);
+    }
+
+    auto writerPool = repl::OplogApplier::makeWriterPool(state.range(0));
+    repl::SyncTail syncTail(nullptr,
+                            environment.getConsistencyMarkers(),
+                            environment.getStorageInterface(),
+                            repl::multiSyncApply,
+                            writerPool.get());
+
+    LatencyRecorder latencies;
+    long long nextId = 0;
+    for (auto _ : state) {
+        // Build the batch outside of the timed section. Its optimes follow the cluster time, like
+        // the optimes of the batches a secondary applies.
+        state.PauseTiming();
+        const auto firstTimestamp =
+            LogicalClock::get(opCtx.get())->reserveTicks(kOplogBatchSize).asTimestamp();
+        repl::MultiApplier::Operations ops;
+        for (int i = 0; i < kOplogBatchSize; ++i, ++nextId) {
+            const Timestamp timestamp(firstTimestamp.getSecs(), firstTimestamp.getInc() + i);
+            ops.emplace_back(repl::OpTime(timestamp, 1),                     // optime
+                             boost::none,                                    // hash
+                             repl::OpTypeEnum::kInsert,                      // opType
+                             nss,                                            // namespace
+                             boost::none,                                    // uuid
+                             boost::none,                                    // fromMigrate
+                             repl::OplogEntry::kOplogVersion,                // version
+                             BSON("_id" << nextId << "x" << nextId),         // o
+                             boost::none,                                    // o2
+                             OperationSessionInfo(),                         // sessionInfo
+                             boost::none,                                    // upsert
+                             Date_t::now(),                                  // wall clock time
+                             boost::none,                                    // statement id
+                             boost::none,   // optime of previous write within same transaction
+                             boost::none,   // pre-image optime
+                             boost::none);  // post-image optime
+        }
+        state.ResumeTiming();
+
+        latencies.start();
+        uassertStatusOK(syncTail.multiApply(opCtx.get(), std::move(ops)));
+        latencies.stop();
+    }
+    latencies.report(state);
+    state.SetItemsProcessed(state.iterations() * kOplogBatchSize);
+}
+
+BENCHMARK(BM_Insert)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_FindById)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_IndexRangeScan)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_Update)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_AggregateGroup)->ThreadRange(1, kMaxThreads);
+BENCHMARK(BM_ApplyOplogBatch)->RangeMultiplier(2)->Range(1, kMaxThreads);
+
+}  // namespace
+}  // namespace mongo
@@ -42,13 +42,16 @@
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_change_stream_fanout.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/dbtests/dbtests.h"
@@ -480,5 +483,141 @@ TEST_F(DocumentSourceCursorTest, NormalCursorShouldErrorAfterBeingKilled) {
     ASSERT_THROWS_CODE(cursor->getNext().isEOF(), AssertionException, ErrorCodes::QueryPlanKilled);
 }
 
+class ChangeStreamFanoutTest : public unittest::Test {
+public:
+    ChangeStreamFanoutTest()
+        : _ctx(new ExpressionContextForTest(_opCtx.get(), AggregationRequest(nss, {}))) {
+        _ctx->tailableMode = TailableModeEnum::kTailableAndAwaitData;
+        _mock = DocumentSourceMock::create();
+        auto pipeline = uassertStatusOK(Pipeline::create({_mock}, _ctx));
+        pipeline->detachFromOperationContext();
+        _fanout = std::make_shared<ChangeStreamFanout>(std::move(pipeline), Timestamp(1, 0), false);
+    }
+
+protected:
+    static Document makeEvent(Timestamp clusterTime) {
+        return Document{{"clusterTime", clusterTime}};
+    }
+
+    void addEvent(Timestamp clusterTime) {
+        _mock->queue.push_back(makeEvent(clusterTime));
+    }
+
+    ChangeStreamFanout::SubscriberId subscribe(Timestamp startFrom, bool startFromInclusive) {
+        auto id = _fanout->subscribe(startFrom, startFromInclusive);
+        ASSERT(id);
+        return *id;
+    }
+
+    boost::optional<DocumentSource::GetNextResult> getNext(ChangeStreamFanout::SubscriberId id) {
+        Timestamp latestOplogTimestamp;
+        return _fanout->getNext(_opCtx.get(), id, &latestOplogTimestamp);
+    }
+
+    void assertNextEvent(ChangeStreamFanout::SubscriberId id, Timestamp clusterTime) {
+        auto next = getNext(id);
+        ASSERT(next);
+        ASSERT(next->isAdvanced());
+        ASSERT_DOCUMENT_EQ(next->releaseDocument(), makeEvent(clusterTime));
+    }
+
+    void assertEOF(ChangeStreamFanout::SubscriberId id) {
+        auto next = getNext(id);
+        ASSERT(next);
+        ASSERT(next->isEOF());
+    }
+
+    const ServiceContext::UniqueOperationContext _opCtx = cc().makeOperationContext();
+    intrusive_ptr<ExpressionContextForTest> _ctx;
+    intrusive_ptr<DocumentSourceMock> _mock;
+    std::shared_ptr<ChangeStreamFanout> _fanout;
+};
+
+TEST_F(ChangeStreamFanoutTest, SubscribersShareEventsProducedOnce) {
+    auto first = subscribe(Timestamp(1, 0), false);
+    auto second = subscribe(Timestamp(1, 0), false);
+    addEvent(Timestamp(1, 1));
+    addEvent(Timestamp(1, 2));
+
+    assertNextEvent(first, Timestamp(1, 1));
+    assertNextEvent(first, Timestamp(1, 2));
+    ASSERT(_mock->queue.empty());
+    assertEOF(first);
+
+    assertNextEvent(second, Timestamp(1, 1));
+    assertNextEvent(second, Timestamp(1, 2));
+    assertEOF(second);
+
+    // Events which every subscriber has consumed are discarded before the pipeline runs again.
+    addEvent(Timestamp(1, 3));
+    assertNextEvent(second, Timestamp(1, 3));
+    ASSERT_EQ(_fanout->numBufferedEvents(), 1U);
+    assertNextEvent(first, Timestamp(1, 3));
+}
+
+TEST_F(ChangeStreamFanoutTest, SubscriberSkipsEventsBeforeItsStartingPoint) {
+    auto first = subscribe(Timestamp(1, 0), false);
+    auto inclusive = subscribe(Timestamp(1, 2), true);
+    auto exclusive = subscribe(Timestamp(1, 2), false);
+    addEvent(Timestamp(1, 1));
+    addEvent(Timestamp(1, 2));
+    addEvent(Timestamp(1, 3));
+
+    assertNextEvent(first, Timestamp(1, 1));
+    assertNextEvent(inclusive, Timestamp(1, 2));
+    assertNextEvent(inclusive, Timestamp(1, 3));
+    assertNextEvent(exclusive, Timestamp(1, 3));
+    assertEOF(exclusive);
+}
+
+TEST_F(ChangeStreamFanoutTest, LaggingSubscriberIsNoLongerServedOnceItsEventsAreDiscarded) {
+    const auto maxBufferedEvents = internalQueryChangeStreamFanoutMaxBufferedEvents.load();
+    internalQueryChangeStreamFanoutMaxBufferedEvents.store(2);
+    ON_BLOCK_EXIT(
+        [&] { internalQueryChangeStreamFanoutMaxBufferedEvents.store(maxBufferedEvents); });
+
+    auto leader = subscribe(Timestamp(1, 0), false);
+    auto laggard = subscribe(Timestamp(1, 0), false);
+    addEvent(Timestamp(1, 1));
+    addEvent(Timestamp(1, 2));
+    addEvent(Timestamp(1, 3));
+
+    assertNextEvent(leader, Timestamp(1, 1));
+    assertNextEvent(leader, Timestamp(1, 2));
+    assertNextEvent(leader, Timestamp(1, 3));
+    ASSERT_EQ(_fanout->numBufferedEvents(), 2U);
+    ASSERT_FALSE(getNext(laggard));
+
+    // The event at Timestamp(1, 1) has been discarded, so the fanout can no longer serve streams
+    // which start at that time.
+    ASSERT_FALSE(_fanout->subscribe(Timestamp(1, 1), true));
+    auto late = subscribe(Timestamp(1, 1), false);
+    assertNextEvent(late, Timestamp(1, 2));
+}
+
+TEST_F(ChangeStreamFanoutTest, RegistrySharesFanoutsAndDisposesOfThemWithTheLastSubscriber) {
+    ChangeStreamFanoutRegistry registry;
+    auto makePipeline = [&] {
+        auto pipeline = uassertStatusOK(Pipeline::create({DocumentSourceMock::create()}, _ctx));
+        pipeline->detachFromOperationContext();
+        return pipeline;
+    };
+
+    auto first = registry.subscribe("test", Timestamp(1, 0), false, makePipeline);
+    auto second = registry.subscribe("test", Timestamp(1, 1), false, makePipeline);
+    auto other = registry.subscribe("other", Timestamp(1, 0), false, makePipeline);
+    ASSERT_EQ(first.first, second.first);
+    ASSERT_NE(first.first, other.first);
+    ASSERT_EQ(registry.numFanouts(), 2U);
+
+    registry.unsubscribe(_opCtx.get(), "test", first.first, first.second);
+    ASSERT_EQ(registry.numFanouts(), 2U);
+    registry.unsubscribe(_opCtx.get(), "test", second.first, second.second);
+    ASSERT_EQ(registry.numFanouts(), 1U);
+    ASSERT_FALSE(second.first->subscribe(Timestamp(1, 1), false));
+    registry.unsubscribe(_opCtx.get(), "other", other.first, other.second);
+    ASSERT_EQ(registry.numFanouts(), 0U);
+}
+
 }  // namespace
 }  // namespace mongo
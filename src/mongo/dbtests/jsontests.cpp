@@ -697,6 +697,49 @@ class EmptyStrings : public Base {
     }
 };
 
+class PlainNumberTypes : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", 2147483647);
+        b.append("b", -2147483647 - 1);
+        b.append("c", -2147483649LL);
+        b.append("d", 123456789012345678LL);
+        b.append("e", 1e19);
+        b.append("f", -1.5e-3);
+        b.append("g", 0);
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ \"a\" : 2147483647, \"b\" : -2147483648, \"c\" : -2147483649, "
+               "\"d\" : 123456789012345678, \"e\" : 10000000000000000000, \"f\" : -1.5E-3, "
+               "\"g\" : -0 }";
+    }
+};
+
+class PlainNestedDocument : public Base {
+    virtual BSONObj bson() const {
+        return BSON("a" << BSON("b" << BSON_ARRAY(1 << "two" << true << BSONNULL << BSONObj()))
+                        << "$c"
+                        << BSON("$set" << BSONArray())
+                        << "d"
+                        << false);
+    }
+    virtual string json() const {
+        return "{\"a\":{\"b\":[1,\"two\",true,null,{}]},\"$c\":{\"$set\":[]},\"d\":false}";
+    }
+};
+
+class PlainEscapedString : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", "x\"y\\z/\n\t'");
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ \"a\" : \"x\\\"y\\\\z\\/\\n\\t\\'\" }";
+    }
+};
+
 class ReservedFieldName : public Bad {
     virtual string json() const {
         return "{ \"$oid\" : \"b\" }";
@@ -2758,6 +2801,9 @@ public:
         add<FromJsonTests::EmptyWithSpace>();
         add<FromJsonTests::SingleString>();
         add<FromJsonTests::EmptyStrings>();
+        add<FromJsonTests::PlainNumberTypes>();
+        add<FromJsonTests::PlainNestedDocument>();
+        add<FromJsonTests::PlainEscapedString>();
         add<FromJsonTests::ReservedFieldName>();
         add<FromJsonTests::ReservedFieldName1>();
         add<FromJsonTests::NumberFieldName>();
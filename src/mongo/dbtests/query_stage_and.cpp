@@ -383,6 +383,51 @@ public:
     }
 };
 
+// An AND with two children, where most of the last child's results are not in the first child.
+// The Bloom filter built from the first child should reject them without probing the hash table.
+class QueryStageAndHashFilterRejectsNonIntersectingResults : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ah = make_unique<AndHashStage>(&_opCtx, &ws);
+
+        // Foo <= 20
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 20);
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 10
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 10);
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // foo == bar, and foo <= 20, bar >= 10, so our values are foo == 10, ..., 20. The 29
+        // results of the last child with bar > 20 are not in the intersection.
+        ASSERT_EQUALS(11, countResults(ah.get()));
+
+        auto stats = static_cast<const AndHashStats*>(ah->getSpecificStats());
+        ASSERT_GT(stats->filterRejects, 0U);
+        ASSERT_LTE(stats->filterRejects, 29U);
+    }
+};
+
 // An AND with two children.
 // Add large keys (512 bytes) to index of first child to cause
 // internal buffer within hashed AND to exceed threshold (32MB)
@@ -1339,6 +1384,7 @@ public:
     void setupTests() {
         add<QueryStageAndHashDeleteDuringYield>();
         add<QueryStageAndHashTwoLeaf>();
+        add<QueryStageAndHashFilterRejectsNonIntersectingResults>();
         add<QueryStageAndHashTwoLeafFirstChildLargeKeys>();
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
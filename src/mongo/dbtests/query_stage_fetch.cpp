@@ -46,6 +46,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/fail_point_service.h"
 
 namespace QueryStageFetch {
 
@@ -220,6 +221,159 @@ public:
     }
 };
 
+//
+// Test that a batch of fetched results keeps the order in which the child produced them, even
+// though the records are read in RecordId order.
+//
+class FetchStageBatchPreservesChildOrder : public QueryStageFetchBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        const int kNumDocs = 10;
+        for (int i = 0; i < kNumDocs; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(kNumDocs), recordIds.size());
+
+        // Queue the records in descending RecordId order, as a descending index scan would.
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        BSONObj filterObj = BSON("foo" << BSON("$ne" << 3));
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(filterObj, expCtx);
+        verify(statusWithMatcher.isOK());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), filterExpr.get(), coll));
+
+        std::vector<WorkingSetID> out;
+        WorkingSetID lastOut = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = fetchStage->workBatch(&ws, 2 * kNumDocs, &out, &lastOut);
+        ASSERT_EQUALS(PlanStage::IS_EOF, state);
+
+        ASSERT_EQUALS(size_t(kNumDocs - 1), out.size());
+        int expected = kNumDocs - 1;
+        for (auto id : out) {
+            if (expected == 3) {
+                --expected;
+            }
+            ASSERT_EQUALS(expected, ws.get(id)->obj.value()["foo"].numberInt());
+            --expected;
+        }
+
+        auto stats = static_cast<const FetchStats*>(fetchStage->getSpecificStats());
+        ASSERT_EQUALS(size_t(kNumDocs), stats->docsExamined);
+    }
+};
+
+//
+// Test that a write conflict in the middle of a batch neither examines a result twice nor drops the
+// state which ended our child's batch.
+//
+class FetchStageBatchWriteConflict : public QueryStageFetchBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        const int kNumDocs = 10;
+        for (int i = 0; i < kNumDocs; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(kNumDocs), recordIds.size());
+
+        // Queue the records in descending RecordId order, so that some of the results after the
+        // one which conflicts have already been fetched, and end the child's batch with a yield.
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            ws.get(id)->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+        mockStage->pushBack(PlanStage::NEED_YIELD);
+
+        BSONObj filterObj = BSON("foo" << BSON("$ne" << 3));
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(filterObj, expCtx);
+        verify(statusWithMatcher.isOK());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), filterExpr.get(), coll));
+
+        // The third record read conflicts.
+        FailPoint* failPoint = getGlobalFailPointRegistry()->getFailPoint(
+            "throwWriteConflictExceptionInFetchStage");
+        failPoint->setMode(FailPoint::skip, 2);
+
+        std::vector<WorkingSetID> out;
+        WorkingSetID lastOut = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = fetchStage->workBatch(&ws, 2 * kNumDocs, &out, &lastOut);
+        failPoint->setMode(FailPoint::off);
+        ASSERT_EQUALS(PlanStage::NEED_YIELD, state);
+        ASSERT_EQUALS(WorkingSet::INVALID_ID, lastOut);
+
+        // The rest of the results come one at a time, followed by the child's yield.
+        while (PlanStage::NEED_YIELD != (state = fetchStage->work(&lastOut))) {
+            ASSERT_NOT_EQUALS(PlanStage::IS_EOF, state);
+            if (PlanStage::ADVANCED == state) {
+                out.push_back(lastOut);
+            }
+        }
+        ASSERT_EQUALS(PlanStage::IS_EOF, fetchStage->work(&lastOut));
+
+        ASSERT_EQUALS(size_t(kNumDocs - 1), out.size());
+        int expected = kNumDocs - 1;
+        for (auto id : out) {
+            if (expected == 3) {
+                --expected;
+            }
+            ASSERT_EQUALS(expected, ws.get(id)->obj.value()["foo"].numberInt());
+            --expected;
+        }
+
+        auto stats = static_cast<const FetchStats*>(fetchStage->getSpecificStats());
+        ASSERT_EQUALS(size_t(kNumDocs), stats->docsExamined);
+        ASSERT_EQUALS(size_t(0), stats->alreadyHasObj);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -227,6 +381,8 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatchPreservesChildOrder>();
+        add<FetchStageBatchWriteConflict>();
     }
 };
 
@@ -560,6 +560,91 @@ TEST_F(QueryStageMultiPlanTest, MPSSummaryStats) {
     ASSERT_LTE(stats.totalKeysExamined, static_cast<size_t>(N));
 }
 
+TEST_F(QueryStageMultiPlanTest, MPSPicksClearWinnerByCostEstimate) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("a" << i << "b" << (i % 2)));
+    }
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    const bool costBasedOldValue = internalQueryPlanCostBasedSelectionEnabled.load();
+    const bool ixisectOldValue = internalQueryPlannerEnableIndexIntersection.load();
+    internalQueryPlanCostBasedSelectionEnabled.store(true);
+    internalQueryPlannerEnableIndexIntersection.store(false);
+    ON_BLOCK_EXIT([&] {
+        internalQueryPlanCostBasedSelectionEnabled.store(costBasedOldValue);
+        internalQueryPlannerEnableIndexIntersection.store(ixisectOldValue);
+    });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* coll = ctx.getCollection();
+
+    // The scan over 'a' examines a single key, while the scan over 'b' hits the key limit.
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("a" << 7 << "b" << BSON("$gte" << 0)));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    auto exec =
+        uassertStatusOK(getExecutor(opCtx(), coll, std::move(cq), PlanExecutor::NO_YIELD, 0));
+    ASSERT_EQ(exec->getRootStage()->stageType(), STAGE_MULTI_PLAN);
+
+    auto mps = static_cast<MultiPlanStage*>(exec->getRootStage());
+    auto mpsStats = static_cast<const MultiPlanStats*>(mps->getSpecificStats());
+    ASSERT_TRUE(mpsStats->chosenByCostEstimate);
+    ASSERT_EQ(mpsStats->costEstimates.size(), 2U);
+    ASSERT_EQ(Explain::getPlanSummary(exec.get()), "IXSCAN { a: 1 }");
+
+    // The losing plan was never worked.
+    PlanSummaryStats stats;
+    Explain::getSummaryStats(*exec, &stats);
+    ASSERT_EQ(stats.totalKeysExamined, 0U);
+
+    BSONObj obj;
+    ASSERT_EQ(PlanExecutor::ADVANCED, exec->getNext(&obj, nullptr));
+    ASSERT_EQ(obj["a"].numberInt(), 7);
+    ASSERT_EQ(PlanExecutor::IS_EOF, exec->getNext(&obj, nullptr));
+}
+
+TEST_F(QueryStageMultiPlanTest, MPSFallsBackToTrialPeriodWhenCostEstimatesAreClose) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("a" << i << "b" << i));
+    }
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    const bool costBasedOldValue = internalQueryPlanCostBasedSelectionEnabled.load();
+    const bool ixisectOldValue = internalQueryPlannerEnableIndexIntersection.load();
+    internalQueryPlanCostBasedSelectionEnabled.store(true);
+    internalQueryPlannerEnableIndexIntersection.store(false);
+    ON_BLOCK_EXIT([&] {
+        internalQueryPlanCostBasedSelectionEnabled.store(costBasedOldValue);
+        internalQueryPlannerEnableIndexIntersection.store(ixisectOldValue);
+    });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* coll = ctx.getCollection();
+
+    // Both scans hit the key limit, so neither estimate is exact.
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("a" << BSON("$gte" << 0) << "b" << BSON("$gte" << 0)));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    auto exec =
+        uassertStatusOK(getExecutor(opCtx(), coll, std::move(cq), PlanExecutor::NO_YIELD, 0));
+    ASSERT_EQ(exec->getRootStage()->stageType(), STAGE_MULTI_PLAN);
+
+    auto mps = static_cast<MultiPlanStage*>(exec->getRootStage());
+    auto mpsStats = static_cast<const MultiPlanStats*>(mps->getSpecificStats());
+    ASSERT_FALSE(mpsStats->chosenByCostEstimate);
+    ASSERT_EQ(mpsStats->costEstimates.size(), 2U);
+    for (auto&& estimate : mpsStats->costEstimates) {
+        ASSERT_FALSE(estimate.exact);
+    }
+    ASSERT_TRUE(mps->bestPlanChosen());
+}
+
 TEST_F(QueryStageMultiPlanTest, ShouldReportErrorIfExceedsTimeLimitDuringPlanning) {
     const int N = 5000;
     for (int i = 0; i < N; ++i) {
@@ -0,0 +1,224 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file tests db/exec/parallel_collection_scan.cpp.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/dbclient_cursor.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/memory.h"
+
+namespace QueryStageParallelCollectionScan {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+static const NamespaceString nss{"unittests.QueryStageParallelCollectionScan"};
+
+class QueryStageParallelCollectionScanBase {
+public:
+    QueryStageParallelCollectionScanBase() : _client(&_opCtx) {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+
+        for (int i = 0; i < numObj(); ++i) {
+            _client.insert(nss.ns(), BSON("foo" << i << "bar" << BSON_ARRAY(i % 7 << i % 11)));
+        }
+    }
+
+    virtual ~QueryStageParallelCollectionScanBase() {
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        _client.dropCollection(nss.ns());
+    }
+
+    unique_ptr<MatchExpression> parse(const BSONObj& filterObj) {
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(filterObj,
+                                         expCtx,
+                                         ExtensionsCallbackNoop(),
+                                         MatchExpressionParser::kAllowAllSpecialFeatures);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        return std::move(statusWithMatcher.getValue());
+    }
+
+    /**
+     * Runs 'stage' to completion and returns the values of 'foo' in the documents it returns.
+     */
+    vector<int> runToCompletion(const Collection* collection,
+                                unique_ptr<WorkingSet> ws,
+                                unique_ptr<PlanStage> stage) {
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_opCtx, std::move(ws), std::move(stage), collection, PlanExecutor::NO_YIELD);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        auto exec = std::move(statusWithPlanExecutor.getValue());
+
+        vector<int> results;
+        PlanExecutor::ExecState state;
+        for (BSONObj obj; PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL));) {
+            results.push_back(obj["foo"].numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+        return results;
+    }
+
+    /**
+     * Checks that a parallel scan with 'filterObj' returns the same documents, in the same order,
+     * as a CollectionScan.
+     */
+    void assertMatchesCollectionScan(CollectionScanParams::Direction direction,
+                                     const BSONObj& filterObj,
+                                     size_t numThreads) {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        auto collection = ctx.getCollection();
+
+        CollectionScanParams params;
+        params.direction = direction;
+        unique_ptr<MatchExpression> filter = parse(filterObj);
+        ASSERT_TRUE(ParallelCollectionScan::canScanInParallel(params, filter.get()));
+
+        auto ws = make_unique<WorkingSet>();
+        auto scan =
+            make_unique<CollectionScan>(&_opCtx, collection, params, ws.get(), filter.get());
+        vector<int> expected = runToCompletion(collection, std::move(ws), std::move(scan));
+
+        ws = make_unique<WorkingSet>();
+        auto parallelScan = make_unique<ParallelCollectionScan>(
+            &_opCtx, collection, params, numThreads, ws.get(), filter.get());
+        vector<int> actual = runToCompletion(collection, std::move(ws), std::move(parallelScan));
+
+        ASSERT_FALSE(expected.empty());
+        ASSERT_EQUALS(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUALS(expected[i], actual[i]);
+        }
+    }
+
+    static int numObj() {
+        return 10000;
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _txnPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_txnPtr;
+
+private:
+    DBDirectClient _client;
+};
+
+class QueryStageParallelCollscanForward : public QueryStageParallelCollectionScanBase {
+public:
+    void run() {
+        assertMatchesCollectionScan(
+            CollectionScanParams::FORWARD, BSON("foo" << BSON("$mod" << BSON_ARRAY(3 << 0))), 4);
+    }
+};
+
+class QueryStageParallelCollscanBackward : public QueryStageParallelCollectionScanBase {
+public:
+    void run() {
+        assertMatchesCollectionScan(
+            CollectionScanParams::BACKWARD, BSON("foo" << BSON("$mod" << BSON_ARRAY(3 << 0))), 4);
+    }
+};
+
+class QueryStageParallelCollscanCompoundFilter : public QueryStageParallelCollectionScanBase {
+public:
+    void run() {
+        assertMatchesCollectionScan(
+            CollectionScanParams::FORWARD,
+            BSON("$or" << BSON_ARRAY(BSON("bar" << 3) << BSON("foo" << BSON("$gte" << 9990)))),
+            16);
+    }
+};
+
+class QueryStageParallelCollscanSingleThread : public QueryStageParallelCollectionScanBase {
+public:
+    void run() {
+        assertMatchesCollectionScan(
+            CollectionScanParams::FORWARD, BSON("foo" << BSON("$lt" << 5000)), 1);
+    }
+};
+
+class QueryStageParallelCollscanUnsupported : public QueryStageParallelCollectionScanBase {
+public:
+    void run() {
+        CollectionScanParams params;
+        unique_ptr<MatchExpression> filter = parse(BSON("foo" << 1));
+        ASSERT_TRUE(ParallelCollectionScan::canScanInParallel(params, filter.get()));
+
+        // There is nothing to evaluate in parallel without a filter.
+        ASSERT_FALSE(ParallelCollectionScan::canScanInParallel(params, nullptr));
+
+        // $expr keeps mutable state while matching.
+        filter = parse(BSON("$and" << BSON_ARRAY(
+                                BSON("foo" << 1)
+                                << BSON("$expr" << BSON("$eq" << BSON_ARRAY("$foo"
+                                                                            << "$bar"))))));
+        ASSERT_FALSE(ParallelCollectionScan::canScanInParallel(params, filter.get()));
+
+        // Tailable scans need CollectionScan's handling of EOF.
+        filter = parse(BSON("foo" << 1));
+        params.tailable = true;
+        ASSERT_FALSE(ParallelCollectionScan::canScanInParallel(params, filter.get()));
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("QueryStageParallelCollectionScan") {}
+
+    void setupTests() {
+        add<QueryStageParallelCollscanForward>();
+        add<QueryStageParallelCollscanBackward>();
+        add<QueryStageParallelCollscanCompoundFilter>();
+        add<QueryStageParallelCollscanSingleThread>();
+        add<QueryStageParallelCollscanUnsupported>();
+    }
+};
+
+SuiteInstance<All> all;
+
+}  // namespace QueryStageParallelCollectionScan
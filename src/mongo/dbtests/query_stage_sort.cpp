@@ -38,6 +38,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/json.h"
@@ -571,6 +572,69 @@ public:
     }
 };
 
+// A covered projection builds its results in a buffer which it reuses. Sorting buffers every
+// result, so each of them must remain intact once the projection has produced the next one.
+class QueryStageSortCoveredProjection : public QueryStageSortTestBase {
+public:
+    virtual int numObj() {
+        return 100;
+    }
+
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        auto ws = make_unique<WorkingSet>();
+        auto queuedDataStage = make_unique<QueuedDataStage>(&_opCtx, ws.get());
+
+        // Feed index keys, as an index scan over {foo: 1, bar: 1} would.
+        const BSONObj keyPattern = BSON("foo" << 1 << "bar" << 1);
+        for (int i = 0; i < numObj(); ++i) {
+            WorkingSetID id = ws->allocate();
+            WorkingSetMember* member = ws->get(id);
+            member->recordId = RecordId(i + 1);
+            member->keyData.push_back(
+                IndexKeyDatum(keyPattern, BSON("" << i << "" << std::string(i, 'x')), nullptr));
+            ws->transitionToRecordIdAndIdx(id);
+            queuedDataStage->pushBack(id);
+        }
+
+        auto projectionStage =
+            stdx::make_unique<ProjectionStageCovered>(&_opCtx,
+                                                      BSON("_id" << 0 << "foo" << 1 << "bar" << 1),
+                                                      ws.get(),
+                                                      std::move(queuedDataStage),
+                                                      keyPattern);
+
+        SortStageParams params;
+        params.pattern = BSON("foo" << -1);
+
+        auto keyGenStage = make_unique<SortKeyGeneratorStage>(
+            &_opCtx, projectionStage.release(), ws.get(), params.pattern, nullptr);
+
+        auto sortStage = make_unique<SortStage>(&_opCtx, params, ws.get(), keyGenStage.release());
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_opCtx, std::move(ws), std::move(sortStage), coll, PlanExecutor::NO_YIELD);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        auto exec = std::move(statusWithPlanExecutor.getValue());
+
+        // Every projected result comes back whole and in sorted order.
+        BSONObj current;
+        for (int i = numObj() - 1; i >= 0; --i) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&current, NULL));
+            ASSERT_BSONOBJ_EQ(current, BSON("foo" << i << "bar" << std::string(i, 'x')));
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&current, NULL));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_sort") {}
@@ -588,6 +652,7 @@ public:
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
         add<QueryStageSortDeletionInvalidationWithLimit<1>>();
         add<QueryStageSortParallelArrays>();
+        add<QueryStageSortCoveredProjection>();
     }
 };
 
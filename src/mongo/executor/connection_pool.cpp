@@ -300,6 +300,7 @@ constexpr Milliseconds ConnectionPool::kDefaultHostTimeout;
 size_t const ConnectionPool::kDefaultMaxConns = std::numeric_limits<size_t>::max();
 size_t const ConnectionPool::kDefaultMinConns = 1;
 size_t const ConnectionPool::kDefaultMaxConnecting = std::numeric_limits<size_t>::max();
+size_t const ConnectionPool::kDefaultMaxIdleConns = std::numeric_limits<size_t>::max();
 constexpr Milliseconds ConnectionPool::kDefaultRefreshRequirement;
 constexpr Milliseconds ConnectionPool::kDefaultRefreshTimeout;
 
@@ -668,6 +669,12 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
                              processFailure(status, std::move(lk));
                          }));
         lk.lock();
+    } else if (_readyPool.size() >= _parent->_options.maxIdleConnections && _requests.empty() &&
+               openConnections(lk) >= _parent->_options.minConnections) {
+        // If we already hold enough idle connections, let this one lapse
+        LOG(1) << "Ending idle connection to host " << _hostAndPort
+               << " because the pool holds enough idle connections; " << openConnections(lk)
+               << " connections to that host remain open";
     } else {
         // If it's fine as it is, just put it in the ready queue
         addToReady(lk, std::move(conn));
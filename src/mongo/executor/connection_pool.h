@@ -79,6 +79,7 @@ public:
     static const size_t kDefaultMaxConns;
     static const size_t kDefaultMinConns;
     static const size_t kDefaultMaxConnecting;
+    static const size_t kDefaultMaxIdleConns;
     static constexpr Milliseconds kDefaultRefreshRequirement = Milliseconds(60000);  // 1min
     static constexpr Milliseconds kDefaultRefreshTimeout = Milliseconds(20000);      // 20secs
 
@@ -107,6 +108,14 @@ public:
          */
         size_t maxConnecting = kDefaultMaxConnecting;
 
+        /**
+         * The maximum number of idle connections to keep for a host. A connection returned to a
+         * pool which already holds this many ready connections is closed, as long as the pool
+         * keeps minConnections. This bounds the connections a pool holds on to after a burst of
+         * requests, rather than keeping them open until they need a refresh.
+         */
+        size_t maxIdleConnections = kDefaultMaxIdleConns;
+
         /**
          * Amount of time to wait before timing out a refresh attempt
          */
@@ -614,6 +614,36 @@ TEST_F(ConnectionPoolTest, maxPoolRespected) {
     doneWith(conn3);
 }
 
+/**
+ * Verify that connections returned beyond maxIdleConnections are closed
+ */
+TEST_F(ConnectionPoolTest, maxIdleConnectionsRespected) {
+    ConnectionPool::Options options;
+    options.minConnections = 1;
+    options.maxIdleConnections = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    std::vector<ConnectionPool::ConnectionHandle> conns;
+    for (int i = 0; i < 3; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get_forTest(HostAndPort(),
+                         Milliseconds(5000),
+                         [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                             ASSERT(swConn.isOK());
+                             conns.push_back(std::move(swConn.getValue()));
+                         });
+    }
+    ASSERT_EQ(3U, conns.size());
+    ASSERT_EQ(3U, pool.getNumConnectionsPerHost(HostAndPort()));
+
+    // Only the first connection returned is kept.
+    for (auto& conn : conns) {
+        doneWith(conn);
+        conn.reset();
+    }
+    ASSERT_EQ(1U, pool.getNumConnectionsPerHost(HostAndPort()));
+}
+
 /**
  * Verify that we respect maxConnecting
  */
@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_log_writer.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <ostream>
+
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+// How long buffered lines may wait before the background thread writes them.
+const Milliseconds kDrainInterval{100};
+
+}  // namespace
+
+AsyncLogWriter::AsyncLogWriter(RotatableFileWriter* writer, std::size_t maxBufferedBytes)
+    : _writer(writer), _maxStripeBytes(std::max<std::size_t>(maxBufferedBytes / kNumStripes, 1)) {}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    shutdown();
+}
+
+void AsyncLogWriter::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_threadMutex);
+    invariant(!_thread.joinable());
+    _inShutdown = false;
+    _thread = stdx::thread([this] { _run(); });
+    _async.store(true);
+}
+
+void AsyncLogWriter::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_threadMutex);
+        if (!_thread.joinable())
+            return;
+        _async.store(false);
+        _inShutdown = true;
+    }
+    _wakeup.notify_one();
+    _thread.join();
+
+    // Lines appended while the background thread was stopping are still buffered.
+    flush().ignore();
+}
+
+AsyncLogWriter::Stripe& AsyncLogWriter::_stripeForCurrentThread() {
+    return _stripes[std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % kNumStripes];
+}
+
+bool AsyncLogWriter::append(StringData line) {
+    if (!_async.load()) {
+        return writeSync(line).isOK();
+    }
+
+    auto& stripe = _stripeForCurrentThread();
+    bool wake = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        if (stripe.bytes + line.size() > _maxStripeBytes) {
+            _droppedLines.fetchAndAdd(1);
+            _droppedBytes.fetchAndAdd(line.size());
+            return false;
+        }
+
+        // Taking the sequence number under the stripe lock keeps the lines of each stripe sorted.
+        stripe.entries.push_back({_nextSeq.fetchAndAdd(1), line.toString()});
+        stripe.bytes += line.size();
+        wake = stripe.bytes > _maxStripeBytes / 2;
+    }
+
+    if (wake) {
+        _wakeup.notify_one();
+    }
+    return true;
+}
+
+Status AsyncLogWriter::writeSync(StringData line) {
+    stdx::lock_guard<stdx::mutex> lk(_writeMutex);
+    return _drain_inlock(line);
+}
+
+void AsyncLogWriter::_takeBufferedEntries(std::vector<Entry>* entries) {
+    for (auto& stripe : _stripes) {
+        std::vector<Entry> stripeEntries;
+        {
+            stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+            stripeEntries.swap(stripe.entries);
+            stripe.bytes = 0;
+        }
+        std::move(stripeEntries.begin(), stripeEntries.end(), std::back_inserter(*entries));
+    }
+
+    std::sort(entries->begin(), entries->end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.seq < rhs.seq;
+    });
+}
+
+Status AsyncLogWriter::_drain_inlock(StringData line) {
+    // Lines are only taken out of the buffers once the file is available, so that a stalled disk
+    // bounds the buffered lines rather than piling them up here.
+    RotatableFileWriter::Use useWriter(_writer);
+    Status status = useWriter.status();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    std::vector<Entry> entries;
+    _takeBufferedEntries(&entries);
+
+    const auto droppedLines = _droppedLines.load() - _reportedDroppedLines;
+    if (entries.empty() && line.empty() && droppedLines == 0) {
+        return Status::OK();
+    }
+
+    auto& stream = useWriter.stream();
+    for (const auto& entry : entries) {
+        stream.write(entry.line.data(), entry.line.size());
+    }
+    if (droppedLines != 0) {
+        stream << "*** " << droppedLines
+               << " log lines were dropped because the log writer could not keep up ***\n";
+        _reportedDroppedLines += droppedLines;
+    }
+    if (!line.empty()) {
+        stream.write(line.rawData(), line.size());
+    }
+    stream.flush();
+
+    _writtenLines.fetchAndAdd(entries.size() + (line.empty() ? 0 : 1));
+    return useWriter.status();
+}
+
+void AsyncLogWriter::_run() {
+    setThreadName("AsyncLogWriter");
+
+    stdx::unique_lock<stdx::mutex> lk(_threadMutex);
+    while (!_inShutdown) {
+        _wakeup.wait_for(lk, kDrainInterval.toSystemDuration());
+        lk.unlock();
+        {
+            stdx::lock_guard<stdx::mutex> writeLk(_writeMutex);
+            // There is nobody to report a failure to; it surfaces through the stream status of the
+            // next synchronous write.
+            _drain_inlock(StringData()).ignore();
+        }
+        lk.lock();
+    }
+}
+
+AsyncLogWriter::Stats AsyncLogWriter::getStats() const {
+    Stats stats;
+    stats.writtenLines = _writtenLines.load();
+    stats.droppedLines = _droppedLines.load();
+    stats.droppedBytes = _droppedBytes.load();
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        stats.bufferedBytes += stripe.bytes;
+    }
+    return stats;
+}
+
+}  // namespace logger
+}  // namespace mongo
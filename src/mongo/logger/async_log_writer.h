@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace logger {
+
+class RotatableFileWriter;
+
+/**
+ * Decouples the threads that log from the disk behind a RotatableFileWriter.
+ *
+ * Formatted log lines are appended to one of several buffers, chosen by the id of the logging
+ * thread, and a background thread periodically drains all buffers and writes their lines, in the
+ * order they were logged, to the file. Logging threads therefore only contend on a short
+ * critical section with the few other threads sharing their buffer, and never wait for the disk.
+ *
+ * The memory used by buffered lines is bounded. Once a buffer is full, further lines appended to
+ * it are dropped and counted, and the background thread writes a line reporting how many lines
+ * were lost before resuming with the next line it has.
+ *
+ * Lines that must not be lost are written with writeSync(), which first writes every buffered
+ * line and then the line itself on the calling thread.
+ */
+class AsyncLogWriter {
+    MONGO_DISALLOW_COPYING(AsyncLogWriter);
+
+public:
+    struct Stats {
+        std::uint64_t writtenLines = 0;
+        std::uint64_t droppedLines = 0;
+        std::uint64_t droppedBytes = 0;
+        std::uint64_t bufferedBytes = 0;
+    };
+
+    /**
+     * Constructs a writer for "writer", which must outlive it, that buffers at most
+     * "maxBufferedBytes" of log lines. The background thread is not started until startup().
+     */
+    AsyncLogWriter(RotatableFileWriter* writer, std::size_t maxBufferedBytes);
+
+    /**
+     * Writes all buffered lines and stops the background thread.
+     */
+    ~AsyncLogWriter();
+
+    /**
+     * Starts the background thread.
+     */
+    void startup();
+
+    /**
+     * Writes all buffered lines and stops the background thread. Lines appended afterwards are
+     * written by the appending thread.
+     */
+    void shutdown();
+
+    /**
+     * Buffers "line", which must include its line terminator, to be written by the background
+     * thread. Returns false if the line was dropped because its buffer is full.
+     */
+    bool append(StringData line);
+
+    /**
+     * Writes all buffered lines, followed by "line", on the calling thread and returns the status
+     * of the file stream.
+     */
+    Status writeSync(StringData line);
+
+    /**
+     * Writes all buffered lines on the calling thread and returns the status of the file stream.
+     */
+    Status flush() {
+        return writeSync(StringData());
+    }
+
+    Stats getStats() const;
+
+private:
+    static constexpr std::size_t kNumStripes = 16;
+
+    struct Entry {
+        std::uint64_t seq;
+        std::string line;
+    };
+
+    struct Stripe {
+        stdx::mutex mutex;
+        std::vector<Entry> entries;
+        std::size_t bytes = 0;
+    };
+
+    Stripe& _stripeForCurrentThread();
+
+    /**
+     * Moves the lines of every stripe into "entries", sorted in the order they were appended.
+     */
+    void _takeBufferedEntries(std::vector<Entry>* entries);
+
+    /**
+     * Writes all buffered lines, followed by "line" if it is not empty. Must be called with
+     * _writeMutex held.
+     */
+    Status _drain_inlock(StringData line);
+
+    void _run();
+
+    RotatableFileWriter* const _writer;
+    const std::size_t _maxStripeBytes;
+
+    mutable std::array<Stripe, kNumStripes> _stripes;
+    AtomicWord<unsigned long long> _nextSeq{0};
+
+    // Serializes drains, so that batches of lines reach the file in order.
+    stdx::mutex _writeMutex;
+
+    AtomicWord<unsigned long long> _writtenLines{0};
+    AtomicWord<unsigned long long> _droppedLines{0};
+    AtomicWord<unsigned long long> _droppedBytes{0};
+
+    // Number of dropped lines already reported in the log file. Guarded by _writeMutex.
+    std::uint64_t _reportedDroppedLines = 0;
+
+    // Set while the background thread drains the buffers. Lines are written synchronously
+    // otherwise.
+    AtomicWord<bool> _async{false};
+
+    stdx::mutex _threadMutex;
+    stdx::condition_variable _wakeup;
+    bool _inShutdown = false;  // Guarded by _threadMutex.
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "mongo/logger/async_log_writer.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+using namespace mongo;
+using namespace mongo::logger;
+
+const std::string logFileName("LogTest_AsyncLogWriter.txt");
+
+class AsyncLogWriterTest : public mongo::unittest::Test {
+public:
+    AsyncLogWriterTest() {
+        unlink(logFileName.c_str());
+        ASSERT_OK(RotatableFileWriter::Use(&_fileWriter).setFileName(logFileName, false));
+    }
+
+    virtual ~AsyncLogWriterTest() {
+        unlink(logFileName.c_str());
+    }
+
+    RotatableFileWriter* fileWriter() {
+        return &_fileWriter;
+    }
+
+    std::string readFile() {
+        std::ifstream ifs(logFileName.c_str());
+        ASSERT_TRUE(ifs.is_open());
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+private:
+    RotatableFileWriter _fileWriter;
+};
+
+TEST_F(AsyncLogWriterTest, WritesSynchronouslyUntilStarted) {
+    AsyncLogWriter writer(fileWriter(), 1024 * 1024);
+    ASSERT_TRUE(writer.append("Level 1 message.\n"));
+    ASSERT_EQUALS(readFile(), "Level 1 message.\n");
+}
+
+TEST_F(AsyncLogWriterTest, FlushWritesBufferedLinesInOrder) {
+    AsyncLogWriter writer(fileWriter(), 1024 * 1024);
+    writer.startup();
+
+    // Lines from different threads are buffered separately, but written in the order logged.
+    std::string expected;
+    for (int i = 0; i < 4; ++i) {
+        const auto line = std::string("Thread ") + std::to_string(i) + "\n";
+        stdx::thread([&] { ASSERT_TRUE(writer.append(line)); }).join();
+        expected += line;
+    }
+    ASSERT_TRUE(writer.append("Main thread.\n"));
+    expected += "Main thread.\n";
+
+    ASSERT_OK(writer.flush());
+    ASSERT_EQUALS(readFile(), expected);
+    ASSERT_EQUALS(writer.getStats().writtenLines, 5U);
+    ASSERT_EQUALS(writer.getStats().bufferedBytes, 0U);
+}
+
+TEST_F(AsyncLogWriterTest, WriteSyncWritesBufferedLinesFirst) {
+    AsyncLogWriter writer(fileWriter(), 1024 * 1024);
+    writer.startup();
+    ASSERT_TRUE(writer.append("Level 1 message.\n"));
+    ASSERT_OK(writer.writeSync("Fatal message.\n"));
+    ASSERT_EQUALS(readFile(), "Level 1 message.\nFatal message.\n");
+}
+
+TEST_F(AsyncLogWriterTest, ShutdownWritesBufferedLines) {
+    {
+        AsyncLogWriter writer(fileWriter(), 1024 * 1024);
+        writer.startup();
+        ASSERT_TRUE(writer.append("Level 1 message.\n"));
+        writer.shutdown();
+        ASSERT_TRUE(writer.append("Level 2 message.\n"));
+    }
+    ASSERT_EQUALS(readFile(), "Level 1 message.\nLevel 2 message.\n");
+}
+
+TEST_F(AsyncLogWriterTest, DropsLinesWhenBufferIsFullAndReportsThem) {
+    // Each of the 16 buffers holds 32 bytes.
+    AsyncLogWriter writer(fileWriter(), 16 * 32);
+    writer.startup();
+
+    const std::string line = "0123456789abcdef0123456789\n";
+    {
+        // Stall the background thread as a saturated disk would.
+        RotatableFileWriter::Use stall(fileWriter());
+        ASSERT_TRUE(writer.append(line));
+        ASSERT_FALSE(writer.append(line));
+        ASSERT_FALSE(writer.append(line));
+    }
+
+    auto stats = writer.getStats();
+    ASSERT_EQUALS(stats.droppedLines, 2U);
+    ASSERT_EQUALS(stats.droppedBytes, 2 * line.size());
+
+    ASSERT_OK(writer.flush());
+    const std::string dropped =
+        "*** 2 log lines were dropped because the log writer could not keep up ***\n";
+    ASSERT_EQUALS(readFile(), line + dropped);
+
+    // Drops are reported only once.
+    ASSERT_TRUE(writer.append(line));
+    ASSERT_OK(writer.flush());
+    ASSERT_EQUALS(readFile(), line + dropped + line);
+}
+
+}  // namespace
@@ -32,6 +32,7 @@
 #include "mongo/base/init.h"
 #include "mongo/base/status.h"
 #include "mongo/platform/compiler.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 namespace logger {
@@ -40,6 +41,7 @@ static LogManager* theGlobalLogManager;  // NULL at program start, before even s
                                          // initialization.
 
 static RotatableFileManager theGlobalRotatableFileManager;
+static AsyncLogWriter* theGlobalAsyncLogWriter;
 
 LogManager* globalLogManager() {
     if (MONGO_unlikely(!theGlobalLogManager)) {
@@ -52,6 +54,15 @@ RotatableFileManager* globalRotatableFileManager() {
     return &theGlobalRotatableFileManager;
 }
 
+AsyncLogWriter* globalAsyncLogWriter() {
+    return theGlobalAsyncLogWriter;
+}
+
+void setGlobalAsyncLogWriter(std::unique_ptr<AsyncLogWriter> writer) {
+    invariant(!theGlobalAsyncLogWriter);
+    theGlobalAsyncLogWriter = writer.release();
+}
+
 /**
  * Just in case no static initializer called globalLogManager, make sure that the global log
  * manager is instantiated while we're still in a single-threaded context.
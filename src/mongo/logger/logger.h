@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <memory>
+
+#include "mongo/logger/async_log_writer.h"
 #include "mongo/logger/log_manager.h"
 #include "mongo/logger/message_log_domain.h"
 #include "mongo/logger/rotatable_file_manager.h"
@@ -41,6 +44,18 @@ namespace logger {
  */
 RotatableFileManager* globalRotatableFileManager();
 
+/**
+ * Gets the AsyncLogWriter behind the server log file, or nullptr if the log file is written
+ * synchronously.
+ */
+AsyncLogWriter* globalAsyncLogWriter();
+
+/**
+ * Installs "writer" as the global AsyncLogWriter. It is never destroyed, since threads may log
+ * until the process exits. Must be called in a single-threaded context, at most once.
+ */
+void setGlobalAsyncLogWriter(std::unique_ptr<AsyncLogWriter> writer);
+
 /**
  * Gets a global singleton instance of LogManager.
  */
@@ -36,6 +36,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -712,9 +713,82 @@ Decimal128 Decimal128::add(const Decimal128& other, RoundingMode roundMode) cons
     return add(other, &throwAwayFlag, roundMode);
 }
 
+bool Decimal128::_addSmall(const Decimal128& other,
+                          bool negateOther,
+                          RoundingMode roundMode,
+                          Decimal128* result) const {
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient())
+        return false;
+    const uint64_t exponent = getBiasedExponent();
+    if (exponent != other.getBiasedExponent())
+        return false;
+
+    const uint64_t sign = _value.high64 >> kSignFieldPos;
+    const uint64_t otherSign = (other._value.high64 >> kSignFieldPos) ^ (negateOther ? 1 : 0);
+    const uint64_t coefficient = _value.low64;
+    const uint64_t otherCoefficient = other._value.low64;
+    if (sign == otherSign) {
+        // The sum is below 2^65, so a carry goes into the high part of the coefficient.
+        const uint64_t low = coefficient + otherCoefficient;
+        *result = Decimal128(sign, exponent, low < coefficient ? 1 : 0, low);
+    } else if (coefficient == otherCoefficient) {
+        // An exact zero sum of operands of opposite sign is +0, unless rounding toward -Inf.
+        *result = Decimal128(roundMode == kRoundTowardNegative ? 1 : 0, exponent, 0, 0);
+    } else if (coefficient > otherCoefficient) {
+        *result = Decimal128(sign, exponent, 0, coefficient - otherCoefficient);
+    } else {
+        *result = Decimal128(otherSign, exponent, 0, otherCoefficient - coefficient);
+    }
+    return true;
+}
+
+bool Decimal128::_multiplySmall(const Decimal128& other, Decimal128* result) const {
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient())
+        return false;
+    const uint64_t coefficient = _value.low64;
+    const uint64_t otherCoefficient = other._value.low64;
+    if (coefficient > std::numeric_limits<uint32_t>::max() ||
+        otherCoefficient > std::numeric_limits<uint32_t>::max())
+        return false;
+    const int64_t exponent = static_cast<int64_t>(getBiasedExponent()) +
+        other.getBiasedExponent() - kExponentBias;
+    if (exponent < 0 || exponent > kMaxBiasedExponent)
+        return false;
+
+    const uint64_t sign = (_value.high64 ^ other._value.high64) >> kSignFieldPos;
+    *result = Decimal128(sign, exponent, 0, coefficient * otherCoefficient);
+    return true;
+}
+
+bool Decimal128::_compareSmall(const Decimal128& other, int* result) const {
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient() ||
+        getBiasedExponent() != other.getBiasedExponent())
+        return false;
+
+    const bool negative = _value.high64 >> kSignFieldPos;
+    const bool otherNegative = other._value.high64 >> kSignFieldPos;
+    const uint64_t coefficient = _value.low64;
+    const uint64_t otherCoefficient = other._value.low64;
+    if (coefficient == 0 && otherCoefficient == 0) {
+        *result = 0;  // -0 and +0 compare equal
+    } else if (negative != otherNegative) {
+        *result = negative ? -1 : 1;
+    } else {
+        const int magnitude = coefficient < otherCoefficient
+            ? -1
+            : coefficient == otherCoefficient ? 0 : 1;
+        *result = negative ? -magnitude : magnitude;
+    }
+    return true;
+}
+
 Decimal128 Decimal128::add(const Decimal128& other,
                            std::uint32_t* signalingFlags,
                            RoundingMode roundMode) const {
+    Decimal128 exact;
+    if (_addSmall(other, false, roundMode, &exact))
+        return exact;
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 addend = decimal128ToLibraryType(other.getValue());
     current = bid128_add(current, addend, roundMode, signalingFlags);
@@ -731,6 +805,10 @@ Decimal128 Decimal128::subtract(const Decimal128& other, RoundingMode roundMode)
 Decimal128 Decimal128::subtract(const Decimal128& other,
                                 std::uint32_t* signalingFlags,
                                 RoundingMode roundMode) const {
+    Decimal128 exact;
+    if (_addSmall(other, true, roundMode, &exact))
+        return exact;
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 sub = decimal128ToLibraryType(other.getValue());
     current = bid128_sub(current, sub, roundMode, signalingFlags);
@@ -747,6 +825,10 @@ Decimal128 Decimal128::multiply(const Decimal128& other, RoundingMode roundMode)
 Decimal128 Decimal128::multiply(const Decimal128& other,
                                 std::uint32_t* signalingFlags,
                                 RoundingMode roundMode) const {
+    Decimal128 exact;
+    if (_multiplySmall(other, &exact))
+        return exact;
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 factor = decimal128ToLibraryType(other.getValue());
     current = bid128_mul(current, factor, roundMode, signalingFlags);
@@ -897,6 +979,10 @@ Decimal128 Decimal128::squareRoot(std::uint32_t* signalingFlags, RoundingMode ro
 }
 
 bool Decimal128::isEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp))
+        return cmp == 0;
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -904,6 +990,10 @@ bool Decimal128::isEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isNotEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp))
+        return cmp != 0;
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -911,6 +1001,10 @@ bool Decimal128::isNotEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isGreater(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp))
+        return cmp > 0;
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -918,6 +1012,10 @@ bool Decimal128::isGreater(const Decimal128& other) const {
 }
 
 bool Decimal128::isGreaterEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp))
+        return cmp >= 0;
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -925,6 +1023,10 @@ bool Decimal128::isGreaterEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isLess(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp))
+        return cmp < 0;
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -932,6 +1034,10 @@ bool Decimal128::isLess(const Decimal128& other) const {
 }
 
 bool Decimal128::isLessEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp))
+        return cmp <= 0;
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
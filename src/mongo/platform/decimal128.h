@@ -542,6 +542,40 @@ private:
         return (_value.high64 >> kCombinationFieldPos) & kCombinationFieldMask;
     }
 
+    /**
+     * Returns true if this is a finite value in canonical encoding whose coefficient fits in 64
+     * bits. Such values, which include most decimals with a fixed number of fractional digits,
+     * allow the integer fast paths below.
+     */
+    bool _hasSmallCoefficient() const {
+        return _getCombinationField() < kCombinationNonCanonical &&
+            (_value.high64 & kCanonicalCoefficientHighFieldMask) == 0;
+    }
+
+    /**
+     * Computes this + other, or this - other if 'negateOther' is true, with integer arithmetic if
+     * both operands have small coefficients and the same exponent. The exact result then fits in
+     * 34 digits, so it is what the RDFP library would return and no flags are raised. Returns
+     * false, leaving 'result' untouched, if the fast path does not apply.
+     */
+    bool _addSmall(const Decimal128& other,
+                   bool negateOther,
+                   RoundingMode roundMode,
+                   Decimal128* result) const;
+
+    /**
+     * Computes this * other with integer arithmetic if both coefficients fit in 32 bits and the
+     * exponent of the product is in range, so that the product is exact. Returns false if the
+     * fast path does not apply.
+     */
+    bool _multiplySmall(const Decimal128& other, Decimal128* result) const;
+
+    /**
+     * Sets 'result' to -1, 0 or 1 as this is less than, equal to or greater than 'other' if both
+     * have small coefficients and the same exponent. Returns false if the fast path does not apply.
+     */
+    bool _compareSmall(const Decimal128& other, int* result) const;
+
     Value _value;
 };
 }  // namespace mongo
@@ -1054,6 +1054,54 @@ TEST(Decimal128Test, TestDecimal128MultiplicationCase2) {
     ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
 }
 
+TEST(Decimal128Test, TestDecimal128AdditionSameExponentCarry) {
+    Decimal128 d1("18446744073709551615");
+    Decimal128 d2("1");
+    Decimal128 result = d1.add(d2);
+    Decimal128 expected("18446744073709551616");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+}
+
+TEST(Decimal128Test, TestDecimal128AdditionSameExponentToZero) {
+    Decimal128 d1("1.50");
+    Decimal128 d2("-1.50");
+    Decimal128 result = d1.add(d2);
+    Decimal128 expected("0.00");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+    result = d1.add(d2, Decimal128::kRoundTowardNegative);
+    expected = Decimal128("-0.00");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+}
+
+TEST(Decimal128Test, TestDecimal128SubtractionSameExponent) {
+    Decimal128 d1("1.25");
+    Decimal128 d2("3.75");
+    Decimal128 result = d1.subtract(d2);
+    Decimal128 expected("-2.50");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+}
+
+TEST(Decimal128Test, TestDecimal128MultiplicationSmallCoefficients) {
+    Decimal128 d1("1.5");
+    Decimal128 d2("-2.25");
+    Decimal128 result = d1.multiply(d2);
+    Decimal128 expected("-3.375");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+}
+
+TEST(Decimal128Test, TestDecimal128CompareSameExponent) {
+    ASSERT_TRUE(Decimal128("-0.00").isEqual(Decimal128("0.00")));
+    ASSERT_TRUE(Decimal128("-1.25").isLess(Decimal128("1.25")));
+    ASSERT_TRUE(Decimal128("-3.00").isLess(Decimal128("-2.00")));
+    ASSERT_TRUE(Decimal128("2.50").isGreaterEqual(Decimal128("2.50")));
+    ASSERT_FALSE(Decimal128("2.50").isNotEqual(Decimal128("2.50")));
+}
+
 TEST(Decimal128Test, TestDecimal128DivisionCase1) {
     Decimal128 d1("25.05E20");
     Decimal128 d2("-50.5218E19");
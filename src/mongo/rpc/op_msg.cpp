@@ -37,6 +37,7 @@
 #include <set>
 
 #include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/rpc/object_check.h"
 #include "mongo/util/bufreader.h"
@@ -58,6 +59,30 @@ enum class Section : uint8_t {
     kDocSequence = 1,
 };
 
+/**
+ * Returns the number of documents in the document sequence payload of 'size' bytes at 'data',
+ * looking only at the leading size of each document. This is only used to reserve room for the
+ * documents up front, the documents themselves are read and checked afterwards.
+ */
+size_t countDocuments(const char* data, size_t size) {
+    size_t count = 0;
+    size_t offset = 0;
+    while (size - offset >= sizeof(int32_t)) {
+        const auto docSize = ConstDataView(data + offset).read<LittleEndian<int32_t>>();
+        if (docSize <= 0 || static_cast<size_t>(docSize) > size - offset)
+            break;
+        offset += docSize;
+        count++;
+    }
+    return count;
+}
+
+BSONObj readBSON(BufReader* reader, bool validate) {
+    if (validate)
+        return reader->read<Validated<BSONObj>>();
+    return reader->read<BSONObj>();
+}
+
 }  // namespace
 
 uint32_t OpMsg::flags(const Message& message) {
@@ -76,7 +101,9 @@ void OpMsg::replaceFlags(Message* message, uint32_t flags) {
     DataView(message->singleData().data()).write<LittleEndian<uint32_t>>(flags);
 }
 
-OpMsg OpMsg::parse(const Message& message) try {
+namespace {
+
+OpMsg parseImpl(const Message& message, bool validate) try {
     // It is the caller's responsibility to call the correct parser for a given message type.
     invariant(!message.empty());
     invariant(message.operation() == dbMsg);
@@ -88,7 +115,7 @@ OpMsg OpMsg::parse(const Message& message) try {
             !containsUnknownRequiredFlags(flags));
 
     constexpr int kCrc32Size = 4;
-    const bool haveChecksum = flags & kChecksumPresent;
+    const bool haveChecksum = flags & OpMsg::kChecksumPresent;
     const int checksumSize = haveChecksum ? kCrc32Size : 0;
 
     // The sections begin after the flags and before the checksum (if present).
@@ -104,7 +131,7 @@ OpMsg OpMsg::parse(const Message& message) try {
             case Section::kBody: {
                 uassert(40430, "Multiple body sections in message", !haveBody);
                 haveBody = true;
-                msg.body = sectionsBuf.read<Validated<BSONObj>>();
+                msg.body = readBSON(&sectionsBuf, validate);
                 break;
             }
 
@@ -126,8 +153,11 @@ OpMsg OpMsg::parse(const Message& message) try {
                         !msg.getSequence(name));  // TODO IDL
 
                 msg.sequences.push_back({name.toString()});
+                auto& objs = msg.sequences.back().objs;
+                objs.reserve(
+                    countDocuments(static_cast<const char*>(seqBuf.pos()), seqBuf.remaining()));
                 while (!seqBuf.atEof()) {
-                    msg.sequences.back().objs.push_back(seqBuf.read<Validated<BSONObj>>());
+                    objs.push_back(readBSON(&seqBuf, validate));
                 }
                 break;
             }
@@ -159,6 +189,16 @@ OpMsg OpMsg::parse(const Message& message) try {
     throw;
 }
 
+}  // namespace
+
+OpMsg OpMsg::parse(const Message& message) {
+    return parseImpl(message, true);
+}
+
+OpMsg OpMsg::parseTrusted(const Message& message) {
+    return parseImpl(message, false);
+}
+
 Message OpMsg::serialize() const {
     OpMsgBuilder builder;
     for (auto&& seq : sequences) {
@@ -78,6 +78,12 @@ struct OpMsg {
      */
     static OpMsg parse(const Message& message);
 
+    /**
+     * Like parse(), but does not validate the BSON in the message. Only use this on messages built
+     * by this process, such as the replies to the commands it ran.
+     */
+    static OpMsg parseTrusted(const Message& message);
+
     /**
      * Parses and returns an OpMsg containing owned BSON.
      */
@@ -116,6 +116,16 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
     return *readyResponse;
 }
 
+void AsyncRequestsSender::addRequests(const std::vector<AsyncRequestsSender::Request>& requests) {
+    invariant(!_stopRetrying);
+
+    for (const auto& request : requests) {
+        _remotes.emplace_back(request.shardId, request.cmdObj);
+    }
+
+    _scheduleRequests();
+}
+
 void AsyncRequestsSender::stopRetrying() {
     _stopRetrying = true;
 }
@@ -143,23 +153,28 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
 
     // Check if any remote is ready.
     invariant(!_remotes.empty());
-    for (auto& remote : _remotes) {
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        auto& remote = _remotes[i];
         if (remote.swResponse && !remote.done) {
             remote.done = true;
             if (remote.swResponse->isOK()) {
                 invariant(remote.shardHostAndPort);
-                return Response(std::move(remote.shardId),
-                                std::move(remote.swResponse->getValue()),
-                                std::move(*remote.shardHostAndPort));
+                Response response(std::move(remote.shardId),
+                                  std::move(remote.swResponse->getValue()),
+                                  std::move(*remote.shardHostAndPort));
+                response.requestIndex = i;
+                return response;
             } else {
                 // If _interruptStatus is set, promote CallbackCanceled errors to it.
                 if (!_interruptStatus.isOK() &&
                     ErrorCodes::CallbackCanceled == remote.swResponse->getStatus().code()) {
                     remote.swResponse = _interruptStatus;
                 }
-                return Response(std::move(remote.shardId),
-                                std::move(remote.swResponse->getStatus()),
-                                std::move(remote.shardHostAndPort));
+                Response response(std::move(remote.shardId),
+                                  std::move(remote.swResponse->getStatus()),
+                                  std::move(remote.shardHostAndPort));
+                response.requestIndex = i;
+                return response;
             }
         }
     }
@@ -268,6 +283,16 @@ void AsyncRequestsSender::_makeProgress() {
     // 'remote'.
     remote.cbHandle = executor::TaskExecutor::CallbackHandle();
 
+    // Let the targeter know how long the host took to answer, so that later requests which may go
+    // to any of several hosts prefer the faster ones.
+    if (job->cbData.response.status.isOK() && job->cbData.response.elapsedMillis &&
+        remote.shardHostAndPort) {
+        if (auto shard = remote.getShard()) {
+            shard->getTargeter()->noteOperationLatency(*remote.shardHostAndPort,
+                                                       *job->cbData.response.elapsedMillis);
+        }
+    }
+
     // Store the response or error.
     if (job->cbData.response.status.isOK()) {
         remote.swResponse = std::move(job->cbData.response);
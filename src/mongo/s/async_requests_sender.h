@@ -116,6 +116,11 @@ public:
         // The exact host on which the remote command was run. Is unset if the shard could not be
         // found or no shard hosts matching the readPreference could be found.
         boost::optional<HostAndPort> shardHostAndPort;
+
+        // The position of the request among all requests given to the ARS, counting both the
+        // requests it was constructed with and those added later through addRequests(). Allows
+        // callers which send several requests to the same shard to tell their responses apart.
+        size_t requestIndex = 0;
     };
 
     /**
@@ -152,6 +157,15 @@ public:
      */
     Response next();
 
+    /**
+     * Schedules additional requests while earlier ones may still be outstanding. Their responses
+     * are returned by next() like those of the initial requests, so done() becomes false again
+     * until they have all been returned.
+     *
+     * Note: Invalid to call after stopRetrying() or once the operation was interrupted.
+     */
+    void addRequests(const std::vector<AsyncRequestsSender::Request>& requests);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -245,7 +245,11 @@ CatalogCache::RefreshResult CatalogCache::_getCollectionRoutingInfoAt(
 
             auto refreshStatus = [&]() {
                 Timer t;
-                ON_BLOCK_EXIT([&] { _stats.totalRefreshWaitTimeMicros.addAndFetch(t.micros()); });
+                Timer totalWaitTimer;
+                ON_BLOCK_EXIT([&] {
+                    _stats.totalRefreshWaitTimeMicros.addAndFetch(t.micros());
+                    _stats.refreshWaitDurations.record(Milliseconds(totalWaitTimer.millis()));
+                });
 
                 try {
                     const Milliseconds kReportingInterval{250};
@@ -445,6 +449,22 @@ void CatalogCache::purgeAllDatabases() {
     _collectionsByDb.clear();
 }
 
+void CatalogCache::refreshShardedCollectionsInBackground() {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    for (const auto& db : _collectionsByDb) {
+        for (const auto& coll : db.second) {
+            const auto& collEntry = coll.second;
+            if (collEntry->needsRefresh || !collEntry->routingInfo ||
+                collEntry->backgroundRefreshInProgress) {
+                continue;
+            }
+
+            _scheduleBackgroundCollectionRefresh(lg, collEntry, NamespaceString(coll.first));
+        }
+    }
+}
+
 void CatalogCache::report(BSONObjBuilder* builder) const {
     BSONObjBuilder cacheStatsBuilder(builder->subobjStart("catalogCache"));
 
@@ -561,8 +581,10 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
         const Status& status, RoutingTableHistory* routingInfoAfterRefresh) {
         if (isIncremental) {
             _stats.numActiveIncrementalRefreshes.subtractAndFetch(1);
+            _stats.incrementalRefreshDurations.record(Milliseconds(t.millis()));
         } else {
             _stats.numActiveFullRefreshes.subtractAndFetch(1);
+            _stats.fullRefreshDurations.record(Milliseconds(t.millis()));
         }
 
         if (!status.isOK()) {
@@ -667,6 +689,71 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
     invariant(collEntry->routingInfo.get() == existingRoutingInfo.get());
 }
 
+void CatalogCache::_scheduleBackgroundCollectionRefresh(
+    WithLock, std::shared_ptr<CollectionRoutingInfoEntry> collEntry, const NamespaceString& nss) {
+    const auto existingRoutingInfo = collEntry->routingInfo;
+    invariant(existingRoutingInfo);
+    invariant(!collEntry->needsRefresh);
+
+    collEntry->backgroundRefreshInProgress = true;
+    _stats.countBackgroundRefreshesStarted.addAndFetch(1);
+
+    const auto refreshCallback = [ this, collEntry, nss, existingRoutingInfo, t = Timer() ](
+        OperationContext * opCtx,
+        StatusWith<CatalogCacheLoader::CollectionAndChangedChunks> swCollAndChunks) noexcept {
+        std::shared_ptr<RoutingTableHistory> newRoutingInfo;
+        Status status = Status::OK();
+        try {
+            newRoutingInfo = refreshCollectionRoutingInfo(
+                opCtx, nss, existingRoutingInfo, std::move(swCollAndChunks));
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+        collEntry->backgroundRefreshInProgress = false;
+
+        if (!status.isOK()) {
+            // The next stale shard version error will trigger a regular refresh
+            LOG_CATALOG_REFRESH(1) << "Background refresh for collection " << nss << " took "
+                                   << t.millis() << " ms and failed" << causedBy(redact(status));
+            return;
+        }
+
+        // A regular refresh was started in the meantime and will install its own routing table
+        if (collEntry->needsRefresh || collEntry->routingInfo != existingRoutingInfo) {
+            return;
+        }
+
+        if (!newRoutingInfo) {
+            // The collection was dropped or is no longer sharded, so let the next operation do a
+            // regular refresh rather than routing with the cached routing table.
+            collEntry->needsRefresh = true;
+            return;
+        }
+
+        if (newRoutingInfo->getVersion() == existingRoutingInfo->getVersion()) {
+            return;
+        }
+
+        LOG_CATALOG_REFRESH(0) << "Background refresh for collection " << nss << " from version "
+                               << existingRoutingInfo->getVersion().toString() << " to version "
+                               << newRoutingInfo->getVersion().toString() << " took "
+                               << t.millis() << " ms";
+
+        _stats.countBackgroundRefreshesAdvanced.addAndFetch(1);
+        collEntry->routingInfo = std::move(newRoutingInfo);
+    };
+
+    try {
+        _cacheLoader.getChunksSince(nss, existingRoutingInfo->getVersion(), refreshCallback);
+    } catch (const DBException& ex) {
+        collEntry->backgroundRefreshInProgress = false;
+        LOG_CATALOG_REFRESH(1) << "Failed to schedule background refresh for collection " << nss
+                               << causedBy(redact(ex.toStatus()));
+    }
+}
+
 void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
     builder->append("countStaleConfigErrors", countStaleConfigErrors.load());
 
@@ -679,6 +766,37 @@ void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
     builder->append("countFullRefreshesStarted", countFullRefreshesStarted.load());
 
     builder->append("countFailedRefreshes", countFailedRefreshes.load());
+
+    builder->append("countBackgroundRefreshesStarted", countBackgroundRefreshesStarted.load());
+    builder->append("countBackgroundRefreshesAdvanced", countBackgroundRefreshesAdvanced.load());
+
+    incrementalRefreshDurations.report("incrementalRefreshDurationMillis", builder);
+    fullRefreshDurations.report("fullRefreshDurationMillis", builder);
+    refreshWaitDurations.report("refreshWaitDurationMillis", builder);
+}
+
+void CatalogCache::Stats::DurationHistogram::record(Milliseconds duration) {
+    int bucket = 0;
+    for (long long bound = 1; bucket < kNumBuckets - 1 && duration.count() >= bound; bound *= 2) {
+        ++bucket;
+    }
+
+    _buckets[bucket].addAndFetch(1);
+}
+
+void CatalogCache::Stats::DurationHistogram::report(StringData fieldName,
+                                                    BSONObjBuilder* builder) const {
+    BSONArrayBuilder arrayBuilder(builder->subarrayStart(fieldName));
+    for (int i = 0; i < kNumBuckets; ++i) {
+        const auto count = _buckets[i].load();
+        if (count == 0) {
+            continue;
+        }
+
+        BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+        entryBuilder.append("lowerBoundMillis", i == 0 ? 0LL : 1LL << (i - 1));
+        entryBuilder.append("count", count);
+    }
 }
 
 CachedDatabaseInfo::CachedDatabaseInfo(DatabaseType dbt, std::shared_ptr<Shard> primaryShard)
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
@@ -42,6 +44,7 @@
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -244,6 +247,15 @@ public:
      */
     void purgeAllDatabases();
 
+    /**
+     * Non-blocking method, which schedules an incremental refresh for every cached sharded
+     * collection which is not already being refreshed. Operations keep routing with the cached
+     * routing table while these refreshes run, and a newer routing table replaces it once loaded,
+     * so that chunk migrations are picked up without operations having to hit a stale shard version
+     * and wait for the refresh.
+     */
+    void refreshShardedCollectionsInBackground();
+
     /**
      * Reports statistics about the catalog cache to be used by serverStatus
      */
@@ -268,6 +280,10 @@ private:
 
         // Contains the cached routing information (only available if needsRefresh is false)
         std::shared_ptr<RoutingTableHistory> routingInfo;
+
+        // Whether a background refresh started by refreshShardedCollectionsInBackground is loading
+        // the changes since the version of 'routingInfo'
+        bool backgroundRefreshInProgress{false};
     };
 
     /**
@@ -307,6 +323,16 @@ private:
                                     std::shared_ptr<CollectionRoutingInfoEntry> collEntry,
                                     NamespaceString const& nss,
                                     int refreshAttempt);
+
+    /**
+     * Non-blocking call which schedules an asynchronous refresh for the specified namespace, which
+     * leaves the entry usable while it runs. The entry must have routing info and must not be in
+     * the 'needsRefresh' state.
+     */
+    void _scheduleBackgroundCollectionRefresh(WithLock,
+                                              std::shared_ptr<CollectionRoutingInfoEntry> collEntry,
+                                              const NamespaceString& nss);
+
     /**
      * Used as a flag to indicate whether or not this thread performed its own
      * refresh for certain helper functions
@@ -375,6 +401,41 @@ private:
         // for whatever reason
         AtomicWord<long long> countFailedRefreshes{0};
 
+        // Cumulative, always-increasing counter of how many background refreshes have been kicked
+        // off
+        AtomicWord<long long> countBackgroundRefreshesStarted{0};
+
+        // Cumulative, always-increasing counter of how many background refreshes found a newer
+        // version than the cached one
+        AtomicWord<long long> countBackgroundRefreshesAdvanced{0};
+
+        /**
+         * Counts durations in buckets whose lower bounds are 0 and the powers of two up to
+         * 2^(kNumBuckets - 2) milliseconds.
+         */
+        class DurationHistogram {
+        public:
+            static constexpr int kNumBuckets = 16;
+
+            void record(Milliseconds duration);
+
+            /**
+             * Appends an array of {lowerBoundMillis, count} documents for the non-empty buckets.
+             */
+            void report(StringData fieldName, BSONObjBuilder* builder) const;
+
+        private:
+            std::array<AtomicWord<long long>, kNumBuckets> _buckets;
+        };
+
+        // Durations of the incremental and full refreshes, from when they were kicked off until the
+        // routing table was loaded or the refresh failed
+        DurationHistogram incrementalRefreshDurations;
+        DurationHistogram fullRefreshDurations;
+
+        // Durations for which threads waited for a refresh, counted once per wait
+        DurationHistogram refreshWaitDurations;
+
         /**
          * Reports the accumulated statistics for serverStatus.
          */
@@ -39,7 +39,9 @@
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
 #include "mongo/s/database_version_helpers.h"
+#include "mongo/s/grid.h"
 #include "mongo/unittest/death_test.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -628,5 +630,50 @@ TEST_F(CatalogCacheRefreshTest, IncrementalLoadAfterMoveLastChunk) {
     ASSERT_EQ(version, cm->getVersion({"1"}));
 }
 
+TEST_F(CatalogCacheRefreshTest, BackgroundRefreshKeepsRoutingUntilNewerVersionIsLoaded) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto initialRoutingInfo(makeChunkManager(kNss, shardKeyPattern, nullptr, true, {}));
+    ASSERT_EQ(1, initialRoutingInfo->numChunks());
+
+    ChunkVersion version = initialRoutingInfo->getVersion();
+
+    auto const catalogCache = Grid::get(getServiceContext())->catalogCache();
+    catalogCache->refreshShardedCollectionsInBackground();
+
+    // Operations do not wait for the background refresh
+    const auto getCachedVersion = [&] {
+        auto routingInfo =
+            assertGet(catalogCache->getCollectionRoutingInfo(operationContext(), kNss));
+        ASSERT(routingInfo.cm());
+        return routingInfo.cm()->getVersion();
+    };
+    ASSERT_EQ(initialRoutingInfo->getVersion(), getCachedVersion());
+
+    expectGetCollection(version.epoch(), shardKeyPattern);
+
+    // Return set of chunks, which represent a move
+    expectFindSendBSONObjVector(kConfigHostAndPort, [&]() {
+        version.incMajor();
+        ChunkType chunk1(kNss,
+                         {shardKeyPattern.getKeyPattern().globalMin(),
+                          shardKeyPattern.getKeyPattern().globalMax()},
+                         version,
+                         {"1"});
+
+        return std::vector<BSONObj>{chunk1.toConfigBSON()};
+    }());
+
+    // The loader's thread installs the new routing table after the response was processed
+    const auto deadline = Date_t::now() + kFutureTimeout;
+    while (getCachedVersion() != version) {
+        ASSERT_LT(Date_t::now(), deadline);
+        sleepmillis(1);
+    }
+
+    auto routingInfo = assertGet(catalogCache->getCollectionRoutingInfo(operationContext(), kNss));
+    ASSERT_EQ(version, routingInfo.cm()->getVersion({"1"}));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -50,6 +50,47 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created RoutingTableHistory
 AtomicWord<unsigned> nextCMSequenceNumber(0);
 
+// Applying a change to a ChunkInfoMap moves every chunk after it. When more chunks than this change
+// at once, for example when the routing table is built from scratch, the changes are applied to an
+// ordered map instead, which is flattened afterwards.
+const size_t kMaxChangedChunksToApplyInPlace = 16;
+
+using ChunkInfoOrderedMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+
+/**
+ * Orders ChunkInfoMap entries by the KeyString of their chunk's max.
+ */
+struct ChunkMaxKeyStringLess {
+    bool operator()(const ChunkInfoMap::value_type& lhs, const std::string& rhs) const {
+        return lhs.first < rhs;
+    }
+    bool operator()(const std::string& lhs, const ChunkInfoMap::value_type& rhs) const {
+        return lhs < rhs.first;
+    }
+};
+
+/**
+ * Returns the first chunk whose max is greater than "keyString", which is the chunk containing
+ * "keyString" if there is one.
+ */
+ChunkInfoMap::const_iterator upperBound(const ChunkInfoMap& chunkMap,
+                                        const std::string& keyString) {
+    return std::upper_bound(chunkMap.begin(), chunkMap.end(), keyString, ChunkMaxKeyStringLess());
+}
+
+ChunkInfoOrderedMap::const_iterator upperBound(const ChunkInfoOrderedMap& chunkMap,
+                                               const std::string& keyString) {
+    return chunkMap.upper_bound(keyString);
+}
+
+/**
+ * Returns the first chunk whose max is not less than "keyString".
+ */
+ChunkInfoMap::const_iterator lowerBound(const ChunkInfoMap& chunkMap,
+                                        const std::string& keyString) {
+    return std::lower_bound(chunkMap.begin(), chunkMap.end(), keyString, ChunkMaxKeyStringLess());
+}
+
 void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     for (auto&& element : o) {
         uassert(ErrorCodes::ConflictingOperationInProgress,
@@ -100,7 +141,7 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
         }
     }
 
-    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    const auto it = upperBound(_rt->getChunkMap(), _rt->_extractKeyString(shardKey));
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
             it != _rt->getChunkMap().end() && it->second->containsKey(shardKey));
@@ -108,11 +149,43 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
     return Chunk(*(it->second), _clusterTime);
 }
 
+std::vector<ShardId> ChunkManager::getShardIdsForShardKeys(
+    const std::vector<BSONObj>& shardKeys) const {
+    // Pairs of the KeyString of each shard key and its position in 'shardKeys'.
+    std::vector<std::pair<std::string, size_t>> keyStrings;
+    keyStrings.reserve(shardKeys.size());
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        keyStrings.emplace_back(_rt->_extractKeyString(shardKeys[i]), i);
+    }
+    std::sort(keyStrings.begin(), keyStrings.end());
+
+    const auto& chunkMap = _rt->getChunkMap();
+    auto it = chunkMap.begin();
+
+    std::vector<ShardId> shardIds(shardKeys.size());
+    for (const auto& keyString : keyStrings) {
+        // The keys are visited in sorted order, so the chunk containing this key is either the
+        // chunk containing the previous key or one after it.
+        if (it == chunkMap.end() || !(keyString.first < it->first)) {
+            it = std::upper_bound(it, chunkMap.end(), keyString.first, ChunkMaxKeyStringLess());
+        }
+
+        const auto& shardKey = shardKeys[keyString.second];
+        uassert(ErrorCodes::ShardKeyNotFound,
+                str::stream() << "Cannot target single shard using key " << shardKey,
+                it != chunkMap.end() && it->second->containsKey(shardKey));
+
+        shardIds[keyString.second] = it->second->getShardIdAt(_clusterTime);
+    }
+
+    return shardIds;
+}
+
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
 
-    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    const auto it = upperBound(_rt->getChunkMap(), _rt->_extractKeyString(shardKey));
     if (it == _rt->getChunkMap().end())
         return false;
 
@@ -169,8 +242,20 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     //   => Ranges { a : 1, b : 3 } => { a : 2, b : 4 }
     BoundList ranges = _rt->getShardKeyPattern().flattenBounds(bounds);
 
+    // The ranges are sorted, and for a large $in on the shard key (in particular a hashed one)
+    // they are mostly points. Consecutive ranges therefore often fall into the same chunk, in
+    // which case the shard has already been added and the chunk map need not be searched again.
+    std::shared_ptr<ChunkInfo> lastChunk;
     for (BoundList::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
-        getShardIdsForRange(it->first /*min*/, it->second /*max*/, shardIds);
+        if (lastChunk && lastChunk->containsKey(it->first) && lastChunk->containsKey(it->second)) {
+            continue;
+        }
+
+        const auto overlapping = _rt->overlappingRanges(it->first, it->second, true);
+        for (auto chunkIt = overlapping.first; chunkIt != overlapping.second; ++chunkIt) {
+            shardIds->insert(chunkIt->second->getShardIdAt(_clusterTime));
+            lastChunk = chunkIt->second;
+        }
 
         // once we know we need to visit all shards no need to keep looping
         if (shardIds->size() == _rt->_shardVersions.size()) {
@@ -212,7 +297,7 @@ bool ChunkManager::rangeOverlapsShard(const ChunkRange& range, const ShardId& sh
 
 ChunkManager::ConstRangeOfChunks ChunkManager::getNextChunkOnShard(const BSONObj& shardKey,
                                                                    const ShardId& shardId) const {
-    for (auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    for (auto it = upperBound(_rt->getChunkMap(), _rt->_extractKeyString(shardKey));
          it != _rt->getChunkMap().end();
          ++it) {
         const auto& chunk = it->second;
@@ -238,10 +323,10 @@ RoutingTableHistory::overlappingRanges(const BSONObj& min,
                                        const BSONObj& max,
                                        bool isMaxInclusive) const {
 
-    const auto itMin = _chunkMap.upper_bound(_extractKeyString(min));
+    const auto itMin = upperBound(_chunkMap, _extractKeyString(min));
     const auto itMax = [this, &max, isMaxInclusive]() {
-        auto it = isMaxInclusive ? _chunkMap.upper_bound(_extractKeyString(max))
-                                 : _chunkMap.lower_bound(_extractKeyString(max));
+        auto it = isMaxInclusive ? upperBound(_chunkMap, _extractKeyString(max))
+                                 : lowerBound(_chunkMap, _extractKeyString(max));
         return it == _chunkMap.end() ? it : ++it;
     }();
 
@@ -453,14 +538,14 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
                 uasserted(ErrorCodes::ConflictingOperationInProgress,
                           str::stream()
                               << "Gap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
+                              << lowerBound(_chunkMap, _extractKeyString(*lastMax))->second->getRange().toString()
                               << " and "
                               << rangeLast->second->getRange().toString());
             else
                 uasserted(ErrorCodes::ConflictingOperationInProgress,
                           str::stream()
                               << "Overlap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
+                              << lowerBound(_chunkMap, _extractKeyString(*lastMax))->second->getRange().toString()
                               << " and "
                               << rangeLast->second->getRange().toString());
         }
@@ -509,13 +594,10 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
         .makeUpdated(chunks);
 }
 
-std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
-    const std::vector<ChunkType>& changedChunks) {
-
-    const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
-
-    ChunkVersion collectionVersion = startingCollectionVersion;
+template <typename ChunkMapType>
+ChunkVersion RoutingTableHistory::_applyChangedChunks(
+    ChunkMapType* chunkMap, const std::vector<ChunkType>& changedChunks) const {
+    ChunkVersion collectionVersion = getVersion();
     for (const auto& chunk : changedChunks) {
         const auto& chunkVersion = chunk.getVersion();
 
@@ -534,11 +616,11 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
 
         // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
         // min
-        const auto low = chunkMap.upper_bound(chunkMinKeyString);
+        const auto low = upperBound(*chunkMap, chunkMinKeyString);
 
         // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
         // not overlap max
-        const auto high = chunkMap.upper_bound(chunkMaxKeyString);
+        const auto high = upperBound(*chunkMap, chunkMaxKeyString);
 
         // If we are in the middle of splitting a chunk, for the first few
         // chunks inserted, low == high, because both lookups will point to the
@@ -552,7 +634,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         // high, but low == chunkMap.end(), and we aren't doing a split in that
         // case.
         auto foundSingleChunk =
-            ((low == high || std::distance(low, high) == 1) && low != chunkMap.end());
+            ((low == high || std::distance(low, high) == 1) && low != chunkMap->end());
 
         auto newChunk = std::make_shared<ChunkInfo>(chunk);
         if (foundSingleChunk) {
@@ -563,10 +645,34 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         }
 
         // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        const auto pos = chunkMap->erase(low, high);
+
+        // Insert only the chunk itself. All chunks before 'pos' end at or before its min and the
+        // chunk at 'pos' ends after its max, so this keeps the chunks sorted.
+        chunkMap->insert(pos, std::make_pair(chunkMaxKeyString, newChunk));
+    }
 
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+    return collectionVersion;
+}
+
+std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
+    const std::vector<ChunkType>& changedChunks) {
+
+    const auto startingCollectionVersion = getVersion();
+
+    ChunkInfoMap chunkMap;
+    ChunkVersion collectionVersion;
+    if (changedChunks.size() <= kMaxChangedChunksToApplyInPlace) {
+        chunkMap = _chunkMap;
+        collectionVersion = _applyChangedChunks(&chunkMap, changedChunks);
+    } else {
+        ChunkInfoOrderedMap orderedChunkMap(_chunkMap.begin(), _chunkMap.end());
+        collectionVersion = _applyChangedChunks(&orderedChunkMap, changedChunks);
+
+        chunkMap.reserve(orderedChunkMap.size());
+        for (auto& entry : orderedChunkMap) {
+            chunkMap.emplace_back(entry.first, std::move(entry.second));
+        }
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
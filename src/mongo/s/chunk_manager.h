@@ -50,8 +50,10 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+// Array of the entries describing each chunk, paired with the KeyString of the chunk's max and
+// sorted by it. Kept flat rather than in a node-based map so that targeting binary searches
+// contiguous memory and copying it for a refresh is a single allocation.
+using ChunkInfoMap = std::vector<std::pair<std::string, std::shared_ptr<ChunkInfo>>>;
 
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
@@ -166,6 +168,14 @@ private:
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
 
+    /**
+     * Applies the changes in "changedChunks" to "chunkMap", which is either a ChunkInfoMap or an
+     * ordered map with the same entries, and returns the resulting collection version.
+     */
+    template <typename ChunkMapType>
+    ChunkVersion _applyChangedChunks(ChunkMapType* chunkMap,
+                                     const std::vector<ChunkType>& changedChunks) const;
+
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
     // ChunkManagers.
     const unsigned long long _sequenceNumber;
@@ -187,8 +197,8 @@ private:
     // Whether the sharding key is unique
     const bool _unique;
 
-    // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
-    // ranges must cover the complete space from [MinKey, MaxKey).
+    // Chunks sorted by the KeyString of their max. The union of all chunks' ranges must cover the
+    // complete space from [MinKey, MaxKey).
     const ChunkInfoMap _chunkMap;
 
     // Max version across all chunks
@@ -336,6 +346,16 @@ public:
         return findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec);
     }
 
+    /**
+     * Returns the ids of the shards owning the chunks which contain each of the given complete
+     * shard keys under the simple collation, in the same order as "shardKeys". The keys are looked
+     * up in sorted order with a single pass over the chunks, which is cheaper than calling
+     * findIntersectingChunkWithSimpleCollation() for each of them.
+     *
+     * Throws a DBException with the ShardKeyNotFound code if a key is not contained in any chunk.
+     */
+    std::vector<ShardId> getShardIdsForShardKeys(const std::vector<BSONObj>& shardKeys) const;
+
     /**
      * Finds the shard IDs for a given filter and collation. If collation is empty, we use the
      * collection default collation for targeting.
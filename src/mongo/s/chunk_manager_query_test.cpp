@@ -121,6 +121,26 @@ TEST_F(ChunkManagerQueryTest, GetShardIdsForRangeMinAndMaxAreTheSameAtLastChunkM
                                {ShardId("3")});
 }
 
+TEST_F(ChunkManagerQueryTest, GetShardIdsForShardKeysPreservesOrderOfKeys) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    const std::vector<BSONObj> splitPoints{BSON("a" << -100), BSON("a" << 0), BSON("a" << 100)};
+    auto chunkManager = makeChunkManager(kNss, shardKeyPattern, nullptr, false, splitPoints);
+
+    const auto shardIds = chunkManager->getShardIdsForShardKeys({BSON("a" << 150),
+                                                                 BSON("a" << -150),
+                                                                 BSON("a" << 0),
+                                                                 BSON("a" << 50),
+                                                                 BSON("a" << -150),
+                                                                 BSON("a" << -100)});
+    ASSERT_EQ(6U, shardIds.size());
+    ASSERT_EQ(ShardId("3"), shardIds[0]);
+    ASSERT_EQ(ShardId("0"), shardIds[1]);
+    ASSERT_EQ(ShardId("2"), shardIds[2]);
+    ASSERT_EQ(ShardId("2"), shardIds[3]);
+    ASSERT_EQ(ShardId("0"), shardIds[4]);
+    ASSERT_EQ(ShardId("1"), shardIds[5]);
+}
+
 TEST_F(ChunkManagerQueryTest, EmptyQuerySingleShard) {
     runQueryTest(BSON("a" << 1), nullptr, false, {}, BSONObj(), BSONObj(), {ShardId("0")});
 }
@@ -488,5 +508,28 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, HashedInMatchesTargetingOfEachValue) {
+    const ShardKeyPattern shardKeyPattern(BSON("a"
+                                               << "hashed"));
+    std::vector<BSONObj> splitPoints;
+    for (long long split = -4; split <= 4; ++split) {
+        splitPoints.push_back(BSON("a" << split * (1LL << 61)));
+    }
+    auto chunkManager = makeChunkManager(kNss, shardKeyPattern, nullptr, false, splitPoints);
+
+    BSONArrayBuilder values;
+    std::set<ShardId> expectedShardIds;
+    for (int i = 0; i < 200; i += 7) {
+        values << i;
+        chunkManager->getShardIdsForQuery(
+            operationContext(), BSON("a" << i), BSONObj(), &expectedShardIds);
+    }
+
+    std::set<ShardId> shardIds;
+    chunkManager->getShardIdsForQuery(
+        operationContext(), BSON("a" << BSON("$in" << values.arr())), BSONObj(), &shardIds);
+    ASSERT(expectedShardIds == shardIds);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -121,7 +121,42 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
+
+void BM_IncrementalRefreshAfterSplit(benchmark::State& state) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    const int nSplitPoints = state.range(2);
+    auto cm = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+
+    // Splits the chunk in the middle of the key space into nSplitPoints + 1 chunks.
+    auto postSplitVersion = cm->getChunkManager()->getVersion();
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    const auto chunkToSplit = getRangeForChunk(nChunks / 2, nChunks);
+    const auto splitMin = chunkToSplit.getMin()["_id"].numberInt();
+    const auto splitShard = optimalShardSelector(nChunks / 2, nShards, nChunks);
+
+    std::vector<ChunkType> newChunks;
+    BSONObj min = chunkToSplit.getMin();
+    for (int i = 1; i <= nSplitPoints + 1; ++i) {
+        const auto max = i <= nSplitPoints ? BSON("_id" << splitMin + i * 100 / (nSplitPoints + 1))
+                                           : chunkToSplit.getMax();
+        postSplitVersion.incMinor();
+        newChunks.emplace_back(collName, ChunkRange(min, max), postSplitVersion, splitShard);
+        min = max;
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+}
+
+BENCHMARK(BM_IncrementalRefreshAfterSplit)
+    ->Args({2, 50000, 1})
+    ->Args({2, 500000, 1})
+    ->Args({2, 500000, 32});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
@@ -347,6 +382,7 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({10, 50000})
             ->Args({100, 50000})
             ->Args({1000, 50000})
+            ->Args({10, 500000})
             ->Args({2, 2});
     }
 
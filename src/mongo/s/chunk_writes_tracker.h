@@ -63,6 +63,26 @@ public:
      */
     uint64_t clearBytesWritten();
 
+    /**
+     * Counts reads or writes of documents in the chunk.
+     */
+    void addOperations(uint64_t operations) {
+        _operations.fetchAndAdd(operations);
+    }
+
+    /**
+     * Returns the number of reads and writes counted since the last call to clearOperations.
+     */
+    uint64_t getOperations() {
+        return _operations.loadRelaxed();
+    }
+
+    /**
+     * Sets the number of operations in the tracker to zero and returns the number of operations
+     * in the tracker prior to clearing it.
+     */
+    uint64_t clearOperations();
+
     /**
      * Returns whether or not this chunk is ready to be split based on the
      * maximum allowable size of a chunk.
@@ -87,6 +107,13 @@ private:
      */
     AtomicWord<unsigned long long> _bytesWritten{0};
 
+    /**
+     * The number of documents read from or written to this chunk, which is how the balancer
+     * finds the chunks carrying most of a shard's load. Unlike the bytes written, it is not
+     * carried over to the chunks resulting from a split.
+     */
+    AtomicWord<unsigned long long> _operations{0};
+
     /**
      * Protects _splitState when starting a split.
      */
@@ -64,6 +64,22 @@ TEST(ChunkWritesTrackerTest, ClearBytesWrittenReturnsBytesWrittenBeforeClearing)
     ASSERT_EQ(previousBytesWritten, bytesToAdd);
 }
 
+TEST(ChunkWritesTrackerTest, AddOperationsCorrectlyAddsOperations) {
+    ChunkWritesTracker wt;
+    ASSERT_EQ(wt.getOperations(), 0ull);
+    wt.addOperations(3ull);
+    wt.addOperations(1ull);
+    ASSERT_EQ(wt.getOperations(), 4ull);
+    ASSERT_EQ(wt.getBytesWritten(), 0ull);
+}
+
+TEST(ChunkWritesTrackerTest, ClearOperationsReturnsOperationsBeforeClearing) {
+    ChunkWritesTracker wt;
+    wt.addOperations(4ull);
+    ASSERT_EQ(wt.clearOperations(), 4ull);
+    ASSERT_EQ(wt.getOperations(), 0ull);
+}
+
 TEST(ChunkWritesTrackerTest, ShouldSplitReturnsTrueWithBytesWrittenAndMaxChunkSizeZero) {
     ChunkWritesTracker wt;
     wt.addBytesWritten(4ull);
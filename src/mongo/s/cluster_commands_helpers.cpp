@@ -50,6 +50,7 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
 #include "mongo/s/request_types/create_database_gen.h"
+#include "mongo/s/routing_hint_index.h"
 #include "mongo/s/shard_id.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/transaction_router.h"
@@ -542,6 +543,8 @@ std::set<ShardId> getTargetedShardsForQuery(OperationContext* opCtx,
         // based on the query and collation.
         std::set<ShardId> shardIds;
         routingInfo.cm()->getShardIdsForQuery(opCtx, query, collation, &shardIds);
+        RoutingHintIndex::get(opCtx)->pruneShards(
+            opCtx, *routingInfo.cm(), query, collation, Date_t::now(), &shardIds);
         return shardIds;
     }
 
@@ -45,9 +45,12 @@
 #include "mongo/s/commands/strategy.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
+#include "mongo/s/routing_hint_index.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/transaction_router.h"
 #include "mongo/s/write_ops/cluster_write.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -168,6 +171,12 @@ public:
         // that the parsing be pulled into this function.
         uassertStatusOK(createShardDatabase(opCtx, nss.db()));
 
+        // The write may have been applied even if it failed.
+        ON_BLOCK_EXIT([&] {
+            ClusterQueryResultCache::get(opCtx)->onWrite(nss);
+            RoutingHintIndex::get(opCtx)->onWrite(nss);
+        });
+
         const auto routingInfo = uassertStatusOK(getCollectionRoutingInfoForTxnCmd(opCtx, nss));
         if (!routingInfo.cm()) {
             _runCommand(opCtx,
@@ -0,0 +1,187 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/s/catalog_cache.h"
+#include "mongo/s/cluster_commands_helpers.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/routing_hint_index.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+class RefreshRoutingHintsCmd : public BasicCommand {
+public:
+    RefreshRoutingHintsCmd() : BasicCommand("refreshRoutingHints") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "Records the range of values which each shard holds for the given fields of a "
+               "sharded collection, so that queries on those fields skip the shards which cannot "
+               "match them. The ranges are dropped when the routing table of the collection "
+               "changes, when this router sends a write to the collection, or after "
+               "'expireAfterSecs'. Writes through other routers are not detected before then.\n"
+               "Usage:\n"
+               "{refreshRoutingHints: 'db.coll', fields: ['zone'], expireAfterSecs: 60}\n"
+               "{refreshRoutingHints: 'db.coll', fields: []} drops the ranges";
+    }
+
+    std::string parseNs(const std::string& dbname, const BSONObj& cmdObj) const override {
+        return CommandHelpers::parseNsFullyQualified(cmdObj);
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet clusterActions;
+        clusterActions.addAction(ActionType::flushRouterConfig);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), clusterActions));
+
+        ActionSet collectionActions;
+        collectionActions.addAction(ActionType::find);
+        out->push_back(Privilege(
+            ResourcePattern::forExactNamespace(NamespaceString(parseNs(dbname, cmdObj))),
+            collectionActions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNs(dbname, cmdObj));
+
+        const auto fieldsElem = cmdObj["fields"];
+        uassert(ErrorCodes::TypeMismatch,
+                "'fields' must be an array of field paths",
+                fieldsElem.type() == Array);
+        std::vector<std::string> fields;
+        for (const auto& elem : fieldsElem.Obj()) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "Field path " << elem << " must be a non-empty string",
+                    elem.type() == String && !elem.valueStringData().empty() &&
+                        elem.valueStringData()[0] != '$');
+            fields.push_back(elem.str());
+        }
+
+        long long expireAfterSecs = 60;
+        if (const auto expireElem = cmdObj["expireAfterSecs"]) {
+            uassert(ErrorCodes::BadValue,
+                    "'expireAfterSecs' must be a positive number",
+                    expireElem.isNumber() && expireElem.safeNumberLong() > 0);
+            expireAfterSecs = expireElem.safeNumberLong();
+        }
+
+        auto routingInfo = uassertStatusOK(
+            Grid::get(opCtx)->catalogCache()->getCollectionRoutingInfo(opCtx, nss));
+        uassert(ErrorCodes::NamespaceNotSharded,
+                str::stream() << "Collection " << nss.ns() << " is not sharded.",
+                routingInfo.cm());
+
+        auto* const hintIndex = RoutingHintIndex::get(opCtx);
+        const auto writeGeneration = hintIndex->getWriteGeneration(nss);
+
+        RoutingHintIndex::ShardFieldRanges shardRanges;
+        if (!fields.empty()) {
+            BSONObjBuilder aggBuilder;
+            aggBuilder.append("aggregate", nss.coll());
+            aggBuilder.append("pipeline", RoutingHintIndex::makeStatsPipeline(fields));
+            aggBuilder.append("cursor", BSONObj());
+
+            // Every shard which owns chunks of the collection reports the ranges of its documents.
+            auto shardResults = scatterGatherVersionedTargetByRoutingTable(
+                opCtx,
+                nss.db(),
+                nss,
+                routingInfo,
+                aggBuilder.obj(),
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly),
+                Shard::RetryPolicy::kIdempotent,
+                {},
+                {});
+
+            for (const auto& shardResult : shardResults) {
+                const auto shardResponse = uassertStatusOK(std::move(shardResult.swResponse));
+                uassertStatusOK(shardResponse.status);
+                uassertStatusOK(getStatusFromCommandResult(shardResponse.data));
+
+                // The $group produces a single document, or none if the shard has no documents.
+                const auto cursorResponse =
+                    uassertStatusOK(CursorResponse::parseFromBSON(shardResponse.data));
+                const auto& batch = cursorResponse.getBatch();
+                shardRanges.emplace(
+                    shardResult.shardId,
+                    RoutingHintIndex::parseStats(batch.empty() ? BSONObj() : batch.front(),
+                                                 fields.size()));
+            }
+        }
+
+        const auto collectionVersion = routingInfo.cm()->getVersion();
+        const bool refreshed =
+            hintIndex->setHints(nss,
+                                collectionVersion,
+                                fields,
+                                std::move(shardRanges),
+                                writeGeneration,
+                                Date_t::now() + Seconds(expireAfterSecs));
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Collection " << nss.ns()
+                              << " was written while its routing hints were being refreshed",
+                refreshed);
+
+        LOG(1) << "Refreshed routing hints on " << fields.size() << " fields of " << nss.ns()
+               << " at version " << collectionVersion;
+
+        collectionVersion.appendLegacyWithField(&result, "version");
+        return true;
+    }
+
+} refreshRoutingHintsCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -31,14 +31,17 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/auth/action_set.h"
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/field_parser.h"
+#include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/cluster_commands_helpers.h"
@@ -84,6 +87,58 @@ BSONObj selectMedianKey(OperationContext* opCtx,
               "Unable to find median in chunk, possibly because chunk is empty.");
 }
 
+/**
+ * Splits the chunks of 'cm' at all of the sorted, normalized 'splitPoints'. All the split points
+ * which fall into the same chunk are committed by a single splitChunk request (or a few, if there
+ * are more than shardutil::kMaxSplitPoints of them), so pre-splitting a collection into many chunks
+ * costs one config server commit per existing chunk rather than one per split point.
+ */
+void splitAtMultiplePoints(OperationContext* opCtx,
+                           const NamespaceString& nss,
+                           const ChunkManager& cm,
+                           const std::vector<BSONObj>& splitPoints) {
+    auto it = splitPoints.begin();
+    while (it != splitPoints.end()) {
+        const auto chunk = cm.findIntersectingChunkWithSimpleCollation(*it);
+        uassert(ErrorCodes::InvalidOptions,
+                str::stream() << "new split key " << *it << " is a boundary key of existing chunk "
+                              << "["
+                              << chunk.getMin()
+                              << ","
+                              << chunk.getMax()
+                              << ")",
+                chunk.getMin().woCompare(*it) != 0);
+
+        // Collect the split points falling into this chunk
+        auto chunkEnd = std::find_if(it, splitPoints.end(), [&](const BSONObj& splitPoint) {
+            return !chunk.containsKey(splitPoint);
+        });
+
+        BSONObj batchMin = chunk.getMin();
+        while (it != chunkEnd) {
+            const auto batchSize = std::min<size_t>(chunkEnd - it, shardutil::kMaxSplitPoints);
+            const std::vector<BSONObj> batch(it, it + batchSize);
+            const ChunkRange batchRange(batchMin, chunk.getMax());
+
+            log() << "Splitting chunk " << redact(batchRange.toString()) << " in collection "
+                  << nss.ns() << " on shard " << chunk.getShardId() << " at " << batch.size()
+                  << " keys";
+
+            uassertStatusOK(shardutil::splitChunkAtMultiplePoints(opCtx,
+                                                                  chunk.getShardId(),
+                                                                  nss,
+                                                                  cm.getShardKeyPattern(),
+                                                                  cm.getVersion(),
+                                                                  batchRange,
+                                                                  batch));
+
+            // The remaining split points of this chunk fall into the last chunk produced above
+            batchMin = batch.back();
+            it += batchSize;
+        }
+    }
+}
+
 class SplitCollectionCmd : public ErrmsgCommandDeprecated {
 public:
     SplitCollectionCmd() : ErrmsgCommandDeprecated("split") {}
@@ -105,6 +160,8 @@ public:
                "   { split : 'alleyinsider.blog.posts' , find : { ts : 1 } }\n"
                " example: - split the shard that contains the key with this as the middle\n"
                "   { split : 'alleyinsider.blog.posts' , middle : { ts : 1 } }\n"
+               " example: - split the chunks that contain the given keys at all of these keys\n"
+               "   { split : 'alleyinsider.blog.posts' , middles : [ { ts : 1 }, { ts : 2 } ] }\n"
                " NOTE: this does not move the chunks, it just creates a logical separation.";
     }
 
@@ -138,6 +195,7 @@ public:
         const BSONField<BSONObj> findField("find", BSONObj());
         const BSONField<BSONArray> boundsField("bounds", BSONArray());
         const BSONField<BSONObj> middleField("middle", BSONObj());
+        const BSONField<BSONArray> middlesField("middles", BSONArray());
 
         BSONObj find;
         if (FieldParser::extract(cmdObj, findField, &find, &errmsg) == FieldParser::FIELD_INVALID) {
@@ -174,8 +232,53 @@ public:
             return false;
         }
 
+        BSONArray middles;
+        if (FieldParser::extract(cmdObj, middlesField, &middles, &errmsg) ==
+            FieldParser::FIELD_INVALID) {
+            return false;
+        }
+
+        if (!middles.isEmpty()) {
+            if (!find.isEmpty() || !bounds.isEmpty() || !middle.isEmpty()) {
+                errmsg = "cannot specify middles together with find, bounds or middle";
+                return false;
+            }
+
+            std::vector<BSONObj> splitPoints;
+            for (const auto& elem : middles) {
+                if (elem.type() != Object || !cm->getShardKeyPattern().isShardKey(elem.Obj())) {
+                    errmsg = str::stream() << "new split key " << elem
+                                           << " is not valid for shard key pattern "
+                                           << cm->getShardKeyPattern().toBSON();
+                    return false;
+                }
+
+                auto splitPoint = cm->getShardKeyPattern().normalizeShardKey(elem.Obj());
+
+                // Check shard key size when manually provided
+                uassertStatusOK(ShardKeyPattern::checkShardKeySize(splitPoint));
+
+                splitPoints.push_back(std::move(splitPoint));
+            }
+
+            std::sort(splitPoints.begin(),
+                      splitPoints.end(),
+                      SimpleBSONObjComparator::kInstance.makeLessThan());
+            splitPoints.erase(std::unique(splitPoints.begin(),
+                                          splitPoints.end(),
+                                          SimpleBSONObjComparator::kInstance.makeEqualTo()),
+                              splitPoints.end());
+
+            splitAtMultiplePoints(opCtx, nss, *cm, splitPoints);
+
+            // As for a single split, this only lets auto-split track statistics for the new chunks
+            Grid::get(opCtx)->catalogCache()->onStaleShardVersion(std::move(routingInfo));
+
+            return true;
+        }
+
         if (find.isEmpty() && bounds.isEmpty() && middle.isEmpty()) {
-            errmsg = "need to specify find/bounds or middle";
+            errmsg = "need to specify find/bounds, middle or middles";
             return false;
         }
 
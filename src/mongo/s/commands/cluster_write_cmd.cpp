@@ -46,12 +46,15 @@
 #include "mongo/s/commands/cluster_explain.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
+#include "mongo/s/routing_hint_index.h"
 #include "mongo/s/transaction_router.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
 #include "mongo/s/write_ops/chunk_manager_targeter.h"
 #include "mongo/s/write_ops/cluster_write.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -251,7 +254,14 @@ private:
 
         BatchWriteExecStats stats;
         BatchedCommandResponse response;
-        ClusterWriter::write(opCtx, batchedRequest, &stats, &response);
+        {
+            // Any part of the write may have been applied, even if it failed.
+            ON_BLOCK_EXIT([&] {
+                ClusterQueryResultCache::get(opCtx)->onWrite(batchedRequest.getNS());
+                RoutingHintIndex::get(opCtx)->onWrite(batchedRequest.getNS());
+            });
+            ClusterWriter::write(opCtx, batchedRequest, &stats, &response);
+        }
 
         // Populate the lastError object based on the write response
         batchErrorToLastError(batchedRequest, response, &LastError::get(opCtx->getClient()));
@@ -92,6 +92,11 @@ AsyncRequestsSender::Response MultiStatementTransactionRequestsSender::next() {
     return response;
 }
 
+void MultiStatementTransactionRequestsSender::addRequests(
+    const std::vector<AsyncRequestsSender::Request>& requests) {
+    _ars.addRequests(attachTxnDetails(_opCtx, requests));
+}
+
 void MultiStatementTransactionRequestsSender::stopRetrying() {
     _ars.stopRetrying();
 }
@@ -57,6 +57,8 @@ public:
 
     AsyncRequestsSender::Response next();
 
+    void addRequests(const std::vector<AsyncRequestsSender::Request>& requests);
+
     void stopRetrying();
 
 private:
@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/periodic_runner_job_refresh_catalog_cache.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/catalog_cache.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/periodic_runner_job_refresh_catalog_cache_gen.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+namespace {
+
+void refreshCatalogCache(Client* client) {
+    static int seconds = 0;
+    const int interval = catalogCacheBackgroundRefreshIntervalSecs.load();
+
+    if (interval == 0 || ++seconds < interval) {
+        return;
+    }
+
+    seconds = 0;
+
+    auto const grid = Grid::get(client->getServiceContext());
+    if (!grid->isShardingInitialized()) {
+        return;
+    }
+
+    // Only schedules the refreshes, which the catalog cache loader runs on its own threads.
+    grid->catalogCache()->refreshShardedCollectionsInBackground();
+}
+
+}  // namespace
+
+void startPeriodicThreadToRefreshCatalogCache(ServiceContext* serviceContext) {
+    // Enforce calling this function once, and only once.
+    static bool firstCall = true;
+    invariant(firstCall);
+    firstCall = false;
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    // PeriodicRunner does not currently support altering the period of a job. So we are giving this
+    // job a 1 second period on PeriodicRunner and incrementing a static variable 'seconds' on each
+    // run until we reach catalogCacheBackgroundRefreshIntervalSecs.
+    PeriodicRunner::PeriodicJob job(
+        "startPeriodicThreadToRefreshCatalogCache", refreshCatalogCache, Seconds(1));
+
+    periodicRunner->scheduleJob(std::move(job));
+}
+
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -102,7 +103,8 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
     for (const auto& remote : _params.getRemotes()) {
         _remotes.emplace_back(remote.getHostAndPort(),
                               remote.getCursorResponse().getNSS(),
-                              remote.getCursorResponse().getCursorId());
+                              remote.getCursorResponse().getCursorId(),
+                              remote.getShardId().toString());
 
         // We don't check the return value of _addBatchToBuffer here; if there was an error,
         // it will be stored in the remote and the first call to ready() will return true.
@@ -183,11 +185,31 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
         const auto newIndex = _remotes.size();
         _remotes.emplace_back(remote.getHostAndPort(),
                               remote.getCursorResponse().getNSS(),
-                              remote.getCursorResponse().getCursorId());
+                              remote.getCursorResponse().getCursorId(),
+                              remote.getShardId().toString());
         _addBatchToBuffer(lk, newIndex, remote.getCursorResponse());
     }
 }
 
+std::vector<BSONObj> AsyncResultsMerger::getRemoteStallTimes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const auto now = _executor->now();
+    std::vector<BSONObj> stallTimes;
+    stallTimes.reserve(_remotes.size());
+    for (const auto& remote : _remotes) {
+        // Include the wait which is still in progress, if any.
+        auto stallTime = remote.stallTime;
+        if (remote.stallStart) {
+            stallTime += now - *remote.stallStart;
+        }
+        stallTimes.push_back(BSON("shardId" << remote.shardId.toString() << "host"
+                                            << remote.shardHostAndPort.toString()
+                                            << "stallMillis"
+                                            << durationCount<Milliseconds>(stallTime)));
+    }
+    return stallTimes;
+}
+
 BSONObj AsyncResultsMerger::getHighWaterMark() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     auto minPromisedSortKey = _getMinPromisedSortKey(lk);
@@ -232,8 +254,9 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode == TailableModeEnum::kNormal);
 
-    for (const auto& remote : _remotes) {
-        if (!remote.hasNext() && !remote.exhausted()) {
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        const auto& remote = _remotes[i];
+        if (!remote.hasNext() && !remote.exhausted() && !_isCutOffByLimit(lk, i)) {
             return false;
         }
     }
@@ -290,7 +313,29 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+boost::optional<ClusterQueryRawBatch> AsyncResultsMerger::nextReadyRawBatch(size_t maxDocs) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    dassert(_ready(lk));
+    if (_lifecycleState != kAlive || !_status.isOK() || _eofNext || _params.getSort() ||
+        _tailableMode != TailableModeEnum::kNormal || _remotes.size() != 1) {
+        return boost::none;
+    }
+
+    auto& remote = _remotes[0];
+    if (!remote.status.isOK() || remote.rawBatch.isEmpty() || remote.docBuffer.size() > maxDocs) {
+        return boost::none;
+    }
+
+    ClusterQueryRawBatch batch{std::move(remote.rawBatch), remote.docBuffer.size()};
+    remote.rawBatch = BSONObj();
+    remote.docBuffer = std::queue<ClusterQueryResult>();
+    _bufferedBytes -= remote.rawBatchBytes;
+    remote.rawBatchBytes = 0;
+    _prefetchNextBatch(lk, 0);
+    return batch;
+}
+
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -306,6 +351,10 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    _remotes[smallestRemote].rawBatch = BSONObj();
+    _bufferedBytes -= front.getResult()->objsize();
+    ++_numReturned;
+    _prefetchNextBatch(lk, smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -322,7 +371,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
@@ -331,6 +380,9 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
         if (_remotes[_gettingFromRemote].hasNext()) {
             ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
             _remotes[_gettingFromRemote].docBuffer.pop();
+            _remotes[_gettingFromRemote].rawBatch = BSONObj();
+            _bufferedBytes -= front.getResult()->objsize();
+            _prefetchNextBatch(lk, _gettingFromRemote);
 
             if (_tailableMode == TailableModeEnum::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -412,6 +464,73 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     return Status::OK();
 }
 
+bool AsyncResultsMerger::_shouldPrefetch(WithLock, const RemoteCursorData& remote) const {
+    // Batches of tailable cursors are returned to the client as they arrive, and a getMore issued
+    // on behalf of a transaction would hold the transaction on the shard while the cursor is idle.
+    if (_tailableMode != TailableModeEnum::kNormal || _params.getTxnNumber()) {
+        return false;
+    }
+
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+        remote.cutOffByLimit) {
+        return false;
+    }
+
+    const auto thresholdDocs = static_cast<size_t>(internalQueryMergerPrefetchThresholdDocs.load());
+    const auto maxBufferedBytes =
+        static_cast<size_t>(internalQueryMergerPrefetchMaxBufferedBytes.load());
+    return remote.docBuffer.size() < thresholdDocs && _bufferedBytes < maxBufferedBytes;
+}
+
+void AsyncResultsMerger::_prefetchNextBatch(WithLock lk, size_t remoteIndex) {
+    // It is illegal to schedule a remote command on a user's behalf without an OperationContext.
+    if (!_opCtx || _lifecycleState != kAlive || !_shouldPrefetch(lk, _remotes[remoteIndex])) {
+        return;
+    }
+
+    _remotes[remoteIndex].status = _askForNextBatch(lk, remoteIndex);
+}
+
+bool AsyncResultsMerger::_isCutOffByLimit(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    if (remote.cutOffByLimit) {
+        return true;
+    }
+
+    // A tailable cursor has no end, so there is no limit to cut remotes off by.
+    if (!_params.getSort() || !_params.getLimit() || _tailableMode != TailableModeEnum::kNormal ||
+        remote.lastSortKey.isEmpty()) {
+        return false;
+    }
+
+    // Each remote returns its results in sort order, so a remote whose last buffered result sorts
+    // no later than 'lastSortKey' contributes all of its buffered results. Otherwise only its
+    // front result is known to qualify.
+    const long long needed = *_params.getLimit() - _numReturned;
+    long long qualifying = 0;
+    for (size_t i = 0; i < _remotes.size() && qualifying < needed; ++i) {
+        const auto& other = _remotes[i];
+        if (i == remoteIndex || other.docBuffer.empty()) {
+            continue;
+        }
+
+        auto frontKey = extractSortKey(*other.docBuffer.front().getResult(),
+                                       _params.getCompareWholeSortKey());
+        if (compareSortKeys(frontKey, remote.lastSortKey, *_params.getSort()) > 0) {
+            continue;
+        }
+
+        auto backKey = extractSortKey(*other.docBuffer.back().getResult(),
+                                      _params.getCompareWholeSortKey());
+        qualifying += compareSortKeys(backKey, remote.lastSortKey, *_params.getSort()) <= 0
+            ? static_cast<long long>(other.docBuffer.size())
+            : 1;
+    }
+
+    remote.cutOffByLimit = qualifying >= needed;
+    return remote.cutOffByLimit;
+}
+
 Status AsyncResultsMerger::scheduleGetMores() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return _scheduleGetMores(lk);
@@ -426,9 +545,11 @@ Status AsyncResultsMerger::_scheduleGetMores(WithLock lk) {
             return remote.status;
         }
 
-        if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
+        if ((!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid() &&
+             !_isCutOffByLimit(lk, i)) ||
+            _shouldPrefetch(lk, remote)) {
             // If this remote is not exhausted and there is no outstanding request for it, schedule
-            // work to retrieve the next batch.
+            // work to retrieve the next batch. Also do so if its buffer is running low.
             auto nextBatchStatus = _askForNextBatch(lk, i);
             if (!nextBatchStatus.isOK()) {
                 return nextBatchStatus;
@@ -467,6 +588,14 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
         return getMoresStatus;
     }
 
+    // The caller is about to wait for a batch from every remote which has nothing buffered.
+    const auto now = _executor->now();
+    for (auto& remote : _remotes) {
+        if (!remote.hasNext() && remote.cbHandle.isValid() && !remote.stallStart) {
+            remote.stallStart = now;
+        }
+    }
+
     auto eventStatus = _executor->makeEvent();
     if (!eventStatus.isOK()) {
         return eventStatus;
@@ -545,7 +674,12 @@ void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
                                               CbData const& cbData,
                                               size_t remoteIndex) {
     // Got a response from remote, so indicate we are no longer waiting for one.
-    _remotes[remoteIndex].cbHandle = executor::TaskExecutor::CallbackHandle();
+    auto& remote = _remotes[remoteIndex];
+    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    if (remote.stallStart) {
+        remote.stallTime += _executor->now() - *remote.stallStart;
+        remote.stallStart = boost::none;
+    }
 
     //  On shutdown, there is no need to process the response.
     if (_lifecycleState != kAlive) {
@@ -556,7 +690,7 @@ void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
     try {
         _processBatchResults(lk, cbData.response, remoteIndex);
     } catch (DBException const& e) {
-        _remotes[remoteIndex].status = e.toStatus();
+        remote.status = e.toStatus();
     }
     _signalCurrentEventIfReady(lk);  // Wake up anyone waiting on '_currentEvent'.
 }
@@ -589,9 +723,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
     if (_params.getAllowPartialResults() || remote.status == ErrorCodes::ExchangePassthrough) {
         remote.status = Status::OK();
 
-        // Clear the results buffer and cursor id.
-        std::queue<ClusterQueryResult> emptyBuffer;
-        std::swap(remote.docBuffer, emptyBuffer);
+        // Clear the cursor id. Any results which were prefetched before the failure remain
+        // buffered and are still returned.
         remote.cursorId = 0;
     }
 }
@@ -632,12 +765,16 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
     if (_tailableMode == TailableModeEnum::kTailable && !remote.hasNext()) {
         invariant(_remotes.size() == 1);
         _eofNext = true;
-    } else if (!remote.hasNext() && !remote.exhausted() && _lifecycleState == kAlive && _opCtx) {
+    } else if (!remote.hasNext() && !remote.exhausted() && _lifecycleState == kAlive && _opCtx &&
+               !_isCutOffByLimit(lk, remoteIndex)) {
         // If this is normal or tailable-awaitData cursor and we still don't have anything buffered
         // after receiving this batch, we can schedule work to retrieve the next batch right away.
         // Be careful only to do this when '_opCtx' is non-null, since it is illegal to schedule a
         // remote command on a user's behalf without a non-null OperationContext.
         remote.status = _askForNextBatch(lk, remoteIndex);
+    } else {
+        // The batch may have left fewer results buffered than we prefetch at.
+        _prefetchNextBatch(lk, remoteIndex);
     }
 }
 
@@ -646,6 +783,8 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     _updateRemoteMetadata(lk, remoteIndex, response);
+    const bool bufferWasEmpty = remote.docBuffer.empty();
+    const auto bufferedBytesBefore = _bufferedBytes;
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (_params.getSort()) {
@@ -669,13 +808,25 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
+        _bufferedBytes += obj.objsize();
         ++remote.fetchedCount;
     }
 
+    // The batch can only be handed out whole if none of the buffered results came from elsewhere.
+    if (bufferWasEmpty && !response.getRawBatch().isEmpty()) {
+        remote.rawBatch = response.getRawBatch();
+        remote.rawBatchBytes = _bufferedBytes - bufferedBytesBefore;
+    } else {
+        remote.rawBatch = BSONObj();
+    }
+
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
     if (_params.getSort() && !response.getBatch().empty()) {
         _mergeQueue.push(remoteIndex);
+        remote.lastSortKey =
+            extractSortKey(response.getBatch().back(), _params.getCompareWholeSortKey())
+                .getOwned();
     }
     return true;
 }
@@ -765,10 +916,12 @@ executor::TaskExecutor::EventHandle AsyncResultsMerger::kill(OperationContext* o
 
 AsyncResultsMerger::RemoteCursorData::RemoteCursorData(HostAndPort hostAndPort,
                                                        NamespaceString cursorNss,
-                                                       CursorId establishedCursorId)
+                                                       CursorId establishedCursorId,
+                                                       ShardId shardId)
     : cursorId(establishedCursorId),
       cursorNss(std::move(cursorNss)),
-      shardHostAndPort(std::move(hostAndPort)) {}
+      shardHostAndPort(std::move(hostAndPort)),
+      shardId(std::move(shardId)) {}
 
 const HostAndPort& AsyncResultsMerger::RemoteCursorData::getTargetHost() const {
     return shardHostAndPort;
@@ -40,6 +40,7 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
+#include "mongo/s/shard_id.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
@@ -167,6 +168,17 @@ public:
      */
     StatusWith<ClusterQueryResult> nextReady();
 
+    /**
+     * If this AsyncResultsMerger reads from a single remote without a sort, and the results
+     * buffered for that remote are exactly one unconsumed batch of at most 'maxDocs' documents,
+     * returns that batch as the BSON array received from the shard and removes it from the buffer.
+     * Otherwise returns boost::none and leaves the buffer untouched, in which case the caller should
+     * fall back to nextReady().
+     *
+     * Invalid to call unless ready() has returned true.
+     */
+    boost::optional<ClusterQueryRawBatch> nextReadyRawBatch(std::size_t maxDocs);
+
     /**
      * Schedules remote work as required in order to make further results available. If there is an
      * error in scheduling this work, returns a non-ok status. On success, returns an event handle.
@@ -214,6 +226,13 @@ public:
         return _remotes.size();
     }
 
+    /**
+     * Returns one document per remote, of the form {shardId: <string>, host: <string>,
+     * stallMillis: <long>}. 'stallMillis' is the total time for which the caller waited on
+     * nextEvent() while this remote had no buffered results and a batch from it was outstanding.
+     */
+    std::vector<BSONObj> getRemoteStallTimes() const;
+
     /**
      * For sorted tailable cursors, returns the most recent available sort key. This guarantees that
      * we will never return any future results which precede this key. If no results are ready to be
@@ -250,7 +269,8 @@ private:
     struct RemoteCursorData {
         RemoteCursorData(HostAndPort hostAndPort,
                          NamespaceString cursorNss,
-                         CursorId establishedCursorId);
+                         CursorId establishedCursorId,
+                         ShardId shardId);
 
         /**
          * Returns the resolved host and port on which the remote cursor resides.
@@ -292,6 +312,12 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // Set while 'docBuffer' holds exactly the documents of the last batch received, none of
+        // which have been returned yet. The batch as the BSON array sent by the remote, and the
+        // number of bytes its documents account for in '_bufferedBytes'.
+        BSONObj rawBatch;
+        size_t rawBatchBytes = 0;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -302,6 +328,22 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Set while the caller of nextEvent() is waiting on a batch from this remote because it has
+        // no buffered results. Records when the wait began.
+        boost::optional<Date_t> stallStart;
+
+        // The total time the caller of nextEvent() has spent waiting on batches from this remote.
+        Milliseconds stallTime{0};
+
+        // For sorted merges, the sort key of the last result received from this remote. Every
+        // result the remote has yet to send sorts after it.
+        BSONObj lastSortKey;
+
+        // Set once enough results which sort before 'lastSortKey' are buffered from the other
+        // remotes to satisfy the merge's limit, so that no further batch from this remote can make
+        // it into the results. No more batches are requested from a remote in this state.
+        bool cutOffByLimit = false;
     };
 
     class MergingComparator {
@@ -356,6 +398,28 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * Returns whether the next batch should be requested from 'remote' before all of its buffered
+     * results have been returned. A remote is prefetched once fewer than
+     * 'internalQueryMergerPrefetchThresholdDocs' of its results remain buffered, unless the results
+     * buffered from all remotes exceed 'internalQueryMergerPrefetchMaxBufferedBytes'.
+     */
+    bool _shouldPrefetch(WithLock, const RemoteCursorData& remote) const;
+
+    /**
+     * Asks the remote at 'remoteIndex' for its next batch if _shouldPrefetch() allows it. Any error
+     * scheduling the request is recorded in the remote's status.
+     */
+    void _prefetchNextBatch(WithLock, size_t remoteIndex);
+
+    /**
+     * For sorted merges with a limit, returns whether the remote at 'remoteIndex' can no longer
+     * contribute to the results because the buffered results of the other remotes which sort
+     * no later than its last sort key already fill the remainder of the limit. Once this returns
+     * true for a remote, it keeps returning true.
+     */
+    bool _isCutOffByLimit(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -464,6 +528,12 @@ private:
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
 
+    // The total size of the results buffered from all remotes.
+    size_t _bufferedBytes = 0;
+
+    // The number of results returned by nextReady(). Used only if there is a sort and a limit.
+    long long _numReturned = 0;
+
     Status _status = Status::OK();
 
     executor::TaskExecutor::EventHandle _currentEvent;
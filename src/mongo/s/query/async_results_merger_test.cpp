@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/resume_token.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/client/shard_registry.h"
@@ -44,6 +45,7 @@
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -112,6 +114,45 @@ TEST_F(AsyncResultsMergerTest, SingleShardUnsorted) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SingleShardUnsortedReturnsRawBatch) {
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, {})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
+    responses.emplace_back(kTestNss, CursorId(5), batch);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+
+    // A batch larger than the caller can take is left in the buffer.
+    ASSERT_FALSE(arm->nextReadyRawBatch(2));
+
+    // The whole batch is returned as the array the shard sent.
+    auto rawBatch = arm->nextReadyRawBatch(3);
+    ASSERT_TRUE(rawBatch);
+    ASSERT_EQ(3U, rawBatch->numDocs);
+    ASSERT_BSONOBJ_EQ(fromjson("{'0': {_id: 1}, '1': {_id: 2}, '2': {_id: 3}}"), rawBatch->docs);
+    ASSERT_FALSE(arm->ready());
+
+    // Once a result of a batch has been returned on its own, the rest of it cannot be returned
+    // whole.
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    responses.clear();
+    batch = {fromjson("{_id: 4}"), fromjson("{_id: 5}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(arm->nextReadyRawBatch(10));
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 5}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SingleShardSorted) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
     std::vector<RemoteCursor> cursors;
@@ -1115,6 +1156,96 @@ TEST_F(AsyncResultsMergerTest, GetMoreBatchSizes) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortedPrefetchesNextBatchWhenBufferRunsLow) {
+    const auto oldThreshold = internalQueryMergerPrefetchThresholdDocs.load();
+    internalQueryMergerPrefetchThresholdDocs.store(2);
+    ON_BLOCK_EXIT([&] { internalQueryMergerPrefetchThresholdDocs.store(oldThreshold); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, {})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                   fromjson("{$sortKey: {'': 2}}"),
+                                   fromjson("{$sortKey: {'': 3}}")};
+    scheduleNetworkResponse(CursorResponse(kTestNss, CursorId(5), batch1));
+    executor()->waitForEvent(readyEvent);
+
+    // Three results are buffered, so no further batch is requested yet.
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 1}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Returning the second result leaves fewer buffered results than the threshold, so the next
+    // batch is requested while the last buffered result can still be returned.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 2}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 3}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(arm->ready());
+
+    // Waiting on the outstanding batch does not schedule another request.
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 4}}")};
+    scheduleNetworkResponse(CursorResponse(kTestNss, CursorId(0), batch2));
+    executor()->waitForEvent(readyEvent);
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 4}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+
+    auto stallTimes = arm->getRemoteStallTimes();
+    ASSERT_EQ(1U, stallTimes.size());
+    ASSERT_EQ(kTestShardIds[0].toString(), stallTimes[0]["shardId"].str());
+    ASSERT_EQ(kTestShardHosts[0].toString(), stallTimes[0]["host"].str());
+    ASSERT_TRUE(stallTimes[0].hasField("stallMillis"));
+}
+
+TEST_F(AsyncResultsMergerTest, SortedWithLimitStopsFetchingFromRemotesThatCannotContribute) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 5}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, CursorId(5), batch1)));
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 1}}"),
+                                   fromjson("{$sortKey: {'': 2}}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, CursorId(6), batch2)));
+    auto params = makeARMParamsFromExistingCursors(std::move(cursors), findCmd);
+    params.setLimit(2);
+    auto arm =
+        stdx::make_unique<AsyncResultsMerger>(operationContext(), executor(), std::move(params));
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 1}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 2}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    // The second remote has run out of buffered results, but the limit has been reached, so the
+    // merger neither waits on nor asks for its next batch.
+    ASSERT_TRUE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    executor()->waitForEvent(readyEvent);
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Kill the cursor before deleting it, as neither remote cursor has been exhausted.
+    auto killEvent = arm->kill(operationContext());
+    executor()->waitForEvent(killEvent);
+}
+
 TEST_F(AsyncResultsMergerTest, AllowPartialResults) {
     BSONObj findCmd = fromjson("{find: 'testcoll', allowPartialResults: true}");
     std::vector<RemoteCursor> cursors;
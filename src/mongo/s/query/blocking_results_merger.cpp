@@ -110,7 +110,7 @@ StatusWith<ClusterQueryResult> BlockingResultsMerger::awaitNextWithTimeout(
     return _arm.ready() ? _arm.nextReady() : ClusterQueryResult{};
 }
 
-StatusWith<ClusterQueryResult> BlockingResultsMerger::blockUntilNext(OperationContext* opCtx) {
+Status BlockingResultsMerger::blockUntilReady(OperationContext* opCtx) {
     while (!_arm.ready()) {
         auto nextEventStatus = _arm.nextEvent();
         if (!nextEventStatus.isOK()) {
@@ -131,8 +131,31 @@ StatusWith<ClusterQueryResult> BlockingResultsMerger::blockUntilNext(OperationCo
         invariant(status.getValue() == stdx::cv_status::no_timeout);
     }
 
+    return Status::OK();
+}
+
+StatusWith<ClusterQueryResult> BlockingResultsMerger::blockUntilNext(OperationContext* opCtx) {
+    auto status = blockUntilReady(opCtx);
+    if (!status.isOK()) {
+        return status;
+    }
     return _arm.nextReady();
 }
+
+StatusWith<boost::optional<ClusterQueryRawBatch>> BlockingResultsMerger::nextRawBatch(
+    OperationContext* opCtx, std::size_t maxDocs) {
+    // AwaitData cursors must be able to give up waiting once their time limit is exceeded, which
+    // only next() knows how to do.
+    if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
+        return {boost::none};
+    }
+
+    auto status = blockUntilReady(opCtx);
+    if (!status.isOK()) {
+        return status;
+    }
+    return _arm.nextReadyRawBatch(maxDocs);
+}
 StatusWith<ClusterQueryResult> BlockingResultsMerger::next(OperationContext* opCtx,
                                                            RouterExecStage::ExecContext execCtx) {
     // Non-tailable and tailable non-awaitData cursors always block until ready(). AwaitData
@@ -50,6 +50,15 @@ public:
      */
     StatusWith<ClusterQueryResult> next(OperationContext*, RouterExecStage::ExecContext);
 
+    /**
+     * Blocks until results are available or an error is detected, then returns the next whole
+     * batch received from the single remote if the ARM can hand it out unchanged (see
+     * AsyncResultsMerger::nextReadyRawBatch()). Returns boost::none if results must instead be
+     * consumed one at a time through next().
+     */
+    StatusWith<boost::optional<ClusterQueryRawBatch>> nextRawBatch(OperationContext* opCtx,
+                                                                   std::size_t maxDocs);
+
     Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) {
         return _arm.setAwaitDataTimeout(awaitDataTimeout);
     }
@@ -70,6 +79,10 @@ public:
         return _arm.getNumRemotes();
     }
 
+    std::vector<BSONObj> getRemoteStallTimes() const {
+        return _arm.getRemoteStallTimes();
+    }
+
     BSONObj getHighWaterMark() {
         return _arm.getHighWaterMark();
     }
@@ -85,6 +98,11 @@ public:
     void kill(OperationContext* opCtx);
 
 private:
+    /**
+     * Waits with no time limit until the ARM is ready.
+     */
+    Status blockUntilReady(OperationContext* opCtx);
+
     /**
      * Awaits the next result from the ARM with no time limit.
      */
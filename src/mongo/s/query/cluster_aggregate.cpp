@@ -226,10 +226,11 @@ Status appendExplainResults(sharded_agg_helpers::DispatchShardPipelineResults&&
     if (dispatchResults.splitPipeline) {
         auto* mergePipeline = dispatchResults.splitPipeline->mergePipeline.get();
         const char* mergeType = [&]() {
-            if (mergePipeline->canRunOnMongos()) {
-                return "mongos";
-            } else if (dispatchResults.exchangeSpec) {
+            if (dispatchResults.exchangeSpec) {
+                // A $group merged through an exchange could also have been merged on mongos.
                 return "exchange";
+            } else if (mergePipeline->canRunOnMongos()) {
+                return "mongos";
             } else if (mergePipeline->needsPrimaryShardMerger()) {
                 return "primaryShard";
             } else {
@@ -31,6 +31,8 @@
 
 #include "mongo/s/query/cluster_aggregation_planner.h"
 
+#include <limits>
+
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -492,6 +494,15 @@ void addMergeCursorsSource(Pipeline* mergePipeline,
     armParams.setTailableMode(mergePipeline->getContext()->tailableMode);
     armParams.setNss(mergePipeline->getContext()->ns);
 
+    // A $sort with a limit leaves a $limit at the front of the merging pipeline. Pass the limit on
+    // so that the merger stops fetching from shards whose results can no longer make the cut.
+    if (shardCursorsSortSpec && !mergePipeline->getSources().empty()) {
+        if (auto limit =
+                dynamic_cast<DocumentSourceLimit*>(mergePipeline->getSources().front().get())) {
+            armParams.setLimit(limit->getLimit());
+        }
+    }
+
     OperationSessionInfoFromClient sessionInfo;
     boost::optional<LogicalSessionFromClient> lsidFromClient;
 
@@ -588,5 +599,70 @@ boost::optional<ShardedExchangePolicy> checkIfEligibleForExchange(OperationConte
     return walkPipelineBackwardsTrackingShardKey(opCtx, outStage, mergePipeline, *routingInfo.cm());
 }
 
+boost::optional<ShardedExchangePolicy> checkIfEligibleForGroupExchange(
+    const Pipeline* mergePipeline, const std::set<ShardId>& targetedShards) {
+    if (internalQueryDisableExchange.load()) {
+        return boost::none;
+    }
+
+    const auto numConsumers = std::min(
+        static_cast<size_t>(internalQueryMaxGroupMergeConsumers.load()), targetedShards.size());
+    if (numConsumers < 2 || mergePipeline->getSources().empty()) {
+        return boost::none;
+    }
+
+    // The group keys are hashed as they are, so keys which are only equal under a collation would
+    // end up on different consumers.
+    if (mergePipeline->getContext()->getCollator()) {
+        return boost::none;
+    }
+
+    const auto& stages = mergePipeline->getSources();
+    const auto group = dynamic_cast<DocumentSourceGroup*>(stages.front().get());
+    if (!group || !group->doingMerge()) {
+        return boost::none;
+    }
+
+    // The results of the consumers are only concatenated, so every stage after the $group has to
+    // produce the same results when run separately on each consumer's groups.
+    for (auto it = std::next(stages.begin()); it != stages.end(); ++it) {
+        const auto hostRequirement =
+            (*it)->constraints(Pipeline::SplitState::kSplitForMerge).hostRequirement;
+        if ((*it)->mergingLogic() ||
+            (hostRequirement != StageConstraints::HostTypeRequirement::kNone &&
+             hostRequirement != StageConstraints::HostTypeRequirement::kAnyShard)) {
+            return boost::none;
+        }
+    }
+
+    // The partial groups carry their group key in '_id'. Split the range of its 64-bit hash evenly
+    // between the consumers.
+    std::vector<BSONObj> boundaries;
+    std::vector<int> consumerIds;
+    const auto rangePerConsumer = std::numeric_limits<std::uint64_t>::max() / numConsumers;
+    boundaries.emplace_back(BSON("_id" << MINKEY));
+    for (size_t i = 1; i < numConsumers; ++i) {
+        const auto splitPoint = static_cast<std::uint64_t>(std::numeric_limits<long long>::min()) +
+            i * rangePerConsumer;
+        boundaries.emplace_back(BSON("_id" << static_cast<long long>(splitPoint)));
+    }
+    boundaries.emplace_back(BSON("_id" << MAXKEY));
+    for (size_t i = 0; i < numConsumers; ++i) {
+        consumerIds.emplace_back(i);
+    }
+
+    ExchangeSpec exchangeSpec;
+    exchangeSpec.setPolicy(ExchangePolicyEnum::kKeyRange);
+    exchangeSpec.setKey(BSON("_id"
+                             << "hashed"));
+    exchangeSpec.setBoundaries(std::move(boundaries));
+    exchangeSpec.setConsumers(numConsumers);
+    exchangeSpec.setConsumerIds(std::move(consumerIds));
+
+    std::vector<ShardId> consumerShards(targetedShards.begin(),
+                                        std::next(targetedShards.begin(), numConsumers));
+    return ShardedExchangePolicy{std::move(exchangeSpec), std::move(consumerShards)};
+}
+
 }  // namespace cluster_aggregation_planner
 }  // namespace mongo
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <set>
+
 #include "mongo/db/pipeline/exchange_spec_gen.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -109,5 +111,14 @@ struct ShardedExchangePolicy {
  */
 boost::optional<ShardedExchangePolicy> checkIfEligibleForExchange(OperationContext* opCtx,
                                                                   const Pipeline* mergePipeline);
+
+/**
+ * If the merging pipeline starts with the merging half of a $group and none of the stages after it
+ * needs a single input stream, returns an $exchange policy which partitions the partial groups by a
+ * hash of their group key among up to 'internalQueryMaxGroupMergeConsumers' of 'targetedShards'.
+ * Each of these shards then merges a disjoint set of groups.
+ */
+boost::optional<ShardedExchangePolicy> checkIfEligibleForGroupExchange(
+    const Pipeline* mergePipeline, const std::set<ShardId>& targetedShards);
 }  // namespace cluster_aggregation_planner
 }  // namespace mongo
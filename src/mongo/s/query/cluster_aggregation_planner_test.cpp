@@ -43,6 +43,7 @@
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
 #include "mongo/s/query/cluster_aggregation_planner.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
 
@@ -597,5 +598,51 @@ TEST_F(ClusterExchangeTest, CompoundShardKeyThreeShards) {
 
     future.timed_get(kFutureTimeout);
 }
+
+TEST_F(ClusterExchangeTest, GroupMergeIsEligibleForHashedExchange) {
+    const auto originalMaxConsumers = internalQueryMaxGroupMergeConsumers.load();
+    internalQueryMaxGroupMergeConsumers.store(2);
+    ON_BLOCK_EXIT([&] { internalQueryMaxGroupMergeConsumers.store(originalMaxConsumers); });
+
+    auto mergePipe = unittest::assertGet(
+        Pipeline::create({parse("{$group: {_id: '$x', $doingMerge: true}}"),
+                          parse("{$project: {_id: 1}}")},
+                         expCtx()));
+    auto exchangeSpec = cluster_aggregation_planner::checkIfEligibleForGroupExchange(
+        mergePipe.get(), {ShardId("0"), ShardId("1"), ShardId("2")});
+    ASSERT_TRUE(exchangeSpec);
+    ASSERT(exchangeSpec->exchangeSpec.getPolicy() == ExchangePolicyEnum::kKeyRange);
+    ASSERT_BSONOBJ_EQ(exchangeSpec->exchangeSpec.getKey(),
+                      BSON("_id"
+                           << "hashed"));
+    ASSERT_EQ(exchangeSpec->consumerShards.size(), 2UL);
+    ASSERT_EQ(exchangeSpec->consumerShards[0], ShardId("0"));
+    ASSERT_EQ(exchangeSpec->consumerShards[1], ShardId("1"));
+
+    const auto& boundaries = exchangeSpec->exchangeSpec.getBoundaries().get();
+    ASSERT_EQ(boundaries.size(), 3UL);
+    ASSERT_BSONOBJ_EQ(boundaries[0], BSON("_id" << MINKEY));
+    ASSERT_EQ(boundaries[1]["_id"].type(), BSONType::NumberLong);
+    ASSERT_BSONOBJ_EQ(boundaries[2], BSON("_id" << MAXKEY));
+}
+
+TEST_F(ClusterExchangeTest, GroupMergeFollowedBySortIsNotEligibleForHashedExchange) {
+    const auto originalMaxConsumers = internalQueryMaxGroupMergeConsumers.load();
+    internalQueryMaxGroupMergeConsumers.store(2);
+    ON_BLOCK_EXIT([&] { internalQueryMaxGroupMergeConsumers.store(originalMaxConsumers); });
+
+    auto mergePipe = unittest::assertGet(Pipeline::create(
+        {parse("{$group: {_id: '$x', $doingMerge: true}}"), parse("{$sort: {_id: 1}}")},
+        expCtx()));
+    ASSERT_FALSE(cluster_aggregation_planner::checkIfEligibleForGroupExchange(
+        mergePipe.get(), {ShardId("0"), ShardId("1")}));
+
+    // Without a $sort, merging on a single shard is still the default.
+    mergePipe = unittest::assertGet(
+        Pipeline::create({parse("{$group: {_id: '$x', $doingMerge: true}}")}, expCtx()));
+    internalQueryMaxGroupMergeConsumers.store(1);
+    ASSERT_FALSE(cluster_aggregation_planner::checkIfEligibleForGroupExchange(
+        mergePipe.get(), {ShardId("0"), ShardId("1")}));
+}
 }  // namespace
 }  // namespace mongo
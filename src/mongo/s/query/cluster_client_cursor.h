@@ -72,6 +72,15 @@ public:
      */
     virtual StatusWith<ClusterQueryResult> next(RouterExecStage::ExecContext) = 0;
 
+    /**
+     * Returns the next whole batch of at most 'maxDocs' results as the single remote cursor sent
+     * it, if the batch can be passed to the client unchanged. Returns boost::none, leaving the
+     * results in place, if they must instead be consumed through next(). May block waiting for
+     * results from remote nodes.
+     */
+    virtual StatusWith<boost::optional<ClusterQueryRawBatch>> nextRawBatch(
+        std::size_t maxDocs) = 0;
+
     /**
      * Must be called before destruction to abandon a not-yet-exhausted cursor. If next() has
      * already returned boost::none, then the cursor is exhausted and is safe to destroy.
@@ -123,6 +132,12 @@ public:
      */
     virtual std::size_t getNumRemotes() const = 0;
 
+    /**
+     * Returns one document per remote host describing how long this cursor has waited on it. See
+     * AsyncResultsMerger::getRemoteStallTimes().
+     */
+    virtual std::vector<BSONObj> getRemoteStallTimes() const = 0;
+
     /**
      * Returns the current most-recent resume token for this cursor, or an empty object if this is
      * not a $changeStream cursor.
@@ -127,6 +127,26 @@ StatusWith<ClusterQueryResult> ClusterClientCursorImpl::next(
     return next;
 }
 
+StatusWith<boost::optional<ClusterQueryRawBatch>> ClusterClientCursorImpl::nextRawBatch(
+    std::size_t maxDocs) {
+    invariant(_opCtx);
+    const auto interruptStatus = _opCtx->checkForInterruptNoAssert();
+    if (!interruptStatus.isOK()) {
+        return interruptStatus;
+    }
+
+    // Stashed results have to be returned first, one at a time.
+    if (!_stash.empty()) {
+        return {boost::none};
+    }
+
+    auto batch = _root->nextRawBatch(maxDocs);
+    if (batch.isOK() && batch.getValue()) {
+        _numReturnedSoFar += batch.getValue()->numDocs;
+    }
+    return batch;
+}
+
 void ClusterClientCursorImpl::kill(OperationContext* opCtx) {
     _root->kill(opCtx);
 }
@@ -165,6 +185,10 @@ std::size_t ClusterClientCursorImpl::getNumRemotes() const {
     return _root->getNumRemotes();
 }
 
+std::vector<BSONObj> ClusterClientCursorImpl::getRemoteStallTimes() const {
+    return _root->getRemoteStallTimes();
+}
+
 BSONObj ClusterClientCursorImpl::getPostBatchResumeToken() const {
     return _root->getPostBatchResumeToken();
 }
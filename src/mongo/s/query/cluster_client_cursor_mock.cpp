@@ -66,6 +66,11 @@ StatusWith<ClusterQueryResult> ClusterClientCursorMock::next(
     return out.getValue();
 }
 
+StatusWith<boost::optional<ClusterQueryRawBatch>> ClusterClientCursorMock::nextRawBatch(
+    std::size_t maxDocs) {
+    return {boost::none};
+}
+
 BSONObj ClusterClientCursorMock::getOriginatingCommand() const {
     return _originatingCommand;
 }
@@ -78,6 +83,10 @@ std::size_t ClusterClientCursorMock::getNumRemotes() const {
     MONGO_UNREACHABLE;
 }
 
+std::vector<BSONObj> ClusterClientCursorMock::getRemoteStallTimes() const {
+    return {};
+}
+
 BSONObj ClusterClientCursorMock::getPostBatchResumeToken() const {
     MONGO_UNREACHABLE;
 }
@@ -51,6 +51,8 @@ public:
 
     StatusWith<ClusterQueryResult> next(RouterExecStage::ExecContext) final;
 
+    StatusWith<boost::optional<ClusterQueryRawBatch>> nextRawBatch(std::size_t maxDocs) final;
+
     void kill(OperationContext* opCtx) final;
 
     void reattachToOperationContext(OperationContext* opCtx) final {
@@ -76,6 +78,8 @@ public:
 
     std::size_t getNumRemotes() const final;
 
+    std::vector<BSONObj> getRemoteStallTimes() const final;
+
     BSONObj getPostBatchResumeToken() const final;
 
     long long getNumReturnedSoFar() const final;
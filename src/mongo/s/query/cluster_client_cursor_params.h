@@ -85,6 +85,10 @@ struct ClusterClientCursorParams {
         armParams.setRemotes(std::move(remotes));
         armParams.setTailableMode(tailableMode);
         armParams.setBatchSize(batchSize);
+        if (!sort.isEmpty() && limit) {
+            // The merger has to produce the skipped results as well as the limited ones.
+            armParams.setLimit(*limit + skip.value_or(0));
+        }
         armParams.setNss(nsString);
         armParams.setAllowPartialResults(isAllowPartialResults);
 
@@ -119,6 +119,12 @@ StatusWith<ClusterQueryResult> ClusterCursorManager::PinnedCursor::next(
     return _cursor->next(execContext);
 }
 
+StatusWith<boost::optional<ClusterQueryRawBatch>> ClusterCursorManager::PinnedCursor::nextRawBatch(
+    std::size_t maxDocs) {
+    invariant(_cursor);
+    return _cursor->nextRawBatch(maxDocs);
+}
+
 bool ClusterCursorManager::PinnedCursor::isTailable() const {
     invariant(_cursor);
     return _cursor->isTailable();
@@ -217,6 +223,7 @@ GenericCursor ClusterCursorManager::PinnedCursor::toGenericCursor() const {
     gc.setLastAccessDate(getLastUseDate());
     gc.setCreatedDate(getCreatedDate());
     gc.setNBatchesReturned(getNBatches());
+    gc.setRemoteStallTimes(_cursor->getRemoteStallTimes());
     return gc;
 }
 
@@ -636,6 +643,7 @@ GenericCursor ClusterCursorManager::CursorEntry::cursorToGenericCursor(
     gc.setOriginatingCommand(_cursor->getOriginatingCommand());
     gc.setNoCursorTimeout(getLifetimeType() == CursorLifetime::Immortal);
     gc.setNBatchesReturned(_cursor->getNBatches());
+    gc.setRemoteStallTimes(_cursor->getRemoteStallTimes());
     return gc;
 }
 
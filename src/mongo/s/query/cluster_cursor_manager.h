@@ -164,6 +164,14 @@ public:
          */
         StatusWith<ClusterQueryResult> next(RouterExecStage::ExecContext);
 
+        /**
+         * Calls nextRawBatch() on the underlying cursor. Cannot be called after returnCursor() is
+         * called. A cursor must be owned.
+         *
+         * Can block.
+         */
+        StatusWith<boost::optional<ClusterQueryRawBatch>> nextRawBatch(std::size_t maxDocs);
+
         /**
          * Returns whether or not the underlying cursor is tailing a capped collection.  Cannot be
          * called after returnCursor() is called.  A cursor must be owned.
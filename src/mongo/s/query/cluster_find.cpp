@@ -33,6 +33,7 @@
 
 #include "mongo/s/query/cluster_find.h"
 
+#include <limits>
 #include <set>
 #include <vector>
 
@@ -49,6 +50,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/catalog_cache.h"
@@ -58,6 +60,8 @@
 #include "mongo/s/query/async_results_merger.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/establish_cursors.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
@@ -209,6 +213,75 @@ std::vector<std::pair<ShardId, BSONObj>> constructRequestsForShards(
     return requests;
 }
 
+/**
+ * Returns whether the results of 'query' may be returned from and added to the
+ * ClusterQueryResultCache.
+ */
+bool canUseResultCache(OperationContext* opCtx, const CanonicalQuery& query) {
+    if (internalQueryMongosResultCacheTTLSecs.load() <= 0) {
+        return false;
+    }
+
+    // The cluster's metadata must always be read from the shards.
+    if (query.nss().isOnInternalDb()) {
+        return false;
+    }
+
+    const auto& qr = query.getQueryRequest();
+    if (qr.isTailable() || qr.isAllowPartialResults()) {
+        return false;
+    }
+
+    // Transactions and causally consistent reads must observe writes made through other routers.
+    if (opCtx->getTxnNumber() || TransactionRouter::get(opCtx)) {
+        return false;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getArgsAfterClusterTime() || readConcernArgs.getArgsAtClusterTime() ||
+        readConcernArgs.getArgsOpTime()) {
+        return false;
+    }
+
+    const auto level = readConcernArgs.getLevel();
+    return level == repl::ReadConcernLevel::kLocalReadConcern ||
+        level == repl::ReadConcernLevel::kAvailableReadConcern;
+}
+
+/**
+ * Describes 'query' and the read preference it runs with, which together determine its results.
+ */
+BSONObj makeResultCacheQuery(const CanonicalQuery& query, const ReadPreferenceSetting& readPref) {
+    BSONObjBuilder builder;
+    query.getQueryRequest().asFindCommand(&builder);
+    readPref.toContainingBSON(&builder);
+    return builder.obj();
+}
+
+/**
+ * Describes the versions of the shards which 'query' targets according to 'routingInfo'. Cached
+ * results of the query may only be returned while these stay the same.
+ */
+BSONObj makeResultCacheRoutingVersions(OperationContext* opCtx,
+                                       const CanonicalQuery& query,
+                                       const CachedCollectionRoutingInfo& routingInfo) {
+    BSONObjBuilder builder;
+    if (!routingInfo.cm()) {
+        builder.append("primary", routingInfo.db().primaryId().toString());
+        builder.append("databaseVersion", routingInfo.db().databaseVersion().toBSON());
+        return builder.obj();
+    }
+
+    const auto shardIds = getTargetedShardsForQuery(opCtx,
+                                                    routingInfo,
+                                                    query.getQueryRequest().getFilter(),
+                                                    query.getQueryRequest().getCollation());
+    for (const auto& shardId : shardIds) {
+        routingInfo.cm()->getVersion(shardId).appendWithField(&builder, shardId.toString());
+    }
+    return builder.obj();
+}
+
 CursorId runQueryWithoutRetrying(OperationContext* opCtx,
                                  const CanonicalQuery& query,
                                  const ReadPreferenceSetting& readPref,
@@ -416,6 +489,11 @@ CursorId ClusterFind::runQuery(OperationContext* opCtx,
 
     auto const catalogCache = Grid::get(opCtx)->catalogCache();
 
+    auto const resultCache = ClusterQueryResultCache::get(opCtx);
+    const bool useResultCache = canUseResultCache(opCtx, query);
+    const auto resultCacheQuery =
+        useResultCache ? makeResultCacheQuery(query, readPref) : BSONObj();
+
     // Re-target and re-send the initial find command to the shards until we have established the
     // shard version.
     for (size_t retries = 1; retries <= kMaxRetries; ++retries) {
@@ -428,8 +506,37 @@ CursorId ClusterFind::runQuery(OperationContext* opCtx,
 
         auto routingInfo = uassertStatusOK(routingInfoStatus);
 
+        BSONObj routingVersions;
+        std::uint64_t writeGeneration = 0;
+        const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+        if (useResultCache) {
+            routingVersions = makeResultCacheRoutingVersions(opCtx, query, routingInfo);
+            if (auto cachedResults =
+                    resultCache->find(query.nss(), resultCacheQuery, routingVersions, now)) {
+                *results = std::move(*cachedResults);
+                CurOp::get(opCtx)->debug().nreturned = results->size();
+                CurOp::get(opCtx)->debug().cursorExhausted = true;
+                return CursorId(0);
+            }
+
+            // Read before the query runs, so that results which may predate a concurrent write
+            // are not cached.
+            writeGeneration = resultCache->getWriteGeneration(query.nss());
+        }
+
         try {
-            return runQueryWithoutRetrying(opCtx, query, readPref, routingInfo, results);
+            auto cursorId = runQueryWithoutRetrying(opCtx, query, readPref, routingInfo, results);
+            if (useResultCache && cursorId == CursorId(0)) {
+                resultCache->insert(
+                    query.nss(),
+                    resultCacheQuery,
+                    routingVersions,
+                    writeGeneration,
+                    *results,
+                    now + Seconds(internalQueryMongosResultCacheTTLSecs.load()),
+                    static_cast<size_t>(internalQueryMongosResultCacheMaxBytes.load()));
+            }
+            return cursorId;
         } catch (DBException& ex) {
             if (retries >= kMaxRetries) {
                 // Check if there are no retries remaining, so the last received error can be
@@ -617,7 +724,19 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
                                                          "waitWithPinnedCursorDuringGetMoreBatch");
     }
 
-    while (!FindCommon::enoughForGetMore(batchSize, batch.size())) {
+    // When the cursor reads from a single shard and nothing needs to be done to its results, the
+    // shard's batch is forwarded to the client as the array it arrived in rather than being taken
+    // apart and appended to the reply one document at a time.
+    auto rawBatch = pinnedCursor.getValue().nextRawBatch(
+        batchSize ? static_cast<std::size_t>(batchSize) : std::numeric_limits<std::size_t>::max());
+    if (!rawBatch.isOK()) {
+        return rawBatch.getStatus();
+    }
+    if (rawBatch.getValue() && pinnedCursor.getValue().remotesExhausted()) {
+        cursorState = ClusterCursorManager::CursorState::Exhausted;
+    }
+
+    while (!rawBatch.getValue() && !FindCommon::enoughForGetMore(batchSize, batch.size())) {
         auto context = batch.empty()
             ? RouterExecStage::ExecContext::kGetMoreNoResultsYet
             : RouterExecStage::ExecContext::kGetMoreWithAtLeastOneResultInBatch;
@@ -686,7 +805,8 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
 
     // Set nReturned and whether the cursor has been exhausted.
     CurOp::get(opCtx)->debug().cursorExhausted = (idToReturn == 0);
-    CurOp::get(opCtx)->debug().nreturned = batch.size();
+    CurOp::get(opCtx)->debug().nreturned =
+        rawBatch.getValue() ? rawBatch.getValue()->numDocs : batch.size();
 
     if (MONGO_FAIL_POINT(waitBeforeUnpinningOrDeletingCursorAfterGetMoreBatch)) {
         CurOpFailpointHelpers::waitWhileFailPointEnabled(
@@ -695,8 +815,12 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
             "waitBeforeUnpinningOrDeletingCursorAfterGetMoreBatch");
     }
 
-    return CursorResponse(
+    CursorResponse response(
         request.nss, idToReturn, std::move(batch), startingFrom, boost::none, postBatchResumeToken);
+    if (rawBatch.getValue()) {
+        response.setRawBatch(std::move(rawBatch.getValue()->docs));
+    }
+    return {std::move(response)};
 }
 
 }  // namespace mongo
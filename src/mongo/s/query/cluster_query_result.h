@@ -57,4 +57,16 @@ private:
     boost::optional<BSONObj> _resultObj;
 };
 
+/**
+ * A whole batch of results from a single remote cursor, kept as the BSON array in which the shard
+ * sent it so that it can be forwarded to the client without being taken apart.
+ */
+struct ClusterQueryRawBatch {
+    // The documents, as a BSON array which shares ownership with the shard's response.
+    BSONObj docs;
+
+    // The number of documents in 'docs'.
+    std::size_t numDocs = 0;
+};
+
 }  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getClusterQueryResultCache =
+    ServiceContext::declareDecoration<ClusterQueryResultCache>();
+
+}  // namespace
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(ServiceContext* serviceContext) {
+    return &getClusterQueryResultCache(serviceContext);
+}
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+std::uint64_t ClusterQueryResultCache::getWriteGeneration(const NamespaceString& nss) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _getWriteGeneration(lk, nss.ns());
+}
+
+void ClusterQueryResultCache::onWrite(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    // Entries for 'nss' are dropped lazily, once find() sees that they are from an older
+    // generation.
+    ++_writeGenerations[nss.ns()];
+}
+
+boost::optional<std::vector<BSONObj>> ClusterQueryResultCache::find(
+    const NamespaceString& nss, const BSONObj& query, const BSONObj& routingVersions, Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _cache.find(_makeKey(nss, query));
+    if (it == _cache.end()) {
+        return boost::none;
+    }
+
+    const auto& entry = it->second;
+    if (entry.expireAt <= now ||
+        entry.writeGeneration != _getWriteGeneration(lk, entry.ns) ||
+        !entry.routingVersions.binaryEqual(routingVersions)) {
+        _erase(lk, it);
+        return boost::none;
+    }
+
+    return entry.results;
+}
+
+void ClusterQueryResultCache::insert(const NamespaceString& nss,
+                                     const BSONObj& query,
+                                     const BSONObj& routingVersions,
+                                     std::uint64_t writeGeneration,
+                                     const std::vector<BSONObj>& results,
+                                     Date_t expireAt,
+                                     size_t maxBytes) {
+    auto key = _makeKey(nss, query);
+
+    Entry entry;
+    entry.ns = nss.ns();
+    entry.routingVersions = routingVersions.getOwned();
+    entry.writeGeneration = writeGeneration;
+    entry.expireAt = expireAt;
+    entry.bytes = key.size() + entry.ns.size() + entry.routingVersions.objsize();
+    entry.results.reserve(results.size());
+    for (const auto& result : results) {
+        entry.results.push_back(result.getOwned());
+        entry.bytes += result.objsize();
+    }
+
+    if (entry.bytes > maxBytes) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // The namespace was written while the query ran, so its results may already be stale.
+    if (writeGeneration != _getWriteGeneration(lk, entry.ns)) {
+        return;
+    }
+
+    auto existing = _cache.find(key);
+    if (existing != _cache.end()) {
+        _erase(lk, existing);
+    }
+
+    while (!_cache.empty() && _cachedBytes + entry.bytes > maxBytes) {
+        _erase(lk, std::prev(_cache.end()));
+    }
+
+    _cachedBytes += entry.bytes;
+    _cache.add(std::move(key), std::move(entry));
+}
+
+size_t ClusterQueryResultCache::getCachedBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _cachedBytes;
+}
+
+std::string ClusterQueryResultCache::_makeKey(const NamespaceString& nss, const BSONObj& query) {
+    std::string key = nss.ns();
+    key.push_back('\0');
+    key.append(query.objdata(), query.objsize());
+    return key;
+}
+
+std::uint64_t ClusterQueryResultCache::_getWriteGeneration(WithLock, const std::string& ns) const {
+    auto it = _writeGenerations.find(ns);
+    return it == _writeGenerations.end() ? 0 : it->second;
+}
+
+void ClusterQueryResultCache::_erase(WithLock, Cache::iterator it) {
+    _cachedBytes -= it->second.bytes;
+    _cache.erase(it);
+}
+
+}  // namespace mongo
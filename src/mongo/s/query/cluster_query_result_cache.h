@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/lru_cache.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Caches the results of queries run by mongos which were answered in a single batch, so that
+ * repeating such a query does not need to contact the shards.
+ *
+ * Each entry records the versions of the shards which were targeted by the query and is only
+ * returned while the caller presents the same versions, so entries become unusable as soon as the
+ * routing table of the collection or its database is refreshed. Writes routed through this mongos
+ * invalidate the entries for the written namespace. Writes made through other routers, and writes
+ * committed as part of a transaction, are only reflected once the entry expires, which is why the
+ * cache must be enabled explicitly.
+ *
+ * Entries are evicted in least recently used order to keep the cache within its memory limit.
+ */
+class ClusterQueryResultCache {
+    MONGO_DISALLOW_COPYING(ClusterQueryResultCache);
+
+public:
+    ClusterQueryResultCache() = default;
+
+    static ClusterQueryResultCache* get(ServiceContext* serviceContext);
+    static ClusterQueryResultCache* get(OperationContext* opCtx);
+
+    /**
+     * Returns the number of writes to 'nss' which have been routed through this mongos. A query
+     * must read this before it is sent to the shards and pass it to insert().
+     */
+    std::uint64_t getWriteGeneration(const NamespaceString& nss) const;
+
+    /**
+     * Invalidates every entry for 'nss'. Must be called once a write to 'nss' has been applied, or
+     * has failed in a way which may have applied part of it.
+     */
+    void onWrite(const NamespaceString& nss);
+
+    /**
+     * Returns the results cached for 'query' on 'nss', where 'query' is any canonical description
+     * of the query and of the options affecting its results. Returns boost::none and drops the
+     * entry if it has expired, if 'nss' was written since the query ran or if the versions of the
+     * shards which the query targets are no longer 'routingVersions'.
+     */
+    boost::optional<std::vector<BSONObj>> find(const NamespaceString& nss,
+                                               const BSONObj& query,
+                                               const BSONObj& routingVersions,
+                                               Date_t now);
+
+    /**
+     * Caches 'results' as the results of 'query' on 'nss' until 'expireAt'. 'writeGeneration' is
+     * the value returned by getWriteGeneration() before the query ran. Evicts the least recently
+     * used entries until the cache holds at most 'maxBytes'. Results which would not fit on their
+     * own are not cached.
+     */
+    void insert(const NamespaceString& nss,
+                const BSONObj& query,
+                const BSONObj& routingVersions,
+                std::uint64_t writeGeneration,
+                const std::vector<BSONObj>& results,
+                Date_t expireAt,
+                size_t maxBytes);
+
+    /**
+     * Returns the number of bytes used by the cached entries.
+     */
+    size_t getCachedBytes() const;
+
+private:
+    struct Entry {
+        std::string ns;
+        BSONObj routingVersions;
+        std::uint64_t writeGeneration;
+        std::vector<BSONObj> results;
+        Date_t expireAt;
+        size_t bytes;
+    };
+
+    using Cache = LRUCache<std::string, Entry>;
+
+    static std::string _makeKey(const NamespaceString& nss, const BSONObj& query);
+
+    std::uint64_t _getWriteGeneration(WithLock, const std::string& ns) const;
+
+    void _erase(WithLock, Cache::iterator it);
+
+    mutable stdx::mutex _mutex;
+
+    // Entries are only bounded by their total size.
+    Cache _cache{std::numeric_limits<std::size_t>::max()};
+
+    // The number of writes routed through this mongos to each namespace written so far.
+    stdx::unordered_map<std::string, std::uint64_t> _writeGenerations;
+
+    size_t _cachedBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.coll");
+const size_t kMaxBytes = 1024 * 1024;
+
+const BSONObj kQuery = BSON("find"
+                            << "coll"
+                            << "filter"
+                            << BSON("a" << 1));
+const BSONObj kRoutingVersions = BSON("shard0" << 1);
+const std::vector<BSONObj> kResults = {BSON("_id" << 1 << "a" << 1), BSON("_id" << 2 << "a" << 1)};
+
+void assertResultsEqual(const std::vector<BSONObj>& expected,
+                        const boost::optional<std::vector<BSONObj>>& actual) {
+    ASSERT(actual);
+    ASSERT_EQ(expected.size(), actual->size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(expected[i], (*actual)[i]);
+    }
+}
+
+TEST(ClusterQueryResultCacheTest, ReturnsResultsWhileRoutingVersionsAreUnchanged) {
+    ClusterQueryResultCache cache;
+    const auto now = Date_t::now();
+    cache.insert(kNss,
+                 kQuery,
+                 kRoutingVersions,
+                 cache.getWriteGeneration(kNss),
+                 kResults,
+                 now + Seconds(10),
+                 kMaxBytes);
+
+    assertResultsEqual(kResults, cache.find(kNss, kQuery, kRoutingVersions, now));
+
+    // A different query or namespace has no results cached.
+    ASSERT_FALSE(cache.find(kNss, BSON("find"
+                                       << "coll"),
+                            kRoutingVersions,
+                            now));
+    ASSERT_FALSE(cache.find(NamespaceString("test.other"), kQuery, kRoutingVersions, now));
+
+    // Once the routing table changes, the entry is dropped.
+    ASSERT_FALSE(cache.find(kNss, kQuery, BSON("shard0" << 2), now));
+    ASSERT_FALSE(cache.find(kNss, kQuery, kRoutingVersions, now));
+    ASSERT_EQ(0U, cache.getCachedBytes());
+}
+
+TEST(ClusterQueryResultCacheTest, ExpiredResultsAreNotReturned) {
+    ClusterQueryResultCache cache;
+    const auto now = Date_t::now();
+    cache.insert(kNss,
+                 kQuery,
+                 kRoutingVersions,
+                 cache.getWriteGeneration(kNss),
+                 kResults,
+                 now + Seconds(10),
+                 kMaxBytes);
+
+    assertResultsEqual(kResults, cache.find(kNss, kQuery, kRoutingVersions, now + Seconds(9)));
+    ASSERT_FALSE(cache.find(kNss, kQuery, kRoutingVersions, now + Seconds(10)));
+    ASSERT_EQ(0U, cache.getCachedBytes());
+}
+
+TEST(ClusterQueryResultCacheTest, WriteInvalidatesResultsForNamespace) {
+    ClusterQueryResultCache cache;
+    const NamespaceString otherNss("test.other");
+    const auto now = Date_t::now();
+    cache.insert(kNss,
+                 kQuery,
+                 kRoutingVersions,
+                 cache.getWriteGeneration(kNss),
+                 kResults,
+                 now + Seconds(10),
+                 kMaxBytes);
+    cache.insert(otherNss,
+                 kQuery,
+                 kRoutingVersions,
+                 cache.getWriteGeneration(otherNss),
+                 kResults,
+                 now + Seconds(10),
+                 kMaxBytes);
+
+    cache.onWrite(kNss);
+    ASSERT_FALSE(cache.find(kNss, kQuery, kRoutingVersions, now));
+    assertResultsEqual(kResults, cache.find(otherNss, kQuery, kRoutingVersions, now));
+}
+
+TEST(ClusterQueryResultCacheTest, ResultsOfQueryConcurrentWithWriteAreNotCached) {
+    ClusterQueryResultCache cache;
+    const auto now = Date_t::now();
+
+    // The write generation is read before the query runs and the write completes before the
+    // results are inserted.
+    const auto writeGeneration = cache.getWriteGeneration(kNss);
+    cache.onWrite(kNss);
+    cache.insert(
+        kNss, kQuery, kRoutingVersions, writeGeneration, kResults, now + Seconds(10), kMaxBytes);
+
+    ASSERT_FALSE(cache.find(kNss, kQuery, kRoutingVersions, now));
+    ASSERT_EQ(0U, cache.getCachedBytes());
+}
+
+TEST(ClusterQueryResultCacheTest, EvictsLeastRecentlyUsedResultsToStayWithinMaxBytes) {
+    ClusterQueryResultCache cache;
+    const auto now = Date_t::now();
+    const auto expireAt = now + Seconds(10);
+    auto makeQuery = [](int i) {
+        return BSON("find"
+                    << "coll"
+                    << "filter"
+                    << BSON("a" << i));
+    };
+
+    cache.insert(kNss, makeQuery(0), kRoutingVersions, 0, kResults, expireAt, kMaxBytes);
+    const auto entryBytes = cache.getCachedBytes();
+    const auto maxBytes = 2 * entryBytes;
+
+    cache.insert(kNss, makeQuery(1), kRoutingVersions, 0, kResults, expireAt, maxBytes);
+    ASSERT_EQ(maxBytes, cache.getCachedBytes());
+
+    // Use the first entry, so that the second one is evicted to make room for the third.
+    ASSERT(cache.find(kNss, makeQuery(0), kRoutingVersions, now));
+    cache.insert(kNss, makeQuery(2), kRoutingVersions, 0, kResults, expireAt, maxBytes);
+    ASSERT_EQ(maxBytes, cache.getCachedBytes());
+    ASSERT(cache.find(kNss, makeQuery(0), kRoutingVersions, now));
+    ASSERT_FALSE(cache.find(kNss, makeQuery(1), kRoutingVersions, now));
+    ASSERT(cache.find(kNss, makeQuery(2), kRoutingVersions, now));
+
+    // Results larger than the cache are not cached at all.
+    cache.insert(kNss, makeQuery(3), kRoutingVersions, 0, kResults, expireAt, entryBytes - 1);
+    ASSERT_FALSE(cache.find(kNss, makeQuery(3), kRoutingVersions, now));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -62,6 +62,13 @@ std::size_t DocumentSourceMergeCursors::getNumRemotes() const {
     return _blockingResultsMerger->getNumRemotes();
 }
 
+std::vector<BSONObj> DocumentSourceMergeCursors::getRemoteStallTimes() const {
+    if (_armParams) {
+        return {};
+    }
+    return _blockingResultsMerger->getRemoteStallTimes();
+}
+
 BSONObj DocumentSourceMergeCursors::getHighWaterMark() {
     if (!_blockingResultsMerger) {
         populateMerger();
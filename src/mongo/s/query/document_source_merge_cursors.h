@@ -102,6 +102,13 @@ public:
 
     std::size_t getNumRemotes() const;
 
+    /**
+     * Returns the time spent waiting on each remote, as reported by
+     * AsyncResultsMerger::getRemoteStallTimes(). Returns an empty vector if no results have been
+     * requested yet.
+     */
+    std::vector<BSONObj> getRemoteStallTimes() const;
+
     /**
      * Returns the high water mark sort key for the given cursor, if it exists; otherwise, returns
      * an empty BSONObj. Calling this method causes the underlying BlockingResultsMerger to be
@@ -31,6 +31,7 @@
 
 #include <boost/optional.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
@@ -76,6 +77,15 @@ public:
      */
     virtual StatusWith<ClusterQueryResult> next(ExecContext) = 0;
 
+    /**
+     * Returns the next whole batch of results exactly as a single remote sent it, if this stage can
+     * pass it on unchanged. Returns boost::none if the results must be consumed through next(),
+     * which is always the case for stages that transform or filter the results of their child.
+     */
+    virtual StatusWith<boost::optional<ClusterQueryRawBatch>> nextRawBatch(std::size_t maxDocs) {
+        return {boost::none};
+    }
+
     /**
      * Must be called before destruction to abandon a not-yet-exhausted plan. May block waiting for
      * responses from remote hosts.
@@ -97,6 +107,15 @@ public:
         return _child->getNumRemotes();
     }
 
+    /**
+     * Returns the time spent waiting on each remote host involved in this execution plan, as
+     * reported by AsyncResultsMerger::getRemoteStallTimes(). Default implementation forwards to the
+     * stage's child.
+     */
+    virtual std::vector<BSONObj> getRemoteStallTimes() const {
+        return _child ? _child->getRemoteStallTimes() : std::vector<BSONObj>();
+    }
+
     /**
      * Returns whether or not all the remote cursors are exhausted.
      */
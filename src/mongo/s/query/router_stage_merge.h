@@ -52,6 +52,10 @@ public:
         return _resultsMerger.next(getOpCtx(), execCtx);
     }
 
+    StatusWith<boost::optional<ClusterQueryRawBatch>> nextRawBatch(std::size_t maxDocs) final {
+        return _resultsMerger.nextRawBatch(getOpCtx(), maxDocs);
+    }
+
     void kill(OperationContext* opCtx) final {
         _resultsMerger.kill(opCtx);
     }
@@ -64,6 +68,10 @@ public:
         return _resultsMerger.getNumRemotes();
     }
 
+    std::vector<BSONObj> getRemoteStallTimes() const final {
+        return _resultsMerger.getRemoteStallTimes();
+    }
+
 protected:
     Status doSetAwaitDataTimeout(Milliseconds awaitDataTimeout) final {
         return _resultsMerger.setAwaitDataTimeout(awaitDataTimeout);
@@ -86,6 +86,13 @@ std::size_t RouterStagePipeline::getNumRemotes() const {
     return 0;
 }
 
+std::vector<BSONObj> RouterStagePipeline::getRemoteStallTimes() const {
+    if (_mergeCursorsStage) {
+        return _mergeCursorsStage->getRemoteStallTimes();
+    }
+    return {};
+}
+
 BSONObj RouterStagePipeline::getPostBatchResumeToken() const {
     return _mergeCursorsStage ? _mergeCursorsStage->getHighWaterMark() : BSONObj();
 }
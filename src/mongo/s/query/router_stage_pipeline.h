@@ -53,6 +53,8 @@ public:
 
     std::size_t getNumRemotes() const final;
 
+    std::vector<BSONObj> getRemoteStallTimes() const final;
+
     BSONObj getPostBatchResumeToken() const final;
 
 protected:
@@ -0,0 +1,242 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/routing_hint_index.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collation_spec.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const auto getRoutingHintIndex = ServiceContext::declareDecoration<RoutingHintIndex>();
+
+std::string minFieldName(size_t fieldIndex) {
+    return str::stream() << "min" << fieldIndex;
+}
+
+std::string maxFieldName(size_t fieldIndex) {
+    return str::stream() << "max" << fieldIndex;
+}
+
+std::string hasArraysFieldName(size_t fieldIndex) {
+    return str::stream() << "hasArrays" << fieldIndex;
+}
+
+/**
+ * Returns whether 'interval' may match a value between 'range.min' and 'range.max' inclusive.
+ * Intervals which reach down to null also match documents where the field is null or missing, and
+ * those are not covered by the range, so they always may match.
+ */
+bool mayMatch(const Interval& interval, const RoutingHintIndex::FieldRange& range) {
+    if (canonicalizeBSONType(interval.start.type()) <= canonicalizeBSONType(jstNULL)) {
+        return true;
+    }
+
+    if (range.min.isEmpty()) {
+        return false;
+    }
+
+    const int endToMin = interval.end.woCompare(range.min.firstElement(), false);
+    if (endToMin < 0 || (endToMin == 0 && !interval.endInclusive)) {
+        return false;
+    }
+
+    const int startToMax = interval.start.woCompare(range.max.firstElement(), false);
+    return startToMax < 0 || (startToMax == 0 && interval.startInclusive);
+}
+
+}  // namespace
+
+RoutingHintIndex* RoutingHintIndex::get(ServiceContext* serviceContext) {
+    return &getRoutingHintIndex(serviceContext);
+}
+
+RoutingHintIndex* RoutingHintIndex::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+std::vector<BSONObj> RoutingHintIndex::makeStatsPipeline(const std::vector<std::string>& fields) {
+    BSONObjBuilder groupBuilder;
+    groupBuilder.appendNull("_id");
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const std::string path = "$" + fields[i];
+        groupBuilder.append(minFieldName(i), BSON("$min" << path));
+        groupBuilder.append(maxFieldName(i), BSON("$max" << path));
+        groupBuilder.append(hasArraysFieldName(i), BSON("$max" << BSON("$isArray" << path)));
+    }
+
+    return {BSON("$group" << groupBuilder.obj())};
+}
+
+std::vector<RoutingHintIndex::FieldRange> RoutingHintIndex::parseStats(const BSONObj& stats,
+                                                                       size_t numFields) {
+    std::vector<FieldRange> ranges(numFields);
+    for (size_t i = 0; i < numFields; ++i) {
+        // $min and $max skip null and missing values, so they are only null if there are no
+        // other values.
+        const auto min = stats[minFieldName(i)];
+        const auto max = stats[maxFieldName(i)];
+        if (!min.isNull() && !min.eoo() && !max.isNull() && !max.eoo()) {
+            ranges[i].min = min.wrap();
+            ranges[i].max = max.wrap();
+        }
+        ranges[i].hasArrays = stats[hasArraysFieldName(i)].trueValue();
+    }
+    return ranges;
+}
+
+std::uint64_t RoutingHintIndex::getWriteGeneration(const NamespaceString& nss) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _writeGenerations.find(nss.ns());
+    return it == _writeGenerations.end() ? 0 : it->second;
+}
+
+void RoutingHintIndex::onWrite(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_writeGenerations[nss.ns()];
+    _hints.erase(nss.ns());
+}
+
+bool RoutingHintIndex::setHints(const NamespaceString& nss,
+                                ChunkVersion collectionVersion,
+                                std::vector<std::string> fields,
+                                ShardFieldRanges shardRanges,
+                                std::uint64_t writeGeneration,
+                                Date_t expireAt) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _writeGenerations.find(nss.ns());
+    if ((it == _writeGenerations.end() ? 0 : it->second) != writeGeneration) {
+        _hints.erase(nss.ns());
+        return false;
+    }
+
+    _hints[nss.ns()] =
+        CollectionHints{collectionVersion, std::move(fields), std::move(shardRanges), expireAt};
+    return true;
+}
+
+void RoutingHintIndex::pruneShards(OperationContext* opCtx,
+                                   const ChunkManager& cm,
+                                   const BSONObj& query,
+                                   const BSONObj& collation,
+                                   Date_t now,
+                                   std::set<ShardId>* shardIds) const {
+    if (shardIds->size() < 2) {
+        return;
+    }
+
+    CollectionHints hints;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _hints.find(cm.getns().ns());
+        if (it == _hints.end() || it->second.expireAt <= now ||
+            it->second.collectionVersion != cm.getVersion()) {
+            return;
+        }
+        hints = it->second;
+    }
+
+    // The ranges were computed with the simple collation.
+    const bool simpleCollation = collation.isEmpty()
+        ? !cm.getDefaultCollator()
+        : SimpleBSONObjComparator::kInstance.evaluate(collation == CollationSpec::kSimpleSpec);
+    if (!simpleCollation) {
+        return;
+    }
+
+    auto qr = stdx::make_unique<QueryRequest>(cm.getns());
+    qr->setFilter(query);
+    if (!collation.isEmpty()) {
+        qr->setCollation(collation);
+    }
+
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto cq = uassertStatusOK(
+        CanonicalQuery::canonicalize(opCtx,
+                                     std::move(qr),
+                                     expCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures));
+
+    // Only the fields which the query constrains can rule shards out.
+    std::vector<std::pair<size_t, OrderedIntervalList>> constrainedFields;
+    for (size_t i = 0; i < hints.fields.size(); ++i) {
+        auto bounds = ChunkManager::getIndexBoundsForQuery(BSON(hints.fields[i] << 1), *cq);
+        if (bounds.fields.size() == 1) {
+            constrainedFields.emplace_back(i, std::move(bounds.fields[0]));
+        }
+    }
+
+    std::set<ShardId> targetedShardIds;
+    for (const auto& shardId : *shardIds) {
+        auto rangesIt = hints.shardRanges.find(shardId);
+        if (rangesIt == hints.shardRanges.end()) {
+            targetedShardIds.insert(shardId);
+            continue;
+        }
+
+        const auto ruledOut = std::any_of(
+            constrainedFields.begin(), constrainedFields.end(), [&](const auto& field) {
+                const auto& range = rangesIt->second[field.first];
+                const auto& intervals = field.second.intervals;
+                return !range.hasArrays &&
+                    std::none_of(intervals.begin(), intervals.end(), [&](const auto& interval) {
+                        return mayMatch(interval, range);
+                    });
+            });
+        if (!ruledOut) {
+            targetedShardIds.insert(shardId);
+        }
+    }
+
+    // Some callers assume that at least one shard is targeted, as in
+    // ChunkManager::getShardIdsForQuery().
+    if (targetedShardIds.empty()) {
+        targetedShardIds.insert(*shardIds->begin());
+    }
+    *shardIds = std::move(targetedShardIds);
+}
+
+}  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/s/shard_id.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ChunkManager;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Lets mongos skip shards which cannot hold any document matching a query's predicates on fields
+ * other than the shard key, such as a field which is correlated with the shard key through zones.
+ *
+ * For each hinted field of a sharded collection the index keeps the smallest and largest value
+ * which each shard held when the hints were refreshed. The hints are only used while the routing
+ * table of the collection is at the version they were gathered for. Writes routed through this
+ * mongos drop the hints for the written collection. Writes made through other routers are only
+ * reflected once the hints expire, which is why hints must be refreshed explicitly.
+ */
+class RoutingHintIndex {
+    MONGO_DISALLOW_COPYING(RoutingHintIndex);
+
+public:
+    /**
+     * The values of a hinted field held by one shard.
+     */
+    struct FieldRange {
+        // The smallest and largest non-null values of the field, each wrapped in a single-field
+        // object. Both are empty if the shard holds no such values.
+        BSONObj min;
+        BSONObj max;
+
+        // Whether the field is an array in any of the shard's documents. Queries can match the
+        // elements of an array, which the bounds of whole values do not bound.
+        bool hasArrays = false;
+    };
+
+    // The ranges of the hinted fields held by each shard, in the order of the fields.
+    using ShardFieldRanges = std::map<ShardId, std::vector<FieldRange>>;
+
+    RoutingHintIndex() = default;
+
+    static RoutingHintIndex* get(ServiceContext* serviceContext);
+    static RoutingHintIndex* get(OperationContext* opCtx);
+
+    /**
+     * Returns the aggregation pipeline which each shard runs to report the ranges of 'fields'.
+     */
+    static std::vector<BSONObj> makeStatsPipeline(const std::vector<std::string>& fields);
+
+    /**
+     * Parses the ranges of 'numFields' fields out of the document produced by the pipeline from
+     * makeStatsPipeline(). 'stats' is empty if the shard holds no documents.
+     */
+    static std::vector<FieldRange> parseStats(const BSONObj& stats, size_t numFields);
+
+    /**
+     * Returns the number of writes to 'nss' which have been routed through this mongos. A refresh
+     * must read this before it gathers ranges from the shards and pass it to setHints().
+     */
+    std::uint64_t getWriteGeneration(const NamespaceString& nss) const;
+
+    /**
+     * Drops the hints for 'nss'. Must be called once a write to 'nss' has been applied, or has
+     * failed in a way which may have applied part of it.
+     */
+    void onWrite(const NamespaceString& nss);
+
+    /**
+     * Replaces the hints for 'nss' with the ranges of 'fields' in 'shardRanges', which were
+     * gathered at routing table version 'collectionVersion'. Returns false and keeps no hints if
+     * 'nss' was written since 'writeGeneration' was read.
+     */
+    bool setHints(const NamespaceString& nss,
+                  ChunkVersion collectionVersion,
+                  std::vector<std::string> fields,
+                  ShardFieldRanges shardRanges,
+                  std::uint64_t writeGeneration,
+                  Date_t expireAt);
+
+    /**
+     * Removes from 'shardIds' the shards which the hints for the collection of 'cm' show cannot
+     * match 'query'. Leaves 'shardIds' unchanged if there are no usable hints, if the query uses a
+     * non-simple collation, or if every shard would be removed.
+     */
+    void pruneShards(OperationContext* opCtx,
+                     const ChunkManager& cm,
+                     const BSONObj& query,
+                     const BSONObj& collation,
+                     Date_t now,
+                     std::set<ShardId>* shardIds) const;
+
+private:
+    struct CollectionHints {
+        ChunkVersion collectionVersion;
+        std::vector<std::string> fields;
+        ShardFieldRanges shardRanges;
+        Date_t expireAt;
+    };
+
+    mutable stdx::mutex _mutex;
+
+    stdx::unordered_map<std::string, CollectionHints> _hints;
+
+    // The number of writes routed through this mongos to each namespace written so far.
+    stdx::unordered_map<std::string, std::uint64_t> _writeGenerations;
+};
+
+}  // namespace mongo
@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/s/catalog_cache_test_fixture.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/s/routing_hint_index.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+
+class RoutingHintIndexTest : public CatalogCacheTestFixture {
+protected:
+    void setUp() override {
+        CatalogCacheTestFixture::setUp();
+
+        // Chunks [MinKey, 0), [0, 10) and [10, MaxKey) on shards "0", "1" and "2".
+        _cm = makeChunkManager(kNss,
+                               ShardKeyPattern(BSON("x" << 1)),
+                               nullptr,
+                               false,
+                               {BSON("x" << 0), BSON("x" << 10)});
+    }
+
+    /**
+     * Sets hints on the field 'zone', where shard "0" holds the values "a" to "b" and shard "1"
+     * holds the values "c" to "d". Shard "2" holds 'stats2'.
+     */
+    bool setZoneHints(const BSONObj& stats2 = BSONObj(), std::uint64_t writeGeneration = 0) {
+        RoutingHintIndex::ShardFieldRanges shardRanges;
+        shardRanges.emplace(ShardId("0"),
+                            RoutingHintIndex::parseStats(BSON("min0"
+                                                              << "a"
+                                                              << "max0"
+                                                              << "b"),
+                                                         1));
+        shardRanges.emplace(ShardId("1"),
+                            RoutingHintIndex::parseStats(BSON("min0"
+                                                              << "c"
+                                                              << "max0"
+                                                              << "d"),
+                                                         1));
+        shardRanges.emplace(ShardId("2"), RoutingHintIndex::parseStats(stats2, 1));
+        return _hintIndex.setHints(kNss,
+                                   _cm->getVersion(),
+                                   {"zone"},
+                                   std::move(shardRanges),
+                                   writeGeneration,
+                                   Date_t::now() + Seconds(60));
+    }
+
+    std::set<ShardId> target(const BSONObj& query, const BSONObj& collation = BSONObj()) {
+        std::set<ShardId> shardIds;
+        _cm->getShardIdsForQuery(operationContext(), query, collation, &shardIds);
+        _hintIndex.pruneShards(
+            operationContext(), *_cm, query, collation, Date_t::now(), &shardIds);
+        return shardIds;
+    }
+
+    std::shared_ptr<ChunkManager> _cm;
+    RoutingHintIndex _hintIndex;
+};
+
+TEST_F(RoutingHintIndexTest, StatsPipelineReportsRangesAndArrays) {
+    const auto pipeline = RoutingHintIndex::makeStatsPipeline({"zone", "a.b"});
+    ASSERT_EQ(1UL, pipeline.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{$group: {_id: null, min0: {$min: '$zone'}, max0: {$max: '$zone'}, "
+                               "hasArrays0: {$max: {$isArray: '$zone'}}, min1: {$min: '$a.b'}, "
+                               "max1: {$max: '$a.b'}, hasArrays1: {$max: {$isArray: '$a.b'}}}}"),
+                      pipeline[0]);
+
+    const auto ranges = RoutingHintIndex::parseStats(
+        fromjson("{_id: null, min0: 1, max0: 5, hasArrays0: true, min1: null, max1: null}"), 2);
+    ASSERT_EQ(2UL, ranges.size());
+    ASSERT_BSONOBJ_EQ(BSON("min0" << 1), ranges[0].min);
+    ASSERT_BSONOBJ_EQ(BSON("max0" << 5), ranges[0].max);
+    ASSERT_TRUE(ranges[0].hasArrays);
+    ASSERT_TRUE(ranges[1].min.isEmpty());
+    ASSERT_FALSE(ranges[1].hasArrays);
+}
+
+TEST_F(RoutingHintIndexTest, SkipsShardsWhoseRangesCannotMatch) {
+    ASSERT_TRUE(setZoneHints());
+
+    ASSERT(target(BSON("zone"
+                       << "c")) == std::set<ShardId>{ShardId("1")});
+    ASSERT(target(fromjson("{zone: {$in: ['a', 'd']}}")) ==
+           (std::set<ShardId>{ShardId("0"), ShardId("1")}));
+    ASSERT(target(fromjson("{zone: {$gt: 'b'}}")) == std::set<ShardId>{ShardId("1")});
+
+    // At least one shard is targeted even if none can match.
+    ASSERT_EQ(1UL, target(BSON("zone"
+                               << "z"))
+                       .size());
+
+    // The shard key still narrows the targeted shards.
+    ASSERT(target(BSON("zone"
+                       << "a"
+                       << "x"
+                       << 5)) == std::set<ShardId>{ShardId("1")});
+}
+
+TEST_F(RoutingHintIndexTest, TargetsAllShardsForQueriesWhichMayMatchNullOrOtherFields) {
+    ASSERT_TRUE(setZoneHints());
+
+    ASSERT_EQ(3UL, target(BSON("zone" << BSONNULL)).size());
+    ASSERT_EQ(3UL, target(fromjson("{zone: {$ne: 'a'}}")).size());
+    ASSERT_EQ(3UL, target(BSON("y" << 1)).size());
+}
+
+TEST_F(RoutingHintIndexTest, TargetsShardsHoldingArrays) {
+    ASSERT_TRUE(setZoneHints(BSON("min0"
+                                  << "a"
+                                  << "max0"
+                                  << "a"
+                                  << "hasArrays0"
+                                  << true)));
+
+    ASSERT(target(BSON("zone"
+                       << "c")) == (std::set<ShardId>{ShardId("1"), ShardId("2")}));
+}
+
+TEST_F(RoutingHintIndexTest, IgnoresHintsForNonSimpleCollations) {
+    ASSERT_TRUE(setZoneHints());
+
+    ASSERT_EQ(3UL, target(BSON("zone"
+                               << "c"),
+                          BSON("locale"
+                               << "mock_reverse_string"))
+                       .size());
+    ASSERT_EQ(1UL, target(BSON("zone"
+                               << "c"),
+                          BSON("locale"
+                               << "simple"))
+                       .size());
+}
+
+TEST_F(RoutingHintIndexTest, WritesDropHints) {
+    const auto writeGeneration = _hintIndex.getWriteGeneration(kNss);
+    ASSERT_TRUE(setZoneHints(BSONObj(), writeGeneration));
+    ASSERT_EQ(1UL, target(BSON("zone"
+                               << "c"))
+                       .size());
+
+    _hintIndex.onWrite(kNss);
+    ASSERT_EQ(3UL, target(BSON("zone"
+                               << "c"))
+                       .size());
+
+    // Ranges gathered before the write are rejected.
+    ASSERT_FALSE(setZoneHints(BSONObj(), writeGeneration));
+    ASSERT_EQ(3UL, target(BSON("zone"
+                               << "c"))
+                       .size());
+    ASSERT_TRUE(setZoneHints(BSONObj(), _hintIndex.getWriteGeneration(kNss)));
+}
+
+}  // namespace
+}  // namespace mongo
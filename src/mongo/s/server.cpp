@@ -80,6 +80,7 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/is_mongos.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/s/periodic_runner_job_refresh_catalog_cache.h"
 #include "mongo/s/query/cluster_cursor_cleanup_job.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/service_entry_point_mongos.h"
@@ -440,6 +441,8 @@ ExitCode runMongosServer(ServiceContext* serviceContext) {
     runner->startup();
     serviceContext->setPeriodicRunner(std::move(runner));
 
+    startPeriodicThreadToRefreshCatalogCache(serviceContext);
+
     SessionKiller::set(serviceContext,
                        std::make_shared<SessionKiller>(serviceContext, killSessionsRemote));
 
@@ -144,8 +144,6 @@ StatusWith<boost::optional<ChunkRange>> splitChunkAtMultiplePoints(
     const std::vector<BSONObj>& splitPoints) {
     invariant(!splitPoints.empty());
 
-    const size_t kMaxSplitPoints = 8192;
-
     if (splitPoints.size() > kMaxSplitPoints) {
         return {ErrorCodes::BadValue,
                 str::stream() << "Cannot split chunk in more than " << kMaxSplitPoints
@@ -51,6 +51,11 @@ class StatusWith;
  */
 namespace shardutil {
 
+/**
+ * The maximum number of split points which can be committed by a single splitChunk request.
+ */
+constexpr size_t kMaxSplitPoints = 8192;
+
 /**
  * Executes the listDatabases command against the specified shard and obtains the total data
  * size across all databases in bytes (essentially, the totalSize field).
@@ -183,6 +183,9 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.maxConnecting = (gShardingTaskExecutorPoolMaxConnecting >= 0)
         ? gShardingTaskExecutorPoolMaxConnecting
         : ConnectionPool::kDefaultMaxConnecting;
+    connPoolOptions.maxIdleConnections = (gShardingTaskExecutorPoolMaxIdleConnections >= 0)
+        ? gShardingTaskExecutorPoolMaxIdleConnections
+        : ConnectionPool::kDefaultMaxIdleConns;
 
     connPoolOptions.hostTimeout = Milliseconds(gShardingTaskExecutorPoolHostTimeoutMS);
     connPoolOptions.refreshRequirement =
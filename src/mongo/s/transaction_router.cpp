@@ -642,6 +642,10 @@ BSONObj TransactionRouter::_commitReadOnlyTransaction(OperationContext* opCtx) {
     // Assemble requests.
     std::vector<AsyncRequestsSender::Request> requests;
     for (const auto& participant : _participants) {
+        if (participant.second.readOnly != Participant::ReadOnly::kReadOnly) {
+            continue;
+        }
+
         CommitTransaction commitCmd;
         commitCmd.setDbName(NamespaceString::kAdminDb);
         const auto commitCmdObj = commitCmd.toBSON(
@@ -687,6 +691,40 @@ BSONObj TransactionRouter::_commitReadOnlyTransaction(OperationContext* opCtx) {
     return BSONObj();
 }
 
+BSONObj TransactionRouter::_commitSingleWriteShardTransaction(OperationContext* opCtx,
+                                                              const ShardId& writeShardId) {
+    LOG(0) << txnIdToString()
+           << " Committing single-write-shard transaction, write participant: " << writeShardId;
+
+    // The read-only participants hold no changes which could become visible, so committing them
+    // first cannot expose a partial transaction. If any of them fails to commit, return its error
+    // before the write participant has committed, so that the transaction can still be aborted.
+    auto readOnlyResult = _commitReadOnlyTransaction(opCtx);
+    if (!readOnlyResult.isEmpty()) {
+        return readOnlyResult;
+    }
+
+    const auto writeParticipantIter = _participants.find(writeShardId);
+    invariant(writeParticipantIter != _participants.end());
+    const auto& participant = writeParticipantIter->second;
+
+    auto shard = uassertStatusOK(Grid::get(opCtx)->shardRegistry()->getShard(opCtx, writeShardId));
+
+    CommitTransaction commitCmd;
+    commitCmd.setDbName(NamespaceString::kAdminDb);
+
+    return uassertStatusOK(shard->runCommandWithFixedRetryAttempts(
+                               opCtx,
+                               ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                               "admin",
+                               participant.attachTxnFieldsIfNeeded(
+                                   commitCmd.toBSON(BSON(WriteConcernOptions::kWriteConcernField
+                                                         << opCtx->getWriteConcern().toBSON())),
+                                   false),
+                               Shard::RetryPolicy::kIdempotent))
+        .response;
+}
+
 BSONObj TransactionRouter::_commitMultiShardTransaction(OperationContext* opCtx) {
     invariant(_coordinatorId);
     auto coordinatorIter = _participants.find(*_coordinatorId);
@@ -783,13 +821,13 @@ BSONObj TransactionRouter::commitTransaction(
         return BSON("ok" << 1);
     }
 
-    bool allParticipantsReadOnly = true;
+    std::vector<ShardId> writeShards;
     for (const auto& participant : _participants) {
         uassert(ErrorCodes::NoSuchTransaction,
                 "Can't send commit unless all previous statements were successful",
                 participant.second.readOnly != Participant::ReadOnly::kUnset);
         if (participant.second.readOnly == Participant::ReadOnly::kNotReadOnly) {
-            allParticipantsReadOnly = false;
+            writeShards.push_back(participant.first);
         }
     }
 
@@ -799,10 +837,16 @@ BSONObj TransactionRouter::commitTransaction(
         return _commitSingleShardTransaction(opCtx);
     }
 
-    if (allParticipantsReadOnly) {
+    if (writeShards.empty()) {
         return _commitReadOnlyTransaction(opCtx);
     }
 
+    // A single write participant can commit on its own once the read-only participants are done,
+    // which avoids the coordinator's majority writes and the prepare round trip.
+    if (writeShards.size() == 1) {
+        return _commitSingleWriteShardTransaction(opCtx, writeShards.front());
+    }
+
     return _commitMultiShardTransaction(opCtx);
 }
 
@@ -870,14 +914,22 @@ void TransactionRouter::appendRecoveryToken(BSONObjBuilder* builder) const {
     TxnRecoveryToken recoveryToken;
 
     // Only return a populated recovery token if the transaction has done a write (transactions that
-    // only did reads do not need to be recovered; they can just be retried).
+    // only did reads do not need to be recovered; they can just be retried). A transaction with a
+    // single write participant is committed directly on that participant, so its decision is
+    // recovered from there rather than from the coordinator.
+    std::vector<ShardId> writeShards;
     for (const auto& participant : _participants) {
         if (participant.second.readOnly == Participant::ReadOnly::kNotReadOnly) {
-            recoveryToken.setShardId(*_coordinatorId);
-            break;
+            writeShards.push_back(participant.first);
         }
     }
 
+    if (writeShards.size() == 1) {
+        recoveryToken.setShardId(writeShards.front());
+    } else if (!writeShards.empty()) {
+        recoveryToken.setShardId(*_coordinatorId);
+    }
+
     recoveryToken.serialize(&recoveryTokenBuilder);
     recoveryTokenBuilder.doneFast();
 }
@@ -289,11 +289,19 @@ private:
      */
     BSONObj _commitReadOnlyTransaction(OperationContext* opCtx);
 
+    /**
+     * Commits a transaction in which only 'writeShardId' did writes without two-phase commit, by
+     * first committing the read-only participants and then sending commit directly to the write
+     * participant.
+     */
+    BSONObj _commitSingleWriteShardTransaction(OperationContext* opCtx,
+                                               const ShardId& writeShardId);
+
     BSONObj _commitWithRecoveryToken(OperationContext* opCtx,
                                      const TxnRecoveryToken& recoveryToken);
 
     /**
-     * Run two phase commit for transactions that touched multiple shards.
+     * Run two phase commit for transactions that did writes on multiple shards.
      */
     BSONObj _commitMultiShardTransaction(OperationContext* opCtx);
 
@@ -37,6 +37,7 @@
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/session_catalog_router.h"
 #include "mongo/s/sharding_router_test_fixture.h"
@@ -815,7 +816,7 @@ TEST_F(TransactionRouterTestWithDefaultSession,
 }
 
 TEST_F(TransactionRouterTestWithDefaultSession,
-       SendCoordinateCommitForMultipleParticipantsOnlyOneDidAWrite) {
+       SendCommitToReadOnlyParticipantsThenToWriteParticipantIfOnlyOneDidAWrite) {
     TxnNumber txnNum{3};
 
     auto& txnRouter(*TransactionRouter::get(operationContext()));
@@ -831,30 +832,41 @@ TEST_F(TransactionRouterTestWithDefaultSession,
     txnRouter.beginOrContinueTxn(
         operationContext(), txnNum, TransactionRouter::TransactionActions::kCommit);
 
+    // The decision of a transaction with a single write participant is recovered from that
+    // participant rather than from the coordinator.
+    BSONObjBuilder responseBuilder;
+    txnRouter.appendRecoveryToken(&responseBuilder);
+    ASSERT_EQ(shard2.toString(),
+              responseBuilder.obj()["recoveryToken"]["shardId"].valuestr());
+
     TxnRecoveryToken recoveryToken;
-    recoveryToken.setShardId(shard1);
+    recoveryToken.setShardId(shard2);
 
     auto future =
         launchAsync([&] { txnRouter.commitTransaction(operationContext(), recoveryToken); });
 
+    // The read-only participant commits first.
     onCommand([&](const RemoteCommandRequest& request) {
         ASSERT_EQ(hostAndPort1, request.target);
         ASSERT_EQ("admin", request.dbname);
 
         auto cmdName = request.cmdObj.firstElement().fieldNameStringData();
-        ASSERT_EQ(cmdName, "coordinateCommitTransaction");
+        ASSERT_EQ(cmdName, "commitTransaction");
 
-        std::set<std::string> expectedParticipants = {shard1.toString(), shard2.toString()};
-        auto participantElements = request.cmdObj["participants"].Array();
-        ASSERT_EQ(expectedParticipants.size(), participantElements.size());
+        checkSessionDetails(request.cmdObj, getSessionId(), txnNum, true);
 
-        for (const auto& element : participantElements) {
-            auto shardId = element["shardId"].valuestr();
-            ASSERT_EQ(1ull, expectedParticipants.count(shardId));
-            expectedParticipants.erase(shardId);
-        }
+        return kOkReadOnlyTrueResponse;
+    });
 
-        checkSessionDetails(request.cmdObj, getSessionId(), txnNum, true);
+    // The write participant commits without a coordinator.
+    onCommand([&](const RemoteCommandRequest& request) {
+        ASSERT_EQ(hostAndPort2, request.target);
+        ASSERT_EQ("admin", request.dbname);
+
+        auto cmdName = request.cmdObj.firstElement().fieldNameStringData();
+        ASSERT_EQ(cmdName, "commitTransaction");
+
+        checkSessionDetails(request.cmdObj, getSessionId(), txnNum, boost::none);
 
         return BSON("ok" << 1);
     });
@@ -862,6 +874,40 @@ TEST_F(TransactionRouterTestWithDefaultSession,
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(TransactionRouterTestWithDefaultSession,
+       DoNotCommitWriteParticipantIfReadOnlyParticipantFailsToCommit) {
+    TxnNumber txnNum{3};
+
+    auto& txnRouter(*TransactionRouter::get(operationContext()));
+    txnRouter.beginOrContinueTxn(
+        operationContext(), txnNum, TransactionRouter::TransactionActions::kStart);
+    txnRouter.setDefaultAtClusterTime(operationContext());
+
+    txnRouter.attachTxnFieldsIfNeeded(shard1, {});
+    txnRouter.attachTxnFieldsIfNeeded(shard2, {});
+    txnRouter.processParticipantResponse(shard1, kOkReadOnlyTrueResponse);
+    txnRouter.processParticipantResponse(shard2, kOkReadOnlyFalseResponse);
+
+    txnRouter.beginOrContinueTxn(
+        operationContext(), txnNum, TransactionRouter::TransactionActions::kCommit);
+
+    auto future = launchAsync([&] {
+        auto response = txnRouter.commitTransaction(operationContext(), boost::none);
+        ASSERT_EQ(ErrorCodes::NoSuchTransaction, getStatusFromCommandResult(response));
+    });
+
+    onCommand([&](const RemoteCommandRequest& request) {
+        ASSERT_EQ(hostAndPort1, request.target);
+
+        auto cmdName = request.cmdObj.firstElement().fieldNameStringData();
+        ASSERT_EQ(cmdName, "commitTransaction");
+
+        return BSON("ok" << 0 << "code" << ErrorCodes::NoSuchTransaction);
+    });
+
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(TransactionRouterTestWithDefaultSession,
        SendCoordinateCommitForMultipleParticipantsAllDidWrites) {
     TxnNumber txnNum{3};
@@ -33,6 +33,10 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
@@ -44,6 +48,7 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
 #include "mongo/s/transaction_router.h"
+#include "mongo/s/write_ops/batch_write_exec_gen.h"
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
 #include "mongo/util/log.h"
@@ -146,201 +151,240 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         //
         // Send all child batches
         //
+        // Unordered batches outside of transactions may keep several child batches in flight for
+        // each shard. The writes which are left are targeted as soon as all targeted batches have
+        // been sent rather than once every response of the round has arrived, so that each shard
+        // is kept busy while the others respond.
+        //
 
-        const size_t numToSend = childBatches.size();
-        size_t numSent = 0;
-
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedShardBatchMap ownedPendingBatches;
-            OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+        const bool isRetryableWrite = opCtx->getTxnNumber() && !TransactionRouter::get(opCtx);
+        const bool canPipeline =
+            !clientRequest.getWriteCommandBase().getOrdered() && !TransactionRouter::get(opCtx);
+        const int maxInFlightPerShard =
+            canPipeline ? internalBatchWriteMaxInFlightBatchesPerShard.load() : 1;
+        bool canTargetMore = targetStatus.isOK() && maxInFlightPerShard > 1;
 
-            //
-            // Construct the requests.
-            //
+        // Batches which have been targeted but not sent yet, per shard
+        std::map<ShardId, std::deque<std::unique_ptr<TargetedWriteBatch>>> queuedBatches;
 
-            std::vector<AsyncRequestsSender::Request> requests;
+        // Batches out on the network, by the index of their request in the ARS. Reset once their
+        // response has been noted.
+        std::vector<std::unique_ptr<TargetedWriteBatch>> sentBatches;
+        std::map<ShardId, int> numInFlight;
 
-            // Get as many batches as we can at once
+        const auto queueChildBatches = [&] {
             for (auto& childBatch : childBatches) {
-                TargetedWriteBatch* const nextBatch = childBatch.second;
+                queuedBatches[childBatch.first].emplace_back(childBatch.second);
+                childBatch.second = nullptr;
+            }
+            childBatches.clear();
+        };
+
+        MultiStatementTransactionRequestsSender ars(
+            opCtx,
+            Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+            clientRequest.getNS().db().toString(),
+            {},
+            kPrimaryOnlyReadPreference,
+            isRetryableWrite ? Shard::RetryPolicy::kIdempotent : Shard::RetryPolicy::kNoRetry);
+
+        const auto sendQueuedBatches = [&] {
+            std::vector<AsyncRequestsSender::Request> requests;
 
-                // If the batch is nullptr, we sent it previously, so skip
-                if (!nextBatch)
-                    continue;
+            for (auto& queued : queuedBatches) {
+                const auto& targetShardId = queued.first;
+                auto& shardBatches = queued.second;
 
-                // If we already have a batch for this shard, wait until the next time
-                const auto& targetShardId = nextBatch->getEndpoint().shardName;
+                while (!shardBatches.empty() && numInFlight[targetShardId] < maxInFlightPerShard) {
+                    auto nextBatch = std::move(shardBatches.front());
+                    shardBatches.pop_front();
 
-                if (pendingBatches.count(targetShardId))
-                    continue;
+                    stats->noteTargetedShard(targetShardId);
 
-                stats->noteTargetedShard(targetShardId);
+                    const auto request = [&] {
+                        const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
 
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
+                        BSONObjBuilder requestBuilder;
+                        shardBatchRequest.serialize(&requestBuilder);
 
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
+                        {
+                            OperationSessionInfo sessionInfo;
 
-                    {
-                        OperationSessionInfo sessionInfo;
+                            if (opCtx->getLogicalSessionId()) {
+                                sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+                            }
 
-                        if (opCtx->getLogicalSessionId()) {
-                            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+                            sessionInfo.setTxnNumber(opCtx->getTxnNumber());
+                            sessionInfo.serialize(&requestBuilder);
                         }
 
-                        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
-                        sessionInfo.serialize(&requestBuilder);
-                    }
-
-                    return requestBuilder.obj();
-                }();
+                        return requestBuilder.obj();
+                    }();
 
-                LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+                    LOG(4) << "Sending write batch to " << targetShardId << ": "
+                           << redact(request);
 
-                requests.emplace_back(targetShardId, request);
+                    requests.emplace_back(targetShardId, request);
+                    ++numInFlight[targetShardId];
 
-                // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
-                // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
-                // so this should be pretty efficient without moving stuff around.
-                childBatch.second = nullptr;
+                    // The response for the request is matched up with the batch by its index
+                    sentBatches.push_back(std::move(nextBatch));
+                }
+            }
 
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.emplace(targetShardId, nextBatch);
+            if (!requests.empty()) {
+                ars.addRequests(requests);
             }
+        };
+
+        queueChildBatches();
+
+        while (true) {
+            // Target the remaining writes once everything targeted before has been sent
+            const bool allQueuedBatchesSent =
+                std::all_of(queuedBatches.begin(), queuedBatches.end(), [](const auto& queued) {
+                    return queued.second.empty();
+                });
+            if (canTargetMore && allQueuedBatchesSent) {
+                Status moreTargetStatus =
+                    batchOp.targetBatch(targeter, refreshedTargeter, &childBatches);
+                if (!moreTargetStatus.isOK()) {
+                    // Wait for the outstanding batches, then refresh as after any targeting error
+                    targeter.noteCouldNotTarget();
+                    refreshedTargeter = true;
+                    ++stats->numTargetErrors;
+                    dassert(childBatches.size() == 0u);
+                }
 
-            bool isRetryableWrite = opCtx->getTxnNumber() && !TransactionRouter::get(opCtx);
+                // Nothing was left to target, or the targeter needs a refresh first
+                canTargetMore = moreTargetStatus.isOK() && !childBatches.empty();
+                queueChildBatches();
+            }
 
-            MultiStatementTransactionRequestsSender ars(
-                opCtx,
-                Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                clientRequest.getNS().db().toString(),
-                requests,
-                kPrimaryOnlyReadPreference,
-                isRetryableWrite ? Shard::RetryPolicy::kIdempotent : Shard::RetryPolicy::kNoRetry);
-            numSent += pendingBatches.size();
+            sendQueuedBatches();
 
             //
             // Receive the responses.
             //
 
-            while (!ars.done()) {
-                // Block until a response is available.
-                auto response = ars.next();
-
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
-
-                // First check if we were able to target a shard host.
-                if (!response.shardHostAndPort) {
-                    invariant(!response.swResponse.isOK());
-
-                    // Record a resolve failure
-                    batchOp.noteBatchError(*batch,
-                                           errorFromStatus(response.swResponse.getStatus()));
-
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel
-                    // and retarget the batch
-                    LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
-                           << causedBy(response.swResponse.getStatus());
-
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
-                    continue;
-                }
+            if (ars.done()) {
+                break;
+            }
 
-                const auto shardHost(std::move(*response.shardHostAndPort));
-
-                // Then check if we successfully got a response.
-                Status responseStatus = response.swResponse.getStatus();
-                BatchedCommandResponse batchedCommandResponse;
-                if (responseStatus.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg) ||
-                        !batchedCommandResponse.isValid(&errMsg)) {
-                        responseStatus = {ErrorCodes::FailedToParse, errMsg};
-                    }
-                }
+            // Block until a response is available.
+            auto response = ars.next();
 
-                if (responseStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-                    trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
-
-                    LOG(4) << "Write results received from " << shardHost.toString() << ": "
-                           << redact(batchedCommandResponse.toString());
-
-                    // If we are in a transaction, we must fail the whole batch on any error.
-                    if (TransactionRouter::get(opCtx)) {
-                        // Note: this returns a bad status if any part of the batch failed.
-                        auto batchStatus = batchedCommandResponse.toStatus();
-                        if (!batchStatus.isOK()) {
-                            batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-                            uassertStatusOK(batchStatus.withContext(
-                                str::stream() << "Encountered error from " << shardHost.toString()
-                                              << " during a transaction"));
-                        }
-                    }
+            // Get the TargetedWriteBatch to find where to put the response
+            dassert(response.requestIndex < sentBatches.size() &&
+                    sentBatches[response.requestIndex]);
+            const auto ownedBatch = std::move(sentBatches[response.requestIndex]);
+            TargetedWriteBatch* batch = ownedBatch.get();
+            --numInFlight[batch->getEndpoint().shardName];
 
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
+            // First check if we were able to target a shard host.
+            if (!response.shardHostAndPort) {
+                invariant(!response.swResponse.isOK());
 
-                    // Note if anything was stale
-                    const auto& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-                    if (!staleErrors.empty()) {
-                        noteStaleResponses(staleErrors, &targeter);
-                        ++stats->numStaleBatches;
-                    }
+                // Record a resolve failure
+                batchOp.noteBatchError(*batch, errorFromStatus(response.swResponse.getStatus()));
 
-                    const auto& cannotImplicitlyCreateErrors =
-                        trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
-                    if (!cannotImplicitlyCreateErrors.empty()) {
-                        // This forces the chunk manager to reload so we can attach the correct
-                        // version on retry and make sure we route to the correct shard.
-                        targeter.noteCouldNotTarget();
-
-                        // It is also possible that information about which shard is the primary
-                        // for this collection collection is stale, so refresh the database as
-                        // well.
-                        Grid::get(opCtx)->catalogCache()->invalidateDatabaseEntry(
-                            targeter.getNS().db());
-                    }
+                // TODO: It may be necessary to refresh the cache if stale, or maybe just cancel
+                // and retarget the batch
+                LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
+                       << causedBy(response.swResponse.getStatus());
+                continue;
+            }
+
+            const auto shardHost(std::move(*response.shardHostAndPort));
+
+            // Then check if we successfully got a response.
+            Status responseStatus = response.swResponse.getStatus();
+            BatchedCommandResponse batchedCommandResponse;
+            if (responseStatus.isOK()) {
+                std::string errMsg;
+                if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
+                                                      &errMsg) ||
+                    !batchedCommandResponse.isValid(&errMsg)) {
+                    responseStatus = {ErrorCodes::FailedToParse, errMsg};
+                }
+            }
+
+            if (responseStatus.isOK()) {
+                TrackedErrors trackedErrors;
+                trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+                trackedErrors.startTracking(ErrorCodes::CannotImplicitlyCreateCollection);
+
+                LOG(4) << "Write results received from " << shardHost.toString() << ": "
+                       << redact(batchedCommandResponse.toString());
 
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(shardHost,
-                                       batchedCommandResponse.isLastOpSet()
-                                           ? batchedCommandResponse.getLastOp()
-                                           : repl::OpTime(),
-                                       batchedCommandResponse.isElectionIdSet()
-                                           ? batchedCommandResponse.getElectionId()
-                                           : OID());
-                } else {
-                    // Error occurred dispatching, note it
-                    const Status status = responseStatus.withContext(
-                        str::stream() << "Write results unavailable from " << shardHost);
-
-                    batchOp.noteBatchError(*batch, errorFromStatus(status));
-
-                    LOG(4) << "Unable to receive write results from " << shardHost
-                           << causedBy(redact(status));
-
-                    // If we are in a transaction, we must fail the whole batch on any error.
-                    if (TransactionRouter::get(opCtx)) {
+                // If we are in a transaction, we must fail the whole batch on any error.
+                if (TransactionRouter::get(opCtx)) {
+                    // Note: this returns a bad status if any part of the batch failed.
+                    auto batchStatus = batchedCommandResponse.toStatus();
+                    if (!batchStatus.isOK()) {
                         batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-                        uassertStatusOK(status.withContext(
+                        uassertStatusOK(batchStatus.withContext(
                             str::stream() << "Encountered error from " << shardHost.toString()
                                           << " during a transaction"));
                     }
                 }
+
+                // Dispatch was ok, note response
+                batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
+
+                // Note if anything was stale
+                const auto& staleErrors = trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+                if (!staleErrors.empty()) {
+                    noteStaleResponses(staleErrors, &targeter);
+                    ++stats->numStaleBatches;
+
+                    // Retarget the stale writes only after the targeter has been refreshed
+                    canTargetMore = false;
+                }
+
+                const auto& cannotImplicitlyCreateErrors =
+                    trackedErrors.getErrors(ErrorCodes::CannotImplicitlyCreateCollection);
+                if (!cannotImplicitlyCreateErrors.empty()) {
+                    // This forces the chunk manager to reload so we can attach the correct
+                    // version on retry and make sure we route to the correct shard.
+                    targeter.noteCouldNotTarget();
+
+                    // It is also possible that information about which shard is the primary
+                    // for this collection collection is stale, so refresh the database as
+                    // well.
+                    Grid::get(opCtx)->catalogCache()->invalidateDatabaseEntry(
+                        targeter.getNS().db());
+
+                    canTargetMore = false;
+                }
+
+                // Remember that we successfully wrote to this shard
+                // NOTE: This will record lastOps for shards where we actually didn't update
+                // or delete any documents, which preserves old behavior but is conservative
+                stats->noteWriteAt(shardHost,
+                                   batchedCommandResponse.isLastOpSet()
+                                       ? batchedCommandResponse.getLastOp()
+                                       : repl::OpTime(),
+                                   batchedCommandResponse.isElectionIdSet()
+                                       ? batchedCommandResponse.getElectionId()
+                                       : OID());
+            } else {
+                // Error occurred dispatching, note it
+                const Status status = responseStatus.withContext(
+                    str::stream() << "Write results unavailable from " << shardHost);
+
+                batchOp.noteBatchError(*batch, errorFromStatus(status));
+
+                LOG(4) << "Unable to receive write results from " << shardHost
+                       << causedBy(redact(status));
+
+                // If we are in a transaction, we must fail the whole batch on any error.
+                if (TransactionRouter::get(opCtx)) {
+                    batchOp.forgetTargetedBatchesOnTransactionAbortingError();
+                    uassertStatusOK(status.withContext(str::stream() << "Encountered error from "
+                                                                     << shardHost.toString()
+                                                                     << " during a transaction"));
+                }
             }
         }
 
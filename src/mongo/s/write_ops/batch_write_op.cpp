@@ -239,6 +239,72 @@ void trackErrors(const ShardEndpoint& endpoint,
     }
 }
 
+/**
+ * Targets the inserts of a batch ahead of time through NSTargeter::targetInserts(), which can look
+ * up the shard keys of many documents at once. Inserts are targeted in windows of doubling size,
+ * so that a batch which is split after a few writes, such as an ordered batch spanning several
+ * shards, does not target many more inserts than it sends.
+ */
+class InsertTargetingWindow {
+public:
+    InsertTargetingWindow(OperationContext* opCtx,
+                          const NSTargeter& targeter,
+                          const std::vector<WriteOp>& writeOps)
+        : _opCtx(opCtx), _targeter(targeter), _writeOps(writeOps) {}
+
+    /**
+     * Returns the endpoint of the insert at 'writeOpIndex', which must be in state _Ready. Must be
+     * called with increasing indexes.
+     */
+    StatusWith<ShardEndpoint> target(size_t writeOpIndex) {
+        while (_next < _writeOpIndexes.size() && _writeOpIndexes[_next] < writeOpIndex) {
+            ++_next;
+        }
+
+        if (_next == _writeOpIndexes.size()) {
+            _targetWindow(writeOpIndex);
+        }
+
+        invariant(_writeOpIndexes[_next] == writeOpIndex);
+        return std::move(_endpoints[_next++]);
+    }
+
+private:
+    static constexpr size_t kInitialWindowSize = 16;
+
+    void _targetWindow(size_t firstWriteOpIndex) {
+        _writeOpIndexes.clear();
+        _next = 0;
+
+        std::vector<BSONObj> docs;
+        for (size_t i = firstWriteOpIndex; i < _writeOps.size() && docs.size() < _windowSize; ++i) {
+            if (_writeOps[i].getWriteState() != WriteOpState_Ready)
+                continue;
+
+            _writeOpIndexes.push_back(i);
+            docs.push_back(_writeOps[i].getWriteItem().getDocument());
+        }
+
+        _endpoints = _targeter.targetInserts(_opCtx, docs);
+        invariant(_endpoints.size() == docs.size());
+
+        _windowSize *= 2;
+    }
+
+    OperationContext* const _opCtx;
+    const NSTargeter& _targeter;
+    const std::vector<WriteOp>& _writeOps;
+
+    // Indexes of the write ops in the current window and the endpoints they were targeted to.
+    std::vector<size_t> _writeOpIndexes;
+    std::vector<StatusWith<ShardEndpoint>> _endpoints;
+
+    // Position in the current window of the next insert to be returned.
+    size_t _next = 0;
+
+    size_t _windowSize = kInitialWindowSize;
+};
+
 }  // namespace
 
 BatchWriteOp::BatchWriteOp(OperationContext* opCtx, const BatchedCommandRequest& clientRequest)
@@ -300,6 +366,10 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    const bool isInsertBatch =
+        _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert;
+    InsertTargetingWindow insertTargetingWindow(_opCtx, targeter, _writeOps);
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -315,7 +385,9 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = isInsertBatch
+            ? writeOp.targetWrites(_opCtx, targeter, insertTargetingWindow.target(i), &writes)
+            : writeOp.targetWrites(_opCtx, targeter, &writes);
 
         if (!targetStatus.isOK()) {
             // Throw any error encountered during a transaction, since the whole batch must fail.
@@ -80,6 +80,10 @@ public:
     StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                            const BSONObj& doc) const override;
 
+    // Looks up the shard keys of all sharded inserts with a single pass over the chunks.
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     StatusWith<std::vector<ShardEndpoint>> targetUpdate(
         OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const override;
@@ -116,6 +120,13 @@ private:
      */
     Status _refreshNow(OperationContext* opCtx);
 
+    /**
+     * Extracts the shard key of a document to be inserted into a sharded collection. Returns
+     * ShardKeyNotFound if the document does not contain the full shard key, or an error if the
+     * shard key is too large.
+     */
+    StatusWith<BSONObj> _extractShardKeyForInsert(const BSONObj& doc) const;
+
     /**
      * Attempts to route an update operation by extracting an exact shard key from the given query
      * and/or update expression. Should only be called on sharded collections, and with a valid
@@ -122,6 +122,15 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as above for an insert which has already been targeted to 'swInsertEndpoint', for
+     * example through NSTargeter::targetInserts().
+     */
+    Status targetWrites(OperationContext* opCtx,
+                        const NSTargeter& targeter,
+                        StatusWith<ShardEndpoint> swInsertEndpoint,
+                        std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -165,6 +174,14 @@ private:
      */
     void _updateOpState();
 
+    /**
+     * Creates the TargetedWrites for the endpoints this op was targeted to.
+     */
+    Status _targetWrites(OperationContext* opCtx,
+                         const NSTargeter& targeter,
+                         StatusWith<std::vector<ShardEndpoint>> swEndpoints,
+                         std::vector<TargetedWrite*>* targetedWrites);
+
     // Owned elsewhere, reference to a batch with a write item
     const BatchItemRef _itemRef;
 
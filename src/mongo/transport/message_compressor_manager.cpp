@@ -80,6 +80,14 @@ private:
     }
 };
 
+// A message is considered incompressible if it doesn't shrink by at least this fraction.
+constexpr double kIncompressibleRatio = 0.9;
+
+// After this many incompressible messages in a row, compression is skipped for the next
+// kIncompressibleMessagesSkipped messages, after which the payloads are sampled again.
+constexpr int kIncompressibleMessagesLimit = 8;
+constexpr int kIncompressibleMessagesSkipped = 64;
+
 const transport::Session::Decoration<MessageCompressorManager> getForSession =
     transport::Session::declareDecoration<MessageCompressorManager>();
 }  // namespace
@@ -103,6 +111,11 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
         return {msg};
     }
 
+    if (_messagesToSkip > 0) {
+        _messagesToSkip--;
+        return {msg};
+    }
+
     LOG(3) << "Compressing message with " << compressor->getName();
 
     auto inputHeader = msg.header();
@@ -118,7 +131,7 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
         return {msg};
     }
 
-    auto outputMessageBuffer = SharedBuffer::allocate(bufferSize);
+    auto outputMessageBuffer = SharedBuffer::allocatePooled(bufferSize);
 
     MsgData::View outMessage(outputMessageBuffer.get());
     outMessage.setId(inputHeader.getId());
@@ -136,6 +149,18 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
         return sws.getStatus();
 
     auto realCompressedSize = sws.getValue();
+    if (realCompressedSize > inputHeader.dataLen() * kIncompressibleRatio) {
+        if (++_incompressibleMessages >= kIncompressibleMessagesLimit) {
+            LOG(3) << "Skipping compression of the next " << kIncompressibleMessagesSkipped
+                   << " messages since the last " << kIncompressibleMessagesLimit
+                   << " messages were incompressible";
+            _incompressibleMessages = 0;
+            _messagesToSkip = kIncompressibleMessagesSkipped;
+        }
+    } else {
+        _incompressibleMessages = 0;
+    }
+
     outMessage.setLen(realCompressedSize + CompressionHeader::size() + MsgData::MsgDataHeaderSize);
 
     return {Message(outputMessageBuffer)};
@@ -168,7 +193,7 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
                 "Decompressed message would be larger than maximum message size"};
     }
 
-    auto outputMessageBuffer = SharedBuffer::allocate(bufferSize);
+    auto outputMessageBuffer = SharedBuffer::allocatePooled(bufferSize);
     MsgData::View outMessage(outputMessageBuffer.get());
     outMessage.setId(inputHeader.getId());
     outMessage.setResponseToMsgId(inputHeader.getResponseToMsgId());
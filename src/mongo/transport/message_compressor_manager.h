@@ -100,6 +100,9 @@ public:
      * it will return a ref-count bumped copy of the input message.
      *
      * If an error occurs in the compressor, it will return a Status error.
+     *
+     * Compression adapts to the payloads: once several messages in a row barely shrank, the
+     * following messages are returned uncompressed for a while before compression is tried again.
      */
     StatusWith<Message> compressMessage(const Message& msg,
                                         const MessageCompressorId* compressorId = nullptr);
@@ -129,6 +132,12 @@ public:
 private:
     std::vector<MessageCompressorBase*> _negotiated;
     MessageCompressorRegistry* _registry;
+
+    // Number of consecutive messages which were incompressible.
+    int _incompressibleMessages = 0;
+
+    // Number of upcoming messages to send uncompressed.
+    int _messagesToSkip = 0;
 };
 
 }  // namespace mongo
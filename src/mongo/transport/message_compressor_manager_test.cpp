@@ -252,6 +252,34 @@ TEST(ZstdMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<ZstdMessageCompressor>());
 }
 
+// A raw content dictionary, zstd also accepts dictionaries which weren't trained.
+const std::string kZstdDictionary =
+    "Hello, world! find getMore insert update delete cursor firstBatch nextBatch";
+
+TEST(ZstdDictionaryMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>(kZstdDictionary));
+}
+
+TEST(ZstdDictionaryMessageCompressor, Overflow) {
+    checkOverflow(stdx::make_unique<ZstdMessageCompressor>(kZstdDictionary));
+}
+
+TEST(ZstdDictionaryMessageCompressor, CannotDecompressWithoutDictionary) {
+    ZstdMessageCompressor dictionaryCompressor(kZstdDictionary);
+    ZstdMessageCompressor plainCompressor;
+
+    const std::string data = "Hello, world! Hello, world!";
+    std::vector<char> compressed(dictionaryCompressor.getMaxCompressedSize(data.size()));
+    auto compressedSize = assertOk(dictionaryCompressor.compressData(
+        ConstDataRange(data.data(), data.size()), DataRange(compressed.data(), compressed.size())));
+
+    std::vector<char> decompressed(data.size());
+    ASSERT_NOT_OK(
+        plainCompressor.decompressData(ConstDataRange(compressed.data(), compressedSize),
+                                       DataRange(decompressed.data(), decompressed.size())));
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
@@ -364,5 +392,20 @@ TEST(MessageCompressorManager, RuntMessage) {
     ASSERT_NOT_OK(status);
 }
 
+TEST(MessageCompressorManager, SkipsCompressionOfIncompressibleMessages) {
+    auto registry = buildRegistry();
+    MessageCompressorManager compManager(&registry);
+    const auto noopId = registry.getCompressor("noop")->getId();
+
+    // The noop compressor never shrinks a message, so compression stops after a few messages.
+    for (int i = 0; i < 8; i++) {
+        auto compressed = assertOk(compManager.compressMessage(buildMessage(), &noopId));
+        ASSERT_EQ(compressed.operation(), dbCompressed);
+    }
+
+    auto skipped = assertOk(compManager.compressMessage(buildMessage(), &noopId));
+    ASSERT_EQ(skipped.operation(), dbQuery);
+}
+
 }  // namespace
 }  // namespace mongo
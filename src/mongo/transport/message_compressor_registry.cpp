@@ -57,6 +57,8 @@ StringData getMessageCompressorName(MessageCompressor id) {
             return "zlib"_sd;
         case MessageCompressor::kZstd:
             return "zstd"_sd;
+        case MessageCompressor::kZstdDictionary:
+            return "zstd-dict"_sd;
         default:
             fassert(40269, "Invalid message compressor ID");
     }
@@ -95,6 +97,14 @@ Status MessageCompressorRegistry::finalizeSupportedCompressors() {
     return Status::OK();
 }
 
+void MessageCompressorRegistry::setZstdDictionaryPath(std::string path) {
+    _zstdDictionaryPath = std::move(path);
+}
+
+const std::string& MessageCompressorRegistry::getZstdDictionaryPath() const {
+    return _zstdDictionaryPath;
+}
+
 const std::vector<std::string>& MessageCompressorRegistry::getCompressorNames() const {
     return _compressorNames;
 }
@@ -126,6 +136,11 @@ Status storeMessageCompressionOptions(const std::string& compressors) {
     return Status::OK();
 }
 
+Status storeMessageCompressionDictionaryOptions(const std::string& zstdDictionaryPath) {
+    MessageCompressorRegistry::get().setZstdDictionaryPath(zstdDictionaryPath);
+    return Status::OK();
+}
+
 // This instantiates and registers the "noop" compressor. It must happen after option storage
 // because that's when the configuration of the compressors gets set.
 MONGO_INITIALIZER_GENERAL(NoopMessageCompressorInit,
@@ -110,14 +110,24 @@ public:
      */
     Status finalizeSupportedCompressors();
 
+    /*
+     * Sets the path of the pre-trained dictionary for the "zstd-dict" compressor, which is only
+     * registered if a path was set. Should be called during option parsing.
+     */
+    void setZstdDictionaryPath(std::string path);
+
+    const std::string& getZstdDictionaryPath() const;
+
 private:
     StringMap<MessageCompressorBase*> _compressorsByName;
     std::array<std::unique_ptr<MessageCompressorBase>,
                std::numeric_limits<MessageCompressorId>::max() + 1>
         _compressorsByIds;
     std::vector<std::string> _compressorNames;
+    std::string _zstdDictionaryPath;
 };
 
 Status storeMessageCompressionOptions(const std::string& compressors);
+Status storeMessageCompressionDictionaryOptions(const std::string& zstdDictionaryPath);
 void appendMessageCompressionStats(BSONObjBuilder* b);
 }  // namespace mongo
@@ -31,28 +31,92 @@
 
 #include "mongo/platform/basic.h"
 
+// Needed for ZSTD_getDictID_fromDict(). The server links zstd statically.
+#define ZSTD_STATIC_LINKING_ONLY
 #include <zstd.h>
 
 #include "mongo/base/init.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/util/log.h"
+
+#include <fstream>
+#include <sstream>
 
 namespace mongo {
+namespace {
+
+struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* ctx) const {
+        ZSTD_freeCCtx(ctx);
+    }
+};
+
+struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* ctx) const {
+        ZSTD_freeDCtx(ctx);
+    }
+};
+
+// Setting up a context is expensive compared to compressing a small message, so every thread
+// keeps one context for compression and one for decompression and reuses it for all messages.
+ZSTD_CCtx* getThreadCompressionContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> ctx(ZSTD_createCCtx());
+    return ctx.get();
+}
+
+ZSTD_DCtx* getThreadDecompressionContext() {
+    thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> ctx(ZSTD_createDCtx());
+    return ctx.get();
+}
+
+}  // namespace
+
+void ZstdMessageCompressor::CDictDeleter::operator()(ZSTD_CDict* dict) const {
+    ZSTD_freeCDict(dict);
+}
+
+void ZstdMessageCompressor::DDictDeleter::operator()(ZSTD_DDict* dict) const {
+    ZSTD_freeDDict(dict);
+}
 
 ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
 
+ZstdMessageCompressor::ZstdMessageCompressor(std::string dictionary)
+    : MessageCompressorBase(MessageCompressor::kZstdDictionary),
+      _cdict(ZSTD_createCDict(dictionary.data(), dictionary.size(), ZSTD_CLEVEL_DEFAULT)),
+      _ddict(ZSTD_createDDict(dictionary.data(), dictionary.size())) {
+    uassert(ErrorCodes::BadValue,
+            "Could not load the zstd network message compression dictionary",
+            _cdict && _ddict);
+}
+
+ZstdMessageCompressor::~ZstdMessageCompressor() = default;
+
 std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
     return ZSTD_compressBound(inputSize);
 }
 
 StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
                                                             DataRange output) {
-    size_t ret = ZSTD_compress(const_cast<char*>(output.data()),
-                               output.length(),
-                               input.data(),
-                               input.length(),
-                               ZSTD_CLEVEL_DEFAULT);
+    auto ctx = getThreadCompressionContext();
+    if (!ctx) {
+        return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate a zstd context"};
+    }
+
+    size_t ret = _cdict ? ZSTD_compress_usingCDict(ctx,
+                                                   const_cast<char*>(output.data()),
+                                                   output.length(),
+                                                   input.data(),
+                                                   input.length(),
+                                                   _cdict.get())
+                        : ZSTD_compressCCtx(ctx,
+                                            const_cast<char*>(output.data()),
+                                            output.length(),
+                                            input.data(),
+                                            input.length(),
+                                            ZSTD_CLEVEL_DEFAULT);
 
     if (ZSTD_isError(ret)) {
         return Status{ErrorCodes::BadValue,
@@ -64,8 +128,22 @@ StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input
 
 StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
                                                               DataRange output) {
-    size_t ret = ZSTD_decompress(
-        const_cast<char*>(output.data()), output.length(), input.data(), input.length());
+    auto ctx = getThreadDecompressionContext();
+    if (!ctx) {
+        return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate a zstd context"};
+    }
+
+    size_t ret = _ddict ? ZSTD_decompress_usingDDict(ctx,
+                                                     const_cast<char*>(output.data()),
+                                                     output.length(),
+                                                     input.data(),
+                                                     input.length(),
+                                                     _ddict.get())
+                        : ZSTD_decompressDCtx(ctx,
+                                              const_cast<char*>(output.data()),
+                                              output.length(),
+                                              input.data(),
+                                              input.length());
 
     if (ZSTD_isError(ret)) {
         return Status{ErrorCodes::BadValue,
@@ -83,6 +161,26 @@ MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
 (InitializerContext* context) {
     auto& compressorRegistry = MessageCompressorRegistry::get();
     compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>());
+
+    const auto& dictionaryPath = compressorRegistry.getZstdDictionaryPath();
+    if (dictionaryPath.empty()) {
+        return Status::OK();
+    }
+
+    std::ifstream dictionaryFile(dictionaryPath, std::ios::in | std::ios::binary);
+    std::stringstream dictionaryStream;
+    dictionaryStream << dictionaryFile.rdbuf();
+    auto dictionary = dictionaryStream.str();
+    if (!dictionaryFile || dictionary.empty()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Could not read the zstd network message compression dictionary "
+                              << dictionaryPath};
+    }
+
+    log() << "Loaded zstd network message compression dictionary " << dictionaryPath
+          << " with id " << ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    compressorRegistry.registerImplementation(
+        stdx::make_unique<ZstdMessageCompressor>(std::move(dictionary)));
     return Status::OK();
 }
 }  // namespace mongo
@@ -27,18 +27,46 @@
  *    it in the license file.
  */
 
+#include <memory>
+#include <string>
+
 #include "mongo/transport/message_compressor_base.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 namespace mongo {
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
     ZstdMessageCompressor();
 
+    /*
+     * Constructs the "zstd-dict" compressor, which compresses with a pre-trained dictionary.
+     * Small messages with a repetitive structure, like those between members of a cluster,
+     * compress much better with a dictionary, but every peer must load the same dictionary.
+     */
+    explicit ZstdMessageCompressor(std::string dictionary);
+
+    ~ZstdMessageCompressor();
+
     std::size_t getMaxCompressedSize(size_t inputSize) override;
 
     StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
 
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+private:
+    struct CDictDeleter {
+        void operator()(ZSTD_CDict_s* dict) const;
+    };
+    struct DDictDeleter {
+        void operator()(ZSTD_DDict_s* dict) const;
+    };
+
+    // Digested forms of the dictionary, only set for the "zstd-dict" compressor. These are only
+    // read after construction, so they can be shared by all threads.
+    std::unique_ptr<ZSTD_CDict_s, CDictDeleter> _cdict;
+    std::unique_ptr<ZSTD_DDict_s, DDictDeleter> _ddict;
 };
 
 
@@ -37,6 +37,7 @@
 #include "mongo/transport/service_executor_adaptive.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/service_executor_work_stealing.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -107,6 +108,17 @@ public:
         }
     }
 
+    void runOneFor(Milliseconds time) noexcept final {
+        asio::io_context::work work(_ioContext);
+
+        try {
+            _ioContext.run_one_for(time.toSystemDuration());
+        } catch (...) {
+            severe() << "Uncaught exception in reactor: " << exceptionToStatus();
+            fassertFailed(51251);
+        }
+    }
+
     void stop() final {
         _ioContext.stop();
     }
@@ -176,6 +188,19 @@ protected:
     std::unique_ptr<ServiceExecutorSynchronous> executor;
 };
 
+class ServiceExecutorWorkStealingFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = ServiceContext::make();
+        setGlobalServiceContext(std::move(scOwned));
+
+        executor = stdx::make_unique<ServiceExecutorWorkStealing>(
+            getGlobalServiceContext(), std::make_shared<ASIOReactor>(), 2);
+    }
+
+    std::unique_ptr<ServiceExecutorWorkStealing> executor;
+};
+
 void scheduleBasicTask(ServiceExecutor* exec, bool expectSuccess) {
     stdx::condition_variable cond;
     stdx::mutex mutex;
@@ -217,6 +242,63 @@ TEST_F(ServiceExecutorSynchronousFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorWorkStealingFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, StartsExtraThreadWhenAllWorkersAreBlocked) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int numBlocked = 0;
+    bool released = false;
+
+    // Occupy both workers with tasks that only finish once a later task has run.
+    for (int i = 0; i < 2; i++) {
+        ASSERT_OK(executor->schedule(
+            [&] {
+                stdx::unique_lock<stdx::mutex> lk(mutex);
+                ++numBlocked;
+                cond.notify_all();
+                cond.wait_for(lk, Seconds(30).toSystemDuration(), [&] { return released; });
+            },
+            ServiceExecutor::kEmptyFlags,
+            ServiceExecutorTaskName::kSSMProcessMessage));
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return numBlocked == 2; });
+    }
+
+    ASSERT_OK(executor->schedule(
+        [&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            released = true;
+            cond.notify_all();
+        },
+        ServiceExecutor::kEmptyFlags,
+        ServiceExecutorTaskName::kSSMProcessMessage));
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        ASSERT(cond.wait_for(lk, Seconds(10).toSystemDuration(), [&] { return released; }));
+    }
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_GTE(bob.obj()["extraThreadsStarted"].numberLong(), 1);
+}
+
 
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,397 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_work_stealing.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "workStealing"_sd;
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kWorkers = "workers"_sd;
+constexpr auto kQueueDepth = "queueDepth"_sd;
+constexpr auto kExecuted = "executed"_sd;
+constexpr auto kStolen = "stolen"_sd;
+constexpr auto kOverflowQueueDepth = "overflowQueueDepth"_sd;
+constexpr auto kExtraThreadsStarted = "extraThreadsStarted"_sd;
+
+// How long an idle worker waits for an I/O completion before checking for shutdown again
+constexpr Milliseconds kReactorPollTime{100};
+
+// How long an extra thread stays around without finding a task
+constexpr Milliseconds kExtraThreadIdleTime{10 * 1000};
+
+size_t defaultNumWorkers() {
+    const auto value = workStealingServiceExecutorThreads.load();
+    if (value > 0) {
+        return static_cast<size_t>(value);
+    }
+    return std::max<size_t>(ProcessInfo::getNumAvailableCores(), 1);
+}
+
+}  // namespace
+
+constexpr size_t ServiceExecutorWorkStealing::kWorkerQueueCapacity;
+
+thread_local ServiceExecutorWorkStealing::Worker* ServiceExecutorWorkStealing::_localWorker =
+    nullptr;
+thread_local int ServiceExecutorWorkStealing::_localRecursionDepth = 0;
+
+ServiceExecutorWorkStealing::ServiceExecutorWorkStealing(ServiceContext* ctx,
+                                                         ReactorHandle reactor)
+    : ServiceExecutorWorkStealing(ctx, std::move(reactor), defaultNumWorkers()) {}
+
+ServiceExecutorWorkStealing::ServiceExecutorWorkStealing(ServiceContext* ctx,
+                                                         ReactorHandle reactor,
+                                                         size_t numWorkers)
+    : _reactorHandle(std::move(reactor)), _numWorkers(numWorkers) {
+    invariant(_numWorkers > 0);
+    for (size_t i = 0; i < _numWorkers; i++) {
+        _workers.push_back(stdx::make_unique<Worker>(i));
+    }
+}
+
+ServiceExecutorWorkStealing::~ServiceExecutorWorkStealing() {
+    invariant(!_stillRunning.load());
+}
+
+Status ServiceExecutorWorkStealing::start() {
+    invariant(!_stillRunning.load());
+    _stillRunning.store(true);
+
+    for (size_t i = 0; i < _numWorkers; i++) {
+        auto status = _startThread([this, i] { _workerThreadRoutine(i); });
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    _controllerThread =
+        stdx::thread(&ServiceExecutorWorkStealing::_controllerThreadRoutine, this);
+
+    return Status::OK();
+}
+
+Status ServiceExecutorWorkStealing::_startThread(stdx::function<void()> routine) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _numRunningWorkers++;
+    }
+
+    auto status = launchServiceWorkerThread(std::move(routine));
+    if (!status.isOK()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _numRunningWorkers--;
+        _shutdownCondition.notify_one();
+    }
+    return status;
+}
+
+void ServiceExecutorWorkStealing::_workerThreadRoutine(size_t workerId) {
+    {
+        std::string threadName = str::stream() << "worker-" << workerId;
+        setThreadName(threadName);
+    }
+
+    log() << "Started work stealing service executor worker " << workerId;
+
+    _localWorker = _workers[workerId].get();
+    const auto guard = makeGuard([this] {
+        _localWorker = nullptr;
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _numRunningWorkers--;
+        _shutdownCondition.notify_one();
+    });
+
+    while (_stillRunning.load()) {
+        auto task = _nextTask(_localWorker);
+        if (!task) {
+            // Nothing to run, so wait for I/O completions (or a wakeup from schedule()) instead.
+            // The completion handlers schedule their follow-up tasks on this worker.
+            _reactorHandle->runOneFor(kReactorPollTime);
+            continue;
+        }
+
+        _runTask(task);
+        _localWorker->executed.addAndFetch(1);
+    }
+
+    LOG(3) << "Exiting work stealing service executor worker " << workerId;
+}
+
+void ServiceExecutorWorkStealing::_extraThreadRoutine(size_t threadId) {
+    {
+        std::string threadName = str::stream() << "worker-extra-" << threadId;
+        setThreadName(threadName);
+    }
+
+    log() << "Started extra work stealing service executor thread " << threadId;
+
+    const auto guard = makeGuard([this] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _numRunningWorkers--;
+        _shutdownCondition.notify_one();
+    });
+
+    // Tasks scheduled from an extra thread are spread across the workers like those of any other
+    // thread, and the extra thread steals them back while the workers are busy.
+    auto lastTaskTime = Date_t::now();
+    while (_stillRunning.load()) {
+        auto task = _nextTask(nullptr);
+        if (!task) {
+            if (Date_t::now() - lastTaskTime >= kExtraThreadIdleTime) {
+                break;
+            }
+            _reactorHandle->runOneFor(kReactorPollTime);
+            continue;
+        }
+
+        _runTask(task);
+        _extraExecuted.addAndFetch(1);
+        lastTaskTime = Date_t::now();
+    }
+
+    LOG(3) << "Exiting extra work stealing service executor thread " << threadId;
+}
+
+void ServiceExecutorWorkStealing::_runTask(Task& task) {
+    _numBusyThreads.addAndFetch(1);
+    const auto guard = makeGuard([this] { _numBusyThreads.subtractAndFetch(1); });
+
+    _localRecursionDepth = 1;
+    task();
+}
+
+/*
+ * Every thread is stuck when each of them is running a task and none of those tasks has completed
+ * since the previous check, for example because they are all waiting on locks held by operations
+ * whose own tasks are queued behind them. I/O completions are not visible as queued tasks until a
+ * thread runs the reactor, so the check does not look at the queues.
+ */
+void ServiceExecutorWorkStealing::_controllerThreadRoutine() {
+    setThreadName("worker-controller"_sd);
+
+    auto lastExecuted = _totalExecuted();
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_stillRunning.load()) {
+        const Milliseconds stuckThreadTimeout{
+            workStealingServiceExecutorStuckThreadTimeoutMillis.load()};
+        _controllerCondition.wait_for(lk, stuckThreadTimeout.toSystemDuration(), [this] {
+            return !_stillRunning.load();
+        });
+        if (!_stillRunning.load()) {
+            break;
+        }
+
+        const auto executed = _totalExecuted();
+        const bool stuck = executed == lastExecuted &&
+            static_cast<size_t>(_numBusyThreads.load()) >= _numRunningWorkers;
+        lastExecuted = executed;
+        if (!stuck) {
+            continue;
+        }
+
+        const auto threadId = _extraThreadsStarted.fetchAndAdd(1);
+        log() << "All " << _numRunningWorkers << " work stealing service executor threads have "
+              << "been busy for " << stuckThreadTimeout << ", starting an extra thread";
+
+        lk.unlock();
+        auto status = _startThread([this, threadId] { _extraThreadRoutine(threadId); });
+        if (!status.isOK()) {
+            warning() << "Failed to start an extra work stealing service executor thread: "
+                      << status;
+        }
+        lk.lock();
+    }
+}
+
+long long ServiceExecutorWorkStealing::_totalExecuted() const {
+    long long total = _extraExecuted.load();
+    for (const auto& worker : _workers) {
+        total += worker->executed.load();
+    }
+    return total;
+}
+
+ServiceExecutor::Task ServiceExecutorWorkStealing::_nextTask(Worker* worker) {
+    Task task;
+    if (worker && worker->tasks.tryPop(&task)) {
+        return task;
+    }
+
+    if (_overflowDepth.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_overflowMutex);
+        if (!_overflowTasks.empty()) {
+            task = std::move(_overflowTasks.front());
+            _overflowTasks.pop_front();
+            _overflowDepth.subtractAndFetch(1);
+            return task;
+        }
+    }
+
+    // Steal the oldest task of the first other worker which has any
+    const size_t first = worker ? worker->id + 1 : _nextWorker.load();
+    for (size_t i = 0; i < _numWorkers; i++) {
+        auto& victim = *_workers[(first + i) % _numWorkers];
+        if (&victim != worker && victim.tasks.tryPop(&task)) {
+            if (worker) {
+                worker->stolen.addAndFetch(1);
+            }
+            return task;
+        }
+    }
+
+    return Task();
+}
+
+void ServiceExecutorWorkStealing::_enqueue(size_t workerId, Task task) {
+    auto& worker = *_workers[workerId];
+    if (!worker.tasks.tryPush(std::move(task))) {
+        stdx::lock_guard<stdx::mutex> lk(_overflowMutex);
+        _overflowTasks.push_back(std::move(task));
+        _overflowDepth.addAndFetch(1);
+    }
+
+    // A worker which is running the reactor returns from it after the current handler and picks up
+    // its own tasks. In every other case, post a no-op to the reactor to wake up an idle worker,
+    // which will steal the task if its owner is busy.
+    if (_localWorker != &worker || _localRecursionDepth > 0 || worker.tasks.size() > 1) {
+        _reactorHandle->schedule([] {});
+    }
+}
+
+Status ServiceExecutorWorkStealing::shutdown(Milliseconds timeout) {
+    LOG(3) << "Shutting down work stealing executor";
+
+    if (!_stillRunning.load())
+        return Status::OK();
+
+    _stillRunning.store(false);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _controllerCondition.notify_one();
+    }
+    if (_controllerThread.joinable()) {
+        _controllerThread.join();
+    }
+    _reactorHandle->stop();
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    bool result = _shutdownCondition.wait_for(
+        lk, timeout.toSystemDuration(), [this] { return _numRunningWorkers == 0; });
+
+    return result
+        ? Status::OK()
+        : Status(ErrorCodes::Error::ExceededTimeLimit,
+                 "work stealing executor couldn't shutdown all worker threads within time limit.");
+}
+
+Status ServiceExecutorWorkStealing::schedule(Task task,
+                                             ScheduleFlags flags,
+                                             ServiceExecutorTaskName taskName) {
+    if (!_stillRunning.load()) {
+        return Status{ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    _totalQueued.addAndFetch(1);
+
+    if (!_localWorker) {
+        // Spread the tasks scheduled by other threads, such as new sessions, across the workers
+        _enqueue(_nextWorker.fetchAndAdd(1) % _numWorkers, std::move(task));
+        return Status::OK();
+    }
+
+    // Execute task directly (recurse) if allowed by the caller as it produced better performance
+    // in testing. Try to limit the amount of recursion so we don't blow up the stack.
+    if ((flags & ScheduleFlags::kMayRecurse) && _localRecursionDepth > 0 &&
+        (_localRecursionDepth < workStealingServiceExecutorRecursionLimit.loadRelaxed())) {
+        ++_localRecursionDepth;
+        const auto guard = makeGuard([] { --_localRecursionDepth; });
+        task();
+        _localWorker->executed.addAndFetch(1);
+        return Status::OK();
+    }
+
+    _enqueue(_localWorker->id, std::move(task));
+
+    return Status::OK();
+}
+
+void ServiceExecutorWorkStealing::appendStats(BSONObjBuilder* bob) const {
+    long long totalExecuted = 0;
+    long long totalStolen = 0;
+
+    BSONArrayBuilder workers;
+    for (const auto& worker : _workers) {
+        const auto executed = worker->executed.load();
+        const auto stolen = worker->stolen.load();
+        totalExecuted += executed;
+        totalStolen += stolen;
+
+        workers.append(BSON(kQueueDepth << static_cast<long long>(worker->tasks.size())
+                                        << kExecuted
+                                        << executed
+                                        << kStolen
+                                        << stolen));
+    }
+
+    int threadsRunning;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        threadsRunning = static_cast<int>(_numRunningWorkers);
+    }
+
+    *bob << kExecutorLabel << kExecutorName << kThreadsRunning << threadsRunning << kTotalQueued
+         << _totalQueued.load() << kTotalExecuted << totalExecuted << kTotalStolen << totalStolen
+         << kOverflowQueueDepth << _overflowDepth.load() << kExtraThreadsStarted
+         << _extraThreadsStarted.load() << kWorkers << workers.arr();
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/concurrency/bounded_mpmc_queue.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * The work stealing service executor runs a fixed number of worker threads, by default one per
+ * core. Each worker has its own queue of tasks. Tasks scheduled from a worker thread are queued
+ * on that worker, so a connection tends to stay on the same worker, and tasks scheduled from any
+ * other thread are spread across the workers round-robin.
+ *
+ * A worker without local tasks first tries to steal the oldest task of another worker and only
+ * then runs the networking reactor, one handler at a time, to wait for I/O completions. A task
+ * which blocks occupies its worker until it finishes, so a controller thread watches for the
+ * case where every thread is busy and no task has completed for
+ * workStealingServiceExecutorStuckThreadTimeoutMillis. It then starts an extra thread, which has
+ * no queue of its own but steals tasks and runs the reactor like a worker, and which exits once it
+ * has been idle for a while.
+ *
+ * The worker queues are lock-free and bounded. Tasks which don't fit go to a shared overflow
+ * queue, which every worker checks before stealing.
+ */
+class ServiceExecutorWorkStealing final : public ServiceExecutor {
+public:
+    explicit ServiceExecutorWorkStealing(ServiceContext* ctx, ReactorHandle reactor);
+    ServiceExecutorWorkStealing(ServiceContext* ctx, ReactorHandle reactor, size_t numWorkers);
+
+    ~ServiceExecutorWorkStealing();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override;
+
+    Mode transportMode() const override {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+private:
+    static constexpr size_t kWorkerQueueCapacity = 1024;
+
+    struct Worker {
+        explicit Worker(size_t id) : id(id) {}
+
+        const size_t id;
+
+        BoundedMPMCQueue<Task> tasks{kWorkerQueueCapacity};
+
+        AtomicWord<long long> executed{0};
+        AtomicWord<long long> stolen{0};
+    };
+
+    void _workerThreadRoutine(size_t workerId);
+    void _extraThreadRoutine(size_t threadId);
+    void _controllerThreadRoutine();
+
+    /**
+     * Starts a thread running 'routine' that counts towards the running threads.
+     */
+    Status _startThread(stdx::function<void()> routine);
+
+    /**
+     * Pops the oldest task of 'worker', or steals one from another worker if it has none. Extra
+     * threads pass a null 'worker' and only steal. Returns an empty task if no task was found.
+     */
+    Task _nextTask(Worker* worker);
+
+    void _runTask(Task& task);
+
+    long long _totalExecuted() const;
+
+    void _enqueue(size_t workerId, Task task);
+
+    static thread_local Worker* _localWorker;
+    static thread_local int _localRecursionDepth;
+
+    ReactorHandle _reactorHandle;
+    const size_t _numWorkers;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    AtomicWord<bool> _stillRunning{false};
+    AtomicWord<unsigned> _nextWorker{0};
+    AtomicWord<long long> _totalQueued{0};
+
+    stdx::mutex _overflowMutex;
+    std::deque<Task> _overflowTasks;  // Guarded by '_overflowMutex'
+    AtomicWord<long long> _overflowDepth{0};
+
+    AtomicWord<int> _numBusyThreads{0};
+    AtomicWord<long long> _extraExecuted{0};
+    AtomicWord<long long> _extraThreadsStarted{0};
+
+    stdx::thread _controllerThread;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _shutdownCondition;
+    stdx::condition_variable _controllerCondition;
+    size_t _numRunningWorkers{0};  // Guarded by '_mutex'
+};
+
+}  // namespace transport
+}  // namespace mongo
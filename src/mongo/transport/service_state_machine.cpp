@@ -118,7 +118,9 @@ Message makeExhaustMessage(Message requestMsg, DbResponse* dbresponse) {
         return Message();
     }
 
-    auto reply = OpMsg::parse(dbresponse->response);
+    // The reply was built by this server, so there is no need to validate the batch it holds
+    // again for every batch of the stream.
+    auto reply = OpMsg::parseTrusted(dbresponse->response);
 
     // Check for a non-OK response.
     auto resOk = reply.body["ok"].number();
@@ -343,7 +343,8 @@ private:
     Future<Message> sourceMessageImpl(const BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
-        auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
+        // Most messages fit into the smallest pooled buffer, which then also receives the body.
+        auto headerBuffer = SharedBuffer::allocatePooled(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
             .then([ headerBuffer = std::move(headerBuffer), this, baton ]() mutable {
@@ -370,8 +371,12 @@ private:
                     return Future<Message>::makeReady(Message(std::move(headerBuffer)));
                 }
 
-                auto buffer = SharedBuffer::allocate(msgLen);
-                memcpy(buffer.get(), headerBuffer.get(), kHeaderSize);
+                auto buffer = std::move(headerBuffer);
+                if (msgLen > buffer.capacity()) {
+                    auto largerBuffer = SharedBuffer::allocatePooled(msgLen);
+                    memcpy(largerBuffer.get(), buffer.get(), kHeaderSize);
+                    buffer = std::move(largerBuffer);
+                }
 
                 MsgData::View msgView(buffer.get());
                 return read(asio::buffer(msgView.data(), msgView.dataLen()), baton)
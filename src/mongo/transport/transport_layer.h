@@ -165,6 +165,11 @@ public:
      */
     virtual void run() noexcept = 0;
     virtual void runFor(Milliseconds time) noexcept = 0;
+
+    /*
+     * Runs at most one handler of the event loop, waiting at most 'time' for one to become ready.
+     */
+    virtual void runOneFor(Milliseconds time) noexcept = 0;
     virtual void stop() = 0;
     virtual void drain() = 0;
 
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/buffer_arena.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mongo/util/allocator.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kAlignment = alignof(std::max_align_t);
+
+size_t alignUp(size_t bytes) {
+    return (bytes + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+}  // namespace
+
+BufferArena::~BufferArena() {
+    while (_chunk) {
+        auto prev = _chunk->prev;
+        mongoFree(_chunk, _chunk->size);
+        _chunk = prev;
+    }
+}
+
+char* BufferArena::allocate(size_t bytes) {
+    bytes = alignUp(bytes);
+    if (static_cast<size_t>(_end - _next) < bytes) {
+        return _allocateFromNewChunk(bytes);
+    }
+
+    auto ptr = _next;
+    _next += bytes;
+    return ptr;
+}
+
+char* BufferArena::reallocate(char* ptr, size_t oldBytes, size_t newBytes) {
+    if (!ptr) {
+        return allocate(newBytes);
+    }
+
+    if (ptr + alignUp(oldBytes) == _next &&
+        static_cast<size_t>(_end - ptr) >= alignUp(newBytes)) {
+        _next = ptr + alignUp(newBytes);
+        return ptr;
+    }
+
+    auto newPtr = allocate(newBytes);
+    memcpy(newPtr, ptr, std::min(oldBytes, newBytes));
+    return newPtr;
+}
+
+char* BufferArena::_allocateFromNewChunk(size_t bytes) {
+    // Chunks double in size up to kMaxChunkSize, so that operations which build little stay
+    // small. Regions which do not fit in such a chunk get a chunk of their own.
+    const size_t headerSize = alignUp(sizeof(Chunk));
+    const size_t chunkSize = std::max(
+        headerSize + bytes,
+        _chunk ? std::min(_chunk->size * 2, kMaxChunkSize) : kMinChunkSize);
+
+    auto chunk = static_cast<Chunk*>(mongoMalloc(chunkSize));
+    chunk->prev = _chunk;
+    chunk->size = chunkSize;
+    _chunk = chunk;
+    _bytesReserved += chunkSize;
+
+    auto ptr = reinterpret_cast<char*>(chunk) + headerSize;
+    _next = ptr + bytes;
+    _end = reinterpret_cast<char*>(chunk) + chunkSize;
+    return ptr;
+}
+
+}  // namespace mongo
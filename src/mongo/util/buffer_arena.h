@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+/**
+ * A region of memory out of which buffers are carved by bumping a pointer, and which is freed
+ * all at once when the arena is destroyed. Meant for the many short-lived builders of an
+ * operation, so that building them does not go through the allocator every time.
+ *
+ * Memory given out by an arena is never reused before the arena is destroyed, so it must not be
+ * used for buffers which are grown without bound or which outlive the arena.
+ *
+ * Not thread safe.
+ */
+class BufferArena {
+    MONGO_DISALLOW_COPYING(BufferArena);
+
+public:
+    static constexpr size_t kMinChunkSize = 16 * 1024;
+    static constexpr size_t kMaxChunkSize = 1024 * 1024;
+
+    BufferArena() = default;
+    ~BufferArena();
+
+    /**
+     * Returns 'bytes' bytes of memory which stay valid until the arena is destroyed.
+     */
+    char* allocate(size_t bytes);
+
+    /**
+     * Grows the region at 'ptr' of 'oldBytes' bytes to 'newBytes' bytes and returns its new
+     * location. The region is extended in place if it is the latest one allocated and the current
+     * chunk has room, and is otherwise copied to a new region.
+     */
+    char* reallocate(char* ptr, size_t oldBytes, size_t newBytes);
+
+    /**
+     * Returns the number of bytes of the chunks held by this arena.
+     */
+    size_t bytesReserved() const {
+        return _bytesReserved;
+    }
+
+private:
+    struct Chunk {
+        Chunk* prev;
+        size_t size;
+    };
+
+    char* _allocateFromNewChunk(size_t bytes);
+
+    Chunk* _chunk = nullptr;
+    char* _next = nullptr;
+    char* _end = nullptr;
+    size_t _bytesReserved = 0;
+};
+
+}  // namespace mongo
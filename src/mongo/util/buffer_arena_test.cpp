@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/buffer_arena.h"
+
+#include <cstring>
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(BufferArenaTest, AllocationsDoNotOverlap) {
+    BufferArena arena;
+    auto first = arena.allocate(100);
+    memset(first, 'a', 100);
+    auto second = arena.allocate(100);
+    memset(second, 'b', 100);
+
+    ASSERT_GTE(second, first + 100);
+    ASSERT_EQ(first[99], 'a');
+    ASSERT_EQ(arena.bytesReserved(), BufferArena::kMinChunkSize);
+}
+
+TEST(BufferArenaTest, ReallocateLatestGrowsInPlace) {
+    BufferArena arena;
+    auto ptr = arena.allocate(64);
+    ASSERT_EQ(arena.reallocate(ptr, 64, 1024), ptr);
+}
+
+TEST(BufferArenaTest, ReallocateOlderRegionCopies) {
+    BufferArena arena;
+    auto ptr = arena.allocate(64);
+    strcpy(ptr, "arena");
+    arena.allocate(64);
+
+    auto moved = arena.reallocate(ptr, 64, 128);
+    ASSERT_NE(moved, ptr);
+    ASSERT_EQ(std::string(moved), "arena");
+}
+
+TEST(BufferArenaTest, LargeAllocationGetsItsOwnChunk) {
+    BufferArena arena;
+    arena.allocate(16);
+    auto ptr = arena.allocate(4 * BufferArena::kMaxChunkSize);
+    memset(ptr, 0, 4 * BufferArena::kMaxChunkSize);
+    ASSERT_GT(arena.bytesReserved(), 4 * BufferArena::kMaxChunkSize);
+}
+
+TEST(BufferArenaTest, ChunksGrowUpToMaxChunkSize) {
+    BufferArena arena;
+    for (int i = 0; i < 1000; ++i) {
+        arena.allocate(4096);
+    }
+    ASSERT_GTE(arena.bytesReserved(), 1000U * 4096);
+    ASSERT_LT(arena.bytesReserved(), 1000U * 4096 + 2 * BufferArena::kMaxChunkSize);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,8 @@
 #include "mongo/util/fast_clock_source_factory.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/system_clock_source.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/tsc_tick_source.h"
 
 namespace mongo {
 namespace {
@@ -76,5 +78,25 @@ BENCHMARK(BM_ClockNow)
     ->Arg(1)
     ->Arg(10);
 
+/**
+ * Benchmark calls to the getTicks() method of a tick source. With an argument of 0, tests the
+ * system tick source, and with an argument of 1, the TSC tick source (which is the system tick
+ * source on processors without an invariant TSC).
+ */
+void BM_TickSourceGetTicks(benchmark::State& state) {
+    TickSource* tickSource =
+        state.range(0) ? TscTickSource::get() : static_cast<TickSource*>(SystemTickSource::get());
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(tickSource->getTicks());
+    }
+}
+
+BENCHMARK(BM_TickSourceGetTicks)
+    ->ThreadRange(1, ProcessInfo::getNumAvailableCores())
+    ->ArgName("tsc")
+    ->Arg(0)
+    ->Arg(1);
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A lock-free queue with a fixed capacity which any number of threads can push to and pop from
+ * concurrently. Pushing to a full queue and popping from an empty queue fail instead of blocking,
+ * so callers need a fallback for both.
+ *
+ * Each slot carries a sequence number telling whether it is ready to be written or read for a
+ * given position, so producers and consumers only contend on their own position counter.
+ */
+template <typename T>
+class BoundedMPMCQueue {
+    MONGO_DISALLOW_COPYING(BoundedMPMCQueue);
+
+public:
+    /**
+     * 'capacity' must be a power of two.
+     */
+    explicit BoundedMPMCQueue(size_t capacity)
+        : _mask(capacity - 1), _cells(new Cell[capacity]) {
+        invariant(capacity >= 2 && (capacity & _mask) == 0);
+        for (size_t i = 0; i < capacity; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Moves 'value' into the queue and returns true, or leaves it untouched and returns false if
+     * the queue is full.
+     */
+    bool tryPush(T&& value) {
+        Cell* cell;
+        size_t pos = _pushPos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &_cells[pos & _mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _pushPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Moves the oldest value of the queue into 'value' and returns true, or returns false if the
+     * queue is empty.
+     */
+    bool tryPop(T* value) {
+        Cell* cell;
+        size_t pos = _popPos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &_cells[pos & _mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _popPos.load(std::memory_order_relaxed);
+            }
+        }
+
+        *value = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Returns the number of values in the queue. This is only a snapshot when other threads are
+     * using the queue at the same time.
+     */
+    size_t size() const {
+        const auto popPos = _popPos.load(std::memory_order_relaxed);
+        const auto pushPos = _pushPos.load(std::memory_order_relaxed);
+        return pushPos > popPos ? pushPos - popPos : 0;
+    }
+
+    size_t capacity() const {
+        return _mask + 1;
+    }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;  // NOLINT
+        T value;
+    };
+
+    const size_t _mask;
+    const std::unique_ptr<Cell[]> _cells;
+
+    // Kept on separate cache lines, so that producers and consumers don't slow each other down.
+    alignas(kCacheLineSize) std::atomic<size_t> _pushPos{0};  // NOLINT
+    alignas(kCacheLineSize) std::atomic<size_t> _popPos{0};   // NOLINT
+};
+
+}  // namespace mongo
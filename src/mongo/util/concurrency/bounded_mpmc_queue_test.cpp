@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/bounded_mpmc_queue.h"
+
+namespace mongo {
+namespace {
+
+TEST(BoundedMPMCQueueTest, PopsInPushOrder) {
+    BoundedMPMCQueue<int> queue(4);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(queue.tryPush(int(i)));
+    }
+    ASSERT_EQ(queue.size(), 3U);
+
+    int value;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(queue.tryPop(&value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_EQ(queue.size(), 0U);
+}
+
+TEST(BoundedMPMCQueueTest, PushFailsWhenFull) {
+    BoundedMPMCQueue<std::unique_ptr<int>> queue(2);
+    ASSERT_TRUE(queue.tryPush(std::make_unique<int>(1)));
+    ASSERT_TRUE(queue.tryPush(std::make_unique<int>(2)));
+
+    // A failed push must leave the value with the caller.
+    auto value = std::make_unique<int>(3);
+    ASSERT_FALSE(queue.tryPush(std::move(value)));
+    ASSERT(value);
+    ASSERT_EQ(*value, 3);
+
+    std::unique_ptr<int> popped;
+    ASSERT_TRUE(queue.tryPop(&popped));
+    ASSERT_EQ(*popped, 1);
+    ASSERT_TRUE(queue.tryPush(std::move(value)));
+}
+
+TEST(BoundedMPMCQueueTest, PopFailsWhenEmpty) {
+    BoundedMPMCQueue<int> queue(2);
+    int value = 0;
+    ASSERT_FALSE(queue.tryPop(&value));
+
+    // Wrap around the slots a few times.
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(queue.tryPush(int(i)));
+        ASSERT_TRUE(queue.tryPop(&value));
+        ASSERT_EQ(value, i);
+        ASSERT_FALSE(queue.tryPop(&value));
+    }
+}
+
+TEST(BoundedMPMCQueueTest, ConcurrentProducersAndConsumers) {
+    constexpr int kThreads = 4;
+    constexpr int kValuesPerProducer = 100000;
+
+    BoundedMPMCQueue<int> queue(64);
+    AtomicWord<long long> sum{0};
+    AtomicWord<int> popped{0};
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&] {
+            for (int i = 1; i <= kValuesPerProducer; i++) {
+                while (!queue.tryPush(int(i))) {
+                    stdx::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&] {
+            int value;
+            while (popped.load() < kThreads * kValuesPerProducer) {
+                if (queue.tryPop(&value)) {
+                    sum.fetchAndAdd(value);
+                    popped.fetchAndAdd(1);
+                } else {
+                    stdx::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(popped.load(), kThreads * kValuesPerProducer);
+    ASSERT_EQ(sum.load(), kThreads * (kValuesPerProducer * (kValuesPerProducer + 1LL) / 2));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * Holds an immutable snapshot of some state that is read far more often than it changes, such as
+ * the maps the catalogs use to resolve names.
+ *
+ * Readers do not take a lock as long as the snapshot has not changed since the calling thread last
+ * read it: every thread caches a reference to the last snapshot it read, along with its version,
+ * and only compares versions on later reads. Writers replace the whole snapshot with publish(), or
+ * drop it with invalidate() so that the owner rebuilds it on the next read. The latter keeps a
+ * burst of changes, like loading the catalog at startup, from copying the state every time.
+ *
+ * A thread keeps the last snapshot it read alive until it reads again, so snapshots should not own
+ * expensive resources.
+ */
+template <typename T>
+class CopyOnWriteSnapshot {
+public:
+    CopyOnWriteSnapshot() : _version(_nextVersion()) {}
+
+    /**
+     * Returns the current snapshot, or nullptr if it was invalidated. The snapshot stays valid
+     * until this thread calls get() on any CopyOnWriteSnapshot<T> again.
+     */
+    const T* get() const {
+        auto& cache = _threadCache();
+        if (cache.version != _version.load()) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            cache.snapshot = _snapshot;
+            cache.version = _version.load();
+        }
+        return cache.snapshot.get();
+    }
+
+    void publish(std::shared_ptr<const T> snapshot) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _snapshot = std::move(snapshot);
+        _version.store(_nextVersion());
+    }
+
+    void invalidate() {
+        publish(nullptr);
+    }
+
+private:
+    struct ThreadCache {
+        unsigned long long version = 0;
+        std::shared_ptr<const T> snapshot;
+    };
+
+    static ThreadCache& _threadCache() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    // Versions are unique across all instances, so that a thread that alternates between
+    // instances never mistakes the snapshot of one for the other.
+    static unsigned long long _nextVersion() {
+        static AtomicWord<unsigned long long> lastVersion{0};
+        return lastVersion.addAndFetch(1);
+    }
+
+    // Guards '_snapshot' and publishing a new version along with it.
+    mutable stdx::mutex _mutex;
+    std::shared_ptr<const T> _snapshot;
+    AtomicWord<unsigned long long> _version;
+};
+
+}  // namespace mongo
@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/copy_on_write_snapshot.h"
+
+namespace mongo {
+namespace {
+
+TEST(CopyOnWriteSnapshotTest, StartsInvalidated) {
+    CopyOnWriteSnapshot<std::string> snapshot;
+    ASSERT(!snapshot.get());
+}
+
+TEST(CopyOnWriteSnapshotTest, ReadsPublishedSnapshot) {
+    CopyOnWriteSnapshot<std::string> snapshot;
+    snapshot.publish(std::make_shared<std::string>("a"));
+    ASSERT_EQ(*snapshot.get(), "a");
+    ASSERT_EQ(*snapshot.get(), "a");
+
+    snapshot.publish(std::make_shared<std::string>("b"));
+    ASSERT_EQ(*snapshot.get(), "b");
+
+    snapshot.invalidate();
+    ASSERT(!snapshot.get());
+}
+
+TEST(CopyOnWriteSnapshotTest, InstancesDoNotShareSnapshots) {
+    CopyOnWriteSnapshot<std::string> first;
+    CopyOnWriteSnapshot<std::string> second;
+    first.publish(std::make_shared<std::string>("first"));
+    second.publish(std::make_shared<std::string>("second"));
+
+    ASSERT_EQ(*first.get(), "first");
+    ASSERT_EQ(*second.get(), "second");
+    ASSERT_EQ(*first.get(), "first");
+}
+
+TEST(CopyOnWriteSnapshotTest, KeepsSnapshotAliveForReader) {
+    CopyOnWriteSnapshot<std::string> snapshot;
+    auto published = std::make_shared<std::string>("a");
+    snapshot.publish(published);
+    const std::string* read = snapshot.get();
+
+    // Replacing the snapshot does not free the one this thread is reading.
+    snapshot.publish(std::make_shared<std::string>("b"));
+    ASSERT_EQ(published.use_count(), 2);
+    ASSERT_EQ(*read, "a");
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/bounded_mpmc_queue.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+// Schedules small tasks from the benchmark thread and waits for the pool to run all of them.
+void BM_threadPoolScheduleSmallTasks(benchmark::State& state) {
+    ThreadPool::Options options;
+    options.minThreads = state.range(0);
+    options.maxThreads = state.range(0);
+    ThreadPool pool(options);
+    pool.startup();
+
+    AtomicWord<long long> executed{0};
+    for (auto _ : state) {
+        for (int i = 0; i < 1000; i++) {
+            invariant(pool.schedule([&] { executed.fetchAndAdd(1); }));
+        }
+        pool.waitForIdle();
+    }
+
+    pool.shutdown();
+    pool.join();
+    state.SetItemsProcessed(executed.load());
+}
+
+BENCHMARK(BM_threadPoolScheduleSmallTasks)->Arg(1)->Arg(4)->Arg(16);
+
+// Every benchmark thread pushes a value and pops one, so that producers and consumers contend.
+void BM_boundedMPMCQueuePushPop(benchmark::State& state) {
+    static BoundedMPMCQueue<int>* queue;
+    if (state.thread_index == 0) {
+        queue = new BoundedMPMCQueue<int>(1024);
+    }
+
+    int value = 0;
+    for (auto _ : state) {
+        while (!queue->tryPush(int(value))) {
+        }
+        while (!queue->tryPop(&value)) {
+        }
+    }
+
+    if (state.thread_index == 0) {
+        delete queue;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_boundedMPMCQueuePushPop)->ThreadRange(1, 16);
+
+}  // namespace mongo
@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/ticket_limit_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mongo {
+namespace {
+
+// How quickly the limit moves towards the computed one on every update.
+const double kSmoothing = 0.2;
+
+// Lowest factor the limit is scaled down by on a single update.
+const double kMinGradient = 0.5;
+
+// Factor the limit is scaled down by while the cache is under pressure.
+const double kCachePressureBackoff = 0.9;
+
+// Factor the lowest latency drifts up by on every update.
+const double kMinLatencyDrift = 1.01;
+
+}  // namespace
+
+TicketLimitController::TicketLimitController(int initialLimit) : _limit(initialLimit) {}
+
+int TicketLimitController::update(const Sample& sample, int minLimit, int maxLimit) {
+    double newLimit = _limit;
+    if (sample.cacheUnderPressure) {
+        // Fewer concurrent operations let eviction catch up.
+        newLimit = _limit * kCachePressureBackoff;
+    } else if (sample.throughput > 0 && sample.ticketsInUse > 0) {
+        const double latency = sample.ticketsInUse / sample.throughput;
+        _minLatency =
+            _minLatency == 0 ? latency : std::min(_minLatency * kMinLatencyDrift, latency);
+
+        const double gradient = std::max(kMinGradient, std::min(1.0, _minLatency / latency));
+
+        // There is nothing to gain from more tickets unless operations wait for them.
+        const double queueAllowance = sample.queued > 0 ? std::sqrt(_limit) : 0;
+        newLimit = _limit * gradient + queueAllowance;
+    }
+
+    _limit = _limit * (1 - kSmoothing) + newLimit * kSmoothing;
+    _limit = std::max<double>(minLimit, std::min<double>(maxLimit, _limit));
+    return limit();
+}
+
+int TicketLimitController::limit() const {
+    return static_cast<int>(std::lround(_limit));
+}
+
+}  // namespace mongo
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+namespace mongo {
+
+/**
+ * Adjusts the number of tickets of a TicketHolder from periodic measurements, in the style of a
+ * gradient concurrency limiter.
+ *
+ * The average time operations hold a ticket follows from the throughput and the number of tickets
+ * in use (Little's law). As long as more concurrency only adds throughput, that time stays close to
+ * the lowest seen recently. Once operations contend inside the storage engine, it grows, and the
+ * limit is scaled down by the ratio of the two. The limit grows by the square root of itself while
+ * operations queue for tickets, and backs off while the storage engine cache is under pressure.
+ */
+class TicketLimitController {
+public:
+    struct Sample {
+        // Tickets released per second.
+        double throughput = 0;
+
+        // Average number of tickets in use.
+        double ticketsInUse = 0;
+
+        // Number of operations waiting for a ticket.
+        int queued = 0;
+
+        // Whether the storage engine cache is too full or too dirty to keep up.
+        bool cacheUnderPressure = false;
+    };
+
+    explicit TicketLimitController(int initialLimit);
+
+    /**
+     * Updates the limit from the measurements of the last interval and returns it, bounded by
+     * 'minLimit' and 'maxLimit'.
+     */
+    int update(const Sample& sample, int minLimit, int maxLimit);
+
+    int limit() const;
+
+private:
+    double _limit;
+
+    // Lowest average time operations held a ticket, in seconds. Slowly drifts upwards so that it
+    // follows changes in the workload.
+    double _minLatency = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticket_limit_controller.h"
+
+namespace mongo {
+namespace {
+
+TicketLimitController::Sample makeSample(double throughput, double ticketsInUse, int queued) {
+    TicketLimitController::Sample sample;
+    sample.throughput = throughput;
+    sample.ticketsInUse = ticketsInUse;
+    sample.queued = queued;
+    return sample;
+}
+
+TEST(TicketLimitControllerTest, GrowsWhileOperationsQueueAtConstantLatency) {
+    TicketLimitController controller(16);
+    int limit = controller.limit();
+    for (int i = 0; i < 20; ++i) {
+        // Every operation holds its ticket for 10ms regardless of the concurrency.
+        const int newLimit = controller.update(makeSample(limit * 100, limit, 10), 8, 512);
+        ASSERT_GTE(newLimit, limit);
+        limit = newLimit;
+    }
+    ASSERT_GT(limit, 16);
+}
+
+TEST(TicketLimitControllerTest, DoesNotGrowWithoutQueuedOperations) {
+    TicketLimitController controller(16);
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_EQ(16, controller.update(makeSample(1600, 16, 0), 8, 512));
+    }
+}
+
+TEST(TicketLimitControllerTest, ShrinksWhenLatencyGrows) {
+    TicketLimitController controller(128);
+    controller.update(makeSample(12800, 128, 10), 8, 512);
+    const int limit = controller.limit();
+
+    // The same throughput with the same number of tickets in use now takes four times as long.
+    for (int i = 0; i < 10; ++i) {
+        controller.update(makeSample(3200, 128, 10), 8, 512);
+    }
+    ASSERT_LT(controller.limit(), limit);
+}
+
+TEST(TicketLimitControllerTest, ShrinksUnderCachePressure) {
+    TicketLimitController controller(128);
+    auto sample = makeSample(12800, 128, 10);
+    sample.cacheUnderPressure = true;
+    ASSERT_LT(controller.update(sample, 8, 512), 128);
+}
+
+TEST(TicketLimitControllerTest, StaysWithinBounds) {
+    TicketLimitController controller(16);
+    auto sample = makeSample(1600, 16, 0);
+    sample.cacheUnderPressure = true;
+    for (int i = 0; i < 100; ++i) {
+        controller.update(sample, 8, 512);
+    }
+    ASSERT_EQ(8, controller.limit());
+
+    for (int i = 0; i < 1000; ++i) {
+        controller.update(makeSample(controller.limit() * 100, controller.limit(), 10), 8, 32);
+    }
+    ASSERT_EQ(32, controller.limit());
+}
+
+TEST(TicketLimitControllerTest, IgnoresIdleIntervals) {
+    TicketLimitController controller(64);
+    ASSERT_EQ(64, controller.update(makeSample(0, 0, 0), 8, 512));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,11 +35,146 @@
 
 #include <iostream>
 
+#include "mongo/db/wait_event.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
+constexpr std::array<int, TicketHolder::kNumPriorities> TicketHolder::kPriorityWeights;
+constexpr int TicketHolder::kNumQueueTimeBuckets;
+
+void TicketHolder::waitForTicket(OperationContext* opCtx, AdmissionPriority priority) {
+    waitForTicketUntil(opCtx, Date_t::max(), priority);
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      AdmissionPriority priority) {
+    // Don't take a ticket from the pool while other operations wait, they would be passed over.
+    if (_numWaiters.load() == 0 && tryAcquire())
+        return true;
+
+    WaitEventGuard waitEvent(opCtx, WaitEvent::kTicket);
+    const Date_t start = Date_t::now();
+    stdx::unique_lock<stdx::mutex> lk(_queueMutex);
+    auto& queue = _waiters[static_cast<int>(priority)];
+    Waiter waiter;
+    waiter.position = queue.insert(queue.end(), &waiter);
+    _numWaiters.fetchAndAdd(1);
+
+    // Pass the ticket on if it was handed to this operation just as the wait failed.
+    auto stopWaiting = makeGuard([&] {
+        if (waiter.hasTicket) {
+            _release_inlock();
+        } else {
+            queue.erase(waiter.position);
+            _numWaiters.subtractAndFetch(1);
+        }
+    });
+
+    _grantPooledTickets_inlock();
+
+    // To support interrupting ticket acquisition, wait on an interval to periodically check for
+    // interrupts.
+    const Milliseconds interval(500);
+    while (!waiter.hasTicket) {
+        const Date_t deadline = std::min(until, Date_t::now() + interval);
+        waiter.granted.wait_until(lk, deadline.toSystemTimePoint());
+        if (waiter.hasTicket)
+            break;
+
+        if (opCtx)
+            opCtx->checkForInterrupt();
+
+        if (deadline == until)
+            return false;
+    }
+
+    stopWaiting.dismiss();
+    lk.unlock();
+
+    const auto millis = durationCount<Milliseconds>(Date_t::now() - start);
+    int bucket = 0;
+    while (bucket < kNumQueueTimeBuckets - 1 && millis >= (1LL << bucket)) {
+        bucket++;
+    }
+    _queueTimeBuckets[bucket].fetchAndAdd(1);
+    return true;
+}
+
+void TicketHolder::appendQueueTimeHistogram(BSONObjBuilder* builder) const {
+    for (int bucket = 0; bucket < kNumQueueTimeBuckets - 1; bucket++) {
+        const std::string name = str::stream() << "lt" << (1LL << bucket);
+        builder->append(name, _queueTimeBuckets[bucket].load());
+    }
+    const std::string name = str::stream() << "ge" << (1LL << (kNumQueueTimeBuckets - 2));
+    builder->append(name, _queueTimeBuckets[kNumQueueTimeBuckets - 1].load());
+}
+
+void TicketHolder::release() {
+    _numReleased.fetchAndAdd(1);
+
+    if (_numWaiters.load() == 0) {
+        _releaseToPool();
+
+        // An operation may have started waiting just before the ticket got back to the pool.
+        if (_numWaiters.load() == 0)
+            return;
+
+        stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+        _grantPooledTickets_inlock();
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+    _release_inlock();
+}
+
+void TicketHolder::_release_inlock() {
+    auto waiter = _popNextWaiter_inlock();
+    if (!waiter) {
+        _releaseToPool();
+        return;
+    }
+
+    waiter->hasTicket = true;
+    waiter->granted.notify_one();
+}
+
+void TicketHolder::_grantPooledTickets_inlock() {
+    while (_numWaiters.load() > 0 && tryAcquire()) {
+        _release_inlock();
+    }
+}
+
+auto TicketHolder::_popNextWaiter_inlock() -> Waiter* {
+    // Smooth weighted round-robin between the priorities with waiting operations.
+    int totalWeight = 0;
+    int next = -1;
+    for (int i = 0; i < kNumPriorities; i++) {
+        if (_waiters[i].empty()) {
+            _currentWeights[i] = 0;
+            continue;
+        }
+
+        _currentWeights[i] += kPriorityWeights[i];
+        totalWeight += kPriorityWeights[i];
+        if (next < 0 || _currentWeights[i] > _currentWeights[next])
+            next = i;
+    }
+
+    if (next < 0)
+        return nullptr;
+
+    _currentWeights[next] -= totalWeight;
+    auto waiter = _waiters[next].front();
+    _waiters[next].pop_front();
+    _numWaiters.subtractAndFetch(1);
+    return waiter;
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -60,14 +195,6 @@ void check(int ret) {
         return;
     failWithErrno(errno);
 }
-
-/**
- * Takes a Date_t deadline and sets the appropriate values in a timespec structure.
- */
-void tsFromDate(const Date_t& deadline, struct timespec& ts) {
-    ts.tv_sec = deadline.toTimeT();
-    ts.tv_nsec = (deadline.toMillisSinceEpoch() % 1000) * 1'000'000;
-}
 }  // namespace
 
 TicketHolder::TicketHolder(int num) : _outof(num) {
@@ -88,42 +215,7 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    const Milliseconds intervalMs(500);
-    struct timespec ts;
-
-    // To support interrupting ticket acquisition while still benefiting from semaphores, we do a
-    // timed wait on an interval to periodically check for interrupts.
-    // The wait period interval is the smaller of the default interval and the provided
-    // deadline.
-    Date_t deadline = std::min(until, Date_t::now() + intervalMs);
-    tsFromDate(deadline, ts);
-
-    while (0 != sem_timedwait(&_sem, &ts)) {
-        if (errno == ETIMEDOUT) {
-            // If we reached the deadline without being interrupted, we have completely timed out.
-            if (deadline == until)
-                return false;
-
-            deadline = std::min(until, Date_t::now() + intervalMs);
-            tsFromDate(deadline, ts);
-        } else if (errno != EINTR) {
-            failWithErrno(errno);
-        }
-
-        // To correctly handle errors from sem_timedwait, we should check for interrupts last.
-        // It is possible to unset 'errno' after a call to checkForInterrupt().
-        if (opCtx)
-            opCtx->checkForInterrupt();
-    }
-    return true;
-}
-
-void TicketHolder::release() {
+void TicketHolder::_releaseToPool() {
     check(sem_post(&_sem));
 }
 
@@ -179,55 +271,33 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    if (opCtx) {
-        opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
-    } else {
-        _newTicket.wait(lk, [this] { return _tryAcquire(); });
-    }
-}
-
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
-            _newTicket, lk, until, [this] { return _tryAcquire(); });
-    } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
-    }
+void TicketHolder::_releaseToPool() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _num++;
 }
 
-void TicketHolder::release() {
+Status TicketHolder::resize(int newSize) {
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _num++;
-    }
-    _newTicket.notify_one();
-}
 
-Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+        int used = _outof.load() - _num;
+        if (used > newSize) {
+            std::stringstream ss;
+            ss << "can't resize since we're using (" << used << ") "
+               << "more than newSize(" << newSize << ")";
 
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
+            std::string errmsg = ss.str();
+            log() << errmsg;
+            return Status(ErrorCodes::BadValue, errmsg);
+        }
 
-        std::string errmsg = ss.str();
-        log() << errmsg;
-        return Status(ErrorCodes::BadValue, errmsg);
+        _outof.store(newSize);
+        _num = _outof.load() - used;
     }
 
-    _outof.store(newSize);
-    _num = _outof.load() - used;
-
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
+    // Hand the tickets that were added to the waiting operations.
+    stdx::lock_guard<stdx::mutex> lk(_queueMutex);
+    _grantPooledTickets_inlock();
     return Status::OK();
 }
 
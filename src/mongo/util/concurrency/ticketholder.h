@@ -32,15 +32,26 @@
 #include <semaphore.h>
 #endif
 
+#include <array>
+#include <list>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/admission_priority.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+/**
+ * Hands out a limited number of tickets. Operations which cannot get a ticket right away wait in
+ * one queue per AdmissionPriority. Released tickets go to the waiting operations, choosing the
+ * queue by smooth weighted round-robin so that higher priorities get most of the tickets, but
+ * lower priorities are not starved. Operations wait in order of arrival within a queue.
+ */
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
@@ -55,7 +66,8 @@ public:
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx,
+                       AdmissionPriority priority = AdmissionPriority::kNormal);
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -67,7 +79,9 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            AdmissionPriority priority = AdmissionPriority::kNormal);
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
@@ -81,7 +95,74 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of operations waiting for a ticket.
+     */
+    int queued() const {
+        return _numWaiters.load();
+    }
+
+    /**
+     * Returns the number of tickets released so far.
+     */
+    long long numReleased() const {
+        return _numReleased.load();
+    }
+
+    /**
+     * Appends a histogram of how long operations which could not get a ticket right away waited
+     * for one, in milliseconds.
+     */
+    void appendQueueTimeHistogram(BSONObjBuilder* builder) const;
+
 private:
+    static constexpr int kNumPriorities = static_cast<int>(AdmissionPriority::kHigh) + 1;
+
+    // Share of the released tickets each priority gets while operations of all priorities wait.
+    static constexpr std::array<int, kNumPriorities> kPriorityWeights{{1, 4, 16}};
+
+    // Queue times are counted in buckets of [0, 1), [1, 2), [2, 4), ... [512, 1024) and
+    // [1024, inf) milliseconds.
+    static constexpr int kNumQueueTimeBuckets = 12;
+
+    struct Waiter {
+        std::list<Waiter*>::iterator position;
+        stdx::condition_variable granted;
+        bool hasTicket = false;
+    };
+
+    /**
+     * Returns a ticket to the pool, without handing it to a waiting operation.
+     */
+    void _releaseToPool();
+
+    /**
+     * Hands a released ticket to the next waiting operation, or returns it to the pool if there
+     * are none.
+     */
+    void _release_inlock();
+
+    /**
+     * Hands the tickets in the pool to waiting operations. A ticket can end up in the pool while
+     * operations wait when it is released just as they start waiting.
+     */
+    void _grantPooledTickets_inlock();
+
+    /**
+     * Removes and returns the next operation to hand a ticket to, or nullptr if none are waiting.
+     */
+    Waiter* _popNextWaiter_inlock();
+
+    stdx::mutex _queueMutex;
+    std::array<std::list<Waiter*>, kNumPriorities> _waiters;  // Guarded by _queueMutex.
+    std::array<int, kNumPriorities> _currentWeights{};        // Guarded by _queueMutex.
+
+    // Only modified with _queueMutex held, can be read without it.
+    AtomicWord<int> _numWaiters{0};
+
+    AtomicWord<long long> _numReleased{0};
+    std::array<AtomicWord<long long>, kNumQueueTimeBuckets> _queueTimeBuckets;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
@@ -94,7 +175,6 @@ private:
     AtomicWord<int> _outof;
     int _num;
     stdx::mutex _mutex;
-    stdx::condition_variable _newTicket;
 #endif
 };
 
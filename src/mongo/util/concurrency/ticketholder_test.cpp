@@ -32,6 +32,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -72,4 +75,51 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, HigherPriorityWaitersGetTicketsFirst) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    stdx::mutex mutex;
+    std::vector<AdmissionPriority> order;
+    auto waitAndRecord = [&](AdmissionPriority priority) {
+        holder.waitForTicket(nullptr, priority);
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            order.push_back(priority);
+        }
+        holder.release();
+    };
+
+    stdx::thread lowThread(waitAndRecord, AdmissionPriority::kLow);
+    while (holder.queued() < 1) {
+        sleepmillis(1);
+    }
+    stdx::thread highThread(waitAndRecord, AdmissionPriority::kHigh);
+    while (holder.queued() < 2) {
+        sleepmillis(1);
+    }
+
+    holder.release();
+    lowThread.join();
+    highThread.join();
+
+    ASSERT_EQ(order.size(), 2u);
+    ASSERT(order[0] == AdmissionPriority::kHigh);
+    ASSERT(order[1] == AdmissionPriority::kLow);
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.queued(), 0);
+}
+
+TEST(TicketholderTest, TimedOutWaiterLeavesQueue) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    ASSERT_FALSE(holder.waitForTicketUntil(
+        nullptr, Date_t::now() + Milliseconds(5), AdmissionPriority::kLow));
+    ASSERT_EQ(holder.queued(), 0);
+
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+}
 }  // namespace
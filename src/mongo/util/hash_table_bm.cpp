@@ -58,6 +58,8 @@ using AbslFlatHashMapString = absl::flat_hash_map<std::string, bool>;
 using AbslNodeHashMapInt = absl::node_hash_map<uint32_t, bool>;
 using AbslNodeHashMapString = absl::node_hash_map<std::string, bool>;
 
+using StringMapString = StringMap<bool>;
+
 template <typename>
 struct IsAbslHashMap : std::false_type {};
 
@@ -77,6 +79,48 @@ struct LookupType {
         typename Container::key_type>;
 };
 
+// StringMap is looked up through its own transparent hasher, which takes StringData.
+template <>
+struct LookupType<StringMapString> {
+    using type = StringData;
+};
+
+// Looks up keys whose hash was computed up front, as callers of StringMapHasher::hashed_key() do
+// when the same key is looked up in several maps or under a lock.
+template <class StorageGenerator, class LookupGenerator>
+void HashedLookupTest(benchmark::State& state) {
+    StringMapString container;
+    StorageGenerator storage_gen;
+
+    const int num = state.range(0) + 1;
+    for (int i = num - 1; i; --i) {
+        container[storage_gen.template generate<StringData>()];
+    }
+
+    std::vector<StringMapHashedKey> lookup_keys;
+    LookupGenerator lookup_gen;
+    for (int i = num; i; --i) {
+        lookup_keys.push_back(
+            StringMapHasher().hashed_key(lookup_gen.template generate<StringData>()));
+    }
+    // Make sure we don't do the lookup in the same order as insert.
+    std::shuffle(lookup_keys.begin(),
+                 lookup_keys.end(),
+                 std::default_random_engine(kDefaultSeed + kOtherSeed));
+
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        benchmark::DoNotOptimize(container.find(lookup_keys[i++]));
+        if (i == num) {
+            i = 0;
+        }
+    }
+
+    state.counters["size"] = state.range(0);
+    state.counters["load_factor"] = container.load_factor();
+}
+
 class BaseGenerator {
 public:
     template <typename K>
@@ -236,6 +280,14 @@ void BM_Insert(benchmark::State& state) {
         state);
 }
 
+void BM_SuccessfulHashedLookup(benchmark::State& state) {
+    HashedLookupTest<UniformDistribution<kDefaultSeed>, UniformDistribution<kDefaultSeed>>(state);
+}
+
+void BM_UnsuccessfulHashedLookup(benchmark::State& state) {
+    HashedLookupTest<UniformDistribution<kDefaultSeed>, UniformDistribution<kOtherSeed>>(state);
+}
+
 template <uint32_t Start = 0>
 static void Range(benchmark::internal::Benchmark* b) {
     uint32_t n0 = Start, n1 = kMaxContainerSize;
@@ -267,17 +319,23 @@ BENCHMARK_TEMPLATE(BM_Insert, AbslNodeHashMapInt)->Apply(Range<1>);
 BENCHMARK_TEMPLATE(BM_SuccessfulLookup, StdUnorderedString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_SuccessfulLookup, AbslFlatHashMapString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_SuccessfulLookup, AbslNodeHashMapString)->Apply(Range);
+BENCHMARK_TEMPLATE(BM_SuccessfulLookup, StringMapString)->Apply(Range);
+BENCHMARK(BM_SuccessfulHashedLookup)->Apply(Range);
 
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, StdUnorderedString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, AbslFlatHashMapString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, AbslNodeHashMapString)->Apply(Range);
+BENCHMARK_TEMPLATE(BM_UnsuccessfulLookup, StringMapString)->Apply(Range);
+BENCHMARK(BM_UnsuccessfulHashedLookup)->Apply(Range);
 
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookupSeq, StdUnorderedString)->Apply(Range);
 BENCHMARK_TEMPLATE(BM_UnsuccessfulLookupSeq, AbslNodeHashMapString)->Apply(Range);
+BENCHMARK_TEMPLATE(BM_UnsuccessfulLookupSeq, StringMapString)->Apply(Range);
 
 BENCHMARK_TEMPLATE(BM_Insert, StdUnorderedString)->Apply(Range<1>);
 BENCHMARK_TEMPLATE(BM_Insert, AbslFlatHashMapString)->Apply(Range<1>);
 BENCHMARK_TEMPLATE(BM_Insert, AbslNodeHashMapString)->Apply(Range<1>);
+BENCHMARK_TEMPLATE(BM_Insert, StringMapString)->Apply(Range<1>);
 
 }  // namespace
 }  // namespace mongo
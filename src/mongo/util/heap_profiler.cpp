@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/util/heap_profiler.h"
+
 #include "mongo/base/init.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/config.h"
@@ -73,8 +75,17 @@
 //   * the number of active bytes charged to the allocating stack trace is decreased
 //   * the object is removed from the object hash table
 //
-// Enable at startup time (only) with
+// Enable at startup time with
 //     mongod --setParameter heapProfilingEnabled=true
+// or at runtime with
+//     db.adminCommand({setParameter: 1, heapProfilingEnabled: true})
+//
+// The hash tables are allocated and the allocator hooks are installed the first time profiling
+// is enabled. Disabling profiling at runtime stops sampling new allocations, but frees of objects
+// that were already sampled are still accounted for, so the reported active bytes drain as those
+// objects are released. Once no sampled objects remain live, the free hook returns after a single
+// atomic load. heapProfilingSampleIntervalBytes may also be changed at runtime; raising it lowers
+// the sampling rate, and hence the overhead, on production nodes.
 //
 // If enabled, adds a heapProfile section to serverStatus as follows:
 //
@@ -276,7 +287,7 @@ public:
 
 class HeapProfiler {
 private:
-    // 0: sampling internally disabled
+    // 0: sampling disabled, either via heapProfilingEnabled or internally
     // 1: sample every allocation - byte accurate but slow and big
     // >1: sample ever sampleIntervalBytes bytes allocated - less accurate but fast and small
     std::atomic_size_t sampleIntervalBytes;  // NOLINT
@@ -386,8 +397,9 @@ private:
     // Record an allocation.
     //
     void _alloc(const void* objPtr, size_t objLen) {
-        // still profiling?
-        if (sampleIntervalBytes == 0)
+        // still profiling? The interval may change at runtime, so read it once.
+        const size_t interval = sampleIntervalBytes;
+        if (interval == 0)
             return;
 
         // Sample every sampleIntervalBytes bytes of allocation.
@@ -396,8 +408,7 @@ private:
         // number of samples will be correct.
         size_t lastSample = bytesAllocated.fetch_add(objLen);
         size_t currentSample = lastSample + objLen;
-        size_t accountedLen = sampleIntervalBytes *
-            (currentSample / sampleIntervalBytes - lastSample / sampleIntervalBytes);
+        size_t accountedLen = interval * (currentSample / interval - lastSample / interval);
         if (accountedLen == 0)
             return;
 
@@ -441,8 +452,11 @@ private:
     // Record a freed object.
     //
     void _free(const void* objPtr) {
-        // still profiling?
-        if (sampleIntervalBytes == 0)
+        // Any sampled objects still live? This is checked even when sampling is disabled so that
+        // objects sampled before profiling was turned off are still credited back to their stack.
+        // Visibility of an insert done on another thread is guaranteed because the freed object
+        // must have been handed over to this thread after it was allocated.
+        if (objHashTable.size() == 0)
             return;
 
         // Compute hash, quick return before locking if bucket is empty (common case).
@@ -529,7 +543,7 @@ private:
             const size_t objTableSize = objHashTable.memorySizeBytes();
             const size_t stackTableSize = stackHashTable.memorySizeBytes();
             const double MB = 1024 * 1024;
-            log() << "sampleIntervalBytes " << HeapProfilingSampleIntervalBytes << "; "
+            log() << "sampleIntervalBytes " << sampleIntervalBytes << "; "
                   << "maxActiveMemory " << maxActiveMemory / MB << " MB; "
                   << "objTableSize " << objTableSize / MB << " MB; "
                   << "stackTableSize " << stackTableSize / MB << " MB";
@@ -541,6 +555,7 @@ private:
 
         // Stats subsection.
         BSONObjBuilder statsBuilder(builder.subobjStart("stats"));
+        statsBuilder.appendNumber("sampleIntervalBytes", static_cast<size_t>(sampleIntervalBytes));
         statsBuilder.appendNumber("totalActiveBytes", totalActiveBytes);
         statsBuilder.appendNumber("bytesAllocated", bytesAllocated);
         statsBuilder.appendNumber("numStacks", stackHashTable.size());
@@ -612,21 +627,60 @@ private:
         heapProfiler->_free(obj);
     }
 
-public:
-    static HeapProfiler* heapProfiler;
-
     HeapProfiler() {
-        // Set sample interval from the parameter.
-        sampleIntervalBytes = HeapProfilingSampleIntervalBytes;
-
-        // This is our only allocator dependency - ifdef and change as
-        // appropriate for other allocators, using hooks or shims.
         // For tcmalloc we skip two frames that are internal to the allocator
         // so that the top frame is the public tc_* function.
         skipStartFrames = 2;
         skipEndFrames = 0;
-        MallocHook::AddNewHook(alloc);
-        MallocHook::AddDeleteHook(free);
+    }
+
+    // Serializes creation of the profiler and changes to whether it is sampling.
+    static stdx::mutex startMutex;
+
+    // Set once the startup value of heapProfilingEnabled has been applied. Parameter updates made
+    // while parsing startup options are deferred to the StartHeapProfiling initializer.
+    static bool started;
+
+public:
+    static HeapProfiler* heapProfiler;
+
+    // Starts or stops sampling according to the current parameter values. The profiler and its
+    // hash tables are created the first time sampling is enabled and are never destroyed, since
+    // the allocator hooks may still be running on other threads.
+    static void update() {
+        stdx::lock_guard<stdx::mutex> lk(startMutex);
+        if (!started)
+            return;
+
+        if (!HeapProfilingEnabled.load()) {
+            if (heapProfiler) {
+                heapProfiler->sampleIntervalBytes = 0;
+                log() << "heap profiling disabled";
+            }
+            return;
+        }
+
+        const bool first = !heapProfiler;
+        if (first)
+            heapProfiler = new HeapProfiler();
+        heapProfiler->sampleIntervalBytes = HeapProfilingSampleIntervalBytes.load();
+        if (first) {
+            // This is our only allocator dependency - ifdef and change as
+            // appropriate for other allocators, using hooks or shims.
+            // The hooks are installed only once heapProfiler has been published.
+            MallocHook::AddNewHook(alloc);
+            MallocHook::AddDeleteHook(free);
+        }
+        log() << "heap profiling enabled with sampleIntervalBytes "
+              << heapProfiler->sampleIntervalBytes;
+    }
+
+    static void start() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(startMutex);
+            started = true;
+        }
+        update();
     }
 
     static void generateServerStatusSection(BSONObjBuilder& builder) {
@@ -644,7 +698,7 @@ public:
     HeapProfilerServerStatusSection() : ServerStatusSection("heapProfile") {}
 
     bool includeByDefault() const override {
-        return HeapProfilingEnabled;
+        return HeapProfilingEnabled.load();
     }
 
     BSONObj generateSection(OperationContext* opCtx,
@@ -660,15 +714,27 @@ public:
 //
 
 HeapProfiler* HeapProfiler::heapProfiler;
+stdx::mutex HeapProfiler::startMutex;
+bool HeapProfiler::started = false;
 
 MONGO_INITIALIZER_GENERAL(StartHeapProfiling, ("EndStartupOptionHandling"), ("default"))
 (InitializerContext* context) {
-    if (HeapProfilingEnabled)
-        HeapProfiler::heapProfiler = new HeapProfiler();
+    HeapProfiler::start();
     return Status::OK();
 }
 
 }  // namespace
+
+Status onUpdateHeapProfilingEnabled(const bool&) {
+    HeapProfiler::update();
+    return Status::OK();
+}
+
+Status onUpdateHeapProfilingSampleIntervalBytes(const long long&) {
+    HeapProfiler::update();
+    return Status::OK();
+}
+
 }  // namespace mongo
 
 #endif  // MONGO_HAVE_HEAP_PROFILER
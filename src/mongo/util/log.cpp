@@ -65,6 +65,10 @@ bool rotateLogs(bool renameFiles) {
     using logger::RotatableFileManager;
     RotatableFileManager* manager = logger::globalRotatableFileManager();
     log() << "Log rotation initiated";
+    // Write buffered lines to the file they were logged to, before it is renamed.
+    if (auto asyncWriter = logger::globalAsyncLogWriter()) {
+        asyncWriter->flush().ignore();
+    }
     RotatableFileManager::FileNameStatusPairVector result(
         manager->rotateAll(renameFiles, "." + terseCurrentTime(false)));
     for (RotatableFileManager::FileNameStatusPairVector::iterator it = result.begin();
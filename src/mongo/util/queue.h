@@ -157,7 +157,7 @@ public:
         if (_queue.empty())
             return false;
 
-        t = _queue.front();
+        t = std::move(_queue.front());
         _queue.pop();
         _currentSize -= _getSize(t);
         _cvNoLongerFull.notify_one();
@@ -174,7 +174,7 @@ public:
             return T{};
         }
 
-        T t = _queue.front();
+        T t = std::move(_queue.front());
         _queue.pop();
         _currentSize -= _getSize(t);
         _cvNoLongerFull.notify_one();
@@ -201,7 +201,7 @@ public:
         if (_clearing) {
             return false;
         }
-        t = _queue.front();
+        t = std::move(_queue.front());
         _queue.pop();
         _currentSize -= _getSize(t);
         _cvNoLongerFull.notify_one();
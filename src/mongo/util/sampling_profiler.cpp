@@ -0,0 +1,426 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+#if defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#define MONGO_HAVE_SAMPLING_PROFILER
+#include <csignal>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Older C libraries do not name the field that holds the thread to signal.
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif
+
+namespace mongo {
+
+#if defined(MONGO_HAVE_SAMPLING_PROFILER)
+namespace {
+
+constexpr std::size_t kMaxTagLength = SamplingProfiler::kMaxTagLength;
+
+// Copies 'str' into 'dest', truncating it to fit with a terminating NUL.
+void copyTag(StringData str, char* dest) {
+    str = str.substr(0, kMaxTagLength - 1);
+    str.copyTo(dest, false);
+    dest[str.size()] = '\0';
+}
+
+// The tag of the innermost ScopedTag on this thread, read by the signal handler. It must stay
+// trivially destructible so that a signal arriving while the thread exits finds it intact.
+struct ThreadTag {
+    char command[kMaxTagLength];
+    char ns[kMaxTagLength];
+};
+thread_local ThreadTag threadTag;
+
+// Samples per second, or 0 when not sampling.
+AtomicWord<int> samplingFrequency{0};
+
+// Incremented by every setFrequency() call, so that threads know to rearm their timers.
+AtomicWord<int> frequencyGeneration{0};
+
+AtomicWord<long long> totalSamples{0};
+AtomicWord<long long> droppedSamples{0};
+
+// Number of samples the signal handler can record before the aggregator drains them.
+constexpr std::size_t kBufferSize = 4096;
+
+// How often the aggregator drains the buffer.
+constexpr Milliseconds kAggregationInterval{100};
+
+// Bounds the number of distinct stacks kept. Samples with a new stack are dropped once reached.
+constexpr std::size_t kMaxProfileEntries = 20000;
+
+// Frames of the signal handler and of the signal trampoline at the top of each stack.
+constexpr int kSkipFrames = 2;
+
+struct Sample {
+    enum State { kEmpty, kWriting, kFull };
+
+    AtomicWord<int> state;
+    int numFrames;
+    void* frames[SamplingProfiler::kMaxFrames + kSkipFrames];
+    ThreadTag tag;
+};
+
+Sample sampleBuffer[kBufferSize];
+AtomicWord<unsigned> nextSample{0};
+
+// A CPU time timer for the current thread, deleted when the thread exits.
+struct ThreadTimer {
+    ~ThreadTimer() {
+        if (created) {
+            timer_delete(timer);
+        }
+    }
+
+    // Rearms the timer for the current sampling frequency.
+    void update() {
+        generation = frequencyGeneration.load();
+        const auto frequency = samplingFrequency.load();
+        if (!created) {
+            if (frequency == 0) {
+                return;
+            }
+            struct sigevent event = {};
+            event.sigev_notify = SIGEV_THREAD_ID;
+            event.sigev_signo = SIGPROF;
+            event.sigev_notify_thread_id = syscall(SYS_gettid);
+            if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer) != 0) {
+                return;
+            }
+            created = true;
+        }
+
+        struct itimerspec interval = {};
+        if (frequency > 0) {
+            const long long periodNanos = 1000 * 1000 * 1000LL / frequency;
+            interval.it_interval.tv_sec = periodNanos / (1000 * 1000 * 1000);
+            interval.it_interval.tv_nsec = periodNanos % (1000 * 1000 * 1000);
+            interval.it_value = interval.it_interval;
+        }
+        timer_settime(timer, 0, &interval, nullptr);
+    }
+
+    bool created = false;
+    timer_t timer;
+    int generation = 0;
+};
+thread_local ThreadTimer threadTimer;
+
+// Async-signal-safe apart from backtrace(), which is safe once it has been called outside of a
+// signal handler.
+void recordSample(int, siginfo_t*, void*) {
+    if (samplingFrequency.loadRelaxed() == 0) {
+        return;
+    }
+    const int savedErrno = errno;
+    totalSamples.fetchAndAddRelaxed(1);
+    auto& sample = sampleBuffer[nextSample.fetchAndAdd(1) % kBufferSize];
+    if (sample.state.compareAndSwap(Sample::kEmpty, Sample::kWriting) == Sample::kEmpty) {
+        sample.numFrames = backtrace(sample.frames, SamplingProfiler::kMaxFrames + kSkipFrames);
+        std::memcpy(&sample.tag, &threadTag, sizeof(ThreadTag));
+        sample.state.store(Sample::kFull);
+    } else {
+        droppedSamples.fetchAndAddRelaxed(1);
+    }
+    errno = savedErrno;
+}
+
+/**
+ * Moves samples from the signal handler's buffer into a table of counts per stack and tag.
+ */
+class Aggregator {
+public:
+    static Aggregator& get() {
+        static Aggregator* const aggregator = new Aggregator();
+        return *aggregator;
+    }
+
+    // Starts the aggregation thread the first time sampling is enabled, and wakes it up.
+    void notifyFrequencyChanged() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_thread.joinable()) {
+            _thread = stdx::thread([this] {
+                setThreadName("samplingProfiler");
+                _run();
+            });
+        }
+        _condvar.notify_one();
+    }
+
+    template <typename F>
+    void withProfile(F&& f) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _drain(lk);
+        f(_profile);
+    }
+
+private:
+    void _run() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            if (samplingFrequency.load() == 0) {
+                _drain(lk);
+                _condvar.wait(lk);
+            } else {
+                _condvar.wait_for(lk, kAggregationInterval.toSystemDuration());
+            }
+            _drain(lk);
+        }
+    }
+
+    void _drain(WithLock) {
+        for (auto& sample : sampleBuffer) {
+            if (sample.state.load() != Sample::kFull) {
+                continue;
+            }
+
+            // Key samples on their tag followed by their raw frames. See appendProfile().
+            const auto numFrames = std::max(sample.numFrames - kSkipFrames, 0);
+            std::string key(sample.tag.command, strnlen(sample.tag.command, kMaxTagLength));
+            key.push_back('\0');
+            key.append(sample.tag.ns, strnlen(sample.tag.ns, kMaxTagLength));
+            key.push_back('\0');
+            key.append(reinterpret_cast<const char*>(sample.frames + kSkipFrames),
+                       numFrames * sizeof(void*));
+            sample.state.store(Sample::kEmpty);
+
+            auto it = _profile.find(key);
+            if (it != _profile.end()) {
+                ++it->second;
+            } else if (_profile.size() < kMaxProfileEntries) {
+                _profile.emplace(std::move(key), 1);
+            } else {
+                droppedSamples.fetchAndAddRelaxed(1);
+            }
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    stdx::thread _thread;
+    stdx::unordered_map<std::string, long long> _profile;
+};
+
+// Returns the demangled name of the function containing 'address', without its parameters.
+std::string symbolize(void* address) {
+    Dl_info dli;
+    if (dladdr(address, &dli) && dli.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+        if (!demangled) {
+            return dli.dli_sname;
+        }
+        std::string name(demangled, strcspn(demangled, "("));
+        free(demangled);
+        return name;
+    }
+    return str::stream() << address;
+}
+
+}  // namespace
+
+SamplingProfiler::ScopedTag::ScopedTag(StringData command, StringData ns)
+    : _active(samplingFrequency.loadRelaxed() != 0 ||
+              threadTimer.generation != frequencyGeneration.loadRelaxed()) {
+    if (!_active) {
+        return;
+    }
+    if (threadTimer.generation != frequencyGeneration.load()) {
+        threadTimer.update();
+    }
+    std::memcpy(_previousCommand, threadTag.command, kMaxTagLength);
+    std::memcpy(_previousNs, threadTag.ns, kMaxTagLength);
+
+    // The signal handler may interrupt this thread between the two copies and record a mix of
+    // the two tags, which is harmless.
+    copyTag(command, threadTag.command);
+    copyTag(ns, threadTag.ns);
+    std::atomic_signal_fence(std::memory_order_seq_cst);  // NOLINT
+}
+
+SamplingProfiler::ScopedTag::~ScopedTag() {
+    if (!_active) {
+        return;
+    }
+    std::memcpy(threadTag.command, _previousCommand, kMaxTagLength);
+    std::memcpy(threadTag.ns, _previousNs, kMaxTagLength);
+    std::atomic_signal_fence(std::memory_order_seq_cst);  // NOLINT
+}
+
+Status SamplingProfiler::setFrequency(int samplesPerSecond) {
+    if (samplesPerSecond < 0) {
+        return {ErrorCodes::BadValue, "Sampling frequency must not be negative"};
+    }
+
+    static stdx::mutex installMutex;
+    static bool installed = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(installMutex);
+        if (samplesPerSecond > 0 && !installed) {
+            // backtrace() loads the unwinder on its first call, which is not safe in a signal
+            // handler.
+            void* frames[1];
+            backtrace(frames, 1);
+
+            struct sigaction action = {};
+            action.sa_sigaction = recordSample;
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            if (sigaction(SIGPROF, &action, nullptr) != 0) {
+                const auto err = errno;
+                return {ErrorCodes::InternalError,
+                        str::stream() << "Failed to install the sampling profiler signal handler: "
+                                      << errnoWithDescription(err)};
+            }
+            installed = true;
+        }
+        samplingFrequency.store(samplesPerSecond);
+        frequencyGeneration.fetchAndAdd(1);
+    }
+
+    Aggregator::get().notifyFrequencyChanged();
+    return Status::OK();
+}
+
+void SamplingProfiler::appendProfile(std::size_t limit, BSONObjBuilder* builder) {
+    builder->append("samplesPerSecond", samplingFrequency.load());
+
+    std::vector<std::pair<std::string, long long>> entries;
+    Aggregator::get().withProfile([&](const auto& profile) {
+        entries.assign(profile.begin(), profile.end());
+    });
+    builder->append("samples", totalSamples.load());
+    builder->append("droppedSamples", droppedSamples.load());
+
+    limit = std::min(limit, entries.size());
+    std::partial_sort(entries.begin(),
+                      entries.begin() + limit,
+                      entries.end(),
+                      [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+
+    stdx::unordered_map<void*, std::string> symbols;
+    BSONArrayBuilder profileBuilder(builder->subarrayStart("profile"));
+    for (std::size_t i = 0; i < limit; ++i) {
+        // Unpack the key built by the aggregator.
+        const auto& key = entries[i].first;
+        const auto commandEnd = key.find('\0');
+        const auto nsEnd = key.find('\0', commandEnd + 1);
+        const auto numFrames = (key.size() - nsEnd - 1) / sizeof(void*);
+        std::vector<void*> frames(numFrames);
+        std::memcpy(frames.data(), key.data() + nsEnd + 1, numFrames * sizeof(void*));
+
+        // Stacks are reported outermost frame first.
+        StringBuilder stack;
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            auto symbol = symbols.find(*it);
+            if (symbol == symbols.end()) {
+                symbol = symbols.emplace(*it, symbolize(*it)).first;
+            }
+            if (it != frames.rbegin()) {
+                stack << ';';
+            }
+            stack << symbol->second;
+        }
+
+        BSONObjBuilder entryBuilder(profileBuilder.subobjStart());
+        entryBuilder.append("command", StringData(key.data(), commandEnd));
+        entryBuilder.append("ns", StringData(key.data() + commandEnd + 1, nsEnd - commandEnd - 1));
+        entryBuilder.append("stack", stack.str());
+        entryBuilder.append("count", entries[i].second);
+    }
+    profileBuilder.doneFast();
+}
+
+void SamplingProfiler::reset() {
+    Aggregator::get().withProfile([](auto& profile) { profile.clear(); });
+    totalSamples.store(0);
+    droppedSamples.store(0);
+}
+
+#else
+
+SamplingProfiler::ScopedTag::ScopedTag(StringData command, StringData ns) : _active(false) {}
+
+SamplingProfiler::ScopedTag::~ScopedTag() {}
+
+Status SamplingProfiler::setFrequency(int samplesPerSecond) {
+    if (samplesPerSecond == 0) {
+        return Status::OK();
+    }
+    return {ErrorCodes::InternalError, "The sampling profiler is not supported on this platform"};
+}
+
+void SamplingProfiler::appendProfile(std::size_t limit, BSONObjBuilder* builder) {
+    builder->append("samplesPerSecond", 0);
+    builder->append("samples", 0LL);
+    builder->append("droppedSamples", 0LL);
+    BSONArrayBuilder(builder->subarrayStart("profile")).doneFast();
+}
+
+void SamplingProfiler::reset() {}
+
+#endif
+
+Status onUpdateSamplingProfilerFrequency(const int& samplesPerSecond) {
+    return SamplingProfiler::setFrequency(samplesPerSecond);
+}
+
+}  // namespace mongo
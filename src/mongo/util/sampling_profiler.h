@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A sampling CPU profiler for the threads that run commands.
+ *
+ * While sampling is enabled, each thread that enters a ScopedTag arms a timer on its own CPU time.
+ * Every time the thread has used another 1/frequency seconds of CPU, the timer interrupts it with
+ * SIGPROF and the signal handler records the thread's stack, along with the command name and
+ * namespace of the innermost ScopedTag, in a fixed size buffer. A background thread moves the
+ * samples from the buffer into a bounded table of stacks and counts, which appendProfile()
+ * reports in a form that flame graph tools consume.
+ *
+ * Sampling uses SIGPROF, as the gperftools CPU profiler does, so the two cannot run at the same
+ * time. It is only supported on Linux; setFrequency() returns an error elsewhere.
+ */
+class SamplingProfiler {
+public:
+    // Deepest stack recorded for a sample.
+    static constexpr std::size_t kMaxFrames = 48;
+
+    // Longest command name and namespace recorded for a sample; longer ones are truncated.
+    static constexpr std::size_t kMaxTagLength = 96;
+
+    /**
+     * Attributes the samples taken on this thread while in scope to 'command' and 'ns'. Nested
+     * tags replace the enclosing tag until they go out of scope.
+     */
+    class ScopedTag {
+        MONGO_DISALLOW_COPYING(ScopedTag);
+
+    public:
+        ScopedTag(StringData command, StringData ns);
+        ~ScopedTag();
+
+    private:
+        bool _active;
+        char _previousCommand[kMaxTagLength];
+        char _previousNs[kMaxTagLength];
+    };
+
+    /**
+     * Sets the number of samples taken per second of CPU time on each thread, or stops sampling
+     * for a frequency of 0. Threads pick up the new frequency the next time they enter a
+     * ScopedTag.
+     */
+    static Status setFrequency(int samplesPerSecond);
+
+    /**
+     * Appends the aggregated samples, most frequent first and at most 'limit' of them, as
+     *
+     *     {samplesPerSecond: <int>, samples: <long>, droppedSamples: <long>,
+     *      profile: [{command: <string>, ns: <string>, stack: <string>, count: <long>}, ...]}
+     *
+     * where each stack lists the frames from the outermost to the innermost, separated by ';'.
+     */
+    static void appendProfile(std::size_t limit, BSONObjBuilder* builder);
+
+    /**
+     * Discards the aggregated samples.
+     */
+    static void reset();
+};
+
+/**
+ * Hook for the samplingProfilerFrequencyHz server parameter.
+ */
+Status onUpdateSamplingProfilerFrequency(const int& samplesPerSecond);
+
+}  // namespace mongo
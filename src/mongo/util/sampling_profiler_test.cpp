@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <ctime>
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Burns about 'millis' of CPU time on the current thread.
+ */
+void spin(long long millis) {
+    const auto end = std::clock() + millis * CLOCKS_PER_SEC / 1000;
+    volatile long long counter = 0;
+    while (std::clock() < end) {
+        counter = counter + 1;
+    }
+}
+
+/**
+ * Samples 'millis' of CPU time under the tag 'command' and 'ns' at 1000 samples per second, and
+ * returns false if sampling is not supported on this platform.
+ */
+bool sample(long long millis, StringData command, StringData ns) {
+    if (!SamplingProfiler::setFrequency(1000).isOK()) {
+        return false;
+    }
+    ON_BLOCK_EXIT([] { SamplingProfiler::setFrequency(0).ignore(); });
+
+    SamplingProfiler::ScopedTag tag(command, ns);
+    spin(millis);
+    return true;
+}
+
+BSONObj getProfile(std::size_t limit) {
+    BSONObjBuilder builder;
+    SamplingProfiler::appendProfile(limit, &builder);
+    return builder.obj();
+}
+
+TEST(SamplingProfilerTest, RejectsNegativeFrequency) {
+    ASSERT_EQ(ErrorCodes::BadValue, SamplingProfiler::setFrequency(-1));
+    ASSERT_OK(SamplingProfiler::setFrequency(0));
+}
+
+TEST(SamplingProfilerTest, ReportsNothingWhenNotSampling) {
+    SamplingProfiler::reset();
+    {
+        SamplingProfiler::ScopedTag tag("find", "test.coll");
+        spin(50);
+    }
+
+    const auto profile = getProfile(1000);
+    ASSERT_EQ(0, profile["samplesPerSecond"].numberInt());
+    ASSERT_EQ(0, profile["samples"].numberLong());
+    ASSERT_EQ(0U, profile["profile"].Array().size());
+}
+
+TEST(SamplingProfilerTest, AggregatesSamplesByTagAndStack) {
+    SamplingProfiler::reset();
+    if (!sample(300, "find", "test.coll")) {
+        return;
+    }
+
+    const auto profile = getProfile(1000000);
+    const auto samples = profile["samples"].numberLong();
+    ASSERT_GT(samples, 0);
+
+    // Every sample is either counted in the profile or dropped, and repeated stacks share entries.
+    long long counted = 0;
+    long long previousCount = std::numeric_limits<long long>::max();
+    for (auto&& element : profile["profile"].Array()) {
+        const auto entry = element.Obj();
+        ASSERT_EQ("find", entry["command"].str());
+        ASSERT_EQ("test.coll", entry["ns"].str());
+        ASSERT_FALSE(entry["stack"].str().empty());
+
+        // Entries are reported most frequent first.
+        const auto count = entry["count"].numberLong();
+        ASSERT_GT(count, 0);
+        ASSERT_LTE(count, previousCount);
+        previousCount = count;
+        counted += count;
+    }
+    ASSERT_EQ(samples, counted + profile["droppedSamples"].numberLong());
+    ASSERT_LT(static_cast<long long>(profile["profile"].Array().size()), samples);
+}
+
+TEST(SamplingProfilerTest, LimitKeepsTheMostFrequentStacks) {
+    SamplingProfiler::reset();
+    if (!sample(300, "find", "test.coll") || !sample(100, "insert", "test.other")) {
+        return;
+    }
+
+    const auto full = getProfile(1000000)["profile"].Array();
+    ASSERT_GTE(full.size(), 2U);
+
+    const auto limited = getProfile(1);
+    ASSERT_EQ(1U, limited["profile"].Array().size());
+    ASSERT_BSONOBJ_EQ(full[0].Obj(), limited["profile"].Array()[0].Obj());
+
+    ASSERT_EQ(0U, getProfile(0)["profile"].Array().size());
+}
+
+TEST(SamplingProfilerTest, ResetDiscardsSamples) {
+    SamplingProfiler::reset();
+    if (!sample(100, "find", "test.coll")) {
+        return;
+    }
+    ASSERT_GT(getProfile(1000)["samples"].numberLong(), 0);
+
+    SamplingProfiler::reset();
+    const auto profile = getProfile(1000);
+    ASSERT_EQ(0, profile["samples"].numberLong());
+    ASSERT_EQ(0, profile["droppedSamples"].numberLong());
+    ASSERT_EQ(0U, profile["profile"].Array().size());
+}
+
+}  // namespace
+}  // namespace mongo
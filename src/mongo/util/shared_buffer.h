@@ -34,6 +34,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/shared_buffer_pool.h"
 
 namespace mongo {
 
@@ -52,6 +53,16 @@ public:
         return takeOwnership(mongoMalloc(sizeof(Holder) + bytes), bytes);
     }
 
+    /**
+     * Like allocate(), but rounds the capacity up to a size class of the SharedBufferPool so that
+     * the memory can be reused once the buffer is released. Meant for short-lived buffers, such
+     * as those of messages.
+     */
+    static SharedBuffer allocatePooled(size_t bytes) {
+        const auto capacity = SharedBufferPool::roundUpToSizeClass(bytes);
+        return takeOwnership(SharedBufferPool::allocate(capacity, sizeof(Holder)), capacity);
+    }
+
     /**
      * Resizes the buffer, copying the current contents.
      *
@@ -114,9 +125,11 @@ private:
             if (h->_refCount.subtractAndFetch(1) == 0) {
                 // We placement new'ed a Holder in takeOwnership above,
                 // so we must destroy the object here.
-                auto allocation_size = sizeof(Holder) + h->_capacity;
+                const size_t capacity = h->_capacity;
                 h->~Holder();
-                mongoFree(h, allocation_size);
+                if (!SharedBufferPool::release(h, capacity)) {
+                    mongoFree(h, sizeof(Holder) + capacity);
+                }
             }
         }
 
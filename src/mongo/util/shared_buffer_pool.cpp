@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include <array>
+#include <set>
+#include <vector>
+
+#include "mongo/base/static_assert.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/bits.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/allocator.h"
+
+namespace mongo {
+namespace {
+
+constexpr int kMinSizeClassLog2 = 9;
+constexpr int kMaxSizeClassLog2 = 24;
+constexpr int kNumSizeClasses = kMaxSizeClassLog2 - kMinSizeClassLog2 + 1;
+MONGO_STATIC_ASSERT(SharedBufferPool::kMinSizeClass == size_t(1) << kMinSizeClassLog2);
+MONGO_STATIC_ASSERT(SharedBufferPool::kMaxSizeClass == size_t(1) << kMaxSizeClassLog2);
+
+// Larger blocks are only kept in the shared cache, and each thread keeps at most
+// kMaxThreadCacheBytes, so that the many idle threads of a busy server don't hold on to much.
+constexpr size_t kMaxThreadCachedSizeClass = 16 * 1024;
+constexpr size_t kThreadCacheBlocksPerClass = 4;
+constexpr size_t kMaxThreadCacheBytes = 64 * 1024;
+constexpr size_t kMaxSharedCacheBytes = 64 * 1024 * 1024;
+
+/**
+ * Returns the index of the size class 'capacity', or -1 if it is not a size class.
+ */
+int sizeClassIndex(size_t capacity) {
+    if (capacity < SharedBufferPool::kMinSizeClass || capacity > SharedBufferPool::kMaxSizeClass ||
+        (capacity & (capacity - 1)) != 0) {
+        return -1;
+    }
+    return countTrailingZeros64(capacity) - kMinSizeClassLog2;
+}
+
+struct ThreadCache;
+
+struct SharedCache {
+    stdx::mutex mutex;
+    std::vector<std::vector<void*>> blocks{static_cast<size_t>(kNumSizeClasses)};
+    size_t bytes = 0;
+
+    // The caches of the running threads, for stats only.
+    std::set<ThreadCache*> threadCaches;
+
+    void* pop(int index) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        auto& list = blocks[index];
+        if (list.empty()) {
+            return nullptr;
+        }
+        auto block = list.back();
+        list.pop_back();
+        bytes -= SharedBufferPool::kMinSizeClass << index;
+        return block;
+    }
+
+    bool push(int index, void* block) {
+        const size_t capacity = SharedBufferPool::kMinSizeClass << index;
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (bytes + capacity > kMaxSharedCacheBytes) {
+            return false;
+        }
+        blocks[index].push_back(block);
+        bytes += capacity;
+        return true;
+    }
+};
+
+SharedCache& sharedCache() {
+    // Intentionally leaked, since buffers may still be released during static destruction
+    static auto cache = new SharedCache();
+    return *cache;
+}
+
+// Set once the cache of the current thread has been destroyed at thread exit. This is trivially
+// destructible, so it can still be read by buffers released by later thread-local destructors.
+thread_local bool threadCacheDestroyed = false;
+
+struct ThreadCache {
+    std::array<std::array<void*, kThreadCacheBlocksPerClass>, kNumSizeClasses> blocks{};
+    std::array<size_t, kNumSizeClasses> counts{};
+
+    // Only written by the owning thread, and read by appendStats().
+    AtomicWord<long long> bytes{0};
+
+    ThreadCache() {
+        auto& cache = sharedCache();
+        stdx::lock_guard<stdx::mutex> lk(cache.mutex);
+        cache.threadCaches.insert(this);
+    }
+
+    ~ThreadCache() {
+        threadCacheDestroyed = true;
+        {
+            auto& cache = sharedCache();
+            stdx::lock_guard<stdx::mutex> lk(cache.mutex);
+            cache.threadCaches.erase(this);
+        }
+        for (int index = 0; index < kNumSizeClasses; index++) {
+            for (size_t i = 0; i < counts[index]; i++) {
+                if (!sharedCache().push(index, blocks[index][i])) {
+                    mongoFree(blocks[index][i]);
+                }
+            }
+        }
+    }
+
+    void* pop(int index) {
+        if (counts[index] == 0) {
+            return nullptr;
+        }
+        bytes.store(bytes.loadRelaxed() - (SharedBufferPool::kMinSizeClass << index));
+        return blocks[index][--counts[index]];
+    }
+
+    bool push(int index, void* block) {
+        const size_t capacity = SharedBufferPool::kMinSizeClass << index;
+        if (counts[index] == kThreadCacheBlocksPerClass ||
+            static_cast<size_t>(bytes.loadRelaxed()) + capacity > kMaxThreadCacheBytes) {
+            return false;
+        }
+        bytes.store(bytes.loadRelaxed() + capacity);
+        blocks[index][counts[index]++] = block;
+        return true;
+    }
+};
+
+thread_local ThreadCache threadCache;
+
+bool isThreadCached(int index) {
+    return !threadCacheDestroyed &&
+        (SharedBufferPool::kMinSizeClass << index) <= kMaxThreadCachedSizeClass;
+}
+
+}  // namespace
+
+constexpr size_t SharedBufferPool::kMinSizeClass;
+constexpr size_t SharedBufferPool::kMaxSizeClass;
+
+size_t SharedBufferPool::roundUpToSizeClass(size_t bytes) {
+    if (bytes > kMaxSizeClass) {
+        return bytes;
+    }
+
+    size_t capacity = kMinSizeClass;
+    while (capacity < bytes) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+void* SharedBufferPool::allocate(size_t capacity, size_t headerSize) {
+    const int index = sizeClassIndex(capacity);
+    if (index >= 0) {
+        if (isThreadCached(index)) {
+            if (auto block = threadCache.pop(index)) {
+                return block;
+            }
+        }
+        if (auto block = sharedCache().pop(index)) {
+            return block;
+        }
+    }
+
+    return mongoMalloc(headerSize + capacity);
+}
+
+bool SharedBufferPool::release(void* block, size_t capacity) {
+    const int index = sizeClassIndex(capacity);
+    if (index < 0) {
+        return false;
+    }
+
+    if (isThreadCached(index) && threadCache.push(index, block)) {
+        return true;
+    }
+
+    return sharedCache().push(index, block);
+}
+
+void SharedBufferPool::appendStats(BSONObjBuilder* builder) {
+    long long sharedBytes;
+    long long threadBytes = 0;
+    long long numThreadCaches;
+    {
+        auto& cache = sharedCache();
+        stdx::lock_guard<stdx::mutex> lk(cache.mutex);
+        sharedBytes = cache.bytes;
+        for (auto threadCache : cache.threadCaches) {
+            threadBytes += threadCache->bytes.load();
+        }
+        numThreadCaches = cache.threadCaches.size();
+    }
+
+    builder->append("pooledBytes", sharedBytes + threadBytes);
+    builder->append("sharedCacheBytes", sharedBytes);
+    builder->append("threadCacheBytes", threadBytes);
+    builder->append("threadCaches", numThreadCaches);
+}
+
+}  // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A cache of memory blocks for SharedBuffer, sorted into power of two size classes, so that the
+ * buffers of messages and replies can be reused instead of going through the allocator every
+ * time.
+ *
+ * Released blocks are first kept in a small cache of the releasing thread, and otherwise in a
+ * cache shared by all threads. Both caches are bounded in bytes; blocks which do not fit are
+ * freed.
+ */
+class SharedBufferPool {
+public:
+    static constexpr size_t kMinSizeClass = 512;
+    static constexpr size_t kMaxSizeClass = 16 * 1024 * 1024;
+
+    /**
+     * Returns the capacity of the smallest size class which can hold 'bytes', or 'bytes' itself
+     * if it is larger than the largest size class.
+     */
+    static size_t roundUpToSizeClass(size_t bytes);
+
+    /**
+     * Returns a block of 'headerSize + capacity' bytes, reusing a cached block if 'capacity' is a
+     * size class. The block must be released with release() or freed with mongoFree().
+     */
+    static void* allocate(size_t capacity, size_t headerSize);
+
+    /**
+     * Offers a block whose data part has 'capacity' bytes for reuse. Returns false if the block
+     * was not kept, in which case the caller remains responsible for freeing it.
+     */
+    static bool release(void* block, size_t capacity);
+
+    /**
+     * Appends the number of bytes held in the caches.
+     */
+    static void appendStats(BSONObjBuilder* builder);
+};
+
+}  // namespace mongo
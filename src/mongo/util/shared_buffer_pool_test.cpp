@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer_pool.h"
+
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/data_type_endian.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/util/shared_buffer.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(SharedBufferPoolTest, RoundUpToSizeClass) {
+    ASSERT_EQ(SharedBufferPool::roundUpToSizeClass(0), SharedBufferPool::kMinSizeClass);
+    ASSERT_EQ(SharedBufferPool::roundUpToSizeClass(16), SharedBufferPool::kMinSizeClass);
+    ASSERT_EQ(SharedBufferPool::roundUpToSizeClass(512), 512U);
+    ASSERT_EQ(SharedBufferPool::roundUpToSizeClass(513), 1024U);
+    ASSERT_EQ(SharedBufferPool::roundUpToSizeClass(SharedBufferPool::kMaxSizeClass),
+              SharedBufferPool::kMaxSizeClass);
+    ASSERT_EQ(SharedBufferPool::roundUpToSizeClass(SharedBufferPool::kMaxSizeClass + 1),
+              SharedBufferPool::kMaxSizeClass + 1);
+}
+
+TEST(SharedBufferPoolTest, PooledBufferHasSizeClassCapacity) {
+    auto buf = SharedBuffer::allocatePooled(3000);
+    ASSERT_EQ(buf.capacity(), 4096U);
+}
+
+TEST(SharedBufferPoolTest, ReleasedBufferIsReused) {
+    auto buf = SharedBuffer::allocatePooled(2048);
+    const auto data = buf.get();
+    buf = {};
+
+    auto reused = SharedBuffer::allocatePooled(2000);
+    ASSERT_EQ(reused.get(), data);
+}
+
+TEST(SharedBufferPoolTest, ReleaseRejectsOtherCapacities) {
+    ASSERT_FALSE(SharedBufferPool::release(nullptr, 1000));
+    ASSERT_FALSE(SharedBufferPool::release(nullptr, SharedBufferPool::kMinSizeClass / 2));
+    ASSERT_FALSE(SharedBufferPool::release(nullptr, SharedBufferPool::kMaxSizeClass * 2));
+}
+
+BSONObj getStats() {
+    BSONObjBuilder builder;
+    SharedBufferPool::appendStats(&builder);
+    return builder.obj();
+}
+
+TEST(SharedBufferPoolTest, StatsCountReleasedBuffers) {
+    auto buf = SharedBuffer::allocatePooled(4096);
+    const auto before = getStats();
+    buf = {};
+    const auto after = getStats();
+
+    ASSERT_EQ(after["pooledBytes"].numberLong(), before["pooledBytes"].numberLong() + 4096);
+    ASSERT_EQ(after["pooledBytes"].numberLong(),
+              after["sharedCacheBytes"].numberLong() + after["threadCacheBytes"].numberLong());
+    ASSERT_GTE(after["threadCaches"].numberLong(), 1);
+}
+
+TEST(SharedBufferPoolTest, ThreadCacheIsBounded) {
+    std::vector<SharedBuffer> bufs;
+    for (size_t size = SharedBufferPool::kMinSizeClass; size <= 64 * 1024; size *= 2) {
+        for (int i = 0; i < 8; i++) {
+            bufs.push_back(SharedBuffer::allocatePooled(size));
+        }
+    }
+    bufs.clear();
+
+    ASSERT_LTE(getStats()["threadCacheBytes"].numberLong(), 64 * 1024);
+}
+
+TEST(SharedBufferPoolTest, BufBuilderGrowthKeepsContents) {
+    BufBuilder builder(SharedBufferPool::kMinSizeClass);
+    for (int i = 0; i < 10000; i++) {
+        builder.appendNum(i);
+    }
+
+    ConstDataRangeCursor cursor(builder.buf(), builder.buf() + builder.len());
+    for (int i = 0; i < 10000; i++) {
+        ASSERT_EQ(cursor.readAndAdvance<LittleEndian<int>>().getValue(), i);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tsc_tick_source.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#define MONGO_HAVE_TSC_TICK_SOURCE
+#endif
+
+#include "mongo/base/init.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+// How long the TSC is compared against the system tick source to determine its rate.
+const long long kCalibrationMillis = 10;
+
+#if defined(MONGO_HAVE_TSC_TICK_SOURCE)
+
+bool hasInvariantTsc() {
+    // The invariant TSC bit is bit 8 of EDX in extended leaf 0x80000007.
+    const unsigned int kInvariantTscLeaf = 0x80000007;
+    const unsigned int kInvariantTscBit = 1u << 8;
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned int>(regs[0]) < kInvariantTscLeaf)
+        return false;
+    __cpuid(regs, kInvariantTscLeaf);
+    return static_cast<unsigned int>(regs[3]) & kInvariantTscBit;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0x80000000, nullptr) < kInvariantTscLeaf)
+        return false;
+    __get_cpuid(kInvariantTscLeaf, &eax, &ebx, &ecx, &edx);
+    return edx & kInvariantTscBit;
+#endif
+}
+
+TickSource::Tick readTsc() {
+    return static_cast<TickSource::Tick>(__rdtsc());
+}
+
+#else
+
+bool hasInvariantTsc() {
+    return false;
+}
+
+TickSource::Tick readTsc() {
+    return 0;
+}
+
+#endif
+
+}  // namespace
+
+MONGO_INITIALIZER_WITH_PREREQUISITES(TscTickSourceInit, ("SystemTickSourceInit"))
+(InitializerContext* context) {
+    // Calibrate the TSC during startup rather than on first use.
+    TscTickSource::get();
+    return Status::OK();
+}
+
+TscTickSource::TscTickSource() {
+    auto systemTickSource = SystemTickSource::get();
+    const auto systemStart = systemTickSource->getTicks();
+    const auto tscStart = readTsc();
+    sleepmillis(kCalibrationMillis);
+    const auto systemEnd = systemTickSource->getTicks();
+    const auto tscEnd = readTsc();
+
+    const double elapsedSeconds = static_cast<double>(systemEnd - systemStart) /
+        systemTickSource->getTicksPerSecond();
+    _ticksPerSecond = static_cast<TickSource::Tick>((tscEnd - tscStart) / elapsedSeconds);
+}
+
+TickSource::Tick TscTickSource::getTicks() {
+    return readTsc();
+}
+
+TickSource::Tick TscTickSource::getTicksPerSecond() {
+    return _ticksPerSecond;
+}
+
+bool TscTickSource::isAvailable() {
+    static const bool available = hasInvariantTsc();
+    return available;
+}
+
+TickSource* TscTickSource::get() {
+    static TickSource* const tickSource = isAvailable()
+        ? static_cast<TickSource*>(new TscTickSource())
+        : static_cast<TickSource*>(SystemTickSource::get());
+    return tickSource;
+}
+
+}  // namespace mongo